@@ -1045,6 +1045,20 @@ not been tested and explicitly activated if you set use --wanted-tests ALL""")
         group.add_argument("--validate-generate-ssim-reference-files",
                            help="(re)generate ssim reference image files.",
                            default=False, action='store_true')
+        group.add_argument("--validate-perf-baseline", dest="validate_perf_baseline",
+                           help="Run the tests with fakesinks and the latency tracer, record"
+                                " CPU time, peak RSS, realtime factor and per element latency"
+                                " percentiles, and compare them with the JSON baseline file"
+                                " (which is created if it does not exist yet).",
+                           default=None)
+        group.add_argument("--validate-perf-update-baseline", dest="validate_perf_update_baseline",
+                           help="Store the measured performance in the baseline file instead"
+                                " of comparing against it.",
+                           default=False, action='store_true')
+        group.add_argument("--validate-perf-max-regression", dest="validate_perf_max_regression",
+                           help="Performance regression, in percent, above which a test"
+                                " is considered failed (default: 10).",
+                           default=10.0, type=float)
 
     def print_valgrind_bugs(self):
         # Look for all the 'pending' bugs in our supp file
@@ -1246,6 +1260,11 @@ not been tested and explicitly activated if you set use --wanted-tests ALL""")
         if options.validate_uris or options.validate_generate_ssim_reference_files:
             self.check_testslist = False
 
+        if options.validate_perf_baseline:
+            # Measure the pipeline, not the sinks' synchronization
+            options.mute = True
+            options.validate_perf_baseline = os.path.abspath(options.validate_perf_baseline)
+
         super(GstValidateTestManager, self).set_settings(
             options, args, reporter)
 
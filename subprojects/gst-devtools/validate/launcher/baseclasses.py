@@ -80,6 +80,11 @@ EXITING_SIGNALS.update({(v, k) for k, v in EXITING_SIGNALS.items()})
 
 CI_ARTIFACTS_URL = os.environ.get('CI_ARTIFACTS_URL')
 
+# Serializes updates of the performance baseline file between test threads
+PERF_BASELINE_LOCK = threading.Lock()
+ELEMENT_LATENCY_REGEX = re.compile(
+    r"element-latency, .*element=\(string\)([^,]+), .*time=\(guint64\)(\d+)")
+
 
 class Test(Loggable):
 
@@ -522,12 +527,15 @@ class Test(Loggable):
                                         env=self.proc_env,
                                         cwd=self.workdir,
                                         preexec_fn=preexec_fn)
-        self.process.wait()
+        self.wait_process()
         if self.result is not Result.TIMEOUT:
             if self.process.returncode == 0:
                 self.run_external_checks()
             self.queue.put(None)
 
+    def wait_process(self):
+        self.process.wait()
+
     def get_valgrind_suppression_file(self, subdir, name):
         p = get_data_file(subdir, name)
         if p:
@@ -862,6 +870,7 @@ class GstValidateTest(Test):
         self.position = -1
         self.media_duration = -1
         self.speed = 1.0
+        self.rusage = None
         self.actions_infos = []
         self.media_descriptor = media_descriptor
         self.server = None
@@ -920,6 +929,14 @@ class GstValidateTest(Test):
     def add_report(self, report):
         self.reports.append(report)
 
+    def wait_process(self):
+        if not self.options.validate_perf_baseline or not hasattr(os, 'wait4'):
+            return super().wait_process()
+
+        # Reap the child ourselves so we get its resource usage
+        _, status, self.rusage = os.wait4(self.process.pid, 0)
+        self.process.returncode = os.waitstatus_to_exitcode(status)
+
     def set_position(self, position, duration, speed=None):
         self.position = position
         self.media_duration = duration
@@ -963,6 +980,13 @@ class GstValidateTest(Test):
         if self.options.no_color:
             subproc_env["GST_DEBUG_NO_COLOR"] = '1'
 
+        if self.options.validate_perf_baseline:
+            tracers = subproc_env.get('GST_TRACERS')
+            latency = 'latency(flags=element)'
+            subproc_env['GST_TRACERS'] = tracers + ';' + latency if tracers else latency
+            debug = subproc_env.get('GST_DEBUG')
+            subproc_env['GST_DEBUG'] = debug + ',GST_TRACER:7' if debug else 'GST_TRACER:7'
+
         # Ensure XInitThreads is called, see bgo#731525
         subproc_env['GST_GL_XINITTHREADS'] = '1'
         self.add_env_variable('GST_GL_XINITTHREADS', '1')
@@ -998,6 +1022,7 @@ class GstValidateTest(Test):
         self.position = -1
         self.media_duration = -1
         self.speed = 1.0
+        self.rusage = None
         self.actions_infos = []
 
     def build_arguments(self):
@@ -1200,8 +1225,97 @@ class GstValidateTest(Test):
                     result = Result.KNOWN_ERROR
                     break
 
+        if result == Result.PASSED and self.options.validate_perf_baseline:
+            result, msg = self.check_performance(msg)
+
         self.set_result(result, msg.strip())
 
+    def get_element_latencies(self):
+        latencies = defaultdict(list)
+        for logfile in [self.logfile] + list(self.extra_logfiles):
+            try:
+                with open(logfile, errors='replace') as f:
+                    for line in f:
+                        m = ELEMENT_LATENCY_REGEX.search(line)
+                        if m:
+                            latencies[m.group(1)].append(int(m.group(2)))
+            except OSError:
+                continue
+
+        res = {}
+        for element, values in latencies.items():
+            values.sort()
+            res[element] = {
+                'p%d' % p: values[min(len(values) - 1, len(values) * p // 100)]
+                for p in [50, 95, 99]}
+
+        return res
+
+    def get_performance_metrics(self):
+        metrics = {}
+        if self.rusage:
+            metrics['cpu-time'] = self.rusage.ru_utime + self.rusage.ru_stime
+            # ru_maxrss is in kilobytes on Linux but in bytes on macOS
+            maxrss = self.rusage.ru_maxrss
+            if sys.platform == 'darwin':
+                maxrss //= 1024
+            metrics['peak-rss-kb'] = maxrss
+
+        if self.position > 0 and self.time_taken > 0:
+            metrics['realtime-factor'] = self.position / GST_SECOND / self.time_taken
+
+        latencies = self.get_element_latencies()
+        if latencies:
+            metrics['element-latency'] = latencies
+
+        return metrics
+
+    def check_performance(self, msg):
+        """
+        Compares the performance of the test run against the baseline,
+        returns the result and the message of the test.
+        """
+        metrics = self.get_performance_metrics()
+        max_regression = self.options.validate_perf_max_regression / 100.0
+
+        with PERF_BASELINE_LOCK:
+            baselines = {}
+            if os.path.exists(self.options.validate_perf_baseline):
+                with open(self.options.validate_perf_baseline) as f:
+                    baselines = json.load(f)
+
+            baseline = baselines.get(self.classname)
+            if baseline is None or self.options.validate_perf_update_baseline:
+                baselines[self.classname] = metrics
+                with open(self.options.validate_perf_baseline, 'w') as f:
+                    json.dump(baselines, f, indent=4, sort_keys=True)
+
+        if baseline is None or self.options.validate_perf_update_baseline:
+            return Result.PASSED, msg
+
+        regressions = []
+
+        def check(name, value, ref, higher_is_better=False):
+            if value is None or not ref:
+                return
+            change = (ref - value if higher_is_better else value - ref) / ref
+            if change > max_regression:
+                regressions.append('%s %.4g -> %.4g (%+.1f%%)' % (
+                    name, ref, value, (value - ref) * 100 / ref))
+
+        check('cpu-time', metrics.get('cpu-time'), baseline.get('cpu-time'))
+        check('peak-rss-kb', metrics.get('peak-rss-kb'), baseline.get('peak-rss-kb'))
+        check('realtime-factor', metrics.get('realtime-factor'),
+              baseline.get('realtime-factor'), higher_is_better=True)
+        for element, ref in baseline.get('element-latency', {}).items():
+            current = metrics.get('element-latency', {}).get(element, {})
+            check('%s latency p95' % element, current.get('p95'), ref.get('p95'))
+
+        if regressions:
+            return Result.FAILED, msg + ' (Performance regressions: %s) ' % ', '.join(regressions)
+
+        return Result.PASSED, msg
+
     def _generate_expected_issues(self):
         res = ""
         self.criticals = self.criticals or []
@@ -783,6 +783,262 @@ ges_uri_clip_asset_get_stream_assets (GESUriClipAsset * self)
   return self->priv->asset_trackfilesources;
 }
 
+typedef struct
+{
+  gchar *uri;
+  gchar *proxy_uri;
+  GstEncodingProfile *profile;
+} CreateProxyData;
+
+static void
+create_proxy_data_free (CreateProxyData * data)
+{
+  g_free (data->uri);
+  g_free (data->proxy_uri);
+  gst_object_unref (data->profile);
+  g_free (data);
+}
+
+static void
+proxy_pad_added_cb (GstElement * decodebin, GstPad * pad, GstElement * ebin)
+{
+  GstCaps *caps = gst_pad_query_caps (pad, NULL);
+  GstPad *sinkpad = NULL;
+
+  g_signal_emit_by_name (ebin, "request-pad", caps, &sinkpad);
+  if (!sinkpad) {
+    GstElement *fakesink = gst_element_factory_make ("fakesink", NULL);
+
+    GST_INFO_OBJECT (ebin, "Not transcoding stream with caps %" GST_PTR_FORMAT,
+        caps);
+    gst_bin_add (GST_BIN (GST_OBJECT_PARENT (ebin)), fakesink);
+    gst_element_sync_state_with_parent (fakesink);
+    sinkpad = gst_element_get_static_pad (fakesink, "sink");
+  }
+
+  if (gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)
+    GST_WARNING_OBJECT (ebin, "Could not link %" GST_PTR_FORMAT, pad);
+
+  gst_object_unref (sinkpad);
+  gst_caps_unref (caps);
+}
+
+/* Runs in a thread of the GTask pool */
+static gboolean
+transcode_proxy (CreateProxyData * data, GCancellable * cancellable,
+    GError ** error)
+{
+  GstElement *pipeline, *decodebin, *ebin, *sink;
+  GstMessage *msg = NULL;
+  GstBus *bus;
+  gboolean res = FALSE;
+
+  sink = gst_element_make_from_uri (GST_URI_SINK, data->proxy_uri, NULL,
+      error);
+  if (!sink)
+    return FALSE;
+
+  decodebin = gst_element_factory_make ("uridecodebin", NULL);
+  ebin = gst_element_factory_make ("encodebin", NULL);
+  if (!decodebin || !ebin) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_MISSING_PLUGIN,
+        "Missing uridecodebin or encodebin to create proxies");
+    gst_clear_object (&decodebin);
+    gst_clear_object (&ebin);
+    gst_object_unref (sink);
+
+    return FALSE;
+  }
+
+  pipeline = gst_pipeline_new ("proxy-transcoder");
+  g_object_set (decodebin, "uri", data->uri, NULL);
+  g_object_set (ebin, "profile", data->profile, NULL);
+  gst_bin_add_many (GST_BIN (pipeline), decodebin, ebin, sink, NULL);
+  gst_element_link (ebin, sink);
+  g_signal_connect (decodebin, "pad-added", G_CALLBACK (proxy_pad_added_cb),
+      ebin);
+
+  bus = gst_element_get_bus (pipeline);
+  if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+    msg = gst_bus_pop_filtered (bus, GST_MESSAGE_ERROR);
+
+  /* Wake up regularly to check for cancellation */
+  while (!msg && !g_cancellable_is_cancelled (cancellable))
+    msg = gst_bus_timed_pop_filtered (bus, 100 * GST_MSECOND,
+        GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+
+  if (msg && GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS) {
+    res = TRUE;
+  } else if (msg) {
+    gst_message_parse_error (msg, error, NULL);
+  } else {
+    g_cancellable_set_error_if_cancelled (cancellable, error);
+  }
+
+  if (!res && error && !*error)
+    g_set_error (error, GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "Could not create proxy %s", data->proxy_uri);
+
+  gst_clear_message (&msg);
+  gst_object_unref (bus);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  return res;
+}
+
+static void
+transcode_proxy_thread (GTask * task, GESUriClipAsset * self,
+    CreateProxyData * data, GCancellable * cancellable)
+{
+  GFile *file = g_file_new_for_uri (data->proxy_uri);
+  GError *error = NULL;
+
+  /* Proxies are only created once, they are reused in the next sessions */
+  if (g_file_query_exists (file, cancellable)) {
+    GST_INFO_OBJECT (self, "Reusing existing proxy %s", data->proxy_uri);
+  } else if (!transcode_proxy (data, cancellable, &error)) {
+    g_file_delete (file, NULL, NULL);
+    g_task_return_error (task, error);
+    gst_object_unref (file);
+
+    return;
+  }
+
+  gst_object_unref (file);
+  g_task_return_boolean (task, TRUE);
+}
+
+static void
+proxy_loaded_cb (GObject * source, GAsyncResult * res, GTask * task)
+{
+  GESUriClipAsset *self = g_task_get_source_object (task);
+  GError *error = NULL;
+  GESAsset *proxy;
+
+  proxy = ges_asset_request_finish (res, &error);
+  if (!proxy) {
+    g_task_return_error (task, error);
+  } else if (!ges_asset_set_proxy (GES_ASSET (self), proxy)) {
+    g_task_return_new_error (task, GES_ERROR, GES_ERROR_ASSET_LOADING,
+        "Could not use %s as a proxy of %s", ges_asset_get_id (proxy),
+        ges_asset_get_id (GES_ASSET (self)));
+    gst_object_unref (proxy);
+  } else {
+    g_task_return_pointer (task, proxy, gst_object_unref);
+  }
+
+  g_object_unref (task);
+}
+
+static void
+proxy_transcoded_cb (GESUriClipAsset * self, GAsyncResult * res, GTask * task)
+{
+  CreateProxyData *data = g_task_get_task_data (G_TASK (res));
+  GError *error = NULL;
+
+  if (!g_task_propagate_boolean (G_TASK (res), &error)) {
+    g_task_return_error (task, error);
+    g_object_unref (task);
+
+    return;
+  }
+
+  ges_asset_request_async (GES_TYPE_URI_CLIP, data->proxy_uri,
+      g_task_get_cancellable (task), (GAsyncReadyCallback) proxy_loaded_cb,
+      task);
+}
+
+/**
+ * ges_uri_clip_asset_create_proxy_async:
+ * @self: A #GESUriClipAsset
+ * @profile: The #GstEncodingProfile to encode the proxy with, usually with
+ * restriction caps setting a lower resolution than the one of @self
+ * @proxy_uri: (nullable): The URI to write the proxy to, or %NULL to write
+ * it next to the file of @self
+ * @cancellable: (nullable): Optional #GCancellable object, %NULL to ignore
+ * @callback: The callback to call when the proxy is ready
+ * @user_data: User data to pass to @callback
+ *
+ * Transcodes the media of @self with @profile in the background and sets the
+ * resulting asset as the default proxy of @self (see ges_asset_set_proxy())
+ * so that the clips extracted from @self afterwards decode the proxy
+ * instead, which makes the playback of heavy media like 4K footage a lot
+ * cheaper while editing. Clips already in a timeline keep their asset, use
+ * ges_extractable_set_asset() to switch them to the proxy, and back to
+ * @self before rendering.
+ *
+ * If @proxy_uri is %NULL, the proxy is written next to the file of @self,
+ * with `.proxy.` and the file extension of @profile appended to its name.
+ * An existing file at that URI is considered to be a proxy created earlier
+ * and is used without transcoding again.
+ *
+ * Call ges_uri_clip_asset_create_proxy_finish() from @callback to get the
+ * proxy.
+ *
+ * Since: 1.24
+ */
+void
+ges_uri_clip_asset_create_proxy_async (GESUriClipAsset * self,
+    GstEncodingProfile * profile, const gchar * proxy_uri,
+    GCancellable * cancellable, GAsyncReadyCallback callback,
+    gpointer user_data)
+{
+  GTask *task, *transcode_task;
+  CreateProxyData *data;
+  const gchar *ext;
+
+  g_return_if_fail (GES_IS_URI_CLIP_ASSET (self));
+  g_return_if_fail (GST_IS_ENCODING_PROFILE (profile));
+
+  task = g_task_new (self, cancellable, callback, user_data);
+
+  data = g_new0 (CreateProxyData, 1);
+  data->uri = g_strdup (ges_asset_get_id (GES_ASSET (self)));
+  data->profile = gst_object_ref (profile);
+  if (proxy_uri) {
+    data->proxy_uri = g_strdup (proxy_uri);
+  } else {
+    ext = gst_encoding_profile_get_file_extension (profile);
+    data->proxy_uri = g_strdup_printf ("%s.proxy.%s", data->uri,
+        ext ? ext : "proxy");
+  }
+
+  transcode_task = g_task_new (self, cancellable,
+      (GAsyncReadyCallback) proxy_transcoded_cb, task);
+  g_task_set_task_data (transcode_task, data,
+      (GDestroyNotify) create_proxy_data_free);
+  g_task_run_in_thread (transcode_task,
+      (GTaskThreadFunc) transcode_proxy_thread);
+  g_object_unref (transcode_task);
+}
+
+/**
+ * ges_uri_clip_asset_create_proxy_finish:
+ * @self: A #GESUriClipAsset
+ * @res: The #GAsyncResult passed to the callback of
+ * ges_uri_clip_asset_create_proxy_async()
+ * @error: An error to be set in case something wrong happens or %NULL
+ *
+ * Finishes the creation of a proxy of @self started with
+ * ges_uri_clip_asset_create_proxy_async().
+ *
+ * Returns: (transfer full) (nullable): The proxy, which is now the default
+ * proxy of @self, or %NULL if an error happened
+ *
+ * Since: 1.24
+ */
+GESUriClipAsset *
+ges_uri_clip_asset_create_proxy_finish (GESUriClipAsset * self,
+    GAsyncResult * res, GError ** error)
+{
+  g_return_val_if_fail (GES_IS_URI_CLIP_ASSET (self), NULL);
+  g_return_val_if_fail (g_task_is_valid (res, self), NULL);
+
+  return g_task_propagate_pointer (G_TASK (res), error);
+}
+
 /*****************************************************************
  *            GESUriSourceAsset implementation             *
  *****************************************************************/
@@ -23,6 +23,7 @@
 
 #include <glib-object.h>
 #include <gio/gio.h>
+#include <gst/pbutils/encoding-profile.h>
 #include <ges/ges-types.h>
 #include <ges/ges-asset.h>
 #include <ges/ges-source-clip-asset.h>
@@ -81,6 +82,17 @@ void ges_uri_clip_asset_class_set_timeout           (GESUriClipAssetClass *klass
                                                      GstClockTime timeout);
 GES_API
 const GList * ges_uri_clip_asset_get_stream_assets  (GESUriClipAsset *self);
+GES_API
+void ges_uri_clip_asset_create_proxy_async          (GESUriClipAsset *self,
+                                                     GstEncodingProfile *profile,
+                                                     const gchar *proxy_uri,
+                                                     GCancellable *cancellable,
+                                                     GAsyncReadyCallback callback,
+                                                     gpointer user_data);
+GES_API
+GESUriClipAsset * ges_uri_clip_asset_create_proxy_finish (GESUriClipAsset *self,
+                                                     GAsyncResult *res,
+                                                     GError **error);
 
 #define GES_TYPE_URI_SOURCE_ASSET ges_uri_source_asset_get_type()
 GES_DECLARE_TYPE(UriSourceAsset, uri_source_asset, URI_SOURCE_ASSET);
@@ -271,7 +271,7 @@ static gboolean _nle_composition_add_object (NleComposition * comp,
 static gboolean _nle_composition_remove_object (NleComposition * comp,
     NleObject * object);
 static void _deactivate_stack (NleComposition * comp,
-    NleUpdateStackReason reason);
+    NleUpdateStackReason reason, GList * reused);
 static void _set_real_eos_seqnum_from_seek (NleComposition * comp,
     GstEvent * event);
 static void _emit_commited_signal_func (NleComposition * comp, gpointer udata);
@@ -666,7 +666,7 @@ _process_pending_entries (NleComposition * comp, NleUpdateStackReason reason)
           deactivated_stack == FALSE) {
         deactivated_stack = TRUE;
 
-        _deactivate_stack (comp, reason);
+        _deactivate_stack (comp, reason, NULL);
       }
 
       _nle_composition_remove_object (comp, object);
@@ -1293,30 +1293,41 @@ signal_duration_change (NleComposition * comp)
       gst_message_new_duration_changed (GST_OBJECT_CAST (comp)));
 }
 
+typedef struct
+{
+  GstBin *bin;
+  /* children to leave in the bin */
+  GList *keep;
+} EmptyBinData;
+
 static gboolean
-_remove_child (GValue * item, GValue * ret G_GNUC_UNUSED, GstBin * bin)
+_remove_child (GValue * item, GValue * ret G_GNUC_UNUSED, EmptyBinData * data)
 {
   GstElement *child = g_value_get_object (item);
 
+  if (g_list_find (data->keep, child))
+    return TRUE;
+
   if (NLE_IS_OPERATION (child))
     nle_operation_hard_cleanup (NLE_OPERATION (child));
 
 
-  gst_bin_remove (bin, child);
+  gst_bin_remove (data->bin, child);
 
   return TRUE;
 }
 
 static void
-_empty_bin (GstBin * bin)
+_empty_bin (GstBin * bin, GList * keep)
 {
   GstIterator *children;
+  EmptyBinData data = { bin, keep };
 
   children = gst_bin_iterate_elements (bin);
 
   while (G_UNLIKELY (gst_iterator_fold (children,
               (GstIteratorFoldFunction) _remove_child, NULL,
-              bin) == GST_ITERATOR_RESYNC)) {
+              &data) == GST_ITERATOR_RESYNC)) {
     gst_iterator_resync (children);
   }
 
@@ -1351,7 +1362,7 @@ nle_composition_reset (NleComposition * comp)
   priv->next_eos_seqnum = 0;
   priv->flush_seqnum = 0;
 
-  _empty_bin (GST_BIN_CAST (priv->current_bin));
+  _empty_bin (GST_BIN_CAST (priv->current_bin), NULL);
 
   GST_DEBUG_OBJECT (comp, "Composition now resetted");
 }
@@ -2676,7 +2687,7 @@ nle_composition_change_state (GstElement * element, GstStateChange transition)
 
       _remove_update_actions (comp);
       _remove_seek_actions (comp);
-      _deactivate_stack (comp, TRUE);
+      _deactivate_stack (comp, TRUE, NULL);
       comp->priv->tearing_down_stack = TRUE;
       break;
     case GST_STATE_CHANGE_READY_TO_NULL:
@@ -2950,6 +2961,7 @@ _relink_single_node (NleComposition * comp, GNode * node,
   NleObject *newobj;
   NleObject *newparent;
   GstPad *srcpad = NULL, *sinkpad = NULL;
+  gboolean reused;
 
   if (G_UNLIKELY (!node))
     return;
@@ -2962,8 +2974,13 @@ _relink_single_node (NleComposition * comp, GNode * node,
 
   srcpad = NLE_OBJECT_SRC (newobj);
 
-  gst_bin_add (GST_BIN (comp->priv->current_bin), GST_ELEMENT (newobj));
-  gst_element_sync_state_with_parent (GST_ELEMENT_CAST (newobj));
+  /* Sources reused from the previous stack are still in the bin, running */
+  reused = GST_OBJECT_PARENT (newobj) ==
+      GST_OBJECT_CAST (comp->priv->current_bin);
+  if (!reused) {
+    gst_bin_add (GST_BIN (comp->priv->current_bin), GST_ELEMENT (newobj));
+    gst_element_sync_state_with_parent (GST_ELEMENT_CAST (newobj));
+  }
 
   /* link to parent if needed.  */
   if (newparent) {
@@ -2980,6 +2997,10 @@ _relink_single_node (NleComposition * comp, GNode * node,
   if (NLE_IS_OPERATION (newobj))
     _relink_children_recursively (comp, newobj, node, toplevel_seek);
 
+  /* It follows the state of the bin again from now on */
+  if (reused)
+    gst_element_set_locked_state (GST_ELEMENT_CAST (newobj), FALSE);
+
   GST_LOG_OBJECT (comp, "done with object %s",
       GST_ELEMENT_NAME (GST_ELEMENT (newobj)));
 }
@@ -2999,17 +3020,96 @@ _relink_single_node (NleComposition * comp, GNode * node,
  * Returns: The #GList of #NleObject no longer used
  */
 
+/*
+ * _get_reused_sources:
+ * @comp: The #NleComposition
+ * @old_stack: The current stack
+ * @new_stack: The stack replacing it
+ *
+ * Gets the sources that are used by both stacks and can keep running while
+ * the rest of the stack is rebuilt, instead of going through READY, which
+ * for most sources means typefinding, demuxing and creating the decoders
+ * again. The toplevel element is never reused as it's the target of the
+ * composition's source pad.
+ *
+ * Returns: The #GList of #NleObject to keep in the current bin
+ */
+typedef struct
+{
+  NleComposition *comp;
+  GNode *old_stack;
+  GList *reused;
+} ReusedSourcesData;
+
+static gboolean
+_find_reused_source (GNode * node, ReusedSourcesData * data)
+{
+  NleObject *object = node->data;
+  GNode *old_node;
+
+  if (G_NODE_IS_ROOT (node) || !NLE_IS_SOURCE (object))
+    return FALSE;
+
+  old_node = g_node_find (data->old_stack, G_IN_ORDER, G_TRAVERSE_LEAVES,
+      object);
+  if (old_node && !G_NODE_IS_ROOT (old_node)) {
+    GST_DEBUG_OBJECT (data->comp, "Reusing %s in the new stack",
+        GST_OBJECT_NAME (object));
+    data->reused = g_list_prepend (data->reused, object);
+  }
+
+  return FALSE;
+}
+
+static GList *
+_get_reused_sources (NleComposition * comp, GNode * old_stack,
+    GNode * new_stack)
+{
+  ReusedSourcesData data = { comp, old_stack, NULL };
+
+  if (!old_stack || !new_stack)
+    return NULL;
+
+  g_node_traverse (new_stack, G_IN_ORDER, G_TRAVERSE_LEAVES, -1,
+      (GNodeTraverseFunc) _find_reused_source, &data);
+
+  return data.reused;
+}
+
+/* Stops data flow in a source kept from the previous stack and unlinks it
+ * from its previous parent, it gets flushed again by the stack initialization
+ * seek */
 static void
-_deactivate_stack (NleComposition * comp, NleUpdateStackReason reason)
+_detach_reused_source (NleComposition * comp, NleObject * object)
+{
+  GstPad *srcpad = NLE_OBJECT_SRC (object);
+  GstPad *peer;
+
+  gst_element_set_locked_state (GST_ELEMENT_CAST (object), TRUE);
+  gst_pad_send_event (srcpad, gst_event_new_flush_start ());
+
+  peer = gst_pad_get_peer (srcpad);
+  if (peer) {
+    gst_pad_unlink (srcpad, peer);
+    gst_object_unref (peer);
+  }
+}
+
+static void
+_deactivate_stack (NleComposition * comp, NleUpdateStackReason reason,
+    GList * reused)
 {
   GstPad *ptarget;
+  GList *tmp;
 
-  GST_INFO_OBJECT (comp, "Deactivating current stack (reason: %s)",
-      UPDATE_PIPELINE_REASONS[reason]);
+  GST_INFO_OBJECT (comp, "Deactivating current stack (reason: %s, %u sources "
+      "reused)", UPDATE_PIPELINE_REASONS[reason], g_list_length (reused));
+  for (tmp = reused; tmp; tmp = tmp->next)
+    _detach_reused_source (comp, tmp->data);
   _set_current_bin_to_ready (comp, reason);
 
   ptarget = gst_ghost_pad_get_target (GST_GHOST_PAD (NLE_OBJECT_SRC (comp)));
-  _empty_bin (GST_BIN_CAST (comp->priv->current_bin));
+  _empty_bin (GST_BIN_CAST (comp->priv->current_bin), reused);
 
   if (comp->priv->ghosteventprobe) {
     GST_INFO_OBJECT (comp, "Removing old ghost pad probe");
@@ -3298,6 +3398,7 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
 
   GNode *stack = NULL;
   gboolean tear_down = FALSE;
+  gboolean forced_tear_down = FALSE;
   gboolean updatestoponly = FALSE;
   GstState state = GST_STATE (comp);
   NleCompositionPrivate *priv = comp->priv;
@@ -3335,8 +3436,9 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
 
   /* Get new stack and compare it to current one */
   stack = get_clean_toplevel_stack (comp, &currenttime, &new_start, &new_stop);
-  tear_down = !are_same_stacks (priv->current, stack)
-      || nle_composition_query_needs_teardown (comp, update_reason);
+  forced_tear_down = nle_composition_query_needs_teardown (comp,
+      update_reason);
+  tear_down = forced_tear_down || !are_same_stacks (priv->current, stack);
 
   /* set new current_stack_start/stop (the current zone over which the new stack
    * is valid) */
@@ -3381,9 +3483,18 @@ update_pipeline (NleComposition * comp, GstClockTime currenttime, gint32 seqnum,
 
   /* If stacks are different, unlink/relink objects */
   if (tear_down) {
+    GList *reused = NULL;
+
+    /* Only keep sources running when the new stack gets flushed and seeked
+     * anyway */
+    if (!forced_tear_down && (update_reason == COMP_UPDATE_STACK_ON_COMMIT
+            || update_reason == COMP_UPDATE_STACK_ON_SEEK))
+      reused = _get_reused_sources (comp, priv->current, stack);
+
     _dump_stack (comp, update_reason, stack);
-    _deactivate_stack (comp, update_reason);
+    _deactivate_stack (comp, update_reason, reused);
     _relink_new_stack (comp, stack, gst_event_ref (toplevel_seek));
+    g_list_free (reused);
   }
 
   /* Unlock all elements in new stack */
@@ -23,6 +23,7 @@
 
 #include <glib.h>
 #include <glib/gprintf.h>
+#include <glib/gstdio.h>
 #include <stdlib.h>
 #include <string.h>
 #ifdef G_OS_UNIX
@@ -58,6 +59,14 @@ struct _GESLauncherPrivate
   gdouble rate;
 
   GstState desired_state;       /* as per user interaction, PAUSED or PLAYING */
+
+  /* parallel rendering, render_profile is only set when rendering in
+   * parallel */
+  GstEncodingProfile *render_profile;
+  gchar *render_dir;
+  GPtrArray *render_chunks;     /* RenderChunk */
+  guint render_chunks_done;
+  GstElement *join_pipeline;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (GESLauncher, ges_launcher, G_TYPE_APPLICATION);
@@ -698,6 +707,13 @@ _set_rendering_details (GESLauncher * self)
       g_signal_connect (self->priv->pipeline, "deep-element-added",
           G_CALLBACK (disable_bframe_for_smart_rendering_cb), NULL);
     }
+    if (opts->render_jobs > 1 && opts->smartrender) {
+      ges_warn ("--render-jobs is not supported with smart rendering, "
+          "rendering in a single pipeline");
+    } else if (opts->render_jobs > 1 && prof) {
+      self->priv->render_profile = gst_encoding_profile_ref (prof);
+    }
+
     if (!prof
         || !ges_pipeline_set_render_settings (self->priv->pipeline,
             opts->outputuri, prof)
@@ -842,6 +858,377 @@ _project_loading_error_cb (GESProject * project, GESTimeline * timeline,
   g_application_quit (G_APPLICATION (self));
 }
 
+typedef struct
+{
+  GESLauncher *launcher;
+  GESPipeline *pipeline;
+  gchar *uri;
+} RenderChunk;
+
+static void
+render_chunk_free (RenderChunk * chunk)
+{
+  GstBus *bus = gst_pipeline_get_bus (GST_PIPELINE (chunk->pipeline));
+
+  gst_bus_remove_signal_watch (bus);
+  gst_object_unref (bus);
+  gst_element_set_state (GST_ELEMENT (chunk->pipeline), GST_STATE_NULL);
+  gst_object_unref (chunk->pipeline);
+  g_free (chunk->uri);
+  g_free (chunk);
+}
+
+static void
+_remove_render_dir (GESLauncher * self)
+{
+  const gchar *name;
+  GDir *dir;
+
+  if (!self->priv->render_dir)
+    return;
+
+  if ((dir = g_dir_open (self->priv->render_dir, 0, NULL))) {
+    while ((name = g_dir_read_name (dir))) {
+      gchar *path = g_build_filename (self->priv->render_dir, name, NULL);
+
+      g_unlink (path);
+      g_free (path);
+    }
+    g_dir_close (dir);
+  }
+  g_rmdir (self->priv->render_dir);
+  g_clear_pointer (&self->priv->render_dir, g_free);
+}
+
+static void
+_render_failed (GESLauncher * self, GstMessage * message)
+{
+  GError *err = NULL;
+  gchar *dbg_info = NULL;
+
+  gst_message_parse_error (message, &err, &dbg_info);
+  ges_printerr ("ERROR from element %s: %s\n",
+      GST_OBJECT_NAME (message->src), err->message);
+  ges_printerr ("Debugging info: %s\n", (dbg_info) ? dbg_info : "none");
+  g_clear_error (&err);
+  g_free (dbg_info);
+  self->priv->seenerrors = TRUE;
+  g_application_quit (G_APPLICATION (self));
+}
+
+static void
+join_message_cb (GstBus * bus, GstMessage * message, GESLauncher * self)
+{
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ERROR:
+      _render_failed (self, message);
+      break;
+    case GST_MESSAGE_EOS:
+      ges_ok ("\nDone\n");
+      g_application_quit (G_APPLICATION (self));
+      break;
+    default:
+      break;
+  }
+}
+
+static void
+join_pad_added_cb (GstElement * splitmuxsrc, GstPad * pad, GstElement * ebin)
+{
+  GstCaps *caps = gst_pad_query_caps (pad, NULL);
+  GstPad *sinkpad = NULL;
+
+  g_signal_emit_by_name (ebin, "request-pad", caps, &sinkpad);
+  if (!sinkpad || gst_pad_link (pad, sinkpad) != GST_PAD_LINK_OK)
+    GST_ERROR_OBJECT (ebin, "Could not link stream with caps %" GST_PTR_FORMAT,
+        caps);
+
+  gst_clear_object (&sinkpad);
+  gst_caps_unref (caps);
+}
+
+/* Concatenates the encoded segments into the output file, the encoders are
+ * bypassed as the streams already match the profile */
+static void
+_join_render_chunks (GESLauncher * self)
+{
+  GESLauncherParsedOptions *opts = &self->priv->parsed_options;
+  GstElement *pipeline, *src, *ebin, *sink;
+  RenderChunk *first = g_ptr_array_index (self->priv->render_chunks, 0);
+  gchar *location, *pattern, *ext;
+  GError *err = NULL;
+  GstBus *bus;
+
+  gst_print ("Joining %u rendered segments\n", self->priv->render_chunks->len);
+
+  src = gst_element_factory_make ("splitmuxsrc", NULL);
+  ebin = gst_element_factory_make ("encodebin", NULL);
+  sink = gst_element_make_from_uri (GST_URI_SINK, opts->outputuri, NULL, &err);
+  if (!src || !ebin || !sink) {
+    ges_printerr ("Could not create the elements to join the segments: %s\n",
+        err ? err->message : "splitmuxsrc or encodebin missing");
+    g_clear_error (&err);
+    gst_clear_object (&src);
+    gst_clear_object (&ebin);
+    gst_clear_object (&sink);
+    self->priv->seenerrors = TRUE;
+    g_application_quit (G_APPLICATION (self));
+    return;
+  }
+
+  location = gst_uri_get_location (first->uri);
+  ext = get_file_extension (location);
+  pattern = g_strdup_printf ("%s" G_DIR_SEPARATOR_S "segment-*.%s",
+      self->priv->render_dir, ext);
+  g_object_set (src, "location", pattern, NULL);
+  g_free (pattern);
+  g_free (ext);
+  g_free (location);
+
+  g_object_set (ebin, "profile", self->priv->render_profile,
+      "avoid-reencoding", TRUE, NULL);
+
+  pipeline = gst_pipeline_new ("ges-launch-joiner");
+  gst_bin_add_many (GST_BIN (pipeline), src, ebin, sink, NULL);
+  gst_element_link (ebin, sink);
+  g_signal_connect (src, "pad-added", G_CALLBACK (join_pad_added_cb), ebin);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  gst_bus_add_signal_watch (bus);
+  g_signal_connect (bus, "message", G_CALLBACK (join_message_cb), self);
+  gst_object_unref (bus);
+
+  self->priv->join_pipeline = pipeline;
+  if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+    ges_printerr ("Failed to start joining the segments\n");
+    self->priv->seenerrors = TRUE;
+    g_application_quit (G_APPLICATION (self));
+  }
+}
+
+static void
+chunk_message_cb (GstBus * bus, GstMessage * message, RenderChunk * chunk)
+{
+  GESLauncher *self = chunk->launcher;
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_ERROR:
+      _render_failed (self, message);
+      break;
+    case GST_MESSAGE_EOS:
+      self->priv->render_chunks_done++;
+      gst_print ("Rendered segment %u/%u\n", self->priv->render_chunks_done,
+          self->priv->render_chunks->len);
+      if (self->priv->render_chunks_done == self->priv->render_chunks->len)
+        _join_render_chunks (self);
+      break;
+    default:
+      break;
+  }
+}
+
+/* A timeline playing the [@start, @stop[ segment of @nested, with the same
+ * tracks as the timeline being rendered */
+static GESTimeline *
+_create_chunk_timeline (GESLauncher * self, GESAsset * nested,
+    GstClockTime start, GstClockTime stop)
+{
+  GESTimeline *timeline = ges_timeline_new ();
+  GList *tracks, *tmp;
+  GESLayer *layer;
+
+  tracks = ges_timeline_get_tracks (self->priv->timeline);
+  for (tmp = tracks; tmp; tmp = tmp->next) {
+    GESTrack *track = tmp->data, *copy;
+    GstCaps *caps;
+
+    if (GES_IS_VIDEO_TRACK (track))
+      copy = GES_TRACK (ges_video_track_new ());
+    else if (GES_IS_AUDIO_TRACK (track))
+      copy = GES_TRACK (ges_audio_track_new ());
+    else
+      continue;
+
+    caps = ges_track_get_restriction_caps (track);
+    if (caps) {
+      ges_track_set_restriction_caps (copy, caps);
+      gst_caps_unref (caps);
+    }
+    ges_timeline_add_track (timeline, copy);
+  }
+  g_list_free_full (tracks, gst_object_unref);
+
+  layer = ges_timeline_append_layer (timeline);
+  if (!ges_layer_add_asset (layer, nested, 0, start, stop - start,
+          GES_TRACK_TYPE_UNKNOWN)) {
+    gst_object_unref (timeline);
+    return NULL;
+  }
+  ges_timeline_commit (timeline);
+
+  return timeline;
+}
+
+/* The framerate of the video track being rendered, 0/0 if not fixed */
+static void
+_get_output_framerate (GESLauncher * self, gint * fps_n, gint * fps_d)
+{
+  GList *tracks, *tmp;
+
+  *fps_n = *fps_d = 0;
+  tracks = ges_timeline_get_tracks (self->priv->timeline);
+  for (tmp = tracks; tmp; tmp = tmp->next) {
+    GstCaps *caps;
+
+    if (!GES_IS_VIDEO_TRACK (tmp->data))
+      continue;
+
+    caps = ges_track_get_restriction_caps (tmp->data);
+    if (caps && !gst_caps_is_empty (caps))
+      gst_structure_get_fraction (gst_caps_get_structure (caps, 0),
+          "framerate", fps_n, fps_d);
+    gst_clear_caps (&caps);
+  }
+  g_list_free_full (tracks, gst_object_unref);
+}
+
+static void
+_nested_timeline_loaded_cb (GObject * source, GAsyncResult * res,
+    GESLauncher * self)
+{
+  GESLauncherParsedOptions *opts = &self->priv->parsed_options;
+  GstClockTime duration = ges_timeline_get_duration (self->priv->timeline);
+  GError *err = NULL;
+  GESAsset *nested;
+  gint fps_n, fps_d;
+  guint64 frames = 0;
+  gchar *ext;
+  guint i, n_chunks = opts->render_jobs;
+
+  nested = ges_asset_request_finish (res, &err);
+  if (!nested) {
+    ges_printerr ("Could not load the timeline to render in parallel: %s\n",
+        err->message);
+    g_clear_error (&err);
+    self->priv->seenerrors = TRUE;
+    g_application_quit (G_APPLICATION (self));
+    return;
+  }
+
+  /* Each segment starts with a keyframe as it's encoded separately, cut on
+   * frame boundaries so that no frame is split among two segments */
+  _get_output_framerate (self, &fps_n, &fps_d);
+  if (fps_n > 0 && fps_d > 0) {
+    frames = gst_util_uint64_scale (duration, fps_n, fps_d * GST_SECOND);
+    n_chunks = MIN (n_chunks, MAX (frames, 1));
+  }
+
+  ext = get_file_extension (opts->outputuri);
+  if (!ext)
+    ext = g_strdup (gst_encoding_profile_get_file_extension
+        (self->priv->render_profile));
+
+  gst_print ("Rendering %u segments in parallel\n", n_chunks);
+  self->priv->render_chunks = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      render_chunk_free);
+  for (i = 0; i < n_chunks; i++) {
+    RenderChunk *chunk;
+    GESTimeline *timeline;
+    GstClockTime start, stop;
+    gchar *filename, *path;
+    GstBus *bus;
+
+    if (frames) {
+      start = gst_util_uint64_scale (frames * i / n_chunks,
+          fps_d * GST_SECOND, fps_n);
+      stop = i == n_chunks - 1 ? duration :
+          gst_util_uint64_scale (frames * (i + 1) / n_chunks,
+          fps_d * GST_SECOND, fps_n);
+    } else {
+      start = gst_util_uint64_scale (duration, i, n_chunks);
+      stop = gst_util_uint64_scale (duration, i + 1, n_chunks);
+    }
+
+    timeline = _create_chunk_timeline (self, nested, start, stop);
+    if (!timeline) {
+      ges_printerr ("Could not create the timeline of segment %u\n", i);
+      self->priv->seenerrors = TRUE;
+      g_application_quit (G_APPLICATION (self));
+      break;
+    }
+
+    chunk = g_new0 (RenderChunk, 1);
+    chunk->launcher = self;
+    filename = g_strdup_printf ("segment-%05u.%s", i, ext ? ext : "out");
+    path = g_build_filename (self->priv->render_dir, filename, NULL);
+    chunk->uri = gst_filename_to_uri (path, NULL);
+    g_free (path);
+    g_free (filename);
+
+    chunk->pipeline = ges_pipeline_new ();
+    ges_pipeline_set_timeline (chunk->pipeline, timeline);
+    ges_pipeline_set_render_settings (chunk->pipeline, chunk->uri,
+        self->priv->render_profile);
+    ges_pipeline_set_mode (chunk->pipeline, GES_PIPELINE_MODE_RENDER);
+    g_ptr_array_add (self->priv->render_chunks, chunk);
+
+    bus = gst_pipeline_get_bus (GST_PIPELINE (chunk->pipeline));
+    gst_bus_add_signal_watch (bus);
+    g_signal_connect (bus, "message", G_CALLBACK (chunk_message_cb), chunk);
+    gst_object_unref (bus);
+
+    GST_INFO_OBJECT (self, "Rendering [%" GST_TIME_FORMAT " - %"
+        GST_TIME_FORMAT "] to %s", GST_TIME_ARGS (start), GST_TIME_ARGS (stop),
+        chunk->uri);
+    if (gst_element_set_state (GST_ELEMENT (chunk->pipeline),
+            GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+      ges_printerr ("Failed to start rendering segment %u\n", i);
+      self->priv->seenerrors = TRUE;
+      g_application_quit (G_APPLICATION (self));
+      break;
+    }
+  }
+
+  g_free (ext);
+  gst_object_unref (nested);
+}
+
+/* Renders the timeline as several segments in parallel, each segment is
+ * a timeline nesting a saved copy of the timeline being rendered */
+static gboolean
+_render_in_parallel (GESLauncher * self)
+{
+  gchar *path, *uri;
+  GError *err = NULL;
+
+  self->priv->render_dir = g_dir_make_tmp ("ges-launch-XXXXXX", &err);
+  if (!self->priv->render_dir)
+    goto failed;
+
+  path = g_build_filename (self->priv->render_dir, "timeline.xges", NULL);
+  uri = gst_filename_to_uri (path, &err);
+  g_free (path);
+  if (!uri || !ges_timeline_save_to_uri (self->priv->timeline, uri, NULL,
+          TRUE, &err)) {
+    g_free (uri);
+    goto failed;
+  }
+
+  ges_asset_request_async (GES_TYPE_URI_CLIP, uri, NULL,
+      (GAsyncReadyCallback) _nested_timeline_loaded_cb, self);
+  g_free (uri);
+
+  return TRUE;
+
+failed:
+  ges_printerr ("Could not prepare the parallel rendering: %s\n",
+      err ? err->message : "unknown error");
+  g_clear_error (&err);
+
+  return FALSE;
+}
+
 static void
 _project_loaded_cb (GESProject * project, GESTimeline * timeline,
     GESLauncher * self)
@@ -900,6 +1287,12 @@ _project_loaded_cb (GESProject * project, GESTimeline * timeline,
   g_free (project_uri);
 
   if (!self->priv->seenerrors && opts->needs_set_state &&
+      self->priv->render_profile) {
+    if (!_render_in_parallel (self)) {
+      self->priv->seenerrors = TRUE;
+      g_application_quit (G_APPLICATION (self));
+    }
+  } else if (!self->priv->seenerrors && opts->needs_set_state &&
       gst_element_set_state (GST_ELEMENT (self->priv->pipeline),
           GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
     g_error ("Failed to start the pipeline\n");
@@ -1332,6 +1725,12 @@ ges_launcher_get_rendering_option_group (GESLauncherParsedOptions * opts)
     {"smart-rendering", 0, 0, G_OPTION_ARG_NONE, &opts->smartrender,
           "Avoid reencoding when rendering. This option implies --disable-mixing.",
         NULL},
+    {"render-jobs", 0, 0, G_OPTION_ARG_INT, &opts->render_jobs,
+          "Split the timeline into <jobs> segments, render them in parallel "
+          "and join them without reencoding. The output container has to be "
+          "readable by splitmuxsrc, like mp4 or matroska. "
+          "This will have no effect if no outputuri has been specified.",
+        "<jobs>"},
     {NULL}
   };
 
@@ -1694,6 +2093,18 @@ _shutdown (GApplication * application)
 
   _save_timeline (self);
 
+  g_clear_pointer (&self->priv->render_chunks, g_ptr_array_unref);
+  if (self->priv->join_pipeline) {
+    GstBus *bus = gst_pipeline_get_bus (GST_PIPELINE (self->priv->join_pipeline));
+
+    gst_bus_remove_signal_watch (bus);
+    gst_object_unref (bus);
+    gst_element_set_state (self->priv->join_pipeline, GST_STATE_NULL);
+    gst_clear_object (&self->priv->join_pipeline);
+  }
+  _remove_render_dir (self);
+  g_clear_pointer (&self->priv->render_profile, gst_encoding_profile_unref);
+
   if (self->priv->pipeline) {
     gst_element_set_state (GST_ELEMENT (self->priv->pipeline), GST_STATE_NULL);
     validate_res = ges_validate_clean (GST_PIPELINE (self->priv->pipeline));
@@ -33,6 +33,7 @@ typedef struct
   GESTrackType track_types;
   gboolean needs_set_state;
   gboolean smartrender;
+  gint render_jobs;
   gchar *scenario;
   gchar *testfile;
   gchar *format;
@@ -494,6 +494,61 @@ gst_ffmpeg_auto_max_threads (void)
   return (int) (n_threads);
 }
 
+/* Process wide limit for the number of libav worker threads, configured with
+ * the GST_AV_THREAD_BUDGET environment variable. Without it each element
+ * picks its thread count on its own, which is the historical behaviour. */
+static GMutex thread_budget_lock;
+static gint thread_budget = -1;
+static gint thread_budget_used = 0;
+
+static gint
+gst_ffmpeg_thread_budget_get_total (void)
+{
+  if (thread_budget < 0) {
+    const gchar *env = g_getenv ("GST_AV_THREAD_BUDGET");
+
+    thread_budget = 0;
+    if (env)
+      thread_budget = MAX ((gint) g_ascii_strtoll (env, NULL, 10), 0);
+  }
+
+  return thread_budget;
+}
+
+/* Returns the number of threads the caller may use, at most @wanted and at
+ * least 1. Has to be paired with gst_ffmpeg_thread_budget_release() */
+int
+gst_ffmpeg_thread_budget_acquire (int wanted)
+{
+  gint total, granted;
+
+  g_return_val_if_fail (wanted > 0, 1);
+
+  g_mutex_lock (&thread_budget_lock);
+  total = gst_ffmpeg_thread_budget_get_total ();
+  if (total == 0) {
+    granted = wanted;
+  } else {
+    granted = CLAMP (total - thread_budget_used, 1, wanted);
+  }
+  thread_budget_used += granted;
+  g_mutex_unlock (&thread_budget_lock);
+
+  GST_DEBUG ("granted %d of %d requested threads, %d of %d in use", granted,
+      wanted, thread_budget_used, total);
+
+  return granted;
+}
+
+void
+gst_ffmpeg_thread_budget_release (int n_threads)
+{
+  g_mutex_lock (&thread_budget_lock);
+  thread_budget_used -= n_threads;
+  g_assert (thread_budget_used >= 0);
+  g_mutex_unlock (&thread_budget_lock);
+}
+
 
 GType
 gst_av_codec_compliance_get_type (void)
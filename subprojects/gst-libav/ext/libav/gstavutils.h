@@ -105,6 +105,12 @@ gst_ffmpeg_init_pix_fmt_info(void);
 int
 gst_ffmpeg_auto_max_threads(void);
 
+int
+gst_ffmpeg_thread_budget_acquire(int wanted);
+
+void
+gst_ffmpeg_thread_budget_release(int n_threads);
+
 const gchar *
 gst_ffmpeg_get_codecid_longname (enum AVCodecID codec_id);
 
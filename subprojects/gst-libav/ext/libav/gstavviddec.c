@@ -410,6 +410,11 @@ gst_ffmpegviddec_close (GstFFMpegVidDec * ffmpegdec, gboolean reset)
   gst_ffmpeg_avcodec_close (ffmpegdec->context);
   ffmpegdec->opened = FALSE;
 
+  if (ffmpegdec->budget_threads > 0) {
+    gst_ffmpeg_thread_budget_release (ffmpegdec->budget_threads);
+    ffmpegdec->budget_threads = 0;
+  }
+
   for (i = 0; i < G_N_ELEMENTS (ffmpegdec->stride); i++)
     ffmpegdec->stride[i] = -1;
 
@@ -620,11 +625,16 @@ gst_ffmpegviddec_set_format (GstVideoDecoder * decoder,
     /* When thread type is FF_THREAD_FRAME, extra latency is introduced equal
      * to one frame per thread. We thus need to calculate the thread count ourselves */
     if ((!(oclass->in_plugin->capabilities & AV_CODEC_CAP_OTHER_THREADS)) ||
-        (ffmpegdec->context->thread_type & FF_THREAD_FRAME))
-      ffmpegdec->context->thread_count =
-          MIN (gst_ffmpeg_auto_max_threads (), 16);
-    else
+        (ffmpegdec->context->thread_type & FF_THREAD_FRAME)) {
+      /* Automatic thread counts are bounded by the process wide budget so
+       * many decoders in one process don't oversubscribe the CPUs */
+      ffmpegdec->budget_threads =
+          gst_ffmpeg_thread_budget_acquire (MIN (gst_ffmpeg_auto_max_threads
+              (), 16));
+      ffmpegdec->context->thread_count = ffmpegdec->budget_threads;
+    } else {
       ffmpegdec->context->thread_count = 0;
+    }
   } else
     ffmpegdec->context->thread_count = ffmpegdec->max_threads;
 
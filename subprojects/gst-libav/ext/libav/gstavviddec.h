@@ -82,6 +82,8 @@ struct _GstFFMpegVidDec
   gint lowres;
   gboolean direct_rendering;
   int max_threads;
+  /* threads taken from the process wide budget */
+  int budget_threads;
   gboolean output_corrupt;
   guint thread_type;
   GstAvCodecCompliance std_compliance;
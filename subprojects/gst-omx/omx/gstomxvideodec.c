@@ -755,6 +755,7 @@ gst_omx_video_dec_allocate_output_buffers (GstOMXVideoDec * self)
   GstBufferPool *pool;
   GstStructure *config;
   gboolean eglimage = FALSE, add_videometa = FALSE;
+  gboolean pool_too_small = FALSE;
   GstCaps *caps = NULL;
   guint min = 0, max = 0;
   GstVideoCodecState *state =
@@ -789,10 +790,15 @@ gst_omx_video_dec_allocate_output_buffers (GstOMXVideoDec * self)
     if (max == 0) {
       max = min;
     } else if (max < min) {
-      /* Can't use pool because can't have enough buffers */
+      /* Can't import the downstream buffers because the pool can't provide
+       * enough of them, but our own buffers can still be handed downstream
+       * and recycled without copying */
       GST_DEBUG_OBJECT (self,
-          "pool can only provide %d buffers but %d are required", max, min);
-      caps = NULL;
+          "pool can only provide %d buffers but %d are required, "
+          "using internal buffers", max, min);
+      pool_too_small = TRUE;
+      self->use_buffers = FALSE;
+      max = min;
     } else {
       min = max;
     }
@@ -802,7 +808,7 @@ gst_omx_video_dec_allocate_output_buffers (GstOMXVideoDec * self)
     gst_structure_free (config);
 
 #if defined (HAVE_GST_GL)
-    eglimage = self->eglimage
+    eglimage = self->eglimage && !pool_too_small
         && (allocator && GST_IS_GL_MEMORY_EGL_ALLOCATOR (allocator));
 #else
     eglimage = FALSE;
@@ -62,8 +62,11 @@ GST_DEBUG_CATEGORY_STATIC (gst_hls_sink2_debug);
 #define DEFAULT_TARGET_DURATION 15
 #define DEFAULT_PLAYLIST_LENGTH 5
 #define DEFAULT_SEND_KEYFRAME_REQUESTS TRUE
+#define DEFAULT_PART_DURATION 0
 
 #define GST_M3U8_PLAYLIST_VERSION 3
+/* byte range partial segments need a newer version */
+#define GST_M3U8_PLAYLIST_PART_VERSION 6
 
 enum
 {
@@ -75,6 +78,7 @@ enum
   PROP_TARGET_DURATION,
   PROP_PLAYLIST_LENGTH,
   PROP_SEND_KEYFRAME_REQUESTS,
+  PROP_PART_DURATION,
 };
 
 enum
@@ -110,6 +114,7 @@ static void gst_hls_sink2_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * spec);
 static void gst_hls_sink2_handle_message (GstBin * bin, GstMessage * message);
 static void gst_hls_sink2_reset (GstHlsSink2 * sink);
+static void gst_hls_sink2_write_playlist (GstHlsSink2 * sink);
 static GstStateChangeReturn
 gst_hls_sink2_change_state (GstElement * element, GstStateChange trans);
 static GstPad *gst_hls_sink2_request_new_pad (GstElement * element,
@@ -133,6 +138,7 @@ gst_hls_sink2_finalize (GObject * object)
   g_free (sink->playlist_location);
   g_free (sink->playlist_root);
   g_free (sink->current_location);
+  g_free (sink->current_entry_location);
   if (sink->playlist)
     gst_m3u8_playlist_free (sink->playlist);
 
@@ -257,6 +263,22 @@ gst_hls_sink2_class_init (GstHlsSink2Class * klass)
           DEFAULT_SEND_KEYFRAME_REQUESTS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstHlsSink2:part-duration:
+   *
+   * Target duration in milliseconds of the partial segments announced in
+   * the playlist for low-latency HLS. Partial segments are byte ranges of the
+   * fragment that is currently written, and the playlist is rewritten for
+   * every new one. 0 disables partial segments.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PART_DURATION,
+      g_param_spec_uint ("part-duration", "Part duration",
+          "The target duration in milliseconds of low-latency partial "
+          "segments (0 - disabled)", 0, G_MAXUINT, DEFAULT_PART_DURATION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstHlsSink2::get-playlist-stream:
    * @sink: the #GstHlsSink2
@@ -306,6 +328,21 @@ gst_hls_sink2_class_init (GstHlsSink2Class * klass)
   klass->get_fragment_stream = gst_hls_sink2_get_fragment_stream;
 }
 
+static gchar *
+gst_hls_sink2_get_entry_location (GstHlsSink2 * sink, const gchar * location)
+{
+  gchar *name = g_path_get_basename (location);
+  gchar *entry_location;
+
+  if (sink->playlist_root == NULL)
+    return name;
+
+  entry_location = g_build_filename (sink->playlist_root, name, NULL);
+  g_free (name);
+
+  return entry_location;
+}
+
 static gchar *
 on_format_location (GstElement * splitmuxsink, guint fragment_id,
     GstHlsSink2 * sink)
@@ -328,6 +365,14 @@ on_format_location (GstElement * splitmuxsink, guint fragment_id,
   }
   g_object_set (sink->giostreamsink, "stream", stream, NULL);
 
+  g_free (sink->current_entry_location);
+  sink->current_entry_location = sink->current_location ?
+      gst_hls_sink2_get_entry_location (sink, sink->current_location) : NULL;
+  sink->fragment_bytes = 0;
+  sink->part_offset = 0;
+  sink->part_start = GST_CLOCK_TIME_NONE;
+  sink->parts_duration = 0;
+
   if (stream)
     g_object_unref (stream);
 
@@ -336,10 +381,74 @@ on_format_location (GstElement * splitmuxsink, guint fragment_id,
   return NULL;
 }
 
+static void
+gst_hls_sink2_add_part (GstHlsSink2 * sink, gfloat duration)
+{
+  if (sink->fragment_bytes == sink->part_offset)
+    return;
+
+  gst_m3u8_playlist_add_part (sink->playlist, sink->current_entry_location,
+      duration, sink->part_offset, sink->fragment_bytes - sink->part_offset,
+      sink->part_independent);
+  sink->parts_duration += duration;
+  sink->part_offset = sink->fragment_bytes;
+}
+
+/* Tracks the bytes written to the current fragment and announces a new
+ * partial segment whenever the data since the previous one covers more
+ * than part-duration */
+static GstPadProbeReturn
+gst_hls_sink2_fragment_data_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstHlsSink2 * sink)
+{
+  GstBuffer *buffer;
+  GstClockTime ts;
+  gsize size;
+  gboolean updated = FALSE;
+
+  if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST (info);
+
+    if (gst_buffer_list_length (list) == 0)
+      return GST_PAD_PROBE_OK;
+
+    buffer = gst_buffer_list_get (list, 0);
+    size = gst_buffer_list_calculate_size (list);
+  } else {
+    buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+    size = gst_buffer_get_size (buffer);
+  }
+
+  ts = GST_BUFFER_DTS_OR_PTS (buffer);
+
+  if (sink->part_duration > 0 && sink->current_entry_location &&
+      GST_CLOCK_TIME_IS_VALID (ts)) {
+    if (!GST_CLOCK_TIME_IS_VALID (sink->part_start)) {
+      sink->part_start = ts;
+      sink->part_independent =
+          !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+    } else if (ts >= sink->part_start + sink->part_duration * GST_MSECOND) {
+      gst_hls_sink2_add_part (sink, ts - sink->part_start);
+      sink->part_start = ts;
+      sink->part_independent =
+          !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+      updated = TRUE;
+    }
+  }
+
+  sink->fragment_bytes += size;
+
+  if (updated)
+    gst_hls_sink2_write_playlist (sink);
+
+  return GST_PAD_PROBE_OK;
+}
+
 static void
 gst_hls_sink2_init (GstHlsSink2 * sink)
 {
   GstElement *mux;
+  GstPad *pad;
 
   sink->location = g_strdup (DEFAULT_LOCATION);
   sink->playlist_location = g_strdup (DEFAULT_PLAYLIST_LOCATION);
@@ -348,12 +457,19 @@ gst_hls_sink2_init (GstHlsSink2 * sink)
   sink->max_files = DEFAULT_MAX_FILES;
   sink->target_duration = DEFAULT_TARGET_DURATION;
   sink->send_keyframe_requests = DEFAULT_SEND_KEYFRAME_REQUESTS;
+  sink->part_duration = DEFAULT_PART_DURATION;
+  sink->part_start = GST_CLOCK_TIME_NONE;
   g_queue_init (&sink->old_locations);
 
   sink->splitmuxsink = gst_element_factory_make ("splitmuxsink", NULL);
   gst_bin_add (GST_BIN (sink), sink->splitmuxsink);
 
   sink->giostreamsink = gst_element_factory_make ("giostreamsink", NULL);
+  pad = gst_element_get_static_pad (sink->giostreamsink, "sink");
+  gst_pad_add_probe (pad,
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+      (GstPadProbeCallback) gst_hls_sink2_fragment_data_probe, sink, NULL);
+  gst_object_unref (pad);
 
   mux = gst_element_factory_make ("mpegtsmux", NULL);
   g_object_set (sink->splitmuxsink, "location", NULL, "max-size-time",
@@ -377,7 +493,10 @@ gst_hls_sink2_reset (GstHlsSink2 * sink)
   if (sink->playlist)
     gst_m3u8_playlist_free (sink->playlist);
   sink->playlist =
-      gst_m3u8_playlist_new (GST_M3U8_PLAYLIST_VERSION, sink->playlist_length);
+      gst_m3u8_playlist_new (sink->part_duration > 0 ?
+      GST_M3U8_PLAYLIST_PART_VERSION : GST_M3U8_PLAYLIST_VERSION,
+      sink->playlist_length);
+  sink->playlist->part_target = sink->part_duration * GST_MSECOND;
 
   g_queue_foreach (&sink->old_locations, (GFunc) g_free, NULL);
   g_queue_clear (&sink->old_locations);
@@ -442,15 +561,18 @@ gst_hls_sink2_handle_message (GstBin * bin, GstMessage * message)
 
           gst_structure_get_clock_time (s, "running-time", &running_time);
 
-          GST_INFO_OBJECT (sink, "COUNT %d", sink->index);
-          if (sink->playlist_root == NULL) {
-            entry_location = g_path_get_basename (sink->current_location);
-          } else {
-            gchar *name = g_path_get_basename (sink->current_location);
-            entry_location = g_build_filename (sink->playlist_root, name, NULL);
-            g_free (name);
+          /* the rest of the fragment is its last partial segment */
+          if (sink->part_duration > 0 && sink->current_entry_location) {
+            gfloat duration = running_time - sink->current_running_time_start;
+
+            gst_hls_sink2_add_part (sink,
+                MAX (duration - sink->parts_duration, 0));
           }
 
+          GST_INFO_OBJECT (sink, "COUNT %d", sink->index);
+          entry_location =
+              gst_hls_sink2_get_entry_location (sink, sink->current_location);
+
           gst_m3u8_playlist_add_entry (sink->playlist, entry_location,
               NULL, running_time - sink->current_running_time_start,
               sink->index++, FALSE);
@@ -649,6 +771,12 @@ gst_hls_sink2_set_property (GObject * object, guint prop_id,
             sink->send_keyframe_requests, NULL);
       }
       break;
+    case PROP_PART_DURATION:
+      sink->part_duration = g_value_get_uint (value);
+      sink->playlist->part_target = sink->part_duration * GST_MSECOND;
+      sink->playlist->version = sink->part_duration > 0 ?
+          GST_M3U8_PLAYLIST_PART_VERSION : GST_M3U8_PLAYLIST_VERSION;
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -683,6 +811,9 @@ gst_hls_sink2_get_property (GObject * object, guint prop_id,
     case PROP_SEND_KEYFRAME_REQUESTS:
       g_value_set_boolean (value, sink->send_keyframe_requests);
       break;
+    case PROP_PART_DURATION:
+      g_value_set_uint (value, sink->part_duration);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
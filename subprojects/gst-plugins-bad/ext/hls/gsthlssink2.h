@@ -50,6 +50,7 @@ struct _GstHlsSink2
   gint max_files;
   gint target_duration;
   gboolean send_keyframe_requests;
+  guint part_duration;
 
   GstM3U8Playlist *playlist;
   guint index;
@@ -58,6 +59,15 @@ struct _GstHlsSink2
   GstClockTime current_running_time_start;
   GQueue old_locations;
   GstM3U8PlaylistRenderState state;
+
+  /* partial segments of the current fragment, only accessed from the
+   * fragment streaming thread */
+  gchar *current_entry_location;
+  guint64 fragment_bytes;
+  guint64 part_offset;
+  GstClockTime part_start;
+  gboolean part_independent;
+  gfloat parts_duration;
 };
 
 struct _GstHlsSink2Class
@@ -26,6 +26,10 @@
 
 #define GST_CAT_DEFAULT hls_debug
 
+/* number of most recent segments for which the partial segments are kept
+ * in the playlist */
+#define GST_M3U8_PLAYLIST_PART_SEGMENTS 2
+
 enum
 {
   GST_M3U8_PLAYLIST_TYPE_EVENT,
@@ -33,6 +37,7 @@ enum
 };
 
 typedef struct _GstM3U8Entry GstM3U8Entry;
+typedef struct _GstM3U8Part GstM3U8Part;
 
 struct _GstM3U8Entry
 {
@@ -40,8 +45,26 @@ struct _GstM3U8Entry
   gchar *title;
   gchar *url;
   gboolean discontinuous;
+  GQueue *parts;
+};
+
+/* a partial segment, a byte range of the segment file at url */
+struct _GstM3U8Part
+{
+  gfloat duration;
+  gchar *url;
+  guint64 offset;
+  guint64 size;
+  gboolean independent;
 };
 
+static void
+gst_m3u8_part_free (GstM3U8Part * part)
+{
+  g_free (part->url);
+  g_free (part);
+}
+
 static GstM3U8Entry *
 gst_m3u8_entry_new (const gchar * url, const gchar * title,
     gfloat duration, gboolean discontinuous)
@@ -65,6 +88,8 @@ gst_m3u8_entry_free (GstM3U8Entry * entry)
 
   g_free (entry->url);
   g_free (entry->title);
+  if (entry->parts)
+    g_queue_free_full (entry->parts, (GDestroyNotify) gst_m3u8_part_free);
   g_free (entry);
 }
 
@@ -79,6 +104,7 @@ gst_m3u8_playlist_new (guint version, guint window_size)
   playlist->type = GST_M3U8_PLAYLIST_TYPE_EVENT;
   playlist->end_list = FALSE;
   playlist->entries = g_queue_new ();
+  playlist->pending_parts = g_queue_new ();
 
   return playlist;
 }
@@ -90,6 +116,8 @@ gst_m3u8_playlist_free (GstM3U8Playlist * playlist)
 
   g_queue_foreach (playlist->entries, (GFunc) gst_m3u8_entry_free, NULL);
   g_queue_free (playlist->entries);
+  g_queue_free_full (playlist->pending_parts,
+      (GDestroyNotify) gst_m3u8_part_free);
   g_free (playlist);
 }
 
@@ -122,9 +150,71 @@ gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
   playlist->sequence_number = index + 1;
   g_queue_push_tail (playlist->entries, entry);
 
+  /* The partial segments added so far belong to this entry, only keep them
+   * around for the most recent ones */
+  if (!g_queue_is_empty (playlist->pending_parts)) {
+    entry->parts = playlist->pending_parts;
+    playlist->pending_parts = g_queue_new ();
+
+    if (playlist->entries->length > GST_M3U8_PLAYLIST_PART_SEGMENTS) {
+      GstM3U8Entry *old_entry = g_queue_peek_nth (playlist->entries,
+          playlist->entries->length - GST_M3U8_PLAYLIST_PART_SEGMENTS - 1);
+
+      if (old_entry->parts) {
+        g_queue_free_full (old_entry->parts,
+            (GDestroyNotify) gst_m3u8_part_free);
+        old_entry->parts = NULL;
+      }
+    }
+  }
+
   return TRUE;
 }
 
+/* Adds a partial segment of the segment that is currently being written,
+ * it is moved to the segment's entry once that is added */
+gboolean
+gst_m3u8_playlist_add_part (GstM3U8Playlist * playlist, const gchar * url,
+    gfloat duration, guint64 offset, guint64 size, gboolean independent)
+{
+  GstM3U8Part *part;
+
+  g_return_val_if_fail (playlist != NULL, FALSE);
+  g_return_val_if_fail (url != NULL, FALSE);
+
+  if (playlist->type == GST_M3U8_PLAYLIST_TYPE_VOD)
+    return FALSE;
+
+  part = g_new0 (GstM3U8Part, 1);
+  part->url = g_strdup (url);
+  part->duration = duration;
+  part->offset = offset;
+  part->size = size;
+  part->independent = independent;
+
+  g_queue_push_tail (playlist->pending_parts, part);
+
+  return TRUE;
+}
+
+static void
+gst_m3u8_playlist_render_parts (GString * playlist_str, GQueue * parts)
+{
+  GList *l;
+
+  for (l = parts->head; l != NULL; l = l->next) {
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+    GstM3U8Part *part = l->data;
+
+    g_string_append_printf (playlist_str,
+        "#EXT-X-PART:DURATION=%s,URI=\"%s\",BYTERANGE=\"%" G_GUINT64_FORMAT
+        "@%" G_GUINT64_FORMAT "\"%s\n",
+        g_ascii_dtostr (buf, sizeof (buf), part->duration / GST_SECOND),
+        part->url, part->size, part->offset,
+        part->independent ? ",INDEPENDENT=YES" : "");
+  }
+}
+
 static guint
 gst_m3u8_playlist_target_duration (GstM3U8Playlist * playlist)
 {
@@ -159,6 +249,19 @@ gst_m3u8_playlist_render (GstM3U8Playlist * playlist)
 
   g_string_append_printf (playlist_str, "#EXT-X-TARGETDURATION:%u\n",
       gst_m3u8_playlist_target_duration (playlist));
+
+  if (playlist->part_target > 0) {
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+    /* players should stay at least three part durations behind the end */
+    g_string_append_printf (playlist_str,
+        "#EXT-X-SERVER-CONTROL:PART-HOLD-BACK=%s\n",
+        g_ascii_dtostr (buf, sizeof (buf),
+            (gdouble) (3 * playlist->part_target) / GST_SECOND));
+    g_string_append_printf (playlist_str, "#EXT-X-PART-INF:PART-TARGET=%s\n",
+        g_ascii_dtostr (buf, sizeof (buf),
+            (gdouble) playlist->part_target / GST_SECOND));
+  }
   g_string_append (playlist_str, "\n");
 
   /* Entries */
@@ -169,6 +272,9 @@ gst_m3u8_playlist_render (GstM3U8Playlist * playlist)
     if (entry->discontinuous)
       g_string_append (playlist_str, "#EXT-X-DISCONTINUITY\n");
 
+    if (entry->parts)
+      gst_m3u8_playlist_render_parts (playlist_str, entry->parts);
+
     if (playlist->version < 3) {
       g_string_append_printf (playlist_str, "#EXTINF:%d,%s\n",
           (gint) ((entry->duration + 500 * GST_MSECOND) / GST_SECOND),
@@ -182,6 +288,17 @@ gst_m3u8_playlist_render (GstM3U8Playlist * playlist)
     g_string_append_printf (playlist_str, "%s\n", entry->url);
   }
 
+  /* Parts of the segment that is currently written, plus a hint for the
+   * next part so that players can request it before it is complete */
+  if (!playlist->end_list && !g_queue_is_empty (playlist->pending_parts)) {
+    GstM3U8Part *last = g_queue_peek_tail (playlist->pending_parts);
+
+    gst_m3u8_playlist_render_parts (playlist_str, playlist->pending_parts);
+    g_string_append_printf (playlist_str,
+        "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"%s\",BYTERANGE-START=%"
+        G_GUINT64_FORMAT "\n", last->url, last->offset + last->size);
+  }
+
   if (playlist->end_list)
     g_string_append (playlist_str, "#EXT-X-ENDLIST");
 
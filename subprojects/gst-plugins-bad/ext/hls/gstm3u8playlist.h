@@ -35,9 +35,13 @@ struct _GstM3U8Playlist
   gint type;
   gboolean end_list;
   guint sequence_number;
+  /* target duration of partial segments in nanoseconds, 0 disables
+   * the low-latency tags */
+  guint64 part_target;
 
   /*< Private >*/
   GQueue *entries;
+  GQueue *pending_parts;
 };
 
 typedef enum
@@ -60,6 +64,13 @@ gboolean          gst_m3u8_playlist_add_entry (GstM3U8Playlist * playlist,
                                                guint             index,
                                                gboolean          discontinuous);
 
+gboolean          gst_m3u8_playlist_add_part (GstM3U8Playlist * playlist,
+                                              const gchar     * url,
+                                              gfloat            duration,
+                                              guint64           offset,
+                                              guint64           size,
+                                              gboolean          independent);
+
 gchar *           gst_m3u8_playlist_render (GstM3U8Playlist * playlist);
 
 G_END_DECLS
@@ -32,6 +32,8 @@
 #include <numeric>
 #include <cmath>
 #include <sstream>
+#include <map>
+#include <chrono>
 
 namespace GstOnnxNamespace
 {
@@ -58,7 +60,287 @@ GstMlOutputNodeInfo::GstMlOutputNodeInfo (void):index
 {
 }
 
+static Ort::Env & getEnv (void)
+{
+    static Ort::Env env (OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING,
+        "GstOnnxNamespace");
+
+    return env;
+}
+
+static size_t getElementSize (ONNXTensorElementDataType type)
+{
+    switch (type) {
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+        return 1;
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+        return 2;
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+      case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+        return 8;
+      default:
+        return 4;
+    }
+}
+
+// Sets @srcPtr to the first R, G and B samples of the frame, and
+// @samplesPerPixel to the distance between two samples of a channel
+static void getChannelPointers (uint8_t * img_data, GstVideoMeta * vmeta,
+      uint8_t * srcPtr[3], uint32_t * samplesPerPixel)
+{
+    srcPtr[0] = img_data;
+    srcPtr[1] = img_data + 1;
+    srcPtr[2] = img_data + 2;
+    *samplesPerPixel = 3;
+    switch (vmeta->format) {
+      case GST_VIDEO_FORMAT_RGBA:
+        *samplesPerPixel = 4;
+        break;
+      case GST_VIDEO_FORMAT_BGRA:
+        *samplesPerPixel = 4;
+        srcPtr[0] = img_data + 2;
+        srcPtr[1] = img_data + 1;
+        srcPtr[2] = img_data + 0;
+        break;
+      case GST_VIDEO_FORMAT_ARGB:
+        *samplesPerPixel = 4;
+        srcPtr[0] = img_data + 1;
+        srcPtr[1] = img_data + 2;
+        srcPtr[2] = img_data + 3;
+        break;
+      case GST_VIDEO_FORMAT_ABGR:
+        *samplesPerPixel = 4;
+        srcPtr[0] = img_data + 3;
+        srcPtr[1] = img_data + 2;
+        srcPtr[2] = img_data + 1;
+        break;
+      case GST_VIDEO_FORMAT_BGR:
+        srcPtr[0] = img_data + 2;
+        srcPtr[1] = img_data + 1;
+        srcPtr[2] = img_data + 0;
+        break;
+      case GST_VIDEO_FORMAT_RGBP:
+        *samplesPerPixel = 1;
+        srcPtr[0] = img_data + vmeta->offset[0];
+        srcPtr[1] = img_data + vmeta->offset[1];
+        srcPtr[2] = img_data + vmeta->offset[2];
+        break;
+      case GST_VIDEO_FORMAT_BGRP:
+        *samplesPerPixel = 1;
+        srcPtr[0] = img_data + vmeta->offset[2];
+        srcPtr[1] = img_data + vmeta->offset[1];
+        srcPtr[2] = img_data + vmeta->offset[0];
+        break;
+      default:
+        break;
+    }
+}
+
+std::shared_ptr < GstOnnxSession > GstOnnxSession::get (std::string modelFile,
+      GraphOptimizationLevel optim, GstOnnxExecutionProvider provider)
+{
+    static std::mutex sessionsLock;
+    static std::map < std::string, std::weak_ptr < GstOnnxSession > > sessions;
+    std::ostringstream key;
+
+    key << modelFile << ":" << optim << ":" << provider;
+
+    std::lock_guard < std::mutex > lk (sessionsLock);
+    auto res = sessions[key.str ()].lock ();
+    if (!res) {
+      GST_DEBUG ("Creating new session for %s", key.str ().c_str ());
+      res = std::make_shared < GstOnnxSession > (getEnv (), modelFile, optim,
+          provider);
+      sessions[key.str ()] = res;
+    } else {
+      GST_DEBUG ("Sharing session for %s", key.str ().c_str ());
+    }
+
+    return res;
+}
+
+GstOnnxSession::GstOnnxSession (Ort::Env & env, std::string modelFile,
+      GraphOptimizationLevel optim, GstOnnxExecutionProvider provider):
+      session (nullptr), dynamicBatch (false), collecting (false)
+{
+    Ort::SessionOptions sessionOptions;
+    // for debugging
+    //sessionOptions.SetIntraOpNumThreads (1);
+    sessionOptions.SetGraphOptimizationLevel (optim);
+#ifdef GST_ML_ONNX_RUNTIME_HAVE_CUDA
+    if (provider == GST_ONNX_EXECUTION_PROVIDER_CUDA)
+      Ort::ThrowOnError (OrtSessionOptionsAppendExecutionProvider_CUDA
+          (sessionOptions, 0));
+#endif
+    session = new Ort::Session (env, modelFile.c_str (), sessionOptions);
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    inputNames.push_back (session->GetInputNameAllocated (0, allocator));
+    auto inputDims =
+        session->GetInputTypeInfo (0).GetTensorTypeAndShapeInfo ().GetShape ();
+
+    // batching requires all the outputs to be batched too
+    dynamicBatch = !inputDims.empty () && inputDims[0] < 0;
+    for (size_t i = 0; i < session->GetOutputCount (); ++i) {
+      auto outputDims =
+          session->GetOutputTypeInfo (i).GetTensorTypeAndShapeInfo ().
+          GetShape ();
+
+      if (outputDims.empty () || outputDims[0] >= 0)
+        dynamicBatch = false;
+      outputNames.push_back (session->GetOutputNameAllocated (i, allocator));
+      outputNamesRaw.push_back (outputNames.back ().get ());
+    }
+    GST_DEBUG ("Model %s dynamic batching", dynamicBatch ?
+        "supports" : "does not support");
+}
+
+GstOnnxSession::~GstOnnxSession ()
+{
+    outputNamesRaw.clear ();
+    outputNames.clear ();
+    inputNames.clear ();
+    delete session;
+}
+
+Ort::Session & GstOnnxSession::getSession (void)
+{
+    return *session;
+}
+
+void GstOnnxSession::runBatch (std::vector < GstOnnxBatchRequest * > &batch)
+{
+    std::vector < int64_t > dims = batch[0]->dims;
+    std::vector < uint8_t > batchData;
+    uint8_t *data = (uint8_t *) batch[0]->data;
+    size_t size = batch[0]->size;
+
+    dims[0] = batch.size ();
+    if (batch.size () > 1) {
+      batchData.reserve (size * batch.size ());
+      for (auto req : batch)
+        batchData.insert (batchData.end (), req->data, req->data + req->size);
+      data = batchData.data ();
+      size = batchData.size ();
+    }
+
+    try {
+      auto memoryInfo =
+          Ort::MemoryInfo::CreateCpu (OrtAllocatorType::OrtArenaAllocator,
+          OrtMemType::OrtMemTypeDefault);
+      auto inputTensor = Ort::Value::CreateTensor < uint8_t > (memoryInfo,
+          data, size, dims.data (), dims.size ());
+      const char *inputName = inputNames[0].get ();
+
+      auto outputs = session->Run (Ort::RunOptions { nullptr}, &inputName,
+          &inputTensor, 1, outputNamesRaw.data (), outputNamesRaw.size ());
+
+      for (auto req : batch)
+        req->outputs.resize (outputs.size ());
+      for (size_t i = 0; i < outputs.size (); ++i) {
+        auto info = outputs[i].GetTensorTypeAndShapeInfo ();
+        size_t bytes =
+            info.GetElementCount () * getElementSize (info.GetElementType ());
+        size_t itemBytes = bytes / batch.size ();
+        auto src = (const uint8_t *) outputs[i].GetTensorRawData ();
+
+        for (size_t j = 0; j < batch.size (); ++j)
+          batch[j]->outputs[i].assign (src + j * itemBytes,
+              src + (j + 1) * itemBytes);
+      }
+    } catch (Ort::Exception & e) {
+      GST_ERROR ("Inference failed: %s", e.what ());
+      for (auto req : batch)
+        req->failed = true;
+    }
+}
+
+bool GstOnnxSession::run (GstOnnxBatchRequest & request, size_t maxBatchSize,
+      GstClockTime timeout)
+{
+    request.done = false;
+    request.failed = false;
+
+    if (!dynamicBatch || maxBatchSize <= 1) {
+      std::vector < GstOnnxBatchRequest * > batch { &request };
+      runBatch (batch);
+      return !request.failed;
+    }
+
+    std::unique_lock < std::mutex > lk (batchLock);
+    pending.push_back (&request);
+    batchCond.notify_all ();
+
+    while (!request.done) {
+      if (collecting) {
+        batchCond.wait (lk);
+        continue;
+      }
+
+      // Nobody is collecting a batch yet, collect the next one until it is
+      // full or the deadline is reached
+      collecting = true;
+      auto deadline = std::chrono::steady_clock::now () +
+          std::chrono::nanoseconds (timeout);
+      batchCond.wait_until (lk, deadline, [&] {
+            return pending.size () >= maxBatchSize;
+          });
+
+      std::vector < GstOnnxBatchRequest * > batch;
+      for (auto it = pending.begin (); it != pending.end () &&
+          batch.size () < maxBatchSize;) {
+        if ((*it)->dims == request.dims) {
+          batch.push_back (*it);
+          it = pending.erase (it);
+        } else {
+          ++it;
+        }
+      }
+      GST_LOG ("Running batch of %d requests", (gint) batch.size ());
+
+      // let the others collect the next batch while this one runs
+      collecting = false;
+      batchCond.notify_all ();
+      lk.unlock ();
+      runBatch (batch);
+      lk.lock ();
+
+      for (auto req : batch)
+        req->done = true;
+      batchCond.notify_all ();
+    }
+
+    return !request.failed;
+}
+
+void GstOnnxSession::runAll (std::vector < GstOnnxBatchRequest * > &requests,
+      size_t maxBatchSize)
+{
+    size_t batchSize = dynamicBatch ? MAX (maxBatchSize, 1) : 1;
+    std::vector < GstOnnxBatchRequest * > batch;
+
+    for (auto req : requests) {
+      req->done = false;
+      req->failed = false;
+      if (!batch.empty () && (batch.size () == batchSize ||
+              batch[0]->dims != req->dims)) {
+        runBatch (batch);
+        batch.clear ();
+      }
+      batch.push_back (req);
+    }
+    if (!batch.empty ())
+      runBatch (batch);
+}
+
 GstOnnxClient::GstOnnxClient ():session (nullptr),
+      maxBatchSize (1),
+      batchTimeout (0),
       width (0),
       height (0),
       channels (0),
@@ -74,16 +356,15 @@ GstOnnxClient::GstOnnxClient ():session (nullptr),
 GstOnnxClient::~GstOnnxClient ()
 {
     outputNames.clear();
-    delete session;
+    session = nullptr;
+    sharedSession.reset ();
     delete[]dest;
 }
 
-Ort::Env & GstOnnxClient::getEnv (void)
+void GstOnnxClient::setBatching (size_t batchSize, GstClockTime timeout)
 {
-    static Ort::Env env (OrtLoggingLevel::ORT_LOGGING_LEVEL_WARNING,
-        "GstOnnxNamespace");
-
-    return env;
+    maxBatchSize = batchSize;
+    batchTimeout = timeout;
 }
 
 int32_t GstOnnxClient::getWidth (void)
@@ -203,25 +484,13 @@ bool GstOnnxClient::createSession (std::string modelFile,
         break;
     };
 
-    Ort::SessionOptions sessionOptions;
-    // for debugging
-    //sessionOptions.SetIntraOpNumThreads (1);
-    sessionOptions.SetGraphOptimizationLevel (onnx_optim);
     m_provider = provider;
-    switch (m_provider) {
-      case GST_ONNX_EXECUTION_PROVIDER_CUDA:
-#ifdef GST_ML_ONNX_RUNTIME_HAVE_CUDA
-        Ort::ThrowOnError (OrtSessionOptionsAppendExecutionProvider_CUDA
-            (sessionOptions, 0));
-#else
-        return false;
+#ifndef GST_ML_ONNX_RUNTIME_HAVE_CUDA
+    if (m_provider == GST_ONNX_EXECUTION_PROVIDER_CUDA)
+      return false;
 #endif
-        break;
-      default:
-        break;
-
-    };
-    session = new Ort::Session (getEnv (), modelFile.c_str (), sessionOptions);
+    sharedSession = GstOnnxSession::get (modelFile, onnx_optim, m_provider);
+    session = &sharedSession->getSession ();
     auto inputTypeInfo = session->GetInputTypeInfo (0);
     std::vector < int64_t > inputDims =
         inputTypeInfo.GetTensorTypeAndShapeInfo ().GetShape ();
@@ -291,8 +560,6 @@ template < typename T > std::vector < GstMlBoundingBox >
 
     parseDimensions (vmeta);
 
-    Ort::AllocatorWithDefaultOptions allocator;
-    auto inputName = session->GetInputNameAllocated (0, allocator);
     auto inputTypeInfo = session->GetInputTypeInfo (0);
     std::vector < int64_t > inputDims =
         inputTypeInfo.GetTensorTypeAndShapeInfo ().GetShape ();
@@ -310,41 +577,26 @@ template < typename T > std::vector < GstMlBoundingBox >
     GST_DEBUG ("Input dimensions: %s", buffer.str ().c_str ());
 
     // copy video frame
-    uint8_t *srcPtr[3] = { img_data, img_data + 1, img_data + 2 };
-    uint32_t srcSamplesPerPixel = 3;
-    switch (vmeta->format) {
-      case GST_VIDEO_FORMAT_RGBA:
-        srcSamplesPerPixel = 4;
-        break;
-      case GST_VIDEO_FORMAT_BGRA:
-        srcSamplesPerPixel = 4;
-        srcPtr[0] = img_data + 2;
-        srcPtr[1] = img_data + 1;
-        srcPtr[2] = img_data + 0;
-        break;
-      case GST_VIDEO_FORMAT_ARGB:
-        srcSamplesPerPixel = 4;
-        srcPtr[0] = img_data + 1;
-        srcPtr[1] = img_data + 2;
-        srcPtr[2] = img_data + 3;
-        break;
-      case GST_VIDEO_FORMAT_ABGR:
-        srcSamplesPerPixel = 4;
-        srcPtr[0] = img_data + 3;
-        srcPtr[1] = img_data + 2;
-        srcPtr[2] = img_data + 1;
-        break;
-      case GST_VIDEO_FORMAT_BGR:
-        srcPtr[0] = img_data + 2;
-        srcPtr[1] = img_data + 1;
-        srcPtr[2] = img_data + 0;
-        break;
-      default:
-        break;
-    }
+    uint8_t *srcPtr[3];
+    uint32_t srcSamplesPerPixel;
+    getChannelPointers (img_data, vmeta, srcPtr, &srcSamplesPerPixel);
     size_t destIndex = 0;
     uint32_t stride = vmeta->stride[0];
-    if (inputImageFormat == GST_ML_MODEL_INPUT_IMAGE_FORMAT_HWC) {
+    size_t frameSize = width * height;
+    uint8_t *tensorData = dest;
+    // The frame can be used as is if it already has the tensor layout, which
+    // is the case when the resizing, letterboxing and (planar) RGB
+    // conversion was done upstream, possibly on the GPU
+    if (channels == 3 && inputImageFormat == GST_ML_MODEL_INPUT_IMAGE_FORMAT_HWC
+        && vmeta->format == GST_VIDEO_FORMAT_RGB && stride == (uint32_t) (3 * width)) {
+      tensorData = img_data;
+    } else if (channels == 3
+        && inputImageFormat == GST_ML_MODEL_INPUT_IMAGE_FORMAT_CHW
+        && vmeta->format == GST_VIDEO_FORMAT_RGBP && stride == (uint32_t) width
+        && vmeta->offset[1] == vmeta->offset[0] + frameSize
+        && vmeta->offset[2] == vmeta->offset[1] + frameSize) {
+      tensorData = img_data + vmeta->offset[0];
+    } else if (inputImageFormat == GST_ML_MODEL_INPUT_IMAGE_FORMAT_HWC) {
       for (int32_t j = 0; j < height; ++j) {
         for (int32_t i = 0; i < width; ++i) {
           for (int32_t k = 0; k < channels; ++k) {
@@ -357,7 +609,6 @@ template < typename T > std::vector < GstMlBoundingBox >
           srcPtr[k] += stride - srcSamplesPerPixel * width;
       }
     } else {
-      size_t frameSize = width * height;
       uint8_t *destPtr[3] = { dest, dest + frameSize, dest + 2 * frameSize };
       for (int32_t j = 0; j < height; ++j) {
         for (int32_t i = 0; i < width; ++i) {
@@ -373,38 +624,45 @@ template < typename T > std::vector < GstMlBoundingBox >
       }
     }
 
-    const size_t inputTensorSize = width * height * channels;
-    auto memoryInfo =
-        Ort::MemoryInfo::CreateCpu (OrtAllocatorType::OrtArenaAllocator,
-        OrtMemType::OrtMemTypeDefault);
-    std::vector < Ort::Value > inputTensors;
-    inputTensors.push_back (Ort::Value::CreateTensor < uint8_t > (memoryInfo,
-            dest, inputTensorSize, inputDims.data (), inputDims.size ()));
-    std::vector < const char *>inputNames { inputName.get () };
-
-    std::vector < Ort::Value > modelOutput = session->Run (Ort::RunOptions { nullptr},
-        inputNames.data (),
-        inputTensors.data (), 1, outputNamesRaw.data (), outputNamesRaw.size ());
-
-    auto numDetections =
-        modelOutput[getOutputNodeIndex
-        (GST_ML_OUTPUT_NODE_FUNCTION_DETECTION)].GetTensorMutableData < float >();
-    auto bboxes =
-        modelOutput[getOutputNodeIndex
-        (GST_ML_OUTPUT_NODE_FUNCTION_BOUNDING_BOX)].GetTensorMutableData < float >();
-    auto scores =
-        modelOutput[getOutputNodeIndex
-        (GST_ML_OUTPUT_NODE_FUNCTION_SCORE)].GetTensorMutableData < float >();
+    GstOnnxBatchRequest request;
+    request.dims = inputDims;
+    request.data = tensorData;
+    request.size = width * height * channels;
+    if (!sharedSession->run (request, maxBatchSize, batchTimeout))
+      return boundingBoxes;
+
+    GstVideoRectangle region = { 0, 0, width, height };
+    parseOutputs < T > (request, region, labelPath, scoreThreshold,
+        boundingBoxes);
+
+    return boundingBoxes;
+}
+
+template < typename T > void
+      GstOnnxClient::parseOutputs (GstOnnxBatchRequest & request,
+      const GstVideoRectangle & region, std::string labelPath,
+      float scoreThreshold, std::vector < GstMlBoundingBox > &boundingBoxes)
+{
+    auto numDetections = (float *)
+        request.outputs[getOutputNodeIndex
+        (GST_ML_OUTPUT_NODE_FUNCTION_DETECTION)].data ();
+    auto bboxes = (float *)
+        request.outputs[getOutputNodeIndex
+        (GST_ML_OUTPUT_NODE_FUNCTION_BOUNDING_BOX)].data ();
+    auto scores = (float *)
+        request.outputs[getOutputNodeIndex
+        (GST_ML_OUTPUT_NODE_FUNCTION_SCORE)].data ();
     T *labelIndex = nullptr;
     if (getOutputNodeIndex (GST_ML_OUTPUT_NODE_FUNCTION_CLASS) !=
         GST_ML_NODE_INDEX_DISABLED) {
-      labelIndex =
-          modelOutput[getOutputNodeIndex
-          (GST_ML_OUTPUT_NODE_FUNCTION_CLASS)].GetTensorMutableData < T > ();
+      labelIndex = (T *)
+          request.outputs[getOutputNodeIndex
+          (GST_ML_OUTPUT_NODE_FUNCTION_CLASS)].data ();
     }
     if (labels.empty () && !labelPath.empty ())
       labels = ReadLabels (labelPath);
 
+    // boxes are normalized, scale them to the region
     for (int i = 0; i < numDetections[0]; ++i) {
       if (scores[i] > scoreThreshold) {
         std::string label = "";
@@ -412,15 +670,111 @@ template < typename T > std::vector < GstMlBoundingBox >
         if (labelIndex && !labels.empty ())
           label = labels[labelIndex[i] - 1];
         auto score = scores[i];
-        auto y0 = bboxes[i * 4] * height;
-        auto x0 = bboxes[i * 4 + 1] * width;
-        auto bheight = bboxes[i * 4 + 2] * height - y0;
-        auto bwidth = bboxes[i * 4 + 3] * width - x0;
-        boundingBoxes.push_back (GstMlBoundingBox (label, score, x0, y0, bwidth,
-                bheight));
+        auto y0 = bboxes[i * 4] * region.h;
+        auto x0 = bboxes[i * 4 + 1] * region.w;
+        auto bheight = bboxes[i * 4 + 2] * region.h - y0;
+        auto bwidth = bboxes[i * 4 + 3] * region.w - x0;
+        boundingBoxes.push_back (GstMlBoundingBox (label, score,
+                region.x + x0, region.y + y0, bwidth, bheight));
       }
     }
-    return boundingBoxes;
+}
+
+std::vector < std::vector < GstMlBoundingBox > >
+      GstOnnxClient::runRegions (uint8_t * img_data, GstVideoMeta * vmeta,
+      const std::vector < GstVideoRectangle > &regions, std::string labelPath,
+      float scoreThreshold)
+{
+    auto type = getOutputNodeType (GST_ML_OUTPUT_NODE_FUNCTION_CLASS);
+    return (type ==
+        ONNXTensorElementDataType::ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT) ?
+          doRunRegions < float >(img_data, vmeta, regions, labelPath,
+              scoreThreshold)
+            : doRunRegions < int >(img_data, vmeta, regions, labelPath,
+              scoreThreshold);
+}
+
+template < typename T > std::vector < std::vector < GstMlBoundingBox > >
+      GstOnnxClient::doRunRegions (uint8_t * img_data, GstVideoMeta * vmeta,
+      const std::vector < GstVideoRectangle > &regions, std::string labelPath,
+      float scoreThreshold)
+{
+    std::vector < std::vector < GstMlBoundingBox > > res (regions.size ());
+    if (!img_data || regions.empty ())
+      return res;
+
+    uint8_t *srcPtr[3];
+    uint32_t srcSamplesPerPixel;
+    getChannelPointers (img_data, vmeta, srcPtr, &srcSamplesPerPixel);
+    uint32_t stride = vmeta->stride[0];
+
+    auto inputTypeInfo = session->GetInputTypeInfo (0);
+    std::vector < int64_t > modelDims =
+        inputTypeInfo.GetTensorTypeAndShapeInfo ().GetShape ();
+    modelDims[0] = 1;
+
+    // Each region is sampled straight from the frame into its own tensor,
+    // scaling it to the model input size if needed
+    std::vector < GstVideoRectangle > clipped (regions.size ());
+    std::vector < std::vector < uint8_t > > tensors (regions.size ());
+    std::vector < GstOnnxBatchRequest > requests (regions.size ());
+    std::vector < GstOnnxBatchRequest * > toRun;
+    for (size_t r = 0; r < regions.size (); ++r) {
+      GstVideoRectangle & region = clipped[r];
+      region.x = CLAMP (regions[r].x, 0, (gint) vmeta->width);
+      region.y = CLAMP (regions[r].y, 0, (gint) vmeta->height);
+      region.w = MIN (regions[r].w, (gint) vmeta->width - region.x);
+      region.h = MIN (regions[r].h, (gint) vmeta->height - region.y);
+      if (region.w <= 0 || region.h <= 0)
+        continue;
+
+      int32_t w = fixedInputImageSize ? width : region.w;
+      int32_t h = fixedInputImageSize ? height : region.h;
+      size_t planeSize = w * h;
+      std::vector < uint8_t > &tensor = tensors[r];
+      size_t destIndex = 0;
+
+      tensor.resize (planeSize * channels);
+      for (int32_t j = 0; j < h; ++j) {
+        size_t sy = region.y + (size_t) j * region.h / h;
+        for (int32_t i = 0; i < w; ++i) {
+          size_t sx = region.x + (size_t) i * region.w / w;
+          size_t srcOffset = sy * stride + sx * srcSamplesPerPixel;
+          for (int32_t k = 0; k < channels; ++k) {
+            if (inputImageFormat == GST_ML_MODEL_INPUT_IMAGE_FORMAT_HWC)
+              tensor[destIndex * channels + k] = srcPtr[k][srcOffset];
+            else
+              tensor[k * planeSize + destIndex] = srcPtr[k][srcOffset];
+          }
+          destIndex++;
+        }
+      }
+
+      GstOnnxBatchRequest & request = requests[r];
+      request.dims = modelDims;
+      if (inputImageFormat == GST_ML_MODEL_INPUT_IMAGE_FORMAT_HWC) {
+        request.dims[1] = h;
+        request.dims[2] = w;
+      } else {
+        request.dims[2] = h;
+        request.dims[3] = w;
+      }
+      request.data = tensor.data ();
+      request.size = tensor.size ();
+      toRun.push_back (&request);
+    }
+
+    GST_DEBUG ("Running inference on %d regions", (gint) toRun.size ());
+    sharedSession->runAll (toRun, maxBatchSize);
+
+    for (size_t r = 0; r < regions.size (); ++r) {
+      if (requests[r].outputs.empty () || requests[r].failed)
+        continue;
+      parseOutputs < T > (requests[r], clipped[r], labelPath, scoreThreshold,
+          res[r]);
+    }
+
+    return res;
 }
 
 std::vector < std::string >
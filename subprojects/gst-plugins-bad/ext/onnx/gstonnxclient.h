@@ -28,6 +28,9 @@
 #include "gstonnxelement.h"
 #include <string>
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
 
 namespace GstOnnxNamespace {
   enum GstMlOutputNodeFunction {
@@ -65,6 +68,46 @@ namespace GstOnnxNamespace {
     float height;
   };
 
+  // One inference request, possibly run as part of a batch
+  struct GstOnnxBatchRequest {
+    // input tensor dimensions, batch dimension is 1
+    std::vector < int64_t > dims;
+    const uint8_t *data;
+    size_t size;
+    // raw data of each output tensor for this request
+    std::vector < std::vector < uint8_t > > outputs;
+    bool done;
+    bool failed;
+  };
+
+  // Session shared by all the clients using the same model with the same
+  // settings. Concurrent requests with the same input dimensions are run
+  // as a single batch if the model has a dynamic batch dimension.
+  class GstOnnxSession {
+  public:
+    static std::shared_ptr < GstOnnxSession > get (std::string modelFile,
+        GraphOptimizationLevel optim, GstOnnxExecutionProvider provider);
+    GstOnnxSession (Ort::Env & env, std::string modelFile,
+        GraphOptimizationLevel optim, GstOnnxExecutionProvider provider);
+    ~GstOnnxSession (void);
+    Ort::Session & getSession (void);
+    bool run (GstOnnxBatchRequest & request, size_t maxBatchSize,
+        GstClockTime timeout);
+    void runAll (std::vector < GstOnnxBatchRequest * > & requests,
+        size_t maxBatchSize);
+  private:
+    void runBatch (std::vector < GstOnnxBatchRequest * > & batch);
+    Ort::Session * session;
+    bool dynamicBatch;
+    std::vector < Ort::AllocatedStringPtr > inputNames;
+    std::vector < Ort::AllocatedStringPtr > outputNames;
+    std::vector < const char *> outputNamesRaw;
+    std::mutex batchLock;
+    std::condition_variable batchCond;
+    std::vector < GstOnnxBatchRequest * > pending;
+    bool collecting;
+  };
+
   class GstOnnxClient {
   public:
     GstOnnxClient(void);
@@ -72,6 +115,7 @@ namespace GstOnnxNamespace {
     bool createSession(std::string modelFile, GstOnnxOptimizationLevel optim,
                        GstOnnxExecutionProvider provider);
     bool hasSession(void);
+    void setBatching(size_t maxBatchSize, GstClockTime timeout);
     void setInputImageFormat(GstMlModelInputImageFormat format);
     GstMlModelInputImageFormat getInputImageFormat(void);
     void setOutputNodeIndex(GstMlOutputNodeFunction nodeType, gint index);
@@ -84,6 +128,10 @@ namespace GstOnnxNamespace {
                                           GstVideoMeta * vmeta,
                                           std::string labelPath,
                                           float scoreThreshold);
+    std::vector < std::vector < GstMlBoundingBox > > runRegions(
+        uint8_t * img_data, GstVideoMeta * vmeta,
+        const std::vector < GstVideoRectangle > & regions,
+        std::string labelPath, float scoreThreshold);
     std::vector < GstMlBoundingBox > &getBoundingBoxes(void);
     std::vector < const char *>getOutputNodeNames(void);
     bool isFixedInputImageSize(void);
@@ -94,9 +142,19 @@ namespace GstOnnxNamespace {
     template < typename T > std::vector < GstMlBoundingBox >
     doRun(uint8_t * img_data, GstVideoMeta * vmeta, std::string labelPath,
             float scoreThreshold);
+    template < typename T > std::vector < std::vector < GstMlBoundingBox > >
+    doRunRegions(uint8_t * img_data, GstVideoMeta * vmeta,
+            const std::vector < GstVideoRectangle > & regions,
+            std::string labelPath, float scoreThreshold);
+    template < typename T > void parseOutputs(GstOnnxBatchRequest & request,
+            const GstVideoRectangle & region, std::string labelPath,
+            float scoreThreshold,
+            std::vector < GstMlBoundingBox > & boundingBoxes);
     std::vector < std::string > ReadLabels(const std::string & labelsFile);
-    Ort::Env & getEnv(void);
     Ort::Session * session;
+    std::shared_ptr < GstOnnxSession > sharedSession;
+    size_t maxBatchSize;
+    GstClockTime batchTimeout;
     int32_t width;
     int32_t height;
     int32_t channels;
@@ -83,6 +83,33 @@
  * videoconvert ! \
  * autovideosink
  * ```
+ *
+ * The frame conversion to the model input can also be done upstream, for
+ * example on the GPU. If the input is packed RGB for a HWC model, or planar
+ * RGBP for a CHW model, without any padding, it is passed to the model
+ * without being copied:
+ *
+ * ```
+ * gst-launch-1.0 filesrc location=video.mp4 ! parsebin ! nvh264dec ! \
+ * cudaconvertscale add-borders=true ! \
+ * 'video/x-raw(memory:CUDAMemory),format=RGBP,width=640,height=383' ! \
+ * cudadownload ! \
+ * onnxobjectdetector input-image-format=chw model-file=model.onnx \
+ * box-node-index=0 class-node-index=1 score-node-index=2 \
+ * detection-node-index=3 ! \
+ * fakesink
+ * ```
+ *
+ * Models can be cascaded with the #GstOnnxObjectDetector:roi-type property:
+ * the second element below runs its model on every region found by the
+ * first one, reading the pixels straight from the frame and running all the
+ * regions of a frame as one batch:
+ *
+ * ```
+ * gst-launch-1.0 ... ! onnxobjectdetector model-file=detector.onnx ... ! \
+ * onnxobjectdetector roi-type=onnx-object_detector model-file=faces.onnx ... ! \
+ * fakesink
+ * ```
  */
 
 #ifdef HAVE_CONFIG_H
@@ -118,26 +145,31 @@ enum
   PROP_CLASS_NODE_INDEX,
   PROP_INPUT_IMAGE_FORMAT,
   PROP_OPTIMIZATION_LEVEL,
-  PROP_EXECUTION_PROVIDER
+  PROP_EXECUTION_PROVIDER,
+  PROP_BATCH_SIZE,
+  PROP_BATCH_TIMEOUT,
+  PROP_ROI_TYPE
 };
 
 
 #define GST_ONNX_OBJECT_DETECTOR_DEFAULT_EXECUTION_PROVIDER    GST_ONNX_EXECUTION_PROVIDER_CPU
 #define GST_ONNX_OBJECT_DETECTOR_DEFAULT_OPTIMIZATION_LEVEL    GST_ONNX_OPTIMIZATION_LEVEL_ENABLE_EXTENDED
 #define GST_ONNX_OBJECT_DETECTOR_DEFAULT_SCORE_THRESHOLD       0.3f     /* 0 to 1 */
+#define GST_ONNX_OBJECT_DETECTOR_DEFAULT_BATCH_SIZE            1
+#define GST_ONNX_OBJECT_DETECTOR_DEFAULT_BATCH_TIMEOUT         (10 * GST_MSECOND)
 
 static GstStaticPadTemplate gst_onnx_object_detector_src_template =
 GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
-    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("{ RGB,RGBA,BGR,BGRA }"))
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("{ RGB,RGBA,BGR,BGRA,RGBP,BGRP }"))
     );
 
 static GstStaticPadTemplate gst_onnx_object_detector_sink_template =
 GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
-    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("{ RGB,RGBA,BGR,BGRA }"))
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE ("{ RGB,RGBA,BGR,BGRA,RGBP,BGRP }"))
     );
 
 static void gst_onnx_object_detector_set_property (GObject * object,
@@ -327,6 +359,60 @@ gst_onnx_object_detector_class_init (GstOnnxObjectDetectorClass * klass)
           GST_ONNX_EXECUTION_PROVIDER_CPU, (GParamFlags)
           (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
+  /**
+   * GstOnnxObjectDetector:batch-size
+   *
+   * All the elements using the same model file, optimization level and
+   * execution provider share the same ONNX session. If the model has a
+   * dynamic batch dimension, frames of the same size that are processed at
+   * the same time by these elements are run as a single batch of up to
+   * this number of frames.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size",
+          "Batch size",
+          "Maximum number of frames, from all the elements sharing the model, "
+          "to run inference on at once (1 = no batching)",
+          1, G_MAXINT, GST_ONNX_OBJECT_DETECTOR_DEFAULT_BATCH_SIZE,
+          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+  /**
+   * GstOnnxObjectDetector:batch-timeout
+   *
+   * Maximum time to wait for more frames to fill a batch
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_BATCH_TIMEOUT,
+      g_param_spec_uint64 ("batch-timeout",
+          "Batch timeout",
+          "Maximum time to wait for more frames to fill a batch (in ns)",
+          0, G_MAXUINT64, GST_ONNX_OBJECT_DETECTOR_DEFAULT_BATCH_TIMEOUT,
+          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+  /**
+   * GstOnnxObjectDetector:roi-type
+   *
+   * When set, the model is not run on the whole frame but on each
+   * #GstVideoRegionOfInterestMeta of this type, as attached for instance by
+   * a first onnxobjectdetector. The regions are sampled straight from the
+   * mapped frame into the model input, scaled to the model input size if it
+   * is fixed, and all the regions of a frame are run as one batch if the
+   * model allows it. The detections are attached as new
+   * #GstVideoRegionOfInterestMeta with the id of the region they were found
+   * in as parent id, and their coordinates in the frame.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_ROI_TYPE,
+      g_param_spec_string ("roi-type",
+          "ROI type",
+          "Only run the model on the regions of interest of this type "
+          "(NULL = whole frame)",
+          NULL, (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
   gst_element_class_set_static_metadata (element_class, "onnxobjectdetector",
       "Filter/Effect/Video",
       "Apply neural network to detect objects in video frames",
@@ -346,6 +432,8 @@ gst_onnx_object_detector_init (GstOnnxObjectDetector * self)
 {
   self->onnx_ptr = new GstOnnxNamespace::GstOnnxClient ();
   self->onnx_disabled = false;
+  self->batch_size = GST_ONNX_OBJECT_DETECTOR_DEFAULT_BATCH_SIZE;
+  self->batch_timeout = GST_ONNX_OBJECT_DETECTOR_DEFAULT_BATCH_TIMEOUT;
 }
 
 static void
@@ -354,6 +442,8 @@ gst_onnx_object_detector_finalize (GObject * object)
   GstOnnxObjectDetector *self = GST_ONNX_OBJECT_DETECTOR (object);
 
   g_free (self->model_file);
+  g_free (self->label_file);
+  g_free (self->roi_type);
   delete GST_ONNX_MEMBER (self);
   G_OBJECT_CLASS (gst_onnx_object_detector_parent_class)->finalize (object);
 }
@@ -392,6 +482,10 @@ gst_onnx_object_detector_set_property (GObject * object, guint prop_id,
         GST_WARNING_OBJECT (self, "Label file '%s' not found!", filename);
       }
       break;
+    case PROP_ROI_TYPE:
+      g_free (self->roi_type);
+      self->roi_type = g_value_dup_string (value);
+      break;
     case PROP_SCORE_THRESHOLD:
       GST_OBJECT_LOCK (self);
       self->score_threshold = g_value_get_float (value);
@@ -405,6 +499,18 @@ gst_onnx_object_detector_set_property (GObject * object, guint prop_id,
       self->execution_provider =
           (GstOnnxExecutionProvider) g_value_get_enum (value);
       break;
+    case PROP_BATCH_SIZE:
+      GST_OBJECT_LOCK (self);
+      self->batch_size = g_value_get_uint (value);
+      onnxClient->setBatching (self->batch_size, self->batch_timeout);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_BATCH_TIMEOUT:
+      GST_OBJECT_LOCK (self);
+      self->batch_timeout = g_value_get_uint64 (value);
+      onnxClient->setBatching (self->batch_size, self->batch_timeout);
+      GST_OBJECT_UNLOCK (self);
+      break;
     case PROP_DETECTION_NODE_INDEX:
       onnxClient->setOutputNodeIndex
           (GstOnnxNamespace::GST_ML_OUTPUT_NODE_FUNCTION_DETECTION,
@@ -451,6 +557,9 @@ gst_onnx_object_detector_get_property (GObject * object, guint prop_id,
     case PROP_LABEL_FILE:
       g_value_set_string (value, self->label_file);
       break;
+    case PROP_ROI_TYPE:
+      g_value_set_string (value, self->roi_type);
+      break;
     case PROP_SCORE_THRESHOLD:
       GST_OBJECT_LOCK (self);
       g_value_set_float (value, self->score_threshold);
@@ -462,6 +571,16 @@ gst_onnx_object_detector_get_property (GObject * object, guint prop_id,
     case PROP_EXECUTION_PROVIDER:
       g_value_set_enum (value, self->execution_provider);
       break;
+    case PROP_BATCH_SIZE:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint (value, self->batch_size);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case PROP_BATCH_TIMEOUT:
+      GST_OBJECT_LOCK (self);
+      g_value_set_uint64 (value, self->batch_timeout);
+      GST_OBJECT_UNLOCK (self);
+      break;
     case PROP_DETECTION_NODE_INDEX:
       g_value_set_int (value,
           onnxClient->getOutputNodeIndex
@@ -587,7 +706,8 @@ gst_onnx_object_detector_transform_caps (GstBaseTransform *
 	  return NULL;
   GST_LOG_OBJECT (self, "transforming caps %" GST_PTR_FORMAT, caps);
 
-  if (gst_base_transform_is_passthrough (trans)
+  /* regions are scaled to the model input, the frame can have any size */
+  if (gst_base_transform_is_passthrough (trans) || self->roi_type
       || (!onnxClient->isFixedInputImageSize ()))
     return gst_caps_ref (caps);
 
@@ -631,48 +751,103 @@ gst_onnx_object_detector_transform_ip (GstBaseTransform * trans,
   return GST_FLOW_OK;
 }
 
+static gboolean
+gst_onnx_object_detector_attach_box (GstOnnxObjectDetector * self,
+    GstBuffer * buf, const GstOnnxNamespace::GstMlBoundingBox & b,
+    gint parent_id)
+{
+  auto vroi_meta = gst_buffer_add_video_region_of_interest_meta (buf,
+      GST_ONNX_OBJECT_DETECTOR_META_NAME,
+      b.x0, b.y0,
+      b.width,
+      b.height);
+  if (!vroi_meta) {
+    GST_WARNING_OBJECT (self,
+        "Unable to attach GstVideoRegionOfInterestMeta to buffer");
+    return FALSE;
+  }
+  vroi_meta->parent_id = parent_id;
+  auto s = gst_structure_new (GST_ONNX_OBJECT_DETECTOR_META_PARAM_NAME,
+      GST_ONNX_OBJECT_DETECTOR_META_FIELD_LABEL,
+      G_TYPE_STRING,
+      b.label.c_str (),
+      GST_ONNX_OBJECT_DETECTOR_META_FIELD_SCORE,
+      G_TYPE_DOUBLE,
+      b.score,
+      NULL);
+  gst_video_region_of_interest_meta_add_param (vroi_meta, s);
+  GST_DEBUG_OBJECT (self,
+      "Object detected with label : %s, score: %f, bound box: (%f,%f,%f,%f), "
+      "parent: %d", b.label.c_str (), b.score, b.x0, b.y0,
+      b.x0 + b.width, b.y0 + b.height, parent_id);
+
+  return TRUE;
+}
+
 static gboolean
 gst_onnx_object_detector_process (GstBaseTransform * trans, GstBuffer * buf)
 {
+  GstOnnxObjectDetector *self = GST_ONNX_OBJECT_DETECTOR (trans);
   GstMapInfo info;
   GstVideoMeta *vmeta = gst_buffer_get_video_meta (buf);
+  gboolean ret = TRUE;
 
   if (!vmeta) {
     GST_WARNING_OBJECT (trans, "missing video meta");
     return FALSE;
   }
-  if (gst_buffer_map (buf, &info, GST_MAP_READ)) {
-    GstOnnxObjectDetector *self = GST_ONNX_OBJECT_DETECTOR (trans);
+  if (!gst_buffer_map (buf, &info, GST_MAP_READ))
+    return TRUE;
+
+  if (self->roi_type) {
+    GQuark roi_type = g_quark_from_string (self->roi_type);
+    std::vector < GstVideoRectangle > regions;
+    std::vector < gint > parents;
+    gpointer state = NULL;
+    GstMeta *meta;
+
+    /* collect the regions first, the detections are added to the same
+     * buffer */
+    while ((meta = gst_buffer_iterate_meta_filtered (buf, &state,
+                GST_VIDEO_REGION_OF_INTEREST_META_API_TYPE))) {
+      auto roi = (GstVideoRegionOfInterestMeta *) meta;
+      GstVideoRectangle region;
+
+      if (roi->roi_type != roi_type)
+        continue;
+      region.x = roi->x;
+      region.y = roi->y;
+      region.w = roi->w;
+      region.h = roi->h;
+      regions.push_back (region);
+      parents.push_back (roi->id);
+    }
+
+    if (!regions.empty ()) {
+      auto results = GST_ONNX_MEMBER (self)->runRegions (info.data, vmeta,
+          regions, self->label_file ? self->label_file : "",
+          self->score_threshold);
+      for (size_t i = 0; ret && i < results.size (); ++i) {
+        for (auto & b:results[i]) {
+          if (!gst_onnx_object_detector_attach_box (self, buf, b, parents[i])) {
+            ret = FALSE;
+            break;
+          }
+        }
+      }
+    }
+  } else {
     auto boxes = GST_ONNX_MEMBER (self)->run (info.data, vmeta,
         self->label_file ? self->label_file : "",
         self->score_threshold);
-  for (auto & b:boxes) {
-      auto vroi_meta = gst_buffer_add_video_region_of_interest_meta (buf,
-          GST_ONNX_OBJECT_DETECTOR_META_NAME,
-          b.x0, b.y0,
-          b.width,
-          b.height);
-      if (!vroi_meta) {
-        GST_WARNING_OBJECT (trans,
-            "Unable to attach GstVideoRegionOfInterestMeta to buffer");
-        return FALSE;
+    for (auto & b:boxes) {
+      if (!gst_onnx_object_detector_attach_box (self, buf, b, 0)) {
+        ret = FALSE;
+        break;
       }
-      auto s = gst_structure_new (GST_ONNX_OBJECT_DETECTOR_META_PARAM_NAME,
-          GST_ONNX_OBJECT_DETECTOR_META_FIELD_LABEL,
-          G_TYPE_STRING,
-          b.label.c_str (),
-          GST_ONNX_OBJECT_DETECTOR_META_FIELD_SCORE,
-          G_TYPE_DOUBLE,
-          b.score,
-          NULL);
-      gst_video_region_of_interest_meta_add_param (vroi_meta, s);
-      GST_DEBUG_OBJECT (self,
-          "Object detected with label : %s, score: %f, bound box: (%f,%f,%f,%f) \n",
-          b.label.c_str (), b.score, b.x0, b.y0,
-          b.x0 + b.width, b.y0 + b.height);
     }
-    gst_buffer_unmap (buf, &info);
   }
+  gst_buffer_unmap (buf, &info);
 
-  return TRUE;
+  return ret;
 }
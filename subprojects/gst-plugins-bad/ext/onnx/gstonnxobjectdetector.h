@@ -53,6 +53,9 @@ G_DECLARE_FINAL_TYPE (GstOnnxObjectDetector, gst_onnx_object_detector, GST, ONNX
  * @iou_threhsold iou threshold
  * @optimization_level ONNX optimization level
  * @execution_provider: ONNX execution provider
+ * @batch_size: maximum number of frames per inference batch
+ * @batch_timeout: maximum time to wait for a batch to fill
+ * @roi_type: type of the regions of interest to run the model on
  * @onnx_ptr opaque pointer to ONNX implementation
  *
  * Since: 1.20
@@ -67,6 +70,9 @@ struct _GstOnnxObjectDetector
   gfloat iou_threshold;
   GstOnnxOptimizationLevel optimization_level;
   GstOnnxExecutionProvider execution_provider;
+  guint batch_size;
+  GstClockTime batch_timeout;
+  gchar *roi_type;
   gpointer onnx_ptr;
   gboolean onnx_disabled;
 
@@ -149,6 +149,8 @@ static void gst_sctp_enc_release_pad (GstElement * element, GstPad * pad);
 static void gst_sctp_enc_srcpad_loop (GstPad * pad);
 static GstFlowReturn gst_sctp_enc_sink_chain (GstPad * pad, GstObject * parent,
     GstBuffer * buffer);
+static GstFlowReturn gst_sctp_enc_sink_chain_list (GstPad * pad,
+    GstObject * parent, GstBufferList * list);
 static gboolean gst_sctp_enc_sink_event (GstPad * pad, GstObject * parent,
     GstEvent * event);
 static gboolean gst_sctp_enc_src_event (GstPad * pad, GstObject * parent,
@@ -429,6 +431,8 @@ gst_sctp_enc_request_new_pad (GstElement * element, GstPadTemplate * template,
       template->direction, "template", template, NULL);
   gst_pad_set_chain_function (new_pad,
       GST_DEBUG_FUNCPTR (gst_sctp_enc_sink_chain));
+  gst_pad_set_chain_list_function (new_pad,
+      GST_DEBUG_FUNCPTR (gst_sctp_enc_sink_chain_list));
   gst_pad_set_event_function (new_pad,
       GST_DEBUG_FUNCPTR (gst_sctp_enc_sink_event));
 
@@ -561,11 +565,71 @@ gst_sctp_enc_srcpad_loop (GstPad * pad)
 }
 
 static GstFlowReturn
-gst_sctp_enc_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+gst_sctp_enc_check_src_ret (GstSctpEnc * self, GstPad * pad)
+{
+  GstFlowReturn flow_ret;
+
+  GST_OBJECT_LOCK (self);
+  flow_ret = self->src_ret;
+  if (flow_ret != GST_FLOW_OK)
+    GST_ERROR_OBJECT (pad, "Pushing on source pad failed before: %s",
+        gst_flow_get_name (flow_ret));
+  GST_OBJECT_UNLOCK (self);
+
+  return flow_ret;
+}
+
+/* Waits until it is the turn of @sctpenc_pad to send, returns with the pad
+ * lock held */
+static void
+gst_sctp_enc_pad_wait_turn (GstSctpEnc * self, GstSctpEncPad * sctpenc_pad)
+{
+  gboolean clear_to_send;
+
+  GST_OBJECT_LOCK (self);
+  clear_to_send = g_queue_is_empty (&self->pending_pads);
+  g_queue_push_tail (&self->pending_pads, sctpenc_pad);
+  GST_OBJECT_UNLOCK (self);
+
+  g_mutex_lock (&sctpenc_pad->lock);
+
+  if (clear_to_send) {
+    sctpenc_pad->clear_to_send = TRUE;
+  }
+
+  while (!sctpenc_pad->flushing && !sctpenc_pad->clear_to_send) {
+    g_cond_wait (&sctpenc_pad->cond, &sctpenc_pad->lock);
+  }
+}
+
+/* Releases the pad lock and hands the turn over to the next pad */
+static void
+gst_sctp_enc_pad_end_turn (GstSctpEnc * self, GstSctpEncPad * sctpenc_pad)
 {
-  GstSctpEnc *self = GST_SCTP_ENC (parent);
-  GstSctpEncPad *sctpenc_pad = GST_SCTP_ENC_PAD (pad);
   GstSctpEncPad *sctpenc_pad_next = NULL;
+
+  sctpenc_pad->clear_to_send = FALSE;
+  g_mutex_unlock (&sctpenc_pad->lock);
+
+  GST_OBJECT_LOCK (self);
+  g_queue_remove (&self->pending_pads, sctpenc_pad);
+  sctpenc_pad_next = g_queue_peek_head (&self->pending_pads);
+  GST_OBJECT_UNLOCK (self);
+
+  if (sctpenc_pad_next) {
+    g_mutex_lock (&sctpenc_pad_next->lock);
+    sctpenc_pad_next->clear_to_send = TRUE;
+    g_cond_signal (&sctpenc_pad_next->cond);
+    g_mutex_unlock (&sctpenc_pad_next->lock);
+  }
+}
+
+/* Must be called with the pad lock held during the pad's turn */
+static GstFlowReturn
+gst_sctp_enc_pad_send_buffer (GstSctpEnc * self, GstSctpEncPad * sctpenc_pad,
+    GstBuffer * buffer)
+{
+  GstPad *pad = GST_PAD (sctpenc_pad);
   GstMapInfo map;
   guint32 ppid;
   gboolean ordered;
@@ -577,18 +641,6 @@ gst_sctp_enc_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   GstFlowReturn flow_ret = GST_FLOW_ERROR;
   const guint8 *data;
   guint32 length;
-  gboolean clear_to_send;
-
-  GST_OBJECT_LOCK (self);
-  if (self->src_ret != GST_FLOW_OK) {
-    GST_ERROR_OBJECT (pad, "Pushing on source pad failed before: %s",
-        gst_flow_get_name (self->src_ret));
-    flow_ret = self->src_ret;
-    GST_OBJECT_UNLOCK (self);
-    gst_buffer_unref (buffer);
-    return flow_ret;
-  }
-  GST_OBJECT_UNLOCK (self);
 
   ppid = sctpenc_pad->ppid;
   ordered = sctpenc_pad->ordered;
@@ -627,27 +679,12 @@ gst_sctp_enc_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 
   if (!gst_buffer_map (buffer, &map, GST_MAP_READ)) {
     GST_ERROR_OBJECT (pad, "Could not map GstBuffer");
-    goto error;
+    return GST_FLOW_ERROR;
   }
 
   data = map.data;
   length = map.size;
 
-  GST_OBJECT_LOCK (self);
-  clear_to_send = g_queue_is_empty (&self->pending_pads);
-  g_queue_push_tail (&self->pending_pads, sctpenc_pad);
-  GST_OBJECT_UNLOCK (self);
-
-  g_mutex_lock (&sctpenc_pad->lock);
-
-  if (clear_to_send) {
-    sctpenc_pad->clear_to_send = TRUE;
-  }
-
-  while (!sctpenc_pad->flushing && !sctpenc_pad->clear_to_send) {
-    g_cond_wait (&sctpenc_pad->cond, &sctpenc_pad->lock);
-  }
-
   while (!sctpenc_pad->flushing) {
     guint32 bytes_sent;
 
@@ -687,27 +724,61 @@ gst_sctp_enc_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   flow_ret = sctpenc_pad->flushing ? GST_FLOW_FLUSHING : GST_FLOW_OK;
 
 out:
-  sctpenc_pad->clear_to_send = FALSE;
-  g_mutex_unlock (&sctpenc_pad->lock);
+  gst_buffer_unmap (buffer, &map);
+  return flow_ret;
+}
 
-  GST_OBJECT_LOCK (self);
-  g_queue_remove (&self->pending_pads, sctpenc_pad);
-  sctpenc_pad_next = g_queue_peek_head (&self->pending_pads);
-  GST_OBJECT_UNLOCK (self);
+static GstFlowReturn
+gst_sctp_enc_sink_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstSctpEnc *self = GST_SCTP_ENC (parent);
+  GstSctpEncPad *sctpenc_pad = GST_SCTP_ENC_PAD (pad);
+  GstFlowReturn flow_ret;
 
-  if (sctpenc_pad_next) {
-    g_mutex_lock (&sctpenc_pad_next->lock);
-    sctpenc_pad_next->clear_to_send = TRUE;
-    g_cond_signal (&sctpenc_pad_next->cond);
-    g_mutex_unlock (&sctpenc_pad_next->lock);
+  if ((flow_ret = gst_sctp_enc_check_src_ret (self, pad)) != GST_FLOW_OK) {
+    gst_buffer_unref (buffer);
+    return flow_ret;
   }
 
-  gst_buffer_unmap (buffer, &map);
-error:
+  gst_sctp_enc_pad_wait_turn (self, sctpenc_pad);
+  flow_ret = gst_sctp_enc_pad_send_buffer (self, sctpenc_pad, buffer);
+  gst_sctp_enc_pad_end_turn (self, sctpenc_pad);
+
   gst_buffer_unref (buffer);
   return flow_ret;
 }
 
+/* All messages of a list are sent during a single turn of the pad, instead
+ * of waiting for the other pads after every message */
+static GstFlowReturn
+gst_sctp_enc_sink_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstSctpEnc *self = GST_SCTP_ENC (parent);
+  GstSctpEncPad *sctpenc_pad = GST_SCTP_ENC_PAD (pad);
+  GstFlowReturn flow_ret;
+  guint i, len;
+
+  if ((flow_ret = gst_sctp_enc_check_src_ret (self, pad)) != GST_FLOW_OK) {
+    gst_buffer_list_unref (list);
+    return flow_ret;
+  }
+
+  len = gst_buffer_list_length (list);
+
+  GST_LOG_OBJECT (pad, "Sending list of %u buffers", len);
+
+  gst_sctp_enc_pad_wait_turn (self, sctpenc_pad);
+  for (i = 0; i < len && flow_ret == GST_FLOW_OK; i++) {
+    flow_ret = gst_sctp_enc_pad_send_buffer (self, sctpenc_pad,
+        gst_buffer_list_get (list, i));
+  }
+  gst_sctp_enc_pad_end_turn (self, sctpenc_pad);
+
+  gst_buffer_list_unref (list);
+  return flow_ret;
+}
+
 static gboolean
 gst_sctp_enc_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
@@ -1742,6 +1742,16 @@ gst_srt_object_write_to_callers (GstSRTObject * srtobject,
       gint rest = MIN (mapinfo->size - len, payload_size);
       sent = srt_sendmsg2 (caller->sock, (char *) (msg + len), rest, 0);
       if (sent < 0) {
+        /* Caller sockets are non-blocking. A caller that can't keep up only
+         * loses the rest of this buffer, it must neither stall the other
+         * callers nor be disconnected for it */
+        if (srt_getlasterror (NULL) == SRT_EASYNCSND) {
+          GST_LOG_OBJECT (srtobject->element,
+              "Send buffer of caller %d full, skipping %" G_GSSIZE_FORMAT
+              " bytes", caller->sock, (gssize) (mapinfo->size - len));
+          break;
+        }
+
         GST_WARNING_OBJECT (srtobject->element, "Dropping caller %d: %s",
             caller->sock, srt_getlasterror_str ());
         goto err;
@@ -211,6 +211,10 @@ static GstFlowReturn gst_srtp_dec_chain_rtp (GstPad * pad,
     GstObject * parent, GstBuffer * buf);
 static GstFlowReturn gst_srtp_dec_chain_rtcp (GstPad * pad,
     GstObject * parent, GstBuffer * buf);
+static GstFlowReturn gst_srtp_dec_chain_list_rtp (GstPad * pad,
+    GstObject * parent, GstBufferList * buf_list);
+static GstFlowReturn gst_srtp_dec_chain_list_rtcp (GstPad * pad,
+    GstObject * parent, GstBufferList * buf_list);
 
 static GstStateChangeReturn gst_srtp_dec_change_state (GstElement * element,
     GstStateChange transition);
@@ -385,6 +389,8 @@ gst_srtp_dec_init (GstSrtpDec * filter)
       GST_DEBUG_FUNCPTR (gst_srtp_dec_iterate_internal_links_rtp));
   gst_pad_set_chain_function (filter->rtp_sinkpad,
       GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_rtp));
+  gst_pad_set_chain_list_function (filter->rtp_sinkpad,
+      GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_list_rtp));
 
   filter->rtp_srcpad =
       gst_pad_new_from_static_template (&rtp_src_template, "rtp_src");
@@ -408,6 +414,8 @@ gst_srtp_dec_init (GstSrtpDec * filter)
       GST_DEBUG_FUNCPTR (gst_srtp_dec_iterate_internal_links_rtcp));
   gst_pad_set_chain_function (filter->rtcp_sinkpad,
       GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_rtcp));
+  gst_pad_set_chain_list_function (filter->rtcp_sinkpad,
+      GST_DEBUG_FUNCPTR (gst_srtp_dec_chain_list_rtcp));
 
   filter->rtcp_srcpad =
       gst_pad_new_from_static_template (&rtcp_src_template, "rtcp_src");
@@ -1460,21 +1468,20 @@ err:
   return FALSE;
 }
 
-static GstFlowReturn
-gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
-    gboolean is_rtcp)
+/* Takes ownership of @buf and returns the decoded buffer, or %NULL if it
+ * was dropped. @is_rtcp is updated if an RTCP packet arrived on the RTP pad */
+static GstBuffer *
+gst_srtp_dec_process_buffer (GstSrtpDec * filter, GstPad * pad,
+    GstBuffer * buf, gboolean * is_rtcp)
 {
-  GstSrtpDec *filter = GST_SRTP_DEC (parent);
-  GstPad *otherpad;
   GstSrtpDecSsrcStream *stream = NULL;
-  GstFlowReturn ret = GST_FLOW_OK;
   guint32 ssrc = 0;
 
   GST_OBJECT_LOCK (filter);
 
   /* Check if this stream exists, if not create a new stream */
 
-  if (!(stream = validate_buffer (filter, buf, &ssrc, &is_rtcp))) {
+  if (!(stream = validate_buffer (filter, buf, &ssrc, is_rtcp))) {
     GST_OBJECT_UNLOCK (filter);
     GST_WARNING_OBJECT (filter, "Invalid buffer, dropping");
     goto drop_buffer;
@@ -1482,10 +1489,13 @@ gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
 
   if (!STREAM_HAS_CRYPTO (stream)) {
     GST_OBJECT_UNLOCK (filter);
-    goto push_out;
+    return buf;
   }
 
-  if (!gst_srtp_dec_decode_buffer (filter, pad, buf, is_rtcp, ssrc)) {
+  /* The buffer is decoded in place */
+  buf = gst_buffer_make_writable (buf);
+
+  if (!gst_srtp_dec_decode_buffer (filter, pad, buf, *is_rtcp, ssrc)) {
     GST_OBJECT_UNLOCK (filter);
     goto drop_buffer;
   }
@@ -1496,27 +1506,105 @@ gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
   if (gst_srtp_get_soft_limit_reached ())
     request_key_with_signal (filter, ssrc, SIGNAL_SOFT_LIMIT);
 
-push_out:
-  /* Push buffer to source pad */
+  return buf;
+
+drop_buffer:
+  gst_buffer_unref (buf);
+
+  return NULL;
+}
+
+static GstPad *
+gst_srtp_dec_get_src_pad (GstSrtpDec * filter, gboolean is_rtcp)
+{
   if (is_rtcp) {
-    otherpad = filter->rtcp_srcpad;
     if (!filter->rtcp_has_segment)
       gst_srtp_dec_push_early_events (filter, filter->rtcp_srcpad,
           filter->rtp_srcpad, TRUE);
+    return filter->rtcp_srcpad;
   } else {
-    otherpad = filter->rtp_srcpad;
     if (!filter->rtp_has_segment)
       gst_srtp_dec_push_early_events (filter, filter->rtp_srcpad,
           filter->rtcp_srcpad, FALSE);
+    return filter->rtp_srcpad;
   }
-  ret = gst_pad_push (otherpad, buf);
+}
 
-  return ret;
+static GstFlowReturn
+gst_srtp_dec_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
+    gboolean is_rtcp)
+{
+  GstSrtpDec *filter = GST_SRTP_DEC (parent);
 
-drop_buffer:
-  /* Drop buffer, except if gst_pad_push returned OK or an error */
+  buf = gst_srtp_dec_process_buffer (filter, pad, buf, &is_rtcp);
+  if (!buf)
+    return GST_FLOW_OK;
 
-  gst_buffer_unref (buf);
+  /* Push buffer to source pad */
+  return gst_pad_push (gst_srtp_dec_get_src_pad (filter, is_rtcp), buf);
+}
+
+typedef struct
+{
+  GstSrtpDec *filter;
+  GstPad *pad;
+  gboolean is_rtcp;
+  /* decoded RTP and RTCP buffers, indexed by is_rtcp */
+  GstBufferList *out_list[2];
+  guint len;
+} DecodeListData;
+
+static gboolean
+decode_buffer_it (GstBuffer ** buffer, guint idx, gpointer user_data)
+{
+  DecodeListData *data = user_data;
+  gboolean is_rtcp = data->is_rtcp;
+  GstBuffer *buf;
+
+  /* Takes the buffer out of the list */
+  buf = gst_srtp_dec_process_buffer (data->filter, data->pad, *buffer,
+      &is_rtcp);
+  *buffer = NULL;
+
+  if (buf) {
+    if (!data->out_list[is_rtcp])
+      data->out_list[is_rtcp] = gst_buffer_list_new_sized (data->len);
+    gst_buffer_list_add (data->out_list[is_rtcp], buf);
+  }
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_srtp_dec_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list, gboolean is_rtcp)
+{
+  GstSrtpDec *filter = GST_SRTP_DEC (parent);
+  GstFlowReturn ret = GST_FLOW_OK, rtcp_ret = GST_FLOW_OK;
+  DecodeListData data = { filter, pad, is_rtcp, {NULL, NULL}, 0 };
+
+  data.len = gst_buffer_list_length (buf_list);
+
+  GST_LOG_OBJECT (pad, "Buffer chain with list of %u", data.len);
+
+  /* All the buffers of the list are decoded before pushing the result
+   * downstream as a list again, RTCP packets muxed on the RTP pad end up in
+   * a separate list for the RTCP source pad */
+  buf_list = gst_buffer_list_make_writable (buf_list);
+  gst_buffer_list_foreach (buf_list, decode_buffer_it, &data);
+  gst_buffer_list_unref (buf_list);
+
+  if (data.out_list[FALSE])
+    ret = gst_pad_push_list (gst_srtp_dec_get_src_pad (filter, FALSE),
+        data.out_list[FALSE]);
+
+  if (data.out_list[TRUE])
+    rtcp_ret = gst_pad_push_list (gst_srtp_dec_get_src_pad (filter, TRUE),
+        data.out_list[TRUE]);
+
+  /* Report the flow of the pad the list arrived on */
+  if (is_rtcp || ret == GST_FLOW_OK)
+    ret = rtcp_ret;
 
   return ret;
 }
@@ -1533,6 +1621,20 @@ gst_srtp_dec_chain_rtcp (GstPad * pad, GstObject * parent, GstBuffer * buf)
   return gst_srtp_dec_chain (pad, parent, buf, TRUE);
 }
 
+static GstFlowReturn
+gst_srtp_dec_chain_list_rtp (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list)
+{
+  return gst_srtp_dec_chain_list (pad, parent, buf_list, FALSE);
+}
+
+static GstFlowReturn
+gst_srtp_dec_chain_list_rtcp (GstPad * pad, GstObject * parent,
+    GstBufferList * buf_list)
+{
+  return gst_srtp_dec_chain_list (pad, parent, buf_list, TRUE);
+}
+
 static GstStateChangeReturn
 gst_srtp_dec_change_state (GstElement * element, GstStateChange transition)
 {
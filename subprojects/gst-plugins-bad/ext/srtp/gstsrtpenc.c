@@ -161,15 +161,6 @@ enum
   PROP_MKI
 };
 
-typedef struct ProcessBufferItData
-{
-  GstSrtpEnc *filter;
-  GstPad *pad;
-  GstBufferList *out_list;
-  GstFlowReturn flowret;
-  gboolean is_rtcp;
-} ProcessBufferItData;
-
 /* the capabilities of the inputs and outputs.
  *
  * describe the real formats here.
@@ -1123,6 +1114,42 @@ gst_srtp_enc_ensure_ssrc (GstSrtpEnc * filter, GstBuffer * buf)
   }
 }
 
+/* called with the object lock */
+static srtp_err_status_t
+gst_srtp_enc_protect (GstSrtpEnc * filter, guint8 * data, gint * size,
+    gboolean is_rtcp)
+{
+#ifdef HAVE_SRTP2
+  if (is_rtcp)
+    return srtp_protect_rtcp_mki (filter->session, data, size,
+        (filter->mki != NULL), 0);
+  else
+    return srtp_protect_mki (filter->session, data, size,
+        (filter->mki != NULL), 0);
+#else
+  if (is_rtcp)
+    return srtp_protect_rtcp (filter->session, data, size);
+  else
+    return srtp_protect (filter->session, data, size);
+#endif
+}
+
+static GstFlowReturn
+gst_srtp_enc_protect_error (GstSrtpEnc * filter, srtp_err_status_t err)
+{
+  if (err == srtp_err_status_key_expired) {
+    GST_ELEMENT_ERROR (GST_ELEMENT_CAST (filter), STREAM, ENCODE,
+        ("Key usage limit has been reached"),
+        ("Unable to protect buffer (hard key usage limit reached)"));
+  } else {
+    /* srtp_protect failed */
+    GST_ELEMENT_ERROR (filter, LIBRARY, FAILED, (NULL),
+        ("Unable to protect buffer (protect failed) code %d", err));
+  }
+
+  return GST_FLOW_ERROR;
+}
+
 static GstFlowReturn
 gst_srtp_enc_process_buffer (GstSrtpEnc * filter, GstPad * pad,
     GstBuffer * buf, gboolean is_rtcp, GstBuffer ** outbuf_ptr)
@@ -1149,54 +1176,31 @@ gst_srtp_enc_process_buffer (GstSrtpEnc * filter, GstPad * pad,
   if (filter->session == NULL) {
     /* The rtcp session disappeared (element shutting down) */
     GST_OBJECT_UNLOCK (filter);
+    gst_buffer_unmap (bufout, &mapout);
     ret = GST_FLOW_FLUSHING;
     goto fail;
   }
 
   gst_srtp_enc_ensure_ssrc (filter, buf);
 
-#ifdef HAVE_SRTP2
-  if (is_rtcp)
-    err = srtp_protect_rtcp_mki (filter->session, mapout.data, &size,
-        (filter->mki != NULL), 0);
-  else
-    err = srtp_protect_mki (filter->session, mapout.data, &size,
-        (filter->mki != NULL), 0);
-#else
-  if (is_rtcp)
-    err = srtp_protect_rtcp (filter->session, mapout.data, &size);
-  else
-    err = srtp_protect (filter->session, mapout.data, &size);
-#endif
+  err = gst_srtp_enc_protect (filter, mapout.data, &size, is_rtcp);
 
   GST_OBJECT_UNLOCK (filter);
 
   gst_buffer_unmap (bufout, &mapout);
 
-  if (err == srtp_err_status_ok) {
-    /* Buffer protected */
-    gst_buffer_set_size (bufout, size);
-    gst_buffer_copy_into (bufout, buf, GST_BUFFER_COPY_METADATA, 0, -1);
-
-    GST_LOG_OBJECT (pad, "Encoding %s buffer of size %d",
-        is_rtcp ? "RTCP" : "RTP", size);
-
-  } else if (err == srtp_err_status_key_expired) {
-
-    GST_ELEMENT_ERROR (GST_ELEMENT_CAST (filter), STREAM, ENCODE,
-        ("Key usage limit has been reached"),
-        ("Unable to protect buffer (hard key usage limit reached)"));
-    ret = GST_FLOW_ERROR;
-    goto fail;
-
-  } else {
-    /* srtp_protect failed */
-    GST_ELEMENT_ERROR (filter, LIBRARY, FAILED, (NULL),
-        ("Unable to protect buffer (protect failed) code %d", err));
-    ret = GST_FLOW_ERROR;
+  if (err != srtp_err_status_ok) {
+    ret = gst_srtp_enc_protect_error (filter, err);
     goto fail;
   }
 
+  /* Buffer protected */
+  gst_buffer_set_size (bufout, size);
+  gst_buffer_copy_into (bufout, buf, GST_BUFFER_COPY_METADATA, 0, -1);
+
+  GST_LOG_OBJECT (pad, "Encoding %s buffer of size %d",
+      is_rtcp ? "RTCP" : "RTP", size);
+
   *outbuf_ptr = bufout;
   return ret;
 
@@ -1205,6 +1209,91 @@ fail:
   return ret;
 }
 
+/* Protects all the buffers of @buf_list in one go: the output is written
+ * into a single allocation that the output buffers share, and the object
+ * lock is only taken once for the whole list */
+static GstFlowReturn
+gst_srtp_enc_process_buffer_list (GstSrtpEnc * filter, GstPad * pad,
+    GstBufferList * buf_list, gboolean is_rtcp, GstBufferList ** outlist_ptr)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i, len = gst_buffer_list_length (buf_list);
+  GstBufferList *out_list;
+  GstMemory *mem;
+  GstMapInfo map;
+  gsize offset, total = 0;
+  gint *sizes;
+  srtp_err_status_t err = srtp_err_status_ok;
+
+  for (i = 0; i < len; i++)
+    total += gst_buffer_get_size (gst_buffer_list_get (buf_list, i)) +
+        SRTP_MAX_TRAILER_LEN + 10;
+
+  mem = gst_allocator_alloc (NULL, total, NULL);
+  gst_memory_map (mem, &map, GST_MAP_READWRITE);
+  sizes = g_new (gint, len);
+
+  GST_OBJECT_LOCK (filter);
+
+  gst_srtp_init_event_reporter ();
+
+  if (filter->session == NULL) {
+    /* The rtcp session disappeared (element shutting down) */
+    GST_OBJECT_UNLOCK (filter);
+    gst_memory_unmap (mem, &map);
+    ret = GST_FLOW_FLUSHING;
+    goto out;
+  }
+
+  for (i = 0, offset = 0; i < len; i++) {
+    GstBuffer *buf = gst_buffer_list_get (buf_list, i);
+    guint8 *data = map.data + offset;
+
+    sizes[i] = gst_buffer_get_size (buf);
+    gst_buffer_extract (buf, 0, data, sizes[i]);
+    offset += sizes[i] + SRTP_MAX_TRAILER_LEN + 10;
+
+    gst_srtp_enc_ensure_ssrc (filter, buf);
+
+    err = gst_srtp_enc_protect (filter, data, &sizes[i], is_rtcp);
+    if (err != srtp_err_status_ok)
+      break;
+  }
+
+  GST_OBJECT_UNLOCK (filter);
+
+  gst_memory_unmap (mem, &map);
+
+  if (err != srtp_err_status_ok) {
+    ret = gst_srtp_enc_protect_error (filter, err);
+    goto out;
+  }
+
+  out_list = gst_buffer_list_new_sized (len);
+
+  for (i = 0, offset = 0; i < len; i++) {
+    GstBuffer *buf = gst_buffer_list_get (buf_list, i);
+    GstBuffer *bufout = gst_buffer_new ();
+
+    gst_buffer_append_memory (bufout, gst_memory_share (mem, offset,
+            sizes[i]));
+    gst_buffer_copy_into (bufout, buf, GST_BUFFER_COPY_METADATA, 0, -1);
+    gst_buffer_list_add (out_list, bufout);
+
+    offset += gst_buffer_get_size (buf) + SRTP_MAX_TRAILER_LEN + 10;
+  }
+
+  GST_LOG_OBJECT (pad, "Encoded list of %u %s buffers", len,
+      is_rtcp ? "RTCP" : "RTP");
+
+  *outlist_ptr = out_list;
+
+out:
+  g_free (sizes);
+  gst_memory_unref (mem);
+  return ret;
+}
+
 static GstFlowReturn
 gst_srtp_enc_chain (GstPad * pad, GstObject * parent, GstBuffer * buf,
     gboolean is_rtcp)
@@ -1257,25 +1346,6 @@ out:
   return ret;
 }
 
-static gboolean
-process_buffer_it (GstBuffer ** buffer, guint index, gpointer user_data)
-{
-  ProcessBufferItData *data = user_data;
-  GstBuffer *bufout;
-  GstFlowReturn ret;
-
-  ret = gst_srtp_enc_process_buffer (data->filter, data->pad, *buffer,
-      data->is_rtcp, &bufout);
-  if (ret != GST_FLOW_OK) {
-    data->flowret = ret;
-    return FALSE;
-  }
-
-  gst_buffer_list_add (data->out_list, bufout);
-
-  return TRUE;
-}
-
 static GstFlowReturn
 gst_srtp_enc_chain_list (GstPad * pad, GstObject * parent,
     GstBufferList * buf_list, gboolean is_rtcp)
@@ -1284,7 +1354,6 @@ gst_srtp_enc_chain_list (GstPad * pad, GstObject * parent,
   GstFlowReturn ret = GST_FLOW_OK;
   GstPad *otherpad;
   GstBufferList *out_list = NULL;
-  ProcessBufferItData process_data;
 
   GST_LOG_OBJECT (pad, "Buffer chain with list of %d",
       gst_buffer_list_length (buf_list));
@@ -1305,24 +1374,10 @@ gst_srtp_enc_chain_list (GstPad * pad, GstObject * parent,
 
   GST_OBJECT_UNLOCK (filter);
 
-  out_list = gst_buffer_list_new ();
-
-  process_data.filter = filter;
-  process_data.pad = pad;
-  process_data.is_rtcp = is_rtcp;
-  process_data.out_list = out_list;
-  process_data.flowret = GST_FLOW_OK;
-
-  if (!gst_buffer_list_foreach (buf_list, process_buffer_it, &process_data)) {
-    ret = process_data.flowret;
-    goto out;
-  }
-
-  if (!gst_buffer_list_length (out_list)) {
-    gst_buffer_list_unref (out_list);
-    ret = GST_FLOW_OK;
+  ret = gst_srtp_enc_process_buffer_list (filter, pad, buf_list, is_rtcp,
+      &out_list);
+  if (ret != GST_FLOW_OK)
     goto out;
-  }
 
   /* Push buffer to source pad */
   otherpad = get_rtp_other_pad (pad);
@@ -65,6 +65,9 @@
 #define RTPSTORAGE_EXTRA_TIME (50)
 
 #define DEFAULT_JB_LATENCY 200
+#define DEFAULT_ASYNC_ENCRYPTION FALSE
+#define DEFAULT_FORWARD_MODE FALSE
+#define DEFAULT_STATS_CACHE_TIME 0
 
 #define RTPHDREXT_MID GST_RTP_HDREXT_BASE "sdes:mid"
 #define RTPHDREXT_STREAM_ID GST_RTP_HDREXT_BASE "sdes:rtp-stream-id"
@@ -673,7 +676,10 @@ enum
   PROP_ICE_AGENT,
   PROP_LATENCY,
   PROP_SCTP_TRANSPORT,
-  PROP_HTTP_PROXY
+  PROP_HTTP_PROXY,
+  PROP_ASYNC_ENCRYPTION,
+  PROP_FORWARD_MODE,
+  PROP_STATS_CACHE_TIME,
 };
 
 static guint gst_webrtc_bin_signals[LAST_SIGNAL] = { 0 };
@@ -5192,7 +5198,8 @@ _connect_input_stream (GstWebRTCBin * webrtc, GstWebRTCBinPad * pad)
   g_assert (trans->stream);
 
   clocksync = gst_element_factory_make ("clocksync", NULL);
-  g_object_set (clocksync, "sync", TRUE, NULL);
+  /* forwarded packets are sent out as they arrive */
+  g_object_set (clocksync, "sync", !webrtc->priv->forward_mode, NULL);
   gst_bin_add (GST_BIN (webrtc), clocksync);
   gst_element_sync_state_with_parent (clocksync);
 
@@ -6761,47 +6768,95 @@ bad_input:
 }
 
 static GstStructure *
-_add_ice_candidate_task (GstWebRTCBin * webrtc, IceCandidateItem * item)
+_add_ice_candidates_task (GstWebRTCBin * webrtc)
 {
-  if (!webrtc->current_local_description || !webrtc->current_remote_description) {
-    IceCandidateItem new;
-    new.mlineindex = item->mlineindex;
-    new.candidate = g_steal_pointer (&item->candidate);
+  gboolean have_descriptions;
+  GArray *items;
+  gsize i;
 
-    ICE_LOCK (webrtc);
-    g_array_append_val (webrtc->priv->pending_remote_ice_candidates, new);
+  ICE_LOCK (webrtc);
+  if (webrtc->priv->trickled_remote_ice_candidates->len == 0) {
     ICE_UNLOCK (webrtc);
-  } else {
+    return NULL;
+  }
+
+  have_descriptions = webrtc->current_local_description
+      && webrtc->current_remote_description;
+
+  /* Without both descriptions, the whole batch is deferred until the
+   * remote description has been applied */
+  if (!have_descriptions) {
+    for (i = 0; i < webrtc->priv->trickled_remote_ice_candidates->len; i++) {
+      IceCandidateItem *item =
+          &g_array_index (webrtc->priv->trickled_remote_ice_candidates,
+          IceCandidateItem, i);
+      IceCandidateItem new;
+
+      new.mlineindex = item->mlineindex;
+      new.candidate = g_steal_pointer (&item->candidate);
+      g_array_append_val (webrtc->priv->pending_remote_ice_candidates, new);
+    }
+    g_array_set_size (webrtc->priv->trickled_remote_ice_candidates, 0);
+    ICE_UNLOCK (webrtc);
+    return NULL;
+  }
+
+  /* Take the array so that candidates trickled while we are adding these
+   * queue a new task */
+  items = webrtc->priv->trickled_remote_ice_candidates;
+  webrtc->priv->trickled_remote_ice_candidates =
+      g_array_new (FALSE, TRUE, sizeof (IceCandidateItem));
+  g_array_set_clear_func (webrtc->priv->trickled_remote_ice_candidates,
+      (GDestroyNotify) _clear_ice_candidate_item);
+  ICE_UNLOCK (webrtc);
+
+  GST_DEBUG_OBJECT (webrtc, "adding %u trickled ICE candidates", items->len);
+
+  for (i = 0; i < items->len; i++) {
+    IceCandidateItem *item = &g_array_index (items, IceCandidateItem, i);
+
     _add_ice_candidate (webrtc, item, FALSE);
   }
+  g_array_free (items, TRUE);
 
   return NULL;
 }
 
-static void
-_free_ice_candidate_item (IceCandidateItem * item)
-{
-  _clear_ice_candidate_item (item);
-  g_free (item);
-}
-
 static void
 gst_webrtc_bin_add_ice_candidate (GstWebRTCBin * webrtc, guint mline,
     const gchar * attr)
 {
-  IceCandidateItem *item;
+  IceCandidateItem item;
+  gboolean queue_task = FALSE;
 
-  item = g_new0 (IceCandidateItem, 1);
-  item->mlineindex = mline;
+  item.mlineindex = mline;
+  item.candidate = NULL;
   if (attr && attr[0] != 0) {
     if (!g_ascii_strncasecmp (attr, "a=candidate:", 12))
-      item->candidate = g_strdup (attr);
+      item.candidate = g_strdup (attr);
     else if (!g_ascii_strncasecmp (attr, "candidate:", 10))
-      item->candidate = g_strdup_printf ("a=%s", attr);
+      item.candidate = g_strdup_printf ("a=%s", attr);
+  }
+
+  ICE_LOCK (webrtc);
+  g_array_append_val (webrtc->priv->trickled_remote_ice_candidates, item);
+
+  /* Candidates usually arrive in bursts from the signalling channel. Only the
+   * first pending candidate queues a task, which adds every candidate that
+   * arrived until it runs in one go */
+  if (webrtc->priv->trickled_remote_ice_candidates->len == 1)
+    queue_task = TRUE;
+  ICE_UNLOCK (webrtc);
+
+  if (queue_task) {
+    GST_TRACE_OBJECT (webrtc, "Queueing add_ice_candidates_task");
+    if (!gst_webrtc_bin_enqueue_task (webrtc,
+            (GstWebRTCBinFunc) _add_ice_candidates_task, NULL, NULL, NULL)) {
+      ICE_LOCK (webrtc);
+      g_array_set_size (webrtc->priv->trickled_remote_ice_candidates, 0);
+      ICE_UNLOCK (webrtc);
+    }
   }
-  gst_webrtc_bin_enqueue_task (webrtc,
-      (GstWebRTCBinFunc) _add_ice_candidate_task, item,
-      (GDestroyNotify) _free_ice_candidate_item, NULL);
 }
 
 static GstStructure *
@@ -6911,11 +6966,40 @@ _free_get_stats (struct get_stats *stats)
 static GstStructure *
 _get_stats_task (GstWebRTCBin * webrtc, struct get_stats *stats)
 {
+  GstStructure *s;
+
   /* Our selector is the pad,
    * https://www.w3.org/TR/webrtc/#dfn-stats-selection-algorithm
    */
 
-  return gst_webrtc_bin_create_stats (webrtc, stats->pad);
+  s = gst_webrtc_bin_create_stats (webrtc, stats->pad);
+
+  if (!stats->pad) {
+    GST_OBJECT_LOCK (webrtc);
+    if (webrtc->priv->stats_cache_time > 0) {
+      g_clear_pointer (&webrtc->priv->cached_stats, gst_structure_free);
+      webrtc->priv->cached_stats = gst_structure_copy (s);
+      webrtc->priv->cached_stats_time = gst_util_get_timestamp ();
+    }
+    GST_OBJECT_UNLOCK (webrtc);
+  }
+
+  return s;
+}
+
+static GstStructure *
+_get_cached_stats (GstWebRTCBin * webrtc)
+{
+  GstStructure *s = NULL;
+
+  GST_OBJECT_LOCK (webrtc);
+  if (webrtc->priv->cached_stats && webrtc->priv->stats_cache_time > 0
+      && gst_util_get_timestamp () - webrtc->priv->cached_stats_time <
+      webrtc->priv->stats_cache_time)
+    s = gst_structure_copy (webrtc->priv->cached_stats);
+  GST_OBJECT_UNLOCK (webrtc);
+
+  return s;
 }
 
 static void
@@ -6927,6 +7011,16 @@ gst_webrtc_bin_get_stats (GstWebRTCBin * webrtc, GstPad * pad,
   g_return_if_fail (promise != NULL);
   g_return_if_fail (pad == NULL || GST_IS_WEBRTC_BIN_PAD (pad));
 
+  if (!pad) {
+    GstStructure *s = _get_cached_stats (webrtc);
+
+    if (s) {
+      GST_LOG_OBJECT (webrtc, "replying with cached stats");
+      gst_promise_reply (promise, s);
+      return;
+    }
+  }
+
   stats = g_new0 (struct get_stats, 1);
   stats->promise = gst_promise_ref (promise);
   /* FIXME: check that pad exists in element */
@@ -7757,6 +7851,10 @@ on_rtpbin_new_jitterbuffer (GstElement * rtpbin, GstElement * jitterbuffer,
   GST_INFO_OBJECT (webrtc, "new jitterbuffer %" GST_PTR_FORMAT " for "
       "session %u ssrc %u", jitterbuffer, session_id, ssrc);
 
+  /* there is no jitterbuffer to configure when forwarding */
+  if (webrtc->priv->forward_mode)
+    goto out;
+
   if (!(stream = _find_transport_for_session (webrtc, session_id))) {
     g_warn_if_reached ();
     goto out;
@@ -7773,6 +7871,23 @@ out:
   PC_UNLOCK (webrtc);
 }
 
+static GstElement *
+on_rtpbin_request_jitterbuffer (GstElement * rtpbin, guint session_id,
+    GstWebRTCBin * webrtc)
+{
+  GstElement *ret = NULL;
+
+  PC_LOCK (webrtc);
+  if (webrtc->priv->forward_mode) {
+    GST_DEBUG_OBJECT (webrtc, "bypassing the jitterbuffer for session %u",
+        session_id);
+    ret = gst_element_factory_make ("identity", NULL);
+  }
+  PC_UNLOCK (webrtc);
+
+  return ret;
+}
+
 static void
 on_rtpbin_new_storage (GstElement * rtpbin, GstElement * storage,
     guint session_id, GstWebRTCBin * webrtc)
@@ -7835,6 +7950,8 @@ _create_rtpbin (GstWebRTCBin * webrtc)
       G_CALLBACK (on_rtpbin_timeout), webrtc);
   g_signal_connect (rtpbin, "new-jitterbuffer",
       G_CALLBACK (on_rtpbin_new_jitterbuffer), webrtc);
+  g_signal_connect (rtpbin, "request-jitterbuffer",
+      G_CALLBACK (on_rtpbin_request_jitterbuffer), webrtc);
 
   return rtpbin;
 }
@@ -7883,6 +8000,9 @@ gst_webrtc_bin_change_state (GstElement * element, GstStateChange transition)
       break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       _stop_thread (webrtc);
+      GST_OBJECT_LOCK (webrtc);
+      g_clear_pointer (&webrtc->priv->cached_stats, gst_structure_free);
+      GST_OBJECT_UNLOCK (webrtc);
       break;
     default:
       break;
@@ -7985,6 +8105,94 @@ sink_pad_buffer_peek (GstPad * pad, GstPadProbeInfo * info,
   return GST_PAD_PROBE_OK;
 }
 
+static gboolean
+forward_rewrite_buffer (GstBuffer ** buffer, guint idx,
+    GstWebRTCBinPad * pad)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  guint32 ssrc;
+  guint16 seqnum;
+
+  *buffer = gst_buffer_make_writable (*buffer);
+
+  if (!gst_rtp_buffer_map (*buffer, GST_MAP_READWRITE, &rtp))
+    return TRUE;
+
+  ssrc = gst_rtp_buffer_get_ssrc (&rtp);
+  seqnum = gst_rtp_buffer_get_seq (&rtp);
+
+  if (!pad->have_forward_ssrc) {
+    pad->forward_ssrc = ssrc;
+    pad->have_forward_ssrc = TRUE;
+  }
+
+  if (!pad->have_forward_in_ssrc || pad->forward_in_ssrc != ssrc) {
+    /* switched to another stream, continue after the highest sequence
+     * number sent so far */
+    if (pad->have_forward_in_ssrc)
+      pad->forward_seqnum_offset = pad->forward_max_seqnum + 1 - seqnum;
+    pad->forward_in_ssrc = ssrc;
+    pad->have_forward_in_ssrc = TRUE;
+    pad->forward_max_seqnum = seqnum + pad->forward_seqnum_offset;
+    GST_DEBUG_OBJECT (pad, "forwarding SSRC %08x as %08x, seqnum offset %u",
+        ssrc, pad->forward_ssrc, pad->forward_seqnum_offset);
+  }
+
+  seqnum += pad->forward_seqnum_offset;
+  if (gst_rtp_buffer_compare_seqnum (pad->forward_max_seqnum, seqnum) > 0)
+    pad->forward_max_seqnum = seqnum;
+
+  gst_rtp_buffer_set_ssrc (&rtp, pad->forward_ssrc);
+  gst_rtp_buffer_set_seq (&rtp, seqnum);
+  gst_rtp_buffer_unmap (&rtp);
+
+  return TRUE;
+}
+
+static GstPadProbeReturn
+sink_pad_forward_rewrite (GstPad * pad, GstPadProbeInfo * info,
+    gpointer unused)
+{
+  GstWebRTCBinPad *webrtc_pad = GST_WEBRTC_BIN_PAD (pad);
+
+  if (info->type & GST_PAD_PROBE_TYPE_BUFFER) {
+    forward_rewrite_buffer ((GstBuffer **) & info->data, 0, webrtc_pad);
+  } else if (info->type & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST (info);
+
+    list = gst_buffer_list_make_writable (list);
+    gst_buffer_list_foreach (list, (GstBufferListFunc) forward_rewrite_buffer,
+        webrtc_pad);
+    info->data = list;
+  } else if (GST_EVENT_TYPE (GST_PAD_PROBE_INFO_EVENT (info)) ==
+      GST_EVENT_CAPS) {
+    GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+    GstCaps *caps;
+    guint ssrc;
+
+    /* keep the SSRC in the caps to the one that is sent out, a change of
+     * the forwarded stream must not cause a renegotiation */
+    gst_event_parse_caps (event, &caps);
+    if (!gst_structure_get_uint (gst_caps_get_structure (caps, 0), "ssrc",
+            &ssrc))
+      return GST_PAD_PROBE_OK;
+
+    if (!webrtc_pad->have_forward_ssrc) {
+      webrtc_pad->forward_ssrc = ssrc;
+      webrtc_pad->have_forward_ssrc = TRUE;
+    } else if (ssrc != webrtc_pad->forward_ssrc) {
+      caps = gst_caps_copy (caps);
+      gst_caps_set_simple (caps, "ssrc", G_TYPE_UINT, webrtc_pad->forward_ssrc,
+          NULL);
+      info->data = gst_event_new_caps (caps);
+      gst_caps_unref (caps);
+      gst_event_unref (event);
+    }
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
 static GstPad *
 gst_webrtc_bin_request_new_pad (GstElement * element, GstPadTemplate * templ,
     const gchar * name, const GstCaps * caps)
@@ -8139,6 +8347,11 @@ gst_webrtc_bin_request_new_pad (GstElement * element, GstPadTemplate * templ,
   }
   pad = _create_pad_for_sdp_media (webrtc, GST_PAD_SINK, trans, serial, NULL);
 
+  if (webrtc->priv->forward_mode)
+    gst_pad_add_probe (GST_PAD (pad), GST_PAD_PROBE_TYPE_BUFFER |
+        GST_PAD_PROBE_TYPE_BUFFER_LIST | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+        (GstPadProbeCallback) sink_pad_forward_rewrite, NULL, NULL);
+
   pad->block_id = gst_pad_add_probe (GST_PAD (pad), GST_PAD_PROBE_TYPE_BLOCK |
       GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
       (GstPadProbeCallback) sink_pad_block, NULL, NULL);
@@ -8254,6 +8467,18 @@ gst_webrtc_bin_set_property (GObject * object, guint prop_id,
       gst_webrtc_ice_set_http_proxy (webrtc->priv->ice,
           g_value_get_string (value));
       break;
+    case PROP_ASYNC_ENCRYPTION:
+      webrtc->priv->async_encryption = g_value_get_boolean (value);
+      break;
+    case PROP_FORWARD_MODE:
+      webrtc->priv->forward_mode = g_value_get_boolean (value);
+      break;
+    case PROP_STATS_CACHE_TIME:
+      GST_OBJECT_LOCK (webrtc);
+      webrtc->priv->stats_cache_time = g_value_get_uint64 (value);
+      g_clear_pointer (&webrtc->priv->cached_stats, gst_structure_free);
+      GST_OBJECT_UNLOCK (webrtc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -8335,6 +8560,17 @@ gst_webrtc_bin_get_property (GObject * object, guint prop_id,
       g_value_take_string (value,
           gst_webrtc_ice_get_http_proxy (webrtc->priv->ice));
       break;
+    case PROP_ASYNC_ENCRYPTION:
+      g_value_set_boolean (value, webrtc->priv->async_encryption);
+      break;
+    case PROP_FORWARD_MODE:
+      g_value_set_boolean (value, webrtc->priv->forward_mode);
+      break;
+    case PROP_STATS_CACHE_TIME:
+      GST_OBJECT_LOCK (webrtc);
+      g_value_set_uint64 (value, webrtc->priv->stats_cache_time);
+      GST_OBJECT_UNLOCK (webrtc);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -8412,6 +8648,12 @@ gst_webrtc_bin_finalize (GObject * object)
     g_array_free (webrtc->priv->pending_local_ice_candidates, TRUE);
   webrtc->priv->pending_local_ice_candidates = NULL;
 
+  if (webrtc->priv->trickled_remote_ice_candidates)
+    g_array_free (webrtc->priv->trickled_remote_ice_candidates, TRUE);
+  webrtc->priv->trickled_remote_ice_candidates = NULL;
+
+  g_clear_pointer (&webrtc->priv->cached_stats, gst_structure_free);
+
   if (webrtc->priv->pending_pads)
     g_list_free_full (webrtc->priv->pending_pads,
         (GDestroyNotify) _free_pending_pad);
@@ -8635,6 +8877,73 @@ gst_webrtc_bin_class_init (GstWebRTCBinClass * klass)
           "http://[username:password@]hostname[:port]",
           NULL, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstWebRTCBin:async-encryption:
+   *
+   * Whether to encrypt outgoing RTP in a separate streaming thread per
+   * transport instead of in the thread pushing into webrtcbin.
+   *
+   * Only affects transports created after the property is set.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_ASYNC_ENCRYPTION,
+      g_param_spec_boolean ("async-encryption", "Async Encryption",
+          "Encrypt outgoing RTP in a separate thread per transport",
+          DEFAULT_ASYNC_ENCRYPTION,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstWebRTCBin:forward-mode:
+   *
+   * Configure webrtcbin for forwarding RTP between peers without decoding
+   * it, e.g. for building a selective forwarding unit.
+   *
+   * Received RTP is output as soon as it arrives, without going through a
+   * jitterbuffer. Retransmission requests for received streams are
+   * therefore not sent either.
+   *
+   * On the sending side, RTP is not synchronised against the clock and the
+   * sequence numbers and SSRC of each sink pad are rewritten, so that the
+   * stream forwarded into a pad can be switched to another one without
+   * the receiver seeing a new stream. The SSRC of the first stream is kept
+   * for the pad's lifetime. Transport-wide congestion control sequence
+   * numbers are already rewritten by the RTP session on sending.
+   *
+   * Must be set before requesting pads and before any stream is received.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_FORWARD_MODE,
+      g_param_spec_boolean ("forward-mode", "Forward Mode",
+          "Forward RTP without jitterbuffering and rewrite the SSRC and "
+          "sequence numbers of each sink pad",
+          DEFAULT_FORWARD_MODE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstWebRTCBin:stats-cache-time:
+   *
+   * Time in nanoseconds for which the statistics of the whole peer
+   * connection returned by #GstWebRTCBin::get-stats are reused.
+   *
+   * While the last statistics are younger than this, "get-stats" without a
+   * pad replies immediately with a copy of them instead of collecting them
+   * again from all the RTP sessions and ICE streams on the webrtcbin
+   * thread. This is useful when the statistics of many peer connections
+   * are polled periodically. 0 disables caching.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_STATS_CACHE_TIME,
+      g_param_spec_uint64 ("stats-cache-time", "Stats Cache Time",
+          "Time in nanoseconds for which the peer connection statistics are "
+          "reused by get-stats (0 = disabled)", 0, G_MAXUINT64,
+          DEFAULT_STATS_CACHE_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstWebRTCBin:sctp-transport:
    *
@@ -9039,7 +9348,15 @@ gst_webrtc_bin_init (GstWebRTCBin * webrtc)
   g_array_set_clear_func (webrtc->priv->pending_local_ice_candidates,
       (GDestroyNotify) _clear_ice_candidate_item);
 
+  webrtc->priv->trickled_remote_ice_candidates =
+      g_array_new (FALSE, TRUE, sizeof (IceCandidateItem));
+  g_array_set_clear_func (webrtc->priv->trickled_remote_ice_candidates,
+      (GDestroyNotify) _clear_ice_candidate_item);
+
   /* we start off closed until we move to READY */
   webrtc->priv->is_closed = TRUE;
   webrtc->priv->jb_latency = DEFAULT_JB_LATENCY;
+  webrtc->priv->async_encryption = DEFAULT_ASYNC_ENCRYPTION;
+  webrtc->priv->forward_mode = DEFAULT_FORWARD_MODE;
+  webrtc->priv->stats_cache_time = DEFAULT_STATS_CACHE_TIME;
 }
@@ -49,6 +49,14 @@ struct _GstWebRTCBinPad
 
   GstCaps              *received_caps;
   char                 *msid;
+
+  /* forward-mode header rewriting, only used from the streaming thread */
+  gboolean              have_forward_ssrc;
+  guint32               forward_ssrc;
+  gboolean              have_forward_in_ssrc;
+  guint32               forward_in_ssrc;
+  guint16               forward_seqnum_offset;
+  guint16               forward_max_seqnum;
 };
 
 struct _GstWebRTCBinPadClass
@@ -117,6 +125,13 @@ struct _GstWebRTCBinPrivate
   GMutex dc_lock;
 
   guint jb_latency;
+  gboolean async_encryption;
+  gboolean forward_mode;
+
+  /* protected by the object lock */
+  GstClockTime stats_cache_time;
+  GstStructure *cached_stats;
+  GstClockTime cached_stats_time;
 
   WebRTCSCTPTransport *sctp_transport;
   TransportStream *data_channel_transport;
@@ -126,6 +141,9 @@ struct _GstWebRTCBinPrivate
   GMutex ice_lock;
   GArray *pending_remote_ice_candidates;
   GArray *pending_local_ice_candidates;
+  /* remote candidates trickled in by the application that are waiting for
+   * the next add-ice-candidates task, protected by the ICE lock */
+  GArray *trickled_remote_ice_candidates;
 
   /* peerconnection variables */
   gboolean is_closed;
@@ -36,6 +36,10 @@
  *           ;   '-------------------'
  *           '-------------------------------------------'
  *
+ * With async-encryption, a queue is placed between rtp_sink and
+ * rtp_sink_0 so that protecting the RTP packets happens in a streaming
+ * thread of its own for each transport.
+ *
  *
  * FIXME: Do we need a valve drop=TRUE for the no RTCP case?
  */
@@ -70,6 +74,7 @@ enum
 {
   PROP_0,
   PROP_STREAM,
+  PROP_ASYNC_ENCRYPTION,
 };
 
 #define TSB_GET_LOCK(tsb) (&tsb->lock)
@@ -90,6 +95,9 @@ transport_send_bin_set_property (GObject * object, guint prop_id,
       /* XXX: weak-ref this? Note, it's construct-only so can't be changed later */
       send->stream = TRANSPORT_STREAM (g_value_get_object (value));
       break;
+    case PROP_ASYNC_ENCRYPTION:
+      send->async_encryption = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -108,6 +116,9 @@ transport_send_bin_get_property (GObject * object, guint prop_id,
     case PROP_STREAM:
       g_value_set_object (value, send->stream);
       break;
+    case PROP_ASYNC_ENCRYPTION:
+      g_value_set_boolean (value, send->async_encryption);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -349,6 +360,25 @@ transport_send_bin_constructed (GObject * object)
       "rtp_sink_%d");
   pad = gst_element_request_pad (send->dtlssrtpenc, templ, "rtp_sink_0", NULL);
 
+  if (send->async_encryption) {
+    GstPad *queue_pad;
+
+    /* only bound the queue in time, the packet rate differs a lot between
+     * audio and video */
+    send->rtp_queue = gst_element_factory_make ("queue", NULL);
+    g_object_set (send->rtp_queue, "max-size-buffers", 0, "max-size-bytes", 0,
+        "max-size-time", 200 * GST_MSECOND, NULL);
+    gst_bin_add (GST_BIN (send), send->rtp_queue);
+
+    queue_pad = gst_element_get_static_pad (send->rtp_queue, "src");
+    if (gst_pad_link (queue_pad, pad) != GST_PAD_LINK_OK)
+      g_warn_if_reached ();
+    gst_object_unref (queue_pad);
+    gst_object_unref (pad);
+
+    pad = gst_element_get_static_pad (send->rtp_queue, "sink");
+  }
+
   ghost = gst_ghost_pad_new ("rtp_sink", pad);
   gst_element_add_pad (GST_ELEMENT (send), ghost);
   gst_object_unref (pad);
@@ -528,6 +558,13 @@ transport_send_bin_class_init (TransportSendBinClass * klass)
           "The TransportStream for this sending bin",
           transport_stream_get_type (),
           G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (gobject_class,
+      PROP_ASYNC_ENCRYPTION,
+      g_param_spec_boolean ("async-encryption", "Async Encryption",
+          "Encrypt RTP in a separate streaming thread",
+          FALSE,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
 }
 
 static void
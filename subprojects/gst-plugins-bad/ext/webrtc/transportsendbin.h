@@ -48,6 +48,11 @@ struct _TransportSendBin
 
   gboolean has_clientness;
 
+  /* queue in front of the dtlssrtpenc RTP sink pad, if async-encryption is
+   * enabled */
+  GstElement *rtp_queue;
+  gboolean async_encryption;
+
   /* Block on the dtlssrtpenc RTP sink pad, if any */
   struct pad_block          *rtp_block;
   /* Block on the dtlssrtpenc RTCP sink pad, if any */
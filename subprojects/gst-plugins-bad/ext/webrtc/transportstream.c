@@ -229,7 +229,7 @@ transport_stream_constructed (GObject * object)
   gst_object_unref (ice_trans);
 
   stream->send_bin = g_object_new (transport_send_bin_get_type (), "stream",
-      stream, NULL);
+      stream, "async-encryption", webrtc->priv->async_encryption, NULL);
   gst_object_ref_sink (stream->send_bin);
   stream->receive_bin = g_object_new (transport_receive_bin_get_type (),
       "stream", stream, NULL);
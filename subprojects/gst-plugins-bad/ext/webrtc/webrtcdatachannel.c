@@ -677,7 +677,14 @@ _data_channel_have_sample (WebRTCDataChannel * channel, GstSample * sample,
     }
     case DATA_CHANNEL_PPID_WEBRTC_BINARY:
     case DATA_CHANNEL_PPID_WEBRTC_BINARY_PARTIAL:{
-      struct map_info *info = g_new0 (struct map_info, 1);
+      struct map_info *info;
+
+      /* handed to the application as is if it asked for buffers */
+      if (gst_webrtc_data_channel_on_message_buffer (GST_WEBRTC_DATA_CHANNEL
+              (channel), buffer))
+        break;
+
+      info = g_new0 (struct map_info, 1);
       if (!gst_buffer_map (buffer, &info->map_info, GST_MAP_READ)) {
         g_set_error (error, GST_WEBRTC_ERROR,
             GST_WEBRTC_ERROR_DATA_CHANNEL_FAILURE,
@@ -895,6 +902,81 @@ webrtc_data_channel_send_data (GstWebRTCDataChannel * base_channel,
   return TRUE;
 }
 
+static gboolean
+webrtc_data_channel_send_buffer_list (GstWebRTCDataChannel * base_channel,
+    GstBufferList * list, GError ** error)
+{
+  WebRTCDataChannel *channel = WEBRTC_DATA_CHANNEL (base_channel);
+  GstSctpSendMetaPartiallyReliability reliability;
+  guint rel_param;
+  GstBufferList *out_list;
+  guint i, len;
+  gsize size = 0;
+  GstFlowReturn ret;
+
+  len = gst_buffer_list_length (list);
+  if (len == 0)
+    return TRUE;
+
+  _get_sctp_reliability (channel, &reliability, &rel_param);
+
+  out_list = gst_buffer_list_new_sized (len);
+  for (i = 0; i < len; i++) {
+    GstBuffer *buffer = gst_buffer_list_get (list, i);
+    gsize buffer_size = gst_buffer_get_size (buffer);
+
+    if (!_is_within_max_message_size (channel, buffer_size)) {
+      gst_buffer_list_unref (out_list);
+      g_set_error (error, GST_WEBRTC_ERROR, GST_WEBRTC_ERROR_TYPE_ERROR,
+          "Requested to send data that is too large");
+      return FALSE;
+    }
+
+    /* a shallow copy to carry the send meta, the memory is shared */
+    buffer = gst_buffer_copy (buffer);
+    gst_sctp_buffer_add_send_meta (buffer, buffer_size > 0 ?
+        DATA_CHANNEL_PPID_WEBRTC_BINARY : DATA_CHANNEL_PPID_WEBRTC_BINARY_EMPTY,
+        channel->parent.ordered, reliability, rel_param);
+    gst_buffer_list_add (out_list, buffer);
+
+    size += buffer_size;
+  }
+
+  GST_LOG_OBJECT (channel, "Sending %u messages of %" G_GSIZE_FORMAT
+      " bytes in total", len, size);
+
+  GST_WEBRTC_DATA_CHANNEL_LOCK (channel);
+  if (channel->parent.ready_state == GST_WEBRTC_DATA_CHANNEL_STATE_OPEN) {
+    channel->parent.buffered_amount += size;
+  } else {
+    GST_WEBRTC_DATA_CHANNEL_UNLOCK (channel);
+    gst_buffer_list_unref (out_list);
+    g_set_error (error, GST_WEBRTC_ERROR,
+        GST_WEBRTC_ERROR_INVALID_STATE, "channel is not open");
+    return FALSE;
+  }
+  GST_WEBRTC_DATA_CHANNEL_UNLOCK (channel);
+
+  ret = gst_app_src_push_buffer_list (GST_APP_SRC (channel->appsrc), out_list);
+  if (ret == GST_FLOW_OK) {
+    g_object_notify (G_OBJECT (&channel->parent), "buffered-amount");
+  } else {
+    g_set_error (error, GST_WEBRTC_ERROR,
+        GST_WEBRTC_ERROR_DATA_CHANNEL_FAILURE, "Failed to send data");
+    GST_WARNING_OBJECT (channel, "push returned %i, %s", ret,
+        gst_flow_get_name (ret));
+
+    GST_WEBRTC_DATA_CHANNEL_LOCK (channel);
+    channel->parent.buffered_amount -= size;
+    GST_WEBRTC_DATA_CHANNEL_UNLOCK (channel);
+
+    _channel_enqueue_task (channel, (ChannelTask) _close_procedure, NULL, NULL);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 static gboolean
 webrtc_data_channel_send_string (GstWebRTCDataChannel * base_channel,
     const gchar * str, GError ** error)
@@ -1144,6 +1226,7 @@ webrtc_data_channel_class_init (WebRTCDataChannelClass * klass)
 
   channel_class->send_data = webrtc_data_channel_send_data;
   channel_class->send_string = webrtc_data_channel_send_string;
+  channel_class->send_buffer_list = webrtc_data_channel_send_buffer_list;
   channel_class->close = webrtc_data_channel_close;
 }
 
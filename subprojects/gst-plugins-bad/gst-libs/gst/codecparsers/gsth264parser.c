@@ -2554,16 +2554,48 @@ gst_h264_parser_parse_sei (GstH264NalParser * nalparser, GstH264NalUnit * nalu,
   GstH264SEIMessage sei;
   GstH264ParserResult res;
 
+  *messages = g_array_new (FALSE, FALSE, sizeof (GstH264SEIMessage));
+
+  return gst_h264_parser_parse_sei_into (nalparser, nalu, *messages);
+}
+
+/**
+ * gst_h264_parser_parse_sei_into:
+ * @nalparser: a #GstH264NalParser
+ * @nalu: The #GST_H264_NAL_SEI #GstH264NalUnit to parse
+ * @messages: The GArray of #GstH264SEIMessage to fill
+ *
+ * Parses @nalu containing one or more Supplementary Enhancement Information
+ * messages into @messages, which was created by the caller. Any previous
+ * content of @messages is cleared first, so that the same array can be
+ * reused for each SEI without allocating a new one.
+ *
+ * Returns: a #GstH264ParserResult
+ *
+ * Since: 1.24
+ */
+GstH264ParserResult
+gst_h264_parser_parse_sei_into (GstH264NalParser * nalparser,
+    GstH264NalUnit * nalu, GArray * messages)
+{
+  NalReader nr;
+  GstH264SEIMessage sei;
+  GstH264ParserResult res;
+
+  g_return_val_if_fail (messages != NULL, GST_H264_PARSER_ERROR);
+  g_return_val_if_fail (g_array_get_element_size (messages) ==
+      sizeof (GstH264SEIMessage), GST_H264_PARSER_ERROR);
+
   GST_DEBUG ("parsing SEI nal");
   nal_reader_init (&nr, nalu->data + nalu->offset + nalu->header_bytes,
       nalu->size - nalu->header_bytes);
-  *messages = g_array_new (FALSE, FALSE, sizeof (GstH264SEIMessage));
-  g_array_set_clear_func (*messages, (GDestroyNotify) gst_h264_sei_clear);
+  g_array_set_clear_func (messages, (GDestroyNotify) gst_h264_sei_clear);
+  g_array_set_size (messages, 0);
 
   do {
     res = gst_h264_parser_parse_sei_message (nalparser, &nr, &sei);
     if (res == GST_H264_PARSER_OK)
-      g_array_append_val (*messages, sei);
+      g_array_append_val (messages, sei);
     else
       break;
   } while (nal_reader_has_more_data (&nr));
@@ -1406,6 +1406,10 @@ GST_CODEC_PARSERS_API
 GstH264ParserResult gst_h264_parser_parse_sei         (GstH264NalParser *nalparser,
                                                        GstH264NalUnit *nalu, GArray ** messages);
 
+GST_CODEC_PARSERS_API
+GstH264ParserResult gst_h264_parser_parse_sei_into    (GstH264NalParser *nalparser,
+                                                       GstH264NalUnit *nalu, GArray * messages);
+
 GST_CODEC_PARSERS_API
 GstH264ParserResult gst_h264_parser_update_sps        (GstH264NalParser *nalparser,
                                                        GstH264SPS *sps);
@@ -3277,16 +3277,47 @@ gst_h265_parser_parse_sei (GstH265Parser * nalparser, GstH265NalUnit * nalu,
   GstH265SEIMessage sei;
   GstH265ParserResult res;
 
+  *messages = g_array_new (FALSE, FALSE, sizeof (GstH265SEIMessage));
+
+  return gst_h265_parser_parse_sei_into (nalparser, nalu, *messages);
+}
+
+/**
+ * gst_h265_parser_parse_sei_into:
+ * @nalparser: a #GstH265Parser
+ * @nalu: The `GST_H265_NAL_*_SEI` #GstH265NalUnit to parse
+ * @messages: The GArray of #GstH265SEIMessage to fill
+ *
+ * Parses @nalu into @messages, which was created by the caller. Any previous
+ * content of @messages is cleared first, so that the same array can be
+ * reused for each SEI without allocating a new one.
+ *
+ * Returns: a #GstH265ParserResult
+ *
+ * Since: 1.24
+ */
+GstH265ParserResult
+gst_h265_parser_parse_sei_into (GstH265Parser * nalparser,
+    GstH265NalUnit * nalu, GArray * messages)
+{
+  NalReader nr;
+  GstH265SEIMessage sei;
+  GstH265ParserResult res;
+
+  g_return_val_if_fail (messages != NULL, GST_H265_PARSER_ERROR);
+  g_return_val_if_fail (g_array_get_element_size (messages) ==
+      sizeof (GstH265SEIMessage), GST_H265_PARSER_ERROR);
+
   GST_DEBUG ("parsing SEI nal");
   nal_reader_init (&nr, nalu->data + nalu->offset + nalu->header_bytes,
       nalu->size - nalu->header_bytes);
-  *messages = g_array_new (FALSE, FALSE, sizeof (GstH265SEIMessage));
-  g_array_set_clear_func (*messages, (GDestroyNotify) gst_h265_sei_free);
+  g_array_set_clear_func (messages, (GDestroyNotify) gst_h265_sei_free);
+  g_array_set_size (messages, 0);
 
   do {
     res = gst_h265_parser_parse_sei_message (nalparser, nalu->type, &nr, &sei);
     if (res == GST_H265_PARSER_OK)
-      g_array_append_val (*messages, sei);
+      g_array_append_val (messages, sei);
     else
       break;
   } while (nal_reader_has_more_data (&nr));
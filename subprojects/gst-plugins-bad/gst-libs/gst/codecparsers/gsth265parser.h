@@ -1736,6 +1736,11 @@ GstH265ParserResult gst_h265_parser_parse_sei       (GstH265Parser   * parser,
                                                      GstH265NalUnit  * nalu,
                                                      GArray **messages);
 
+GST_CODEC_PARSERS_API
+GstH265ParserResult gst_h265_parser_parse_sei_into  (GstH265Parser   * parser,
+                                                     GstH265NalUnit  * nalu,
+                                                     GArray * messages);
+
 GST_CODEC_PARSERS_API
 GstH265ParserResult gst_h265_parser_update_vps      (GstH265Parser   * parser,
                                                      GstH265VPS      * vps);
@@ -48,6 +48,7 @@ struct _GstAV1DecoderPrivate
   guint preferred_output_delay;
   GstQueueArray *output_queue;
   gboolean is_live;
+  gboolean low_latency;
 
   gboolean input_state_changed;
 };
@@ -68,6 +69,12 @@ G_DEFINE_ABSTRACT_TYPE_WITH_CODE (GstAV1Decoder, gst_av1_decoder,
     GST_DEBUG_CATEGORY_INIT (gst_av1_decoder_debug, "av1decoder", 0,
         "AV1 Video Decoder"));
 
+enum
+{
+  PROP_0,
+  PROP_LOW_LATENCY,
+};
+
 static gint
 _floor_log2 (guint32 x)
 {
@@ -94,12 +101,52 @@ static GstFlowReturn gst_av1_decoder_handle_frame (GstVideoDecoder * decoder,
 static void
 gst_av1_decoder_clear_output_frame (GstAV1DecoderOutputFrame * output_frame);
 
+static void
+gst_av1_decoder_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstAV1Decoder *self = GST_AV1_DECODER (object);
+  GstAV1DecoderPrivate *priv = self->priv;
+
+  switch (property_id) {
+    case PROP_LOW_LATENCY:
+      GST_OBJECT_LOCK (self);
+      g_value_set_boolean (value, priv->low_latency);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_av1_decoder_set_property (GObject * object, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstAV1Decoder *self = GST_AV1_DECODER (object);
+  GstAV1DecoderPrivate *priv = self->priv;
+
+  switch (property_id) {
+    case PROP_LOW_LATENCY:
+      GST_OBJECT_LOCK (self);
+      priv->low_latency = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
 static void
 gst_av1_decoder_class_init (GstAV1DecoderClass * klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_CLASS (klass);
 
+  object_class->get_property = gst_av1_decoder_get_property;
+  object_class->set_property = gst_av1_decoder_set_property;
   object_class->finalize = gst_av1_decoder_finalize;
 
   decoder_class->start = GST_DEBUG_FUNCPTR (gst_av1_decoder_start);
@@ -111,6 +158,19 @@ gst_av1_decoder_class_init (GstAV1DecoderClass * klass)
   decoder_class->drain = GST_DEBUG_FUNCPTR (gst_av1_decoder_drain);
   decoder_class->handle_frame =
       GST_DEBUG_FUNCPTR (gst_av1_decoder_handle_frame);
+
+  /**
+   * GstAV1Decoder:low-latency:
+   *
+   * Disable any additional output delay preferred by the subclass, so that
+   * each shown frame is output as soon as it is decoded.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (object_class, PROP_LOW_LATENCY,
+      g_param_spec_boolean ("low-latency", "Low Latency",
+          "Output pictures as soon as the picture order allows it",
+          FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -391,7 +451,7 @@ gst_av1_decoder_process_sequence (GstAV1Decoder * self, GstAV1OBU * obu)
     return ret;
   }
 
-  if (klass->get_preferred_output_delay) {
+  if (klass->get_preferred_output_delay && !priv->low_latency) {
     priv->preferred_output_delay =
         klass->get_preferred_output_delay (self, priv->is_live);
   } else {
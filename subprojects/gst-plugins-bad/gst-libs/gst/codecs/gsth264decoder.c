@@ -97,6 +97,7 @@ struct _GstH264DecoderPrivate
 
   /* used for low-latency vs. high throughput mode decision */
   gboolean is_live;
+  gboolean low_latency;
 
   /* sps/pps of the current slice */
   const GstH264SPS *active_sps;
@@ -151,6 +152,17 @@ struct _GstH264DecoderPrivate
   /* For delayed output */
   GstQueueArray *output_queue;
 
+  /* Output thread, used if subclass enabled asynchronous output.
+   * Protected by output_lock */
+  gboolean async_output;
+  GThread *output_thread;
+  GMutex output_lock;
+  GCond output_cond;
+  GstQueueArray *async_output_queue;
+  gboolean output_busy;
+  gboolean output_thread_stop;
+  GstFlowReturn async_output_ret;
+
   gboolean input_state_changed;
 };
 
@@ -223,6 +235,7 @@ enum
 {
   PROP_0,
   PROP_COMPLIANCE,
+  PROP_LOW_LATENCY,
 };
 
 /**
@@ -272,6 +285,11 @@ gst_h264_decoder_get_property (GObject * object, guint property_id,
       g_value_set_enum (value, priv->compliance);
       GST_OBJECT_UNLOCK (self);
       break;
+    case PROP_LOW_LATENCY:
+      GST_OBJECT_LOCK (self);
+      g_value_set_boolean (value, priv->low_latency);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -291,6 +309,11 @@ gst_h264_decoder_set_property (GObject * object, guint property_id,
       priv->compliance = g_value_get_enum (value);
       GST_OBJECT_UNLOCK (self);
       break;
+    case PROP_LOW_LATENCY:
+      GST_OBJECT_LOCK (self);
+      priv->low_latency = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -332,6 +355,23 @@ gst_h264_decoder_class_init (GstH264DecoderClass * klass)
           "The decoder's behavior in compliance with the h264 spec.",
           GST_TYPE_H264_DECODER_COMPLIANCE, GST_H264_DECODER_COMPLIANCE_AUTO,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_CONSTRUCT));
+
+  /**
+   * GstH264Decoder:low-latency:
+   *
+   * Output each picture as soon as the picture order allows it, as
+   * signalled by the VUI max_num_reorder_frames (or inferred from the
+   * profile), instead of waiting for the DPB to be full. Any additional
+   * output delay preferred by the subclass is disabled as well.
+   * This behaves as if upstream was live, and the "compliance" property
+   * still takes precedence when not set to auto.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (object_class, PROP_LOW_LATENCY,
+      g_param_spec_boolean ("low-latency", "Low Latency",
+          "Output pictures as soon as the picture order allows it",
+          FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -384,6 +424,13 @@ gst_h264_decoder_init (GstH264Decoder * self)
       gst_queue_array_new_for_struct (sizeof (GstH264DecoderOutputFrame), 1);
   gst_queue_array_set_clear_func (priv->output_queue,
       (GDestroyNotify) gst_h264_decoder_clear_output_frame);
+
+  g_mutex_init (&priv->output_lock);
+  g_cond_init (&priv->output_cond);
+  priv->async_output_queue =
+      gst_queue_array_new_for_struct (sizeof (GstH264DecoderOutputFrame), 1);
+  gst_queue_array_set_clear_func (priv->async_output_queue,
+      (GDestroyNotify) gst_h264_decoder_clear_output_frame);
 }
 
 static void
@@ -401,6 +448,9 @@ gst_h264_decoder_finalize (GObject * object)
   g_array_unref (priv->ref_pic_list0);
   g_array_unref (priv->ref_pic_list1);
   gst_queue_array_free (priv->output_queue);
+  gst_queue_array_free (priv->async_output_queue);
+  g_mutex_clear (&priv->output_lock);
+  g_cond_clear (&priv->output_cond);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -421,6 +471,102 @@ gst_h264_decoder_reset (GstH264Decoder * self)
   priv->nal_length_size = 4;
 }
 
+static gpointer
+gst_h264_decoder_output_thread_func (GstH264Decoder * self)
+{
+  GstH264DecoderPrivate *priv = self->priv;
+  GstH264DecoderClass *klass = GST_H264_DECODER_GET_CLASS (self);
+
+  GST_DEBUG_OBJECT (self, "Entering output thread");
+
+  g_mutex_lock (&priv->output_lock);
+  while (TRUE) {
+    GstH264DecoderOutputFrame output_frame;
+    GstFlowReturn flow_ret;
+
+    while (gst_queue_array_is_empty (priv->async_output_queue) &&
+        !priv->output_thread_stop) {
+      g_cond_wait (&priv->output_cond, &priv->output_lock);
+    }
+
+    if (priv->output_thread_stop)
+      break;
+
+    output_frame = *((GstH264DecoderOutputFrame *)
+        gst_queue_array_pop_head_struct (priv->async_output_queue));
+    priv->output_busy = TRUE;
+    g_mutex_unlock (&priv->output_lock);
+
+    /* This may block on the hardware while the streaming thread keeps
+     * parsing and submitting the following pictures */
+    flow_ret = klass->output_picture (self, output_frame.frame,
+        output_frame.picture);
+
+    g_mutex_lock (&priv->output_lock);
+    priv->output_busy = FALSE;
+    UPDATE_FLOW_RETURN (&priv->async_output_ret, flow_ret);
+    g_cond_broadcast (&priv->output_cond);
+  }
+  g_mutex_unlock (&priv->output_lock);
+
+  GST_DEBUG_OBJECT (self, "Leaving output thread");
+
+  return NULL;
+}
+
+#define ASYNC_OUTPUT_PENDING(priv) \
+  (gst_queue_array_get_length ((priv)->async_output_queue) + \
+      ((priv)->output_busy ? 1 : 0))
+
+/* Waits until at most @max_pending pictures are owned by the output thread
+ * and returns the flow return of pictures output since the last call.
+ * Must be called with the stream lock held (once). The lock is released
+ * while waiting, since the output thread needs it to finish frames */
+static GstFlowReturn
+gst_h264_decoder_wait_async_output (GstH264Decoder * self, guint max_pending)
+{
+  GstH264DecoderPrivate *priv = self->priv;
+  GstFlowReturn ret;
+
+  g_mutex_lock (&priv->output_lock);
+  if (ASYNC_OUTPUT_PENDING (priv) > max_pending) {
+    g_mutex_unlock (&priv->output_lock);
+    GST_VIDEO_DECODER_STREAM_UNLOCK (self);
+
+    g_mutex_lock (&priv->output_lock);
+    while (ASYNC_OUTPUT_PENDING (priv) > max_pending)
+      g_cond_wait (&priv->output_cond, &priv->output_lock);
+    g_mutex_unlock (&priv->output_lock);
+
+    GST_VIDEO_DECODER_STREAM_LOCK (self);
+    g_mutex_lock (&priv->output_lock);
+  }
+  ret = priv->async_output_ret;
+  priv->async_output_ret = GST_FLOW_OK;
+  g_mutex_unlock (&priv->output_lock);
+
+  return ret;
+}
+
+static void
+gst_h264_decoder_stop_output_thread (GstH264Decoder * self)
+{
+  GstH264DecoderPrivate *priv = self->priv;
+
+  if (!priv->output_thread)
+    return;
+
+  g_mutex_lock (&priv->output_lock);
+  priv->output_thread_stop = TRUE;
+  g_cond_broadcast (&priv->output_cond);
+  g_mutex_unlock (&priv->output_lock);
+
+  g_thread_join (priv->output_thread);
+  priv->output_thread = NULL;
+
+  gst_queue_array_clear (priv->async_output_queue);
+}
+
 static gboolean
 gst_h264_decoder_start (GstVideoDecoder * decoder)
 {
@@ -432,6 +578,14 @@ gst_h264_decoder_start (GstVideoDecoder * decoder)
   priv->parser = gst_h264_nal_parser_new ();
   priv->dpb = gst_h264_dpb_new ();
 
+  if (priv->async_output) {
+    priv->output_thread_stop = FALSE;
+    priv->output_busy = FALSE;
+    priv->async_output_ret = GST_FLOW_OK;
+    priv->output_thread = g_thread_new ("h264dec-output",
+        (GThreadFunc) gst_h264_decoder_output_thread_func, self);
+  }
+
   return TRUE;
 }
 
@@ -440,6 +594,7 @@ gst_h264_decoder_stop (GstVideoDecoder * decoder)
 {
   GstH264Decoder *self = GST_H264_DECODER (decoder);
 
+  gst_h264_decoder_stop_output_thread (self);
   gst_h264_decoder_reset (self);
 
   return TRUE;
@@ -481,6 +636,14 @@ gst_h264_decoder_clear_dpb (GstH264Decoder * self, gboolean flush)
   }
 
   gst_queue_array_clear (priv->output_queue);
+  if (priv->output_thread) {
+    g_mutex_lock (&priv->output_lock);
+    gst_queue_array_clear (priv->async_output_queue);
+    g_mutex_unlock (&priv->output_lock);
+
+    /* Wait for the picture being output, and discard its flow return */
+    gst_h264_decoder_wait_async_output (self, 0);
+  }
   gst_h264_decoder_clear_ref_pic_lists (self);
   gst_clear_h264_picture (&priv->last_field);
   gst_h264_dpb_clear (priv->dpb);
@@ -512,6 +675,69 @@ gst_h264_decoder_finish (GstVideoDecoder * decoder)
   return gst_h264_decoder_drain (decoder);
 }
 
+/* Whether decoding of @frame can be skipped as the frame would arrive too
+ * late anyway (QoS). Only access units consisting of non-reference slices
+ * are considered, dropping them doesn't affect decoding of other frames */
+static gboolean
+gst_h264_decoder_can_skip_frame (GstH264Decoder * self,
+    GstVideoCodecFrame * frame, const GstMapInfo * map)
+{
+  GstH264DecoderPrivate *priv = self->priv;
+  GstH264NalUnit nalu;
+  GstH264ParserResult pres;
+  gboolean have_slice = FALSE;
+
+  /* Pending first field, let the second one complete it */
+  if (priv->last_field || !priv->active_sps)
+    return FALSE;
+
+  if (gst_video_decoder_get_max_decode_time (GST_VIDEO_DECODER (self),
+          frame) >= 0)
+    return FALSE;
+
+  if (priv->in_format == GST_H264_DECODER_FORMAT_AVC) {
+    pres = gst_h264_parser_identify_nalu_avc (priv->parser,
+        map->data, 0, map->size, priv->nal_length_size, &nalu);
+  } else {
+    pres = gst_h264_parser_identify_nalu (priv->parser,
+        map->data, 0, map->size, &nalu);
+    if (pres == GST_H264_PARSER_NO_NAL_END)
+      pres = GST_H264_PARSER_OK;
+  }
+
+  while (pres == GST_H264_PARSER_OK) {
+    switch (nalu.type) {
+      case GST_H264_NAL_SLICE:
+        if (nalu.ref_idc != 0)
+          return FALSE;
+        have_slice = TRUE;
+        break;
+      case GST_H264_NAL_SEI:
+      case GST_H264_NAL_AU_DELIMITER:
+      case GST_H264_NAL_FILLER_DATA:
+      case GST_H264_NAL_SEQ_END:
+      case GST_H264_NAL_STREAM_END:
+        break;
+      default:
+        /* IDR, parameter sets, data partitions, extensions, ... */
+        return FALSE;
+    }
+
+    if (priv->in_format == GST_H264_DECODER_FORMAT_AVC) {
+      pres = gst_h264_parser_identify_nalu_avc (priv->parser,
+          map->data, nalu.offset + nalu.size, map->size,
+          priv->nal_length_size, &nalu);
+    } else {
+      pres = gst_h264_parser_identify_nalu (priv->parser,
+          map->data, nalu.offset + nalu.size, map->size, &nalu);
+      if (pres == GST_H264_PARSER_NO_NAL_END)
+        pres = GST_H264_PARSER_OK;
+    }
+  }
+
+  return have_slice;
+}
+
 static GstFlowReturn
 gst_h264_decoder_handle_frame (GstVideoDecoder * decoder,
     GstVideoCodecFrame * frame)
@@ -529,9 +755,17 @@ gst_h264_decoder_handle_frame (GstVideoDecoder * decoder,
       GST_TIME_FORMAT, GST_TIME_ARGS (GST_BUFFER_PTS (in_buf)),
       GST_TIME_ARGS (GST_BUFFER_DTS (in_buf)));
 
+  gst_buffer_map (in_buf, &map, GST_MAP_READ);
+
+  if (gst_h264_decoder_can_skip_frame (self, frame, &map)) {
+    GST_DEBUG_OBJECT (self, "Skipping late non-reference frame %u",
+        frame->system_frame_number);
+    gst_buffer_unmap (in_buf, &map);
+    return gst_video_decoder_drop_frame (decoder, frame);
+  }
+
   priv->current_frame = frame;
 
-  gst_buffer_map (in_buf, &map, GST_MAP_READ);
   if (priv->in_format == GST_H264_DECODER_FORMAT_AVC) {
     pres = gst_h264_parser_identify_nalu_avc (priv->parser,
         map.data, 0, map.size, priv->nal_length_size, &nalu);
@@ -1758,8 +1992,31 @@ gst_h264_decoder_drain_output_queue (GstH264Decoder * self, guint num,
   while (gst_queue_array_get_length (priv->output_queue) > num) {
     GstH264DecoderOutputFrame *output_frame = (GstH264DecoderOutputFrame *)
         gst_queue_array_pop_head_struct (priv->output_queue);
-    GstFlowReturn flow_ret = klass->output_picture (self, output_frame->frame,
-        output_frame->picture);
+    GstFlowReturn flow_ret;
+
+    if (priv->output_thread) {
+      GstH264DecoderOutputFrame to_output = *output_frame;
+
+      /* Keep at most one picture queued for the output thread in addition to
+       * the one being output, so that the number of pictures in flight is
+       * bounded by the DPB size we reported to the subclass */
+      flow_ret = gst_h264_decoder_wait_async_output (self, 1);
+
+      g_mutex_lock (&priv->output_lock);
+      gst_queue_array_push_tail_struct (priv->async_output_queue, &to_output);
+      g_cond_signal (&priv->output_cond);
+      g_mutex_unlock (&priv->output_lock);
+    } else {
+      flow_ret = klass->output_picture (self, output_frame->frame,
+          output_frame->picture);
+    }
+
+    UPDATE_FLOW_RETURN (ret, flow_ret);
+  }
+
+  /* Draining, wait for the output thread as well */
+  if (priv->output_thread && num == 0) {
+    GstFlowReturn flow_ret = gst_h264_decoder_wait_async_output (self, 0);
 
     UPDATE_FLOW_RETURN (ret, flow_ret);
   }
@@ -2051,7 +2308,7 @@ get_bump_level (GstH264Decoder * self)
 
   /* GST_H264_DECODER_COMPLIANCE_AUTO case. */
 
-  if (priv->is_live) {
+  if (priv->is_live || priv->low_latency) {
     /* The baseline and constrained-baseline profiles do not have B frames
        and do not use the picture reorder, safe to use the higher bump level. */
     if (priv->profile_idc == GST_H264_PROFILE_BASELINE)
@@ -2163,9 +2420,10 @@ gst_h264_decoder_finish_picture (GstH264Decoder * self,
 
   gst_h264_picture_unref (picture);
 
-  /* For the live mode, we try to bump here to avoid waiting
+  /* For the live and low-latency modes, we try to bump here to avoid waiting
      for another decoding circle. */
-  if (priv->is_live && priv->compliance != GST_H264_DECODER_COMPLIANCE_STRICT)
+  if ((priv->is_live || priv->low_latency) &&
+      priv->compliance != GST_H264_DECODER_COMPLIANCE_STRICT)
     _bump_dpb (self, bump_level, NULL, ret);
 }
 
@@ -2453,15 +2711,16 @@ gst_h264_decoder_process_sps (GstH264Decoder * self, GstH264SPS * sps)
 
     g_assert (klass->new_sequence);
 
-    if (klass->get_preferred_output_delay) {
+    if (klass->get_preferred_output_delay && !priv->low_latency) {
       priv->preferred_output_delay =
           klass->get_preferred_output_delay (self, priv->is_live);
     } else {
       priv->preferred_output_delay = 0;
     }
 
-    ret = klass->new_sequence (self,
-        sps, max_dpb_size + priv->preferred_output_delay);
+    /* One more picture can be held by the output thread */
+    ret = klass->new_sequence (self, sps, max_dpb_size +
+        priv->preferred_output_delay + (priv->async_output ? 1 : 0));
     if (ret != GST_FLOW_OK) {
       GST_WARNING_OBJECT (self, "subclass does not want accept new sequence");
       return ret;
@@ -3277,6 +3536,35 @@ gst_h264_decoder_set_process_ref_pic_lists (GstH264Decoder * decoder,
   decoder->priv->process_ref_pic_lists = process;
 }
 
+/**
+ * gst_h264_decoder_set_async_output:
+ * @decoder: a #GstH264Decoder
+ * @async_output: whether #GstH264DecoderClass.output_picture() should be
+ *   called from a dedicated output thread
+ *
+ * Called by subclasses to pipeline the output of decoded pictures with the
+ * parsing, DPB management and submission of the following ones. When
+ * enabled, #GstH264DecoderClass.output_picture() is called from a dedicated
+ * thread, without the stream lock held, in output order. Subclasses can
+ * then wait for the hardware to complete picture N while the streaming
+ * thread submits picture N + 1 (possibly to another decode engine). The DPB
+ * size passed to #GstH264DecoderClass.new_sequence() is increased by one to
+ * account for the picture held by the output thread.
+ *
+ * This must be called before the element goes to PAUSED, typically from
+ * the instance init function.
+ *
+ * Since: 1.24
+ */
+void
+gst_h264_decoder_set_async_output (GstH264Decoder * decoder,
+    gboolean async_output)
+{
+  g_return_if_fail (GST_IS_H264_DECODER (decoder));
+
+  decoder->priv->async_output = async_output;
+}
+
 /**
  * gst_h264_decoder_get_picture:
  * @decoder: a #GstH264Decoder
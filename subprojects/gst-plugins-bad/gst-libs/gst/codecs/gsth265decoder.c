@@ -67,6 +67,8 @@ struct _GstH265DecoderPrivate
   GstH265DecoderFormat in_format;
   GstH265DecoderAlign align;
   GstH265Parser *parser;
+  /* reused for each SEI */
+  GArray *sei_messages;
   GstH265Dpb *dpb;
 
   /* 0: frame or field-pair interlaced stream
@@ -133,6 +135,7 @@ struct _GstH265DecoderPrivate
   /* For delayed output */
   guint preferred_output_delay;
   gboolean is_live;
+  gboolean low_latency;
   GstQueueArray *output_queue;
 
   gboolean input_state_changed;
@@ -169,6 +172,12 @@ G_DEFINE_ABSTRACT_TYPE_WITH_CODE (GstH265Decoder, gst_h265_decoder,
     GST_DEBUG_CATEGORY_INIT (gst_h265_decoder_debug, "h265decoder", 0,
         "H.265 Video Decoder"));
 
+enum
+{
+  PROP_0,
+  PROP_LOW_LATENCY,
+};
+
 static void gst_h265_decoder_finalize (GObject * object);
 
 static gboolean gst_h265_decoder_start (GstVideoDecoder * decoder);
@@ -193,12 +202,52 @@ static void gst_h265_decoder_clear_nalu (GstH265DecoderNalUnit * nalu);
 static void
 gst_h265_decoder_clear_output_frame (GstH265DecoderOutputFrame * output_frame);
 
+static void
+gst_h265_decoder_get_property (GObject * object, guint property_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstH265Decoder *self = GST_H265_DECODER (object);
+  GstH265DecoderPrivate *priv = self->priv;
+
+  switch (property_id) {
+    case PROP_LOW_LATENCY:
+      GST_OBJECT_LOCK (self);
+      g_value_set_boolean (value, priv->low_latency);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_h265_decoder_set_property (GObject * object, guint property_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstH265Decoder *self = GST_H265_DECODER (object);
+  GstH265DecoderPrivate *priv = self->priv;
+
+  switch (property_id) {
+    case PROP_LOW_LATENCY:
+      GST_OBJECT_LOCK (self);
+      priv->low_latency = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+  }
+}
+
 static void
 gst_h265_decoder_class_init (GstH265DecoderClass * klass)
 {
   GstVideoDecoderClass *decoder_class = GST_VIDEO_DECODER_CLASS (klass);
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
+  object_class->get_property = gst_h265_decoder_get_property;
+  object_class->set_property = gst_h265_decoder_set_property;
   object_class->finalize = GST_DEBUG_FUNCPTR (gst_h265_decoder_finalize);
 
   decoder_class->start = GST_DEBUG_FUNCPTR (gst_h265_decoder_start);
@@ -210,6 +259,20 @@ gst_h265_decoder_class_init (GstH265DecoderClass * klass)
   decoder_class->drain = GST_DEBUG_FUNCPTR (gst_h265_decoder_drain);
   decoder_class->handle_frame =
       GST_DEBUG_FUNCPTR (gst_h265_decoder_handle_frame);
+
+  /**
+   * GstH265Decoder:low-latency:
+   *
+   * Disable any additional output delay preferred by the subclass, so that
+   * pictures are output as soon as sps_max_num_reorder_pics and
+   * sps_max_latency_increase_plus1 allow it.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (object_class, PROP_LOW_LATENCY,
+      g_param_spec_boolean ("low-latency", "Low Latency",
+          "Output pictures as soon as the picture order allows it",
+          FALSE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -263,6 +326,7 @@ gst_h265_decoder_start (GstVideoDecoder * decoder)
   GstH265DecoderPrivate *priv = self->priv;
 
   priv->parser = gst_h265_parser_new ();
+  priv->sei_messages = g_array_new (FALSE, FALSE, sizeof (GstH265SEIMessage));
   priv->dpb = gst_h265_dpb_new ();
   priv->new_bitstream = TRUE;
   priv->prev_nal_is_eos = FALSE;
@@ -286,6 +350,8 @@ gst_h265_decoder_stop (GstVideoDecoder * decoder)
     priv->parser = NULL;
   }
 
+  g_clear_pointer (&priv->sei_messages, g_array_unref);
+
   if (priv->dpb) {
     gst_h265_dpb_free (priv->dpb);
     priv->dpb = NULL;
@@ -483,7 +549,7 @@ gst_h265_decoder_process_sps (GstH265Decoder * self, GstH265SPS * sps)
     if (ret != GST_FLOW_OK)
       return ret;
 
-    if (klass->get_preferred_output_delay) {
+    if (klass->get_preferred_output_delay && !priv->low_latency) {
       priv->preferred_output_delay =
           klass->get_preferred_output_delay (self, priv->is_live);
     } else {
@@ -531,16 +597,16 @@ gst_h265_decoder_parse_sei (GstH265Decoder * self, GstH265NalUnit * nalu)
 {
   GstH265DecoderPrivate *priv = self->priv;
   GstH265ParserResult pres;
-  GArray *messages = NULL;
+  GArray *messages = priv->sei_messages;
   guint i;
 
-  pres = gst_h265_parser_parse_sei (priv->parser, nalu, &messages);
+  pres = gst_h265_parser_parse_sei_into (priv->parser, nalu, messages);
   if (pres != GST_H265_PARSER_OK) {
     GST_WARNING_OBJECT (self, "Failed to parse SEI, result %d", pres);
 
     /* XXX: Ignore error from SEI parsing, it might be malformed bitstream,
      * or our fault. But shouldn't be critical  */
-    g_clear_pointer (&messages, g_array_unref);
+    g_array_set_size (messages, 0);
     return GST_H265_PARSER_OK;
   }
 
@@ -563,7 +629,7 @@ gst_h265_decoder_parse_sei (GstH265Decoder * self, GstH265NalUnit * nalu)
     }
   }
 
-  g_array_free (messages, TRUE);
+  g_array_set_size (messages, 0);
   GST_LOG_OBJECT (self, "SEI parsed");
 
   return GST_H265_PARSER_OK;
@@ -110,6 +110,22 @@ CUresult CUDAAPI CuStreamDestroy    (CUstream hStream);
 GST_CUDA_API
 CUresult CUDAAPI CuStreamSynchronize (CUstream hStream);
 
+GST_CUDA_API
+CUresult CUDAAPI CuStreamWaitEvent  (CUstream hStream,
+                                     CUevent hEvent,
+                                     unsigned int Flags);
+
+GST_CUDA_API
+CUresult CUDAAPI CuEventCreate      (CUevent *phEvent,
+                                     unsigned int Flags);
+
+GST_CUDA_API
+CUresult CUDAAPI CuEventDestroy     (CUevent hEvent);
+
+GST_CUDA_API
+CUresult CUDAAPI CuEventRecord      (CUevent hEvent,
+                                     CUstream hStream);
+
 GST_CUDA_API
 CUresult CUDAAPI CuDeviceGet        (CUdevice * device,
                                      int ordinal);
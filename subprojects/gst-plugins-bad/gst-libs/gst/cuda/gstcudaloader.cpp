@@ -91,6 +91,12 @@ typedef struct _GstNvCodecCudaVTable
       unsigned int Flags);
   CUresult (CUDAAPI * CuStreamDestroy) (CUstream hStream);
   CUresult (CUDAAPI * CuStreamSynchronize) (CUstream hStream);
+  CUresult (CUDAAPI * CuStreamWaitEvent) (CUstream hStream, CUevent hEvent,
+      unsigned int Flags);
+
+  CUresult (CUDAAPI * CuEventCreate) (CUevent * phEvent, unsigned int Flags);
+  CUresult (CUDAAPI * CuEventDestroy) (CUevent hEvent);
+  CUresult (CUDAAPI * CuEventRecord) (CUevent hEvent, CUstream hStream);
 
   CUresult (CUDAAPI * CuDeviceGet) (CUdevice * device, int ordinal);
   CUresult (CUDAAPI * CuDeviceGetCount) (int *count);
@@ -186,6 +192,11 @@ gst_cuda_load_library_once_func (void)
   LOAD_SYMBOL (cuStreamCreate, CuStreamCreate);
   LOAD_SYMBOL (cuStreamDestroy, CuStreamDestroy);
   LOAD_SYMBOL (cuStreamSynchronize, CuStreamSynchronize);
+  LOAD_SYMBOL (cuStreamWaitEvent, CuStreamWaitEvent);
+
+  LOAD_SYMBOL (cuEventCreate, CuEventCreate);
+  LOAD_SYMBOL (cuEventDestroy, CuEventDestroy);
+  LOAD_SYMBOL (cuEventRecord, CuEventRecord);
 
   LOAD_SYMBOL (cuDeviceGet, CuDeviceGet);
   LOAD_SYMBOL (cuDeviceGetCount, CuDeviceGetCount);
@@ -449,6 +460,38 @@ CuStreamSynchronize (CUstream hStream)
   return gst_cuda_vtable.CuStreamSynchronize (hStream);
 }
 
+CUresult CUDAAPI
+CuStreamWaitEvent (CUstream hStream, CUevent hEvent, unsigned int Flags)
+{
+  g_assert (gst_cuda_vtable.CuStreamWaitEvent != nullptr);
+
+  return gst_cuda_vtable.CuStreamWaitEvent (hStream, hEvent, Flags);
+}
+
+CUresult CUDAAPI
+CuEventCreate (CUevent * phEvent, unsigned int Flags)
+{
+  g_assert (gst_cuda_vtable.CuEventCreate != nullptr);
+
+  return gst_cuda_vtable.CuEventCreate (phEvent, Flags);
+}
+
+CUresult CUDAAPI
+CuEventDestroy (CUevent hEvent)
+{
+  g_assert (gst_cuda_vtable.CuEventDestroy != nullptr);
+
+  return gst_cuda_vtable.CuEventDestroy (hEvent);
+}
+
+CUresult CUDAAPI
+CuEventRecord (CUevent hEvent, CUstream hStream)
+{
+  g_assert (gst_cuda_vtable.CuEventRecord != nullptr);
+
+  return gst_cuda_vtable.CuEventRecord (hEvent, hStream);
+}
+
 CUresult CUDAAPI
 CuDeviceGet (CUdevice * device, int ordinal)
 {
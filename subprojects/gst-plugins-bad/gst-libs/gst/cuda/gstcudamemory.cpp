@@ -71,6 +71,10 @@ struct _GstCudaMemoryPrivate
 
   GstCudaStream *stream = nullptr;
 
+  /* Used by gst_cuda_memory_sync_stream() to order other streams after the
+   * pending operations of our stream */
+  CUevent event = nullptr;
+
   gint texture_align = 0;
 
   /* Per plane, and point/linear sampling textures respectively  */
@@ -282,6 +286,9 @@ gst_cuda_allocator_free (GstAllocator * allocator, GstMemory * memory)
     CuStreamSynchronize (gst_cuda_stream_get_handle (priv->stream));
   }
 
+  if (priv->event)
+    CuEventDestroy (priv->event);
+
   priv->token_map.clear ();
 
   for (guint i = 0; i < GST_VIDEO_MAX_PLANES; i++) {
@@ -634,6 +641,67 @@ gst_cuda_memory_sync (GstCudaMemory * mem)
   }
 }
 
+/**
+ * gst_cuda_memory_sync_stream:
+ * @mem: A #GstCudaMemory
+ * @stream: (allow-none): the #GstCudaStream about to access @mem
+ *
+ * Makes the device operations later queued on @stream wait for the pending
+ * operations on @mem, without blocking the calling thread. This is a no-op
+ * when @mem uses @stream or has no pending operations. If @stream is %NULL
+ * (the default CUDA stream), this is equivalent to gst_cuda_memory_sync().
+ *
+ * @stream must belong to the #GstCudaContext of @mem. Mapping @mem to
+ * system memory still waits as needed.
+ *
+ * Since: 1.24
+ */
+void
+gst_cuda_memory_sync_stream (GstCudaMemory * mem, GstCudaStream * stream)
+{
+  GstCudaMemoryPrivate *priv;
+  CUstream handle;
+  gboolean waited = FALSE;
+
+  g_return_if_fail (gst_is_cuda_memory ((GstMemory *) mem));
+
+  priv = mem->priv;
+  if (!priv->stream || priv->stream == stream)
+    return;
+
+  if (!stream) {
+    gst_cuda_memory_sync (mem);
+    return;
+  }
+
+  std::lock_guard < std::mutex > lk (priv->lock);
+  if (!GST_MEMORY_FLAG_IS_SET (mem, GST_CUDA_MEMORY_TRANSFER_NEED_SYNC))
+    return;
+
+  if (!gst_cuda_context_push (mem->context))
+    return;
+
+  handle = gst_cuda_stream_get_handle (priv->stream);
+  if (!priv->event &&
+      !gst_cuda_result (CuEventCreate (&priv->event,
+              CU_EVENT_DISABLE_TIMING))) {
+    priv->event = nullptr;
+  }
+
+  if (priv->event && gst_cuda_result (CuEventRecord (priv->event, handle))) {
+    waited = gst_cuda_result (CuStreamWaitEvent (gst_cuda_stream_get_handle
+            (stream), priv->event, 0));
+  }
+
+  /* The flag stays set, a CPU access needs to wait still */
+  if (!waited) {
+    GST_MEMORY_FLAG_UNSET (mem, GST_CUDA_MEMORY_TRANSFER_NEED_SYNC);
+    CuStreamSynchronize (handle);
+  }
+
+  gst_cuda_context_pop (nullptr);
+}
+
 typedef struct _TextureFormat
 {
   GstVideoFormat format;
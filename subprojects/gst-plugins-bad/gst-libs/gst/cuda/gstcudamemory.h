@@ -165,6 +165,10 @@ GstCudaStream * gst_cuda_memory_get_stream  (GstCudaMemory * mem);
 GST_CUDA_API
 void            gst_cuda_memory_sync        (GstCudaMemory * mem);
 
+GST_CUDA_API
+void            gst_cuda_memory_sync_stream (GstCudaMemory * mem,
+                                             GstCudaStream * stream);
+
 GST_CUDA_API
 gboolean        gst_cuda_memory_get_texture (GstCudaMemory * mem,
                                              guint plane,
@@ -23,8 +23,10 @@
 
 #include "gstcudautils.h"
 #include "gstcudacontext.h"
+#include "gstcudaloader.h"
 #include "gstcuda-private.h"
 #include <atomic>
+#include <map>
 
 #ifdef HAVE_CUDA_GST_GL
 #include <gst/gl/gl.h>
@@ -173,6 +175,157 @@ context_set_cuda_context (GstContext * context, GstCudaContext * cuda_ctx)
       cuda_ctx, "cuda-device-id", G_TYPE_UINT, device_id, nullptr);
 }
 
+/* Contexts created by gst_cuda_ensure_element_context(), per device, so that
+ * elements in different pipelines can share them when GST_CUDA_SHARE_CONTEXT
+ * is set. Protected by the gst_cuda_ensure_element_context() lock */
+/* *INDENT-OFF* */
+static std::map <guint, GWeakRef *> shared_contexts;
+/* *INDENT-ON* */
+
+static gboolean
+share_context_enabled (void)
+{
+  static gboolean enabled = FALSE;
+
+  GST_CUDA_CALL_ONCE_BEGIN {
+    const gchar *env = g_getenv ("GST_CUDA_SHARE_CONTEXT");
+
+    enabled = env && g_strcmp0 (env, "0") != 0;
+  } GST_CUDA_CALL_ONCE_END;
+
+  return enabled;
+}
+
+static GstCudaContext *
+get_shared_context (guint device_id)
+{
+  GstCudaContext *context;
+  GWeakRef *ref;
+
+  if (shared_contexts.find (device_id) == shared_contexts.end ()) {
+    ref = g_new0 (GWeakRef, 1);
+    g_weak_ref_init (ref, nullptr);
+    shared_contexts[device_id] = ref;
+  } else {
+    ref = shared_contexts[device_id];
+  }
+
+  context = (GstCudaContext *) g_weak_ref_get (ref);
+  if (context)
+    return context;
+
+  context = gst_cuda_context_new (device_id);
+  if (context)
+    g_weak_ref_set (ref, context);
+
+  return context;
+}
+
+/* Number of elements that got a context for each device from
+ * gst_cuda_ensure_element_context(). An element is accounted to the device of
+ * its last context until it requests another one, drops it with
+ * gst_cuda_clear_element_context() or is destroyed */
+/* *INDENT-OFF* */
+static std::mutex device_load_lock;
+static std::map <guint, guint> device_load;
+/* *INDENT-ON* */
+
+static GQuark
+device_load_quark (void)
+{
+  static GQuark quark = 0;
+
+  GST_CUDA_CALL_ONCE_BEGIN {
+    quark = g_quark_from_static_string ("gst-cuda-device-load");
+  } GST_CUDA_CALL_ONCE_END;
+
+  return quark;
+}
+
+static void
+device_load_release (gpointer data)
+{
+  guint device_id = GPOINTER_TO_UINT (data) - 1;
+  std::lock_guard < std::mutex > lk (device_load_lock);
+
+  if (device_load[device_id] > 0)
+    device_load[device_id]--;
+}
+
+static void
+device_load_track (GstElement * element, GstCudaContext * cuda_ctx)
+{
+  guint device_id;
+
+  g_object_get (cuda_ctx, "cuda-device-id", &device_id, nullptr);
+
+  {
+    std::lock_guard < std::mutex > lk (device_load_lock);
+    device_load[device_id]++;
+  }
+
+  /* releases the device the element was accounted to before, if any */
+  g_object_set_qdata_full (G_OBJECT (element), device_load_quark (),
+      GUINT_TO_POINTER (device_id + 1), device_load_release);
+}
+
+static gboolean
+auto_device_enabled (void)
+{
+  static gboolean enabled = FALSE;
+
+  GST_CUDA_CALL_ONCE_BEGIN {
+    const gchar *env = g_getenv ("GST_CUDA_AUTO_DEVICE");
+
+    enabled = env && g_strcmp0 (env, "0") != 0;
+  } GST_CUDA_CALL_ONCE_END;
+
+  return enabled;
+}
+
+/**
+ * gst_cuda_get_least_loaded_device:
+ *
+ * Finds the CUDA device which the fewest elements in this process currently
+ * use, as accounted by gst_cuda_ensure_element_context(). Applications can
+ * use this to spread new pipelines over the available devices, for example
+ * by selecting the cuda-device-id or the per device element of a decoder.
+ *
+ * Returns: the device id of the least loaded device, or -1 if no CUDA device
+ * is available
+ *
+ * Since: 1.24
+ */
+gint
+gst_cuda_get_least_loaded_device (void)
+{
+  gint dev_count = 0;
+  gint i, device_id = -1;
+  guint min_load = G_MAXUINT;
+
+  _init_debug ();
+
+  if (!gst_cuda_load_library () || !gst_cuda_result (CuInit (0)) ||
+      !gst_cuda_result (CuDeviceGetCount (&dev_count)))
+    return -1;
+
+  std::lock_guard < std::mutex > lk (device_load_lock);
+  for (i = 0; i < dev_count; i++) {
+    guint load = 0;
+
+    if (device_load.find (i) != device_load.end ())
+      load = device_load[i];
+
+    GST_LOG ("Device %d is used by %u elements", i, load);
+    if (load < min_load) {
+      min_load = load;
+      device_id = i;
+    }
+  }
+
+  return device_id;
+}
+
 /**
  * gst_cuda_ensure_element_context:
  * @element: the #GstElement running the query
@@ -186,6 +339,18 @@ context_set_cuda_context (GstContext * context, GstCudaContext * cuda_ctx)
  * If the content of @cuda_ctx is not %NULL, then no #GstContext query is
  * necessary for #GstCudaContext.
  *
+ * If no #GstCudaContext is found and the `GST_CUDA_SHARE_CONTEXT` environment
+ * variable is set, an existing #GstCudaContext created for the same device by
+ * this function is reused, even from another pipeline, instead of a new one.
+ * This avoids the memory and context switch overhead of one CUDA context per
+ * element when running many pipelines in the same process (Since: 1.24).
+ *
+ * If a new #GstCudaContext is needed, @device_id is -1 and the
+ * `GST_CUDA_AUTO_DEVICE` environment variable is set, the context is created
+ * for the device returned by gst_cuda_get_least_loaded_device() instead of
+ * the first device, so that new pipelines are spread over the available
+ * devices (Since: 1.24).
+ *
  * Returns: whether a #GstCudaContext exists in @cuda_ctx
  *
  * Since: 1.22
@@ -206,17 +371,29 @@ gst_cuda_ensure_element_context (GstElement * element, gint device_id,
   std::lock_guard < std::recursive_mutex > lk (lock);
 
   if (*cuda_ctx)
-    return TRUE;
+    goto done;
 
   find_cuda_context (element, cuda_ctx);
   if (*cuda_ctx)
-    return TRUE;
+    goto done;
 
-  if (device_id > 0)
+  if (device_id > 0) {
     target_device_id = device_id;
+  } else if (device_id < 0 && auto_device_enabled ()) {
+    gint least_loaded = gst_cuda_get_least_loaded_device ();
+
+    if (least_loaded >= 0)
+      target_device_id = least_loaded;
+    GST_CAT_INFO_OBJECT (GST_CAT_CONTEXT, element,
+        "Selected device %u for new context", target_device_id);
+  }
 
-  /* No available CUDA context in pipeline, create new one here */
-  *cuda_ctx = gst_cuda_context_new (target_device_id);
+  /* No available CUDA context in pipeline, create new one here or reuse
+   * the one we made for another pipeline */
+  if (share_context_enabled ())
+    *cuda_ctx = get_shared_context (target_device_id);
+  else
+    *cuda_ctx = gst_cuda_context_new (target_device_id);
 
   if (*cuda_ctx == nullptr) {
     GST_CAT_ERROR_OBJECT (GST_CAT_CONTEXT, element,
@@ -240,9 +417,38 @@ gst_cuda_ensure_element_context (GstElement * element, gint device_id,
     gst_element_post_message (GST_ELEMENT_CAST (element), msg);
   }
 
+done:
+  if (*cuda_ctx)
+    device_load_track (element, *cuda_ctx);
+
   return ret;
 }
 
+/**
+ * gst_cuda_clear_element_context:
+ * @element: the #GstElement owning @cuda_ctx
+ * @cuda_ctx: (inout) (transfer full): location of a #GstCudaContext
+ *
+ * Clears the #GstCudaContext in @cuda_ctx, if any, and stops accounting
+ * @element to its device in gst_cuda_get_least_loaded_device(). Elements
+ * should use this instead of gst_clear_object() when dropping the context
+ * they got from gst_cuda_ensure_element_context(), usually when they stop
+ * or go to %GST_STATE_NULL, so that idle elements don't count as load.
+ *
+ * Since: 1.24
+ */
+void
+gst_cuda_clear_element_context (GstElement * element,
+    GstCudaContext ** cuda_ctx)
+{
+  g_return_if_fail (element != nullptr);
+  g_return_if_fail (cuda_ctx != nullptr);
+
+  /* the destroy notify releases the device the element was accounted to */
+  g_object_set_qdata (G_OBJECT (element), device_load_quark (), nullptr);
+  gst_clear_object (cuda_ctx);
+}
+
 /**
  * gst_cuda_handle_set_context:
  * @element: a #GstElement
@@ -127,6 +127,13 @@ gboolean        gst_cuda_ensure_element_context (GstElement * element,
                                                  gint device_id,
                                                  GstCudaContext ** cuda_ctx);
 
+GST_CUDA_API
+void            gst_cuda_clear_element_context  (GstElement * element,
+                                                 GstCudaContext ** cuda_ctx);
+
+GST_CUDA_API
+gint            gst_cuda_get_least_loaded_device (void);
+
 GST_CUDA_API
 gboolean        gst_cuda_handle_set_context     (GstElement * element,
                                                  GstContext * context,
@@ -26,6 +26,7 @@ G_BEGIN_DECLS
 typedef gpointer CUcontext;
 typedef gpointer CUgraphicsResource;
 typedef gpointer CUstream;
+typedef gpointer CUevent;
 typedef gpointer CUarray;
 typedef gpointer CUmodule;
 typedef gpointer CUfunction;
@@ -77,6 +78,13 @@ typedef enum
   CU_STREAM_NON_BLOCKING = 0x1
 } CUstream_flags;
 
+typedef enum
+{
+  CU_EVENT_DEFAULT = 0x0,
+  CU_EVENT_BLOCKING_SYNC = 0x1,
+  CU_EVENT_DISABLE_TIMING = 0x2,
+} CUevent_flags;
+
 typedef enum
 {
   CU_TR_FILTER_MODE_POINT = 0,
@@ -204,6 +212,7 @@ typedef struct
 #define cuCtxDestroy cuCtxDestroy_v2
 #define cuCtxPopCurrent cuCtxPopCurrent_v2
 #define cuCtxPushCurrent cuCtxPushCurrent_v2
+#define cuEventDestroy cuEventDestroy_v2
 #define cuGraphicsResourceGetMappedPointer cuGraphicsResourceGetMappedPointer_v2
 #define cuGraphicsResourceSetMapFlags cuGraphicsResourceSetMapFlags_v2
 
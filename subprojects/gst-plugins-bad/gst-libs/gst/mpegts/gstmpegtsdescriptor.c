@@ -715,7 +715,10 @@ _copy_descriptor (GstMpegtsDescriptor * desc)
 void
 gst_mpegts_descriptor_free (GstMpegtsDescriptor * desc)
 {
-  g_free ((gpointer) desc->data);
+  /* descriptors from gst_mpegts_parse_descriptors() carry their data in
+   * the same allocation */
+  if (desc->data != (const guint8 *) (desc + 1))
+    g_free ((gpointer) desc->data);
   g_free (desc);
 }
 
@@ -783,13 +786,15 @@ gst_mpegts_parse_descriptors (guint8 * buffer, gsize buf_len)
   data = buffer;
 
   for (i = 0; i < nb_desc; i++) {
-    GstMpegtsDescriptor *desc = g_new0 (GstMpegtsDescriptor, 1);
+    GstMpegtsDescriptor *desc;
 
-    desc->data = data;
+    /* Sections with many descriptors (EIT) are common, so allocate each
+     * descriptor and a copy of its data in one go */
+    length = data[1];
+    desc = g_malloc0 (sizeof (GstMpegtsDescriptor) + length + 2);
+    desc->data = memcpy (desc + 1, data, length + 2);
     desc->tag = *data++;
     desc->length = *data++;
-    /* Copy the data now that we known the size */
-    desc->data = g_memdup2 (desc->data, desc->length + 2);
     GST_LOG ("descriptor 0x%02x length:%d", desc->tag, desc->length);
     GST_MEMDUMP ("descriptor", desc->data + 2, desc->length);
     /* extended descriptors */
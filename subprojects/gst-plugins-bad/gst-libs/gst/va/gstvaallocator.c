@@ -661,6 +661,8 @@ gst_va_dmabuf_allocator_setup_buffer_full (GstAllocator * allocator,
     *drm_mod = desc.objects[i].drm_format_modifier;
     gst_mini_object_set_qdata (GST_MINI_OBJECT (mem), gst_va_drm_mod_quark (),
         drm_mod, g_free);
+    /* also expose it to generic dmabuf importers */
+    gst_dmabuf_memory_set_drm_modifier (mem, *drm_mod);
 
     if (G_UNLIKELY (info))
       GST_VIDEO_INFO_PLANE_OFFSET (info, i) = GST_VIDEO_INFO_SIZE (info);
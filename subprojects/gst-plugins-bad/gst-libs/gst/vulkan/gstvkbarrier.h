@@ -72,8 +72,26 @@ struct _GstVulkanBarrierMemoryInfo
   VkPipelineStageFlags pipeline_stages;
   VkAccessFlags access_flags;
 
+  /**
+   * GstVulkanBarrierMemoryInfo.semaphore:
+   *
+   * timeline semaphore signalled by the last submission writing to the
+   * memory, or %VK_NULL_HANDLE if the device has no timeline semaphores
+   *
+   * Since: 1.24
+   */
+  VkSemaphore semaphore;
+  /**
+   * GstVulkanBarrierMemoryInfo.semaphore_value:
+   *
+   * value @semaphore reaches once the last write to the memory has completed
+   *
+   * Since: 1.24
+   */
+  guint64 semaphore_value;
+
   /* <private> */
-  gpointer _reserved        [GST_PADDING];
+  gpointer _reserved        [GST_PADDING - 2];
 };
 
 G_END_DECLS
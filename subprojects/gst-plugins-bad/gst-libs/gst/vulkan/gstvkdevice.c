@@ -23,6 +23,8 @@
 #endif
 
 #include "gstvkdevice.h"
+#include "gstvkdevice-private.h"
+#include "gstvkphysicaldevice-private.h"
 #include "gstvkdebug.h"
 
 #include <string.h>
@@ -60,6 +62,7 @@ struct _GstVulkanDevicePrivate
   gboolean opened;
   guint queue_family_id;
   guint n_queues;
+  gboolean timeline_semaphore;
 
   GstVulkanFenceCache *fence_cache;
 };
@@ -309,6 +312,9 @@ gst_vulkan_device_open (GstVulkanDevice * device, GError ** error)
     VkDeviceQueueCreateInfo queue_info = { 0, };
     VkDeviceCreateInfo device_info = { 0, };
     gfloat queue_priority = 0.5;
+#if defined (VK_API_VERSION_1_2)
+    VkPhysicalDeviceVulkan12Features features12 = { 0, };
+#endif
 
     queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
     queue_info.pNext = NULL;
@@ -328,10 +334,25 @@ gst_vulkan_device_open (GstVulkanDevice * device, GError ** error)
         (const char *const *) priv->enabled_extensions->pdata;
     device_info.pEnabledFeatures = NULL;
 
+#if defined (VK_API_VERSION_1_2)
+    /* timeline semaphores let GPU work on different queues be ordered
+     * without waiting on the CPU */
+    if (gst_vulkan_physical_device_has_feature_timeline_semaphore
+        (device->physical_device)) {
+      features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+      features12.timelineSemaphore = VK_TRUE;
+      device_info.pNext = &features12;
+    }
+#endif
+
     err = vkCreateDevice (gpu, &device_info, NULL, &device->device);
     if (gst_vulkan_error_to_g_error (err, error, "vkCreateDevice") < 0) {
       goto error;
     }
+
+#if defined (VK_API_VERSION_1_2)
+    priv->timeline_semaphore = features12.timelineSemaphore;
+#endif
   }
 
   priv->fence_cache = gst_vulkan_fence_cache_new (device);
@@ -871,3 +892,11 @@ gst_vulkan_device_enable_layer (GstVulkanDevice * device, const gchar * name)
 
   return ret;
 }
+
+gboolean
+gst_vulkan_device_has_timeline_semaphore (GstVulkanDevice * device)
+{
+  GstVulkanDevicePrivate *priv = GET_PRIV (device);
+
+  return priv->timeline_semaphore;
+}
@@ -1612,27 +1612,82 @@ gboolean
 gst_vulkan_full_screen_quad_submit (GstVulkanFullScreenQuad * self,
     GstVulkanCommandBuffer * cmd, GstVulkanFence * fence, GError ** error)
 {
+  GstVulkanFullScreenQuadPrivate *priv;
+  VkSemaphore wait_semaphores[GST_VIDEO_MAX_PLANES];
+  guint64 wait_values[GST_VIDEO_MAX_PLANES];
+  VkPipelineStageFlags wait_stages[GST_VIDEO_MAX_PLANES];
+  VkSemaphore signal_semaphores[GST_VIDEO_MAX_PLANES];
+  guint64 signal_values[GST_VIDEO_MAX_PLANES];
+  GstVulkanImageMemory *signal_mems[GST_VIDEO_MAX_PLANES];
+  guint n_wait = 0, n_signal = 0;
   VkResult err;
+  guint i;
 
   g_return_val_if_fail (GST_IS_VULKAN_FULL_SCREEN_QUAD (self), FALSE);
   g_return_val_if_fail (cmd != NULL, FALSE);
   g_return_val_if_fail (fence != NULL, FALSE);
 
+  priv = GET_PRIV (self);
+
+  /* Order against previous GPU writes to the input and let the next user of
+   * the output wait for this submission using the timeline semaphores */
+  for (i = 0; priv->inbuf && i < GST_VIDEO_INFO_N_PLANES (&self->in_info);
+      i++) {
+    GstVulkanImageMemory *img_mem = peek_image_from_buffer (priv->inbuf, i);
+
+    if (!img_mem || !img_mem->barrier.parent.semaphore)
+      continue;
+
+    wait_semaphores[n_wait] = img_mem->barrier.parent.semaphore;
+    wait_values[n_wait] = img_mem->barrier.parent.semaphore_value;
+    wait_stages[n_wait] = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    n_wait++;
+  }
+  for (i = 0; priv->outbuf && i < GST_VIDEO_INFO_N_PLANES (&self->out_info);
+      i++) {
+    GstVulkanImageMemory *img_mem = peek_image_from_buffer (priv->outbuf, i);
+
+    if (!img_mem || !img_mem->barrier.parent.semaphore)
+      continue;
+
+    signal_mems[n_signal] = img_mem;
+    signal_semaphores[n_signal] = img_mem->barrier.parent.semaphore;
+    signal_values[n_signal] = img_mem->barrier.parent.semaphore_value + 1;
+    n_signal++;
+  }
+
   {
+#if defined (VK_API_VERSION_1_2)
+    /* *INDENT-OFF* */
+    VkTimelineSemaphoreSubmitInfo timeline_info = {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .pNext = NULL,
+        .waitSemaphoreValueCount = n_wait,
+        .pWaitSemaphoreValues = wait_values,
+        .signalSemaphoreValueCount = n_signal,
+        .pSignalSemaphoreValues = signal_values,
+    };
+    /* *INDENT-ON* */
+#endif
     /* *INDENT-OFF* */
     VkSubmitInfo submit_info = {
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
         .pNext = NULL,
-        .waitSemaphoreCount = 0,
-        .pWaitSemaphores = NULL,
-        .pWaitDstStageMask = NULL,
+        .waitSemaphoreCount = n_wait,
+        .pWaitSemaphores = wait_semaphores,
+        .pWaitDstStageMask = wait_stages,
         .commandBufferCount = 1,
         .pCommandBuffers = &cmd->cmd,
-        .signalSemaphoreCount = 0,
-        .pSignalSemaphores = NULL,
+        .signalSemaphoreCount = n_signal,
+        .pSignalSemaphores = signal_semaphores,
     };
     /* *INDENT-ON* */
 
+#if defined (VK_API_VERSION_1_2)
+    if (n_wait > 0 || n_signal > 0)
+      submit_info.pNext = &timeline_info;
+#endif
+
     gst_vulkan_queue_submit_lock (self->queue);
     err =
         vkQueueSubmit (self->queue->queue, 1, &submit_info,
@@ -1642,6 +1697,9 @@ gst_vulkan_full_screen_quad_submit (GstVulkanFullScreenQuad * self,
       goto error;
   }
 
+  for (i = 0; i < n_signal; i++)
+    signal_mems[i]->barrier.parent.semaphore_value = signal_values[i];
+
   gst_vulkan_trash_list_add (self->trash_list,
       gst_vulkan_trash_list_acquire (self->trash_list, fence,
           gst_vulkan_trash_mini_object_unref, GST_MINI_OBJECT_CAST (cmd)));
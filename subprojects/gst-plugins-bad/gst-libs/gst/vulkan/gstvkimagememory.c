@@ -23,6 +23,7 @@
 #endif
 
 #include "gstvkimagememory.h"
+#include "gstvkdevice-private.h"
 
 /**
  * SECTION:vkimagememory
@@ -198,6 +199,35 @@ gst_vulkan_image_memory_init (GstVulkanImageMemory * mem,
   mem->views = g_ptr_array_new ();
   mem->outstanding_views = g_ptr_array_new ();
 
+#if defined (VK_API_VERSION_1_2)
+  if (gst_vulkan_device_has_timeline_semaphore (device)) {
+    VkResult err;
+    /* *INDENT-OFF* */
+    VkSemaphoreTypeCreateInfo semaphore_type_info = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .pNext = NULL,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0,
+    };
+    VkSemaphoreCreateInfo semaphore_info = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &semaphore_type_info,
+        .flags = 0,
+    };
+    /* *INDENT-ON* */
+
+    err = vkCreateSemaphore (device->device, &semaphore_info, NULL,
+        &mem->barrier.parent.semaphore);
+    if (err != VK_SUCCESS) {
+      GST_CAT_WARNING (GST_CAT_VULKAN_IMAGE_MEMORY,
+          "Failed to create timeline semaphore: %s",
+          gst_vulkan_result_to_string (err));
+      mem->barrier.parent.semaphore = VK_NULL_HANDLE;
+    }
+    mem->barrier.parent.semaphore_value = 0;
+  }
+#endif
+
   GST_CAT_DEBUG (GST_CAT_VULKAN_IMAGE_MEMORY,
       "new Vulkan Image memory:%p size:%" G_GSIZE_FORMAT, mem, maxsize);
 
@@ -423,6 +453,10 @@ _vk_image_mem_free (GstAllocator * allocator, GstMemory * memory)
   if (mem->image && !mem->wrapped)
     vkDestroyImage (mem->device->device, mem->image, NULL);
 
+  if (mem->barrier.parent.semaphore)
+    vkDestroySemaphore (mem->device->device, mem->barrier.parent.semaphore,
+        NULL);
+
   if (mem->vk_mem)
     gst_memory_unref ((GstMemory *) mem->vk_mem);
 
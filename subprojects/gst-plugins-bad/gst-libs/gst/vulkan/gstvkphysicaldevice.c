@@ -23,6 +23,7 @@
 #endif
 
 #include "gstvkphysicaldevice.h"
+#include "gstvkphysicaldevice-private.h"
 
 #include "gstvkdebug.h"
 
@@ -1190,3 +1191,20 @@ gst_vulkan_physical_device_get_extension_info (GstVulkanPhysicalDevice * device,
 
   return ret;
 }
+
+gboolean
+gst_vulkan_physical_device_has_feature_timeline_semaphore (GstVulkanPhysicalDevice
+    * device)
+{
+#if defined (VK_API_VERSION_1_2)
+  GstVulkanPhysicalDevicePrivate *priv = GET_PRIV (device);
+
+  /* the features are only queried with a Vulkan 1.2 instance */
+  if (device->properties.apiVersion < VK_MAKE_VERSION (1, 2, 0))
+    return FALSE;
+
+  return priv->features12.timelineSemaphore;
+#else
+  return FALSE;
+#endif
+}
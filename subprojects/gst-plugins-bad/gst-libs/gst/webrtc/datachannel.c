@@ -40,11 +40,23 @@
 #define GST_CAT_DEFAULT gst_webrtc_data_channel_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
+typedef struct
+{
+  GstWebRTCDataChannelMessageBufferFunc message_buffer_func;
+  gpointer message_buffer_data;
+  GDestroyNotify message_buffer_notify;
+} GstWebRTCDataChannelPrivate;
+
 #define gst_webrtc_data_channel_parent_class parent_class
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (GstWebRTCDataChannel, gst_webrtc_data_channel,
-    G_TYPE_OBJECT, GST_DEBUG_CATEGORY_INIT (gst_webrtc_data_channel_debug,
+    G_TYPE_OBJECT, G_ADD_PRIVATE (GstWebRTCDataChannel);
+    GST_DEBUG_CATEGORY_INIT (gst_webrtc_data_channel_debug,
         "webrtcdatachannel", 0, "webrtcdatachannel"););
 
+#define GET_PRIV(channel) \
+    ((GstWebRTCDataChannelPrivate *) \
+        gst_webrtc_data_channel_get_instance_private (channel))
+
 enum
 {
   SIGNAL_0,
@@ -174,6 +186,10 @@ static void
 gst_webrtc_data_channel_finalize (GObject * object)
 {
   GstWebRTCDataChannel *channel = GST_WEBRTC_DATA_CHANNEL (object);
+  GstWebRTCDataChannelPrivate *priv = GET_PRIV (channel);
+
+  if (priv->message_buffer_notify)
+    priv->message_buffer_notify (priv->message_buffer_data);
 
   g_free (channel->label);
   channel->label = NULL;
@@ -474,6 +490,46 @@ gst_webrtc_data_channel_on_message_data (GstWebRTCDataChannel * channel,
       gst_webrtc_data_channel_signals[SIGNAL_ON_MESSAGE_DATA], 0, data);
 }
 
+/**
+ * gst_webrtc_data_channel_on_message_buffer:
+ * @channel: a #GstWebRTCDataChannel
+ * @buffer: (transfer none): the payload of a binary message
+ *
+ * Pass a received binary message to the function set with
+ * gst_webrtc_data_channel_set_message_buffer_func(). Should only be used by
+ * subclasses, which have to signal the message with
+ * gst_webrtc_data_channel_on_message_data() instead if this returns %FALSE.
+ *
+ * Returns: %TRUE if a function was set and the message was passed to it
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_webrtc_data_channel_on_message_buffer (GstWebRTCDataChannel * channel,
+    GstBuffer * buffer)
+{
+  GstWebRTCDataChannelPrivate *priv;
+  GstWebRTCDataChannelMessageBufferFunc func;
+  gpointer user_data;
+
+  g_return_val_if_fail (GST_IS_WEBRTC_DATA_CHANNEL (channel), FALSE);
+
+  priv = GET_PRIV (channel);
+
+  GST_WEBRTC_DATA_CHANNEL_LOCK (channel);
+  func = priv->message_buffer_func;
+  user_data = priv->message_buffer_data;
+  GST_WEBRTC_DATA_CHANNEL_UNLOCK (channel);
+
+  if (!func)
+    return FALSE;
+
+  GST_LOG_OBJECT (channel, "Have buffer %" GST_PTR_FORMAT, buffer);
+  func (channel, buffer, user_data);
+
+  return TRUE;
+}
+
 /**
  * gst_webrtc_data_channel_on_message_string:
  * @channel: a #GstWebRTCDataChannel
@@ -593,6 +649,105 @@ gst_webrtc_data_channel_send_string_full (GstWebRTCDataChannel * channel,
   return klass->send_string (channel, str, error);
 }
 
+/**
+ * gst_webrtc_data_channel_send_buffer_list:
+ * @channel: a #GstWebRTCDataChannel
+ * @list: (transfer none): a #GstBufferList
+ * @error: (nullable): location to a #GError or %NULL
+ *
+ * Send every buffer of @list as a binary message over @channel. The
+ * messages are queued in one go and the memory of the buffers is used
+ * without copying it, which avoids the overhead of
+ * gst_webrtc_data_channel_send_data_full() for high message rates.
+ *
+ * Returns: TRUE if @channel is open and all messages could be queued
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_webrtc_data_channel_send_buffer_list (GstWebRTCDataChannel * channel,
+    GstBufferList * list, GError ** error)
+{
+  GstWebRTCDataChannelClass *klass;
+  guint i, len;
+
+  g_return_val_if_fail (GST_IS_WEBRTC_DATA_CHANNEL (channel), FALSE);
+  g_return_val_if_fail (GST_IS_BUFFER_LIST (list), FALSE);
+
+  klass = GST_WEBRTC_DATA_CHANNEL_GET_CLASS (channel);
+  if (klass->send_buffer_list)
+    return klass->send_buffer_list (channel, list, error);
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len; i++) {
+    GstBuffer *buffer = gst_buffer_list_get (list, i);
+    GstMapInfo map;
+    GBytes *bytes;
+    gboolean ret;
+
+    if (!gst_buffer_map (buffer, &map, GST_MAP_READ)) {
+      g_set_error (error, GST_WEBRTC_ERROR,
+          GST_WEBRTC_ERROR_DATA_CHANNEL_FAILURE, "Failed to map buffer");
+      return FALSE;
+    }
+    bytes = g_bytes_new (map.data, map.size);
+    gst_buffer_unmap (buffer, &map);
+
+    ret = klass->send_data (channel, bytes, error);
+    g_bytes_unref (bytes);
+    if (!ret)
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+/**
+ * gst_webrtc_data_channel_set_message_buffer_func:
+ * @channel: a #GstWebRTCDataChannel
+ * @func: (nullable) (scope notified): the function to call for received
+ *     binary messages, or %NULL
+ * @user_data: (closure): user data passed to @func
+ * @notify: (nullable): called for @user_data when @func is replaced
+ *
+ * Have received binary messages passed to @func as #GstBuffer instead of
+ * emitting #GstWebRTCDataChannel::on-message-data. @func is called
+ * directly from the streaming thread that received the message, without
+ * copying it or dispatching it to the main context of webrtcbin, and must
+ * therefore not block.
+ *
+ * String messages are still signalled with
+ * #GstWebRTCDataChannel::on-message-string.
+ *
+ * The function should be set before the channel is opened.
+ *
+ * Since: 1.24
+ */
+void
+gst_webrtc_data_channel_set_message_buffer_func (GstWebRTCDataChannel *
+    channel, GstWebRTCDataChannelMessageBufferFunc func, gpointer user_data,
+    GDestroyNotify notify)
+{
+  GstWebRTCDataChannelPrivate *priv;
+  GDestroyNotify old_notify;
+  gpointer old_data;
+
+  g_return_if_fail (GST_IS_WEBRTC_DATA_CHANNEL (channel));
+
+  priv = GET_PRIV (channel);
+
+  GST_WEBRTC_DATA_CHANNEL_LOCK (channel);
+  old_notify = priv->message_buffer_notify;
+  old_data = priv->message_buffer_data;
+  priv->message_buffer_func = func;
+  priv->message_buffer_data = user_data;
+  priv->message_buffer_notify = notify;
+  GST_WEBRTC_DATA_CHANNEL_UNLOCK (channel);
+
+  if (old_notify)
+    old_notify (old_data);
+}
+
 /**
  * gst_webrtc_data_channel_close:
  * @channel: a #GstWebRTCDataChannel
@@ -45,6 +45,28 @@ gboolean gst_webrtc_data_channel_send_string_full (GstWebRTCDataChannel * channe
 GST_WEBRTC_API
 void gst_webrtc_data_channel_close (GstWebRTCDataChannel * channel);
 
+GST_WEBRTC_API
+gboolean gst_webrtc_data_channel_send_buffer_list (GstWebRTCDataChannel * channel, GstBufferList * list, GError ** error);
+
+/**
+ * GstWebRTCDataChannelMessageBufferFunc:
+ * @channel: the #GstWebRTCDataChannel
+ * @buffer: (transfer none): the payload of the received binary message
+ * @user_data: the user data passed when setting the function
+ *
+ * Called for every binary message received on @channel, see
+ * gst_webrtc_data_channel_set_message_buffer_func().
+ *
+ * Since: 1.24
+ */
+typedef void (*GstWebRTCDataChannelMessageBufferFunc) (GstWebRTCDataChannel * channel, GstBuffer * buffer, gpointer user_data);
+
+GST_WEBRTC_API
+void gst_webrtc_data_channel_set_message_buffer_func (GstWebRTCDataChannel * channel,
+                                                      GstWebRTCDataChannelMessageBufferFunc func,
+                                                      gpointer user_data,
+                                                      GDestroyNotify notify);
+
 #ifndef GST_REMOVE_DEPRECATED
 GST_WEBRTC_DEPRECATED_FOR(gst_webrtc_data_channel_send_data_full)
 void gst_webrtc_data_channel_send_data (GstWebRTCDataChannel * channel, GBytes * data);
@@ -60,6 +60,12 @@ struct _GstWebRTCNicePrivate
   GMutex lock;
   GCond cond;
 
+  /* remote candidates waiting to be handed to the agent from its own
+   * thread, protected by remote_candidates_lock */
+  GMutex remote_candidates_lock;
+  GQueue remote_candidates;
+  gboolean remote_candidates_scheduled;
+
   GstWebRTCICEOnCandidateFunc on_candidate;
   gpointer on_candidate_data;
   GDestroyNotify on_candidate_notify;
@@ -709,11 +715,111 @@ free_resolve_candidate_data (struct resolve_candidate_data *rc)
   g_free (rc);
 }
 
+struct remote_candidate_item
+{
+  guint nice_stream_id;
+  /* NULL marks the end of the remote candidates */
+  NiceCandidate *cand;
+};
+
+static void
+free_remote_candidate_item (struct remote_candidate_item *rc)
+{
+  if (rc->cand)
+    nice_candidate_free (rc->cand);
+  g_free (rc);
+}
+
+static void
+set_remote_candidates (GstWebRTCNice * nice, guint nice_stream_id,
+    guint component_id, GSList * candidates)
+{
+  if (!candidates)
+    return;
+
+  candidates = g_slist_reverse (candidates);
+  GST_LOG_OBJECT (nice, "adding %u remote candidates to stream %u "
+      "component %u", g_slist_length (candidates), nice_stream_id,
+      component_id);
+  nice_agent_set_remote_candidates (nice->priv->nice_agent, nice_stream_id,
+      component_id, candidates);
+  g_slist_free (candidates);
+}
+
+static gboolean
+flush_remote_candidates (GstWebRTCNice * nice)
+{
+  GQueue items = G_QUEUE_INIT;
+  GSList *candidates = NULL;
+  guint nice_stream_id = 0, component_id = 0;
+  GList *l;
+
+  g_mutex_lock (&nice->priv->remote_candidates_lock);
+  items = nice->priv->remote_candidates;
+  g_queue_init (&nice->priv->remote_candidates);
+  nice->priv->remote_candidates_scheduled = FALSE;
+  g_mutex_unlock (&nice->priv->remote_candidates_lock);
+
+  /* hand consecutive candidates for the same component to the agent at
+   * once so they are paired in one go */
+  for (l = items.head; l; l = l->next) {
+    struct remote_candidate_item *rc = l->data;
+
+    if (candidates && (!rc->cand || rc->nice_stream_id != nice_stream_id
+            || rc->cand->component_id != component_id)) {
+      set_remote_candidates (nice, nice_stream_id, component_id, candidates);
+      candidates = NULL;
+    }
+
+    if (!rc->cand) {
+      nice_agent_peer_candidate_gathering_done (nice->priv->nice_agent,
+          rc->nice_stream_id);
+      continue;
+    }
+
+    nice_stream_id = rc->nice_stream_id;
+    component_id = rc->cand->component_id;
+    candidates = g_slist_prepend (candidates, rc->cand);
+  }
+  set_remote_candidates (nice, nice_stream_id, component_id, candidates);
+
+  g_queue_clear_full (&items, (GDestroyNotify) free_remote_candidate_item);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* takes ownership of @cand */
+static void
+queue_remote_candidate (GstWebRTCNice * nice, guint nice_stream_id,
+    NiceCandidate * cand)
+{
+  struct remote_candidate_item *rc;
+  gboolean schedule = FALSE;
+
+  rc = g_new0 (struct remote_candidate_item, 1);
+  rc->nice_stream_id = nice_stream_id;
+  rc->cand = cand;
+
+  g_mutex_lock (&nice->priv->remote_candidates_lock);
+  g_queue_push_tail (&nice->priv->remote_candidates, rc);
+  if (!nice->priv->remote_candidates_scheduled) {
+    nice->priv->remote_candidates_scheduled = TRUE;
+    schedule = TRUE;
+  }
+  g_mutex_unlock (&nice->priv->remote_candidates_lock);
+
+  /* Candidates are applied from the agent's thread so the caller does not
+   * wait on the agent, and a burst of trickled candidates only wakes it up
+   * once */
+  if (schedule)
+    g_main_context_invoke (nice->priv->main_context,
+        (GSourceFunc) flush_remote_candidates, nice);
+}
+
 static void
 add_ice_candidate_to_libnice (GstWebRTCICE * ice, guint nice_stream_id,
     NiceCandidate * cand)
 {
-  GSList *candidates = NULL;
   GstWebRTCNice *nice = GST_WEBRTC_NICE (ice);
 
   if (cand->component_id == 2) {
@@ -722,12 +828,7 @@ add_ice_candidate_to_libnice (GstWebRTCICE * ice, guint nice_stream_id,
     return;
   }
 
-  candidates = g_slist_append (candidates, cand);
-
-  nice_agent_set_remote_candidates (nice->priv->nice_agent, nice_stream_id,
-      cand->component_id, candidates);
-
-  g_slist_free (candidates);
+  queue_remote_candidate (nice, nice_stream_id, nice_candidate_copy (cand));
 }
 
 static void
@@ -787,8 +888,7 @@ gst_webrtc_nice_add_candidate (GstWebRTCICE * ice, GstWebRTCICEStream * stream,
   g_return_if_fail (item != NULL);
 
   if (candidate == NULL) {
-    nice_agent_peer_candidate_gathering_done (nice->priv->nice_agent,
-        item->nice_stream_id);
+    queue_remote_candidate (nice, item->nice_stream_id, NULL);
     return;
   }
 
@@ -1560,6 +1660,10 @@ gst_webrtc_nice_finalize (GObject * object)
   g_mutex_clear (&ice->priv->lock);
   g_cond_clear (&ice->priv->cond);
 
+  g_queue_clear_full (&ice->priv->remote_candidates,
+      (GDestroyNotify) free_remote_candidate_item);
+  g_mutex_clear (&ice->priv->remote_candidates_lock);
+
   g_array_free (ice->priv->nice_stream_map, TRUE);
 
   g_object_unref (ice->priv->nice_agent);
@@ -1660,6 +1764,9 @@ gst_webrtc_nice_init (GstWebRTCNice * ice)
   g_mutex_init (&ice->priv->lock);
   g_cond_init (&ice->priv->cond);
 
+  g_mutex_init (&ice->priv->remote_candidates_lock);
+  g_queue_init (&ice->priv->remote_candidates);
+
   ice->priv->turn_servers =
       g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
       (GDestroyNotify) gst_uri_unref);
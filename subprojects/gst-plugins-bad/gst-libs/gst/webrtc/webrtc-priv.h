@@ -226,7 +226,14 @@ struct _GstWebRTCDataChannelClass
   gboolean          (*send_string) (GstWebRTCDataChannel * channel, const gchar *str, GError ** error);
   void              (*close)       (GstWebRTCDataChannel * channel);
 
-  gpointer           _padding[GST_PADDING];
+  /**
+   * GstWebRTCDataChannelClass::send_buffer_list:
+   *
+   * Since: 1.24
+   */
+  gboolean          (*send_buffer_list) (GstWebRTCDataChannel * channel, GstBufferList * list, GError ** error);
+
+  gpointer           _padding[GST_PADDING - 1];
 };
 
 GST_WEBRTC_API
@@ -247,6 +254,9 @@ void gst_webrtc_data_channel_on_message_string (GstWebRTCDataChannel * channel,
 GST_WEBRTC_API
 void gst_webrtc_data_channel_on_buffered_amount_low (GstWebRTCDataChannel * channel);
 
+GST_WEBRTC_API
+gboolean gst_webrtc_data_channel_on_message_buffer (GstWebRTCDataChannel * channel, GstBuffer * buffer);
+
 
 /**
  * GstWebRTCSCTPTransport:
@@ -37,7 +37,9 @@ struct _GstInterSurface
 
   /* video */
   GstVideoInfo video_info;
-  int video_buffer_count;
+  /* bumped for every new video_buffer, each consumer keeps its own repeat
+   * count against it so that several sources can share the channel */
+  guint64 video_buffer_seq;
 
   /* audio */
   GstAudioInfo audio_info;
@@ -253,11 +253,8 @@ gst_inter_video_sink_show_frame (GstVideoSink * sink, GstBuffer * buffer)
       GST_TIME_ARGS (GST_BUFFER_PTS (buffer)));
 
   g_mutex_lock (&intervideosink->surface->mutex);
-  if (intervideosink->surface->video_buffer) {
-    gst_buffer_unref (intervideosink->surface->video_buffer);
-  }
-  intervideosink->surface->video_buffer = gst_buffer_ref (buffer);
-  intervideosink->surface->video_buffer_count = 0;
+  gst_buffer_replace (&intervideosink->surface->video_buffer, buffer);
+  intervideosink->surface->video_buffer_seq++;
   g_mutex_unlock (&intervideosink->surface->mutex);
 
   return GST_FLOW_OK;
@@ -278,6 +278,8 @@ gst_inter_video_src_start (GstBaseSrc * src)
   intervideosrc->surface = gst_inter_surface_get (intervideosrc->channel);
   intervideosrc->timestamp_offset = 0;
   intervideosrc->n_frames = 0;
+  intervideosrc->last_seq = 0;
+  intervideosrc->repeat_count = 0;
 
   return TRUE;
 }
@@ -328,7 +330,7 @@ gst_inter_video_src_create (GstBaseSrc * src, guint64 offset, guint size,
   GstInterVideoSrc *intervideosrc = GST_INTER_VIDEO_SRC (src);
   GstCaps *caps;
   GstBuffer *buffer;
-  guint64 frames;
+  guint64 frames, seq;
   gboolean is_gap = FALSE;
 
   GST_DEBUG_OBJECT (intervideosrc, "create");
@@ -362,25 +364,31 @@ gst_inter_video_src_create (GstBaseSrc * src, guint64 offset, guint size,
     }
   }
 
-  if (intervideosrc->surface->video_buffer) {
-    /* We have a buffer to push */
+  /* Only take a reference here, the surface buffer is left in place so
+   * that other sources on the same channel still see it */
+  if (intervideosrc->surface->video_buffer)
     buffer = gst_buffer_ref (intervideosrc->surface->video_buffer);
+  seq = intervideosrc->surface->video_buffer_seq;
+  g_mutex_unlock (&intervideosrc->surface->mutex);
 
-    /* Can only be true if timeout > 0 */
-    if (intervideosrc->surface->video_buffer_count == frames) {
-      gst_buffer_unref (intervideosrc->surface->video_buffer);
-      intervideosrc->surface->video_buffer = NULL;
-    }
+  if (seq != intervideosrc->last_seq) {
+    intervideosrc->last_seq = seq;
+    intervideosrc->repeat_count = 0;
   }
 
-  if (intervideosrc->surface->video_buffer_count != 0 &&
-      intervideosrc->surface->video_buffer_count != (frames + 1)) {
+  /* Repeat the last frame until the timeout expired, black afterwards */
+  if (buffer && intervideosrc->repeat_count > frames) {
+    gst_buffer_unref (buffer);
+    buffer = NULL;
+  }
+
+  if (intervideosrc->repeat_count != 0 &&
+      intervideosrc->repeat_count != (frames + 1)) {
     /* This is a repeat of the stored buffer or of a black frame */
     is_gap = TRUE;
   }
 
-  intervideosrc->surface->video_buffer_count++;
-  g_mutex_unlock (&intervideosrc->surface->mutex);
+  intervideosrc->repeat_count++;
 
   if (caps) {
     gboolean ret;
@@ -48,6 +48,11 @@ struct _GstInterVideoSrc
   GstBuffer *black_frame;
   int n_frames;
   GstClockTime timestamp_offset;
+
+  /* surface video_buffer_seq of the last frame we fetched and how often we
+   * produced output since then */
+  guint64 last_seq;
+  guint64 repeat_count;
 };
 
 struct _GstInterVideoSrcClass
@@ -1535,6 +1535,12 @@ mpegts_base_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
 
   mpegts_packetizer_push (base->packetizer, buf);
 
+  /* Packets on PIDs we neither parse nor push can be skipped in bulk by the
+   * packetizer, unless the subclass wants to see all of them */
+  if (!klass->inspect_packet && !base->push_unknown)
+    mpegts_packetizer_set_pid_filter (packetizer, base->known_psi,
+        base->is_pes);
+
   while (res == GST_FLOW_OK) {
     pret = mpegts_packetizer_next_packet (base->packetizer, &packet);
 
@@ -1583,6 +1589,7 @@ mpegts_base_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   next:
     mpegts_packetizer_clear_packet (base->packetizer, &packet);
   }
+  mpegts_packetizer_set_pid_filter (packetizer, NULL, NULL);
 
   if (res == GST_FLOW_OK && klass->input_done)
     res = klass->input_done (base);
@@ -136,21 +136,17 @@ mpegts_packetizer_get_current_time (MpegTSPacketizer2 * packetizer,
       pcr_pid);
 }
 
+#define SUBTABLE_KEY(table_id, subtable_extension) \
+  GUINT_TO_POINTER (((guint) (table_id) << 16) | (subtable_extension))
+
+/* EIT carries one subtable per service and table_id, so there can be
+ * hundreds of them on a single PID */
 static inline MpegTSPacketizerStreamSubtable *
-find_subtable (GSList * subtables, guint8 table_id, guint16 subtable_extension)
+find_subtable (GHashTable * subtables, guint8 table_id,
+    guint16 subtable_extension)
 {
-  GSList *tmp;
-
-  /* FIXME: Make this an array ! */
-  for (tmp = subtables; tmp; tmp = tmp->next) {
-    MpegTSPacketizerStreamSubtable *sub =
-        (MpegTSPacketizerStreamSubtable *) tmp->data;
-    if (sub->table_id == table_id
-        && sub->subtable_extension == subtable_extension)
-      return sub;
-  }
-
-  return NULL;
+  return g_hash_table_lookup (subtables,
+      SUBTABLE_KEY (table_id, subtable_extension));
 }
 
 static gboolean
@@ -194,6 +190,13 @@ mpegts_packetizer_stream_subtable_new (guint8 table_id,
   return subtable;
 }
 
+static void
+mpegts_packetizer_stream_subtable_free (MpegTSPacketizerStreamSubtable *
+    subtable)
+{
+  g_free (subtable);
+}
+
 static MpegTSPacketizerStream *
 mpegts_packetizer_stream_new (guint16 pid)
 {
@@ -201,7 +204,8 @@ mpegts_packetizer_stream_new (guint16 pid)
 
   stream = (MpegTSPacketizerStream *) g_new0 (MpegTSPacketizerStream, 1);
   stream->continuity_counter = CONTINUITY_UNSET;
-  stream->subtables = NULL;
+  stream->subtables = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) mpegts_packetizer_stream_subtable_free);
   stream->table_id = TABLE_ID_UNSET;
   stream->pid = pid;
   return stream;
@@ -218,20 +222,11 @@ mpegts_packetizer_clear_section (MpegTSPacketizerStream * stream)
   stream->section_data = NULL;
 }
 
-static void
-mpegts_packetizer_stream_subtable_free (MpegTSPacketizerStreamSubtable *
-    subtable)
-{
-  g_free (subtable);
-}
-
 static void
 mpegts_packetizer_stream_free (MpegTSPacketizerStream * stream)
 {
   mpegts_packetizer_clear_section (stream);
-  g_slist_foreach (stream->subtables,
-      (GFunc) mpegts_packetizer_stream_subtable_free, NULL);
-  g_slist_free (stream->subtables);
+  g_hash_table_unref (stream->subtables);
   g_free (stream);
 }
 
@@ -532,7 +527,8 @@ mpegts_packetizer_parse_section_header (MpegTSPacketizer2 * packetizer,
         stream->subtable_extension, stream->last_section_number);
     subtable->version_number = stream->version_number;
 
-    stream->subtables = g_slist_prepend (stream->subtables, subtable);
+    g_hash_table_insert (stream->subtables,
+        SUBTABLE_KEY (stream->table_id, stream->subtable_extension), subtable);
   }
 
   GST_MEMDUMP ("Full section data", stream->section_data,
@@ -838,6 +834,51 @@ mpegts_packetizer_sync (MpegTSPacketizer2 * packetizer)
   return found;
 }
 
+/* Skips the mapped packets on PIDs that are not in the filter bitmaps, only
+ * looking at the sync byte and PID of each packet. Packets carrying a PCR
+ * are kept if the PCR observations are needed.
+ * Returns FALSE if the whole mapped data could be skipped */
+static gboolean
+mpegts_packetizer_skip_filtered (MpegTSPacketizer2 * packetizer,
+    guint packet_size, gsize sync_offset)
+{
+  const guint8 *psi = packetizer->filter_psi;
+  const guint8 *pes = packetizer->filter_pes;
+  gboolean need_pcr = packetizer->calculate_skew
+      || packetizer->calculate_offset;
+  const guint8 *data = packetizer->map_data + sync_offset;
+  gsize offset = packetizer->map_offset;
+  gsize size = packetizer->map_size;
+  gsize skipped = 0;
+  guint16 pid;
+
+  for (; size - offset >= packet_size; offset += packet_size) {
+    const guint8 *p = data + offset;
+
+    /* let the caller handle sync losses */
+    if (G_UNLIKELY (p[0] != PACKET_SYNC_BYTE))
+      break;
+
+    pid = GST_READ_UINT16_BE (p + 1) & 0x1FFF;
+    if (MPEGTS_BIT_IS_SET (pes, pid) || MPEGTS_BIT_IS_SET (psi, pid))
+      break;
+
+    /* adaptation field with PCR */
+    if (need_pcr && (p[3] & 0x20) && p[4] > 0 && (p[5] & MPEGTS_AFC_PCR_FLAG))
+      break;
+
+    skipped++;
+  }
+
+  if (skipped) {
+    GST_LOG ("skipped %" G_GSIZE_FORMAT " packets on unwanted PIDs", skipped);
+    packetizer->offset += skipped * packet_size;
+    packetizer->map_offset = offset;
+  }
+
+  return size - offset >= packet_size;
+}
+
 MpegTSPacketizerPacketReturn
 mpegts_packetizer_next_packet (MpegTSPacketizer2 * packetizer,
     MpegTSPacketizerPacket * packet)
@@ -869,6 +910,11 @@ mpegts_packetizer_next_packet (MpegTSPacketizer2 * packetizer,
     if (!mpegts_packetizer_map (packetizer, packet_size))
       return PACKET_NEED_MORE;
 
+    if (packetizer->filter_pes && packetizer->filter_psi &&
+        !mpegts_packetizer_skip_filtered (packetizer, packet_size,
+            sync_offset))
+      continue;
+
     packet_data = &packetizer->map_data[packetizer->map_offset + sync_offset];
 
     /* Check sync byte */
@@ -2538,6 +2584,17 @@ mpegts_packetizer_set_pcr_discont_threshold (MpegTSPacketizer2 * packetizer,
   PACKETIZER_GROUP_UNLOCK (packetizer);
 }
 
+/* Only return packets on PIDs set in either of the bitmaps from
+ * mpegts_packetizer_next_packet(), or all packets if they are %NULL.
+ * The bitmaps are not copied */
+void
+mpegts_packetizer_set_pid_filter (MpegTSPacketizer2 * packetizer,
+    const guint8 * psi_pids, const guint8 * pes_pids)
+{
+  packetizer->filter_psi = psi_pids;
+  packetizer->filter_pes = pes_pids;
+}
+
 void
 mpegts_packetizer_set_current_pcr_offset (MpegTSPacketizer2 * packetizer,
     GstClockTime offset, guint16 pcr_pid)
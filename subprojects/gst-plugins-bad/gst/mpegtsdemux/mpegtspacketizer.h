@@ -85,7 +85,8 @@ typedef struct
   guint8  section_number;
   guint8  last_section_number;
 
-  GSList *subtables;
+  /* table_id << 16 | subtable_extension -> MpegTSPacketizerStreamSubtable */
+  GHashTable *subtables;
 
   /* Upstream offset of the data contained in the section */
   guint64 offset;
@@ -269,6 +270,11 @@ struct _MpegTSPacketizer2 {
   gsize map_size;
   gboolean need_sync;
 
+  /* Optional bitmaps of wanted PIDs, packets on other PIDs are skipped
+   * without being parsed. Use MPEGTS_BIT_* macros to check */
+  const guint8 *filter_psi;
+  const guint8 *filter_pes;
+
   /* Reference offset */
   guint64 refoffset;
 
@@ -387,6 +393,9 @@ mpegts_packetizer_set_reference_offset (MpegTSPacketizer2 * packetizer,
 G_GNUC_INTERNAL void
 mpegts_packetizer_set_pcr_discont_threshold (MpegTSPacketizer2 * packetizer,
 					GstClockTime threshold);
+G_GNUC_INTERNAL void
+mpegts_packetizer_set_pid_filter (MpegTSPacketizer2 * packetizer,
+				  const guint8 * psi_pids, const guint8 * pes_pids);
 G_END_DECLS
 
 #endif /* GST_MPEGTS_PACKETIZER_H */
@@ -89,6 +89,7 @@ enum
   PROP_PCR_PID,
   PROP_ALIGNMENT,
   PROP_SPLIT_ON_RAI,
+  PROP_SPLIT_PROGRAMS,
   /* FILL ME */
 };
 
@@ -118,6 +119,8 @@ static void mpegts_parse_destroy_tspad (MpegTSParse2 * parse,
 static void mpegts_parse_pad_removed (GstElement * element, GstPad * pad);
 static GstPad *mpegts_parse_request_new_pad (GstElement * element,
     GstPadTemplate * templ, const gchar * name, const GstCaps * caps);
+static GstPad *mpegts_parse_add_program_pad (MpegTSParse2 * parse,
+    const gchar * padname, gint program_num);
 static void mpegts_parse_release_pad (GstElement * element, GstPad * pad);
 static gboolean mpegts_parse_src_pad_query (GstPad * pad, GstObject * parent,
     GstQuery * query);
@@ -183,6 +186,21 @@ mpegts_parse_class_init (MpegTSParse2Class * klass)
           "so that RAI packets are at the start of a new buffer", FALSE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * tsparse:split-programs:
+   *
+   * If set, a program_%u source pad is added for every program announced in
+   * the PAT, without the application having to request one. This allows
+   * splitting all programs of a multi-program transport stream in a single
+   * pass, the packets being shared between the outputs without copies.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_SPLIT_PROGRAMS,
+      g_param_spec_boolean ("split-programs", "Split programs",
+          "Automatically add a program source pad for every program", FALSE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   element_class = GST_ELEMENT_CLASS (klass);
   element_class->pad_removed = mpegts_parse_pad_removed;
   element_class->request_new_pad = mpegts_parse_request_new_pad;
@@ -238,6 +256,7 @@ mpegts_parse_init (MpegTSParse2 * parse)
   parse->is_eos = FALSE;
   parse->header = 0;
   parse->split_on_rai = FALSE;
+  parse->split_programs = FALSE;
 }
 
 static void
@@ -313,6 +332,9 @@ mpegts_parse_set_property (GObject * object, guint prop_id,
     case PROP_SPLIT_ON_RAI:
       parse->split_on_rai = g_value_get_boolean (value);
       break;
+    case PROP_SPLIT_PROGRAMS:
+      parse->split_programs = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -340,6 +362,9 @@ mpegts_parse_get_property (GObject * object, guint prop_id,
     case PROP_SPLIT_ON_RAI:
       g_value_set_boolean (value, parse->split_on_rai);
       break;
+    case PROP_SPLIT_PROGRAMS:
+      g_value_set_boolean (value, parse->split_programs);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
   }
@@ -545,13 +570,7 @@ static GstPad *
 mpegts_parse_request_new_pad (GstElement * element, GstPadTemplate * template,
     const gchar * padname, const GstCaps * caps)
 {
-  MpegTSParse2 *parse;
-  MpegTSParsePad *tspad;
-  MpegTSParseProgram *parseprogram;
-  GstPad *pad;
   gint program_num = -1;
-  GstEvent *event;
-  gchar *stream_id;
 
   g_return_val_if_fail (template != NULL, NULL);
   g_return_val_if_fail (GST_IS_MPEGTS_PARSE (element), NULL);
@@ -561,7 +580,20 @@ mpegts_parse_request_new_pad (GstElement * element, GstPadTemplate * template,
 
   GST_DEBUG_OBJECT (element, "padname:%s, program:%d", padname, program_num);
 
-  parse = GST_MPEGTS_PARSE (element);
+  return mpegts_parse_add_program_pad (GST_MPEGTS_PARSE (element), padname,
+      program_num);
+}
+
+static GstPad *
+mpegts_parse_add_program_pad (MpegTSParse2 * parse, const gchar * padname,
+    gint program_num)
+{
+  GstElement *element = GST_ELEMENT_CAST (parse);
+  MpegTSParsePad *tspad;
+  MpegTSParseProgram *parseprogram;
+  GstPad *pad;
+  GstEvent *event;
+  gchar *stream_id;
 
   tspad = mpegts_parse_create_tspad (parse, padname);
   tspad->program_number = program_num;
@@ -1152,6 +1184,16 @@ mpegts_parse_program_started (MpegTSBase * base, MpegTSBaseProgram * program)
   /* If we have a request pad for that program, activate it */
   tspad = find_pad_for_program (parse, program->program_number);
 
+  if (!tspad && parse->split_programs) {
+    gchar *padname = g_strdup_printf ("program_%d", program->program_number);
+
+    GST_DEBUG_OBJECT (parse, "adding pad for program %d",
+        program->program_number);
+    mpegts_parse_add_program_pad (parse, padname, program->program_number);
+    g_free (padname);
+    tspad = find_pad_for_program (parse, program->program_number);
+  }
+
   if (tspad) {
     tspad->program = parseprogram;
     parseprogram->tspad = tspad;
@@ -86,6 +86,7 @@ struct _MpegTSParse2 {
   MpegTSParse2Adapter ts_adapter;
   guint alignment;
   gboolean split_on_rai;
+  gboolean split_programs;
   gboolean is_eos;
   guint32 header;
 };
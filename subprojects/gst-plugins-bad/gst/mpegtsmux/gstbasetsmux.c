@@ -189,10 +189,12 @@ enum
   PROP_BITRATE,
   PROP_PCR_INTERVAL,
   PROP_SCTE_35_PID,
-  PROP_SCTE_35_NULL_INTERVAL
+  PROP_SCTE_35_NULL_INTERVAL,
+  PROP_PACED_OUTPUT
 };
 
 #define DEFAULT_SCTE_35_PID 0
+#define DEFAULT_PACED_OUTPUT FALSE
 
 #define BASETSMUX_DEFAULT_ALIGNMENT    -1
 
@@ -298,6 +300,44 @@ steal_si_section (GstMpegtsSectionType * type, TsMuxSection * section,
   return TRUE;
 }
 
+static void
+gst_base_ts_mux_clear_pool (GstBufferPool ** pool)
+{
+  if (*pool) {
+    gst_buffer_pool_set_active (*pool, FALSE);
+    gst_object_unref (*pool);
+    *pool = NULL;
+  }
+}
+
+/* Returns a buffer of @size from @pool, creating the pool if needed.
+ * Buffers go back to the pool once the adapter or downstream is done with
+ * them, which avoids an allocation for every packet and output buffer */
+static GstBuffer *
+gst_base_ts_mux_acquire_buffer (GstBufferPool ** pool, gsize size)
+{
+  GstBuffer *buf = NULL;
+
+  if (G_UNLIKELY (*pool == NULL)) {
+    GstStructure *config;
+
+    *pool = gst_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (*pool);
+    gst_buffer_pool_config_set_params (config, NULL, size, 0, 0);
+    if (!gst_buffer_pool_set_config (*pool, config) ||
+        !gst_buffer_pool_set_active (*pool, TRUE)) {
+      gst_object_unref (*pool);
+      *pool = NULL;
+    }
+  }
+
+  if (G_UNLIKELY (*pool == NULL ||
+          gst_buffer_pool_acquire_buffer (*pool, &buf, NULL) != GST_FLOW_OK))
+    buf = gst_buffer_new_and_alloc (size);
+
+  return buf;
+}
+
 /* Must be called with mux->lock held */
 static void
 gst_base_ts_mux_reset (GstBaseTsMux * mux, gboolean alloc)
@@ -321,6 +361,10 @@ gst_base_ts_mux_reset (GstBaseTsMux * mux, gboolean alloc)
     gst_adapter_clear (mux->out_adapter);
   mux->output_ts_offset = GST_CLOCK_STIME_NONE;
 
+  gst_base_ts_mux_clear_pool (&mux->packet_pool);
+  gst_base_ts_mux_clear_pool (&mux->out_pool);
+  mux->out_pool_size = 0;
+
   if (mux->tsmux) {
     if (mux->tsmux->si_sections)
       si_sections = g_hash_table_ref (mux->tsmux->si_sections);
@@ -949,6 +993,37 @@ new_packet_common_init (GstBaseTsMux * mux, GstBuffer * buf, guint8 * data,
   }
 }
 
+/* In paced output mode every buffer gets the duration of its packets at
+ * the configured bitrate and is pushed on its own, so that a sink syncing
+ * on the clock sends them out evenly instead of in bursts of lists */
+static GstFlowReturn
+gst_base_ts_mux_finish_packets (GstBaseTsMux * mux, GstBufferList * list)
+{
+  GstAggregator *agg = GST_AGGREGATOR (mux);
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint i, len;
+
+  if (!mux->paced_output || !mux->bitrate)
+    return gst_aggregator_finish_buffer_list (agg, list);
+
+  len = gst_buffer_list_length (list);
+  for (i = 0; i < len && ret == GST_FLOW_OK; i++) {
+    GstBuffer *buf = gst_buffer_list_get_writable (list, i);
+    guint64 ts_bytes;
+
+    /* the bitrate only accounts for the 188 bytes of the TS packets */
+    ts_bytes = gst_buffer_get_size (buf) / mux->packet_size *
+        GST_BASE_TS_MUX_NORMAL_PACKET_LENGTH;
+    GST_BUFFER_DURATION (buf) =
+        gst_util_uint64_scale (ts_bytes * 8, GST_SECOND, mux->bitrate);
+
+    ret = gst_aggregator_finish_buffer (agg, gst_buffer_ref (buf));
+  }
+  gst_buffer_list_unref (list);
+
+  return ret;
+}
+
 static GstFlowReturn
 gst_base_ts_mux_push_packets (GstBaseTsMux * mux, gboolean force)
 {
@@ -970,8 +1045,7 @@ gst_base_ts_mux_push_packets (GstBaseTsMux * mux, gboolean force)
   /* no alignment, just push all available data */
   if (align == 0) {
     buffer_list = gst_adapter_take_buffer_list (mux->out_adapter, av);
-    return gst_aggregator_finish_buffer_list (GST_AGGREGATOR (mux),
-        buffer_list);
+    return gst_base_ts_mux_finish_packets (mux, buffer_list);
   }
 
   align *= packet_size;
@@ -981,13 +1055,23 @@ gst_base_ts_mux_push_packets (GstBaseTsMux * mux, gboolean force)
 
   buffer_list = gst_buffer_list_new_sized ((av / align) + 1);
 
+  if (mux->out_pool_size != align) {
+    gst_base_ts_mux_clear_pool (&mux->out_pool);
+    mux->out_pool_size = align;
+  }
+
   GST_LOG_OBJECT (mux, "aligning to %d bytes", align);
   while (align <= av) {
     GstBuffer *buf;
     GstClockTime pts;
+    GstMapInfo map;
 
     pts = gst_adapter_prev_pts (mux->out_adapter, NULL);
-    buf = gst_adapter_take_buffer (mux->out_adapter, align);
+    buf = gst_base_ts_mux_acquire_buffer (&mux->out_pool, align);
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
+    gst_adapter_copy (mux->out_adapter, map.data, 0, align);
+    gst_buffer_unmap (buf, &map);
+    gst_adapter_flush (mux->out_adapter, align);
 
     GST_BUFFER_PTS (buf) = pts;
 
@@ -1047,7 +1131,7 @@ gst_base_ts_mux_push_packets (GstBaseTsMux * mux, gboolean force)
     gst_buffer_list_add (buffer_list, buf);
   }
 
-  return gst_aggregator_finish_buffer_list (GST_AGGREGATOR (mux), buffer_list);
+  return gst_base_ts_mux_finish_packets (mux, buffer_list);
 }
 
 static GstFlowReturn
@@ -2506,6 +2590,9 @@ gst_base_ts_mux_set_property (GObject * object, guint prop_id,
     case PROP_SCTE_35_NULL_INTERVAL:
       mux->scte35_null_interval = g_value_get_uint (value);
       break;
+    case PROP_PACED_OUTPUT:
+      mux->paced_output = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2546,6 +2633,9 @@ gst_base_ts_mux_get_property (GObject * object, guint prop_id,
     case PROP_SCTE_35_NULL_INTERVAL:
       g_value_set_uint (value, mux->scte35_null_interval);
       break;
+    case PROP_PACED_OUTPUT:
+      g_value_set_boolean (value, mux->paced_output);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2572,11 +2662,8 @@ static void
 gst_base_ts_mux_default_allocate_packet (GstBaseTsMux * mux,
     GstBuffer ** buffer)
 {
-  GstBuffer *buf;
-
-  buf = gst_buffer_new_and_alloc (mux->packet_size);
-
-  *buffer = buf;
+  *buffer = gst_base_ts_mux_acquire_buffer (&mux->packet_pool,
+      mux->packet_size);
 }
 
 static gboolean
@@ -2593,7 +2680,11 @@ gst_base_ts_mux_default_output_packet (GstBaseTsMux * mux, GstBuffer * buffer,
 void
 gst_base_ts_mux_set_packet_size (GstBaseTsMux * mux, gsize size)
 {
+  g_mutex_lock (&mux->lock);
+  if (mux->packet_size != size)
+    gst_base_ts_mux_clear_pool (&mux->packet_pool);
   mux->packet_size = size;
+  g_mutex_unlock (&mux->lock);
 }
 
 void
@@ -2699,6 +2790,24 @@ gst_base_ts_mux_class_init (GstBaseTsMuxClass * klass)
           TSMUX_DEFAULT_SCTE_35_NULL_INTERVAL,
           (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
+  /**
+   * GstBaseTsMux:paced-output:
+   *
+   * When a constant #GstBaseTsMux:bitrate is set, push every output buffer
+   * separately with a duration matching the bitrate instead of pushing
+   * buffer lists. The timestamps of the packets follow the PCRs written in
+   * the stream, so a sink synchronising on the clock outputs a smooth
+   * constant bitrate stream.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (G_OBJECT_CLASS (klass), PROP_PACED_OUTPUT,
+      g_param_spec_boolean ("paced-output", "Paced output",
+          "Timestamp and push output buffers separately according to the "
+          "bitrate, for pacing by a synchronised sink (requires bitrate)",
+          DEFAULT_PACED_OUTPUT,
+          (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_base_ts_mux_src_factory, GST_TYPE_AGGREGATOR_PAD);
 
@@ -2720,6 +2829,7 @@ gst_base_ts_mux_init (GstBaseTsMux * mux)
   mux->bitrate = TSMUX_DEFAULT_BITRATE;
   mux->scte35_pid = DEFAULT_SCTE_35_PID;
   mux->scte35_null_interval = TSMUX_DEFAULT_SCTE_35_NULL_INTERVAL;
+  mux->paced_output = DEFAULT_PACED_OUTPUT;
 
   mux->packet_size = GST_BASE_TS_MUX_NORMAL_PACKET_LENGTH;
   mux->automatic_alignment = 0;
@@ -157,6 +157,7 @@ struct GstBaseTsMux {
   gint alignment;
   guint si_interval;
   guint64 bitrate;
+  gboolean paced_output;
   guint pcr_interval;
   guint scte35_pid;
   guint scte35_null_interval;
@@ -182,6 +183,10 @@ struct GstBaseTsMux {
   /* output buffer aggregation */
   GstAdapter *out_adapter;
   GstBuffer *out_buffer;
+  /* recycled packet and aligned output buffers */
+  GstBufferPool *packet_pool;
+  GstBufferPool *out_pool;
+  gsize out_pool_size;
   GstClockTimeDiff output_ts_offset;
 
   /* protects the tsmux object, the programs hash table, and pad streams */
@@ -51,9 +51,14 @@
  * mapped to its own RTP session. RTX request are only replied to on the
  * link the NACK was received from.
  *
- * There are currently two bonding methods in place: "broadcast" and "round-robin".
+ * There are currently three bonding methods in place: "broadcast",
+ * "round-robin" and "adaptive".
  * In "broadcast" mode, all the packets are duplicated over all sessions.
- * While in "round-robin" mode, packets are evenly distributed over the links. One
+ * While in "round-robin" mode, packets are evenly distributed over the links.
+ * The "adaptive" mode distributes the packets like "round-robin", but
+ * weights each link by the round-trip time and the packet loss reported in
+ * the RTCP receiver reports of that link, so that slower or lossy links get
+ * a smaller share of the stream. One
  * can also implement its own dispatcher element and configure it using the
  * "dispatcher" property. As a reference, "broadcast" mode is implemented with
  * the "tee" element, while "round-robin" mode is implemented with the
@@ -108,6 +113,7 @@ typedef enum
 {
   GST_RIST_BONDING_METHOD_BROADCAST,
   GST_RIST_BONDING_METHOD_ROUND_ROBIN,
+  GST_RIST_BONDING_METHOD_ADAPTIVE,
 } GstRistBondingMethod;
 
 static GstStaticPadTemplate sink_templ = GST_STATIC_PAD_TEMPLATE ("sink",
@@ -175,6 +181,15 @@ gst_rist_bonding_method_get_type (void)
         "GST_RIST_BONDING_METHOD_BROADCAST", "broadcast"},
     {GST_RIST_BONDING_METHOD_ROUND_ROBIN,
         "GST_RIST_BONDING_METHOD_ROUND_ROBIN", "round-robin"},
+    /**
+     * GstRistBondingMethodType::adaptive:
+     *
+     * Round robin weighted by the RTCP statistics of each link.
+     *
+     * Since: 1.24
+     */
+    {GST_RIST_BONDING_METHOD_ADAPTIVE,
+        "GST_RIST_BONDING_METHOD_ADAPTIVE", "adaptive"},
     {0, NULL, NULL}
   };
 
@@ -478,6 +493,81 @@ gst_rist_sink_on_new_receiver_ssrc (GstRistSink * sink, guint session_id,
   bond->rtcp_ssrc = ssrc;
 }
 
+/* Weight of a link for the adaptive bonding method, the expected goodput of
+ * a link is roughly proportional to its delivery ratio over its round-trip
+ * time. The weight never drops to 0 so that a link recovering from a bad
+ * period still gets some traffic and keeps producing receiver reports. */
+static guint
+gst_rist_sink_link_weight (guint fraction_lost, guint rb_rtt)
+{
+  guint64 rtt_ms;
+
+  /* rb_rtt is in Q16 in NTP time */
+  rtt_ms = gst_util_uint64_scale (rb_rtt, 1000, 65536);
+  rtt_ms = MAX (rtt_ms, 1);
+
+  return CLAMP ((256 - MIN (fraction_lost, 256)) * 100 / rtt_ms, 1,
+      G_MAXUINT16);
+}
+
+static void
+gst_rist_sink_on_ssrc_active (GstRistSink * sink, guint session_id,
+    guint ssrc, GstElement * rtpbin)
+{
+  RistSenderBond *bond;
+  GObject *session = NULL;
+  GObject *source = NULL;
+  GstStructure *sstats = NULL;
+  gboolean have_rb = FALSE;
+  guint fraction_lost = 0, rb_rtt = 0;
+  GstPad *pad;
+  gchar name[32];
+  guint weight;
+
+  if (sink->bonding_method != GST_RIST_BONDING_METHOD_ADAPTIVE ||
+      !sink->dispatcher || session_id >= sink->bonds->len)
+    return;
+
+  g_signal_emit_by_name (rtpbin, "get-internal-session", session_id, &session);
+  if (!session)
+    return;
+
+  g_signal_emit_by_name (session, "get-source-by-ssrc", ssrc, &source);
+  g_object_unref (session);
+  if (!source)
+    return;
+
+  g_object_get (source, "stats", &sstats, NULL);
+  g_object_unref (source);
+
+  gst_structure_get_boolean (sstats, "have-rb", &have_rb);
+  gst_structure_get_uint (sstats, "rb-fractionlost", &fraction_lost);
+  gst_structure_get_uint (sstats, "rb-round-trip", &rb_rtt);
+  gst_structure_free (sstats);
+
+  if (!have_rb || rb_rtt == 0)
+    return;
+
+  weight = gst_rist_sink_link_weight (fraction_lost, rb_rtt);
+
+  bond = g_ptr_array_index (sink->bonds, session_id);
+  g_snprintf (name, 32, "src_%u", bond->session);
+  pad = gst_element_get_static_pad (sink->dispatcher, name);
+  if (!pad)
+    return;
+
+  /* custom dispatchers don't necessarily support weights */
+  if (!g_object_class_find_property (G_OBJECT_GET_CLASS (pad), "weight")) {
+    gst_object_unref (pad);
+    return;
+  }
+
+  GST_LOG_OBJECT (sink, "Session %u: fraction lost %u, rtt %u, weight %u",
+      session_id, fraction_lost, rb_rtt, weight);
+  g_object_set (pad, "weight", weight, NULL);
+  gst_object_unref (pad);
+}
+
 static GstPadProbeReturn
 gst_rist_sink_fix_collision (GstPad * pad, GstPadProbeInfo * info,
     gpointer user_data)
@@ -596,6 +686,8 @@ gst_rist_sink_init (GstRistSink * sink)
       G_CALLBACK (gst_rist_sink_on_new_sender_ssrc), sink, G_CONNECT_SWAPPED);
   g_signal_connect_object (sink->rtpbin, "on-new-ssrc",
       G_CALLBACK (gst_rist_sink_on_new_receiver_ssrc), sink, G_CONNECT_SWAPPED);
+  g_signal_connect_object (sink->rtpbin, "on-ssrc-active",
+      G_CALLBACK (gst_rist_sink_on_ssrc_active), sink, G_CONNECT_SWAPPED);
 
   sink->rtxbin = gst_bin_new ("rist_send_rtxbin");
   g_object_ref_sink (sink->rtxbin);
@@ -754,6 +846,7 @@ gst_rist_sink_start (GstRistSink * sink)
         }
         break;
       case GST_RIST_BONDING_METHOD_ROUND_ROBIN:
+      case GST_RIST_BONDING_METHOD_ADAPTIVE:
         sink->dispatcher = gst_element_factory_make ("roundrobin",
             "rist_dispatcher");
         g_assert (sink->dispatcher);
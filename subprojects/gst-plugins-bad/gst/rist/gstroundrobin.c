@@ -27,6 +27,11 @@
  * element, which duplicates buffers over all pads. This element 
  * can be used to distrute load across multiple branches when the buffer
  * can be processed independently.
+ *
+ * Each src pad has a "weight" property. Buffers are distributed in
+ * proportion to the weights using a smooth weighted round robin, so that
+ * consecutive buffers are still spread over the pads rather than sent in
+ * bursts. By default all pads have the same weight.
  */
 
 #include "gstroundrobin.h"
@@ -44,10 +49,109 @@ static GstStaticPadTemplate src_templ = GST_STATIC_PAD_TEMPLATE ("src_%d",
     GST_PAD_REQUEST,
     GST_STATIC_CAPS ("ANY"));
 
+#define DEFAULT_WEIGHT 1
+
+enum
+{
+  PROP_PAD_0,
+  PROP_PAD_WEIGHT,
+};
+
+#define GST_TYPE_ROUND_ROBIN_PAD (gst_round_robin_pad_get_type())
+G_DECLARE_FINAL_TYPE (GstRoundRobinPad, gst_round_robin_pad, GST,
+    ROUND_ROBIN_PAD, GstPad);
+
+struct _GstRoundRobinPad
+{
+  GstPad parent;
+
+  /* protected by the element object lock */
+  guint weight;
+  gint64 current;
+};
+
+G_DEFINE_TYPE (GstRoundRobinPad, gst_round_robin_pad, GST_TYPE_PAD);
+
+static void
+gst_round_robin_pad_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstRoundRobinPad *pad = GST_ROUND_ROBIN_PAD (object);
+  GstObject *parent = gst_object_get_parent (GST_OBJECT (object));
+
+  switch (prop_id) {
+    case PROP_PAD_WEIGHT:
+      if (parent)
+        GST_OBJECT_LOCK (parent);
+      pad->weight = g_value_get_uint (value);
+      if (parent)
+        GST_OBJECT_UNLOCK (parent);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+
+  if (parent)
+    gst_object_unref (parent);
+}
+
+static void
+gst_round_robin_pad_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstRoundRobinPad *pad = GST_ROUND_ROBIN_PAD (object);
+  GstObject *parent = gst_object_get_parent (GST_OBJECT (object));
+
+  switch (prop_id) {
+    case PROP_PAD_WEIGHT:
+      if (parent)
+        GST_OBJECT_LOCK (parent);
+      g_value_set_uint (value, pad->weight);
+      if (parent)
+        GST_OBJECT_UNLOCK (parent);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+
+  if (parent)
+    gst_object_unref (parent);
+}
+
+static void
+gst_round_robin_pad_class_init (GstRoundRobinPadClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->set_property = gst_round_robin_pad_set_property;
+  gobject_class->get_property = gst_round_robin_pad_get_property;
+
+  /**
+   * GstRoundRobinPad:weight:
+   *
+   * Relative share of the buffers sent on this pad. A pad with a weight of
+   * 0 gets no buffers.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PAD_WEIGHT,
+      g_param_spec_uint ("weight", "Weight",
+          "Relative share of the buffers pushed on this pad", 0, G_MAXUINT16,
+          DEFAULT_WEIGHT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+}
+
+static void
+gst_round_robin_pad_init (GstRoundRobinPad * pad)
+{
+  pad->weight = DEFAULT_WEIGHT;
+  pad->current = 0;
+}
+
 struct _GstRoundRobin
 {
   GstElement parent;
-  gint index;
 };
 
 G_DEFINE_TYPE_WITH_CODE (GstRoundRobin, gst_round_robin,
@@ -61,18 +165,32 @@ gst_round_robin_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 {
   GstRoundRobin *disp = (GstRoundRobin *) parent;
   GstElement *elem = (GstElement *) parent;
+  GstRoundRobinPad *best = NULL;
   GstPad *src_pad = NULL;
+  gint64 total = 0;
+  GList *l;
   GstFlowReturn ret;
 
+  /* smooth weighted round robin: every pad gains its weight, the pad with
+   * the most credit is picked and pays for it with the total weight. With
+   * equal weights this is a plain round robin */
   GST_OBJECT_LOCK (disp);
-  if (disp->index >= elem->numsrcpads)
-    disp->index = 0;
+  for (l = elem->srcpads; l; l = l->next) {
+    GstRoundRobinPad *pad = l->data;
+
+    if (pad->weight == 0)
+      continue;
 
-  src_pad = g_list_nth_data (elem->srcpads, disp->index);
+    pad->current += pad->weight;
+    total += pad->weight;
+
+    if (!best || pad->current > best->current)
+      best = pad;
+  }
 
-  if (src_pad) {
-    gst_object_ref (src_pad);
-    disp->index += 1;
+  if (best) {
+    best->current -= total;
+    src_pad = gst_object_ref (GST_PAD (best));
   }
   GST_OBJECT_UNLOCK (disp);
 
@@ -98,7 +216,8 @@ gst_round_robin_request_pad (GstElement * element, GstPadTemplate * templ,
     return NULL;
   }
 
-  pad = gst_pad_new_from_static_template (&src_templ, name);
+  pad = g_object_new (GST_TYPE_ROUND_ROBIN_PAD, "name", name,
+      "direction", GST_PAD_SRC, "template", templ, NULL);
   gst_element_add_pad (element, pad);
 
   return pad;
@@ -130,7 +249,8 @@ gst_round_robin_class_init (GstRoundRobinClass * klass)
       "Nicolas Dufresne <nicolas.dufresne@collabora.com");
 
   gst_element_class_add_static_pad_template (element_class, &sink_templ);
-  gst_element_class_add_static_pad_template (element_class, &src_templ);
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &src_templ, GST_TYPE_ROUND_ROBIN_PAD);
 
   element_class->request_new_pad =
       GST_DEBUG_FUNCPTR (gst_round_robin_request_pad);
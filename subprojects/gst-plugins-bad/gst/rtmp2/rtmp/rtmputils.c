@@ -156,11 +156,15 @@ gst_rtmp_output_stream_write_all_bytes_finish (GOutputStream * stream,
   return g_task_propagate_boolean (G_TASK (result), error);
 }
 
+/* The buffer is written from its memories with a vectored write, so the
+ * chunk headers and the payload memories they reference don't have to be
+ * merged into one contiguous block first */
 typedef struct
 {
   GstBuffer *buffer;
-  GstMapInfo map;
-  gboolean mapped;
+  GstMapInfo *maps;
+  GOutputVector *vectors;
+  guint n_mapped;
   gsize bytes_written;
 } WriteAllBufferData;
 
@@ -168,17 +172,31 @@ static WriteAllBufferData *
 write_all_buffer_data_new (GstBuffer * buffer)
 {
   WriteAllBufferData *data = g_new0 (WriteAllBufferData, 1);
+  guint n_mem = gst_buffer_n_memory (buffer);
+
   data->buffer = gst_buffer_ref (buffer);
+  data->maps = g_new0 (GstMapInfo, n_mem);
+  data->vectors = g_new0 (GOutputVector, n_mem);
   return data;
 }
 
+static void
+write_all_buffer_data_unmap (WriteAllBufferData * data)
+{
+  guint i;
+
+  for (i = 0; i < data->n_mapped; i++)
+    gst_memory_unmap (data->maps[i].memory, &data->maps[i]);
+  data->n_mapped = 0;
+}
+
 static void
 write_all_buffer_data_free (gpointer ptr)
 {
   WriteAllBufferData *data = ptr;
-  if (data->mapped) {
-    gst_buffer_unmap (data->buffer, &data->map);
-  }
+  write_all_buffer_data_unmap (data);
+  g_free (data->maps);
+  g_free (data->vectors);
   g_clear_pointer (&data->buffer, gst_buffer_unref);
   g_free (data);
 }
@@ -190,6 +208,7 @@ gst_rtmp_output_stream_write_all_buffer_async (GOutputStream * stream,
 {
   GTask *task;
   WriteAllBufferData *data;
+  guint i, n_mem;
 
   g_return_if_fail (G_IS_OUTPUT_STREAM (stream));
   g_return_if_fail (GST_IS_BUFFER (buffer));
@@ -199,16 +218,23 @@ gst_rtmp_output_stream_write_all_buffer_async (GOutputStream * stream,
   data = write_all_buffer_data_new (buffer);
   g_task_set_task_data (task, data, write_all_buffer_data_free);
 
-  if (!gst_buffer_map (buffer, &data->map, GST_MAP_READ)) {
-    g_task_return_new_error (task, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_READ,
-        "Failed to map buffer for reading");
-    g_object_unref (task);
-    return;
-  }
+  n_mem = gst_buffer_n_memory (buffer);
+  for (i = 0; i < n_mem; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (buffer, i);
 
-  data->mapped = TRUE;
+    if (!gst_memory_map (mem, &data->maps[i], GST_MAP_READ)) {
+      g_task_return_new_error (task, GST_RESOURCE_ERROR,
+          GST_RESOURCE_ERROR_READ, "Failed to map buffer for reading");
+      g_object_unref (task);
+      return;
+    }
+
+    data->vectors[i].buffer = data->maps[i].data;
+    data->vectors[i].size = data->maps[i].size;
+    data->n_mapped++;
+  }
 
-  g_output_stream_write_all_async (stream, data->map.data, data->map.size,
+  g_output_stream_writev_all_async (stream, data->vectors, n_mem,
       io_priority, cancellable, write_all_buffer_done, task);
 }
 
@@ -222,11 +248,10 @@ write_all_buffer_done (GObject * source, GAsyncResult * result,
   GError *error = NULL;
   gboolean res;
 
-  res = g_output_stream_write_all_finish (os, result, &data->bytes_written,
+  res = g_output_stream_writev_all_finish (os, result, &data->bytes_written,
       &error);
 
-  gst_buffer_unmap (data->buffer, &data->map);
-  data->mapped = FALSE;
+  write_all_buffer_data_unmap (data);
 
   if (!res) {
     g_task_return_error (task, error);
@@ -0,0 +1,767 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-rtpsimulcastenc
+ * @title: rtpsimulcastenc
+ *
+ * Encodes and payloads one raw video stream as several simulcast layers,
+ * one per RTP stream ID (RID). The first layer is encoded at the input
+ * resolution and every following layer at half the resolution of the
+ * previous one.
+ *
+ * Each layer is scaled down from the previous layer instead of from the
+ * full resolution input, so the scaling work is shared between layers.
+ * Layers listed in #GstRtpSimulcastEnc:paused-rids are not scaled (unless
+ * a lower layer still needs them) nor encoded, which allows applications to
+ * stop encoding the layers that the receivers are not interested in, as
+ * signalled by the remote description or by the sender statistics. A
+ * resumed layer restarts with a key frame.
+ *
+ * When #GstRtpSimulcastEnc:rid-extension-id is set, the RID header
+ * extension is added to every payloader so the streams can be linked into
+ * the same `webrtcbin` sink pad.
+ *
+ * ## Example launch line
+ * |[
+ * gst-launch-1.0 videotestsrc ! video/x-raw,width=1280,height=720 ! \
+ *     rtpsimulcastenc name=s rids="<f,h,q>" paused-rids="<q>" \
+ *     s.src_0 ! fakesink  s.src_1 ! fakesink  s.src_2 ! fakesink
+ * ]|
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gst/video/video.h>
+#include <gst/rtp/rtp.h>
+
+#include "gstrtpsimulcastenc.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_rtp_simulcast_enc_debug);
+#define GST_CAT_DEFAULT gst_rtp_simulcast_enc_debug
+
+#define RID_EXTMAP_STR GST_RTP_HDREXT_BASE "sdes:rtp-stream-id"
+
+#define DEFAULT_PROP_ENCODER          "vp8enc"
+#define DEFAULT_PROP_PAYLOADER        "rtpvp8pay"
+#define DEFAULT_PROP_RID_EXT_ID       0
+
+static const gchar *default_rids[] = { "f", "h", "q", NULL };
+
+enum
+{
+  PROP_0,
+  PROP_RIDS,
+  PROP_PAUSED_RIDS,
+  PROP_ENCODER,
+  PROP_PAYLOADER,
+  PROP_RID_EXT_ID,
+};
+
+enum
+{
+  SIGNAL_ENCODER_SETUP,
+  LAST_SIGNAL
+};
+
+static guint gst_rtp_simulcast_enc_signals[LAST_SIGNAL] = { 0 };
+
+typedef struct
+{
+  GstRtpSimulcastEnc *self;
+  guint index;
+  gchar *rid;
+
+  /* scaling from the previous layer, not used for the first layer */
+  GstPad *scale_teepad;
+  GstElement *scale_queue;
+  GstElement *scaler;
+  GstElement *capsfilter;
+
+  GstElement *tee;
+
+  GstPad *enc_teepad;
+  GstElement *enc_queue;
+  GstElement *encoder;
+  GstElement *payloader;
+
+  GstPad *srcpad;
+
+  /* protected by the object lock */
+  gboolean paused;
+  gboolean need_keyframe;
+} SimulcastLayer;
+
+#define gst_rtp_simulcast_enc_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstRtpSimulcastEnc, gst_rtp_simulcast_enc,
+    GST_TYPE_BIN, GST_DEBUG_CATEGORY_INIT (gst_rtp_simulcast_enc_debug,
+        "rtpsimulcastenc", 0, "RTP Simulcast Encoder"));
+GST_ELEMENT_REGISTER_DEFINE (rtpsimulcastenc, "rtpsimulcastenc",
+    GST_RANK_NONE, GST_TYPE_RTP_SIMULCAST_ENC);
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("video/x-raw"));
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_SOMETIMES,
+    GST_STATIC_CAPS_ANY);
+
+static GstStateChangeReturn
+gst_rtp_simulcast_enc_change_state (GstElement * element,
+    GstStateChange transition);
+
+static gchar **
+strv_from_value_array (const GValue * value)
+{
+  guint i, size = gst_value_array_get_size (value);
+  gchar **strv = g_new0 (gchar *, size + 1);
+
+  for (i = 0; i < size; i++)
+    strv[i] = g_value_dup_string (gst_value_array_get_value (value, i));
+
+  return strv;
+}
+
+static void
+strv_to_value_array (gchar ** strv, GValue * value)
+{
+  guint i;
+
+  for (i = 0; strv && strv[i]; i++) {
+    GValue v = G_VALUE_INIT;
+
+    g_value_init (&v, G_TYPE_STRING);
+    g_value_set_string (&v, strv[i]);
+    gst_value_array_append_and_take_value (value, &v);
+  }
+}
+
+/* call with the object lock */
+static void
+gst_rtp_simulcast_enc_update_paused (GstRtpSimulcastEnc * self)
+{
+  guint i;
+
+  if (!self->layers)
+    return;
+
+  for (i = 0; i < self->layers->len; i++) {
+    SimulcastLayer *layer = g_ptr_array_index (self->layers, i);
+    gboolean paused = self->paused_rids &&
+        g_strv_contains ((const gchar * const *) self->paused_rids,
+        layer->rid);
+
+    if (paused == layer->paused)
+      continue;
+
+    GST_INFO_OBJECT (self, "%s layer %s", paused ? "Pausing" : "Resuming",
+        layer->rid);
+
+    /* the encoder skipped frames, restart the stream with a key frame */
+    if (!paused)
+      layer->need_keyframe = TRUE;
+    layer->paused = paused;
+  }
+}
+
+static void
+gst_rtp_simulcast_enc_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstRtpSimulcastEnc *self = GST_RTP_SIMULCAST_ENC (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_RIDS:
+      g_strfreev (self->rids);
+      self->rids = strv_from_value_array (value);
+      break;
+    case PROP_PAUSED_RIDS:
+      g_strfreev (self->paused_rids);
+      self->paused_rids = strv_from_value_array (value);
+      gst_rtp_simulcast_enc_update_paused (self);
+      break;
+    case PROP_ENCODER:
+      g_free (self->encoder);
+      self->encoder = g_value_dup_string (value);
+      break;
+    case PROP_PAYLOADER:
+      g_free (self->payloader);
+      self->payloader = g_value_dup_string (value);
+      break;
+    case PROP_RID_EXT_ID:
+      self->rid_ext_id = g_value_get_uint (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gst_rtp_simulcast_enc_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstRtpSimulcastEnc *self = GST_RTP_SIMULCAST_ENC (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_RIDS:
+      strv_to_value_array (self->rids, value);
+      break;
+    case PROP_PAUSED_RIDS:
+      strv_to_value_array (self->paused_rids, value);
+      break;
+    case PROP_ENCODER:
+      g_value_set_string (value, self->encoder);
+      break;
+    case PROP_PAYLOADER:
+      g_value_set_string (value, self->payloader);
+      break;
+    case PROP_RID_EXT_ID:
+      g_value_set_uint (value, self->rid_ext_id);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gst_rtp_simulcast_enc_finalize (GObject * object)
+{
+  GstRtpSimulcastEnc *self = GST_RTP_SIMULCAST_ENC (object);
+
+  g_strfreev (self->rids);
+  g_strfreev (self->paused_rids);
+  g_free (self->encoder);
+  g_free (self->payloader);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_rtp_simulcast_enc_class_init (GstRtpSimulcastEncClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *gstelement_class = GST_ELEMENT_CLASS (klass);
+
+  gobject_class->set_property = gst_rtp_simulcast_enc_set_property;
+  gobject_class->get_property = gst_rtp_simulcast_enc_get_property;
+  gobject_class->finalize = gst_rtp_simulcast_enc_finalize;
+  gstelement_class->change_state = gst_rtp_simulcast_enc_change_state;
+
+  /**
+   * GstRtpSimulcastEnc:rids:
+   *
+   * The RTP stream IDs of the layers, from the highest to the lowest
+   * resolution. Each layer has half the width and height of the previous
+   * one.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_RIDS,
+      gst_param_spec_array ("rids", "RIDs",
+          "The RTP stream IDs of the layers, highest resolution first",
+          g_param_spec_string ("rid", "RID", "RTP stream ID", NULL,
+              G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS),
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstRtpSimulcastEnc:paused-rids:
+   *
+   * The RTP stream IDs of the layers that are currently not scaled nor
+   * encoded. Can be changed at any time, resumed layers start with a key
+   * frame.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PAUSED_RIDS,
+      gst_param_spec_array ("paused-rids", "Paused RIDs",
+          "The RTP stream IDs of the layers that are not encoded",
+          g_param_spec_string ("rid", "RID", "RTP stream ID", NULL,
+              G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS),
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
+
+  /**
+   * GstRtpSimulcastEnc:encoder:
+   *
+   * The factory name of the encoder created for each layer.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_ENCODER,
+      g_param_spec_string ("encoder", "Encoder",
+          "The factory name of the encoder created for each layer",
+          DEFAULT_PROP_ENCODER, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstRtpSimulcastEnc:payloader:
+   *
+   * The factory name of the payloader created for each layer, or %NULL
+   * to output the encoded streams.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PAYLOADER,
+      g_param_spec_string ("payloader", "Payloader",
+          "The factory name of the payloader created for each layer, "
+          "NULL to not payload", DEFAULT_PROP_PAYLOADER,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstRtpSimulcastEnc:rid-extension-id:
+   *
+   * The header extension ID used for the RTP stream ID extension added to
+   * the payloaders, 0 to not add the extension.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_RID_EXT_ID,
+      g_param_spec_uint ("rid-extension-id", "RID Extension ID",
+          "The RTP stream ID header extension ID, 0 to disable",
+          0, 255,
+          DEFAULT_PROP_RID_EXT_ID, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
+  /**
+   * GstRtpSimulcastEnc::encoder-setup:
+   * @self: the #GstRtpSimulcastEnc
+   * @rid: the RTP stream ID of the layer
+   * @encoder: the encoder of the layer
+   * @payloader: (nullable): the payloader of the layer
+   *
+   * Emitted when the elements of a layer were created, for example to
+   * configure the bitrate of the encoder.
+   *
+   * Since: 1.24
+   */
+  gst_rtp_simulcast_enc_signals[SIGNAL_ENCODER_SETUP] =
+      g_signal_new ("encoder-setup", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, NULL, NULL, NULL, G_TYPE_NONE, 3, G_TYPE_STRING,
+      GST_TYPE_ELEMENT, GST_TYPE_ELEMENT);
+
+  gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
+  gst_element_class_add_static_pad_template (gstelement_class, &src_template);
+
+  gst_element_class_set_static_metadata (gstelement_class,
+      "RTP Simulcast Encoder",
+      "Codec/Encoder/Video/Bin",
+      "Encodes a video stream in several resolutions for simulcast",
+      "GStreamer maintainers <gstreamer-devel@lists.freedesktop.org>");
+}
+
+static void
+gst_rtp_simulcast_enc_init (GstRtpSimulcastEnc * self)
+{
+  self->rids = g_strdupv ((gchar **) default_rids);
+  self->encoder = g_strdup (DEFAULT_PROP_ENCODER);
+  self->payloader = g_strdup (DEFAULT_PROP_PAYLOADER);
+  self->rid_ext_id = DEFAULT_PROP_RID_EXT_ID;
+
+  self->sinkpad = gst_ghost_pad_new_no_target_from_template ("sink",
+      gst_static_pad_template_get (&sink_template));
+  gst_element_add_pad (GST_ELEMENT (self), self->sinkpad);
+}
+
+static GstElement *
+gst_rtp_simulcast_enc_make_element (GstRtpSimulcastEnc * self,
+    const gchar * factory)
+{
+  GstElement *element = gst_element_factory_make (factory, NULL);
+
+  if (!element) {
+    GST_ELEMENT_ERROR (self, CORE, MISSING_PLUGIN, (NULL),
+        ("Missing element '%s'", factory));
+    return NULL;
+  }
+
+  gst_bin_add (GST_BIN (self), element);
+
+  return element;
+}
+
+static GstPadProbeReturn
+gst_rtp_simulcast_enc_caps_probe (GstPad * pad, GstPadProbeInfo * info,
+    GstRtpSimulcastEnc * self)
+{
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+  GstCaps *caps;
+  GstStructure *s;
+  gint width, height;
+  guint i;
+
+  if (GST_EVENT_TYPE (event) != GST_EVENT_CAPS)
+    return GST_PAD_PROBE_OK;
+
+  gst_event_parse_caps (event, &caps);
+  s = gst_caps_get_structure (caps, 0);
+  if (!gst_structure_get_int (s, "width", &width) ||
+      !gst_structure_get_int (s, "height", &height))
+    return GST_PAD_PROBE_OK;
+
+  /* the caps event reaches the capsfilters after this, through the queues */
+  for (i = 1; i < self->layers->len; i++) {
+    SimulcastLayer *layer = g_ptr_array_index (self->layers, i);
+    GstCaps *layer_caps = gst_caps_copy (caps);
+
+    gst_caps_set_simple (layer_caps,
+        "width", G_TYPE_INT, MAX (GST_ROUND_DOWN_2 (width >> i), 2),
+        "height", G_TYPE_INT, MAX (GST_ROUND_DOWN_2 (height >> i), 2), NULL);
+
+    GST_DEBUG_OBJECT (self, "Layer %s caps %" GST_PTR_FORMAT, layer->rid,
+        layer_caps);
+    g_object_set (layer->capsfilter, "caps", layer_caps, NULL);
+    gst_caps_unref (layer_caps);
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+/* drops the input of a scaler when this and all lower layers are paused */
+static GstPadProbeReturn
+gst_rtp_simulcast_enc_scale_probe (GstPad * pad, GstPadProbeInfo * info,
+    SimulcastLayer * layer)
+{
+  GstRtpSimulcastEnc *self = layer->self;
+  gboolean drop = TRUE;
+  guint i;
+
+  GST_OBJECT_LOCK (self);
+  for (i = layer->index; i < self->layers->len && drop; i++) {
+    SimulcastLayer *l = g_ptr_array_index (self->layers, i);
+
+    drop = l->paused;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  return drop ? GST_PAD_PROBE_DROP : GST_PAD_PROBE_OK;
+}
+
+static GstPadProbeReturn
+gst_rtp_simulcast_enc_encode_probe (GstPad * pad, GstPadProbeInfo * info,
+    SimulcastLayer * layer)
+{
+  GstRtpSimulcastEnc *self = layer->self;
+  gboolean need_keyframe;
+  GstBuffer *buffer;
+
+  GST_OBJECT_LOCK (self);
+  if (layer->paused) {
+    GST_OBJECT_UNLOCK (self);
+    return GST_PAD_PROBE_DROP;
+  }
+  need_keyframe = layer->need_keyframe;
+  layer->need_keyframe = FALSE;
+  GST_OBJECT_UNLOCK (self);
+
+  if (need_keyframe) {
+    if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER_LIST)
+      buffer = gst_buffer_list_get (GST_PAD_PROBE_INFO_BUFFER_LIST (info), 0);
+    else
+      buffer = GST_PAD_PROBE_INFO_BUFFER (info);
+
+    GST_DEBUG_OBJECT (self, "Requesting key frame for layer %s", layer->rid);
+    gst_pad_push_event (pad,
+        gst_video_event_new_downstream_force_key_unit (GST_BUFFER_PTS (buffer),
+            GST_CLOCK_TIME_NONE, GST_CLOCK_TIME_NONE, TRUE, 0));
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+static gboolean
+gst_rtp_simulcast_enc_add_rid_extension (GstRtpSimulcastEnc * self,
+    SimulcastLayer * layer, guint ext_id)
+{
+  GstRTPHeaderExtension *ext;
+
+  ext = gst_rtp_header_extension_create_from_uri (RID_EXTMAP_STR);
+  if (!ext) {
+    GST_ELEMENT_ERROR (self, CORE, MISSING_PLUGIN, (NULL),
+        ("No RTP header extension for '%s'", RID_EXTMAP_STR));
+    return FALSE;
+  }
+
+  gst_rtp_header_extension_set_id (ext, ext_id);
+  g_object_set (ext, "rid", layer->rid, NULL);
+  g_signal_emit_by_name (layer->payloader, "add-extension", ext);
+  gst_object_unref (ext);
+
+  return TRUE;
+}
+
+static void
+gst_rtp_simulcast_enc_free_layer (GstRtpSimulcastEnc * self,
+    SimulcastLayer * layer)
+{
+  GstElement *elements[] = { layer->scale_queue, layer->scaler,
+    layer->capsfilter, layer->tee, layer->enc_queue, layer->encoder,
+    layer->payloader
+  };
+  guint i;
+
+  if (layer->srcpad)
+    gst_element_remove_pad (GST_ELEMENT (self), layer->srcpad);
+
+  if (layer->scale_teepad) {
+    gst_element_release_request_pad (GST_PAD_PARENT (layer->scale_teepad),
+        layer->scale_teepad);
+    gst_object_unref (layer->scale_teepad);
+  }
+
+  if (layer->enc_teepad) {
+    gst_element_release_request_pad (layer->tee, layer->enc_teepad);
+    gst_object_unref (layer->enc_teepad);
+  }
+
+  for (i = 0; i < G_N_ELEMENTS (elements); i++) {
+    if (elements[i]) {
+      gst_element_set_state (elements[i], GST_STATE_NULL);
+      gst_bin_remove (GST_BIN (self), elements[i]);
+    }
+  }
+
+  g_free (layer->rid);
+  g_free (layer);
+}
+
+static void
+gst_rtp_simulcast_enc_teardown (GstRtpSimulcastEnc * self)
+{
+  GPtrArray *layers;
+
+  GST_OBJECT_LOCK (self);
+  layers = self->layers;
+  self->layers = NULL;
+  GST_OBJECT_UNLOCK (self);
+
+  if (!layers)
+    return;
+
+  gst_ghost_pad_set_target (GST_GHOST_PAD (self->sinkpad), NULL);
+
+  /* lower layers first, their scalers are linked to the upper tees */
+  while (layers->len > 0)
+    gst_rtp_simulcast_enc_free_layer (self,
+        g_ptr_array_remove_index (layers, layers->len - 1));
+
+  g_ptr_array_unref (layers);
+}
+
+static gboolean
+gst_rtp_simulcast_enc_build (GstRtpSimulcastEnc * self)
+{
+  GPtrArray *layers = NULL;
+  gchar **rids, *encoder, *payloader;
+  guint rid_ext_id, i;
+  GstPad *pad;
+  SimulcastLayer *prev = NULL;
+  gboolean ret = FALSE;
+
+  GST_OBJECT_LOCK (self);
+  rids = g_strdupv (self->rids);
+  encoder = g_strdup (self->encoder);
+  payloader = g_strdup (self->payloader);
+  rid_ext_id = self->rid_ext_id;
+  GST_OBJECT_UNLOCK (self);
+
+  if (!rids || !rids[0]) {
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION, (NULL), ("No layers set"));
+    goto done;
+  }
+
+  if (!encoder) {
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION, (NULL), ("No encoder set"));
+    goto done;
+  }
+
+  layers = g_ptr_array_new ();
+
+  for (i = 0; rids[i]; i++) {
+    SimulcastLayer *layer = g_new0 (SimulcastLayer, 1);
+    GstElement *last;
+    gchar *name;
+
+    layer->self = self;
+    layer->index = i;
+    layer->rid = g_strdup (rids[i]);
+    g_ptr_array_add (layers, layer);
+
+    if (prev) {
+      if (!(layer->scale_queue =
+              gst_rtp_simulcast_enc_make_element (self, "queue")) ||
+          !(layer->scaler =
+              gst_rtp_simulcast_enc_make_element (self, "videoscale")) ||
+          !(layer->capsfilter =
+              gst_rtp_simulcast_enc_make_element (self, "capsfilter")))
+        goto error;
+    }
+
+    if (!(layer->tee = gst_rtp_simulcast_enc_make_element (self, "tee")) ||
+        !(layer->enc_queue =
+            gst_rtp_simulcast_enc_make_element (self, "queue")) ||
+        !(layer->encoder =
+            gst_rtp_simulcast_enc_make_element (self, encoder)))
+      goto error;
+
+    if (payloader && *payloader &&
+        !(layer->payloader =
+            gst_rtp_simulcast_enc_make_element (self, payloader)))
+      goto error;
+
+    g_object_set (layer->tee, "allow-not-linked", TRUE, NULL);
+
+    if (prev) {
+      gst_element_link_many (layer->scale_queue, layer->scaler,
+          layer->capsfilter, layer->tee, NULL);
+
+      layer->scale_teepad = gst_element_request_pad_simple (prev->tee,
+          "src_%u");
+      pad = gst_element_get_static_pad (layer->scale_queue, "sink");
+      gst_pad_link (layer->scale_teepad, pad);
+      gst_object_unref (pad);
+
+      gst_pad_add_probe (layer->scale_teepad,
+          GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+          (GstPadProbeCallback) gst_rtp_simulcast_enc_scale_probe, layer,
+          NULL);
+    } else {
+      pad = gst_element_get_static_pad (layer->tee, "sink");
+      gst_ghost_pad_set_target (GST_GHOST_PAD (self->sinkpad), pad);
+      gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+          (GstPadProbeCallback) gst_rtp_simulcast_enc_caps_probe, self, NULL);
+      gst_object_unref (pad);
+    }
+
+    gst_element_link (layer->enc_queue, layer->encoder);
+    last = layer->encoder;
+    if (layer->payloader) {
+      gst_element_link (layer->encoder, layer->payloader);
+      last = layer->payloader;
+
+      if (rid_ext_id &&
+          !gst_rtp_simulcast_enc_add_rid_extension (self, layer, rid_ext_id))
+        goto error;
+    }
+
+    layer->enc_teepad = gst_element_request_pad_simple (layer->tee, "src_%u");
+    pad = gst_element_get_static_pad (layer->enc_queue, "sink");
+    gst_pad_link (layer->enc_teepad, pad);
+    gst_object_unref (pad);
+
+    gst_pad_add_probe (layer->enc_teepad,
+        GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST,
+        (GstPadProbeCallback) gst_rtp_simulcast_enc_encode_probe, layer, NULL);
+
+    g_signal_emit (self, gst_rtp_simulcast_enc_signals[SIGNAL_ENCODER_SETUP],
+        0, layer->rid, layer->encoder, layer->payloader);
+
+    name = g_strdup_printf ("src_%u", i);
+    pad = gst_element_get_static_pad (last, "src");
+    layer->srcpad = gst_ghost_pad_new_from_template (name, pad,
+        gst_static_pad_template_get (&src_template));
+    gst_object_unref (pad);
+    g_free (name);
+
+    prev = layer;
+  }
+
+  GST_OBJECT_LOCK (self);
+  self->layers = layers;
+  gst_rtp_simulcast_enc_update_paused (self);
+  GST_OBJECT_UNLOCK (self);
+
+  for (i = 0; i < layers->len; i++) {
+    SimulcastLayer *layer = g_ptr_array_index (layers, i);
+
+    gst_element_add_pad (GST_ELEMENT (self), layer->srcpad);
+  }
+  gst_element_no_more_pads (GST_ELEMENT (self));
+
+  ret = TRUE;
+
+done:
+  g_strfreev (rids);
+  g_free (encoder);
+  g_free (payloader);
+
+  return ret;
+
+error:
+  gst_ghost_pad_set_target (GST_GHOST_PAD (self->sinkpad), NULL);
+  while (layers->len > 0) {
+    SimulcastLayer *layer = g_ptr_array_remove_index (layers, layers->len - 1);
+
+    /* not added to the element yet */
+    if (layer->srcpad) {
+      gst_object_unref (gst_object_ref_sink (layer->srcpad));
+      layer->srcpad = NULL;
+    }
+    gst_rtp_simulcast_enc_free_layer (self, layer);
+  }
+  g_ptr_array_unref (layers);
+  goto done;
+}
+
+static GstStateChangeReturn
+gst_rtp_simulcast_enc_change_state (GstElement * element,
+    GstStateChange transition)
+{
+  GstRtpSimulcastEnc *self = GST_RTP_SIMULCAST_ENC (element);
+  GstStateChangeReturn ret;
+
+  switch (transition) {
+    case GST_STATE_CHANGE_NULL_TO_READY:
+      if (!gst_rtp_simulcast_enc_build (self))
+        return GST_STATE_CHANGE_FAILURE;
+      break;
+    default:
+      break;
+  }
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+  if (ret == GST_STATE_CHANGE_FAILURE) {
+    if (transition == GST_STATE_CHANGE_NULL_TO_READY)
+      gst_rtp_simulcast_enc_teardown (self);
+    return ret;
+  }
+
+  switch (transition) {
+    case GST_STATE_CHANGE_READY_TO_NULL:
+      gst_rtp_simulcast_enc_teardown (self);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
+}
@@ -0,0 +1,68 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_RTP_SIMULCAST_ENC_H__
+#define __GST_RTP_SIMULCAST_ENC_H__
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+#define GST_TYPE_RTP_SIMULCAST_ENC \
+  (gst_rtp_simulcast_enc_get_type())
+#define GST_RTP_SIMULCAST_ENC(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_RTP_SIMULCAST_ENC, GstRtpSimulcastEnc))
+#define GST_RTP_SIMULCAST_ENC_CAST(obj) \
+  ((GstRtpSimulcastEnc *) obj)
+#define GST_RTP_SIMULCAST_ENC_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_RTP_SIMULCAST_ENC, GstRtpSimulcastEncClass))
+#define GST_IS_RTP_SIMULCAST_ENC(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_RTP_SIMULCAST_ENC))
+#define GST_IS_RTP_SIMULCAST_ENC_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_RTP_SIMULCAST_ENC))
+
+typedef struct _GstRtpSimulcastEnc GstRtpSimulcastEnc;
+typedef struct _GstRtpSimulcastEncClass GstRtpSimulcastEncClass;
+
+struct _GstRtpSimulcastEnc
+{
+  GstBin parent;
+
+  /* Properties, protected by the object lock */
+  gchar **rids;
+  gchar **paused_rids;
+  gchar *encoder;
+  gchar *payloader;
+  guint rid_ext_id;
+
+  GstPad *sinkpad;
+
+  /* SimulcastLayer, highest resolution first. Only built in READY and
+   * above, the paused field of each layer is protected by the object lock */
+  GPtrArray *layers;
+};
+
+struct _GstRtpSimulcastEncClass
+{
+  GstBinClass parent;
+};
+
+GType gst_rtp_simulcast_enc_get_type (void);
+GST_ELEMENT_REGISTER_DECLARE (rtpsimulcastenc);
+
+G_END_DECLS
+#endif /* __GST_RTP_SIMULCAST_ENC_H__ */
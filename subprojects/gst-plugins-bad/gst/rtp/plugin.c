@@ -2,6 +2,7 @@
 #include "config.h"
 #endif
 
+#include "gstrtpsimulcastenc.h"
 #include "gstrtpsink.h"
 #include "gstrtpsrc.h"
 
@@ -13,6 +14,7 @@ plugin_init (GstPlugin * plugin)
 
   ret |= GST_ELEMENT_REGISTER (rtpsrc, plugin);
   ret |= GST_ELEMENT_REGISTER (rtpsink, plugin);
+  ret |= GST_ELEMENT_REGISTER (rtpsimulcastenc, plugin);
 
   return ret;
 }
@@ -175,6 +175,47 @@ filter_handles_any (GstElement * filter)
   return gst_element_get_pad_template_list (filter) != NULL;
 }
 
+/* Fields of raw caps restrictions that parsers also expose on encoded
+ * streams */
+static const gchar *passthrough_restriction_fields[] = {
+  "width", "height", "framerate", "pixel-aspect-ratio", "interlace-mode",
+  "rate", "channels", NULL
+};
+
+/* The encoded caps a stream can have to be passed through instead of being
+ * re-encoded with @profile: its format, restricted by the parts of the
+ * restriction caps of @profile that can be checked on encoded data, so that
+ * for example a stream with the right codec, profile and level but the
+ * wrong resolution still gets re-encoded. Returns %NULL if the restrictions
+ * can't be checked on encoded data. */
+static GstCaps *
+get_passthrough_caps (GstEncodingProfile * profile, GstCaps * restrictions)
+{
+  GstCaps *caps = gst_encoding_profile_get_format (profile);
+  const GstStructure *restriction;
+  guint i;
+
+  if (!restrictions || gst_caps_is_empty (restrictions))
+    return caps;
+
+  if (gst_caps_get_size (restrictions) != 1) {
+    gst_caps_unref (caps);
+    return NULL;
+  }
+
+  restriction = gst_caps_get_structure (restrictions, 0);
+  caps = gst_caps_make_writable (caps);
+  for (i = 0; passthrough_restriction_fields[i]; i++) {
+    const gchar *field = passthrough_restriction_fields[i];
+    const GValue *value = gst_structure_get_value (restriction, field);
+
+    if (value)
+      gst_caps_set_value (caps, field, value);
+  }
+
+  return caps;
+}
+
 static GstPad *
 _insert_filter (GstTranscodeBin * self, GstPad * sinkpad, GstPad * pad,
     const GstCaps * filtercaps)
@@ -684,14 +725,18 @@ _setup_avoid_reencoding (GstTranscodeBin * self)
 
     restrictions = gst_encoding_profile_get_restriction (profile);
 
-    if (restrictions) {
-      gboolean is_any = gst_caps_is_any (restrictions);
+    if (restrictions && gst_caps_is_any (restrictions)) {
       gst_caps_unref (restrictions);
-      if (is_any)
-        continue;
+      continue;
     }
 
-    encodecaps = gst_encoding_profile_get_format (profile);
+    encodecaps = get_passthrough_caps (profile, restrictions);
+    gst_clear_caps (&restrictions);
+    if (!encodecaps) {
+      GST_DEBUG_OBJECT (self, "Can't check the restrictions of %"
+          GST_PTR_FORMAT " on encoded streams, always re-encoding", profile);
+      continue;
+    }
     filter = NULL;
 
     /* Filter operates on raw data so don't allow decodebin to produce
@@ -706,6 +751,8 @@ _setup_avoid_reencoding (GstTranscodeBin * self)
       GST_DEBUG_OBJECT (self,
           "adding %" GST_PTR_FORMAT " as output caps to decodebin", encodecaps);
       gst_caps_append (decodecaps, encodecaps);
+    } else {
+      gst_caps_unref (encodecaps);
     }
   }
 
@@ -1031,6 +1078,12 @@ gst_transcode_bin_class_init (GstTranscodeBinClass * klass)
    * GstTranscodeBin:avoid-reencoding:
    *
    * See #encodebin:avoid-reencoding
+   *
+   * Input streams are only passed through when they match the format of
+   * their stream profile (codec, profile, level...) and the parts of its
+   * restriction caps that can be checked without decoding: resolution,
+   * framerate, pixel aspect ratio and interlacing for video, sample rate and
+   * channels for audio.
    */
   g_object_class_install_property (object_class, PROP_AVOID_REENCODING,
       g_param_spec_boolean ("avoid-reencoding", "Avoid re-encoding",
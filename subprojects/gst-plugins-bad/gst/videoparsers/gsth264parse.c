@@ -241,6 +241,7 @@ gst_h264_parse_reset_frame (GstH264Parse * h264parse)
   h264parse->have_pps_in_frame = FALSE;
   h264parse->have_aud_in_frame = FALSE;
   gst_adapter_clear (h264parse->frame_out);
+  h264parse->frame_out_n_mem = 0;
 }
 
 static void
@@ -322,6 +323,8 @@ gst_h264_parse_start (GstBaseParse * parse)
   gst_h264_parse_reset (h264parse);
 
   h264parse->nalparser = gst_h264_nal_parser_new ();
+  h264parse->sei_messages =
+      g_array_new (FALSE, FALSE, sizeof (GstH264SEIMessage));
 
   h264parse->state = 0;
   h264parse->dts = GST_CLOCK_TIME_NONE;
@@ -346,6 +349,7 @@ gst_h264_parse_stop (GstBaseParse * parse)
   gst_h264_parse_reset (h264parse);
 
   gst_h264_nal_parser_free (h264parse->nalparser);
+  g_clear_pointer (&h264parse->sei_messages, g_array_unref);
 
   return TRUE;
 }
@@ -505,6 +509,35 @@ gst_h264_parse_wrap_nal (GstH264Parse * h264parse, guint format, guint8 * data,
   return buf;
 }
 
+/* Like gst_h264_parse_wrap_nal(), but the NAL is not copied: the returned
+ * buffer holds a small memory with the start code or length prefix followed
+ * by the memory of @src */
+static GstBuffer *
+gst_h264_parse_wrap_nal_buffer (GstH264Parse * h264parse, guint format,
+    GstBuffer * src, guint offset, guint size)
+{
+  GstBuffer *buf;
+  guint nl = h264parse->nal_length_size;
+  guint32 tmp;
+
+  GST_DEBUG_OBJECT (h264parse, "nal length %d", size);
+
+  if (format == GST_H264_PARSE_FORMAT_AVC
+      || format == GST_H264_PARSE_FORMAT_AVC3) {
+    tmp = GUINT32_TO_BE (size << (32 - 8 * nl));
+  } else {
+    /* see gst_h264_parse_wrap_nal() */
+    nl = 4;
+    tmp = GUINT32_TO_BE (1);
+  }
+
+  buf = gst_buffer_new_allocate (NULL, nl, NULL);
+  gst_buffer_fill (buf, 0, &tmp, nl);
+  gst_buffer_copy_into (buf, src, GST_BUFFER_COPY_MEMORY, offset, size);
+
+  return buf;
+}
+
 static void
 gst_h264_parser_store_nal (GstH264Parse * h264parse, guint id,
     GstH264NalUnitType naltype, GstH264NalUnit * nalu)
@@ -629,10 +662,10 @@ gst_h264_parse_process_sei (GstH264Parse * h264parse, GstH264NalUnit * nalu)
   GstH264SEIMessage sei;
   GstH264NalParser *nalparser = h264parse->nalparser;
   GstH264ParserResult pres;
-  GArray *messages;
+  GArray *messages = h264parse->sei_messages;
   guint i;
 
-  pres = gst_h264_parser_parse_sei (nalparser, nalu, &messages);
+  pres = gst_h264_parser_parse_sei_into (nalparser, nalu, messages);
   if (pres != GST_H264_PARSER_OK)
     GST_WARNING_OBJECT (h264parse, "failed to parse one or more SEI message");
 
@@ -944,7 +977,7 @@ gst_h264_parse_process_sei (GstH264Parse * h264parse, GstH264NalUnit * nalu)
       }
     }
   }
-  g_array_free (messages, TRUE);
+  g_array_set_size (messages, 0);
 }
 
 /* caller guarantees 2 bytes of nal payload */
@@ -1171,8 +1204,14 @@ gst_h264_parse_process_nal (GstH264Parse * h264parse, GstH264NalUnit * nalu)
     GstBuffer *buf;
 
     GST_LOG_OBJECT (h264parse, "collecting NAL in AVC frame");
-    buf = gst_h264_parse_wrap_nal (h264parse, h264parse->format,
-        nalu->data + nalu->offset, nalu->size);
+    if (h264parse->nal_buffer && nalu->data == h264parse->nal_buffer_data) {
+      buf = gst_h264_parse_wrap_nal_buffer (h264parse, h264parse->format,
+          h264parse->nal_buffer, nalu->offset, nalu->size);
+    } else {
+      buf = gst_h264_parse_wrap_nal (h264parse, h264parse->format,
+          nalu->data + nalu->offset, nalu->size);
+    }
+    h264parse->frame_out_n_mem += gst_buffer_n_memory (buf);
     gst_adapter_push (h264parse->frame_out, buf);
   }
   return TRUE;
@@ -1245,6 +1284,8 @@ gst_h264_parse_handle_frame_packetized (GstBaseParse * parse,
     buffer = gst_buffer_copy (frame->buffer);
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
+  h264parse->nal_buffer = buffer;
+  h264parse->nal_buffer_data = map.data;
 
   left = map.size;
 
@@ -1299,6 +1340,7 @@ gst_h264_parse_handle_frame_packetized (GstBaseParse * parse,
         map.data, nalu.offset + nalu.size, map.size, nl, &nalu);
   }
 
+  h264parse->nal_buffer = NULL;
   gst_buffer_unmap (buffer, &map);
 
   if (!h264parse->split_packetized) {
@@ -1370,6 +1412,9 @@ gst_h264_parse_handle_frame (GstBaseParse * parse,
     return GST_FLOW_OK;
   }
 
+  h264parse->nal_buffer = buffer;
+  h264parse->nal_buffer_data = data;
+
   /* need to configure aggregation */
   if (G_UNLIKELY (h264parse->format == GST_H264_PARSE_FORMAT_NONE))
     gst_h264_parse_negotiate (h264parse, GST_H264_PARSE_FORMAT_BYTE, NULL);
@@ -1578,6 +1623,7 @@ gst_h264_parse_handle_frame (GstBaseParse * parse,
 end:
   framesize = nalu.offset + nalu.size;
 
+  h264parse->nal_buffer = NULL;
   gst_buffer_unmap (buffer, &map);
 
   gst_h264_parse_parse_frame (parse, frame);
@@ -1593,6 +1639,7 @@ more:
 
   /* Fall-through. */
 out:
+  h264parse->nal_buffer = NULL;
   gst_buffer_unmap (buffer, &map);
   return GST_FLOW_OK;
 
@@ -1608,6 +1655,7 @@ skip:
   goto out;
 
 invalid_stream:
+  h264parse->nal_buffer = NULL;
   gst_buffer_unmap (buffer, &map);
   return GST_FLOW_ERROR;
 }
@@ -2725,7 +2773,17 @@ gst_h264_parse_parse_frame (GstBaseParse * parse, GstBaseParseFrame * frame)
   if (av) {
     GstBuffer *buf;
 
-    buf = gst_adapter_take_buffer (h264parse->frame_out, av);
+    /* keep the memories of the collected NALs instead of merging them.
+     * With more than GST_BUFFER_MEM_MAX memories the buffer would merge them
+     * again every time it fills up while they are added, so copy the AU
+     * once like before. Downstream elements that map the whole AU pay for
+     * the merge on every map instead, which is still cheaper than the copy
+     * for the usual few NALs per AU. */
+    if (h264parse->frame_out_n_mem <= GST_BUFFER_MEM_MAX)
+      buf = gst_adapter_take_buffer_fast (h264parse->frame_out, av);
+    else
+      buf = gst_adapter_take_buffer (h264parse->frame_out, av);
+    h264parse->frame_out_n_mem = 0;
     gst_buffer_copy_into (buf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
     gst_buffer_replace (&frame->out_buffer, buf);
     gst_buffer_unref (buf);
@@ -2889,35 +2947,56 @@ gst_h264_parse_handle_sps_pps_nals (GstH264Parse * h264parse,
     }
   } else {
     /* insert config NALs into AU */
-    GstByteWriter bw;
     GstBuffer *new_buf;
-    const gboolean bs = h264parse->format == GST_H264_PARSE_FORMAT_BYTE;
-    const gint nls = 4 - h264parse->nal_length_size;
-    gboolean ok;
+    GstBuffer *nals[GST_H264_MAX_SPS_COUNT + GST_H264_MAX_PPS_COUNT];
+    guint n_nals = 0, n_mem;
 
-    gst_byte_writer_init_with_size (&bw, gst_buffer_get_size (buffer), FALSE);
-    ok = gst_byte_writer_put_buffer (&bw, buffer, 0, h264parse->idr_pos);
+    /* the AU is split at idr_pos and each NAL adds its prefix */
+    n_mem = gst_buffer_n_memory (buffer) + 1;
     GST_DEBUG_OBJECT (h264parse, "- inserting SPS/PPS");
     for (i = 0; i < GST_H264_MAX_SPS_COUNT; i++) {
       if ((codec_nal = h264parse->sps_nals[i])) {
-        gsize nal_size = gst_buffer_get_size (codec_nal);
         GST_DEBUG_OBJECT (h264parse, "inserting SPS nal");
-        if (bs) {
-          ok &= gst_byte_writer_put_uint32_be (&bw, 1);
-        } else {
-          ok &= gst_byte_writer_put_uint32_be (&bw, (nal_size << (nls * 8)));
-          ok &= gst_byte_writer_set_pos (&bw,
-              gst_byte_writer_get_pos (&bw) - nls);
-        }
-
-        ok &= gst_byte_writer_put_buffer (&bw, codec_nal, 0, nal_size);
+        nals[n_nals++] = codec_nal;
+        n_mem += 1 + gst_buffer_n_memory (codec_nal);
         send_done = TRUE;
       }
     }
     for (i = 0; i < GST_H264_MAX_PPS_COUNT; i++) {
       if ((codec_nal = h264parse->pps_nals[i])) {
-        gsize nal_size = gst_buffer_get_size (codec_nal);
         GST_DEBUG_OBJECT (h264parse, "inserting PPS nal");
+        nals[n_nals++] = codec_nal;
+        n_mem += 1 + gst_buffer_n_memory (codec_nal);
+        send_done = TRUE;
+      }
+    }
+
+    if (n_mem <= GST_BUFFER_MEM_MAX) {
+      /* reference the existing memory of the AU and of the stored NALs */
+      new_buf = gst_buffer_new ();
+      if (h264parse->idr_pos > 0)
+        gst_buffer_copy_into (new_buf, buffer, GST_BUFFER_COPY_MEMORY, 0,
+            h264parse->idr_pos);
+      for (i = 0; i < n_nals; i++) {
+        new_buf = gst_buffer_append (new_buf,
+            gst_h264_parse_wrap_nal_buffer (h264parse, h264parse->format,
+                nals[i], 0, gst_buffer_get_size (nals[i])));
+      }
+      gst_buffer_copy_into (new_buf, buffer, GST_BUFFER_COPY_MEMORY,
+          h264parse->idr_pos, -1);
+    } else {
+      /* more memories than a buffer can hold, copy everything once */
+      GstByteWriter bw;
+      const gboolean bs = h264parse->format == GST_H264_PARSE_FORMAT_BYTE;
+      const gint nls = 4 - h264parse->nal_length_size;
+      gboolean ok;
+
+      gst_byte_writer_init_with_size (&bw, gst_buffer_get_size (buffer),
+          FALSE);
+      ok = gst_byte_writer_put_buffer (&bw, buffer, 0, h264parse->idr_pos);
+      for (i = 0; i < n_nals; i++) {
+        gsize nal_size = gst_buffer_get_size (nals[i]);
+
         if (bs) {
           ok &= gst_byte_writer_put_uint32_be (&bw, 1);
         } else {
@@ -2925,23 +3004,22 @@ gst_h264_parse_handle_sps_pps_nals (GstH264Parse * h264parse,
           ok &= gst_byte_writer_set_pos (&bw,
               gst_byte_writer_get_pos (&bw) - nls);
         }
-        ok &= gst_byte_writer_put_buffer (&bw, codec_nal, 0, nal_size);
-        send_done = TRUE;
+        ok &= gst_byte_writer_put_buffer (&bw, nals[i], 0, nal_size);
+      }
+      ok &= gst_byte_writer_put_buffer (&bw, buffer, h264parse->idr_pos, -1);
+      new_buf = gst_byte_writer_reset_and_get_buffer (&bw);
+      /* some result checking seems to make some compilers happy */
+      if (G_UNLIKELY (!ok)) {
+        GST_ERROR_OBJECT (h264parse, "failed to insert SPS/PPS");
       }
     }
-    ok &= gst_byte_writer_put_buffer (&bw, buffer, h264parse->idr_pos, -1);
     /* collect result and push */
-    new_buf = gst_byte_writer_reset_and_get_buffer (&bw);
     gst_buffer_copy_into (new_buf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
     /* should already be keyframe/IDR, but it may not have been,
      * so mark it as such to avoid being discarded by picky decoder */
     GST_BUFFER_FLAG_UNSET (new_buf, GST_BUFFER_FLAG_DELTA_UNIT);
     gst_buffer_replace (&frame->out_buffer, new_buf);
     gst_buffer_unref (new_buf);
-    /* some result checking seems to make some compilers happy */
-    if (G_UNLIKELY (!ok)) {
-      GST_ERROR_OBJECT (h264parse, "failed to insert SPS/PPS");
-    }
   }
 
   return send_done;
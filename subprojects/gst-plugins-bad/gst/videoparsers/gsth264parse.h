@@ -73,6 +73,8 @@ struct _GstH264Parse
 
   /* state */
   GstH264NalParser *nalparser;
+  /* reused for each SEI */
+  GArray *sei_messages;
   guint state;
   guint in_align;
   guint align;
@@ -136,6 +138,12 @@ struct _GstH264Parse
   gint pic_timing_sei_size;
   gboolean update_caps;
   GstAdapter *frame_out;
+  /* input buffer the NALs being processed point into, so that the
+   * transformed output can reference its memory instead of copying */
+  GstBuffer *nal_buffer;
+  const guint8 *nal_buffer_data;
+  /* number of memories collected in frame_out */
+  guint frame_out_n_mem;
   gboolean keyframe;
   gboolean predicted;
   gboolean bidirectional;
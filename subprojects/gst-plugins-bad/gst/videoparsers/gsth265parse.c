@@ -203,6 +203,7 @@ gst_h265_parse_reset_frame (GstH265Parse * h265parse)
   h265parse->have_sps_in_frame = FALSE;
   h265parse->have_pps_in_frame = FALSE;
   gst_adapter_clear (h265parse->frame_out);
+  h265parse->frame_out_n_mem = 0;
 }
 
 static void
@@ -278,6 +279,8 @@ gst_h265_parse_start (GstBaseParse * parse)
   gst_h265_parse_reset (h265parse);
 
   h265parse->nalparser = gst_h265_parser_new ();
+  h265parse->sei_messages =
+      g_array_new (FALSE, FALSE, sizeof (GstH265SEIMessage));
   h265parse->state = 0;
 
   gst_base_parse_set_min_frame_size (parse, 5);
@@ -294,6 +297,7 @@ gst_h265_parse_stop (GstBaseParse * parse)
   gst_h265_parse_reset (h265parse);
 
   gst_h265_parser_free (h265parse->nalparser);
+  g_clear_pointer (&h265parse->sei_messages, g_array_unref);
 
   return TRUE;
 }
@@ -450,6 +454,35 @@ gst_h265_parse_wrap_nal (GstH265Parse * h265parse, guint format, guint8 * data,
   return buf;
 }
 
+/* Like gst_h265_parse_wrap_nal(), but the NAL is not copied: the returned
+ * buffer holds a small memory with the start code or length prefix followed
+ * by the memory of @src */
+static GstBuffer *
+gst_h265_parse_wrap_nal_buffer (GstH265Parse * h265parse, guint format,
+    GstBuffer * src, guint offset, guint size)
+{
+  GstBuffer *buf;
+  guint nl = h265parse->nal_length_size;
+  guint32 tmp;
+
+  GST_DEBUG_OBJECT (h265parse, "nal length %d", size);
+
+  if (format == GST_H265_PARSE_FORMAT_HVC1
+      || format == GST_H265_PARSE_FORMAT_HEV1) {
+    tmp = GUINT32_TO_BE (size << (32 - 8 * nl));
+  } else {
+    /* see gst_h265_parse_wrap_nal() */
+    nl = 4;
+    tmp = GUINT32_TO_BE (1);
+  }
+
+  buf = gst_buffer_new_allocate (NULL, nl, NULL);
+  gst_buffer_fill (buf, 0, &tmp, nl);
+  gst_buffer_copy_into (buf, src, GST_BUFFER_COPY_MEMORY, offset, size);
+
+  return buf;
+}
+
 static void
 gst_h265_parser_store_nal (GstH265Parse * h265parse, guint id,
     GstH265NalUnitType naltype, GstH265NalUnit * nalu)
@@ -550,10 +583,10 @@ gst_h265_parse_process_sei (GstH265Parse * h265parse, GstH265NalUnit * nalu)
   GstH265SEIMessage sei;
   GstH265Parser *nalparser = h265parse->nalparser;
   GstH265ParserResult pres;
-  GArray *messages;
+  GArray *messages = h265parse->sei_messages;
   guint i;
 
-  pres = gst_h265_parser_parse_sei (nalparser, nalu, &messages);
+  pres = gst_h265_parser_parse_sei_into (nalparser, nalu, messages);
   if (pres != GST_H265_PARSER_OK)
     GST_WARNING_OBJECT (h265parse, "failed to parse one or more SEI message");
 
@@ -673,7 +706,7 @@ gst_h265_parse_process_sei (GstH265Parse * h265parse, GstH265NalUnit * nalu)
         break;
     }
   }
-  g_array_free (messages, TRUE);
+  g_array_set_size (messages, 0);
 }
 
 static void
@@ -968,8 +1001,14 @@ gst_h265_parse_process_nal (GstH265Parse * h265parse, GstH265NalUnit * nalu)
     GstBuffer *buf;
 
     GST_LOG_OBJECT (h265parse, "collecting NAL in HEVC frame");
-    buf = gst_h265_parse_wrap_nal (h265parse, h265parse->format,
-        nalu->data + nalu->offset, nalu->size);
+    if (h265parse->nal_buffer && nalu->data == h265parse->nal_buffer_data) {
+      buf = gst_h265_parse_wrap_nal_buffer (h265parse, h265parse->format,
+          h265parse->nal_buffer, nalu->offset, nalu->size);
+    } else {
+      buf = gst_h265_parse_wrap_nal (h265parse, h265parse->format,
+          nalu->data + nalu->offset, nalu->size);
+    }
+    h265parse->frame_out_n_mem += gst_buffer_n_memory (buf);
     gst_adapter_push (h265parse->frame_out, buf);
   }
 
@@ -1036,6 +1075,8 @@ gst_h265_parse_handle_frame_packetized (GstBaseParse * parse,
     buffer = gst_buffer_copy (frame->buffer);
 
   gst_buffer_map (buffer, &map, GST_MAP_READ);
+  h265parse->nal_buffer = buffer;
+  h265parse->nal_buffer_data = map.data;
 
   left = map.size;
 
@@ -1085,6 +1126,7 @@ gst_h265_parse_handle_frame_packetized (GstBaseParse * parse,
         map.data, nalu.offset + nalu.size, map.size, nl, &nalu);
   }
 
+  h265parse->nal_buffer = NULL;
   gst_buffer_unmap (buffer, &map);
 
   if (!h265parse->split_packetized) {
@@ -1156,6 +1198,9 @@ gst_h265_parse_handle_frame (GstBaseParse * parse,
     return GST_FLOW_OK;
   }
 
+  h265parse->nal_buffer = buffer;
+  h265parse->nal_buffer_data = data;
+
   /* need to configure aggregation */
   if (G_UNLIKELY (h265parse->format == GST_H265_PARSE_FORMAT_NONE))
     gst_h265_parse_negotiate (h265parse, GST_H265_PARSE_FORMAT_BYTE, NULL);
@@ -1354,6 +1399,7 @@ gst_h265_parse_handle_frame (GstBaseParse * parse,
 end:
   framesize = nalu.offset + nalu.size;
 
+  h265parse->nal_buffer = NULL;
   gst_buffer_unmap (buffer, &map);
 
   gst_h265_parse_parse_frame (parse, frame);
@@ -1369,6 +1415,7 @@ more:
 
   /* Fall-through. */
 out:
+  h265parse->nal_buffer = NULL;
   gst_buffer_unmap (buffer, &map);
   return GST_FLOW_OK;
 
@@ -1384,6 +1431,7 @@ skip:
   goto out;
 
 invalid_stream:
+  h265parse->nal_buffer = NULL;
   gst_buffer_unmap (buffer, &map);
   return GST_FLOW_ERROR;
 }
@@ -2566,7 +2614,17 @@ gst_h265_parse_parse_frame (GstBaseParse * parse, GstBaseParseFrame * frame)
   if (av) {
     GstBuffer *buf;
 
-    buf = gst_adapter_take_buffer (h265parse->frame_out, av);
+    /* keep the memories of the collected NALs instead of merging them.
+     * With more than GST_BUFFER_MEM_MAX memories the buffer would merge them
+     * again every time it fills up while they are added, so copy the AU
+     * once like before. Downstream elements that map the whole AU pay for
+     * the merge on every map instead, which is still cheaper than the copy
+     * for the usual few NALs per AU. */
+    if (h265parse->frame_out_n_mem <= GST_BUFFER_MEM_MAX)
+      buf = gst_adapter_take_buffer_fast (h265parse->frame_out, av);
+    else
+      buf = gst_adapter_take_buffer (h265parse->frame_out, av);
+    h265parse->frame_out_n_mem = 0;
     gst_buffer_copy_into (buf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
     gst_buffer_replace (&frame->out_buffer, buf);
     gst_buffer_unref (buf);
@@ -2749,51 +2807,65 @@ gst_h265_parse_handle_vps_sps_pps_nals (GstH265Parse * h265parse,
     }
   } else {
     /* insert config NALs into AU */
-    GstByteWriter bw;
     GstBuffer *new_buf;
-    const gboolean bs = h265parse->format == GST_H265_PARSE_FORMAT_BYTE;
-    const gint nls = 4 - h265parse->nal_length_size;
-    gboolean ok;
+    GstBuffer *nals[GST_H265_MAX_VPS_COUNT + GST_H265_MAX_SPS_COUNT +
+        GST_H265_MAX_PPS_COUNT];
+    guint n_nals = 0, n_mem;
 
-    gst_byte_writer_init_with_size (&bw, gst_buffer_get_size (buffer), FALSE);
-    ok = gst_byte_writer_put_buffer (&bw, buffer, 0, h265parse->idr_pos);
+    /* the AU is split at idr_pos and each NAL adds its prefix */
+    n_mem = gst_buffer_n_memory (buffer) + 1;
     GST_DEBUG_OBJECT (h265parse, "- inserting VPS/SPS/PPS");
     for (i = 0; i < GST_H265_MAX_VPS_COUNT; i++) {
       if ((codec_nal = h265parse->vps_nals[i])) {
-        gsize nal_size = gst_buffer_get_size (codec_nal);
         GST_DEBUG_OBJECT (h265parse, "inserting VPS nal");
-        if (bs) {
-          ok &= gst_byte_writer_put_uint32_be (&bw, 1);
-        } else {
-          ok &= gst_byte_writer_put_uint32_be (&bw, (nal_size << (nls * 8)));
-          ok &= gst_byte_writer_set_pos (&bw,
-              gst_byte_writer_get_pos (&bw) - nls);
-        }
-
-        ok &= gst_byte_writer_put_buffer (&bw, codec_nal, 0, nal_size);
+        nals[n_nals++] = codec_nal;
+        n_mem += 1 + gst_buffer_n_memory (codec_nal);
         send_done = TRUE;
       }
     }
     for (i = 0; i < GST_H265_MAX_SPS_COUNT; i++) {
       if ((codec_nal = h265parse->sps_nals[i])) {
-        gsize nal_size = gst_buffer_get_size (codec_nal);
         GST_DEBUG_OBJECT (h265parse, "inserting SPS nal");
-        if (bs) {
-          ok &= gst_byte_writer_put_uint32_be (&bw, 1);
-        } else {
-          ok &= gst_byte_writer_put_uint32_be (&bw, (nal_size << (nls * 8)));
-          ok &= gst_byte_writer_set_pos (&bw,
-              gst_byte_writer_get_pos (&bw) - nls);
-        }
-
-        ok &= gst_byte_writer_put_buffer (&bw, codec_nal, 0, nal_size);
+        nals[n_nals++] = codec_nal;
+        n_mem += 1 + gst_buffer_n_memory (codec_nal);
         send_done = TRUE;
       }
     }
     for (i = 0; i < GST_H265_MAX_PPS_COUNT; i++) {
       if ((codec_nal = h265parse->pps_nals[i])) {
-        gsize nal_size = gst_buffer_get_size (codec_nal);
         GST_DEBUG_OBJECT (h265parse, "inserting PPS nal");
+        nals[n_nals++] = codec_nal;
+        n_mem += 1 + gst_buffer_n_memory (codec_nal);
+        send_done = TRUE;
+      }
+    }
+
+    if (n_mem <= GST_BUFFER_MEM_MAX) {
+      /* reference the existing memory of the AU and of the stored NALs */
+      new_buf = gst_buffer_new ();
+      if (h265parse->idr_pos > 0)
+        gst_buffer_copy_into (new_buf, buffer, GST_BUFFER_COPY_MEMORY, 0,
+            h265parse->idr_pos);
+      for (i = 0; i < n_nals; i++) {
+        new_buf = gst_buffer_append (new_buf,
+            gst_h265_parse_wrap_nal_buffer (h265parse, h265parse->format,
+                nals[i], 0, gst_buffer_get_size (nals[i])));
+      }
+      gst_buffer_copy_into (new_buf, buffer, GST_BUFFER_COPY_MEMORY,
+          h265parse->idr_pos, -1);
+    } else {
+      /* more memories than a buffer can hold, copy everything once */
+      GstByteWriter bw;
+      const gboolean bs = h265parse->format == GST_H265_PARSE_FORMAT_BYTE;
+      const gint nls = 4 - h265parse->nal_length_size;
+      gboolean ok;
+
+      gst_byte_writer_init_with_size (&bw, gst_buffer_get_size (buffer),
+          FALSE);
+      ok = gst_byte_writer_put_buffer (&bw, buffer, 0, h265parse->idr_pos);
+      for (i = 0; i < n_nals; i++) {
+        gsize nal_size = gst_buffer_get_size (nals[i]);
+
         if (bs) {
           ok &= gst_byte_writer_put_uint32_be (&bw, 1);
         } else {
@@ -2801,23 +2873,22 @@ gst_h265_parse_handle_vps_sps_pps_nals (GstH265Parse * h265parse,
           ok &= gst_byte_writer_set_pos (&bw,
               gst_byte_writer_get_pos (&bw) - nls);
         }
-        ok &= gst_byte_writer_put_buffer (&bw, codec_nal, 0, nal_size);
-        send_done = TRUE;
+        ok &= gst_byte_writer_put_buffer (&bw, nals[i], 0, nal_size);
+      }
+      ok &= gst_byte_writer_put_buffer (&bw, buffer, h265parse->idr_pos, -1);
+      new_buf = gst_byte_writer_reset_and_get_buffer (&bw);
+      /* some result checking seems to make some compilers happy */
+      if (G_UNLIKELY (!ok)) {
+        GST_ERROR_OBJECT (h265parse, "failed to insert SPS/PPS");
       }
     }
-    ok &= gst_byte_writer_put_buffer (&bw, buffer, h265parse->idr_pos, -1);
     /* collect result and push */
-    new_buf = gst_byte_writer_reset_and_get_buffer (&bw);
     gst_buffer_copy_into (new_buf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
     /* should already be keyframe/IDR, but it may not have been,
      * so mark it as such to avoid being discarded by picky decoder */
     GST_BUFFER_FLAG_UNSET (new_buf, GST_BUFFER_FLAG_DELTA_UNIT);
     gst_buffer_replace (&frame->out_buffer, new_buf);
     gst_buffer_unref (new_buf);
-    /* some result checking seems to make some compilers happy */
-    if (G_UNLIKELY (!ok)) {
-      GST_ERROR_OBJECT (h265parse, "failed to insert SPS/PPS");
-    }
   }
 
   return send_done;
@@ -67,6 +67,8 @@ struct _GstH265Parse
 
   /* state */
   GstH265Parser *nalparser;
+  /* reused for each SEI */
+  GArray *sei_messages;
   guint in_align;
   guint state;
   guint align;
@@ -106,6 +108,12 @@ struct _GstH265Parse
   gint idr_pos, sei_pos;
   gboolean update_caps;
   GstAdapter *frame_out;
+  /* input buffer the NALs being processed point into, so that the
+   * transformed output can reference its memory instead of copying */
+  GstBuffer *nal_buffer;
+  const guint8 *nal_buffer_data;
+  /* number of memories collected in frame_out */
+  guint frame_out_n_mem;
   gboolean keyframe;
   gboolean predicted;
   gboolean bidirectional;
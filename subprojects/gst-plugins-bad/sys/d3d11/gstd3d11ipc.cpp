@@ -0,0 +1,240 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd3d11ipc.h"
+#include <string.h>
+
+const gchar *
+gst_d3d11_ipc_pkt_type_to_string (GstD3D11IpcPktType type)
+{
+  switch (type) {
+    case GST_D3D11_IPC_PKT_NEED_DATA:
+      return "NEED-DATA";
+    case GST_D3D11_IPC_PKT_HAVE_DATA:
+      return "HAVE-DATA";
+    case GST_D3D11_IPC_PKT_READ_DONE:
+      return "READ-DONE";
+    case GST_D3D11_IPC_PKT_RELEASE_DATA:
+      return "RELEASE-DATA";
+    default:
+      break;
+  }
+
+  return "Unknown";
+}
+
+GstD3D11IpcPktType
+gst_d3d11_ipc_pkt_type_from_raw (guint8 type)
+{
+  return (GstD3D11IpcPktType) type;
+}
+
+static guint32
+gst_d3d11_ipc_pkt_build_seq_num_only (guint8 * pkt, guint32 pkt_size,
+    GstD3D11IpcPktType type, guint64 seq_num)
+{
+  if (!pkt || pkt_size < 1 + sizeof (guint64))
+    return 0;
+
+  pkt[0] = (guint8) type;
+  GST_WRITE_UINT64_LE (pkt + 1, seq_num);
+
+  return 1 + sizeof (guint64);
+}
+
+/* Appends a nul terminated string. Returns the number of written bytes
+ * or zero if it doesn't fit */
+static guint32
+gst_d3d11_ipc_pkt_write_string (guint8 * data, guint32 remaining,
+    const gchar * str)
+{
+  gsize len;
+
+  if (!str)
+    return 0;
+
+  len = strlen (str);
+  if (len == 0 || len + 1 > remaining)
+    return 0;
+
+  memcpy (data, str, len + 1);
+
+  return (guint32) len + 1;
+}
+
+static guint32
+gst_d3d11_ipc_pkt_read_string (const guint8 * data, guint32 remaining,
+    gchar ** str)
+{
+  gsize len;
+
+  len = strnlen ((const gchar *) data, remaining);
+  /* Must be nul terminated and non-empty */
+  if (len == 0 || len == remaining)
+    return 0;
+
+  *str = g_strndup ((const gchar *) data, len);
+
+  return (guint32) len + 1;
+}
+
+guint32
+gst_d3d11_ipc_pkt_build_need_data (guint8 * pkt, guint32 pkt_size,
+    guint64 seq_num)
+{
+  return gst_d3d11_ipc_pkt_build_seq_num_only (pkt, pkt_size,
+      GST_D3D11_IPC_PKT_NEED_DATA, seq_num);
+}
+
+gboolean
+gst_d3d11_ipc_pkt_parse_need_data (const guint8 * pkt, guint32 pkt_size,
+    guint64 * seq_num)
+{
+  if (!pkt || pkt_size < GST_D3D11_IPC_PKT_NEED_DATA_SIZE)
+    return FALSE;
+
+  if (gst_d3d11_ipc_pkt_type_from_raw (pkt[0]) != GST_D3D11_IPC_PKT_NEED_DATA)
+    return FALSE;
+
+  *seq_num = GST_READ_UINT64_LE (pkt + 1);
+
+  return TRUE;
+}
+
+guint32
+gst_d3d11_ipc_pkt_build_have_data (guint8 * pkt, guint32 pkt_size,
+    guint64 seq_num, gint64 adapter_luid, const gchar * name,
+    const gchar * caps)
+{
+  guint32 offset = GST_D3D11_IPC_PKT_HAVE_DATA_SIZE;
+  guint32 written;
+
+  if (!pkt || pkt_size < GST_D3D11_IPC_PKT_HAVE_DATA_SIZE)
+    return 0;
+
+  pkt[0] = (guint8) GST_D3D11_IPC_PKT_HAVE_DATA;
+  GST_WRITE_UINT64_LE (pkt + 1, seq_num);
+  GST_WRITE_UINT64_LE (pkt + 9, (guint64) adapter_luid);
+
+  written = gst_d3d11_ipc_pkt_write_string (pkt + offset,
+      pkt_size - offset, name);
+  if (!written)
+    return 0;
+  offset += written;
+
+  written = gst_d3d11_ipc_pkt_write_string (pkt + offset,
+      pkt_size - offset, caps);
+  if (!written)
+    return 0;
+  offset += written;
+
+  return offset;
+}
+
+gboolean
+gst_d3d11_ipc_pkt_parse_have_data (const guint8 * pkt, guint32 pkt_size,
+    guint64 * seq_num, gint64 * adapter_luid, gchar ** name, gchar ** caps)
+{
+  guint32 offset = GST_D3D11_IPC_PKT_HAVE_DATA_SIZE;
+  guint32 read;
+
+  if (!pkt || pkt_size <= GST_D3D11_IPC_PKT_HAVE_DATA_SIZE)
+    return FALSE;
+
+  if (gst_d3d11_ipc_pkt_type_from_raw (pkt[0]) != GST_D3D11_IPC_PKT_HAVE_DATA)
+    return FALSE;
+
+  *seq_num = GST_READ_UINT64_LE (pkt + 1);
+  *adapter_luid = (gint64) GST_READ_UINT64_LE (pkt + 9);
+
+  read = gst_d3d11_ipc_pkt_read_string (pkt + offset, pkt_size - offset, name);
+  if (!read)
+    return FALSE;
+  offset += read;
+
+  read = gst_d3d11_ipc_pkt_read_string (pkt + offset, pkt_size - offset, caps);
+  if (!read) {
+    g_clear_pointer (name, g_free);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+guint32
+gst_d3d11_ipc_pkt_build_read_done (guint8 * pkt, guint32 pkt_size,
+    guint64 seq_num)
+{
+  return gst_d3d11_ipc_pkt_build_seq_num_only (pkt, pkt_size,
+      GST_D3D11_IPC_PKT_READ_DONE, seq_num);
+}
+
+guint32
+gst_d3d11_ipc_pkt_build_release_data (guint8 * pkt, guint32 pkt_size,
+    guint64 seq_num, const gchar * name)
+{
+  guint32 offset;
+  guint32 written;
+
+  offset = gst_d3d11_ipc_pkt_build_seq_num_only (pkt, pkt_size,
+      GST_D3D11_IPC_PKT_RELEASE_DATA, seq_num);
+  if (!offset)
+    return 0;
+
+  written = gst_d3d11_ipc_pkt_write_string (pkt + offset,
+      pkt_size - offset, name);
+  if (!written)
+    return 0;
+
+  return offset + written;
+}
+
+gboolean
+gst_d3d11_ipc_pkt_parse_release_data (const guint8 * pkt, guint32 pkt_size,
+    guint64 * seq_num, gchar ** name)
+{
+  guint32 offset = 1 + sizeof (guint64);
+
+  if (!pkt || pkt_size <= offset)
+    return FALSE;
+
+  if (gst_d3d11_ipc_pkt_type_from_raw (pkt[0]) !=
+      GST_D3D11_IPC_PKT_RELEASE_DATA) {
+    return FALSE;
+  }
+
+  *seq_num = GST_READ_UINT64_LE (pkt + 1);
+
+  return gst_d3d11_ipc_pkt_read_string (pkt + offset,
+      pkt_size - offset, name) != 0;
+}
+
+/* Creates process-wide unique name for a shared texture */
+gchar *
+gst_d3d11_ipc_get_texture_name (void)
+{
+  static gint index = 0;
+
+  return g_strdup_printf ("Local\\gst.d3d11.ipc.%lu.%d",
+      (gulong) GetCurrentProcessId (), g_atomic_int_add (&index, 1));
+}
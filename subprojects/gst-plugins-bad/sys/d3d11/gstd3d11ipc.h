@@ -0,0 +1,125 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <gst/gst.h>
+#include <windows.h>
+
+G_BEGIN_DECLS
+
+/*
+ * Communication Sequence
+ *
+ *            +--------+                      +--------+
+ *            | client |                      | server |
+ *            +--------+                      +--------+
+ *                |                               |
+ *                +--------- NEED-DATA ---------->|
+ *                |                               +-------+
+ *                |                               |  copy frame into
+ *                |                               |  shared texture
+ *                |                               +<------+
+ *                +<-- HAVE-DATA (w/ tex name) ---|
+ *       +--------+                               |
+ *   Open shared  |                               |
+ *  texture, copy |                               |
+ *       +------->+                               |
+ *                |--------- READ-DONE ---------->|
+ *                |------- RELEASE-DATA --------->|
+ *
+ * Textures are created with D3D11_RESOURCE_MISC_SHARED_NTHANDLE and
+ * D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX flags, and both peers access them
+ * only while holding the keyed mutex with key zero, which orders GPU work
+ * across processes without any CPU round trip.
+ */
+
+typedef enum
+{
+  GST_D3D11_IPC_PKT_UNKNOWN,
+  GST_D3D11_IPC_PKT_NEED_DATA,
+  GST_D3D11_IPC_PKT_HAVE_DATA,
+  GST_D3D11_IPC_PKT_READ_DONE,
+  GST_D3D11_IPC_PKT_RELEASE_DATA,
+} GstD3D11IpcPktType;
+
+/* Formats which are backed by a single DXGI texture */
+#define GST_D3D11_IPC_FORMATS \
+    "{ RGBA64_LE, RGB10A2_LE, BGRA, RGBA, BGRx, RGBx, VUYA, NV12, " \
+    "P010_10LE, P016_LE }"
+
+#define GST_D3D11_IPC_DEFAULT_PIPE_NAME "\\\\.\\pipe\\gst.d3d11.ipc"
+
+#define GST_D3D11_IPC_PKT_MAX_SIZE 2048
+
+#define GST_D3D11_IPC_KEYED_MUTEX_KEY 0
+
+/* 1 byte (type) + 8 byte (seq-num) */
+#define GST_D3D11_IPC_PKT_NEED_DATA_SIZE 9
+
+/* 1 byte (type) + 8 byte (seq-num) + 8 byte (adapter LUID) +
+ * N bytes (texture name) + M bytes (caps string) */
+#define GST_D3D11_IPC_PKT_HAVE_DATA_SIZE 17
+
+/* 1 byte (type) + 8 byte (seq-num) */
+#define GST_D3D11_IPC_PKT_READ_DONE_SIZE 9
+
+const gchar *      gst_d3d11_ipc_pkt_type_to_string  (GstD3D11IpcPktType type);
+
+GstD3D11IpcPktType gst_d3d11_ipc_pkt_type_from_raw   (guint8 type);
+
+guint32            gst_d3d11_ipc_pkt_build_need_data (guint8 * pkt,
+                                                      guint32 pkt_size,
+                                                      guint64 seq_num);
+
+gboolean           gst_d3d11_ipc_pkt_parse_need_data (const guint8 * pkt,
+                                                      guint32 pkt_size,
+                                                      guint64 * seq_num);
+
+guint32            gst_d3d11_ipc_pkt_build_have_data (guint8 * pkt,
+                                                      guint32 pkt_size,
+                                                      guint64 seq_num,
+                                                      gint64 adapter_luid,
+                                                      const gchar * name,
+                                                      const gchar * caps);
+
+gboolean           gst_d3d11_ipc_pkt_parse_have_data (const guint8 * pkt,
+                                                      guint32 pkt_size,
+                                                      guint64 * seq_num,
+                                                      gint64 * adapter_luid,
+                                                      gchar ** name,
+                                                      gchar ** caps);
+
+guint32            gst_d3d11_ipc_pkt_build_read_done (guint8 * pkt,
+                                                      guint32 pkt_size,
+                                                      guint64 seq_num);
+
+guint32            gst_d3d11_ipc_pkt_build_release_data (guint8 * pkt,
+                                                         guint32 pkt_size,
+                                                         guint64 seq_num,
+                                                         const gchar * name);
+
+gboolean           gst_d3d11_ipc_pkt_parse_release_data (const guint8 * pkt,
+                                                         guint32 pkt_size,
+                                                         guint64 * seq_num,
+                                                         gchar ** name);
+
+gchar *            gst_d3d11_ipc_get_texture_name (void);
+
+G_END_DECLS
@@ -0,0 +1,449 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd3d11ipcclient.h"
+#include "gstd3d11ipc.h"
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <thread>
+#include <queue>
+#include <string>
+
+GST_DEBUG_CATEGORY_EXTERN (gst_d3d11_ipc_debug);
+#define GST_CAT_DEFAULT gst_d3d11_ipc_debug
+
+/* *INDENT-OFF* */
+struct GstD3D11IpcClientData
+{
+  gint64 adapter_luid;
+  std::string name;
+  std::string caps;
+};
+
+struct GstD3D11IpcClientConn : public OVERLAPPED
+{
+  GstD3D11IpcClientConn ()
+  {
+    OVERLAPPED *parent = static_cast<OVERLAPPED *> (this);
+    parent->Internal = 0;
+    parent->InternalHigh = 0;
+    parent->Offset = 0;
+    parent->OffsetHigh = 0;
+  }
+
+  GstD3D11IpcClient *self = nullptr;
+  HANDLE pipe = INVALID_HANDLE_VALUE;
+  guint8 client_msg[GST_D3D11_IPC_PKT_MAX_SIZE];
+  guint8 server_msg[GST_D3D11_IPC_PKT_MAX_SIZE];
+  guint32 to_write = 0;
+  UINT64 seq_num = 0;
+};
+
+struct _GstD3D11IpcClient
+{
+  explicit _GstD3D11IpcClient (const std::string & n) : name (n)
+  {
+    release_event = CreateEventA (nullptr, FALSE, FALSE, nullptr);
+    cancellable = CreateEventA (nullptr, TRUE, FALSE, nullptr);
+    conn.self = this;
+  }
+
+  ~_GstD3D11IpcClient ()
+  {
+    GST_DEBUG ("Free client %p", this);
+    SetEvent (cancellable);
+    if (thread) {
+      thread->join ();
+      thread = nullptr;
+    }
+
+    CloseHandle (release_event);
+    CloseHandle (cancellable);
+  }
+
+  std::mutex lock;
+  std::condition_variable cond;
+  std::unique_ptr<std::thread> thread;
+  std::queue<GstD3D11IpcClientData> queue;
+  std::queue<std::string> unused_data;
+  std::string name;
+
+  HANDLE release_event;
+  HANDLE cancellable;
+  DWORD last_err = ERROR_SUCCESS;
+  BOOL flushing = FALSE;
+  BOOL io_pending = FALSE;
+  GstD3D11IpcClientConn conn;
+};
+/* *INDENT-ON* */
+
+static DWORD
+gst_d3d11_ipc_client_send_need_data_async (GstD3D11IpcClient * self);
+static DWORD
+gst_d3d11_ipc_client_send_release_data_async (GstD3D11IpcClient * self,
+    const gchar * name);
+
+static void
+gst_d3d11_ipc_client_log_error (const gchar * what, DWORD error_code)
+{
+  gchar *msg = g_win32_error_message (error_code);
+  GST_WARNING ("%s failed with 0x%x (%s)", what, (guint) error_code,
+      GST_STR_NULL (msg));
+  g_free (msg);
+}
+
+static DWORD
+gst_d3d11_ipc_client_write_async (GstD3D11IpcClient * self,
+    LPOVERLAPPED_COMPLETION_ROUTINE routine)
+{
+  GstD3D11IpcClientConn *conn = &self->conn;
+
+  if (conn->to_write == 0) {
+    GST_ERROR ("Couldn't build pkt");
+    return ERROR_BAD_FORMAT;
+  }
+
+  GST_TRACE ("Sending %s", gst_d3d11_ipc_pkt_type_to_string
+      (gst_d3d11_ipc_pkt_type_from_raw (conn->client_msg[0])));
+
+  if (!WriteFileEx (conn->pipe, conn->client_msg, conn->to_write,
+          (OVERLAPPED *) conn, routine)) {
+    DWORD last_err = GetLastError ();
+    gst_d3d11_ipc_client_log_error ("WriteFileEx", last_err);
+    return last_err;
+  }
+
+  return ERROR_SUCCESS;
+}
+
+static void WINAPI
+gst_d3d11_ipc_client_send_finish (DWORD error_code, DWORD n_bytes,
+    LPOVERLAPPED overlapped)
+{
+  GstD3D11IpcClientConn *conn = (GstD3D11IpcClientConn *) overlapped;
+  GstD3D11IpcClient *self = conn->self;
+  std::string unused_data;
+
+  if (error_code != ERROR_SUCCESS) {
+    self->last_err = error_code;
+    gst_d3d11_ipc_client_log_error ("WriteFileEx", error_code);
+    goto error;
+  }
+
+  self->lock.lock ();
+  if (!self->unused_data.empty ()) {
+    unused_data = self->unused_data.front ();
+    self->unused_data.pop ();
+  }
+  self->lock.unlock ();
+
+  if (!unused_data.empty ()) {
+    self->last_err = gst_d3d11_ipc_client_send_release_data_async (self,
+        unused_data.c_str ());
+    if (self->last_err != ERROR_SUCCESS)
+      goto error;
+
+    return;
+  }
+
+  self->last_err = gst_d3d11_ipc_client_send_need_data_async (self);
+  if (self->last_err != ERROR_SUCCESS)
+    goto error;
+
+  return;
+
+error:
+  SetEvent (self->cancellable);
+}
+
+static DWORD
+gst_d3d11_ipc_client_send_release_data_async (GstD3D11IpcClient * self,
+    const gchar * name)
+{
+  GstD3D11IpcClientConn *conn = &self->conn;
+
+  conn->to_write = gst_d3d11_ipc_pkt_build_release_data (conn->client_msg,
+      sizeof (conn->client_msg), conn->seq_num, name);
+
+  return gst_d3d11_ipc_client_write_async (self,
+      gst_d3d11_ipc_client_send_finish);
+}
+
+static DWORD
+gst_d3d11_ipc_client_send_read_done_async (GstD3D11IpcClient * self)
+{
+  GstD3D11IpcClientConn *conn = &self->conn;
+
+  conn->to_write = gst_d3d11_ipc_pkt_build_read_done (conn->client_msg,
+      sizeof (conn->client_msg), conn->seq_num);
+
+  return gst_d3d11_ipc_client_write_async (self,
+      gst_d3d11_ipc_client_send_finish);
+}
+
+static void WINAPI
+gst_d3d11_ipc_client_receive_have_data_finish (DWORD error_code,
+    DWORD n_bytes, LPOVERLAPPED overlapped)
+{
+  GstD3D11IpcClientConn *conn = (GstD3D11IpcClientConn *) overlapped;
+  GstD3D11IpcClient *self = conn->self;
+  GstD3D11IpcClientData data;
+  gchar *name = nullptr;
+  gchar *caps = nullptr;
+
+  if (error_code != ERROR_SUCCESS) {
+    self->last_err = error_code;
+    gst_d3d11_ipc_client_log_error ("HAVE-DATA", error_code);
+    goto error;
+  }
+
+  if (!gst_d3d11_ipc_pkt_parse_have_data (conn->server_msg, n_bytes,
+          &conn->seq_num, &data.adapter_luid, &name, &caps)) {
+    self->last_err = ERROR_BAD_FORMAT;
+    GST_WARNING ("Couldn't parse HAVE-DATA pkt");
+    goto error;
+  }
+
+  GST_TRACE ("Got HAVE-DATA %s", name);
+
+  data.name = name;
+  data.caps = caps;
+  g_free (name);
+  g_free (caps);
+
+  {
+    std::lock_guard < std::mutex > lk (self->lock);
+    /* Drops too old data, server must be notified so that the texture
+     * can be reused */
+    while (self->queue.size () > 5) {
+      self->unused_data.push (self->queue.front ().name);
+      self->queue.pop ();
+    }
+
+    self->queue.push (data);
+    self->cond.notify_all ();
+  }
+
+  self->last_err = gst_d3d11_ipc_client_send_read_done_async (self);
+  if (self->last_err != ERROR_SUCCESS)
+    goto error;
+
+  return;
+
+error:
+  SetEvent (self->cancellable);
+}
+
+static void WINAPI
+gst_d3d11_ipc_client_send_need_data_finish (DWORD error_code, DWORD n_bytes,
+    LPOVERLAPPED overlapped)
+{
+  GstD3D11IpcClientConn *conn = (GstD3D11IpcClientConn *) overlapped;
+  GstD3D11IpcClient *self = conn->self;
+
+  if (error_code != ERROR_SUCCESS) {
+    self->last_err = error_code;
+    gst_d3d11_ipc_client_log_error ("NEED-DATA", error_code);
+    goto error;
+  }
+
+  GST_TRACE ("Waiting HAVE-DATA");
+
+  if (!ReadFileEx (conn->pipe, conn->server_msg, sizeof (conn->server_msg),
+          (OVERLAPPED *) conn,
+          gst_d3d11_ipc_client_receive_have_data_finish)) {
+    self->last_err = GetLastError ();
+    gst_d3d11_ipc_client_log_error ("ReadFileEx", self->last_err);
+    goto error;
+  }
+
+  return;
+
+error:
+  SetEvent (self->cancellable);
+}
+
+static DWORD
+gst_d3d11_ipc_client_send_need_data_async (GstD3D11IpcClient * self)
+{
+  GstD3D11IpcClientConn *conn = &self->conn;
+
+  conn->to_write = gst_d3d11_ipc_pkt_build_need_data (conn->client_msg,
+      sizeof (conn->client_msg), conn->seq_num);
+
+  return gst_d3d11_ipc_client_write_async (self,
+      gst_d3d11_ipc_client_send_need_data_finish);
+}
+
+static void
+gst_d3d11_ipc_client_loop (GstD3D11IpcClient * self)
+{
+  DWORD mode = PIPE_READMODE_MESSAGE;
+  std::unique_lock < std::mutex > lk (self->lock);
+  GstD3D11IpcClientConn *conn = &self->conn;
+  HANDLE waitables[2];
+  DWORD wait_ret;
+
+  conn->pipe = CreateFileA (self->name.c_str (),
+      GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING,
+      FILE_FLAG_OVERLAPPED, nullptr);
+  if (conn->pipe == INVALID_HANDLE_VALUE) {
+    self->last_err = GetLastError ();
+    gst_d3d11_ipc_client_log_error ("CreateFileA", self->last_err);
+    self->cond.notify_all ();
+    return;
+  }
+
+  if (!SetNamedPipeHandleState (conn->pipe, &mode, nullptr, nullptr)) {
+    self->last_err = GetLastError ();
+    gst_d3d11_ipc_client_log_error ("SetNamedPipeHandleState",
+        self->last_err);
+    CloseHandle (conn->pipe);
+    conn->pipe = INVALID_HANDLE_VALUE;
+    self->cond.notify_all ();
+    return;
+  }
+
+  self->last_err = ERROR_SUCCESS;
+  self->cond.notify_all ();
+  lk.unlock ();
+
+  /* Once connection is established, send NEED-DATA message to server,
+   * and then it will loop NEED-DATA -> HAVE-DATA -> READ-DONE */
+  self->last_err = gst_d3d11_ipc_client_send_need_data_async (self);
+  if (self->last_err != ERROR_SUCCESS)
+    goto out;
+
+  waitables[0] = self->cancellable;
+  waitables[1] = self->release_event;
+
+  do {
+    /* Enters alertable thread state and wait for I/O completion event
+     * or cancellable event. Queued RELEASE-DATA messages are sent from
+     * the I/O chain once the current write is done */
+    wait_ret = WaitForMultipleObjectsEx (2, waitables, FALSE, INFINITE, TRUE);
+    if (wait_ret == WAIT_OBJECT_0) {
+      GST_DEBUG ("Operation cancelled");
+      goto out;
+    }
+
+    switch (wait_ret) {
+      case WAIT_OBJECT_0 + 1:
+      case WAIT_IO_COMPLETION:
+        break;
+      default:
+        GST_WARNING ("Unexpected wait return 0x%x", (guint) wait_ret);
+        goto out;
+    }
+  } while (true);
+
+out:
+  if (conn->pipe != INVALID_HANDLE_VALUE) {
+    CancelIoEx (conn->pipe, (OVERLAPPED *) conn);
+    CloseHandle (conn->pipe);
+  }
+
+  lk.lock ();
+  if (self->last_err == ERROR_SUCCESS)
+    self->last_err = ERROR_OPERATION_ABORTED;
+  conn->pipe = INVALID_HANDLE_VALUE;
+  self->cond.notify_all ();
+}
+
+GstD3D11IpcClient *
+gst_d3d11_ipc_client_new (const gchar * pipe_name)
+{
+  GstD3D11IpcClient *self;
+
+  g_return_val_if_fail (pipe_name != nullptr, nullptr);
+
+  self = new GstD3D11IpcClient (pipe_name);
+
+  std::unique_lock < std::mutex > lk (self->lock);
+  self->thread = std::make_unique < std::thread >
+      (std::thread (gst_d3d11_ipc_client_loop, self));
+  self->cond.wait (lk);
+
+  if (self->last_err != ERROR_SUCCESS) {
+    lk.unlock ();
+    delete self;
+    return nullptr;
+  }
+
+  return self;
+}
+
+void
+gst_d3d11_ipc_client_unref (GstD3D11IpcClient * client)
+{
+  delete client;
+}
+
+void
+gst_d3d11_ipc_client_set_flushing (GstD3D11IpcClient * client,
+    gboolean flushing)
+{
+  std::lock_guard < std::mutex > lk (client->lock);
+  client->flushing = flushing;
+  client->cond.notify_all ();
+}
+
+/* Waits for a new frame. The caller must pass @name to
+ * gst_d3d11_ipc_client_release_data() once the texture was consumed */
+gboolean
+gst_d3d11_ipc_client_get_data (GstD3D11IpcClient * client,
+    gint64 * adapter_luid, gchar ** name, gchar ** caps)
+{
+  std::unique_lock < std::mutex > lk (client->lock);
+
+  while (client->queue.empty () && client->last_err == ERROR_SUCCESS &&
+      !client->flushing) {
+    client->cond.wait (lk);
+  }
+
+  if (client->queue.empty ())
+    return FALSE;
+
+  GstD3D11IpcClientData data = client->queue.front ();
+  client->queue.pop ();
+
+  *adapter_luid = data.adapter_luid;
+  *name = g_strdup (data.name.c_str ());
+  *caps = g_strdup (data.caps.c_str ());
+
+  return TRUE;
+}
+
+void
+gst_d3d11_ipc_client_release_data (GstD3D11IpcClient * client,
+    const gchar * name)
+{
+  std::lock_guard < std::mutex > lk (client->lock);
+  if (client->last_err != ERROR_SUCCESS)
+    return;
+
+  GST_LOG ("Enqueue release data %s", name);
+  client->unused_data.push (name);
+  SetEvent (client->release_event);
+}
@@ -0,0 +1,43 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstD3D11IpcClient GstD3D11IpcClient;
+
+GstD3D11IpcClient * gst_d3d11_ipc_client_new (const gchar * pipe_name);
+
+void                gst_d3d11_ipc_client_unref (GstD3D11IpcClient * client);
+
+void                gst_d3d11_ipc_client_set_flushing (GstD3D11IpcClient * client,
+                                                       gboolean flushing);
+
+gboolean            gst_d3d11_ipc_client_get_data (GstD3D11IpcClient * client,
+                                                   gint64 * adapter_luid,
+                                                   gchar ** name,
+                                                   gchar ** caps);
+
+void                gst_d3d11_ipc_client_release_data (GstD3D11IpcClient * client,
+                                                       const gchar * name);
+
+G_END_DECLS
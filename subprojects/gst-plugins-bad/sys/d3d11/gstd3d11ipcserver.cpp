@@ -0,0 +1,508 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd3d11ipcserver.h"
+#include "gstd3d11ipc.h"
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+GST_DEBUG_CATEGORY_EXTERN (gst_d3d11_ipc_debug);
+#define GST_CAT_DEFAULT gst_d3d11_ipc_debug
+
+/* *INDENT-OFF* */
+struct GstD3D11IpcData
+{
+  GstD3D11IpcData (GstBuffer * buf, const gchar * n, UINT64 s)
+    : buffer (buf), name (n), seq_num (s)
+  {
+  }
+
+  ~GstD3D11IpcData ()
+  {
+    GST_LOG ("Release %s", name.c_str ());
+    gst_buffer_unref (buffer);
+  }
+
+  /* Holds the shared texture, the producer will not reuse the texture
+   * until all clients release it */
+  GstBuffer *buffer;
+  std::string name;
+  std::string caps;
+  UINT64 seq_num;
+};
+
+struct GstD3D11IpcServerConn : public OVERLAPPED
+{
+  GstD3D11IpcServerConn (GstD3D11IpcServer * server, HANDLE p)
+    : self (server), pipe (p)
+  {
+    OVERLAPPED *parent = static_cast<OVERLAPPED *> (this);
+    parent->Internal = 0;
+    parent->InternalHigh = 0;
+    parent->Offset = 0;
+    parent->OffsetHigh = 0;
+  }
+
+  GstD3D11IpcServer *self;
+  std::shared_ptr<GstD3D11IpcData> data;
+  std::vector<std::shared_ptr<GstD3D11IpcData>> used_data;
+  HANDLE pipe = INVALID_HANDLE_VALUE;
+  guint8 client_msg[GST_D3D11_IPC_PKT_MAX_SIZE];
+  guint8 server_msg[GST_D3D11_IPC_PKT_MAX_SIZE];
+  guint32 to_write = 0;
+  UINT64 seq_num = 0;
+  BOOL pending_have_data = FALSE;
+};
+
+struct _GstD3D11IpcServer
+{
+  _GstD3D11IpcServer (const std::string & n, gint64 luid)
+    : name (n), adapter_luid (luid)
+  {
+    enqueue_event = CreateEventA (nullptr, FALSE, FALSE, nullptr);
+    cancellable = CreateEventA (nullptr, TRUE, FALSE, nullptr);
+  }
+
+  ~_GstD3D11IpcServer ()
+  {
+    SetEvent (cancellable);
+    if (thread) {
+      thread->join ();
+      thread = nullptr;
+    }
+
+    data = nullptr;
+    CloseHandle (cancellable);
+    CloseHandle (enqueue_event);
+  }
+
+  std::mutex lock;
+  std::condition_variable cond;
+  std::unique_ptr<std::thread> thread;
+  std::shared_ptr<GstD3D11IpcData> data;
+  std::string name;
+  std::vector<GstD3D11IpcServerConn *> conn;
+  gint64 adapter_luid;
+
+  HANDLE enqueue_event;
+  HANDLE cancellable;
+  DWORD last_err = ERROR_SUCCESS;
+  UINT64 seq_num = 0;
+};
+/* *INDENT-ON* */
+
+static void
+gst_d3d11_ipc_server_wait_client_msg_async (GstD3D11IpcServerConn * conn);
+
+static void
+gst_d3d11_ipc_server_log_error (const gchar * what, DWORD error_code)
+{
+  gchar *msg = g_win32_error_message (error_code);
+  GST_WARNING ("%s failed with 0x%x (%s)", what, (guint) error_code,
+      GST_STR_NULL (msg));
+  g_free (msg);
+}
+
+static void
+gst_d3d11_ipc_server_close_connection (GstD3D11IpcServerConn * conn,
+    BOOL remove_from_list)
+{
+  GstD3D11IpcServer *self = conn->self;
+
+  GST_DEBUG ("Closing connection %p", conn);
+
+  if (remove_from_list) {
+    self->conn.erase (std::remove (self->conn.begin (), self->conn.end (),
+            conn), self->conn.end ());
+  }
+
+  if (!DisconnectNamedPipe (conn->pipe))
+    gst_d3d11_ipc_server_log_error ("DisconnectNamedPipe", GetLastError ());
+
+  CloseHandle (conn->pipe);
+  delete conn;
+}
+
+static void WINAPI
+gst_d3d11_ipc_server_send_have_data_finish (DWORD error_code, DWORD n_bytes,
+    LPOVERLAPPED overlapped)
+{
+  GstD3D11IpcServerConn *conn = (GstD3D11IpcServerConn *) overlapped;
+
+  if (error_code != ERROR_SUCCESS) {
+    gst_d3d11_ipc_server_log_error ("HAVE-DATA", error_code);
+    gst_d3d11_ipc_server_close_connection (conn, TRUE);
+    return;
+  }
+
+  GST_TRACE ("HAVE-DATA done with %s", conn->data->name.c_str ());
+
+  gst_d3d11_ipc_server_wait_client_msg_async (conn);
+}
+
+static void
+gst_d3d11_ipc_server_send_have_data_async (GstD3D11IpcServerConn * conn)
+{
+  GstD3D11IpcServer *self = conn->self;
+
+  g_assert (conn->data != nullptr);
+
+  conn->pending_have_data = FALSE;
+  conn->seq_num = conn->data->seq_num;
+
+  conn->to_write = gst_d3d11_ipc_pkt_build_have_data (conn->server_msg,
+      sizeof (conn->server_msg), conn->seq_num, self->adapter_luid,
+      conn->data->name.c_str (), conn->data->caps.c_str ());
+  if (conn->to_write == 0) {
+    GST_ERROR ("Couldn't build HAVE-DATA pkt");
+    gst_d3d11_ipc_server_close_connection (conn, TRUE);
+    return;
+  }
+
+  conn->seq_num++;
+
+  GST_TRACE ("Sending HAVE-DATA");
+
+  if (!WriteFileEx (conn->pipe, conn->server_msg, conn->to_write,
+          (OVERLAPPED *) conn, gst_d3d11_ipc_server_send_have_data_finish)) {
+    gst_d3d11_ipc_server_log_error ("WriteFileEx", GetLastError ());
+    gst_d3d11_ipc_server_close_connection (conn, TRUE);
+  }
+}
+
+static void WINAPI
+gst_d3d11_ipc_server_wait_client_msg_finish (DWORD error_code, DWORD n_bytes,
+    LPOVERLAPPED overlapped)
+{
+  GstD3D11IpcServerConn *conn = (GstD3D11IpcServerConn *) overlapped;
+  UINT64 seq_num;
+  gchar *name = nullptr;
+
+  if (error_code != ERROR_SUCCESS) {
+    gst_d3d11_ipc_server_log_error ("ReadFileEx", error_code);
+    gst_d3d11_ipc_server_close_connection (conn, TRUE);
+    return;
+  }
+
+  switch (gst_d3d11_ipc_pkt_type_from_raw (conn->client_msg[0])) {
+    case GST_D3D11_IPC_PKT_NEED_DATA:
+      GST_TRACE ("Got NEED-DATA %p", conn);
+
+      if (!gst_d3d11_ipc_pkt_parse_need_data (conn->client_msg, n_bytes,
+              &seq_num)) {
+        GST_ERROR ("Couldn't parse NEED-DATA message");
+        gst_d3d11_ipc_server_close_connection (conn, TRUE);
+        return;
+      }
+
+      /* Will response later once data is available */
+      if (!conn->data) {
+        GST_LOG ("No data available, waiting");
+        conn->pending_have_data = TRUE;
+        return;
+      }
+
+      gst_d3d11_ipc_server_send_have_data_async (conn);
+      break;
+    case GST_D3D11_IPC_PKT_READ_DONE:
+      GST_TRACE ("Got READ-DONE %p", conn);
+
+      conn->used_data.push_back (conn->data);
+      conn->data = nullptr;
+
+      /* All done, wait for need-data again */
+      gst_d3d11_ipc_server_wait_client_msg_async (conn);
+      break;
+    case GST_D3D11_IPC_PKT_RELEASE_DATA:
+    {
+      GST_TRACE ("Got RELEASE-DATA %p", conn);
+
+      if (!gst_d3d11_ipc_pkt_parse_release_data (conn->client_msg, n_bytes,
+              &seq_num, &name)) {
+        GST_WARNING ("Couldn't parse RELEASE-DATA message");
+        gst_d3d11_ipc_server_close_connection (conn, TRUE);
+        return;
+      }
+
+      /* *INDENT-OFF* */
+      auto it = std::find_if (conn->used_data.begin (), conn->used_data.end (),
+          [&](const std::shared_ptr<GstD3D11IpcData> & data) -> bool {
+            return data->name == name;
+          });
+      /* *INDENT-ON* */
+
+      if (it != conn->used_data.end ())
+        conn->used_data.erase (it);
+      else
+        GST_WARNING ("Unknown texture name %s", name);
+
+      g_free (name);
+
+      gst_d3d11_ipc_server_wait_client_msg_async (conn);
+      break;
+    }
+    default:
+      GST_WARNING ("Unexpected packet type");
+      gst_d3d11_ipc_server_close_connection (conn, TRUE);
+      break;
+  }
+}
+
+static void
+gst_d3d11_ipc_server_wait_client_msg_async (GstD3D11IpcServerConn * conn)
+{
+  GST_TRACE ("Waiting client message");
+
+  if (!ReadFileEx (conn->pipe, conn->client_msg, sizeof (conn->client_msg),
+          (OVERLAPPED *) conn, gst_d3d11_ipc_server_wait_client_msg_finish)) {
+    gst_d3d11_ipc_server_log_error ("ReadFileEx", GetLastError ());
+    gst_d3d11_ipc_server_close_connection (conn, TRUE);
+  }
+}
+
+static HANDLE
+gst_d3d11_ipc_server_create_pipe (GstD3D11IpcServer * self,
+    OVERLAPPED * overlap, BOOL * io_pending)
+{
+  HANDLE pipe = CreateNamedPipeA (self->name.c_str (),
+      PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED,
+      PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT,
+      PIPE_UNLIMITED_INSTANCES, GST_D3D11_IPC_PKT_MAX_SIZE,
+      GST_D3D11_IPC_PKT_MAX_SIZE, 5000, nullptr);
+  if (pipe == INVALID_HANDLE_VALUE) {
+    self->last_err = GetLastError ();
+    gst_d3d11_ipc_server_log_error ("CreateNamedPipeA", self->last_err);
+    return INVALID_HANDLE_VALUE;
+  }
+
+  /* Async pipe should return FALSE */
+  if (ConnectNamedPipe (pipe, overlap)) {
+    self->last_err = GetLastError ();
+    gst_d3d11_ipc_server_log_error ("ConnectNamedPipe", self->last_err);
+    CloseHandle (pipe);
+    return INVALID_HANDLE_VALUE;
+  }
+
+  *io_pending = FALSE;
+  self->last_err = GetLastError ();
+  switch (self->last_err) {
+    case ERROR_IO_PENDING:
+      *io_pending = TRUE;
+      break;
+    case ERROR_PIPE_CONNECTED:
+      SetEvent (overlap->hEvent);
+      break;
+    default:
+      gst_d3d11_ipc_server_log_error ("ConnectNamedPipe", self->last_err);
+      CloseHandle (pipe);
+      return INVALID_HANDLE_VALUE;
+  }
+
+  self->last_err = ERROR_SUCCESS;
+
+  return pipe;
+}
+
+static void
+gst_d3d11_ipc_server_loop (GstD3D11IpcServer * self)
+{
+  BOOL io_pending = FALSE;
+  DWORD n_bytes;
+  DWORD wait_ret;
+  HANDLE waitables[3];
+  HANDLE pipe;
+  OVERLAPPED overlap;
+  std::unique_lock < std::mutex > lk (self->lock);
+
+  overlap.hEvent = CreateEvent (nullptr, TRUE, TRUE, nullptr);
+  pipe = gst_d3d11_ipc_server_create_pipe (self, &overlap, &io_pending);
+  if (pipe == INVALID_HANDLE_VALUE) {
+    CloseHandle (overlap.hEvent);
+    self->cond.notify_all ();
+    return;
+  }
+
+  self->last_err = ERROR_SUCCESS;
+  self->cond.notify_all ();
+  lk.unlock ();
+
+  waitables[0] = overlap.hEvent;
+  waitables[1] = self->enqueue_event;
+  waitables[2] = self->cancellable;
+
+  do {
+    GstD3D11IpcServerConn *conn;
+
+    /* Enters alertable state and wait for
+     * 1) Client's connection request
+     * 2) Or, performs completion routines (finish APC)
+     * 3) Or, terminates if cancellable event was signalled
+     */
+    wait_ret = WaitForMultipleObjectsEx (3, waitables, FALSE, INFINITE, TRUE);
+    if (wait_ret == WAIT_OBJECT_0 + 2) {
+      GST_DEBUG ("Operation cancelled");
+      goto out;
+    }
+
+    switch (wait_ret) {
+      case WAIT_OBJECT_0:
+        if (io_pending &&
+            !GetOverlappedResult (pipe, &overlap, &n_bytes, FALSE)) {
+          gst_d3d11_ipc_server_log_error ("ConnectNamedPipe", GetLastError ());
+          CloseHandle (pipe);
+          pipe = gst_d3d11_ipc_server_create_pipe (self, &overlap,
+              &io_pending);
+          if (pipe == INVALID_HANDLE_VALUE)
+            goto out;
+          break;
+        }
+
+        conn = new GstD3D11IpcServerConn (self, pipe);
+        GST_DEBUG ("New connection is established %p", conn);
+
+        /* Stores current frame if available */
+        lk.lock ();
+        conn->data = self->data;
+        lk.unlock ();
+
+        self->conn.push_back (conn);
+        gst_d3d11_ipc_server_wait_client_msg_async (conn);
+        pipe = gst_d3d11_ipc_server_create_pipe (self, &overlap, &io_pending);
+        if (pipe == INVALID_HANDLE_VALUE)
+          goto out;
+        break;
+      case WAIT_OBJECT_0 + 1:
+      case WAIT_IO_COMPLETION:
+      {
+        std::vector < GstD3D11IpcServerConn * >pending_conns;
+        std::shared_ptr < GstD3D11IpcData > data;
+
+        lk.lock ();
+        data = self->data;
+        lk.unlock ();
+
+        if (data) {
+          for (auto iter : self->conn) {
+            if (iter->pending_have_data && iter->seq_num <= data->seq_num) {
+              iter->data = data;
+              pending_conns.push_back (iter);
+            }
+          }
+        }
+
+        for (auto iter : pending_conns) {
+          GST_LOG ("Sending pending have data to %p", iter);
+          gst_d3d11_ipc_server_send_have_data_async (iter);
+        }
+        break;
+      }
+      default:
+        GST_WARNING ("Unexpected WaitForMultipleObjectsEx return 0x%x",
+            (guint) wait_ret);
+        goto out;
+    }
+  } while (true);
+
+out:
+  /* Cancels all I/O event issued from this thread */
+  for (auto iter : self->conn)
+    CancelIo (iter->pipe);
+
+  for (auto iter : self->conn)
+    gst_d3d11_ipc_server_close_connection (iter, FALSE);
+
+  self->conn.clear ();
+
+  if (pipe != INVALID_HANDLE_VALUE) {
+    CancelIo (pipe);
+    CloseHandle (pipe);
+  }
+
+  lk.lock ();
+  CloseHandle (overlap.hEvent);
+  self->last_err = ERROR_OPERATION_ABORTED;
+  self->cond.notify_all ();
+}
+
+GstD3D11IpcServer *
+gst_d3d11_ipc_server_new (const gchar * pipe_name, gint64 adapter_luid)
+{
+  GstD3D11IpcServer *self;
+
+  g_return_val_if_fail (pipe_name != nullptr, nullptr);
+
+  self = new GstD3D11IpcServer (pipe_name, adapter_luid);
+
+  std::unique_lock < std::mutex > lk (self->lock);
+  self->thread = std::make_unique < std::thread >
+      (std::thread (gst_d3d11_ipc_server_loop, self));
+  self->cond.wait (lk);
+
+  if (self->last_err != ERROR_SUCCESS) {
+    lk.unlock ();
+    delete self;
+    return nullptr;
+  }
+
+  return self;
+}
+
+void
+gst_d3d11_ipc_server_unref (GstD3D11IpcServer * server)
+{
+  GST_DEBUG ("Shutting down");
+
+  delete server;
+}
+
+/* Takes ownership of @buffer. The buffer is kept alive until every client
+ * which received it sends RELEASE-DATA, or a newer frame replaces it */
+gboolean
+gst_d3d11_ipc_server_send_data (GstD3D11IpcServer * server,
+    GstBuffer * buffer, const gchar * name, const gchar * caps)
+{
+  std::lock_guard < std::mutex > lk (server->lock);
+
+  if (server->last_err != ERROR_SUCCESS) {
+    gst_buffer_unref (buffer);
+    return FALSE;
+  }
+
+  server->data = std::make_shared < GstD3D11IpcData > (buffer, name,
+      server->seq_num);
+  server->data->caps = caps;
+
+  GST_LOG ("Enqueue texture %s", name);
+
+  server->seq_num++;
+
+  /* Wakeup event loop */
+  SetEvent (server->enqueue_event);
+
+  return TRUE;
+}
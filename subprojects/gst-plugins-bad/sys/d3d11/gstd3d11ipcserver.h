@@ -0,0 +1,38 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstD3D11IpcServer GstD3D11IpcServer;
+
+GstD3D11IpcServer * gst_d3d11_ipc_server_new (const gchar * pipe_name,
+                                              gint64 adapter_luid);
+
+void                gst_d3d11_ipc_server_unref (GstD3D11IpcServer * server);
+
+gboolean            gst_d3d11_ipc_server_send_data (GstD3D11IpcServer * server,
+                                                    GstBuffer * buffer,
+                                                    const gchar * name,
+                                                    const gchar * caps);
+
+G_END_DECLS
@@ -0,0 +1,566 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/**
+ * SECTION:element-d3d11ipcsink
+ * @title: d3d11ipcsink
+ *
+ * d3d11ipcsink shares Direct3D11 textures with d3d11ipcsrc elements running
+ * in other processes. Each frame is copied on the GPU into a texture created
+ * with NT handle and keyed mutex sharing, so that frames never leave the GPU.
+ *
+ * ## Example launch line
+ * ```
+ * gst-launch-1.0 d3d11testsrc ! queue ! d3d11ipcsink
+ * ```
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd3d11ipcsink.h"
+#include "gstd3d11ipc.h"
+#include "gstd3d11ipcserver.h"
+#include "gstd3d11pluginutils.h"
+#include <wrl.h>
+#include <string.h>
+
+/* *INDENT-OFF* */
+using namespace Microsoft::WRL;
+/* *INDENT-ON* */
+
+GST_DEBUG_CATEGORY_STATIC (gst_d3d11_ipc_sink_debug);
+#define GST_CAT_DEFAULT gst_d3d11_ipc_sink_debug
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE_WITH_FEATURES
+        (GST_CAPS_FEATURE_MEMORY_D3D11_MEMORY, GST_D3D11_IPC_FORMATS)));
+
+enum
+{
+  PROP_0,
+  PROP_ADAPTER,
+  PROP_PIPE_NAME,
+};
+
+#define DEFAULT_ADAPTER -1
+
+struct GstD3D11IpcSinkHandle
+{
+  HANDLE handle;
+  gchar *name;
+};
+
+struct _GstD3D11IpcSink
+{
+  GstBaseSink parent;
+
+  GstD3D11Device *device;
+  GstD3D11IpcServer *server;
+
+  GstVideoInfo info;
+  gchar *caps_str;
+  GstBufferPool *pool;
+  GstBuffer *prepared_buffer;
+  gint64 token;
+
+  /* properties */
+  gint adapter;
+  gchar *pipe_name;
+};
+
+static void gst_d3d11_ipc_sink_finalize (GObject * object);
+static void gst_d3d11_ipc_sink_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec);
+static void gst_d3d11_ipc_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+static void gst_d3d11_ipc_sink_set_context (GstElement * element,
+    GstContext * context);
+
+static gboolean gst_d3d11_ipc_sink_start (GstBaseSink * sink);
+static gboolean gst_d3d11_ipc_sink_stop (GstBaseSink * sink);
+static gboolean gst_d3d11_ipc_sink_unlock_stop (GstBaseSink * sink);
+static gboolean gst_d3d11_ipc_sink_set_caps (GstBaseSink * sink,
+    GstCaps * caps);
+static gboolean gst_d3d11_ipc_sink_propose_allocation (GstBaseSink * sink,
+    GstQuery * query);
+static gboolean gst_d3d11_ipc_sink_query (GstBaseSink * sink,
+    GstQuery * query);
+static GstFlowReturn gst_d3d11_ipc_sink_prepare (GstBaseSink * sink,
+    GstBuffer * buf);
+static GstFlowReturn gst_d3d11_ipc_sink_render (GstBaseSink * sink,
+    GstBuffer * buf);
+
+#define gst_d3d11_ipc_sink_parent_class parent_class
+G_DEFINE_TYPE (GstD3D11IpcSink, gst_d3d11_ipc_sink, GST_TYPE_BASE_SINK);
+
+static void
+gst_d3d11_ipc_sink_class_init (GstD3D11IpcSinkClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstBaseSinkClass *sink_class = GST_BASE_SINK_CLASS (klass);
+
+  object_class->finalize = gst_d3d11_ipc_sink_finalize;
+  object_class->set_property = gst_d3d11_ipc_sink_set_property;
+  object_class->get_property = gst_d3d11_ipc_sink_get_property;
+
+  g_object_class_install_property (object_class, PROP_ADAPTER,
+      g_param_spec_int ("adapter", "Adapter",
+          "DXGI Adapter index (-1 for any device)",
+          -1, G_MAXINT32, DEFAULT_ADAPTER,
+          (GParamFlags) (G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+              G_PARAM_STATIC_STRINGS)));
+  g_object_class_install_property (object_class, PROP_PIPE_NAME,
+      g_param_spec_string ("pipe-name", "Pipe Name",
+          "The name of Win32 named pipe to communicate with clients. "
+          "Validation of the pipe name is caller's responsibility",
+          GST_D3D11_IPC_DEFAULT_PIPE_NAME, (GParamFlags) (G_PARAM_READWRITE |
+              G_PARAM_STATIC_STRINGS | GST_PARAM_MUTABLE_READY)));
+
+  gst_element_class_set_static_metadata (element_class,
+      "Direct3D11 IPC Sink", "Sink/Video",
+      "Shares Direct3D11 textures with d3d11ipcsrc elements",
+      "Seungha Yang <seungha@centricular.com>");
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+
+  element_class->set_context =
+      GST_DEBUG_FUNCPTR (gst_d3d11_ipc_sink_set_context);
+
+  sink_class->start = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_sink_start);
+  sink_class->stop = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_sink_stop);
+  sink_class->unlock_stop = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_sink_unlock_stop);
+  sink_class->set_caps = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_sink_set_caps);
+  sink_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_d3d11_ipc_sink_propose_allocation);
+  sink_class->query = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_sink_query);
+  sink_class->prepare = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_sink_prepare);
+  sink_class->render = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_sink_render);
+
+  GST_DEBUG_CATEGORY_INIT (gst_d3d11_ipc_sink_debug, "d3d11ipcsink",
+      0, "d3d11ipcsink");
+}
+
+static void
+gst_d3d11_ipc_sink_init (GstD3D11IpcSink * self)
+{
+  self->adapter = DEFAULT_ADAPTER;
+  self->pipe_name = g_strdup (GST_D3D11_IPC_DEFAULT_PIPE_NAME);
+  self->token = gst_d3d11_create_user_token ();
+}
+
+static void
+gst_d3d11_ipc_sink_finalize (GObject * object)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (object);
+
+  g_free (self->pipe_name);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_d3d11_ipc_sink_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (object);
+
+  switch (prop_id) {
+    case PROP_ADAPTER:
+      self->adapter = g_value_get_int (value);
+      break;
+    case PROP_PIPE_NAME:
+      GST_OBJECT_LOCK (self);
+      g_free (self->pipe_name);
+      self->pipe_name = g_value_dup_string (value);
+      if (!self->pipe_name)
+        self->pipe_name = g_strdup (GST_D3D11_IPC_DEFAULT_PIPE_NAME);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_d3d11_ipc_sink_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (object);
+
+  switch (prop_id) {
+    case PROP_ADAPTER:
+      g_value_set_int (value, self->adapter);
+      break;
+    case PROP_PIPE_NAME:
+      GST_OBJECT_LOCK (self);
+      g_value_set_string (value, self->pipe_name);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_d3d11_ipc_sink_set_context (GstElement * element, GstContext * context)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (element);
+
+  gst_d3d11_handle_set_context (element, context, self->adapter,
+      &self->device);
+
+  GST_ELEMENT_CLASS (parent_class)->set_context (element, context);
+}
+
+static void
+gst_d3d11_ipc_sink_clear_pool (GstD3D11IpcSink * self)
+{
+  if (self->pool) {
+    gst_buffer_pool_set_active (self->pool, FALSE);
+    gst_clear_object (&self->pool);
+  }
+}
+
+static gboolean
+gst_d3d11_ipc_sink_start (GstBaseSink * sink)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (sink);
+  gint64 adapter_luid = 0;
+  gchar *pipe_name;
+
+  GST_DEBUG_OBJECT (self, "Start");
+
+  if (!gst_d3d11_ensure_element_data (GST_ELEMENT_CAST (self), self->adapter,
+          &self->device)) {
+    GST_ELEMENT_ERROR (self, RESOURCE, NOT_FOUND,
+        ("Failed to prepare device"), (nullptr));
+    return FALSE;
+  }
+
+  g_object_get (self->device, "adapter-luid", &adapter_luid, nullptr);
+
+  GST_OBJECT_LOCK (self);
+  pipe_name = g_strdup (self->pipe_name);
+  GST_OBJECT_UNLOCK (self);
+
+  self->server = gst_d3d11_ipc_server_new (pipe_name, adapter_luid);
+  g_free (pipe_name);
+
+  if (!self->server) {
+    GST_ELEMENT_ERROR (self, RESOURCE, OPEN_WRITE,
+        ("Couldn't create pipe server"), (nullptr));
+    gst_clear_object (&self->device);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gst_d3d11_ipc_sink_stop (GstBaseSink * sink)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (sink);
+
+  GST_DEBUG_OBJECT (self, "Stop");
+
+  /* Releases all textures held by clients before the pool goes away */
+  g_clear_pointer (&self->server, gst_d3d11_ipc_server_unref);
+  gst_clear_buffer (&self->prepared_buffer);
+  gst_d3d11_ipc_sink_clear_pool (self);
+  g_clear_pointer (&self->caps_str, g_free);
+  gst_clear_object (&self->device);
+
+  return TRUE;
+}
+
+static gboolean
+gst_d3d11_ipc_sink_unlock_stop (GstBaseSink * sink)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (sink);
+
+  gst_clear_buffer (&self->prepared_buffer);
+
+  return TRUE;
+}
+
+static gboolean
+gst_d3d11_ipc_sink_set_caps (GstBaseSink * sink, GstCaps * caps)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (sink);
+  GstD3D11AllocationParams *params;
+
+  GST_DEBUG_OBJECT (self, "New caps %" GST_PTR_FORMAT, caps);
+
+  if (!gst_video_info_from_caps (&self->info, caps)) {
+    GST_WARNING_OBJECT (self, "Invalid caps");
+    return FALSE;
+  }
+
+  g_free (self->caps_str);
+  self->caps_str = gst_caps_to_string (caps);
+
+  gst_d3d11_ipc_sink_clear_pool (self);
+
+  /* Textures in this pool are visible to other processes */
+  params = gst_d3d11_allocation_params_new (self->device, &self->info,
+      GST_D3D11_ALLOCATION_FLAG_DEFAULT, D3D11_BIND_SHADER_RESOURCE,
+      D3D11_RESOURCE_MISC_SHARED_NTHANDLE |
+      D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX);
+  self->pool = gst_d3d11_buffer_pool_new_with_options (self->device,
+      caps, params, 0, 0);
+  gst_d3d11_allocation_params_free (params);
+
+  if (!self->pool || !gst_buffer_pool_set_active (self->pool, TRUE)) {
+    GST_ERROR_OBJECT (self, "Couldn't configure shared texture pool");
+    gst_clear_object (&self->pool);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gst_d3d11_ipc_sink_propose_allocation (GstBaseSink * sink, GstQuery * query)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (sink);
+  GstCaps *caps;
+  GstBufferPool *pool = nullptr;
+  GstVideoInfo info;
+  guint size;
+  gboolean need_pool;
+
+  if (!self->device)
+    return FALSE;
+
+  gst_query_parse_allocation (query, &caps, &need_pool);
+  if (!caps) {
+    GST_WARNING_OBJECT (self, "No caps specified");
+    return FALSE;
+  }
+
+  if (!gst_video_info_from_caps (&info, caps)) {
+    GST_WARNING_OBJECT (self, "Invalid caps %" GST_PTR_FORMAT, caps);
+    return FALSE;
+  }
+
+  size = info.size;
+  if (need_pool) {
+    GstStructure *config;
+
+    pool = gst_d3d11_buffer_pool_new (self->device);
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_add_option (config,
+        GST_BUFFER_POOL_OPTION_VIDEO_META);
+    gst_buffer_pool_config_set_params (config, caps, size, 0, 0);
+
+    if (!gst_buffer_pool_set_config (pool, config)) {
+      GST_ERROR_OBJECT (pool, "Couldn't set config");
+      gst_object_unref (pool);
+      return FALSE;
+    }
+
+    /* d3d11 buffer pool will update buffer size based on allocated texture,
+     * get size from config again */
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_get_params (config,
+        nullptr, &size, nullptr, nullptr);
+    gst_structure_free (config);
+  }
+
+  gst_query_add_allocation_pool (query, pool, size, 0, 0);
+  gst_clear_object (&pool);
+
+  gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, nullptr);
+
+  return TRUE;
+}
+
+static gboolean
+gst_d3d11_ipc_sink_query (GstBaseSink * sink, GstQuery * query)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (sink);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CONTEXT:
+      if (gst_d3d11_handle_context_query (GST_ELEMENT_CAST (self), query,
+              self->device)) {
+        return TRUE;
+      }
+      break;
+    default:
+      break;
+  }
+
+  return GST_BASE_SINK_CLASS (parent_class)->query (sink, query);
+}
+
+static void
+gst_d3d11_ipc_sink_handle_free (GstD3D11IpcSinkHandle * handle)
+{
+  CloseHandle (handle->handle);
+  g_free (handle->name);
+  g_free (handle);
+}
+
+/* Returns the shared name of the texture, creating the NT handle on first
+ * use. The handle lives as long as the pooled memory */
+static const gchar *
+gst_d3d11_ipc_sink_get_shared_name (GstD3D11IpcSink * self,
+    GstD3D11Memory * dmem)
+{
+  GstD3D11IpcSinkHandle *handle;
+  ID3D11Resource *resource;
+  ComPtr < IDXGIResource1 > dxgi_resource;
+  gunichar2 *wname;
+  HANDLE nt_handle = nullptr;
+  gchar *name;
+  HRESULT hr;
+
+  handle = (GstD3D11IpcSinkHandle *)
+      gst_d3d11_memory_get_token_data (dmem, self->token);
+  if (handle)
+    return handle->name;
+
+  resource = gst_d3d11_memory_get_resource_handle (dmem);
+  hr = resource->QueryInterface (IID_PPV_ARGS (&dxgi_resource));
+  if (!gst_d3d11_result (hr, self->device)) {
+    GST_ERROR_OBJECT (self, "IDXGIResource1 interface is not available");
+    return nullptr;
+  }
+
+  name = gst_d3d11_ipc_get_texture_name ();
+  wname = g_utf8_to_utf16 (name, -1, nullptr, nullptr, nullptr);
+  hr = dxgi_resource->CreateSharedHandle (nullptr,
+      DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE,
+      (LPCWSTR) wname, &nt_handle);
+  g_free (wname);
+
+  if (!gst_d3d11_result (hr, self->device)) {
+    GST_ERROR_OBJECT (self, "Couldn't create shared handle");
+    g_free (name);
+    return nullptr;
+  }
+
+  GST_DEBUG_OBJECT (self, "Created shared texture %s", name);
+
+  handle = g_new0 (GstD3D11IpcSinkHandle, 1);
+  handle->handle = nt_handle;
+  handle->name = name;
+
+  gst_d3d11_memory_set_token_data (dmem, self->token, handle,
+      (GDestroyNotify) gst_d3d11_ipc_sink_handle_free);
+
+  return handle->name;
+}
+
+static GstFlowReturn
+gst_d3d11_ipc_sink_prepare (GstBaseSink * sink, GstBuffer * buf)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (sink);
+  GstD3D11Memory *dmem;
+  ID3D11Resource *resource;
+  ComPtr < IDXGIKeyedMutex > keyed_mutex;
+  GstFlowReturn ret;
+  gboolean copied;
+  HRESULT hr;
+
+  gst_clear_buffer (&self->prepared_buffer);
+
+  if (!self->pool) {
+    GST_ERROR_OBJECT (self, "Pool is not configured");
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  ret = gst_buffer_pool_acquire_buffer (self->pool, &self->prepared_buffer,
+      nullptr);
+  if (ret != GST_FLOW_OK) {
+    GST_ERROR_OBJECT (self, "Couldn't acquire shared texture");
+    return ret;
+  }
+
+  dmem = (GstD3D11Memory *) gst_buffer_peek_memory (self->prepared_buffer, 0);
+  resource = gst_d3d11_memory_get_resource_handle (dmem);
+  hr = resource->QueryInterface (IID_PPV_ARGS (&keyed_mutex));
+  if (!gst_d3d11_result (hr, self->device))
+    goto error;
+
+  /* Device lock is recursive, held so that the keyed mutex and the copy
+   * are issued as one unit on the immediate context */
+  {
+    GstD3D11DeviceLockGuard lk (self->device);
+
+    hr = keyed_mutex->AcquireSync (GST_D3D11_IPC_KEYED_MUTEX_KEY, INFINITE);
+    if (!gst_d3d11_result (hr, self->device)) {
+      GST_ERROR_OBJECT (self, "Couldn't acquire keyed mutex");
+      goto error;
+    }
+
+    copied = gst_d3d11_buffer_copy_into (self->prepared_buffer, buf,
+        &self->info);
+    keyed_mutex->ReleaseSync (GST_D3D11_IPC_KEYED_MUTEX_KEY);
+  }
+
+  if (!copied) {
+    GST_ERROR_OBJECT (self, "Couldn't copy into shared texture");
+    goto error;
+  }
+
+  if (!gst_d3d11_ipc_sink_get_shared_name (self, dmem))
+    goto error;
+
+  return GST_FLOW_OK;
+
+error:
+  gst_clear_buffer (&self->prepared_buffer);
+  return GST_FLOW_ERROR;
+}
+
+static GstFlowReturn
+gst_d3d11_ipc_sink_render (GstBaseSink * sink, GstBuffer * buf)
+{
+  GstD3D11IpcSink *self = GST_D3D11_IPC_SINK (sink);
+  GstD3D11Memory *dmem;
+  const gchar *name;
+
+  if (!self->prepared_buffer) {
+    GST_ERROR_OBJECT (self, "No prepared buffer");
+    return GST_FLOW_ERROR;
+  }
+
+  dmem = (GstD3D11Memory *) gst_buffer_peek_memory (self->prepared_buffer, 0);
+  name = gst_d3d11_ipc_sink_get_shared_name (self, dmem);
+
+  /* gst_d3d11_ipc_server_send_data() takes ownership of buffer */
+  if (!gst_d3d11_ipc_server_send_data (self->server,
+          g_steal_pointer (&self->prepared_buffer), name, self->caps_str)) {
+    GST_ERROR_OBJECT (self, "Couldn't send buffer");
+    return GST_FLOW_ERROR;
+  }
+
+  return GST_FLOW_OK;
+}
@@ -0,0 +1,568 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/**
+ * SECTION:element-d3d11ipcsrc
+ * @title: d3d11ipcsrc
+ *
+ * d3d11ipcsrc receives Direct3D11 textures shared by a d3d11ipcsink element
+ * running in another process. Shared textures are copied on the GPU into
+ * textures owned by this element, and are returned to the producer
+ * right after the copy.
+ *
+ * The Direct3D11 device is created on the same adapter as the producer's one
+ * since shared textures cannot be opened on other adapters.
+ *
+ * ## Example launch line
+ * ```
+ * gst-launch-1.0 d3d11ipcsrc ! queue ! d3d11videosink
+ * ```
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstd3d11ipcsrc.h"
+#include "gstd3d11ipc.h"
+#include "gstd3d11ipcclient.h"
+#include "gstd3d11pluginutils.h"
+#include <wrl.h>
+#include <string>
+#include <unordered_map>
+
+/* *INDENT-OFF* */
+using namespace Microsoft::WRL;
+/* *INDENT-ON* */
+
+GST_DEBUG_CATEGORY_STATIC (gst_d3d11_ipc_src_debug);
+#define GST_CAT_DEFAULT gst_d3d11_ipc_src_debug
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE_WITH_FEATURES
+        (GST_CAPS_FEATURE_MEMORY_D3D11_MEMORY, GST_D3D11_IPC_FORMATS)));
+
+enum
+{
+  PROP_0,
+  PROP_PIPE_NAME,
+};
+
+/* *INDENT-OFF* */
+struct GstD3D11IpcSrcPrivate
+{
+  /* Opened shared textures, the producer reuses its pooled textures
+   * so that we don't need to open them again for every frame */
+  std::unordered_map<std::string, ComPtr<ID3D11Texture2D>> textures;
+};
+/* *INDENT-ON* */
+
+struct _GstD3D11IpcSrc
+{
+  GstBaseSrc parent;
+
+  GstD3D11IpcSrcPrivate *priv;
+
+  GstD3D11Device *device;
+  gint64 adapter_luid;
+  GstD3D11IpcClient *client;
+  GstCaps *caps;
+  GstVideoInfo info;
+  GstBufferPool *pool;
+  gboolean flushing;
+  SRWLOCK lock;
+
+  /* properties */
+  gchar *pipe_name;
+};
+
+static void gst_d3d11_ipc_src_finalize (GObject * object);
+static void gst_d3d11_ipc_src_set_property (GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec);
+static void gst_d3d11_ipc_src_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
+static void gst_d3d11_ipc_src_set_context (GstElement * element,
+    GstContext * context);
+
+static gboolean gst_d3d11_ipc_src_start (GstBaseSrc * src);
+static gboolean gst_d3d11_ipc_src_stop (GstBaseSrc * src);
+static gboolean gst_d3d11_ipc_src_unlock (GstBaseSrc * src);
+static gboolean gst_d3d11_ipc_src_unlock_stop (GstBaseSrc * src);
+static gboolean gst_d3d11_ipc_src_query (GstBaseSrc * src, GstQuery * query);
+static GstFlowReturn gst_d3d11_ipc_src_create (GstBaseSrc * src,
+    guint64 offset, guint size, GstBuffer ** buf);
+
+#define gst_d3d11_ipc_src_parent_class parent_class
+G_DEFINE_TYPE (GstD3D11IpcSrc, gst_d3d11_ipc_src, GST_TYPE_BASE_SRC);
+
+static void
+gst_d3d11_ipc_src_class_init (GstD3D11IpcSrcClass * klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstBaseSrcClass *src_class = GST_BASE_SRC_CLASS (klass);
+
+  object_class->finalize = gst_d3d11_ipc_src_finalize;
+  object_class->set_property = gst_d3d11_ipc_src_set_property;
+  object_class->get_property = gst_d3d11_ipc_src_get_property;
+
+  g_object_class_install_property (object_class, PROP_PIPE_NAME,
+      g_param_spec_string ("pipe-name", "Pipe Name",
+          "The name of Win32 named pipe to communicate with server. "
+          "Validation of the pipe name is caller's responsibility",
+          GST_D3D11_IPC_DEFAULT_PIPE_NAME, (GParamFlags) (G_PARAM_READWRITE |
+              G_PARAM_STATIC_STRINGS | GST_PARAM_MUTABLE_READY)));
+
+  gst_element_class_set_static_metadata (element_class,
+      "Direct3D11 IPC Source", "Source/Video",
+      "Receives Direct3D11 textures from the d3d11ipcsink",
+      "Seungha Yang <seungha@centricular.com>");
+  gst_element_class_add_static_pad_template (element_class, &src_template);
+
+  element_class->set_context = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_src_set_context);
+
+  src_class->start = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_src_start);
+  src_class->stop = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_src_stop);
+  src_class->unlock = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_src_unlock);
+  src_class->unlock_stop = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_src_unlock_stop);
+  src_class->query = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_src_query);
+  src_class->create = GST_DEBUG_FUNCPTR (gst_d3d11_ipc_src_create);
+
+  GST_DEBUG_CATEGORY_INIT (gst_d3d11_ipc_src_debug, "d3d11ipcsrc",
+      0, "d3d11ipcsrc");
+}
+
+static void
+gst_d3d11_ipc_src_init (GstD3D11IpcSrc * self)
+{
+  gst_base_src_set_format (GST_BASE_SRC (self), GST_FORMAT_TIME);
+  gst_base_src_set_live (GST_BASE_SRC (self), TRUE);
+  gst_base_src_set_do_timestamp (GST_BASE_SRC (self), TRUE);
+
+  self->priv = new GstD3D11IpcSrcPrivate ();
+  self->pipe_name = g_strdup (GST_D3D11_IPC_DEFAULT_PIPE_NAME);
+}
+
+static void
+gst_d3d11_ipc_src_finalize (GObject * object)
+{
+  GstD3D11IpcSrc *self = GST_D3D11_IPC_SRC (object);
+
+  delete self->priv;
+  g_free (self->pipe_name);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_d3d11_ipc_src_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstD3D11IpcSrc *self = GST_D3D11_IPC_SRC (object);
+
+  switch (prop_id) {
+    case PROP_PIPE_NAME:
+      GST_OBJECT_LOCK (self);
+      g_free (self->pipe_name);
+      self->pipe_name = g_value_dup_string (value);
+      if (!self->pipe_name)
+        self->pipe_name = g_strdup (GST_D3D11_IPC_DEFAULT_PIPE_NAME);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_d3d11_ipc_src_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstD3D11IpcSrc *self = GST_D3D11_IPC_SRC (object);
+
+  switch (prop_id) {
+    case PROP_PIPE_NAME:
+      GST_OBJECT_LOCK (self);
+      g_value_set_string (value, self->pipe_name);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_d3d11_ipc_src_set_context (GstElement * element, GstContext * context)
+{
+  GstD3D11IpcSrc *self = GST_D3D11_IPC_SRC (element);
+
+  /* Only the device of the producer's adapter is usable, which is known
+   * once the first frame arrives */
+  if (self->adapter_luid != 0) {
+    gst_d3d11_handle_set_context_for_adapter_luid (element, context,
+        self->adapter_luid, &self->device);
+  }
+
+  GST_ELEMENT_CLASS (parent_class)->set_context (element, context);
+}
+
+static void
+gst_d3d11_ipc_src_clear_resource (GstD3D11IpcSrc * self)
+{
+  if (self->pool) {
+    gst_buffer_pool_set_active (self->pool, FALSE);
+    gst_clear_object (&self->pool);
+  }
+
+  self->priv->textures.clear ();
+  gst_clear_caps (&self->caps);
+}
+
+static gboolean
+gst_d3d11_ipc_src_start (GstBaseSrc * src)
+{
+  GstD3D11IpcSrc *self = GST_D3D11_IPC_SRC (src);
+
+  GST_DEBUG_OBJECT (self, "Start");
+
+  gst_video_info_init (&self->info);
+
+  return TRUE;
+}
+
+static gboolean
+gst_d3d11_ipc_src_stop (GstBaseSrc * src)
+{
+  GstD3D11IpcSrc *self = GST_D3D11_IPC_SRC (src);
+
+  GST_DEBUG_OBJECT (self, "Stop");
+
+  g_clear_pointer (&self->client, gst_d3d11_ipc_client_unref);
+  gst_d3d11_ipc_src_clear_resource (self);
+  gst_clear_object (&self->device);
+  self->adapter_luid = 0;
+
+  return TRUE;
+}
+
+static gboolean
+gst_d3d11_ipc_src_unlock (GstBaseSrc * src)
+{
+  GstD3D11IpcSrc *self = GST_D3D11_IPC_SRC (src);
+
+  GST_DEBUG_OBJECT (self, "Unlock");
+
+  AcquireSRWLockExclusive (&self->lock);
+  self->flushing = TRUE;
+  if (self->client)
+    gst_d3d11_ipc_client_set_flushing (self->client, TRUE);
+  ReleaseSRWLockExclusive (&self->lock);
+
+  return TRUE;
+}
+
+static gboolean
+gst_d3d11_ipc_src_unlock_stop (GstBaseSrc * src)
+{
+  GstD3D11IpcSrc *self = GST_D3D11_IPC_SRC (src);
+
+  GST_DEBUG_OBJECT (self, "Unlock stop");
+
+  AcquireSRWLockExclusive (&self->lock);
+  self->flushing = FALSE;
+  if (self->client)
+    gst_d3d11_ipc_client_set_flushing (self->client, FALSE);
+  ReleaseSRWLockExclusive (&self->lock);
+
+  return TRUE;
+}
+
+static gboolean
+gst_d3d11_ipc_src_query (GstBaseSrc * src, GstQuery * query)
+{
+  GstD3D11IpcSrc *self = GST_D3D11_IPC_SRC (src);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CONTEXT:
+      if (gst_d3d11_handle_context_query (GST_ELEMENT_CAST (self), query,
+              self->device)) {
+        return TRUE;
+      }
+      break;
+    default:
+      break;
+  }
+
+  return GST_BASE_SRC_CLASS (parent_class)->query (src, query);
+}
+
+static gboolean
+gst_d3d11_ipc_src_update_device (GstD3D11IpcSrc * self, gint64 adapter_luid)
+{
+  if (self->device && self->adapter_luid == adapter_luid)
+    return TRUE;
+
+  GST_DEBUG_OBJECT (self, "Producer adapter LUID %" G_GINT64_FORMAT,
+      adapter_luid);
+
+  gst_d3d11_ipc_src_clear_resource (self);
+  gst_clear_object (&self->device);
+  self->adapter_luid = adapter_luid;
+
+  if (!gst_d3d11_ensure_element_data_for_adapter_luid (GST_ELEMENT_CAST (self),
+          adapter_luid, &self->device)) {
+    GST_ERROR_OBJECT (self, "Couldn't create device for adapter LUID %"
+        G_GINT64_FORMAT, adapter_luid);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+static gboolean
+gst_d3d11_ipc_src_update_caps (GstD3D11IpcSrc * self, const gchar * caps_str)
+{
+  GstD3D11AllocationParams *params;
+  GstCaps *caps;
+
+  if (self->caps && self->pool) {
+    gchar *cur_caps_str = gst_caps_to_string (self->caps);
+    gboolean equal = g_strcmp0 (cur_caps_str, caps_str) == 0;
+
+    g_free (cur_caps_str);
+    if (equal)
+      return TRUE;
+  }
+
+  caps = gst_caps_from_string (caps_str);
+  if (!caps || !gst_video_info_from_caps (&self->info, caps)) {
+    GST_ERROR_OBJECT (self, "Invalid caps %s", caps_str);
+    gst_clear_caps (&caps);
+    return FALSE;
+  }
+
+  gst_d3d11_ipc_src_clear_resource (self);
+
+  GST_DEBUG_OBJECT (self, "Setting caps %" GST_PTR_FORMAT, caps);
+
+  if (!gst_pad_set_caps (GST_BASE_SRC_PAD (self), caps)) {
+    GST_ERROR_OBJECT (self, "Couldn't set caps");
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+
+  params = gst_d3d11_allocation_params_new (self->device, &self->info,
+      GST_D3D11_ALLOCATION_FLAG_DEFAULT, D3D11_BIND_SHADER_RESOURCE, 0);
+  self->pool = gst_d3d11_buffer_pool_new_with_options (self->device,
+      caps, params, 0, 0);
+  gst_d3d11_allocation_params_free (params);
+
+  if (!self->pool || !gst_buffer_pool_set_active (self->pool, TRUE)) {
+    GST_ERROR_OBJECT (self, "Couldn't configure pool");
+    gst_clear_object (&self->pool);
+    gst_caps_unref (caps);
+    return FALSE;
+  }
+
+  self->caps = caps;
+
+  return TRUE;
+}
+
+static ID3D11Texture2D *
+gst_d3d11_ipc_src_open_texture (GstD3D11IpcSrc * self, const gchar * name)
+{
+  GstD3D11IpcSrcPrivate *priv = self->priv;
+  ID3D11Device *device_handle;
+  ComPtr < ID3D11Device1 > device1;
+  ComPtr < ID3D11Texture2D > texture;
+  gunichar2 *wname;
+  HRESULT hr;
+
+  /* *INDENT-OFF* */
+  auto it = priv->textures.find (name);
+  /* *INDENT-ON* */
+  if (it != priv->textures.end ())
+    return it->second.Get ();
+
+  device_handle = gst_d3d11_device_get_device_handle (self->device);
+  hr = device_handle->QueryInterface (IID_PPV_ARGS (&device1));
+  if (!gst_d3d11_result (hr, self->device)) {
+    GST_ERROR_OBJECT (self, "ID3D11Device1 interface is not available");
+    return nullptr;
+  }
+
+  wname = g_utf8_to_utf16 (name, -1, nullptr, nullptr, nullptr);
+  hr = device1->OpenSharedResourceByName ((LPCWSTR) wname,
+      DXGI_SHARED_RESOURCE_READ | DXGI_SHARED_RESOURCE_WRITE,
+      IID_PPV_ARGS (&texture));
+  g_free (wname);
+
+  if (!gst_d3d11_result (hr, self->device)) {
+    GST_ERROR_OBJECT (self, "Couldn't open shared texture %s", name);
+    return nullptr;
+  }
+
+  GST_DEBUG_OBJECT (self, "Opened shared texture %s", name);
+
+  priv->textures[name] = texture;
+
+  return texture.Get ();
+}
+
+static GstFlowReturn
+gst_d3d11_ipc_src_copy_texture (GstD3D11IpcSrc * self, const gchar * name,
+    GstBuffer ** buf)
+{
+  ID3D11Texture2D *shared_texture;
+  ID3D11DeviceContext *context;
+  ComPtr < IDXGIKeyedMutex > keyed_mutex;
+  GstBuffer *buffer = nullptr;
+  GstMemory *mem;
+  GstMapInfo map;
+  GstFlowReturn ret;
+  HRESULT hr;
+
+  shared_texture = gst_d3d11_ipc_src_open_texture (self, name);
+  if (!shared_texture)
+    return GST_FLOW_ERROR;
+
+  hr = shared_texture->QueryInterface (IID_PPV_ARGS (&keyed_mutex));
+  if (!gst_d3d11_result (hr, self->device)) {
+    GST_ERROR_OBJECT (self, "Shared texture has no keyed mutex");
+    return GST_FLOW_ERROR;
+  }
+
+  ret = gst_buffer_pool_acquire_buffer (self->pool, &buffer, nullptr);
+  if (ret != GST_FLOW_OK) {
+    GST_ERROR_OBJECT (self, "Couldn't acquire buffer");
+    return ret;
+  }
+
+  mem = gst_buffer_peek_memory (buffer, 0);
+  if (!gst_memory_map (mem, &map,
+          (GstMapFlags) (GST_MAP_WRITE | GST_MAP_D3D11))) {
+    GST_ERROR_OBJECT (self, "Couldn't map memory");
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+
+  context = gst_d3d11_device_get_device_context_handle (self->device);
+
+  {
+    GstD3D11DeviceLockGuard lk (self->device);
+    D3D11_BOX src_box = { 0, };
+
+    hr = keyed_mutex->AcquireSync (GST_D3D11_IPC_KEYED_MUTEX_KEY, INFINITE);
+    if (gst_d3d11_result (hr, self->device)) {
+      /* Shared texture might be larger than ours because of padding */
+      src_box.right = GST_VIDEO_INFO_WIDTH (&self->info);
+      src_box.bottom = GST_VIDEO_INFO_HEIGHT (&self->info);
+      src_box.back = 1;
+
+      context->CopySubresourceRegion ((ID3D11Resource *) map.data,
+          gst_d3d11_memory_get_subresource_index ((GstD3D11Memory *) mem),
+          0, 0, 0, shared_texture, 0, &src_box);
+      keyed_mutex->ReleaseSync (GST_D3D11_IPC_KEYED_MUTEX_KEY);
+    }
+  }
+
+  gst_memory_unmap (mem, &map);
+
+  if (FAILED (hr)) {
+    GST_ERROR_OBJECT (self, "Couldn't acquire keyed mutex");
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+
+  *buf = buffer;
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_d3d11_ipc_src_create (GstBaseSrc * src, guint64 offset, guint size,
+    GstBuffer ** buf)
+{
+  GstD3D11IpcSrc *self = GST_D3D11_IPC_SRC (src);
+  GstFlowReturn ret = GST_FLOW_OK;
+  gint64 adapter_luid;
+  gchar *name = nullptr;
+  gchar *caps_str = nullptr;
+
+  AcquireSRWLockExclusive (&self->lock);
+  if (self->flushing) {
+    ReleaseSRWLockExclusive (&self->lock);
+    return GST_FLOW_FLUSHING;
+  }
+
+  if (!self->client) {
+    gchar *pipe_name;
+
+    GST_OBJECT_LOCK (self);
+    pipe_name = g_strdup (self->pipe_name);
+    GST_OBJECT_UNLOCK (self);
+
+    self->client = gst_d3d11_ipc_client_new (pipe_name);
+    g_free (pipe_name);
+
+    if (!self->client) {
+      ReleaseSRWLockExclusive (&self->lock);
+      GST_ERROR_OBJECT (self, "Couldn't create pipe client");
+      return GST_FLOW_ERROR;
+    }
+  }
+  ReleaseSRWLockExclusive (&self->lock);
+
+  if (!gst_d3d11_ipc_client_get_data (self->client, &adapter_luid, &name,
+          &caps_str)) {
+    AcquireSRWLockExclusive (&self->lock);
+    if (self->flushing) {
+      ret = GST_FLOW_FLUSHING;
+      GST_DEBUG_OBJECT (self, "Flushing");
+    } else {
+      ret = GST_FLOW_EOS;
+      GST_WARNING_OBJECT (self, "Couldn't get data from server");
+    }
+    ReleaseSRWLockExclusive (&self->lock);
+    return ret;
+  }
+
+  if (!gst_d3d11_ipc_src_update_device (self, adapter_luid) ||
+      !gst_d3d11_ipc_src_update_caps (self, caps_str)) {
+    ret = GST_FLOW_NOT_NEGOTIATED;
+  } else {
+    ret = gst_d3d11_ipc_src_copy_texture (self, name, buf);
+  }
+
+  /* The copy is queued on our device already, the producer can reuse
+   * the texture once it acquires the keyed mutex again */
+  gst_d3d11_ipc_client_release_data (self->client, name);
+  g_free (name);
+  g_free (caps_str);
+
+  return ret;
+}
@@ -79,6 +79,8 @@
 #if !GST_D3D11_WINAPI_ONLY_APP
 #include "gstd3d11screencapturesrc.h"
 #include "gstd3d11screencapturedevice.h"
+#include "gstd3d11ipcsink.h"
+#include "gstd3d11ipcsrc.h"
 #endif
 
 #include <wrl.h>
@@ -106,6 +108,7 @@ GST_DEBUG_CATEGORY (gst_d3d11_deinterlace_debug);
 #if !GST_D3D11_WINAPI_ONLY_APP
 GST_DEBUG_CATEGORY (gst_d3d11_screen_capture_debug);
 GST_DEBUG_CATEGORY (gst_d3d11_screen_capture_device_debug);
+GST_DEBUG_CATEGORY (gst_d3d11_ipc_debug);
 #endif
 
 #define GST_CAT_DEFAULT gst_d3d11_debug
@@ -250,6 +253,12 @@ plugin_init (GstPlugin * plugin)
         "d3d11screencapturedeviceprovider", GST_RANK_PRIMARY,
         GST_TYPE_D3D11_SCREEN_CAPTURE_DEVICE_PROVIDER);
   }
+
+  GST_DEBUG_CATEGORY_INIT (gst_d3d11_ipc_debug, "d3d11ipc", 0, "d3d11ipc");
+  gst_element_register (plugin,
+      "d3d11ipcsink", GST_RANK_NONE, GST_TYPE_D3D11_IPC_SINK);
+  gst_element_register (plugin,
+      "d3d11ipcsrc", GST_RANK_NONE, GST_TYPE_D3D11_IPC_SRC);
 #endif
 
   return TRUE;
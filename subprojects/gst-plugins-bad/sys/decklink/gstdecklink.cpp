@@ -1331,6 +1331,22 @@ public:
   }
 };
 
+/* The driver DMAs captured frames straight into these buffers, so they are
+ * page aligned: the pages it pins are then not shared with other
+ * allocations and whole-page DMA transfers can be used. It also allows
+ * aligned AVX2 operations on the frames for example. */
+#define DECKLINK_BUFFER_ALIGN 4096
+
+/* Stored right before each aligned buffer */
+typedef struct
+{
+  void *alloc;
+  uint32_t size;
+} GstDecklinkBufferHeader;
+
+#define DECKLINK_BUFFER_HEADER(buf) \
+  (((GstDecklinkBufferHeader *) (buf)) - 1)
+
 class GStreamerDecklinkMemoryAllocator:public IDeckLinkMemoryAllocator
 {
 private:
@@ -1340,6 +1356,11 @@ private:
   GstQueueArray *m_buffers;
   gint m_refcount;
 
+  static void _freeBuffer (uint8_t * buf)
+  {
+    g_free (DECKLINK_BUFFER_HEADER (buf)->alloc);
+  }
+
   void _clearBufferPool ()
   {
     uint8_t *buf;
@@ -1347,11 +1368,8 @@ private:
     if (!m_buffers)
         return;
 
-    while ((buf = (uint8_t *) gst_queue_array_pop_head (m_buffers))) {
-      uint8_t offset = *(buf - 1);
-      void *alloc_buf = buf - 128 + offset;
-        g_free (alloc_buf);
-    }
+    while ((buf = (uint8_t *) gst_queue_array_pop_head (m_buffers)))
+      _freeBuffer (buf);
   }
 
 public:
@@ -1411,7 +1429,6 @@ public:
       AllocateBuffer (uint32_t bufferSize, void **allocatedBuffer)
   {
     uint8_t *buf;
-    uint8_t offset = 0;
 
     g_mutex_lock (&m_mutex);
 
@@ -1423,25 +1440,18 @@ public:
 
     /* Look if there is a free buffer in the pool */
     if (!(buf = (uint8_t *) gst_queue_array_pop_head (m_buffers))) {
-      /* If not, alloc a new one */
-      buf = (uint8_t *) g_malloc (bufferSize + 128);
-
-      /* The Decklink SDK requires 16 byte aligned memory at least but for us
-       * to work nicely let's align to 64 bytes (512 bits) as this allows
-       * aligned AVX2 operations for example */
-      if (((guintptr) buf) % 64 != 0) {
-        offset = ((guintptr) buf) % 64;
-      }
-
-      /* Write the allocation size at the very beginning. It's guaranteed by
-       * malloc() to be allocated aligned enough for doing this. */
-      *((uint32_t *) buf) = bufferSize;
-
-      /* Align our buffer */
-      buf += 128 - offset;
-
-      /* And write the alignment offset right before the buffer */
-      *(buf - 1) = offset;
+      /* If not, alloc a new one. The Decklink SDK requires 16 byte aligned
+       * memory at least, see DECKLINK_BUFFER_ALIGN for why we use more */
+      void *alloc = g_malloc (bufferSize + DECKLINK_BUFFER_ALIGN +
+          sizeof (GstDecklinkBufferHeader));
+      guintptr addr = (guintptr) alloc + sizeof (GstDecklinkBufferHeader);
+
+      addr = (addr + DECKLINK_BUFFER_ALIGN - 1) &
+          ~((guintptr) DECKLINK_BUFFER_ALIGN - 1);
+      buf = (uint8_t *) addr;
+
+      DECKLINK_BUFFER_HEADER (buf)->alloc = alloc;
+      DECKLINK_BUFFER_HEADER (buf)->size = bufferSize;
     }
     *allocatedBuffer = (void *) buf;
 
@@ -1450,9 +1460,7 @@ public:
     if (gst_queue_array_get_length (m_buffers) > 0) {
       if (++m_nonEmptyCalls >= 5) {
         buf = (uint8_t *) gst_queue_array_pop_head (m_buffers);
-        uint8_t offset = *(buf - 1);
-        void *alloc_buf = buf - 128 + offset;
-        g_free (alloc_buf);
+        _freeBuffer (buf);
         m_nonEmptyCalls = 0;
       }
     } else {
@@ -1469,13 +1477,10 @@ public:
     g_mutex_lock (&m_mutex);
 
     /* Put the buffer back to the pool if size matches with current pool */
-    uint8_t offset = *(((uint8_t *) buffer) - 1);
-    uint8_t *alloc_buffer = ((uint8_t *) buffer) - 128 + offset;
-    uint32_t size = *(uint32_t *) alloc_buffer;
-    if (size == m_lastBufferSize) {
+    if (DECKLINK_BUFFER_HEADER (buffer)->size == m_lastBufferSize) {
       gst_queue_array_push_tail (m_buffers, buffer);
     } else {
-      g_free (alloc_buffer);
+      _freeBuffer ((uint8_t *) buffer);
     }
 
     g_mutex_unlock (&m_mutex);
@@ -2101,12 +2101,17 @@ gst_decklink_video_sink_propose_allocation (GstBaseSink * bsink,
   if (gst_query_get_n_allocation_pools (query) == 0) {
     GstStructure *structure;
     GstAllocator *allocator = NULL;
-    GstAllocationParams params = { (GstMemoryFlags) 0, 15, 0, 0 };
+    /* The frames are handed to the driver without copying, which DMAs
+     * them out of page aligned memory most efficiently */
+    GstAllocationParams params = { (GstMemoryFlags) 0, 4095, 0, 0 };
 
-    if (gst_query_get_n_allocation_params (query) > 0)
+    if (gst_query_get_n_allocation_params (query) > 0) {
       gst_query_parse_nth_allocation_param (query, 0, &allocator, &params);
-    else
+      params.align |= 4095;
+      gst_query_set_nth_allocation_param (query, 0, allocator, &params);
+    } else {
       gst_query_add_allocation_param (query, allocator, &params);
+    }
 
     pool = gst_video_buffer_pool_new ();
 
@@ -32,10 +32,16 @@
 #  define ssize_t int
 #  include <winsock2.h>
 #endif
+#ifdef G_OS_UNIX
+#  include <sys/types.h>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#endif
 #include <errno.h>
 #include <string.h>
 #include <gst/base/gstbytewriter.h>
 #include <gst/gstprotection.h>
+#include <gst/allocators/allocators.h>
 #include "gstipcpipelinecomm.h"
 
 GST_DEBUG_CATEGORY_STATIC (gst_ipc_pipeline_comm_debug);
@@ -43,6 +49,12 @@ GST_DEBUG_CATEGORY_STATIC (gst_ipc_pipeline_comm_debug);
 
 #define DEFAULT_ACK_TIME (10 * G_TIME_SPAN_SECOND)
 
+/* maximum number of fds passed along with a single buffer, one per memory */
+#define MAX_PASSED_FDS 16
+/* flags, offset and size of each passed memory */
+#define FD_MEMORY_DESC_SIZE (4 + 8 + 8)
+#define FD_MEMORY_FLAG_DMABUF (1 << 0)
+
 GQuark QUARK_ID;
 
 typedef enum
@@ -193,6 +205,8 @@ gst_ipc_pipeline_comm_data_type_get_name (GstIpcPipelineCommDataType type)
       return "MESSAGE";
     case GST_IPC_PIPELINE_COMM_DATA_TYPE_GERROR_MESSAGE:
       return "GERROR_MESSAGE";
+    case GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER:
+      return "FD_BUFFER";
     default:
       return "UNKNOWN";
   }
@@ -278,6 +292,102 @@ write_byte_writer_to_fd (GstIpcPipelineComm * comm, GstByteWriter * bw)
   return ret;
 }
 
+#ifdef G_OS_UNIX
+/* Same as write_byte_writer_to_fd(), but passes @fds along with the data */
+static gboolean
+write_byte_writer_with_fds_to_fd (GstIpcPipelineComm * comm,
+    GstByteWriter * bw, const int *fds, guint n_fds)
+{
+  char control[CMSG_SPACE (sizeof (int) * MAX_PASSED_FDS)];
+  struct msghdr msg;
+  struct iovec iov;
+  struct cmsghdr *cmsg;
+  ssize_t written;
+  guint8 *data;
+  gboolean ret;
+  guint size;
+
+  g_return_val_if_fail (n_fds > 0 && n_fds <= MAX_PASSED_FDS, FALSE);
+
+  size = gst_byte_writer_get_size (bw);
+  data = gst_byte_writer_reset_and_get_data (bw);
+  if (!data)
+    return FALSE;
+
+  memset (&msg, 0, sizeof (msg));
+  memset (control, 0, sizeof (control));
+  iov.iov_base = data;
+  iov.iov_len = size;
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = CMSG_SPACE (sizeof (int) * n_fds);
+
+  cmsg = CMSG_FIRSTHDR (&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN (sizeof (int) * n_fds);
+  memcpy (CMSG_DATA (cmsg), fds, sizeof (int) * n_fds);
+
+  GST_TRACE_OBJECT (comm->element, "Writing %u bytes and %u fds to fdout",
+      size, n_fds);
+  do {
+    written = sendmsg (comm->fdout, &msg, 0);
+  } while (written < 0 && (errno == EAGAIN || errno == EINTR));
+
+  if (written < 0) {
+    GST_ERROR_OBJECT (comm->element, "Failed to write to fd: %s",
+        strerror (errno));
+    ret = FALSE;
+  } else {
+    /* the fds went with the first chunk, write the rest normally */
+    ret = write_to_fd_raw (comm, data + written, size - written);
+  }
+
+  g_free (data);
+  return ret;
+}
+
+static gboolean
+can_pass_buffer_fds (GstIpcPipelineComm * comm, GstBuffer * buffer)
+{
+  struct stat st;
+  guint i, n_mem;
+
+  if (!comm->pass_fds)
+    return FALSE;
+
+  n_mem = gst_buffer_n_memory (buffer);
+  if (n_mem == 0 || n_mem > MAX_PASSED_FDS)
+    return FALSE;
+
+  for (i = 0; i < n_mem; i++) {
+    if (!gst_is_fd_memory (gst_buffer_peek_memory (buffer, i)))
+      return FALSE;
+  }
+
+  /* fds can only be passed over unix domain sockets, not pipes */
+  if (fstat (comm->fdout, &st) < 0 || !S_ISSOCK (st.st_mode))
+    return FALSE;
+
+  return TRUE;
+}
+#else
+static gboolean
+write_byte_writer_with_fds_to_fd (GstIpcPipelineComm * comm,
+    GstByteWriter * bw, const int *fds, guint n_fds)
+{
+  g_assert_not_reached ();
+  return FALSE;
+}
+
+static gboolean
+can_pass_buffer_fds (GstIpcPipelineComm * comm, GstBuffer * buffer)
+{
+  return FALSE;
+}
+#endif
+
 static void
 gst_ipc_pipeline_comm_write_ack_to_fd (GstIpcPipelineComm * comm, guint32 id,
     guint32 ret, CommRequestType type)
@@ -523,7 +633,7 @@ GstFlowReturn
 gst_ipc_pipeline_comm_write_buffer_to_fd (GstIpcPipelineComm * comm,
     GstBuffer * buffer)
 {
-  const unsigned char payload_type = GST_IPC_PIPELINE_COMM_DATA_TYPE_BUFFER;
+  unsigned char payload_type = GST_IPC_PIPELINE_COMM_DATA_TYPE_BUFFER;
   GstMapInfo map;
   guint32 ret32 = GST_FLOW_OK;
   guint32 size, n;
@@ -531,10 +641,19 @@ gst_ipc_pipeline_comm_write_buffer_to_fd (GstIpcPipelineComm * comm,
   GstFlowReturn ret;
   MetaListRepresentation repr = { comm, 0, 4, NULL };   /* starts a 4 for n_meta */
   GstByteWriter bw;
+  gboolean pass_fds;
+  int fds[MAX_PASSED_FDS];
+  guint n_mem = 0;
 
   g_mutex_lock (&comm->mutex);
   ++comm->send_id;
 
+  pass_fds = can_pass_buffer_fds (comm, buffer);
+  if (pass_fds) {
+    payload_type = GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER;
+    n_mem = gst_buffer_n_memory (buffer);
+  }
+
   GST_TRACE_OBJECT (comm->element, "Writing buffer %u: %" GST_PTR_FORMAT,
       comm->send_id, buffer);
 
@@ -554,25 +673,51 @@ gst_ipc_pipeline_comm_write_buffer_to_fd (GstIpcPipelineComm * comm,
     goto write_failed;
   if (!gst_byte_writer_put_uint32_le (&bw, comm->send_id))
     goto write_failed;
-  size =
-      gst_buffer_get_size (buffer) + sizeof (guint32) +
-      sizeof (CommBufferMetadata) + repr.total_bytes;
+  if (pass_fds)
+    size = n_mem * FD_MEMORY_DESC_SIZE;
+  else
+    size = gst_buffer_get_size (buffer);
+  size += sizeof (guint32) + sizeof (CommBufferMetadata) + repr.total_bytes;
   if (!gst_byte_writer_put_uint32_le (&bw, size))
     goto write_failed;
   if (!gst_byte_writer_put_data (&bw, (const guint8 *) &meta, sizeof (meta)))
     goto write_failed;
-  size = gst_buffer_get_size (buffer);
-  if (!gst_byte_writer_put_uint32_le (&bw, size))
-    goto write_failed;
-  if (!write_byte_writer_to_fd (comm, &bw))
-    goto write_failed;
 
-  if (!gst_buffer_map (buffer, &map, GST_MAP_READ))
-    goto map_failed;
-  ret = write_to_fd_raw (comm, map.data, map.size);
-  gst_buffer_unmap (buffer, &map);
-  if (!ret)
-    goto write_failed;
+  if (pass_fds) {
+    /* the peer maps the same memory, only describe where the data is */
+    if (!gst_byte_writer_put_uint32_le (&bw, n_mem))
+      goto write_failed;
+    for (n = 0; n < n_mem; ++n) {
+      GstMemory *mem = gst_buffer_peek_memory (buffer, n);
+      guint32 flags = 0;
+
+      if (gst_is_dmabuf_memory (mem))
+        flags |= FD_MEMORY_FLAG_DMABUF;
+      fds[n] = gst_fd_memory_get_fd (mem);
+
+      if (!gst_byte_writer_put_uint32_le (&bw, flags))
+        goto write_failed;
+      if (!gst_byte_writer_put_uint64_le (&bw, mem->offset))
+        goto write_failed;
+      if (!gst_byte_writer_put_uint64_le (&bw, mem->size))
+        goto write_failed;
+    }
+    if (!write_byte_writer_with_fds_to_fd (comm, &bw, fds, n_mem))
+      goto write_failed;
+  } else {
+    size = gst_buffer_get_size (buffer);
+    if (!gst_byte_writer_put_uint32_le (&bw, size))
+      goto write_failed;
+    if (!write_byte_writer_to_fd (comm, &bw))
+      goto write_failed;
+
+    if (!gst_buffer_map (buffer, &map, GST_MAP_READ))
+      goto map_failed;
+    ret = write_to_fd_raw (comm, map.data, map.size);
+    gst_buffer_unmap (buffer, &map);
+    if (!ret)
+      goto write_failed;
+  }
 
   /* meta */
   gst_byte_writer_init (&bw);
@@ -643,8 +788,75 @@ map_failed:
   goto done;
 }
 
+/* Wraps the next @n_mem passed fds, described in the adapter, in a buffer */
 static GstBuffer *
-gst_ipc_pipeline_comm_read_buffer (GstIpcPipelineComm * comm, guint32 size)
+gst_ipc_pipeline_comm_read_fd_memories (GstIpcPipelineComm * comm,
+    guint32 n_mem, guint32 * size)
+{
+  GstBuffer *buffer;
+  const guint8 *payload;
+  guint32 mapped_size, n;
+
+  if (n_mem > MAX_PASSED_FDS || *size < n_mem * FD_MEMORY_DESC_SIZE) {
+    GST_ERROR_OBJECT (comm->element, "Invalid fd buffer with %u memories",
+        n_mem);
+    return NULL;
+  }
+
+  mapped_size = n_mem * FD_MEMORY_DESC_SIZE;
+  payload = gst_adapter_map (comm->adapter, mapped_size);
+  if (!payload)
+    return NULL;
+
+  buffer = gst_buffer_new ();
+  for (n = 0; n < n_mem; ++n) {
+    GstMemory *mem;
+    guint32 flags;
+    guint64 offset, msize;
+    int fd;
+
+    memcpy (&flags, payload, sizeof (flags));
+    payload += sizeof (flags);
+    memcpy (&offset, payload, sizeof (offset));
+    payload += sizeof (offset);
+    memcpy (&msize, payload, sizeof (msize));
+    payload += sizeof (msize);
+
+    if (g_queue_is_empty (&comm->passed_fds)) {
+      GST_ERROR_OBJECT (comm->element, "Missing fd for memory %u", n);
+      gst_buffer_unref (buffer);
+      buffer = NULL;
+      break;
+    }
+    fd = GPOINTER_TO_INT (g_queue_pop_head (&comm->passed_fds));
+
+    /* the memory takes ownership of the fd */
+    if (flags & FD_MEMORY_FLAG_DMABUF)
+      mem = gst_dmabuf_allocator_alloc (comm->dmabuf_allocator, fd,
+          offset + msize);
+    else
+      mem = gst_fd_allocator_alloc (comm->fd_allocator, fd, offset + msize,
+          GST_FD_MEMORY_FLAG_NONE);
+    if (!mem) {
+      GST_ERROR_OBJECT (comm->element, "Failed to wrap fd %d", fd);
+      gst_buffer_unref (buffer);
+      buffer = NULL;
+      break;
+    }
+    gst_memory_resize (mem, offset, msize);
+    gst_buffer_append_memory (buffer, mem);
+  }
+
+  gst_adapter_unmap (comm->adapter);
+  gst_adapter_flush (comm->adapter, mapped_size);
+  *size -= mapped_size;
+
+  return buffer;
+}
+
+static GstBuffer *
+gst_ipc_pipeline_comm_read_buffer (GstIpcPipelineComm * comm, guint32 size,
+    gboolean with_fds)
 {
   GstBuffer *buffer;
   CommBufferMetadata meta;
@@ -667,13 +879,21 @@ gst_ipc_pipeline_comm_read_buffer (GstIpcPipelineComm * comm, guint32 size)
   gst_adapter_unmap (comm->adapter);
   gst_adapter_flush (comm->adapter, mapped_size);
 
-  if (buffer_data_size == 0) {
-    buffer = gst_buffer_new ();
+  if (with_fds) {
+    /* buffer_data_size is the number of memories here */
+    buffer =
+        gst_ipc_pipeline_comm_read_fd_memories (comm, buffer_data_size, &size);
+    if (!buffer)
+      return NULL;
   } else {
-    buffer = gst_adapter_get_buffer (comm->adapter, buffer_data_size);
-    gst_adapter_flush (comm->adapter, buffer_data_size);
+    if (buffer_data_size == 0) {
+      buffer = gst_buffer_new ();
+    } else {
+      buffer = gst_adapter_get_buffer (comm->adapter, buffer_data_size);
+      gst_adapter_flush (comm->adapter, buffer_data_size);
+    }
+    size -= buffer_data_size;
   }
-  size -= buffer_data_size;
 
   GST_BUFFER_PTS (buffer) = meta.pts;
   GST_BUFFER_DTS (buffer) = meta.dts;
@@ -1630,11 +1850,25 @@ gst_ipc_pipeline_comm_init (GstIpcPipelineComm * comm, GstElement * element)
   comm->adapter = gst_adapter_new ();
   comm->poll = gst_poll_new (TRUE);
   gst_poll_fd_init (&comm->pollFDin);
+  g_queue_init (&comm->passed_fds);
+  comm->fd_allocator = gst_fd_allocator_new ();
+  comm->dmabuf_allocator = gst_dmabuf_allocator_new ();
+}
+
+static void
+close_passed_fd (gpointer data)
+{
+#ifdef G_OS_UNIX
+  close (GPOINTER_TO_INT (data));
+#endif
 }
 
 void
 gst_ipc_pipeline_comm_clear (GstIpcPipelineComm * comm)
 {
+  g_queue_clear_full (&comm->passed_fds, close_passed_fd);
+  gst_object_unref (comm->fd_allocator);
+  gst_object_unref (comm->dmabuf_allocator);
   g_hash_table_destroy (comm->waiting_ids);
   gst_object_unref (comm->adapter);
   gst_poll_free (comm->poll);
@@ -1745,6 +1979,12 @@ again:
       gst_poll_fd_init (&comm->pollFDin);
     }
     if (comm->fdin != -1 && GST_OBJECT_PARENT (comm->element)) {
+#ifdef G_OS_UNIX
+      struct stat st;
+
+      comm->fdin_is_socket = fstat (comm->fdin, &st) == 0 &&
+          S_ISSOCK (st.st_mode);
+#endif
       GST_DEBUG_OBJECT (comm->element, "Start watching fd %d", comm->fdin);
       comm->pollFDin.fd = comm->fdin;
       gst_poll_add_fd (comm->poll, &comm->pollFDin);
@@ -1779,7 +2019,45 @@ again:
       }
     }
 #else
-    sz = read (comm->pollFDin.fd, map.data, map.size);
+#ifdef G_OS_UNIX
+    if (comm->fdin_is_socket) {
+      char control[CMSG_SPACE (sizeof (int) * MAX_PASSED_FDS)];
+      struct msghdr msg;
+      struct iovec iov;
+      struct cmsghdr *cmsg;
+      int flags = 0;
+
+      memset (&msg, 0, sizeof (msg));
+      iov.iov_base = map.data;
+      iov.iov_len = map.size;
+      msg.msg_iov = &iov;
+      msg.msg_iovlen = 1;
+      msg.msg_control = control;
+      msg.msg_controllen = sizeof (control);
+#ifdef MSG_CMSG_CLOEXEC
+      flags |= MSG_CMSG_CLOEXEC;
+#endif
+
+      sz = recvmsg (comm->pollFDin.fd, &msg, flags);
+
+      /* keep the fds in order, they are consumed by the fd buffers */
+      for (cmsg = CMSG_FIRSTHDR (&msg); sz > 0 && cmsg;
+          cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+        const int *fds = (const int *) CMSG_DATA (cmsg);
+        guint i, n_fds;
+
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+          continue;
+
+        n_fds = (cmsg->cmsg_len - CMSG_LEN (0)) / sizeof (int);
+        for (i = 0; i < n_fds; i++)
+          g_queue_push_tail (&comm->passed_fds, GINT_TO_POINTER (fds[i]));
+      }
+    } else
+#endif
+    {
+      sz = read (comm->pollFDin.fd, map.data, map.size);
+    }
 #endif
     gst_memory_unmap (mem, &map);
 
@@ -1845,6 +2123,7 @@ read_many (GstIpcPipelineComm * comm)
           case GST_IPC_PIPELINE_COMM_DATA_TYPE_STATE_LOST:
           case GST_IPC_PIPELINE_COMM_DATA_TYPE_MESSAGE:
           case GST_IPC_PIPELINE_COMM_DATA_TYPE_GERROR_MESSAGE:
+          case GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER:
             GST_TRACE_OBJECT (comm->element, "switching to state %s",
                 gst_ipc_pipeline_comm_data_type_get_name (type));
             comm->state = type;
@@ -1909,6 +2188,7 @@ read_many (GstIpcPipelineComm * comm)
         break;
       }
       case GST_IPC_PIPELINE_COMM_DATA_TYPE_BUFFER:
+      case GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER:
       {
         GstBuffer *buf;
 
@@ -1916,7 +2196,8 @@ read_many (GstIpcPipelineComm * comm)
         if (available < comm->payload_length)
           goto done;
 
-        buf = gst_ipc_pipeline_comm_read_buffer (comm, comm->payload_length);
+        buf = gst_ipc_pipeline_comm_read_buffer (comm, comm->payload_length,
+            comm->state == GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER);
         if (!buf)
           goto buffer_failed;
 
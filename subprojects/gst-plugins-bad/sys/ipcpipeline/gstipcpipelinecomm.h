@@ -51,6 +51,7 @@ typedef enum {
   GST_IPC_PIPELINE_COMM_DATA_TYPE_STATE_LOST,
   GST_IPC_PIPELINE_COMM_DATA_TYPE_MESSAGE,
   GST_IPC_PIPELINE_COMM_DATA_TYPE_GERROR_MESSAGE,
+  GST_IPC_PIPELINE_COMM_DATA_TYPE_FD_BUFFER,
 } GstIpcPipelineCommDataType;
 
 typedef struct
@@ -76,6 +77,14 @@ typedef struct
   guint read_chunk_size;
   GstClockTime ack_time;
 
+  /* pass fd backed memory over the socket instead of its contents */
+  gboolean pass_fds;
+  gboolean fdin_is_socket;
+  /* fds received from the peer, not yet wrapped in a buffer */
+  GQueue passed_fds;
+  GstAllocator *fd_allocator;
+  GstAllocator *dmabuf_allocator;
+
   void (*on_buffer) (guint32, GstBuffer *, gpointer);
   void (*on_event) (guint32, GstEvent *, gboolean, gpointer);
   void (*on_query) (guint32, GstQuery *, gboolean, gpointer);
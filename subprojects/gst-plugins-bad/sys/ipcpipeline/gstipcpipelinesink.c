@@ -66,7 +66,11 @@
  * GError are serialized differently).
  *
  * Buffers are transported by writing their content directly on the socket.
- * More efficient ways for memory sharing could be implemented in the future.
+ * When #GstIpcPipelineSink:pass-fds is enabled and the peer is connected
+ * through a unix domain socket, buffers backed by file descriptors (memfd,
+ * DMABuf) are instead passed by sending their file descriptors, so that the
+ * data is not copied. Upstream is then offered memfd backed memory in the
+ * allocation query.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -76,6 +80,13 @@
 #include "gstipcpipelineelements.h"
 #include "gstipcpipelinesink.h"
 
+#include <gst/allocators/allocators.h>
+#ifdef HAVE_MEMFD_CREATE
+#  include <errno.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -99,11 +110,83 @@ enum
   PROP_FDOUT,
   PROP_READ_CHUNK_SIZE,
   PROP_ACK_TIME,
+  PROP_PASS_FDS,
 };
 
 
 #define DEFAULT_READ_CHUNK_SIZE 4096
 #define DEFAULT_ACK_TIME (10 * G_TIME_SPAN_SECOND)
+#define DEFAULT_PASS_FDS FALSE
+
+#ifdef HAVE_MEMFD_CREATE
+/* Allocator for the memory proposed to upstream when passing fds: every
+ * memory is a new memfd, so that the sender never reuses memory that the
+ * peer may still be reading from */
+typedef struct
+{
+  GstFdAllocator parent;
+} GstIpcMemfdAllocator;
+
+typedef struct
+{
+  GstFdAllocatorClass parent_class;
+} GstIpcMemfdAllocatorClass;
+
+static GType gst_ipc_memfd_allocator_get_type (void);
+G_DEFINE_TYPE (GstIpcMemfdAllocator, gst_ipc_memfd_allocator,
+    GST_TYPE_FD_ALLOCATOR);
+
+static GstMemory *
+gst_ipc_memfd_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+  GstMemory *mem;
+  gsize maxsize;
+  int fd;
+
+  maxsize = size + params->prefix + params->padding;
+
+  fd = memfd_create ("gst-ipcpipeline", MFD_CLOEXEC);
+  if (fd < 0) {
+    GST_ERROR_OBJECT (allocator, "memfd_create failed: %s",
+        g_strerror (errno));
+    return NULL;
+  }
+
+  if (ftruncate (fd, maxsize) < 0) {
+    GST_ERROR_OBJECT (allocator, "ftruncate failed: %s", g_strerror (errno));
+    close (fd);
+    return NULL;
+  }
+
+  mem = gst_fd_allocator_alloc (allocator, fd, maxsize,
+      GST_FD_MEMORY_FLAG_NONE);
+  if (!mem) {
+    close (fd);
+    return NULL;
+  }
+  gst_memory_resize (mem, params->prefix, size);
+
+  return mem;
+}
+
+static void
+gst_ipc_memfd_allocator_class_init (GstIpcMemfdAllocatorClass * klass)
+{
+  GstAllocatorClass *alloc_class = (GstAllocatorClass *) klass;
+
+  alloc_class->alloc = GST_DEBUG_FUNCPTR (gst_ipc_memfd_allocator_alloc);
+}
+
+static void
+gst_ipc_memfd_allocator_init (GstIpcMemfdAllocator * self)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (self);
+
+  alloc->mem_type = "ipcmemfd";
+  GST_OBJECT_FLAG_UNSET (self, GST_ALLOCATOR_FLAG_CUSTOM_ALLOC);
+}
+#endif
 
 #define _do_init \
     GST_DEBUG_CATEGORY_INIT (gst_ipc_pipeline_sink_debug, "ipcpipelinesink", 0, "ipcpipelinesink element");
@@ -179,6 +262,25 @@ gst_ipc_pipeline_sink_class_init (GstIpcPipelineSinkClass * klass)
           0, G_MAXUINT64, DEFAULT_ACK_TIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstIpcPipelineSink:pass-fds:
+   *
+   * Pass buffers whose memory is backed by file descriptors to the peer by
+   * sending the file descriptors over the socket, instead of writing the
+   * buffer contents. This requires fdout to be a unix domain socket and the
+   * peer to support it, other buffers are still written to the socket.
+   *
+   * Memory allocated from an anonymous memfd is proposed to upstream in the
+   * allocation query so that the data is never copied.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PASS_FDS,
+      g_param_spec_boolean ("pass-fds", "Pass fds",
+          "Pass file descriptor backed memory over the socket instead of "
+          "copying it", DEFAULT_PASS_FDS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_ipc_pipeline_sink_signals[SIGNAL_DISCONNECT] =
       g_signal_new ("disconnect",
       G_TYPE_FROM_CLASS (klass),
@@ -214,6 +316,7 @@ gst_ipc_pipeline_sink_init (GstIpcPipelineSink * sink)
   gst_ipc_pipeline_comm_init (&sink->comm, GST_ELEMENT (sink));
   sink->comm.read_chunk_size = DEFAULT_READ_CHUNK_SIZE;
   sink->comm.ack_time = DEFAULT_ACK_TIME;
+  sink->comm.pass_fds = DEFAULT_PASS_FDS;
   sink->comm.fdin = -1;
   sink->comm.fdout = -1;
   sink->threads = g_thread_pool_new (pusher, sink, -1, FALSE, NULL);
@@ -252,6 +355,7 @@ gst_ipc_pipeline_sink_finalize (GObject * obj)
 
   gst_ipc_pipeline_comm_clear (&sink->comm);
   g_thread_pool_free (sink->threads, TRUE, TRUE);
+  gst_clear_object (&sink->allocator);
 
   G_OBJECT_CLASS (parent_class)->finalize (obj);
 }
@@ -275,6 +379,9 @@ gst_ipc_pipeline_sink_set_property (GObject * object, guint prop_id,
     case PROP_ACK_TIME:
       sink->comm.ack_time = g_value_get_uint64 (value);
       break;
+    case PROP_PASS_FDS:
+      sink->comm.pass_fds = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -300,6 +407,9 @@ gst_ipc_pipeline_sink_get_property (GObject * object, guint prop_id,
     case PROP_ACK_TIME:
       g_value_set_uint64 (value, sink->comm.ack_time);
       break;
+    case PROP_PASS_FDS:
+      g_value_set_boolean (value, sink->comm.pass_fds);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -348,6 +458,18 @@ gst_ipc_pipeline_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
 
   switch (GST_QUERY_TYPE (query)) {
     case GST_QUERY_ALLOCATION:
+#ifdef HAVE_MEMFD_CREATE
+      if (sink->comm.pass_fds) {
+        GST_OBJECT_LOCK (sink);
+        if (!sink->allocator)
+          sink->allocator = g_object_new (gst_ipc_memfd_allocator_get_type (),
+              NULL);
+        gst_query_add_allocation_param (query, sink->allocator, NULL);
+        GST_OBJECT_UNLOCK (sink);
+        GST_DEBUG_OBJECT (sink, "Proposing memfd allocator");
+        return TRUE;
+      }
+#endif
       GST_DEBUG_OBJECT (sink, "Rejecting ALLOCATION query");
       return FALSE;
     case GST_QUERY_CAPS:
@@ -52,6 +52,9 @@ struct _GstIpcPipelineSink {
   GThreadPool *threads;
   gboolean pass_next_async_done;
   GstPad *sinkpad;
+
+  /* proposed to upstream when passing fds */
+  GstAllocator *allocator;
 };
 
 struct _GstIpcPipelineSinkClass {
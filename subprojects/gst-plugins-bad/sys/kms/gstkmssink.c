@@ -79,6 +79,7 @@ static GstFlowReturn gst_kms_sink_show_frame (GstVideoSink * vsink,
     GstBuffer * buf);
 static void gst_kms_sink_video_overlay_init (GstVideoOverlayInterface * iface);
 static void gst_kms_sink_drain (GstKMSSink * self);
+static gboolean gst_kms_sink_wait_flip (GstKMSSink * self);
 
 #define parent_class gst_kms_sink_parent_class
 G_DEFINE_TYPE_WITH_CODE (GstKMSSink, gst_kms_sink, GST_TYPE_VIDEO_SINK,
@@ -105,6 +106,7 @@ enum
   PROP_PLANE_PROPS,
   PROP_FD,
   PROP_SKIP_VSYNC,
+  PROP_ATOMIC,
   PROP_N,
 };
 
@@ -1013,6 +1015,62 @@ gst_kms_sink_update_plane_properties (GstKMSSink * self)
   gst_kms_sink_update_properties (&iter, self->plane_props);
 }
 
+static gboolean
+gst_kms_sink_find_plane_prop_ids (GstKMSSink * self)
+{
+  drmModeObjectPropertiesPtr properties;
+  guint i;
+  struct
+  {
+    const gchar *name;
+    guint32 *id;
+  } props[] = {
+    {"FB_ID", &self->plane_prop_ids.fb_id},
+    {"CRTC_ID", &self->plane_prop_ids.crtc_id},
+    {"SRC_X", &self->plane_prop_ids.src_x},
+    {"SRC_Y", &self->plane_prop_ids.src_y},
+    {"SRC_W", &self->plane_prop_ids.src_w},
+    {"SRC_H", &self->plane_prop_ids.src_h},
+    {"CRTC_X", &self->plane_prop_ids.crtc_x},
+    {"CRTC_Y", &self->plane_prop_ids.crtc_y},
+    {"CRTC_W", &self->plane_prop_ids.crtc_w},
+    {"CRTC_H", &self->plane_prop_ids.crtc_h},
+  };
+
+  properties = drmModeObjectGetProperties (self->fd, self->plane_id,
+      DRM_MODE_OBJECT_PLANE);
+  if (!properties)
+    return FALSE;
+
+  for (i = 0; i < G_N_ELEMENTS (props); i++)
+    *props[i].id = 0;
+
+  for (i = 0; i < properties->count_props; i++) {
+    drmModePropertyPtr property;
+    guint j;
+
+    property = drmModeGetProperty (self->fd, properties->props[i]);
+    if (!property)
+      continue;
+
+    for (j = 0; j < G_N_ELEMENTS (props); j++) {
+      if (!strcmp (property->name, props[j].name))
+        *props[j].id = property->prop_id;
+    }
+    drmModeFreeProperty (property);
+  }
+  drmModeFreeObjectProperties (properties);
+
+  for (i = 0; i < G_N_ELEMENTS (props); i++) {
+    if (*props[i].id == 0) {
+      GST_WARNING_OBJECT (self, "plane has no %s property", props[i].name);
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
 static gboolean
 gst_kms_sink_start (GstBaseSink * bsink)
 {
@@ -1100,6 +1158,18 @@ retry_find_plane:
   GST_INFO_OBJECT (self, "connector id = %d / crtc id = %d / plane id = %d",
       self->conn_id, self->crtc_id, self->plane_id);
 
+  /* The plane is chosen before enabling atomic, which also exposes the
+   * primary and cursor planes */
+  self->has_atomic = FALSE;
+  if (self->atomic && !self->modesetting_enabled) {
+    if (drmSetClientCap (self->fd, DRM_CLIENT_CAP_ATOMIC, 1))
+      GST_WARNING_OBJECT (self, "driver does not support atomic modesetting");
+    else if (gst_kms_sink_find_plane_prop_ids (self))
+      self->has_atomic = TRUE;
+  }
+  GST_INFO_OBJECT (self, "atomic modesetting (%s)",
+      self->has_atomic ? "✓" : "✗");
+
   GST_OBJECT_LOCK (self);
   self->hdisplay = crtc->mode.hdisplay;
   self->vdisplay = crtc->mode.vdisplay;
@@ -1232,8 +1302,18 @@ gst_kms_sink_stop (GstBaseSink * bsink)
   if (self->allocator)
     gst_kms_allocator_clear_cache (self->allocator);
 
+  if (self->has_atomic) {
+    GST_OBJECT_LOCK (self);
+    gst_kms_sink_wait_flip (self);
+    GST_OBJECT_UNLOCK (self);
+    self->has_atomic = FALSE;
+  }
+
+  gst_buffer_replace (&self->prev_buffer, NULL);
   gst_buffer_replace (&self->last_buffer, NULL);
   gst_caps_replace (&self->allowed_caps, NULL);
+  self->vblank_time = GST_CLOCK_TIME_NONE;
+  self->refresh_interval = GST_CLOCK_TIME_NONE;
   gst_object_replace ((GstObject **) & self->pool, NULL);
   gst_object_replace ((GstObject **) & self->allocator, NULL);
 
@@ -1571,20 +1651,75 @@ no_pool:
   }
 }
 
+typedef struct
+{
+  gboolean waiting;
+  guint sequence;
+  GstClockTime timestamp;
+} GstKMSSinkSyncData;
+
 static void
 sync_handler (gint fd, guint frame, guint sec, guint usec, gpointer data)
 {
-  gboolean *waiting;
+  GstKMSSinkSyncData *sync_data = data;
+
+  sync_data->sequence = frame;
+  /* CLOCK_MONOTONIC, unless the driver lacks DRM_CAP_TIMESTAMP_MONOTONIC */
+  sync_data->timestamp = sec * GST_SECOND + usec * GST_USECOND;
+  sync_data->waiting = FALSE;
+}
+
+static void
+gst_kms_sink_update_vblank (GstKMSSink * self, guint sequence,
+    GstClockTime timestamp)
+{
+  if (GST_CLOCK_TIME_IS_VALID (self->vblank_time) &&
+      sequence > self->vblank_sequence && timestamp > self->vblank_time) {
+    self->refresh_interval = (timestamp - self->vblank_time) /
+        (sequence - self->vblank_sequence);
+  }
+
+  self->vblank_sequence = sequence;
+  self->vblank_time = timestamp;
+}
+
+/* Must be called without the object lock */
+static void
+gst_kms_sink_report_presentation (GstKMSSink * self)
+{
+  GstClock *clock;
+  GstClockTime mono_now, now, base_time, age;
 
-  waiting = data;
-  *waiting = FALSE;
+  if (!GST_CLOCK_TIME_IS_VALID (self->vblank_time) ||
+      !GST_CLOCK_TIME_IS_VALID (self->refresh_interval))
+    return;
+
+  clock = gst_element_get_clock (GST_ELEMENT_CAST (self));
+  if (!clock)
+    return;
+
+  /* translate the vblank timestamp into running time */
+  mono_now = g_get_monotonic_time () * GST_USECOND;
+  now = gst_clock_get_time (clock);
+  base_time = gst_element_get_base_time (GST_ELEMENT_CAST (self));
+  gst_object_unref (clock);
+
+  if (mono_now < self->vblank_time)
+    return;
+
+  age = mono_now - self->vblank_time;
+  if (now < base_time + age)
+    return;
+
+  gst_base_sink_set_presentation_feedback (GST_BASE_SINK_CAST (self),
+      now - base_time - age, self->refresh_interval);
 }
 
 static gboolean
 gst_kms_sink_sync (GstKMSSink * self)
 {
   gint ret;
-  gboolean waiting;
+  GstKMSSinkSyncData sync_data = { 0, };
   drmEventContext evctxt = {
     .version = DRM_EVENT_CONTEXT_VERSION,
     .page_flip_handler = sync_handler,
@@ -1594,7 +1729,7 @@ gst_kms_sink_sync (GstKMSSink * self)
     .request = {
           .type = DRM_VBLANK_RELATIVE | DRM_VBLANK_EVENT,
           .sequence = 1,
-          .signal = (gulong) & waiting,
+          .signal = (gulong) & sync_data,
         },
   };
 
@@ -1603,19 +1738,19 @@ gst_kms_sink_sync (GstKMSSink * self)
   else if (self->pipe > 1)
     vbl.request.type |= self->pipe << DRM_VBLANK_HIGH_CRTC_SHIFT;
 
-  waiting = TRUE;
+  sync_data.waiting = TRUE;
   if (!self->has_async_page_flip && !self->modesetting_enabled) {
     ret = drmWaitVBlank (self->fd, &vbl);
     if (ret)
       goto vblank_failed;
   } else {
     ret = drmModePageFlip (self->fd, self->crtc_id, self->buffer_id,
-        DRM_MODE_PAGE_FLIP_EVENT, &waiting);
+        DRM_MODE_PAGE_FLIP_EVENT, &sync_data);
     if (ret)
       goto pageflip_failed;
   }
 
-  while (waiting) {
+  while (sync_data.waiting) {
     do {
       ret = gst_poll_wait (self->poll, 3 * GST_SECOND);
     } while (ret == -1 && (errno == EAGAIN || errno == EINTR));
@@ -1625,6 +1760,8 @@ gst_kms_sink_sync (GstKMSSink * self)
       goto event_failed;
   }
 
+  gst_kms_sink_update_vblank (self, sync_data.sequence, sync_data.timestamp);
+
   return TRUE;
 
   /* ERRORS */
@@ -1648,6 +1785,106 @@ event_failed:
   }
 }
 
+static void
+atomic_flip_handler (gint fd, guint frame, guint sec, guint usec,
+    gpointer data)
+{
+  GstKMSSink *self = data;
+
+  self->flip_pending = FALSE;
+  gst_kms_sink_update_vblank (self, frame,
+      sec * GST_SECOND + usec * GST_USECOND);
+}
+
+/* Waits until the previously committed frame is scanned out, at which point
+ * the frame before it can be released. Called with the object lock. */
+static gboolean
+gst_kms_sink_wait_flip (GstKMSSink * self)
+{
+  gint ret;
+  drmEventContext evctxt = {
+    .version = DRM_EVENT_CONTEXT_VERSION,
+    .page_flip_handler = atomic_flip_handler,
+  };
+
+  while (self->flip_pending) {
+    do {
+      ret = gst_poll_wait (self->poll, 3 * GST_SECOND);
+    } while (ret == -1 && (errno == EAGAIN || errno == EINTR));
+
+    if (ret <= 0)
+      goto wait_failed;
+
+    ret = drmHandleEvent (self->fd, &evctxt);
+    if (ret)
+      goto event_failed;
+  }
+
+  gst_buffer_replace (&self->prev_buffer, NULL);
+
+  return TRUE;
+
+  /* ERRORS */
+wait_failed:
+  {
+    GST_WARNING_OBJECT (self, "timed out waiting for page flip");
+    self->flip_pending = FALSE;
+    return FALSE;
+  }
+event_failed:
+  {
+    GST_ERROR_OBJECT (self, "drmHandleEvent failed: %s (%d)",
+        g_strerror (errno), errno);
+    self->flip_pending = FALSE;
+    return FALSE;
+  }
+}
+
+/* Queues the frame for the next vblank and returns immediately, completion
+ * is signalled by a page flip event */
+static gint
+gst_kms_sink_atomic_commit (GstKMSSink * self, guint32 fb_id,
+    GstVideoRectangle * src, GstVideoRectangle * dst)
+{
+  drmModeAtomicReq *req;
+  gint ret;
+
+  req = drmModeAtomicAlloc ();
+  if (!req)
+    return -ENOMEM;
+
+  drmModeAtomicAddProperty (req, self->plane_id,
+      self->plane_prop_ids.fb_id, fb_id);
+  drmModeAtomicAddProperty (req, self->plane_id,
+      self->plane_prop_ids.crtc_id, self->crtc_id);
+  /* source/cropping coordinates are given in Q16 */
+  drmModeAtomicAddProperty (req, self->plane_id,
+      self->plane_prop_ids.src_x, (guint64) src->x << 16);
+  drmModeAtomicAddProperty (req, self->plane_id,
+      self->plane_prop_ids.src_y, (guint64) src->y << 16);
+  drmModeAtomicAddProperty (req, self->plane_id,
+      self->plane_prop_ids.src_w, (guint64) src->w << 16);
+  drmModeAtomicAddProperty (req, self->plane_id,
+      self->plane_prop_ids.src_h, (guint64) src->h << 16);
+  drmModeAtomicAddProperty (req, self->plane_id,
+      self->plane_prop_ids.crtc_x, dst->x);
+  drmModeAtomicAddProperty (req, self->plane_id,
+      self->plane_prop_ids.crtc_y, dst->y);
+  drmModeAtomicAddProperty (req, self->plane_id,
+      self->plane_prop_ids.crtc_w, dst->w);
+  drmModeAtomicAddProperty (req, self->plane_id,
+      self->plane_prop_ids.crtc_h, dst->h);
+
+  ret = drmModeAtomicCommit (self->fd, req,
+      DRM_MODE_ATOMIC_NONBLOCK | DRM_MODE_PAGE_FLIP_EVENT, self);
+  drmModeAtomicFree (req);
+
+  if (ret == 0)
+    self->flip_pending = TRUE;
+
+  return ret;
+}
+
 static gboolean
 gst_kms_sink_import_dmabuf (GstKMSSink * self, GstBuffer * inbuf,
     GstBuffer ** outbuf)
@@ -1924,6 +2161,10 @@ gst_kms_sink_show_frame (GstVideoSink * vsink, GstBuffer * buf)
     goto sync_frame;
   }
 
+  /* only one commit can be in flight, so wait for the previous one */
+  if (self->has_atomic)
+    gst_kms_sink_wait_flip (self);
+
   if ((crop = gst_buffer_get_video_crop_meta (buffer))) {
     GstVideoInfo cropped_vinfo = *vinfo;
 
@@ -1977,6 +2218,22 @@ retry_set_plane:
   gst_kms_push_hdr_infoframe (self, FALSE);
 #endif
 
+  if (self->has_atomic) {
+    GST_TRACE_OBJECT (self,
+        "atomic commit at (%i,%i) %ix%i sourcing at (%i,%i) %ix%i",
+        result.x, result.y, result.w, result.h, src.x, src.y, src.w, src.h);
+
+    ret = gst_kms_sink_atomic_commit (self, fb_id, &src, &result);
+    if (ret) {
+      if (self->can_scale) {
+        self->can_scale = FALSE;
+        goto retry_set_plane;
+      }
+      goto set_plane_failed;
+    }
+    goto frame_queued;
+  }
+
   GST_TRACE_OBJECT (self,
       "drmModeSetPlane at (%i,%i) %ix%i sourcing at (%i,%i) %ix%i",
       result.x, result.y, result.w, result.h, src.x, src.y, src.w, src.h);
@@ -1995,13 +2252,17 @@ retry_set_plane:
 
 sync_frame:
   /* Wait for the previous frame to complete redraw */
-  if (!self->skip_vsync && !gst_kms_sink_sync (self)) {
+  if (!self->has_atomic && !self->skip_vsync && !gst_kms_sink_sync (self)) {
     GST_OBJECT_UNLOCK (self);
     goto bail;
   }
 
+frame_queued:
   /* Save the rendered buffer and its metadata in case a redraw is needed */
   if (buffer != self->last_buffer) {
+    /* with atomic commits the last buffer stays on screen until the flip */
+    if (self->flip_pending)
+      gst_buffer_replace (&self->prev_buffer, self->last_buffer);
     gst_buffer_replace (&self->last_buffer, buffer);
     self->last_width = GST_VIDEO_SINK_WIDTH (self);
     self->last_height = GST_VIDEO_SINK_HEIGHT (self);
@@ -2010,6 +2271,10 @@ sync_frame:
   g_clear_pointer (&self->tmp_kmsmem, gst_memory_unref);
 
   GST_OBJECT_UNLOCK (self);
+
+  if (self->has_atomic || !self->skip_vsync)
+    gst_kms_sink_report_presentation (self);
+
   res = GST_FLOW_OK;
 
 bail:
@@ -2030,7 +2295,9 @@ set_plane_failed:
         result.w, result.h, src.x, src.y, src.w, src.h, dst.x, dst.y, dst.w,
         dst.h);
     GST_ELEMENT_ERROR (self, RESOURCE, FAILED,
-        (NULL), ("drmModeSetPlane failed: %s (%d)", g_strerror (errno), errno));
+        (NULL), ("%s failed: %s (%d)", self->has_atomic ?
+            "drmModeAtomicCommit" : "drmModeSetPlane", g_strerror (errno),
+            errno));
     goto bail;
   }
 no_disp_ratio:
@@ -2072,6 +2339,13 @@ gst_kms_sink_drain (GstKMSSink * self)
     gst_kms_allocator_clear_cache (self->allocator);
     gst_kms_sink_show_frame (GST_VIDEO_SINK (self), NULL);
     gst_buffer_unref (last_buf);
+
+    /* make sure the upstream buffer is not scanned out anymore */
+    if (self->has_atomic) {
+      GST_OBJECT_LOCK (self);
+      gst_kms_sink_wait_flip (self);
+      GST_OBJECT_UNLOCK (self);
+    }
   }
 }
 
@@ -2199,6 +2473,9 @@ gst_kms_sink_set_property (GObject * object, guint prop_id,
     case PROP_SKIP_VSYNC:
       sink->skip_vsync = g_value_get_boolean (value);
       break;
+    case PROP_ATOMIC:
+      sink->atomic = g_value_get_boolean (value);
+      break;
     default:
       if (!gst_video_overlay_set_property (object, PROP_N, prop_id, value))
         G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -2258,6 +2535,9 @@ gst_kms_sink_get_property (GObject * object, guint prop_id,
     case PROP_SKIP_VSYNC:
       g_value_set_boolean (value, sink->skip_vsync);
       break;
+    case PROP_ATOMIC:
+      g_value_set_boolean (value, sink->atomic);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2292,6 +2572,8 @@ gst_kms_sink_init (GstKMSSink * sink)
   sink->poll = gst_poll_new (TRUE);
   gst_video_info_init (&sink->vinfo);
   sink->skip_vsync = FALSE;
+  sink->vblank_time = GST_CLOCK_TIME_NONE;
+  sink->refresh_interval = GST_CLOCK_TIME_NONE;
 
 #ifdef HAVE_DRM_HDR
   sink->no_infoframe = FALSE;
@@ -2496,6 +2778,22 @@ gst_kms_sink_class_init (GstKMSSinkClass * klass)
       "Should be used for atomic drivers to avoid double vsync.", FALSE,
       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_CONSTRUCT);
 
+  /**
+   * kmssink:atomic:
+   *
+   * Use atomic modesetting when the driver supports it. Frames are then
+   * queued with non-blocking commits: showing a frame only waits for the
+   * previous one to be scanned out instead of for its own vblank, and
+   * #kmssink:skip-vsync has no effect. Not used together with
+   * #kmssink:force-modesetting.
+   *
+   * Since: 1.24
+   */
+  g_properties[PROP_ATOMIC] =
+      g_param_spec_boolean ("atomic", "Atomic",
+      "Use non-blocking atomic commits if supported by the driver", FALSE,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, PROP_N, g_properties);
 
   gst_video_overlay_install_properties (gobject_class, PROP_N);
@@ -98,6 +98,23 @@ struct _GstKMSSink {
   gboolean is_internal_fd;
   gboolean skip_vsync;
 
+  /* atomic modesetting */
+  gboolean atomic;
+  gboolean has_atomic;
+  struct {
+    guint32 fb_id, crtc_id;
+    guint32 src_x, src_y, src_w, src_h;
+    guint32 crtc_x, crtc_y, crtc_w, crtc_h;
+  } plane_prop_ids;
+  gboolean flip_pending;
+  /* still scanned out until the pending flip completes */
+  GstBuffer *prev_buffer;
+
+  /* last vblank, for presentation feedback */
+  guint vblank_sequence;
+  GstClockTime vblank_time;
+  GstClockTime refresh_interval;
+
 #ifdef HAVE_DRM_HDR
   /* HDR mastering related structure */
   gboolean no_infoframe;
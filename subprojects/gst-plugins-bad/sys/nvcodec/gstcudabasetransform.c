@@ -192,7 +192,7 @@ gst_cuda_base_transform_stop (GstBaseTransform * trans)
   GstCudaBaseTransform *filter = GST_CUDA_BASE_TRANSFORM (trans);
 
   gst_clear_cuda_stream (&filter->stream);
-  gst_clear_object (&filter->context);
+  gst_cuda_clear_element_context (GST_ELEMENT_CAST (filter), &filter->context);
 
   return TRUE;
 }
@@ -1424,7 +1424,7 @@ gst_cuda_base_convert_transform (GstBaseTransform * trans,
         GST_TRACE_OBJECT (self, "Same stream");
       } else {
         GST_TRACE_OBJECT (self, "Different CUDA stream");
-        gst_cuda_memory_sync (in_cmem);
+        gst_cuda_memory_sync_stream (in_cmem, out_stream);
       }
     }
   }
@@ -0,0 +1,833 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-cudaladder
+ * @title: cudaladder
+ * @short_description: Scales a CUDA video stream to several resolutions
+ *
+ * This element converts each input frame to the size and format negotiated
+ * on each of its request source pads, typically to feed the encoders of an
+ * adaptive streaming ladder. Compared to a tee followed by one
+ * cudaconvertscale per branch, all conversions are issued on a single CUDA
+ * stream, the input is synchronized at most once per frame, and the outputs
+ * are pushed without waiting for the conversion to finish, so that
+ * downstream elements using the same stream don't need to synchronize
+ * either.
+ *
+ * The aspect ratio is not preserved and no borders are added: the output
+ * sizes are expected to be configured downstream, for example with
+ * capsfilters.
+ *
+ * ## Example launch line
+ * ```
+ * gst-launch-1.0 videotestsrc ! cudaupload ! cudaladder name=l \
+ *     l.src_0 ! video/x-raw(memory:CUDAMemory),width=1280,height=720 ! nvh264enc ! fakesink \
+ *     l.src_1 ! video/x-raw(memory:CUDAMemory),width=640,height=360 ! nvh264enc ! fakesink
+ * ```
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <gst/base/base.h>
+#include <gst/cuda/gstcuda.h>
+#include "gstcudaladder.h"
+#include "gstcudaconverter.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_cuda_ladder_debug);
+#define GST_CAT_DEFAULT gst_cuda_ladder_debug
+
+#define GST_CUDA_LADDER_FORMATS \
+    "{ I420, YV12, NV12, NV21, P010_10LE, P016_LE, I420_10LE, Y444, Y444_16LE, " \
+    "BGRA, RGBA, RGBx, BGRx, ARGB, ABGR, RGB, BGR, BGR10A2_LE, RGB10A2_LE, " \
+    "Y42B, I422_10LE, I422_12LE, RGBP, BGRP, GBR, GBRA }"
+
+static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE_WITH_FEATURES
+        (GST_CAPS_FEATURE_MEMORY_CUDA_MEMORY, GST_CUDA_LADDER_FORMATS))
+    );
+
+static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE_WITH_FEATURES
+        (GST_CAPS_FEATURE_MEMORY_CUDA_MEMORY, GST_CUDA_LADDER_FORMATS))
+    );
+
+enum
+{
+  PROP_0,
+  PROP_DEVICE_ID,
+};
+
+#define DEFAULT_DEVICE_ID -1
+
+struct _GstCudaLadderPad
+{
+  GstPad parent;
+
+  /* Only accessed from the streaming thread */
+  GstVideoInfo info;
+  GstCudaConverter *converter;
+  GstBufferPool *pool;
+};
+
+struct _GstCudaLadder
+{
+  GstElement parent;
+
+  GstPad *sinkpad;
+
+  gint device_id;
+  GstCudaContext *context;
+  GstCudaStream *stream;
+
+  /* Protected by object lock */
+  guint next_pad_id;
+
+  /* Only accessed from the streaming thread */
+  GstCaps *in_caps;
+  GstVideoInfo in_info;
+  GstFlowCombiner *flow_combiner;
+};
+
+#define gst_cuda_ladder_pad_parent_class pad_parent_class
+G_DEFINE_TYPE (GstCudaLadderPad, gst_cuda_ladder_pad, GST_TYPE_PAD);
+
+static void
+gst_cuda_ladder_pad_reset (GstCudaLadderPad * pad)
+{
+  if (pad->pool) {
+    gst_buffer_pool_set_active (pad->pool, FALSE);
+    gst_clear_object (&pad->pool);
+  }
+  gst_clear_object (&pad->converter);
+}
+
+static void
+gst_cuda_ladder_pad_dispose (GObject * object)
+{
+  gst_cuda_ladder_pad_reset (GST_CUDA_LADDER_PAD (object));
+
+  G_OBJECT_CLASS (pad_parent_class)->dispose (object);
+}
+
+static void
+gst_cuda_ladder_pad_class_init (GstCudaLadderPadClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->dispose = gst_cuda_ladder_pad_dispose;
+}
+
+static void
+gst_cuda_ladder_pad_init (GstCudaLadderPad * pad)
+{
+}
+
+static void gst_cuda_ladder_finalize (GObject * object);
+static void gst_cuda_ladder_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_cuda_ladder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+static GstStateChangeReturn gst_cuda_ladder_change_state (GstElement * element,
+    GstStateChange transition);
+static void gst_cuda_ladder_set_context (GstElement * element,
+    GstContext * context);
+static GstPad *gst_cuda_ladder_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * name, const GstCaps * caps);
+static void gst_cuda_ladder_release_pad (GstElement * element, GstPad * pad);
+static gboolean gst_cuda_ladder_sink_event (GstPad * pad, GstObject * parent,
+    GstEvent * event);
+static gboolean gst_cuda_ladder_sink_query (GstPad * pad, GstObject * parent,
+    GstQuery * query);
+static gboolean gst_cuda_ladder_src_query (GstPad * pad, GstObject * parent,
+    GstQuery * query);
+static GstFlowReturn gst_cuda_ladder_chain (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer);
+
+#define gst_cuda_ladder_parent_class parent_class
+G_DEFINE_TYPE (GstCudaLadder, gst_cuda_ladder, GST_TYPE_ELEMENT);
+
+static void
+gst_cuda_ladder_class_init (GstCudaLadderClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+
+  gobject_class->finalize = gst_cuda_ladder_finalize;
+  gobject_class->set_property = gst_cuda_ladder_set_property;
+  gobject_class->get_property = gst_cuda_ladder_get_property;
+
+  g_object_class_install_property (gobject_class, PROP_DEVICE_ID,
+      g_param_spec_int ("cuda-device-id",
+          "Cuda Device ID",
+          "Set the GPU device to use for operations (-1 = auto)",
+          -1, G_MAXINT, DEFAULT_DEVICE_ID,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_READY |
+          G_PARAM_STATIC_STRINGS));
+
+  element_class->change_state =
+      GST_DEBUG_FUNCPTR (gst_cuda_ladder_change_state);
+  element_class->set_context = GST_DEBUG_FUNCPTR (gst_cuda_ladder_set_context);
+  element_class->request_new_pad =
+      GST_DEBUG_FUNCPTR (gst_cuda_ladder_request_new_pad);
+  element_class->release_pad = GST_DEBUG_FUNCPTR (gst_cuda_ladder_release_pad);
+
+  gst_element_class_add_static_pad_template (element_class, &sink_template);
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &src_template, GST_TYPE_CUDA_LADDER_PAD);
+
+  gst_element_class_set_static_metadata (element_class,
+      "CUDA video ladder scaler", "Filter/Converter/Video/Scaler/Hardware",
+      "Converts a video stream to several sizes and formats using CUDA",
+      "GStreamer maintainers <gstreamer-devel@lists.freedesktop.org>");
+
+  GST_DEBUG_CATEGORY_INIT (gst_cuda_ladder_debug, "cudaladder", 0,
+      "cudaladder");
+
+  gst_type_mark_as_plugin_api (GST_TYPE_CUDA_LADDER_PAD, 0);
+}
+
+static void
+gst_cuda_ladder_init (GstCudaLadder * self)
+{
+  self->device_id = DEFAULT_DEVICE_ID;
+  self->flow_combiner = gst_flow_combiner_new ();
+
+  self->sinkpad = gst_pad_new_from_static_template (&sink_template, "sink");
+  gst_pad_set_event_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_cuda_ladder_sink_event));
+  gst_pad_set_query_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_cuda_ladder_sink_query));
+  gst_pad_set_chain_function (self->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_cuda_ladder_chain));
+  gst_element_add_pad (GST_ELEMENT_CAST (self), self->sinkpad);
+}
+
+static void
+gst_cuda_ladder_finalize (GObject * object)
+{
+  GstCudaLadder *self = GST_CUDA_LADDER (object);
+
+  gst_flow_combiner_free (self->flow_combiner);
+  gst_clear_caps (&self->in_caps);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_cuda_ladder_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstCudaLadder *self = GST_CUDA_LADDER (object);
+
+  switch (prop_id) {
+    case PROP_DEVICE_ID:
+      self->device_id = g_value_get_int (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_cuda_ladder_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstCudaLadder *self = GST_CUDA_LADDER (object);
+
+  switch (prop_id) {
+    case PROP_DEVICE_ID:
+      g_value_set_int (value, self->device_id);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_cuda_ladder_set_context (GstElement * element, GstContext * context)
+{
+  GstCudaLadder *self = GST_CUDA_LADDER (element);
+
+  gst_cuda_handle_set_context (element, context, self->device_id,
+      &self->context);
+
+  GST_ELEMENT_CLASS (parent_class)->set_context (element, context);
+}
+
+static void
+gst_cuda_ladder_reset_src_pads (GstCudaLadder * self)
+{
+  GList *iter;
+
+  GST_OBJECT_LOCK (self);
+  for (iter = GST_ELEMENT_CAST (self)->srcpads; iter; iter = g_list_next (iter))
+    gst_cuda_ladder_pad_reset (GST_CUDA_LADDER_PAD (iter->data));
+  GST_OBJECT_UNLOCK (self);
+}
+
+static GstStateChangeReturn
+gst_cuda_ladder_change_state (GstElement * element, GstStateChange transition)
+{
+  GstCudaLadder *self = GST_CUDA_LADDER (element);
+  GstStateChangeReturn ret;
+
+  switch (transition) {
+    case GST_STATE_CHANGE_NULL_TO_READY:
+      if (!gst_cuda_ensure_element_context (element, self->device_id,
+              &self->context)) {
+        GST_ERROR_OBJECT (self, "Failed to get CUDA context");
+        return GST_STATE_CHANGE_FAILURE;
+      }
+
+      self->stream = gst_cuda_stream_new (self->context);
+      if (!self->stream) {
+        GST_WARNING_OBJECT (self,
+            "Could not create cuda stream, will use default stream");
+      }
+      break;
+    case GST_STATE_CHANGE_READY_TO_PAUSED:
+      gst_flow_combiner_reset (self->flow_combiner);
+      break;
+    default:
+      break;
+  }
+
+  ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
+  if (ret == GST_STATE_CHANGE_FAILURE)
+    return ret;
+
+  switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_cuda_ladder_reset_src_pads (self);
+      gst_clear_caps (&self->in_caps);
+      break;
+    case GST_STATE_CHANGE_READY_TO_NULL:
+      gst_clear_cuda_stream (&self->stream);
+      gst_cuda_clear_element_context (element, &self->context);
+      break;
+    default:
+      break;
+  }
+
+  return ret;
+}
+
+static gboolean
+copy_sticky_event (GstPad * pad, GstEvent ** event, gpointer user_data)
+{
+  GstPad *srcpad = GST_PAD_CAST (user_data);
+
+  /* Caps are decided for each source pad */
+  if (GST_EVENT_TYPE (*event) != GST_EVENT_CAPS)
+    gst_pad_store_sticky_event (srcpad, *event);
+
+  return TRUE;
+}
+
+static GstPad *
+gst_cuda_ladder_request_new_pad (GstElement * element, GstPadTemplate * templ,
+    const gchar * name, const GstCaps * caps)
+{
+  GstCudaLadder *self = GST_CUDA_LADDER (element);
+  GstPad *pad;
+  gchar *pad_name;
+  guint pad_id;
+
+  GST_OBJECT_LOCK (self);
+  if (name && sscanf (name, "src_%u", &pad_id) == 1) {
+    if (pad_id >= self->next_pad_id)
+      self->next_pad_id = pad_id + 1;
+  } else {
+    pad_id = self->next_pad_id++;
+  }
+  GST_OBJECT_UNLOCK (self);
+
+  pad_name = g_strdup_printf ("src_%u", pad_id);
+  pad = g_object_new (GST_TYPE_CUDA_LADDER_PAD, "name", pad_name,
+      "direction", GST_PAD_SRC, "template", templ, NULL);
+  g_free (pad_name);
+
+  gst_pad_set_query_function (pad,
+      GST_DEBUG_FUNCPTR (gst_cuda_ladder_src_query));
+  gst_pad_use_fixed_caps (pad);
+  gst_pad_set_active (pad, TRUE);
+
+  /* New pads requested while streaming need stream-start and segment */
+  gst_pad_sticky_events_foreach (self->sinkpad, copy_sticky_event, pad);
+
+  if (!gst_element_add_pad (element, pad)) {
+    gst_object_unref (pad);
+    return NULL;
+  }
+
+  GST_PAD_STREAM_LOCK (self->sinkpad);
+  gst_flow_combiner_add_pad (self->flow_combiner, pad);
+  GST_PAD_STREAM_UNLOCK (self->sinkpad);
+
+  return pad;
+}
+
+static void
+gst_cuda_ladder_release_pad (GstElement * element, GstPad * pad)
+{
+  GstCudaLadder *self = GST_CUDA_LADDER (element);
+
+  GST_PAD_STREAM_LOCK (self->sinkpad);
+  gst_flow_combiner_remove_pad (self->flow_combiner, pad);
+  gst_cuda_ladder_pad_reset (GST_CUDA_LADDER_PAD (pad));
+  GST_PAD_STREAM_UNLOCK (self->sinkpad);
+
+  gst_pad_set_active (pad, FALSE);
+  gst_element_remove_pad (element, pad);
+}
+
+static GstCaps *
+gst_cuda_ladder_fixate_src_caps (GstCudaLadder * self, GstCaps * peer_caps)
+{
+  GstStructure *in_s = gst_caps_get_structure (self->in_caps, 0);
+  GstStructure *s;
+  GstCaps *caps;
+  const gchar *fields[] = { "framerate", "pixel-aspect-ratio",
+    "interlace-mode", "colorimetry", "chroma-site"
+  };
+  guint i;
+
+  caps = gst_caps_truncate (gst_caps_copy (peer_caps));
+  s = gst_caps_get_structure (caps, 0);
+
+  /* Keep what downstream doesn't care about from the input */
+  gst_structure_fixate_field_nearest_int (s, "width", self->in_info.width);
+  gst_structure_fixate_field_nearest_int (s, "height", self->in_info.height);
+  gst_structure_fixate_field_string (s, "format",
+      gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&self->in_info)));
+
+  for (i = 0; i < G_N_ELEMENTS (fields); i++) {
+    const GValue *value = gst_structure_get_value (in_s, fields[i]);
+
+    if (!value)
+      continue;
+
+    if (!gst_structure_has_field (s, fields[i]))
+      gst_structure_set_value (s, fields[i], value);
+    else if (G_VALUE_TYPE (value) == GST_TYPE_FRACTION)
+      gst_structure_fixate_field_nearest_fraction (s, fields[i],
+          gst_value_get_fraction_numerator (value),
+          gst_value_get_fraction_denominator (value));
+    else if (G_VALUE_TYPE (value) == G_TYPE_STRING)
+      gst_structure_fixate_field_string (s, fields[i],
+          g_value_get_string (value));
+  }
+
+  return gst_caps_fixate (caps);
+}
+
+static gboolean
+gst_cuda_ladder_negotiate_pad (GstCudaLadder * self, GstCudaLadderPad * pad)
+{
+  GstPad *srcpad = GST_PAD_CAST (pad);
+  GstCaps *templ_caps, *peer_caps, *caps;
+  GstQuery *query;
+  GstStructure *config;
+  GstVideoInfo info;
+  guint size;
+  gboolean ret = FALSE;
+
+  gst_cuda_ladder_pad_reset (pad);
+
+  templ_caps = gst_pad_get_pad_template_caps (srcpad);
+  peer_caps = gst_pad_peer_query_caps (srcpad, templ_caps);
+  gst_caps_unref (templ_caps);
+
+  if (gst_caps_is_empty (peer_caps)) {
+    GST_WARNING_OBJECT (pad, "Downstream does not accept CUDA memory");
+    gst_caps_unref (peer_caps);
+    return FALSE;
+  }
+
+  caps = gst_cuda_ladder_fixate_src_caps (self, peer_caps);
+  gst_caps_unref (peer_caps);
+
+  if (!gst_video_info_from_caps (&info, caps)) {
+    GST_ERROR_OBJECT (pad, "Invalid caps %" GST_PTR_FORMAT, caps);
+    goto done;
+  }
+
+  GST_DEBUG_OBJECT (pad, "Negotiated caps %" GST_PTR_FORMAT, caps);
+
+  if (!gst_pad_push_event (srcpad, gst_event_new_caps (caps))) {
+    GST_WARNING_OBJECT (pad, "Caps were not accepted");
+    goto done;
+  }
+
+  pad->converter = gst_cuda_converter_new (&self->in_info, &info,
+      self->context, NULL);
+  if (!pad->converter) {
+    GST_ERROR_OBJECT (pad, "Couldn't create converter");
+    goto done;
+  }
+
+  /* Let downstream know about our requirements, but always use our own
+   * pool so that all conversions happen on our stream */
+  query = gst_query_new_allocation (caps, FALSE);
+  gst_pad_peer_query (srcpad, query);
+  gst_query_unref (query);
+
+  pad->pool = gst_cuda_buffer_pool_new (self->context);
+  config = gst_buffer_pool_get_config (pad->pool);
+  gst_buffer_pool_config_add_option (config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+  gst_buffer_pool_config_set_params (config, caps,
+      GST_VIDEO_INFO_SIZE (&info), 0, 0);
+  if (self->stream)
+    gst_buffer_pool_config_set_cuda_stream (config, self->stream);
+
+  if (!gst_buffer_pool_set_config (pad->pool, config)) {
+    GST_ERROR_OBJECT (pad, "Failed to set pool config");
+    goto done;
+  }
+
+  config = gst_buffer_pool_get_config (pad->pool);
+  gst_buffer_pool_config_get_params (config, NULL, &size, NULL, NULL);
+  gst_structure_free (config);
+
+  if (!gst_buffer_pool_set_active (pad->pool, TRUE)) {
+    GST_ERROR_OBJECT (pad, "Failed to activate pool");
+    goto done;
+  }
+
+  pad->info = info;
+  ret = TRUE;
+
+done:
+  gst_caps_unref (caps);
+  if (!ret)
+    gst_cuda_ladder_pad_reset (pad);
+
+  return ret;
+}
+
+static gboolean
+gst_cuda_ladder_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  GstCudaLadder *self = GST_CUDA_LADDER (parent);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:
+    {
+      GstCaps *caps;
+      GstVideoInfo info;
+
+      gst_event_parse_caps (event, &caps);
+      if (!gst_video_info_from_caps (&info, caps)) {
+        GST_ERROR_OBJECT (self, "Invalid caps %" GST_PTR_FORMAT, caps);
+        gst_event_unref (event);
+        return FALSE;
+      }
+
+      gst_caps_replace (&self->in_caps, caps);
+      self->in_info = info;
+
+      /* Renegotiate all outputs on the next buffer */
+      gst_cuda_ladder_reset_src_pads (self);
+      gst_event_unref (event);
+      return TRUE;
+    }
+    case GST_EVENT_FLUSH_STOP:
+      gst_flow_combiner_reset (self->flow_combiner);
+      break;
+    default:
+      break;
+  }
+
+  return gst_pad_event_default (pad, parent, event);
+}
+
+static gboolean
+gst_cuda_ladder_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  GstCudaLadder *self = GST_CUDA_LADDER (parent);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CONTEXT:
+      if (gst_cuda_handle_context_query (GST_ELEMENT (self), query,
+              self->context))
+        return TRUE;
+      break;
+    case GST_QUERY_CAPS:
+    {
+      GstCaps *filter, *caps;
+
+      /* Any size and format can be converted for each output */
+      gst_query_parse_caps (query, &filter);
+      caps = gst_pad_get_pad_template_caps (pad);
+      if (filter) {
+        GstCaps *tmp = gst_caps_intersect_full (filter, caps,
+            GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      return TRUE;
+    }
+    case GST_QUERY_ALLOCATION:
+    {
+      GstCaps *caps;
+      GstVideoInfo info;
+      gboolean need_pool;
+
+      gst_query_parse_allocation (query, &caps, &need_pool);
+      if (!caps || !gst_video_info_from_caps (&info, caps))
+        return FALSE;
+
+      if (need_pool && self->context) {
+        GstBufferPool *pool = gst_cuda_buffer_pool_new (self->context);
+        GstStructure *config = gst_buffer_pool_get_config (pool);
+        guint size;
+
+        /* Decoding into memory on our stream saves the input sync */
+        if (self->stream)
+          gst_buffer_pool_config_set_cuda_stream (config, self->stream);
+
+        gst_buffer_pool_config_add_option (config,
+            GST_BUFFER_POOL_OPTION_VIDEO_META);
+        gst_buffer_pool_config_set_params (config, caps,
+            GST_VIDEO_INFO_SIZE (&info), 0, 0);
+
+        if (!gst_buffer_pool_set_config (pool, config)) {
+          GST_ERROR_OBJECT (self, "failed to set config");
+          gst_object_unref (pool);
+          return FALSE;
+        }
+
+        config = gst_buffer_pool_get_config (pool);
+        gst_buffer_pool_config_get_params (config, NULL, &size, NULL, NULL);
+        gst_structure_free (config);
+
+        gst_query_add_allocation_pool (query, pool, size, 0, 0);
+        gst_object_unref (pool);
+      }
+
+      gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+      return TRUE;
+    }
+    default:
+      break;
+  }
+
+  return gst_pad_query_default (pad, parent, query);
+}
+
+static gboolean
+gst_cuda_ladder_src_query (GstPad * pad, GstObject * parent, GstQuery * query)
+{
+  GstCudaLadder *self = GST_CUDA_LADDER (parent);
+
+  switch (GST_QUERY_TYPE (query)) {
+    case GST_QUERY_CONTEXT:
+      if (gst_cuda_handle_context_query (GST_ELEMENT (self), query,
+              self->context))
+        return TRUE;
+      break;
+    case GST_QUERY_CAPS:
+    {
+      GstCaps *filter, *caps;
+
+      gst_query_parse_caps (query, &filter);
+      caps = gst_pad_get_current_caps (pad);
+      if (!caps)
+        caps = gst_pad_get_pad_template_caps (pad);
+
+      if (filter) {
+        GstCaps *tmp = gst_caps_intersect_full (filter, caps,
+            GST_CAPS_INTERSECT_FIRST);
+        gst_caps_unref (caps);
+        caps = tmp;
+      }
+
+      gst_query_set_caps_result (query, caps);
+      gst_caps_unref (caps);
+      return TRUE;
+    }
+    default:
+      break;
+  }
+
+  return gst_pad_query_default (pad, parent, query);
+}
+
+static GstFlowReturn
+gst_cuda_ladder_convert (GstCudaLadder * self, GstCudaLadderPad * pad,
+    GstBuffer * inbuf, GstVideoFrame * in_frame, GstBuffer ** outbuf)
+{
+  GstVideoFrame out_frame;
+  GstCudaMemory *out_cmem;
+  GstFlowReturn ret;
+  gboolean sync_done = FALSE;
+
+  if (!pad->converter || gst_pad_check_reconfigure (GST_PAD_CAST (pad))) {
+    if (!gst_cuda_ladder_negotiate_pad (self, pad)) {
+      gst_pad_mark_reconfigure (GST_PAD_CAST (pad));
+      return GST_PAD_IS_FLUSHING (pad) ? GST_FLOW_FLUSHING :
+          GST_FLOW_NOT_NEGOTIATED;
+    }
+  }
+
+  ret = gst_buffer_pool_acquire_buffer (pad->pool, outbuf, NULL);
+  if (ret != GST_FLOW_OK)
+    return ret;
+
+  gst_buffer_copy_into (*outbuf, inbuf,
+      GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+
+  if (!gst_video_frame_map (&out_frame, &pad->info, *outbuf,
+          GST_MAP_WRITE | GST_MAP_CUDA)) {
+    GST_ERROR_OBJECT (pad, "Failed to map output buffer");
+    gst_clear_buffer (outbuf);
+    return GST_FLOW_ERROR;
+  }
+
+  if (!gst_cuda_converter_convert_frame (pad->converter, in_frame, &out_frame,
+          gst_cuda_stream_get_handle (self->stream), &sync_done)) {
+    GST_ERROR_OBJECT (pad, "Failed to convert frame");
+    ret = GST_FLOW_ERROR;
+  }
+
+  /* Otherwise the conversion may still be running, and downstream will wait
+   * for it only if it doesn't use our stream */
+  out_cmem = (GstCudaMemory *) gst_buffer_peek_memory (*outbuf, 0);
+  if (sync_done)
+    GST_MEMORY_FLAG_UNSET (out_cmem, GST_CUDA_MEMORY_TRANSFER_NEED_SYNC);
+
+  gst_video_frame_unmap (&out_frame);
+
+  if (ret != GST_FLOW_OK)
+    gst_clear_buffer (outbuf);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_cuda_ladder_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstCudaLadder *self = GST_CUDA_LADDER (parent);
+  GstVideoFrame in_frame;
+  GstMemory *mem;
+  GstCudaMemory *in_cmem;
+  GstCudaStream *in_stream;
+  GList *pads = NULL, *iter;
+  GstBuffer **outbufs;
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint n_pads, i;
+
+  if (!self->in_caps) {
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION, (NULL),
+        ("No input format negotiated"));
+    gst_buffer_unref (buffer);
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  mem = gst_buffer_peek_memory (buffer, 0);
+  if (gst_buffer_n_memory (buffer) != 1 || !gst_is_cuda_memory (mem)) {
+    GST_ERROR_OBJECT (self, "Input buffer is not CUDA");
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+
+  in_cmem = GST_CUDA_MEMORY_CAST (mem);
+  if (in_cmem->context != self->context) {
+    GST_ERROR_OBJECT (self, "Input memory belongs to another CUDA context");
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+
+  GST_OBJECT_LOCK (self);
+  pads = g_list_copy_deep (GST_ELEMENT_CAST (self)->srcpads,
+      (GCopyFunc) gst_object_ref, NULL);
+  GST_OBJECT_UNLOCK (self);
+
+  n_pads = g_list_length (pads);
+  if (n_pads == 0) {
+    gst_buffer_unref (buffer);
+    return GST_FLOW_OK;
+  }
+
+  if (!gst_video_frame_map (&in_frame, &self->in_info, buffer,
+          GST_MAP_READ | GST_MAP_CUDA)) {
+    GST_ERROR_OBJECT (self, "Failed to map input buffer");
+    g_list_free_full (pads, gst_object_unref);
+    gst_buffer_unref (buffer);
+    return GST_FLOW_ERROR;
+  }
+
+  /* Order our stream after upstream once for all outputs, if it didn't
+   * produce the frame on our stream */
+  in_stream = gst_cuda_memory_get_stream (in_cmem);
+  if (in_stream && in_stream != self->stream)
+    gst_cuda_memory_sync_stream (in_cmem, self->stream);
+
+  /* Issue all conversions first, then push */
+  outbufs = g_new0 (GstBuffer *, n_pads);
+  for (iter = pads, i = 0; iter; iter = g_list_next (iter), i++) {
+    GstCudaLadderPad *srcpad = GST_CUDA_LADDER_PAD (iter->data);
+    GstFlowReturn conv_ret;
+
+    conv_ret = gst_cuda_ladder_convert (self, srcpad, buffer, &in_frame,
+        &outbufs[i]);
+    if (conv_ret != GST_FLOW_OK) {
+      ret = gst_flow_combiner_update_pad_flow (self->flow_combiner,
+          GST_PAD_CAST (srcpad), conv_ret);
+      if (ret != GST_FLOW_OK && ret != GST_FLOW_NOT_LINKED)
+        break;
+    }
+  }
+
+  gst_video_frame_unmap (&in_frame);
+  gst_buffer_unref (buffer);
+
+  for (iter = pads, i = 0; iter; iter = g_list_next (iter), i++) {
+    GstPad *srcpad = GST_PAD_CAST (iter->data);
+
+    if (!outbufs[i])
+      continue;
+
+    if (ret != GST_FLOW_OK && ret != GST_FLOW_NOT_LINKED) {
+      gst_buffer_unref (outbufs[i]);
+      continue;
+    }
+
+    ret = gst_flow_combiner_update_pad_flow (self->flow_combiner, srcpad,
+        gst_pad_push (srcpad, outbufs[i]));
+  }
+
+  g_free (outbufs);
+  g_list_free_full (pads, gst_object_unref);
+
+  return ret;
+}
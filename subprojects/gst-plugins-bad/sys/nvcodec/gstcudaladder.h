@@ -0,0 +1,33 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_CUDA_LADDER_PAD (gst_cuda_ladder_pad_get_type())
+G_DECLARE_FINAL_TYPE (GstCudaLadderPad, gst_cuda_ladder_pad,
+    GST, CUDA_LADDER_PAD, GstPad)
+
+#define GST_TYPE_CUDA_LADDER (gst_cuda_ladder_get_type())
+G_DECLARE_FINAL_TYPE (GstCudaLadder, gst_cuda_ladder,
+    GST, CUDA_LADDER, GstElement)
+
+G_END_DECLS
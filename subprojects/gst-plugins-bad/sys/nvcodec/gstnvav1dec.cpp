@@ -340,7 +340,7 @@ gst_nv_av1_dec_open (GstVideoDecoder * decoder)
   self->decoder = gst_nv_decoder_new (self->context);
   if (!self->decoder) {
     GST_ERROR_OBJECT (self, "Failed to create decoder object");
-    gst_clear_object (&self->context);
+    gst_cuda_clear_element_context (GST_ELEMENT (self), &self->context);
 
     return FALSE;
   }
@@ -366,7 +366,7 @@ gst_nv_av1_dec_close (GstVideoDecoder * decoder)
   GstNvAV1Dec *self = GST_NV_AV1_DEC (decoder);
 
   gst_clear_object (&self->decoder);
-  gst_clear_object (&self->context);
+  gst_cuda_clear_element_context (GST_ELEMENT (self), &self->context);
 
   gst_nv_av1_dec_reset_bitstream_params (self);
 
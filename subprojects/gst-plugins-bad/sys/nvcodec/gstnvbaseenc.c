@@ -232,6 +232,8 @@ static gboolean gst_nv_base_enc_sink_query (GstVideoEncoder * enc,
     GstQuery * query);
 static gboolean gst_nv_base_enc_sink_event (GstVideoEncoder * enc,
     GstEvent * event);
+static gboolean gst_nv_base_enc_src_event (GstVideoEncoder * enc,
+    GstEvent * event);
 static gboolean gst_nv_base_enc_set_format (GstVideoEncoder * enc,
     GstVideoCodecState * state);
 static GstFlowReturn gst_nv_base_enc_handle_frame (GstVideoEncoder * enc,
@@ -277,6 +279,7 @@ gst_nv_base_enc_class_init (GstNvBaseEncClass * klass)
   videoenc_class->finish = GST_DEBUG_FUNCPTR (gst_nv_base_enc_finish);
   videoenc_class->sink_query = GST_DEBUG_FUNCPTR (gst_nv_base_enc_sink_query);
   videoenc_class->sink_event = GST_DEBUG_FUNCPTR (gst_nv_base_enc_sink_event);
+  videoenc_class->src_event = GST_DEBUG_FUNCPTR (gst_nv_base_enc_src_event);
   videoenc_class->propose_allocation =
       GST_DEBUG_FUNCPTR (gst_nv_base_enc_propose_allocation);
 
@@ -484,7 +487,7 @@ gst_nv_base_enc_open (GstVideoEncoder * enc)
 
   if (!gst_nv_base_enc_open_encode_session (nvenc)) {
     GST_ERROR ("Failed to create NVENC encoder session");
-    gst_clear_object (&nvenc->cuda_ctx);
+    gst_cuda_clear_element_context (GST_ELEMENT_CAST (nvenc), &nvenc->cuda_ctx);
     return FALSE;
   }
 
@@ -711,6 +714,21 @@ gst_nv_base_enc_sink_event (GstVideoEncoder * enc, GstEvent * event)
   return ret;
 }
 
+static gboolean
+gst_nv_base_enc_src_event (GstVideoEncoder * enc, GstEvent * event)
+{
+  guint bitrate;
+
+  /* bandwidth estimate from rtpsession, follow it like a change of the
+   * bitrate property */
+  if (gst_video_event_parse_bandwidth_estimate (event, &bitrate)) {
+    GST_DEBUG_OBJECT (enc, "Following bandwidth estimate of %u bps", bitrate);
+    g_object_set (enc, "bitrate", MAX (bitrate / 1000, 1), NULL);
+  }
+
+  return GST_VIDEO_ENCODER_CLASS (parent_class)->src_event (enc, event);
+}
+
 static gboolean
 gst_nv_base_enc_start (GstVideoEncoder * enc)
 {
@@ -994,7 +1012,7 @@ gst_nv_base_enc_close (GstVideoEncoder * enc)
   }
 
   gst_clear_cuda_stream (&nvenc->stream);
-  gst_clear_object (&nvenc->cuda_ctx);
+  gst_cuda_clear_element_context (GST_ELEMENT_CAST (nvenc), &nvenc->cuda_ctx);
 
   GST_OBJECT_LOCK (nvenc);
   if (nvenc->input_formats)
@@ -1035,7 +1035,7 @@ gst_nvdec_close (GstVideoDecoder * decoder)
   GstNvDec *nvdec = GST_NVDEC (decoder);
 
   gst_clear_cuda_stream (&nvdec->stream);
-  gst_clear_object (&nvdec->cuda_ctx);
+  gst_cuda_clear_element_context (GST_ELEMENT_CAST (nvdec), &nvdec->cuda_ctx);
 
   return TRUE;
 }
@@ -383,10 +383,35 @@ out:
   return status;
 }
 
+/* @info is passed when the input resolution changes in-session. Input
+ * buffers of the old resolution are released here and the ones still in use
+ * will be released once those are returned */
 NVENCSTATUS
-GstNvEncObject::Reconfigure (NV_ENC_RECONFIGURE_PARAMS * params)
+GstNvEncObject::Reconfigure (NV_ENC_RECONFIGURE_PARAMS * params,
+    const GstVideoInfo * info)
 {
-  return NvEncReconfigureEncoder (session_, params);
+  NVENCSTATUS status;
+
+  status = NvEncReconfigureEncoder (session_, params);
+  if (status != NV_ENC_SUCCESS || !info)
+    return status;
+
+  std::lock_guard <std::mutex> lk (lock_);
+  if (info_.width == info->width && info_.height == info->height)
+    return status;
+
+  info_ = *info;
+  DeviceLock ();
+  while (!buffer_queue_.empty ()) {
+    GstNvEncBuffer *buf = buffer_queue_.front ();
+
+    NvEncDestroyInputBuffer (session_, buf->buffer.inputBuffer);
+    gst_nv_enc_buffer_unref (buf);
+    buffer_queue_.pop ();
+  }
+  DeviceUnlock ();
+
+  return status;
 }
 
 void
@@ -934,6 +959,17 @@ GstNvEncObject::PushEmptyBuffer (GstNvEncBuffer * buffer)
 {
   std::lock_guard <std::mutex> lk (lock_);
 
+  if (buffer->buffer.width != (guint32) info_.width ||
+      buffer->buffer.height != (guint32) info_.height) {
+    GST_LOG_ID (id_.c_str (), "Releasing buffer %u of old resolution",
+        buffer->seq_num);
+    DeviceLock ();
+    NvEncDestroyInputBuffer (session_, buffer->buffer.inputBuffer);
+    DeviceUnlock ();
+    gst_nv_enc_buffer_unref (buffer);
+    return;
+  }
+
   buffer_queue_.push (buffer);
   cond_.notify_all ();
 }
@@ -165,7 +165,8 @@ public:
                              const GstVideoInfo * info,
                              guint pool_size);
 
-  NVENCSTATUS   Reconfigure (NV_ENC_RECONFIGURE_PARAMS * params);
+  NVENCSTATUS   Reconfigure (NV_ENC_RECONFIGURE_PARAMS * params,
+                             const GstVideoInfo * info = nullptr);
 
   void          SetFlushing (bool flushing);
 
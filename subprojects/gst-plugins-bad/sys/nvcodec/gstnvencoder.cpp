@@ -59,9 +59,13 @@ enum
 {
   PROP_0,
   PROP_CC_INSERT,
+  PROP_MAX_WIDTH,
+  PROP_MAX_HEIGHT,
 };
 
 #define DEFAULT_CC_INSERT GST_NV_ENCODER_SEI_INSERT
+#define DEFAULT_MAX_WIDTH 0
+#define DEFAULT_MAX_HEIGHT 0
 
 struct _GstNvEncoderPrivate
 {
@@ -101,6 +105,10 @@ struct _GstNvEncoderPrivate
 
   GstBufferPool *internal_pool = nullptr;
 
+  /* accessed only from the encoding thread */
+  GstBufferPool *bitstream_pool = nullptr;
+  gsize bitstream_pool_size = 0;
+
   GstClockTime dts_offset = 0;
 
   std::mutex lock;
@@ -114,6 +122,8 @@ struct _GstNvEncoderPrivate
 
   /* properties */
   GstNvEncoderSeiInsertMode cc_insert = DEFAULT_CC_INSERT;
+  guint max_width = DEFAULT_MAX_WIDTH;
+  guint max_height = DEFAULT_MAX_HEIGHT;
 };
 
 /**
@@ -136,6 +146,8 @@ static gboolean gst_nv_encoder_close (GstVideoEncoder * encoder);
 static gboolean gst_nv_encoder_stop (GstVideoEncoder * encoder);
 static gboolean gst_nv_encoder_sink_event (GstVideoEncoder * encoder,
     GstEvent * event);
+static gboolean gst_nv_encoder_src_event (GstVideoEncoder * encoder,
+    GstEvent * event);
 static gboolean gst_nv_encoder_sink_query (GstVideoEncoder * encoder,
     GstQuery * query);
 static gboolean gst_nv_encoder_src_query (GstVideoEncoder * encoder,
@@ -175,12 +187,43 @@ gst_nv_encoder_class_init (GstNvEncoderClass * klass)
           GST_TYPE_NV_ENCODER_SEI_INSERT_MODE, DEFAULT_CC_INSERT,
           (GParamFlags) (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
 
+  /**
+   * GstNvEncoder:max-width:
+   *
+   * Maximum width the encoding session is configured for. Resolution changes
+   * within #GstNvEncoder:max-width and #GstNvEncoder:max-height are applied
+   * without re-opening the encoding session
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (object_class, PROP_MAX_WIDTH,
+      g_param_spec_uint ("max-width", "Max Width",
+          "Maximum encoding width for in-session resolution change "
+          "(0 = input width)", 0, G_MAXINT, DEFAULT_MAX_WIDTH,
+          (GParamFlags) (GST_PARAM_MUTABLE_READY | G_PARAM_READWRITE |
+              G_PARAM_STATIC_STRINGS)));
+
+  /**
+   * GstNvEncoder:max-height:
+   *
+   * Maximum height the encoding session is configured for
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (object_class, PROP_MAX_HEIGHT,
+      g_param_spec_uint ("max-height", "Max Height",
+          "Maximum encoding height for in-session resolution change "
+          "(0 = input height)", 0, G_MAXINT, DEFAULT_MAX_HEIGHT,
+          (GParamFlags) (GST_PARAM_MUTABLE_READY | G_PARAM_READWRITE |
+              G_PARAM_STATIC_STRINGS)));
+
   element_class->set_context = GST_DEBUG_FUNCPTR (gst_nv_encoder_set_context);
 
   videoenc_class->open = GST_DEBUG_FUNCPTR (gst_nv_encoder_open);
   videoenc_class->close = GST_DEBUG_FUNCPTR (gst_nv_encoder_close);
   videoenc_class->stop = GST_DEBUG_FUNCPTR (gst_nv_encoder_stop);
   videoenc_class->sink_event = GST_DEBUG_FUNCPTR (gst_nv_encoder_sink_event);
+  videoenc_class->src_event = GST_DEBUG_FUNCPTR (gst_nv_encoder_src_event);
   videoenc_class->sink_query = GST_DEBUG_FUNCPTR (gst_nv_encoder_sink_query);
   videoenc_class->src_query = GST_DEBUG_FUNCPTR (gst_nv_encoder_src_query);
   videoenc_class->propose_allocation =
@@ -234,6 +277,12 @@ gst_nv_encoder_set_property (GObject * object, guint prop_id,
     case PROP_CC_INSERT:
       priv->cc_insert = (GstNvEncoderSeiInsertMode) g_value_get_enum (value);
       break;
+    case PROP_MAX_WIDTH:
+      priv->max_width = g_value_get_uint (value);
+      break;
+    case PROP_MAX_HEIGHT:
+      priv->max_height = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -251,6 +300,12 @@ gst_nv_encoder_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_CC_INSERT:
       g_value_set_enum (value, priv->cc_insert);
       break;
+    case PROP_MAX_WIDTH:
+      g_value_set_uint (value, priv->max_width);
+      break;
+    case PROP_MAX_HEIGHT:
+      g_value_set_uint (value, priv->max_height);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -309,6 +364,12 @@ gst_nv_encoder_reset (GstNvEncoder * self)
     priv->encoding_thread = nullptr;
   }
 
+  if (priv->bitstream_pool) {
+    gst_buffer_pool_set_active (priv->bitstream_pool, FALSE);
+    gst_clear_object (&priv->bitstream_pool);
+  }
+  priv->bitstream_pool_size = 0;
+
   priv->object = nullptr;
   priv->last_flow = GST_FLOW_OK;
 
@@ -359,16 +420,15 @@ gst_nv_encoder_device_unlock (GstNvEncoder * self)
   return ret;
 }
 
-static gboolean
-gst_nv_encoder_drain (GstNvEncoder * self, gboolean locked)
+/* Outputs all pending frames and stops the encoding thread, but keeps
+ * the encoding session */
+static void
+gst_nv_encoder_drain_session (GstNvEncoder * self, gboolean locked)
 {
   GstNvEncoderPrivate *priv = self->priv;
   NVENCSTATUS status;
   GstNvEncTask *task = nullptr;
 
-  if (!priv->object || !priv->encoding_thread)
-    return TRUE;
-
   GST_DEBUG_OBJECT (self, "Drain");
 
   if (locked)
@@ -382,10 +442,20 @@ gst_nv_encoder_drain (GstNvEncoder * self, gboolean locked)
   priv->encoding_thread->join ();
   priv->encoding_thread = nullptr;
 
-  gst_nv_encoder_reset (self);
-
   if (locked)
     GST_VIDEO_ENCODER_STREAM_LOCK (self);
+}
+
+static gboolean
+gst_nv_encoder_drain (GstNvEncoder * self, gboolean locked)
+{
+  GstNvEncoderPrivate *priv = self->priv;
+
+  if (!priv->object || !priv->encoding_thread)
+    return TRUE;
+
+  gst_nv_encoder_drain_session (self, locked);
+  gst_nv_encoder_reset (self);
 
   return TRUE;
 }
@@ -458,7 +528,7 @@ gst_nv_encoder_close (GstVideoEncoder * encoder)
   GstNvEncoderPrivate *priv = self->priv;
 
   gst_clear_cuda_stream (&priv->stream);
-  gst_clear_object (&priv->context);
+  gst_cuda_clear_element_context (GST_ELEMENT_CAST (self), &priv->context);
 #ifdef G_OS_WIN32
   gst_clear_d3d11_fence (&priv->fence);
   gst_clear_object (&priv->device);
@@ -484,7 +554,7 @@ gst_nv_encoder_stop (GstVideoEncoder * encoder)
 
   if (priv->subclass_device_mode == GST_NV_ENCODER_DEVICE_AUTO_SELECT) {
     gst_clear_cuda_stream (&priv->stream);
-    gst_clear_object (&priv->context);
+    gst_cuda_clear_element_context (GST_ELEMENT_CAST (self), &priv->context);
 #ifdef G_OS_WIN32
     gst_clear_object (&priv->device);
 #endif
@@ -514,6 +584,21 @@ gst_nv_encoder_sink_event (GstVideoEncoder * encoder, GstEvent * event)
   return GST_VIDEO_ENCODER_CLASS (parent_class)->sink_event (encoder, event);
 }
 
+static gboolean
+gst_nv_encoder_src_event (GstVideoEncoder * encoder, GstEvent * event)
+{
+  guint bitrate;
+
+  /* bandwidth estimate from rtpsession, follow it like a change of the
+   * bitrate property */
+  if (gst_video_event_parse_bandwidth_estimate (event, &bitrate)) {
+    GST_DEBUG_OBJECT (encoder, "Following bandwidth estimate of %u bps", bitrate);
+    g_object_set (encoder, "bitrate", MAX (bitrate / 1000, 1), NULL);
+  }
+
+  return GST_VIDEO_ENCODER_CLASS (parent_class)->src_event (encoder, event);
+}
+
 #ifdef HAVE_CUDA_GST_GL
 static void
 gst_nv_encoder_check_cuda_device_from_gl_context (GstGLContext * context,
@@ -893,8 +978,9 @@ gst_nv_encoder_thread_func (GstNvEncoder * self)
     if (klass->create_output_buffer) {
       frame->output_buffer = klass->create_output_buffer (self, &bitstream);
     } else {
-      frame->output_buffer =
-          gst_buffer_new_memdup (bitstream.bitstreamBufferPtr,
+      frame->output_buffer = gst_nv_encoder_allocate_output_buffer (self,
+          bitstream.bitstreamSizeInBytes);
+      gst_buffer_fill (frame->output_buffer, 0, bitstream.bitstreamBufferPtr,
           bitstream.bitstreamSizeInBytes);
     }
 
@@ -1061,6 +1147,36 @@ gst_nv_encoder_create_pool (GstNvEncoder * self, GstVideoCodecState * state)
   return pool;
 }
 
+static void
+gst_nv_encoder_update_latency (GstNvEncoder * self, guint task_pool_size)
+{
+  GstNvEncoderPrivate *priv = self->priv;
+  GstVideoInfo *info = &priv->input_state->info;
+  gint fps_n, fps_d;
+  GstClockTime frame_duration, min_latency, max_latency;
+
+  if (info->fps_n > 0 && info->fps_d > 0) {
+    fps_n = info->fps_n;
+    fps_d = info->fps_d;
+  } else {
+    fps_n = 25;
+    fps_d = 1;
+  }
+
+  frame_duration = gst_util_uint64_scale (GST_SECOND, fps_d, fps_n);
+
+  priv->dts_offset = 0;
+  /* Calculate DTS offset for B frame. NVENC does not provide DTS */
+  if (priv->config.frameIntervalP > 1)
+    priv->dts_offset = frame_duration * (priv->config.frameIntervalP - 1);
+
+  min_latency = priv->dts_offset +
+      priv->config.rcParams.lookaheadDepth * frame_duration;
+  max_latency = frame_duration * task_pool_size;
+  gst_video_encoder_set_latency (GST_VIDEO_ENCODER (self),
+      min_latency, max_latency);
+}
+
 static gboolean
 gst_nv_encoder_init_session (GstNvEncoder * self, GstBuffer * in_buf)
 {
@@ -1070,8 +1186,6 @@ gst_nv_encoder_init_session (GstNvEncoder * self, GstBuffer * in_buf)
   GstVideoInfo *info = &state->info;
   NVENCSTATUS status;
   guint task_pool_size;
-  gint fps_n, fps_d;
-  GstClockTime frame_duration, min_latency, max_latency;
 
   gst_nv_encoder_reset (self);
 
@@ -1105,7 +1219,7 @@ gst_nv_encoder_init_session (GstNvEncoder * self, GstBuffer * in_buf)
     priv->selected_device_mode = data.device_mode;
     priv->cuda_device_id = data.cuda_device_id;
     priv->dxgi_adapter_luid = data.adapter_luid;
-    gst_clear_object (&priv->context);
+    gst_cuda_clear_element_context (GST_ELEMENT_CAST (self), &priv->context);
     if (data.device_mode == GST_NV_ENCODER_DEVICE_CUDA) {
       GstMemory *mem = gst_buffer_peek_memory (in_buf, 0);
 
@@ -1162,6 +1276,12 @@ gst_nv_encoder_init_session (GstNvEncoder * self, GstBuffer * in_buf)
     goto error;
   }
 
+  /* Reserve resources for in-session resolution change */
+  priv->init_params.maxEncodeWidth = MAX (priv->init_params.maxEncodeWidth,
+      priv->max_width);
+  priv->init_params.maxEncodeHeight = MAX (priv->init_params.maxEncodeHeight,
+      priv->max_height);
+
   task_pool_size = gst_nv_encoder_calculate_task_pool_size (self,
       &priv->config);
 
@@ -1188,26 +1308,7 @@ gst_nv_encoder_init_session (GstNvEncoder * self, GstBuffer * in_buf)
   priv->encoding_thread = std::make_unique < std::thread >
       (gst_nv_encoder_thread_func, self);
 
-  if (info->fps_n > 0 && info->fps_d > 0) {
-    fps_n = info->fps_n;
-    fps_d = info->fps_d;
-  } else {
-    fps_n = 25;
-    fps_d = 1;
-  }
-
-  frame_duration = gst_util_uint64_scale (GST_SECOND, fps_d, fps_n);
-
-  priv->dts_offset = 0;
-  /* Calculate DTS offset for B frame. NVENC does not provide DTS */
-  if (priv->config.frameIntervalP > 1)
-    priv->dts_offset = frame_duration * (priv->config.frameIntervalP - 1);
-
-  min_latency = priv->dts_offset +
-      priv->config.rcParams.lookaheadDepth * frame_duration;
-  max_latency = frame_duration * task_pool_size;
-  gst_video_encoder_set_latency (GST_VIDEO_ENCODER (self),
-      min_latency, max_latency);
+  gst_nv_encoder_update_latency (self, task_pool_size);
 
   return TRUE;
 
@@ -1248,6 +1349,142 @@ gst_nv_encoder_reconfigure_session (GstNvEncoder * self)
   return TRUE;
 }
 
+static gboolean
+gst_nv_encoder_can_reconfigure_format (GstNvEncoder * self,
+    GstVideoCodecState * state)
+{
+  GstNvEncoderPrivate *priv = self->priv;
+  GstVideoInfo *old_info, *new_info;
+  GstCapsFeatures *old_features, *new_features;
+
+  if (!priv->object || !priv->encoding_thread || !priv->input_state)
+    return FALSE;
+
+  old_info = &priv->input_state->info;
+  new_info = &state->info;
+
+  if (GST_VIDEO_INFO_FORMAT (old_info) != GST_VIDEO_INFO_FORMAT (new_info) ||
+      GST_VIDEO_INFO_INTERLACE_MODE (old_info) !=
+      GST_VIDEO_INFO_INTERLACE_MODE (new_info)) {
+    return FALSE;
+  }
+
+  /* Memory type may require another device */
+  old_features = gst_caps_get_features (priv->input_state->caps, 0);
+  new_features = gst_caps_get_features (state->caps, 0);
+  if (!gst_caps_features_is_equal (old_features, new_features))
+    return FALSE;
+
+  if ((guint) GST_VIDEO_INFO_WIDTH (new_info) >
+      priv->init_params.maxEncodeWidth ||
+      (guint) GST_VIDEO_INFO_HEIGHT (new_info) >
+      priv->init_params.maxEncodeHeight) {
+    GST_DEBUG_OBJECT (self, "%dx%d is larger than session max %ux%u",
+        GST_VIDEO_INFO_WIDTH (new_info), GST_VIDEO_INFO_HEIGHT (new_info),
+        priv->init_params.maxEncodeWidth, priv->init_params.maxEncodeHeight);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Applies resolution and framerate change with NvEncReconfigureEncoder()
+ * instead of re-opening the session */
+static gboolean
+gst_nv_encoder_reconfigure_format (GstNvEncoder * self,
+    GstVideoCodecState * state)
+{
+  GstNvEncoderPrivate *priv = self->priv;
+  GstNvEncoderClass *klass = GST_NV_ENCODER_GET_CLASS (self);
+  GstVideoInfo *info = &state->info;
+  NV_ENC_RECONFIGURE_PARAMS params = { 0, };
+  NV_ENC_INITIALIZE_PARAMS *init_params = &params.reInitEncodeParams;
+  gint dar_n, dar_d;
+  gboolean resized;
+  NVENCSTATUS status;
+
+  gst_nv_encoder_drain_session (self, TRUE);
+
+  resized = GST_VIDEO_INFO_WIDTH (info) !=
+      GST_VIDEO_INFO_WIDTH (&priv->input_state->info) ||
+      GST_VIDEO_INFO_HEIGHT (info) !=
+      GST_VIDEO_INFO_HEIGHT (&priv->input_state->info);
+
+  params.version = gst_nvenc_get_reconfigure_params_version ();
+  *init_params = priv->init_params;
+  init_params->encodeConfig = &priv->config;
+  init_params->encodeWidth = GST_VIDEO_INFO_WIDTH (info);
+  init_params->encodeHeight = GST_VIDEO_INFO_HEIGHT (info);
+  if (info->fps_d > 0 && info->fps_n > 0) {
+    init_params->frameRateNum = info->fps_n;
+    init_params->frameRateDen = info->fps_d;
+  } else {
+    init_params->frameRateNum = 0;
+    init_params->frameRateDen = 1;
+  }
+
+  if (gst_util_fraction_multiply (GST_VIDEO_INFO_WIDTH (info),
+          GST_VIDEO_INFO_HEIGHT (info), GST_VIDEO_INFO_PAR_N (info),
+          GST_VIDEO_INFO_PAR_D (info), &dar_n, &dar_d) && dar_n > 0
+      && dar_d > 0) {
+    init_params->darWidth = dar_n;
+    init_params->darHeight = dar_d;
+  } else {
+    init_params->darWidth = 0;
+    init_params->darHeight = 0;
+  }
+
+  /* New sequence headers are required for the new resolution */
+  if (resized) {
+    params.resetEncoder = 1;
+    params.forceIDR = 1;
+  }
+
+  if (!gst_nv_encoder_device_lock (self))
+    return FALSE;
+
+  status = priv->object->Reconfigure (&params, info);
+  gst_nv_encoder_device_unlock (self);
+
+  if (!gst_nv_enc_result (status, self)) {
+    GST_INFO_OBJECT (self, "Couldn't reconfigure session, status: %"
+        GST_NVENC_STATUS_FORMAT, GST_NVENC_STATUS_ARGS (status));
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (self, "Reconfigured session to %dx%d",
+      GST_VIDEO_INFO_WIDTH (info), GST_VIDEO_INFO_HEIGHT (info));
+
+  priv->init_params = *init_params;
+
+  g_clear_pointer (&priv->input_state, gst_video_codec_state_unref);
+  priv->input_state = gst_video_codec_state_ref (state);
+  priv->last_flow = GST_FLOW_OK;
+
+  if (resized) {
+    if (priv->internal_pool) {
+      gst_buffer_pool_set_active (priv->internal_pool, FALSE);
+      gst_clear_object (&priv->internal_pool);
+    }
+
+    priv->internal_pool = gst_nv_encoder_create_pool (self, state);
+    if (!priv->internal_pool)
+      return FALSE;
+  }
+
+  if (!klass->set_output_state (self, priv->input_state,
+          priv->object->GetHandle ())) {
+    return FALSE;
+  }
+
+  priv->encoding_thread = std::make_unique < std::thread >
+      (gst_nv_encoder_thread_func, self);
+
+  gst_nv_encoder_update_latency (self, priv->object->GetTaskSize ());
+
+  return TRUE;
+}
+
 static gboolean
 gst_nv_encoder_set_format (GstVideoEncoder * encoder,
     GstVideoCodecState * state)
@@ -1255,6 +1492,13 @@ gst_nv_encoder_set_format (GstVideoEncoder * encoder,
   GstNvEncoder *self = GST_NV_ENCODER (encoder);
   GstNvEncoderPrivate *priv = self->priv;
 
+  if (gst_nv_encoder_can_reconfigure_format (self, state)) {
+    if (gst_nv_encoder_reconfigure_format (self, state))
+      return TRUE;
+
+    GST_INFO_OBJECT (self, "Re-opening session");
+  }
+
   gst_nv_encoder_drain (self, TRUE);
 
   g_clear_pointer (&priv->input_state, gst_video_codec_state_unref);
@@ -1566,8 +1810,8 @@ gst_nv_encoder_prepare_task_input_cuda (GstNvEncoder * self,
 
   stream = gst_cuda_memory_get_stream (cmem);
   if (stream != priv->stream) {
-    /* different stream, needs sync */
-    gst_cuda_memory_sync (cmem);
+    /* different stream, make ours wait for it, or sync if we don't have one */
+    gst_cuda_memory_sync_stream (cmem, priv->stream);
   }
 
   gst_nv_enc_task_set_resource (task, gst_buffer_ref (buffer), resource);
@@ -2040,6 +2284,63 @@ out:
       frame, meta);
 }
 
+static gboolean
+gst_nv_encoder_ensure_bitstream_pool (GstNvEncoder * self, gsize size)
+{
+  GstNvEncoderPrivate *priv = self->priv;
+  GstStructure *config;
+  GstBufferPool *pool;
+
+  if (priv->bitstream_pool && size <= priv->bitstream_pool_size)
+    return TRUE;
+
+  /* Bitstream size is not known in advance. Grow the pool so that a few
+   * larger frames (e.g., IDR) following the current one still fit */
+  size = GST_ROUND_UP_N (size + size / 2, 4096);
+
+  if (priv->bitstream_pool) {
+    gst_buffer_pool_set_active (priv->bitstream_pool, FALSE);
+    gst_clear_object (&priv->bitstream_pool);
+  }
+  priv->bitstream_pool_size = 0;
+
+  pool = gst_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, nullptr, size, 0, 0);
+  if (!gst_buffer_pool_set_config (pool, config) ||
+      !gst_buffer_pool_set_active (pool, TRUE)) {
+    GST_WARNING_OBJECT (self, "Couldn't setup bitstream pool");
+    gst_object_unref (pool);
+    return FALSE;
+  }
+
+  GST_DEBUG_OBJECT (self, "Configured bitstream pool with size %"
+      G_GSIZE_FORMAT, size);
+
+  priv->bitstream_pool = pool;
+  priv->bitstream_pool_size = size;
+
+  return TRUE;
+}
+
+/* Must be called from the encoding thread, i.e., from
+ * GstNvEncoderClass::create_output_buffer */
+GstBuffer *
+gst_nv_encoder_allocate_output_buffer (GstNvEncoder * encoder, gsize size)
+{
+  GstNvEncoderPrivate *priv = encoder->priv;
+  GstBuffer *buffer = nullptr;
+
+  if (gst_nv_encoder_ensure_bitstream_pool (encoder, size) &&
+      gst_buffer_pool_acquire_buffer (priv->bitstream_pool, &buffer,
+          nullptr) == GST_FLOW_OK) {
+    gst_buffer_set_size (buffer, size);
+    return buffer;
+  }
+
+  return gst_buffer_new_and_alloc (size);
+}
+
 void
 gst_nv_encoder_set_device_mode (GstNvEncoder * encoder,
     GstNvEncoderDeviceMode mode, guint cuda_device_id, gint64 adapter_luid)
@@ -226,6 +226,9 @@ void gst_nv_encoder_preset_to_guid (GstNvEncoderPreset preset,
 
 NV_ENC_PARAMS_RC_MODE gst_nv_encoder_rc_mode_to_native (GstNvEncoderRCMode rc_mode);
 
+GstBuffer * gst_nv_encoder_allocate_output_buffer (GstNvEncoder * encoder,
+                                                   gsize size);
+
 void gst_nv_encoder_set_device_mode (GstNvEncoder * encoder,
                                      GstNvEncoderDeviceMode mode,
                                      guint cuda_device_id,
@@ -329,6 +329,10 @@ gst_nv_h264_dec_init (GstNvH264Dec * self)
       (GDestroyNotify) gst_clear_h264_picture);
 
   self->num_output_surfaces = DEFAULT_NUM_OUTPUT_SURFACES;
+
+  /* Map and export decoded surfaces from the base class output thread, so
+   * that NVDEC keeps decoding the next pictures meanwhile */
+  gst_h264_decoder_set_async_output (GST_H264_DECODER (self), TRUE);
 }
 
 static void
@@ -439,7 +443,7 @@ gst_nv_h264_dec_open (GstVideoDecoder * decoder)
   self->decoder = gst_nv_decoder_new (self->context);
   if (!self->decoder) {
     GST_ERROR_OBJECT (self, "Failed to create decoder object");
-    gst_clear_object (&self->context);
+    gst_cuda_clear_element_context (GST_ELEMENT (self), &self->context);
 
     return FALSE;
   }
@@ -455,7 +459,7 @@ gst_nv_h264_dec_close (GstVideoDecoder * decoder)
   GstNvH264Dec *self = GST_NV_H264_DEC (decoder);
 
   gst_clear_object (&self->decoder);
-  gst_clear_object (&self->context);
+  gst_cuda_clear_element_context (GST_ELEMENT (self), &self->context);
 
   g_clear_pointer (&self->bitstream_buffer, g_free);
   g_clear_pointer (&self->slice_offsets, g_free);
@@ -1648,7 +1648,9 @@ gst_nv_h264_encoder_create_output_buffer (GstNvEncoder * encoder,
   GstH264NalUnit nalu;
 
   if (!self->packetized) {
-    buffer = gst_buffer_new_memdup (bitstream->bitstreamBufferPtr,
+    buffer = gst_nv_encoder_allocate_output_buffer (encoder,
+        bitstream->bitstreamSizeInBytes);
+    gst_buffer_fill (buffer, 0, bitstream->bitstreamBufferPtr,
         bitstream->bitstreamSizeInBytes);
   } else {
     std::vector < GstH264NalUnit > nalu_list;
@@ -1675,7 +1677,7 @@ gst_nv_h264_encoder_create_output_buffer (GstNvEncoder * encoder,
         rst = GST_H264_PARSER_OK;
     }
 
-    buffer = gst_buffer_new_and_alloc (total_size);
+    buffer = gst_nv_encoder_allocate_output_buffer (encoder, total_size);
     gst_buffer_map (buffer, &info, GST_MAP_WRITE);
     data = (guint8 *) info.data;
     /* *INDENT-OFF* */
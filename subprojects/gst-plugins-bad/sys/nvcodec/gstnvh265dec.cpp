@@ -399,7 +399,7 @@ gst_nv_h265_dec_open (GstVideoDecoder * decoder)
   self->decoder = gst_nv_decoder_new (self->context);
   if (!self->decoder) {
     GST_ERROR_OBJECT (self, "Failed to create decoder object");
-    gst_clear_object (&self->context);
+    gst_cuda_clear_element_context (GST_ELEMENT (self), &self->context);
 
     return FALSE;
   }
@@ -413,7 +413,7 @@ gst_nv_h265_dec_close (GstVideoDecoder * decoder)
   GstNvH265Dec *self = GST_NV_H265_DEC (decoder);
 
   gst_clear_object (&self->decoder);
-  gst_clear_object (&self->context);
+  gst_cuda_clear_element_context (GST_ELEMENT (self), &self->context);
 
   g_clear_pointer (&self->bitstream_buffer, g_free);
   g_clear_pointer (&self->slice_offsets, g_free);
@@ -1667,7 +1667,9 @@ gst_nv_h265_encoder_create_output_buffer (GstNvEncoder * encoder,
   GstH265NalUnit nalu;
 
   if (self->stream_format == GST_NV_H265_ENCODER_BYTE_STREAM) {
-    buffer = gst_buffer_new_memdup (bitstream->bitstreamBufferPtr,
+    buffer = gst_nv_encoder_allocate_output_buffer (encoder,
+        bitstream->bitstreamSizeInBytes);
+    gst_buffer_fill (buffer, 0, bitstream->bitstreamBufferPtr,
         bitstream->bitstreamSizeInBytes);
   } else {
     std::vector < GstH265NalUnit > nalu_list;
@@ -1694,7 +1696,7 @@ gst_nv_h265_encoder_create_output_buffer (GstNvEncoder * encoder,
         rst = GST_H265_PARSER_OK;
     }
 
-    buffer = gst_buffer_new_and_alloc (total_size);
+    buffer = gst_nv_encoder_allocate_output_buffer (encoder, total_size);
     gst_buffer_map (buffer, &info, GST_MAP_WRITE);
     data = (guint8 *) info.data;
     /* *INDENT-OFF* */
@@ -327,7 +327,7 @@ gst_nv_vp9_dec_open (GstVideoDecoder * decoder)
   self->decoder = gst_nv_decoder_new (self->context);
   if (!self->decoder) {
     GST_ERROR_OBJECT (self, "Failed to create decoder object");
-    gst_clear_object (&self->context);
+    gst_cuda_clear_element_context (GST_ELEMENT (self), &self->context);
 
     return FALSE;
   }
@@ -345,7 +345,7 @@ gst_nv_vp9_dec_close (GstVideoDecoder * decoder)
   GstNvVp9Dec *self = GST_NV_VP9_DEC (decoder);
 
   gst_clear_object (&self->decoder);
-  gst_clear_object (&self->context);
+  gst_cuda_clear_element_context (GST_ELEMENT (self), &self->context);
 
   return TRUE;
 }
@@ -470,13 +470,13 @@ gst_qsv_d3d11_allocator_upload (GstQsvAllocator * allocator,
 {
   GstMemory *mem;
   GstD3D11Memory *dmem;
-  D3D11_TEXTURE2D_DESC desc;
+  D3D11_TEXTURE2D_DESC desc, dst_desc;
   GstBuffer *dst_buf;
   GstFlowReturn flow_ret;
   gboolean shared_copy = FALSE;
 
   /* 1) D3D11 buffer from the same d3d11device with ours
-   * 1-1) Same resolution
+   * 1-1) Same format and at least our aligned resolution
    *      -> Increase refcount and wrap with GstQsvFrame
    * 1-2) Different resolution
    *      -> GPU copy
@@ -519,8 +519,12 @@ gst_qsv_d3d11_allocator_upload (GstQsvAllocator * allocator,
   }
 
   gst_d3d11_memory_get_texture_desc (dmem, &desc);
+  gst_d3d11_memory_get_texture_desc (GST_D3D11_MEMORY_CAST
+      (gst_buffer_peek_memory (dst_buf, 0)), &dst_desc);
 
-  if (desc.Usage == D3D11_USAGE_DEFAULT && !shared_copy) {
+  if (desc.Usage == D3D11_USAGE_DEFAULT && !shared_copy &&
+      desc.Format == dst_desc.Format && desc.Width >= dst_desc.Width &&
+      desc.Height >= dst_desc.Height) {
     GST_TRACE_OBJECT (allocator, "Wrapping D3D11 buffer without copy");
     gst_buffer_unref (dst_buf);
 
@@ -83,6 +83,58 @@ gst_qsv_va_allocator_alloc (GstQsvAllocator * allocator, gboolean dummy_alloc,
   return MFX_ERR_UNSUPPORTED;
 }
 
+static gboolean
+gst_qsv_va_allocator_get_surface_info (GstAllocator * allocator,
+    GstVideoInfo * info)
+{
+  if (GST_IS_VA_ALLOCATOR (allocator))
+    return gst_va_allocator_get_format (allocator, info, nullptr, nullptr);
+
+  if (GST_IS_VA_DMABUF_ALLOCATOR (allocator))
+    return gst_va_dmabuf_allocator_get_format (allocator, info, nullptr);
+
+  return FALSE;
+}
+
+/* Checks whether the surface of @buffer can be handed to the runtime as is.
+ * The surface needs to be at least as large as the ones of our own @pool,
+ * since the runtime works on the aligned resolution */
+static gboolean
+gst_qsv_va_allocator_can_import (GstQsvVaAllocator * self,
+    GstBuffer * buffer, GstBufferPool * pool)
+{
+  GstMemory *mem;
+  GstStructure *config;
+  GstAllocator *pool_allocator = nullptr;
+  GstVideoInfo src_info, dst_info;
+  gboolean ret;
+
+  mem = gst_buffer_peek_memory (buffer, 0);
+  if (!gst_qsv_va_allocator_get_surface_info (mem->allocator, &src_info))
+    return FALSE;
+
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_get_allocator (config, &pool_allocator, nullptr);
+  ret = pool_allocator &&
+      gst_qsv_va_allocator_get_surface_info (pool_allocator, &dst_info);
+  gst_structure_free (config);
+
+  if (!ret)
+    return FALSE;
+
+  if (GST_VIDEO_INFO_FORMAT (&src_info) != GST_VIDEO_INFO_FORMAT (&dst_info) ||
+      GST_VIDEO_INFO_WIDTH (&src_info) < GST_VIDEO_INFO_WIDTH (&dst_info) ||
+      GST_VIDEO_INFO_HEIGHT (&src_info) < GST_VIDEO_INFO_HEIGHT (&dst_info)) {
+    GST_LOG_OBJECT (self, "Surface %s %dx%d is not compatible with %s %dx%d",
+        GST_VIDEO_INFO_NAME (&src_info), GST_VIDEO_INFO_WIDTH (&src_info),
+        GST_VIDEO_INFO_HEIGHT (&src_info), GST_VIDEO_INFO_NAME (&dst_info),
+        GST_VIDEO_INFO_WIDTH (&dst_info), GST_VIDEO_INFO_HEIGHT (&dst_info));
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
 static GstBuffer *
 gst_qsv_va_allocator_upload (GstQsvAllocator * allocator,
     const GstVideoInfo * info, GstBuffer * buffer, GstBufferPool * pool)
@@ -93,9 +145,12 @@ gst_qsv_va_allocator_upload (GstQsvAllocator * allocator,
   GstBuffer *dst_buf;
   GstFlowReturn ret;
 
+  /* Surfaces from the same display (e.g., vah264dec output) are wrapped
+   * without copy, as long as those are large enough for the runtime */
   surface = gst_va_buffer_get_surface (buffer);
   if (surface != VA_INVALID_ID && gst_va_buffer_peek_display (buffer) ==
-      self->display) {
+      self->display && gst_qsv_va_allocator_can_import (self, buffer, pool)) {
+    GST_TRACE_OBJECT (self, "Wrapping VA surface without copy");
     return gst_buffer_ref (buffer);
   }
 
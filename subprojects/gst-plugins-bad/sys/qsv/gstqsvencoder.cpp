@@ -146,6 +146,10 @@ struct _GstQsvEncoderPrivate
   GQueue free_tasks;
   GQueue pending_tasks;
 
+  /* Output bitstream buffer pool, grown to the largest bitstream seen */
+  GstBufferPool *bitstream_pool;
+  gsize bitstream_pool_size;
+
   /* Properties */
   guint target_usage;
   gboolean low_latency;
@@ -504,6 +508,12 @@ gst_qsv_encoder_reset (GstQsvEncoder * self)
     gst_clear_object (&priv->internal_pool);
   }
 
+  if (priv->bitstream_pool) {
+    gst_buffer_pool_set_active (priv->bitstream_pool, FALSE);
+    gst_clear_object (&priv->bitstream_pool);
+  }
+  priv->bitstream_pool_size = 0;
+
   g_array_set_size (priv->surface_pool, 0);
   g_array_set_size (priv->task_pool, 0);
   g_queue_clear (&priv->free_tasks);
@@ -512,6 +522,53 @@ gst_qsv_encoder_reset (GstQsvEncoder * self)
   return TRUE;
 }
 
+/* Output bitstream buffers are recycled via internal pool instead of
+ * allocating new memory per encoded frame */
+GstBuffer *
+gst_qsv_encoder_allocate_output_buffer (GstQsvEncoder * encoder, gsize size)
+{
+  GstQsvEncoderPrivate *priv = encoder->priv;
+  GstBuffer *buffer = nullptr;
+
+  if (!priv->bitstream_pool || size > priv->bitstream_pool_size) {
+    GstStructure *config;
+    GstBufferPool *pool;
+    gsize pool_size;
+
+    if (priv->bitstream_pool) {
+      gst_buffer_pool_set_active (priv->bitstream_pool, FALSE);
+      gst_clear_object (&priv->bitstream_pool);
+    }
+    priv->bitstream_pool_size = 0;
+
+    /* Leave headroom for following bigger frames (e.g., IDR) */
+    pool_size = GST_ROUND_UP_N (size + size / 2, 4096);
+
+    pool = gst_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, nullptr, pool_size, 0, 0);
+    if (gst_buffer_pool_set_config (pool, config) &&
+        gst_buffer_pool_set_active (pool, TRUE)) {
+      GST_DEBUG_OBJECT (encoder, "Configured bitstream pool with size %"
+          G_GSIZE_FORMAT, pool_size);
+      priv->bitstream_pool = pool;
+      priv->bitstream_pool_size = pool_size;
+    } else {
+      GST_WARNING_OBJECT (encoder, "Couldn't setup bitstream pool");
+      gst_object_unref (pool);
+    }
+  }
+
+  if (priv->bitstream_pool &&
+      gst_buffer_pool_acquire_buffer (priv->bitstream_pool, &buffer,
+          nullptr) == GST_FLOW_OK) {
+    gst_buffer_set_size (buffer, size);
+    return buffer;
+  }
+
+  return gst_buffer_new_and_alloc (size);
+}
+
 static gboolean
 gst_qsv_encoder_stop (GstVideoEncoder * encoder)
 {
@@ -825,7 +882,8 @@ gst_qsv_encoder_finish_frame (GstQsvEncoder * self, GstQsvEncoderTask * task,
   if (klass->create_output_buffer) {
     buffer = klass->create_output_buffer (self, bs);
   } else {
-    buffer = gst_buffer_new_memdup (bs->Data + bs->DataOffset, bs->DataLength);
+    buffer = gst_qsv_encoder_allocate_output_buffer (self, bs->DataLength);
+    gst_buffer_fill (buffer, 0, bs->Data + bs->DataOffset, bs->DataLength);
   }
   gst_qsv_encoder_task_reset (self, task);
 
@@ -1480,6 +1538,7 @@ gst_qsv_encoder_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
   guint size;
   GstStructure *config;
   GstCapsFeatures *features;
+  GstVideoAlignment align;
   gboolean is_d3d11 = FALSE;
 
   gst_query_parse_allocation (query, &caps, nullptr);
@@ -1506,20 +1565,20 @@ gst_qsv_encoder_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
   config = gst_buffer_pool_get_config (pool);
   gst_buffer_pool_config_add_option (config, GST_BUFFER_POOL_OPTION_VIDEO_META);
 
+  /* Propose the runtime's aligned resolution so that upstream buffers
+   * can be wrapped as is, instead of being copied into our internal pool */
+  gst_video_alignment_reset (&align);
+  align.padding_right = GST_VIDEO_INFO_WIDTH (&priv->aligned_info) -
+      GST_VIDEO_INFO_WIDTH (&info);
+  align.padding_bottom = GST_VIDEO_INFO_HEIGHT (&priv->aligned_info) -
+      GST_VIDEO_INFO_HEIGHT (&info);
+
   if (is_d3d11) {
     GstD3D11AllocationParams *d3d11_params;
-    GstVideoAlignment align;
 
     /* d3d11 buffer pool doesn't support generic video alignment
      * because memory layout of CPU accessible staging texture is uncontrollable.
      * Do D3D11 specific handling */
-    gst_video_alignment_reset (&align);
-
-    align.padding_right = GST_VIDEO_INFO_WIDTH (&priv->aligned_info) -
-        GST_VIDEO_INFO_WIDTH (&info);
-    align.padding_bottom = GST_VIDEO_INFO_HEIGHT (&priv->aligned_info) -
-        GST_VIDEO_INFO_HEIGHT (&info);
-
     d3d11_params = gst_d3d11_allocation_params_new (device, &info,
         GST_D3D11_ALLOCATION_FLAG_DEFAULT, 0, 0);
 
@@ -1529,6 +1588,7 @@ gst_qsv_encoder_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
   } else {
     gst_buffer_pool_config_add_option (config,
         GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
+    gst_buffer_pool_config_set_video_alignment (config, &align);
   }
 
   size = GST_VIDEO_INFO_SIZE (&info);
@@ -1604,6 +1664,9 @@ gst_qsv_encoder_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
     return FALSE;
   }
 
+  /* Propose the runtime's aligned resolution so that upstream surfaces
+   * can be wrapped as is. VA pool ignores the generic video alignment
+   * for surface allocation, use VA specific one */
   gst_video_alignment_reset (&align);
   align.padding_right = GST_VIDEO_INFO_WIDTH (&priv->aligned_info) -
       GST_VIDEO_INFO_WIDTH (&info);
@@ -1612,9 +1675,7 @@ gst_qsv_encoder_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
 
   config = gst_buffer_pool_get_config (pool);
   gst_buffer_pool_config_add_option (config, GST_BUFFER_POOL_OPTION_VIDEO_META);
-  gst_buffer_pool_config_add_option (config,
-      GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT);
-  gst_buffer_pool_config_set_video_alignment (config, &align);
+  gst_buffer_pool_config_set_va_alignment (config, &align);
 
   gst_buffer_pool_config_set_params (config,
       caps, GST_VIDEO_INFO_SIZE (&info), priv->surface_pool->len, 0);
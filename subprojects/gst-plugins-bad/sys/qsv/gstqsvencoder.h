@@ -92,6 +92,9 @@ struct _GstQsvEncoderClass
 
 GType gst_qsv_encoder_get_type (void);
 
+GstBuffer * gst_qsv_encoder_allocate_output_buffer (GstQsvEncoder * encoder,
+                                                    gsize size);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstQsvEncoder, gst_object_unref)
 
 G_END_DECLS
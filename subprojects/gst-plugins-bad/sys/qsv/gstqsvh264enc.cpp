@@ -2014,7 +2014,9 @@ gst_qsv_h264_enc_create_output_buffer (GstQsvEncoder * encoder,
   GstH264NalUnit nalu;
 
   if (!self->packetized) {
-    buf = gst_buffer_new_memdup (bitstream->Data + bitstream->DataOffset,
+    buf = gst_qsv_encoder_allocate_output_buffer (encoder,
+        bitstream->DataLength);
+    gst_buffer_fill (buf, 0, bitstream->Data + bitstream->DataOffset,
         bitstream->DataLength);
   } else {
     std::vector < GstH264NalUnit > nalu_list;
@@ -2040,7 +2042,7 @@ gst_qsv_h264_enc_create_output_buffer (GstQsvEncoder * encoder,
         rst = GST_H264_PARSER_OK;
     }
 
-    buf = gst_buffer_new_and_alloc (total_size);
+    buf = gst_qsv_encoder_allocate_output_buffer (encoder, total_size);
     gst_buffer_map (buf, &info, GST_MAP_WRITE);
     data = (guint8 *) info.data;
 
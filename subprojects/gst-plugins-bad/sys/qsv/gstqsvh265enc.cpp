@@ -1358,7 +1358,9 @@ gst_qsv_h265_enc_create_output_buffer (GstQsvEncoder * encoder,
 {
   GstBuffer *buf;
 
-  buf = gst_buffer_new_memdup (bitstream->Data + bitstream->DataOffset,
+  buf = gst_qsv_encoder_allocate_output_buffer (encoder,
+      bitstream->DataLength);
+  gst_buffer_fill (buf, 0, bitstream->Data + bitstream->DataOffset,
       bitstream->DataLength);
 
   /* This buffer must be the end of a frame boundary */
@@ -58,7 +58,8 @@ enum
   PROP_PERMS,
   PROP_SHM_SIZE,
   PROP_WAIT_FOR_CONNECTION,
-  PROP_BUFFER_TIME
+  PROP_BUFFER_TIME,
+  PROP_USE_MEMFD
 };
 
 struct GstShmClient
@@ -69,6 +70,7 @@ struct GstShmClient
 
 #define DEFAULT_SIZE ( 64 * 1024 * 1024 )
 #define DEFAULT_WAIT_FOR_CONNECTION (TRUE)
+#define DEFAULT_USE_MEMFD (FALSE)
 /* Default is user read/write, group read */
 #define DEFAULT_PERMS ( S_IRUSR | S_IWUSR | S_IRGRP )
 
@@ -356,6 +358,7 @@ gst_shm_sink_init (GstShmSink * self)
   self->size = DEFAULT_SIZE;
   self->unlock = FALSE;
   self->wait_for_connection = DEFAULT_WAIT_FOR_CONNECTION;
+  self->use_memfd = DEFAULT_USE_MEMFD;
   self->perms = DEFAULT_PERMS;
 
   gst_allocation_params_init (&self->params);
@@ -419,6 +422,29 @@ gst_shm_sink_class_init (GstShmSinkClass * klass)
           -1, G_MAXINT64, -1,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstShmSink:use-memfd:
+   *
+   * Back the shared memory area with an anonymous memfd and pass its file
+   * descriptor to the clients over the control socket, instead of creating
+   * a named shm segment that the clients open by name. Only the processes
+   * connected to the socket can then map the area, and nothing is left
+   * behind in the filesystem if the process dies.
+   *
+   * Requires a shmsrc from a version supporting it. Ignored on systems
+   * without memfd_create().
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MEMFD,
+      g_param_spec_boolean ("use-memfd",
+          "Use memfd",
+          "Pass the file descriptor of an anonymous memfd to the clients "
+          "instead of using a named shm area",
+          DEFAULT_USE_MEMFD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   signals[SIGNAL_CLIENT_CONNECTED] = g_signal_new ("client-connected",
       GST_TYPE_SHM_SINK, G_SIGNAL_RUN_LAST, 0, NULL, NULL, NULL,
       G_TYPE_NONE, 1, G_TYPE_INT);
@@ -507,6 +533,11 @@ gst_shm_sink_set_property (GObject * object, guint prop_id,
       GST_OBJECT_UNLOCK (object);
       g_cond_broadcast (&self->cond);
       break;
+    case PROP_USE_MEMFD:
+      GST_OBJECT_LOCK (object);
+      self->use_memfd = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (object);
+      break;
     default:
       break;
   }
@@ -536,6 +567,9 @@ gst_shm_sink_get_property (GObject * object, guint prop_id,
     case PROP_BUFFER_TIME:
       g_value_set_int64 (value, self->buffer_time);
       break;
+    case PROP_USE_MEMFD:
+      g_value_set_boolean (value, self->use_memfd);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -563,7 +597,8 @@ gst_shm_sink_start (GstBaseSink * bsink)
   GST_DEBUG_OBJECT (self, "Creating new socket at %s"
       " with shared memory of %d bytes", self->socket_path, self->size);
 
-  self->pipe = sp_writer_create (self->socket_path, self->size, self->perms);
+  self->pipe = sp_writer_create (self->socket_path, self->size, self->perms,
+      self->use_memfd);
 
   if (!self->pipe) {
     GST_ELEMENT_ERROR (self, RESOURCE, OPEN_READ_WRITE,
@@ -55,7 +55,8 @@
  * The defined types are:
  * type 1: new shm area
  * Area length
- * Size of path (followed by path)
+ * Size of path (followed by path), or 0 if the file descriptor of the
+ * area is passed along with the packet
  *
  * type 2: Close shm area:
  * No payload
@@ -93,6 +94,7 @@ struct _ShmArea
   int is_writer;
 
   int shm_fd;
+  int is_memfd;
 
   char *shm_area_buf;
   size_t shm_area_len;
@@ -141,6 +143,7 @@ struct _ShmPipe
   ShmClient *clients;
 
   mode_t perms;
+  int use_memfd;
 };
 
 struct _ShmClient
@@ -182,7 +185,9 @@ struct CommandBuffer
   } payload;
 };
 
-static ShmArea *sp_open_shm (char *path, int id, mode_t perms, size_t size);
+static ShmArea *sp_open_shm (char *path, int id, mode_t perms, size_t size,
+    int use_memfd);
+static ShmArea *sp_open_shm_fd (int fd, int id, size_t size);
 static void sp_close_shm (ShmArea * area);
 static int sp_shmbuf_dec (ShmPipe * self, ShmBuffer * buf,
     ShmBuffer * prev_buf, ShmClient * client, void **tag);
@@ -197,7 +202,7 @@ static void sp_shm_area_dec (ShmPipe * self, ShmArea * area);
   } while (0)
 
 ShmPipe *
-sp_writer_create (const char *path, size_t size, mode_t perms)
+sp_writer_create (const char *path, size_t size, mode_t perms, int use_memfd)
 {
   ShmPipe *self = spalloc_new (ShmPipe);
   int flags;
@@ -244,9 +249,11 @@ sp_writer_create (const char *path, size_t size, mode_t perms)
   if (listen (self->main_socket, LISTEN_BACKLOG) < 0)
     RETURN_ERROR ("listen() failed (%d): %s\n", errno, strerror (errno));
 
-  self->shm_area = sp_open_shm (NULL, ++self->next_area_id, perms, size);
+  self->shm_area = sp_open_shm (NULL, ++self->next_area_id, perms, size,
+      use_memfd);
 
   self->perms = perms;
+  self->use_memfd = use_memfd;
 
   if (!self->shm_area)
     RETURN_ERROR ("Could not open shm area (%d): %s", errno, strerror (errno));
@@ -266,12 +273,15 @@ sp_writer_create (const char *path, size_t size, mode_t perms)
 /* sp_open_shm:
  * @path: Path of the shm area for a reader,
  *  NULL if this is a writer (then it will allocate its own path)
+ * @use_memfd: for a writer, back the area with an anonymous memfd
+ *  instead of a named shm segment, its fd then has to be passed to
+ *  the readers
  *
  * Opens a ShmArea
  */
 
 static ShmArea *
-sp_open_shm (char *path, int id, mode_t perms, size_t size)
+sp_open_shm (char *path, int id, mode_t perms, size_t size, int use_memfd)
 {
   ShmArea *area = spalloc_new (ShmArea);
   char tmppath[32];
@@ -302,6 +312,18 @@ sp_open_shm (char *path, int id, mode_t perms, size_t size)
 
   if (path) {
     area->shm_fd = shm_open (path, flags, perms);
+#ifdef HAVE_MEMFD_CREATE
+  } else if (use_memfd) {
+    snprintf (tmppath, sizeof (tmppath), "shmpipe.%5d.%5d", getpid (), id);
+    area->shm_fd = memfd_create (tmppath, MFD_CLOEXEC);
+    area->is_memfd = 1;
+    if (area->shm_fd < 0)
+      RETURN_ERROR ("memfd_create failed (%d): %s\n", errno,
+          strerror (errno));
+    if (fchmod (area->shm_fd, perms) < 0)
+      RETURN_ERROR ("failed to set memfd permissions (%d): %s\n", errno,
+          strerror (errno));
+#endif
   } else {
     do {
       snprintf (tmppath, sizeof (tmppath), "/shmpipe.%5d.%5d", getpid (), i++);
@@ -314,6 +336,7 @@ sp_open_shm (char *path, int id, mode_t perms, size_t size)
         path ? path : tmppath, errno, strerror (errno));
 
   if (!path) {
+    /* a memfd has no name in the filesystem, keep it for debugging only */
     area->shm_area_name = strdup (tmppath);
 
     if (ftruncate (area->shm_fd, size))
@@ -339,6 +362,34 @@ sp_open_shm (char *path, int id, mode_t perms, size_t size)
   return area;
 }
 
+/* sp_open_shm_fd:
+ * @fd: file descriptor of the area received from the writer, ownership
+ *  is taken
+ *
+ * Opens a ShmArea for a reader from a passed file descriptor
+ */
+
+static ShmArea *
+sp_open_shm_fd (int fd, int id, size_t size)
+{
+  ShmArea *area = spalloc_new (ShmArea);
+
+  memset (area, 0, sizeof (ShmArea));
+
+  area->use_count = 1;
+  area->shm_fd = fd;
+  area->is_memfd = 1;
+  area->shm_area_len = size;
+  area->id = id;
+
+  area->shm_area_buf = mmap (NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+
+  if (area->shm_area_buf == MAP_FAILED)
+    RETURN_ERROR ("mmap failed (%d): %s\n", errno, strerror (errno));
+
+  return area;
+}
+
 #undef RETURN_ERROR
 
 static void
@@ -356,7 +407,7 @@ sp_close_shm (ShmArea * area)
     close (area->shm_fd);
 
   if (area->shm_area_name) {
-    if (area->is_writer)
+    if (area->is_writer && !area->is_memfd)
       shm_unlink (area->shm_area_name);
     free (area->shm_area_name);
   }
@@ -484,6 +535,65 @@ send_command (int fd, struct CommandBuffer *cb, unsigned short int type,
   return 1;
 }
 
+static int
+send_command_with_fd (int fd, struct CommandBuffer *cb,
+    unsigned short int type, int area_id, int passed_fd)
+{
+  struct msghdr msg;
+  struct iovec iov;
+  struct cmsghdr *cmsg;
+  char control[CMSG_SPACE (sizeof (int))];
+
+  cb->type = type;
+  cb->area_id = area_id;
+
+  memset (&msg, 0, sizeof (msg));
+  memset (control, 0, sizeof (control));
+  iov.iov_base = cb;
+  iov.iov_len = sizeof (struct CommandBuffer);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof (control);
+
+  cmsg = CMSG_FIRSTHDR (&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN (sizeof (int));
+  memcpy (CMSG_DATA (cmsg), &passed_fd, sizeof (int));
+
+  if (sendmsg (fd, &msg, MSG_NOSIGNAL) != sizeof (struct CommandBuffer))
+    return 0;
+
+  return 1;
+}
+
+/* Announces @area to a client, either by name or by passing its fd */
+static int
+send_new_area (int fd, ShmArea * area)
+{
+  struct CommandBuffer cb = { 0 };
+  int pathlen;
+
+  cb.payload.new_shm_area.size = area->shm_area_len;
+
+  if (area->is_memfd) {
+    cb.payload.new_shm_area.path_size = 0;
+    return send_command_with_fd (fd, &cb, COMMAND_NEW_SHM_AREA, area->id,
+        area->shm_fd);
+  }
+
+  pathlen = strlen (area->shm_area_name) + 1;
+  cb.payload.new_shm_area.path_size = pathlen;
+  if (!send_command (fd, &cb, COMMAND_NEW_SHM_AREA, area->id))
+    return 0;
+
+  if (send (fd, area->shm_area_name, pathlen, MSG_NOSIGNAL) != pathlen)
+    return 0;
+
+  return 1;
+}
+
 int
 sp_writer_resize (ShmPipe * self, size_t size)
 {
@@ -491,12 +601,12 @@ sp_writer_resize (ShmPipe * self, size_t size)
   ShmArea *old_current;
   ShmClient *client;
   int c = 0;
-  int pathlen;
 
   if (self->shm_area->shm_area_len == size)
     return 0;
 
-  newarea = sp_open_shm (NULL, ++self->next_area_id, self->perms, size);
+  newarea = sp_open_shm (NULL, ++self->next_area_id, self->perms, size,
+      self->use_memfd);
 
   if (!newarea)
     return -1;
@@ -505,8 +615,6 @@ sp_writer_resize (ShmPipe * self, size_t size)
   newarea->next = self->shm_area;
   self->shm_area = newarea;
 
-  pathlen = strlen (newarea->shm_area_name) + 1;
-
   for (client = self->clients; client; client = client->next) {
     struct CommandBuffer cb = { 0 };
 
@@ -514,13 +622,7 @@ sp_writer_resize (ShmPipe * self, size_t size)
             old_current->id))
       continue;
 
-    cb.payload.new_shm_area.size = newarea->shm_area_len;
-    cb.payload.new_shm_area.path_size = pathlen;
-    if (!send_command (client->fd, &cb, COMMAND_NEW_SHM_AREA, newarea->id))
-      continue;
-
-    if (send (client->fd, newarea->shm_area_name, pathlen, MSG_NOSIGNAL) !=
-        pathlen)
+    if (!send_new_area (client->fd, newarea))
       continue;
     c++;
   }
@@ -638,15 +740,54 @@ sp_writer_send_buf (ShmPipe * self, char *buf, size_t size, void *tag)
   return c;
 }
 
+/* @passed_fd: (out) (optional): file descriptor passed along with the
+ *  command, or -1 */
 static int
-recv_command (int fd, struct CommandBuffer *cb)
+recv_command (int fd, struct CommandBuffer *cb, int *passed_fd)
 {
+  struct msghdr msg;
+  struct iovec iov;
+  struct cmsghdr *cmsg;
+  char control[CMSG_SPACE (sizeof (int))];
+  int flags = MSG_DONTWAIT;
   int retval;
+  int received_fd = -1;
+
+  memset (&msg, 0, sizeof (msg));
+  iov.iov_base = cb;
+  iov.iov_len = sizeof (struct CommandBuffer);
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof (control);
+
+#ifdef MSG_CMSG_CLOEXEC
+  flags |= MSG_CMSG_CLOEXEC;
+#endif
+
+  retval = recvmsg (fd, &msg, flags);
+
+  for (cmsg = CMSG_FIRSTHDR (&msg); cmsg; cmsg = CMSG_NXTHDR (&msg, cmsg)) {
+    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+        cmsg->cmsg_len == CMSG_LEN (sizeof (int))) {
+      if (received_fd >= 0)
+        close (received_fd);
+      memcpy (&received_fd, CMSG_DATA (cmsg), sizeof (int));
+    }
+  }
+
+  if (passed_fd)
+    *passed_fd = received_fd;
+  else if (received_fd >= 0)
+    close (received_fd);
 
-  retval = recv (fd, cb, sizeof (struct CommandBuffer), MSG_DONTWAIT);
   if (retval == sizeof (struct CommandBuffer)) {
     return 1;
   } else {
+    if (passed_fd && received_fd >= 0) {
+      close (received_fd);
+      *passed_fd = -1;
+    }
     return 0;
   }
 }
@@ -659,15 +800,35 @@ sp_client_recv (ShmPipe * self, char **buf)
   ShmArea *area;
   struct CommandBuffer cb;
   int retval;
+  int passed_fd = -1;
 
-  if (!recv_command (self->main_socket, &cb))
+  if (!recv_command (self->main_socket, &cb, &passed_fd))
     return -1;
 
+  if (passed_fd >= 0 && (cb.type != COMMAND_NEW_SHM_AREA ||
+          cb.payload.new_shm_area.path_size > 0)) {
+    close (passed_fd);
+    passed_fd = -1;
+  }
+
   switch (cb.type) {
     case COMMAND_NEW_SHM_AREA:
-      assert (cb.payload.new_shm_area.path_size > 0);
       assert (cb.payload.new_shm_area.size > 0);
 
+      if (cb.payload.new_shm_area.path_size == 0) {
+        if (passed_fd < 0)
+          return -5;
+
+        newarea = sp_open_shm_fd (passed_fd, cb.area_id,
+            cb.payload.new_shm_area.size);
+        if (!newarea)
+          return -4;
+
+        newarea->next = self->shm_area;
+        self->shm_area = newarea;
+        break;
+      }
+
       area_name = malloc (cb.payload.new_shm_area.path_size + 1);
       retval = recv (self->main_socket, area_name,
           cb.payload.new_shm_area.path_size, 0);
@@ -679,7 +840,7 @@ sp_client_recv (ShmPipe * self, char **buf)
       area_name[retval] = 0;
 
       newarea = sp_open_shm (area_name, cb.area_id, 0,
-          cb.payload.new_shm_area.size);
+          cb.payload.new_shm_area.size, 0);
       free (area_name);
       if (!newarea)
         return -4;
@@ -721,7 +882,7 @@ sp_writer_recv (ShmPipe * self, ShmClient * client, void **tag)
   ShmBuffer *buf = NULL, *prev_buf = NULL;
   struct CommandBuffer cb;
 
-  if (!recv_command (client->fd, &cb))
+  if (!recv_command (client->fd, &cb, NULL))
     return -1;
 
   switch (cb.type) {
@@ -809,8 +970,6 @@ sp_writer_accept_client (ShmPipe * self)
 {
   ShmClient *client = NULL;
   int fd;
-  struct CommandBuffer cb = { 0 };
-  int pathlen = strlen (self->shm_area->shm_area_name) + 1;
 
 
   fd = accept (self->main_socket, NULL, NULL);
@@ -820,19 +979,11 @@ sp_writer_accept_client (ShmPipe * self)
     return NULL;
   }
 
-  cb.payload.new_shm_area.size = self->shm_area->shm_area_len;
-  cb.payload.new_shm_area.path_size = pathlen;
-  if (!send_command (fd, &cb, COMMAND_NEW_SHM_AREA, self->shm_area->id)) {
+  if (!send_new_area (fd, self->shm_area)) {
     fprintf (stderr, "Sending new shm area failed: %s", strerror (errno));
     goto error;
   }
 
-  if (send (fd, self->shm_area->shm_area_name, pathlen, MSG_NOSIGNAL) !=
-      pathlen) {
-    fprintf (stderr, "Sending new shm area path failed: %s", strerror (errno));
-    goto error;
-  }
-
   client = spalloc_new (ShmClient);
   client->fd = fd;
 
@@ -80,7 +80,8 @@ typedef struct _ShmBuffer ShmBuffer;
 
 typedef void (*sp_buffer_free_callback) (void * tag, void * user_data);
 
-ShmPipe *sp_writer_create (const char *path, size_t size, mode_t perms);
+ShmPipe *sp_writer_create (const char *path, size_t size, mode_t perms,
+    int use_memfd);
 const char *sp_writer_get_path (ShmPipe *pipe);
 void sp_writer_close (ShmPipe * self, sp_buffer_free_callback callback,
     void * user_data);
@@ -29,15 +29,29 @@
 #define GST_CAT_DEFAULT gst_va_base_enc_debug
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
 
+#define SCENE_CUT_HISTOGRAM_BINS 64
+#define DEFAULT_SCENE_CUT_THRESHOLD 0
+
 struct _GstVaBaseEncPrivate
 {
   GstVideoInfo sinkpad_info;
   GstBufferPool *raw_pool;
+
+  /* output bitstream pool, grown to the largest coded size seen */
+  GstBufferPool *bitstream_pool;
+  GstAllocator *bitstream_allocator;
+  gsize bitstream_pool_size;
+
+  /* scene cut detection, luma histogram of the previous input frame */
+  guint scene_cut_threshold;
+  guint32 prev_histogram[SCENE_CUT_HISTOGRAM_BINS];
+  gboolean prev_histogram_valid;
 };
 
 enum
 {
   PROP_DEVICE_PATH = 1,
+  PROP_SCENE_CUT_THRESHOLD,
   N_PROPERTIES
 };
 
@@ -69,11 +83,14 @@ gst_va_base_enc_reset_state_default (GstVaBaseEnc * base)
   base->rt_format = 0;
   base->codedbuf_size = 0;
   g_atomic_int_set (&base->reconf, FALSE);
+  g_atomic_int_set (&base->update_rc, FALSE);
 }
 
 static void
 _flush_all_frames (GstVaBaseEnc * base)
 {
+  base->priv->prev_histogram_valid = FALSE;
+
   g_queue_clear_full (&base->reorder_list,
       (GDestroyNotify) gst_video_codec_frame_unref);
   g_queue_clear_full (&base->output_list,
@@ -134,6 +151,16 @@ gst_va_base_enc_start (GstVideoEncoder * venc)
   return TRUE;
 }
 
+static void
+_clear_bitstream_pool (GstVaBaseEnc * base)
+{
+  if (base->priv->bitstream_pool)
+    gst_buffer_pool_set_active (base->priv->bitstream_pool, FALSE);
+  gst_clear_object (&base->priv->bitstream_pool);
+  gst_clear_object (&base->priv->bitstream_allocator);
+  base->priv->bitstream_pool_size = 0;
+}
+
 static gboolean
 gst_va_base_enc_close (GstVideoEncoder * venc)
 {
@@ -161,6 +188,8 @@ gst_va_base_enc_stop (GstVideoEncoder * venc)
     gst_buffer_pool_set_active (base->priv->raw_pool, FALSE);
   gst_clear_object (&base->priv->raw_pool);
 
+  _clear_bitstream_pool (base);
+
   if (base->input_state)
     gst_video_codec_state_unref (base->input_state);
 
@@ -317,6 +346,63 @@ invalid_buffer:
   }
 }
 
+static GstBuffer *
+_allocate_bitstream_buffer (GstVaBaseEnc * base, gsize size)
+{
+  GstVaBaseEncPrivate *priv = base->priv;
+  GstAllocator *allocator = NULL;
+  GstAllocationParams params;
+  GstBuffer *buf = NULL;
+
+  gst_video_encoder_get_allocator (GST_VIDEO_ENCODER_CAST (base), &allocator,
+      &params);
+
+  /* Recreate the pool if downstream changed the allocator or if the coded
+   * picture doesn't fit */
+  if (!priv->bitstream_pool || priv->bitstream_allocator != allocator
+      || size > priv->bitstream_pool_size) {
+    GstStructure *config;
+    GstBufferPool *pool;
+    gsize pool_size;
+
+    _clear_bitstream_pool (base);
+
+    /* Leave some headroom for the following bigger pictures, but never go
+     * beyond the coded buffer size */
+    pool_size = GST_ROUND_UP_N (size + size / 2, 4096);
+    if (base->codedbuf_size > 0)
+      pool_size = MAX (MIN (pool_size, base->codedbuf_size), size);
+
+    pool = gst_buffer_pool_new ();
+    config = gst_buffer_pool_get_config (pool);
+    gst_buffer_pool_config_set_params (config, NULL, pool_size, 0, 0);
+    gst_buffer_pool_config_set_allocator (config, allocator, &params);
+    if (gst_buffer_pool_set_config (pool, config)
+        && gst_buffer_pool_set_active (pool, TRUE)) {
+      GST_DEBUG_OBJECT (base, "Configured bitstream pool with size %"
+          G_GSIZE_FORMAT, pool_size);
+      priv->bitstream_pool = pool;
+      priv->bitstream_allocator = allocator ? gst_object_ref (allocator) : NULL;
+      priv->bitstream_pool_size = pool_size;
+    } else {
+      GST_WARNING_OBJECT (base, "Couldn't setup bitstream pool");
+      gst_object_unref (pool);
+    }
+  }
+
+  gst_clear_object (&allocator);
+
+  if (priv->bitstream_pool &&
+      gst_buffer_pool_acquire_buffer (priv->bitstream_pool, &buf,
+          NULL) == GST_FLOW_OK) {
+    gst_buffer_set_size (buf, size);
+    return buf;
+  }
+
+  return gst_video_encoder_allocate_output_buffer (GST_VIDEO_ENCODER_CAST
+      (base), size);
+}
+
 static GstBuffer *
 gst_va_base_enc_create_output_buffer (GstVaBaseEnc * base,
     GstVaEncodePicture * picture)
@@ -347,8 +433,7 @@ gst_va_base_enc_create_output_buffer (GstVaBaseEnc * base,
   for (seg = seg_list; seg; seg = seg->next)
     coded_size += seg->size;
 
-  buf = gst_video_encoder_allocate_output_buffer (GST_VIDEO_ENCODER_CAST (base),
-      coded_size);
+  buf = _allocate_bitstream_buffer (base, coded_size);
   if (!buf) {
     va_unmap_buffer (base->display, picture->coded_buffer);
     GST_ERROR_OBJECT (base, "Failed to allocate output buffer, size %d",
@@ -601,6 +686,106 @@ error_and_purge_all:
   return ret;
 }
 
+/* Builds a coarse histogram of the luma plane, only looking at every 4th
+ * pixel of every 4th line, which is enough to tell scenes apart. */
+static gboolean
+_luma_histogram (GstVaBaseEnc * base, GstBuffer * buffer,
+    guint32 histogram[SCENE_CUT_HISTOGRAM_BINS])
+{
+  GstVideoInfo *info = &base->input_state->info;
+  const GstVideoFormatInfo *finfo = info->finfo;
+  GstVideoFrame frame;
+  guint x, y, width, height, pstride, shift, offset;
+  gint stride;
+
+  if (!GST_VIDEO_FORMAT_INFO_IS_YUV (finfo))
+    return FALSE;
+
+  if (!gst_video_frame_map (&frame, info, buffer, GST_MAP_READ))
+    return FALSE;
+
+  width = GST_VIDEO_FRAME_COMP_WIDTH (&frame, 0);
+  height = GST_VIDEO_FRAME_COMP_HEIGHT (&frame, 0);
+  stride = GST_VIDEO_FRAME_COMP_STRIDE (&frame, 0);
+  pstride = GST_VIDEO_FRAME_COMP_PSTRIDE (&frame, 0);
+  offset = GST_VIDEO_FORMAT_INFO_POFFSET (finfo, 0);
+
+  /* use the most significant byte of the luma sample */
+  shift = GST_VIDEO_FORMAT_INFO_SHIFT (finfo, 0) +
+      GST_VIDEO_FORMAT_INFO_DEPTH (finfo, 0) - 8;
+  if (pstride == 0 || GST_VIDEO_FORMAT_INFO_DEPTH (finfo, 0) < 8) {
+    gst_video_frame_unmap (&frame);
+    return FALSE;
+  }
+
+  memset (histogram, 0, sizeof (guint32) * SCENE_CUT_HISTOGRAM_BINS);
+
+  for (y = 0; y < height; y += 4) {
+    const guint8 *line = (const guint8 *) GST_VIDEO_FRAME_COMP_DATA (&frame,
+        0) + y * stride + offset;
+
+    for (x = 0; x < width; x += 4) {
+      guint value;
+
+      if (pstride == 1) {
+        value = line[x];
+      } else if (GST_VIDEO_FORMAT_INFO_IS_LE (finfo)) {
+        value = (GST_READ_UINT16_LE (line + x * pstride) >> shift) & 0xff;
+      } else {
+        value = (GST_READ_UINT16_BE (line + x * pstride) >> shift) & 0xff;
+      }
+
+      histogram[value * SCENE_CUT_HISTOGRAM_BINS / 256]++;
+    }
+  }
+
+  gst_video_frame_unmap (&frame);
+
+  return TRUE;
+}
+
+static gboolean
+_is_scene_cut (GstVaBaseEnc * base, GstBuffer * buffer)
+{
+  GstVaBaseEncPrivate *priv = base->priv;
+  guint32 histogram[SCENE_CUT_HISTOGRAM_BINS];
+  guint64 diff = 0, total = 0;
+  guint threshold, i, score;
+  gboolean had_prev;
+
+  GST_OBJECT_LOCK (base);
+  threshold = priv->scene_cut_threshold;
+  GST_OBJECT_UNLOCK (base);
+
+  if (threshold == 0)
+    return FALSE;
+
+  if (!_luma_histogram (base, buffer, histogram)) {
+    priv->prev_histogram_valid = FALSE;
+    return FALSE;
+  }
+
+  had_prev = priv->prev_histogram_valid;
+  for (i = 0; had_prev && i < SCENE_CUT_HISTOGRAM_BINS; i++) {
+    diff += ABS ((gint64) histogram[i] - (gint64) priv->prev_histogram[i]);
+    total += histogram[i];
+  }
+
+  memcpy (priv->prev_histogram, histogram, sizeof (histogram));
+  priv->prev_histogram_valid = TRUE;
+
+  if (!had_prev || total == 0)
+    return FALSE;
+
+  /* 0 for identical histograms, 100 for disjoint ones */
+  score = diff * 100 / (2 * total);
+
+  GST_LOG_OBJECT (base, "scene change score %u, threshold %u", score,
+      threshold);
+
+  return score >= threshold;
+}
+
 static gboolean
 gst_va_base_enc_reset (GstVaBaseEnc * base)
 {
@@ -637,6 +822,23 @@ gst_va_base_enc_handle_frame (GstVideoEncoder * venc,
   if (g_atomic_int_compare_and_exchange (&base->reconf, TRUE, FALSE)) {
     if (!gst_va_base_enc_reset (base))
       return GST_FLOW_ERROR;
+  } else if (g_atomic_int_compare_and_exchange (&base->update_rc, TRUE, FALSE)) {
+    /* New rate control parameters are sent with the next picture, without
+     * draining nor restarting the GOP */
+    g_assert (base_class->update_rate_control);
+    if (!base_class->update_rate_control (base)) {
+      GST_DEBUG_OBJECT (base, "Couldn't update rate control in-stream");
+      if (!gst_va_base_enc_reset (base))
+        return GST_FLOW_ERROR;
+    }
+  }
+
+  /* Start a new intra frame at scene cuts, the GOP structure of the
+   * subclass would otherwise predict it from unrelated pictures */
+  if (_is_scene_cut (base, frame->input_buffer)) {
+    GST_DEBUG_OBJECT (base, "scene cut at system_frame_number: %d",
+        frame->system_frame_number);
+    GST_VIDEO_CODEC_FRAME_SET_FORCE_KEYFRAME (frame);
   }
 
   ret = gst_va_base_enc_import_input_buffer (base,
@@ -715,17 +917,62 @@ gst_va_base_enc_finish (GstVideoEncoder * venc)
   return gst_va_base_enc_drain (venc);
 }
 
+/* Whether the new input caps only differ in framerate */
+static gboolean
+_is_framerate_change (GstVaBaseEnc * base, GstVideoCodecState * state)
+{
+  GstVideoInfo info;
+
+  if (!base->input_state || !gst_va_encoder_is_open (base->encoder))
+    return FALSE;
+
+  info = base->input_state->info;
+  GST_VIDEO_INFO_FPS_N (&info) = GST_VIDEO_INFO_FPS_N (&state->info);
+  GST_VIDEO_INFO_FPS_D (&info) = GST_VIDEO_INFO_FPS_D (&state->info);
+
+  return GST_VIDEO_INFO_FPS_N (&state->info) > 0
+      && GST_VIDEO_INFO_FPS_D (&state->info) > 0
+      && gst_video_info_is_equal (&info, &state->info)
+      && gst_caps_features_is_equal (gst_caps_get_features (state->caps, 0),
+      gst_caps_get_features (base->input_state->caps, 0));
+}
+
 static gboolean
 gst_va_base_enc_set_format (GstVideoEncoder * venc, GstVideoCodecState * state)
 {
   GstVaBaseEnc *base = GST_VA_BASE_ENC (venc);
+  GstVaBaseEncClass *base_class = GST_VA_BASE_ENC_GET_CLASS (base);
 
   g_return_val_if_fail (state->caps != NULL, FALSE);
 
+  if (base_class->update_rate_control && _is_framerate_change (base, state)) {
+    GstVideoCodecState *output_state;
+
+    GST_DEBUG_OBJECT (base, "Framerate change only, update in-stream");
+
+    output_state = gst_video_encoder_get_output_state (venc);
+    if (output_state) {
+      gst_video_codec_state_unref (gst_video_encoder_set_output_state (venc,
+              gst_caps_copy (output_state->caps), state));
+      gst_video_codec_state_unref (output_state);
+    }
+
+    gst_video_codec_state_unref (base->input_state);
+    base->input_state = gst_video_codec_state_ref (state);
+    base->frame_duration = gst_util_uint64_scale (GST_SECOND,
+        GST_VIDEO_INFO_FPS_D (&state->info),
+        GST_VIDEO_INFO_FPS_N (&state->info));
+    g_atomic_int_set (&base->update_rc, TRUE);
+
+    return TRUE;
+  }
+
   if (base->input_state)
     gst_video_codec_state_unref (base->input_state);
   base->input_state = gst_video_codec_state_ref (state);
 
+  base->priv->prev_histogram_valid = FALSE;
+
   if (!gst_va_base_enc_reset (base))
     return FALSE;
 
@@ -805,6 +1052,21 @@ gst_va_base_enc_src_query (GstVideoEncoder * venc, GstQuery * query)
   return ret;
 }
 
+static gboolean
+gst_va_base_enc_src_event (GstVideoEncoder * venc, GstEvent * event)
+{
+  guint bitrate;
+
+  /* bandwidth estimate from rtpsession, follow it like a change of the
+   * bitrate property */
+  if (gst_video_event_parse_bandwidth_estimate (event, &bitrate)) {
+    GST_DEBUG_OBJECT (venc, "Following bandwidth estimate of %u bps", bitrate);
+    g_object_set (venc, "bitrate", MAX (bitrate / 1000, 1), NULL);
+  }
+
+  return GST_VIDEO_ENCODER_CLASS (parent_class)->src_event (venc, event);
+}
+
 static gboolean
 gst_va_base_enc_sink_query (GstVideoEncoder * venc, GstQuery * query)
 {
@@ -843,6 +1105,23 @@ gst_va_base_enc_set_context (GstElement * element, GstContext * context)
   GST_ELEMENT_CLASS (parent_class)->set_context (element, context);
 }
 
+static void
+gst_va_base_enc_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstVaBaseEnc *base = GST_VA_BASE_ENC (object);
+
+  switch (prop_id) {
+    case PROP_SCENE_CUT_THRESHOLD:
+      GST_OBJECT_LOCK (base);
+      base->priv->scene_cut_threshold = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (base);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+  }
+}
+
 static void
 gst_va_base_enc_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec)
@@ -850,6 +1129,11 @@ gst_va_base_enc_get_property (GObject * object, guint prop_id,
   GstVaBaseEnc *base = GST_VA_BASE_ENC (object);
 
   switch (prop_id) {
+    case PROP_SCENE_CUT_THRESHOLD:
+      GST_OBJECT_LOCK (base);
+      g_value_set_uint (value, base->priv->scene_cut_threshold);
+      GST_OBJECT_UNLOCK (base);
+      break;
     case PROP_DEVICE_PATH:{
       if (!(base->display && GST_IS_VA_DISPLAY_DRM (base->display))) {
         g_value_set_string (value, NULL);
@@ -871,12 +1155,14 @@ gst_va_base_enc_init (GstVaBaseEnc * self)
   g_queue_init (&self->output_list);
 
   self->priv = gst_va_base_enc_get_instance_private (self);
+  self->priv->scene_cut_threshold = DEFAULT_SCENE_CUT_THRESHOLD;
 }
 
 static void
 gst_va_base_enc_dispose (GObject * object)
 {
   _flush_all_frames (GST_VA_BASE_ENC (object));
+  _clear_bitstream_pool (GST_VA_BASE_ENC (object));
   gst_va_base_enc_close (GST_VIDEO_ENCODER (object));
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
@@ -889,6 +1175,7 @@ gst_va_base_enc_class_init (GstVaBaseEncClass * klass)
   GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
   GstVideoEncoderClass *encoder_class = GST_VIDEO_ENCODER_CLASS (klass);
 
+  gobject_class->set_property = gst_va_base_enc_set_property;
   gobject_class->get_property = gst_va_base_enc_get_property;
   gobject_class->dispose = gst_va_base_enc_dispose;
 
@@ -900,6 +1187,7 @@ gst_va_base_enc_class_init (GstVaBaseEncClass * klass)
   encoder_class->stop = GST_DEBUG_FUNCPTR (gst_va_base_enc_stop);
   encoder_class->getcaps = GST_DEBUG_FUNCPTR (gst_va_base_enc_get_caps);
   encoder_class->src_query = GST_DEBUG_FUNCPTR (gst_va_base_enc_src_query);
+  encoder_class->src_event = GST_DEBUG_FUNCPTR (gst_va_base_enc_src_event);
   encoder_class->sink_query = GST_DEBUG_FUNCPTR (gst_va_base_enc_sink_query);
   encoder_class->propose_allocation =
       GST_DEBUG_FUNCPTR (gst_va_base_enc_propose_allocation);
@@ -920,6 +1208,21 @@ gst_va_base_enc_class_init (GstVaBaseEncClass * klass)
       "Device Path", "DRM device path", NULL,
       G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GstVaBaseEnc:scene-cut-threshold:
+   *
+   * Sensitivity of the scene cut detection. When the luma histogram of an
+   * input frame differs from the previous one by at least this percentage,
+   * the frame is encoded as an intra frame. 0 disables the detection.
+   *
+   * Since: 1.24
+   */
+  properties[PROP_SCENE_CUT_THRESHOLD] =
+      g_param_spec_uint ("scene-cut-threshold", "Scene cut threshold",
+      "Histogram difference percentage that starts an intra frame "
+      "(0: disabled)", 0, 100, DEFAULT_SCENE_CUT_THRESHOLD,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | GST_PARAM_MUTABLE_PLAYING);
+
   g_object_class_install_properties (gobject_class, N_PROPERTIES, properties);
 
   gst_type_mark_as_plugin_api (GST_TYPE_VA_BASE_ENC, 0);
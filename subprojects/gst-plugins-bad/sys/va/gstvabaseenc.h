@@ -47,6 +47,8 @@ struct _GstVaBaseEnc
   GstVaEncoder *encoder;
 
   gboolean reconf;
+  /* only rate control parameters changed, applied in-stream */
+  gboolean update_rc;
 
   VAProfile profile;
   gint width;
@@ -89,6 +91,7 @@ struct _GstVaBaseEncClass
                               gboolean is_last);
   void     (*prepare_output) (GstVaBaseEnc * encoder,
                               GstVideoCodecFrame * frame);
+  gboolean (*update_rate_control) (GstVaBaseEnc * encoder);
 
   GstVaCodecs codec;
   VAEntrypoint entrypoint;
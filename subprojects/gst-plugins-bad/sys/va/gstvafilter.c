@@ -1730,6 +1730,22 @@ gst_va_filter_has_compose (GstVaFilter * self)
   return TRUE;
 }
 
+struct ComposeInput
+{
+  GstBuffer *buffer;
+  VASurfaceID surface;
+  VARectangle input_region;
+  VARectangle output_region;
+  gdouble alpha;
+  VABlendState blend;
+};
+
+static void
+_clear_compose_input (struct ComposeInput *input)
+{
+  gst_clear_buffer (&input->buffer);
+}
+
 /**
  * gst_va_filter_compose:
  * @tx: the #GstVaComposeTransaction for input samples and output.
@@ -1752,6 +1768,12 @@ gst_va_filter_compose (GstVaFilter * self, GstVaComposeTransaction * tx)
   VAStatus status;
   VASurfaceID out_surface;
   GstVaComposeSample *sample;
+  GArray *inputs;
+  VABufferID *buffers = NULL;
+  guint i, n_buffers = 0;
+  guint32 scale_method;
+  gboolean blend_alpha;
+  gboolean ret = FALSE;
 
   g_return_val_if_fail (GST_IS_VA_FILTER (self), FALSE);
   g_return_val_if_fail (tx, FALSE);
@@ -1767,60 +1789,78 @@ gst_va_filter_compose (GstVaFilter * self, GstVaComposeTransaction * tx)
 
   dpy = gst_va_display_get_va_dpy (self->display);
 
-  status = vaBeginPicture (dpy, self->context, out_surface);
-  if (status != VA_STATUS_SUCCESS) {
-    GST_ERROR_OBJECT (self, "vaBeginPicture: %s", vaErrorStr (status));
-    return FALSE;
-  }
+  /* Gather all the inputs first, so they are handed to the driver as one
+   * batch of pipeline parameters in a single vaRenderPicture() call instead
+   * of one call per input. The input buffers are kept alive until the output
+   * picture is done. */
+  inputs = g_array_new (FALSE, TRUE, sizeof (struct ComposeInput));
+  g_array_set_clear_func (inputs, (GDestroyNotify) _clear_compose_input);
 
   sample = tx->next (tx->user_data);
   for (; sample; sample = tx->next (tx->user_data)) {
-    VAProcPipelineParameterBuffer params = { 0, };
-    VABufferID buffer;
-    VASurfaceID in_surface;
-    VABlendState blend = { 0, };
+    struct ComposeInput input = {
+      .buffer = sample->buffer, /* (transfer full) */
+      .surface = _get_surface_from_buffer (self, sample->buffer),
+      .input_region = sample->input_region,
+      .output_region = sample->output_region,
+      .alpha = sample->alpha,
+    };
 
-    in_surface = _get_surface_from_buffer (self, sample->buffer);
-    if (in_surface == VA_INVALID_ID)
-      return FALSE;
+    g_array_append_val (inputs, input);
 
-    /* (transfer full), unref it */
-    gst_buffer_unref (sample->buffer);
+    if (input.surface == VA_INVALID_ID)
+      goto bail;
+  }
 
-    GST_OBJECT_LOCK (self);
+  GST_OBJECT_LOCK (self);
+  scale_method = self->scale_method;
+  blend_alpha = (self->pipeline_caps.blend_flags & VA_BLEND_GLOBAL_ALPHA);
+  GST_OBJECT_UNLOCK (self);
+
+  buffers = g_new (VABufferID, MAX (inputs->len, 1));
+
+  for (i = 0; i < inputs->len; i++) {
+    struct ComposeInput *input = &g_array_index (inputs, struct ComposeInput,
+        i);
     /* *INDENT-OFF* */
-    params = (VAProcPipelineParameterBuffer) {
-      .surface = in_surface,
-      .surface_region = &sample->input_region,
-      .output_region = &sample->output_region,
+    VAProcPipelineParameterBuffer params = {
+      .surface = input->surface,
+      .surface_region = &input->input_region,
+      .output_region = &input->output_region,
       .output_background_color = 0xff000000,
-      .filter_flags = self->scale_method,
+      .filter_flags = scale_method,
     };
     /* *INDENT-ON* */
-    GST_OBJECT_UNLOCK (self);
 
     /* only send blend state when sample is not fully opaque */
-    if ((self->pipeline_caps.blend_flags & VA_BLEND_GLOBAL_ALPHA)
-        && sample->alpha < 1.0) {
+    if (blend_alpha && input->alpha < 1.0) {
       /* *INDENT-OFF* */
-      blend = (VABlendState) {
+      input->blend = (VABlendState) {
         .flags = VA_BLEND_GLOBAL_ALPHA,
-        .global_alpha = sample->alpha,
+        .global_alpha = input->alpha,
       };
       /* *INDENT-ON* */
-      params.blend_state = &blend;
+      params.blend_state = &input->blend;
     }
 
     status = vaCreateBuffer (dpy, self->context,
         VAProcPipelineParameterBufferType, sizeof (params), 1, &params,
-        &buffer);
+        &buffers[n_buffers]);
     if (status != VA_STATUS_SUCCESS) {
       GST_ERROR_OBJECT (self, "vaCreateBuffer: %s", vaErrorStr (status));
-      goto fail_end_pic;
+      goto bail;
     }
+    n_buffers++;
+  }
+
+  status = vaBeginPicture (dpy, self->context, out_surface);
+  if (status != VA_STATUS_SUCCESS) {
+    GST_ERROR_OBJECT (self, "vaBeginPicture: %s", vaErrorStr (status));
+    goto bail;
+  }
 
-    status = vaRenderPicture (dpy, self->context, &buffer, 1);
-    vaDestroyBuffer (dpy, buffer);
+  if (n_buffers > 0) {
+    status = vaRenderPicture (dpy, self->context, buffers, n_buffers);
     if (status != VA_STATUS_SUCCESS) {
       GST_ERROR_OBJECT (self, "vaRenderPicture: %s", vaErrorStr (status));
       goto fail_end_pic;
@@ -1830,17 +1870,25 @@ gst_va_filter_compose (GstVaFilter * self, GstVaComposeTransaction * tx)
   status = vaEndPicture (dpy, self->context);
   if (status != VA_STATUS_SUCCESS) {
     GST_ERROR_OBJECT (self, "vaEndPicture: %s", vaErrorStr (status));
-    return FALSE;
+    goto bail;
   }
 
-  return TRUE;
+  ret = TRUE;
+
+bail:
+  for (i = 0; i < n_buffers; i++)
+    vaDestroyBuffer (dpy, buffers[i]);
+  g_free (buffers);
+  g_array_unref (inputs);
+
+  return ret;
 
 fail_end_pic:
   {
     status = vaEndPicture (dpy, self->context);
     if (status != VA_STATUS_SUCCESS)
       GST_ERROR_OBJECT (self, "vaEndPicture: %s", vaErrorStr (status));
-    return FALSE;
+    goto bail;
   }
 }
 
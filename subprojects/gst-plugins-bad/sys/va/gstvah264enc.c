@@ -252,6 +252,8 @@ struct _GstVaH264Enc
     guint cpb_size;
     /* length of CPB buffer (bits) */
     guint cpb_length_bits;
+    /* send the rate control parameters with the next picture */
+    gboolean params_changed;
   } rc;
 
   GstH264SPS sequence_hdr;
@@ -1520,10 +1522,84 @@ gst_va_h264_enc_reset_state (GstVaBaseEnc * base)
   self->rc.max_bitrate_bits = 0;
   self->rc.target_bitrate_bits = 0;
   self->rc.cpb_length_bits = 0;
+  self->rc.params_changed = FALSE;
 
   memset (&self->sequence_hdr, 0, sizeof (GstH264SPS));
 }
 
+/* Applies new bitrate or framerate without restarting the GOP. The
+ * parameters are sent with the next picture */
+static gboolean
+gst_va_h264_enc_update_rate_control (GstVaBaseEnc * base)
+{
+  GstVaH264Enc *self = GST_VA_H264_ENC (base);
+  const guint cpb_factor = _get_h264_cpb_nal_factor (base->profile);
+  const GstVaH264LevelLimits *limits = NULL;
+  guint bitrate, target_percentage, i;
+  guint64 mbps;
+
+  for (i = 0; i < G_N_ELEMENTS (_va_h264_level_limits); i++) {
+    if (_va_h264_level_limits[i].level_idc == self->level_idc) {
+      limits = &_va_h264_level_limits[i];
+      break;
+    }
+  }
+
+  if (!limits)
+    return FALSE;
+
+  mbps = gst_util_uint64_scale_int_ceil (self->mb_width * self->mb_height,
+      GST_VIDEO_INFO_FPS_N (&base->input_state->info),
+      GST_VIDEO_INFO_FPS_D (&base->input_state->info));
+  if (mbps > limits->MaxMBPS)
+    return FALSE;
+
+  GST_OBJECT_LOCK (self);
+  bitrate = self->prop.bitrate;
+  target_percentage = self->prop.target_percentage;
+  GST_OBJECT_UNLOCK (self);
+
+  switch (self->rc.rc_ctrl_mode) {
+    case VA_RC_CBR:
+    case VA_RC_VCM:
+      self->rc.max_bitrate = bitrate;
+      self->rc.target_bitrate = bitrate;
+      break;
+    case VA_RC_VBR:
+      self->rc.max_bitrate = (guint) gst_util_uint64_scale_int (bitrate,
+          100, target_percentage);
+      self->rc.target_bitrate = bitrate;
+      self->rc.target_percentage = target_percentage;
+      break;
+    default:
+      /* only the frame rate parameter is updated */
+      self->rc.params_changed = TRUE;
+      return TRUE;
+  }
+
+  if (bitrate == 0)
+    return FALSE;
+
+  _calculate_bitrate_hrd (self);
+
+  if (self->rc.max_bitrate_bits > limits->MaxBR * 1000 * cpb_factor ||
+      self->rc.cpb_length_bits > limits->MaxCPB * 1000 * cpb_factor) {
+    GST_DEBUG_OBJECT (self, "New bitrate exceeds level %s", self->level_str);
+    return FALSE;
+  }
+
+  update_property_uint (base, &self->prop.cpb_size, self->rc.cpb_size,
+      PROP_CPB_SIZE);
+
+  GST_DEBUG_OBJECT (self, "Updated max bitrate: %u bits/sec, "
+      "target bitrate: %u bits/sec", self->rc.max_bitrate_bits,
+      self->rc.target_bitrate_bits);
+
+  self->rc.params_changed = TRUE;
+
+  return TRUE;
+}
+
 static gboolean
 gst_va_h264_enc_reconfig (GstVaBaseEnc * base)
 {
@@ -1535,7 +1611,7 @@ gst_va_h264_enc_reconfig (GstVaBaseEnc * base)
   VAProfile profile = VAProfileNone;
   gboolean do_renegotiation = TRUE, do_reopen, need_negotiation;
   guint max_ref_frames, max_surfaces = 0, rt_format = 0, codedbuf_size;
-  gint width, height;
+  gint width, height, reconf_width = 0, reconf_height = 0;
 
   width = GST_VIDEO_INFO_WIDTH (&base->input_state->info);
   height = GST_VIDEO_INFO_HEIGHT (&base->input_state->info);
@@ -1550,15 +1626,20 @@ gst_va_h264_enc_reconfig (GstVaBaseEnc * base)
     if (!gst_video_info_from_caps (&vi, reconf_caps))
       return FALSE;
     reconf_format = GST_VIDEO_INFO_FORMAT (&vi);
+    reconf_width = GST_VIDEO_INFO_WIDTH (&vi);
+    reconf_height = GST_VIDEO_INFO_HEIGHT (&vi);
   }
 
   if (!_decide_profile (self, &profile, &rt_format))
     return FALSE;
 
-  /* first check */
+  /* first check. The context and reconstructed surfaces are kept for a
+   * resolution not larger than the one the encoder was opened with, only
+   * new sequence parameters are sent */
   do_reopen = !(base->profile == profile && base->rt_format == rt_format
-      && format == reconf_format && width == base->width
-      && height == base->height && self->prop.rc_ctrl == self->rc.rc_ctrl_mode);
+      && format == reconf_format && width <= reconf_width
+      && height <= reconf_height
+      && self->prop.rc_ctrl == self->rc.rc_ctrl_mode);
 
   if (do_reopen && gst_va_encoder_is_open (base->encoder))
     gst_va_encoder_close (base->encoder);
@@ -1621,10 +1702,14 @@ gst_va_h264_enc_reconfig (GstVaBaseEnc * base)
 
   /* second check after calculations */
   do_reopen |=
-      !(max_ref_frames == max_surfaces && codedbuf_size == base->codedbuf_size);
+      !(max_ref_frames == max_surfaces && codedbuf_size >= base->codedbuf_size);
   if (do_reopen && gst_va_encoder_is_open (base->encoder))
     gst_va_encoder_close (base->encoder);
 
+  /* coded buffers keep the size the encoder was opened with */
+  if (!do_reopen)
+    base->codedbuf_size = codedbuf_size;
+
   if (!gst_va_encoder_is_open (base->encoder)
       && !gst_va_encoder_open (base->encoder, base->profile,
           format, base->rt_format, base->width, base->height,
@@ -2894,6 +2979,8 @@ _encode_one_frame (GstVaH264Enc * self, GstVideoCodecFrame * gst_frame)
   if (frame->poc == 0) {
     VAEncSequenceParameterBufferH264 sequence;
 
+    self->rc.params_changed = FALSE;
+
     if (!gst_va_base_enc_add_rate_control_parameter (base, frame->picture,
             self->rc.rc_ctrl_mode, self->rc.max_bitrate_bits,
             self->rc.target_percentage, self->rc.qp_i, self->rc.min_qp,
@@ -2925,6 +3012,22 @@ _encode_one_frame (GstVaH264Enc * self, GstVideoCodecFrame * gst_frame)
     if ((self->packed_headers & VA_ENC_PACKED_HEADER_SEQUENCE)
         && !_add_sequence_header (self, frame))
       return FALSE;
+  } else if (self->rc.params_changed) {
+    /* bitrate or framerate changed in-stream */
+    if (!gst_va_base_enc_add_rate_control_parameter (base, frame->picture,
+            self->rc.rc_ctrl_mode, self->rc.max_bitrate_bits,
+            self->rc.target_percentage, self->rc.qp_i, self->rc.min_qp,
+            self->rc.max_qp, self->rc.mbbrc))
+      return FALSE;
+
+    if (!gst_va_base_enc_add_frame_rate_parameter (base, frame->picture))
+      return FALSE;
+
+    if (!gst_va_base_enc_add_hrd_parameter (base, frame->picture,
+            self->rc.rc_ctrl_mode, self->rc.cpb_length_bits))
+      return FALSE;
+
+    self->rc.params_changed = FALSE;
   }
 
   /* Non I frame, construct reference list. */
@@ -3322,11 +3425,11 @@ gst_va_h264_enc_set_property (GObject * object, guint prop_id,
     }
     case PROP_BITRATE:
       self->prop.bitrate = g_value_get_uint (value);
-      g_atomic_int_set (&GST_VA_BASE_ENC (self)->reconf, TRUE);
+      g_atomic_int_set (&GST_VA_BASE_ENC (self)->update_rc, TRUE);
       break;
     case PROP_TARGET_PERCENTAGE:
       self->prop.target_percentage = g_value_get_uint (value);
-      g_atomic_int_set (&GST_VA_BASE_ENC (self)->reconf, TRUE);
+      g_atomic_int_set (&GST_VA_BASE_ENC (self)->update_rc, TRUE);
       break;
     case PROP_TARGET_USAGE:
       self->prop.target_usage = g_value_get_uint (value);
@@ -3347,6 +3450,7 @@ gst_va_h264_enc_set_property (GObject * object, guint prop_id,
 
 #ifndef GST_DISABLE_GST_DEBUG
   if (!g_atomic_int_get (&GST_VA_BASE_ENC (self)->reconf)
+      && !g_atomic_int_get (&GST_VA_BASE_ENC (self)->update_rc)
       && base->encoder && gst_va_encoder_is_open (base->encoder)) {
     GST_WARNING_OBJECT (self, "Property `%s` change ignored while processing.",
         pspec->name);
@@ -3502,6 +3606,8 @@ gst_va_h264_enc_class_init (gpointer g_klass, gpointer class_data)
 
   va_enc_class->reset_state = GST_DEBUG_FUNCPTR (gst_va_h264_enc_reset_state);
   va_enc_class->reconfig = GST_DEBUG_FUNCPTR (gst_va_h264_enc_reconfig);
+  va_enc_class->update_rate_control =
+      GST_DEBUG_FUNCPTR (gst_va_h264_enc_update_rate_control);
   va_enc_class->new_frame = GST_DEBUG_FUNCPTR (gst_va_h264_enc_new_frame);
   va_enc_class->reorder_frame =
       GST_DEBUG_FUNCPTR (gst_va_h264_enc_reorder_frame);
@@ -1176,6 +1176,72 @@ GST_START_TEST (test_parse_sliced_sps_pps_sps)
 
 GST_END_TEST;
 
+static GstBuffer *
+convert_to_avc (GstBuffer * buf)
+{
+  GstHarness *h = gst_harness_new ("h264parse");
+  GstBuffer *out;
+
+  gst_harness_set_caps_str (h,
+      "video/x-h264,stream-format=byte-stream,alignment=au,parsed=false,framerate=30/1",
+      "video/x-h264,stream-format=avc,alignment=au,parsed=true");
+
+  fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  out = gst_harness_pull (h);
+  gst_harness_teardown (h);
+
+  return out;
+}
+
+GST_START_TEST (test_parse_sliced_au_avc_memories)
+{
+  GstBuffer *buf;
+  gsize size;
+  guint8 len[4];
+
+  /* the input NALs are referenced, with their length prefix in front */
+  buf = composite_buffer (100, 0, 4,
+      h264_slicing_sps, sizeof (h264_slicing_sps),
+      h264_slicing_pps, sizeof (h264_slicing_pps),
+      h264_idr_slice_1, sizeof (h264_idr_slice_1),
+      h264_idr_slice_2, sizeof (h264_idr_slice_2));
+  size = gst_buffer_get_size (buf);
+
+  buf = convert_to_avc (buf);
+  fail_unless_equals_int (gst_buffer_get_size (buf), size);
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 8);
+  gst_buffer_extract (buf, 0, len, 4);
+  fail_unless_equals_int (GST_READ_UINT32_BE (len),
+      sizeof (h264_slicing_sps) - 4);
+  gst_buffer_unref (buf);
+
+  /* more memories than a buffer can hold, the AU is copied once */
+  buf = composite_buffer (100, 0, 10,
+      h264_slicing_sps, sizeof (h264_slicing_sps),
+      h264_slicing_pps, sizeof (h264_slicing_pps),
+      h264_idr_slice_1, sizeof (h264_idr_slice_1),
+      h264_idr_slice_2, sizeof (h264_idr_slice_2),
+      h264_idr_slice_2, sizeof (h264_idr_slice_2),
+      h264_idr_slice_2, sizeof (h264_idr_slice_2),
+      h264_idr_slice_2, sizeof (h264_idr_slice_2),
+      h264_idr_slice_2, sizeof (h264_idr_slice_2),
+      h264_idr_slice_2, sizeof (h264_idr_slice_2),
+      h264_idr_slice_2, sizeof (h264_idr_slice_2));
+  size = gst_buffer_get_size (buf);
+
+  buf = convert_to_avc (buf);
+  fail_unless_equals_int (gst_buffer_get_size (buf), size);
+  fail_unless_equals_int (gst_buffer_n_memory (buf), 1);
+  gst_buffer_extract (buf, 0, len, 4);
+  fail_unless_equals_int (GST_READ_UINT32_BE (len),
+      sizeof (h264_slicing_sps) - 4);
+  gst_buffer_unref (buf);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 h264parse_sliced_suite (void)
@@ -1188,6 +1254,7 @@ h264parse_sliced_suite (void)
   tcase_add_test (tc_chain, test_parse_sliced_au_nal);
   tcase_add_test (tc_chain, test_parse_sliced_nal_au);
   tcase_add_test (tc_chain, test_parse_sliced_sps_pps_sps);
+  tcase_add_test (tc_chain, test_parse_sliced_au_avc_memories);
 
   return s;
 }
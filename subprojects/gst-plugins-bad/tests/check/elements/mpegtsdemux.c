@@ -335,6 +335,37 @@ GST_START_TEST (test_tsparse_padding)
 
 GST_END_TEST;
 
+GST_START_TEST (test_tsparse_split_programs)
+{
+  GstHarness *h = gst_harness_new ("tsparse");
+  GstBuffer *buf;
+  GstPad *pad;
+
+  gst_harness_set (h, "tsparse", "split-programs", TRUE, NULL);
+
+  gst_harness_set_src_caps_str (h, "video/mpegts,systemstream=true");
+  gst_harness_set_sink_caps_str (h,
+      "video/mpegts,systemstream=true,packetsize=" G_STRINGIFY (PACKETSIZE));
+
+  fail_unless (gst_element_get_static_pad (h->element, "program_1") == NULL);
+
+  buf =
+      gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY, (guint8 *) aac_ts,
+      sizeof aac_ts, 0, sizeof aac_ts, NULL, NULL);
+  buf = gst_harness_push_and_pull (h, buf);
+  gst_check_buffer_data (buf, aac_ts, sizeof aac_ts);
+  gst_buffer_unref (buf);
+
+  /* the single program from the PAT got its own pad */
+  pad = gst_element_get_static_pad (h->element, "program_1");
+  fail_unless (pad != NULL);
+  gst_object_unref (pad);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static void
 tsdemux_simple_pad_added (GstElement * tsdemux, GstPad * pad, GstHarness * h)
 {
@@ -390,6 +421,7 @@ mpegtsdemux_suite (void)
   tcase_add_test (tc, test_tsparse_align_fuse);
   tcase_add_test (tc, test_tsparse_align_split);
   tcase_add_test (tc, test_tsparse_padding);
+  tcase_add_test (tc, test_tsparse_split_programs);
 
   tc = tcase_create ("tsdemux");
   suite_add_tcase (s, tc);
@@ -557,6 +557,55 @@ GST_START_TEST (test_align)
 
 GST_END_TEST;
 
+#define PACED_BITRATE 2000000
+
+static void
+test_paced_output_check_output (GList * bufs)
+{
+  GstClockTime duration, next_pts = GST_CLOCK_TIME_NONE;
+
+  duration = gst_util_uint64_scale (7 * 188 * 8, GST_SECOND, PACED_BITRATE);
+
+  GST_LOG ("%u buffers", g_list_length (bufs));
+  fail_unless (bufs != NULL);
+  while (bufs != NULL) {
+    GstBuffer *buf = bufs->data;
+
+    fail_unless_equals_int (gst_buffer_get_size (buf), 7 * 188);
+    fail_unless_equals_uint64 (GST_BUFFER_DURATION (buf), duration);
+    fail_unless (GST_BUFFER_PTS_IS_VALID (buf));
+    /* buffers follow each other at the bitrate, up to rounding */
+    if (GST_CLOCK_TIME_IS_VALID (next_pts))
+      fail_unless (ABS (GST_CLOCK_DIFF (next_pts, GST_BUFFER_PTS (buf))) <= 1,
+          "expected pts %" GST_TIME_FORMAT ", got %" GST_TIME_FORMAT,
+          GST_TIME_ARGS (next_pts), GST_TIME_ARGS (GST_BUFFER_PTS (buf)));
+    next_pts = GST_BUFFER_PTS (buf) + duration;
+    bufs = bufs->next;
+  }
+}
+
+GST_START_TEST (test_paced_output)
+{
+  gchar *padname;
+  GstElement *mux;
+
+  mux = setup_tsmux (&video_src_template, "sink_%d", &padname);
+  g_object_set (mux, "alignment", 7, "bitrate", (guint64) PACED_BITRATE,
+      "paced-output", TRUE, NULL);
+
+  fail_unless (gst_element_set_state (mux,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  check_tsmux_pad_given_muxer (mux, VIDEO_CAPS_STRING, 0xE0, 0x1b,
+      test_paced_output_check_output, 25, 1000);
+
+  cleanup_tsmux (mux, padname);
+  g_free (padname);
+}
+
+GST_END_TEST;
+
 static void
 test_keyframe_propagation_check_output (GList * bufs)
 {
@@ -599,6 +648,7 @@ mpegtsmux_suite (void)
   tcase_add_test (tc_chain, test_multiple_state_change);
   tcase_add_test (tc_chain, test_align);
   tcase_add_test (tc_chain, test_keyframe_flag_propagation);
+  tcase_add_test (tc_chain, test_paced_output);
   tcase_add_test (tc_chain, test_reappearing_pad_while_playing);
   tcase_add_test (tc_chain, test_reappearing_pad_while_stopped);
   tcase_add_test (tc_chain, test_unused_pad);
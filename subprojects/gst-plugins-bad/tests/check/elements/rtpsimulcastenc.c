@@ -0,0 +1,146 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <gst/check/gstcheck.h>
+
+#define NUM_BUFFERS 5
+
+static GstPadProbeReturn
+count_buffers (GstPad * pad, GstPadProbeInfo * info, gint * count)
+{
+  g_atomic_int_inc (count);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+check_layer (GstElement * pipeline, const gchar * name, gint width,
+    gint height, gint * count)
+{
+  GstElement *sink = gst_bin_get_by_name (GST_BIN (pipeline), name);
+  GstPad *pad = gst_element_get_static_pad (sink, "sink");
+
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER,
+      (GstPadProbeCallback) count_buffers, count, NULL);
+  g_object_set_data (G_OBJECT (sink), "width", GINT_TO_POINTER (width));
+  g_object_set_data (G_OBJECT (sink), "height", GINT_TO_POINTER (height));
+
+  gst_object_unref (pad);
+  gst_object_unref (sink);
+}
+
+static void
+check_caps (GstElement * pipeline, const gchar * name)
+{
+  GstElement *sink = gst_bin_get_by_name (GST_BIN (pipeline), name);
+  GstPad *pad = gst_element_get_static_pad (sink, "sink");
+  GstCaps *caps = gst_pad_get_current_caps (pad);
+  GstStructure *s;
+  gint width, height;
+
+  fail_unless (caps != NULL);
+  s = gst_caps_get_structure (caps, 0);
+  fail_unless (gst_structure_get_int (s, "width", &width));
+  fail_unless (gst_structure_get_int (s, "height", &height));
+  fail_unless_equals_int (width,
+      GPOINTER_TO_INT (g_object_get_data (G_OBJECT (sink), "width")));
+  fail_unless_equals_int (height,
+      GPOINTER_TO_INT (g_object_get_data (G_OBJECT (sink), "height")));
+
+  gst_caps_unref (caps);
+  gst_object_unref (pad);
+  gst_object_unref (sink);
+}
+
+static void
+run_pipeline (const gchar * props, gint * counts)
+{
+  GstElement *pipeline;
+  GstMessage *msg;
+  gchar *desc;
+
+  desc = g_strdup_printf ("videotestsrc num-buffers=%d ! "
+      "video/x-raw,format=I420,width=320,height=240 ! "
+      "rtpsimulcastenc name=s rids=\"<f,h,q>\" %s "
+      "encoder=identity payloader=identity "
+      "s.src_0 ! fakesink name=f  s.src_1 ! fakesink name=h "
+      "s.src_2 ! fakesink name=q", NUM_BUFFERS, props);
+  pipeline = gst_parse_launch (desc, NULL);
+  g_free (desc);
+  fail_unless (pipeline != NULL);
+
+  check_layer (pipeline, "f", 320, 240, &counts[0]);
+  check_layer (pipeline, "h", 160, 120, &counts[1]);
+  check_layer (pipeline, "q", 80, 60, &counts[2]);
+
+  fail_unless (gst_element_set_state (pipeline, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipeline),
+      GST_CLOCK_TIME_NONE, GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  check_caps (pipeline, "f");
+  check_caps (pipeline, "h");
+  check_caps (pipeline, "q");
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+GST_START_TEST (test_layers)
+{
+  gint counts[3] = { 0, };
+
+  run_pipeline ("", counts);
+
+  fail_unless_equals_int (counts[0], NUM_BUFFERS);
+  fail_unless_equals_int (counts[1], NUM_BUFFERS);
+  fail_unless_equals_int (counts[2], NUM_BUFFERS);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_paused_layers)
+{
+  gint counts[3] = { 0, };
+
+  /* the half resolution is still scaled for the quarter resolution */
+  run_pipeline ("paused-rids=\"<h>\"", counts);
+
+  fail_unless_equals_int (counts[0], NUM_BUFFERS);
+  fail_unless_equals_int (counts[1], 0);
+  fail_unless_equals_int (counts[2], NUM_BUFFERS);
+}
+
+GST_END_TEST;
+
+static Suite *
+rtpsimulcastenc_suite (void)
+{
+  Suite *s = suite_create ("rtpsimulcastenc");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_layers);
+  tcase_add_test (tc_chain, test_paused_layers);
+
+  return s;
+}
+
+GST_CHECK_MAIN (rtpsimulcastenc);
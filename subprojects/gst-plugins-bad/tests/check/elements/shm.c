@@ -169,7 +169,8 @@ GST_START_TEST (test_shm_alloc)
 
 GST_END_TEST;
 
-GST_START_TEST (test_shm_live)
+static void
+run_shm_live (gboolean use_memfd)
 {
   GstElement *producer, *consumer;
   GstElement *src, *sink;
@@ -182,7 +183,7 @@ GST_START_TEST (test_shm_live)
 
   sink = gst_element_factory_make ("shmsink", NULL);
   g_object_set (sink, "socket-path", "shm-unit-test", "wait-for-connection",
-      FALSE, NULL);
+      FALSE, "use-memfd", use_memfd, NULL);
 
   producer = gst_pipeline_new ("producer-pipeline");
   gst_bin_add_many (GST_BIN (producer), src, sink, NULL);
@@ -227,8 +228,22 @@ GST_START_TEST (test_shm_live)
   g_free (socket_path);
 }
 
+GST_START_TEST (test_shm_live)
+{
+  run_shm_live (FALSE);
+}
+
 GST_END_TEST;
 
+#ifdef HAVE_MEMFD_CREATE
+GST_START_TEST (test_shm_live_memfd)
+{
+  run_shm_live (TRUE);
+}
+
+GST_END_TEST;
+#endif
+
 static Suite *
 shm_suite (void)
 {
@@ -243,6 +258,9 @@ shm_suite (void)
 
   tc = tcase_create ("shm2");
   tcase_add_test (tc, test_shm_live);
+#ifdef HAVE_MEMFD_CREATE
+  tcase_add_test (tc, test_shm_live_memfd);
+#endif
   suite_add_tcase (s, tc);
 
   return s;
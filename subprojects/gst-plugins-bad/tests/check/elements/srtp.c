@@ -30,6 +30,7 @@
 #include <gst/check/gstcheck.h>
 
 #include <gst/check/gstharness.h>
+#include <gst/rtp/gstrtpbuffer.h>
 
 GST_START_TEST (test_create_and_unref)
 {
@@ -249,6 +250,78 @@ GST_START_TEST (test_roc)
 
 GST_END_TEST;
 
+#define LIST_KEY "012345678901234567890123456789012345678901234567890123456789"
+#define LIST_RTP_CAPS "application/x-rtp, payload=(int)8, ssrc=(uint)1356955624"
+#define LIST_SRTP_CAPS "application/x-srtp, payload=(int)8, " \
+    "ssrc=(uint)1356955624, srtp-key=(buffer)" LIST_KEY ", " \
+    "srtp-cipher=(string)aes-128-icm, srtp-auth=(string)hmac-sha1-80, " \
+    "srtcp-cipher=(string)aes-128-icm, srtcp-auth=(string)hmac-sha1-80"
+
+GST_START_TEST (test_buffer_list)
+{
+  GstHarness *enc, *dec;
+  GstBufferList *list;
+  GstBuffer *buf, *in[10];
+  guint i;
+
+  enc = gst_harness_new_with_padnames ("srtpenc", "rtp_sink_0", "rtp_src_0");
+  gst_util_set_object_arg (G_OBJECT (enc->element), "key", LIST_KEY);
+  gst_harness_set_src_caps_str (enc, LIST_RTP_CAPS);
+
+  dec = gst_harness_new_with_padnames ("srtpdec", "rtp_sink", "rtp_src");
+  gst_harness_set_src_caps_str (dec, LIST_SRTP_CAPS);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < G_N_ELEMENTS (in); i++) {
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+
+    in[i] = gst_rtp_buffer_new_allocate (160, 0, 0);
+    gst_rtp_buffer_map (in[i], GST_MAP_WRITE, &rtp);
+    gst_rtp_buffer_set_payload_type (&rtp, 8);
+    gst_rtp_buffer_set_ssrc (&rtp, 1356955624);
+    gst_rtp_buffer_set_seq (&rtp, 1000 + i);
+    gst_rtp_buffer_set_timestamp (&rtp, i * 160);
+    memset (gst_rtp_buffer_get_payload (&rtp), i, 160);
+    gst_rtp_buffer_unmap (&rtp);
+
+    gst_buffer_list_add (list, gst_buffer_ref (in[i]));
+  }
+
+  /* the whole list is protected at once */
+  fail_unless_equals_int (gst_pad_push_list (enc->srcpad, list), GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (enc),
+      G_N_ELEMENTS (in));
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < G_N_ELEMENTS (in); i++) {
+    buf = gst_harness_pull (enc);
+    fail_unless (gst_buffer_get_size (buf) > gst_buffer_get_size (in[i]));
+    gst_buffer_list_add (list, buf);
+  }
+
+  /* and unprotected as a list again */
+  fail_unless_equals_int (gst_pad_push_list (dec->srcpad, list), GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (dec),
+      G_N_ELEMENTS (in));
+
+  for (i = 0; i < G_N_ELEMENTS (in); i++) {
+    GstMapInfo map;
+
+    buf = gst_harness_pull (dec);
+    gst_buffer_map (in[i], &map, GST_MAP_READ);
+    fail_unless_equals_int (gst_buffer_get_size (buf), map.size);
+    fail_unless (gst_buffer_memcmp (buf, 0, map.data, map.size) == 0);
+    gst_buffer_unmap (in[i], &map);
+    gst_buffer_unref (buf);
+    gst_buffer_unref (in[i]);
+  }
+
+  gst_harness_teardown (enc);
+  gst_harness_teardown (dec);
+}
+
+GST_END_TEST;
+
 #ifdef HAVE_SRTP2
 
 GST_START_TEST (test_simple_mki)
@@ -395,6 +468,7 @@ srtp_suite (void)
   tcase_add_test (tc_chain, test_play);
   tcase_add_test (tc_chain, test_roc);
   tcase_add_test (tc_chain, test_play_key_error);
+  tcase_add_test (tc_chain, test_buffer_list);
 #ifdef HAVE_SRTP2
   tcase_add_test (tc_chain, test_simple_mki);
   tcase_add_test (tc_chain, test_srtpdec_multiple_mki);
@@ -1766,6 +1766,45 @@ GST_START_TEST (test_session_stats)
 
 GST_END_TEST;
 
+GST_START_TEST (test_stats_cache)
+{
+  struct test_webrtc *t = test_webrtc_new ();
+  GstStructure *first;
+  GstPromise *p;
+
+  t->on_negotiation_needed = NULL;
+  test_validate_sdp (t, NULL, NULL);
+
+  g_object_set (t->webrtc1, "stats-cache-time", 60 * GST_SECOND, NULL);
+
+  p = gst_promise_new ();
+  g_signal_emit_by_name (t->webrtc1, "get-stats", NULL, p);
+  fail_unless_equals_int (gst_promise_wait (p), GST_PROMISE_RESULT_REPLIED);
+  first = gst_structure_copy (gst_promise_get_reply (p));
+  validate_stats (first);
+  gst_promise_unref (p);
+
+  /* the cached stats are replied to immediately */
+  p = gst_promise_new ();
+  g_signal_emit_by_name (t->webrtc1, "get-stats", NULL, p);
+  fail_unless_equals_int (gst_promise_wait (p), GST_PROMISE_RESULT_REPLIED);
+  fail_unless (gst_structure_is_equal (first, gst_promise_get_reply (p)));
+  gst_promise_unref (p);
+
+  /* disabling the cache collects them again */
+  g_object_set (t->webrtc1, "stats-cache-time", G_GUINT64_CONSTANT (0), NULL);
+  p = gst_promise_new ();
+  g_signal_emit_by_name (t->webrtc1, "get-stats", NULL, p);
+  fail_unless_equals_int (gst_promise_wait (p), GST_PROMISE_RESULT_REPLIED);
+  validate_stats (gst_promise_get_reply (p));
+  gst_promise_unref (p);
+
+  gst_structure_free (first);
+  test_webrtc_free (t);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_stats_with_stream)
 {
   struct test_webrtc *t = create_audio_test ();
@@ -2258,6 +2297,88 @@ GST_START_TEST (test_data_channel_transfer_data)
 
 GST_END_TEST;
 
+#define N_LIST_MESSAGES 3
+
+static void
+on_message_buffer (GstWebRTCDataChannel * channel, GstBuffer * buffer,
+    struct test_webrtc *t)
+{
+  guint n = GPOINTER_TO_UINT (g_object_get_data (G_OBJECT (channel),
+          "n-received"));
+
+  fail_unless_equals_int (gst_buffer_get_size (buffer), strlen (test_string));
+  fail_unless (gst_buffer_memcmp (buffer, 0, test_string,
+          strlen (test_string)) == 0);
+
+  g_object_set_data (G_OBJECT (channel), "n-received",
+      GUINT_TO_POINTER (++n));
+  if (n == N_LIST_MESSAGES)
+    test_webrtc_signal_state (t, STATE_CUSTOM);
+}
+
+static void
+have_data_channel_transfer_buffer_list (struct test_webrtc *t,
+    GstElement * element, GObject * our, gpointer user_data)
+{
+  GObject *other = user_data;
+  GstBufferList *list;
+  GError *error = NULL;
+  guint i;
+
+  gst_webrtc_data_channel_set_message_buffer_func (GST_WEBRTC_DATA_CHANNEL
+      (our), (GstWebRTCDataChannelMessageBufferFunc) on_message_buffer, t,
+      NULL);
+
+  list = gst_buffer_list_new ();
+  for (i = 0; i < N_LIST_MESSAGES; i++)
+    gst_buffer_list_add (list,
+        gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY,
+            (gpointer) test_string, strlen (test_string), 0,
+            strlen (test_string), NULL, NULL));
+
+  fail_unless (gst_webrtc_data_channel_send_buffer_list
+      (GST_WEBRTC_DATA_CHANNEL (other), list, &error));
+  g_assert_null (error);
+  gst_buffer_list_unref (list);
+}
+
+GST_START_TEST (test_data_channel_transfer_buffer_list)
+{
+  struct test_webrtc *t = test_webrtc_new ();
+  GObject *channel = NULL;
+  VAL_SDP_INIT (media_count, _count_num_sdp_media, GUINT_TO_POINTER (1), NULL);
+  VAL_SDP_INIT (offer, on_sdp_has_datachannel, NULL, &media_count);
+
+  t->on_negotiation_needed = NULL;
+  t->on_ice_candidate = NULL;
+  t->on_prepare_data_channel = have_prepare_data_channel;
+  t->on_data_channel = have_data_channel_transfer_buffer_list;
+
+  fail_if (gst_element_set_state (t->webrtc1,
+          GST_STATE_READY) == GST_STATE_CHANGE_FAILURE);
+  fail_if (gst_element_set_state (t->webrtc2,
+          GST_STATE_READY) == GST_STATE_CHANGE_FAILURE);
+
+  g_signal_emit_by_name (t->webrtc1, "create-data-channel", "label", NULL,
+      &channel);
+  g_assert_nonnull (channel);
+  t->data_channel_data = channel;
+  g_signal_connect (channel, "on-error",
+      G_CALLBACK (on_channel_error_not_reached), NULL);
+
+  fail_if (gst_element_set_state (t->webrtc1,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+  fail_if (gst_element_set_state (t->webrtc2,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+
+  test_validate_sdp_full (t, &offer, &offer, 1 << STATE_CUSTOM, FALSE);
+
+  g_object_unref (channel);
+  test_webrtc_free (t);
+}
+
+GST_END_TEST;
+
 static void
 have_data_channel_create_data_channel (struct test_webrtc *t,
     GstElement * element, GObject * our, gpointer user_data)
@@ -5708,6 +5829,40 @@ GST_START_TEST (test_msid)
 
 GST_END_TEST;
 
+GST_START_TEST (test_forward_mode_ssrc)
+{
+  GstElement *webrtc;
+  GstHarness *h;
+  GstPad *pad;
+  GstCaps *caps;
+  guint ssrc = 0;
+
+  webrtc = gst_element_factory_make ("webrtcbin", NULL);
+  g_object_set (webrtc, "forward-mode", TRUE, NULL);
+  h = gst_harness_new_with_element (webrtc, "sink_0", NULL);
+
+  gst_harness_set_src_caps_str (h, OPUS_RTP_CAPS (96));
+
+  /* switching the forwarded stream keeps the SSRC of the first one */
+  gst_harness_set_src_caps_str (h,
+      "application/x-rtp,payload=96,encoding-name=OPUS,media=audio,"
+      "clock-rate=48000,ssrc=(uint)1234");
+
+  pad = gst_element_get_static_pad (webrtc, "sink_0");
+  caps = gst_pad_get_current_caps (pad);
+  fail_unless (caps != NULL);
+  fail_unless (gst_structure_get_uint (gst_caps_get_structure (caps, 0),
+          "ssrc", &ssrc));
+  fail_unless_equals_int64 (ssrc, 3384078950u);
+  gst_caps_unref (caps);
+  gst_object_unref (pad);
+
+  gst_harness_teardown (h);
+  gst_object_unref (webrtc);
+}
+
+GST_END_TEST;
+
 static Suite *
 webrtcbin_suite (void)
 {
@@ -5730,6 +5885,7 @@ webrtcbin_suite (void)
   if (nicesrc && nicesink && dtlssrtpenc && dtlssrtpdec) {
     tcase_add_test (tc, test_sdp_no_media);
     tcase_add_test (tc, test_session_stats);
+    tcase_add_test (tc, test_stats_cache);
     tcase_add_test (tc, test_stats_with_stream);
     tcase_add_test (tc, test_audio);
     tcase_add_test (tc, test_ice_port_restriction);
@@ -5773,11 +5929,13 @@ webrtcbin_suite (void)
     tcase_add_test (tc, test_invalid_add_media_in_answer);
     tcase_add_test (tc, test_add_turn_server);
     tcase_add_test (tc, test_msid);
+    tcase_add_test (tc, test_forward_mode_ssrc);
     if (sctpenc && sctpdec) {
       tcase_add_test (tc, test_data_channel_create);
       tcase_add_test (tc, test_data_channel_remote_notify);
       tcase_add_test (tc, test_data_channel_transfer_string);
       tcase_add_test (tc, test_data_channel_transfer_data);
+      tcase_add_test (tc, test_data_channel_transfer_buffer_list);
       tcase_add_test (tc, test_data_channel_create_after_negotiate);
       tcase_add_test (tc, test_data_channel_close);
       tcase_add_test (tc, test_data_channel_low_threshold);
@@ -406,6 +406,43 @@ GST_START_TEST (test_h264_parse_invalid_sei)
 
 GST_END_TEST;
 
+GST_START_TEST (test_h264_parse_sei_into)
+{
+  GstH264ParserResult res;
+  GstH264NalUnit nalu;
+  GstH264NalParser *const parser = gst_h264_nal_parser_new ();
+  GArray *seis = g_array_new (FALSE, FALSE, sizeof (GstH264SEIMessage));
+  GstH264SEIMessage *sei;
+
+  res = gst_h264_parser_identify_nalu (parser, nalu_sps_with_vui, 0,
+      sizeof (nalu_sps_with_vui), &nalu);
+  assert_equals_int (res, GST_H264_PARSER_NO_NAL_END);
+  res = gst_h264_parser_parse_nal (parser, &nalu);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+
+  res = gst_h264_parser_identify_nalu (parser, nalu_chained_sei, 0,
+      sizeof (nalu_chained_sei), &nalu);
+  assert_equals_int (res, GST_H264_PARSER_NO_NAL_END);
+  res = gst_h264_parser_parse_sei_into (parser, &nalu, seis);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+  assert_equals_int (seis->len, 2);
+
+  /* the previous messages are replaced when the array is reused */
+  res = gst_h264_parser_identify_nalu (parser, nalu_sei_pic_timing, 0,
+      sizeof (nalu_sei_pic_timing), &nalu);
+  assert_equals_int (res, GST_H264_PARSER_NO_NAL_END);
+  res = gst_h264_parser_parse_sei_into (parser, &nalu, seis);
+  assert_equals_int (res, GST_H264_PARSER_OK);
+  assert_equals_int (seis->len, 1);
+  sei = &g_array_index (seis, GstH264SEIMessage, 0);
+  assert_equals_int (sei->payloadType, GST_H264_SEI_PIC_TIMING);
+
+  g_array_unref (seis);
+  gst_h264_nal_parser_free (parser);
+}
+
+GST_END_TEST;
+
 typedef gboolean (*SEICheckFunc) (gconstpointer a, gconstpointer b);
 
 static gboolean
@@ -838,6 +875,7 @@ h264parser_suite (void)
   tcase_add_test (tc_chain, test_h264_parse_slice_5bytes);
   tcase_add_test (tc_chain, test_h264_parse_identify_nalu_avc);
   tcase_add_test (tc_chain, test_h264_parse_invalid_sei);
+  tcase_add_test (tc_chain, test_h264_parse_sei_into);
   tcase_add_test (tc_chain, test_h264_create_sei);
   tcase_add_test (tc_chain, test_h264_decoder_config_record);
 
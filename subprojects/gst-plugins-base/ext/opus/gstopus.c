@@ -30,6 +30,7 @@ plugin_init (GstPlugin * plugin)
 
   ret |= GST_ELEMENT_REGISTER (opusenc, plugin);
   ret |= GST_ELEMENT_REGISTER (opusdec, plugin);
+  ret |= GST_ELEMENT_REGISTER (opusbatchenc, plugin);
 
   return ret;
 }
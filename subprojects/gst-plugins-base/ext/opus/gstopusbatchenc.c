@@ -0,0 +1,778 @@
+/* GStreamer Opus batch encoder
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-opusbatchenc
+ * @title: opusbatchenc
+ * @see_also: opusenc
+ *
+ * This element encodes many independent mono or stereo streams to Opus on a
+ * single thread. Every requested sink_\%u pad gets its own Opus encoder and a
+ * src_\%u pad with the same number carrying the encoded stream, with the
+ * timestamps of its input.
+ *
+ * All frames that are ready on any pad are encoded in one go from the
+ * streaming thread of the element, which avoids the thread per stream and
+ * the per-buffer overhead of many opusenc elements, e.g. when transcoding
+ * thousands of streams on a conference server. In live pipelines a stream
+ * that stops sending data does not hold back the others for longer than
+ * the latency.
+ *
+ * The always src pad of the element does not carry any data, it only exists
+ * because the element is a #GstAggregator and does not need to be linked.
+ *
+ * ## Example pipeline
+ * |[
+ * gst-launch-1.0 opusbatchenc name=enc \
+ *     audiotestsrc is-live=true ! enc.sink_0  enc.src_0 ! oggmux ! filesink location=a.ogg \
+ *     audiotestsrc is-live=true wave=pink-noise ! enc.sink_1  enc.src_1 ! oggmux ! filesink location=b.ogg
+ * ]|
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include <gst/pbutils/pbutils.h>
+#include <gst/tag/tag.h>
+
+#include "gstopuselements.h"
+#include "gstopusenc.h"
+#include "gstopusbatchenc.h"
+
+GST_DEBUG_CATEGORY_STATIC (opusbatchenc_debug);
+#define GST_CAT_DEFAULT opusbatchenc_debug
+
+#define LOWEST_BITRATE 4000
+#define HIGHEST_BITRATE 650000
+
+#define DEFAULT_AUDIO_TYPE      OPUS_APPLICATION_AUDIO
+#define DEFAULT_BITRATE         64000
+#define DEFAULT_FRAMESIZE       20
+#define DEFAULT_COMPLEXITY      10
+
+/* the recommended output buffer size of opus_encode() */
+#define MAX_PACKET_SIZE 4000
+
+enum
+{
+  PROP_0,
+  PROP_AUDIO_TYPE,
+  PROP_BITRATE,
+  PROP_FRAME_SIZE,
+  PROP_COMPLEXITY,
+};
+
+#define FORMAT_STR GST_AUDIO_NE(S16)
+static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE ("sink_%u",
+    GST_PAD_SINK,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS ("audio/x-raw, "
+        "format = (string) " FORMAT_STR ", "
+        "layout = (string) interleaved, "
+        "rate = (int) { 8000, 12000, 16000, 24000, 48000 }, "
+        "channels = (int) [ 1, 2 ]")
+    );
+
+static GstStaticPadTemplate stream_src_factory =
+GST_STATIC_PAD_TEMPLATE ("src_%u",
+    GST_PAD_SRC,
+    GST_PAD_SOMETIMES,
+    GST_STATIC_CAPS ("audio/x-opus")
+    );
+
+static GstStaticPadTemplate src_factory = GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("audio/x-opus")
+    );
+
+G_DEFINE_TYPE (GstOpusBatchEncPad, gst_opus_batch_enc_pad,
+    GST_TYPE_AGGREGATOR_PAD);
+
+static void
+gst_opus_batch_enc_pad_finalize (GObject * object)
+{
+  GstOpusBatchEncPad *pad = GST_OPUS_BATCH_ENC_PAD (object);
+
+  if (pad->state)
+    opus_encoder_destroy (pad->state);
+  g_object_unref (pad->adapter);
+  gst_clear_object (&pad->srcpad);
+
+  G_OBJECT_CLASS (gst_opus_batch_enc_pad_parent_class)->finalize (object);
+}
+
+static GstFlowReturn
+gst_opus_batch_enc_pad_flush (GstAggregatorPad * aggpad, GstAggregator * agg)
+{
+  GstOpusBatchEncPad *pad = GST_OPUS_BATCH_ENC_PAD (aggpad);
+
+  gst_adapter_clear (pad->adapter);
+  if (pad->state)
+    opus_encoder_ctl (pad->state, OPUS_RESET_STATE);
+  pad->base_ts = GST_CLOCK_TIME_NONE;
+  pad->encoded_samples = 0;
+  pad->discont = TRUE;
+  pad->eos_pushed = FALSE;
+
+  return GST_FLOW_OK;
+}
+
+static void
+gst_opus_batch_enc_pad_class_init (GstOpusBatchEncPadClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstAggregatorPadClass *aggpad_class = GST_AGGREGATOR_PAD_CLASS (klass);
+
+  gobject_class->finalize = gst_opus_batch_enc_pad_finalize;
+  aggpad_class->flush = GST_DEBUG_FUNCPTR (gst_opus_batch_enc_pad_flush);
+}
+
+static void
+gst_opus_batch_enc_pad_init (GstOpusBatchEncPad * pad)
+{
+  gst_audio_info_init (&pad->info);
+  pad->adapter = gst_adapter_new ();
+  pad->base_ts = GST_CLOCK_TIME_NONE;
+  pad->discont = TRUE;
+}
+
+#define gst_opus_batch_enc_parent_class parent_class
+G_DEFINE_TYPE (GstOpusBatchEnc, gst_opus_batch_enc, GST_TYPE_AGGREGATOR);
+GST_ELEMENT_REGISTER_DEFINE_WITH_CODE (opusbatchenc, "opusbatchenc",
+    GST_RANK_NONE, GST_TYPE_OPUS_BATCH_ENC, opus_element_init (plugin));
+
+static void
+gst_opus_batch_enc_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstOpusBatchEnc *self = GST_OPUS_BATCH_ENC (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_AUDIO_TYPE:
+      self->audio_type = g_value_get_enum (value);
+      break;
+    case PROP_BITRATE:
+      self->bitrate = g_value_get_int (value);
+      self->settings_changed = TRUE;
+      break;
+    case PROP_FRAME_SIZE:
+      self->frame_size = g_value_get_enum (value);
+      break;
+    case PROP_COMPLEXITY:
+      self->complexity = g_value_get_int (value);
+      self->settings_changed = TRUE;
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gst_opus_batch_enc_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstOpusBatchEnc *self = GST_OPUS_BATCH_ENC (object);
+
+  GST_OBJECT_LOCK (self);
+  switch (prop_id) {
+    case PROP_AUDIO_TYPE:
+      g_value_set_enum (value, self->audio_type);
+      break;
+    case PROP_BITRATE:
+      g_value_set_int (value, self->bitrate);
+      break;
+    case PROP_FRAME_SIZE:
+      g_value_set_enum (value, self->frame_size);
+      break;
+    case PROP_COMPLEXITY:
+      g_value_set_int (value, self->complexity);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
+static GstPad *
+gst_opus_batch_enc_get_srcpad (GstOpusBatchEnc * self, GstOpusBatchEncPad * pad)
+{
+  GstPad *srcpad;
+
+  GST_OBJECT_LOCK (self);
+  srcpad = pad->srcpad ? gst_object_ref (pad->srcpad) : NULL;
+  GST_OBJECT_UNLOCK (self);
+
+  return srcpad;
+}
+
+static GstFlowReturn
+gst_opus_batch_enc_push (GstOpusBatchEnc * self, GstOpusBatchEncPad * pad,
+    GstBuffer * buffer)
+{
+  GstPad *srcpad;
+  GstFlowReturn ret;
+
+  /* the pad is being released */
+  if (!(srcpad = gst_opus_batch_enc_get_srcpad (self, pad))) {
+    gst_buffer_unref (buffer);
+    return GST_FLOW_OK;
+  }
+
+  ret = gst_pad_push (srcpad, buffer);
+
+  GST_OBJECT_LOCK (self);
+  ret = gst_flow_combiner_update_pad_flow (self->flow_combiner, srcpad, ret);
+  GST_OBJECT_UNLOCK (self);
+
+  gst_object_unref (srcpad);
+
+  return ret;
+}
+
+static gboolean
+gst_opus_batch_enc_push_event (GstOpusBatchEnc * self,
+    GstOpusBatchEncPad * pad, GstEvent * event)
+{
+  GstPad *srcpad;
+  gboolean ret;
+
+  if (!(srcpad = gst_opus_batch_enc_get_srcpad (self, pad))) {
+    gst_event_unref (event);
+    return FALSE;
+  }
+
+  ret = gst_pad_push_event (srcpad, event);
+  gst_object_unref (srcpad);
+
+  return ret;
+}
+
+/* encode all complete frames of @pad, and with @drain also the last
+ * incomplete one padded with silence */
+static GstFlowReturn
+gst_opus_batch_enc_encode (GstOpusBatchEnc * self, GstOpusBatchEncPad * pad,
+    gboolean drain)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  gsize frame_bytes, available;
+  gint rate;
+
+  if (pad->state == NULL)
+    return GST_FLOW_OK;
+
+  rate = GST_AUDIO_INFO_RATE (&pad->info);
+  frame_bytes = pad->frame_samples * GST_AUDIO_INFO_BPF (&pad->info);
+
+  while (ret == GST_FLOW_OK) {
+    GstBuffer *outbuf;
+    GstMapInfo omap;
+    const guint8 *data;
+    guint8 *padded = NULL;
+    gint len;
+
+    available = gst_adapter_available (pad->adapter);
+    if (available == 0 || (available < frame_bytes && !drain))
+      break;
+
+    if (available >= frame_bytes) {
+      data = gst_adapter_map (pad->adapter, frame_bytes);
+    } else {
+      padded = g_malloc0 (frame_bytes);
+      gst_adapter_copy (pad->adapter, padded, 0, available);
+      data = padded;
+    }
+
+    outbuf = gst_buffer_new_allocate (NULL, MAX_PACKET_SIZE, NULL);
+    gst_buffer_map (outbuf, &omap, GST_MAP_WRITE);
+    len = opus_encode (pad->state, (const opus_int16 *) data,
+        pad->frame_samples, omap.data, omap.size);
+    gst_buffer_unmap (outbuf, &omap);
+
+    if (padded) {
+      g_free (padded);
+      gst_adapter_flush (pad->adapter, available);
+    } else {
+      gst_adapter_unmap (pad->adapter);
+      gst_adapter_flush (pad->adapter, frame_bytes);
+    }
+
+    if (len < 0) {
+      gst_buffer_unref (outbuf);
+      GST_ELEMENT_ERROR (self, STREAM, ENCODE, (NULL),
+          ("Encoding failed on pad %s: %d (%s)", GST_PAD_NAME (pad), len,
+              opus_strerror (len)));
+      return GST_FLOW_ERROR;
+    }
+
+    gst_buffer_set_size (outbuf, len);
+    GST_BUFFER_PTS (outbuf) = pad->base_ts +
+        gst_util_uint64_scale_int (pad->encoded_samples, GST_SECOND, rate);
+    pad->encoded_samples += pad->frame_samples;
+    GST_BUFFER_DURATION (outbuf) = pad->base_ts +
+        gst_util_uint64_scale_int (pad->encoded_samples, GST_SECOND, rate) -
+        GST_BUFFER_PTS (outbuf);
+    GST_BUFFER_OFFSET_END (outbuf) = pad->encoded_samples;
+    if (pad->discont) {
+      GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
+      pad->discont = FALSE;
+    }
+
+    GST_LOG_OBJECT (pad, "encoded %d bytes at %" GST_TIME_FORMAT, len,
+        GST_TIME_ARGS (GST_BUFFER_PTS (outbuf)));
+
+    ret = gst_opus_batch_enc_push (self, pad, outbuf);
+  }
+
+  return ret;
+}
+
+static void
+gst_opus_batch_enc_update_next_time (GstOpusBatchEnc * self,
+    GstAggregatorPad * aggpad, GstClockTime end)
+{
+  GstClockTime running_time;
+
+  if (!GST_CLOCK_TIME_IS_VALID (end))
+    return;
+
+  GST_OBJECT_LOCK (aggpad);
+  running_time = gst_segment_to_running_time (&aggpad->segment,
+      GST_FORMAT_TIME, end);
+  GST_OBJECT_UNLOCK (aggpad);
+
+  GST_OBJECT_LOCK (self);
+  if (GST_CLOCK_TIME_IS_VALID (running_time) &&
+      (!GST_CLOCK_TIME_IS_VALID (self->next_time)
+          || running_time > self->next_time))
+    self->next_time = running_time;
+  GST_OBJECT_UNLOCK (self);
+}
+
+static GstFlowReturn
+gst_opus_batch_enc_handle_buffer (GstOpusBatchEnc * self,
+    GstOpusBatchEncPad * pad, GstBuffer * buffer)
+{
+  GstAggregatorPad *aggpad = GST_AGGREGATOR_PAD (pad);
+  GstClockTime pts, end = GST_CLOCK_TIME_NONE;
+  GstFlowReturn ret = GST_FLOW_OK;
+
+  pts = GST_BUFFER_PTS (buffer);
+
+  /* the buffers the base class creates for gap events, the event itself
+   * was already forwarded */
+  if (gst_buffer_get_size (buffer) == 0) {
+    if (GST_CLOCK_TIME_IS_VALID (pts)
+        && GST_BUFFER_DURATION_IS_VALID (buffer))
+      end = pts + GST_BUFFER_DURATION (buffer);
+    gst_opus_batch_enc_update_next_time (self, aggpad, end);
+    gst_buffer_unref (buffer);
+    return GST_FLOW_OK;
+  }
+
+  if (pad->state == NULL) {
+    gst_buffer_unref (buffer);
+    GST_ELEMENT_ERROR (self, CORE, NEGOTIATION, (NULL),
+        ("No caps on pad %s before buffer", GST_PAD_NAME (pad)));
+    return GST_FLOW_NOT_NEGOTIATED;
+  }
+
+  /* restart the timestamps of the stream after a discontinuity */
+  if (GST_BUFFER_IS_DISCONT (buffer) && GST_CLOCK_TIME_IS_VALID (pad->base_ts)) {
+    ret = gst_opus_batch_enc_encode (self, pad, TRUE);
+    pad->base_ts = GST_CLOCK_TIME_NONE;
+    pad->discont = TRUE;
+  }
+
+  if (!GST_CLOCK_TIME_IS_VALID (pad->base_ts)) {
+    pad->base_ts = GST_CLOCK_TIME_IS_VALID (pts) ? pts : 0;
+    pad->encoded_samples = 0;
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (pts))
+    end = pts + gst_util_uint64_scale_int (gst_buffer_get_size (buffer) /
+        GST_AUDIO_INFO_BPF (&pad->info), GST_SECOND,
+        GST_AUDIO_INFO_RATE (&pad->info));
+
+  gst_adapter_push (pad->adapter, buffer);
+
+  if (ret == GST_FLOW_OK)
+    ret = gst_opus_batch_enc_encode (self, pad, FALSE);
+
+  gst_opus_batch_enc_update_next_time (self, aggpad, end);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_opus_batch_enc_aggregate (GstAggregator * agg, gboolean timeout)
+{
+  GstOpusBatchEnc *self = GST_OPUS_BATCH_ENC (agg);
+  GstFlowReturn ret = GST_FLOW_OK;
+  gboolean all_eos = TRUE, settings_changed;
+  gint bitrate, complexity, frame_size;
+  GList *pads, *l;
+
+  GST_OBJECT_LOCK (self);
+  settings_changed = self->settings_changed;
+  self->settings_changed = FALSE;
+  bitrate = self->bitrate;
+  complexity = self->complexity;
+  frame_size = self->frame_size;
+  pads = g_list_copy_deep (GST_ELEMENT_CAST (self)->sinkpads,
+      (GCopyFunc) gst_object_ref, NULL);
+  GST_OBJECT_UNLOCK (self);
+
+  for (l = pads; l; l = l->next) {
+    GstOpusBatchEncPad *pad = l->data;
+    GstAggregatorPad *aggpad = l->data;
+    GstBuffer *buffer;
+
+    if (settings_changed && pad->state) {
+      opus_encoder_ctl (pad->state, OPUS_SET_BITRATE (bitrate));
+      opus_encoder_ctl (pad->state, OPUS_SET_COMPLEXITY (complexity));
+    }
+
+    while (ret == GST_FLOW_OK
+        && (buffer = gst_aggregator_pad_pop_buffer (aggpad)))
+      ret = gst_opus_batch_enc_handle_buffer (self, pad, buffer);
+
+    if (!gst_aggregator_pad_is_eos (aggpad))
+      all_eos = FALSE;
+
+    if (ret != GST_FLOW_OK)
+      break;
+  }
+
+  g_list_free_full (pads, gst_object_unref);
+
+  /* the streams that had no data are behind, don't wait for them again
+   * before one more frame is due */
+  if (timeout) {
+    GST_OBJECT_LOCK (self);
+    if (GST_CLOCK_TIME_IS_VALID (self->next_time))
+      self->next_time += frame_size == 2 ? GST_MSECOND * 5 / 2 :
+          frame_size * GST_MSECOND;
+    GST_OBJECT_UNLOCK (self);
+  }
+
+  if (ret == GST_FLOW_OK && all_eos)
+    ret = GST_FLOW_EOS;
+
+  return ret;
+}
+
+static gboolean
+gst_opus_batch_enc_pad_setup (GstOpusBatchEnc * self, GstOpusBatchEncPad * pad,
+    GstCaps * caps)
+{
+  GstAudioInfo info;
+  gint audio_type, bitrate, complexity, frame_size, error = OPUS_OK, rate;
+  opus_int32 lookahead;
+  GstBuffer *header, *comments;
+  GstTagList *tags;
+  GstCaps *outcaps;
+
+  if (!gst_audio_info_from_caps (&info, caps))
+    return FALSE;
+
+  if (pad->state) {
+    gst_opus_batch_enc_encode (self, pad, TRUE);
+    opus_encoder_destroy (pad->state);
+    pad->state = NULL;
+  }
+
+  GST_OBJECT_LOCK (self);
+  audio_type = self->audio_type;
+  bitrate = self->bitrate;
+  complexity = self->complexity;
+  frame_size = self->frame_size;
+  GST_OBJECT_UNLOCK (self);
+
+  rate = GST_AUDIO_INFO_RATE (&info);
+  pad->state = opus_encoder_create (rate, GST_AUDIO_INFO_CHANNELS (&info),
+      audio_type, &error);
+  if (!pad->state || error != OPUS_OK) {
+    GST_ERROR_OBJECT (pad, "Encoder creation failed: %s",
+        opus_strerror (error));
+    pad->state = NULL;
+    return FALSE;
+  }
+
+  opus_encoder_ctl (pad->state, OPUS_SET_BITRATE (bitrate));
+  opus_encoder_ctl (pad->state, OPUS_SET_COMPLEXITY (complexity));
+  opus_encoder_ctl (pad->state, OPUS_GET_LOOKAHEAD (&lookahead));
+
+  pad->info = info;
+  pad->frame_samples = frame_size == 2 ? rate / 400 : rate * frame_size / 1000;
+  pad->base_ts = GST_CLOCK_TIME_NONE;
+  pad->encoded_samples = 0;
+  gst_adapter_clear (pad->adapter);
+
+  GST_DEBUG_OBJECT (pad, "%d Hz, %d channels, %d samples per frame, "
+      "lookahead %d", rate, GST_AUDIO_INFO_CHANNELS (&info), pad->frame_samples,
+      lookahead);
+
+  /* the Opus header wants the lookahead in 48kHz samples */
+  header = gst_codec_utils_opus_create_header (rate,
+      GST_AUDIO_INFO_CHANNELS (&info), 0, 1,
+      GST_AUDIO_INFO_CHANNELS (&info) - 1, NULL, lookahead * 48000 / rate, 0);
+  tags = gst_tag_list_new_empty ();
+  comments = gst_tag_list_to_vorbiscomment_buffer (tags,
+      (const guint8 *) "OpusTags", 8, "Encoded with GStreamer opusbatchenc");
+  outcaps = gst_codec_utils_opus_create_caps_from_header (header, comments);
+  gst_tag_list_unref (tags);
+  gst_buffer_unref (header);
+  gst_buffer_unref (comments);
+
+  return gst_opus_batch_enc_push_event (self, pad,
+      gst_event_new_caps (outcaps));
+}
+
+static gboolean
+gst_opus_batch_enc_sink_event (GstAggregator * agg, GstAggregatorPad * aggpad,
+    GstEvent * event)
+{
+  GstOpusBatchEnc *self = GST_OPUS_BATCH_ENC (agg);
+  GstOpusBatchEncPad *pad = GST_OPUS_BATCH_ENC_PAD (aggpad);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_CAPS:{
+      GstCaps *caps;
+
+      gst_event_parse_caps (event, &caps);
+      if (!gst_opus_batch_enc_pad_setup (self, pad, caps)) {
+        gst_event_unref (event);
+        return FALSE;
+      }
+      break;
+    }
+    case GST_EVENT_SEGMENT:
+      /* a new segment starts a new timeline */
+      gst_opus_batch_enc_encode (self, pad, TRUE);
+      pad->base_ts = GST_CLOCK_TIME_NONE;
+      gst_opus_batch_enc_push_event (self, pad, gst_event_ref (event));
+      break;
+    case GST_EVENT_EOS:
+      if (!pad->eos_pushed) {
+        gst_opus_batch_enc_encode (self, pad, TRUE);
+        gst_opus_batch_enc_push_event (self, pad, gst_event_ref (event));
+        pad->eos_pushed = TRUE;
+      }
+      break;
+    case GST_EVENT_GAP:
+      gst_opus_batch_enc_encode (self, pad, TRUE);
+      pad->base_ts = GST_CLOCK_TIME_NONE;
+      pad->discont = TRUE;
+      gst_opus_batch_enc_push_event (self, pad, gst_event_ref (event));
+      break;
+    case GST_EVENT_STREAM_START:
+    case GST_EVENT_TAG:
+    case GST_EVENT_FLUSH_START:
+    case GST_EVENT_FLUSH_STOP:
+      gst_opus_batch_enc_push_event (self, pad, gst_event_ref (event));
+      break;
+    default:
+      break;
+  }
+
+  return GST_AGGREGATOR_CLASS (parent_class)->sink_event (agg, aggpad, event);
+}
+
+static GstClockTime
+gst_opus_batch_enc_get_next_time (GstAggregator * agg)
+{
+  GstOpusBatchEnc *self = GST_OPUS_BATCH_ENC (agg);
+  GstClockTime next_time;
+
+  GST_OBJECT_LOCK (self);
+  next_time = self->next_time;
+  GST_OBJECT_UNLOCK (self);
+
+  return next_time;
+}
+
+static gboolean
+gst_opus_batch_enc_negotiate (GstAggregator * agg)
+{
+  /* every stream has its own caps on its src pad */
+  return TRUE;
+}
+
+static gboolean
+gst_opus_batch_enc_start (GstAggregator * agg)
+{
+  GstOpusBatchEnc *self = GST_OPUS_BATCH_ENC (agg);
+
+  GstClockTime frame_duration;
+
+  GST_OBJECT_LOCK (self);
+  self->next_time = GST_CLOCK_TIME_NONE;
+  gst_flow_combiner_reset (self->flow_combiner);
+  frame_duration = self->frame_size == 2 ? GST_MSECOND * 5 / 2 :
+      self->frame_size * GST_MSECOND;
+  GST_OBJECT_UNLOCK (self);
+
+  /* a frame is only encoded once it is complete */
+  gst_aggregator_set_latency (agg, frame_duration, frame_duration);
+
+  return TRUE;
+}
+
+static GstPad *
+gst_opus_batch_enc_request_new_pad (GstElement * element,
+    GstPadTemplate * templ, const gchar * req_name, const GstCaps * caps)
+{
+  GstOpusBatchEnc *self = GST_OPUS_BATCH_ENC (element);
+  GstOpusBatchEncPad *pad;
+  GstPad *srcpad;
+  gchar *name;
+
+  pad = (GstOpusBatchEncPad *)
+      GST_ELEMENT_CLASS (parent_class)->request_new_pad (element, templ,
+      req_name, caps);
+  if (pad == NULL)
+    return NULL;
+
+  name = g_strdup_printf ("src_%s", GST_PAD_NAME (pad) + strlen ("sink_"));
+  srcpad = gst_pad_new_from_static_template (&stream_src_factory, name);
+  g_free (name);
+  gst_pad_use_fixed_caps (srcpad);
+
+  GST_OBJECT_LOCK (self);
+  pad->srcpad = gst_object_ref (srcpad);
+  gst_flow_combiner_add_pad (self->flow_combiner, srcpad);
+  GST_OBJECT_UNLOCK (self);
+
+  gst_element_add_pad (element, srcpad);
+
+  return GST_PAD_CAST (pad);
+}
+
+static void
+gst_opus_batch_enc_release_pad (GstElement * element, GstPad * pad)
+{
+  GstOpusBatchEnc *self = GST_OPUS_BATCH_ENC (element);
+  GstOpusBatchEncPad *encpad = GST_OPUS_BATCH_ENC_PAD (pad);
+  GstPad *srcpad;
+
+  GST_OBJECT_LOCK (self);
+  srcpad = encpad->srcpad;
+  encpad->srcpad = NULL;
+  if (srcpad)
+    gst_flow_combiner_remove_pad (self->flow_combiner, srcpad);
+  GST_OBJECT_UNLOCK (self);
+
+  if (srcpad) {
+    gst_pad_set_active (srcpad, FALSE);
+    gst_element_remove_pad (element, srcpad);
+    gst_object_unref (srcpad);
+  }
+
+  GST_ELEMENT_CLASS (parent_class)->release_pad (element, pad);
+}
+
+static void
+gst_opus_batch_enc_finalize (GObject * object)
+{
+  GstOpusBatchEnc *self = GST_OPUS_BATCH_ENC (object);
+
+  gst_flow_combiner_free (self->flow_combiner);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_opus_batch_enc_class_init (GstOpusBatchEncClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstAggregatorClass *agg_class = GST_AGGREGATOR_CLASS (klass);
+
+  gobject_class->set_property = gst_opus_batch_enc_set_property;
+  gobject_class->get_property = gst_opus_batch_enc_get_property;
+  gobject_class->finalize = gst_opus_batch_enc_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_AUDIO_TYPE,
+      g_param_spec_enum ("audio-type", "What type of audio to optimize for",
+          "What type of audio to optimize for, applies to streams configured "
+          "afterwards", gst_opus_enc_audio_type_get_type (),
+          DEFAULT_AUDIO_TYPE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_BITRATE,
+      g_param_spec_int ("bitrate", "Encoding Bit-rate",
+          "Specify an encoding bit-rate (in bps) for every stream",
+          LOWEST_BITRATE, HIGHEST_BITRATE, DEFAULT_BITRATE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
+  g_object_class_install_property (gobject_class, PROP_FRAME_SIZE,
+      g_param_spec_enum ("frame-size", "Frame Size",
+          "The duration of an audio frame, in ms, applies to streams "
+          "configured afterwards", gst_opus_enc_frame_size_get_type (),
+          DEFAULT_FRAMESIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_COMPLEXITY,
+      g_param_spec_int ("complexity", "Complexity", "Complexity", 0, 10,
+          DEFAULT_COMPLEXITY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_PLAYING));
+
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &sink_factory, GST_TYPE_OPUS_BATCH_ENC_PAD);
+  gst_element_class_add_static_pad_template_with_gtype (element_class,
+      &src_factory, GST_TYPE_AGGREGATOR_PAD);
+  gst_element_class_add_static_pad_template (element_class,
+      &stream_src_factory);
+  gst_element_class_set_static_metadata (element_class,
+      "Opus batch audio encoder", "Codec/Encoder/Audio",
+      "Encodes many audio streams in Opus format on one thread",
+      "GStreamer maintainers <gstreamer-devel@lists.freedesktop.org>");
+
+  element_class->request_new_pad =
+      GST_DEBUG_FUNCPTR (gst_opus_batch_enc_request_new_pad);
+  element_class->release_pad = GST_DEBUG_FUNCPTR (gst_opus_batch_enc_release_pad);
+
+  agg_class->aggregate = GST_DEBUG_FUNCPTR (gst_opus_batch_enc_aggregate);
+  agg_class->sink_event = GST_DEBUG_FUNCPTR (gst_opus_batch_enc_sink_event);
+  agg_class->get_next_time =
+      GST_DEBUG_FUNCPTR (gst_opus_batch_enc_get_next_time);
+  agg_class->negotiate = GST_DEBUG_FUNCPTR (gst_opus_batch_enc_negotiate);
+  agg_class->start = GST_DEBUG_FUNCPTR (gst_opus_batch_enc_start);
+
+  gst_type_mark_as_plugin_api (GST_TYPE_OPUS_BATCH_ENC_PAD, 0);
+
+  GST_DEBUG_CATEGORY_INIT (opusbatchenc_debug, "opusbatchenc", 0,
+      "Opus batch encoding element");
+}
+
+static void
+gst_opus_batch_enc_init (GstOpusBatchEnc * self)
+{
+  self->audio_type = DEFAULT_AUDIO_TYPE;
+  self->bitrate = DEFAULT_BITRATE;
+  self->frame_size = DEFAULT_FRAMESIZE;
+  self->complexity = DEFAULT_COMPLEXITY;
+  self->next_time = GST_CLOCK_TIME_NONE;
+  self->flow_combiner = gst_flow_combiner_new ();
+}
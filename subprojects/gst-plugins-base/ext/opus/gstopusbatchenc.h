@@ -0,0 +1,78 @@
+/* GStreamer Opus batch encoder
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __GST_OPUS_BATCH_ENC_H__
+#define __GST_OPUS_BATCH_ENC_H__
+
+
+#include <gst/gst.h>
+#include <gst/base/base.h>
+#include <gst/audio/audio.h>
+
+#include <opus.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_OPUS_BATCH_ENC (gst_opus_batch_enc_get_type())
+G_DECLARE_FINAL_TYPE (GstOpusBatchEnc, gst_opus_batch_enc, GST, OPUS_BATCH_ENC,
+    GstAggregator)
+
+#define GST_TYPE_OPUS_BATCH_ENC_PAD (gst_opus_batch_enc_pad_get_type())
+G_DECLARE_FINAL_TYPE (GstOpusBatchEncPad, gst_opus_batch_enc_pad, GST,
+    OPUS_BATCH_ENC_PAD, GstAggregatorPad)
+
+struct _GstOpusBatchEnc {
+  GstAggregator         element;
+
+  /* properties, protected by object lock */
+  gint                  audio_type;
+  gint                  bitrate;
+  gint                  frame_size;
+  gint                  complexity;
+  gboolean              settings_changed;
+
+  guint                 next_pad_num;
+  GstFlowCombiner      *flow_combiner;
+
+  /* running time up to which data was seen on any pad, the streams that
+   * are behind it are encoded on timeout in live pipelines */
+  GstClockTime          next_time;
+};
+
+struct _GstOpusBatchEncPad {
+  GstAggregatorPad      parent;
+
+  /* only accessed from the aggregate thread */
+  OpusEncoder          *state;
+  GstAudioInfo          info;
+  gint                  frame_samples;
+  GstAdapter           *adapter;
+
+  GstClockTime          base_ts;
+  guint64               encoded_samples;
+  gboolean              discont;
+  gboolean              eos_pushed;
+
+  /* the src pad carrying the encoded stream */
+  GstPad               *srcpad;
+};
+
+G_END_DECLS
+
+#endif /* __GST_OPUS_BATCH_ENC_H__ */
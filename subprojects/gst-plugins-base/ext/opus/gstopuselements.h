@@ -31,6 +31,7 @@ G_GNUC_INTERNAL void opus_element_init (GstPlugin * plugin);
 
 GST_ELEMENT_REGISTER_DECLARE (opusenc);
 GST_ELEMENT_REGISTER_DECLARE (opusdec);
+GST_ELEMENT_REGISTER_DECLARE (opusbatchenc);
 
 G_END_DECLS
 
@@ -94,7 +94,7 @@ gst_opus_enc_bandwidth_get_type (void)
 }
 
 #define GST_OPUS_ENC_TYPE_FRAME_SIZE (gst_opus_enc_frame_size_get_type())
-static GType
+GType
 gst_opus_enc_frame_size_get_type (void)
 {
   static const GEnumValue values[] = {
@@ -120,7 +120,7 @@ gst_opus_enc_frame_size_get_type (void)
 }
 
 #define GST_OPUS_ENC_TYPE_AUDIO_TYPE (gst_opus_enc_audio_type_get_type())
-static GType
+GType
 gst_opus_enc_audio_type_get_type (void)
 {
   static const GEnumValue values[] = {
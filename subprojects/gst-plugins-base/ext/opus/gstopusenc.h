@@ -98,6 +98,9 @@ struct _GstOpusEncClass {
 
 GType gst_opus_enc_get_type (void);
 
+G_GNUC_INTERNAL GType gst_opus_enc_frame_size_get_type (void);
+G_GNUC_INTERNAL GType gst_opus_enc_audio_type_get_type (void);
+
 G_END_DECLS
 
 #endif /* __GST_OPUS_ENC_H__ */
@@ -76,6 +76,10 @@
 #define MINIMUM_OUTLINE_OFFSET 1.0
 #define DEFAULT_SCALE_BASIS    640
 
+/* number of rendered text images kept around for reuse, shared by all
+ * text overlay instances of the process */
+#define RENDER_CACHE_SIZE      32
+
 enum
 {
   PROP_0,
@@ -1670,10 +1674,6 @@ gst_base_text_overlay_set_composition (GstBaseTextOverlay * overlay)
         overlay->text_width, overlay->text_height, render_width,
         render_height, xpos, ypos);
 
-    gst_buffer_add_video_meta (overlay->text_image, GST_VIDEO_FRAME_FLAG_NONE,
-        GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB,
-        overlay->text_width, overlay->text_height);
-
     rectangle = gst_video_overlay_rectangle_new_raw (overlay->text_image,
         xpos, ypos, render_width, render_height,
         GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA);
@@ -1708,6 +1708,114 @@ gst_text_overlay_filter_foreground_attr (PangoAttribute * attr, gpointer data)
   }
 }
 
+/* Rendered text images, keyed on everything that influences their pixels.
+ * Many overlays in a process (video walls, per-camera clocks, subtitles
+ * shown for several frames) end up drawing the same text with the same
+ * settings, and the outline path drawing is slow, so the images are shared
+ * between all instances. The cached buffers carry their video meta and are
+ * never written to again. */
+static GMutex render_cache_lock;
+static GHashTable *render_cache;        /* key -> GList link in render_lru */
+static GQueue render_lru = G_QUEUE_INIT;
+
+typedef struct
+{
+  gchar *key;
+  GstBuffer *image;
+} RenderCacheEntry;
+
+static void
+render_cache_entry_free (RenderCacheEntry * entry)
+{
+  g_free (entry->key);
+  gst_buffer_unref (entry->image);
+  g_free (entry);
+}
+
+static gchar *
+gst_base_text_overlay_render_cache_key (GstBaseTextOverlay * overlay,
+    const gchar * string, const cairo_matrix_t * matrix, gint width,
+    gint height)
+{
+  const PangoFontDescription *desc;
+  gchar *desc_str, *key;
+
+  desc = pango_layout_get_font_description (overlay->layout);
+  if (!desc)
+    desc = pango_context_get_font_description (overlay->pango_context);
+  desc_str = desc ? pango_font_description_to_string (desc) : NULL;
+
+  key = g_strdup_printf ("%s|%s|%s|%d|%d|%d|%d|%d|%d|%08x|%d|%.17g|%d|%.17g|"
+      "%08x|%.17g|%.17g|%.17g|%.17g|%.17g|%.17g|%s",
+      G_OBJECT_TYPE_NAME (overlay), GST_STR_NULL (desc_str),
+      pango_language_to_string (pango_context_get_language
+          (overlay->pango_context)),
+      pango_layout_get_width (overlay->layout),
+      pango_layout_get_wrap (overlay->layout),
+      pango_layout_get_alignment (overlay->layout),
+      overlay->use_vertical_render, width, height, overlay->color, overlay->draw_shadow, overlay->shadow_offset,
+      overlay->draw_outline, overlay->outline_offset, overlay->outline_color,
+      matrix->xx, matrix->yx, matrix->xy, matrix->yy, matrix->x0, matrix->y0,
+      string);
+
+  g_free (desc_str);
+
+  return key;
+}
+
+/* Returns a ref on the cached image for @key, or %NULL */
+static GstBuffer *
+gst_base_text_overlay_render_cache_lookup (const gchar * key)
+{
+  GstBuffer *image = NULL;
+  GList *link;
+
+  g_mutex_lock (&render_cache_lock);
+  if (render_cache && (link = g_hash_table_lookup (render_cache, key))) {
+    RenderCacheEntry *entry = link->data;
+
+    /* move to the front of the LRU */
+    g_queue_unlink (&render_lru, link);
+    g_queue_push_head_link (&render_lru, link);
+    image = gst_buffer_ref (entry->image);
+  }
+  g_mutex_unlock (&render_cache_lock);
+
+  return image;
+}
+
+/* Takes ownership of @key */
+static void
+gst_base_text_overlay_render_cache_insert (gchar * key, GstBuffer * image)
+{
+  RenderCacheEntry *entry;
+
+  g_mutex_lock (&render_cache_lock);
+  if (!render_cache)
+    render_cache = g_hash_table_new (g_str_hash, g_str_equal);
+
+  if (g_hash_table_contains (render_cache, key)) {
+    /* another instance rendered the same text meanwhile */
+    g_mutex_unlock (&render_cache_lock);
+    g_free (key);
+    return;
+  }
+
+  while (render_lru.length >= RENDER_CACHE_SIZE) {
+    RenderCacheEntry *old = g_queue_pop_tail (&render_lru);
+
+    g_hash_table_remove (render_cache, old->key);
+    render_cache_entry_free (old);
+  }
+
+  entry = g_new (RenderCacheEntry, 1);
+  entry->key = key;
+  entry->image = gst_buffer_ref (image);
+  g_queue_push_head (&render_lru, entry);
+  g_hash_table_insert (render_cache, entry->key, render_lru.head);
+  g_mutex_unlock (&render_cache_lock);
+}
+
 static void
 gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
     const gchar * string, gint textlen)
@@ -1726,6 +1834,7 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
   gint xpad = 0, ypad = 0;
   GstBuffer *buffer;
   GstMapInfo map;
+  gchar *cache_key;
 
   if (overlay->auto_adjust_size) {
     /* 640 pixel is default */
@@ -1935,6 +2044,20 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
       ceil (outline_offset / 2.0l) - ink_rect.x,
       ceil (outline_offset / 2.0l) - ink_rect.y);
 
+  cache_key = gst_base_text_overlay_render_cache_key (overlay, string,
+      &cairo_matrix, width, height);
+  buffer = gst_base_text_overlay_render_cache_lookup (cache_key);
+  if (buffer) {
+    GST_DEBUG_OBJECT (overlay, "Reusing cached text image");
+    gst_buffer_replace (&overlay->text_image, buffer);
+    gst_buffer_unref (buffer);
+    g_free (cache_key);
+    overlay->text_width = width;
+    overlay->text_height = height;
+    gst_base_text_overlay_set_composition (overlay);
+    return;
+  }
+
   /* reallocate overlay buffer */
   buffer = gst_buffer_new_and_alloc (4 * width * height);
   gst_buffer_replace (&overlay->text_image, buffer);
@@ -2021,10 +2144,12 @@ gst_base_text_overlay_render_pangocairo (GstBaseTextOverlay * overlay,
   cairo_destroy (cr);
   cairo_surface_destroy (surface);
   gst_buffer_unmap (buffer, &map);
-  if (width != 0)
-    overlay->text_width = width;
-  if (height != 0)
-    overlay->text_height = height;
+  overlay->text_width = width;
+  overlay->text_height = height;
+
+  gst_buffer_add_video_meta (buffer, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB, width, height);
+  gst_base_text_overlay_render_cache_insert (cache_key, buffer);
 
   gst_base_text_overlay_set_composition (overlay);
 }
@@ -49,6 +49,19 @@ GST_DEBUG_CATEGORY_STATIC (dmabuf_debug);
 G_DEFINE_TYPE_WITH_CODE (GstDmaBufAllocator, gst_dmabuf_allocator,
     GST_TYPE_FD_ALLOCATOR, _do_init);
 
+static GQuark
+gst_dmabuf_drm_modifier_quark (void)
+{
+  static gsize quark = 0;
+
+  if (g_once_init_enter (&quark)) {
+    GQuark q = g_quark_from_static_string ("GstDmaBufDrmModifier");
+    g_once_init_leave (&quark, q);
+  }
+
+  return quark;
+}
+
 static gpointer
 gst_dmabuf_mem_map (GstMemory * gmem, GstMapInfo * info, gsize maxsize)
 {
@@ -222,3 +235,62 @@ gst_is_dmabuf_memory (GstMemory * mem)
 
   return GST_IS_DMABUF_ALLOCATOR (mem->allocator);
 }
+
+/**
+ * gst_dmabuf_memory_set_drm_modifier:
+ * @mem: a dmabuf #GstMemory
+ * @modifier: the DRM format modifier describing the layout of @mem
+ *
+ * Attaches the DRM format @modifier to @mem so that importers can describe
+ * the buffer layout to their driver instead of assuming a linear layout.
+ * Exporters that know the modifier of the memory they produce (e.g. from a
+ * PRIME descriptor) should call this right after allocating the memory.
+ *
+ * Since: 1.24
+ */
+void
+gst_dmabuf_memory_set_drm_modifier (GstMemory * mem, guint64 modifier)
+{
+  guint64 *data;
+
+  g_return_if_fail (gst_is_dmabuf_memory (mem));
+
+  data = g_new (guint64, 1);
+  *data = modifier;
+
+  gst_mini_object_set_qdata (GST_MINI_OBJECT (mem),
+      gst_dmabuf_drm_modifier_quark (), data, g_free);
+}
+
+/**
+ * gst_dmabuf_memory_get_drm_modifier:
+ * @mem: a dmabuf #GstMemory
+ * @modifier: (out): return location for the DRM format modifier
+ *
+ * Retrieves the DRM format modifier attached to @mem with
+ * gst_dmabuf_memory_set_drm_modifier(). If no modifier was attached,
+ * @modifier is set to %GST_DMABUF_DRM_MODIFIER_LINEAR, which is what
+ * importers have always assumed.
+ *
+ * Returns: %TRUE if @mem carries an explicit modifier
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_dmabuf_memory_get_drm_modifier (GstMemory * mem, guint64 * modifier)
+{
+  guint64 *data;
+
+  g_return_val_if_fail (gst_is_dmabuf_memory (mem), FALSE);
+  g_return_val_if_fail (modifier != NULL, FALSE);
+
+  data = gst_mini_object_get_qdata (GST_MINI_OBJECT (mem),
+      gst_dmabuf_drm_modifier_quark ());
+  if (!data) {
+    *modifier = GST_DMABUF_DRM_MODIFIER_LINEAR;
+    return FALSE;
+  }
+
+  *modifier = *data;
+  return TRUE;
+}
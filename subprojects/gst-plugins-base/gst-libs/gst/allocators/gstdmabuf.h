@@ -60,6 +60,27 @@ G_BEGIN_DECLS
 
 #define GST_ALLOCATOR_DMABUF "dmabuf"
 
+/**
+ * GST_DMABUF_DRM_MODIFIER_LINEAR:
+ *
+ * The DRM format modifier describing a linear, untiled and uncompressed
+ * layout. This is the layout assumed for dmabuf memory that carries no
+ * explicit modifier.
+ *
+ * Since: 1.24
+ */
+#define GST_DMABUF_DRM_MODIFIER_LINEAR G_GUINT64_CONSTANT (0)
+
+/**
+ * GST_DMABUF_DRM_MODIFIER_INVALID:
+ *
+ * The DRM format modifier value used to signal that the modifier is unknown
+ * or that the buffer layout is implicitly negotiated by the driver.
+ *
+ * Since: 1.24
+ */
+#define GST_DMABUF_DRM_MODIFIER_INVALID G_GUINT64_CONSTANT (0x00ffffffffffffff)
+
 #define GST_TYPE_DMABUF_ALLOCATOR              (gst_dmabuf_allocator_get_type())
 #define GST_IS_DMABUF_ALLOCATOR(obj)           (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_DMABUF_ALLOCATOR))
 #define GST_IS_DMABUF_ALLOCATOR_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_DMABUF_ALLOCATOR))
@@ -113,6 +134,12 @@ gint           gst_dmabuf_memory_get_fd (GstMemory * mem);
 GST_ALLOCATORS_API
 gboolean       gst_is_dmabuf_memory (GstMemory * mem);
 
+GST_ALLOCATORS_API
+void           gst_dmabuf_memory_set_drm_modifier (GstMemory * mem, guint64 modifier);
+
+GST_ALLOCATORS_API
+gboolean       gst_dmabuf_memory_get_drm_modifier (GstMemory * mem, guint64 * modifier);
+
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstDmaBufAllocator, gst_object_unref)
 
@@ -0,0 +1,306 @@
+/* GStreamer huge page backed memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gsthugepagememory
+ * @title: GstHugePageAllocator
+ * @short_description: Memory backed by huge pages
+ * @see_also: #GstMemory, #GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT
+ *
+ * #GstHugePageAllocator backs the memory it allocates with huge pages of
+ * #GST_HUGE_PAGE_SIZE bytes. Large buffers like 4K or 8K video frames then
+ * need far fewer page faults and TLB entries than with the default
+ * allocator.
+ *
+ * The memory is taken from the reserved huge pages of the system
+ * (/proc/sys/vm/nr_hugepages) when there are enough of them. Otherwise it
+ * is allocated normally and the kernel is asked to use transparent huge
+ * pages for it, see gst_huge_page_memory_is_reserved(). Every allocation is
+ * rounded up to a multiple of #GST_HUGE_PAGE_SIZE, so this allocator is
+ * only useful for large memory.
+ *
+ * To use it for the buffers of a #GstBufferPool, set it on the pool config
+ * with gst_buffer_pool_config_set_allocator().
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gsthugepagememory.h"
+
+#include <string.h>
+
+#ifdef HAVE_MMAP
+#include <errno.h>
+#include <sys/mman.h>
+#endif
+
+GST_DEBUG_CATEGORY_STATIC (gst_huge_page_memory_debug);
+#define GST_CAT_DEFAULT gst_huge_page_memory_debug
+
+typedef struct
+{
+  GstMemory mem;
+
+  /* the allocated block, only set on the parent */
+  gpointer block;
+  gsize block_size;
+
+  guint8 *data;
+  gboolean reserved;
+} GstHugePageMemory;
+
+#define gst_huge_page_allocator_parent_class parent_class
+G_DEFINE_TYPE (GstHugePageAllocator, gst_huge_page_allocator,
+    GST_TYPE_ALLOCATOR);
+
+static GstMemory *
+gst_huge_page_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+  GstHugePageMemory *mem;
+  gsize maxsize, align, aoffset, block_size, pages_size;
+  gpointer block = NULL;
+  guint8 *data;
+  gboolean reserved = FALSE;
+
+  /* ensure configured alignment */
+  align = params->align | gst_memory_alignment;
+  /* allocate more to compensate for alignment */
+  maxsize = size + params->prefix + params->padding + align;
+  pages_size = GST_ROUND_UP_N (maxsize, GST_HUGE_PAGE_SIZE);
+
+#ifdef HAVE_MMAP
+#ifdef MAP_HUGETLB
+  block_size = pages_size;
+  block = mmap (NULL, block_size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (block != MAP_FAILED) {
+    data = block;
+    reserved = TRUE;
+  } else {
+    GST_DEBUG_OBJECT (allocator, "no reserved huge pages for %" G_GSIZE_FORMAT
+        " bytes: %s", block_size, g_strerror (errno));
+    block = NULL;
+  }
+#endif
+
+  if (block == NULL) {
+    /* map one huge page more so the data can start on a huge page boundary,
+     * transparent huge pages are only used for aligned ranges */
+    block_size = pages_size + GST_HUGE_PAGE_SIZE;
+    block = mmap (NULL, block_size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (block == MAP_FAILED) {
+      GST_WARNING_OBJECT (allocator, "failed to map %" G_GSIZE_FORMAT " bytes",
+          block_size);
+      return NULL;
+    }
+
+    data = (guint8 *) GST_ROUND_UP_N ((guintptr) block, GST_HUGE_PAGE_SIZE);
+#ifdef MADV_HUGEPAGE
+    if (madvise (data, pages_size, MADV_HUGEPAGE) != 0)
+      GST_DEBUG_OBJECT (allocator, "no transparent huge pages: %s",
+          g_strerror (errno));
+#endif
+  }
+#else
+  block_size = pages_size;
+  block = g_try_malloc0 (block_size);
+  if (block == NULL)
+    return NULL;
+  data = block;
+#endif
+
+  maxsize = pages_size;
+  /* do alignment */
+  if ((aoffset = ((guintptr) data & align))) {
+    aoffset = (align + 1) - aoffset;
+    data += aoffset;
+    maxsize -= aoffset;
+  }
+
+  mem = g_new0 (GstHugePageMemory, 1);
+  gst_memory_init (GST_MEMORY_CAST (mem), params->flags, allocator, NULL,
+      maxsize, align, params->prefix, size);
+  mem->block = block;
+  mem->block_size = block_size;
+  mem->data = data;
+  mem->reserved = reserved;
+
+  GST_LOG_OBJECT (allocator, "%p: allocated %" G_GSIZE_FORMAT " bytes, %s",
+      mem, maxsize, reserved ? "reserved" : "transparent");
+
+  return GST_MEMORY_CAST (mem);
+}
+
+static void
+gst_huge_page_allocator_free (GstAllocator * allocator, GstMemory * gmem)
+{
+  GstHugePageMemory *mem = (GstHugePageMemory *) gmem;
+
+  if (mem->block) {
+#ifdef HAVE_MMAP
+    munmap (mem->block, mem->block_size);
+#else
+    g_free (mem->block);
+#endif
+  }
+
+  GST_LOG_OBJECT (allocator, "%p: freed", mem);
+  g_free (mem);
+}
+
+static gpointer
+gst_huge_page_mem_map (GstHugePageMemory * mem, gsize maxsize,
+    GstMapFlags flags)
+{
+  return mem->data;
+}
+
+static gboolean
+gst_huge_page_mem_unmap (GstHugePageMemory * mem)
+{
+  return TRUE;
+}
+
+static GstHugePageMemory *
+gst_huge_page_mem_share (GstHugePageMemory * mem, gssize offset, gsize size)
+{
+  GstHugePageMemory *sub;
+  GstMemory *parent;
+
+  /* find the real parent */
+  if ((parent = mem->mem.parent) == NULL)
+    parent = (GstMemory *) mem;
+
+  if (size == -1)
+    size = mem->mem.size - offset;
+
+  /* the shared memory is always readonly */
+  sub = g_new0 (GstHugePageMemory, 1);
+  gst_memory_init (GST_MEMORY_CAST (sub), GST_MINI_OBJECT_FLAGS (parent) |
+      GST_MINI_OBJECT_FLAG_LOCK_READONLY, mem->mem.allocator, parent,
+      mem->mem.maxsize, mem->mem.align, mem->mem.offset + offset, size);
+  sub->data = mem->data;
+  sub->reserved = mem->reserved;
+
+  return sub;
+}
+
+static gboolean
+gst_huge_page_mem_is_span (GstHugePageMemory * mem1,
+    GstHugePageMemory * mem2, gsize * offset)
+{
+  if (offset) {
+    GstHugePageMemory *parent;
+
+    parent = (GstHugePageMemory *) mem1->mem.parent;
+
+    *offset = mem1->mem.offset - parent->mem.offset;
+  }
+
+  /* and memory is contiguous */
+  return mem1->data + mem1->mem.offset + mem1->mem.size ==
+      mem2->data + mem2->mem.offset;
+}
+
+static void
+gst_huge_page_allocator_class_init (GstHugePageAllocatorClass * klass)
+{
+  GstAllocatorClass *allocator_class = (GstAllocatorClass *) klass;
+
+  allocator_class->alloc = gst_huge_page_allocator_alloc;
+  allocator_class->free = gst_huge_page_allocator_free;
+
+  GST_DEBUG_CATEGORY_INIT (gst_huge_page_memory_debug, "hugepagememory", 0,
+      "GstHugePageMemory and GstHugePageAllocator");
+}
+
+static void
+gst_huge_page_allocator_init (GstHugePageAllocator * allocator)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (allocator);
+
+  alloc->mem_type = GST_ALLOCATOR_HUGE_PAGE;
+  alloc->mem_map = (GstMemoryMapFunction) gst_huge_page_mem_map;
+  alloc->mem_unmap = (GstMemoryUnmapFunction) gst_huge_page_mem_unmap;
+  alloc->mem_share = (GstMemoryShareFunction) gst_huge_page_mem_share;
+  alloc->mem_is_span = (GstMemoryIsSpanFunction) gst_huge_page_mem_is_span;
+}
+
+/**
+ * gst_huge_page_allocator_new:
+ *
+ * Create a new allocator that backs its memory with huge pages.
+ *
+ * Returns: (transfer full): a new #GstHugePageAllocator
+ *
+ * Since: 1.24
+ */
+GstAllocator *
+gst_huge_page_allocator_new (void)
+{
+  GstHugePageAllocator *alloc;
+
+  alloc = g_object_new (GST_TYPE_HUGE_PAGE_ALLOCATOR, NULL);
+  gst_object_ref_sink (alloc);
+
+  return GST_ALLOCATOR_CAST (alloc);
+}
+
+/**
+ * gst_is_huge_page_memory:
+ * @mem: #GstMemory
+ *
+ * Check if @mem was allocated by a #GstHugePageAllocator.
+ *
+ * Returns: %TRUE when @mem is huge page memory.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_is_huge_page_memory (GstMemory * mem)
+{
+  g_return_val_if_fail (mem != NULL, FALSE);
+
+  return gst_memory_is_type (mem, GST_ALLOCATOR_HUGE_PAGE);
+}
+
+/**
+ * gst_huge_page_memory_is_reserved:
+ * @mem: #GstMemory allocated by a #GstHugePageAllocator
+ *
+ * Check if @mem was taken from the reserved huge pages of the system. If not,
+ * the kernel was only asked to use transparent huge pages for it and may
+ * not have done so for all of it.
+ *
+ * Returns: %TRUE when @mem uses reserved huge pages.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_huge_page_memory_is_reserved (GstMemory * mem)
+{
+  g_return_val_if_fail (gst_is_huge_page_memory (mem), FALSE);
+
+  return ((GstHugePageMemory *) mem)->reserved;
+}
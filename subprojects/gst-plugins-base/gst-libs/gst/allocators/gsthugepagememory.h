@@ -0,0 +1,95 @@
+/* GStreamer huge page backed memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_HUGE_PAGE_MEMORY_H__
+#define __GST_HUGE_PAGE_MEMORY_H__
+
+#include <gst/gst.h>
+#include <gst/allocators/allocators-prelude.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstHugePageAllocator GstHugePageAllocator;
+typedef struct _GstHugePageAllocatorClass GstHugePageAllocatorClass;
+
+/**
+ * GST_ALLOCATOR_HUGE_PAGE:
+ *
+ * The memory type of #GstHugePageAllocator memory.
+ *
+ * Since: 1.24
+ */
+#define GST_ALLOCATOR_HUGE_PAGE "HugePageMemory"
+
+/**
+ * GST_HUGE_PAGE_SIZE:
+ *
+ * The size of the huge pages #GstHugePageAllocator allocates.
+ *
+ * Since: 1.24
+ */
+#define GST_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#define GST_TYPE_HUGE_PAGE_ALLOCATOR              (gst_huge_page_allocator_get_type())
+#define GST_IS_HUGE_PAGE_ALLOCATOR(obj)           (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_HUGE_PAGE_ALLOCATOR))
+#define GST_IS_HUGE_PAGE_ALLOCATOR_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_HUGE_PAGE_ALLOCATOR))
+#define GST_HUGE_PAGE_ALLOCATOR_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GST_TYPE_HUGE_PAGE_ALLOCATOR, GstHugePageAllocatorClass))
+#define GST_HUGE_PAGE_ALLOCATOR(obj)              (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_HUGE_PAGE_ALLOCATOR, GstHugePageAllocator))
+#define GST_HUGE_PAGE_ALLOCATOR_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_HUGE_PAGE_ALLOCATOR, GstHugePageAllocatorClass))
+#define GST_HUGE_PAGE_ALLOCATOR_CAST(obj)         ((GstHugePageAllocator *)(obj))
+
+/**
+ * GstHugePageAllocator:
+ *
+ * Allocator for memory backed by huge pages.
+ *
+ * Since: 1.24
+ */
+struct _GstHugePageAllocator
+{
+  GstAllocator parent;
+
+  /*< private >*/
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+struct _GstHugePageAllocatorClass
+{
+  GstAllocatorClass parent_class;
+
+  /*< private >*/
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+GST_ALLOCATORS_API
+GType           gst_huge_page_allocator_get_type  (void);
+
+GST_ALLOCATORS_API
+GstAllocator *  gst_huge_page_allocator_new       (void);
+
+GST_ALLOCATORS_API
+gboolean        gst_is_huge_page_memory           (GstMemory * mem);
+
+GST_ALLOCATORS_API
+gboolean        gst_huge_page_memory_is_reserved  (GstMemory * mem);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstHugePageAllocator, gst_object_unref)
+
+G_END_DECLS
+
+#endif /* __GST_HUGE_PAGE_MEMORY_H__ */
@@ -0,0 +1,340 @@
+/* GStreamer NUMA node local memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gstnumamemory
+ * @title: GstNumaAllocator
+ * @short_description: Memory allocated on a NUMA node
+ * @see_also: #GstMemory, gst_task_set_numa_node()
+ *
+ * #GstNumaAllocator places the memory it allocates on a NUMA node. The node
+ * is either fixed when creating the allocator or, with -1, the node of the
+ * CPU the allocating thread runs on. Combined with gst_task_set_numa_node()
+ * or a #GST_TASK_AFFINITY_CONTEXT_TYPE context, buffers allocated by a
+ * streaming thread stay local to the node that thread processes them on.
+ *
+ * Placement is only a preference, when the node has no free memory left the
+ * kernel falls back to other nodes. On systems without NUMA support this
+ * allocator behaves like the default allocator.
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstnumamemory.h"
+
+#include <string.h>
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
+#ifdef HAVE_NUMA_SYSCALLS
+#include <errno.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* from linux/mempolicy.h */
+#define NUMA_MPOL_PREFERRED 1
+#endif
+
+GST_DEBUG_CATEGORY_STATIC (gst_numa_memory_debug);
+#define GST_CAT_DEFAULT gst_numa_memory_debug
+
+typedef struct
+{
+  GstMemory mem;
+
+  /* the allocated block, only set on the parent */
+  gpointer block;
+  gsize block_size;
+
+  guint8 *data;
+  gint node;
+} GstNumaMemory;
+
+#define gst_numa_allocator_parent_class parent_class
+G_DEFINE_TYPE (GstNumaAllocator, gst_numa_allocator, GST_TYPE_ALLOCATOR);
+
+static gint
+gst_numa_get_current_node (void)
+{
+#ifdef HAVE_NUMA_SYSCALLS
+  unsigned int cpu, node;
+
+  if (syscall (SYS_getcpu, &cpu, &node, NULL) == 0)
+    return node;
+#endif
+
+  return -1;
+}
+
+static void
+gst_numa_bind (gpointer block, gsize size, gint node)
+{
+#if defined (HAVE_NUMA_SYSCALLS) && defined (HAVE_MMAP)
+  unsigned long mask[16] = { 0, };
+  const guint bits = 8 * sizeof (unsigned long);
+
+  /* the kernel only looks at maxnode - 1 bits */
+  if (node < 0 || (guint) node >= G_N_ELEMENTS (mask) * bits - 1)
+    return;
+
+  mask[node / bits] |= 1UL << (node % bits);
+
+  if (syscall (SYS_mbind, block, size, NUMA_MPOL_PREFERRED, mask,
+          (unsigned long) (G_N_ELEMENTS (mask) * bits), 0) != 0)
+    GST_DEBUG ("failed to bind %p to node %d: %s", block, node,
+        g_strerror (errno));
+#endif
+}
+
+static GstMemory *
+gst_numa_allocator_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+  GstNumaAllocator *self = GST_NUMA_ALLOCATOR (allocator);
+  GstNumaMemory *mem;
+  gsize maxsize, align, aoffset, block_size;
+  gpointer block;
+  guint8 *data;
+  gint node;
+
+  /* ensure configured alignment */
+  align = params->align | gst_memory_alignment;
+  /* allocate more to compensate for alignment */
+  maxsize = size + params->prefix + params->padding + align;
+  block_size = maxsize;
+
+  node = self->node >= 0 ? self->node : gst_numa_get_current_node ();
+
+#ifdef HAVE_MMAP
+  /* anonymous mappings are page aligned and zero filled, the pages are only
+   * placed when they are first touched so bind before that */
+  block = mmap (NULL, block_size, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (block == MAP_FAILED) {
+    GST_WARNING_OBJECT (allocator, "failed to map %" G_GSIZE_FORMAT " bytes",
+        block_size);
+    return NULL;
+  }
+  gst_numa_bind (block, block_size, node);
+#else
+  block = g_try_malloc0 (block_size);
+  if (block == NULL)
+    return NULL;
+#endif
+
+  data = block;
+  /* do alignment */
+  if ((aoffset = ((guintptr) data & align))) {
+    aoffset = (align + 1) - aoffset;
+    data += aoffset;
+    maxsize -= aoffset;
+  }
+
+  mem = g_new0 (GstNumaMemory, 1);
+  gst_memory_init (GST_MEMORY_CAST (mem), params->flags, allocator, NULL,
+      maxsize, align, params->prefix, size);
+  mem->block = block;
+  mem->block_size = block_size;
+  mem->data = data;
+  mem->node = node;
+
+  GST_LOG_OBJECT (allocator, "%p: allocated %" G_GSIZE_FORMAT " bytes on node "
+      "%d", mem, maxsize, node);
+
+  return GST_MEMORY_CAST (mem);
+}
+
+static void
+gst_numa_allocator_free (GstAllocator * allocator, GstMemory * gmem)
+{
+  GstNumaMemory *mem = (GstNumaMemory *) gmem;
+
+  if (mem->block) {
+#ifdef HAVE_MMAP
+    munmap (mem->block, mem->block_size);
+#else
+    g_free (mem->block);
+#endif
+  }
+
+  GST_LOG_OBJECT (allocator, "%p: freed", mem);
+  g_free (mem);
+}
+
+static gpointer
+gst_numa_mem_map (GstNumaMemory * mem, gsize maxsize, GstMapFlags flags)
+{
+  return mem->data;
+}
+
+static gboolean
+gst_numa_mem_unmap (GstNumaMemory * mem)
+{
+  return TRUE;
+}
+
+static GstNumaMemory *
+gst_numa_mem_share (GstNumaMemory * mem, gssize offset, gsize size)
+{
+  GstNumaMemory *sub;
+  GstMemory *parent;
+
+  /* find the real parent */
+  if ((parent = mem->mem.parent) == NULL)
+    parent = (GstMemory *) mem;
+
+  if (size == -1)
+    size = mem->mem.size - offset;
+
+  /* the shared memory is always readonly */
+  sub = g_new0 (GstNumaMemory, 1);
+  gst_memory_init (GST_MEMORY_CAST (sub), GST_MINI_OBJECT_FLAGS (parent) |
+      GST_MINI_OBJECT_FLAG_LOCK_READONLY, mem->mem.allocator, parent,
+      mem->mem.maxsize, mem->mem.align, mem->mem.offset + offset, size);
+  sub->data = mem->data;
+  sub->node = mem->node;
+
+  return sub;
+}
+
+static gboolean
+gst_numa_mem_is_span (GstNumaMemory * mem1, GstNumaMemory * mem2,
+    gsize * offset)
+{
+  if (offset) {
+    GstNumaMemory *parent;
+
+    parent = (GstNumaMemory *) mem1->mem.parent;
+
+    *offset = mem1->mem.offset - parent->mem.offset;
+  }
+
+  /* and memory is contiguous */
+  return mem1->data + mem1->mem.offset + mem1->mem.size ==
+      mem2->data + mem2->mem.offset;
+}
+
+static void
+gst_numa_allocator_class_init (GstNumaAllocatorClass * klass)
+{
+  GstAllocatorClass *allocator_class = (GstAllocatorClass *) klass;
+
+  allocator_class->alloc = gst_numa_allocator_alloc;
+  allocator_class->free = gst_numa_allocator_free;
+
+  GST_DEBUG_CATEGORY_INIT (gst_numa_memory_debug, "numamemory", 0,
+      "GstNumaMemory and GstNumaAllocator");
+}
+
+static void
+gst_numa_allocator_init (GstNumaAllocator * allocator)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (allocator);
+
+  alloc->mem_type = GST_ALLOCATOR_NUMA;
+  alloc->mem_map = (GstMemoryMapFunction) gst_numa_mem_map;
+  alloc->mem_unmap = (GstMemoryUnmapFunction) gst_numa_mem_unmap;
+  alloc->mem_share = (GstMemoryShareFunction) gst_numa_mem_share;
+  alloc->mem_is_span = (GstMemoryIsSpanFunction) gst_numa_mem_is_span;
+
+  allocator->node = -1;
+}
+
+/**
+ * gst_numa_allocator_new:
+ * @node: the NUMA node to allocate on, or -1
+ *
+ * Create a new allocator that places its memory on NUMA node @node. With -1
+ * the memory is placed on the node of the CPU the allocating thread runs on.
+ *
+ * Returns: (transfer full): a new #GstNumaAllocator
+ *
+ * Since: 1.24
+ */
+GstAllocator *
+gst_numa_allocator_new (gint node)
+{
+  GstNumaAllocator *alloc;
+
+  g_return_val_if_fail (node >= -1, NULL);
+
+  alloc = g_object_new (GST_TYPE_NUMA_ALLOCATOR, NULL);
+  gst_object_ref_sink (alloc);
+  alloc->node = node;
+
+  return GST_ALLOCATOR_CAST (alloc);
+}
+
+/**
+ * gst_numa_allocator_get_node:
+ * @allocator: a #GstNumaAllocator
+ *
+ * Returns: the NUMA node @allocator was created for, or -1
+ *
+ * Since: 1.24
+ */
+gint
+gst_numa_allocator_get_node (GstNumaAllocator * allocator)
+{
+  g_return_val_if_fail (GST_IS_NUMA_ALLOCATOR (allocator), -1);
+
+  return allocator->node;
+}
+
+/**
+ * gst_is_numa_memory:
+ * @mem: #GstMemory
+ *
+ * Check if @mem was allocated by a #GstNumaAllocator.
+ *
+ * Returns: %TRUE when @mem is NUMA memory.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_is_numa_memory (GstMemory * mem)
+{
+  g_return_val_if_fail (mem != NULL, FALSE);
+
+  return gst_memory_is_type (mem, GST_ALLOCATOR_NUMA);
+}
+
+/**
+ * gst_numa_memory_get_node:
+ * @mem: #GstMemory allocated by a #GstNumaAllocator
+ *
+ * Get the NUMA node @mem was placed on. This is the preferred node, the
+ * kernel may have placed some pages elsewhere.
+ *
+ * Returns: the NUMA node of @mem or -1 if it is unknown.
+ *
+ * Since: 1.24
+ */
+gint
+gst_numa_memory_get_node (GstMemory * mem)
+{
+  g_return_val_if_fail (gst_is_numa_memory (mem), -1);
+
+  return ((GstNumaMemory *) mem)->node;
+}
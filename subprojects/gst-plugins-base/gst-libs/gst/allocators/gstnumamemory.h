@@ -0,0 +1,91 @@
+/* GStreamer NUMA node local memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_NUMA_MEMORY_H__
+#define __GST_NUMA_MEMORY_H__
+
+#include <gst/gst.h>
+#include <gst/allocators/allocators-prelude.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstNumaAllocator GstNumaAllocator;
+typedef struct _GstNumaAllocatorClass GstNumaAllocatorClass;
+
+/**
+ * GST_ALLOCATOR_NUMA:
+ *
+ * The memory type of #GstNumaAllocator memory.
+ *
+ * Since: 1.24
+ */
+#define GST_ALLOCATOR_NUMA "NumaMemory"
+
+#define GST_TYPE_NUMA_ALLOCATOR              (gst_numa_allocator_get_type())
+#define GST_IS_NUMA_ALLOCATOR(obj)           (G_TYPE_CHECK_INSTANCE_TYPE ((obj), GST_TYPE_NUMA_ALLOCATOR))
+#define GST_IS_NUMA_ALLOCATOR_CLASS(klass)   (G_TYPE_CHECK_CLASS_TYPE ((klass), GST_TYPE_NUMA_ALLOCATOR))
+#define GST_NUMA_ALLOCATOR_GET_CLASS(obj)    (G_TYPE_INSTANCE_GET_CLASS ((obj), GST_TYPE_NUMA_ALLOCATOR, GstNumaAllocatorClass))
+#define GST_NUMA_ALLOCATOR(obj)              (G_TYPE_CHECK_INSTANCE_CAST ((obj), GST_TYPE_NUMA_ALLOCATOR, GstNumaAllocator))
+#define GST_NUMA_ALLOCATOR_CLASS(klass)      (G_TYPE_CHECK_CLASS_CAST ((klass), GST_TYPE_NUMA_ALLOCATOR, GstNumaAllocatorClass))
+#define GST_NUMA_ALLOCATOR_CAST(obj)         ((GstNumaAllocator *)(obj))
+
+/**
+ * GstNumaAllocator:
+ *
+ * Allocator for memory placed on a NUMA node.
+ *
+ * Since: 1.24
+ */
+struct _GstNumaAllocator
+{
+  GstAllocator parent;
+
+  /*< private >*/
+  gint node;
+
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+struct _GstNumaAllocatorClass
+{
+  GstAllocatorClass parent_class;
+
+  /*< private >*/
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+GST_ALLOCATORS_API
+GType           gst_numa_allocator_get_type (void);
+
+GST_ALLOCATORS_API
+GstAllocator *  gst_numa_allocator_new      (gint node);
+
+GST_ALLOCATORS_API
+gint            gst_numa_allocator_get_node (GstNumaAllocator * allocator);
+
+GST_ALLOCATORS_API
+gboolean        gst_is_numa_memory          (GstMemory * mem);
+
+GST_ALLOCATORS_API
+gint            gst_numa_memory_get_node    (GstMemory * mem);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstNumaAllocator, gst_object_unref)
+
+G_END_DECLS
+
+#endif /* __GST_NUMA_MEMORY_H__ */
@@ -1961,6 +1961,146 @@ not_started:
   }
 }
 
+/**
+ * gst_app_sink_try_pull_sample_batch:
+ * @appsink: a #GstAppSink
+ * @max_buffers: the maximum number of buffers to return, 0 for all queued ones
+ * @timeout: the maximum amount of time to wait for a buffer
+ *
+ * This function blocks until at least one buffer or EOS becomes available or
+ * the appsink element is set to the READY/NULL state or the timeout expires,
+ * like gst_app_sink_try_pull_sample().
+ *
+ * Unlike gst_app_sink_try_pull_sample() it then returns all queued buffers,
+ * up to @max_buffers, at once in the #GstBufferList of a single sample. This
+ * saves the locking and the sample handling per buffer for applications
+ * that process many small buffers. The batch stops before a caps or segment
+ * change so that all buffers in the sample share its caps and segment, other
+ * queued events are dropped like with gst_app_sink_try_pull_sample().
+ *
+ * Returns: (transfer full) (nullable): a #GstSample with a #GstBufferList or
+ *     NULL when the appsink is stopped or EOS or the timeout expires.
+ *     Call gst_sample_unref() after usage.
+ *
+ * Since: 1.24
+ */
+GstSample *
+gst_app_sink_try_pull_sample_batch (GstAppSink * appsink, guint max_buffers,
+    GstClockTime timeout)
+{
+  GstAppSinkPrivate *priv;
+  GstBufferList *list;
+  GstSample *ret;
+  gboolean timeout_valid;
+  gint64 end_time;
+
+  g_return_val_if_fail (GST_IS_APP_SINK (appsink), NULL);
+
+  timeout_valid = GST_CLOCK_TIME_IS_VALID (timeout);
+
+  if (timeout_valid)
+    end_time =
+        g_get_monotonic_time () + timeout / (GST_SECOND / G_TIME_SPAN_SECOND);
+
+  priv = appsink->priv;
+
+  g_mutex_lock (&priv->mutex);
+  gst_buffer_replace (&priv->preroll_buffer, NULL);
+
+  while (TRUE) {
+    GST_DEBUG_OBJECT (appsink, "trying to grab buffers");
+    if (!priv->started)
+      goto not_started;
+
+    if (priv->num_buffers > 0)
+      break;
+
+    if (priv->is_eos)
+      goto eos;
+
+    /* nothing to return, wait */
+    GST_DEBUG_OBJECT (appsink, "waiting for a buffer");
+    priv->wait_status |= APP_WAITING;
+    if (timeout_valid) {
+      if (!g_cond_wait_until (&priv->cond, &priv->mutex, end_time))
+        goto expired;
+    } else {
+      g_cond_wait (&priv->cond, &priv->mutex);
+    }
+    priv->wait_status &= ~APP_WAITING;
+  }
+
+  list = gst_buffer_list_new_sized (max_buffers > 0 ?
+      MIN (max_buffers, priv->num_buffers) : priv->num_buffers);
+
+  while (!gst_queue_array_is_empty (priv->queue)) {
+    GstMiniObject *obj = gst_queue_array_peek_head (priv->queue);
+
+    if (GST_IS_EVENT (obj)) {
+      /* keep caps and segment changes for the next batch */
+      if (gst_buffer_list_length (list) > 0 &&
+          (GST_EVENT_TYPE (obj) == GST_EVENT_CAPS ||
+              GST_EVENT_TYPE (obj) == GST_EVENT_SEGMENT))
+        break;
+
+      gst_mini_object_unref (dequeue_object (appsink));
+      continue;
+    }
+
+    if (max_buffers > 0 && gst_buffer_list_length (list) >= max_buffers)
+      break;
+
+    obj = dequeue_object (appsink);
+    if (GST_IS_BUFFER (obj)) {
+      gst_buffer_list_add (list, GST_BUFFER_CAST (obj));
+    } else {
+      GstBufferList *blist = GST_BUFFER_LIST_CAST (obj);
+      guint i, len = gst_buffer_list_length (blist);
+
+      for (i = 0; i < len; i++)
+        gst_buffer_list_add (list,
+            gst_buffer_ref (gst_buffer_list_get (blist, i)));
+      gst_buffer_list_unref (blist);
+    }
+  }
+
+  GST_DEBUG_OBJECT (appsink, "pulled %u buffers", gst_buffer_list_length (list));
+
+  priv->sample = gst_sample_make_writable (priv->sample);
+  gst_sample_set_buffer (priv->sample, NULL);
+  gst_sample_set_buffer_list (priv->sample, list);
+  ret = gst_sample_ref (priv->sample);
+  gst_buffer_list_unref (list);
+
+  if ((priv->wait_status & STREAM_WAITING))
+    g_cond_signal (&priv->cond);
+
+  g_mutex_unlock (&priv->mutex);
+
+  return ret;
+
+  /* special conditions */
+expired:
+  {
+    GST_DEBUG_OBJECT (appsink, "timeout expired, return NULL");
+    priv->wait_status &= ~APP_WAITING;
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+eos:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are EOS, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+not_started:
+  {
+    GST_DEBUG_OBJECT (appsink, "we are stopped, return NULL");
+    g_mutex_unlock (&priv->mutex);
+    return NULL;
+  }
+}
+
 /**
  * gst_app_sink_set_callbacks: (skip)
  * @appsink: a #GstAppSink
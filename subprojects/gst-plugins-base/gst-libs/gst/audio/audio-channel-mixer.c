@@ -28,6 +28,7 @@
 #include <string.h>
 
 #include "audio-channel-mixer.h"
+#include "gstaudioutilsprivate.h"
 
 #ifndef GST_DISABLE_GST_DEBUG
 #define GST_CAT_DEFAULT ensure_debug_category()
@@ -70,6 +71,15 @@ struct _GstAudioChannelMixer
    * this is matrix * (2^10) as integers */
   gint **matrix_int;
 
+  /* for each output channel the input channels with a non-zero coefficient,
+   * m_in[out * in_channels + i] for i < n_in[out] */
+  gint *n_in;
+  gint *m_in;
+
+  /* if every output channel is a copy of one input channel or silent, the
+   * input channel to copy for each output channel or -1 */
+  gint *remap;
+
   MixerFunc func;
 };
 
@@ -95,6 +105,10 @@ gst_audio_channel_mixer_free (GstAudioChannelMixer * mix)
   g_free (mix->matrix_int);
   mix->matrix_int = NULL;
 
+  g_free (mix->n_in);
+  g_free (mix->m_in);
+  g_free (mix->remap);
+
   g_free (mix);
 }
 
@@ -673,6 +687,40 @@ gst_audio_channel_mixer_setup_matrix_int (GstAudioChannelMixer * mix)
   }
 }
 
+/* collect the non-zero coefficients of every output channel so that the
+ * mix functions can skip the others, sparse matrices are common when mixing
+ * many channels */
+static void
+gst_audio_channel_mixer_setup_sparse (GstAudioChannelMixer * mix)
+{
+  gint i, j, n;
+  gboolean remap = TRUE;
+
+  mix->n_in = g_new (gint, mix->out_channels);
+  mix->m_in = g_new (gint, mix->out_channels * mix->in_channels);
+
+  for (j = 0; j < mix->out_channels; j++) {
+    n = 0;
+    for (i = 0; i < mix->in_channels; i++) {
+      if (mix->matrix[i][j] == 0.0f)
+        continue;
+
+      mix->m_in[j * mix->in_channels + n++] = i;
+      if (mix->matrix[i][j] != 1.0f)
+        remap = FALSE;
+    }
+    mix->n_in[j] = n;
+    if (n > 1)
+      remap = FALSE;
+  }
+
+  if (remap) {
+    mix->remap = g_new (gint, mix->out_channels);
+    for (j = 0; j < mix->out_channels; j++)
+      mix->remap[j] = mix->n_in[j] ? mix->m_in[j * mix->in_channels] : -1;
+  }
+}
+
 static gfloat **
 gst_audio_channel_mixer_setup_matrix (GstAudioChannelMixerFlags flags,
     gint in_channels, GstAudioChannelPosition * in_position,
@@ -731,9 +779,10 @@ gst_audio_channel_mixer_mix_int##bits##_##inlayout##_##outlayout ( \
     GstAudioChannelMixer * mix, const gint##bits * in_data[], \
     gint##bits * out_data[], gint samples) \
 { \
-  gint in, out, n; \
+  gint in, out, n, i; \
   gint##resbits res; \
   gint inchannels, outchannels; \
+  const gint *m_in; \
   \
   inchannels = mix->in_channels; \
   outchannels = mix->out_channels; \
@@ -742,10 +791,13 @@ gst_audio_channel_mixer_mix_int##bits##_##inlayout##_##outlayout ( \
     for (out = 0; out < outchannels; out++) { \
       /* convert */ \
       res = 0; \
-      for (in = 0; in < inchannels; in++) \
+      m_in = &mix->m_in[out * inchannels]; \
+      for (i = 0; i < mix->n_in[out]; i++) { \
+        in = m_in[i]; \
         res += \
           _get_in_data_##inlayout##_gint##bits (in_data, n, in, inchannels) * \
           (gint##resbits) mix->matrix_int[in][out]; \
+      } \
       \
       /* remove factor from int matrix */ \
       res = (res + (1 << (PRECISION_INT - 1))) >> PRECISION_INT; \
@@ -761,9 +813,10 @@ gst_audio_channel_mixer_mix_##type##_##inlayout##_##outlayout ( \
     GstAudioChannelMixer * mix, const g##type * in_data[], \
     g##type * out_data[], gint samples) \
 { \
-  gint in, out, n; \
+  gint in, out, n, i; \
   g##type res; \
   gint inchannels, outchannels; \
+  const gint *m_in; \
   \
   inchannels = mix->in_channels; \
   outchannels = mix->out_channels; \
@@ -772,10 +825,13 @@ gst_audio_channel_mixer_mix_##type##_##inlayout##_##outlayout ( \
     for (out = 0; out < outchannels; out++) { \
       /* convert */ \
       res = 0.0; \
-      for (in = 0; in < inchannels; in++) \
+      m_in = &mix->m_in[out * inchannels]; \
+      for (i = 0; i < mix->n_in[out]; i++) { \
+        in = m_in[i]; \
         res += \
           _get_in_data_##inlayout##_g##type (in_data, n, in, inchannels) * \
           mix->matrix[in][out]; \
+      } \
       \
       *_get_out_data_##outlayout##_g##type (out_data, n, out, outchannels) = res; \
     } \
@@ -806,6 +862,59 @@ DEFINE_FLOAT_MIX_FUNC (double, interleaved, planar);
 DEFINE_FLOAT_MIX_FUNC (double, planar, interleaved);
 DEFINE_FLOAT_MIX_FUNC (double, planar, planar);
 
+#define DEFINE_REMAP_FUNC(type, inlayout, outlayout) \
+static void \
+gst_audio_channel_mixer_remap_##type##_##inlayout##_##outlayout ( \
+    GstAudioChannelMixer * mix, const type * in_data[], \
+    type * out_data[], gint samples) \
+{ \
+  gint out, n; \
+  gint inchannels, outchannels; \
+  \
+  inchannels = mix->in_channels; \
+  outchannels = mix->out_channels; \
+  \
+  for (n = 0; n < samples; n++) { \
+    for (out = 0; out < outchannels; out++) { \
+      gint in = mix->remap[out]; \
+      \
+      *_get_out_data_##outlayout##_##type (out_data, n, out, outchannels) = \
+          in < 0 ? 0 : \
+          _get_in_data_##inlayout##_##type (in_data, n, in, inchannels); \
+    } \
+  } \
+}
+
+/* the samples are only copied, F32 samples are remapped as gint32 */
+DEFINE_REMAP_FUNC (gint16, interleaved, interleaved);
+DEFINE_REMAP_FUNC (gint16, interleaved, planar);
+DEFINE_REMAP_FUNC (gint16, planar, interleaved);
+DEFINE_REMAP_FUNC (gint16, planar, planar);
+
+DEFINE_REMAP_FUNC (gint32, interleaved, interleaved);
+DEFINE_REMAP_FUNC (gint32, interleaved, planar);
+DEFINE_REMAP_FUNC (gint32, planar, interleaved);
+DEFINE_REMAP_FUNC (gint32, planar, planar);
+
+DEFINE_REMAP_FUNC (gdouble, interleaved, interleaved);
+DEFINE_REMAP_FUNC (gdouble, interleaved, planar);
+DEFINE_REMAP_FUNC (gdouble, planar, interleaved);
+DEFINE_REMAP_FUNC (gdouble, planar, planar);
+
+#define SELECT_REMAP_FUNC(mix, flags, type) G_STMT_START { \
+  if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_IN) { \
+    if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) \
+      mix->func = (MixerFunc) gst_audio_channel_mixer_remap_##type##_planar_planar; \
+    else \
+      mix->func = (MixerFunc) gst_audio_channel_mixer_remap_##type##_planar_interleaved; \
+  } else { \
+    if (flags & GST_AUDIO_CHANNEL_MIXER_FLAGS_NON_INTERLEAVED_OUT) \
+      mix->func = (MixerFunc) gst_audio_channel_mixer_remap_##type##_interleaved_planar; \
+    else \
+      mix->func = (MixerFunc) gst_audio_channel_mixer_remap_##type##_interleaved_interleaved; \
+  } \
+} G_STMT_END
+
 /**
  * gst_audio_channel_mixer_new_with_matrix: (skip):
  * @flags: #GstAudioChannelMixerFlags
@@ -857,6 +966,7 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
   }
 
   gst_audio_channel_mixer_setup_matrix_int (mix);
+  gst_audio_channel_mixer_setup_sparse (mix);
 
 #ifndef GST_DISABLE_GST_DEBUG
   /* debug */
@@ -966,6 +1076,24 @@ gst_audio_channel_mixer_new_with_matrix (GstAudioChannelMixerFlags flags,
       g_assert_not_reached ();
       break;
   }
+
+  if (mix->remap) {
+    GST_DEBUG ("matrix only remaps channels");
+    switch (format) {
+      case GST_AUDIO_FORMAT_S16:
+        SELECT_REMAP_FUNC (mix, flags, gint16);
+        break;
+      case GST_AUDIO_FORMAT_S32:
+      case GST_AUDIO_FORMAT_F32:
+        SELECT_REMAP_FUNC (mix, flags, gint32);
+        break;
+      case GST_AUDIO_FORMAT_F64:
+        SELECT_REMAP_FUNC (mix, flags, gdouble);
+        break;
+      default:
+        break;
+    }
+  }
   return mix;
 }
 
@@ -1073,3 +1201,20 @@ gst_audio_channel_mixer_samples (GstAudioChannelMixer * mix,
 
   mix->func (mix, in, out, samples);
 }
+
+/* Get the input channel that is copied to each output channel, or -1 for
+ * silent output channels. Returns %FALSE if @mix does more than copy
+ * channels. */
+gboolean
+__gst_audio_channel_mixer_get_remap (GstAudioChannelMixer * mix, gint * remap)
+{
+  g_return_val_if_fail (mix != NULL, FALSE);
+
+  if (mix->remap == NULL)
+    return FALSE;
+
+  if (remap)
+    memcpy (remap, mix->remap, sizeof (gint) * mix->out_channels);
+
+  return TRUE;
+}
@@ -29,6 +29,7 @@
 
 #include "audio-converter.h"
 #include "gstaudiopack.h"
+#include "gstaudioutilsprivate.h"
 
 /**
  * SECTION:gstaudioconverter
@@ -70,12 +71,17 @@ ensure_debug_category (void)
 
 typedef struct _AudioChain AudioChain;
 
+/* maximum number of channels for the one pass remap of converter_remap() */
+#define MAX_REMAP_CHANNELS 64
+
 typedef void (*AudioConvertFunc) (gpointer dst, const gpointer src, gint count);
 typedef gboolean (*AudioConvertSamplesFunc) (GstAudioConverter * convert,
     GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
     gpointer out[], gsize out_frames);
 typedef void (*AudioConvertEndianFunc) (gpointer dst, const gpointer src,
     gint count);
+typedef void (*AudioRemapFunc) (gpointer dst[], gint dst_stride,
+    const gpointer src[], const gint src_stride[], gint channels, gsize frames);
 
 /*                           int/int    int/float  float/int float/float
  *
@@ -132,6 +138,7 @@ struct _GstAudioConverter
 
   /* quant */
   GstAudioQuantize *quant;
+  gboolean quant_noise;         /* the quantizer dithers or shapes noise */
 
   /* change layout */
   GstAudioFormat chlayout_format;
@@ -145,6 +152,11 @@ struct _GstAudioConverter
   /* endian swap */
   AudioConvertEndianFunc swap_endian;
 
+  /* remap, the input channel of each output channel or -1. Only used up to
+   * MAX_REMAP_CHANNELS channels, more use the generic path */
+  gint remap[MAX_REMAP_CHANNELS];
+  AudioRemapFunc remap_func;
+
   AudioConvertSamplesFunc convert;
 };
 
@@ -991,6 +1003,8 @@ chain_quantize (GstAudioConverter * convert, AudioChain * prev)
     convert->quant =
         gst_audio_quantize_new (dither, ns, 0, convert->current_format,
         out->channels, 1U << (32 - out_depth));
+    convert->quant_noise = dither != GST_AUDIO_DITHER_NONE
+        || ns != GST_AUDIO_NOISE_SHAPING_NONE;
 
     prev = audio_chain_new (prev, convert);
     prev->allow_ip = TRUE;
@@ -1288,6 +1302,116 @@ converter_generic (GstAudioConverter * convert,
   return TRUE;
 }
 
+typedef struct
+{
+  guint8 s[3];
+} AudioSample24;
+
+#define REMAP_COPY(x) (x)
+#define REMAP_S32_TO_F32(x) ((gfloat) ((gdouble) (x) / 2147483648.0))
+#define REMAP_F32_TO_S32(x) remap_f32_to_s32 (x)
+
+/* same result as unpacking to F64 and audio_orc_double_to_s32 */
+static inline gint32
+remap_f32_to_s32 (gfloat x)
+{
+  gdouble d = (gdouble) x * 2147483648.0;
+
+  if (d >= 2147483647.0)
+    return G_MAXINT32;
+  if (d <= -2147483648.0)
+    return G_MININT32;
+  return (gint32) d;
+}
+
+/* the strides are in samples, a silent output channel reads the same
+ * sample over and over with a stride of 0 */
+#define MAKE_REMAP_FUNC(name, intype, outtype, conv) \
+static void \
+remap_##name (gpointer dst[], gint dst_stride, const gpointer src[], \
+    const gint src_stride[], gint channels, gsize frames) \
+{ \
+  gsize n; \
+  gint c; \
+  for (n = 0; n < frames; n++) { \
+    for (c = 0; c < channels; c++) { \
+      const intype *s = (const intype *) src[c] + n * src_stride[c]; \
+      outtype *d = (outtype *) dst[c] + n * dst_stride; \
+      *d = conv (*s); \
+    } \
+  } \
+}
+
+MAKE_REMAP_FUNC (8, guint8, guint8, REMAP_COPY);
+MAKE_REMAP_FUNC (16, guint16, guint16, REMAP_COPY);
+MAKE_REMAP_FUNC (24, AudioSample24, AudioSample24, REMAP_COPY);
+MAKE_REMAP_FUNC (32, guint32, guint32, REMAP_COPY);
+MAKE_REMAP_FUNC (64, guint64, guint64, REMAP_COPY);
+MAKE_REMAP_FUNC (s32_f32, gint32, gfloat, REMAP_S32_TO_F32);
+MAKE_REMAP_FUNC (f32_s32, gfloat, gint32, REMAP_F32_TO_S32);
+
+/* the worker function to copy or convert samples between two layouts while
+ * remapping channels in one pass, without mixing or resampling */
+static gboolean
+converter_remap (GstAudioConverter * convert,
+    GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
+    gpointer out[], gsize out_frames)
+{
+  gint c, idx, in_channels, out_channels, in_bps, out_bps;
+  gpointer src[MAX_REMAP_CHANNELS], dst[MAX_REMAP_CHANNELS];
+  gint src_stride[MAX_REMAP_CHANNELS], dst_stride;
+
+  if (out == NULL)
+    return TRUE;
+
+  in_channels = convert->in.channels;
+  out_channels = convert->out.channels;
+
+  GST_LOG ("remap: %" G_GSIZE_FORMAT " frames, %d -> %d channels", in_frames,
+      in_channels, out_channels);
+
+  if (in == NULL) {
+    if (convert->out.layout == GST_AUDIO_LAYOUT_INTERLEAVED) {
+      gst_audio_format_info_fill_silence (convert->out.finfo, out[0],
+          in_frames * convert->out.bpf);
+    } else {
+      for (c = 0; c < out_channels; c++)
+        gst_audio_format_info_fill_silence (convert->out.finfo, out[c],
+            in_frames * (convert->out.bpf / out_channels));
+    }
+    return TRUE;
+  }
+
+  in_bps = convert->in.bpf / in_channels;
+  out_bps = convert->out.bpf / out_channels;
+
+  for (c = 0; c < out_channels; c++) {
+    idx = convert->remap[c];
+    if (idx < 0) {
+      src[c] = (gpointer) convert->in.finfo->silence;
+      src_stride[c] = 0;
+    } else if (convert->in.layout == GST_AUDIO_LAYOUT_INTERLEAVED) {
+      src[c] = (guint8 *) in[0] + idx * in_bps;
+      src_stride[c] = in_channels;
+    } else {
+      src[c] = in[idx];
+      src_stride[c] = 1;
+    }
+
+    if (convert->out.layout == GST_AUDIO_LAYOUT_INTERLEAVED)
+      dst[c] = (guint8 *) out[0] + c * out_bps;
+    else
+      dst[c] = out[c];
+  }
+  dst_stride =
+      convert->out.layout == GST_AUDIO_LAYOUT_INTERLEAVED ? out_channels : 1;
+
+  convert->remap_func (dst, dst_stride, (const gpointer *) src, src_stride,
+      out_channels, in_frames);
+
+  return TRUE;
+}
+
 static gboolean
 converter_resample (GstAudioConverter * convert,
     GstAudioConverterFlags flags, gpointer in[], gsize in_frames,
@@ -1299,6 +1423,57 @@ converter_resample (GstAudioConverter * convert,
   return TRUE;
 }
 
+/* check if the conversion only copies or converts samples to other
+ * channels and another layout, that can be done in one pass */
+static AudioRemapFunc
+get_remap_func (GstAudioConverter * convert)
+{
+  const GstAudioFormatInfo *in_finfo = convert->in.finfo;
+  const GstAudioFormatInfo *out_finfo = convert->out.finfo;
+  gint c;
+
+  if (convert->resampler != NULL || convert->quant_noise)
+    return NULL;
+
+  /* the remap tables are fixed size */
+  if (convert->in.channels > MAX_REMAP_CHANNELS ||
+      convert->out.channels > MAX_REMAP_CHANNELS)
+    return NULL;
+
+  if (convert->mix_passthrough) {
+    for (c = 0; c < convert->out.channels; c++)
+      convert->remap[c] = c;
+  } else if (!__gst_audio_channel_mixer_get_remap (convert->mix,
+          convert->remap)) {
+    return NULL;
+  }
+
+  if (in_finfo->format == out_finfo->format) {
+    switch (GST_AUDIO_FORMAT_INFO_WIDTH (in_finfo)) {
+      case 8:
+        return remap_8;
+      case 16:
+        return remap_16;
+      case 24:
+        return remap_24;
+      case 32:
+        return remap_32;
+      case 64:
+        return remap_64;
+      default:
+        return NULL;
+    }
+  }
+  if (in_finfo->format == GST_AUDIO_FORMAT_S32
+      && out_finfo->format == GST_AUDIO_FORMAT_F32)
+    return remap_s32_f32;
+  if (in_finfo->format == GST_AUDIO_FORMAT_F32
+      && out_finfo->format == GST_AUDIO_FORMAT_S32)
+    return remap_f32_s32;
+
+  return NULL;
+}
+
 #define GST_AUDIO_FORMAT_IS_ENDIAN_CONVERSION(info1, info2) \
 		( \
 			!(((info1)->flags ^ (info2)->flags) & (~GST_AUDIO_FORMAT_FLAG_UNPACK)) && \
@@ -1430,6 +1605,12 @@ gst_audio_converter_new (GstAudioConverterFlags flags, GstAudioInfo * in_info,
     }
   }
 
+  if (convert->convert == converter_generic
+      && (convert->remap_func = get_remap_func (convert))) {
+    GST_INFO ("no resampler, only remapping channels -> one pass remap");
+    convert->convert = converter_remap;
+  }
+
   setup_allocators (convert);
 
   return convert;
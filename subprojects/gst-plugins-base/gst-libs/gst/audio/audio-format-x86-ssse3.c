@@ -0,0 +1,127 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-format-x86-ssse3.h"
+
+#if defined (HAVE_TMMINTRIN_H) && defined (__SSSE3__)
+
+#include <tmmintrin.h>
+
+/* Unpacking places the 3 bytes of each sample in the upper 3 bytes of a
+ * 32 bit lane, which is the sample shifted left by 8. Packing does the
+ * reverse after shifting the lanes right by (scale - 8). */
+static const gint8 unpack_le[16] = {
+  -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11
+};
+
+static const gint8 unpack_be[16] = {
+  -1, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9
+};
+
+static const gint8 pack_le[16] = {
+  1, 2, 3, 5, 6, 7, 9, 10, 11, 13, 14, 15, -1, -1, -1, -1
+};
+
+static const gint8 pack_be[16] = {
+  3, 2, 1, 7, 6, 5, 11, 10, 9, 15, 14, 13, -1, -1, -1, -1
+};
+
+gint
+audio_format_unpack_24_ssse3 (guint32 * d, const guint8 * s, gint length,
+    gboolean be, guint scale, guint32 sign)
+{
+  const __m128i mask =
+      _mm_loadu_si128 ((const __m128i *) (be ? unpack_be : unpack_le));
+  const __m128i shift = _mm_cvtsi32_si128 (scale - 8);
+  const __m128i sgn = _mm_set1_epi32 (sign);
+  __m128i a, b, c, t0, t1, t2, t3;
+  gint i;
+
+  for (i = 0; i + 16 <= length; i += 16) {
+    a = _mm_loadu_si128 ((const __m128i *) (s + 0));
+    b = _mm_loadu_si128 ((const __m128i *) (s + 16));
+    c = _mm_loadu_si128 ((const __m128i *) (s + 32));
+
+    /* 4 samples are in bytes 0-11, 12-23, 24-35 and 36-47 */
+    t0 = _mm_shuffle_epi8 (a, mask);
+    t1 = _mm_shuffle_epi8 (_mm_alignr_epi8 (b, a, 12), mask);
+    t2 = _mm_shuffle_epi8 (_mm_alignr_epi8 (c, b, 8), mask);
+    t3 = _mm_shuffle_epi8 (_mm_srli_si128 (c, 4), mask);
+
+    t0 = _mm_xor_si128 (_mm_sll_epi32 (t0, shift), sgn);
+    t1 = _mm_xor_si128 (_mm_sll_epi32 (t1, shift), sgn);
+    t2 = _mm_xor_si128 (_mm_sll_epi32 (t2, shift), sgn);
+    t3 = _mm_xor_si128 (_mm_sll_epi32 (t3, shift), sgn);
+
+    _mm_storeu_si128 ((__m128i *) (d + 0), t0);
+    _mm_storeu_si128 ((__m128i *) (d + 4), t1);
+    _mm_storeu_si128 ((__m128i *) (d + 8), t2);
+    _mm_storeu_si128 ((__m128i *) (d + 12), t3);
+
+    s += 48;
+    d += 16;
+  }
+  return i;
+}
+
+gint
+audio_format_pack_24_ssse3 (guint8 * d, const guint32 * s, gint length,
+    gboolean be, guint scale, guint32 sign)
+{
+  const __m128i mask =
+      _mm_loadu_si128 ((const __m128i *) (be ? pack_be : pack_le));
+  const __m128i shift = _mm_cvtsi32_si128 (scale - 8);
+  const __m128i sgn = _mm_set1_epi32 (sign);
+  __m128i t0, t1, t2, t3;
+  gint i;
+
+  for (i = 0; i + 16 <= length; i += 16) {
+    t0 = _mm_loadu_si128 ((const __m128i *) (s + 0));
+    t1 = _mm_loadu_si128 ((const __m128i *) (s + 4));
+    t2 = _mm_loadu_si128 ((const __m128i *) (s + 8));
+    t3 = _mm_loadu_si128 ((const __m128i *) (s + 12));
+
+    t0 = _mm_shuffle_epi8 (_mm_srl_epi32 (_mm_xor_si128 (t0, sgn), shift),
+        mask);
+    t1 = _mm_shuffle_epi8 (_mm_srl_epi32 (_mm_xor_si128 (t1, sgn), shift),
+        mask);
+    t2 = _mm_shuffle_epi8 (_mm_srl_epi32 (_mm_xor_si128 (t2, sgn), shift),
+        mask);
+    t3 = _mm_shuffle_epi8 (_mm_srl_epi32 (_mm_xor_si128 (t3, sgn), shift),
+        mask);
+
+    /* each register now has 12 bytes, merge them into 48 output bytes */
+    _mm_storeu_si128 ((__m128i *) (d + 0),
+        _mm_or_si128 (t0, _mm_slli_si128 (t1, 12)));
+    _mm_storeu_si128 ((__m128i *) (d + 16),
+        _mm_or_si128 (_mm_srli_si128 (t1, 4), _mm_slli_si128 (t2, 8)));
+    _mm_storeu_si128 ((__m128i *) (d + 32),
+        _mm_or_si128 (_mm_srli_si128 (t2, 8), _mm_slli_si128 (t3, 4)));
+
+    s += 16;
+    d += 48;
+  }
+  return i;
+}
+
+#endif
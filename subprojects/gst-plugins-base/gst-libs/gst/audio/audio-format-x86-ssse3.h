@@ -0,0 +1,34 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef AUDIO_FORMAT_X86_SSSE3_H
+#define AUDIO_FORMAT_X86_SSSE3_H
+
+#include <glib.h>
+
+/* Both functions handle the samples in blocks of 16 and return the number of
+ * samples that were processed, the remaining ones are left to the caller */
+G_GNUC_INTERNAL
+gint audio_format_unpack_24_ssse3 (guint32 * d, const guint8 * s, gint length,
+    gboolean be, guint scale, guint32 sign);
+
+G_GNUC_INTERNAL
+gint audio_format_pack_24_ssse3 (guint8 * d, const guint32 * s, gint length,
+    gboolean be, guint scale, guint32 sign);
+
+#endif /* AUDIO_FORMAT_X86_SSSE3_H */
@@ -27,6 +27,14 @@
 
 #include "gstaudiopack.h"
 
+#if defined (HAVE_SSSE3) && defined (__x86_64__) && defined (__GNUC__)
+#include "audio-format-x86-ssse3.h"
+#define AUDIO_FORMAT_SSSE3 1
+#elif G_BYTE_ORDER == G_LITTLE_ENDIAN && defined (__ARM_NEON)
+#include <arm_neon.h>
+#define AUDIO_FORMAT_NEON 1
+#endif
+
 #ifdef HAVE_ORC
 #include <orc/orcfunctions.h>
 #else
@@ -153,60 +161,161 @@ MAKE_ORC_PACK_UNPACK (s8, s8_trunc)
 #define PACK_U32BE GST_AUDIO_FORMAT_S32, unpack_u32be, pack_u32be
     MAKE_ORC_PACK_UNPACK (u32be, u32be)
 #define SIGNED  (1U<<31)
-/* pack from signed integer 32 to integer */
-#define WRITE24_TO_LE(p,v) p[0] = v & 0xff; p[1] = (v >> 8) & 0xff; p[2] = (v >> 16) & 0xff
-#define WRITE24_TO_BE(p,v) p[2] = v & 0xff; p[1] = (v >> 8) & 0xff; p[0] = (v >> 16) & 0xff
-#define READ24_FROM_LE(p) (p[0] | (p[1] << 8) | (p[2] << 16))
-#define READ24_FROM_BE(p) (p[2] | (p[1] << 8) | (p[0] << 16))
-#define MAKE_PACK_UNPACK(name, stride, sign, scale, READ_FUNC, WRITE_FUNC)     \
+/* The packed 24 bit formats. The samples are unpacked to the upper bits of a
+ * signed 32 bit integer, shifted left by @scale and xor-ed with @sign to
+ * handle the unsigned formats. SSSE3 (selected at runtime) and NEON versions
+ * handle blocks of 16 samples, the remainder is done here. */
+static gint (*audio_format_unpack_24_simd) (guint32 * d, const guint8 * s,
+    gint length, gboolean be, guint scale, guint32 sign);
+static gint (*audio_format_pack_24_simd) (guint8 * d, const guint32 * s,
+    gint length, gboolean be, guint scale, guint32 sign);
+
+static void
+audio_format_init_simd (void)
+{
+  static gsize init_gonce = 0;
+
+  if (g_once_init_enter (&init_gonce)) {
+#if defined (AUDIO_FORMAT_SSSE3)
+    __builtin_cpu_init ();
+    if (__builtin_cpu_supports ("ssse3")) {
+      audio_format_unpack_24_simd = audio_format_unpack_24_ssse3;
+      audio_format_pack_24_simd = audio_format_pack_24_ssse3;
+    }
+#endif
+    g_once_init_leave (&init_gonce, 1);
+  }
+}
+
+static void
+audio_format_unpack_24 (guint32 * d, const guint8 * s, gint length,
+    gboolean be, guint scale, guint32 sign)
+{
+  gint i = 0;
+
+#if defined (AUDIO_FORMAT_NEON)
+  {
+    const int32x4_t shift = vdupq_n_s32 (scale - 8);
+    const uint32x4_t sgn = vdupq_n_u32 (sign);
+    uint8x16x3_t in;
+    uint8x16x4_t out;
+    gint j;
+
+    out.val[0] = vdupq_n_u8 (0);
+    for (; i + 16 <= length; i += 16) {
+      in = vld3q_u8 (s + 3 * i);
+      out.val[1] = be ? in.val[2] : in.val[0];
+      out.val[2] = in.val[1];
+      out.val[3] = be ? in.val[0] : in.val[2];
+      vst4q_u8 ((guint8 *) (d + i), out);
+
+      if (scale != 8 || sign) {
+        for (j = 0; j < 16; j += 4)
+          vst1q_u32 (d + i + j,
+              veorq_u32 (vshlq_u32 (vld1q_u32 (d + i + j), shift), sgn));
+      }
+    }
+  }
+#else
+  if (audio_format_unpack_24_simd)
+    i = audio_format_unpack_24_simd (d, s, length, be, scale, sign);
+#endif
+
+  s += 3 * i;
+  if (be) {
+    for (; i < length; i++, s += 3)
+      d[i] = (((gint32) (s[2] | (s[1] << 8) | (s[0] << 16))) << scale) ^ sign;
+  } else {
+    for (; i < length; i++, s += 3)
+      d[i] = (((gint32) (s[0] | (s[1] << 8) | (s[2] << 16))) << scale) ^ sign;
+  }
+}
+
+static void
+audio_format_pack_24 (guint8 * d, const guint32 * s, gint length,
+    gboolean be, guint scale, guint32 sign)
+{
+  gint32 tmp;
+  gint i = 0;
+
+#if defined (AUDIO_FORMAT_NEON)
+  {
+    const int32x4_t shift = vdupq_n_s32 (8 - (gint) scale);
+    const uint32x4_t sgn = vdupq_n_u32 (sign);
+    guint32 t[16];
+    uint8x16x4_t in;
+    uint8x16x3_t out;
+    gint j;
+
+    for (; i + 16 <= length; i += 16) {
+      for (j = 0; j < 16; j += 4)
+        vst1q_u32 (t + j,
+            vshlq_u32 (veorq_u32 (vld1q_u32 (s + i + j), sgn), shift));
+
+      in = vld4q_u8 ((const guint8 *) t);
+      out.val[0] = be ? in.val[3] : in.val[1];
+      out.val[1] = in.val[2];
+      out.val[2] = be ? in.val[1] : in.val[3];
+      vst3q_u8 (d + 3 * i, out);
+    }
+  }
+#else
+  if (audio_format_pack_24_simd)
+    i = audio_format_pack_24_simd (d, s, length, be, scale, sign);
+#endif
+
+  d += 3 * i;
+  for (; i < length; i++, d += 3) {
+    tmp = (s[i] ^ sign) >> scale;
+    if (be) {
+      d[2] = tmp & 0xff;
+      d[1] = (tmp >> 8) & 0xff;
+      d[0] = (tmp >> 16) & 0xff;
+    } else {
+      d[0] = tmp & 0xff;
+      d[1] = (tmp >> 8) & 0xff;
+      d[2] = (tmp >> 16) & 0xff;
+    }
+  }
+}
+
+#define MAKE_PACK_UNPACK(name, sign, scale, be)                         \
 static void unpack_ ##name (const GstAudioFormatInfo *info,             \
     GstAudioPackFlags flags, gpointer dest,                             \
     gconstpointer data, gint length)                                    \
 {                                                                       \
-  guint32 *d = dest;                                                    \
-  const guint8 *s = data;                                               \
-  for (;length; length--) {                                             \
-    *d++ = (((gint32) READ_FUNC (s)) << scale) ^ (sign);                \
-    s += stride;                                                        \
-  }                                                                     \
+  audio_format_unpack_24 (dest, data, length, be, scale, sign);         \
 }                                                                       \
 static void pack_ ##name (const GstAudioFormatInfo *info,               \
     GstAudioPackFlags flags, gconstpointer src,                         \
     gpointer data, gint length)                                         \
 {                                                                       \
-  gint32 tmp;                                                           \
-  const guint32 *s = src;                                               \
-  guint8 *d = data;                                                     \
-  for (;length; length--) {                                             \
-    tmp = (*s++ ^ (sign)) >> scale;                                     \
-    WRITE_FUNC (d, tmp);                                                \
-    d += stride;                                                        \
-  }                                                                     \
+  audio_format_pack_24 (data, src, length, be, scale, sign);            \
 }
 #define PACK_S24LE GST_AUDIO_FORMAT_S32, unpack_s24le, pack_s24le
-    MAKE_PACK_UNPACK (s24le, 3, 0, 8, READ24_FROM_LE, WRITE24_TO_LE)
+    MAKE_PACK_UNPACK (s24le, 0, 8, FALSE)
 #define PACK_U24LE GST_AUDIO_FORMAT_S32, unpack_u24le, pack_u24le
-    MAKE_PACK_UNPACK (u24le, 3, SIGNED, 8, READ24_FROM_LE, WRITE24_TO_LE)
+    MAKE_PACK_UNPACK (u24le, SIGNED, 8, FALSE)
 #define PACK_S24BE GST_AUDIO_FORMAT_S32, unpack_s24be, pack_s24be
-    MAKE_PACK_UNPACK (s24be, 3, 0, 8, READ24_FROM_BE, WRITE24_TO_BE)
+    MAKE_PACK_UNPACK (s24be, 0, 8, TRUE)
 #define PACK_U24BE GST_AUDIO_FORMAT_S32, unpack_u24be, pack_u24be
-    MAKE_PACK_UNPACK (u24be, 3, SIGNED, 8, READ24_FROM_BE, WRITE24_TO_BE)
+    MAKE_PACK_UNPACK (u24be, SIGNED, 8, TRUE)
 #define PACK_S20LE GST_AUDIO_FORMAT_S32, unpack_s20le, pack_s20le
-    MAKE_PACK_UNPACK (s20le, 3, 0, 12, READ24_FROM_LE, WRITE24_TO_LE)
+    MAKE_PACK_UNPACK (s20le, 0, 12, FALSE)
 #define PACK_U20LE GST_AUDIO_FORMAT_S32, unpack_u20le, pack_u20le
-    MAKE_PACK_UNPACK (u20le, 3, SIGNED, 12, READ24_FROM_LE, WRITE24_TO_LE)
+    MAKE_PACK_UNPACK (u20le, SIGNED, 12, FALSE)
 #define PACK_S20BE GST_AUDIO_FORMAT_S32, unpack_s20be, pack_s20be
-    MAKE_PACK_UNPACK (s20be, 3, 0, 12, READ24_FROM_BE, WRITE24_TO_BE)
+    MAKE_PACK_UNPACK (s20be, 0, 12, TRUE)
 #define PACK_U20BE GST_AUDIO_FORMAT_S32, unpack_u20be, pack_u20be
-    MAKE_PACK_UNPACK (u20be, 3, SIGNED, 12, READ24_FROM_BE, WRITE24_TO_BE)
+    MAKE_PACK_UNPACK (u20be, SIGNED, 12, TRUE)
 #define PACK_S18LE GST_AUDIO_FORMAT_S32, unpack_s18le, pack_s18le
-    MAKE_PACK_UNPACK (s18le, 3, 0, 14, READ24_FROM_LE, WRITE24_TO_LE)
+    MAKE_PACK_UNPACK (s18le, 0, 14, FALSE)
 #define PACK_U18LE GST_AUDIO_FORMAT_S32, unpack_u18le, pack_u18le
-    MAKE_PACK_UNPACK (u18le, 3, SIGNED, 14, READ24_FROM_LE, WRITE24_TO_LE)
+    MAKE_PACK_UNPACK (u18le, SIGNED, 14, FALSE)
 #define PACK_S18BE GST_AUDIO_FORMAT_S32, unpack_s18be, pack_s18be
-    MAKE_PACK_UNPACK (s18be, 3, 0, 14, READ24_FROM_BE, WRITE24_TO_BE)
+    MAKE_PACK_UNPACK (s18be, 0, 14, TRUE)
 #define PACK_U18BE GST_AUDIO_FORMAT_S32, unpack_u18be, pack_u18be
-    MAKE_PACK_UNPACK (u18be, 3, SIGNED, 14, READ24_FROM_BE, WRITE24_TO_BE)
+    MAKE_PACK_UNPACK (u18be, SIGNED, 14, TRUE)
 #define PACK_F32LE GST_AUDIO_FORMAT_F64, unpack_f32le, pack_f32le
     MAKE_ORC_PACK_UNPACK (f32le, f32le)
 #define PACK_F32BE GST_AUDIO_FORMAT_F64, unpack_f32be, pack_f32be
@@ -448,6 +557,8 @@ gst_audio_format_get_info (GstAudioFormat format)
 {
   g_return_val_if_fail ((gint) format < G_N_ELEMENTS (formats), NULL);
 
+  audio_format_init_simd ();
+
   return &formats[format];
 }
 
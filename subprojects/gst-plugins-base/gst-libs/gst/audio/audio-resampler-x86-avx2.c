@@ -0,0 +1,560 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx2.h"
+
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && \
+    defined (__AVX2__) && defined (__FMA__)
+
+#include <immintrin.h>
+
+/* The taps are only 16 byte aligned, use unaligned loads everywhere. Like
+ * the SSE versions, the loops may read past @len into the zero padded taps
+ * (TAPS_OVERREAD) but never more than 16 samples. */
+
+static inline __m128i
+reduce_epi32_avx2 (__m256i v)
+{
+  return _mm_add_epi32 (_mm256_castsi256_si128 (v),
+      _mm256_extracti128_si256 (v, 1));
+}
+
+static inline __m128i
+reduce_epi64_avx2 (__m256i v)
+{
+  return _mm_add_epi64 (_mm256_castsi256_si128 (v),
+      _mm256_extracti128_si256 (v, 1));
+}
+
+static inline __m128
+reduce_ps_avx2 (__m256 v)
+{
+  __m128 t;
+
+  t = _mm_add_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+  t = _mm_add_ps (t, _mm_movehl_ps (t, t));
+  return _mm_add_ss (t, _mm_shuffle_ps (t, t, 0x55));
+}
+
+static inline __m128d
+reduce_pd_avx2 (__m256d v)
+{
+  __m128d t;
+
+  t = _mm_add_pd (_mm256_castpd256_pd128 (v), _mm256_extractf128_pd (v, 1));
+  return _mm_add_sd (t, _mm_unpackhi_pd (t, t));
+}
+
+static inline __m256i
+madd_epi32_avx2 (__m256i sum, __m256i ta, __m256i tb)
+{
+  sum = _mm256_add_epi64 (sum,
+      _mm256_mul_epi32 (_mm256_unpacklo_epi32 (ta, ta),
+          _mm256_unpacklo_epi32 (tb, tb)));
+  return _mm256_add_epi64 (sum,
+      _mm256_mul_epi32 (_mm256_unpackhi_epi32 (ta, ta),
+          _mm256_unpackhi_epi32 (tb, tb)));
+}
+
+static inline void
+inner_product_gint16_full_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum256 = _mm256_setzero_si256 ();
+  __m128i sum;
+
+  for (i = 0; i < len; i += 16) {
+    sum256 = _mm256_add_epi32 (sum256,
+        _mm256_madd_epi16 (_mm256_loadu_si256 ((__m256i *) (a + i)),
+            _mm256_loadu_si256 ((__m256i *) (b + i))));
+  }
+  sum = reduce_epi32_avx2 (sum256);
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, _MM_SHUFFLE (2, 3, 2, 3)));
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, _MM_SHUFFLE (1, 1, 1, 1)));
+
+  sum = _mm_add_epi32 (sum, _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum = _mm_srai_epi32 (sum, PRECISION_S16);
+  sum = _mm_packs_epi32 (sum, sum);
+  *o = _mm_extract_epi16 (sum, 0);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum256[2], t;
+  __m128i sum[2];
+  __m128i f = _mm_set_epi64x (0, *((gint64 *) icoeff));
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum256[0] = sum256[1] = _mm256_setzero_si256 ();
+  f = _mm_unpacklo_epi16 (f, _mm_setzero_si128 ());
+
+  for (i = 0; i < len; i += 16) {
+    t = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum256[0] = _mm256_add_epi32 (sum256[0], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum256[1] = _mm256_add_epi32 (sum256[1], _mm256_madd_epi16 (t,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+  }
+  sum[0] = _mm_srai_epi32 (reduce_epi32_avx2 (sum256[0]), PRECISION_S16);
+  sum[1] = _mm_srai_epi32 (reduce_epi32_avx2 (sum256[1]), PRECISION_S16);
+
+  sum[0] =
+      _mm_madd_epi16 (sum[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  sum[1] =
+      _mm_madd_epi16 (sum[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  sum[0] = _mm_add_epi32 (sum[0], sum[1]);
+
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (2, 3, 2,
+              3)));
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (1, 1, 1,
+              1)));
+
+  sum[0] = _mm_add_epi32 (sum[0], _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_packs_epi32 (sum[0], sum[0]);
+  *o = _mm_extract_epi16 (sum[0], 0);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx2 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum256[4], ta;
+  __m128i sum[4], t[4];
+  __m128i f = _mm_set_epi64x (0, *((long long *) icoeff));
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum256[0] = sum256[1] = sum256[2] = sum256[3] = _mm256_setzero_si256 ();
+  f = _mm_unpacklo_epi16 (f, _mm_setzero_si128 ());
+
+  for (i = 0; i < len; i += 16) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum256[0] = _mm256_add_epi32 (sum256[0], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[0] + i))));
+    sum256[1] = _mm256_add_epi32 (sum256[1], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[1] + i))));
+    sum256[2] = _mm256_add_epi32 (sum256[2], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[2] + i))));
+    sum256[3] = _mm256_add_epi32 (sum256[3], _mm256_madd_epi16 (ta,
+            _mm256_loadu_si256 ((__m256i *) (c[3] + i))));
+  }
+  sum[0] = reduce_epi32_avx2 (sum256[0]);
+  sum[1] = reduce_epi32_avx2 (sum256[1]);
+  sum[2] = reduce_epi32_avx2 (sum256[2]);
+  sum[3] = reduce_epi32_avx2 (sum256[3]);
+
+  t[0] = _mm_unpacklo_epi32 (sum[0], sum[1]);
+  t[1] = _mm_unpacklo_epi32 (sum[2], sum[3]);
+  t[2] = _mm_unpackhi_epi32 (sum[0], sum[1]);
+  t[3] = _mm_unpackhi_epi32 (sum[2], sum[3]);
+
+  sum[0] =
+      _mm_add_epi32 (_mm_unpacklo_epi64 (t[0], t[1]), _mm_unpackhi_epi64 (t[0],
+          t[1]));
+  sum[2] =
+      _mm_add_epi32 (_mm_unpacklo_epi64 (t[2], t[3]), _mm_unpackhi_epi64 (t[2],
+          t[3]));
+  sum[0] = _mm_add_epi32 (sum[0], sum[2]);
+
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_madd_epi16 (sum[0], f);
+
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (2, 3, 2,
+              3)));
+  sum[0] =
+      _mm_add_epi32 (sum[0], _mm_shuffle_epi32 (sum[0], _MM_SHUFFLE (1, 1, 1,
+              1)));
+
+  sum[0] = _mm_add_epi32 (sum[0], _mm_set1_epi32 (1 << (PRECISION_S16 - 1)));
+  sum[0] = _mm_srai_epi32 (sum[0], PRECISION_S16);
+  sum[0] = _mm_packs_epi32 (sum[0], sum[0]);
+  *o = _mm_extract_epi16 (sum[0], 0);
+}
+
+static inline void
+inner_product_gint32_full_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  __m256i sum256 = _mm256_setzero_si256 ();
+  __m128i sum;
+  gint64 res;
+
+  for (i = 0; i < len; i += 8) {
+    sum256 = madd_epi32_avx2 (sum256,
+        _mm256_loadu_si256 ((__m256i *) (a + i)),
+        _mm256_loadu_si256 ((__m256i *) (b + i)));
+  }
+  sum = reduce_epi64_avx2 (sum256);
+  sum = _mm_add_epi64 (sum, _mm_unpackhi_epi64 (sum, sum));
+  res = _mm_cvtsi128_si64 (sum);
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_linear_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m256i sum256[2], ta;
+  __m128i sum[2];
+  __m128i f = _mm_loadu_si128 ((__m128i *) icoeff);
+  const gint32 *c[2] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum256[0] = sum256[1] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum256[0] = madd_epi32_avx2 (sum256[0], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[0] + i)));
+    sum256[1] = madd_epi32_avx2 (sum256[1], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[1] + i)));
+  }
+  sum[0] = _mm_srli_epi64 (reduce_epi64_avx2 (sum256[0]), PRECISION_S32);
+  sum[1] = _mm_srli_epi64 (reduce_epi64_avx2 (sum256[1]), PRECISION_S32);
+  sum[0] =
+      _mm_mul_epi32 (sum[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  sum[1] =
+      _mm_mul_epi32 (sum[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  sum[0] = _mm_add_epi64 (sum[0], sum[1]);
+  sum[0] = _mm_add_epi64 (sum[0], _mm_unpackhi_epi64 (sum[0], sum[0]));
+  res = _mm_cvtsi128_si64 (sum[0]);
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_cubic_1_avx2 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __m256i sum256[4], ta;
+  __m128i sum[4];
+  __m128i f = _mm_loadu_si128 ((__m128i *) icoeff);
+  const gint32 *c[4] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride),
+    (gint32 *) ((gint8 *) b + 2 * bstride),
+    (gint32 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum256[0] = sum256[1] = sum256[2] = sum256[3] = _mm256_setzero_si256 ();
+
+  for (i = 0; i < len; i += 8) {
+    ta = _mm256_loadu_si256 ((__m256i *) (a + i));
+    sum256[0] = madd_epi32_avx2 (sum256[0], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[0] + i)));
+    sum256[1] = madd_epi32_avx2 (sum256[1], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[1] + i)));
+    sum256[2] = madd_epi32_avx2 (sum256[2], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[2] + i)));
+    sum256[3] = madd_epi32_avx2 (sum256[3], ta,
+        _mm256_loadu_si256 ((__m256i *) (c[3] + i)));
+  }
+  sum[0] = _mm_srli_epi64 (reduce_epi64_avx2 (sum256[0]), PRECISION_S32);
+  sum[1] = _mm_srli_epi64 (reduce_epi64_avx2 (sum256[1]), PRECISION_S32);
+  sum[2] = _mm_srli_epi64 (reduce_epi64_avx2 (sum256[2]), PRECISION_S32);
+  sum[3] = _mm_srli_epi64 (reduce_epi64_avx2 (sum256[3]), PRECISION_S32);
+  sum[0] =
+      _mm_mul_epi32 (sum[0], _mm_shuffle_epi32 (f, _MM_SHUFFLE (0, 0, 0, 0)));
+  sum[1] =
+      _mm_mul_epi32 (sum[1], _mm_shuffle_epi32 (f, _MM_SHUFFLE (1, 1, 1, 1)));
+  sum[2] =
+      _mm_mul_epi32 (sum[2], _mm_shuffle_epi32 (f, _MM_SHUFFLE (2, 2, 2, 2)));
+  sum[3] =
+      _mm_mul_epi32 (sum[3], _mm_shuffle_epi32 (f, _MM_SHUFFLE (3, 3, 3, 3)));
+  sum[0] = _mm_add_epi64 (sum[0], sum[1]);
+  sum[2] = _mm_add_epi64 (sum[2], sum[3]);
+  sum[0] = _mm_add_epi64 (sum[0], sum[2]);
+  sum[0] = _mm_add_epi64 (sum[0], _mm_unpackhi_epi64 (sum[0], sum[0]));
+  res = _mm_cvtsi128_si64 (sum[0]);
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gfloat_full_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8)
+    sum = _mm256_fmadd_ps (_mm256_loadu_ps (a + i), _mm256_loadu_ps (b + i),
+        sum);
+
+  _mm_store_ss (o, reduce_ps_avx2 (sum));
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_ps (_mm256_sub_ps (sum[0], sum[1]),
+      _mm256_broadcast_ss (icoeff), sum[1]);
+
+  _mm_store_ss (o, reduce_ps_avx2 (sum[0]));
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx2 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __m256 sum[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_ps ();
+
+  for (i = 0; i < len; i += 8) {
+    t = _mm256_loadu_ps (a + i);
+    sum[0] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_ps (t, _mm256_loadu_ps (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_ps (sum[0], _mm256_broadcast_ss (icoeff + 0));
+  sum[0] = _mm256_fmadd_ps (sum[1], _mm256_broadcast_ss (icoeff + 1), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[2], _mm256_broadcast_ss (icoeff + 2), sum[0]);
+  sum[0] = _mm256_fmadd_ps (sum[3], _mm256_broadcast_ss (icoeff + 3), sum[0]);
+
+  _mm_store_ss (o, reduce_ps_avx2 (sum[0]));
+}
+
+static inline void
+inner_product_gdouble_full_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 4)
+    sum = _mm256_fmadd_pd (_mm256_loadu_pd (a + i), _mm256_loadu_pd (b + i),
+        sum);
+
+  _mm_store_sd (o, reduce_pd_avx2 (sum));
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[2], t;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+  }
+  sum[0] = _mm256_fmadd_pd (_mm256_sub_pd (sum[0], sum[1]),
+      _mm256_broadcast_sd (icoeff), sum[1]);
+
+  _mm_store_sd (o, reduce_pd_avx2 (sum[0]));
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx2 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __m256d sum[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm256_setzero_pd ();
+
+  for (i = 0; i < len; i += 4) {
+    t = _mm256_loadu_pd (a + i);
+    sum[0] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[0] + i), sum[0]);
+    sum[1] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[1] + i), sum[1]);
+    sum[2] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[2] + i), sum[2]);
+    sum[3] = _mm256_fmadd_pd (t, _mm256_loadu_pd (c[3] + i), sum[3]);
+  }
+  sum[0] = _mm256_mul_pd (sum[0], _mm256_broadcast_sd (icoeff + 0));
+  sum[0] = _mm256_fmadd_pd (sum[1], _mm256_broadcast_sd (icoeff + 1), sum[0]);
+  sum[0] = _mm256_fmadd_pd (sum[2], _mm256_broadcast_sd (icoeff + 2), sum[0]);
+  sum[0] = _mm256_fmadd_pd (sum[3], _mm256_broadcast_sd (icoeff + 3), sum[0]);
+
+  _mm_store_sd (o, reduce_pd_avx2 (sum[0]));
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gint32, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gint32, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx2);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx2);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx2);
+
+void
+interpolate_gfloat_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[2];
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm256_broadcast_ss (ic + 0);
+  f[1] = _mm256_broadcast_ss (ic + 1);
+
+  for (i = 0; i < len; i += 8) {
+    _mm256_storeu_ps (o + i,
+        _mm256_fmadd_ps (_mm256_loadu_ps (c[1] + i), f[1],
+            _mm256_mul_ps (_mm256_loadu_ps (c[0] + i), f[0])));
+  }
+}
+
+void
+interpolate_gfloat_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m256 f[4], t[2];
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride),
+    (gfloat *) ((gint8 *) a + 2 * astride),
+    (gfloat *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_broadcast_ss (ic + 0);
+  f[1] = _mm256_broadcast_ss (ic + 1);
+  f[2] = _mm256_broadcast_ss (ic + 2);
+  f[3] = _mm256_broadcast_ss (ic + 3);
+
+  for (i = 0; i < len; i += 8) {
+    t[0] = _mm256_mul_ps (_mm256_loadu_ps (c[0] + i), f[0]);
+    t[1] = _mm256_mul_ps (_mm256_loadu_ps (c[2] + i), f[2]);
+    t[0] = _mm256_fmadd_ps (_mm256_loadu_ps (c[1] + i), f[1], t[0]);
+    t[1] = _mm256_fmadd_ps (_mm256_loadu_ps (c[3] + i), f[3], t[1]);
+    _mm256_storeu_ps (o + i, _mm256_add_ps (t[0], t[1]));
+  }
+}
+
+void
+interpolate_gdouble_linear_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[2];
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm256_broadcast_sd (ic + 0);
+  f[1] = _mm256_broadcast_sd (ic + 1);
+
+  for (i = 0; i < len; i += 4) {
+    _mm256_storeu_pd (o + i,
+        _mm256_fmadd_pd (_mm256_loadu_pd (c[1] + i), f[1],
+            _mm256_mul_pd (_mm256_loadu_pd (c[0] + i), f[0])));
+  }
+}
+
+void
+interpolate_gdouble_cubic_avx2 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m256d f[4], t[2];
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride),
+    (gdouble *) ((gint8 *) a + 2 * astride),
+    (gdouble *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm256_broadcast_sd (ic + 0);
+  f[1] = _mm256_broadcast_sd (ic + 1);
+  f[2] = _mm256_broadcast_sd (ic + 2);
+  f[3] = _mm256_broadcast_sd (ic + 3);
+
+  for (i = 0; i < len; i += 4) {
+    t[0] = _mm256_mul_pd (_mm256_loadu_pd (c[0] + i), f[0]);
+    t[1] = _mm256_mul_pd (_mm256_loadu_pd (c[2] + i), f[2]);
+    t[0] = _mm256_fmadd_pd (_mm256_loadu_pd (c[1] + i), f[1], t[0]);
+    t[1] = _mm256_fmadd_pd (_mm256_loadu_pd (c[3] + i), f[3], t[1]);
+    _mm256_storeu_pd (o + i, _mm256_add_pd (t[0], t[1]));
+  }
+}
+
+#endif
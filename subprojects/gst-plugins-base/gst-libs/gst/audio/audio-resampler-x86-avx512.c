@@ -0,0 +1,504 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "audio-resampler-x86-avx512.h"
+
+#if defined (__x86_64__) && defined (HAVE_IMMINTRIN_H) && \
+    defined (__AVX512F__) && defined (__AVX512BW__)
+
+#include <immintrin.h>
+
+/* The loops handle the last partial vector with masked loads and stores so
+ * that they never touch more than @len samples. A full vector is wider than
+ * the zero padded taps (TAPS_OVERREAD) for S16 and F32. */
+
+static inline __mmask32
+mask32_avx512 (gint n)
+{
+  return n >= 32 ? 0xffffffff : (__mmask32) ((1U << n) - 1);
+}
+
+static inline __mmask16
+mask16_avx512 (gint n)
+{
+  return n >= 16 ? 0xffff : (__mmask16) ((1U << n) - 1);
+}
+
+static inline __mmask8
+mask8_avx512 (gint n)
+{
+  return n >= 8 ? 0xff : (__mmask8) ((1U << n) - 1);
+}
+
+static inline __m512i
+madd_epi32_avx512 (__m512i sum, __m512i ta, __m512i tb)
+{
+  sum = _mm512_add_epi64 (sum, _mm512_mul_epi32 (ta, tb));
+  return _mm512_add_epi64 (sum,
+      _mm512_mul_epi32 (_mm512_srli_epi64 (ta, 32),
+          _mm512_srli_epi64 (tb, 32)));
+}
+
+static inline void
+inner_product_gint16_full_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res;
+  __mmask32 m;
+  __m512i sum = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 32) {
+    m = mask32_avx512 (len - i);
+    sum = _mm512_add_epi32 (sum,
+        _mm512_madd_epi16 (_mm512_maskz_loadu_epi16 (m, a + i),
+            _mm512_maskz_loadu_epi16 (m, b + i)));
+  }
+  res = _mm512_reduce_add_epi32 (sum);
+
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint16_linear_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i;
+  gint32 res;
+  __mmask32 m;
+  __m512i sum[2], t;
+  const gint16 *c[2] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 32) {
+    m = mask32_avx512 (len - i);
+    t = _mm512_maskz_loadu_epi16 (m, a + i);
+    sum[0] = _mm512_add_epi32 (sum[0], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[0] + i)));
+    sum[1] = _mm512_add_epi32 (sum[1], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[1] + i)));
+  }
+  res = (gint32) (gint16) (_mm512_reduce_add_epi32 (sum[0]) >> PRECISION_S16)
+      * icoeff[0];
+  res += (gint32) (gint16) (_mm512_reduce_add_epi32 (sum[1]) >> PRECISION_S16)
+      * icoeff[1];
+
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint16_cubic_1_avx512 (gint16 * o, const gint16 * a,
+    const gint16 * b, gint len, const gint16 * icoeff, gint bstride)
+{
+  gint i, j;
+  gint32 res;
+  __mmask32 m;
+  __m512i sum[4], t;
+  const gint16 *c[4] = { (gint16 *) ((gint8 *) b + 0 * bstride),
+    (gint16 *) ((gint8 *) b + 1 * bstride),
+    (gint16 *) ((gint8 *) b + 2 * bstride),
+    (gint16 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 32) {
+    m = mask32_avx512 (len - i);
+    t = _mm512_maskz_loadu_epi16 (m, a + i);
+    sum[0] = _mm512_add_epi32 (sum[0], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[0] + i)));
+    sum[1] = _mm512_add_epi32 (sum[1], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[1] + i)));
+    sum[2] = _mm512_add_epi32 (sum[2], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[2] + i)));
+    sum[3] = _mm512_add_epi32 (sum[3], _mm512_madd_epi16 (t,
+            _mm512_maskz_loadu_epi16 (m, c[3] + i)));
+  }
+  for (j = 0, res = 0; j < 4; j++)
+    res += (gint32) (gint16) (_mm512_reduce_add_epi32 (sum[j]) >>
+        PRECISION_S16) * icoeff[j];
+
+  res = (res + (1 << (PRECISION_S16 - 1))) >> PRECISION_S16;
+  *o = CLAMP (res, G_MININT16, G_MAXINT16);
+}
+
+static inline void
+inner_product_gint32_full_1_avx512 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __mmask16 m;
+  __m512i sum = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 16) {
+    m = mask16_avx512 (len - i);
+    sum = madd_epi32_avx512 (sum,
+        _mm512_maskz_loadu_epi32 (m, a + i),
+        _mm512_maskz_loadu_epi32 (m, b + i));
+  }
+  res = _mm512_reduce_add_epi64 (sum);
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_linear_1_avx512 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i;
+  gint64 res;
+  __mmask16 m;
+  __m512i sum[2], t;
+  const gint32 *c[2] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 16) {
+    m = mask16_avx512 (len - i);
+    t = _mm512_maskz_loadu_epi32 (m, a + i);
+    sum[0] = madd_epi32_avx512 (sum[0], t,
+        _mm512_maskz_loadu_epi32 (m, c[0] + i));
+    sum[1] = madd_epi32_avx512 (sum[1], t,
+        _mm512_maskz_loadu_epi32 (m, c[1] + i));
+  }
+  res = (gint64) (gint32) (_mm512_reduce_add_epi64 (sum[0]) >> PRECISION_S32)
+      * icoeff[0];
+  res += (gint64) (gint32) (_mm512_reduce_add_epi64 (sum[1]) >> PRECISION_S32)
+      * icoeff[1];
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gint32_cubic_1_avx512 (gint32 * o, const gint32 * a,
+    const gint32 * b, gint len, const gint32 * icoeff, gint bstride)
+{
+  gint i, j;
+  gint64 res;
+  __mmask16 m;
+  __m512i sum[4], t;
+  const gint32 *c[4] = { (gint32 *) ((gint8 *) b + 0 * bstride),
+    (gint32 *) ((gint8 *) b + 1 * bstride),
+    (gint32 *) ((gint8 *) b + 2 * bstride),
+    (gint32 *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_si512 ();
+
+  for (i = 0; i < len; i += 16) {
+    m = mask16_avx512 (len - i);
+    t = _mm512_maskz_loadu_epi32 (m, a + i);
+    sum[0] = madd_epi32_avx512 (sum[0], t,
+        _mm512_maskz_loadu_epi32 (m, c[0] + i));
+    sum[1] = madd_epi32_avx512 (sum[1], t,
+        _mm512_maskz_loadu_epi32 (m, c[1] + i));
+    sum[2] = madd_epi32_avx512 (sum[2], t,
+        _mm512_maskz_loadu_epi32 (m, c[2] + i));
+    sum[3] = madd_epi32_avx512 (sum[3], t,
+        _mm512_maskz_loadu_epi32 (m, c[3] + i));
+  }
+  for (j = 0, res = 0; j < 4; j++)
+    res += (gint64) (gint32) (_mm512_reduce_add_epi64 (sum[j]) >>
+        PRECISION_S32) * icoeff[j];
+
+  res = (res + (1 << (PRECISION_S32 - 1))) >> PRECISION_S32;
+  *o = CLAMP (res, G_MININT32, G_MAXINT32);
+}
+
+static inline void
+inner_product_gfloat_full_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __mmask16 m;
+  __m512 sum = _mm512_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    m = mask16_avx512 (len - i);
+    sum = _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, a + i),
+        _mm512_maskz_loadu_ps (m, b + i), sum);
+  }
+
+  *o = _mm512_reduce_add_ps (sum);
+}
+
+static inline void
+inner_product_gfloat_linear_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __mmask16 m;
+  __m512 sum[2], t;
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    m = mask16_avx512 (len - i);
+    t = _mm512_maskz_loadu_ps (m, a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[1] + i), sum[1]);
+  }
+  sum[0] = _mm512_fmadd_ps (_mm512_sub_ps (sum[0], sum[1]),
+      _mm512_set1_ps (icoeff[0]), sum[1]);
+
+  *o = _mm512_reduce_add_ps (sum[0]);
+}
+
+static inline void
+inner_product_gfloat_cubic_1_avx512 (gfloat * o, const gfloat * a,
+    const gfloat * b, gint len, const gfloat * icoeff, gint bstride)
+{
+  gint i;
+  __mmask16 m;
+  __m512 sum[4], t;
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) b + 0 * bstride),
+    (gfloat *) ((gint8 *) b + 1 * bstride),
+    (gfloat *) ((gint8 *) b + 2 * bstride),
+    (gfloat *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_ps ();
+
+  for (i = 0; i < len; i += 16) {
+    m = mask16_avx512 (len - i);
+    t = _mm512_maskz_loadu_ps (m, a + i);
+    sum[0] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[1] + i), sum[1]);
+    sum[2] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[2] + i), sum[2]);
+    sum[3] = _mm512_fmadd_ps (t, _mm512_maskz_loadu_ps (m, c[3] + i), sum[3]);
+  }
+  sum[0] = _mm512_mul_ps (sum[0], _mm512_set1_ps (icoeff[0]));
+  sum[0] = _mm512_fmadd_ps (sum[1], _mm512_set1_ps (icoeff[1]), sum[0]);
+  sum[0] = _mm512_fmadd_ps (sum[2], _mm512_set1_ps (icoeff[2]), sum[0]);
+  sum[0] = _mm512_fmadd_ps (sum[3], _mm512_set1_ps (icoeff[3]), sum[0]);
+
+  *o = _mm512_reduce_add_ps (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_full_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __mmask8 m;
+  __m512d sum = _mm512_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    m = mask8_avx512 (len - i);
+    sum = _mm512_fmadd_pd (_mm512_maskz_loadu_pd (m, a + i),
+        _mm512_maskz_loadu_pd (m, b + i), sum);
+  }
+
+  *o = _mm512_reduce_add_pd (sum);
+}
+
+static inline void
+inner_product_gdouble_linear_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __mmask8 m;
+  __m512d sum[2], t;
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride)
+  };
+
+  sum[0] = sum[1] = _mm512_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    m = mask8_avx512 (len - i);
+    t = _mm512_maskz_loadu_pd (m, a + i);
+    sum[0] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[1] + i), sum[1]);
+  }
+  sum[0] = _mm512_fmadd_pd (_mm512_sub_pd (sum[0], sum[1]),
+      _mm512_set1_pd (icoeff[0]), sum[1]);
+
+  *o = _mm512_reduce_add_pd (sum[0]);
+}
+
+static inline void
+inner_product_gdouble_cubic_1_avx512 (gdouble * o, const gdouble * a,
+    const gdouble * b, gint len, const gdouble * icoeff, gint bstride)
+{
+  gint i;
+  __mmask8 m;
+  __m512d sum[4], t;
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) b + 0 * bstride),
+    (gdouble *) ((gint8 *) b + 1 * bstride),
+    (gdouble *) ((gint8 *) b + 2 * bstride),
+    (gdouble *) ((gint8 *) b + 3 * bstride)
+  };
+
+  sum[0] = sum[1] = sum[2] = sum[3] = _mm512_setzero_pd ();
+
+  for (i = 0; i < len; i += 8) {
+    m = mask8_avx512 (len - i);
+    t = _mm512_maskz_loadu_pd (m, a + i);
+    sum[0] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[0] + i), sum[0]);
+    sum[1] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[1] + i), sum[1]);
+    sum[2] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[2] + i), sum[2]);
+    sum[3] = _mm512_fmadd_pd (t, _mm512_maskz_loadu_pd (m, c[3] + i), sum[3]);
+  }
+  sum[0] = _mm512_mul_pd (sum[0], _mm512_set1_pd (icoeff[0]));
+  sum[0] = _mm512_fmadd_pd (sum[1], _mm512_set1_pd (icoeff[1]), sum[0]);
+  sum[0] = _mm512_fmadd_pd (sum[2], _mm512_set1_pd (icoeff[2]), sum[0]);
+  sum[0] = _mm512_fmadd_pd (sum[3], _mm512_set1_pd (icoeff[3]), sum[0]);
+
+  *o = _mm512_reduce_add_pd (sum[0]);
+}
+
+MAKE_RESAMPLE_FUNC (gint16, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint16, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint16, cubic, 1, avx512);
+
+MAKE_RESAMPLE_FUNC (gint32, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint32, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gint32, cubic, 1, avx512);
+
+MAKE_RESAMPLE_FUNC (gfloat, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gfloat, cubic, 1, avx512);
+
+MAKE_RESAMPLE_FUNC (gdouble, full, 1, avx512);
+MAKE_RESAMPLE_FUNC (gdouble, linear, 1, avx512);
+MAKE_RESAMPLE_FUNC (gdouble, cubic, 1, avx512);
+
+void
+interpolate_gfloat_linear_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  __mmask16 m;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m512 f[2];
+  const gfloat *c[2] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm512_set1_ps (ic[0]);
+  f[1] = _mm512_set1_ps (ic[1]);
+
+  for (i = 0; i < len; i += 16) {
+    m = mask16_avx512 (len - i);
+    _mm512_mask_storeu_ps (o + i, m,
+        _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, c[1] + i), f[1],
+            _mm512_mul_ps (_mm512_maskz_loadu_ps (m, c[0] + i), f[0])));
+  }
+}
+
+void
+interpolate_gfloat_cubic_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  __mmask16 m;
+  gfloat *o = op, *a = ap, *ic = icp;
+  __m512 f[4], t[2];
+  const gfloat *c[4] = { (gfloat *) ((gint8 *) a + 0 * astride),
+    (gfloat *) ((gint8 *) a + 1 * astride),
+    (gfloat *) ((gint8 *) a + 2 * astride),
+    (gfloat *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm512_set1_ps (ic[0]);
+  f[1] = _mm512_set1_ps (ic[1]);
+  f[2] = _mm512_set1_ps (ic[2]);
+  f[3] = _mm512_set1_ps (ic[3]);
+
+  for (i = 0; i < len; i += 16) {
+    m = mask16_avx512 (len - i);
+    t[0] = _mm512_mul_ps (_mm512_maskz_loadu_ps (m, c[0] + i), f[0]);
+    t[1] = _mm512_mul_ps (_mm512_maskz_loadu_ps (m, c[2] + i), f[2]);
+    t[0] = _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, c[1] + i), f[1], t[0]);
+    t[1] = _mm512_fmadd_ps (_mm512_maskz_loadu_ps (m, c[3] + i), f[3], t[1]);
+    _mm512_mask_storeu_ps (o + i, m, _mm512_add_ps (t[0], t[1]));
+  }
+}
+
+void
+interpolate_gdouble_linear_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  __mmask8 m;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m512d f[2];
+  const gdouble *c[2] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride)
+  };
+
+  f[0] = _mm512_set1_pd (ic[0]);
+  f[1] = _mm512_set1_pd (ic[1]);
+
+  for (i = 0; i < len; i += 8) {
+    m = mask8_avx512 (len - i);
+    _mm512_mask_storeu_pd (o + i, m,
+        _mm512_fmadd_pd (_mm512_maskz_loadu_pd (m, c[1] + i), f[1],
+            _mm512_mul_pd (_mm512_maskz_loadu_pd (m, c[0] + i), f[0])));
+  }
+}
+
+void
+interpolate_gdouble_cubic_avx512 (gpointer op, const gpointer ap,
+    gint len, const gpointer icp, gint astride)
+{
+  gint i;
+  __mmask8 m;
+  gdouble *o = op, *a = ap, *ic = icp;
+  __m512d f[4], t[2];
+  const gdouble *c[4] = { (gdouble *) ((gint8 *) a + 0 * astride),
+    (gdouble *) ((gint8 *) a + 1 * astride),
+    (gdouble *) ((gint8 *) a + 2 * astride),
+    (gdouble *) ((gint8 *) a + 3 * astride)
+  };
+
+  f[0] = _mm512_set1_pd (ic[0]);
+  f[1] = _mm512_set1_pd (ic[1]);
+  f[2] = _mm512_set1_pd (ic[2]);
+  f[3] = _mm512_set1_pd (ic[3]);
+
+  for (i = 0; i < len; i += 8) {
+    m = mask8_avx512 (len - i);
+    t[0] = _mm512_mul_pd (_mm512_maskz_loadu_pd (m, c[0] + i), f[0]);
+    t[1] = _mm512_mul_pd (_mm512_maskz_loadu_pd (m, c[2] + i), f[2]);
+    t[0] = _mm512_fmadd_pd (_mm512_maskz_loadu_pd (m, c[1] + i), f[1], t[0]);
+    t[1] = _mm512_fmadd_pd (_mm512_maskz_loadu_pd (m, c[3] + i), f[3], t[1]);
+    _mm512_mask_storeu_pd (o + i, m, _mm512_add_pd (t[0], t[1]));
+  }
+}
+
+#endif
@@ -872,6 +872,13 @@ audio_resampler_init (void)
 #endif
           }
         }
+#ifdef CHECK_X86
+        /* after the SSE versions so that these take precedence */
+        if (audio_resampler_x86_has_avx2 ())
+          audio_resampler_check_x86 ("avx2");
+        if (audio_resampler_x86_has_avx512 ())
+          audio_resampler_check_x86 ("avx512");
+#endif
       }
     }
 #endif
@@ -75,6 +75,13 @@ struct _GstAudioBaseSinkPrivate
   GstAudioBaseSinkCustomSlavingCallback custom_slaving_callback;
   gpointer custom_slaving_cb_data;
   GDestroyNotify custom_slaving_cb_notify;
+
+  /* resampler and its output for GST_AUDIO_BASE_SINK_SLAVE_RESAMPLE */
+  GstAudioResampler *resampler;
+  gint resampler_in_rate;
+  gint resampler_out_rate;
+  gpointer resample_data;
+  gsize resample_size;
 };
 
 /* BaseAudioSink signals and args */
@@ -105,6 +112,10 @@ enum
  * fix itself, or is a permanent offset */
 #define DEFAULT_DISCONT_WAIT        (1 * GST_SECOND)
 
+/* the sample rate is scaled by this for the resampler so that the rate
+ * correction of slaving has a resolution of better than 1ppm */
+#define RESAMPLE_RATE_SCALE         1000
+
 enum
 {
   PROP_0,
@@ -326,6 +337,14 @@ gst_audio_base_sink_dispose (GObject * object)
     sink->ringbuffer = NULL;
   }
 
+  if (sink->priv->resampler) {
+    gst_audio_resampler_free (sink->priv->resampler);
+    sink->priv->resampler = NULL;
+  }
+  g_free (sink->priv->resample_data);
+  sink->priv->resample_data = NULL;
+  sink->priv->resample_size = 0;
+
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
@@ -946,6 +965,12 @@ gst_audio_base_sink_setcaps (GstBaseSink * bsink, GstCaps * caps)
   if (!gst_audio_ring_buffer_parse_caps (spec, caps))
     goto parse_error;
 
+  /* the resampler is created for the new format when needed */
+  if (sink->priv->resampler) {
+    gst_audio_resampler_free (sink->priv->resampler);
+    sink->priv->resampler = NULL;
+  }
+
   gst_audio_ring_buffer_debug_spec_buff (spec);
 
   GST_DEBUG_OBJECT (sink, "acquire ringbuffer");
@@ -1043,6 +1068,8 @@ gst_audio_base_sink_reset_sync (GstAudioBaseSink * sink)
   sink->priv->discont_time = -1;
   sink->priv->avg_skew = -1;
   sink->priv->last_align = 0;
+  if (sink->priv->resampler)
+    gst_audio_resampler_reset (sink->priv->resampler);
 }
 
 static void
@@ -1548,6 +1575,81 @@ gst_audio_base_sink_none_slaving (GstAudioBaseSink * sink,
   *srender_stop = render_stop;
 }
 
+/* resample @samples frames of @data to the rate of the master clock, using
+ * the rate of the clock calibration. Returns the number of resampled frames
+ * in @out_data, or -1 if the format can't be resampled and the ringbuffer
+ * has to skip or repeat samples instead */
+static gint
+gst_audio_base_sink_resample (GstAudioBaseSink * sink, gpointer data,
+    guint samples, gpointer * out_data)
+{
+  GstAudioBaseSinkPrivate *priv = sink->priv;
+  GstAudioRingBufferSpec *spec = &sink->ringbuffer->spec;
+  GstClockTime crate_num, crate_denom;
+  gint rate, in_rate, out_rate;
+  gsize out_samples, size;
+
+  if (spec->type != GST_AUDIO_RING_BUFFER_FORMAT_TYPE_RAW ||
+      GST_AUDIO_INFO_LAYOUT (&spec->info) != GST_AUDIO_LAYOUT_INTERLEAVED)
+    return -1;
+
+  switch (GST_AUDIO_INFO_FORMAT (&spec->info)) {
+    case GST_AUDIO_FORMAT_S16:
+    case GST_AUDIO_FORMAT_S32:
+    case GST_AUDIO_FORMAT_F32:
+    case GST_AUDIO_FORMAT_F64:
+      break;
+    default:
+      return -1;
+  }
+
+  gst_clock_get_calibration (sink->provided_clock, NULL, NULL, &crate_num,
+      &crate_denom);
+  if (crate_num == 0)
+    crate_denom = crate_num = 1;
+
+  rate = GST_AUDIO_INFO_RATE (&spec->info);
+  in_rate = rate * MIN (RESAMPLE_RATE_SCALE, MAX (1, G_MAXINT / 4 / rate));
+  out_rate = gst_util_uint64_scale_round (in_rate, crate_denom, crate_num);
+  if (out_rate <= 0 || out_rate > G_MAXINT / 2)
+    return -1;
+
+  if (priv->resampler == NULL) {
+    GstStructure *options;
+
+    options = gst_structure_new_empty ("GstAudioResampler.options");
+    gst_audio_resampler_options_set_quality (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+        GST_AUDIO_RESAMPLER_QUALITY_DEFAULT, in_rate, out_rate, options);
+    priv->resampler = gst_audio_resampler_new (GST_AUDIO_RESAMPLER_METHOD_KAISER,
+        GST_AUDIO_RESAMPLER_FLAG_VARIABLE_RATE,
+        GST_AUDIO_INFO_FORMAT (&spec->info),
+        GST_AUDIO_INFO_CHANNELS (&spec->info), in_rate, out_rate, options);
+    gst_structure_free (options);
+
+    if (priv->resampler == NULL)
+      return -1;
+  } else if (in_rate != priv->resampler_in_rate
+      || out_rate != priv->resampler_out_rate) {
+    GST_LOG_OBJECT (sink, "resampling %d to %d", in_rate, out_rate);
+    gst_audio_resampler_update (priv->resampler, in_rate, out_rate, NULL);
+  }
+  priv->resampler_in_rate = in_rate;
+  priv->resampler_out_rate = out_rate;
+
+  out_samples = gst_audio_resampler_get_out_frames (priv->resampler, samples);
+  size = out_samples * GST_AUDIO_INFO_BPF (&spec->info);
+  if (size > priv->resample_size) {
+    priv->resample_data = g_realloc (priv->resample_data, size);
+    priv->resample_size = size;
+  }
+
+  gst_audio_resampler_resample (priv->resampler, &data, samples,
+      &priv->resample_data, out_samples);
+  *out_data = priv->resample_data;
+
+  return out_samples;
+}
+
 /* converts render_start and render_stop to their slaved values */
 static void
 gst_audio_base_sink_handle_slaving (GstAudioBaseSink * sink,
@@ -1808,6 +1910,7 @@ gst_audio_base_sink_render (GstBaseSink * bsink, GstBuffer * buf)
   guint64 ctime, cstop;
   gsize offset;
   GstMapInfo info;
+  guint8 *data;
   gsize size;
   guint samples, written;
   gint bpf, rate;
@@ -2138,14 +2241,34 @@ no_align:
   GST_DEBUG_OBJECT (sink, "rendering at %" G_GUINT64_FORMAT " %d/%d",
       sample_offset, samples, out_samples);
 
+  gst_buffer_map (buf, &info, GST_MAP_READ);
+  data = info.data + offset;
+  offset = 0;
+
+  /* when resampling to the master clock, let the resampler produce the
+   * samples for the ringbuffer instead of skipping/repeating samples */
+  if (G_UNLIKELY (slaved
+          && sink->priv->slave_method == GST_AUDIO_BASE_SINK_SLAVE_RESAMPLE
+          && bsink->segment.rate == 1.0 && samples > 0)) {
+    gpointer resampled;
+    gint n;
+
+    n = gst_audio_base_sink_resample (sink, data, samples, &resampled);
+    if (n >= 0) {
+      GST_DEBUG_OBJECT (sink, "resampled %u to %d samples for %d", samples,
+          n, out_samples);
+      data = resampled;
+      samples = out_samples = n;
+    }
+  }
+
   /* we need to accumulate over different runs for when we get interrupted */
   accum = 0;
   align_next = TRUE;
-  gst_buffer_map (buf, &info, GST_MAP_READ);
   do {
     written =
         gst_audio_ring_buffer_commit (ringbuf, &sample_offset,
-        info.data + offset, samples, out_samples, &accum);
+        data + offset, samples, out_samples, &accum);
 
     GST_DEBUG_OBJECT (sink, "wrote %u of %u", written, samples);
     /* if we wrote all, we're done */
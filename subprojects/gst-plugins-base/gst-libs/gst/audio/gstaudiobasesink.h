@@ -82,7 +82,9 @@ G_BEGIN_DECLS
 
 /**
  * GstAudioBaseSinkSlaveMethod:
- * @GST_AUDIO_BASE_SINK_SLAVE_RESAMPLE: Resample to match the master clock
+ * @GST_AUDIO_BASE_SINK_SLAVE_RESAMPLE: Resample to match the master clock.
+ * Since 1.24 interleaved S16, S32, F32 and F64 samples are resampled with a
+ * #GstAudioResampler, other formats by skipping or repeating samples.
  * @GST_AUDIO_BASE_SINK_SLAVE_SKEW: Adjust playout pointer when master clock
  * drifts too much.
  * @GST_AUDIO_BASE_SINK_SLAVE_NONE: No adjustment is done.
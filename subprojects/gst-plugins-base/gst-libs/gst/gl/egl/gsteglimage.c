@@ -804,6 +804,27 @@ _drm_direct_fourcc_from_info (const GstVideoInfo * info)
 gboolean
 gst_egl_image_check_dmabuf_direct (GstGLContext * context,
     const GstVideoInfo * in_info, GstGLTextureTarget target)
+{
+  return gst_egl_image_check_dmabuf_direct_with_modifier (context, in_info,
+      target, DRM_FORMAT_MOD_LINEAR);
+}
+
+/**
+ * gst_egl_image_check_dmabuf_direct_with_modifier:
+ * @context: a #GstGLContext (must be an EGL context)
+ * @in_info: a #GstVideoInfo
+ * @target: a #GstGLTextureTarget
+ * @modifier: the DRM format modifier of the dmabuf memory
+ *
+ * Checks whether the video format specified by the given #GstVideoInfo,
+ * laid out as described by @modifier, is a supported texture format for the
+ * given target.
+ *
+ * Returns: %TRUE if the format and modifier are supported.
+ */
+gboolean
+gst_egl_image_check_dmabuf_direct_with_modifier (GstGLContext * context,
+    const GstVideoInfo * in_info, GstGLTextureTarget target, guint64 modifier)
 {
   EGLDisplay egl_display = EGL_DEFAULT_DISPLAY;
   GstGLDisplayEGL *display_egl;
@@ -889,7 +910,7 @@ gst_egl_image_check_dmabuf_direct (GstGLContext * context,
   }
 
   for (i = 0; i < num_modifiers; ++i) {
-    if (modifiers[i] == DRM_FORMAT_MOD_LINEAR) {
+    if (modifiers[i] == modifier) {
       if (external_only[i]) {
         GST_DEBUG ("driver only supports external import of fourcc %"
             GST_FOURCC_FORMAT, GST_FOURCC_ARGS (fourcc));
@@ -900,8 +921,8 @@ gst_egl_image_check_dmabuf_direct (GstGLContext * context,
       return ret;
     }
   }
-  GST_DEBUG ("driver only supports non-linear import of fourcc %"
-      GST_FOURCC_FORMAT, GST_FOURCC_ARGS (fourcc));
+  GST_DEBUG ("driver does not support modifier %#" G_GINT64_MODIFIER
+      "x for fourcc %" GST_FOURCC_FORMAT, modifier, GST_FOURCC_ARGS (fourcc));
   g_free (modifiers);
   g_free (external_only);
   return FALSE;
@@ -934,6 +955,33 @@ gst_egl_image_from_dmabuf_direct_target (GstGLContext * context,
     gint * fd, const gsize * offset, const GstVideoInfo * in_info,
     GstGLTextureTarget target)
 {
+  return gst_egl_image_from_dmabuf_direct_target_with_modifier (context, fd,
+      offset, in_info, target, DRM_FORMAT_MOD_LINEAR);
+}
+
+/**
+ * gst_egl_image_from_dmabuf_direct_target_with_modifier:
+ * @context: a #GstGLContext (must be an EGL context)
+ * @fd: Array of DMABuf file descriptors
+ * @offset: Array of offsets, relative to the DMABuf
+ * @in_info: the #GstVideoInfo
+ * @target: GL texture target this GstEGLImage is intended for
+ * @modifier: the DRM format modifier describing the layout of the DMABufs
+ *
+ * Same as gst_egl_image_from_dmabuf_direct_target(), but imports DMABufs
+ * with a tiled or compressed layout described by @modifier instead of
+ * assuming a linear layout. Non-linear modifiers require the
+ * EGL_EXT_image_dma_buf_import_modifiers extension.
+ *
+ * Returns: (nullable): a #GstEGLImage wrapping @dmabuf or %NULL on failure
+ *
+ * Since: 1.24
+ */
+GstEGLImage *
+gst_egl_image_from_dmabuf_direct_target_with_modifier (GstGLContext * context,
+    gint * fd, const gsize * offset, const GstVideoInfo * in_info,
+    GstGLTextureTarget target, guint64 modifier)
+{
 
   EGLImageKHR img;
   guint n_planes = GST_VIDEO_INFO_N_PLANES (in_info);
@@ -950,13 +998,18 @@ gst_egl_image_from_dmabuf_direct_target (GstGLContext * context,
   guintptr attribs[41];         /* 6 + 10 * 3 + 4 + 1 */
   gint atti = 0;
 
-  if (!gst_egl_image_check_dmabuf_direct (context, in_info, target))
+  if (!gst_egl_image_check_dmabuf_direct_with_modifier (context, in_info,
+          target, modifier))
     return NULL;
 
   fourcc = _drm_direct_fourcc_from_info (in_info);
   with_modifiers = gst_gl_context_check_feature (context,
       "EGL_EXT_image_dma_buf_import_modifiers");
 
+  /* without the extension, the driver can only assume a linear layout */
+  if (!with_modifiers && modifier != DRM_FORMAT_MOD_LINEAR)
+    return NULL;
+
   /* EGL DMABuf importation supports a maximum of 3 planes */
   if (G_UNLIKELY (n_planes > 3))
     return NULL;
@@ -978,9 +1031,9 @@ gst_egl_image_from_dmabuf_direct_target (GstGLContext * context,
     attribs[atti++] = get_egl_stride (in_info, 0);
     if (with_modifiers) {
       attribs[atti++] = EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT;
-      attribs[atti++] = DRM_FORMAT_MOD_LINEAR & 0xffffffff;
+      attribs[atti++] = modifier & 0xffffffff;
       attribs[atti++] = EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT;
-      attribs[atti++] = (DRM_FORMAT_MOD_LINEAR >> 32) & 0xffffffff;
+      attribs[atti++] = (modifier >> 32) & 0xffffffff;
     }
   }
 
@@ -994,9 +1047,9 @@ gst_egl_image_from_dmabuf_direct_target (GstGLContext * context,
     attribs[atti++] = get_egl_stride (in_info, 1);
     if (with_modifiers) {
       attribs[atti++] = EGL_DMA_BUF_PLANE1_MODIFIER_LO_EXT;
-      attribs[atti++] = DRM_FORMAT_MOD_LINEAR & 0xffffffff;
+      attribs[atti++] = modifier & 0xffffffff;
       attribs[atti++] = EGL_DMA_BUF_PLANE1_MODIFIER_HI_EXT;
-      attribs[atti++] = (DRM_FORMAT_MOD_LINEAR >> 32) & 0xffffffff;
+      attribs[atti++] = (modifier >> 32) & 0xffffffff;
     }
   }
 
@@ -1010,9 +1063,9 @@ gst_egl_image_from_dmabuf_direct_target (GstGLContext * context,
     attribs[atti++] = get_egl_stride (in_info, 2);
     if (with_modifiers) {
       attribs[atti++] = EGL_DMA_BUF_PLANE2_MODIFIER_LO_EXT;
-      attribs[atti++] = DRM_FORMAT_MOD_LINEAR & 0xffffffff;
+      attribs[atti++] = modifier & 0xffffffff;
       attribs[atti++] = EGL_DMA_BUF_PLANE2_MODIFIER_HI_EXT;
-      attribs[atti++] = (DRM_FORMAT_MOD_LINEAR >> 32) & 0xffffffff;
+      attribs[atti++] = (modifier >> 32) & 0xffffffff;
     }
   }
 
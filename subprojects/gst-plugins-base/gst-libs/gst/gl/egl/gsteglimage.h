@@ -99,6 +99,13 @@ GstEGLImage *           gst_egl_image_from_dmabuf_direct_target (GstGLContext *
                                                                  const gsize *offset,
                                                                  const GstVideoInfo * in_info,
                                                                  GstGLTextureTarget target);
+GST_GL_API
+GstEGLImage *           gst_egl_image_from_dmabuf_direct_target_with_modifier (GstGLContext * context,
+                                                                 gint *fd,
+                                                                 const gsize *offset,
+                                                                 const GstVideoInfo * in_info,
+                                                                 GstGLTextureTarget target,
+                                                                 guint64 modifier);
 
 GST_GL_API
 gboolean                gst_egl_image_export_dmabuf             (GstEGLImage *image, int *fd, gint *stride, gsize *offset);
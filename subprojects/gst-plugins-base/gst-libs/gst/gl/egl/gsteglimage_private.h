@@ -31,6 +31,12 @@ gboolean                gst_egl_image_check_dmabuf_direct       (GstGLContext *
                                                                  const GstVideoInfo * in_info,
                                                                  GstGLTextureTarget target);
 
+G_GNUC_INTERNAL
+gboolean                gst_egl_image_check_dmabuf_direct_with_modifier (GstGLContext * context,
+                                                                 const GstVideoInfo * in_info,
+                                                                 GstGLTextureTarget target,
+                                                                 guint64 modifier);
+
 
 G_END_DECLS
 
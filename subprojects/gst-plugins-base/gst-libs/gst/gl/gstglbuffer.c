@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include "gstglbuffer.h"
+#include "gstglbuffer_private.h"
 
 #include "gstglcontext.h"
 #include "gstglfuncs.h"
@@ -54,6 +55,8 @@
 #define USING_GLES3(context) (gst_gl_context_check_gl_version (context, GST_GL_API_GLES2, 3, 0))
 
 #define HAVE_BUFFER_STORAGE(context) (context->gl_vtable->BufferStorage != NULL)
+#define HAVE_SYNC(context) (context->gl_vtable->FenceSync != NULL && \
+    context->gl_vtable->ClientWaitSync != NULL)
 
 /* compatibility definitions... */
 #ifndef GL_MAP_READ_BIT
@@ -68,6 +71,9 @@
 #ifndef GL_MAP_PERSISTENT_BIT
 #define GL_MAP_PERSISTENT_BIT 0x0040
 #endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
 #ifndef GL_DYNAMIC_STORAGE_BIT
 #define GL_DYNAMIC_STORAGE_BIT 0x0100
 #endif
@@ -80,6 +86,15 @@
 #ifndef GL_COPY_WRITE_BUFFER
 #define GL_COPY_WRITE_BUFFER 0x8F37
 #endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#endif
+#ifndef GL_SYNC_FLUSH_COMMANDS_BIT
+#define GL_SYNC_FLUSH_COMMANDS_BIT 0x00000001
+#endif
+#ifndef GL_TIMEOUT_EXPIRED
+#define GL_TIMEOUT_EXPIRED 0x911B
+#endif
 
 GST_DEBUG_CATEGORY_STATIC (GST_CAT_GL_BUFFER);
 #define GST_CAT_DEFUALT GST_CAT_GL_BUFFER
@@ -90,6 +105,20 @@ GST_DEFINE_MINI_OBJECT_TYPE (GstGLBuffer, gst_gl_buffer);
 
 static GstAllocator *_gl_buffer_allocator;
 
+typedef struct
+{
+  GstGLBuffer buffer;
+
+  /* keep the buffer mapped for its whole lifetime, see
+   * gst_gl_buffer_enable_persistent_map() */
+  gboolean persistent;
+  gpointer persistent_data;
+  /* GLsync for the last GL command accessing the buffer */
+  gpointer sync;
+} GstGLBufferImpl;
+
+#define GST_GL_BUFFER_IMPL(mem) ((GstGLBufferImpl *) (mem))
+
 static gboolean
 _gl_buffer_create (GstGLBuffer * gl_mem, GError ** error)
 {
@@ -103,6 +132,9 @@ _gl_buffer_create (GstGLBuffer * gl_mem, GError ** error)
     flags |= GL_MAP_READ_BIT | GL_MAP_WRITE_BIT;
     /* allow access to GPU-side data while there are outstanding mappings */
     flags |= GL_MAP_PERSISTENT_BIT;
+    /* allow coherent mappings, used by
+     * gst_gl_buffer_enable_persistent_map() */
+    flags |= GL_MAP_COHERENT_BIT;
     /* match the glBufferData() below and  make this buffer mutable */
     flags |= GL_DYNAMIC_STORAGE_BIT;
     /* hint that the data should be kept CPU-side.  Fixes atrocious
@@ -153,7 +185,7 @@ _gl_buffer_new (GstAllocator * allocator, GstMemory * parent,
     GstGLContext * context, guint gl_target, guint gl_usage,
     const GstAllocationParams * params, gsize size)
 {
-  GstGLBuffer *ret = g_new0 (GstGLBuffer, 1);
+  GstGLBuffer *ret = (GstGLBuffer *) g_new0 (GstGLBufferImpl, 1);
   _gl_buffer_init (ret, allocator, parent, context, gl_target, gl_usage,
       params, size);
 
@@ -183,6 +215,41 @@ gst_gl_buffer_cpu_access (GstGLBuffer * mem, GstMapInfo * info, gsize size)
   GST_CAT_LOG (GST_CAT_GL_BUFFER, "mapping %p id %d size %" G_GSIZE_FORMAT,
       mem, mem->id, size);
 
+  if (GST_GL_BUFFER_IMPL (mem)->persistent) {
+    GstGLBufferImpl *impl = GST_GL_BUFFER_IMPL (mem);
+
+    if (!impl->persistent_data) {
+      gl->BindBuffer (mem->target, mem->id);
+      impl->persistent_data = gl->MapBufferRange (mem->target, 0,
+          mem->mem.mem.maxsize, GL_MAP_READ_BIT | GL_MAP_WRITE_BIT |
+          GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+      gl->BindBuffer (mem->target, 0);
+
+      GST_CAT_DEBUG (GST_CAT_GL_BUFFER, "persistently mapped buffer %p id %d "
+          "to %p", mem, mem->id, impl->persistent_data);
+    }
+
+    /* the mapping is coherent, the only thing left to do is to wait for the
+     * GL commands still accessing the data */
+    if (impl->sync) {
+      GLenum res;
+
+      do {
+        GST_CAT_LOG (GST_CAT_GL_BUFFER, "waiting on sync object %p",
+            impl->sync);
+        res = gl->ClientWaitSync ((GLsync) impl->sync,
+            GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000 /* 1s */ );
+      } while (res == GL_TIMEOUT_EXPIRED);
+
+      gl->DeleteSync ((GLsync) impl->sync);
+      impl->sync = NULL;
+    }
+
+    mem->mem.data = impl->persistent_data;
+
+    return mem->mem.data;
+  }
+
   if (HAVE_BUFFER_STORAGE (mem->mem.context)) {
     GLenum gl_map_flags = gst_map_flags_to_gl (info->flags);
 
@@ -307,7 +374,10 @@ _gl_buffer_unmap (GstGLBuffer * mem, GstMapInfo * info)
   GST_CAT_LOG (GST_CAT_GL_BUFFER, "unmapping %p id %d size %" G_GSIZE_FORMAT,
       mem, mem->id, info->size);
 
-  if (HAVE_BUFFER_STORAGE (mem->mem.context) && (info->flags & GST_MAP_GL) == 0) {
+  if (GST_GL_BUFFER_IMPL (mem)->persistent) {
+    /* coherent mapping, nothing to flush and stays mapped until destroyed */
+  } else if (HAVE_BUFFER_STORAGE (mem->mem.context)
+      && (info->flags & GST_MAP_GL) == 0) {
     gl->BindBuffer (mem->target, mem->id);
 
     if (info->flags & GST_MAP_WRITE)
@@ -420,10 +490,82 @@ static void
 _gl_buffer_destroy (GstGLBuffer * mem)
 {
   const GstGLFuncs *gl = mem->mem.context->gl_vtable;
+  GstGLBufferImpl *impl = GST_GL_BUFFER_IMPL (mem);
+
+  if (impl->sync) {
+    gl->DeleteSync ((GLsync) impl->sync);
+    impl->sync = NULL;
+  }
+
+  if (impl->persistent_data) {
+    gl->BindBuffer (mem->target, mem->id);
+    gl->UnmapBuffer (mem->target);
+    gl->BindBuffer (mem->target, 0);
+    impl->persistent_data = NULL;
+  }
 
   gl->DeleteBuffers (1, &mem->id);
 }
 
+/*
+ * gst_gl_buffer_enable_persistent_map:
+ * @buffer: a #GstGLBuffer
+ *
+ * Keep @buffer mapped for CPU access with a persistent and coherent mapping
+ * for its whole lifetime instead of calling glMapBufferRange() on every
+ * gst_memory_map().  CPU mappings then only wait for the GL commands
+ * accessing the buffer that were marked with gst_gl_buffer_set_sync_point()
+ * to complete.
+ *
+ * Users must call gst_gl_buffer_set_sync_point() after every GL command
+ * reading from or writing to @buffer.  Must be called before @buffer is
+ * first mapped.
+ *
+ * Returns: whether persistent mapping is supported and has been enabled
+ */
+gboolean
+gst_gl_buffer_enable_persistent_map (GstGLBuffer * buffer)
+{
+  GstGLContext *context = buffer->mem.context;
+
+  if (!HAVE_BUFFER_STORAGE (context) || !HAVE_SYNC (context)
+      || !context->gl_vtable->MapBufferRange)
+    return FALSE;
+
+  GST_GL_BUFFER_IMPL (buffer)->persistent = TRUE;
+
+  return TRUE;
+}
+
+/*
+ * gst_gl_buffer_set_sync_point:
+ * @buffer: a #GstGLBuffer
+ *
+ * Insert a fence after the GL commands accessing @buffer that the next CPU
+ * mapping of a persistently mapped @buffer will wait for.
+ *
+ * Must be called from the GL thread.
+ */
+void
+gst_gl_buffer_set_sync_point (GstGLBuffer * buffer)
+{
+  GstGLBufferImpl *impl = GST_GL_BUFFER_IMPL (buffer);
+  GstGLContext *context = buffer->mem.context;
+  const GstGLFuncs *gl = context->gl_vtable;
+
+  if (!impl->persistent)
+    return;
+
+  if (impl->sync)
+    gl->DeleteSync ((GLsync) impl->sync);
+  impl->sync = (gpointer) gl->FenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  GST_CAT_LOG (GST_CAT_GL_BUFFER, "setting sync object %p on buffer %p",
+      impl->sync, buffer);
+
+  if (gst_gl_context_is_shared (context))
+    gl->Flush ();
+}
+
 static void
 _gst_gl_buffer_allocation_params_copy_data (GstGLBufferAllocationParams * src,
     GstGLBufferAllocationParams * dest)
@@ -46,6 +46,13 @@
  *
  * The glcolorconvertelement provides a GStreamer element that uses
  * #GstGLColorConvert to convert between video formats and color spaces.
+ *
+ * Since 1.24, the input and output sizes may differ for RGB and GRAY
+ * output formats in which case the frame is scaled as part of the same
+ * render pass, and overlay compositions can be blended onto the output with
+ * gst_gl_color_convert_set_blend_overlays().  Compiled shaders are kept
+ * around for the lifetime of the #GstGLColorConvert so that switching back
+ * to a previously used configuration does not need to compile them again.
  */
 
 #define USING_OPENGL(context) (gst_gl_context_check_gl_version (context, GST_GL_API_OPENGL, 1, 0))
@@ -56,6 +63,9 @@
 #define USING_GLES2(context) (gst_gl_context_check_gl_version (context, GST_GL_API_GLES2, 2, 0))
 #define USING_GLES3(context) (gst_gl_context_check_gl_version (context, GST_GL_API_GLES2, 3, 0))
 
+/* maximum number of compiled shaders kept around */
+#define SHADER_CACHE_MAX_SIZE 16
+
 static void _do_convert (GstGLContext * context, GstGLColorConvert * convert);
 static gboolean _init_convert (GstGLColorConvert * convert);
 static gboolean _init_convert_fbo (GstGLColorConvert * convert);
@@ -617,6 +627,14 @@ struct _GstGLColorConvertPrivate
 
   GstBufferPool *pool;
   gboolean pool_started;
+
+  /* (gchar *) key -> (GstGLShader *) */
+  GHashTable *shader_cache;
+
+  gboolean blend_overlays;
+  GstGLOverlayCompositor *overlay_compositor;
+  /* whether the overlays of the current input buffer are drawn */
+  gboolean draw_overlays;
 };
 
 GST_DEBUG_CATEGORY_STATIC (gst_gl_color_convert_debug);
@@ -644,6 +662,8 @@ static void
 gst_gl_color_convert_init (GstGLColorConvert * convert)
 {
   convert->priv = gst_gl_color_convert_get_instance_private (convert);
+  convert->priv->shader_cache = g_hash_table_new_full (g_str_hash,
+      g_str_equal, g_free, gst_object_unref);
 
   gst_gl_color_convert_reset (convert);
 }
@@ -685,6 +705,14 @@ gst_gl_color_convert_finalize (GObject * object)
 
   gst_gl_color_convert_reset (convert);
 
+  g_hash_table_unref (convert->priv->shader_cache);
+  convert->priv->shader_cache = NULL;
+
+  if (convert->priv->overlay_compositor) {
+    gst_object_unref (convert->priv->overlay_compositor);
+    convert->priv->overlay_compositor = NULL;
+  }
+
   if (convert->context) {
     gst_object_unref (convert->context);
     convert->context = NULL;
@@ -891,6 +919,21 @@ _gst_gl_color_convert_set_caps_unlocked (GstGLColorConvert * convert,
     if (!passthrough && (in_flags & yuv_gray_flags) != 0
         && (out_flags & yuv_gray_flags) != 0)
       return FALSE;
+
+    /* Scaling is performed by the texture sampling into the output sized
+     * framebuffer.  YUV output shaders and tiled input shaders address
+     * pixels with the input dimensions and cannot scale */
+    if (!passthrough
+        && (GST_VIDEO_INFO_WIDTH (&in_info) != GST_VIDEO_INFO_WIDTH (&out_info)
+            || GST_VIDEO_INFO_HEIGHT (&in_info) !=
+            GST_VIDEO_INFO_HEIGHT (&out_info))
+        && ((out_flags & GST_VIDEO_FORMAT_FLAG_YUV) != 0
+            || GST_VIDEO_FORMAT_INFO_IS_TILED (in_info.finfo))) {
+      GST_DEBUG_OBJECT (convert, "Cannot scale from %s to %s",
+          gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&in_info)),
+          gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (&out_info)));
+      return FALSE;
+    }
   }
 
   gst_gl_color_convert_reset (convert);
@@ -939,6 +982,33 @@ gst_gl_color_convert_set_caps (GstGLColorConvert * convert,
   return ret;
 }
 
+/**
+ * gst_gl_color_convert_set_blend_overlays:
+ * @convert: a #GstGLColorConvert
+ * @blend: whether to blend overlay compositions onto the output
+ *
+ * Sets whether the #GstVideoOverlayComposition attached to input buffers
+ * should be blended onto the output frame.
+ *
+ * When enabled and the output format is RGBA or RGBx, the overlay rectangles
+ * are drawn into the output framebuffer right after the conversion and the
+ * output buffer does not carry a #GstVideoOverlayCompositionMeta anymore.
+ * For other output formats, and in passthrough mode, the meta is attached to
+ * the output buffer as usual.
+ *
+ * Since: 1.24
+ */
+void
+gst_gl_color_convert_set_blend_overlays (GstGLColorConvert * convert,
+    gboolean blend)
+{
+  g_return_if_fail (GST_IS_GL_COLOR_CONVERT (convert));
+
+  GST_OBJECT_LOCK (convert);
+  convert->priv->blend_overlays = blend;
+  GST_OBJECT_UNLOCK (convert);
+}
+
 /**
  * gst_gl_color_convert_decide_allocation:
  * @convert: a #GstGLColorConvert
@@ -2579,6 +2649,18 @@ _create_shader (GstGLColorConvert * convert)
   return ret;
 }
 
+/* The generated fragment body, the template and the texture targets fully
+ * describe the resulting shader program */
+static gchar *
+_shader_cache_key (GstGLColorConvert * convert)
+{
+  struct ConvertInfo *info = &convert->priv->convert_info;
+
+  return g_strdup_printf ("%p:%d:%d:%d\n%s", info->templ,
+      convert->priv->from_texture_target, convert->priv->to_texture_target,
+      info->out_n_textures, info->frag_body);
+}
+
 /* Called in the gl thread */
 static gboolean
 _init_convert (GstGLColorConvert * convert)
@@ -2658,8 +2740,30 @@ _init_convert (GstGLColorConvert * convert)
     goto incompatible_api;
   }
 
-  if (!(convert->shader = _create_shader (convert)))
-    goto error;
+  {
+    gchar *key = _shader_cache_key (convert);
+    GstGLShader *shader;
+
+    shader = g_hash_table_lookup (convert->priv->shader_cache, key);
+    if (shader) {
+      GST_DEBUG_OBJECT (convert, "reusing cached shader %" GST_PTR_FORMAT,
+          shader);
+      convert->shader = gst_object_ref (shader);
+      g_free (key);
+    } else {
+      if (!(convert->shader = _create_shader (convert))) {
+        g_free (key);
+        goto error;
+      }
+
+      if (g_hash_table_size (convert->priv->shader_cache) >=
+          SHADER_CACHE_MAX_SIZE)
+        g_hash_table_remove_all (convert->priv->shader_cache);
+
+      g_hash_table_insert (convert->priv->shader_cache, key,
+          gst_object_ref (convert->shader));
+    }
+  }
 
   convert->priv->attr_position =
       gst_gl_shader_get_attribute_location (convert->shader, "a_position");
@@ -3116,6 +3220,30 @@ _do_convert (GstGLContext * context, GstGLColorConvert * convert)
     return;
   }
 
+  convert->priv->draw_overlays = FALSE;
+  if (convert->priv->blend_overlays
+      && gst_buffer_get_video_overlay_composition_meta (convert->inbuf)) {
+    GstVideoFormat out_format = GST_VIDEO_INFO_FORMAT (&convert->out_info);
+
+    if (out_format == GST_VIDEO_FORMAT_RGBA
+        || out_format == GST_VIDEO_FORMAT_RGBx) {
+      if (!convert->priv->overlay_compositor) {
+        convert->priv->overlay_compositor =
+            gst_gl_overlay_compositor_new (convert->context);
+        /* we render top-down into the framebuffer */
+        g_object_set (convert->priv->overlay_compositor, "yinvert", TRUE,
+            NULL);
+      }
+
+      gst_gl_overlay_compositor_upload_overlays
+          (convert->priv->overlay_compositor, convert->inbuf);
+      convert->priv->draw_overlays = TRUE;
+    } else {
+      GST_LOG_OBJECT (convert, "Cannot blend overlays onto %s output",
+          gst_video_format_to_string (out_format));
+    }
+  }
+
   gst_gl_insert_debug_marker (context, "%s converting from %s to %s",
       GST_OBJECT_NAME (convert),
       gst_video_format_to_string (GST_VIDEO_INFO_FORMAT (in_info)),
@@ -3148,7 +3276,7 @@ _do_convert (GstGLContext * context, GstGLColorConvert * convert)
 
     composition_meta =
         gst_buffer_get_video_overlay_composition_meta (convert->inbuf);
-    if (composition_meta) {
+    if (composition_meta && !convert->priv->draw_overlays) {
       GST_DEBUG ("found video overlay composition meta, applying on output.");
       gst_buffer_add_video_overlay_composition_meta
           (convert->outbuf, composition_meta->overlay);
@@ -3230,6 +3358,10 @@ _do_convert_draw (GstGLContext * context, GstGLColorConvert * convert)
   else
     _unbind_buffer (convert);
 
+  /* blend the overlays in the same framebuffer pass */
+  if (convert->priv->draw_overlays)
+    gst_gl_overlay_compositor_draw_overlays (convert->priv->overlay_compositor);
+
   if (gl->DrawBuffer)
     gl->DrawBuffer (GL_COLOR_ATTACHMENT0);
 
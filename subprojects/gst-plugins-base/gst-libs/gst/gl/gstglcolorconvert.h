@@ -148,6 +148,10 @@ GST_GL_API
 gboolean    gst_gl_color_convert_decide_allocation (GstGLColorConvert   * convert,
                                                     GstQuery            * query);
 
+GST_GL_API
+void        gst_gl_color_convert_set_blend_overlays (GstGLColorConvert * convert,
+                                                     gboolean            blend);
+
 GST_GL_API
 GstBuffer * gst_gl_color_convert_perform    (GstGLColorConvert * convert, GstBuffer * inbuf);
 
@@ -234,6 +234,12 @@ struct _GstGLContextPrivate
 
   gchar *gl_exts;
   GstStructure *requested_config;
+
+  /* gst_gl_context_thread_add_async() fences */
+  GMutex async_lock;
+  GCond async_cond;
+  guint64 async_queued;
+  guint64 async_done;
 };
 
 typedef struct
@@ -297,6 +303,9 @@ gst_gl_context_init (GstGLContext * context)
   g_cond_init (&context->priv->destroy_cond);
   context->priv->created = FALSE;
 
+  g_mutex_init (&context->priv->async_lock);
+  g_cond_init (&context->priv->async_cond);
+
   g_weak_ref_init (&context->priv->other_context_ref, NULL);
 }
 
@@ -740,6 +749,9 @@ gst_gl_context_finalize (GObject * object)
   g_cond_clear (&context->priv->create_cond);
   g_cond_clear (&context->priv->destroy_cond);
 
+  g_mutex_clear (&context->priv->async_lock);
+  g_cond_clear (&context->priv->async_cond);
+
   g_free (context->priv->gl_exts);
   g_weak_ref_clear (&context->priv->other_context_ref);
 
@@ -1682,6 +1694,144 @@ gst_gl_context_thread_add (GstGLContext * context,
   gst_object_unref (window);
 }
 
+typedef struct
+{
+  GstGLContext *context;
+  GstGLContextThreadFunc func;
+  gpointer data;
+  GDestroyNotify notify;
+  guint64 fence;
+} RunAsyncData;
+
+static void
+_gst_gl_context_thread_run_async (RunAsyncData * data)
+{
+  GST_TRACE_OBJECT (data->context, "running async function:%p data:%p "
+      "fence:%" G_GUINT64_FORMAT, data->func, data->data, data->fence);
+
+  data->func (data->context, data->data);
+}
+
+static void
+_gst_gl_context_thread_free_async (RunAsyncData * data)
+{
+  GstGLContextPrivate *priv = data->context->priv;
+
+  if (data->notify)
+    data->notify (data->data);
+
+  /* messages are executed in order so every fence up to this one has
+   * completed as well */
+  g_mutex_lock (&priv->async_lock);
+  priv->async_done = data->fence;
+  g_cond_broadcast (&priv->async_cond);
+  g_mutex_unlock (&priv->async_lock);
+
+  g_free (data);
+}
+
+/**
+ * gst_gl_context_thread_add_async:
+ * @context: a #GstGLContext
+ * @func: (scope notified): a #GstGLContextThreadFunc
+ * @data: (closure): user data to call @func with
+ * @notify: (nullable): called when @data is not needed anymore
+ *
+ * Schedule @func to be executed in the OpenGL thread of @context with @data
+ * without waiting for it to complete.  Functions added with this function
+ * and with gst_gl_context_thread_add() are executed in the order they were
+ * added, so a later gst_gl_context_thread_add() implicitly waits for @func.
+ *
+ * If called from the OpenGL thread of @context, @func is executed
+ * immediately.
+ *
+ * Returns: a fence that can be passed to gst_gl_context_thread_wait() to
+ *     wait for @func to complete, or 0 if @func has already completed.
+ *
+ * MT-safe
+ *
+ * Since: 1.24
+ */
+guint64
+gst_gl_context_thread_add_async (GstGLContext * context,
+    GstGLContextThreadFunc func, gpointer data, GDestroyNotify notify)
+{
+  GstGLWindow *window;
+  RunAsyncData *adata;
+  guint64 fence;
+
+  g_return_val_if_fail (GST_IS_GL_CONTEXT (context), 0);
+  g_return_val_if_fail (func != NULL, 0);
+
+  if (GST_IS_GL_WRAPPED_CONTEXT (context))
+    g_return_val_if_fail (context->priv->active_thread == g_thread_self (), 0);
+
+  if (context->priv->active_thread == g_thread_self ()) {
+    func (context, data);
+    if (notify)
+      notify (data);
+    return 0;
+  }
+
+  adata = g_new0 (RunAsyncData, 1);
+  adata->context = context;
+  adata->func = func;
+  adata->data = data;
+  adata->notify = notify;
+
+  window = gst_gl_context_get_window (context);
+
+  /* fences must be queued in order, hold the lock while sending */
+  g_mutex_lock (&context->priv->async_lock);
+  fence = adata->fence = ++context->priv->async_queued;
+  gst_gl_window_send_message_async (window,
+      (GstGLWindowCB) _gst_gl_context_thread_run_async, adata,
+      (GDestroyNotify) _gst_gl_context_thread_free_async);
+  g_mutex_unlock (&context->priv->async_lock);
+
+  gst_object_unref (window);
+
+  return fence;
+}
+
+/**
+ * gst_gl_context_thread_wait:
+ * @context: a #GstGLContext
+ * @fence: a fence returned by gst_gl_context_thread_add_async()
+ *
+ * Wait until the function associated with @fence, and all the functions
+ * added before it, have been executed in the OpenGL thread of @context.
+ *
+ * Must not be called from the OpenGL thread of @context.
+ *
+ * MT-safe
+ *
+ * Since: 1.24
+ */
+void
+gst_gl_context_thread_wait (GstGLContext * context, guint64 fence)
+{
+  GstGLContextPrivate *priv;
+
+  g_return_if_fail (GST_IS_GL_CONTEXT (context));
+
+  if (fence == 0)
+    return;
+
+  priv = context->priv;
+
+  g_mutex_lock (&priv->async_lock);
+  if (priv->async_done < fence && priv->active_thread == g_thread_self ()) {
+    g_mutex_unlock (&priv->async_lock);
+    g_critical ("Cannot wait for fence %" G_GUINT64_FORMAT " from the OpenGL "
+        "thread of %" GST_PTR_FORMAT, fence, context);
+    return;
+  }
+  while (priv->async_done < fence)
+    g_cond_wait (&priv->async_cond, &priv->async_lock);
+  g_mutex_unlock (&priv->async_lock);
+}
+
 /**
  * gst_gl_context_get_gl_version:
  * @context: a #GstGLContext
@@ -247,6 +247,12 @@ GST_GL_API
 void gst_gl_context_thread_add (GstGLContext * context,
     GstGLContextThreadFunc func, gpointer data);
 
+GST_GL_API
+guint64 gst_gl_context_thread_add_async (GstGLContext * context,
+    GstGLContextThreadFunc func, gpointer data, GDestroyNotify notify);
+GST_GL_API
+void gst_gl_context_thread_wait (GstGLContext * context, guint64 fence);
+
 G_END_DECLS
 
 #endif /* __GST_GL_CONTEXT_H__ */
@@ -990,6 +990,13 @@ static void
 _filter_gl (GstGLContext * context, GstGLFilter * filter)
 {
   GstGLFilterClass *filter_class = GST_GL_FILTER_GET_CLASS (filter);
+  GstGLSyncMeta *out_sync_meta, *in_sync_meta;
+
+  /* waiting and setting the sync points from here avoids two extra round
+   * trips to the GL thread for every buffer */
+  in_sync_meta = gst_buffer_get_gl_sync_meta (filter->inbuf);
+  if (in_sync_meta)
+    gst_gl_sync_meta_wait (in_sync_meta, context);
 
   gst_gl_insert_debug_marker (context,
       "processing in element %s", GST_OBJECT_NAME (filter));
@@ -1000,6 +1007,10 @@ _filter_gl (GstGLContext * context, GstGLFilter * filter)
   else
     filter->gl_result =
         gst_gl_filter_filter_texture (filter, filter->inbuf, filter->outbuf);
+
+  out_sync_meta = gst_buffer_get_gl_sync_meta (filter->outbuf);
+  if (out_sync_meta)
+    gst_gl_sync_meta_set_sync_point (out_sync_meta, context);
 }
 
 static GstFlowReturn
@@ -1010,7 +1021,6 @@ gst_gl_filter_transform (GstBaseTransform * bt, GstBuffer * inbuf,
   GstGLFilterClass *filter_class = GST_GL_FILTER_GET_CLASS (bt);
   GstGLDisplay *display = GST_GL_BASE_FILTER (bt)->display;
   GstGLContext *context = GST_GL_BASE_FILTER (bt)->context;
-  GstGLSyncMeta *out_sync_meta, *in_sync_meta;
   gboolean ret;
 
   if (!display)
@@ -1018,20 +1028,12 @@ gst_gl_filter_transform (GstBaseTransform * bt, GstBuffer * inbuf,
 
   g_assert (filter_class->filter || filter_class->filter_texture);
 
-  in_sync_meta = gst_buffer_get_gl_sync_meta (inbuf);
-  if (in_sync_meta)
-    gst_gl_sync_meta_wait (in_sync_meta, context);
-
   filter->inbuf = inbuf;
   filter->outbuf = outbuf;
   gst_gl_context_thread_add (context, (GstGLContextThreadFunc) _filter_gl,
       filter);
   ret = filter->gl_result;
 
-  out_sync_meta = gst_buffer_get_gl_sync_meta (outbuf);
-  if (out_sync_meta)
-    gst_gl_sync_meta_set_sync_point (out_sync_meta, context);
-
   return ret ? GST_FLOW_OK : GST_FLOW_ERROR;
 }
 
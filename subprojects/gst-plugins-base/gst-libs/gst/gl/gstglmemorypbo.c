@@ -28,6 +28,7 @@
 #include "gstglmemorypbo.h"
 
 #include "gstglbuffer.h"
+#include "gstglbuffer_private.h"
 #include "gstglcontext.h"
 #include "gstglfuncs.h"
 #include "gstglutils.h"
@@ -49,6 +50,12 @@
  * PBO transfer's are implemented using GstGLBuffer.  We just need to
  * ensure that the texture data is written/read to/from before/after calling
  * map (mem->pbo, READ) which performs the pbo buffer transfer.
+ *
+ * Where supported, the pbo is persistently mapped so that CPU access does not
+ * go through glMapBufferRange() for every frame.  Every GL command using the
+ * pbo is followed by a fence that the next CPU mapping of the pbo waits on,
+ * which keeps optimistic downloads (as done by gldownload) asynchronous for
+ * as many frames as there are buffers in the pool.
  */
 
 #define USING_OPENGL(context) (gst_gl_context_check_gl_version (context, GST_GL_API_OPENGL, 1, 0))
@@ -158,6 +165,9 @@ _upload_pbo_memory (GstGLMemoryPBO * gl_mem, GstMapInfo * info,
   gl->BindBuffer (GL_PIXEL_UNPACK_BUFFER, pbo_id);
   gst_gl_memory_texsubimage (GST_GL_MEMORY_CAST (gl_mem), NULL);
   gl->BindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+
+  /* don't let the CPU overwrite the data before the upload completed */
+  gst_gl_buffer_set_sync_point (pbo);
 }
 
 static guint
@@ -216,6 +226,10 @@ _gl_mem_create (GstGLMemoryPBO * gl_mem, GError ** error)
 
     gst_object_unref (buf_allocator);
 
+    if (gst_gl_buffer_enable_persistent_map (gl_mem->pbo))
+      GST_CAT_LOG (GST_CAT_GL_MEMORY, "using persistently mapped pbo %u",
+          gl_mem->pbo->id);
+
     /* if we are wrapping an existing data pointer, and glbuffer is using
      * GL_EXT/ARB_buffer_storage or OpenGL 4.4 then we need to copy into the GL
      * provided data pointer.
@@ -280,6 +294,9 @@ _read_pixels_to_pbo (GstGLMemoryPBO * gl_mem)
       return FALSE;
     }
 
+    /* the next cpu map of the pbo waits for the read to complete */
+    gst_gl_buffer_set_sync_point (gl_mem->pbo);
+
     gst_memory_unmap (GST_MEMORY_CAST (gl_mem->pbo), &pbo_info);
   }
 
@@ -533,6 +550,7 @@ _gl_mem_copy_thread (GstGLContext * context, gpointer data)
     }
     gl->TexSubImage2D (out_tex_target, 0, 0, 0, out_width, out_height,
         out_gl_format, out_gl_type, 0);
+    gst_gl_buffer_set_sync_point (src->pbo);
     gst_memory_unmap (GST_MEMORY_CAST (src->pbo), &pbo_info);
   } else {                      /* different sizes */
     gst_gl_memory_copy_teximage (GST_GL_MEMORY_CAST (src),
@@ -790,6 +808,9 @@ _download_transfer (GstGLContext * context, GstGLMemoryPBO * gl_mem)
  *
  * Transfer the texture data from the texture into the PBO if necessary.
  *
+ * Since 1.24, the transfer is only scheduled and this function does not
+ * wait for it.  Mapping @gl_mem waits for any scheduled transfer.
+ *
  * Since: 1.8
  */
 void
@@ -797,8 +818,10 @@ gst_gl_memory_pbo_download_transfer (GstGLMemoryPBO * gl_mem)
 {
   g_return_if_fail (gst_is_gl_memory ((GstMemory *) gl_mem));
 
-  gst_gl_context_thread_add (gl_mem->mem.mem.context,
-      (GstGLContextThreadFunc) _download_transfer, gl_mem);
+  gst_gl_context_thread_add_async (gl_mem->mem.mem.context,
+      (GstGLContextThreadFunc) _download_transfer,
+      gst_memory_ref (GST_MEMORY_CAST (gl_mem)),
+      (GDestroyNotify) gst_memory_unref);
 }
 
 static void
@@ -824,6 +847,9 @@ _upload_transfer (GstGLContext * context, GstGLMemoryPBO * gl_mem)
  *
  * Transfer the texture data from the PBO into the texture if necessary.
  *
+ * Since 1.24, the transfer is only scheduled and this function does not
+ * wait for it.  Mapping @gl_mem waits for any scheduled transfer.
+ *
  * Since: 1.8
  */
 void
@@ -832,8 +858,10 @@ gst_gl_memory_pbo_upload_transfer (GstGLMemoryPBO * gl_mem)
   g_return_if_fail (gst_is_gl_memory ((GstMemory *) gl_mem));
 
   if (gl_mem->pbo && CONTEXT_SUPPORTS_PBO_UPLOAD (gl_mem->mem.mem.context))
-    gst_gl_context_thread_add (gl_mem->mem.mem.context,
-        (GstGLContextThreadFunc) _upload_transfer, gl_mem);
+    gst_gl_context_thread_add_async (gl_mem->mem.mem.context,
+        (GstGLContextThreadFunc) _upload_transfer,
+        gst_memory_ref (GST_MEMORY_CAST (gl_mem)),
+        (GDestroyNotify) gst_memory_unref);
 }
 
 /**
@@ -710,6 +710,7 @@ _dma_buf_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
   GstEGLImageCacheEntry *cache_entry = NULL;
   gsize offset[GST_VIDEO_MAX_PLANES];
   gint fd[GST_VIDEO_MAX_PLANES];
+  guint64 modifier = GST_DMABUF_DRM_MODIFIER_LINEAR;
   guint i;
 
   n_mem = gst_buffer_n_memory (buffer);
@@ -824,10 +825,11 @@ _dma_buf_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
   }
 
   if (dmabuf->direct) {
-    /* Check if this format is supported by the driver */
+    /* Check if this format and layout is supported by the driver */
     dmabuf->n_mem = 1;
-    if (!gst_egl_image_check_dmabuf_direct (dmabuf->upload->context, in_info,
-            dmabuf->target)) {
+    gst_dmabuf_memory_get_drm_modifier (mems[0], &modifier);
+    if (!gst_egl_image_check_dmabuf_direct_with_modifier (dmabuf->upload->
+            context, in_info, dmabuf->target, modifier)) {
       GST_DEBUG_OBJECT (dmabuf->upload, "direct check failed");
       return FALSE;
     }
@@ -850,8 +852,8 @@ _dma_buf_upload_accept (gpointer impl, GstBuffer * buffer, GstCaps * in_caps,
     /* otherwise create one and cache it */
     if (dmabuf->direct)
       dmabuf->eglimage[i] =
-          gst_egl_image_from_dmabuf_direct_target (dmabuf->upload->context, fd,
-          offset, in_info, dmabuf->target);
+          gst_egl_image_from_dmabuf_direct_target_with_modifier (dmabuf->
+          upload->context, fd, offset, in_info, dmabuf->target, modifier);
     else
       dmabuf->eglimage[i] = gst_egl_image_from_dmabuf (dmabuf->upload->context,
           fd[i], in_info, i, offset[i]);
@@ -0,0 +1,407 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gstthumbnailer
+ * @title: GstThumbnailer
+ * @short_description: Utility for extracting video thumbnails from URIs.
+ *
+ * The #GstThumbnailer is a utility object which extracts single video frames
+ * from one or many URIs, converted to the caps it was created with.
+ *
+ * It keeps one playback pipeline around and reuses it for every request,
+ * changing the URI only when needed. Seeks snap to the nearest keyframe
+ * and only keyframes are decoded, so requesting many thumbnails from the
+ * same file is cheap. Decoders that can scale while decoding (such as
+ * jpegdec) are configured to output the smallest size that is still at
+ * least as large as the requested width.
+ *
+ * |[<!-- language="C" -->
+ * GstThumbnailer *thumbnailer;
+ * GstSample *sample;
+ * GstCaps *caps;
+ *
+ * caps = gst_caps_from_string ("video/x-raw, format=RGB, width=160, "
+ *     "pixel-aspect-ratio=1/1");
+ * thumbnailer = gst_thumbnailer_new (caps, 5 * GST_SECOND);
+ * gst_caps_unref (caps);
+ *
+ * sample = gst_thumbnailer_get_thumbnail (thumbnailer, uri,
+ *     10 * GST_SECOND, &error);
+ * ]|
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+
+#include "pbutils.h"
+
+GST_DEBUG_CATEGORY_STATIC (thumbnailer_debug);
+#define GST_CAT_DEFAULT thumbnailer_debug
+
+#define SEEK_FLAGS (GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_KEY_UNIT | \
+    GST_SEEK_FLAG_SNAP_NEAREST | GST_SEEK_FLAG_TRICKMODE | \
+    GST_SEEK_FLAG_TRICKMODE_KEY_UNITS | GST_SEEK_FLAG_TRICKMODE_NO_AUDIO)
+
+struct _GstThumbnailer
+{
+  GstObject parent;
+
+  GstElement *pipeline;
+  GstElement *sink;
+  GstBus *bus;
+
+  /* serializes gst_thumbnailer_get_thumbnail() calls */
+  GMutex lock;
+
+  /* width requested by the caps, 0 if not fixed */
+  gint target_width;
+  GstClockTime timeout;
+
+  /* URI the pipeline is currently prerolled on */
+  gchar *uri;
+};
+
+#define gst_thumbnailer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstThumbnailer, gst_thumbnailer, GST_TYPE_OBJECT,
+    GST_DEBUG_CATEGORY_INIT (thumbnailer_debug, "thumbnailer", 0,
+        "Thumbnailer"));
+
+static void gst_thumbnailer_dispose (GObject * object);
+static void gst_thumbnailer_finalize (GObject * object);
+
+static void
+gst_thumbnailer_class_init (GstThumbnailerClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->dispose = gst_thumbnailer_dispose;
+  gobject_class->finalize = gst_thumbnailer_finalize;
+}
+
+static void
+gst_thumbnailer_init (GstThumbnailer * self)
+{
+  self->timeout = GST_CLOCK_TIME_NONE;
+  g_mutex_init (&self->lock);
+}
+
+static void
+gst_thumbnailer_dispose (GObject * object)
+{
+  GstThumbnailer *self = GST_THUMBNAILER (object);
+
+  if (self->pipeline)
+    gst_element_set_state (self->pipeline, GST_STATE_NULL);
+
+  gst_clear_object (&self->sink);
+  gst_clear_object (&self->bus);
+  gst_clear_object (&self->pipeline);
+
+  G_OBJECT_CLASS (parent_class)->dispose (object);
+}
+
+static void
+gst_thumbnailer_finalize (GObject * object)
+{
+  GstThumbnailer *self = GST_THUMBNAILER (object);
+
+  g_free (self->uri);
+  g_mutex_clear (&self->lock);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static GstPadProbeReturn
+decoder_caps_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstThumbnailer *self = GST_THUMBNAILER (user_data);
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+  GstStructure *s;
+  GstCaps *caps;
+  GstObject *decoder;
+  gint width;
+  guint factor;
+
+  if (GST_EVENT_TYPE (event) != GST_EVENT_CAPS)
+    return GST_PAD_PROBE_OK;
+
+  gst_event_parse_caps (event, &caps);
+  s = gst_caps_get_structure (caps, 0);
+  if (!gst_structure_get_int (s, "width", &width))
+    return GST_PAD_PROBE_OK;
+
+  /* the probe runs before the decoder sees the caps, so the new factor
+   * already applies to the first frame */
+  factor = CLAMP (width / self->target_width, 1, 8);
+  decoder = gst_pad_get_parent (pad);
+  if (decoder) {
+    GST_DEBUG_OBJECT (self, "decoding %d pixels wide input at 1/%u scale",
+        width, factor);
+    g_object_set (decoder, "downscale", factor, NULL);
+    gst_object_unref (decoder);
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+static void
+element_setup_cb (GstElement * playbin, GstElement * element,
+    GstThumbnailer * self)
+{
+  GstElementFactory *factory = gst_element_get_factory (element);
+  GParamSpec *pspec;
+  GstPad *pad;
+
+  if (self->target_width <= 0 || !factory ||
+      !gst_element_factory_list_is_type (factory,
+          GST_ELEMENT_FACTORY_TYPE_DECODER))
+    return;
+
+  pspec = g_object_class_find_property (G_OBJECT_GET_CLASS (element),
+      "downscale");
+  if (!pspec || pspec->value_type != G_TYPE_UINT)
+    return;
+
+  pad = gst_element_get_static_pad (element, "sink");
+  if (!pad)
+    return;
+
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM,
+      decoder_caps_probe, self, NULL);
+  gst_object_unref (pad);
+}
+
+/**
+ * gst_thumbnailer_new:
+ * @caps: the caps thumbnails are converted to, usually raw video caps with a
+ *     fixed width and format
+ * @timeout: maximum time to wait for a single thumbnail, or
+ *     #GST_CLOCK_TIME_NONE to wait forever
+ *
+ * Creates a new #GstThumbnailer.
+ *
+ * Returns: (transfer full) (nullable): a new #GstThumbnailer, or %NULL if the
+ *     required elements are not available.
+ *
+ * Since: 1.24
+ */
+GstThumbnailer *
+gst_thumbnailer_new (const GstCaps * caps, GstClockTime timeout)
+{
+  GstThumbnailer *self;
+  GstElement *pipeline, *bin, *filter;
+  GError *err = NULL;
+
+  g_return_val_if_fail (GST_IS_CAPS (caps), NULL);
+
+  pipeline = gst_element_factory_make ("playbin", NULL);
+  if (!pipeline) {
+    GST_WARNING ("playbin is not available");
+    return NULL;
+  }
+
+  bin = gst_parse_bin_from_description ("videoconvert ! videoscale ! "
+      "capsfilter name=filter ! fakesink name=sink sync=false "
+      "enable-last-sample=true", TRUE, &err);
+  if (!bin) {
+    GST_WARNING ("could not create video sink: %s", err->message);
+    g_clear_error (&err);
+    gst_object_unref (pipeline);
+    return NULL;
+  }
+
+  self = g_object_new (GST_TYPE_THUMBNAILER, NULL);
+  gst_object_ref_sink (self);
+
+  self->timeout = timeout;
+  if (!gst_caps_is_empty (caps) && !gst_caps_is_any (caps)) {
+    const GValue *v =
+        gst_structure_get_value (gst_caps_get_structure (caps, 0), "width");
+
+    if (v && G_VALUE_HOLDS_INT (v))
+      self->target_width = g_value_get_int (v);
+  }
+
+  filter = gst_bin_get_by_name (GST_BIN (bin), "filter");
+  g_object_set (filter, "caps", caps, NULL);
+  gst_object_unref (filter);
+
+  self->sink = gst_bin_get_by_name (GST_BIN (bin), "sink");
+
+  g_object_set (pipeline, "video-sink", bin, NULL);
+  gst_util_set_object_arg (G_OBJECT (pipeline), "flags", "video");
+  g_signal_connect (pipeline, "element-setup", G_CALLBACK (element_setup_cb),
+      self);
+
+  self->pipeline = gst_object_ref_sink (pipeline);
+  self->bus = gst_element_get_bus (pipeline);
+
+  return self;
+}
+
+static void
+gst_thumbnailer_propagate_error (GstThumbnailer * self, GstMessage * msg,
+    GError ** error)
+{
+  GError *err = NULL;
+  gchar *debug = NULL;
+
+  gst_message_parse_error (msg, &err, &debug);
+  GST_WARNING_OBJECT (self, "error from %s: %s (%s)",
+      GST_OBJECT_NAME (GST_MESSAGE_SRC (msg)), err->message,
+      GST_STR_NULL (debug));
+  g_propagate_error (error, err);
+  g_free (debug);
+}
+
+/* waits for the pending state change or seek to complete */
+static gboolean
+gst_thumbnailer_wait (GstThumbnailer * self, GError ** error)
+{
+  GstMessage *msg;
+  gboolean ret = TRUE;
+
+  msg = gst_bus_timed_pop_filtered (self->bus, self->timeout,
+      GST_MESSAGE_ASYNC_DONE | GST_MESSAGE_ERROR);
+  if (!msg) {
+    g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_STATE_CHANGE,
+        "Timed out waiting for a video frame");
+    return FALSE;
+  }
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR) {
+    gst_thumbnailer_propagate_error (self, msg, error);
+    ret = FALSE;
+  }
+
+  gst_message_unref (msg);
+  return ret;
+}
+
+static gboolean
+gst_thumbnailer_preroll (GstThumbnailer * self, const gchar * uri,
+    GError ** error)
+{
+  GstStateChangeReturn ret;
+
+  if (!g_strcmp0 (self->uri, uri))
+    return TRUE;
+
+  GST_DEBUG_OBJECT (self, "switching to %s", uri);
+
+  g_clear_pointer (&self->uri, g_free);
+  gst_element_set_state (self->pipeline, GST_STATE_READY);
+  gst_bus_set_flushing (self->bus, TRUE);
+  gst_bus_set_flushing (self->bus, FALSE);
+
+  g_object_set (self->pipeline, "uri", uri, NULL);
+
+  ret = gst_element_set_state (self->pipeline, GST_STATE_PAUSED);
+  if (ret == GST_STATE_CHANGE_FAILURE) {
+    GstMessage *msg = gst_bus_pop_filtered (self->bus, GST_MESSAGE_ERROR);
+
+    if (msg) {
+      gst_thumbnailer_propagate_error (self, msg, error);
+      gst_message_unref (msg);
+    } else {
+      g_set_error (error, GST_RESOURCE_ERROR, GST_RESOURCE_ERROR_OPEN_READ,
+          "Could not open %s", uri);
+    }
+    return FALSE;
+  }
+
+  if (ret == GST_STATE_CHANGE_ASYNC && !gst_thumbnailer_wait (self, error))
+    return FALSE;
+
+  self->uri = g_strdup (uri);
+
+  return TRUE;
+}
+
+/**
+ * gst_thumbnailer_get_thumbnail:
+ * @thumbnailer: a #GstThumbnailer
+ * @uri: the URI to extract the thumbnail from
+ * @position: stream time of the wanted frame, or #GST_CLOCK_TIME_NONE for
+ *     the first frame
+ * @error: (out) (optional): return location for a #GError
+ *
+ * Extracts the keyframe closest to @position from @uri. This blocks until
+ * the frame is decoded, an error occurs or the timeout passed to
+ * gst_thumbnailer_new() expires.
+ *
+ * Consecutive calls with the same @uri only perform a seek.
+ *
+ * Returns: (transfer full) (nullable): a #GstSample with the converted frame,
+ *     or %NULL on error.
+ *
+ * Since: 1.24
+ */
+GstSample *
+gst_thumbnailer_get_thumbnail (GstThumbnailer * thumbnailer,
+    const gchar * uri, GstClockTime position, GError ** error)
+{
+  GstSample *sample = NULL;
+
+  g_return_val_if_fail (GST_IS_THUMBNAILER (thumbnailer), NULL);
+  g_return_val_if_fail (uri != NULL, NULL);
+
+  g_mutex_lock (&thumbnailer->lock);
+
+  if (!gst_thumbnailer_preroll (thumbnailer, uri, error))
+    goto failed;
+
+  if (GST_CLOCK_TIME_IS_VALID (position)) {
+    GST_DEBUG_OBJECT (thumbnailer, "seeking to %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (position));
+
+    if (!gst_element_seek_simple (thumbnailer->pipeline, GST_FORMAT_TIME,
+            SEEK_FLAGS, position)) {
+      g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_SEEK,
+          "Could not seek to %" GST_TIME_FORMAT, GST_TIME_ARGS (position));
+      goto failed;
+    }
+
+    if (!gst_thumbnailer_wait (thumbnailer, error))
+      goto failed;
+  }
+
+  g_object_get (thumbnailer->sink, "last-sample", &sample, NULL);
+  if (!sample) {
+    g_set_error (error, GST_STREAM_ERROR, GST_STREAM_ERROR_FAILED,
+        "No video frame available");
+    goto failed;
+  }
+
+  g_mutex_unlock (&thumbnailer->lock);
+
+  return sample;
+
+failed:
+  gst_element_set_state (thumbnailer->pipeline, GST_STATE_NULL);
+  g_clear_pointer (&thumbnailer->uri, g_free);
+  g_mutex_unlock (&thumbnailer->lock);
+
+  return NULL;
+}
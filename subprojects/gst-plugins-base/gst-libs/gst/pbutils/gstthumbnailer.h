@@ -0,0 +1,44 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef _GST_THUMBNAILER_H_
+#define _GST_THUMBNAILER_H_
+
+#include <gst/gst.h>
+#include <gst/pbutils/pbutils-prelude.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_THUMBNAILER (gst_thumbnailer_get_type ())
+GST_PBUTILS_API
+G_DECLARE_FINAL_TYPE (GstThumbnailer, gst_thumbnailer, GST, THUMBNAILER,
+    GstObject)
+
+GST_PBUTILS_API
+GstThumbnailer * gst_thumbnailer_new           (const GstCaps * caps,
+                                                GstClockTime timeout);
+
+GST_PBUTILS_API
+GstSample *      gst_thumbnailer_get_thumbnail (GstThumbnailer * thumbnailer,
+                                                const gchar * uri,
+                                                GstClockTime position,
+                                                GError ** error);
+
+G_END_DECLS
+
+#endif /* _GST_THUMBNAILER_H_ */
@@ -29,6 +29,7 @@
 #include <gst/pbutils/codec-utils.h>
 #include <gst/pbutils/pbutils-enumtypes.h>
 #include <gst/pbutils/gstdiscoverer.h>
+#include <gst/pbutils/gstthumbnailer.h>
 #include <gst/pbutils/encoding-profile.h>
 #include <gst/pbutils/encoding-target.h>
 #include <gst/pbutils/gstaudiovisualizer.h>
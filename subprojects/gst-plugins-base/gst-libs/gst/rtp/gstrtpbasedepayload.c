@@ -75,6 +75,8 @@ struct _GstRTPBaseDepayloadPrivate
 
   /* array of GstRTPHeaderExtension's * */
   GPtrArray *header_exts;
+  /* the extensions of header_exts by id */
+  GstRTPHeaderExtension *header_ext_ids[256];
 };
 
 /* Filter signals and args */
@@ -428,6 +430,25 @@ add_and_ref_item (GstRTPHeaderExtension * ext, GPtrArray * ret)
   g_ptr_array_add (ret, gst_object_ref (ext));
 }
 
+/* called with the object lock */
+static void
+update_header_ext_ids (GstRTPBaseDepayloadPrivate * priv)
+{
+  guint i;
+
+  memset (priv->header_ext_ids, 0, sizeof (priv->header_ext_ids));
+
+  for (i = 0; i < priv->header_exts->len; i++) {
+    GstRTPHeaderExtension *ext = g_ptr_array_index (priv->header_exts, i);
+    guint ext_id = gst_rtp_header_extension_get_id (ext);
+
+    /* the first extension with an id is used, like the lookup did before */
+    if (ext_id < G_N_ELEMENTS (priv->header_ext_ids)
+        && priv->header_ext_ids[ext_id] == NULL)
+      priv->header_ext_ids[ext_id] = ext;
+  }
+}
+
 static void
 remove_item_from (GstRTPHeaderExtension * ext, GPtrArray * ret)
 {
@@ -634,6 +655,7 @@ gst_rtp_base_depayload_setcaps (GstRTPBaseDepayload * filter, GstCaps * caps)
         filter->priv->header_exts);
     g_ptr_array_foreach (to_add, (GFunc) add_item_to,
         filter->priv->header_exts);
+    update_header_ext_ids (filter->priv);
     GST_OBJECT_UNLOCK (filter);
 
   ext_out:
@@ -1152,6 +1174,7 @@ gst_rtp_base_depayload_add_extension (GstRTPBaseDepayload * rtpbasepayload,
   /* XXX: check for duplicate ids? */
   GST_OBJECT_LOCK (rtpbasepayload);
   g_ptr_array_add (rtpbasepayload->priv->header_exts, gst_object_ref (ext));
+  update_header_ext_ids (rtpbasepayload->priv);
   GST_OBJECT_UNLOCK (rtpbasepayload);
 }
 
@@ -1160,6 +1183,7 @@ gst_rtp_base_depayload_clear_extensions (GstRTPBaseDepayload * rtpbasepayload)
 {
   GST_OBJECT_LOCK (rtpbasepayload);
   g_ptr_array_set_size (rtpbasepayload->priv->header_exts, 0);
+  update_header_ext_ids (rtpbasepayload->priv);
   GST_OBJECT_UNLOCK (rtpbasepayload);
 }
 
@@ -1204,10 +1228,10 @@ read_rtp_header_extensions (GstRTPBaseDepayload * depayload,
       goto out;
     }
 
+    GST_OBJECT_LOCK (depayload);
     while (TRUE) {
       guint8 read_id, read_len;
-      GstRTPHeaderExtension *ext = NULL;
-      guint i;
+      GstRTPHeaderExtension *ext;
 
       if (offset + hdr_unit_bytes >= bytelen)
         /* not enough remaning data */
@@ -1246,14 +1270,11 @@ read_rtp_header_extensions (GstRTPBaseDepayload * depayload,
         break;
       }
 
-      GST_OBJECT_LOCK (depayload);
-      for (i = 0; i < depayload->priv->header_exts->len; i++) {
-        ext = g_ptr_array_index (depayload->priv->header_exts, i);
-        if (read_id == gst_rtp_header_extension_get_id (ext)) {
-          gst_object_ref (ext);
-          break;
-        }
-        ext = NULL;
+      ext = depayload->priv->header_ext_ids[read_id];
+      if (G_UNLIKELY (ext && gst_rtp_header_extension_get_id (ext) != read_id)) {
+        /* the id was changed after the extension was added */
+        update_header_ext_ids (depayload->priv);
+        ext = depayload->priv->header_ext_ids[read_id];
       }
 
       if (ext) {
@@ -1261,20 +1282,17 @@ read_rtp_header_extensions (GstRTPBaseDepayload * depayload,
                 read_len, output)) {
           GST_WARNING_OBJECT (depayload, "RTP header extension (%s) could "
               "not read payloaded data", GST_OBJECT_NAME (ext));
-          gst_object_unref (ext);
-          goto out;
+          break;
         }
 
         if (gst_rtp_header_extension_wants_update_non_rtp_src_caps (ext)) {
           needs_src_caps_update = TRUE;
         }
-
-        gst_object_unref (ext);
       }
-      GST_OBJECT_UNLOCK (depayload);
 
       offset += read_len;
     }
+    GST_OBJECT_UNLOCK (depayload);
   }
 
 out:
@@ -1559,6 +1559,12 @@ typedef struct
   GstClockTime pts;
   guint64 offset;
   guint32 rtptime;
+  /* header extension layout, the same for all the packets of a push. No
+   * extensions are written when hdrext_unit_size is 0 */
+  GstRTPHeaderExtensionFlags hdrext_flags;
+  gsize hdrext_unit_size;
+  guint hdrext_wordlen;
+  guint16 hdrext_bit_pattern;
 } HeaderData;
 
 static gboolean
@@ -1711,6 +1717,63 @@ error:
   return;
 }
 
+/* determine the header extension layout for the packets made from the
+ * current input buffer, called with the object lock */
+static gboolean
+prepare_header_extensions (HeaderData * data)
+{
+  GstRTPBasePayload *payload = data->payload;
+  HeaderExt hdrext = { NULL, };
+  gsize extlen;
+
+  data->hdrext_unit_size = 0;
+
+  if (payload->priv->header_exts->len == 0
+      || !payload->priv->input_meta_buffer)
+    return TRUE;
+
+  hdrext.payload = payload;
+  hdrext.flags =
+      GST_RTP_HEADER_EXTENSION_ONE_BYTE | GST_RTP_HEADER_EXTENSION_TWO_BYTE;
+  g_ptr_array_foreach (payload->priv->header_exts,
+      (GFunc) determine_header_extension_flags_size, &hdrext);
+
+  if (hdrext.flags & GST_RTP_HEADER_EXTENSION_ONE_BYTE) {
+    /* prefer the one byte header */
+    hdrext.hdr_unit_size = 1;
+    /* TODO: support mixed size writing modes, i.e. RFC8285 */
+    hdrext.flags &= ~GST_RTP_HEADER_EXTENSION_TWO_BYTE;
+    data->hdrext_bit_pattern = 0xBEDE;
+  } else if (hdrext.flags & GST_RTP_HEADER_EXTENSION_TWO_BYTE) {
+    hdrext.hdr_unit_size = 2;
+    data->hdrext_bit_pattern = 0x1000;
+  } else {
+    return FALSE;
+  }
+
+  extlen = hdrext.hdr_unit_size * payload->priv->header_exts->len +
+      hdrext.allocated_size;
+
+  data->hdrext_flags = hdrext.flags;
+  data->hdrext_unit_size = hdrext.hdr_unit_size;
+  data->hdrext_wordlen = extlen / 4 + ((extlen % 4) ? 1 : 0);
+
+  return TRUE;
+}
+
+static gboolean
+foreach_metadata_drop (GstBuffer * buffer, GstMeta ** meta, gpointer user_data)
+{
+  GType drop_api_type = (GType) user_data;
+  const GstMetaInfo *info = (*meta)->info;
+
+  if (info->api == drop_api_type)
+    *meta = NULL;
+
+  return TRUE;
+}
+
+/* called with the object lock */
 static gboolean
 set_headers (GstBuffer ** buffer, guint idx, gpointer user_data)
 {
@@ -1726,43 +1789,19 @@ set_headers (GstBuffer ** buffer, guint idx, gpointer user_data)
   gst_rtp_buffer_set_seq (&rtp, data->seqnum);
   gst_rtp_buffer_set_timestamp (&rtp, data->rtptime);
 
-  GST_OBJECT_LOCK (data->payload);
-  if (data->payload->priv->header_exts->len > 0
-      && data->payload->priv->input_meta_buffer) {
-    guint wordlen;
-    gsize extlen;
-    guint16 bit_pattern;
+  if (data->hdrext_unit_size > 0) {
+    guint wordlen = data->hdrext_wordlen;
 
     /* write header extensions */
     hdrext.payload = data->payload;
     hdrext.output = *buffer;
-    /* XXX: pre-calculate these flags and sizes? */
-    hdrext.flags =
-        GST_RTP_HEADER_EXTENSION_ONE_BYTE | GST_RTP_HEADER_EXTENSION_TWO_BYTE;
-    g_ptr_array_foreach (data->payload->priv->header_exts,
-        (GFunc) determine_header_extension_flags_size, &hdrext);
-    hdrext.hdr_unit_size = 0;
-    if (hdrext.flags & GST_RTP_HEADER_EXTENSION_ONE_BYTE) {
-      /* prefer the one byte header */
-      hdrext.hdr_unit_size = 1;
-      /* TODO: support mixed size writing modes, i.e. RFC8285 */
-      hdrext.flags &= ~GST_RTP_HEADER_EXTENSION_TWO_BYTE;
-      bit_pattern = 0xBEDE;
-    } else if (hdrext.flags & GST_RTP_HEADER_EXTENSION_TWO_BYTE) {
-      hdrext.hdr_unit_size = 2;
-      bit_pattern = 0x1000;
-    } else {
-      goto unsupported_flags;
-    }
-
-    extlen =
-        hdrext.hdr_unit_size * data->payload->priv->header_exts->len +
-        hdrext.allocated_size;
-    wordlen = extlen / 4 + ((extlen % 4) ? 1 : 0);
+    hdrext.flags = data->hdrext_flags;
+    hdrext.hdr_unit_size = data->hdrext_unit_size;
 
     /* XXX: do we need to add to any existing extension data instead of
      * overwriting everything? */
-    gst_rtp_buffer_set_extension_data (&rtp, bit_pattern, wordlen);
+    gst_rtp_buffer_set_extension_data (&rtp, data->hdrext_bit_pattern,
+        wordlen);
     gst_rtp_buffer_get_extension_data (&rtp, NULL, (gpointer) & hdrext.data,
         &wordlen);
 
@@ -1779,14 +1818,18 @@ set_headers (GstBuffer ** buffer, guint idx, gpointer user_data)
       memset (&hdrext.data[hdrext.written_size], 0,
           wordlen * 4 - hdrext.written_size);
 
-      gst_rtp_buffer_set_extension_data (&rtp, bit_pattern, wordlen);
+      gst_rtp_buffer_set_extension_data (&rtp, data->hdrext_bit_pattern,
+          wordlen);
     } else {
       gst_rtp_buffer_remove_extension_data (&rtp);
     }
   }
-  GST_OBJECT_UNLOCK (data->payload);
   gst_rtp_buffer_unmap (&rtp);
 
+  /* remove unwanted meta */
+  gst_buffer_foreach_meta (*buffer, foreach_metadata_drop,
+      (gpointer) GST_RTP_SOURCE_META_API_TYPE);
+
   /* increment the seqnum for each buffer */
   data->seqnum++;
 
@@ -1797,33 +1840,6 @@ map_failed:
     GST_ERROR ("failed to map buffer %p", *buffer);
     return FALSE;
   }
-
-unsupported_flags:
-  {
-    GST_OBJECT_UNLOCK (data->payload);
-    gst_rtp_buffer_unmap (&rtp);
-    GST_ERROR ("Cannot add rtp header extensions with mixed header types");
-    return FALSE;
-  }
-}
-
-static gboolean
-foreach_metadata_drop (GstBuffer * buffer, GstMeta ** meta, gpointer user_data)
-{
-  GType drop_api_type = (GType) user_data;
-  const GstMetaInfo *info = (*meta)->info;
-
-  if (info->api == drop_api_type)
-    *meta = NULL;
-
-  return TRUE;
-}
-
-static gboolean
-filter_meta (GstBuffer ** buffer, guint idx, gpointer user_data)
-{
-  return gst_buffer_foreach_meta (*buffer, foreach_metadata_drop,
-      (gpointer) GST_RTP_SOURCE_META_API_TYPE);
 }
 
 /* Updates the SSRC, payload type, seqnum and timestamp of the RTP buffer
@@ -1926,18 +1942,22 @@ gst_rtp_base_payload_prepare_push (GstRTPBasePayload * payload,
     data.rtptime = payload->timestamp;
   }
 
-  /* set ssrc, payload type, seq number, caps and rtptime */
-  /* remove unwanted meta */
+  /* set ssrc, payload type, seq number, caps, rtptime and header extensions,
+   * and remove unwanted meta, in one pass over the packets */
+  GST_OBJECT_LOCK (payload);
+  if (!prepare_header_extensions (&data))
+    GST_ERROR_OBJECT (payload,
+        "Cannot add rtp header extensions with mixed header types");
+
   if (is_list) {
     gst_buffer_list_foreach (GST_BUFFER_LIST_CAST (obj), set_headers, &data);
-    gst_buffer_list_foreach (GST_BUFFER_LIST_CAST (obj), filter_meta, NULL);
     /* sequence number has increased more if this was a buffer list */
     payload->seqnum = data.seqnum - 1;
   } else {
     GstBuffer *buf = GST_BUFFER_CAST (obj);
     set_headers (&buf, 0, &data);
-    filter_meta (&buf, 0, NULL);
   }
+  GST_OBJECT_UNLOCK (payload);
 
   priv->next_seqnum = data.seqnum;
   payload->timestamp = data.rtptime;
@@ -187,6 +187,7 @@ struct _GstRTSPConnection
   gint read_ahead;
 
   gchar *initial_buffer;
+  gsize initial_buffer_size;    /* can hold binary interleaved data */
   gsize initial_buffer_offset;
 
   gboolean remember_session_id; /* remember the session id or not */
@@ -508,6 +509,7 @@ gst_rtsp_connection_create_from_socket (GSocket * socket, const gchar * ip,
   newconn->remote_ip = g_strdup (ip);
   newconn->local_ip = local_ip;
   newconn->initial_buffer = g_strdup (initial_buffer);
+  newconn->initial_buffer_size = initial_buffer ? strlen (initial_buffer) : 0;
 
   *conn = newconn;
 
@@ -1436,7 +1438,7 @@ fill_raw_bytes (GstRTSPConnection * conn, guint8 * buffer, guint size,
   gint out = 0;
 
   if (G_UNLIKELY (conn->initial_buffer != NULL)) {
-    gsize left = strlen (&conn->initial_buffer[conn->initial_buffer_offset]);
+    gsize left = conn->initial_buffer_size - conn->initial_buffer_offset;
 
     out = MIN (left, size);
     memcpy (buffer, &conn->initial_buffer[conn->initial_buffer_offset], out);
@@ -1444,6 +1446,7 @@ fill_raw_bytes (GstRTSPConnection * conn, guint8 * buffer, guint size,
     if (left == (gsize) out) {
       g_free (conn->initial_buffer);
       conn->initial_buffer = NULL;
+      conn->initial_buffer_size = 0;
       conn->initial_buffer_offset = 0;
     } else
       conn->initial_buffer_offset += out;
@@ -1565,6 +1568,77 @@ error:
   }
 }
 
+/* Interleaved data is read in chunks of up to this size */
+#define DATA_PREFETCH_SIZE (64 * 1024)
+
+/* Moves a complete message header that is already waiting on the read socket
+ * into the initial buffer, so that reading it line by line below doesn't
+ * cost a read from the socket for every single byte. Only the header is
+ * taken so that a body or tunnel payload following it stays on the socket.
+ *
+ * Once interleaved data is flowing, the connection is never handed over
+ * anymore, so everything waiting on the socket is taken in one read. The
+ * data messages are then parsed from memory instead of costing three reads
+ * each for the '$', the rest of the header and the packet. */
+static void
+prefetch_header (GstRTSPConnection * conn)
+{
+  gchar buffer[2048];
+  GInputVector vector = { buffer, sizeof (buffer) - 1 };
+  gint flags = G_SOCKET_MSG_PEEK;
+  GIOStream *stream;
+  gchar *end;
+  gssize r;
+
+  if (conn->initial_buffer != NULL || conn->ctxp != NULL ||
+      conn->read_ahead != 0 || conn->read_socket == NULL)
+    return;
+
+  /* the data on the socket must be what we parse */
+  stream = conn->read_socket == conn->socket1 ? conn->stream1 : conn->stream0;
+  if (stream == NULL || G_IS_TLS_CONNECTION (stream))
+    return;
+
+  /* never block here, the normal read path takes care of waiting */
+  if (!(g_socket_condition_check (conn->read_socket, G_IO_IN) & G_IO_IN))
+    return;
+
+  r = g_socket_receive_message (conn->read_socket, NULL, &vector, 1, NULL,
+      NULL, &flags, NULL, NULL);
+  if (r <= 0)
+    return;
+
+  if (buffer[0] == '$') {
+    gchar *data = g_malloc (DATA_PREFETCH_SIZE);
+
+    r = g_socket_receive_with_blocking (conn->read_socket, data,
+        DATA_PREFETCH_SIZE, FALSE, NULL, NULL);
+    if (r <= 0) {
+      g_free (data);
+      return;
+    }
+
+    conn->initial_buffer = data;
+    conn->initial_buffer_size = r;
+    conn->initial_buffer_offset = 0;
+    return;
+  }
+  buffer[r] = '\0';
+
+  /* stops at the first NUL, the initial buffer can't contain any */
+  if ((end = strstr (buffer, "\r\n\r\n")) == NULL)
+    return;
+
+  r = g_socket_receive_with_blocking (conn->read_socket, buffer,
+      end + 4 - buffer, FALSE, NULL, NULL);
+  if (r <= 0)
+    return;
+
+  conn->initial_buffer = g_strndup (buffer, r);
+  conn->initial_buffer_size = r;
+  conn->initial_buffer_offset = 0;
+}
+
 /* The code below tries to handle clients using \r, \n or \r\n to indicate the
  * end of a line. It even does its best to handle clients which mix them (even
  * though this is a really stupid idea (tm).) It also handles Line White Space
@@ -2501,6 +2575,7 @@ build_next (GstRTSPBuilder * builder, GstRTSPMessage * message,
         guint8 c;
 
         builder->offset = 0;
+        prefetch_header (conn);
         res =
             read_bytes (conn, (guint8 *) builder->buffer, &builder->offset, 1,
             block);
@@ -2931,6 +3006,7 @@ gst_rtsp_connection_close (GstRTSPConnection * conn)
 
   g_free (conn->initial_buffer);
   conn->initial_buffer = NULL;
+  conn->initial_buffer_size = 0;
   conn->initial_buffer_offset = 0;
 
   conn->write_socket = NULL;
@@ -3703,6 +3779,7 @@ gst_rtsp_connection_do_tunnel (GstRTSPConnection * conn,
     g_free (conn->initial_buffer);
     conn->initial_buffer = conn2->initial_buffer;
     conn2->initial_buffer = NULL;
+    conn->initial_buffer_size = conn2->initial_buffer_size;
     conn->initial_buffer_offset = conn2->initial_buffer_offset;
   }
 
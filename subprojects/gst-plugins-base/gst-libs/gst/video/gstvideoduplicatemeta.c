@@ -0,0 +1,136 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstvideoduplicatemeta.h"
+
+/**
+ * SECTION:gstvideoduplicatemeta
+ * @title: GstVideoDuplicateMeta
+ * @short_description: GstMeta marking a repeated picture
+ *
+ * Elements that repeat frames, like videorate, can put this meta on the
+ * repeated frames. The frame then contains the same picture as the previous
+ * one, so #GstVideoEncoder sets %GST_VIDEO_CODEC_FRAME_FLAG_DUPLICATE on it
+ * and encoders can output a cheap skip frame instead of encoding the picture
+ * again.
+ *
+ * Since: 1.24
+ */
+
+/**
+ * gst_video_duplicate_meta_api_get_type:
+ *
+ * Returns: #GType for the #GstVideoDuplicateMeta structure.
+ *
+ * Since: 1.24
+ */
+GType
+gst_video_duplicate_meta_api_get_type (void)
+{
+  static GType type = 0;
+  static const gchar *tags[] = { GST_META_TAG_VIDEO_STR, NULL };
+
+  if (g_once_init_enter (&type)) {
+    GType _type =
+        gst_meta_api_type_register ("GstVideoDuplicateMetaAPI", tags);
+    g_once_init_leave (&type, _type);
+  }
+  return type;
+}
+
+static gboolean
+gst_video_duplicate_meta_transform (GstBuffer * dest,
+    GstMeta * meta, GstBuffer * buffer, GQuark type, gpointer data)
+{
+  GstVideoDuplicateMeta *smeta = (GstVideoDuplicateMeta *) meta;
+
+  /* only a copy still has the same picture as the previous frame */
+  if (GST_META_TRANSFORM_IS_COPY (type)) {
+    if (!gst_buffer_add_video_duplicate_meta (dest, smeta->count))
+      return FALSE;
+  }
+  return TRUE;
+}
+
+static gboolean
+gst_video_duplicate_meta_init (GstMeta * meta, gpointer params,
+    GstBuffer * buffer)
+{
+  GstVideoDuplicateMeta *dmeta = (GstVideoDuplicateMeta *) meta;
+
+  dmeta->count = 0;
+
+  return TRUE;
+}
+
+/**
+ * gst_video_duplicate_meta_get_info:
+ *
+ * Returns: #GstMetaInfo pointer that describes #GstVideoDuplicateMeta.
+ *
+ * Since: 1.24
+ */
+const GstMetaInfo *
+gst_video_duplicate_meta_get_info (void)
+{
+  static const GstMetaInfo *info = NULL;
+
+  if (g_once_init_enter ((GstMetaInfo **) & info)) {
+    const GstMetaInfo *meta =
+        gst_meta_register (GST_VIDEO_DUPLICATE_META_API_TYPE,
+        "GstVideoDuplicateMeta",
+        sizeof (GstVideoDuplicateMeta),
+        gst_video_duplicate_meta_init,
+        NULL,
+        gst_video_duplicate_meta_transform);
+    g_once_init_leave ((GstMetaInfo **) & info, (GstMetaInfo *) meta);
+  }
+
+  return info;
+}
+
+/**
+ * gst_buffer_add_video_duplicate_meta:
+ * @buffer: (transfer none): a #GstBuffer
+ * @count: how often the picture was repeated, 1 for the first duplicate
+ *
+ * Attaches a #GstVideoDuplicateMeta metadata to @buffer to mark it as a
+ * repetition of the previous frame.
+ *
+ * Returns: (transfer none): the #GstVideoDuplicateMeta on @buffer.
+ *
+ * Since: 1.24
+ */
+GstVideoDuplicateMeta *
+gst_buffer_add_video_duplicate_meta (GstBuffer * buffer, guint count)
+{
+  GstVideoDuplicateMeta *meta;
+
+  g_return_val_if_fail (buffer != NULL, NULL);
+
+  meta =
+      (GstVideoDuplicateMeta *) gst_buffer_add_meta (buffer,
+      GST_VIDEO_DUPLICATE_META_INFO, NULL);
+  if (meta)
+    meta->count = count;
+
+  return meta;
+}
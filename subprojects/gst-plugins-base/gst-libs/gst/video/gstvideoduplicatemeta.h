@@ -0,0 +1,85 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_VIDEO_DUPLICATE_META_H__
+#define __GST_VIDEO_DUPLICATE_META_H__
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GST_VIDEO_DUPLICATE_META_API_TYPE:
+ *
+ * Since: 1.24
+ */
+#define GST_VIDEO_DUPLICATE_META_API_TYPE (gst_video_duplicate_meta_api_get_type())
+
+/**
+ * GST_VIDEO_DUPLICATE_META_INFO:
+ *
+ * Since: 1.24
+ */
+#define GST_VIDEO_DUPLICATE_META_INFO  (gst_video_duplicate_meta_get_info())
+
+typedef struct _GstVideoDuplicateMeta GstVideoDuplicateMeta;
+
+/**
+ * GstVideoDuplicateMeta:
+ * @meta: parent #GstMeta
+ * @count: how often the picture was repeated, 1 for the first duplicate
+ *
+ * Marks a frame that contains the same picture as the previous frame, for
+ * example a frame duplicated by videorate.
+ *
+ * Since: 1.24
+ */
+struct _GstVideoDuplicateMeta
+{
+  GstMeta meta;
+
+  guint count;
+};
+
+GST_VIDEO_API
+GType gst_video_duplicate_meta_api_get_type          (void);
+
+GST_VIDEO_API
+const GstMetaInfo *gst_video_duplicate_meta_get_info (void);
+
+/**
+ * gst_buffer_get_video_duplicate_meta:
+ * @b: A #GstBuffer pointer
+ *
+ * Helper macro to get #GstVideoDuplicateMeta from an existing #GstBuffer.
+ *
+ * Returns: (nullable): the #GstVideoDuplicateMeta pointer, or %NULL if none.
+ *
+ * Since: 1.24
+ */
+#define gst_buffer_get_video_duplicate_meta(b) \
+    ((GstVideoDuplicateMeta *)gst_buffer_get_meta((b),GST_VIDEO_DUPLICATE_META_API_TYPE))
+
+GST_VIDEO_API
+GstVideoDuplicateMeta *gst_buffer_add_video_duplicate_meta (GstBuffer * buffer,
+                                                            guint count);
+
+G_END_DECLS
+
+#endif /* __GST_VIDEO_DUPLICATE_META_H__ */
@@ -85,6 +85,11 @@
  * use gst_video_encoder_get_max_encode_time() to check if input frames
  * are already late and drop them right away to give a chance to the
  * pipeline to catch up.
+ *
+ * Subclasses able to encode several frames concurrently can enable
+ * frame-level parallelism with gst_video_encoder_set_max_frames_in_flight().
+ * @handle_frame is then called from a pool of worker threads and the base
+ * class pushes the finished frames downstream in input order.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -183,6 +188,18 @@ struct _GstVideoEncoderPrivate
   /* qos messages: frames dropped/processed */
   guint dropped;
   guint processed;
+
+  /* Frame-level parallel encoding,
+   * see gst_video_encoder_set_max_frames_in_flight() */
+  guint max_frames_in_flight;   /* STREAM_LOCK */
+  GThreadPool *frame_pool;      /* STREAM_LOCK */
+  GQueue parallel_order;        /* STREAM_LOCK, frames in input order */
+  GQueue parallel_finished;     /* STREAM_LOCK, frames finished too early */
+  gboolean parallel_pushing;    /* STREAM_LOCK */
+  GMutex parallel_lock;
+  GCond parallel_cond;
+  guint frames_in_flight;       /* parallel_lock */
+  GstFlowReturn parallel_ret;   /* parallel_lock */
 };
 
 typedef struct _ForcedKeyUnitEvent ForcedKeyUnitEvent;
@@ -289,6 +306,11 @@ static gboolean gst_video_encoder_src_query_default (GstVideoEncoder * encoder,
 static gboolean gst_video_encoder_transform_meta_default (GstVideoEncoder *
     encoder, GstVideoCodecFrame * frame, GstMeta * meta);
 
+static GstFlowReturn gst_video_encoder_wait_frames_in_flight (GstVideoEncoder *
+    encoder, guint max_frames);
+static GstFlowReturn gst_video_encoder_do_finish_frame (GstVideoEncoder *
+    encoder, GstVideoCodecFrame * frame);
+
 /* we can't use G_DEFINE_ABSTRACT_TYPE because we need the klass in the _init
  * method to get to the padtemplates */
 GType
@@ -472,7 +494,20 @@ gst_video_encoder_reset (GstVideoEncoder * encoder, gboolean hard)
 
   priv->time_adjustment = GST_CLOCK_TIME_NONE;
 
+  /* Frames still held for ordering will never be pushed now, the frames
+   * themselves are released with priv->frames below */
+  gst_video_encoder_wait_frames_in_flight (encoder, 0);
+  g_queue_clear_full (&priv->parallel_order,
+      (GDestroyNotify) gst_video_codec_frame_unref);
+  g_queue_clear_full (&priv->parallel_finished,
+      (GDestroyNotify) gst_video_codec_frame_unref);
+
   if (hard) {
+    if (priv->frame_pool) {
+      g_thread_pool_free (priv->frame_pool, FALSE, TRUE);
+      priv->frame_pool = NULL;
+    }
+
     gst_segment_init (&encoder->input_segment, GST_FORMAT_TIME);
     gst_segment_init (&encoder->output_segment, GST_FORMAT_TIME);
 
@@ -597,6 +632,13 @@ gst_video_encoder_init (GstVideoEncoder * encoder, GstVideoEncoderClass * klass)
   g_queue_init (&priv->frames);
   g_queue_init (&priv->force_key_unit);
 
+  priv->max_frames_in_flight = 1;
+  g_queue_init (&priv->parallel_order);
+  g_queue_init (&priv->parallel_finished);
+  g_mutex_init (&priv->parallel_lock);
+  g_cond_init (&priv->parallel_cond);
+  priv->parallel_ret = GST_FLOW_OK;
+
   priv->min_latency = 0;
   priv->max_latency = 0;
   priv->min_pts = GST_CLOCK_TIME_NONE;
@@ -755,6 +797,9 @@ gst_video_encoder_setcaps (GstVideoEncoder * encoder, GstCaps * caps)
     encoder_class->reset (encoder, TRUE);
   }
 
+  /* make sure no frame of the previous configuration is still being encoded */
+  gst_video_encoder_wait_frames_in_flight (encoder, 0);
+
   /* and subclass should be ready to configure format at any time around */
   if (encoder_class->set_format != NULL)
     ret = encoder_class->set_format (encoder, state);
@@ -1009,6 +1054,11 @@ gst_video_encoder_finalize (GObject * object)
     encoder->priv->allocator = NULL;
   }
 
+  if (encoder->priv->frame_pool)
+    g_thread_pool_free (encoder->priv->frame_pool, FALSE, TRUE);
+  g_mutex_clear (&encoder->priv->parallel_lock);
+  g_cond_clear (&encoder->priv->parallel_cond);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1125,6 +1175,8 @@ gst_video_encoder_sink_event_default (GstVideoEncoder * encoder,
 
       GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
 
+      gst_video_encoder_wait_frames_in_flight (encoder, 0);
+
       if (encoder_class->finish) {
         flow_ret = encoder_class->finish (encoder);
       } else {
@@ -1251,6 +1303,7 @@ gst_video_encoder_sink_event_default (GstVideoEncoder * encoder,
     }
     case GST_EVENT_FLUSH_STOP:{
       GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+      gst_video_encoder_wait_frames_in_flight (encoder, 0);
       gst_video_encoder_flush (encoder);
       gst_segment_init (&encoder->input_segment, GST_FORMAT_TIME);
       gst_segment_init (&encoder->output_segment, GST_FORMAT_TIME);
@@ -1520,6 +1573,98 @@ gst_video_encoder_new_frame (GstVideoEncoder * encoder, GstBuffer * buf,
   return frame;
 }
 
+static void
+gst_video_encoder_frame_pool_func (GstVideoCodecFrame * frame,
+    GstVideoEncoder * encoder)
+{
+  GstVideoEncoderClass *klass = GST_VIDEO_ENCODER_GET_CLASS (encoder);
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstFlowReturn ret;
+
+  GST_LOG_OBJECT (encoder, "encoding frame %u on worker thread",
+      frame->system_frame_number);
+
+  ret = klass->handle_frame (encoder, frame);
+
+  g_mutex_lock (&priv->parallel_lock);
+  if (priv->parallel_ret == GST_FLOW_OK)
+    priv->parallel_ret = ret;
+  priv->frames_in_flight--;
+  g_cond_broadcast (&priv->parallel_cond);
+  g_mutex_unlock (&priv->parallel_lock);
+}
+
+/* Waits until at most @max_frames are being encoded by the workers and
+ * returns the first non-OK flow return that happened since the last call.
+ * Must be called with the STREAM_LOCK held once, the lock is released
+ * while waiting to let the workers finish their frames */
+static GstFlowReturn
+gst_video_encoder_wait_frames_in_flight (GstVideoEncoder * encoder,
+    guint max_frames)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstFlowReturn ret;
+
+  g_mutex_lock (&priv->parallel_lock);
+  if (priv->frames_in_flight > max_frames) {
+    g_mutex_unlock (&priv->parallel_lock);
+    GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+
+    g_mutex_lock (&priv->parallel_lock);
+    while (priv->frames_in_flight > max_frames)
+      g_cond_wait (&priv->parallel_cond, &priv->parallel_lock);
+    g_mutex_unlock (&priv->parallel_lock);
+
+    GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+    g_mutex_lock (&priv->parallel_lock);
+  }
+  ret = priv->parallel_ret;
+  priv->parallel_ret = GST_FLOW_OK;
+  g_mutex_unlock (&priv->parallel_lock);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_video_encoder_dispatch_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstFlowReturn ret;
+  GError *err = NULL;
+
+  ret = gst_video_encoder_wait_frames_in_flight (encoder,
+      priv->max_frames_in_flight - 1);
+  if (ret != GST_FLOW_OK) {
+    GST_DEBUG_OBJECT (encoder, "not dispatching frame, previous frame "
+        "returned %s", gst_flow_get_name (ret));
+    gst_video_encoder_release_frame (encoder, frame);
+    return ret;
+  }
+
+  if (!priv->frame_pool) {
+    priv->frame_pool =
+        g_thread_pool_new ((GFunc) gst_video_encoder_frame_pool_func, encoder,
+        priv->max_frames_in_flight, FALSE, &err);
+    if (!priv->frame_pool) {
+      GST_ELEMENT_ERROR (encoder, RESOURCE, FAILED, (NULL),
+          ("Failed to create encoding thread pool: %s", err->message));
+      g_clear_error (&err);
+      gst_video_encoder_release_frame (encoder, frame);
+      return GST_FLOW_ERROR;
+    }
+  }
+
+  g_queue_push_tail (&priv->parallel_order, gst_video_codec_frame_ref (frame));
+
+  g_mutex_lock (&priv->parallel_lock);
+  priv->frames_in_flight++;
+  g_mutex_unlock (&priv->parallel_lock);
+
+  g_thread_pool_push (priv->frame_pool, frame, NULL);
+
+  return GST_FLOW_OK;
+}
 
 static GstFlowReturn
 gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
@@ -1587,6 +1732,10 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   frame = gst_video_encoder_new_frame (encoder, buf, cstart,
       GST_CLOCK_TIME_NONE, duration);
 
+  if (gst_buffer_get_video_duplicate_meta (buf))
+    GST_VIDEO_CODEC_FRAME_FLAG_SET (frame,
+        GST_VIDEO_CODEC_FRAME_FLAG_DUPLICATE);
+
   GST_OBJECT_LOCK (encoder);
   if (priv->force_key_unit.head) {
     GList *l;
@@ -1711,7 +1860,15 @@ gst_video_encoder_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
       gst_segment_to_running_time (&encoder->input_segment, GST_FORMAT_TIME,
       frame->pts);
 
-  ret = klass->handle_frame (encoder, frame);
+  if (priv->max_frames_in_flight > 1) {
+    ret = gst_video_encoder_dispatch_frame (encoder, frame);
+  } else {
+    /* frames dispatched before parallelism got disabled must be out first */
+    if (priv->frame_pool)
+      gst_video_encoder_wait_frames_in_flight (encoder, 0);
+
+    ret = klass->handle_frame (encoder, frame);
+  }
 
 done:
   GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
@@ -1763,6 +1920,12 @@ gst_video_encoder_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PAUSED_TO_READY:{
       gboolean stopped = TRUE;
 
+      /* Pads are deactivated, let frames being encoded finish before the
+       * subclass releases its resources */
+      GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+      gst_video_encoder_wait_frames_in_flight (encoder, 0);
+      GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+
       if (encoder_class->stop)
         stopped = encoder_class->stop (encoder);
 
@@ -2505,11 +2668,71 @@ gst_video_encoder_send_key_unit_unlocked (GstVideoEncoder * encoder,
  * considered read-only. This function will also change the metadata
  * of the buffer.
  *
+ * When frames are encoded in parallel (see
+ * gst_video_encoder_set_max_frames_in_flight()), @frame may be finished
+ * before frames that preceded it in input order. It is then kept back and
+ * pushed as soon as all previous frames were finished.
+ *
  * Returns: a #GstFlowReturn resulting from sending data downstream
  */
 GstFlowReturn
 gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
     GstVideoCodecFrame * frame)
+{
+  GstVideoEncoderPrivate *priv = encoder->priv;
+  GstVideoCodecFrame *head;
+  GstFlowReturn ret = GST_FLOW_OK;
+  GList *link;
+
+  g_return_val_if_fail (frame, GST_FLOW_ERROR);
+
+  GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+
+  link = g_queue_find (&priv->parallel_order, frame);
+  if (G_LIKELY (!link)) {
+    ret = gst_video_encoder_do_finish_frame (encoder, frame);
+    GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+    return ret;
+  }
+
+  g_queue_push_tail (&priv->parallel_finished, frame);
+
+  /* Another thread is pushing, it will pick this frame up when its turn
+   * comes, which also happens when the stream lock is released while
+   * pushing downstream */
+  if (priv->parallel_pushing) {
+    GST_LOG_OBJECT (encoder, "frame %u finished, queued",
+        frame->system_frame_number);
+    GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+    return GST_FLOW_OK;
+  }
+
+  priv->parallel_pushing = TRUE;
+  while ((head = g_queue_peek_head (&priv->parallel_order))) {
+    GstFlowReturn flow_ret;
+
+    link = g_queue_find (&priv->parallel_finished, head);
+    if (!link)
+      break;
+
+    g_queue_delete_link (&priv->parallel_finished, link);
+    g_queue_pop_head (&priv->parallel_order);
+    gst_video_codec_frame_unref (head);
+
+    flow_ret = gst_video_encoder_do_finish_frame (encoder, head);
+    if (ret == GST_FLOW_OK)
+      ret = flow_ret;
+  }
+  priv->parallel_pushing = FALSE;
+
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_video_encoder_do_finish_frame (GstVideoEncoder * encoder,
+    GstVideoCodecFrame * frame)
 {
   GstVideoEncoderPrivate *priv = encoder->priv;
   GstFlowReturn ret = GST_FLOW_OK;
@@ -2519,8 +2742,6 @@ gst_video_encoder_finish_frame (GstVideoEncoder * encoder,
   gboolean discont = FALSE;
   GstBuffer *buffer;
 
-  g_return_val_if_fail (frame, GST_FLOW_ERROR);
-
   discont = (frame->presentation_frame_number == 0
       && frame->abidata.ABI.num_subframes == 0);
 
@@ -3212,3 +3433,68 @@ gst_video_encoder_get_min_force_key_unit_interval (GstVideoEncoder * encoder)
 
   return interval;
 }
+
+/**
+ * gst_video_encoder_set_max_frames_in_flight:
+ * @encoder: a #GstVideoEncoder
+ * @max_frames: maximum number of frames being encoded at the same time
+ *
+ * Enables frame-level parallel encoding if @max_frames is larger than 1.
+ * The base class then calls @handle_frame from a pool of up to @max_frames
+ * worker threads, without holding the stream lock, so that up to
+ * @max_frames frames are encoded concurrently.
+ *
+ * This is only suitable for subclasses whose @handle_frame can safely be
+ * called from several threads at once, and which finish every frame
+ * (with gst_video_encoder_finish_frame(), not
+ * gst_video_encoder_finish_subframe()) independently of the following
+ * frames, e.g. intra-only codecs or encoders keeping one context per
+ * thread. Frames finished out of order are reassembled and pushed
+ * downstream in input order by the base class. The flow return values
+ * of @handle_frame are reported from the chain function of the following
+ * frames.
+ *
+ * Since: 1.24
+ */
+void
+gst_video_encoder_set_max_frames_in_flight (GstVideoEncoder * encoder,
+    guint max_frames)
+{
+  GstVideoEncoderPrivate *priv;
+
+  g_return_if_fail (GST_IS_VIDEO_ENCODER (encoder));
+  g_return_if_fail (max_frames > 0);
+
+  priv = encoder->priv;
+
+  GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+  GST_DEBUG_OBJECT (encoder, "max frames in flight %u -> %u",
+      priv->max_frames_in_flight, max_frames);
+  priv->max_frames_in_flight = max_frames;
+  if (priv->frame_pool && max_frames > 1)
+    g_thread_pool_set_max_threads (priv->frame_pool, max_frames, NULL);
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+}
+
+/**
+ * gst_video_encoder_get_max_frames_in_flight:
+ * @encoder: a #GstVideoEncoder
+ *
+ * Returns: the maximum number of frames encoded at the same time, as set
+ *     with gst_video_encoder_set_max_frames_in_flight()
+ *
+ * Since: 1.24
+ */
+guint
+gst_video_encoder_get_max_frames_in_flight (GstVideoEncoder * encoder)
+{
+  guint max_frames;
+
+  g_return_val_if_fail (GST_IS_VIDEO_ENCODER (encoder), 1);
+
+  GST_VIDEO_ENCODER_STREAM_LOCK (encoder);
+  max_frames = encoder->priv->max_frames_in_flight;
+  GST_VIDEO_ENCODER_STREAM_UNLOCK (encoder);
+
+  return max_frames;
+}
@@ -101,6 +101,7 @@ struct _GstVideoBufferPoolPrivate
   GstVideoAlignment video_align;
   gboolean add_videometa;
   gboolean need_alignment;
+  gboolean prefault;
   GstAllocator *allocator;
   GstAllocationParams params;
 };
@@ -115,7 +116,8 @@ static const gchar **
 video_buffer_pool_get_options (GstBufferPool * pool)
 {
   static const gchar *options[] = { GST_BUFFER_POOL_OPTION_VIDEO_META,
-    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT, NULL
+    GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT,
+    GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT, NULL
   };
   return options;
 }
@@ -196,6 +198,10 @@ video_buffer_pool_set_config (GstBufferPool * pool, GstStructure * config)
       gst_buffer_pool_config_set_allocator (config, allocator, &priv->params);
     }
   }
+
+  priv->prefault = gst_buffer_pool_config_has_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT);
+
   info.size = MAX (size, info.size);
   priv->info = info;
 
@@ -235,6 +241,34 @@ failed_to_align:
   }
 }
 
+/* smallest page size there is, writing to each of these touches all pages */
+#define PREFAULT_STRIDE 4096
+
+static void
+video_buffer_pool_prefault (GstBufferPool * pool, GstBuffer * buffer)
+{
+  guint i, n_mem = gst_buffer_n_memory (buffer);
+
+  for (i = 0; i < n_mem; i++) {
+    GstMemory *mem = gst_buffer_peek_memory (buffer, i);
+    GstMapInfo map;
+    gsize offset;
+
+    if (!gst_memory_map (mem, &map, GST_MAP_WRITE)) {
+      GST_DEBUG_OBJECT (pool, "can't map memory %u to prefault it", i);
+      continue;
+    }
+
+    /* the content of new buffers is undefined anyway */
+    for (offset = 0; offset < map.size; offset += PREFAULT_STRIDE)
+      map.data[offset] = 0;
+    if (map.size > 0)
+      map.data[map.size - 1] = 0;
+
+    gst_memory_unmap (mem, &map);
+  }
+}
+
 static GstFlowReturn
 video_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
     GstBufferPoolAcquireParams * params)
@@ -252,6 +286,9 @@ video_buffer_pool_alloc (GstBufferPool * pool, GstBuffer ** buffer,
   if (*buffer == NULL)
     goto no_memory;
 
+  if (priv->prefault)
+    video_buffer_pool_prefault (pool, *buffer);
+
   if (priv->add_videometa) {
     GST_DEBUG_OBJECT (pool, "adding GstVideoMeta");
 
@@ -45,6 +45,19 @@ G_BEGIN_DECLS
  */
 #define GST_BUFFER_POOL_OPTION_VIDEO_ALIGNMENT "GstBufferPoolOptionVideoAlignment"
 
+/**
+ * GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT:
+ *
+ * A bufferpool option to write to every page of the memory of new buffers
+ * when they are allocated. The page faults of the first access then happen
+ * when the pool is activated and allocates its minimum number of buffers
+ * instead of while processing the first frames, which can be noticeable
+ * for large frames.
+ *
+ * Since: 1.24
+ */
+#define GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT "GstBufferPoolOptionVideoPrefault"
+
 /* setting a bufferpool config */
 
 GST_VIDEO_API
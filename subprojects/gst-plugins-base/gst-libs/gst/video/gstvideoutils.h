@@ -105,6 +105,7 @@ struct _GstVideoCodecState
  * @GST_VIDEO_CODEC_FRAME_FLAG_FORCE_KEYFRAME: should the output frame be made a keyframe
  * @GST_VIDEO_CODEC_FRAME_FLAG_FORCE_KEYFRAME_HEADERS: should the encoder output stream headers
  * @GST_VIDEO_CODEC_FRAME_FLAG_CORRUPTED: the buffer data is corrupted (Since: 1.20)
+ * @GST_VIDEO_CODEC_FRAME_FLAG_DUPLICATE: the picture is the same as the previous one (Since: 1.24)
  *
  * Flags for #GstVideoCodecFrame
  */
@@ -122,6 +123,15 @@ typedef enum
    * Since: 1.20
    */
   GST_VIDEO_CODEC_FRAME_FLAG_CORRUPTED = (1<<4),
+  /**
+   * GST_VIDEO_CODEC_FRAME_FLAG_DUPLICATE:
+   *
+   * The frame contains the same picture as the previous frame, see
+   * #GstVideoDuplicateMeta. Encoders can output a skip frame for it.
+   *
+   * Since: 1.24
+   */
+  GST_VIDEO_CODEC_FRAME_FLAG_DUPLICATE = (1<<5),
 } GstVideoCodecFrameFlags;
 
 /**
@@ -283,6 +283,77 @@ G_STMT_START { \
 } G_STMT_END
 
 
+/* x / 255 for 0 <= x <= 255 * 255, without a division */
+#define DIV255(x) (((x) + 1 + ((x) >> 8)) >> 8)
+
+/* Blends non-premultiplied AYUV straight into the planes of 8 bit 4:2:0
+ * frames. This gives the same result as unpacking, blending and packing the
+ * lines again: the chroma of every 2x2 block is blended with the top-left
+ * source pixel of the block only. The loops have no branches so that the
+ * compiler can vectorize them. */
+static void
+blend_ayuv_to_420 (GstVideoFrame * dest, GstVideoFrame * src, gint x, gint y,
+    gint src_xoff, gint src_yoff, gint width, gint height, guint global_alpha)
+{
+  GstVideoFormat format = GST_VIDEO_FRAME_FORMAT (dest);
+  gboolean semi_planar = format == GST_VIDEO_FORMAT_NV12
+      || format == GST_VIDEO_FORMAT_NV21;
+  gint u_comp = format == GST_VIDEO_FORMAT_NV21 ? 1 : 0;
+  gint i, j, cx_start, cx_end;
+  guint a;
+
+  /* the chroma samples whose top-left luma pixel is in the rectangle */
+  cx_start = (x + 1) / 2;
+  cx_end = (x + width + 1) / 2;
+
+  for (i = 0; i < height; i++) {
+    const guint8 *s = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (src, 0) +
+        (src_yoff + i) * GST_VIDEO_FRAME_PLANE_STRIDE (src, 0) + src_xoff * 4;
+    guint8 *dy = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (dest, 0) +
+        (y + i) * GST_VIDEO_FRAME_PLANE_STRIDE (dest, 0) + x;
+
+    for (j = 0; j < width; j++) {
+      a = DIV255 (s[j * 4] * global_alpha);
+      dy[j] = DIV255 (s[j * 4 + 1] * a + dy[j] * (255 - a));
+    }
+
+    if ((y + i) & 1)
+      continue;
+
+    /* s now points at the source pixel of luma column 2 * cx */
+    s -= x * 4;
+
+    if (semi_planar) {
+      guint8 *duv = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (dest, 1) +
+          ((y + i) / 2) * GST_VIDEO_FRAME_PLANE_STRIDE (dest, 1);
+
+      for (j = cx_start; j < cx_end; j++) {
+        const guint8 *sp = s + j * 8;
+        guint8 *du = duv + j * 2 + u_comp, *dv = duv + j * 2 + 1 - u_comp;
+
+        a = DIV255 (sp[0] * global_alpha);
+        *du = DIV255 (sp[2] * a + *du * (255 - a));
+        *dv = DIV255 (sp[3] * a + *dv * (255 - a));
+      }
+    } else {
+      guint8 *du = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (dest, 1) +
+          ((y + i) / 2) * GST_VIDEO_FRAME_COMP_STRIDE (dest, 1);
+      guint8 *dv = (guint8 *) GST_VIDEO_FRAME_COMP_DATA (dest, 2) +
+          ((y + i) / 2) * GST_VIDEO_FRAME_COMP_STRIDE (dest, 2);
+
+      for (j = cx_start; j < cx_end; j++) {
+        const guint8 *sp = s + j * 8;
+
+        a = DIV255 (sp[0] * global_alpha);
+        du[j] = DIV255 (sp[2] * a + du[j] * (255 - a));
+        dv[j] = DIV255 (sp[3] * a + dv[j] * (255 - a));
+      }
+    }
+  }
+}
+
+#undef DIV255
+
 /**
  * gst_video_blend:
  * @dest: The #GstVideoFrame where to blend @src in
@@ -392,6 +463,18 @@ gst_video_blend (GstVideoFrame * dest,
   if (y + src_height > dest_height)
     src_height = dest_height - y;
 
+  if (matrix == matrix_identity && !src_premultiplied_alpha
+      && !dest_premultiplied_alpha
+      && GST_VIDEO_FRAME_FORMAT (src) == GST_VIDEO_FORMAT_AYUV
+      && (GST_VIDEO_FRAME_FORMAT (dest) == GST_VIDEO_FORMAT_I420
+          || GST_VIDEO_FRAME_FORMAT (dest) == GST_VIDEO_FORMAT_YV12
+          || GST_VIDEO_FRAME_FORMAT (dest) == GST_VIDEO_FORMAT_NV12
+          || GST_VIDEO_FRAME_FORMAT (dest) == GST_VIDEO_FORMAT_NV21)) {
+    blend_ayuv_to_420 (dest, src, x, y, src_xoff, src_yoff, src_width,
+        src_height, global_alpha_val);
+    return TRUE;
+  }
+
   tmpsrcline = g_malloc (sizeof (guint8) * (src_width + 8) * 4);
   tmpdestline = g_malloc (sizeof (guint8) * (dest_width + 8) * bpp);
 
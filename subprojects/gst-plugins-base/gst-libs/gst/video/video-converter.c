@@ -38,6 +38,16 @@
 
 #include "video-orc.h"
 
+/* SIMD versions of the semi-planar <-> planar line functions, the formats are
+ * little endian so they are only used on little endian hosts */
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN && (defined (__SSE2__) || defined (_M_X64))
+#include <emmintrin.h>
+#define VIDEO_CONVERTER_SSE2 1
+#elif G_BYTE_ORDER == G_LITTLE_ENDIAN && defined (__ARM_NEON)
+#include <arm_neon.h>
+#define VIDEO_CONVERTER_NEON 1
+#endif
+
 /**
  * SECTION:videoconverter
  * @title: GstVideoConverter
@@ -475,6 +485,8 @@ struct _GstVideoConverter
     GstVideoScaler **scaler;
   } fv_scaler[4];
   FastConvertFunc fconvert[4];
+  /* per thread chroma tiles of the scaling semi-planar <-> planar paths */
+  guint8 **ftile;
 
   /* for parallel async running */
   gpointer tasks[4];
@@ -2308,6 +2320,7 @@ convert_get_alpha_mode (GstVideoConverter * convert)
  *
  * The optional @pool can be used to spawn threads, this is useful when
  * creating new converters rapidly, for example when updating cropping.
+ * It takes precedence over #GST_VIDEO_CONVERTER_OPT_TASK_POOL in @config.
  *
  * Returns (nullable): a #GstVideoConverter or %NULL if conversion is not possible.
  *
@@ -2323,6 +2336,7 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
   gdouble alpha_value;
   gint n_threads, i;
   gboolean async_tasks;
+  GstTaskPool *config_pool = NULL;
 
   g_return_val_if_fail (in_info != NULL, NULL);
   g_return_val_if_fail (out_info != NULL, NULL);
@@ -2453,8 +2467,13 @@ gst_video_converter_new_with_pool (const GstVideoInfo * in_info,
     n_threads = 1;
 
   async_tasks = GET_OPT_ASYNC_TASKS (convert);
+  if (pool == NULL)
+    gst_structure_get (convert->config, GST_VIDEO_CONVERTER_OPT_TASK_POOL,
+        GST_TYPE_TASK_POOL, &config_pool, NULL);
   convert->conversion_runner =
-      gst_parallelized_task_runner_new (n_threads, pool, async_tasks);
+      gst_parallelized_task_runner_new (n_threads, pool ? pool : config_pool,
+      async_tasks);
+  gst_clear_object (&config_pool);
 
   if (video_converter_lookup_fastpath (convert))
     goto done;
@@ -2655,6 +2674,12 @@ gst_video_converter_free (GstVideoConverter * convert)
 
   g_free (convert->borderline);
 
+  if (convert->ftile) {
+    for (i = 0; i < convert->conversion_runner->n_threads; i++)
+      g_free (convert->ftile[i]);
+    g_free (convert->ftile);
+  }
+
   if (convert->config)
     gst_structure_free (convert->config);
 
@@ -3383,6 +3408,297 @@ typedef struct
   gpointer tmpline;
 } FConvertTask;
 
+/* semi-planar <-> planar chroma lines, used by the NV12 <-> I420 and
+ * P010_10LE <-> I420_10LE fast paths. The 16 bit variants also move the
+ * 10 bit samples between the low (I420_10LE) and high (P010) bits. */
+static void
+video_converter_interleave_u8 (guint8 * d, const guint8 * u, const guint8 * v,
+    gint n)
+{
+  gint i = 0;
+
+#if defined (VIDEO_CONVERTER_SSE2)
+  for (; i + 16 <= n; i += 16) {
+    __m128i mu = _mm_loadu_si128 ((const __m128i *) (u + i));
+    __m128i mv = _mm_loadu_si128 ((const __m128i *) (v + i));
+
+    _mm_storeu_si128 ((__m128i *) (d + 2 * i), _mm_unpacklo_epi8 (mu, mv));
+    _mm_storeu_si128 ((__m128i *) (d + 2 * i + 16),
+        _mm_unpackhi_epi8 (mu, mv));
+  }
+#elif defined (VIDEO_CONVERTER_NEON)
+  for (; i + 16 <= n; i += 16) {
+    uint8x16x2_t uv;
+
+    uv.val[0] = vld1q_u8 (u + i);
+    uv.val[1] = vld1q_u8 (v + i);
+    vst2q_u8 (d + 2 * i, uv);
+  }
+#endif
+  for (; i < n; i++) {
+    d[2 * i] = u[i];
+    d[2 * i + 1] = v[i];
+  }
+}
+
+static void
+video_converter_deinterleave_u8 (guint8 * u, guint8 * v, const guint8 * s,
+    gint n)
+{
+  gint i = 0;
+
+#if defined (VIDEO_CONVERTER_SSE2)
+  const __m128i mask = _mm_set1_epi16 (0x00ff);
+
+  for (; i + 16 <= n; i += 16) {
+    __m128i a = _mm_loadu_si128 ((const __m128i *) (s + 2 * i));
+    __m128i b = _mm_loadu_si128 ((const __m128i *) (s + 2 * i + 16));
+
+    _mm_storeu_si128 ((__m128i *) (u + i),
+        _mm_packus_epi16 (_mm_and_si128 (a, mask), _mm_and_si128 (b, mask)));
+    _mm_storeu_si128 ((__m128i *) (v + i),
+        _mm_packus_epi16 (_mm_srli_epi16 (a, 8), _mm_srli_epi16 (b, 8)));
+  }
+#elif defined (VIDEO_CONVERTER_NEON)
+  for (; i + 16 <= n; i += 16) {
+    uint8x16x2_t uv = vld2q_u8 (s + 2 * i);
+
+    vst1q_u8 (u + i, uv.val[0]);
+    vst1q_u8 (v + i, uv.val[1]);
+  }
+#endif
+  for (; i < n; i++) {
+    u[i] = s[2 * i];
+    v[i] = s[2 * i + 1];
+  }
+}
+
+static void
+video_converter_interleave_u16_msb (guint16 * d, const guint16 * u,
+    const guint16 * v, gint n)
+{
+  gint i = 0;
+
+#if defined (VIDEO_CONVERTER_SSE2)
+  for (; i + 8 <= n; i += 8) {
+    __m128i mu = _mm_slli_epi16 (_mm_loadu_si128 ((const __m128i *) (u + i)),
+        6);
+    __m128i mv = _mm_slli_epi16 (_mm_loadu_si128 ((const __m128i *) (v + i)),
+        6);
+
+    _mm_storeu_si128 ((__m128i *) (d + 2 * i), _mm_unpacklo_epi16 (mu, mv));
+    _mm_storeu_si128 ((__m128i *) (d + 2 * i + 8),
+        _mm_unpackhi_epi16 (mu, mv));
+  }
+#elif defined (VIDEO_CONVERTER_NEON)
+  for (; i + 8 <= n; i += 8) {
+    uint16x8x2_t uv;
+
+    uv.val[0] = vshlq_n_u16 (vld1q_u16 (u + i), 6);
+    uv.val[1] = vshlq_n_u16 (vld1q_u16 (v + i), 6);
+    vst2q_u16 (d + 2 * i, uv);
+  }
+#endif
+  for (; i < n; i++) {
+    GST_WRITE_UINT16_LE (d + 2 * i, GST_READ_UINT16_LE (u + i) << 6);
+    GST_WRITE_UINT16_LE (d + 2 * i + 1, GST_READ_UINT16_LE (v + i) << 6);
+  }
+}
+
+static void
+video_converter_deinterleave_u16_msb (guint16 * u, guint16 * v,
+    const guint16 * s, gint n)
+{
+  gint i = 0;
+
+#if defined (VIDEO_CONVERTER_SSE2)
+  const __m128i mask = _mm_set1_epi32 (0xffff);
+
+  for (; i + 8 <= n; i += 8) {
+    /* after the shift all values fit in the signed saturation of packs */
+    __m128i a = _mm_srli_epi16 (_mm_loadu_si128 ((const __m128i *) (s +
+                2 * i)), 6);
+    __m128i b = _mm_srli_epi16 (_mm_loadu_si128 ((const __m128i *) (s +
+                2 * i + 8)), 6);
+
+    _mm_storeu_si128 ((__m128i *) (u + i),
+        _mm_packs_epi32 (_mm_and_si128 (a, mask), _mm_and_si128 (b, mask)));
+    _mm_storeu_si128 ((__m128i *) (v + i),
+        _mm_packs_epi32 (_mm_srli_epi32 (a, 16), _mm_srli_epi32 (b, 16)));
+  }
+#elif defined (VIDEO_CONVERTER_NEON)
+  for (; i + 8 <= n; i += 8) {
+    uint16x8x2_t uv = vld2q_u16 (s + 2 * i);
+
+    vst1q_u16 (u + i, vshrq_n_u16 (uv.val[0], 6));
+    vst1q_u16 (v + i, vshrq_n_u16 (uv.val[1], 6));
+  }
+#endif
+  for (; i < n; i++) {
+    GST_WRITE_UINT16_LE (u + i, GST_READ_UINT16_LE (s + 2 * i) >> 6);
+    GST_WRITE_UINT16_LE (v + i, GST_READ_UINT16_LE (s + 2 * i + 1) >> 6);
+  }
+}
+
+/* move 10 bit samples to the high bits with @to_msb, to the low bits
+ * otherwise */
+static void
+video_converter_shift_u16 (guint16 * d, const guint16 * s, gint n,
+    gboolean to_msb)
+{
+  gint i = 0;
+
+#if defined (VIDEO_CONVERTER_SSE2)
+  for (; i + 8 <= n; i += 8) {
+    __m128i a = _mm_loadu_si128 ((const __m128i *) (s + i));
+
+    a = to_msb ? _mm_slli_epi16 (a, 6) : _mm_srli_epi16 (a, 6);
+    _mm_storeu_si128 ((__m128i *) (d + i), a);
+  }
+#elif defined (VIDEO_CONVERTER_NEON)
+  for (; i + 8 <= n; i += 8) {
+    uint16x8_t a = vld1q_u16 (s + i);
+
+    vst1q_u16 (d + i, to_msb ? vshlq_n_u16 (a, 6) : vshrq_n_u16 (a, 6));
+  }
+#endif
+  for (; i < n; i++) {
+    guint16 val = GST_READ_UINT16_LE (s + i);
+
+    GST_WRITE_UINT16_LE (d + i, to_msb ? val << 6 : val >> 6);
+  }
+}
+
+static void
+convert_NV12_I420_task (FConvertTask * task)
+{
+  gint i, cw = (task->width + 1) / 2;
+
+  for (i = task->height_0; i < task->height_1; i++)
+    memcpy (FRAME_GET_Y_LINE (task->dest, i), FRAME_GET_Y_LINE (task->src, i),
+        task->width);
+
+  for (i = task->height_0 / 2; i < (task->height_1 + 1) / 2; i++)
+    video_converter_deinterleave_u8 (FRAME_GET_U_LINE (task->dest, i),
+        FRAME_GET_V_LINE (task->dest, i),
+        FRAME_GET_PLANE_LINE (task->src, 1, i), cw);
+}
+
+static void
+convert_I420_NV12_task (FConvertTask * task)
+{
+  gint i, cw = (task->width + 1) / 2;
+
+  for (i = task->height_0; i < task->height_1; i++)
+    memcpy (FRAME_GET_Y_LINE (task->dest, i), FRAME_GET_Y_LINE (task->src, i),
+        task->width);
+
+  for (i = task->height_0 / 2; i < (task->height_1 + 1) / 2; i++)
+    video_converter_interleave_u8 (FRAME_GET_PLANE_LINE (task->dest, 1, i),
+        FRAME_GET_U_LINE (task->src, i), FRAME_GET_V_LINE (task->src, i), cw);
+}
+
+static void
+convert_P010_I420_10_task (FConvertTask * task)
+{
+  gint i, cw = (task->width + 1) / 2;
+
+  for (i = task->height_0; i < task->height_1; i++)
+    video_converter_shift_u16 (FRAME_GET_Y_LINE (task->dest, i),
+        FRAME_GET_Y_LINE (task->src, i), task->width, FALSE);
+
+  for (i = task->height_0 / 2; i < (task->height_1 + 1) / 2; i++)
+    video_converter_deinterleave_u16_msb (FRAME_GET_U_LINE (task->dest, i),
+        FRAME_GET_V_LINE (task->dest, i),
+        FRAME_GET_PLANE_LINE (task->src, 1, i), cw);
+}
+
+static void
+convert_I420_10_P010_task (FConvertTask * task)
+{
+  gint i, cw = (task->width + 1) / 2;
+
+  for (i = task->height_0; i < task->height_1; i++)
+    video_converter_shift_u16 (FRAME_GET_Y_LINE (task->dest, i),
+        FRAME_GET_Y_LINE (task->src, i), task->width, TRUE);
+
+  for (i = task->height_0 / 2; i < (task->height_1 + 1) / 2; i++)
+    video_converter_interleave_u16_msb (FRAME_GET_PLANE_LINE (task->dest, 1,
+            i), FRAME_GET_U_LINE (task->src, i), FRAME_GET_V_LINE (task->src,
+            i), cw);
+}
+
+/* the chroma planes of the 4:2:0 semi-planar and planar formats have the
+ * same lines, also for interlaced content, so we can split the frame at any
+ * even line */
+static void
+convert_semiplanar_planar (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest,
+    GstParallelizedTaskFunc func)
+{
+  gint height = convert->in_height;
+  FConvertTask *tasks;
+  FConvertTask **tasks_p;
+  gint n_threads;
+  gint lines_per_thread;
+  gint i;
+
+  n_threads = convert->conversion_runner->n_threads;
+  tasks = convert->tasks[0] =
+      g_renew (FConvertTask, convert->tasks[0], n_threads);
+  tasks_p = convert->tasks_p[0] =
+      g_renew (FConvertTask *, convert->tasks_p[0], n_threads);
+
+  lines_per_thread = GST_ROUND_UP_2 ((height + n_threads - 1) / n_threads);
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].src = src;
+    tasks[i].dest = dest;
+
+    tasks[i].width = convert->in_width;
+    tasks[i].height_0 = i * lines_per_thread;
+    tasks[i].height_1 = tasks[i].height_0 + lines_per_thread;
+    tasks[i].height_1 = MIN (height, tasks[i].height_1);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner, func,
+      (gpointer) tasks_p);
+}
+
+static void
+convert_NV12_I420 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_semiplanar_planar (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_NV12_I420_task);
+}
+
+static void
+convert_I420_NV12 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_semiplanar_planar (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_I420_NV12_task);
+}
+
+static void
+convert_P010_I420_10 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_semiplanar_planar (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_P010_I420_10_task);
+}
+
+static void
+convert_I420_10_P010 (GstVideoConverter * convert, const GstVideoFrame * src,
+    GstVideoFrame * dest)
+{
+  convert_semiplanar_planar (convert, src, dest,
+      (GstParallelizedTaskFunc) convert_I420_10_P010_task);
+}
+
 static void
 convert_I420_YUY2_task (FConvertTask * task)
 {
@@ -7226,6 +7542,188 @@ convert_scale_planes (GstVideoConverter * convert,
   convert_fill_border (convert, dest);
 }
 
+/* number of output chroma lines the scaling semi-planar <-> planar fast
+ * paths scale into a tile before (de)interleaving them into the destination,
+ * small enough for the tile to stay in the cache */
+#define VIDEO_CONVERTER_TILE_LINES 16
+
+typedef struct
+{
+  GstVideoScaler *h_scaler, *v_scaler;
+  const guint8 *s[2];
+  guint8 *d[2];
+  gint sstride[2], dstride[2];
+  guint8 *tile;
+  gint tstride;
+  guint w, y, h;
+} FScaleChromaTask;
+
+/* the scalers address the output lines by their index in the plane, offset
+ * the tile so that line y ends up in its first line */
+#define TILE_FOR_LINE(task,tile,y) ((tile) - (gsize) (y) * (task)->tstride)
+
+static void
+convert_scale_NV12_I420_chroma_task (FScaleChromaTask * task)
+{
+  guint i, y, n;
+
+  for (y = task->y; y < task->h; y += n) {
+    n = MIN (VIDEO_CONVERTER_TILE_LINES, task->h - y);
+
+    gst_video_scaler_2d (task->h_scaler, task->v_scaler, GST_VIDEO_FORMAT_NV12,
+        (guint8 *) task->s[0], task->sstride[0],
+        TILE_FOR_LINE (task, task->tile, y), task->tstride, 0, y, task->w,
+        y + n);
+
+    for (i = 0; i < n; i++)
+      video_converter_deinterleave_u8 (task->d[0] + (y + i) * task->dstride[0],
+          task->d[1] + (y + i) * task->dstride[1],
+          task->tile + i * task->tstride, task->w);
+  }
+}
+
+static void
+convert_scale_I420_NV12_chroma_task (FScaleChromaTask * task)
+{
+  guint8 *tu = task->tile;
+  guint8 *tv = task->tile + VIDEO_CONVERTER_TILE_LINES * task->tstride;
+  guint i, y, n;
+
+  for (y = task->y; y < task->h; y += n) {
+    n = MIN (VIDEO_CONVERTER_TILE_LINES, task->h - y);
+
+    gst_video_scaler_2d (task->h_scaler, task->v_scaler,
+        GST_VIDEO_FORMAT_GRAY8, (guint8 *) task->s[0], task->sstride[0],
+        TILE_FOR_LINE (task, tu, y), task->tstride, 0, y, task->w, y + n);
+    gst_video_scaler_2d (task->h_scaler, task->v_scaler,
+        GST_VIDEO_FORMAT_GRAY8, (guint8 *) task->s[1], task->sstride[1],
+        TILE_FOR_LINE (task, tv, y), task->tstride, 0, y, task->w, y + n);
+
+    for (i = 0; i < n; i++)
+      video_converter_interleave_u8 (task->d[0] + (y + i) * task->dstride[0],
+          tu + i * task->tstride, tv + i * task->tstride, task->w);
+  }
+}
+
+#undef TILE_FOR_LINE
+
+/* Scale between 4:2:0 semi-planar and planar layouts without going through
+ * the unpacked lines: the luma plane is scaled like in convert_scale_planes
+ * and the chroma is scaled at its native layout into a small tile per
+ * thread, which is then (de)interleaved into the destination while it is
+ * still in the cache. The chroma scalers made by setup_scale for plane 1
+ * apply to both chroma components. */
+static void
+convert_scale_semiplanar_planar (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest, gboolean to_planar)
+{
+  gint in_x, in_y, out_x, out_y, out_width, out_height;
+  guint8 *s[2] = { NULL, NULL }, *d[2] = { NULL, NULL };
+  gint sstride[2] = { 0, 0 }, dstride[2] = { 0, 0 }, tstride;
+  FScaleChromaTask *tasks;
+  FScaleChromaTask **tasks_p;
+  gint i, n_threads, lines_per_thread;
+
+  convert->fconvert[0] (convert, src, dest, 0);
+
+  in_x = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (convert->in_info.finfo,
+      GST_VIDEO_COMP_U, convert->in_x);
+  in_y = convert->fin_y[1];
+  out_x = GST_VIDEO_FORMAT_INFO_SCALE_WIDTH (convert->out_info.finfo,
+      GST_VIDEO_COMP_U, convert->out_x);
+  out_y = convert->fout_y[1];
+  out_width = convert->fout_width[1];
+  out_height = convert->fout_height[1];
+
+  if (to_planar) {
+    s[0] = FRAME_GET_PLANE_LINE (src, 1, in_y);
+    s[0] += in_x * 2;
+    sstride[0] = FRAME_GET_PLANE_STRIDE (src, 1);
+    d[0] = FRAME_GET_U_LINE (dest, out_y);
+    d[0] += out_x;
+    dstride[0] = FRAME_GET_U_STRIDE (dest);
+    d[1] = FRAME_GET_V_LINE (dest, out_y);
+    d[1] += out_x;
+    dstride[1] = FRAME_GET_V_STRIDE (dest);
+    tstride = GST_ROUND_UP_16 (out_width * 2);
+  } else {
+    s[0] = FRAME_GET_U_LINE (src, in_y);
+    s[0] += in_x;
+    sstride[0] = FRAME_GET_U_STRIDE (src);
+    s[1] = FRAME_GET_V_LINE (src, in_y);
+    s[1] += in_x;
+    sstride[1] = FRAME_GET_V_STRIDE (src);
+    d[0] = FRAME_GET_PLANE_LINE (dest, 1, out_y);
+    d[0] += out_x * 2;
+    dstride[0] = FRAME_GET_PLANE_STRIDE (dest, 1);
+    tstride = GST_ROUND_UP_16 (out_width);
+  }
+
+  n_threads = convert->conversion_runner->n_threads;
+
+  if (convert->ftile == NULL) {
+    /* room for two planar tiles or one interleaved tile */
+    convert->ftile = g_new (guint8 *, n_threads);
+    for (i = 0; i < n_threads; i++)
+      convert->ftile[i] =
+          g_malloc (2 * VIDEO_CONVERTER_TILE_LINES * GST_ROUND_UP_16 (out_width
+              * 2));
+  }
+
+  tasks = convert->tasks[1] =
+      g_renew (FScaleChromaTask, convert->tasks[1], n_threads);
+  tasks_p = convert->tasks_p[1] =
+      g_renew (FScaleChromaTask *, convert->tasks_p[1], n_threads);
+
+  lines_per_thread = (out_height + n_threads - 1) / n_threads;
+
+  for (i = 0; i < n_threads; i++) {
+    tasks[i].h_scaler =
+        convert->fh_scaler[1].scaler ? convert->fh_scaler[1].scaler[i] : NULL;
+    tasks[i].v_scaler =
+        convert->fv_scaler[1].scaler ? convert->fv_scaler[1].scaler[i] : NULL;
+    tasks[i].s[0] = s[0];
+    tasks[i].s[1] = s[1];
+    tasks[i].sstride[0] = sstride[0];
+    tasks[i].sstride[1] = sstride[1];
+    tasks[i].d[0] = d[0];
+    tasks[i].d[1] = d[1];
+    tasks[i].dstride[0] = dstride[0];
+    tasks[i].dstride[1] = dstride[1];
+    tasks[i].tile = convert->ftile[i];
+    tasks[i].tstride = tstride;
+
+    tasks[i].w = out_width;
+
+    tasks[i].y = i * lines_per_thread;
+    tasks[i].h = tasks[i].y + lines_per_thread;
+    tasks[i].h = MIN (out_height, tasks[i].h);
+
+    tasks_p[i] = &tasks[i];
+  }
+
+  gst_parallelized_task_runner_run (convert->conversion_runner,
+      to_planar ? (GstParallelizedTaskFunc) convert_scale_NV12_I420_chroma_task
+      : (GstParallelizedTaskFunc) convert_scale_I420_NV12_chroma_task,
+      (gpointer) tasks_p);
+
+  convert_fill_border (convert, dest);
+}
+
+static void
+convert_scale_NV12_I420 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_scale_semiplanar_planar (convert, src, dest, TRUE);
+}
+
+static void
+convert_scale_I420_NV12 (GstVideoConverter * convert,
+    const GstVideoFrame * src, GstVideoFrame * dest)
+{
+  convert_scale_semiplanar_planar (convert, src, dest, FALSE);
+}
+
 static GstVideoFormat
 get_scale_format (GstVideoFormat format, gint plane)
 {
@@ -7517,7 +8015,7 @@ setup_scale (GstVideoConverter * convert)
     for (i = 0; i < n_planes; i++) {
       gint out_comp[GST_VIDEO_MAX_COMPONENTS];
       gint comp, j, iw, ih, ow, oh, pstride;
-      gboolean need_v_scaler, need_h_scaler;
+      gboolean need_v_scaler, need_h_scaler, single_comp;
       GstStructure *config;
       gint resample_method;
 
@@ -7586,6 +8084,11 @@ setup_scale (GstVideoConverter * convert)
         GST_DEBUG ("plane %d -> %d (comp %d)", i, convert->fsplane[i], comp);
       }
 
+      /* the halve and double shortcuts need a single 8 bit component in both
+       * planes, the semi-planar <-> planar paths scale interleaved chroma */
+      single_comp = pstride == 1
+          && GST_VIDEO_FORMAT_INFO_PSTRIDE (in_finfo, comp) == 1;
+
       config = gst_structure_copy (convert->config);
 
       resample_method = (i == 0 ? method : cr_method);
@@ -7596,11 +8099,11 @@ setup_scale (GstVideoConverter * convert)
         if (!interlaced && ih == oh) {
           convert->fconvert[i] = convert_plane_hv;
           GST_DEBUG ("plane %d: copy", i);
-        } else if (!interlaced && ih == 2 * oh && pstride == 1
+        } else if (!interlaced && ih == 2 * oh && single_comp
             && resample_method == GST_VIDEO_RESAMPLER_METHOD_LINEAR) {
           convert->fconvert[i] = convert_plane_v_halve;
           GST_DEBUG ("plane %d: vertical halve", i);
-        } else if (!interlaced && 2 * ih == oh && pstride == 1
+        } else if (!interlaced && 2 * ih == oh && single_comp
             && resample_method == GST_VIDEO_RESAMPLER_METHOD_NEAREST) {
           convert->fconvert[i] = convert_plane_v_double;
           GST_DEBUG ("plane %d: vertical double", i);
@@ -7610,11 +8113,11 @@ setup_scale (GstVideoConverter * convert)
           need_v_scaler = TRUE;
         }
       } else if (ih == oh) {
-        if (!interlaced && iw == 2 * ow && pstride == 1
+        if (!interlaced && iw == 2 * ow && single_comp
             && resample_method == GST_VIDEO_RESAMPLER_METHOD_LINEAR) {
           convert->fconvert[i] = convert_plane_h_halve;
           GST_DEBUG ("plane %d: horizontal halve", i);
-        } else if (!interlaced && 2 * iw == ow && pstride == 1
+        } else if (!interlaced && 2 * iw == ow && single_comp
             && resample_method == GST_VIDEO_RESAMPLER_METHOD_NEAREST) {
           convert->fconvert[i] = convert_plane_h_double;
           GST_DEBUG ("plane %d: horizontal double", i);
@@ -7624,11 +8127,11 @@ setup_scale (GstVideoConverter * convert)
           need_h_scaler = TRUE;
         }
       } else {
-        if (!interlaced && iw == 2 * ow && ih == 2 * oh && pstride == 1
+        if (!interlaced && iw == 2 * ow && ih == 2 * oh && single_comp
             && resample_method == GST_VIDEO_RESAMPLER_METHOD_LINEAR) {
           convert->fconvert[i] = convert_plane_hv_halve;
           GST_DEBUG ("plane %d: horizontal/vertical halve", i);
-        } else if (!interlaced && 2 * iw == ow && 2 * ih == oh && pstride == 1
+        } else if (!interlaced && 2 * iw == ow && 2 * ih == oh && single_comp
             && resample_method == GST_VIDEO_RESAMPLER_METHOD_NEAREST) {
           convert->fconvert[i] = convert_plane_hv_double;
           GST_DEBUG ("plane %d: horizontal/vertical double", i);
@@ -7969,6 +8472,29 @@ static const VideoTransform transforms[] = {
   {GST_VIDEO_FORMAT_YVU9, GST_VIDEO_FORMAT_YVU9, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
 
+  /* semiplanar <-> planar */
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_I420},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_YV12, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_NV12_I420},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_I420_NV12},
+  {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, TRUE, FALSE,
+      FALSE, FALSE, FALSE, FALSE, 0, 0, convert_I420_NV12},
+  {GST_VIDEO_FORMAT_P010_10LE, GST_VIDEO_FORMAT_I420_10LE, TRUE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_P010_I420_10},
+  {GST_VIDEO_FORMAT_I420_10LE, GST_VIDEO_FORMAT_P010_10LE, TRUE, FALSE, TRUE,
+      FALSE, FALSE, FALSE, FALSE, FALSE, 0, 0, convert_I420_10_P010},
+
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420, TRUE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_NV12_I420},
+  {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_YV12, TRUE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_NV12_I420},
+  {GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_I420_NV12},
+  {GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, FALSE, TRUE,
+      TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_I420_NV12},
+
   /* sempiplanar -> semiplanar */
   {GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_NV12, TRUE, FALSE, FALSE, TRUE,
       TRUE, FALSE, FALSE, FALSE, 0, 0, convert_scale_planes},
@@ -285,6 +285,20 @@ typedef enum {
  */
 #define GST_VIDEO_CONVERTER_OPT_ASYNC_TASKS   "GstVideoConverter.async-tasks"
 
+/**
+ * GST_VIDEO_CONVERTER_OPT_TASK_POOL:
+ *
+ * #GST_TYPE_TASK_POOL, the pool to run the threads of
+ * #GST_VIDEO_CONVERTER_OPT_THREADS from. Many converters can share one pool,
+ * for example a #GstSharedTaskPool with a thread per core, instead of each
+ * of them starting its own threads. Only used when creating the converter
+ * and ignored when a pool is passed to gst_video_converter_new_with_pool().
+ * Default %NULL.
+ *
+ * Since: 1.24
+ */
+#define GST_VIDEO_CONVERTER_OPT_TASK_POOL   "GstVideoConverter.task-pool"
+
 typedef struct _GstVideoConverter GstVideoConverter;
 
 GST_VIDEO_API
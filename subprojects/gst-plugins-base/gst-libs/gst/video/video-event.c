@@ -330,3 +330,71 @@ gst_video_event_parse_upstream_force_key_unit (GstEvent * event,
 
   return TRUE;
 }
+
+#define GST_VIDEO_EVENT_BANDWIDTH_ESTIMATE_NAME "GstRTPBandwidthEstimate"
+
+/**
+ * gst_video_event_new_bandwidth_estimate:
+ * @bitrate: the estimated available bandwidth in bits per second
+ *
+ * Creates a new upstream bandwidth estimate event. rtpsession sends it
+ * upstream whenever it has a new estimate of the available bandwidth, and
+ * encoders can follow it like a change of their bitrate setting.
+ *
+ * To parse an event created by gst_video_event_new_bandwidth_estimate() use
+ * gst_video_event_parse_bandwidth_estimate().
+ *
+ * Returns: The new GstEvent
+ *
+ * Since: 1.24
+ */
+GstEvent *
+gst_video_event_new_bandwidth_estimate (guint bitrate)
+{
+  GstStructure *s;
+
+  s = gst_structure_new (GST_VIDEO_EVENT_BANDWIDTH_ESTIMATE_NAME,
+      "bitrate", G_TYPE_UINT, bitrate, NULL);
+
+  return gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM, s);
+}
+
+/**
+ * gst_video_event_parse_bandwidth_estimate:
+ * @event: A #GstEvent to parse
+ * @bitrate: (out) (optional): A pointer to the estimated bandwidth in bits
+ *     per second
+ *
+ * Get the estimated bandwidth from a bandwidth estimate event.
+ *
+ * Create a bandwidth estimate event using
+ * gst_video_event_new_bandwidth_estimate()
+ *
+ * Returns: %TRUE if the event is a valid bandwidth estimate event. %FALSE if
+ *     not
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_video_event_parse_bandwidth_estimate (GstEvent * event, guint * bitrate)
+{
+  const GstStructure *s;
+  guint ev_bitrate;
+
+  g_return_val_if_fail (event != NULL, FALSE);
+
+  if (GST_EVENT_TYPE (event) != GST_EVENT_CUSTOM_UPSTREAM)
+    return FALSE;               /* Not a bandwidth estimate event */
+
+  s = gst_event_get_structure (event);
+  if (s == NULL
+      || !gst_structure_has_name (s, GST_VIDEO_EVENT_BANDWIDTH_ESTIMATE_NAME))
+    return FALSE;               /* Not a bandwidth estimate event */
+  if (!gst_structure_get_uint (s, "bitrate", &ev_bitrate))
+    return FALSE;               /* Not a bandwidth estimate event */
+
+  if (bitrate)
+    *bitrate = ev_bitrate;
+
+  return TRUE;
+}
@@ -64,6 +64,15 @@ gboolean gst_video_event_parse_upstream_force_key_unit (GstEvent * event,
 GST_VIDEO_API
 gboolean gst_video_event_is_force_key_unit(GstEvent *event);
 
+/* bandwidth estimate event creation and parsing */
+
+GST_VIDEO_API
+GstEvent * gst_video_event_new_bandwidth_estimate   (guint bitrate);
+
+GST_VIDEO_API
+gboolean   gst_video_event_parse_bandwidth_estimate (GstEvent * event,
+                                                     guint    * bitrate);
+
 G_END_DECLS
 
 #endif /* __GST_VIDEO_EVENT_H__ */
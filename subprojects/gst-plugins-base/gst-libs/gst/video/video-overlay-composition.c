@@ -443,12 +443,9 @@ gst_video_overlay_composition_get_rectangle (GstVideoOverlayComposition * comp,
   return comp->rectangles[n];
 }
 
-static gboolean
-gst_video_overlay_rectangle_needs_scaling (GstVideoOverlayRectangle * r)
-{
-  return (GST_VIDEO_INFO_WIDTH (&r->info) != r->render_width ||
-      GST_VIDEO_INFO_HEIGHT (&r->info) != r->render_height);
-}
+static GstBuffer *gst_video_overlay_rectangle_get_pixels_raw_internal
+    (GstVideoOverlayRectangle * rectangle, GstVideoOverlayFormatFlags flags,
+    gboolean unscaled, GstVideoFormat wanted_format);
 
 /**
  * gst_video_overlay_composition_blend:
@@ -471,10 +468,9 @@ gboolean
 gst_video_overlay_composition_blend (GstVideoOverlayComposition * comp,
     GstVideoFrame * video_buf)
 {
-  GstVideoInfo scaled_info;
-  GstVideoInfo *vinfo;
+  GstVideoInfo rect_info;
   GstVideoFrame rectangle_frame;
-  GstVideoFormat fmt;
+  GstVideoFormat fmt, rect_fmt;
   GstBuffer *pixels = NULL;
   gboolean ret = TRUE;
   guint n, num;
@@ -493,7 +489,6 @@ gst_video_overlay_composition_blend (GstVideoOverlayComposition * comp,
 
   for (n = 0; n < num; ++n) {
     GstVideoOverlayRectangle *rect;
-    gboolean needs_scaling;
 
     rect = comp->rectangles[n];
 
@@ -501,17 +496,33 @@ gst_video_overlay_composition_blend (GstVideoOverlayComposition * comp,
         GST_VIDEO_INFO_WIDTH (&rect->info), GST_VIDEO_INFO_HEIGHT (&rect->info),
         GST_VIDEO_INFO_FORMAT (&rect->info));
 
-    needs_scaling = gst_video_overlay_rectangle_needs_scaling (rect);
-    if (needs_scaling) {
-      gst_video_blend_scale_linear_RGBA (&rect->info, rect->pixels,
-          rect->render_height, rect->render_width, &scaled_info, &pixels);
-      vinfo = &scaled_info;
-    } else {
-      pixels = gst_buffer_ref (rect->pixels);
-      vinfo = &rect->info;
+    /* Get the pixels scaled to the render size and, unless they are
+     * premultiplied, already in the colorspace of the video so that
+     * gst_video_blend() doesn't have to convert every line again for every
+     * frame. Both are cached in the rectangle. The global alpha is applied
+     * while blending. */
+    rect_fmt = GST_VIDEO_INFO_FORMAT (&rect->info);
+    if (!(rect->flags & GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA)) {
+      rect_fmt = GST_VIDEO_INFO_IS_RGB (&video_buf->info) ?
+          GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB :
+          GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_YUV;
     }
 
-    gst_video_frame_map (&rectangle_frame, vinfo, pixels, GST_MAP_READ);
+    pixels = gst_video_overlay_rectangle_get_pixels_raw_internal (rect,
+        rect->flags | GST_VIDEO_OVERLAY_FORMAT_FLAG_GLOBAL_ALPHA, FALSE,
+        rect_fmt);
+
+    gst_video_info_set_format (&rect_info, rect_fmt, rect->render_width,
+        rect->render_height);
+    if (rect->flags & GST_VIDEO_OVERLAY_FORMAT_FLAG_PREMULTIPLIED_ALPHA)
+      GST_VIDEO_INFO_FLAGS (&rect_info) |= GST_VIDEO_FLAG_PREMULTIPLIED_ALPHA;
+
+    if (!gst_video_frame_map (&rectangle_frame, &rect_info, pixels,
+            GST_MAP_READ)) {
+      GST_WARNING ("Could not map overlay rectangle pixels");
+      ret = FALSE;
+      continue;
+    }
 
     ret = gst_video_blend (video_buf, &rectangle_frame, rect->x, rect->y,
         rect->global_alpha);
@@ -519,9 +530,6 @@ gst_video_overlay_composition_blend (GstVideoOverlayComposition * comp,
     if (!ret) {
       GST_WARNING ("Could not blend overlay rectangle onto video buffer");
     }
-
-    /* FIXME: should cache scaled pixels in the rectangle struct */
-    gst_buffer_unref (pixels);
   }
 
   return ret;
@@ -1274,7 +1282,7 @@ gst_video_overlay_rectangle_get_pixels_raw_internal (GstVideoOverlayRectangle *
     conv_rect = gst_video_overlay_rectangle_new_raw (buf,
         0, 0, width, height, rectangle->flags);
     if (rectangle->global_alpha != 1.0)
-      gst_video_overlay_rectangle_set_global_alpha (scaled_rect,
+      gst_video_overlay_rectangle_set_global_alpha (conv_rect,
           rectangle->global_alpha);
     gst_buffer_unref (buf);
     /* keep this converted one around as well in any case */
@@ -183,6 +183,7 @@ G_END_DECLS
 #include <gst/video/gstvideoaggregator.h>
 #include <gst/video/gstvideocodecalphameta.h>
 #include <gst/video/gstvideodecoder.h>
+#include <gst/video/gstvideoduplicatemeta.h>
 #include <gst/video/gstvideoencoder.h>
 #include <gst/video/gstvideofilter.h>
 #include <gst/video/gstvideometa.h>
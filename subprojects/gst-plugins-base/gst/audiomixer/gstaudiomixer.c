@@ -49,6 +49,19 @@
  * * "mute": Whether to mute the pad or not (#gboolean)
  * * "volume": The volume of the pad, between 0.0 and 10.0 (#gdouble)
  *
+ * With many inputs of which only a few carry a signal at a time, like the
+ * participants of a conference, #GstAudioMixer:max-active-pads limits the
+ * mixing to the loudest pads. The level of every pad is then measured while
+ * mixing and available as the "rms" pad property.
+ *
+ * Each sink pad can also get its own output that carries the mix of all
+ * other pads, for example to send every participant of a conference what the
+ * others say but not their own voice. Request a src pad named "minus_N" to
+ * get the mix without the pad "sink_N". It is computed from the full mix by
+ * subtracting the contribution of the pad, so the cost stays linear in the
+ * number of pads. For integer formats the result of clipping in the full mix
+ * is kept in these outputs.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 audiotestsrc freq=100 ! audiomixer name=mix ! audioconvert ! alsasink audiotestsrc freq=500 ! mix.
@@ -63,9 +76,17 @@
 #include "gstaudiomixerelements.h"
 #include "gstaudiomixerorc.h"
 
+#include <math.h>
+#include <stdio.h>
+
 
 #define DEFAULT_PAD_VOLUME (1.0)
 #define DEFAULT_PAD_MUTE (FALSE)
+#define DEFAULT_MAX_ACTIVE_PADS 0
+
+/* how fast the level of a pad falls when it gets quieter, per mixed chunk,
+ * so that short pauses don't make the set of active pads change */
+#define LEVEL_RELEASE 0.1
 
 /* some defines for audio processing */
 /* the volume factor is a range from 0.0 to (arbitrary) VOLUME_MAX_DOUBLE = 10.0
@@ -84,7 +105,8 @@ enum
 {
   PROP_PAD_0,
   PROP_PAD_VOLUME,
-  PROP_PAD_MUTE
+  PROP_PAD_MUTE,
+  PROP_PAD_RMS
 };
 
 G_DEFINE_TYPE (GstAudioMixerPad, gst_audiomixer_pad,
@@ -105,6 +127,12 @@ gst_audiomixer_pad_get_property (GObject * object, guint prop_id,
     case PROP_PAD_MUTE:
       g_value_set_boolean (value, pad->mute);
       break;
+    case PROP_PAD_RMS:
+      GST_OBJECT_LOCK (pad);
+      g_value_set_double (value,
+          pad->level > 0.0 ? MIN (sqrt (pad->level), 1.0) : 0.0);
+      GST_OBJECT_UNLOCK (pad);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -137,6 +165,16 @@ gst_audiomixer_pad_set_property (GObject * object, guint prop_id,
   }
 }
 
+static void
+gst_audiomixer_pad_finalize (GObject * object)
+{
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (object);
+
+  gst_buffer_replace (&pad->contribution, NULL);
+
+  G_OBJECT_CLASS (gst_audiomixer_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
 {
@@ -144,6 +182,7 @@ gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
 
   gobject_class->set_property = gst_audiomixer_pad_set_property;
   gobject_class->get_property = gst_audiomixer_pad_get_property;
+  gobject_class->finalize = gst_audiomixer_pad_finalize;
 
   g_object_class_install_property (gobject_class, PROP_PAD_VOLUME,
       g_param_spec_double ("volume", "Volume", "Volume of this pad",
@@ -153,6 +192,18 @@ gst_audiomixer_pad_class_init (GstAudioMixerPadClass * klass)
       g_param_spec_boolean ("mute", "Mute", "Mute this pad",
           DEFAULT_PAD_MUTE,
           G_PARAM_READWRITE | GST_PARAM_CONTROLLABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAudioMixerPad:rms:
+   *
+   * The smoothed RMS level of the input relative to full scale. It is only
+   * measured when #GstAudioMixer:max-active-pads is set.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PAD_RMS,
+      g_param_spec_double ("rms", "RMS", "RMS level of the input of this pad",
+          0.0, 1.0, 0.0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -160,11 +211,14 @@ gst_audiomixer_pad_init (GstAudioMixerPad * pad)
 {
   pad->volume = DEFAULT_PAD_VOLUME;
   pad->mute = DEFAULT_PAD_MUTE;
+  pad->level = -1.0;
+  pad->active = TRUE;
 }
 
 enum
 {
-  PROP_0
+  PROP_0,
+  PROP_MAX_ACTIVE_PADS
 };
 
 /* These are the formats we can mix natively */
@@ -190,6 +244,13 @@ GST_STATIC_PAD_TEMPLATE ("src",
   GST_STATIC_CAPS (GST_AUDIO_CAPS_MAKE (GST_AUDIO_FORMATS_ALL) \
       ", layout=interleaved")
 
+static GstStaticPadTemplate gst_audiomixer_minus_template =
+GST_STATIC_PAD_TEMPLATE ("minus_%u",
+    GST_PAD_SRC,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (CAPS)
+    );
+
 static GstStaticPadTemplate gst_audiomixer_sink_template =
 GST_STATIC_PAD_TEMPLATE ("sink_%u",
     GST_PAD_SINK,
@@ -212,18 +273,87 @@ static gboolean
 gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
     GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
     GstBuffer * outbuf, guint out_offset, guint num_samples);
+static GstFlowReturn gst_audiomixer_aggregate (GstAggregator * agg,
+    gboolean timeout);
+static GstFlowReturn gst_audiomixer_finish_buffer (GstAggregator * agg,
+    GstBuffer * buffer);
+static GstFlowReturn gst_audiomixer_flush (GstAggregator * agg);
+static GstPadProbeReturn gst_audiomixer_src_event_probe (GstPad * pad,
+    GstPadProbeInfo * info, gpointer user_data);
 
+static void
+gst_audiomixer_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (object);
+
+  switch (prop_id) {
+    case PROP_MAX_ACTIVE_PADS:
+      GST_OBJECT_LOCK (audiomixer);
+      audiomixer->max_active_pads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (audiomixer);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_audiomixer_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (object);
+
+  switch (prop_id) {
+    case PROP_MAX_ACTIVE_PADS:
+      GST_OBJECT_LOCK (audiomixer);
+      g_value_set_uint (value, audiomixer->max_active_pads);
+      GST_OBJECT_UNLOCK (audiomixer);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
 
 static void
 gst_audiomixer_class_init (GstAudioMixerClass * klass)
 {
+  GObjectClass *gobject_class = (GObjectClass *) klass;
   GstElementClass *gstelement_class = (GstElementClass *) klass;
+  GstAggregatorClass *agg_class = (GstAggregatorClass *) klass;
   GstAudioAggregatorClass *aagg_class = (GstAudioAggregatorClass *) klass;
 
+  gobject_class->set_property = gst_audiomixer_set_property;
+  gobject_class->get_property = gst_audiomixer_get_property;
+
+  /**
+   * GstAudioMixer:max-active-pads:
+   *
+   * Only mix the given number of pads with the highest level, measured as
+   * the RMS of their recent input times their volume. Pads with gap buffers
+   * count as silent. 0 mixes all pads.
+   *
+   * Pads are selected before every output buffer based on what they
+   * contributed to the previous ones, pads that were not measured yet are
+   * always mixed.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_ACTIVE_PADS,
+      g_param_spec_uint ("max-active-pads", "Max Active Pads",
+          "Maximum number of pads to mix, the loudest ones (0 = all)",
+          0, G_MAXUINT, DEFAULT_MAX_ACTIVE_PADS,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_audiomixer_src_template, GST_TYPE_AUDIO_AGGREGATOR_CONVERT_PAD);
   gst_element_class_add_static_pad_template_with_gtype (gstelement_class,
       &gst_audiomixer_sink_template, GST_TYPE_AUDIO_MIXER_PAD);
+  gst_element_class_add_static_pad_template (gstelement_class,
+      &gst_audiomixer_minus_template);
   gst_element_class_set_static_metadata (gstelement_class, "AudioMixer",
       "Generic/Audio", "Mixes multiple audio streams",
       "Sebastian Dröge <sebastian@centricular.com>");
@@ -233,6 +363,10 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
   gstelement_class->release_pad =
       GST_DEBUG_FUNCPTR (gst_audiomixer_release_pad);
 
+  agg_class->aggregate = GST_DEBUG_FUNCPTR (gst_audiomixer_aggregate);
+  agg_class->finish_buffer = GST_DEBUG_FUNCPTR (gst_audiomixer_finish_buffer);
+  agg_class->flush = GST_DEBUG_FUNCPTR (gst_audiomixer_flush);
+
   aagg_class->aggregate_one_buffer = gst_audiomixer_aggregate_one_buffer;
 
   gst_type_mark_as_plugin_api (GST_TYPE_AUDIO_MIXER_PAD, 0);
@@ -241,6 +375,149 @@ gst_audiomixer_class_init (GstAudioMixerClass * klass)
 static void
 gst_audiomixer_init (GstAudioMixer * audiomixer)
 {
+  audiomixer->max_active_pads = DEFAULT_MAX_ACTIVE_PADS;
+
+  gst_pad_add_probe (GST_AGGREGATOR_SRC_PAD (audiomixer),
+      GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM | GST_PAD_PROBE_TYPE_EVENT_FLUSH,
+      gst_audiomixer_src_event_probe, NULL, NULL);
+}
+
+static GstPad *
+find_pad_locked (GList * pads, const gchar * format, guint index)
+{
+  gchar *name = g_strdup_printf (format, index);
+  GstPad *pad = NULL;
+
+  for (; pads; pads = pads->next) {
+    if (!g_strcmp0 (GST_OBJECT_NAME (pads->data), name)) {
+      pad = pads->data;
+      break;
+    }
+  }
+  g_free (name);
+
+  return pad;
+}
+
+/* stream-start needs a different stream id on every pad */
+static GstEvent *
+make_minus_event (GstElement * element, GstPad * minus_pad, GstEvent * event)
+{
+  GstEvent *new_event;
+  gchar *stream_id;
+  GstStreamFlags flags;
+  guint group_id;
+
+  if (GST_EVENT_TYPE (event) != GST_EVENT_STREAM_START)
+    return gst_event_ref (event);
+
+  stream_id = gst_pad_create_stream_id (minus_pad, element,
+      GST_OBJECT_NAME (minus_pad));
+  new_event = gst_event_new_stream_start (stream_id);
+  g_free (stream_id);
+
+  gst_event_parse_stream_flags (event, &flags);
+  gst_event_set_stream_flags (new_event, flags);
+  if (gst_event_parse_group_id (event, &group_id))
+    gst_event_set_group_id (new_event, group_id);
+
+  return new_event;
+}
+
+static gboolean
+copy_sticky_event (GstPad * pad, GstEvent ** event, gpointer user_data)
+{
+  GstPad *minus_pad = user_data;
+  GstEvent *new_event;
+
+  new_event = make_minus_event (GST_PAD_PARENT (pad), minus_pad, *event);
+  gst_pad_store_sticky_event (minus_pad, new_event);
+  gst_event_unref (new_event);
+
+  return TRUE;
+}
+
+static GList *
+get_minus_pads (GstAudioMixer * audiomixer)
+{
+  GstElement *element = GST_ELEMENT_CAST (audiomixer);
+  GstPad *srcpad = GST_AGGREGATOR_SRC_PAD (audiomixer);
+  GList *l, *pads = NULL;
+
+  GST_OBJECT_LOCK (audiomixer);
+  for (l = element->srcpads; l; l = l->next) {
+    if (l->data != srcpad)
+      pads = g_list_prepend (pads, gst_object_ref (l->data));
+  }
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  return pads;
+}
+
+/* forward all events of the src pad to the minus pads */
+static GstPadProbeReturn
+gst_audiomixer_src_event_probe (GstPad * pad, GstPadProbeInfo * info,
+    gpointer user_data)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (GST_PAD_PARENT (pad));
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+  GList *l, *pads;
+
+  pads = get_minus_pads (audiomixer);
+  for (l = pads; l; l = l->next) {
+    gst_pad_push_event (l->data, make_minus_event (GST_ELEMENT_CAST
+            (audiomixer), l->data, event));
+  }
+  g_list_free_full (pads, gst_object_unref);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstPad *
+gst_audiomixer_request_minus_pad (GstElement * element, GstPadTemplate * templ,
+    const gchar * req_name)
+{
+  GstAudioMixerPad *sinkpad;
+  GstPad *minus_pad;
+  guint index;
+
+  if (req_name == NULL || sscanf (req_name, "minus_%u", &index) != 1) {
+    GST_WARNING_OBJECT (element, "minus pads need to be named minus_N");
+    return NULL;
+  }
+
+  GST_OBJECT_LOCK (element);
+  if (find_pad_locked (element->srcpads, "minus_%u", index)) {
+    GST_OBJECT_UNLOCK (element);
+    GST_WARNING_OBJECT (element, "pad %s already exists", req_name);
+    return NULL;
+  }
+  GST_OBJECT_UNLOCK (element);
+
+  minus_pad = gst_pad_new_from_template (templ, req_name);
+  gst_pad_use_fixed_caps (minus_pad);
+
+  if (GST_STATE (element) > GST_STATE_READY)
+    gst_pad_set_active (minus_pad, TRUE);
+
+  if (!gst_element_add_pad (element, minus_pad))
+    return NULL;
+
+  gst_pad_sticky_events_foreach (GST_AGGREGATOR_SRC_PAD (element),
+      copy_sticky_event, minus_pad);
+
+  GST_OBJECT_LOCK (element);
+  sinkpad = (GstAudioMixerPad *) find_pad_locked (element->sinkpads,
+      "sink_%u", index);
+  if (sinkpad) {
+    sinkpad->minus_pad = minus_pad;
+    minus_pad->element_private = sinkpad;
+  }
+  GST_OBJECT_UNLOCK (element);
+
+  GST_DEBUG_OBJECT (element, "created minus pad %s", req_name);
+
+  return minus_pad;
 }
 
 static GstPad *
@@ -248,6 +525,11 @@ gst_audiomixer_request_new_pad (GstElement * element, GstPadTemplate * templ,
     const gchar * req_name, const GstCaps * caps)
 {
   GstAudioMixerPad *newpad;
+  GstPad *minus_pad;
+  guint index;
+
+  if (GST_PAD_TEMPLATE_DIRECTION (templ) == GST_PAD_SRC)
+    return gst_audiomixer_request_minus_pad (element, templ, req_name);
 
   newpad = (GstAudioMixerPad *)
       GST_ELEMENT_CLASS (parent_class)->request_new_pad (element,
@@ -256,6 +538,16 @@ gst_audiomixer_request_new_pad (GstElement * element, GstPadTemplate * templ,
   if (newpad == NULL)
     goto could_not_create;
 
+  if (sscanf (GST_OBJECT_NAME (newpad), "sink_%u", &index) == 1) {
+    GST_OBJECT_LOCK (element);
+    minus_pad = find_pad_locked (element->srcpads, "minus_%u", index);
+    if (minus_pad) {
+      newpad->minus_pad = minus_pad;
+      minus_pad->element_private = newpad;
+    }
+    GST_OBJECT_UNLOCK (element);
+  }
+
   gst_child_proxy_child_added (GST_CHILD_PROXY (element), G_OBJECT (newpad),
       GST_OBJECT_NAME (newpad));
 
@@ -277,136 +569,510 @@ gst_audiomixer_release_pad (GstElement * element, GstPad * pad)
 
   GST_DEBUG_OBJECT (audiomixer, "release pad %s:%s", GST_DEBUG_PAD_NAME (pad));
 
+  if (GST_PAD_IS_SRC (pad)) {
+    GstAudioMixerPad *sinkpad;
+
+    GST_OBJECT_LOCK (audiomixer);
+    sinkpad = pad->element_private;
+    if (sinkpad) {
+      sinkpad->minus_pad = NULL;
+      gst_buffer_replace (&sinkpad->contribution, NULL);
+    }
+    pad->element_private = NULL;
+    GST_OBJECT_UNLOCK (audiomixer);
+
+    gst_pad_set_active (pad, FALSE);
+    gst_element_remove_pad (element, pad);
+    return;
+  } else {
+    GstAudioMixerPad *mpad = GST_AUDIO_MIXER_PAD (pad);
+
+    GST_OBJECT_LOCK (audiomixer);
+    if (mpad->minus_pad)
+      mpad->minus_pad->element_private = NULL;
+    mpad->minus_pad = NULL;
+    gst_buffer_replace (&mpad->contribution, NULL);
+    GST_OBJECT_UNLOCK (audiomixer);
+  }
+
   gst_child_proxy_child_removed (GST_CHILD_PROXY (audiomixer), G_OBJECT (pad),
       GST_OBJECT_NAME (pad));
 
   GST_ELEMENT_CLASS (parent_class)->release_pad (element, pad);
 }
 
+#define DEFINE_SUM_SQUARES(type,name,bias) \
+static gdouble \
+sum_squares_##name (const type * data, guint n) \
+{ \
+  gdouble sum = 0.0; \
+  guint i; \
+  \
+  for (i = 0; i < n; i++) { \
+    gdouble s = (gdouble) data[i] - (bias); \
+    sum += s * s; \
+  } \
+  return sum; \
+}
+
+DEFINE_SUM_SQUARES (guint8, u8, 128.0);
+DEFINE_SUM_SQUARES (gint8, s8, 0.0);
+DEFINE_SUM_SQUARES (guint16, u16, 32768.0);
+DEFINE_SUM_SQUARES (gint16, s16, 0.0);
+DEFINE_SUM_SQUARES (guint32, u32, 2147483648.0);
+DEFINE_SUM_SQUARES (gint32, s32, 0.0);
+DEFINE_SUM_SQUARES (gfloat, f32, 0.0);
+DEFINE_SUM_SQUARES (gdouble, f64, 0.0);
+
+/* mean square of @n samples relative to full scale */
+static gdouble
+mean_square (GstAudioFormat format, gconstpointer data, guint n)
+{
+  gdouble sum;
+
+  if (n == 0)
+    return 0.0;
+
+  switch (format) {
+    case GST_AUDIO_FORMAT_U8:
+      sum = sum_squares_u8 (data, n) / (128.0 * 128.0);
+      break;
+    case GST_AUDIO_FORMAT_S8:
+      sum = sum_squares_s8 (data, n) / (128.0 * 128.0);
+      break;
+    case GST_AUDIO_FORMAT_U16:
+      sum = sum_squares_u16 (data, n) / (32768.0 * 32768.0);
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      sum = sum_squares_s16 (data, n) / (32768.0 * 32768.0);
+      break;
+    case GST_AUDIO_FORMAT_U32:
+      sum = sum_squares_u32 (data, n) / (2147483648.0 * 2147483648.0);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      sum = sum_squares_s32 (data, n) / (2147483648.0 * 2147483648.0);
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      sum = sum_squares_f32 (data, n);
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      sum = sum_squares_f64 (data, n);
+      break;
+    default:
+      g_assert_not_reached ();
+      return 0.0;
+  }
+
+  return sum / n;
+}
+
+/* contribution = mix - contribution, the unsigned formats are offset by
+ * bias in both so that cancels out */
+#define DEFINE_MIX_MINUS_INT(type,name,wide,bias,min,max) \
+static void \
+mix_minus_##name (type * contribution, const type * mix, guint n) \
+{ \
+  guint i; \
+  \
+  for (i = 0; i < n; i++) { \
+    wide v = (wide) mix[i] - (wide) contribution[i] + (bias); \
+    contribution[i] = CLAMP (v, (min), (max)); \
+  } \
+}
+
+#define DEFINE_MIX_MINUS_FLOAT(type,name) \
+static void \
+mix_minus_##name (type * contribution, const type * mix, guint n) \
+{ \
+  guint i; \
+  \
+  for (i = 0; i < n; i++) \
+    contribution[i] = mix[i] - contribution[i]; \
+}
+
+DEFINE_MIX_MINUS_INT (guint8, u8, gint, 128, 0, G_MAXUINT8);
+DEFINE_MIX_MINUS_INT (gint8, s8, gint, 0, G_MININT8, G_MAXINT8);
+DEFINE_MIX_MINUS_INT (guint16, u16, gint, 32768, 0, G_MAXUINT16);
+DEFINE_MIX_MINUS_INT (gint16, s16, gint, 0, G_MININT16, G_MAXINT16);
+DEFINE_MIX_MINUS_INT (guint32, u32, gint64, G_GINT64_CONSTANT (2147483648),
+    0, G_MAXUINT32);
+DEFINE_MIX_MINUS_INT (gint32, s32, gint64, 0, G_MININT32, G_MAXINT32);
+DEFINE_MIX_MINUS_FLOAT (gfloat, f32);
+DEFINE_MIX_MINUS_FLOAT (gdouble, f64);
+
+static void
+mix_minus (GstAudioFormat format, gpointer contribution, gconstpointer mix,
+    guint n)
+{
+  switch (format) {
+    case GST_AUDIO_FORMAT_U8:
+      mix_minus_u8 (contribution, mix, n);
+      break;
+    case GST_AUDIO_FORMAT_S8:
+      mix_minus_s8 (contribution, mix, n);
+      break;
+    case GST_AUDIO_FORMAT_U16:
+      mix_minus_u16 (contribution, mix, n);
+      break;
+    case GST_AUDIO_FORMAT_S16:
+      mix_minus_s16 (contribution, mix, n);
+      break;
+    case GST_AUDIO_FORMAT_U32:
+      mix_minus_u32 (contribution, mix, n);
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      mix_minus_s32 (contribution, mix, n);
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      mix_minus_f32 (contribution, mix, n);
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      mix_minus_f64 (contribution, mix, n);
+      break;
+    default:
+      g_assert_not_reached ();
+      break;
+  }
+}
+
+typedef struct
+{
+  GstAudioMixerPad *pad;
+  gdouble loudness;
+} PadLoudness;
 
 static gboolean
-gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
-    GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
-    GstBuffer * outbuf, guint out_offset, guint num_frames)
+collect_pad_loudness (GstElement * element, GstPad * pad, gpointer user_data)
 {
-  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
-  GstMapInfo inmap;
-  GstMapInfo outmap;
-  gint bpf;
-  GstAggregator *agg = GST_AGGREGATOR (aagg);
-  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  GArray *pads = user_data;
+  GstAudioMixerPad *mpad = GST_AUDIO_MIXER_PAD (pad);
+  GstAggregatorPad *aggpad = GST_AGGREGATOR_PAD (pad);
+  GstBuffer *buf;
+  PadLoudness p;
 
-  GST_OBJECT_LOCK (aagg);
-  GST_OBJECT_LOCK (aaggpad);
+  buf = gst_aggregator_pad_peek_buffer (aggpad);
 
-  if (pad->mute || pad->volume < G_MINDOUBLE) {
-    GST_DEBUG_OBJECT (pad, "Skipping muted pad");
-    GST_OBJECT_UNLOCK (aaggpad);
-    GST_OBJECT_UNLOCK (aagg);
-    return FALSE;
+  GST_OBJECT_LOCK (pad);
+  /* gap buffers are not mixed and so not measured, they are silent */
+  if ((buf && GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_GAP)) ||
+      (!buf && gst_aggregator_pad_is_eos (aggpad)))
+    mpad->level = 0.0;
+
+  p.pad = mpad;
+  if (mpad->mute)
+    p.loudness = 0.0;
+  else if (mpad->level < 0.0)
+    p.loudness = G_MAXDOUBLE;
+  else
+    p.loudness = mpad->level * mpad->volume * mpad->volume;
+  GST_OBJECT_UNLOCK (pad);
+
+  if (buf)
+    gst_buffer_unref (buf);
+
+  g_array_append_val (pads, p);
+  gst_object_ref (pad);
+
+  return TRUE;
+}
+
+static gint
+compare_pad_loudness (gconstpointer a, gconstpointer b)
+{
+  const PadLoudness *pa = a, *pb = b;
+
+  if (pa->loudness > pb->loudness)
+    return -1;
+  if (pa->loudness < pb->loudness)
+    return 1;
+  return 0;
+}
+
+static void
+gst_audiomixer_select_active_pads (GstAudioMixer * audiomixer,
+    guint max_active_pads)
+{
+  GArray *pads;
+  guint i;
+
+  pads = g_array_new (FALSE, FALSE, sizeof (PadLoudness));
+  gst_element_foreach_sink_pad (GST_ELEMENT_CAST (audiomixer),
+      collect_pad_loudness, pads);
+
+  g_array_sort (pads, compare_pad_loudness);
+
+  for (i = 0; i < pads->len; i++) {
+    PadLoudness *p = &g_array_index (pads, PadLoudness, i);
+
+    GST_OBJECT_LOCK (p->pad);
+    /* unmeasured pads are always mixed, even above the maximum */
+    p->pad->active = p->pad->level < 0.0 || (i < max_active_pads
+        && p->loudness > 0.0);
+    GST_OBJECT_UNLOCK (p->pad);
+
+    GST_LOG_OBJECT (p->pad, "loudness %g, active %d", p->loudness,
+        p->pad->active);
+    gst_object_unref (p->pad);
   }
 
-  bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
+  g_array_free (pads, TRUE);
+}
 
-  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
-  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
-  GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
-      num_frames * bpf, out_offset * bpf, in_offset * bpf);
+static GstFlowReturn
+gst_audiomixer_aggregate (GstAggregator * agg, gboolean timeout)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (agg);
+  guint max_active_pads;
+
+  GST_OBJECT_LOCK (audiomixer);
+  max_active_pads = audiomixer->max_active_pads;
+  GST_OBJECT_UNLOCK (audiomixer);
 
-  /* further buffers, need to add them */
+  if (max_active_pads > 0)
+    gst_audiomixer_select_active_pads (audiomixer, max_active_pads);
+
+  return GST_AGGREGATOR_CLASS (parent_class)->aggregate (agg, timeout);
+}
+
+static GstFlowReturn
+gst_audiomixer_push_minus (GstAudioMixer * audiomixer, GstPad * minus_pad,
+    GstBuffer * buffer)
+{
+  GstAudioAggregatorPad *srcpad =
+      GST_AUDIO_AGGREGATOR_PAD (GST_AGGREGATOR_SRC_PAD (audiomixer));
+  GstAudioMixerPad *sinkpad;
+  GstBuffer *outbuf = NULL;
+  gsize size = gst_buffer_get_size (buffer);
+  GstAudioFormat format;
+  gint width;
+
+  GST_OBJECT_LOCK (audiomixer);
+  format = GST_AUDIO_INFO_FORMAT (&srcpad->info);
+  width = GST_AUDIO_INFO_WIDTH (&srcpad->info);
+  sinkpad = minus_pad->element_private;
+  if (sinkpad && sinkpad->contribution) {
+    outbuf = sinkpad->contribution;
+    sinkpad->contribution = NULL;
+  }
+  GST_OBJECT_UNLOCK (audiomixer);
+
+  /* the output buffer can get shorter at the end of the stream, but not
+   * longer unless it was converted to new caps, drop the contribution then */
+  if (outbuf && gst_buffer_get_size (outbuf) < size)
+    gst_clear_buffer (&outbuf);
+
+  if (outbuf) {
+    GstMapInfo outmap, map;
+
+    gst_buffer_resize (outbuf, 0, size);
+    gst_buffer_copy_into (outbuf, buffer, GST_BUFFER_COPY_METADATA, 0, -1);
+
+    gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    mix_minus (format, outmap.data, map.data, size * 8 / width);
+    gst_buffer_unmap (buffer, &map);
+    gst_buffer_unmap (outbuf, &outmap);
+  } else {
+    /* the sink pad did not add anything */
+    outbuf = gst_buffer_copy (buffer);
+  }
+
+  return gst_pad_push (minus_pad, outbuf);
+}
+
+static GstFlowReturn
+gst_audiomixer_finish_buffer (GstAggregator * agg, GstBuffer * buffer)
+{
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (agg);
+  GstFlowReturn ret, minus_ret = GST_FLOW_OK;
+  GList *l, *pads;
+
+  pads = get_minus_pads (audiomixer);
+  for (l = pads; l; l = l->next) {
+    GstFlowReturn res;
+
+    res = gst_audiomixer_push_minus (audiomixer, l->data, buffer);
+    GST_LOG_OBJECT (l->data, "pushed buffer, result = %s",
+        gst_flow_get_name (res));
+
+    /* unlinked or finished minus pads are fine, errors are not */
+    if (res < GST_FLOW_EOS && minus_ret == GST_FLOW_OK)
+      minus_ret = res;
+  }
+  g_list_free_full (pads, gst_object_unref);
+
+  ret = GST_AGGREGATOR_CLASS (parent_class)->finish_buffer (agg, buffer);
+  if (ret == GST_FLOW_OK)
+    ret = minus_ret;
+
+  return ret;
+}
+
+static GstFlowReturn
+gst_audiomixer_flush (GstAggregator * agg)
+{
+  GList *l;
+
+  GST_OBJECT_LOCK (agg);
+  for (l = GST_ELEMENT_CAST (agg)->sinkpads; l; l = l->next)
+    gst_buffer_replace (&GST_AUDIO_MIXER_PAD (l->data)->contribution, NULL);
+  GST_OBJECT_UNLOCK (agg);
+
+  return GST_AGGREGATOR_CLASS (parent_class)->flush (agg);
+}
+
+static void
+gst_audiomixer_mix_samples (GstAudioMixerPad * pad, GstAudioFormat format,
+    guint8 * out, const guint8 * in, guint num_samples)
+{
   if (pad->volume == 1.0) {
-    switch (srcpad->info.finfo->format) {
+    switch (format) {
       case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_u8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u8 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_s8 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s8 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_u16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u16 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_s16 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s16 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_u32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_u32 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_s32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_s32 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_f32 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_f32 ((gpointer) out, (gpointer) in, num_samples);
         break;
       case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_f64 ((gpointer) (outmap.data + out_offset * bpf),
-            (gpointer) (inmap.data + in_offset * bpf),
-            num_frames * srcpad->info.channels);
+        audiomixer_orc_add_f64 ((gpointer) out, (gpointer) in, num_samples);
         break;
       default:
         g_assert_not_reached ();
         break;
     }
   } else {
-    switch (srcpad->info.finfo->format) {
+    switch (format) {
       case GST_AUDIO_FORMAT_U8:
-        audiomixer_orc_add_volume_u8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u8 ((gpointer) out, (gpointer) in,
+            pad->volume_i8, num_samples);
         break;
       case GST_AUDIO_FORMAT_S8:
-        audiomixer_orc_add_volume_s8 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i8, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s8 ((gpointer) out, (gpointer) in,
+            pad->volume_i8, num_samples);
         break;
       case GST_AUDIO_FORMAT_U16:
-        audiomixer_orc_add_volume_u16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u16 ((gpointer) out, (gpointer) in,
+            pad->volume_i16, num_samples);
         break;
       case GST_AUDIO_FORMAT_S16:
-        audiomixer_orc_add_volume_s16 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i16, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s16 ((gpointer) out, (gpointer) in,
+            pad->volume_i16, num_samples);
         break;
       case GST_AUDIO_FORMAT_U32:
-        audiomixer_orc_add_volume_u32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_u32 ((gpointer) out, (gpointer) in,
+            pad->volume_i32, num_samples);
         break;
       case GST_AUDIO_FORMAT_S32:
-        audiomixer_orc_add_volume_s32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume_i32, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_s32 ((gpointer) out, (gpointer) in,
+            pad->volume_i32, num_samples);
         break;
       case GST_AUDIO_FORMAT_F32:
-        audiomixer_orc_add_volume_f32 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_f32 ((gpointer) out, (gpointer) in,
+            pad->volume, num_samples);
         break;
       case GST_AUDIO_FORMAT_F64:
-        audiomixer_orc_add_volume_f64 ((gpointer) (outmap.data +
-                out_offset * bpf), (gpointer) (inmap.data + in_offset * bpf),
-            pad->volume, num_frames * srcpad->info.channels);
+        audiomixer_orc_add_volume_f64 ((gpointer) out, (gpointer) in,
+            pad->volume, num_samples);
         break;
       default:
         g_assert_not_reached ();
         break;
     }
   }
+}
+
+static gboolean
+gst_audiomixer_aggregate_one_buffer (GstAudioAggregator * aagg,
+    GstAudioAggregatorPad * aaggpad, GstBuffer * inbuf, guint in_offset,
+    GstBuffer * outbuf, guint out_offset, guint num_frames)
+{
+  GstAudioMixerPad *pad = GST_AUDIO_MIXER_PAD (aaggpad);
+  GstMapInfo inmap;
+  GstMapInfo outmap;
+  gint bpf;
+  GstAggregator *agg = GST_AGGREGATOR (aagg);
+  GstAudioAggregatorPad *srcpad = GST_AUDIO_AGGREGATOR_PAD (agg->srcpad);
+  GstAudioMixer *audiomixer = GST_AUDIO_MIXER (aagg);
+
+  GST_OBJECT_LOCK (aagg);
+  GST_OBJECT_LOCK (aaggpad);
+
+  if (pad->mute || pad->volume < G_MINDOUBLE) {
+    GST_DEBUG_OBJECT (pad, "Skipping muted pad");
+    GST_OBJECT_UNLOCK (aaggpad);
+    GST_OBJECT_UNLOCK (aagg);
+    return FALSE;
+  }
+
+  bpf = GST_AUDIO_INFO_BPF (&srcpad->info);
+
+  gst_buffer_map (inbuf, &inmap, GST_MAP_READ);
+
+  if (audiomixer->max_active_pads > 0) {
+    gdouble level;
+
+    /* measure also the pads that are not mixed, so they can become active */
+    level = mean_square (srcpad->info.finfo->format,
+        inmap.data + in_offset * bpf, num_frames * srcpad->info.channels);
+    if (pad->level < 0.0 || level > pad->level)
+      pad->level = level;
+    else
+      pad->level += (level - pad->level) * LEVEL_RELEASE;
+
+    if (!pad->active) {
+      GST_LOG_OBJECT (pad, "Skipping inactive pad");
+      gst_buffer_unmap (inbuf, &inmap);
+      GST_OBJECT_UNLOCK (aaggpad);
+      GST_OBJECT_UNLOCK (aagg);
+      return FALSE;
+    }
+  }
+
+  gst_buffer_map (outbuf, &outmap, GST_MAP_READWRITE);
+  GST_LOG_OBJECT (pad, "mixing %u bytes at offset %u from offset %u",
+      num_frames * bpf, out_offset * bpf, in_offset * bpf);
+
+  gst_audiomixer_mix_samples (pad, srcpad->info.finfo->format,
+      outmap.data + out_offset * bpf, inmap.data + in_offset * bpf,
+      num_frames * srcpad->info.channels);
+
+  /* keep what this pad added, to leave it out of its minus pad */
+  if (pad->minus_pad) {
+    GstMapInfo cmap;
+
+    if (pad->contribution
+        && gst_buffer_get_size (pad->contribution) != outmap.size)
+      gst_clear_buffer (&pad->contribution);
+
+    if (pad->contribution == NULL) {
+      pad->contribution = gst_buffer_new_allocate (NULL, outmap.size, NULL);
+      gst_buffer_map (pad->contribution, &cmap, GST_MAP_WRITE);
+      gst_audio_format_info_fill_silence (srcpad->info.finfo, cmap.data,
+          cmap.size);
+    } else {
+      gst_buffer_map (pad->contribution, &cmap, GST_MAP_READWRITE);
+    }
+
+    gst_audiomixer_mix_samples (pad, srcpad->info.finfo->format,
+        cmap.data + out_offset * bpf, inmap.data + in_offset * bpf,
+        num_frames * srcpad->info.channels);
+    gst_buffer_unmap (pad->contribution, &cmap);
+  }
   gst_buffer_unmap (inbuf, &inmap);
   gst_buffer_unmap (outbuf, &outmap);
 
@@ -41,6 +41,8 @@ G_DECLARE_FINAL_TYPE (GstAudioMixer, gst_audiomixer, GST, AUDIO_MIXER,
  */
 struct _GstAudioMixer {
   GstAudioAggregator element;
+
+  guint max_active_pads;
 };
 
 #define GST_TYPE_AUDIO_MIXER_PAD (gst_audiomixer_pad_get_type())
@@ -55,6 +57,16 @@ struct _GstAudioMixerPad {
   gint volume_i16;
   gint volume_i8;
   gboolean mute;
+
+  /* smoothed mean square of the input, < 0 until measured */
+  gdouble level;
+  /* whether the pad is mixed, with max-active-pads */
+  gboolean active;
+
+  /* the minus pad without this pad, and what this pad added to the current
+   * output buffer for it, protected by the element's object lock */
+  GstPad *minus_pad;
+  GstBuffer *contribution;
 };
 
 G_END_DECLS
@@ -491,7 +491,7 @@ gst_audio_test_src_create_sine_##type (GstAudioTestSrc * src, g##type * samples)
 { \
   gint i, c, channels, channel_step, sample_step; \
   gdouble step, amp; \
-  g##type *ptr; \
+  g##type *ptr, val; \
   \
   channels = GST_AUDIO_INFO_CHANNELS (&src->info); \
   if (GST_AUDIO_INFO_LAYOUT (&src->info) == GST_AUDIO_LAYOUT_INTERLEAVED) { \
@@ -509,9 +509,11 @@ gst_audio_test_src_create_sine_##type (GstAudioTestSrc * src, g##type * samples)
     if (src->accumulator >= M_PI_M2) \
       src->accumulator -= M_PI_M2; \
     \
+    /* all channels carry the same sample */ \
+    val = (g##type) (sin (src->accumulator) * amp); \
     ptr = samples; \
     for (c = 0; c < channels; ++c) { \
-      *ptr = (g##type) (sin (src->accumulator) * amp); \
+      *ptr = val; \
       ptr += channel_step; \
     } \
     samples += sample_step; \
@@ -869,7 +871,7 @@ gst_audio_test_src_create_sine_table_##type (GstAudioTestSrc * src, g##type * sa
 { \
   gint i, c, channels, channel_step, sample_step; \
   gdouble step, scl; \
-  g##type *ptr; \
+  g##type *ptr, val; \
   \
   channels = GST_AUDIO_INFO_CHANNELS (&src->info); \
   if (GST_AUDIO_INFO_LAYOUT (&src->info) == GST_AUDIO_LAYOUT_INTERLEAVED) { \
@@ -887,9 +889,10 @@ gst_audio_test_src_create_sine_table_##type (GstAudioTestSrc * src, g##type * sa
     if (src->accumulator >= M_PI_M2) \
       src->accumulator -= M_PI_M2; \
     \
+    val = (g##type) scale * src->wave_table[(gint) (src->accumulator * scl)]; \
     ptr = samples; \
     for (c = 0; c < channels; ++c) { \
-      *ptr = (g##type) scale * src->wave_table[(gint) (src->accumulator * scl)]; \
+      *ptr = val; \
       ptr += channel_step; \
     } \
     samples += sample_step; \
@@ -662,6 +662,16 @@ gst_compositor_pad_create_conversion_info (GstVideoAggregatorConvertPad * pad,
   }
 }
 
+static void
+gst_compositor_pad_finalize (GObject * object)
+{
+  GstCompositorPad *pad = GST_COMPOSITOR_PAD (object);
+
+  gst_clear_buffer (&pad->last_buffer);
+
+  G_OBJECT_CLASS (gst_compositor_pad_parent_class)->finalize (object);
+}
+
 static void
 gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 {
@@ -673,6 +683,7 @@ gst_compositor_pad_class_init (GstCompositorPadClass * klass)
 
   gobject_class->set_property = gst_compositor_pad_set_property;
   gobject_class->get_property = gst_compositor_pad_get_property;
+  gobject_class->finalize = gst_compositor_pad_finalize;
 
   g_object_class_install_property (gobject_class, PROP_PAD_XPOS,
       g_param_spec_int ("xpos", "X Position", "X Position of the picture",
@@ -742,6 +753,11 @@ gst_compositor_pad_init (GstCompositorPad * compo_pad)
 #define DEFAULT_BACKGROUND COMPOSITOR_BACKGROUND_CHECKER
 #define DEFAULT_ZERO_SIZE_IS_UNSCALED TRUE
 #define DEFAULT_MAX_THREADS 0
+#define DEFAULT_SKIP_UNCHANGED FALSE
+
+/* height of the bands of the output that are blended again when the inputs
+ * covering them changed, with skip-unchanged */
+#define DIRTY_BAND_HEIGHT 16
 
 enum
 {
@@ -750,6 +766,7 @@ enum
   PROP_ZERO_SIZE_IS_UNSCALED,
   PROP_MAX_THREADS,
   PROP_IGNORE_INACTIVE_PADS,
+  PROP_SKIP_UNCHANGED,
 };
 
 static void
@@ -772,6 +789,11 @@ gst_compositor_get_property (GObject * object,
       g_value_set_boolean (value,
           gst_aggregator_get_ignore_inactive_pads (GST_AGGREGATOR (object)));
       break;
+    case PROP_SKIP_UNCHANGED:
+      GST_OBJECT_LOCK (self);
+      g_value_set_boolean (value, self->skip_unchanged);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -786,7 +808,10 @@ gst_compositor_set_property (GObject * object,
 
   switch (prop_id) {
     case PROP_BACKGROUND:
+      GST_OBJECT_LOCK (self);
       self->background = g_value_get_enum (value);
+      self->canvas_valid = FALSE;
+      GST_OBJECT_UNLOCK (self);
       break;
     case PROP_ZERO_SIZE_IS_UNSCALED:
       self->zero_size_is_unscaled = g_value_get_boolean (value);
@@ -798,6 +823,23 @@ gst_compositor_set_property (GObject * object,
       gst_aggregator_set_ignore_inactive_pads (GST_AGGREGATOR (object),
           g_value_get_boolean (value));
       break;
+    case PROP_SKIP_UNCHANGED:
+      GST_OBJECT_LOCK (self);
+      self->skip_unchanged = g_value_get_boolean (value);
+      self->canvas_valid = FALSE;
+      if (!self->skip_unchanged) {
+        GList *l;
+
+        gst_clear_buffer (&self->canvas);
+        for (l = GST_ELEMENT (self)->sinkpads; l; l = l->next) {
+          GstCompositorPad *pad = l->data;
+
+          gst_clear_buffer (&pad->last_buffer);
+          pad->last_drawn = FALSE;
+        }
+      }
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1462,6 +1504,11 @@ _negotiated_caps (GstAggregator * agg, GstCaps * caps)
     gst_clear_object (&pool);
   }
 
+  GST_OBJECT_LOCK (vagg);
+  gst_clear_buffer (&compositor->canvas);
+  compositor->canvas_valid = FALSE;
+  GST_OBJECT_UNLOCK (vagg);
+
   if (compositor->intermediate_frame) {
     GstStructure *config = NULL;
     GstTaskPool *pool = gst_video_aggregator_get_execution_task_pool (vagg);
@@ -1485,10 +1532,22 @@ static gboolean
 gst_composior_stop (GstAggregator * agg)
 {
   GstCompositor *self = GST_COMPOSITOR (agg);
+  GList *l;
 
   gst_clear_buffer (&self->intermediate_frame);
   g_clear_pointer (&self->intermediate_convert, gst_video_converter_free);
 
+  GST_OBJECT_LOCK (self);
+  gst_clear_buffer (&self->canvas);
+  self->canvas_valid = FALSE;
+  for (l = GST_ELEMENT (self)->sinkpads; l; l = l->next) {
+    GstCompositorPad *pad = l->data;
+
+    gst_clear_buffer (&pad->last_buffer);
+    pad->last_drawn = FALSE;
+  }
+  GST_OBJECT_UNLOCK (self);
+
   return GST_AGGREGATOR_CLASS (parent_class)->stop (agg);
 }
 
@@ -1550,6 +1609,8 @@ struct CompositeTask
   gboolean draw_background;
   guint n_pads;
   struct CompositePadInfo *pads_info;
+  /* bands of DIRTY_BAND_HEIGHT lines to blend, or NULL for all lines */
+  const guint8 *dirty_bands;
 };
 
 static void
@@ -1612,7 +1673,7 @@ _draw_background (GstCompositor * comp, GstVideoFrame * outframe,
 }
 
 static void
-blend_pads (struct CompositeTask *comp)
+blend_pads_lines (struct CompositeTask *comp, guint line_start, guint line_end)
 {
   BlendFunction composite;
   guint i;
@@ -1620,29 +1681,194 @@ blend_pads (struct CompositeTask *comp)
   composite = comp->compositor->blend;
 
   if (comp->draw_background) {
-    _draw_background (comp->compositor, comp->out_frame, comp->dst_line_start,
-        comp->dst_line_end, &composite);
+    _draw_background (comp->compositor, comp->out_frame, line_start, line_end,
+        &composite);
   }
 
   for (i = 0; i < comp->n_pads; i++) {
     composite (comp->pads_info[i].prepared_frame,
         comp->pads_info[i].pad->xpos + comp->pads_info[i].pad->x_offset,
         comp->pads_info[i].pad->ypos + comp->pads_info[i].pad->y_offset,
-        comp->pads_info[i].pad->alpha, comp->out_frame, comp->dst_line_start,
-        comp->dst_line_end, comp->pads_info[i].blend_mode);
+        comp->pads_info[i].pad->alpha, comp->out_frame, line_start, line_end,
+        comp->pads_info[i].blend_mode);
+  }
+}
+
+static void
+blend_pads (struct CompositeTask *comp)
+{
+  guint band, end;
+
+  if (comp->dirty_bands == NULL) {
+    blend_pads_lines (comp, comp->dst_line_start, comp->dst_line_end);
+    return;
+  }
+
+  /* blend each run of dirty bands at once, dst_line_start is at the start of
+   * a band then */
+  for (band = comp->dst_line_start / DIRTY_BAND_HEIGHT;
+      band * DIRTY_BAND_HEIGHT < comp->dst_line_end; band = end) {
+    end = band + 1;
+    if (!comp->dirty_bands[band])
+      continue;
+
+    while (end * DIRTY_BAND_HEIGHT < comp->dst_line_end
+        && comp->dirty_bands[end])
+      end++;
+
+    blend_pads_lines (comp, band * DIRTY_BAND_HEIGHT,
+        MIN (end * DIRTY_BAND_HEIGHT, comp->dst_line_end));
   }
 }
 
+static guint
+_mark_dirty_bands (guint8 * dirty_bands, const GstVideoRectangle * rect)
+{
+  guint band, n = 0;
+
+  if (rect->w <= 0 || rect->h <= 0)
+    return 0;
+
+  for (band = rect->y / DIRTY_BAND_HEIGHT;
+      band <= (rect->y + rect->h - 1) / DIRTY_BAND_HEIGHT; band++) {
+    if (!dirty_bands[band]) {
+      dirty_bands[band] = TRUE;
+      n++;
+    }
+  }
+
+  return n;
+}
+
+/* Compare what every pad blends now with what it blended for the previous
+ * output frame and mark the bands covered by pads that changed. Returns the
+ * number of dirty bands. Must be called with the object lock. */
+static guint
+_update_dirty_bands (GstCompositor * self, const GstVideoFrame * outframe,
+    guint8 * dirty_bands)
+{
+  GList *l;
+  guint index = 0, n_dirty = 0;
+
+  for (l = GST_ELEMENT (self)->sinkpads; l; l = l->next, index++) {
+    GstVideoAggregatorPad *vpad = l->data;
+    GstCompositorPad *pad = GST_COMPOSITOR_PAD (vpad);
+    GstVideoFrame *prepared_frame =
+        gst_video_aggregator_pad_get_prepared_frame (vpad);
+    GstBuffer *buffer = NULL;
+    GstVideoRectangle rect = { 0, };
+    gboolean drawn = prepared_frame != NULL;
+
+    if (drawn) {
+      buffer = gst_video_aggregator_pad_get_current_buffer (vpad);
+      rect = clamp_rectangle (pad->xpos + pad->x_offset,
+          pad->ypos + pad->y_offset, GST_VIDEO_FRAME_WIDTH (prepared_frame),
+          GST_VIDEO_FRAME_HEIGHT (prepared_frame),
+          GST_VIDEO_FRAME_WIDTH (outframe), GST_VIDEO_FRAME_HEIGHT (outframe));
+    }
+
+    if (drawn == pad->last_drawn && (!drawn || (buffer == pad->last_buffer
+                && rect.x == pad->last_rect.x && rect.y == pad->last_rect.y
+                && rect.w == pad->last_rect.w && rect.h == pad->last_rect.h
+                && pad->alpha == pad->last_alpha && pad->op == pad->last_op
+                && index == pad->last_index)))
+      continue;
+
+    GST_LOG_OBJECT (pad, "changed since the previous frame");
+
+    if (pad->last_drawn)
+      n_dirty += _mark_dirty_bands (dirty_bands, &pad->last_rect);
+    if (drawn)
+      n_dirty += _mark_dirty_bands (dirty_bands, &rect);
+
+    /* keeping a ref makes sure the buffer can't come back with other
+     * content from a pool */
+    gst_buffer_replace (&pad->last_buffer, buffer);
+    pad->last_drawn = drawn;
+    pad->last_rect = rect;
+    pad->last_alpha = pad->alpha;
+    pad->last_op = pad->op;
+    pad->last_index = index;
+  }
+
+  return n_dirty;
+}
+
+/* Split the output lines between the tasks so that every task blends about
+ * the same number of pixels. With many small inputs, like in a mosaic, a
+ * split by number of lines gives the threads very different amounts of
+ * work depending on how many pads cover their lines. */
+static void
+_split_lines_by_fill (const GstVideoFrame * outframe,
+    struct CompositePadInfo *pads_info, guint n_pads, gboolean draw_background,
+    struct CompositeTask *tasks, guint n_threads)
+{
+  guint out_width = GST_VIDEO_FRAME_WIDTH (outframe);
+  guint out_height = GST_VIDEO_FRAME_HEIGHT (outframe);
+  gint64 *fill_change, fill, total = 0, done = 0;
+  guint i, line, start = 0;
+
+  /* fill_change[line] is how much more is blended on @line than on the
+   * line before it */
+  fill_change = g_new0 (gint64, out_height + 1);
+  if (draw_background) {
+    fill_change[0] += out_width;
+    fill_change[out_height] -= out_width;
+  }
+
+  for (i = 0; i < n_pads; i++) {
+    GstCompositorPad *pad = pads_info[i].pad;
+    GstVideoRectangle rect;
+
+    rect = clamp_rectangle (pad->xpos + pad->x_offset,
+        pad->ypos + pad->y_offset,
+        GST_VIDEO_FRAME_WIDTH (pads_info[i].prepared_frame),
+        GST_VIDEO_FRAME_HEIGHT (pads_info[i].prepared_frame), out_width,
+        out_height);
+    if (rect.w <= 0 || rect.h <= 0)
+      continue;
+
+    fill_change[rect.y] += rect.w;
+    fill_change[rect.y + rect.h] -= rect.w;
+    total += (gint64) rect.w * rect.h;
+  }
+
+  if (draw_background)
+    total += (gint64) out_width * out_height;
+
+  fill = 0;
+  line = 0;
+  for (i = 0; i < n_threads; i++) {
+    gint64 target = total * (i + 1) / n_threads;
+
+    /* every line costs something, even if nothing is blended on it */
+    while (line < out_height && (done < target || i == n_threads - 1)) {
+      fill += fill_change[line];
+      done += MAX (fill, 1);
+      line++;
+    }
+
+    tasks[i].dst_line_start = start;
+    tasks[i].dst_line_end = line;
+    start = line;
+  }
+
+  g_free (fill_change);
+}
+
 static GstFlowReturn
 gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
 {
   GstCompositor *compositor = GST_COMPOSITOR (vagg);
   GList *l;
-  GstVideoFrame out_frame, intermediate_frame, *outframe;
+  GstVideoFrame out_frame, intermediate_frame, canvas_frame, *outframe;
   gboolean draw_background;
   guint drawn_a_pad = FALSE;
   struct CompositePadInfo *pads_info;
   guint i, n_pads = 0;
+  gboolean skip_unchanged, use_canvas = FALSE;
+  guint8 *dirty_bands = NULL;
+  guint n_bands = 0, n_dirty = 0;
 
   if (!gst_video_frame_map (&out_frame, &vagg->info, outbuf, GST_MAP_WRITE)) {
     GST_WARNING_OBJECT (vagg, "Could not map output buffer");
@@ -1663,6 +1889,29 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
     outframe = &intermediate_frame;
   }
 
+  GST_OBJECT_LOCK (vagg);
+  skip_unchanged = compositor->skip_unchanged;
+  if (skip_unchanged && !compositor->intermediate_frame) {
+    /* the intermediate frame already keeps the previous frame */
+    if (!compositor->canvas) {
+      compositor->canvas = gst_buffer_new_and_alloc (vagg->info.size);
+      compositor->canvas_valid = FALSE;
+    }
+    use_canvas = TRUE;
+  }
+  GST_OBJECT_UNLOCK (vagg);
+
+  if (use_canvas) {
+    if (!gst_video_frame_map (&canvas_frame, &vagg->info, compositor->canvas,
+            GST_MAP_READWRITE)) {
+      GST_WARNING_OBJECT (vagg, "Could not map canvas buffer");
+      gst_video_frame_unmap (&out_frame);
+      return GST_FLOW_ERROR;
+    }
+
+    outframe = &canvas_frame;
+  }
+
   /* If one of the frames to be composited completely obscures the background,
    * don't bother drawing the background at all. We can also always use the
    * 'blend' BlendFunction in that case because it only changes if we have to
@@ -1684,6 +1933,24 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
   if (n_pads == 0)
     draw_background = TRUE;
 
+  if (skip_unchanged) {
+    n_bands = (GST_VIDEO_FRAME_HEIGHT (outframe) + DIRTY_BAND_HEIGHT - 1) /
+        DIRTY_BAND_HEIGHT;
+    dirty_bands = g_newa (guint8, n_bands);
+    memset (dirty_bands, 0, n_bands);
+
+    n_dirty = _update_dirty_bands (compositor, outframe, dirty_bands);
+    if (!compositor->canvas_valid)
+      n_dirty = n_bands;
+    compositor->canvas_valid = TRUE;
+
+    GST_LOG_OBJECT (vagg, "%u of %u bands changed", n_dirty, n_bands);
+
+    /* everything changed, blend like without skip-unchanged */
+    if (n_dirty == n_bands)
+      dirty_bands = NULL;
+  }
+
   pads_info = g_newa (struct CompositePadInfo, n_pads);
   n_pads = 0;
 
@@ -1714,7 +1981,7 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
        * background, and @prepared_frame has the same format, height, and width
        * as @outframe, then we can just copy it as-is. Subsequent pads (if any)
        * will be composited on top of it. */
-      if (!drawn_a_pad && !draw_background &&
+      if (!drawn_a_pad && !draw_background && dirty_bands == NULL &&
           frames_can_copy (prepared_frame, outframe)) {
         gst_video_frame_copy (outframe, prepared_frame);
       } else {
@@ -1727,11 +1994,12 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
     }
   }
 
-  {
+  if (!skip_unchanged || n_dirty > 0) {
     guint n_threads, lines_per_thread;
     guint out_height;
     struct CompositeTask *tasks;
     struct CompositeTask **tasks_p;
+    guint band = 0, dirty_per_thread = 0;
 
     n_threads = compositor->blend_runner->n_threads;
 
@@ -1740,6 +2008,8 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
 
     out_height = GST_VIDEO_FRAME_HEIGHT (outframe);
     lines_per_thread = (out_height + n_threads - 1) / n_threads;
+    if (dirty_bands)
+      dirty_per_thread = (n_dirty + n_threads - 1) / n_threads;
 
     for (i = 0; i < n_threads; i++) {
       tasks[i].compositor = compositor;
@@ -1747,16 +2017,28 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
       tasks[i].pads_info = pads_info;
       tasks[i].out_frame = outframe;
       tasks[i].draw_background = draw_background;
-      /* This is a dumb split of the work by number of output lines.
-       * If there is a section of the output that reads from a lot of source
-       * pads, then that thread will consume more time. Maybe tracking and
-       * splitting on the source fill rate would produce better results. */
       tasks[i].dst_line_start = i * lines_per_thread;
       tasks[i].dst_line_end = MIN ((i + 1) * lines_per_thread, out_height);
+      tasks[i].dirty_bands = dirty_bands;
+
+      /* only some bands are blended, split those evenly instead */
+      if (dirty_bands) {
+        guint n = 0;
+
+        tasks[i].dst_line_start = MIN (band * DIRTY_BAND_HEIGHT, out_height);
+        while (band < n_bands && n < dirty_per_thread)
+          n += dirty_bands[band++];
+        tasks[i].dst_line_end = i == n_threads - 1 ? out_height :
+            MIN (band * DIRTY_BAND_HEIGHT, out_height);
+      }
 
       tasks_p[i] = &tasks[i];
     }
 
+    if (n_threads > 1 && !dirty_bands)
+      _split_lines_by_fill (outframe, pads_info, n_pads, draw_background,
+          tasks, n_threads);
+
     gst_parallelized_task_runner_run (compositor->blend_runner,
         (GstParallelizedTaskFunc) blend_pads, (gpointer *) tasks_p);
   }
@@ -1770,6 +2052,11 @@ gst_compositor_aggregate_frames (GstVideoAggregator * vagg, GstBuffer * outbuf)
     gst_video_frame_unmap (&intermediate_frame);
   }
 
+  if (use_canvas) {
+    gst_video_frame_copy (&out_frame, &canvas_frame);
+    gst_video_frame_unmap (&canvas_frame);
+  }
+
   gst_video_frame_unmap (&out_frame);
 
   return GST_FLOW_OK;
@@ -1812,6 +2099,11 @@ gst_compositor_release_pad (GstElement * element, GstPad * pad)
   gst_child_proxy_child_removed (GST_CHILD_PROXY (compositor), G_OBJECT (pad),
       GST_OBJECT_NAME (pad));
 
+  /* blend everything again without the area of the pad */
+  GST_OBJECT_LOCK (compositor);
+  compositor->canvas_valid = FALSE;
+  GST_OBJECT_UNLOCK (compositor);
+
   GST_ELEMENT_CLASS (parent_class)->release_pad (element, pad);
 }
 
@@ -2032,6 +2324,24 @@ gst_compositor_class_init (GstCompositorClass * klass)
           "Avoid timing out waiting for inactive pads", FALSE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * compositor:skip-unchanged:
+   *
+   * Keep the previous output frame and only blend the bands of it again
+   * that are covered by inputs that changed since then: a pad that shows the
+   * same buffer at the same position, size, alpha and operator does not
+   * cause its area to be blended again.
+   *
+   * This is useful when most inputs are static, like slides or overlays,
+   * and costs a copy of the output frame otherwise.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_SKIP_UNCHANGED,
+      g_param_spec_boolean ("skip-unchanged", "Skip unchanged",
+          "Only blend the parts of the output again whose inputs changed",
+          DEFAULT_SKIP_UNCHANGED, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_type_mark_as_plugin_api (GST_TYPE_COMPOSITOR_PAD, 0);
   gst_type_mark_as_plugin_api (GST_TYPE_COMPOSITOR_OPERATOR, 0);
   gst_type_mark_as_plugin_api (GST_TYPE_COMPOSITOR_BACKGROUND, 0);
@@ -2044,6 +2354,7 @@ gst_compositor_init (GstCompositor * self)
   self->background = DEFAULT_BACKGROUND;
   self->zero_size_is_unscaled = DEFAULT_ZERO_SIZE_IS_UNSCALED;
   self->max_threads = DEFAULT_MAX_THREADS;
+  self->skip_unchanged = DEFAULT_SKIP_UNCHANGED;
 }
 
 /* GstChildProxy implementation */
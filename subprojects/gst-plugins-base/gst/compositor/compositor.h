@@ -154,6 +154,12 @@ struct _GstCompositor
   GstVideoConverter *intermediate_convert;
 
   GstParallelizedTaskRunner *blend_runner;
+
+  /* with skip-unchanged, the previous output is kept in the canvas (or the
+   * intermediate frame) and only bands of it are blended again */
+  gboolean skip_unchanged;
+  GstBuffer *canvas;
+  gboolean canvas_valid;
 };
 
 /**
@@ -177,6 +183,14 @@ struct _GstCompositorPad
    * keep-aspect-ratio */
   gint x_offset;
   gint y_offset;
+
+  /* what was blended for the previous output frame, for skip-unchanged */
+  gboolean last_drawn;
+  GstBuffer *last_buffer;
+  GstVideoRectangle last_rect;
+  gdouble last_alpha;
+  GstCompositorOperator last_op;
+  guint last_index;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (compositor);
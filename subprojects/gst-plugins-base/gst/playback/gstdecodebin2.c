@@ -167,6 +167,7 @@ struct _GstDecodeBin
   GMutex factories_lock;
   guint32 factories_cookie;     /* Cookie from last time when factories was updated */
   GList *factories;             /* factories we can use for selecting elements */
+  GstPlaybackFactoryIndex *factories_index;     /* factories by media type */
 
   GMutex subtitle_lock;         /* Protects changes to subtitles and encoding */
   GList *subtitles;             /* List of elements with subtitle-encoding,
@@ -1044,6 +1045,7 @@ gst_decode_bin_update_factories_list (GstDecodeBin * dbin)
 
   cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
   if (!dbin->factories || dbin->factories_cookie != cookie) {
+    gst_playback_factory_index_free (dbin->factories_index);
     if (dbin->factories)
       gst_plugin_feature_list_free (dbin->factories);
     factories =
@@ -1070,6 +1072,7 @@ gst_decode_bin_update_factories_list (GstDecodeBin * dbin)
     dbin->factories =
         g_list_sort (dbin->factories,
         gst_playback_utils_compare_factories_func);
+    dbin->factories_index = gst_playback_factory_index_new (dbin->factories);
     dbin->factories_cookie = cookie;
   }
 }
@@ -1147,6 +1150,8 @@ gst_decode_bin_dispose (GObject * object)
 
   decode_bin = GST_DECODE_BIN (object);
 
+  gst_playback_factory_index_free (decode_bin->factories_index);
+  decode_bin->factories_index = NULL;
   if (decode_bin->factories)
     gst_plugin_feature_list_free (decode_bin->factories);
   decode_bin->factories = NULL;
@@ -1420,8 +1425,8 @@ gst_decode_bin_autoplug_factories (GstElement * element, GstPad * pad,
   g_mutex_lock (&dbin->factories_lock);
   gst_decode_bin_update_factories_list (dbin);
   list =
-      gst_element_factory_list_filter (dbin->factories, caps, GST_PAD_SINK,
-      gst_caps_is_fixed (caps));
+      gst_playback_factory_index_filter (dbin->factories_index, caps,
+      GST_PAD_SINK, gst_caps_is_fixed (caps));
   g_mutex_unlock (&dbin->factories_lock);
 
   result = g_value_array_new (g_list_length (list));
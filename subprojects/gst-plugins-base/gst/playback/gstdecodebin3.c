@@ -33,6 +33,7 @@
 #include "gstplaybackelements.h"
 #include "gstplay-enum.h"
 #include "gstrawcaps.h"
+#include "gstplaybackutils.h"
 
 /**
  * SECTION:element-decodebin3
@@ -155,6 +156,11 @@
  * We want to ensure we re-use decoders when switching streams. This takes place
  * at the multiqueue output level.
  *
+ * Decoders that are no longer used by an output are not destroyed right away
+ * but kept (in READY) in a small pool of idle decoders, so that switching back
+ * and forth between streams (or renditions) with compatible caps doesn't
+ * require instantiating and opening a new decoder each time.
+ *
  * MAIN CONCEPTS
  *  1) Activating a stream (i.e. linking a slot to an output) is only done within
  *    the streaming thread in the multiqueue_src_probe() and only if the
@@ -182,6 +188,9 @@ GST_DEBUG_CATEGORY_STATIC (decodebin3_debug);
 
 #define EXTRA_DEBUG 1
 
+/* Maximum number of unused decoders kept around for reuse */
+#define MAX_IDLE_DECODERS 2
+
 #define CUSTOM_FINAL_EOS_QUARK _custom_final_eos_quark_get ()
 #define CUSTOM_FINAL_EOS_QUARK_DATA "custom-final-eos"
 static GQuark
@@ -230,6 +239,7 @@ struct _GstDecodebin3
   GList *output_streams;        /* List of DecodebinOutputStream used for output */
   GList *slots;                 /* List of MultiQueueSlot */
   guint slot_id;
+  GList *idle_decoders;         /* Unused decoders, in locked READY state */
 
   /* Active collection */
   GstStreamCollection *collection;
@@ -258,6 +268,9 @@ struct _GstDecodebin3
   GList *decoder_factories;
   /* DECODABLE but not DECODER factories */
   GList *decodable_factories;
+  /* decoder_factories and decodable_factories by media type */
+  GstPlaybackFactoryIndex *decoder_index;
+  GstPlaybackFactoryIndex *decodable_index;
 
   /* counters for pads */
   guint32 apadcount, vpadcount, tpadcount, opadcount;
@@ -502,6 +515,8 @@ static void free_output_stream (GstDecodebin3 * dbin,
     DecodebinOutputStream * output);
 static DecodebinOutputStream *create_output_stream (GstDecodebin3 * dbin,
     GstStreamType type);
+static void release_decoder (GstDecodebin3 * dbin, GstElement * decoder);
+static void flush_idle_decoders (GstDecodebin3 * dbin);
 
 static GstPadProbeReturn slot_unassign_probe (GstPad * pad,
     GstPadProbeInfo * info, MultiQueueSlot * slot);
@@ -652,6 +667,7 @@ gst_decodebin3_reset (GstDecodebin3 * dbin)
   }
   g_list_free (dbin->output_streams);
   dbin->output_streams = NULL;
+  flush_idle_decoders (dbin);
 
   /* Free multiqueue slots */
   for (tmp = dbin->slots; tmp; tmp = tmp->next) {
@@ -701,6 +717,10 @@ gst_decodebin3_dispose (GObject * object)
     gst_plugin_feature_list_free (dbin->factories);
     dbin->factories = NULL;
   }
+  gst_playback_factory_index_free (dbin->decoder_index);
+  dbin->decoder_index = NULL;
+  gst_playback_factory_index_free (dbin->decodable_index);
+  dbin->decodable_index = NULL;
   if (dbin->decoder_factories) {
     g_list_free (dbin->decoder_factories);
     dbin->decoder_factories = NULL;
@@ -1242,7 +1262,7 @@ is_parsebin_required_for_input (GstDecodebin3 * dbin, DecodebinInput * input,
     g_mutex_lock (&dbin->factories_lock);
     gst_decode_bin_update_factories_list (dbin);
     decoder_list =
-        gst_element_factory_list_filter (dbin->decoder_factories, newcaps,
+        gst_playback_factory_index_filter (dbin->decoder_index, newcaps,
         GST_PAD_SINK, TRUE);
     g_mutex_unlock (&dbin->factories_lock);
     if (decoder_list) {
@@ -1482,6 +1502,8 @@ gst_decode_bin_update_factories_list (GstDecodebin3 * dbin)
   cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
   if (!dbin->factories || dbin->factories_cookie != cookie) {
     GList *tmp;
+    gst_playback_factory_index_free (dbin->decoder_index);
+    gst_playback_factory_index_free (dbin->decodable_index);
     if (dbin->factories)
       gst_plugin_feature_list_free (dbin->factories);
     if (dbin->decoder_factories)
@@ -1507,6 +1529,10 @@ gst_decode_bin_update_factories_list (GstDecodebin3 * dbin)
         dbin->decodable_factories =
             g_list_append (dbin->decodable_factories, fact);
     }
+    dbin->decoder_index =
+        gst_playback_factory_index_new (dbin->decoder_factories);
+    dbin->decodable_index =
+        gst_playback_factory_index_new (dbin->decodable_factories);
   }
 }
 
@@ -2660,11 +2686,11 @@ have_factory (GstDecodebin3 * dbin, GstCaps * caps,
   gst_decode_bin_update_factories_list (dbin);
   if (ftype == GST_ELEMENT_FACTORY_TYPE_DECODER)
     res =
-        gst_element_factory_list_filter (dbin->decoder_factories,
+        gst_playback_factory_index_filter (dbin->decoder_index,
         caps, GST_PAD_SINK, TRUE);
   else
     res =
-        gst_element_factory_list_filter (dbin->decodable_factories,
+        gst_playback_factory_index_filter (dbin->decodable_index,
         caps, GST_PAD_SINK, TRUE);
   g_mutex_unlock (&dbin->factories_lock);
 
@@ -2684,7 +2710,7 @@ create_decoder_factory_list (GstDecodebin3 * dbin, GstCaps * caps)
 
   g_mutex_lock (&dbin->factories_lock);
   gst_decode_bin_update_factories_list (dbin);
-  res = gst_element_factory_list_filter (dbin->decoder_factories,
+  res = gst_playback_factory_index_filter (dbin->decoder_index,
       caps, GST_PAD_SINK, TRUE);
   g_mutex_unlock (&dbin->factories_lock);
   return res;
@@ -2708,6 +2734,28 @@ keyframe_waiter_probe (GstPad * pad, GstPadProbeInfo * info,
   return GST_PAD_PROBE_DROP;
 }
 
+/* Returns an idle decoder accepting @caps, removed from the pool but still in
+ * locked state, or NULL */
+static GstElement *
+get_idle_decoder (GstDecodebin3 * dbin, GstCaps * caps)
+{
+  GList *tmp;
+
+  for (tmp = dbin->idle_decoders; tmp; tmp = tmp->next) {
+    GstElement *decoder = tmp->data;
+    GstPad *sinkpad = gst_element_get_static_pad (decoder, "sink");
+    gboolean accepted = gst_pad_query_accept_caps (sinkpad, caps);
+
+    gst_object_unref (sinkpad);
+    if (accepted) {
+      dbin->idle_decoders = g_list_delete_link (dbin->idle_decoders, tmp);
+      return decoder;
+    }
+  }
+
+  return NULL;
+}
+
 /* Returns FALSE if the output couldn't be properly configured and the
  * associated GstStreams should be disabled */
 static gboolean
@@ -2778,10 +2826,7 @@ reconfigure_output_stream (DecodebinOutputStream * output,
       goto cleanup;
     }
 
-    gst_element_set_locked_state (output->decoder, TRUE);
-    gst_element_set_state (output->decoder, GST_STATE_NULL);
-
-    gst_bin_remove ((GstBin *) dbin, output->decoder);
+    release_decoder (dbin, output->decoder);
     output->decoder = NULL;
     output->decoder_latency = GST_CLOCK_TIME_NONE;
   } else if (output->linked) {
@@ -2800,9 +2845,34 @@ reconfigure_output_stream (DecodebinOutputStream * output,
 
   /* If a decoder is required, create one */
   if (needs_decoder) {
-    GList *factories, *next_factory;
+    GList *factories = NULL, *next_factory;
+
+    output->decoder = get_idle_decoder (dbin, new_caps);
+    if (output->decoder) {
+      GST_DEBUG_OBJECT (dbin, "Reusing idle decoder %" GST_PTR_FORMAT
+          " for slot %p", output->decoder, slot);
+      gst_element_set_locked_state (output->decoder, FALSE);
+      output->decoder_sink =
+          gst_element_get_static_pad (output->decoder, "sink");
+      output->decoder_src = gst_element_get_static_pad (output->decoder, "src");
+      if (output->type & GST_STREAM_TYPE_VIDEO) {
+        GST_DEBUG_OBJECT (dbin, "Adding keyframe-waiter probe");
+        output->drop_probe_id =
+            gst_pad_add_probe (slot->src_pad, GST_PAD_PROBE_TYPE_BUFFER,
+            (GstPadProbeCallback) keyframe_waiter_probe, output, NULL);
+      }
+      if (gst_pad_link_full (slot->src_pad, output->decoder_sink,
+              GST_PAD_LINK_CHECK_NOTHING) != GST_PAD_LINK_OK) {
+        GST_ERROR_OBJECT (dbin, "could not link to %s:%s",
+            GST_DEBUG_PAD_NAME (output->decoder_sink));
+        ret = FALSE;
+        goto cleanup;
+      }
+    } else {
+      factories = create_decoder_factory_list (dbin, new_caps);
+    }
 
-    factories = next_factory = create_decoder_factory_list (dbin, new_caps);
+    next_factory = factories;
     while (!output->decoder) {
       gboolean decoder_failed = FALSE;
 
@@ -3514,14 +3584,51 @@ free_output_stream (GstDecodebin3 * dbin, DecodebinOutputStream * output)
   if (output->src_exposed) {
     gst_element_remove_pad ((GstElement *) dbin, output->src_pad);
   }
-  if (output->decoder) {
-    gst_element_set_locked_state (output->decoder, TRUE);
-    gst_element_set_state (output->decoder, GST_STATE_NULL);
-    gst_bin_remove ((GstBin *) dbin, output->decoder);
-  }
+  if (output->decoder)
+    release_decoder (dbin, output->decoder);
   g_free (output);
 }
 
+/* Puts @decoder, which isn't used by any output anymore, in the pool of idle
+ * decoders. The oldest idle decoder is discarded if there are too many */
+static void
+release_decoder (GstDecodebin3 * dbin, GstElement * decoder)
+{
+  gst_element_set_locked_state (decoder, TRUE);
+  if (gst_element_set_state (decoder,
+          GST_STATE_READY) != GST_STATE_CHANGE_FAILURE) {
+    GST_DEBUG_OBJECT (dbin, "Keeping idle decoder %" GST_PTR_FORMAT, decoder);
+    dbin->idle_decoders = g_list_prepend (dbin->idle_decoders, decoder);
+    decoder = NULL;
+
+    if (g_list_length (dbin->idle_decoders) > MAX_IDLE_DECODERS) {
+      GList *oldest = g_list_last (dbin->idle_decoders);
+
+      decoder = oldest->data;
+      dbin->idle_decoders = g_list_delete_link (dbin->idle_decoders, oldest);
+    }
+  }
+
+  if (decoder) {
+    GST_DEBUG_OBJECT (dbin, "Discarding decoder %" GST_PTR_FORMAT, decoder);
+    gst_element_set_state (decoder, GST_STATE_NULL);
+    gst_bin_remove ((GstBin *) dbin, decoder);
+  }
+}
+
+static void
+flush_idle_decoders (GstDecodebin3 * dbin)
+{
+  while (dbin->idle_decoders) {
+    GstElement *decoder = dbin->idle_decoders->data;
+
+    dbin->idle_decoders =
+        g_list_delete_link (dbin->idle_decoders, dbin->idle_decoders);
+    gst_element_set_state (decoder, GST_STATE_NULL);
+    gst_bin_remove ((GstBin *) dbin, decoder);
+  }
+}
+
 static GstStateChangeReturn
 gst_decodebin3_change_state (GstElement * element, GstStateChange transition)
 {
@@ -159,6 +159,7 @@ struct _GstParseBin
   GMutex factories_lock;
   guint32 factories_cookie;     /* Cookie from last time when factories was updated */
   GList *factories;             /* factories we can use for selecting elements */
+  GstPlaybackFactoryIndex *factories_index;     /* factories by media type */
 
   GMutex subtitle_lock;         /* Protects changes to subtitles and encoding */
   GList *subtitles;             /* List of elements with subtitle-encoding,
@@ -842,6 +843,7 @@ gst_parse_bin_update_factories_list (GstParseBin * parsebin)
 
   cookie = gst_registry_get_feature_list_cookie (gst_registry_get ());
   if (!parsebin->factories || parsebin->factories_cookie != cookie) {
+    gst_playback_factory_index_free (parsebin->factories_index);
     if (parsebin->factories)
       gst_plugin_feature_list_free (parsebin->factories);
     parsebin->factories =
@@ -850,6 +852,8 @@ gst_parse_bin_update_factories_list (GstParseBin * parsebin)
     parsebin->factories =
         g_list_sort (parsebin->factories,
         gst_playback_utils_compare_factories_func);
+    parsebin->factories_index =
+        gst_playback_factory_index_new (parsebin->factories);
     parsebin->factories_cookie = cookie;
   }
 }
@@ -938,6 +942,8 @@ gst_parse_bin_dispose (GObject * object)
 
   parse_bin = GST_PARSE_BIN (object);
 
+  gst_playback_factory_index_free (parse_bin->factories_index);
+  parse_bin->factories_index = NULL;
   if (parse_bin->factories)
     gst_plugin_feature_list_free (parse_bin->factories);
   parse_bin->factories = NULL;
@@ -1119,8 +1125,8 @@ gst_parse_bin_autoplug_factories (GstElement * element, GstPad * pad,
   g_mutex_lock (&parsebin->factories_lock);
   gst_parse_bin_update_factories_list (parsebin);
   list =
-      gst_element_factory_list_filter (parsebin->factories, caps, GST_PAD_SINK,
-      gst_caps_is_fixed (caps));
+      gst_playback_factory_index_filter (parsebin->factories_index, caps,
+      GST_PAD_SINK, gst_caps_is_fixed (caps));
   g_mutex_unlock (&parsebin->factories_lock);
 
   result = g_value_array_new (g_list_length (list));
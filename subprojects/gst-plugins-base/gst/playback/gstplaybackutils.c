@@ -162,3 +162,184 @@ gst_playback_utils_compare_factories_func (gconstpointer p1, gconstpointer p2)
    * and then by factory name */
   return gst_plugin_feature_rank_compare_func (p1, p2);
 }
+
+/* Index of a list of factories by the media types of their pad templates.
+ * Template caps only intersect with caps that have the same structure name,
+ * so only the factories listed under the media types of the caps (and those
+ * with ANY caps) need the expensive caps checks of
+ * gst_element_factory_list_filter(). */
+struct _GstPlaybackFactoryIndex
+{
+  /* the indexed factories, in list order, not owned */
+  GPtrArray *factories;
+
+  /* for each direction: media type quark -> GArray of factory positions */
+  GHashTable *media_types[2];
+  /* factories with ANY template caps in each direction */
+  GArray *any[2];
+};
+
+static void
+factory_index_add (GHashTable * media_types, GQuark name, guint pos)
+{
+  GArray *positions;
+
+  positions = g_hash_table_lookup (media_types, GUINT_TO_POINTER (name));
+  if (positions == NULL) {
+    positions = g_array_new (FALSE, FALSE, sizeof (guint));
+    g_hash_table_insert (media_types, GUINT_TO_POINTER (name), positions);
+  }
+
+  /* a factory can list several structures with the same media type */
+  if (positions->len == 0 ||
+      g_array_index (positions, guint, positions->len - 1) != pos)
+    g_array_append_val (positions, pos);
+}
+
+static void
+factory_index_build (GstPlaybackFactoryIndex * index,
+    GstPadDirection direction)
+{
+  GHashTable *media_types;
+  GArray *any;
+  guint i, j;
+
+  media_types = g_hash_table_new_full (NULL, NULL, NULL,
+      (GDestroyNotify) g_array_unref);
+  any = g_array_new (FALSE, FALSE, sizeof (guint));
+
+  for (i = 0; i < index->factories->len; i++) {
+    GstElementFactory *factory = g_ptr_array_index (index->factories, i);
+    const GList *walk;
+
+    walk = gst_element_factory_get_static_pad_templates (factory);
+    for (; walk; walk = walk->next) {
+      GstStaticPadTemplate *templ = walk->data;
+      GstCaps *tmpl_caps;
+
+      if (templ->direction != direction)
+        continue;
+
+      tmpl_caps = gst_static_caps_get (&templ->static_caps);
+      if (gst_caps_is_any (tmpl_caps)) {
+        if (any->len == 0 || g_array_index (any, guint, any->len - 1) != i)
+          g_array_append_val (any, i);
+      } else {
+        for (j = 0; j < gst_caps_get_size (tmpl_caps); j++) {
+          GstStructure *s = gst_caps_get_structure (tmpl_caps, j);
+
+          factory_index_add (media_types, gst_structure_get_name_id (s), i);
+        }
+      }
+      gst_caps_unref (tmpl_caps);
+    }
+  }
+
+  index->media_types[direction == GST_PAD_SINK] = media_types;
+  index->any[direction == GST_PAD_SINK] = any;
+}
+
+/* Builds an index on @factories. The factories are not referenced, so the
+ * index must be freed before the list. */
+GstPlaybackFactoryIndex *
+gst_playback_factory_index_new (GList * factories)
+{
+  GstPlaybackFactoryIndex *index = g_new0 (GstPlaybackFactoryIndex, 1);
+
+  index->factories = g_ptr_array_new ();
+  for (; factories; factories = factories->next)
+    g_ptr_array_add (index->factories, factories->data);
+
+  return index;
+}
+
+void
+gst_playback_factory_index_free (GstPlaybackFactoryIndex * index)
+{
+  gint i;
+
+  if (index == NULL)
+    return;
+
+  for (i = 0; i < 2; i++) {
+    if (index->media_types[i])
+      g_hash_table_unref (index->media_types[i]);
+    if (index->any[i])
+      g_array_unref (index->any[i]);
+  }
+  g_ptr_array_unref (index->factories);
+  g_free (index);
+}
+
+static gint
+compare_positions (gconstpointer a, gconstpointer b)
+{
+  guint pa = *(const guint *) a, pb = *(const guint *) b;
+
+  return pa < pb ? -1 : pa > pb ? 1 : 0;
+}
+
+/* Same as gst_element_factory_list_filter() on the indexed list, but only
+ * checks the factories that have a template with a matching media type.
+ * The index for @direction is built on first use. */
+GList *
+gst_playback_factory_index_filter (GstPlaybackFactoryIndex * index,
+    const GstCaps * caps, GstPadDirection direction, gboolean subsetonly)
+{
+  GHashTable *media_types;
+  GArray *candidates;
+  GList *shortlist = NULL, *result;
+  gint d = direction == GST_PAD_SINK;
+  guint i, last = G_MAXUINT;
+
+  /* ANY caps intersect with every template and empty caps are a subset of
+   * every template, the index can't help with those */
+  if (gst_caps_is_any (caps) || gst_caps_is_empty (caps)) {
+    GList *all = NULL;
+
+    for (i = index->factories->len; i > 0; i--)
+      all = g_list_prepend (all, g_ptr_array_index (index->factories, i - 1));
+    result = gst_element_factory_list_filter (all, caps, direction,
+        subsetonly);
+    g_list_free (all);
+    return result;
+  }
+
+  if (index->media_types[d] == NULL)
+    factory_index_build (index, direction);
+  media_types = index->media_types[d];
+
+  candidates = g_array_new (FALSE, FALSE, sizeof (guint));
+  g_array_append_vals (candidates, index->any[d]->data, index->any[d]->len);
+  for (i = 0; i < gst_caps_get_size (caps); i++) {
+    GstStructure *s = gst_caps_get_structure (caps, i);
+    GArray *positions;
+
+    positions = g_hash_table_lookup (media_types,
+        GUINT_TO_POINTER (gst_structure_get_name_id (s)));
+    if (positions)
+      g_array_append_vals (candidates, positions->data, positions->len);
+  }
+  g_array_sort (candidates, compare_positions);
+
+  /* keep the order of the indexed list */
+  for (i = candidates->len; i > 0; i--) {
+    guint pos = g_array_index (candidates, guint, i - 1);
+
+    if (pos == last)
+      continue;
+    shortlist = g_list_prepend (shortlist,
+        g_ptr_array_index (index->factories, pos));
+    last = pos;
+  }
+  g_array_unref (candidates);
+
+  GST_DEBUG ("checking %u of %u factories", g_list_length (shortlist),
+      index->factories->len);
+
+  result = gst_element_factory_list_filter (shortlist, caps, direction,
+      subsetonly);
+  g_list_free (shortlist);
+
+  return result;
+}
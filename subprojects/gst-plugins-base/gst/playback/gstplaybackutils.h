@@ -36,6 +36,21 @@ gst_playback_utils_get_n_common_capsfeatures (GstElementFactory * fact1,
 G_GNUC_INTERNAL
 gint
 gst_playback_utils_compare_factories_func (gconstpointer p1, gconstpointer p2);
+
+typedef struct _GstPlaybackFactoryIndex GstPlaybackFactoryIndex;
+
+G_GNUC_INTERNAL
+GstPlaybackFactoryIndex *
+gst_playback_factory_index_new (GList * factories);
+G_GNUC_INTERNAL
+void
+gst_playback_factory_index_free (GstPlaybackFactoryIndex * index);
+G_GNUC_INTERNAL
+GList *
+gst_playback_factory_index_filter (GstPlaybackFactoryIndex * index,
+                                   const GstCaps * caps,
+                                   GstPadDirection direction,
+                                   gboolean subsetonly);
 G_END_DECLS
 
 #endif /* __GST_PLAYBACK_UTILS_H__ */
@@ -376,6 +376,10 @@ struct _GstPlayBin3
   GstElement *text_stream_combiner;     /* configured text stream combiner, or NULL */
 
   gboolean is_live;             /* Whether we are live */
+
+  gboolean fast_start;          /* only preroll the video stream first */
+  GList *fast_start_streams;    /* stream-ids to select once the video
+                                 * stream prerolled */
 };
 
 struct _GstPlayBin3Class
@@ -412,6 +416,7 @@ struct _GstPlayBin3Class
 #define DEFAULT_BUFFER_DURATION   -1
 #define DEFAULT_BUFFER_SIZE       -1
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
+#define DEFAULT_FAST_START        FALSE
 
 enum
 {
@@ -444,7 +449,9 @@ enum
   PROP_VIDEO_FILTER,
   PROP_MULTIVIEW_MODE,
   PROP_MULTIVIEW_FLAGS,
-  PROP_INSTANT_URI
+  PROP_INSTANT_URI,
+  PROP_FAST_START,
+  PROP_PREROLL_AHEAD
 };
 
 /* signals */
@@ -491,7 +498,7 @@ static void source_setup_cb (GstElement * element, GstElement * source,
 static void about_to_finish_cb (GstElement * uridecodebin,
     GstPlayBin3 * playbin);
 
-static void do_stream_selection (GstPlayBin3 * playbin);
+static void do_stream_selection (GstPlayBin3 * playbin, gboolean fast_start);
 
 static GstElementClass *parent_class;
 
@@ -839,6 +846,43 @@ gst_play_bin3_class_init (GstPlayBin3Class * klass)
           "When enabled, URI changes are applied immediately", FALSE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstPlayBin3:fast-start:
+   *
+   * When a new stream collection is received, only select the video stream
+   * at first and select the other streams (audio, subtitles) once it has
+   * prerolled. This makes the first video frame available sooner, at the
+   * cost of the audio and subtitle outputs being set up while already
+   * paused or playing.
+   *
+   * This only applies to the default stream selection, the selection done by
+   * the application with %GST_EVENT_SELECT_STREAMS is never deferred.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_klass, PROP_FAST_START,
+      g_param_spec_boolean ("fast-start", "Fast start",
+          "Preroll the video stream before selecting the other streams",
+          DEFAULT_FAST_START, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPlayBin3:preroll-ahead:
+   *
+   * When non-zero, URIs set while playing are queued for gapless playback
+   * instead of replacing the next URI, and up to this number of queued URIs
+   * have their sources started in advance so that they can be switched to
+   * without any startup latency.
+   *
+   * See #GstURIDecodeBin3:preroll-ahead
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_klass, PROP_PREROLL_AHEAD,
+      g_param_spec_uint ("preroll-ahead", "Preroll ahead",
+          "Number of queued URIs to start in advance (0 = only start the "
+          "next URI on about-to-finish)", 0, G_MAXUINT, 0,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstPlayBin3::about-to-finish
    * @playbin: a #GstPlayBin3
@@ -1105,6 +1149,7 @@ gst_play_bin3_init (GstPlayBin3 * playbin)
   playbin->multiview_flags = GST_VIDEO_MULTIVIEW_FLAGS_NONE;
 
   playbin->is_live = FALSE;
+  playbin->fast_start = DEFAULT_FAST_START;
 }
 
 static void
@@ -1114,6 +1159,8 @@ gst_play_bin3_finalize (GObject * object)
 
   playbin = GST_PLAY_BIN3 (object);
 
+  g_list_free_full (playbin->fast_start_streams, g_free);
+
   /* Setting states to NULL is safe here because playsink
    * will already be gone and none of these sinks will be
    * a child of playsink
@@ -1282,7 +1329,7 @@ gst_play_bin3_set_current_stream (GstPlayBin3 * playbin,
   if (combine->combiner == NULL) {
     /* FIXME: Check that the current_value is within range */
     *current_value = stream;
-    do_stream_selection (playbin);
+    do_stream_selection (playbin, FALSE);
     GST_PLAY_BIN3_UNLOCK (playbin);
     return TRUE;
   }
@@ -1528,6 +1575,15 @@ gst_play_bin3_set_property (GObject * object, guint prop_id,
       g_object_set_property ((GObject *) playbin->uridecodebin,
           "instant-uri", value);
       break;
+    case PROP_FAST_START:
+      GST_PLAY_BIN3_LOCK (playbin);
+      playbin->fast_start = g_value_get_boolean (value);
+      GST_PLAY_BIN3_UNLOCK (playbin);
+      break;
+    case PROP_PREROLL_AHEAD:
+      g_object_set_property ((GObject *) playbin->uridecodebin,
+          "preroll-ahead", value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1704,6 +1760,15 @@ gst_play_bin3_get_property (GObject * object, guint prop_id, GValue * value,
       g_object_get_property ((GObject *) playbin->uridecodebin,
           "instant-uri", value);
       break;
+    case PROP_FAST_START:
+      GST_PLAY_BIN3_LOCK (playbin);
+      g_value_set_boolean (value, playbin->fast_start);
+      GST_PLAY_BIN3_UNLOCK (playbin);
+      break;
+    case PROP_PREROLL_AHEAD:
+      g_object_get_property ((GObject *) playbin->uridecodebin,
+          "preroll-ahead", value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1845,6 +1910,8 @@ gst_play_bin3_send_event (GstElement * element, GstEvent * event)
         "App sent select-streams, we won't do anything ourselves now");
     /* This is probably already false, but it doesn't hurt to be sure */
     playbin->do_stream_selections = FALSE;
+    g_list_free_full (playbin->fast_start_streams, g_free);
+    playbin->fast_start_streams = NULL;
 
     /* If we have custom combiners, we need to extend the selection with
      * the list of all streams for that given type since we will be handling
@@ -1878,16 +1945,23 @@ gst_play_bin3_send_event (GstElement * element, GstEvent * event)
   return GST_ELEMENT_CLASS (parent_class)->send_event (element, event);
 }
 
-/* Called with playbin lock held */
+/* Called with playbin lock held.
+ *
+ * If @fast_start is set and other streams than video are chosen, only the
+ * video streams are selected now and the complete selection is stored to be
+ * done once the video stream prerolled */
 static void
-do_stream_selection (GstPlayBin3 * playbin)
+do_stream_selection (GstPlayBin3 * playbin, gboolean fast_start)
 {
   GstStreamCollection *collection;
   guint i, nb_streams;
-  GList *streams = NULL;
+  GList *streams = NULL, *video_streams = NULL;
   gint nb_video = 0, nb_audio = 0, nb_text = 0;
   GstStreamType chosen_stream_types = 0;
 
+  g_list_free_full (playbin->fast_start_streams, g_free);
+  playbin->fast_start_streams = NULL;
+
   collection = playbin->collection;
   if (collection == NULL) {
     GST_LOG_OBJECT (playbin, "No stream collection. Not doing stream-select");
@@ -1947,12 +2021,30 @@ do_stream_selection (GstPlayBin3 * playbin)
       GST_DEBUG_OBJECT (playbin, "Selecting stream %s of type %s",
           stream_id, gst_stream_type_get_name (stream_type));
       /* Don't build the list if we're not in charge of stream selection */
-      if (playbin->do_stream_selections)
+      if (playbin->do_stream_selections || fast_start)
         streams = g_list_append (streams, (gpointer) stream_id);
+      if (fast_start && pb_stream_type == PLAYBIN_STREAM_VIDEO)
+        video_streams = g_list_append (video_streams, (gpointer) stream_id);
       chosen_stream_types |= stream_type;
     }
   }
 
+  if (video_streams
+      && g_list_length (video_streams) < g_list_length (streams)) {
+    GST_DEBUG_OBJECT (playbin, "Fast start, only selecting video streams");
+    playbin->fast_start_streams =
+        g_list_copy_deep (streams, (GCopyFunc) g_strdup, NULL);
+    g_list_free (streams);
+    streams = video_streams;
+    video_streams = NULL;
+    chosen_stream_types = GST_STREAM_TYPE_VIDEO;
+  } else if (!playbin->do_stream_selections) {
+    /* Nothing to defer, leave the default selection to decodebin3 */
+    g_list_free (streams);
+    streams = NULL;
+  }
+  g_list_free (video_streams);
+
   if (streams) {
     GstEvent *ev = gst_event_new_select_streams (streams);
     gst_element_send_event ((GstElement *) playbin->collection_source, ev);
@@ -1964,6 +2056,24 @@ do_stream_selection (GstPlayBin3 * playbin)
     reconfigure_output (playbin);
 }
 
+static void
+finish_fast_start (GstPlayBin3 * playbin, gpointer user_data)
+{
+  GList *streams;
+
+  GST_PLAY_BIN3_LOCK (playbin);
+  streams = playbin->fast_start_streams;
+  playbin->fast_start_streams = NULL;
+  GST_PLAY_BIN3_UNLOCK (playbin);
+
+  if (streams) {
+    GST_DEBUG_OBJECT (playbin, "Selecting the deferred streams");
+    gst_element_send_event (playbin->uridecodebin,
+        gst_event_new_select_streams (streams));
+    g_list_free_full (streams, g_free);
+  }
+}
+
 static void
 gst_play_bin3_handle_message (GstBin * bin, GstMessage * msg)
 {
@@ -1990,7 +2100,7 @@ gst_play_bin3_handle_message (GstBin * bin, GstMessage * msg)
       update_combiner_info (playbin, playbin->collection);
       if (pstate)
         playbin->do_stream_selections = FALSE;
-      do_stream_selection (playbin);
+      do_stream_selection (playbin, playbin->fast_start);
       if (pstate)
         playbin->do_stream_selections = TRUE;
       GST_PLAY_BIN3_UNLOCK (playbin);
@@ -2020,6 +2130,16 @@ gst_play_bin3_handle_message (GstBin * bin, GstMessage * msg)
       reconfigure_output (playbin);
     }
     GST_PLAY_BIN3_UNLOCK (playbin);
+  } else if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ASYNC_DONE &&
+      GST_MESSAGE_SRC (msg) == GST_OBJECT_CAST (playbin->playsink)) {
+    GST_PLAY_BIN3_LOCK (playbin);
+    if (playbin->fast_start_streams) {
+      /* Not from this thread, it's a streaming thread of the video sink */
+      GST_DEBUG_OBJECT (playbin, "Video prerolled, completing selection");
+      gst_element_call_async (GST_ELEMENT_CAST (playbin),
+          (GstElementCallAsyncFunc) finish_fast_start, NULL, NULL);
+    }
+    GST_PLAY_BIN3_UNLOCK (playbin);
   }
 
   if (msg)
@@ -2712,6 +2832,10 @@ gst_play_bin3_change_state (GstElement * element, GstStateChange transition)
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
       playbin->is_live = FALSE;
+      GST_PLAY_BIN3_LOCK (playbin);
+      g_list_free_full (playbin->fast_start_streams, g_free);
+      playbin->fast_start_streams = NULL;
+      GST_PLAY_BIN3_UNLOCK (playbin);
       /* Make sure we reset our state  */
       if (playbin->selected_stream_types) {
         playbin->selected_stream_types = 0;
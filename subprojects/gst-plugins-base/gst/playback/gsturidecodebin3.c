@@ -226,6 +226,7 @@ struct _GstURIDecodeBin3
   gboolean use_buffering;
   guint64 ring_buffer_max_size;
   gboolean instant_uri;         /* Whether URI changes should be applied immediately or not */
+  guint preroll_ahead;          /* Number of queued play items to start in advance */
 
   /* Mutex to protect play_items/input_item/output_item */
   GMutex play_items_lock;
@@ -259,6 +260,7 @@ struct _GstURIDecodeBin3
 };
 
 static GstStateChangeReturn activate_play_item (GstPlayItem * item);
+static void activate_preroll_ahead_items (GstURIDecodeBin3 * dec);
 
 static gint
 gst_uridecodebin3_select_stream (GstURIDecodeBin3 * dbin,
@@ -300,6 +302,7 @@ enum
 #define DEFAULT_USE_BUFFERING       FALSE
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
 #define DEFAULT_INSTANT_URI         FALSE
+#define DEFAULT_PREROLL_AHEAD       0
 
 enum
 {
@@ -316,7 +319,8 @@ enum
   PROP_USE_BUFFERING,
   PROP_RING_BUFFER_MAX_SIZE,
   PROP_CAPS,
-  PROP_INSTANT_URI
+  PROP_INSTANT_URI,
+  PROP_PREROLL_AHEAD
 };
 
 static guint gst_uri_decode_bin3_signals[LAST_SIGNAL] = { 0 };
@@ -515,6 +519,29 @@ gst_uri_decode_bin3_class_init (GstURIDecodeBin3Class * klass)
           "When enabled, URI changes are applied immediately",
           DEFAULT_INSTANT_URI, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstURIDecodeBin3:preroll-ahead:
+   *
+   * When non-zero, URIs set while playing are queued instead of replacing the
+   * next URI, and up to this number of queued URIs have their sources
+   * started in advance. Their data is held back right before
+   * decodebin3 until the previous URI is drained, so that switching to them
+   * happens without any startup latency.
+   *
+   * The amount of data prerolled for each queued URI is bound by the
+   * #GstURIDecodeBin3:buffer-size and #GstURIDecodeBin3:buffer-duration
+   * properties.
+   *
+   * This has no effect if #GstURIDecodeBin3:instant-uri is enabled.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PREROLL_AHEAD,
+      g_param_spec_uint ("preroll-ahead", "Preroll ahead",
+          "Number of queued URIs to start in advance (0 = only start the "
+          "next URI on about-to-finish)", 0, G_MAXUINT, DEFAULT_PREROLL_AHEAD,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstURIDecodebin3::select-stream
    * @decodebin: a #GstURIDecodebin3
@@ -1122,6 +1149,12 @@ switch_and_activate_input_locked (GstURIDecodeBin3 * uridecodebin,
   /* and set new one as input item */
   uridecodebin->input_item = new_item;
 
+  /* Start the next queued play item, if any. This can't be done from here
+   * since it requires taking the play items lock */
+  if (uridecodebin->preroll_ahead)
+    gst_element_call_async (GST_ELEMENT_CAST (uridecodebin),
+        (GstElementCallAsyncFunc) activate_preroll_ahead_items, NULL, NULL);
+
   /* If the new source is already drained, propagate about-to-finish */
   if (new_item->pending_about_to_finish) {
     emit_and_handle_about_to_finish (uridecodebin, new_item);
@@ -1274,7 +1307,8 @@ uri_src_block_probe (GstPad * pad, GstPadProbeInfo * info,
   }
 
   PLAY_ITEMS_LOCK (handler->uridecodebin);
-  if (play_item_is_eos (handler->uridecodebin->input_item)) {
+  if (play_item_is_next_input (handler->uridecodebin, handler->play_item) &&
+      play_item_is_eos (handler->uridecodebin->input_item)) {
     GST_DEBUG_OBJECT (handler->uridecodebin,
         "We can switch over to the next input item");
     switch_and_activate_input_locked (handler->uridecodebin,
@@ -1288,6 +1322,15 @@ uri_src_block_probe (GstPad * pad, GstPadProbeInfo * info,
         &handler->uridecodebin->play_items_lock);
     if (g_atomic_int_get (&handler->uridecodebin->shutdown))
       goto shutdown;
+    /* Play items prerolled ahead need to wait for all the previous ones */
+    while (!play_item_is_next_input (handler->uridecodebin,
+            handler->play_item)) {
+      GST_DEBUG_OBJECT (pad, "Waiting for the previous play items");
+      g_cond_wait (&handler->uridecodebin->input_source_drained,
+          &handler->uridecodebin->play_items_lock);
+      if (g_atomic_int_get (&handler->uridecodebin->shutdown))
+        goto shutdown;
+    }
     if (play_item_is_eos (handler->uridecodebin->input_item)) {
       GST_DEBUG_OBJECT (handler->uridecodebin,
           "We can switch over to the next input item");
@@ -1533,6 +1576,11 @@ gst_uri_decode_bin3_set_property (GObject * object, guint prop_id,
       dec->instant_uri = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (dec);
       break;
+    case PROP_PREROLL_AHEAD:
+      GST_OBJECT_LOCK (dec);
+      dec->preroll_ahead = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (dec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1625,6 +1673,11 @@ gst_uri_decode_bin3_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, dec->instant_uri);
       GST_OBJECT_UNLOCK (dec);
       break;
+    case PROP_PREROLL_AHEAD:
+      GST_OBJECT_LOCK (dec);
+      g_value_set_uint (value, dec->preroll_ahead);
+      GST_OBJECT_UNLOCK (dec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1789,6 +1842,68 @@ play_item_has_all_pads (GstPlayItem * item)
   return TRUE;
 }
 
+/* PLAY_ITEMS_LOCK held
+ *
+ * Returns TRUE if @item is the play item following the current input item */
+static gboolean
+play_item_is_next_input (GstURIDecodeBin3 * dec, GstPlayItem * item)
+{
+  GList *iter = g_list_find (dec->play_items, dec->input_item);
+
+  return iter && iter->next && iter->next->data == item;
+}
+
+/* Returns the last play item if it can still get a URI, else creates a new
+ * one at the end of the list of play items */
+static GstPlayItem *
+queue_play_item (GstURIDecodeBin3 * dec)
+{
+  GstPlayItem *res = g_list_last (dec->play_items)->data;
+
+  if (!res->active && !res->main_item)
+    return res;
+
+  GST_DEBUG_OBJECT (dec, "Queueing a new play item");
+  res = new_play_item (dec);
+  dec->play_items = g_list_append (dec->play_items, res);
+
+  return res;
+}
+
+/* Activates the play items queued after the current input item, until
+ * preroll-ahead of them are active */
+static void
+activate_preroll_ahead_items (GstURIDecodeBin3 * dec)
+{
+  GList *iter, *to_activate = NULL;
+  guint nb_active = 0, preroll_ahead;
+
+  GST_OBJECT_LOCK (dec);
+  preroll_ahead = dec->preroll_ahead;
+  GST_OBJECT_UNLOCK (dec);
+
+  PLAY_ITEMS_LOCK (dec);
+  iter = g_list_find (dec->play_items, dec->input_item);
+  for (iter = iter ? iter->next : NULL; iter && nb_active < preroll_ahead;
+      iter = iter->next) {
+    GstPlayItem *item = iter->data;
+
+    if (!item->active) {
+      if (!item->main_item)
+        break;
+      to_activate = g_list_append (to_activate, item);
+    }
+    nb_active++;
+  }
+  PLAY_ITEMS_UNLOCK (dec);
+
+  for (iter = to_activate; iter; iter = iter->next) {
+    GST_DEBUG_OBJECT (dec, "Prerolling ahead play item %p", iter->data);
+    activate_play_item (iter->data);
+  }
+  g_list_free (to_activate);
+}
+
 /* Returns the next inactive play item. If none available, it will create one
  * and add it to the list of play items */
 static GstPlayItem *
@@ -1826,6 +1941,13 @@ gst_uri_decode_bin3_set_uri (GstURIDecodeBin3 * dec, const gchar * uri)
 
   GST_DEBUG_OBJECT (dec, "uri: %s", uri);
 
+  if (dec->preroll_ahead && !dec->instant_uri && dec->input_item->active) {
+    item = queue_play_item (dec);
+    play_item_set_uri (item, uri);
+    activate_preroll_ahead_items (dec);
+    return;
+  }
+
   item = next_inactive_play_item (dec);
   play_item_set_uri (item, uri);
 
@@ -1961,6 +2083,7 @@ gst_uri_decode_bin3_change_state (GstElement * element,
       ret = activate_play_item (uridecodebin->input_item);
       if (ret == GST_STATE_CHANGE_FAILURE)
         goto failure;
+      activate_preroll_ahead_items (uridecodebin);
       break;
     case GST_STATE_CHANGE_PAUSED_TO_READY:
       PLAY_ITEMS_LOCK (uridecodebin);
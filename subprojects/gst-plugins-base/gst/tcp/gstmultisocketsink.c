@@ -774,22 +774,55 @@ gst_buffer_get_cmsg_list (GstBuffer * buf, GSocketControlMessage ** msgs,
 
 #define CMSG_MAX 255
 
+/* maximum number of queued buffers and memories written with one call */
+#define MAX_WRITE_BUFFERS 16
+#define MAX_WRITE_VECTORS 32
+
+static gboolean
+buffer_has_cmsg (GstBuffer * buf)
+{
+  GSocketControlMessage *msg;
+
+  return gst_buffer_get_cmsg_list (buf, &msg, 1) > 0;
+}
+
+/* Writes as much as possible of the @buffers list, starting at @bufoffset
+ * in the first buffer, with a single send call. Buffers carrying control
+ * messages are only ever sent at the head of a write so that the messages
+ * stay attached to the right bytes. */
 static gssize
 gst_multi_socket_sink_write (GstMultiSocketSink * sink,
-    GSocket * sock, GstBuffer * buffer, gsize bufoffset,
+    GSocket * sock, GSList * buffers, gsize bufoffset,
     GCancellable * cancellable, GError ** err)
 {
-  GstMapInfo maps[8];
-  GOutputVector vec[8];
-  guint mems_mapped;
+  GstMapInfo maps[MAX_WRITE_VECTORS];
+  GOutputVector vec[MAX_WRITE_VECTORS];
+  guint mems_mapped = 0;
   gssize wrote;
   GSocketControlMessage *cmsgs[CMSG_MAX];
   gsize msg_count;
+  GstBuffer *buffer;
+  GSList *walk;
 
-  mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps, 8);
+  buffer = GST_BUFFER (buffers->data);
+  mems_mapped = map_n_memory_output_vector (buffer, bufoffset, vec, maps,
+      MAX_WRITE_VECTORS);
 
   msg_count = gst_buffer_get_cmsg_list (buffer, cmsgs, CMSG_MAX);
 
+  if (msg_count == 0) {
+    for (walk = buffers->next; walk && mems_mapped < MAX_WRITE_VECTORS;
+        walk = walk->next) {
+      buffer = GST_BUFFER (walk->data);
+
+      if (gst_buffer_get_size (buffer) == 0 || buffer_has_cmsg (buffer))
+        break;
+
+      mems_mapped += map_n_memory_output_vector (buffer, 0, vec + mems_mapped,
+          maps + mems_mapped, MAX_WRITE_VECTORS - mems_mapped);
+    }
+  }
+
   wrote =
       g_socket_send_message (sock, NULL, vec, mems_mapped, cmsgs, msg_count, 0,
       cancellable, err);
@@ -806,13 +839,14 @@ gst_multi_socket_sink_write (GstMultiSocketSink * sink,
  * We first check to see if we need to send streamheaders. If so, we queue them.
  *
  * Then we run into the main loop that tries to send as many buffers as
- * possible. It will first exhaust the mhclient->sending queue and if the queue
- * is empty, it will pick a buffer from the global queue.
+ * possible. It first tops up the mhclient->sending queue with buffers from
+ * the global queue, up to MAX_WRITE_BUFFERS.
  *
  * Sending the buffers from the mhclient->sending queue is basically writing
- * the bytes to the socket and maintaining a count of the bytes that were
- * sent. When the buffer is completely sent, it is removed from the
- * mhclient->sending queue and we try to pick a new buffer for sending.
+ * the bytes of as many queued buffers as possible to the socket with one
+ * vectored send and maintaining a count of the bytes that were sent. Every
+ * buffer that was completely sent is removed from the mhclient->sending
+ * queue and we try to pick new buffers for sending.
  *
  * When the sending returns a partial buffer we stop sending more data as
  * the next send operation could block.
@@ -840,9 +874,13 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
 
   more = TRUE;
   do {
-    if (!mhclient->sending) {
+    while (g_slist_length (mhclient->sending) < MAX_WRITE_BUFFERS) {
       /* client is not working on a buffer */
       if (mhclient->bufpos == -1) {
+        /* nothing more to add, send what we have */
+        if (mhclient->sending)
+          break;
+
         /* client is too fast, remove from write queue until new buffer is
          * available */
         gst_multi_socket_sink_stop_sending (sink, client);
@@ -868,6 +906,9 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
             mhclient->new_connection = FALSE;
             mhclient->bufpos = position;
           } else {
+            if (mhclient->sending)
+              break;
+
             /* cannot send data to this client yet */
             gst_multi_socket_sink_stop_sending (sink, client);
             return TRUE;
@@ -875,8 +916,11 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         }
 
         /* we flushed all remaining buffers, no need to get a new one */
-        if (mhclient->flushcount == 0)
+        if (mhclient->flushcount == 0) {
+          if (mhclient->sending)
+            break;
           goto flushed;
+        }
 
         /* grab buffer */
         buf = g_array_index (mhsink->bufqueue, GstBuffer *, mhclient->bufpos);
@@ -896,24 +940,23 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
         GST_LOG_OBJECT (sink, "%s client %p at position %d",
             mhclient->debug, client, mhclient->bufpos);
 
+        /* need to start from the first byte for this new buffer */
+        if (!mhclient->sending)
+          mhclient->bufoffset = 0;
+
         /* queueing a buffer will ref it */
         mhsinkclass->client_queue_buffer (mhsink, mhclient, buf);
-
-        /* need to start from the first byte for this new buffer */
-        mhclient->bufoffset = 0;
       }
     }
 
     /* see if we need to send something */
     if (mhclient->sending) {
       gssize wrote;
+      gsize left;
       GstBuffer *head;
 
-      /* pick first buffer from list */
-      head = GST_BUFFER (mhclient->sending->data);
-
-      wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket, head,
-          mhclient->bufoffset, sink->cancellable, &err);
+      wrote = gst_multi_socket_sink_write (sink, mhclient->handle.socket,
+          mhclient->sending, mhclient->bufoffset, sink->cancellable, &err);
 
       if (wrote < 0) {
         /* hmm error.. */
@@ -929,13 +972,23 @@ gst_multi_socket_sink_handle_client_write (GstMultiSocketSink * sink,
           goto write_error;
         }
       } else {
-        if (wrote < (gst_buffer_get_size (head) - mhclient->bufoffset)) {
-          /* partial write, try again now */
-          GST_LOG_OBJECT (sink,
-              "partial write on %p of %" G_GSSIZE_FORMAT " bytes",
-              mhclient->handle.socket, wrote);
-          mhclient->bufoffset += wrote;
-        } else {
+        left = wrote;
+        while (mhclient->sending) {
+          gsize remaining;
+
+          head = GST_BUFFER (mhclient->sending->data);
+          remaining = gst_buffer_get_size (head) - mhclient->bufoffset;
+
+          if (left < remaining) {
+            /* partial write, try again now */
+            GST_LOG_OBJECT (sink,
+                "partial write on %p of %" G_GSSIZE_FORMAT " bytes",
+                mhclient->handle.socket, wrote);
+            mhclient->bufoffset += left;
+            break;
+          }
+          left -= remaining;
+
           if (sink->send_dispatched) {
             gst_pad_push_event (GST_BASE_SINK_PAD (mhsink),
                 gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
@@ -104,6 +104,10 @@ typedef struct
   gdouble alpha_value;
 
   GstVideoConverter *convert;
+  /* the process wide pool when using threads */
+  GstTaskPool *task_pool;
+  /* the crop meta region the converter was made for, width 0 if none */
+  gint crop_x, crop_y, crop_width, crop_height;
 
   gint borders_h;
   gint borders_w;
@@ -139,6 +143,38 @@ GST_DEBUG_CATEGORY_STATIC (CAT_PERFORMANCE);
 
 static GQuark _colorspace_quark;
 
+/* all instances run their conversion threads from one pool with a thread per
+ * core instead of each converter starting its own threads */
+G_LOCK_DEFINE_STATIC (shared_task_pool);
+static GstTaskPool *shared_task_pool;
+static guint shared_task_pool_users;
+
+static GstTaskPool *
+gst_video_convert_scale_acquire_task_pool (void)
+{
+  G_LOCK (shared_task_pool);
+  if (shared_task_pool_users++ == 0) {
+    shared_task_pool = gst_shared_task_pool_new ();
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL
+        (shared_task_pool), g_get_num_processors ());
+    gst_task_pool_prepare (shared_task_pool, NULL);
+  }
+  G_UNLOCK (shared_task_pool);
+
+  return shared_task_pool;
+}
+
+static void
+gst_video_convert_scale_release_task_pool (void)
+{
+  G_LOCK (shared_task_pool);
+  if (--shared_task_pool_users == 0) {
+    gst_task_pool_cleanup (shared_task_pool);
+    gst_clear_object (&shared_task_pool);
+  }
+  G_UNLOCK (shared_task_pool);
+}
+
 enum
 {
   PROP_0,
@@ -246,6 +282,8 @@ static GstCaps *gst_video_convert_scale_transform_caps (GstBaseTransform *
     trans, GstPadDirection direction, GstCaps * caps, GstCaps * filter);
 static GstCaps *gst_video_convert_scale_fixate_caps (GstBaseTransform * base,
     GstPadDirection direction, GstCaps * caps, GstCaps * othercaps);
+static gboolean gst_video_convert_scale_propose_allocation (GstBaseTransform *
+    trans, GstQuery * decide_query, GstQuery * query);
 static gboolean gst_video_convert_scale_transform_meta (GstBaseTransform *
     trans, GstBuffer * outbuf, GstMeta * meta, GstBuffer * inbuf);
 
@@ -269,7 +307,8 @@ gst_video_convert_scale_filter_meta (GstBaseTransform * trans, GstQuery * query,
 {
   /* This element cannot passthrough the crop meta, because it would convert the
    * wrong sub-region of the image, and worst, our output image may not be large
-   * enough for the crop to be applied later */
+   * enough for the crop to be applied later. We apply the crop meta of our
+   * input ourselves instead, see propose_allocation */
   if (api == GST_VIDEO_CROP_META_API_TYPE)
     return FALSE;
 
@@ -400,6 +439,8 @@ gst_video_convert_scale_class_init (GstVideoConvertScaleClass * klass)
       GST_DEBUG_FUNCPTR (gst_video_convert_scale_src_event);
   trans_class->transform_meta =
       GST_DEBUG_FUNCPTR (gst_video_convert_scale_transform_meta);
+  trans_class->propose_allocation =
+      GST_DEBUG_FUNCPTR (gst_video_convert_scale_propose_allocation);
 
   filter_class->set_info = GST_DEBUG_FUNCPTR (gst_video_convert_scale_set_info);
   filter_class->transform_frame =
@@ -440,6 +481,9 @@ gst_video_convert_scale_finalize (GstVideoConvertScale * self)
   if (priv->convert)
     gst_video_converter_free (priv->convert);
 
+  if (priv->task_pool)
+    gst_video_convert_scale_release_task_pool ();
+
   G_OBJECT_CLASS (parent_class)->finalize (G_OBJECT (self));
 }
 
@@ -689,6 +733,10 @@ gst_video_convert_scale_transform_meta (GstBaseTransform * trans,
     NULL
   };
 
+  /* the crop was applied by the conversion */
+  if (info->api == GST_VIDEO_CROP_META_API_TYPE)
+    return FALSE;
+
   tags = gst_meta_api_type_get_tags (info->api);
 
   /* No specific tags, we are good to copy */
@@ -746,6 +794,7 @@ gst_video_convert_scale_set_info (GstVideoFilter * filter, GstCaps * in,
     gst_video_converter_free (priv->convert);
     priv->convert = NULL;
   }
+  priv->crop_x = priv->crop_y = priv->crop_width = priv->crop_height = 0;
 
   if (!gst_util_fraction_multiply (in_info->width,
           in_info->height, in_info->par_n, in_info->par_d, &from_dar_n,
@@ -900,7 +949,11 @@ gst_video_convert_scale_set_info (GstVideoFilter * filter, GstCaps * in,
         priv->primaries_mode, GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT,
         priv->n_threads, NULL);
 
-    priv->convert = gst_video_converter_new (in_info, out_info, options);
+    if (priv->n_threads != 1 && priv->task_pool == NULL)
+      priv->task_pool = gst_video_convert_scale_acquire_task_pool ();
+
+    priv->convert = gst_video_converter_new_with_pool (in_info, out_info,
+        options, priv->n_threads != 1 ? priv->task_pool : NULL);
     if (priv->convert == NULL)
       goto no_convert;
   }
@@ -1754,6 +1807,91 @@ gst_video_convert_scale_fixate_caps (GstBaseTransform * base,
     (gpointer)(((guint8*)(GST_VIDEO_FRAME_PLANE_DATA (frame, 0))) + \
      GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0) * (line))
 
+static gboolean
+gst_video_convert_scale_propose_allocation (GstBaseTransform * trans,
+    GstQuery * decide_query, GstQuery * query)
+{
+  if (!GST_BASE_TRANSFORM_CLASS (parent_class)->propose_allocation (trans,
+          decide_query, query))
+    return FALSE;
+
+  /* when converting, upstream can crop with a crop meta and leave the
+   * cropping to our conversion instead of copying the region */
+  if (decide_query) {
+    if (!gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL))
+      gst_query_add_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+    gst_query_add_allocation_meta (query, GST_VIDEO_CROP_META_API_TYPE, NULL);
+  }
+
+  return TRUE;
+}
+
+/* make the converter read the region of @crop from the full frames of
+ * @in_frame, or the whole frame if @crop is %NULL */
+static gboolean
+gst_video_convert_scale_update_crop (GstVideoConvertScale * self,
+    GstVideoFrame * in_frame, GstVideoCropMeta * crop)
+{
+  GstVideoConvertScalePrivate *priv = PRIV (self);
+  GstVideoConverter *convert;
+  GstStructure *config;
+
+  if (crop) {
+    if (crop->x == priv->crop_x && crop->y == priv->crop_y
+        && crop->width == priv->crop_width
+        && crop->height == priv->crop_height)
+      return TRUE;
+  } else if (priv->crop_width == 0) {
+    return TRUE;
+  }
+
+  if (crop && ((gint) (crop->x + crop->width) > GST_VIDEO_FRAME_WIDTH (in_frame)
+          || (gint) (crop->y + crop->height) >
+          GST_VIDEO_FRAME_HEIGHT (in_frame))) {
+    GST_WARNING_OBJECT (self, "crop region %ux%u at %u,%u outside of frame",
+        crop->width, crop->height, crop->x, crop->y);
+    return FALSE;
+  }
+
+  config = gst_structure_copy (gst_video_converter_get_config (priv->convert));
+  if (crop) {
+    GST_DEBUG_OBJECT (self, "cropping to %ux%u at %u,%u", crop->width,
+        crop->height, crop->x, crop->y);
+    gst_structure_set (config,
+        GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT, (gint) crop->x,
+        GST_VIDEO_CONVERTER_OPT_SRC_Y, G_TYPE_INT, (gint) crop->y,
+        GST_VIDEO_CONVERTER_OPT_SRC_WIDTH, G_TYPE_INT, (gint) crop->width,
+        GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, G_TYPE_INT, (gint) crop->height,
+        NULL);
+  } else {
+    GST_DEBUG_OBJECT (self, "not cropping anymore");
+    gst_structure_remove_fields (config, GST_VIDEO_CONVERTER_OPT_SRC_X,
+        GST_VIDEO_CONVERTER_OPT_SRC_Y, GST_VIDEO_CONVERTER_OPT_SRC_WIDTH,
+        GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, NULL);
+  }
+
+  /* the frame has the size of the video meta, which is the uncropped size */
+  convert = gst_video_converter_new_with_pool (&in_frame->info,
+      gst_video_converter_get_out_info (priv->convert), config,
+      priv->task_pool);
+  if (convert == NULL)
+    return FALSE;
+
+  gst_video_converter_free (priv->convert);
+  priv->convert = convert;
+
+  if (crop) {
+    priv->crop_x = crop->x;
+    priv->crop_y = crop->y;
+    priv->crop_width = crop->width;
+    priv->crop_height = crop->height;
+  } else {
+    priv->crop_x = priv->crop_y = priv->crop_width = priv->crop_height = 0;
+  }
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_video_convert_scale_transform_frame (GstVideoFilter * filter,
     GstVideoFrame * in_frame, GstVideoFrame * out_frame)
@@ -1763,6 +1901,13 @@ gst_video_convert_scale_transform_frame (GstVideoFilter * filter,
 
   GST_CAT_DEBUG_OBJECT (CAT_PERFORMANCE, filter, "doing video scaling");
 
+  if (!gst_video_convert_scale_update_crop (GST_VIDEO_CONVERT_SCALE (filter),
+          in_frame, gst_buffer_get_video_crop_meta (in_frame->buffer))) {
+    GST_ELEMENT_ERROR (filter, CORE, NEGOTIATION, (NULL),
+        ("could not create converter for the crop region"));
+    return GST_FLOW_ERROR;
+  }
+
   gst_video_converter_frame (priv->convert, in_frame, out_frame);
 
   return ret;
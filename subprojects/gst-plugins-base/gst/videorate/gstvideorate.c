@@ -101,6 +101,7 @@ enum
 #define DEFAULT_RATE            1.0
 #define DEFAULT_MAX_DUPLICATION_TIME      0
 #define DEFAULT_MAX_CLOSING_SEGMENT_DUPLICATION_DURATION   GST_SECOND
+#define DEFAULT_TAG_DUPLICATES  FALSE
 
 enum
 {
@@ -117,7 +118,8 @@ enum
   PROP_MAX_RATE,
   PROP_RATE,
   PROP_MAX_DUPLICATION_TIME,
-  PROP_MAX_CLOSING_SEGMENT_DUPLICATION_DURATION
+  PROP_MAX_CLOSING_SEGMENT_DUPLICATION_DURATION,
+  PROP_TAG_DUPLICATES
 };
 
 static GstStaticPadTemplate gst_video_rate_src_template =
@@ -318,6 +320,20 @@ gst_video_rate_class_init (GstVideoRateClass * klass)
           G_MAXUINT64, DEFAULT_MAX_CLOSING_SEGMENT_DUPLICATION_DURATION,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoRate:tag-duplicates:
+   *
+   * Put a #GstVideoDuplicateMeta on duplicated frames. Encoders based on
+   * #GstVideoEncoder can then output skip frames for them instead of
+   * encoding the same picture again.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (object_class, PROP_TAG_DUPLICATES,
+      g_param_spec_boolean ("tag-duplicates", "Tag duplicates",
+          "Put a GstVideoDuplicateMeta on duplicated frames",
+          DEFAULT_TAG_DUPLICATES, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (element_class,
       "Video rate adjuster", "Filter/Effect/Video",
       "Drops/duplicates/adjusts timestamps on video frames to make a perfect stream",
@@ -634,6 +650,7 @@ gst_video_rate_reset (GstVideoRate * videorate, gboolean on_flush)
   videorate->out_frame_count = 0;
   videorate->drop = 0;
   videorate->dup = 0;
+  videorate->dup_count = 0;
   videorate->next_ts = GST_CLOCK_TIME_NONE;
   videorate->last_ts = GST_CLOCK_TIME_NONE;
   videorate->discont = TRUE;
@@ -663,6 +680,7 @@ gst_video_rate_init (GstVideoRate * videorate)
   videorate->max_duplication_time = DEFAULT_MAX_DUPLICATION_TIME;
   videorate->max_closing_segment_duplication_duration =
       DEFAULT_MAX_CLOSING_SEGMENT_DUPLICATION_DURATION;
+  videorate->tag_duplicates = DEFAULT_TAG_DUPLICATES;
 
   videorate->from_rate_numerator = 0;
   videorate->from_rate_denominator = 0;
@@ -689,10 +707,15 @@ gst_video_rate_push_buffer (GstVideoRate * videorate, GstBuffer * outbuf,
   } else
     GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_DISCONT);
 
-  if (duplicate)
+  if (duplicate) {
     GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
-  else
+    videorate->dup_count++;
+    if (videorate->tag_duplicates)
+      gst_buffer_add_video_duplicate_meta (outbuf, videorate->dup_count);
+  } else {
     GST_BUFFER_FLAG_UNSET (outbuf, GST_BUFFER_FLAG_GAP);
+    videorate->dup_count = 0;
+  }
 
   /* this is the timestamp we put on the buffer */
   push_ts = videorate->next_ts;
@@ -770,9 +793,10 @@ gst_video_rate_flush_prev (GstVideoRate * videorate, gboolean duplicate,
   if (!videorate->prevbuf)
     goto eos_before_buffers;
 
-  outbuf = gst_buffer_ref (videorate->prevbuf);
-  /* make sure we can write to the metadata */
-  outbuf = gst_buffer_make_writable (outbuf);
+  /* We keep prevbuf and only the metadata of the pushed buffer is changed,
+   * so share the memory even if it couldn't be shared by a regular copy */
+  outbuf = gst_buffer_make_metadata_writable (gst_buffer_ref
+      (videorate->prevbuf));
 
   return gst_video_rate_push_buffer (videorate, outbuf, duplicate, next_intime,
       invalid_duration);
@@ -2027,6 +2051,9 @@ gst_video_rate_set_property (GObject * object,
       videorate->max_closing_segment_duplication_duration =
           g_value_get_uint64 (value);
       break;
+    case PROP_TAG_DUPLICATES:
+      videorate->tag_duplicates = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -2093,6 +2120,9 @@ gst_video_rate_get_property (GObject * object,
       g_value_set_uint64 (value,
           videorate->max_closing_segment_duplication_duration);
       break;
+    case PROP_TAG_DUPLICATES:
+      g_value_set_boolean (value, videorate->tag_duplicates);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
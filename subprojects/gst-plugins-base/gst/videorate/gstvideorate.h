@@ -59,6 +59,7 @@ struct _GstVideoRate
   gboolean updating_caps;
   guint64 max_duplication_time;
   guint64 max_closing_segment_duplication_duration;
+  guint dup_count;              /* duplicates of the current picture pushed */
 
   /* segment handling */
   GstSegment segment;
@@ -74,6 +75,7 @@ struct _GstVideoRate
   int max_rate;
   gdouble rate;
   gdouble pending_rate;
+  gboolean tag_duplicates;
 
   GstCaps *in_caps;
   /* Only set right after caps were set so that we still have a reference to
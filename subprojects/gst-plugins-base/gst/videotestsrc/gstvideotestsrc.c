@@ -55,6 +55,7 @@ GST_DEBUG_CATEGORY_STATIC (video_test_src_debug);
 #define DEFAULT_ANIMATION_MODE     GST_VIDEO_TEST_SRC_FRAMES
 #define DEFAULT_MOTION_TYPE        GST_VIDEO_TEST_SRC_WAVY
 #define DEFAULT_FLIP               FALSE
+#define DEFAULT_ZERO_COPY          FALSE
 #define DEFAULT_TIMESTAMP_OFFSET   0
 #define DEFAULT_IS_LIVE            FALSE
 #define DEFAULT_COLOR_SPEC         GST_VIDEO_TEST_SRC_BT601
@@ -86,6 +87,7 @@ enum
   PROP_ANIMATION_MODE,
   PROP_MOTION_TYPE,
   PROP_FLIP,
+  PROP_ZERO_COPY,
   PROP_LAST
 };
 
@@ -132,6 +134,8 @@ static void gst_video_test_src_get_times (GstBaseSrc * basesrc,
     GstBuffer * buffer, GstClockTime * start, GstClockTime * end);
 static gboolean gst_video_test_src_decide_allocation (GstBaseSrc * bsrc,
     GstQuery * query);
+static GstFlowReturn gst_video_test_src_alloc (GstBaseSrc * bsrc,
+    guint64 offset, guint length, GstBuffer ** buffer);
 static GstFlowReturn gst_video_test_src_fill (GstPushSrc * psrc,
     GstBuffer * buffer);
 static gboolean gst_video_test_src_start (GstBaseSrc * basesrc);
@@ -362,6 +366,24 @@ gst_video_test_src_class_init (GstVideoTestSrcClass * klass)
           G_MININT32, G_MAXINT32, DEFAULT_HORIZONTAL_SPEED,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstVideoTestSrc:zero-copy:
+   *
+   * For patterns that don't change over time, or only alternate between two
+   * frames like blink, push buffers sharing the memory of the cached
+   * pattern instead of copying it into a new buffer for every frame. The
+   * output memory is then read-only and not allocated from the negotiated
+   * buffer pool, which makes the source almost free when it is used to
+   * benchmark downstream elements.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_ZERO_COPY,
+      g_param_spec_boolean ("zero-copy", "Zero copy",
+          "Push references to the cached pattern for static patterns instead "
+          "of copying it", DEFAULT_ZERO_COPY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "Video test source", "Source/Video",
       "Creates a test video stream", "David A. Schleef <ds@schleef.org>");
@@ -378,6 +400,7 @@ gst_video_test_src_class_init (GstVideoTestSrcClass * klass)
   gstbasesrc_class->start = gst_video_test_src_start;
   gstbasesrc_class->stop = gst_video_test_src_stop;
   gstbasesrc_class->decide_allocation = gst_video_test_src_decide_allocation;
+  gstbasesrc_class->alloc = gst_video_test_src_alloc;
 
   gstpushsrc_class->fill = gst_video_test_src_fill;
 
@@ -404,6 +427,7 @@ gst_video_test_src_init (GstVideoTestSrc * src)
   src->animation_mode = DEFAULT_ANIMATION_MODE;
   src->motion_type = DEFAULT_MOTION_TYPE;
   src->flip = DEFAULT_FLIP;
+  src->zero_copy = DEFAULT_ZERO_COPY;
 
 }
 
@@ -527,10 +551,13 @@ gst_video_test_src_is_static_pattern (GstVideoTestSrc * videotestsrc)
   switch (videotestsrc->pattern_type) {
     case GST_VIDEO_TEST_SRC_SMPTE:
     case GST_VIDEO_TEST_SRC_SNOW:
-    case GST_VIDEO_TEST_SRC_BLINK:
     case GST_VIDEO_TEST_SRC_BALL:
       return FALSE;
 
+      /* blink alternates between two frames, both are cached */
+    case GST_VIDEO_TEST_SRC_BLINK:
+      break;
+
     case GST_VIDEO_TEST_SRC_ZONE_PLATE:
     case GST_VIDEO_TEST_SRC_CHROMA_ZONE_PLATE:
       if (videotestsrc->kxt != 0 || videotestsrc->kyt != 0 ||
@@ -739,6 +766,9 @@ gst_video_test_src_set_property (GObject * object, guint prop_id,
     case PROP_FLIP:
       src->flip = g_value_get_boolean (value);
       break;
+    case PROP_ZERO_COPY:
+      src->zero_copy = g_value_get_boolean (value);
+      break;
     default:
       break;
   }
@@ -746,7 +776,8 @@ gst_video_test_src_set_property (GObject * object, guint prop_id,
   if (invalidate) {
     /* Property change invalidated the current pattern - check if it's static now or not */
     src->have_static_pattern = gst_video_test_src_is_static_pattern (src);
-    gst_clear_buffer (&src->cached);
+    gst_clear_buffer (&src->cached[0]);
+    gst_clear_buffer (&src->cached[1]);
   }
 }
 
@@ -820,6 +851,9 @@ gst_video_test_src_get_property (GObject * object, guint prop_id,
     case PROP_FLIP:
       g_value_set_boolean (value, src->flip);
       break;
+    case PROP_ZERO_COPY:
+      g_value_set_boolean (value, src->zero_copy);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1026,7 +1060,8 @@ gst_video_test_src_setcaps (GstBaseSrc * bsrc, GstCaps * caps)
   videotestsrc->running_time = 0;
   videotestsrc->n_frames = 0;
 
-  gst_clear_buffer (&videotestsrc->cached);
+  gst_clear_buffer (&videotestsrc->cached[0]);
+  gst_clear_buffer (&videotestsrc->cached[1]);
 
   GST_OBJECT_UNLOCK (videotestsrc);
 
@@ -1247,6 +1282,57 @@ invalid_frame:
   }
 }
 
+/* returns the cached frame for the current frame of a static pattern,
+ * rendering it if needed */
+static GstFlowReturn
+gst_video_test_src_get_cached (GstVideoTestSrc * src, GstBuffer ** cached)
+{
+  GstFlowReturn ret;
+  guint idx = 0;
+
+  if (src->pattern_type == GST_VIDEO_TEST_SRC_BLINK)
+    idx = src->n_frames & 1;
+
+  if (src->cached[idx] == NULL) {
+    GstBuffer *buffer = gst_buffer_new_allocate (NULL, src->info.size, NULL);
+
+    ret = fill_image (GST_PUSH_SRC (src), buffer);
+    if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+      gst_buffer_unref (buffer);
+      return ret;
+    }
+    src->cached[idx] = buffer;
+  } else {
+    GST_LOG_OBJECT (src, "Reusing cached pattern buffer");
+  }
+
+  *cached = src->cached[idx];
+
+  return GST_FLOW_OK;
+}
+
+static GstFlowReturn
+gst_video_test_src_alloc (GstBaseSrc * bsrc, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+  GstVideoTestSrc *src = GST_VIDEO_TEST_SRC (bsrc);
+  GstBuffer *cached;
+  GstFlowReturn ret;
+
+  if (!src->zero_copy || !src->have_static_pattern)
+    return GST_BASE_SRC_CLASS (parent_class)->alloc (bsrc, offset, length,
+        buffer);
+
+  ret = gst_video_test_src_get_cached (src, &cached);
+  if (G_UNLIKELY (ret != GST_FLOW_OK))
+    return ret;
+
+  /* shares the memory, which makes it read-only for downstream */
+  *buffer = gst_buffer_copy (cached);
+
+  return GST_FLOW_OK;
+}
+
 static GstFlowReturn
 gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
 {
@@ -1261,29 +1347,28 @@ gst_video_test_src_fill (GstPushSrc * psrc, GstBuffer * buffer)
 
   if (src->have_static_pattern) {
     GstVideoFrame sframe, dframe;
+    GstBuffer *cached;
 
-    if (src->cached == NULL) {
-      src->cached = gst_buffer_new_allocate (NULL, src->info.size, NULL);
-
-      ret = fill_image (GST_PUSH_SRC (src), src->cached);
-      if (G_UNLIKELY (ret != GST_FLOW_OK))
-        goto fill_failed;
-    } else {
-      GST_LOG_OBJECT (src, "Reusing cached pattern buffer");
-    }
+    ret = gst_video_test_src_get_cached (src, &cached);
+    if (G_UNLIKELY (ret != GST_FLOW_OK))
+      goto fill_failed;
 
     /* Do a memory copy instead of just passing a reference to this buffer to
      * be consistent with other sources. This should make things clear for
      * cases where downstream cannot queue the same buffer twice (such as v4l2)
-     */
-    gst_video_frame_map (&sframe, &src->info, src->cached, GST_MAP_READ);
-    gst_video_frame_map (&dframe, &src->info, buffer, GST_MAP_WRITE);
-
-    if (!gst_video_frame_copy (&dframe, &sframe))
-      goto copy_failed;
-
-    gst_video_frame_unmap (&sframe);
-    gst_video_frame_unmap (&dframe);
+     * unless zero-copy is enabled, in which case the buffer from alloc()
+     * already shares the cached memory */
+    if (gst_buffer_peek_memory (buffer, 0) != gst_buffer_peek_memory (cached,
+            0)) {
+      gst_video_frame_map (&sframe, &src->info, cached, GST_MAP_READ);
+      gst_video_frame_map (&dframe, &src->info, buffer, GST_MAP_WRITE);
+
+      if (!gst_video_frame_copy (&dframe, &sframe))
+        goto copy_failed;
+
+      gst_video_frame_unmap (&sframe);
+      gst_video_frame_unmap (&dframe);
+    }
   } else {
     ret = fill_image (GST_PUSH_SRC (src), buffer);
     if (G_UNLIKELY (ret != GST_FLOW_OK))
@@ -1383,7 +1468,8 @@ gst_video_test_src_stop (GstBaseSrc * basesrc)
   src->n_lines = 0;
   src->lines = NULL;
 
-  gst_clear_buffer (&src->cached);
+  gst_clear_buffer (&src->cached[0]);
+  gst_clear_buffer (&src->cached[1]);
 
   return TRUE;
 }
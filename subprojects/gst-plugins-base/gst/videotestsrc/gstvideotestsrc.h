@@ -207,9 +207,11 @@ struct _GstVideoTestSrc {
   gint offset;
   gpointer *lines;
 
-  /* cached buffer used for static patterns that don't change */
-  GstBuffer *cached;
+  /* cached buffers used for static patterns that don't change, the second
+   * one is only used by blink */
+  GstBuffer *cached[2];
   gboolean have_static_pattern;
+  gboolean zero_copy;
 };
 
 GST_ELEMENT_REGISTER_DECLARE (videotestsrc);
@@ -714,6 +714,52 @@ GST_START_TEST (test_pull_sample_refcounts)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pull_sample_batch)
+{
+  GstElement *sink;
+  GstBufferList *list;
+  GstSample *sample;
+  gint i;
+
+  sink = setup_appsink ();
+
+  ASSERT_SET_STATE (sink, GST_STATE_PLAYING, GST_STATE_CHANGE_ASYNC);
+
+  for (i = 0; i < 5; i++)
+    fail_unless (gst_pad_push (mysrcpad,
+            gst_buffer_new_and_alloc (i + 1)) == GST_FLOW_OK);
+
+  sample = gst_app_sink_try_pull_sample_batch (GST_APP_SINK (sink), 3,
+      GST_CLOCK_TIME_NONE);
+  fail_unless (sample != NULL);
+  fail_unless (gst_sample_get_buffer (sample) == NULL);
+  list = gst_sample_get_buffer_list (sample);
+  fail_unless_equals_int (gst_buffer_list_length (list), 3);
+  for (i = 0; i < 3; i++)
+    fail_unless_equals_int (gst_buffer_get_size (gst_buffer_list_get (list,
+                i)), i + 1);
+  gst_sample_unref (sample);
+
+  /* the rest of the queue */
+  sample = gst_app_sink_try_pull_sample_batch (GST_APP_SINK (sink), 0,
+      GST_CLOCK_TIME_NONE);
+  fail_unless (sample != NULL);
+  list = gst_sample_get_buffer_list (sample);
+  fail_unless_equals_int (gst_buffer_list_length (list), 2);
+  fail_unless_equals_int (gst_buffer_get_size (gst_buffer_list_get (list, 0)),
+      4);
+  gst_sample_unref (sample);
+
+  /* nothing queued anymore */
+  fail_unless (gst_app_sink_try_pull_sample_batch (GST_APP_SINK (sink), 0,
+          10 * GST_MSECOND) == NULL);
+
+  ASSERT_SET_STATE (sink, GST_STATE_NULL, GST_STATE_CHANGE_SUCCESS);
+  cleanup_appsink (sink);
+}
+
+GST_END_TEST;
+
 static gboolean
 new_event_cb (GstAppSink * appsink, gpointer callback_data)
 {
@@ -1089,6 +1135,7 @@ appsink_suite (void)
   tcase_add_test (tc_chain, test_pull_preroll);
   tcase_add_test (tc_chain, test_do_not_care_preroll);
   tcase_add_test (tc_chain, test_pull_sample_refcounts);
+  tcase_add_test (tc_chain, test_pull_sample_batch);
   tcase_add_test (tc_chain, test_event_callback);
   tcase_add_test (tc_chain, test_event_signals);
   tcase_add_test (tc_chain, test_event_paused);
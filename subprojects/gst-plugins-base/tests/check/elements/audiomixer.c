@@ -2220,6 +2220,126 @@ GST_START_TEST (test_qos_message_live)
 
 GST_END_TEST;
 
+GST_START_TEST (test_max_active_pads)
+{
+  GstHarness *h, *h2, *h3;
+  GstBuffer *b;
+  GstMapInfo map;
+  GstPad *pad;
+  gdouble rms;
+  gsize i;
+  static const char *caps_str = "audio/x-raw, format=(string)S8, "
+      "rate=(int)10, channels=(int)1, layout=(string)interleaved";
+
+  h = gst_harness_new_with_padnames ("audiomixer", "sink_0", "src");
+  g_object_set (h->element, "output-buffer-duration", GST_SECOND,
+      "max-active-pads", 1, NULL);
+  h2 = gst_harness_new_with_element (h->element, "sink_1", NULL);
+  h3 = gst_harness_new_with_element (h->element, "sink_2", NULL);
+
+  gst_harness_play (h);
+  gst_harness_play (h2);
+  gst_harness_play (h3);
+  gst_harness_set_caps_str (h, caps_str, caps_str);
+  gst_harness_set_src_caps_str (h2, caps_str);
+  gst_harness_set_src_caps_str (h3, caps_str);
+
+  gst_harness_push (h, new_buffer (20, 1, 0, 2 * GST_SECOND, 0));
+  gst_harness_push (h2, new_buffer (20, 3, 0, 2 * GST_SECOND, 0));
+  gst_harness_push (h3, new_buffer (20, 2, 0, 2 * GST_SECOND, 0));
+
+  /* nothing was measured yet, all pads are mixed */
+  b = gst_harness_pull (h);
+  fail_unless_equals_int64 (GST_BUFFER_PTS (b), 0);
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.size, 10);
+  for (i = 0; i < map.size; i++)
+    fail_unless_equals_int (map.data[i], 6);
+  gst_buffer_unmap (b, &map);
+  gst_buffer_unref (b);
+
+  /* then only the loudest one */
+  b = gst_harness_pull (h);
+  fail_unless_equals_int64 (GST_BUFFER_PTS (b), GST_SECOND);
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.size, 10);
+  for (i = 0; i < map.size; i++)
+    fail_unless_equals_int (map.data[i], 3);
+  gst_buffer_unmap (b, &map);
+  gst_buffer_unref (b);
+
+  pad = gst_element_get_static_pad (h->element, "sink_1");
+  g_object_get (pad, "rms", &rms, NULL);
+  fail_unless (G_APPROX_VALUE (rms, 3.0 / 128.0, 1e-6));
+  gst_object_unref (pad);
+
+  gst_harness_teardown (h3);
+  gst_harness_teardown (h2);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_minus_pads)
+{
+  GstHarness *h, *h2, *hm0, *hm1;
+  GstBuffer *b;
+  GstMapInfo map;
+  gsize i;
+  static const char *caps_str = "audio/x-raw, format=(string)S8, "
+      "rate=(int)10, channels=(int)1, layout=(string)interleaved";
+
+  h = gst_harness_new_with_padnames ("audiomixer", "sink_0", "src");
+  g_object_set (h->element, "output-buffer-duration", GST_SECOND, NULL);
+  h2 = gst_harness_new_with_element (h->element, "sink_1", NULL);
+  hm0 = gst_harness_new_with_element (h->element, NULL, "minus_0");
+  hm1 = gst_harness_new_with_element (h->element, NULL, "minus_1");
+
+  gst_harness_play (h);
+  gst_harness_play (h2);
+  gst_harness_play (hm0);
+  gst_harness_play (hm1);
+  gst_harness_set_caps_str (h, caps_str, caps_str);
+  gst_harness_set_src_caps_str (h2, caps_str);
+
+  gst_harness_push (h, new_buffer (10, 1, 0, GST_SECOND, 0));
+  gst_harness_push (h2, new_buffer (10, 4, 0, GST_SECOND, 0));
+
+  b = gst_harness_pull (h);
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  for (i = 0; i < map.size; i++)
+    fail_unless_equals_int (map.data[i], 5);
+  gst_buffer_unmap (b, &map);
+  gst_buffer_unref (b);
+
+  /* everything but sink_0 */
+  b = gst_harness_pull (hm0);
+  fail_unless_equals_int64 (GST_BUFFER_PTS (b), 0);
+  fail_unless_equals_int64 (GST_BUFFER_DURATION (b), GST_SECOND);
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.size, 10);
+  for (i = 0; i < map.size; i++)
+    fail_unless_equals_int (map.data[i], 4);
+  gst_buffer_unmap (b, &map);
+  gst_buffer_unref (b);
+
+  /* everything but sink_1 */
+  b = gst_harness_pull (hm1);
+  gst_buffer_map (b, &map, GST_MAP_READ);
+  fail_unless_equals_int (map.size, 10);
+  for (i = 0; i < map.size; i++)
+    fail_unless_equals_int (map.data[i], 1);
+  gst_buffer_unmap (b, &map);
+  gst_buffer_unref (b);
+
+  gst_harness_teardown (hm1);
+  gst_harness_teardown (hm0);
+  gst_harness_teardown (h2);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 audiomixer_suite (void)
 {
@@ -2249,6 +2369,8 @@ audiomixer_suite (void)
   tcase_add_test (tc_chain, test_segment_base_handling);
   tcase_add_test (tc_chain, test_sinkpad_property_controller);
   tcase_add_test (tc_chain, test_qos_message_live);
+  tcase_add_test (tc_chain, test_max_active_pads);
+  tcase_add_test (tc_chain, test_minus_pads);
   tcase_add_checked_fixture (tc_chain, test_setup, test_teardown);
   tcase_add_test (tc_chain, test_change_output_caps);
   tcase_add_test (tc_chain, test_change_output_caps_mid_output_buffer);
@@ -2323,6 +2323,132 @@ GST_START_TEST (test_gap_events)
 
 GST_END_TEST;
 
+GST_START_TEST (test_skip_unchanged)
+{
+  GstBuffer *buf;
+  GstElement *comp = gst_element_factory_make ("compositor", NULL);
+  GstHarness *h = gst_harness_new_with_element (comp, "sink_%u", "src");
+  GstPad *pad;
+  GstMapInfo info;
+  gint i, j;
+
+  g_object_set (comp, "background", 1, "skip-unchanged", TRUE, NULL);
+  pad = gst_element_get_static_pad (comp, "sink_0");
+
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw, format=RGBA, width=4, height=32, framerate=25/1");
+  gst_harness_set_src_caps_str (h,
+      "video/x-raw, format=RGBA, width=4, height=4, framerate=25/2");
+
+  gst_harness_play (h);
+
+  /* every input lasts for two output frames, the second one has nothing
+   * changed. The second input is moved down, which has to clear the band
+   * it was drawn in before */
+  for (i = 0; i < 2; i++) {
+    gint ypos = i * 20;
+
+    g_object_set (pad, "ypos", ypos, NULL);
+
+    buf = gst_buffer_new_allocate (NULL, 4 * 4 * 4, NULL);
+    gst_buffer_memset (buf, 0, 42, 4 * 4 * 4);
+    GST_BUFFER_PTS (buf) = i * 80 * GST_MSECOND;
+    GST_BUFFER_DURATION (buf) = 80 * GST_MSECOND;
+    gst_harness_push (h, buf);
+
+    for (j = 0; j < 2; j++) {
+      buf = gst_harness_pull (h);
+      gst_buffer_map (buf, &info, GST_MAP_READ);
+      fail_unless_equals_int (info.data[0], ypos == 0 ? 42 : 0);
+      fail_unless_equals_int (info.data[20 * 4 * 4], ypos == 20 ? 42 : 0);
+      fail_unless_equals_int (info.data[10 * 4 * 4], 0);
+      gst_buffer_unmap (buf, &info);
+      gst_buffer_unref (buf);
+    }
+  }
+
+  gst_object_unref (pad);
+  gst_harness_teardown (h);
+  gst_object_unref (comp);
+}
+
+GST_END_TEST;
+
+static GstBuffer *
+run_mosaic (guint max_threads)
+{
+  GstElement *pipeline, *sink;
+  GString *desc;
+  GstBus *bus;
+  GstMessage *msg;
+  GstBuffer *buf;
+  gint i;
+
+  /* one large input at the top and many small ones below it, so splitting
+   * the output by number of lines gives the threads different amounts
+   * of work */
+  desc = g_string_new (NULL);
+  g_string_append_printf (desc, "compositor name=c background=black "
+      "max-threads=%u sink_0::xpos=0 sink_0::ypos=0", max_threads);
+  for (i = 1; i <= 16; i++)
+    g_string_append_printf (desc, " sink_%d::xpos=%d sink_%d::ypos=%d", i,
+        ((i - 1) % 8) * 20, i, 60 + ((i - 1) / 8) * 15);
+  g_string_append (desc, " ! video/x-raw,format=AYUV,width=160,height=90 ! "
+      "fakesink name=sink signal-handoffs=true");
+  g_string_append (desc, " videotestsrc num-buffers=1 pattern=smpte ! "
+      "video/x-raw,format=AYUV,width=160,height=60 ! c.sink_0");
+  for (i = 1; i <= 16; i++)
+    g_string_append_printf (desc, " videotestsrc num-buffers=1 pattern=%d ! "
+        "video/x-raw,format=AYUV,width=20,height=15 ! c.sink_%d", i % 16, i);
+
+  pipeline = gst_parse_launch (desc->str, NULL);
+  g_string_free (desc, TRUE);
+  fail_unless (pipeline != NULL);
+
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  g_signal_connect (sink, "handoff", G_CALLBACK (handoff_buffer_cb), NULL);
+  gst_object_unref (sink);
+
+  bus = gst_pipeline_get_bus (GST_PIPELINE (pipeline));
+  fail_if (gst_element_set_state (pipeline,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE);
+  msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+  fail_unless (handoff_buffer != NULL);
+  buf = handoff_buffer;
+  handoff_buffer = NULL;
+
+  return buf;
+}
+
+GST_START_TEST (test_mosaic_threads)
+{
+  GstBuffer *expected, *buf;
+  GstMapInfo info;
+  guint max_threads;
+
+  expected = run_mosaic (1);
+  gst_buffer_map (expected, &info, GST_MAP_READ);
+
+  for (max_threads = 2; max_threads <= 7; max_threads += 5) {
+    buf = run_mosaic (max_threads);
+    fail_unless (gst_buffer_memcmp (buf, 0, info.data, info.size) == 0);
+    gst_buffer_unref (buf);
+  }
+
+  gst_buffer_unmap (expected, &info);
+  gst_buffer_unref (expected);
+}
+
+GST_END_TEST;
+
 static GstBuffer *expected_selected_buffer = NULL;
 
 static void
@@ -2556,6 +2682,8 @@ compositor_suite (void)
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3);
   tcase_add_test (tc_chain, test_start_time_first_live_drop_3_unlinked_1);
   tcase_add_test (tc_chain, test_gap_events);
+  tcase_add_test (tc_chain, test_skip_unchanged);
+  tcase_add_test (tc_chain, test_mosaic_threads);
   tcase_add_test (tc_chain, test_signals);
   tcase_add_test (tc_chain, test_reverse);
 
@@ -488,6 +488,72 @@ GST_START_TEST (test_opus_decode_plc_timestamps_with_fec)
 
 GST_END_TEST;
 
+GST_START_TEST (test_opus_batch_encode)
+{
+  GstHarness *h0, *h1;
+  GstBuffer *buf;
+  GstEvent *event;
+  GstCaps *caps;
+  gint i;
+
+  h0 = gst_harness_new_with_padnames ("opusbatchenc", "sink_0", "src_0");
+  h1 = gst_harness_new_with_element (h0->element, "sink_1", "src_1");
+  gst_harness_set_src_caps_str (h0, AUDIO_CAPS_STRING);
+  gst_harness_set_src_caps_str (h1, AUDIO_CAPS_STRING);
+
+  /* both streams are encoded in the same aggregate call */
+  for (i = 0; i < 4; i++) {
+    buf = gst_harness_create_buffer (h0, 960 * 2);
+    gst_buffer_memset (buf, 0, 0, 960 * 2);
+    GST_BUFFER_PTS (buf) = i * 20 * GST_MSECOND;
+    GST_BUFFER_DURATION (buf) = 20 * GST_MSECOND;
+    fail_unless_equals_int (gst_harness_push (h0, gst_buffer_ref (buf)),
+        GST_FLOW_OK);
+    fail_unless_equals_int (gst_harness_push (h1, buf), GST_FLOW_OK);
+
+    buf = gst_harness_pull (h0);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buf), i * 20 * GST_MSECOND);
+    fail_unless_equals_uint64 (GST_BUFFER_DURATION (buf), 20 * GST_MSECOND);
+    gst_buffer_unref (buf);
+
+    buf = gst_harness_pull (h1);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buf), i * 20 * GST_MSECOND);
+    fail_unless_equals_uint64 (GST_BUFFER_DURATION (buf), 20 * GST_MSECOND);
+    gst_buffer_unref (buf);
+  }
+
+  caps = gst_pad_get_current_caps (h1->sinkpad);
+  fail_unless (caps != NULL);
+  fail_unless (gst_structure_has_name (gst_caps_get_structure (caps, 0),
+          "audio/x-opus"));
+  gst_caps_unref (caps);
+
+  /* ending one stream does not end the others */
+  fail_unless (gst_harness_push_event (h0, gst_event_new_eos ()));
+  while ((event = gst_harness_pull_event (h0))) {
+    gboolean eos = GST_EVENT_TYPE (event) == GST_EVENT_EOS;
+
+    gst_event_unref (event);
+    if (eos)
+      break;
+  }
+  fail_unless (event != NULL);
+
+  buf = gst_harness_create_buffer (h1, 960 * 2);
+  gst_buffer_memset (buf, 0, 0, 960 * 2);
+  GST_BUFFER_PTS (buf) = 80 * GST_MSECOND;
+  GST_BUFFER_DURATION (buf) = 20 * GST_MSECOND;
+  fail_unless_equals_int (gst_harness_push (h1, buf), GST_FLOW_OK);
+  buf = gst_harness_pull (h1);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (buf), 80 * GST_MSECOND);
+  gst_buffer_unref (buf);
+
+  gst_harness_teardown (h1);
+  gst_harness_teardown (h0);
+}
+
+GST_END_TEST;
+
 static Suite *
 opus_suite (void)
 {
@@ -502,6 +568,7 @@ opus_suite (void)
   tcase_add_test (tc_chain, test_opus_encode_properties);
   tcase_add_test (tc_chain, test_opusdec_getcaps);
   tcase_add_test (tc_chain, test_opus_decode_plc_timestamps_with_fec);
+  tcase_add_test (tc_chain, test_opus_batch_encode);
 
   return s;
 }
@@ -24,6 +24,7 @@
 #endif
 
 #include <gst/check/gstcheck.h>
+#include <gst/video/video.h>
 
 /* For ease of programming we use globals to keep refs for our floating
  * src and sink pads we create; otherwise we always have to do get_pad,
@@ -1589,6 +1590,71 @@ GST_START_TEST (test_nopts_in_middle)
 
 GST_END_TEST;
 
+GST_START_TEST (test_duplicates_share_memory)
+{
+  GstElement *videorate;
+  GstBuffer *first, *second;
+  GstMemory *mem;
+  GstCaps *caps;
+  GList *l;
+  guint n_dups = 0, expected_count = 0;
+
+  videorate = setup_videorate ();
+  g_object_set (videorate, "tag-duplicates", TRUE, NULL);
+  fail_unless (gst_element_set_state (videorate,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  caps = gst_caps_from_string (VIDEO_CAPS_STRING);
+  gst_check_setup_events (mysrcpad, videorate, caps, GST_FORMAT_TIME);
+  gst_caps_unref (caps);
+
+  first = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (first) = 0;
+  gst_buffer_memset (first, 0, 1, 4);
+  fail_unless (gst_pad_push (mysrcpad, gst_buffer_ref (first)) == GST_FLOW_OK);
+
+  second = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_TIMESTAMP (second) = GST_SECOND * 4 / 25;
+  gst_buffer_memset (second, 0, 2, 4);
+  fail_unless (gst_pad_push (mysrcpad, gst_buffer_ref (second)) == GST_FLOW_OK);
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* every output frame shares the memory of one of the input frames and the
+   * duplicates carry the meta */
+  fail_unless (g_list_length (buffers) >= 5);
+  mem = NULL;
+  for (l = buffers; l; l = l->next) {
+    GstBuffer *outbuf = l->data;
+    GstVideoDuplicateMeta *meta = gst_buffer_get_video_duplicate_meta (outbuf);
+
+    fail_unless_equals_int (gst_buffer_n_memory (outbuf), 1);
+    fail_unless (gst_buffer_peek_memory (outbuf, 0) ==
+        gst_buffer_peek_memory (first, 0)
+        || gst_buffer_peek_memory (outbuf, 0) ==
+        gst_buffer_peek_memory (second, 0));
+
+    if (GST_BUFFER_FLAG_IS_SET (outbuf, GST_BUFFER_FLAG_GAP)) {
+      fail_unless (meta != NULL);
+      fail_unless (gst_buffer_peek_memory (outbuf, 0) == mem);
+      fail_unless_equals_int (meta->count, ++expected_count);
+      n_dups++;
+    } else {
+      fail_unless (meta == NULL);
+      mem = gst_buffer_peek_memory (outbuf, 0);
+      expected_count = 0;
+    }
+  }
+  fail_unless (n_dups >= 3);
+
+  gst_buffer_unref (first);
+  gst_buffer_unref (second);
+  cleanup_videorate (videorate);
+}
+
+GST_END_TEST;
+
 static Suite *
 videorate_suite (void)
 {
@@ -1615,6 +1681,7 @@ videorate_suite (void)
   tcase_add_loop_test (tc_chain, test_query_position, 0,
       G_N_ELEMENTS (position_tests));
   tcase_add_test (tc_chain, test_nopts_in_middle);
+  tcase_add_test (tc_chain, test_duplicates_share_memory);
 
   return s;
 }
@@ -1015,6 +1015,52 @@ GST_START_TEST (test_transform_meta)
 
 GST_END_TEST;
 
+GST_START_TEST (test_crop_meta)
+{
+  GstHarness *h;
+  GstBuffer *buffer;
+  GstVideoCropMeta *crop_meta;
+  GstMapInfo map;
+  guint8 data[64];
+  guint i;
+
+  h = gst_harness_new ("videoscale");
+
+  /* 8x8 frame where only the bottom right quarter is not black */
+  for (i = 0; i < sizeof (data); i++)
+    data[i] = (i / 8 >= 4 && i % 8 >= 4) ? 200 : 0;
+  buffer = gst_buffer_new_allocate (NULL, sizeof (data), NULL);
+  gst_buffer_fill (buffer, 0, data, sizeof (data));
+  gst_buffer_add_video_meta (buffer, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_FORMAT_GRAY8, 8, 8);
+  crop_meta = gst_buffer_add_video_crop_meta (buffer);
+  crop_meta->x = 4;
+  crop_meta->y = 4;
+  crop_meta->width = 4;
+  crop_meta->height = 4;
+
+  /* the caps have the cropped size */
+  gst_harness_set_sink_caps_str (h,
+      "video/x-raw,width=2,height=2,format=GRAY8");
+  gst_harness_set_src_caps_str (h, "video/x-raw,width=4,height=4,format=GRAY8");
+  fail_unless_equals_int (gst_harness_push (h, buffer), GST_FLOW_OK);
+
+  buffer = gst_harness_pull (h);
+  fail_unless (gst_buffer_get_video_crop_meta (buffer) == NULL);
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  fail_unless (map.size >= 8);
+  for (i = 0; i < 2; i++) {
+    fail_unless_equals_int (map.data[i * 4 + 0], 200);
+    fail_unless_equals_int (map.data[i * 4 + 1], 200);
+  }
+  gst_buffer_unmap (buffer, &map);
+  gst_buffer_unref (buffer);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 #endif /* !defined(VSCALE_TEST_GROUP) */
 
 static Suite *
@@ -1038,6 +1084,7 @@ videoscale_suite (void)
 #endif
   tcase_add_test (tc_chain, test_basetransform_negotiation);
   tcase_add_test (tc_chain, test_transform_meta);
+  tcase_add_test (tc_chain, test_crop_meta);
 #else
 #if VSCALE_TEST_GROUP == 1
   tcase_add_test (tc_chain, test_downscale_640x480_320x240_method_0);
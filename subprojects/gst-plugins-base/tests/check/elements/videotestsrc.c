@@ -594,7 +594,51 @@ GST_START_TEST (test_patterns_are_deterministic)
 
 GST_END_TEST;
 
+GST_START_TEST (test_zero_copy)
+{
+  GstHarness *h[2];
+  GstBuffer *buf[2][3];
+  gint i, frame;
+
+  /* blink alternates between two cached frames */
+  for (i = 0; i < G_N_ELEMENTS (h); i++) {
+    h[i] = gst_harness_new ("videotestsrc");
+    gst_util_set_object_arg (G_OBJECT (h[i]->element), "pattern", "blink");
+    g_object_set (h[i]->element, "zero-copy", i == 1, NULL);
+    gst_harness_set_blocking_push_mode (h[i]);
+    gst_harness_play (h[i]);
+
+    for (frame = 0; frame < G_N_ELEMENTS (buf[i]); frame++)
+      buf[i][frame] = gst_harness_pull (h[i]);
+  }
+
+  for (frame = 0; frame < G_N_ELEMENTS (buf[0]); frame++) {
+    gchar *ref_checksum = get_buffer_checksum (buf[0][frame]);
+    gchar *checksum = get_buffer_checksum (buf[1][frame]);
+
+    fail_unless_equals_string (ref_checksum, checksum);
+    fail_unless_equals_uint64 (GST_BUFFER_PTS (buf[0][frame]),
+        GST_BUFFER_PTS (buf[1][frame]));
+    g_free (ref_checksum);
+    g_free (checksum);
+  }
 
+  /* only the zero-copy source shares memory between frames */
+  fail_if (gst_buffer_peek_memory (buf[0][0], 0) ==
+      gst_buffer_peek_memory (buf[0][2], 0));
+  fail_unless (gst_buffer_peek_memory (buf[1][0], 0) ==
+      gst_buffer_peek_memory (buf[1][2], 0));
+  fail_if (gst_buffer_peek_memory (buf[1][0], 0) ==
+      gst_buffer_peek_memory (buf[1][1], 0));
+
+  for (i = 0; i < G_N_ELEMENTS (h); i++) {
+    for (frame = 0; frame < G_N_ELEMENTS (buf[i]); frame++)
+      gst_buffer_unref (buf[i][frame]);
+    gst_harness_teardown (h[i]);
+  }
+}
+
+GST_END_TEST;
 
 /* FIXME: add tests for YUV formats */
 
@@ -618,6 +662,7 @@ videotestsrc_suite (void)
   tcase_add_test (tc_chain, test_backward_playback);
   tcase_add_test (tc_chain, test_duration_query);
   tcase_add_test (tc_chain, test_patterns_are_deterministic);
+  tcase_add_test (tc_chain, test_zero_copy);
 
   return s;
 }
@@ -28,6 +28,9 @@
 #include <fcntl.h>
 #include <gst/allocators/gstdmabuf.h>
 #include <gst/allocators/gstfdmemory.h>
+#include <gst/allocators/gsthugepagememory.h>
+#include <gst/allocators/gstnumamemory.h>
+#include <gst/video/video.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -65,6 +68,36 @@ GST_START_TEST (test_dmabuf)
 
 GST_END_TEST;
 
+GST_START_TEST (test_dmabuf_drm_modifier)
+{
+  char tmpfilename[] = "/tmp/dmabuf-test.XXXXXX";
+  int fd;
+  GstMemory *mem;
+  GstAllocator *alloc;
+  guint64 modifier = GST_DMABUF_DRM_MODIFIER_INVALID;
+
+  fd = mkstemp (tmpfilename);
+  fail_unless (fd > 0);
+  fail_unless (g_unlink (tmpfilename) == 0);
+
+  alloc = gst_dmabuf_allocator_new ();
+  mem = gst_dmabuf_allocator_alloc (alloc, fd, FILE_SIZE);
+
+  /* no modifier attached, linear is assumed */
+  fail_if (gst_dmabuf_memory_get_drm_modifier (mem, &modifier));
+  fail_unless_equals_uint64 (modifier, GST_DMABUF_DRM_MODIFIER_LINEAR);
+
+  gst_dmabuf_memory_set_drm_modifier (mem,
+      G_GUINT64_CONSTANT (0x0100000000000002));
+  fail_unless (gst_dmabuf_memory_get_drm_modifier (mem, &modifier));
+  fail_unless_equals_uint64 (modifier, G_GUINT64_CONSTANT (0x0100000000000002));
+
+  gst_memory_unref (mem);
+  g_object_unref (alloc);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_fdmem)
 {
   GstAllocator *alloc;
@@ -101,6 +134,149 @@ GST_START_TEST (test_fdmem)
 
 GST_END_TEST;
 
+GST_START_TEST (test_numamem)
+{
+  GstAllocator *alloc;
+  GstAllocationParams params;
+  GstMemory *mem, *sub, *copy;
+  GstMapInfo info;
+
+  alloc = gst_numa_allocator_new (0);
+  fail_unless (alloc);
+  fail_unless_equals_int (gst_numa_allocator_get_node (GST_NUMA_ALLOCATOR
+          (alloc)), 0);
+
+  gst_allocation_params_init (&params);
+  params.align = 63;
+  params.prefix = 16;
+  mem = gst_allocator_alloc (alloc, 1000, &params);
+  fail_unless (mem);
+  fail_unless (gst_is_numa_memory (mem));
+  fail_unless_equals_int (gst_numa_memory_get_node (mem), 0);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+  fail_unless_equals_int (info.size, 1000);
+  fail_unless (((guintptr) info.data - 16) % 64 == 0);
+  memset (info.data, 'a', info.size);
+  info.data[10] = 'b';
+  gst_memory_unmap (mem, &info);
+
+  sub = gst_memory_share (mem, 10, 20);
+  fail_unless (gst_is_numa_memory (sub));
+  fail_unless (gst_memory_map (sub, &info, GST_MAP_READ));
+  fail_unless_equals_int (info.size, 20);
+  fail_unless (info.data[0] == 'b');
+  gst_memory_unmap (sub, &info);
+  gst_memory_unref (sub);
+
+  copy = gst_memory_copy (mem, 10, 1);
+  fail_unless (gst_is_numa_memory (copy));
+  fail_unless (gst_memory_map (copy, &info, GST_MAP_READ));
+  fail_unless (info.data[0] == 'b');
+  gst_memory_unmap (copy, &info);
+  gst_memory_unref (copy);
+
+  gst_memory_unref (mem);
+  gst_object_unref (alloc);
+
+  /* allocating on the current node works everywhere */
+  alloc = gst_numa_allocator_new (-1);
+  mem = gst_allocator_alloc (alloc, 4096, NULL);
+  fail_unless (mem);
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_READWRITE));
+  memset (info.data, 0, info.size);
+  gst_memory_unmap (mem, &info);
+  gst_memory_unref (mem);
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_hugepagemem)
+{
+  GstAllocator *alloc;
+  GstAllocationParams params;
+  GstMemory *mem, *sub;
+  GstMapInfo info;
+
+  alloc = gst_huge_page_allocator_new ();
+  fail_unless (alloc);
+
+  gst_allocation_params_init (&params);
+  params.align = 63;
+  params.prefix = 16;
+  mem = gst_allocator_alloc (alloc, 1000, &params);
+  fail_unless (mem);
+  fail_unless (gst_is_huge_page_memory (mem));
+  /* rounded up to a whole huge page */
+  fail_unless (mem->maxsize >= GST_HUGE_PAGE_SIZE - 63);
+
+  fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+  fail_unless_equals_int (info.size, 1000);
+  fail_unless (((guintptr) info.data - 16) % 64 == 0);
+  memset (info.data, 'a', info.size);
+  info.data[10] = 'b';
+  gst_memory_unmap (mem, &info);
+
+  sub = gst_memory_share (mem, 10, 20);
+  fail_unless (gst_is_huge_page_memory (sub));
+  fail_unless (gst_huge_page_memory_is_reserved (sub) ==
+      gst_huge_page_memory_is_reserved (mem));
+  fail_unless (gst_memory_map (sub, &info, GST_MAP_READ));
+  fail_unless_equals_int (info.size, 20);
+  fail_unless (info.data[0] == 'b');
+  gst_memory_unmap (sub, &info);
+  gst_memory_unref (sub);
+
+  gst_memory_unref (mem);
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_hugepagemem_video_pool)
+{
+  GstBufferPool *pool;
+  GstAllocator *alloc;
+  GstStructure *config;
+  GstVideoInfo vinfo;
+  GstCaps *caps;
+  GstBuffer *buf;
+
+  gst_video_info_set_format (&vinfo, GST_VIDEO_FORMAT_NV12, 1920, 1080);
+  caps = gst_video_info_to_caps (&vinfo);
+
+  alloc = gst_huge_page_allocator_new ();
+  pool = gst_video_buffer_pool_new ();
+  config = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (config, caps, vinfo.size, 2, 0);
+  gst_buffer_pool_config_set_allocator (config, alloc, NULL);
+  gst_buffer_pool_config_add_option (config,
+      GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT);
+  fail_unless (gst_buffer_pool_set_config (pool, config));
+  gst_caps_unref (caps);
+
+  config = gst_buffer_pool_get_config (pool);
+  fail_unless (gst_buffer_pool_config_has_option (config,
+          GST_BUFFER_POOL_OPTION_VIDEO_PREFAULT));
+  gst_structure_free (config);
+
+  /* the minimum buffers are allocated and prefaulted here */
+  fail_unless (gst_buffer_pool_set_active (pool, TRUE));
+
+  fail_unless_equals_int (gst_buffer_pool_acquire_buffer (pool, &buf, NULL),
+      GST_FLOW_OK);
+  fail_unless (gst_is_huge_page_memory (gst_buffer_peek_memory (buf, 0)));
+  fail_unless (gst_buffer_get_size (buf) >= vinfo.size);
+  gst_buffer_unref (buf);
+
+  fail_unless (gst_buffer_pool_set_active (pool, FALSE));
+  gst_object_unref (pool);
+  gst_object_unref (alloc);
+}
+
+GST_END_TEST;
+
 static Suite *
 allocators_suite (void)
 {
@@ -109,7 +285,11 @@ allocators_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_dmabuf);
+  tcase_add_test (tc_chain, test_dmabuf_drm_modifier);
   tcase_add_test (tc_chain, test_fdmem);
+  tcase_add_test (tc_chain, test_numamem);
+  tcase_add_test (tc_chain, test_hugepagemem);
+  tcase_add_test (tc_chain, test_hugepagemem_video_pool);
 
   return s;
 }
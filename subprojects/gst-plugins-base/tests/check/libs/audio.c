@@ -987,6 +987,52 @@ GST_START_TEST (test_fill_silence)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pack_unpack_24)
+{
+  static const GstAudioFormat formats[] = {
+    GST_AUDIO_FORMAT_S24LE, GST_AUDIO_FORMAT_S24BE, GST_AUDIO_FORMAT_U24LE,
+    GST_AUDIO_FORMAT_U24BE, GST_AUDIO_FORMAT_S20LE, GST_AUDIO_FORMAT_S20BE,
+    GST_AUDIO_FORMAT_S18LE, GST_AUDIO_FORMAT_U18BE
+  };
+  /* more than one block of the SIMD versions plus a remainder */
+  guint8 packed[37 * 3], repacked[37 * 3];
+  guint32 unpacked[37];
+  gint f, i;
+
+  for (i = 0; i < G_N_ELEMENTS (packed); i++)
+    packed[i] = i * 37 + 11;
+
+  for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+    const GstAudioFormatInfo *finfo = gst_audio_format_get_info (formats[f]);
+    gboolean le = GST_AUDIO_FORMAT_INFO_IS_LITTLE_ENDIAN (finfo);
+    gint depth = GST_AUDIO_FORMAT_INFO_DEPTH (finfo);
+    guint32 mask = (1U << depth) - 1;
+
+    finfo->unpack_func (finfo, 0, unpacked, packed, 37);
+    for (i = 0; i < 37; i++) {
+      const guint8 *p = packed + 3 * i;
+      guint32 v = le ? GST_READ_UINT24_LE (p) : GST_READ_UINT24_BE (p);
+
+      v = (v & mask) << (32 - depth);
+      if (!GST_AUDIO_FORMAT_INFO_IS_SIGNED (finfo))
+        v ^= 0x80000000;
+      fail_unless_equals_int (unpacked[i], v);
+    }
+
+    /* packing keeps the bits of the depth, the others are 0 */
+    finfo->pack_func (finfo, 0, unpacked, repacked, 37);
+    for (i = 0; i < 37; i++) {
+      const guint8 *p = packed + 3 * i, *q = repacked + 3 * i;
+      guint32 v = le ? GST_READ_UINT24_LE (p) : GST_READ_UINT24_BE (p);
+      guint32 r = le ? GST_READ_UINT24_LE (q) : GST_READ_UINT24_BE (q);
+
+      fail_unless_equals_int (r, v & mask);
+    }
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_stream_align)
 {
   GstAudioStreamAlign *align;
@@ -1578,6 +1624,101 @@ GST_START_TEST (test_audio_make_raw_caps)
 
 GST_END_TEST;
 
+static GstAudioConverter *
+make_remap_converter (GstAudioFormat in_format, GstAudioLayout in_layout,
+    GstAudioFormat out_format, GstAudioLayout out_layout, gint channels,
+    const gint * remap)
+{
+  GstAudioInfo in_info, out_info;
+  GValue matrix = G_VALUE_INIT;
+  GstStructure *config;
+  gint i, j;
+
+  gst_audio_info_set_format (&in_info, in_format, 48000, channels, NULL);
+  in_info.layout = in_layout;
+  gst_audio_info_set_format (&out_info, out_format, 48000, channels, NULL);
+  out_info.layout = out_layout;
+
+  g_value_init (&matrix, GST_TYPE_ARRAY);
+  for (j = 0; j < channels; j++) {
+    GValue row = G_VALUE_INIT;
+
+    g_value_init (&row, GST_TYPE_ARRAY);
+    for (i = 0; i < channels; i++) {
+      GValue v = G_VALUE_INIT;
+
+      g_value_init (&v, G_TYPE_FLOAT);
+      g_value_set_float (&v, remap[j] == i ? 1.0 : 0.0);
+      gst_value_array_append_and_take_value (&row, &v);
+    }
+    gst_value_array_append_and_take_value (&matrix, &row);
+  }
+
+  config = gst_structure_new_empty ("config");
+  gst_structure_take_value (config, GST_AUDIO_CONVERTER_OPT_MIX_MATRIX,
+      &matrix);
+
+  return gst_audio_converter_new (0, &in_info, &out_info, config);
+}
+
+GST_START_TEST (test_audio_converter_remap)
+{
+  GstAudioConverter *convert;
+
+  /* S24_32 channel reorder with a silent channel */
+  {
+    const gint remap[] = { 2, 0, -1 };
+    gint32 in[] = { 1, 2, 3, -4, -5, -6 };
+    gint32 expected[] = { 3, 1, 0, -6, -4, 0 };
+    gint32 out[6];
+    gpointer in_p[] = { in }, out_p[] = { out };
+
+    convert = make_remap_converter (GST_AUDIO_FORMAT_S24_32,
+        GST_AUDIO_LAYOUT_INTERLEAVED, GST_AUDIO_FORMAT_S24_32,
+        GST_AUDIO_LAYOUT_INTERLEAVED, 3, remap);
+    fail_unless (convert != NULL);
+    fail_unless (gst_audio_converter_samples (convert, 0, in_p, 2, out_p, 2));
+    fail_unless (memcmp (out, expected, sizeof (expected)) == 0);
+    gst_audio_converter_free (convert);
+  }
+
+  /* F32 planar to S32 interleaved with swapped channels */
+  {
+    const gint remap[] = { 1, 0 };
+    gfloat in[] = { 0.5, -0.25, 1.0, -1.0 };
+    gint32 expected[] = { G_MAXINT32, 1073741824, G_MININT32, -536870912 };
+    gint32 out[4];
+    gpointer in_p[] = { in, in + 2 }, out_p[] = { out };
+
+    convert = make_remap_converter (GST_AUDIO_FORMAT_F32,
+        GST_AUDIO_LAYOUT_NON_INTERLEAVED, GST_AUDIO_FORMAT_S32,
+        GST_AUDIO_LAYOUT_INTERLEAVED, 2, remap);
+    fail_unless (convert != NULL);
+    fail_unless (gst_audio_converter_samples (convert, 0, in_p, 2, out_p, 2));
+    fail_unless (memcmp (out, expected, sizeof (expected)) == 0);
+    gst_audio_converter_free (convert);
+  }
+
+  /* S32 interleaved to F32 planar with swapped channels */
+  {
+    const gint remap[] = { 1, 0 };
+    gint32 in[] = { 1073741824, G_MININT32, -536870912, 0 };
+    gfloat expected[] = { -1.0, 0.0, 0.5, -0.25 };
+    gfloat out[4];
+    gpointer in_p[] = { in }, out_p[] = { out, out + 2 };
+
+    convert = make_remap_converter (GST_AUDIO_FORMAT_S32,
+        GST_AUDIO_LAYOUT_INTERLEAVED, GST_AUDIO_FORMAT_F32,
+        GST_AUDIO_LAYOUT_NON_INTERLEAVED, 2, remap);
+    fail_unless (convert != NULL);
+    fail_unless (gst_audio_converter_samples (convert, 0, in_p, 2, out_p, 2));
+    fail_unless (memcmp (out, expected, sizeof (expected)) == 0);
+    gst_audio_converter_free (convert);
+  }
+}
+
+GST_END_TEST;
+
 static Suite *
 audio_suite (void)
 {
@@ -1611,11 +1752,13 @@ audio_suite (void)
   tcase_add_test (tc_chain, test_audio_format_s8);
   tcase_add_test (tc_chain, test_audio_format_u8);
   tcase_add_test (tc_chain, test_fill_silence);
+  tcase_add_test (tc_chain, test_pack_unpack_24);
   tcase_add_test (tc_chain, test_stream_align);
   tcase_add_test (tc_chain, test_stream_align_reverse);
   tcase_add_test (tc_chain, test_audio_buffer_and_audio_meta);
   tcase_add_test (tc_chain, test_audio_info_from_caps);
   tcase_add_test (tc_chain, test_audio_make_raw_caps);
+  tcase_add_test (tc_chain, test_audio_converter_remap);
 
   return s;
 }
@@ -28,6 +28,7 @@
 #include <gst/gl/gstglfuncs.h>
 
 #include <stdio.h>
+#include <string.h>
 
 static GstGLDisplay *display;
 static GstGLContext *context;
@@ -248,6 +249,144 @@ GST_START_TEST (test_reorder_buffer)
 
 GST_END_TEST;
 
+static GstBuffer *
+_wrap_rgba_frame (GstVideoInfo * info, gchar * data, gint * ref_count)
+{
+  GstGLBaseMemoryAllocator *base_mem_alloc;
+  GstGLVideoAllocationParams *params;
+  GstGLBaseMemory *mem;
+  GstBuffer *buf;
+
+  base_mem_alloc =
+      GST_GL_BASE_MEMORY_ALLOCATOR (gst_allocator_find
+      (GST_GL_MEMORY_ALLOCATOR_NAME));
+
+  (*ref_count)++;
+  params = gst_gl_video_allocation_params_new_wrapped_data (context, NULL,
+      info, 0, NULL, GST_GL_TEXTURE_TARGET_2D, GST_GL_RGBA, data, ref_count,
+      _frame_unref);
+  mem = gst_gl_base_memory_alloc (base_mem_alloc,
+      (GstGLAllocationParams *) params);
+  gst_gl_allocation_params_free ((GstGLAllocationParams *) params);
+  gst_object_unref (base_mem_alloc);
+
+  buf = gst_buffer_new ();
+  gst_buffer_append_memory (buf, GST_MEMORY_CAST (mem));
+
+  return buf;
+}
+
+static GstCaps *
+_gl_caps_new (GstVideoFormat format, gint width, gint height)
+{
+  GstVideoInfo info;
+  GstCaps *caps;
+
+  gst_video_info_set_format (&info, format, width, height);
+  caps = gst_video_info_to_caps (&info);
+  gst_caps_set_features (caps, 0,
+      gst_caps_features_from_string (GST_CAPS_FEATURE_MEMORY_GL_MEMORY));
+
+  return caps;
+}
+
+GST_START_TEST (test_scale_rgba)
+{
+  GstVideoInfo in_info, out_info;
+  GstCaps *in_caps, *out_caps;
+  GstBuffer *inbuf, *outbuf;
+  GstVideoFrame out_frame;
+  gint ref_count = 0;
+  gint x, y;
+
+  gst_video_info_set_format (&in_info, GST_VIDEO_FORMAT_RGBA, 1, 1);
+  gst_video_info_set_format (&out_info, GST_VIDEO_FORMAT_RGBA, 4, 4);
+  in_caps = _gl_caps_new (GST_VIDEO_FORMAT_RGBA, 1, 1);
+  out_caps = _gl_caps_new (GST_VIDEO_FORMAT_RGBA, 4, 4);
+
+  fail_unless (gst_gl_color_convert_set_caps (convert, in_caps, out_caps));
+  fail_if (convert->passthrough);
+
+  inbuf = _wrap_rgba_frame (&in_info, (gchar *) rgba_reorder_data,
+      &ref_count);
+  outbuf = gst_gl_color_convert_perform (convert, inbuf);
+  fail_unless (outbuf != NULL);
+
+  fail_unless (gst_video_frame_map (&out_frame, &out_info, outbuf,
+          GST_MAP_READ));
+  for (y = 0; y < 4; y++) {
+    guint8 *line = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&out_frame, 0) +
+        y * GST_VIDEO_FRAME_PLANE_STRIDE (&out_frame, 0);
+
+    for (x = 0; x < 4; x++)
+      fail_unless (memcmp (&line[x * 4], rgba_reorder_data, 4) == 0);
+  }
+  gst_video_frame_unmap (&out_frame);
+
+  /* scaling to YUV is not supported */
+  gst_caps_unref (out_caps);
+  out_caps = _gl_caps_new (GST_VIDEO_FORMAT_NV12, 4, 4);
+  fail_if (gst_gl_color_convert_set_caps (convert, in_caps, out_caps));
+
+  gst_buffer_unref (outbuf);
+  gst_buffer_unref (inbuf);
+  gst_caps_unref (in_caps);
+  gst_caps_unref (out_caps);
+
+  fail_unless_equals_int (ref_count, 0);
+}
+
+GST_END_TEST;
+
+static GstGLShader *
+_convert_and_get_shader (GstBuffer * inbuf, GstCaps * in_caps,
+    GstVideoFormat out_format)
+{
+  GstCaps *out_caps = _gl_caps_new (out_format, 1, 1);
+  GstBuffer *outbuf;
+
+  fail_unless (gst_gl_color_convert_set_caps (convert, in_caps, out_caps));
+  outbuf = gst_gl_color_convert_perform (convert, inbuf);
+  fail_unless (outbuf != NULL);
+  gst_buffer_unref (outbuf);
+  gst_caps_unref (out_caps);
+
+  return convert->shader;
+}
+
+GST_START_TEST (test_shader_cache)
+{
+  GstVideoInfo in_info;
+  GstCaps *in_caps;
+  GstBuffer *inbuf;
+  GstGLShader *bgra_shader, *argb_shader;
+  gint ref_count = 0;
+
+  gst_video_info_set_format (&in_info, GST_VIDEO_FORMAT_RGBA, 1, 1);
+  in_caps = _gl_caps_new (GST_VIDEO_FORMAT_RGBA, 1, 1);
+  inbuf = _wrap_rgba_frame (&in_info, (gchar *) rgba_reorder_data,
+      &ref_count);
+
+  bgra_shader = _convert_and_get_shader (inbuf, in_caps,
+      GST_VIDEO_FORMAT_BGRA);
+  argb_shader = _convert_and_get_shader (inbuf, in_caps,
+      GST_VIDEO_FORMAT_ARGB);
+  fail_unless (bgra_shader != argb_shader);
+
+  /* switching back must reuse the previously compiled program */
+  fail_unless (_convert_and_get_shader (inbuf, in_caps,
+          GST_VIDEO_FORMAT_BGRA) == bgra_shader);
+  fail_unless (_convert_and_get_shader (inbuf, in_caps,
+          GST_VIDEO_FORMAT_ARGB) == argb_shader);
+
+  gst_buffer_unref (inbuf);
+  gst_caps_unref (in_caps);
+
+  fail_unless_equals_int (ref_count, 0);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_gl_color_convert_suite (void)
 {
@@ -257,6 +396,8 @@ gst_gl_color_convert_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_checked_fixture (tc_chain, setup, teardown);
   tcase_add_test (tc_chain, test_reorder_buffer);
+  tcase_add_test (tc_chain, test_scale_rgba);
+  tcase_add_test (tc_chain, test_shader_cache);
   /* FIXME add YUV <--> RGB conversion tests */
 
   return s;
@@ -724,6 +724,74 @@ GST_START_TEST (test_display_list_readd)
 
 GST_END_TEST;
 
+struct async_counter
+{
+  gint count;
+  gint last_seen;
+  gboolean in_order;
+  gint notified;
+};
+
+static void
+_async_increment (GstGLContext * context, struct async_counter *counter)
+{
+  counter->count++;
+  if (counter->last_seen + 1 != counter->count)
+    counter->in_order = FALSE;
+  counter->last_seen = counter->count;
+}
+
+static void
+_async_notify (struct async_counter *counter)
+{
+  g_atomic_int_inc (&counter->notified);
+}
+
+#define N_ASYNC 16
+
+GST_START_TEST (test_thread_add_async)
+{
+  struct async_counter counter = { 0, 0, TRUE, 0 };
+  GstGLContext *context;
+  GError *error = NULL;
+  guint64 fence = 0, prev_fence = 0;
+  gint i;
+
+  context = gst_gl_context_new (display);
+  gst_gl_context_create (context, NULL, &error);
+  fail_if (error != NULL, "Error creating context %s
+",
+      error ? error->message : "Unknown Error");
+
+  for (i = 0; i < N_ASYNC; i++) {
+    fence = gst_gl_context_thread_add_async (context,
+        (GstGLContextThreadFunc) _async_increment, &counter,
+        (GDestroyNotify) _async_notify);
+    fail_unless (fence > prev_fence);
+    prev_fence = fence;
+  }
+
+  gst_gl_context_thread_wait (context, fence);
+  fail_unless_equals_int (counter.count, N_ASYNC);
+  fail_unless_equals_int (g_atomic_int_get (&counter.notified), N_ASYNC);
+  fail_unless (counter.in_order);
+
+  /* synchronous functions are executed after the pending asynchronous ones */
+  gst_gl_context_thread_add_async (context,
+      (GstGLContextThreadFunc) _async_increment, &counter, NULL);
+  gst_gl_context_thread_add (context,
+      (GstGLContextThreadFunc) _async_increment, &counter);
+  fail_unless_equals_int (counter.count, N_ASYNC + 2);
+  fail_unless (counter.in_order);
+
+  /* an already completed fence returns immediately */
+  gst_gl_context_thread_wait (context, fence);
+
+  gst_object_unref (context);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_gl_context_suite (void)
 {
@@ -740,6 +808,7 @@ gst_gl_context_suite (void)
   tcase_add_test (tc_chain, test_display_list);
   tcase_add_test (tc_chain, test_display_list_remove);
   tcase_add_test (tc_chain, test_display_list_readd);
+  tcase_add_test (tc_chain, test_thread_add_async);
 
   return s;
 }
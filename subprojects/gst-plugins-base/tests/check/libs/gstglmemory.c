@@ -510,6 +510,52 @@ GST_START_TEST (test_separate_download_transfer)
 
 GST_END_TEST;
 
+GST_START_TEST (test_repeated_pbo_transfer)
+{
+  static const guint8 other_pixel[] = { 0x11, 0x22, 0x33, 0x44 };
+  guint8 data[G_N_ELEMENTS (rgba_pixel)];
+  GstVideoInfo v_info;
+  GstMemory *mem;
+  GstMapInfo info;
+  gint i;
+
+  memcpy (data, rgba_pixel, G_N_ELEMENTS (rgba_pixel));
+  gst_video_info_set_format (&v_info, GST_VIDEO_FORMAT_RGBA, 1, 1);
+  mem = wrap_raw_data (GST_GL_MEMORY_PBO_ALLOCATOR_NAME, &v_info, 0, data);
+
+  /* alternate the contents so that each CPU access has to observe the
+   * previous GL transfer of the (possibly persistently mapped) pbo */
+  for (i = 0; i < 4; i++) {
+    const guint8 *pixel = i % 2 ? rgba_pixel : other_pixel;
+
+    fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE));
+    memcpy (info.data, pixel, G_N_ELEMENTS (rgba_pixel));
+    gst_memory_unmap (mem, &info);
+
+    /* upload */
+    fail_unless (gst_memory_map (mem, &info, GST_MAP_READ | GST_MAP_GL));
+    gst_memory_unmap (mem, &info);
+
+    /* force a download */
+    fail_unless (gst_memory_map (mem, &info, GST_MAP_WRITE | GST_MAP_GL));
+    gst_memory_unmap (mem, &info);
+
+    gst_gl_memory_pbo_download_transfer ((GstGLMemoryPBO *) mem);
+
+    fail_unless (gst_memory_map (mem, &info, GST_MAP_READ));
+    fail_unless (memcmp (info.data, pixel, G_N_ELEMENTS (rgba_pixel)) == 0,
+        "0x%02x%02x%02x%02x != 0x%02x%02x%02x%02x", (guint8) info.data[0],
+        (guint8) info.data[1], (guint8) info.data[2],
+        (guint8) info.data[3], (guint8) pixel[0], (guint8) pixel[1],
+        (guint8) pixel[2], (guint8) pixel[3]);
+    gst_memory_unmap (mem, &info);
+  }
+
+  gst_memory_unref (mem);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_gl_memory_suite (void)
 {
@@ -528,6 +574,7 @@ gst_gl_memory_suite (void)
   tcase_add_test (tc_chain, test_transfer_state);
   tcase_add_test (tc_chain, test_separate_upload_transfer);
   tcase_add_test (tc_chain, test_separate_download_transfer);
+  tcase_add_test (tc_chain, test_repeated_pbo_transfer);
 
   return s;
 }
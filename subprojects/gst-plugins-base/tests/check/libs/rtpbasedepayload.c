@@ -1844,6 +1844,40 @@ hdr_ext_caps_change_chain_func (GstPad * pad, GstObject * parent,
   return res;
 }
 
+GST_START_TEST (rtp_base_depayload_hdr_ext_id_changed)
+{
+  GstRTPHeaderExtension *ext;
+  State *state;
+
+  state = create_depayloader ("application/x-rtp", NULL);
+  ext = rtp_dummy_hdr_ext_new ();
+  gst_rtp_header_extension_set_id (ext, 1);
+
+  GST_RTP_DUMMY_DEPAY (state->element)->push_method =
+      GST_RTP_DUMMY_RETURN_TO_PUSH;
+
+  g_signal_emit_by_name (state->element, "add-extension", ext);
+  /* the extension is still found by its new id */
+  gst_rtp_header_extension_set_id (ext, 3);
+
+  set_state (state, GST_STATE_PLAYING);
+
+  push_rtp_buffer (state, "pts", 0 * GST_SECOND,
+      "rtptime", G_GUINT64_CONSTANT (0x1234), "seq", 0x4242, "hdrext-1", ext,
+      NULL);
+
+  set_state (state, GST_STATE_NULL);
+
+  validate_buffers_received (1);
+
+  fail_unless_equals_int (GST_RTP_DUMMY_HDR_EXT (ext)->read_count, 1);
+
+  gst_object_unref (ext);
+  destroy_depayloader (state);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (rtp_base_depayload_hdr_ext_caps_change)
 {
   GstRTPHeaderExtension *ext;
@@ -1919,6 +1953,7 @@ rtp_basepayloading_suite (void)
   tcase_add_test (tc_chain, rtp_base_depayload_request_extension);
   tcase_add_test (tc_chain, rtp_base_depayload_clear_extensions);
   tcase_add_test (tc_chain, rtp_base_depayload_multiple_exts);
+  tcase_add_test (tc_chain, rtp_base_depayload_hdr_ext_id_changed);
   tcase_add_test (tc_chain, rtp_base_depayload_caps_request_ignored);
   tcase_add_test (tc_chain, rtp_base_depayload_hdr_ext_caps_change);
 
@@ -928,6 +928,162 @@ GST_START_TEST (test_rtspconnection_send_receive_content_length)
 
 GST_END_TEST;
 
+GST_START_TEST (test_rtspconnection_receive_pipelined)
+{
+  GSocketConnection *input_conn = NULL;
+  GSocketConnection *output_conn = NULL;
+  GSocket *input_sock;
+  GSocket *output_sock;
+  GstRTSPConnection *rtsp_input_conn;
+  GstRTSPMessage *msg;
+  const gchar data[] =
+      "OPTIONS * RTSP/1.0\r\n"
+      "CSeq: 1\r\n"
+      "\r\n"
+      "GET_PARAMETER rtsp://example.com/ RTSP/1.0\r\n"
+      "CSeq: 2\r\n"
+      "Session: 12345678\r\n"
+      "Content-Length: 4\r\n"
+      "\r\n"
+      "body" "$\001\000\002ab";
+  gchar *header_val;
+  guint8 *body;
+  guint body_len;
+  guint8 channel;
+
+  create_connection (&input_conn, &output_conn);
+  input_sock = g_socket_connection_get_socket (input_conn);
+  fail_unless (input_sock != NULL);
+  output_sock = g_socket_connection_get_socket (output_conn);
+  fail_unless (output_sock != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (input_sock, "127.0.0.1",
+          4444, NULL, &rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_input_conn != NULL);
+
+  /* all messages arrive in a single segment */
+  fail_unless_equals_int (g_socket_send (output_sock, data, sizeof (data) - 1,
+          NULL, NULL), sizeof (data) - 1);
+
+  fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg, NULL) ==
+      GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_REQUEST);
+  fail_unless (msg->type_data.request.method == GST_RTSP_OPTIONS);
+  fail_unless (gst_rtsp_message_get_header (msg, GST_RTSP_HDR_CSEQ,
+          &header_val, 0) == GST_RTSP_OK);
+  fail_unless_equals_string (header_val, "1");
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+
+  fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg, NULL) ==
+      GST_RTSP_OK);
+  fail_unless (msg->type_data.request.method == GST_RTSP_GET_PARAMETER);
+  fail_unless (gst_rtsp_message_get_header (msg, GST_RTSP_HDR_CSEQ,
+          &header_val, 0) == GST_RTSP_OK);
+  fail_unless_equals_string (header_val, "2");
+  fail_unless (gst_rtsp_message_get_header (msg, GST_RTSP_HDR_SESSION,
+          &header_val, 0) == GST_RTSP_OK);
+  fail_unless_equals_string (header_val, "12345678");
+  fail_unless (gst_rtsp_message_get_body (msg, &body,
+          &body_len) == GST_RTSP_OK);
+  fail_unless_equals_int (body_len, 5);
+  fail_unless_equals_string ((gchar *) body, "body");
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+
+  fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg, NULL) ==
+      GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_DATA);
+  fail_unless (gst_rtsp_message_parse_data (msg, &channel) == GST_RTSP_OK);
+  fail_unless_equals_int (channel, 1);
+  fail_unless (gst_rtsp_message_get_body (msg, &body,
+          &body_len) == GST_RTSP_OK);
+  fail_unless_equals_int (body_len, 3);
+  fail_unless_equals_string ((gchar *) body, "ab");
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+
+  fail_unless (gst_rtsp_connection_close (rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_input_conn) == GST_RTSP_OK);
+
+  g_object_unref (input_conn);
+  g_object_unref (output_conn);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_rtspconnection_receive_interleaved_batch)
+{
+  GSocketConnection *input_conn = NULL;
+  GSocketConnection *output_conn = NULL;
+  GSocket *input_sock;
+  GSocket *output_sock;
+  GstRTSPConnection *rtsp_input_conn;
+  GstRTSPMessage *msg;
+  /* data messages containing NUL bytes, followed by a response */
+  const gchar data[] =
+      "$\000\000\003a\000b" "$\001\000\001\000" "$\000\000\002cd"
+      "RTSP/1.0 200 OK\r\n" "CSeq: 7\r\n" "\r\n";
+  const struct
+  {
+    guint8 channel;
+    guint len;
+    const gchar *body;
+  } expected[] = {
+    {0, 3, "a\000b"}, {1, 1, "\000"}, {0, 2, "cd"}
+  };
+  gchar *header_val;
+  guint8 *body;
+  guint body_len;
+  guint8 channel;
+  guint i;
+
+  create_connection (&input_conn, &output_conn);
+  input_sock = g_socket_connection_get_socket (input_conn);
+  fail_unless (input_sock != NULL);
+  output_sock = g_socket_connection_get_socket (output_conn);
+  fail_unless (output_sock != NULL);
+
+  fail_unless (gst_rtsp_connection_create_from_socket (input_sock, "127.0.0.1",
+          4444, NULL, &rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (rtsp_input_conn != NULL);
+
+  fail_unless_equals_int (g_socket_send (output_sock, data, sizeof (data) - 1,
+          NULL, NULL), sizeof (data) - 1);
+
+  for (i = 0; i < G_N_ELEMENTS (expected); i++) {
+    fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+    fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg, NULL) ==
+        GST_RTSP_OK);
+    fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_DATA);
+    fail_unless (gst_rtsp_message_parse_data (msg, &channel) == GST_RTSP_OK);
+    fail_unless_equals_int (channel, expected[i].channel);
+    fail_unless (gst_rtsp_message_get_body (msg, &body,
+            &body_len) == GST_RTSP_OK);
+    /* includes the trailing NUL */
+    fail_unless_equals_int (body_len, expected[i].len + 1);
+    fail_unless (memcmp (body, expected[i].body, expected[i].len) == 0);
+    fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+  }
+
+  fail_unless (gst_rtsp_message_new (&msg) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_receive (rtsp_input_conn, msg, NULL) ==
+      GST_RTSP_OK);
+  fail_unless (gst_rtsp_message_get_type (msg) == GST_RTSP_MESSAGE_RESPONSE);
+  fail_unless (gst_rtsp_message_get_header (msg, GST_RTSP_HDR_CSEQ,
+          &header_val, 0) == GST_RTSP_OK);
+  fail_unless_equals_string (header_val, "7");
+  fail_unless (gst_rtsp_message_free (msg) == GST_RTSP_OK);
+
+  fail_unless (gst_rtsp_connection_close (rtsp_input_conn) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_connection_free (rtsp_input_conn) == GST_RTSP_OK);
+
+  g_object_unref (input_conn);
+  g_object_unref (output_conn);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtspconnection_suite (void)
 {
@@ -944,6 +1100,8 @@ rtspconnection_suite (void)
   tcase_add_test (tc_chain, test_rtspconnection_backlog);
   tcase_add_test (tc_chain, test_rtspconnection_ip);
   tcase_add_test (tc_chain, test_rtspconnection_send_receive_content_length);
+  tcase_add_test (tc_chain, test_rtspconnection_receive_pipelined);
+  tcase_add_test (tc_chain, test_rtspconnection_receive_interleaved_batch);
 
   return s;
 }
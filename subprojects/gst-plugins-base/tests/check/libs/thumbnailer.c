@@ -0,0 +1,152 @@
+/* GStreamer unit tests for thumbnailer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/pbutils/pbutils.h>
+
+static gboolean have_theora, have_ogg;
+
+static GstThumbnailer *
+create_thumbnailer (void)
+{
+  GstThumbnailer *thumbnailer;
+  GstCaps *caps;
+
+  caps = gst_caps_from_string ("video/x-raw, format=RGB, width=(int)80, "
+      "pixel-aspect-ratio=1/1");
+  thumbnailer = gst_thumbnailer_new (caps, 5 * GST_SECOND);
+  gst_caps_unref (caps);
+  fail_unless (thumbnailer != NULL);
+
+  return thumbnailer;
+}
+
+static void
+check_thumbnail (GstSample * sample)
+{
+  GstStructure *s;
+  const gchar *format;
+  gint width;
+
+  fail_unless (sample != NULL);
+  fail_unless (gst_sample_get_buffer (sample) != NULL);
+
+  s = gst_caps_get_structure (gst_sample_get_caps (sample), 0);
+  fail_unless (gst_structure_get_int (s, "width", &width));
+  fail_unless_equals_int (width, 80);
+  format = gst_structure_get_string (s, "format");
+  fail_unless_equals_string (format, "RGB");
+}
+
+GST_START_TEST (test_thumbnailer_positions)
+{
+  GstThumbnailer *thumbnailer;
+  GstSample *sample;
+  GError *err = NULL;
+  gchar *path, *uri;
+
+  if (!have_theora || !have_ogg)
+    return;
+
+  path = g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+  uri = gst_filename_to_uri (path, &err);
+  g_free (path);
+  fail_unless (err == NULL);
+
+  thumbnailer = create_thumbnailer ();
+
+  /* first frame, then seeks in the same file reusing the pipeline */
+  sample = gst_thumbnailer_get_thumbnail (thumbnailer, uri,
+      GST_CLOCK_TIME_NONE, &err);
+  fail_unless (err == NULL);
+  check_thumbnail (sample);
+  gst_sample_unref (sample);
+
+  sample = gst_thumbnailer_get_thumbnail (thumbnailer, uri, 0, &err);
+  fail_unless (err == NULL);
+  check_thumbnail (sample);
+  gst_sample_unref (sample);
+
+  sample = gst_thumbnailer_get_thumbnail (thumbnailer, uri,
+      GST_SECOND / 2, &err);
+  fail_unless (err == NULL);
+  check_thumbnail (sample);
+  gst_sample_unref (sample);
+
+  gst_object_unref (thumbnailer);
+  g_free (uri);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_thumbnailer_error)
+{
+  GstThumbnailer *thumbnailer;
+  GstSample *sample;
+  GError *err = NULL;
+  gchar *path, *uri;
+
+  thumbnailer = create_thumbnailer ();
+
+  sample = gst_thumbnailer_get_thumbnail (thumbnailer,
+      "file:///nonexistent/file.ogg", 0, &err);
+  fail_unless (sample == NULL);
+  fail_unless (err != NULL);
+  g_clear_error (&err);
+
+  /* the thumbnailer is usable again after an error */
+  if (have_theora && have_ogg) {
+    path = g_build_filename (GST_TEST_FILES_PATH, "theora-vorbis.ogg", NULL);
+    uri = gst_filename_to_uri (path, &err);
+    g_free (path);
+    fail_unless (err == NULL);
+
+    sample = gst_thumbnailer_get_thumbnail (thumbnailer, uri, 0, &err);
+    fail_unless (err == NULL);
+    check_thumbnail (sample);
+    gst_sample_unref (sample);
+    g_free (uri);
+  }
+
+  gst_object_unref (thumbnailer);
+}
+
+GST_END_TEST;
+
+static Suite *
+thumbnailer_suite (void)
+{
+  Suite *s = suite_create ("thumbnailer");
+  TCase *tc_chain = tcase_create ("general");
+
+  have_theora = gst_registry_check_feature_version (gst_registry_get (),
+      "theoradec", GST_VERSION_MAJOR, GST_VERSION_MINOR, 0);
+  have_ogg = gst_registry_check_feature_version (gst_registry_get (),
+      "oggdemux", GST_VERSION_MAJOR, GST_VERSION_MINOR, 0);
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_thumbnailer_positions);
+  tcase_add_test (tc_chain, test_thumbnailer_error);
+  return s;
+}
+
+GST_CHECK_MAIN (thumbnailer);
@@ -992,6 +992,7 @@ GST_START_TEST (test_events)
 {
   GstEvent *e;
   gboolean in_still;
+  guint bitrate;
 
   e = gst_video_event_new_still_frame (TRUE);
   fail_if (e == NULL, "Failed to create still frame event");
@@ -1010,6 +1011,20 @@ GST_START_TEST (test_events)
       "Failed to parse still frame event w/ in_still == NULL");
   fail_unless (in_still == FALSE);
   gst_event_unref (e);
+
+  e = gst_video_event_new_bandwidth_estimate (500000);
+  fail_if (e == NULL, "Failed to create bandwidth estimate event");
+  fail_unless (gst_video_event_parse_bandwidth_estimate (e, &bitrate),
+      "Failed to parse bandwidth estimate event");
+  fail_unless (gst_video_event_parse_bandwidth_estimate (e, NULL),
+      "Failed to parse bandwidth estimate event w/ bitrate == NULL");
+  fail_unless_equals_int (bitrate, 500000);
+  fail_if (gst_video_event_parse_still_frame (e, NULL));
+  gst_event_unref (e);
+
+  e = gst_video_event_new_still_frame (TRUE);
+  fail_if (gst_video_event_parse_bandwidth_estimate (e, NULL));
+  gst_event_unref (e);
 }
 
 GST_END_TEST;
@@ -2799,12 +2814,172 @@ GST_START_TEST (test_video_convert)
 
 GST_END_TEST;
 
+static void
+check_semiplanar_round_trip (GstVideoFormat sp_format, GstVideoFormat p_format,
+    gint width, gint height, guint16 mask)
+{
+  GstVideoInfo spinfo, pinfo;
+  GstVideoFrame spframe, pframe, outframe;
+  GstBuffer *spbuffer, *pbuffer, *outbuffer;
+  GstVideoConverter *convert;
+  GstMapInfo map;
+  guint i, j, plane;
+
+  fail_unless (gst_video_info_set_format (&spinfo, sp_format, width, height));
+  fail_unless (gst_video_info_set_format (&pinfo, p_format, width, height));
+
+  spbuffer = gst_buffer_new_and_alloc (spinfo.size);
+  gst_buffer_map (spbuffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size / 2; i++)
+    ((guint16 *) map.data)[i] = (g_random_int () & mask);
+  gst_buffer_unmap (spbuffer, &map);
+  pbuffer = gst_buffer_new_and_alloc (pinfo.size);
+  outbuffer = gst_buffer_new_and_alloc (spinfo.size);
+
+  gst_video_frame_map (&spframe, &spinfo, spbuffer, GST_MAP_READ);
+  gst_video_frame_map (&pframe, &pinfo, pbuffer, GST_MAP_READWRITE);
+  gst_video_frame_map (&outframe, &spinfo, outbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&spinfo, &pinfo,
+      gst_structure_new ("options", GST_VIDEO_CONVERTER_OPT_THREADS,
+          G_TYPE_UINT, 3, NULL));
+  gst_video_converter_frame (convert, &spframe, &pframe);
+  gst_video_converter_free (convert);
+
+  convert = gst_video_converter_new (&pinfo, &spinfo,
+      gst_structure_new ("options", GST_VIDEO_CONVERTER_OPT_THREADS,
+          G_TYPE_UINT, 3, NULL));
+  gst_video_converter_frame (convert, &pframe, &outframe);
+  gst_video_converter_free (convert);
+
+  for (plane = 0; plane < GST_VIDEO_FRAME_N_PLANES (&spframe); plane++) {
+    guint w = GST_VIDEO_FRAME_COMP_WIDTH (&spframe, plane) *
+        GST_VIDEO_FRAME_COMP_PSTRIDE (&spframe, plane == 0 ? 0 : 1);
+    guint h = GST_VIDEO_FRAME_COMP_HEIGHT (&spframe, plane);
+
+    for (j = 0; j < h; j++) {
+      const guint8 *a = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&spframe,
+          plane) + j * GST_VIDEO_FRAME_PLANE_STRIDE (&spframe, plane);
+      const guint8 *b = (const guint8 *) GST_VIDEO_FRAME_PLANE_DATA (&outframe,
+          plane) + j * GST_VIDEO_FRAME_PLANE_STRIDE (&outframe, plane);
+
+      fail_unless (memcmp (a, b, w) == 0, "plane %u line %u differs", plane,
+          j);
+    }
+  }
+
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&pframe);
+  gst_video_frame_unmap (&spframe);
+  gst_buffer_unref (outbuffer);
+  gst_buffer_unref (pbuffer);
+  gst_buffer_unref (spbuffer);
+}
+
+GST_START_TEST (test_video_convert_semiplanar_planar)
+{
+  check_semiplanar_round_trip (GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420,
+      320, 240, 0xffff);
+  check_semiplanar_round_trip (GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420,
+      77, 19, 0xffff);
+  /* P010 only has 10 significant bits */
+  check_semiplanar_round_trip (GST_VIDEO_FORMAT_P010_10LE,
+      GST_VIDEO_FORMAT_I420_10LE, 320, 240, GUINT16_TO_LE (0xffc0));
+  check_semiplanar_round_trip (GST_VIDEO_FORMAT_P010_10LE,
+      GST_VIDEO_FORMAT_I420_10LE, 77, 19, GUINT16_TO_LE (0xffc0));
+}
+
+GST_END_TEST;
+
+/* scale to @out_format and compare with scaling to the layout of the input,
+ * which doesn't take the semi-planar <-> planar fast paths but uses the same
+ * scalers */
+static void
+check_semiplanar_planar_scale (GstVideoFormat in_format,
+    GstVideoFormat out_format, gint in_width, gint in_height, gint out_width,
+    gint out_height)
+{
+  GstVideoInfo ininfo, outinfo, refinfo;
+  GstVideoFrame inframe, outframe, refframe;
+  GstBuffer *inbuffer, *outbuffer, *refbuffer;
+  GstVideoConverter *convert;
+  GstMapInfo map;
+  guint i, j, comp;
+
+  fail_unless (gst_video_info_set_format (&ininfo, in_format, in_width,
+          in_height));
+  fail_unless (gst_video_info_set_format (&outinfo, out_format, out_width,
+          out_height));
+  fail_unless (gst_video_info_set_format (&refinfo, in_format, out_width,
+          out_height));
+
+  inbuffer = gst_buffer_new_and_alloc (ininfo.size);
+  gst_buffer_map (inbuffer, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = g_random_int ();
+  gst_buffer_unmap (inbuffer, &map);
+  outbuffer = gst_buffer_new_and_alloc (outinfo.size);
+  refbuffer = gst_buffer_new_and_alloc (refinfo.size);
+
+  gst_video_frame_map (&inframe, &ininfo, inbuffer, GST_MAP_READ);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+  gst_video_frame_map (&refframe, &refinfo, refbuffer, GST_MAP_WRITE);
+
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options", GST_VIDEO_CONVERTER_OPT_THREADS,
+          G_TYPE_UINT, 3, NULL));
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert);
+
+  convert = gst_video_converter_new (&ininfo, &refinfo,
+      gst_structure_new ("options", GST_VIDEO_CONVERTER_OPT_THREADS,
+          G_TYPE_UINT, 3, NULL));
+  gst_video_converter_frame (convert, &inframe, &refframe);
+  gst_video_converter_free (convert);
+
+  for (comp = 0; comp < GST_VIDEO_FRAME_N_COMPONENTS (&refframe); comp++) {
+    for (j = 0; j < GST_VIDEO_FRAME_COMP_HEIGHT (&refframe, comp); j++) {
+      const guint8 *a = (const guint8 *) GST_VIDEO_FRAME_COMP_DATA (&outframe,
+          comp) + j * GST_VIDEO_FRAME_COMP_STRIDE (&outframe, comp);
+      const guint8 *b = (const guint8 *) GST_VIDEO_FRAME_COMP_DATA (&refframe,
+          comp) + j * GST_VIDEO_FRAME_COMP_STRIDE (&refframe, comp);
+
+      for (i = 0; i < GST_VIDEO_FRAME_COMP_WIDTH (&refframe, comp); i++) {
+        fail_unless_equals_int (a[i * GST_VIDEO_FRAME_COMP_PSTRIDE (&outframe,
+                    comp)], b[i * GST_VIDEO_FRAME_COMP_PSTRIDE (&refframe,
+                    comp)]);
+      }
+    }
+  }
+
+  gst_video_frame_unmap (&refframe);
+  gst_video_frame_unmap (&outframe);
+  gst_video_frame_unmap (&inframe);
+  gst_buffer_unref (refbuffer);
+  gst_buffer_unref (outbuffer);
+  gst_buffer_unref (inbuffer);
+}
+
+GST_START_TEST (test_video_convert_semiplanar_planar_scale)
+{
+  check_semiplanar_planar_scale (GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_I420,
+      320, 240, 200, 150);
+  check_semiplanar_planar_scale (GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_YV12,
+      77, 19, 160, 40);
+  check_semiplanar_planar_scale (GST_VIDEO_FORMAT_I420, GST_VIDEO_FORMAT_NV12,
+      320, 240, 200, 150);
+  check_semiplanar_planar_scale (GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12,
+      77, 19, 160, 40);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_video_convert_multithreading)
 {
   GstVideoInfo ininfo, outinfo;
   GstVideoFrame inframe, outframe, refframe;
   GstBuffer *inbuffer, *outbuffer, *refbuffer;
-  GstVideoConverter *convert;
+  GstVideoConverter *convert, *convert2;
   GstMapInfo info;
   GstTaskPool *pool;
 
@@ -2867,6 +3042,34 @@ GST_START_TEST (test_video_convert_multithreading)
   fail_unless (gst_buffer_memcmp (refbuffer, 0, info.data, info.size) == 0);
   gst_buffer_unmap (outbuffer, &info);
 
+  gst_buffer_memset (outbuffer, 0, 0xff, -1);
+  gst_video_frame_map (&outframe, &outinfo, outbuffer, GST_MAP_WRITE);
+
+  /* Multi-threaded conversion, pool passed in the config and shared */
+  pool = gst_shared_task_pool_new ();
+  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool), 2);
+  gst_task_pool_prepare (pool, NULL);
+  convert = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 4,
+          GST_VIDEO_CONVERTER_OPT_TASK_POOL, GST_TYPE_TASK_POOL, pool, NULL));
+  convert2 = gst_video_converter_new (&ininfo, &outinfo,
+      gst_structure_new ("options",
+          GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, 4,
+          GST_VIDEO_CONVERTER_OPT_TASK_POOL, GST_TYPE_TASK_POOL, pool, NULL));
+  gst_video_converter_frame (convert2, &inframe, &outframe);
+  gst_video_converter_frame (convert, &inframe, &outframe);
+  gst_video_converter_free (convert2);
+  gst_video_converter_free (convert);
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+
+  gst_video_frame_unmap (&outframe);
+
+  gst_buffer_map (outbuffer, &info, GST_MAP_READ);
+  fail_unless (gst_buffer_memcmp (refbuffer, 0, info.data, info.size) == 0);
+  gst_buffer_unmap (outbuffer, &info);
+
 
   gst_buffer_unref (refbuffer);
   gst_buffer_unref (outbuffer);
@@ -3126,6 +3329,109 @@ GST_START_TEST (test_overlay_blend)
 
 GST_END_TEST;
 
+static void
+fill_video_frame_comps (GstVideoFrame * frame, const guint8 * values)
+{
+  gint c, i, j;
+
+  for (c = 0; c < GST_VIDEO_FRAME_N_COMPONENTS (frame); c++) {
+    guint8 *data = GST_VIDEO_FRAME_COMP_DATA (frame, c);
+
+    for (i = 0; i < GST_VIDEO_FRAME_COMP_HEIGHT (frame, c); i++)
+      for (j = 0; j < GST_VIDEO_FRAME_COMP_WIDTH (frame, c); j++)
+        data[i * GST_VIDEO_FRAME_COMP_STRIDE (frame, c) +
+            j * GST_VIDEO_FRAME_COMP_PSTRIDE (frame, c)] = values[c];
+  }
+}
+
+GST_START_TEST (test_overlay_blend_420)
+{
+  const GstVideoFormat formats[] = { GST_VIDEO_FORMAT_I420,
+    GST_VIDEO_FORMAT_YV12, GST_VIDEO_FORMAT_NV12, GST_VIDEO_FORMAT_NV21
+  };
+  const guint8 ayuv_values[] = { 255, 100, 110, 120 };
+  const guint8 yuv_values[] = { 100, 110, 120 };
+  GstVideoOverlayComposition *comp;
+  GstVideoOverlayRectangle *rect;
+  GstVideoFrame ref_frame, frame;
+  GstVideoInfo info;
+  GstBuffer *pix, *buf;
+  GstMapInfo map;
+  gint i, j, pass;
+  guint f;
+
+  /* overlay with varying alpha and colors at an odd position */
+  pix = gst_buffer_new_and_alloc (21 * 13 * 4);
+  gst_buffer_map (pix, &map, GST_MAP_WRITE);
+  for (i = 0; i < (gint) map.size; i++)
+    map.data[i] = (i * 37 + i / 4) & 0xff;
+  gst_buffer_unmap (pix, &map);
+  gst_buffer_add_video_meta (pix, GST_VIDEO_FRAME_FLAG_NONE,
+      GST_VIDEO_OVERLAY_COMPOSITION_FORMAT_RGB, 21, 13);
+  rect = gst_video_overlay_rectangle_new_raw (pix, 3, 5, 21, 13,
+      GST_VIDEO_OVERLAY_FORMAT_FLAG_GLOBAL_ALPHA);
+  gst_buffer_unref (pix);
+  comp = gst_video_overlay_composition_new (rect);
+
+  for (pass = 0; pass < 2; pass++) {
+    if (pass == 1)
+      gst_video_overlay_rectangle_set_global_alpha (rect, 0.75);
+
+    /* the generic path, blending onto AYUV, is the reference */
+    gst_video_info_set_format (&info, GST_VIDEO_FORMAT_AYUV, 40, 30);
+    buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+    gst_video_frame_map (&ref_frame, &info, buf, GST_MAP_READWRITE);
+    gst_buffer_unref (buf);
+    fill_video_frame_comps (&ref_frame, ayuv_values);
+    fail_unless (gst_video_overlay_composition_blend (comp, &ref_frame));
+
+    for (f = 0; f < G_N_ELEMENTS (formats); f++) {
+      const guint8 *ref = GST_VIDEO_FRAME_PLANE_DATA (&ref_frame, 0);
+      gint ref_stride = GST_VIDEO_FRAME_PLANE_STRIDE (&ref_frame, 0);
+
+      gst_video_info_set_format (&info, formats[f], 40, 30);
+      buf = gst_buffer_new_and_alloc (GST_VIDEO_INFO_SIZE (&info));
+      gst_video_frame_map (&frame, &info, buf, GST_MAP_READWRITE);
+      gst_buffer_unref (buf);
+      fill_video_frame_comps (&frame, yuv_values);
+      fail_unless (gst_video_overlay_composition_blend (comp, &frame));
+
+      for (i = 0; i < 30; i++) {
+        const guint8 *y = GST_VIDEO_FRAME_COMP_DATA (&frame, 0);
+
+        for (j = 0; j < 40; j++)
+          fail_unless_equals_int (y[i * GST_VIDEO_FRAME_COMP_STRIDE (&frame,
+                      0) + j], ref[i * ref_stride + j * 4 + 1]);
+      }
+
+      /* the chroma is the one of the top-left pixel of every block */
+      for (i = 0; i < 15; i++) {
+        const guint8 *u = GST_VIDEO_FRAME_COMP_DATA (&frame, 1);
+        const guint8 *v = GST_VIDEO_FRAME_COMP_DATA (&frame, 2);
+
+        for (j = 0; j < 20; j++) {
+          gint offset = i * GST_VIDEO_FRAME_COMP_STRIDE (&frame, 1) +
+              j * GST_VIDEO_FRAME_COMP_PSTRIDE (&frame, 1);
+
+          fail_unless_equals_int (u[offset],
+              ref[2 * i * ref_stride + 2 * j * 4 + 2]);
+          fail_unless_equals_int (v[offset],
+              ref[2 * i * ref_stride + 2 * j * 4 + 3]);
+        }
+      }
+
+      gst_video_frame_unmap (&frame);
+    }
+
+    gst_video_frame_unmap (&ref_frame);
+  }
+
+  gst_video_overlay_composition_unref (comp);
+  gst_video_overlay_rectangle_unref (rect);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_overlay_composition_over_transparency)
 {
   GstVideoOverlayComposition *comp1;
@@ -4152,9 +4458,12 @@ video_suite (void)
   tcase_add_test (tc_chain, test_video_size_convert);
   tcase_add_test (tc_chain, test_video_convert);
   tcase_add_test (tc_chain, test_video_convert_multithreading);
+  tcase_add_test (tc_chain, test_video_convert_semiplanar_planar);
+  tcase_add_test (tc_chain, test_video_convert_semiplanar_planar_scale);
   tcase_add_test (tc_chain, test_video_transfer);
   tcase_add_test (tc_chain, test_overlay_blend);
   tcase_add_test (tc_chain, test_video_center_rect);
+  tcase_add_test (tc_chain, test_overlay_blend_420);
   tcase_add_test (tc_chain, test_overlay_composition_over_transparency);
   tcase_add_test (tc_chain, test_video_format_enum_stability);
   tcase_add_test (tc_chain, test_video_formats_pstrides);
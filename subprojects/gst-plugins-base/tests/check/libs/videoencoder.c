@@ -55,6 +55,7 @@ struct _GstVideoEncoderTester
   gboolean key_frame_sent;
   gboolean enable_step_by_step;
   gboolean negotiate_in_set_format;
+  gboolean parallel;
   GstVideoCodecFrame *last_frame;
 };
 
@@ -141,6 +142,35 @@ gst_video_encoder_push_subframe (GstVideoEncoder * enc,
     return gst_video_encoder_finish_frame (enc, frame);
 }
 
+/* used when frames are encoded in parallel, doesn't touch any of the
+ * tester state so it can be called from several threads at once */
+static GstFlowReturn
+gst_video_encoder_tester_parallel_frame (GstVideoEncoder * enc,
+    GstVideoCodecFrame * frame)
+{
+  guint8 *data;
+  GstMapInfo map;
+  guint64 input_num;
+
+  gst_buffer_map (frame->input_buffer, &map, GST_MAP_READ);
+  input_num = *((guint64 *) map.data);
+  gst_buffer_unmap (frame->input_buffer, &map);
+
+  /* make later frames of each group finish first */
+  g_usleep ((3 - (input_num % 4)) * 2000);
+
+  if (input_num == 0)
+    GST_VIDEO_CODEC_FRAME_SET_SYNC_POINT (frame);
+
+  data = g_malloc (sizeof (guint64));
+  *(guint64 *) data = input_num;
+  frame->output_buffer = gst_buffer_new_wrapped (data, sizeof (guint64));
+  frame->pts = GST_BUFFER_PTS (frame->input_buffer);
+  frame->duration = GST_BUFFER_DURATION (frame->input_buffer);
+
+  return gst_video_encoder_finish_frame (enc, frame);
+}
+
 static GstFlowReturn
 gst_video_encoder_tester_output_step_by_step (GstVideoEncoder * enc,
     GstVideoCodecFrame * frame, gint steps)
@@ -175,6 +205,9 @@ gst_video_encoder_tester_handle_frame (GstVideoEncoder * enc,
     return gst_video_encoder_finish_frame (enc, frame);
   }
 
+  if (enc_tester->parallel)
+    return gst_video_encoder_tester_parallel_frame (enc, frame);
+
   enc_tester->last_frame = gst_video_codec_frame_ref (frame);
   if (enc_tester->enable_step_by_step)
     return GST_FLOW_OK;
@@ -384,6 +417,63 @@ GST_START_TEST (videoencoder_playback)
 
 GST_END_TEST;
 
+GST_START_TEST (videoencoder_playback_parallel)
+{
+  GstSegment segment;
+  GstBuffer *buffer;
+  guint64 i;
+  GList *iter;
+
+  setup_videoencodertester ();
+
+  GST_VIDEO_ENCODER_TESTER (enc)->parallel = TRUE;
+  gst_video_encoder_set_max_frames_in_flight (GST_VIDEO_ENCODER (enc), 4);
+  fail_unless_equals_int (gst_video_encoder_get_max_frames_in_flight
+      (GST_VIDEO_ENCODER (enc)), 4);
+
+  gst_pad_set_active (mysrcpad, TRUE);
+  gst_element_set_state (enc, GST_STATE_PLAYING);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  send_startup_events ();
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < NUM_BUFFERS; i++) {
+    buffer = create_test_buffer (i);
+
+    fail_unless (gst_pad_push (mysrcpad, buffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* frames finish out of order but must be pushed in input order */
+  fail_unless_equals_int (g_list_length (buffers), NUM_BUFFERS);
+  i = 0;
+  for (iter = buffers; iter; iter = g_list_next (iter)) {
+    GstMapInfo map;
+    guint64 num;
+
+    buffer = iter->data;
+
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    num = *(guint64 *) map.data;
+    fail_unless_equals_uint64 (num, i);
+    fail_unless (GST_BUFFER_PTS (buffer) == gst_util_uint64_scale_round (i,
+            GST_SECOND * TEST_VIDEO_FPS_D, TEST_VIDEO_FPS_N));
+    gst_buffer_unmap (buffer, &map);
+    i++;
+  }
+
+  g_list_free_full (buffers, (GDestroyNotify) gst_buffer_unref);
+  buffers = NULL;
+
+  cleanup_videoencodertest ();
+}
+
+GST_END_TEST;
+
 /* make sure tags sent right before eos are pushed */
 GST_START_TEST (videoencoder_tags_before_eos)
 {
@@ -1271,6 +1361,7 @@ gst_videoencoder_suite (void)
 
   suite_add_tcase (s, tc);
   tcase_add_test (tc, videoencoder_playback);
+  tcase_add_test (tc, videoencoder_playback_parallel);
 
   tcase_add_test (tc, videoencoder_tags_before_eos);
   tcase_add_test (tc, videoencoder_events_before_eos);
@@ -551,6 +551,8 @@ on_request_sent (GObject * source, GAsyncResult * result, gpointer user_data)
       request->state != DOWNLOAD_REQUEST_STATE_HEADERS_RECEIVED) {
 
     request->state = DOWNLOAD_REQUEST_STATE_HEADERS_RECEIVED;
+    request->download_headers_time =
+        gst_adaptive_demux_clock_get_time (dh->clock);
     request->status_code = _soup_message_get_status (msg);
     request->headers = handle_response_headers (transfer);
     GST_TRACE ("request URI %s range %" G_GINT64_FORMAT " %"
@@ -66,6 +66,7 @@ download_request_new (void)
   request->status_code = 0;
 
   request->download_request_time = GST_CLOCK_TIME_NONE;
+  request->download_headers_time = GST_CLOCK_TIME_NONE;
   request->download_start_time = GST_CLOCK_TIME_NONE;
   request->download_end_time = GST_CLOCK_TIME_NONE;
   request->headers = NULL;
@@ -425,6 +426,7 @@ download_request_begin_download (DownloadRequest * request)
   request->content_received = 0;
 
   request->download_request_time = GST_CLOCK_TIME_NONE;
+  request->download_headers_time = GST_CLOCK_TIME_NONE;
   request->download_start_time = GST_CLOCK_TIME_NONE;
   request->download_end_time = GST_CLOCK_TIME_NONE;
 
@@ -499,6 +501,27 @@ _get_age_header (GstStructure * headers)
 
 /* Return the age of the download from the Age header,
  * or 0 if there was none */
+/* Time between sending the request and getting the response, or
+ * GST_CLOCK_TIME_NONE if that is not known yet */
+GstClockTime
+download_request_get_ttfb (DownloadRequest * request)
+{
+  GstClockTime response_time;
+
+  g_return_val_if_fail (request != NULL, GST_CLOCK_TIME_NONE);
+
+  response_time = request->download_headers_time;
+  if (response_time == GST_CLOCK_TIME_NONE)
+    response_time = request->download_start_time;
+
+  if (request->download_request_time == GST_CLOCK_TIME_NONE
+      || response_time == GST_CLOCK_TIME_NONE
+      || response_time < request->download_request_time)
+    return GST_CLOCK_TIME_NONE;
+
+  return response_time - request->download_request_time;
+}
+
 GstClockTime
 download_request_get_age (DownloadRequest * request)
 {
@@ -67,6 +67,7 @@ struct _DownloadRequest
   guint64 content_received;     /* Response content received so far */
 
   guint64 download_request_time;  /* Epoch time when the download started */
+  guint64 download_headers_time;  /* Epoch time when the response headers arrived */
   guint64 download_start_time;    /* Epoch time when the first data for the download arrived */
   guint64 download_newest_data_time; /* Epoch time when the most recent data for the download arrived */
   guint64 download_end_time;      /* Epoch time when the download finished */
@@ -85,6 +86,7 @@ void download_request_set_caps (DownloadRequest * request, GstCaps * caps);
 GstCaps * download_request_get_caps (DownloadRequest * request);
 
 GstClockTime download_request_get_age (DownloadRequest *request);
+GstClockTime download_request_get_ttfb (DownloadRequest *request);
 
 void download_request_add_buffer (DownloadRequest *request, GstBuffer *buffer);
 GstBuffer * download_request_take_buffer (DownloadRequest *request);
@@ -87,6 +87,7 @@ gst_adaptive_demux2_stream_init (GstAdaptiveDemux2Stream * stream)
   stream->next_input_wakeup_time = GST_CLOCK_STIME_NONE;
 
   stream->recommended_buffering_threshold = GST_CLOCK_TIME_NONE;
+  stream->last_ttfb = GST_CLOCK_TIME_NONE;
 
   stream->fragment_bitrates =
       g_malloc0 (sizeof (guint64) * NUM_LOOKBACK_FRAGMENTS);
@@ -1296,6 +1297,7 @@ update_stream_bitrate (GstAdaptiveDemux2Stream * stream,
   stream->last_download_time =
       GST_CLOCK_DIFF (request->download_request_time,
       request->download_end_time);
+  stream->last_ttfb = download_request_get_ttfb (request);
 
   /* Here we only track the time the data took to arrive and ignore request delay, so we can estimate bitrate */
   last_download_duration =
@@ -2647,6 +2649,10 @@ gst_adaptive_demux2_stream_update_current_bitrate (GstAdaptiveDemux2Stream *
   guint64 average_bitrate;
   guint64 fragment_bitrate;
   guint connection_speed, min_bitrate, max_bitrate, target_download_rate;
+  GstAdaptiveDemuxAbrPolicy abr_policy;
+  GstClockTime fragment_duration = stream->fragment.duration;
+  GstClockTime buffer_level, buffer_target;
+  GstStructure *stats;
 
   fragment_bitrate = stream->last_bitrate;
   GST_DEBUG_OBJECT (stream, "Download bitrate is : %" G_GUINT64_FORMAT " bps",
@@ -2684,6 +2690,14 @@ gst_adaptive_demux2_stream_update_current_bitrate (GstAdaptiveDemux2Stream *
   connection_speed = demux->connection_speed;
   min_bitrate = demux->min_bitrate;
   max_bitrate = demux->max_bitrate;
+  abr_policy = demux->abr_policy;
+  if ((stream->stream_type & GST_STREAM_TYPE_VIDEO) != 0)
+    buffer_level = demux->current_level_time_video;
+  else
+    buffer_level = demux->current_level_time_audio;
+  buffer_target = demux->buffering_high_watermark_time;
+  if (buffer_target == 0)
+    buffer_target = demux->max_buffering_time;
   GST_OBJECT_UNLOCK (demux);
 
   if (connection_speed) {
@@ -2701,6 +2715,46 @@ gst_adaptive_demux2_stream_update_current_bitrate (GstAdaptiveDemux2Stream *
   GST_DEBUG_OBJECT (stream, "Bitrate after target ratio limit (%0.2f): %u",
       demux->bandwidth_target_ratio, target_download_rate);
 
+  /* Each fragment request pays the latency to the server again, so only the
+   * rest of the fragment duration is available to receive its data. Don't
+   * let a single slow response more than halve the estimate though */
+  if (GST_CLOCK_TIME_IS_VALID (stream->last_ttfb)
+      && GST_CLOCK_TIME_IS_VALID (fragment_duration) && fragment_duration > 0) {
+    GstClockTime latency = MIN (stream->last_ttfb, fragment_duration / 2);
+
+    target_download_rate = gst_util_uint64_scale (target_download_rate,
+        fragment_duration - latency, fragment_duration);
+    GST_DEBUG_OBJECT (stream, "Bitrate after TTFB of %" GST_TIME_FORMAT
+        " for %" GST_TIME_FORMAT " fragments: %u",
+        GST_TIME_ARGS (stream->last_ttfb), GST_TIME_ARGS (fragment_duration),
+        target_download_rate);
+  }
+
+  /* Buffer based selection, in the spirit of BOLA: with an empty buffer only
+   * use half of the throughput, and up to 1.5 times of it once the buffer
+   * reaches its target level since it can absorb the slower downloads */
+  if (abr_policy == GST_ADAPTIVE_DEMUX_ABR_POLICY_BUFFER
+      && GST_CLOCK_TIME_IS_VALID (buffer_level) && buffer_target > 0) {
+    target_download_rate = CLAMP (gst_util_uint64_scale (target_download_rate,
+            MIN (buffer_level, buffer_target) + buffer_target / 2,
+            buffer_target), 0, G_MAXUINT);
+    GST_DEBUG_OBJECT (stream, "Bitrate after buffer level %" GST_TIME_FORMAT
+        " / %" GST_TIME_FORMAT ": %u", GST_TIME_ARGS (buffer_level),
+        GST_TIME_ARGS (buffer_target), target_download_rate);
+  }
+
+  stats = gst_structure_new ("adaptivedemux-abr-stats",
+      "stream-type", GST_TYPE_STREAM_TYPE, stream->stream_type,
+      "fragment-bitrate", G_TYPE_UINT64, fragment_bitrate,
+      "average-bitrate", G_TYPE_UINT64, average_bitrate,
+      "ttfb", G_TYPE_UINT64, stream->last_ttfb,
+      "fragment-duration", G_TYPE_UINT64, fragment_duration,
+      "buffer-level", G_TYPE_UINT64, buffer_level,
+      "target-bitrate", G_TYPE_UINT, target_download_rate, NULL);
+  target_download_rate =
+      gst_adaptive_demux2_select_bitrate_for_stream (demux, stream, stats,
+      target_download_rate);
+
 #if 0
   /* Debugging code, modulate the bitrate every few fragments */
   {
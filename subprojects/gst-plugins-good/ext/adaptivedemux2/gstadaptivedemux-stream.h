@@ -335,6 +335,9 @@ struct _GstAdaptiveDemux2Stream
   /* Total last download time, from request to completion */
   GstClockTime last_download_time;
 
+  /* Time to first byte of the last download */
+  GstClockTime last_ttfb;
+
   /* Average for the last fragments */
   guint64 moving_bitrate;
   guint moving_index;
@@ -129,6 +129,8 @@ GST_DEBUG_CATEGORY_EXTERN (adaptivedemux2_debug);
 #define DEFAULT_CURRENT_LEVEL_TIME_VIDEO 0
 #define DEFAULT_CURRENT_LEVEL_TIME_AUDIO 0
 
+#define DEFAULT_ABR_POLICY GST_ADAPTIVE_DEMUX_ABR_POLICY_THROUGHPUT
+
 #define GST_API_GET_LOCK(d) (&(GST_ADAPTIVE_DEMUX_CAST(d)->priv->api_lock))
 #define GST_API_LOCK(d)   g_mutex_lock (GST_API_GET_LOCK (d));
 #define GST_API_UNLOCK(d) g_mutex_unlock (GST_API_GET_LOCK (d));
@@ -149,9 +151,37 @@ enum
   PROP_BUFFERING_LOW_WATERMARK_FRAGMENTS,
   PROP_CURRENT_LEVEL_TIME_VIDEO,
   PROP_CURRENT_LEVEL_TIME_AUDIO,
+  PROP_ABR_POLICY,
   PROP_LAST
 };
 
+enum
+{
+  SIGNAL_SELECT_BITRATE,
+  LAST_SIGNAL
+};
+
+static guint signals[LAST_SIGNAL] = { 0 };
+
+GType
+gst_adaptive_demux_abr_policy_get_type (void)
+{
+  static gsize type = 0;
+  static const GEnumValue values[] = {
+    {GST_ADAPTIVE_DEMUX_ABR_POLICY_THROUGHPUT,
+        "Measured throughput", "throughput"},
+    {GST_ADAPTIVE_DEMUX_ABR_POLICY_BUFFER,
+        "Throughput scaled by buffering level", "buffer"},
+    {0, NULL, NULL},
+  };
+
+  if (g_once_init_enter (&type)) {
+    GType _type = g_enum_register_static ("GstAdaptiveDemuxAbrPolicy", values);
+    g_once_init_leave (&type, _type);
+  }
+  return type;
+}
+
 static GstStaticPadTemplate gst_adaptive_demux_videosrc_template =
 GST_STATIC_PAD_TEMPLATE ("video_%02u",
     GST_PAD_SRC,
@@ -326,6 +356,9 @@ gst_adaptive_demux_set_property (GObject * object, guint prop_id,
     case PROP_BUFFERING_LOW_WATERMARK_FRAGMENTS:
       demux->buffering_low_watermark_fragments = g_value_get_double (value);
       break;
+    case PROP_ABR_POLICY:
+      demux->abr_policy = g_value_get_enum (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -382,6 +415,9 @@ gst_adaptive_demux_get_property (GObject * object, guint prop_id,
     case PROP_CURRENT_LEVEL_TIME_AUDIO:
       g_value_set_uint64 (value, demux->current_level_time_audio);
       break;
+    case PROP_ABR_POLICY:
+      g_value_set_enum (value, demux->abr_policy);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -510,6 +546,47 @@ gst_adaptive_demux_class_init (GstAdaptiveDemuxClass * klass)
           G_PARAM_READABLE | GST_PARAM_MUTABLE_PLAYING |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAdaptiveDemux2:abr-policy:
+   *
+   * Built-in policy used to select the bitrate of the next fragments.
+   * Applications can implement their own by handling the
+   * #GstAdaptiveDemux2::select-bitrate signal.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_ABR_POLICY,
+      g_param_spec_enum ("abr-policy", "ABR policy",
+          "Policy used to select the bitrate of the next fragments",
+          GST_TYPE_ADAPTIVE_DEMUX_ABR_POLICY, DEFAULT_ABR_POLICY,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstAdaptiveDemux2::select-bitrate:
+   * @demux: the demuxer
+   * @stats: a #GstStructure with the download statistics of the stream
+   *
+   * Emitted from the streaming thread after each fragment download, before
+   * the bitrate of the next fragments of a stream is selected. @stats
+   * contains the "stream-type" (#GstStreamType), the "fragment-bitrate" and
+   * "average-bitrate" measurements (guint64, bits/s), the "ttfb" of the last
+   * request, the "fragment-duration" and the "buffer-level" of the stream
+   * (guint64, ns, or GST_CLOCK_TIME_NONE if unknown), and the
+   * "target-bitrate" selected by the #GstAdaptiveDemux2:abr-policy (guint,
+   * bits/s).
+   *
+   * Returns: the bitrate to use in bits/s, or 0 to use the target bitrate
+   * selected by the demuxer. The min-bitrate and max-bitrate limits still
+   * apply.
+   *
+   * Since: 1.24
+   */
+  signals[SIGNAL_SELECT_BITRATE] =
+      g_signal_new ("select-bitrate", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST, 0, g_signal_accumulator_first_wins, NULL, NULL,
+      G_TYPE_UINT, 1, GST_TYPE_STRUCTURE);
+
   gst_element_class_add_static_pad_template (gstelement_class,
       &gst_adaptive_demux_audiosrc_template);
   gst_element_class_add_static_pad_template (gstelement_class,
@@ -527,6 +604,26 @@ gst_adaptive_demux_class_init (GstAdaptiveDemuxClass * klass)
   klass->requires_periodical_playlist_update =
       gst_adaptive_demux_requires_periodical_playlist_update_default;
   gst_type_mark_as_plugin_api (GST_TYPE_ADAPTIVE_DEMUX, 0);
+  gst_type_mark_as_plugin_api (GST_TYPE_ADAPTIVE_DEMUX_ABR_POLICY, 0);
+}
+
+/* Give the application a chance to override the bitrate selected for
+ * @stream. Takes ownership of @stats */
+guint
+gst_adaptive_demux2_select_bitrate_for_stream (GstAdaptiveDemux * demux,
+    GstAdaptiveDemux2Stream * stream, GstStructure * stats,
+    guint target_bitrate)
+{
+  guint bitrate = 0;
+
+  g_signal_emit (demux, signals[SIGNAL_SELECT_BITRATE], 0, stats, &bitrate);
+  gst_structure_free (stats);
+
+  if (bitrate == 0)
+    return target_bitrate;
+
+  GST_DEBUG_OBJECT (stream, "Application selected bitrate %u bps", bitrate);
+  return bitrate;
 }
 
 static void
@@ -593,6 +690,7 @@ gst_adaptive_demux_init (GstAdaptiveDemux * demux,
 
   demux->current_level_time_video = DEFAULT_CURRENT_LEVEL_TIME_VIDEO;
   demux->current_level_time_audio = DEFAULT_CURRENT_LEVEL_TIME_AUDIO;
+  demux->abr_policy = DEFAULT_ABR_POLICY;
 
   gst_element_add_pad (GST_ELEMENT (demux), demux->sinkpad);
 
@@ -91,6 +91,26 @@ G_BEGIN_DECLS
 
 typedef struct _GstAdaptiveDemuxPrivate GstAdaptiveDemuxPrivate;
 
+/**
+ * GstAdaptiveDemuxAbrPolicy:
+ * @GST_ADAPTIVE_DEMUX_ABR_POLICY_THROUGHPUT: Select the bitrate from the
+ *   measured download throughput only
+ * @GST_ADAPTIVE_DEMUX_ABR_POLICY_BUFFER: Scale the throughput based bitrate
+ *   with the buffering level, to switch down early when the buffer drains
+ *   and to allow higher bitrates when it is well filled
+ *
+ * Built-in policies used to select the bitrate of the next fragments.
+ *
+ * Since: 1.24
+ */
+typedef enum {
+  GST_ADAPTIVE_DEMUX_ABR_POLICY_THROUGHPUT,
+  GST_ADAPTIVE_DEMUX_ABR_POLICY_BUFFER,
+} GstAdaptiveDemuxAbrPolicy;
+
+#define GST_TYPE_ADAPTIVE_DEMUX_ABR_POLICY (gst_adaptive_demux_abr_policy_get_type ())
+GType gst_adaptive_demux_abr_policy_get_type (void);
+
 struct _GstAdaptiveDemuxTrack
 {
   gint ref_count;
@@ -278,6 +298,7 @@ struct _GstAdaptiveDemux
   guint max_bitrate; /* Maximum bitrate to choose */
 
   guint current_download_rate; /* Current estimate of download bitrate */
+  GstAdaptiveDemuxAbrPolicy abr_policy; /* Bitrate selection policy */
 
   /* Buffering levels */
   GstClockTime max_buffering_time;
@@ -449,6 +470,11 @@ struct _GstAdaptiveDemuxClass
 
 GType    gst_adaptive_demux_ng_get_type (void);
 
+guint gst_adaptive_demux2_select_bitrate_for_stream (GstAdaptiveDemux *demux,
+						     GstAdaptiveDemux2Stream *stream,
+						     GstStructure *stats,
+						     guint target_bitrate);
+
 gboolean gst_adaptive_demux2_add_stream (GstAdaptiveDemux *demux,
 					 GstAdaptiveDemux2Stream *stream);
 
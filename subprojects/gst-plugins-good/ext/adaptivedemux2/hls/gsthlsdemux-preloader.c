@@ -131,6 +131,10 @@ gst_hls_demux_preloader_load (GstHLSDemuxPreloader * preloader,
         return;                 /* Nothing to do */
       }
 
+      /* Several upcoming segments can be prefetched at once */
+      if (hint->hint_type == M3U8_PRELOAD_HINT_SEGMENT)
+        continue;
+
       gst_hls_demux_preloader_release_request (preloader, req, TRUE);
       g_ptr_array_remove_index_fast (preloader->active_preloads, idx);
       break;
@@ -169,6 +173,34 @@ gst_hls_demux_preloader_cancel (GstHLSDemuxPreloader * preloader,
   }
 }
 
+/* Cancel the active preloads of one of @hint_types that don't match any of the
+ * hints in @hints */
+void
+gst_hls_demux_preloader_cancel_unlisted (GstHLSDemuxPreloader * preloader,
+    GstM3U8PreloadHintType hint_types, GPtrArray * hints)
+{
+  guint idx, i;
+  for (idx = 0; idx < preloader->active_preloads->len;) {
+    GstHLSDemuxPreloadRequest *req =
+        g_ptr_array_index (preloader->active_preloads, idx);
+    gboolean listed = FALSE;
+
+    if (hint_types & req->hint->hint_type) {
+      for (i = 0; i < hints->len && !listed; i++)
+        listed = gst_m3u8_preload_hint_equal (req->hint,
+            g_ptr_array_index (hints, i));
+
+      if (!listed) {
+        gst_hls_demux_preloader_release_request (preloader, req, TRUE);
+        g_ptr_array_remove_index_fast (preloader->active_preloads, idx);
+        continue;
+      }
+    }
+
+    idx++;
+  }
+}
+
 /* This function transfers any available data to the target request, and possibly
  * completes it and removes it from the preload */
 static void
@@ -447,6 +479,9 @@ gst_hls_demux_preloader_submit (GstHLSDemuxPreloader * preloader,
   gint64 end = RFC8673_LAST_BYTE_POS;
   if (hint->size > 0) {
     end = hint->offset + hint->size - 1;
+  } else if (hint->hint_type == M3U8_PRELOAD_HINT_SEGMENT) {
+    /* Complete segments don't need an open-ended range request */
+    end = -1;
   }
 
   download_request_set_uri (download_req, hint->uri, hint->offset, end);
@@ -41,6 +41,7 @@ GstHLSDemuxPreloader *gst_hls_demux_preloader_new (DownloadHelper *download_help
 void gst_hls_demux_preloader_free (GstHLSDemuxPreloader *preloader);
 void gst_hls_demux_preloader_load (GstHLSDemuxPreloader *preloader, GstM3U8PreloadHint *hint, const gchar *referrer_uri);
 void gst_hls_demux_preloader_cancel (GstHLSDemuxPreloader *preloader, GstM3U8PreloadHintType hint_types);
+void gst_hls_demux_preloader_cancel_unlisted (GstHLSDemuxPreloader *preloader, GstM3U8PreloadHintType hint_types, GPtrArray *hints);
 
 gboolean gst_hls_demux_preloader_provide_request (GstHLSDemuxPreloader *preloader, DownloadRequest *target_req);
 
@@ -1216,7 +1216,7 @@ gst_hls_demux_stream_update_preloads (GstHLSDemuxStream * hlsdemux_stream)
     if (hlsdemux_stream->preloader != NULL) {
       /* Cancel any preloads, the new playlist doesn't have them */
       gst_hls_demux_preloader_cancel (hlsdemux_stream->preloader,
-          M3U8_PRELOAD_HINT_ALL);
+          M3U8_PRELOAD_HINT_MAP | M3U8_PRELOAD_HINT_PART);
     }
     /* Nothing to preload */
     return;
@@ -1256,17 +1256,108 @@ gst_hls_demux_stream_update_preloads (GstHLSDemuxStream * hlsdemux_stream)
   }
 }
 
+static GstM3U8PreloadHint *
+gst_hls_demux_stream_prefetch_hint_new (GstM3U8MediaSegment * segment)
+{
+  GstM3U8PreloadHint *hint = g_new0 (GstM3U8PreloadHint, 1);
+
+  hint->ref_count = 1;
+  hint->hint_type = M3U8_PRELOAD_HINT_SEGMENT;
+  hint->uri = g_strdup (segment->uri);
+  hint->offset = segment->offset;
+  hint->size = segment->size;
+
+  return hint;
+}
+
+/* Start downloading the segments following the current one, up to the
+ * prefetch-segments count and the maximum buffering time, and cancel the
+ * prefetches that are not needed anymore. Called after the request for the
+ * current segment was submitted, so that it always goes out first */
+static void
+gst_hls_demux_stream_update_prefetches (GstHLSDemuxStream * hlsdemux_stream)
+{
+  GstAdaptiveDemux2Stream *stream = (GstAdaptiveDemux2Stream *) hlsdemux_stream;
+  GstAdaptiveDemux *demux = stream->demux;
+  GstHLSDemux *hlsdemux = GST_HLS_DEMUX_STREAM_GET_DEMUX (hlsdemux_stream);
+  GstHLSMediaPlaylist *playlist = hlsdemux_stream->playlist;
+  GPtrArray *hints;
+  GstClockTime max_buffering, prefetched = 0;
+  guint n_prefetch, idx;
+
+  if (hlsdemux->prefetch_segments == 0 && hlsdemux_stream->preloader == NULL)
+    return;
+
+  hints = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      gst_m3u8_preload_hint_unref);
+
+  GST_OBJECT_LOCK (demux);
+  max_buffering = demux->max_buffering_time;
+  GST_OBJECT_UNLOCK (demux);
+
+  n_prefetch = hlsdemux->prefetch_segments;
+  if (n_prefetch == 0 || playlist == NULL
+      || hlsdemux_stream->current_segment == NULL
+      || hlsdemux_stream->in_partial_segments || demux->segment.rate < 0.0)
+    goto done;
+
+  GST_HLS_MEDIA_PLAYLIST_LOCK (playlist);
+  if (g_ptr_array_find (playlist->segments, hlsdemux_stream->current_segment,
+          &idx)) {
+    for (idx++; idx < playlist->segments->len && hints->len < n_prefetch;
+        idx++) {
+      GstM3U8MediaSegment *segment =
+          g_ptr_array_index (playlist->segments, idx);
+
+      /* Parts of the live edge segment are handled by the preload hints */
+      if (segment->is_gap || segment->partial_only || segment->uri == NULL)
+        break;
+
+      prefetched += segment->duration;
+      if (max_buffering != 0 && hints->len > 0 && prefetched > max_buffering)
+        break;
+
+      g_ptr_array_add (hints, gst_hls_demux_stream_prefetch_hint_new (segment));
+    }
+  }
+  GST_HLS_MEDIA_PLAYLIST_UNLOCK (playlist);
+
+  if (hints->len > 0 && hlsdemux_stream->preloader == NULL) {
+    hlsdemux_stream->preloader =
+        gst_hls_demux_preloader_new (demux->download_helper);
+  }
+
+done:
+  if (hlsdemux_stream->preloader != NULL) {
+    gst_hls_demux_preloader_cancel_unlisted (hlsdemux_stream->preloader,
+        M3U8_PRELOAD_HINT_SEGMENT, hints);
+
+    for (idx = 0; idx < hints->len; idx++) {
+      GST_LOG_OBJECT (stream, "Prefetching segment %s",
+          ((GstM3U8PreloadHint *) g_ptr_array_index (hints, idx))->uri);
+      gst_hls_demux_preloader_load (hlsdemux_stream->preloader,
+          g_ptr_array_index (hints, idx), playlist->uri);
+    }
+  }
+
+  g_ptr_array_free (hints, TRUE);
+}
+
 static GstFlowReturn
 gst_hls_demux_stream_submit_request (GstAdaptiveDemux2Stream * stream,
     DownloadRequest * download_req)
 {
   GstHLSDemuxStream *hlsdemux_stream = GST_HLS_DEMUX_STREAM_CAST (stream);
+  GstFlowReturn ret;
 
   /* See if the request can be satisfied from a preload */
   if (hlsdemux_stream->preloader != NULL) {
     if (gst_hls_demux_preloader_provide_request (hlsdemux_stream->preloader,
-            download_req))
+            download_req)) {
+      if (!stream->downloading_header)
+        gst_hls_demux_stream_update_prefetches (hlsdemux_stream);
       return GST_FLOW_OK;
+    }
 
     /* We're about to request something, but it wasn't the active preload,
      * so make sure that's been stopped / cancelled so we're not downloading
@@ -1281,9 +1372,14 @@ gst_hls_demux_stream_submit_request (GstAdaptiveDemux2Stream * stream,
     }
   }
 
-  return
+  ret =
       GST_ADAPTIVE_DEMUX2_STREAM_CLASS (stream_parent_class)->submit_request
       (stream, download_req);
+
+  if (ret == GST_FLOW_OK && !stream->downloading_header)
+    gst_hls_demux_stream_update_prefetches (hlsdemux_stream);
+
+  return ret;
 }
 
 static void
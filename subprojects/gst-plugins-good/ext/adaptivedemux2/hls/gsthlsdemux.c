@@ -72,9 +72,11 @@ enum
   PROP_0,
 
   PROP_START_BITRATE,
+  PROP_PREFETCH_SEGMENTS,
 };
 
 #define DEFAULT_START_BITRATE 0
+#define DEFAULT_PREFETCH_SEGMENTS 0
 
 /* GObject */
 static void gst_hls_demux_finalize (GObject * obj);
@@ -139,6 +141,9 @@ gst_hls_demux_set_property (GObject * object, guint prop_id,
     case PROP_START_BITRATE:
       demux->start_bitrate = g_value_get_uint (value);
       break;
+    case PROP_PREFETCH_SEGMENTS:
+      demux->prefetch_segments = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -155,6 +160,9 @@ gst_hls_demux_get_property (GObject * object, guint prop_id,
     case PROP_START_BITRATE:
       g_value_set_uint (value, demux->start_bitrate);
       break;
+    case PROP_PREFETCH_SEGMENTS:
+      g_value_set_uint (value, demux->prefetch_segments);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -193,6 +201,23 @@ gst_hls_demux2_class_init (GstHLSDemux2Class * klass)
           0, G_MAXUINT, DEFAULT_START_BITRATE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * hlsdemux2:prefetch-segments:
+   *
+   * Number of upcoming media segments of each stream to start downloading
+   * while the current one is being downloaded. This avoids waiting for a
+   * full request round trip between segments, which limits the throughput
+   * with short segments. Prefetches are limited to the maximum buffering
+   * time of the demuxer, if set.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PREFETCH_SEGMENTS,
+      g_param_spec_uint ("prefetch-segments", "Prefetch segments",
+          "Number of upcoming segments to download in parallel (0 = disabled)",
+          0, 16, DEFAULT_PREFETCH_SEGMENTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   element_class->change_state = GST_DEBUG_FUNCPTR (gst_hls_demux_change_state);
 
   gst_element_class_add_static_pad_template (element_class, &sinktemplate);
@@ -221,6 +246,7 @@ gst_hls_demux2_init (GstHLSDemux * demux)
 {
   demux->keys = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
   g_mutex_init (&demux->keys_lock);
+  demux->prefetch_segments = DEFAULT_PREFETCH_SEGMENTS;
 }
 
 static GstStateChangeReturn
@@ -81,6 +81,9 @@ struct _GstHLSDemux2
   /* Initial bitrate to use before any bandwidth measurement */
   guint start_bitrate;
 
+  /* Number of upcoming segments to download in parallel */
+  guint prefetch_segments;
+
   /* Decryption key cache: url => GstHLSKey */
   GHashTable *keys;
   GMutex      keys_lock;
@@ -198,9 +198,11 @@ enum _GstM3U8PreloadHintType {
   M3U8_PRELOAD_HINT_NONE = (0 << 0),
   M3U8_PRELOAD_HINT_MAP = (1 << 0),
   M3U8_PRELOAD_HINT_PART = (1 << 1),
+  /* Not from the playlist: prefetch of an upcoming media segment */
+  M3U8_PRELOAD_HINT_SEGMENT = (1 << 2),
 };
 
-#define M3U8_PRELOAD_HINT_ALL (M3U8_PRELOAD_HINT_PART | M3U8_PRELOAD_HINT_MAP)
+#define M3U8_PRELOAD_HINT_ALL (M3U8_PRELOAD_HINT_PART | M3U8_PRELOAD_HINT_MAP | M3U8_PRELOAD_HINT_SEGMENT)
 
 /**
  * GstM3U8PreloadHint:
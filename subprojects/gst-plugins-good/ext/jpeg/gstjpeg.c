@@ -44,3 +44,31 @@ gst_idct_method_get_type (void)
   }
   return idct_method_type;
 }
+
+/* A pool for the threads working on a frame besides the streaming thread,
+ * NULL if the work is not split */
+GstTaskPool *
+gst_jpeg_task_pool_new (guint n_threads)
+{
+  GstTaskPool *pool;
+
+  if (n_threads <= 1)
+    return NULL;
+
+  pool = gst_shared_task_pool_new ();
+  gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool),
+      n_threads - 1);
+  gst_task_pool_prepare (pool, NULL);
+
+  return pool;
+}
+
+void
+gst_jpeg_task_pool_free (GstTaskPool * pool)
+{
+  if (!pool)
+    return;
+
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
@@ -21,7 +21,7 @@
 #ifndef __GST_JPEG_H__
 #define __GST_JPEG_H__
 
-#include <glib-object.h>
+#include <gst/gst.h>
 
 G_BEGIN_DECLS
 
@@ -29,6 +29,10 @@ G_BEGIN_DECLS
 #define GST_TYPE_IDCT_METHOD (gst_idct_method_get_type())
 GType gst_idct_method_get_type (void);
 
+GstTaskPool * gst_jpeg_task_pool_new (guint n_threads);
+
+void gst_jpeg_task_pool_free (GstTaskPool * pool);
+
 
 G_END_DECLS
 
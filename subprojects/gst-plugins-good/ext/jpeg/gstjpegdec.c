@@ -30,6 +30,10 @@
  * |[
  * gst-launch-1.0 -v filesrc location=mjpeg.avi ! avidemux !  queue ! jpegdec ! videoconvert ! videoscale ! autovideosink
  * ]| The above pipeline decode the mjpeg stream and renders it to the screen.
+ * |[
+ * gst-launch-1.0 filesrc location=image.jpg ! jpegdec downscale=8 ! videoconvert ! pngenc ! filesink location=thumbnail.png
+ * ]| The above pipeline writes a thumbnail of an eighth of the image size,
+ * without decoding it at full size first.
  *
  */
 
@@ -60,12 +64,16 @@
 
 #define JPEG_DEFAULT_IDCT_METHOD	JDCT_FASTEST
 #define JPEG_DEFAULT_MAX_ERRORS 	0
+#define JPEG_DEFAULT_DOWNSCALE		1
+#define JPEG_DEFAULT_MAX_THREADS	1
 
 enum
 {
   PROP_0,
   PROP_IDCT_METHOD,
-  PROP_MAX_ERRORS
+  PROP_MAX_ERRORS,
+  PROP_DOWNSCALE,
+  PROP_MAX_THREADS
 };
 
 /* *INDENT-OFF* */
@@ -116,12 +124,17 @@ G_DEFINE_TYPE (GstJpegDec, gst_jpeg_dec, GST_TYPE_VIDEO_DECODER);
 GST_ELEMENT_REGISTER_DEFINE (jpegdec, "jpegdec", GST_RANK_PRIMARY,
     GST_TYPE_JPEG_DEC);
 
+static void gst_jpeg_dec_free_slices (GstJpegDec * dec);
+
 static void
 gst_jpeg_dec_finalize (GObject * object)
 {
   GstJpegDec *dec = GST_JPEG_DEC (object);
 
   jpeg_destroy_decompress (&dec->cinfo);
+  gst_jpeg_dec_free_slices (dec);
+  gst_jpeg_task_pool_free (dec->pool);
+  g_array_unref (dec->restarts);
   if (dec->input_state)
     gst_video_codec_state_unref (dec->input_state);
 
@@ -168,6 +181,38 @@ gst_jpeg_dec_class_init (GstJpegDecClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS | G_PARAM_DEPRECATED));
 #endif
 
+  /**
+   * GstJpegDec:downscale:
+   *
+   * Divides the width and height of the output by this factor, the image
+   * being scaled while decoding by skipping the high frequency coefficients.
+   * This is a lot cheaper than a full decode followed by a scaler, for
+   * thumbnails for example. It is rounded to the nearest factor libjpeg
+   * supports (2, 4 and 8, or any multiple of 1/8 with libjpeg-turbo).
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_DOWNSCALE,
+      g_param_spec_uint ("downscale", "Downscale",
+          "Factor to divide the image size by while decoding", 1, 8,
+          JPEG_DEFAULT_DOWNSCALE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstJpegDec:max-threads:
+   *
+   * The maximum number of threads a frame is decoded with, 0 for the number
+   * of processors. Only frames with restart markers at MCU row boundaries,
+   * such as the ones jpegenc outputs when encoding with multiple threads,
+   * can be decoded in parallel, and only when decoding to I420 at full size.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_uint ("max-threads", "Max Threads",
+          "Maximum number of threads to use (0 = number of processors)", 0,
+          G_MAXINT, JPEG_DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (element_class,
       &gst_jpeg_dec_src_pad_template);
   gst_element_class_add_static_pad_template (element_class,
@@ -281,6 +326,10 @@ gst_jpeg_dec_init (GstJpegDec * dec)
   /* init properties */
   dec->idct_method = JPEG_DEFAULT_IDCT_METHOD;
   dec->max_errors = JPEG_DEFAULT_MAX_ERRORS;
+  dec->downscale = JPEG_DEFAULT_DOWNSCALE;
+  dec->max_threads = JPEG_DEFAULT_MAX_THREADS;
+  dec->n_threads = 1;
+  dec->restarts = g_array_new (FALSE, FALSE, sizeof (gsize));
 
   gst_video_decoder_set_use_default_pad_acceptcaps (GST_VIDEO_DECODER_CAST
       (dec), TRUE);
@@ -868,9 +917,32 @@ gst_jpeg_dec_decode_indirect (GstJpegDec * dec, GstVideoFrame * frame, gint r_v,
   }
 }
 
+static void
+gst_jpeg_dec_ensure_scratch (GstJpegDec * dec, GstVideoFrame * frame,
+    guint num_fields)
+{
+  guint field_height = GST_VIDEO_FRAME_HEIGHT (frame);
+  gint stride = GST_VIDEO_FRAME_COMP_STRIDE (frame, 0) * num_fields;
+
+  /* XXX: division by 2 here might not be a good idea yes. But we are doing this
+   * already in gst_jpeg_dec_handle_frame() for interlaced jpeg */
+  if (num_fields == 2)
+    field_height /= 2;
+
+  if (field_height % (dec->cinfo.comp_info[0].v_samp_factor * DCTSIZE) &&
+      (dec->scratch_size < stride)) {
+    g_free (dec->scratch);
+    dec->scratch = g_malloc (stride);
+    dec->scratch_size = stride;
+  }
+}
+
+/* decodes @height lines into @frame starting at @first_row, a multiple of the
+ * MCU height */
 static GstFlowReturn
-gst_jpeg_dec_decode_direct (GstJpegDec * dec, GstVideoFrame * frame,
-    guint field, guint num_fields)
+gst_jpeg_dec_decode_direct (GstJpegDec * dec, j_decompress_ptr cinfo,
+    GstVideoFrame * frame, guint field, guint num_fields, guint first_row,
+    guint height)
 {
   guchar **line[3];             /* the jpeg line buffer         */
   guchar *y[4 * DCTSIZE] = { NULL, };   /* alloc enough for the lines   */
@@ -880,26 +952,18 @@ gst_jpeg_dec_decode_direct (GstJpegDec * dec, GstVideoFrame * frame,
   gint lines, v_samp[3];
   guchar *base[3], *last[3];
   gint stride[3];
-  guint height, field_height;
 
   line[0] = y;
   line[1] = u;
   line[2] = v;
 
-  v_samp[0] = dec->cinfo.comp_info[0].v_samp_factor;
-  v_samp[1] = dec->cinfo.comp_info[1].v_samp_factor;
-  v_samp[2] = dec->cinfo.comp_info[2].v_samp_factor;
+  v_samp[0] = cinfo->comp_info[0].v_samp_factor;
+  v_samp[1] = cinfo->comp_info[1].v_samp_factor;
+  v_samp[2] = cinfo->comp_info[2].v_samp_factor;
 
   if (G_UNLIKELY (v_samp[0] > 2 || v_samp[1] > 2 || v_samp[2] > 2))
     goto format_not_supported;
 
-  height = field_height = GST_VIDEO_FRAME_HEIGHT (frame);
-
-  /* XXX: division by 2 here might not be a good idea yes. But we are doing this
-   * already in gst_jpeg_dec_handle_frame() for interlaced jpeg */
-  if (num_fields == 2)
-    field_height /= 2;
-
   for (i = 0; i < 3; i++) {
     base[i] = GST_VIDEO_FRAME_COMP_DATA (frame, i);
     stride[i] = GST_VIDEO_FRAME_COMP_STRIDE (frame, i) * num_fields;
@@ -911,12 +975,7 @@ gst_jpeg_dec_decode_direct (GstJpegDec * dec, GstVideoFrame * frame,
     if (field == 2) {
       base[i] += GST_VIDEO_FRAME_COMP_STRIDE (frame, i);
     }
-  }
-
-  if (field_height % (v_samp[0] * DCTSIZE) && (dec->scratch_size < stride[0])) {
-    g_free (dec->scratch);
-    dec->scratch = g_malloc (stride[0]);
-    dec->scratch_size = stride[0];
+    base[i] += (i == 0 ? first_row : first_row / 2) * stride[i];
   }
 
   /* let jpeglib decode directly into our final buffer */
@@ -935,9 +994,9 @@ gst_jpeg_dec_decode_direct (GstJpegDec * dec, GstVideoFrame * frame,
       bufbase += GST_VIDEO_FRAME_PLANE_STRIDE (frame, 0);
     }
 
-    while (dec->cinfo.output_scanline < dec->cinfo.output_height) {
+    while (cinfo->output_scanline < cinfo->output_height) {
       JSAMPARRAY buffer = { &bufbase, };
-      jpeg_read_scanlines (&dec->cinfo, buffer, 1);
+      jpeg_read_scanlines (cinfo, buffer, 1);
       bufbase += row_stride;
     }
   } else
@@ -967,7 +1026,7 @@ gst_jpeg_dec_decode_direct (GstJpegDec * dec, GstVideoFrame * frame,
           line[2][j] = dec->scratch;
       }
 
-      lines = jpeg_read_raw_data (&dec->cinfo, line, v_samp[0] * DCTSIZE);
+      lines = jpeg_read_raw_data (cinfo, line, v_samp[0] * DCTSIZE);
       if (G_UNLIKELY (!lines)) {
         GST_INFO_OBJECT (dec, "jpeg_read_raw_data() returned 0");
       }
@@ -1206,8 +1265,11 @@ gst_jpeg_dec_prepare_decode (GstJpegDec * dec)
 #endif
   {
     dec->cinfo.out_color_space = dec->cinfo.jpeg_color_space;
-    dec->cinfo.raw_data_out = TRUE;
+    /* raw data is only handled at full size */
+    dec->cinfo.raw_data_out = (dec->downscale == 1);
   }
+  dec->cinfo.scale_num = 1;
+  dec->cinfo.scale_denom = dec->downscale;
 
   GST_LOG_OBJECT (dec, "starting decompress");
   guarantee_huff_tables (&dec->cinfo);
@@ -1287,13 +1349,331 @@ invalid_yuvrgbgrayscale:
   }
 }
 
+/* for scaled images, libjpeg outputs interleaved components at full chroma
+ * resolution */
+static void
+gst_jpeg_dec_decode_scanlines (GstJpegDec * dec, GstVideoFrame * frame)
+{
+  JSAMPROW row[1];
+  guint8 *base[3];
+  gint stride[3];
+  gint components = dec->cinfo.output_components;
+  gint width, height;
+  gint i, k;
+
+  GST_DEBUG_OBJECT (dec, "decoding scaled image by scanlines");
+
+  width = GST_VIDEO_FRAME_WIDTH (frame);
+  height = GST_VIDEO_FRAME_HEIGHT (frame);
+
+  if (G_UNLIKELY (!gst_jpeg_dec_ensure_buffers (dec,
+              GST_ROUND_UP_32 (width * components))))
+    return;
+
+  for (i = 0; i < GST_VIDEO_FRAME_N_PLANES (frame); i++) {
+    base[i] = GST_VIDEO_FRAME_PLANE_DATA (frame, i);
+    stride[i] = GST_VIDEO_FRAME_PLANE_STRIDE (frame, i);
+  }
+
+  row[0] = dec->idr_y[0];
+
+  for (i = 0; i < height; i++) {
+    if (G_UNLIKELY (jpeg_read_scanlines (&dec->cinfo, row, 1) != 1)) {
+      GST_INFO_OBJECT (dec, "jpeg_read_scanlines() returned 0");
+      break;
+    }
+
+    if (GST_VIDEO_FRAME_FORMAT (frame) == GST_VIDEO_FORMAT_I420) {
+      for (k = 0; k < width; k++)
+        base[0][k] = row[0][k * 3];
+      if ((i & 1) == 0) {
+        for (k = 0; k < (width + 1) / 2; k++) {
+          base[1][k] = row[0][k * 6 + 1];
+          base[2][k] = row[0][k * 6 + 2];
+        }
+      } else {
+        base[1] += stride[1];
+        base[2] += stride[2];
+      }
+    } else {
+      /* packed RGB or GRAY8 */
+      memcpy (base[0], row[0], width * components);
+    }
+    base[0] += stride[0];
+  }
+}
+
+static void
+gst_jpeg_dec_free_slices (GstJpegDec * dec)
+{
+  guint i;
+
+  for (i = 0; i < dec->n_slices; i++) {
+    jpeg_destroy_decompress (&dec->slices[i].cinfo);
+    g_free (dec->slices[i].header);
+  }
+
+  g_free (dec->slices);
+  dec->slices = NULL;
+  dec->n_slices = 0;
+}
+
+static boolean
+gst_jpeg_dec_slice_fill_input_buffer (j_decompress_ptr cinfo)
+{
+  static const guint8 eoi[2] = { 0xff, 0xd9 };
+  GstJpegDecSlice *slice = (GstJpegDecSlice *) cinfo;
+
+  /* the headers are followed by the entropy coded data of the slice, and
+   * an EOI marker that is repeated in case of corrupted data */
+  if (slice->chunk++ == 0) {
+    cinfo->src->next_input_byte = slice->data;
+    cinfo->src->bytes_in_buffer = slice->size;
+  } else {
+    cinfo->src->next_input_byte = eoi;
+    cinfo->src->bytes_in_buffer = sizeof (eoi);
+  }
+
+  return TRUE;
+}
+
+static void
+gst_jpeg_dec_ensure_slices (GstJpegDec * dec, guint n_slices)
+{
+  guint i;
+
+  if (dec->n_slices >= n_slices)
+    return;
+
+  dec->slices = g_renew (GstJpegDecSlice, dec->slices, n_slices);
+  memset (dec->slices + dec->n_slices, 0,
+      (n_slices - dec->n_slices) * sizeof (GstJpegDecSlice));
+
+  for (i = dec->n_slices; i < n_slices; i++) {
+    GstJpegDecSlice *slice = &dec->slices[i];
+
+    slice->cinfo.err = jpeg_std_error (&slice->jerr.pub);
+    slice->jerr.pub.output_message = gst_jpeg_dec_my_output_message;
+    slice->jerr.pub.emit_message = gst_jpeg_dec_my_emit_message;
+    slice->jerr.pub.error_exit = gst_jpeg_dec_my_error_exit;
+
+    jpeg_create_decompress (&slice->cinfo);
+
+    slice->cinfo.src = (struct jpeg_source_mgr *) &slice->jsrc;
+    slice->cinfo.src->init_source = gst_jpeg_dec_init_source;
+    slice->cinfo.src->fill_input_buffer = gst_jpeg_dec_slice_fill_input_buffer;
+    slice->cinfo.src->skip_input_data = gst_jpeg_dec_skip_input_data;
+    slice->cinfo.src->resync_to_restart = gst_jpeg_dec_resync_to_restart;
+    slice->cinfo.src->term_source = gst_jpeg_dec_term_source;
+    slice->jsrc.dec = dec;
+  }
+
+  dec->n_slices = n_slices;
+}
+
+static void
+gst_jpeg_dec_decode_slice (GstJpegDecSlice * slice)
+{
+  GstJpegDec *dec = slice->jsrc.dec;
+  j_decompress_ptr cinfo = &slice->cinfo;
+
+  slice->failed = FALSE;
+
+  if (setjmp (slice->jerr.setjmp_buffer)) {
+    slice->failed = TRUE;
+    jpeg_abort_decompress (cinfo);
+    return;
+  }
+
+  slice->chunk = 0;
+  cinfo->src->next_input_byte = slice->header;
+  cinfo->src->bytes_in_buffer = slice->header_size;
+
+  jpeg_read_header (cinfo, TRUE);
+  cinfo->do_fancy_upsampling = FALSE;
+  cinfo->do_block_smoothing = FALSE;
+  cinfo->dct_method = dec->idct_method;
+  cinfo->out_color_space = cinfo->jpeg_color_space;
+  cinfo->raw_data_out = TRUE;
+  guarantee_huff_tables (cinfo);
+  jpeg_start_decompress (cinfo);
+
+  if (gst_jpeg_dec_decode_direct (dec, cinfo, slice->frame, 1, 1,
+          slice->first_row, cinfo->output_height) != GST_FLOW_OK)
+    slice->failed = TRUE;
+
+  jpeg_finish_decompress (cinfo);
+}
+
+/* The restart markers reset the decoding state, so when they are at MCU row
+ * boundaries the frame can be split into slices of consecutive intervals,
+ * each decoded as an image made of the frame headers with the height of the
+ * slice, followed by its entropy coded data. Slices start at multiples of 8
+ * intervals so that their restart markers are numbered from 0 too.
+ *
+ * Returns FALSE if the frame can't be decoded in parallel, in which case
+ * nothing was read from it yet */
+static gboolean
+gst_jpeg_dec_decode_parallel (GstJpegDec * dec, GstVideoFrame * frame,
+    GstFlowReturn * ret)
+{
+  j_decompress_ptr cinfo = &dec->cinfo;
+  const guint8 *data = dec->current_frame_map.data;
+  const guint8 *end = data + dec->current_frame_map.size;
+  const guint8 *entropy = dec->jsrc.pub.next_input_byte;
+  const guint8 *pos;
+  gsize header_size = entropy - data, sof = 0, offset;
+  guint max_threads, n_intervals, slice_intervals, n_slices, slice_height;
+  gpointer *ids;
+  guint i;
+
+  GST_OBJECT_LOCK (dec);
+  max_threads = dec->max_threads;
+  GST_OBJECT_UNLOCK (dec);
+
+  if (max_threads == 0)
+    max_threads = g_get_num_processors ();
+  if (max_threads != dec->n_threads) {
+    gst_jpeg_task_pool_free (dec->pool);
+    dec->pool = gst_jpeg_task_pool_new (max_threads);
+    dec->n_threads = max_threads;
+  }
+
+  if (!dec->pool || cinfo->progressive_mode || cinfo->restart_interval == 0
+      || cinfo->comps_in_scan != cinfo->num_components
+      || cinfo->restart_interval % cinfo->MCUs_per_row != 0
+      || cinfo->comp_info[1].v_samp_factor > 2
+      || cinfo->comp_info[2].v_samp_factor > 2)
+    return FALSE;
+
+  if (header_size < 4 || data[0] != 0xff || data[1] != 0xd8)
+    return FALSE;
+
+  /* find the SOF marker to patch the height */
+  offset = 2;
+  while (offset + 4 <= header_size && data[offset] == 0xff) {
+    guint8 marker = data[offset + 1];
+
+    if (marker == 0xff) {
+      offset++;
+      continue;
+    }
+    if (marker >= 0xc0 && marker <= 0xc2)
+      sof = offset;
+    offset += 2 + GST_READ_UINT16_BE (data + offset + 2);
+  }
+  if (!sof || sof + 7 > header_size)
+    return FALSE;
+
+  /* find the restart markers */
+  g_array_set_size (dec->restarts, 0);
+  pos = entropy;
+  while ((pos = memchr (pos, 0xff, end - pos)) && pos + 1 < end) {
+    if (pos[1] == 0x00 || pos[1] == 0xff) {
+      pos += (pos[1] == 0x00) ? 2 : 1;
+    } else if (pos[1] >= 0xd0 && pos[1] <= 0xd7) {
+      offset = pos - data;
+      g_array_append_val (dec->restarts, offset);
+      pos += 2;
+    } else {
+      break;
+    }
+  }
+  if (!pos)
+    pos = end;
+
+  n_intervals = dec->restarts->len + 1;
+  if (n_intervals != (cinfo->MCUs_per_row * cinfo->MCU_rows_in_scan +
+          cinfo->restart_interval - 1) / cinfo->restart_interval) {
+    GST_DEBUG_OBJECT (dec, "found %u restart intervals, expected %u",
+        n_intervals, (cinfo->MCUs_per_row * cinfo->MCU_rows_in_scan +
+            cinfo->restart_interval - 1) / cinfo->restart_interval);
+    return FALSE;
+  }
+
+  slice_intervals = GST_ROUND_UP_8 ((n_intervals + dec->n_threads - 1)
+      / dec->n_threads);
+  n_slices = (n_intervals + slice_intervals - 1) / slice_intervals;
+  if (n_slices < 2)
+    return FALSE;
+
+  slice_height = slice_intervals * (cinfo->restart_interval /
+      cinfo->MCUs_per_row) * cinfo->max_v_samp_factor * DCTSIZE;
+
+  GST_LOG_OBJECT (dec, "decoding %u slices of %u lines", n_slices,
+      slice_height);
+
+  gst_jpeg_dec_ensure_slices (dec, n_slices);
+
+  for (i = 0; i < n_slices; i++) {
+    GstJpegDecSlice *slice = &dec->slices[i];
+    guint first = i * slice_intervals;
+    guint last = MIN (first + slice_intervals, n_intervals) - 1;
+    const guint8 *slice_end;
+
+    if (slice->header_alloc < header_size) {
+      slice->header = g_realloc (slice->header, header_size);
+      slice->header_alloc = header_size;
+    }
+    memcpy (slice->header, data, header_size);
+    slice->header_size = header_size;
+
+    slice->first_row = i * slice_height;
+    GST_WRITE_UINT16_BE (slice->header + sof + 5,
+        MIN (slice_height, cinfo->image_height - slice->first_row));
+
+    slice->data = (first == 0) ? entropy :
+        data + g_array_index (dec->restarts, gsize, first - 1) + 2;
+    slice_end = (last + 1 == n_intervals) ? pos :
+        data + g_array_index (dec->restarts, gsize, last);
+    slice->size = slice_end - slice->data;
+    slice->frame = frame;
+  }
+
+  /* the first slice is done in the current thread */
+  ids = g_newa (gpointer, n_slices);
+  for (i = 1; i < n_slices; i++) {
+    ids[i] = gst_task_pool_push (dec->pool,
+        (GstTaskPoolFunction) gst_jpeg_dec_decode_slice, &dec->slices[i],
+        NULL);
+    if (ids[i] == NULL)
+      gst_jpeg_dec_decode_slice (&dec->slices[i]);
+  }
+
+  gst_jpeg_dec_decode_slice (&dec->slices[0]);
+
+  for (i = 1; i < n_slices; i++) {
+    if (ids[i])
+      gst_task_pool_join (dec->pool, ids[i]);
+  }
+
+  *ret = GST_FLOW_OK;
+  for (i = 0; i < n_slices; i++) {
+    if (dec->slices[i].failed) {
+      GST_VIDEO_DECODER_ERROR (dec, 1, STREAM, DECODE,
+          (_("Failed to decode JPEG image")),
+          ("Failed to decode slice %u", i), *ret);
+      break;
+    }
+  }
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_jpeg_dec_decode (GstJpegDec * dec, GstVideoFrame * vframe, guint width,
     guint height, guint field, guint num_fields)
 {
   GstFlowReturn ret = GST_FLOW_OK;
+  gboolean parallel = FALSE;
 
-  if (dec->cinfo.jpeg_color_space == JCS_RGB) {
+  if (!dec->cinfo.raw_data_out
+#ifdef JCS_EXTENSIONS
+      && !dec->format_convert
+#endif
+      ) {
+    gst_jpeg_dec_decode_scanlines (dec, vframe);
+  } else if (dec->cinfo.jpeg_color_space == JCS_RGB) {
     gst_jpeg_dec_decode_rgb (dec, vframe, field, num_fields);
   } else if (dec->cinfo.jpeg_color_space == JCS_GRAYSCALE) {
     gst_jpeg_dec_decode_grayscale (dec, vframe, field, num_fields);
@@ -1317,13 +1697,19 @@ gst_jpeg_dec_decode (GstJpegDec * dec, GstVideoFrame * vframe, guint width,
           dec->cinfo.comp_info[0].h_samp_factor, dec->cinfo.num_components,
           field, num_fields);
     } else {
-      ret = gst_jpeg_dec_decode_direct (dec, vframe, field, num_fields);
+      gst_jpeg_dec_ensure_scratch (dec, vframe, num_fields);
+      if (num_fields == 1 && gst_jpeg_dec_decode_parallel (dec, vframe, &ret))
+        parallel = TRUE;
+      else
+        ret = gst_jpeg_dec_decode_direct (dec, &dec->cinfo, vframe, field,
+            num_fields, 0, GST_VIDEO_FRAME_HEIGHT (vframe));
     }
   }
 
   GST_LOG_OBJECT (dec, "decompressing finished: %s", gst_flow_get_name (ret));
 
-  if (G_UNLIKELY (ret != GST_FLOW_OK)) {
+  /* the slices were decoded from the frame, not by the main decompressor */
+  if (G_UNLIKELY (ret != GST_FLOW_OK) || parallel) {
     jpeg_abort_decompress (&dec->cinfo);
   } else {
     jpeg_finish_decompress (&dec->cinfo);
@@ -1406,7 +1792,7 @@ gst_jpeg_dec_handle_frame (GstVideoDecoder * bdec, GstVideoCodecFrame * frame)
   /* is it interlaced MJPEG? (we really don't want to scan the jpeg data
    * to see if there are two SOF markers in the packet to detect this) */
   if (gst_video_decoder_get_packetized (bdec) &&
-      dec->input_state &&
+      dec->cinfo.scale_denom == 1 && dec->input_state &&
       dec->input_state->info.height > height &&
       dec->input_state->info.height <= (height * 2)
       && dec->input_state->info.width == width) {
@@ -1695,6 +2081,14 @@ gst_jpeg_dec_set_property (GObject * object, guint prop_id,
       g_atomic_int_set (&dec->max_errors, g_value_get_int (value));
       break;
 #endif
+    case PROP_DOWNSCALE:
+      dec->downscale = g_value_get_uint (value);
+      break;
+    case PROP_MAX_THREADS:
+      GST_OBJECT_LOCK (dec);
+      dec->max_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (dec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1718,6 +2112,14 @@ gst_jpeg_dec_get_property (GObject * object, guint prop_id, GValue * value,
       g_value_set_int (value, g_atomic_int_get (&dec->max_errors));
       break;
 #endif
+    case PROP_DOWNSCALE:
+      g_value_set_uint (value, dec->downscale);
+      break;
+    case PROP_MAX_THREADS:
+      GST_OBJECT_LOCK (dec);
+      g_value_set_uint (value, dec->max_threads);
+      GST_OBJECT_UNLOCK (dec);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1730,6 +2132,7 @@ gst_jpeg_dec_stop (GstVideoDecoder * bdec)
   GstJpegDec *dec = (GstJpegDec *) bdec;
 
   gst_jpeg_dec_free_buffers (dec);
+  gst_jpeg_dec_free_slices (dec);
 
   g_free (dec->scratch);
   dec->scratch = NULL;
@@ -52,6 +52,7 @@ G_BEGIN_DECLS
 
 typedef struct _GstJpegDec           GstJpegDec;
 typedef struct _GstJpegDecClass      GstJpegDecClass;
+typedef struct _GstJpegDecSlice      GstJpegDecSlice;
 
 struct GstJpegDecErrorMgr {
   struct jpeg_error_mgr    pub;   /* public fields */
@@ -63,6 +64,27 @@ struct GstJpegDecSourceMgr {
   GstJpegDec              *dec;
 };
 
+/* consecutive restart intervals, decoded as a separate image */
+struct _GstJpegDecSlice {
+  /* must be first, the source manager gets the slice from it */
+  struct jpeg_decompress_struct cinfo;
+  struct GstJpegDecErrorMgr     jerr;
+  struct GstJpegDecSourceMgr    jsrc;
+
+  /* the frame headers, with the height of the slice */
+  guint8       *header;
+  gsize         header_size;
+  gsize         header_alloc;
+  /* the entropy coded data of the slice */
+  const guint8 *data;
+  gsize         size;
+  gint          chunk;
+
+  GstVideoFrame *frame;
+  guint         first_row;
+  gboolean      failed;
+};
+
 /* Can't use GstBaseTransform, because GstBaseTransform
  * doesn't handle the N buffers in, 1 buffer out case,
  * but only the 1-in 1-out case */
@@ -89,6 +111,15 @@ struct _GstJpegDec {
   /* properties */
   gint     idct_method;
   gint     max_errors;  /* ATOMIC */
+  guint    downscale;
+  guint    max_threads;
+
+  /* parallel decoding */
+  GstTaskPool *pool;
+  guint    n_threads;
+  GstJpegDecSlice *slices;
+  guint    n_slices;
+  GArray  *restarts;
 
   struct jpeg_decompress_struct cinfo;
   struct GstJpegDecErrorMgr     jerr;
@@ -56,6 +56,7 @@ GST_DEBUG_CATEGORY_STATIC (jpegenc_debug);
 #define JPEG_DEFAULT_SMOOTHING 0
 #define JPEG_DEFAULT_IDCT_METHOD	JDCT_FASTEST
 #define JPEG_DEFAULT_SNAPSHOT		FALSE
+#define JPEG_DEFAULT_MAX_THREADS	1
 
 /* JpegEnc signals and args */
 enum
@@ -70,7 +71,8 @@ enum
   PROP_QUALITY,
   PROP_SMOOTHING,
   PROP_IDCT_METHOD,
-  PROP_SNAPSHOT
+  PROP_SNAPSHOT,
+  PROP_MAX_THREADS
 };
 
 static void gst_jpegenc_finalize (GObject * object);
@@ -167,6 +169,23 @@ gst_jpegenc_class_init (GstJpegEncClass * klass)
           "Send EOS after encoding a frame, useful for snapshots",
           JPEG_DEFAULT_SNAPSHOT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstJpegEnc:max-threads:
+   *
+   * The maximum number of threads a frame is encoded with, 0 for the number
+   * of processors. With more than one thread the frame is split in
+   * horizontal slices that are encoded in parallel, and the output has a
+   * restart marker after each row of blocks, which also lets decoders work
+   * on them in parallel.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_uint ("max-threads", "Max Threads",
+          "Maximum number of threads to use (0 = number of processors)", 0,
+          G_MAXINT, JPEG_DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (element_class,
       &gst_jpegenc_sink_pad_template);
   gst_element_class_add_static_pad_template (element_class,
@@ -243,12 +262,11 @@ gst_jpegenc_flush_destination (j_compress_ptr cinfo)
   return TRUE;
 }
 
+/* pushes the image written to output_mem */
 static void
-gst_jpegenc_term_destination (j_compress_ptr cinfo)
+gst_jpegenc_finish_output (GstJpegEnc * jpegenc, gsize memory_size)
 {
   GstBuffer *outbuf;
-  GstJpegEnc *jpegenc = (GstJpegEnc *) (cinfo->client_data);
-  gsize memory_size = jpegenc->output_map.size - jpegenc->jdest.free_in_buffer;
   GstByteReader reader =
       GST_BYTE_READER_INIT (jpegenc->output_map.data, memory_size);
   guint16 marker;
@@ -297,6 +315,46 @@ gst_jpegenc_term_destination (j_compress_ptr cinfo)
   jpegenc->current_frame = NULL;
 }
 
+static void
+gst_jpegenc_term_destination (j_compress_ptr cinfo)
+{
+  GstJpegEnc *jpegenc = (GstJpegEnc *) (cinfo->client_data);
+
+  gst_jpegenc_finish_output (jpegenc,
+      jpegenc->output_map.size - jpegenc->jdest.free_in_buffer);
+}
+
+static void
+gst_jpegenc_slice_init_destination (j_compress_ptr cinfo)
+{
+  GstJpegEncSlice *slice = (GstJpegEncSlice *) (cinfo->client_data);
+
+  slice->jdest.next_output_byte = slice->data;
+  slice->jdest.free_in_buffer = slice->alloc_size;
+}
+
+static boolean
+gst_jpegenc_slice_flush_destination (j_compress_ptr cinfo)
+{
+  GstJpegEncSlice *slice = (GstJpegEncSlice *) (cinfo->client_data);
+  gsize old_size = slice->alloc_size;
+
+  slice->alloc_size *= 2;
+  slice->data = g_realloc (slice->data, slice->alloc_size);
+  slice->jdest.next_output_byte = slice->data + old_size;
+  slice->jdest.free_in_buffer = slice->alloc_size - old_size;
+
+  return TRUE;
+}
+
+static void
+gst_jpegenc_slice_term_destination (j_compress_ptr cinfo)
+{
+  GstJpegEncSlice *slice = (GstJpegEncSlice *) (cinfo->client_data);
+
+  slice->size = slice->alloc_size - slice->jdest.free_in_buffer;
+}
+
 static void
 gst_jpegenc_init (GstJpegEnc * jpegenc)
 {
@@ -319,6 +377,97 @@ gst_jpegenc_init (GstJpegEnc * jpegenc)
   jpegenc->smoothing = JPEG_DEFAULT_SMOOTHING;
   jpegenc->idct_method = JPEG_DEFAULT_IDCT_METHOD;
   jpegenc->snapshot = JPEG_DEFAULT_SNAPSHOT;
+  jpegenc->max_threads = JPEG_DEFAULT_MAX_THREADS;
+  jpegenc->n_threads = 1;
+}
+
+static void
+gst_jpegenc_free_slices (GstJpegEnc * jpegenc)
+{
+  guint i, j, k;
+
+  for (i = 0; i < jpegenc->n_slices; i++) {
+    GstJpegEncSlice *slice = &jpegenc->slices[i];
+
+    jpeg_destroy_compress (&slice->cinfo);
+    g_free (slice->data);
+    for (k = 0; k < 3; k++) {
+      g_free (slice->line[k]);
+      for (j = 0; j < 4 * DCTSIZE; j++)
+        g_free (slice->row[k][j]);
+    }
+  }
+
+  g_free (jpegenc->slices);
+  jpegenc->slices = NULL;
+  jpegenc->n_slices = 0;
+  jpegenc->slice_rows = 0;
+}
+
+/* every slice but the last one has @slice_rows lines, a multiple of the MCU
+ * height */
+static void
+gst_jpegenc_setup_slices (GstJpegEnc * jpegenc, guint n_slices,
+    gint slice_rows)
+{
+  GstVideoInfo *info = &jpegenc->input_state->info;
+  gint width = GST_VIDEO_INFO_WIDTH (info);
+  gint height = GST_VIDEO_INFO_HEIGHT (info);
+  guint i;
+  gint j, k;
+
+  if (jpegenc->n_slices == n_slices && jpegenc->slice_rows == slice_rows)
+    return;
+
+  gst_jpegenc_free_slices (jpegenc);
+
+  GST_DEBUG_OBJECT (jpegenc, "encoding in %u slices of %d lines", n_slices,
+      slice_rows);
+
+  jpegenc->slices = g_new0 (GstJpegEncSlice, n_slices);
+  jpegenc->n_slices = n_slices;
+  jpegenc->slice_rows = slice_rows;
+
+  for (i = 0; i < n_slices; i++) {
+    GstJpegEncSlice *slice = &jpegenc->slices[i];
+    struct jpeg_compress_struct *cinfo = &slice->cinfo;
+
+    slice->enc = jpegenc;
+    slice->first_row = i * slice_rows;
+    slice->n_rows = MIN (slice_rows, height - slice->first_row);
+    slice->alloc_size = MAX (GST_ROUND_UP_4 (jpegenc->bufsize / n_slices),
+        4096);
+    slice->data = g_malloc (slice->alloc_size);
+
+    cinfo->err = jpeg_std_error (&slice->jerr);
+    jpeg_create_compress (cinfo);
+
+    slice->jdest.init_destination = gst_jpegenc_slice_init_destination;
+    slice->jdest.empty_output_buffer = gst_jpegenc_slice_flush_destination;
+    slice->jdest.term_destination = gst_jpegenc_slice_term_destination;
+    cinfo->dest = &slice->jdest;
+    cinfo->client_data = slice;
+
+    cinfo->image_width = width;
+    cinfo->image_height = slice->n_rows;
+    cinfo->input_components = jpegenc->channels;
+    cinfo->in_color_space = jpegenc->cinfo.in_color_space;
+    jpeg_set_defaults (cinfo);
+    cinfo->raw_data_in = TRUE;
+    if (cinfo->in_color_space == JCS_RGB)
+      jpeg_set_colorspace (cinfo, JCS_RGB);
+    cinfo->restart_in_rows = 1;
+
+    for (k = 0; k < jpegenc->channels; k++) {
+      cinfo->comp_info[k].h_samp_factor = jpegenc->h_samp[k];
+      cinfo->comp_info[k].v_samp_factor = jpegenc->v_samp[k];
+      slice->line[k] = g_new (guchar *, jpegenc->v_max_samp * DCTSIZE);
+      if (jpegenc->inc[k] != 1) {
+        for (j = 0; j < jpegenc->v_max_samp * DCTSIZE; j++)
+          slice->row[k][j] = g_malloc (width);
+      }
+    }
+  }
 }
 
 static void
@@ -327,6 +476,8 @@ gst_jpegenc_finalize (GObject * object)
   GstJpegEnc *filter = GST_JPEGENC (object);
 
   jpeg_destroy_compress (&filter->cinfo);
+  gst_jpegenc_free_slices (filter);
+  gst_jpeg_task_pool_free (filter->pool);
 
   if (filter->input_state)
     gst_video_codec_state_unref (filter->input_state);
@@ -376,8 +527,6 @@ gst_jpegenc_set_format (GstVideoEncoder * encoder, GstVideoCodecState * state)
     enc->h_samp[i] = enc->h_max_samp / enc->h_samp[i];
     enc->v_samp[i] = enc->v_max_samp / enc->v_samp[i];
   }
-  enc->planar = (enc->inc[0] == 1 && enc->inc[1] == 1 && enc->inc[2] == 1);
-
   enc->input_caps_changed = TRUE;
   gst_jpegenc_resync (enc);
 
@@ -434,7 +583,7 @@ gst_jpegenc_resync (GstJpegEnc * jpegenc)
     jpegenc->cinfo.comp_info[i].v_samp_factor = jpegenc->v_samp[i];
     g_free (jpegenc->line[i]);
     jpegenc->line[i] = g_new (guchar *, jpegenc->v_max_samp * DCTSIZE);
-    if (!jpegenc->planar) {
+    if (jpegenc->inc[i] != 1) {
       for (j = 0; j < jpegenc->v_max_samp * DCTSIZE; j++) {
         g_free (jpegenc->row[i][j]);
         jpegenc->row[i][j] = g_malloc (width);
@@ -449,17 +598,158 @@ gst_jpegenc_resync (GstJpegEnc * jpegenc)
 
   jpeg_suppress_tables (&jpegenc->cinfo, TRUE);
 
+  gst_jpegenc_free_slices (jpegenc);
+
   GST_DEBUG_OBJECT (jpegenc, "resync done");
 }
 
+/* feeds @n_rows lines of the frame starting at @first_row, a multiple of the
+ * MCU height, to the compressor */
+static void
+gst_jpegenc_write_rows (GstJpegEnc * jpegenc, j_compress_ptr cinfo,
+    guchar ** line[3], guchar * row[3][4 * DCTSIZE], GstVideoFrame * vframe,
+    gint first_row, gint n_rows)
+{
+  guchar *base[3], *end[3];
+  guint stride[3];
+  gint i, j, k;
+
+  for (k = 0; k < jpegenc->channels; k++) {
+    stride[k] = GST_VIDEO_FRAME_COMP_STRIDE (vframe, k);
+    base[k] = GST_VIDEO_FRAME_COMP_DATA (vframe, k) +
+        (first_row * jpegenc->v_samp[k] / jpegenc->v_max_samp) * stride[k];
+    end[k] = GST_VIDEO_FRAME_COMP_DATA (vframe, k) +
+        GST_VIDEO_FRAME_COMP_HEIGHT (vframe, k) * stride[k];
+  }
+
+  for (i = 0; i < n_rows; i += jpegenc->v_max_samp * DCTSIZE) {
+    for (k = 0; k < jpegenc->channels; k++) {
+      for (j = 0; j < jpegenc->v_samp[k] * DCTSIZE; j++) {
+        if (jpegenc->inc[k] == 1) {
+          /* planar components, like the luma of NV12, are used in place */
+          line[k][j] = base[k];
+        } else {
+          guchar *src, *dst;
+          gint l;
+
+          /* ouch, copy line */
+          src = base[k];
+          dst = row[k][j];
+          for (l = jpegenc->cwidth[k]; l > 0; l--) {
+            *dst = *src;
+            src += jpegenc->inc[k];
+            dst++;
+          }
+          line[k][j] = row[k][j];
+        }
+        if (base[k] + stride[k] < end[k])
+          base[k] += stride[k];
+      }
+    }
+    jpeg_write_raw_data (cinfo, line, jpegenc->v_max_samp * DCTSIZE);
+  }
+}
+
+static void
+gst_jpegenc_encode_slice (GstJpegEncSlice * slice)
+{
+  GstJpegEnc *jpegenc = slice->enc;
+
+  jpeg_start_compress (&slice->cinfo, TRUE);
+  gst_jpegenc_write_rows (jpegenc, &slice->cinfo, slice->line, slice->row,
+      &jpegenc->current_vframe, slice->first_row, slice->n_rows);
+  jpeg_finish_compress (&slice->cinfo);
+}
+
+/* returns the offset of the entropy coded data of an image written by
+ * libjpeg, or 0 if it has no SOS marker */
+static gsize
+gst_jpegenc_parse_headers (const guint8 * data, gsize size, gsize * sof)
+{
+  gsize pos = 2;
+
+  while (pos + 4 <= size && data[pos] == 0xff) {
+    guint8 marker = data[pos + 1];
+    gsize len = GST_READ_UINT16_BE (data + pos + 2);
+
+    if (marker >= 0xc0 && marker <= 0xc2 && sof)
+      *sof = pos;
+    if (marker == 0xda)
+      return pos + 2 + len;
+    pos += 2 + len;
+  }
+
+  return 0;
+}
+
+/* The slices are encoded with the same tables and a restart marker after
+ * each MCU row, and start at multiples of 8 MCU rows. So they are the
+ * restart intervals of the whole image, numbered as in it, and the image is
+ * the headers of the first slice with the full height, followed by the
+ * entropy coded data of all the slices separated by restart markers. */
+static gboolean
+gst_jpegenc_assemble_slices (GstJpegEnc * jpegenc)
+{
+  static GstAllocationParams params = { 0, 3, 0, 0, };
+  GstJpegEncSlice *first = &jpegenc->slices[0];
+  gint slice_mcu_rows = jpegenc->slice_rows / (jpegenc->v_max_samp * DCTSIZE);
+  gsize sof = 0, size;
+  guint8 *out;
+  guint i;
+
+  first->entropy_offset =
+      gst_jpegenc_parse_headers (first->data, first->size, &sof);
+  if (!first->entropy_offset || !sof)
+    return FALSE;
+
+  /* headers, and an RST or EOI marker after each slice */
+  size = first->entropy_offset;
+  for (i = 0; i < jpegenc->n_slices; i++) {
+    GstJpegEncSlice *slice = &jpegenc->slices[i];
+
+    if (i > 0)
+      slice->entropy_offset =
+          gst_jpegenc_parse_headers (slice->data, slice->size, NULL);
+    if (!slice->entropy_offset || slice->size < slice->entropy_offset + 2)
+      return FALSE;
+    size += slice->size - slice->entropy_offset;
+  }
+
+  jpegenc->output_mem = gst_allocator_alloc (NULL, size, &params);
+  gst_memory_map (jpegenc->output_mem, &jpegenc->output_map, GST_MAP_READWRITE);
+  out = jpegenc->output_map.data;
+
+  memcpy (out, first->data, first->entropy_offset);
+  GST_WRITE_UINT16_BE (out + sof + 5,
+      GST_VIDEO_INFO_HEIGHT (&jpegenc->input_state->info));
+  out += first->entropy_offset;
+
+  for (i = 0; i < jpegenc->n_slices; i++) {
+    GstJpegEncSlice *slice = &jpegenc->slices[i];
+    gsize len = slice->size - slice->entropy_offset - 2;
+
+    memcpy (out, slice->data + slice->entropy_offset, len);
+    out += len;
+    out[0] = 0xff;
+    out[1] = (i + 1 < jpegenc->n_slices) ?
+        0xd0 + ((i + 1) * slice_mcu_rows - 1) % 8 : 0xd9;
+    out += 2;
+  }
+
+  gst_jpegenc_finish_output (jpegenc, size);
+
+  return TRUE;
+}
+
 static GstFlowReturn
 gst_jpegenc_handle_frame (GstVideoEncoder * encoder, GstVideoCodecFrame * frame)
 {
   GstJpegEnc *jpegenc;
   guint height;
-  guchar *base[3], *end[3];
-  guint stride[3];
-  gint i, j, k;
+  gint quality, smoothing, idct_method;
+  guint max_threads, n_slices = 1;
+  gint mcu_height, mcu_rows, slice_mcu_rows = 0;
+  guint i;
   static GstAllocationParams params = { 0, 0, 0, 3, };
 
   jpegenc = GST_JPEGENC (encoder);
@@ -474,15 +764,76 @@ gst_jpegenc_handle_frame (GstVideoEncoder * encoder, GstVideoCodecFrame * frame)
 
   height = GST_VIDEO_INFO_HEIGHT (&jpegenc->input_state->info);
 
-  for (i = 0; i < jpegenc->channels; i++) {
-    base[i] = GST_VIDEO_FRAME_COMP_DATA (&jpegenc->current_vframe, i);
-    stride[i] = GST_VIDEO_FRAME_COMP_STRIDE (&jpegenc->current_vframe, i);
-    end[i] =
-        base[i] + GST_VIDEO_FRAME_COMP_HEIGHT (&jpegenc->current_vframe,
-        i) * stride[i];
+  jpegenc->res = GST_FLOW_OK;
+
+  GST_OBJECT_LOCK (jpegenc);
+  smoothing = jpegenc->smoothing;
+  idct_method = jpegenc->idct_method;
+  quality = jpegenc->quality;
+  max_threads = jpegenc->max_threads;
+  GST_OBJECT_UNLOCK (jpegenc);
+
+  if (max_threads == 0)
+    max_threads = g_get_num_processors ();
+  if (max_threads != jpegenc->n_threads) {
+    gst_jpeg_task_pool_free (jpegenc->pool);
+    jpegenc->pool = gst_jpeg_task_pool_new (max_threads);
+    jpegenc->n_threads = max_threads;
+  }
+
+  /* split the frame in slices of multiples of 8 MCU rows, see
+   * gst_jpegenc_assemble_slices() */
+  mcu_height = jpegenc->v_max_samp * DCTSIZE;
+  mcu_rows = (height + mcu_height - 1) / mcu_height;
+  if (jpegenc->pool) {
+    slice_mcu_rows = GST_ROUND_UP_8 ((mcu_rows + max_threads - 1) /
+        max_threads);
+    n_slices = (mcu_rows + slice_mcu_rows - 1) / slice_mcu_rows;
+  }
+
+  if (n_slices > 1) {
+    gpointer *ids;
+
+    gst_jpegenc_setup_slices (jpegenc, n_slices, slice_mcu_rows * mcu_height);
+
+    for (i = 0; i < n_slices; i++) {
+      struct jpeg_compress_struct *cinfo = &jpegenc->slices[i].cinfo;
+
+#if JPEG_LIB_VERSION >= 70
+      cinfo->do_fancy_downsampling = FALSE;
+#endif
+      cinfo->smoothing_factor = smoothing;
+      cinfo->dct_method = idct_method;
+      jpeg_set_quality (cinfo, quality, TRUE);
+    }
+
+    GST_LOG_OBJECT (jpegenc, "compressing %u slices", n_slices);
+
+    /* the first slice is done in the current thread */
+    ids = g_newa (gpointer, n_slices);
+    for (i = 1; i < n_slices; i++) {
+      ids[i] = gst_task_pool_push (jpegenc->pool,
+          (GstTaskPoolFunction) gst_jpegenc_encode_slice,
+          &jpegenc->slices[i], NULL);
+      if (ids[i] == NULL)
+        gst_jpegenc_encode_slice (&jpegenc->slices[i]);
+    }
+
+    gst_jpegenc_encode_slice (&jpegenc->slices[0]);
+
+    for (i = 1; i < n_slices; i++) {
+      if (ids[i])
+        gst_task_pool_join (jpegenc->pool, ids[i]);
+    }
+
+    if (!gst_jpegenc_assemble_slices (jpegenc))
+      goto assemble_failed;
+
+    GST_LOG_OBJECT (jpegenc, "compressing done");
+
+    return (jpegenc->snapshot) ? GST_FLOW_EOS : jpegenc->res;
   }
 
-  jpegenc->res = GST_FLOW_OK;
   jpegenc->output_mem = gst_allocator_alloc (NULL, jpegenc->bufsize, &params);
   gst_memory_map (jpegenc->output_mem, &jpegenc->output_map, GST_MAP_READWRITE);
 
@@ -494,51 +845,16 @@ gst_jpegenc_handle_frame (GstVideoEncoder * encoder, GstVideoCodecFrame * frame)
   jpegenc->cinfo.do_fancy_downsampling = FALSE;
 #endif
 
-  GST_OBJECT_LOCK (jpegenc);
-  jpegenc->cinfo.smoothing_factor = jpegenc->smoothing;
-  jpegenc->cinfo.dct_method = jpegenc->idct_method;
-  jpeg_set_quality (&jpegenc->cinfo, jpegenc->quality, TRUE);
-  GST_OBJECT_UNLOCK (jpegenc);
+  jpegenc->cinfo.smoothing_factor = smoothing;
+  jpegenc->cinfo.dct_method = idct_method;
+  jpeg_set_quality (&jpegenc->cinfo, quality, TRUE);
 
   jpeg_start_compress (&jpegenc->cinfo, TRUE);
 
   GST_LOG_OBJECT (jpegenc, "compressing");
 
-  if (jpegenc->planar) {
-    for (i = 0; i < height; i += jpegenc->v_max_samp * DCTSIZE) {
-      for (k = 0; k < jpegenc->channels; k++) {
-        for (j = 0; j < jpegenc->v_samp[k] * DCTSIZE; j++) {
-          jpegenc->line[k][j] = base[k];
-          if (base[k] + stride[k] < end[k])
-            base[k] += stride[k];
-        }
-      }
-      jpeg_write_raw_data (&jpegenc->cinfo, jpegenc->line,
-          jpegenc->v_max_samp * DCTSIZE);
-    }
-  } else {
-    for (i = 0; i < height; i += jpegenc->v_max_samp * DCTSIZE) {
-      for (k = 0; k < jpegenc->channels; k++) {
-        for (j = 0; j < jpegenc->v_samp[k] * DCTSIZE; j++) {
-          guchar *src, *dst;
-          gint l;
-
-          /* ouch, copy line */
-          src = base[k];
-          dst = jpegenc->line[k][j];
-          for (l = jpegenc->cwidth[k]; l > 0; l--) {
-            *dst = *src;
-            src += jpegenc->inc[k];
-            dst++;
-          }
-          if (base[k] + stride[k] < end[k])
-            base[k] += stride[k];
-        }
-      }
-      jpeg_write_raw_data (&jpegenc->cinfo, jpegenc->line,
-          jpegenc->v_max_samp * DCTSIZE);
-    }
-  }
+  gst_jpegenc_write_rows (jpegenc, &jpegenc->cinfo, jpegenc->line,
+      jpegenc->row, &jpegenc->current_vframe, 0, height);
 
   /* This will ensure that gst_jpegenc_term_destination is called */
   jpeg_finish_compress (&jpegenc->cinfo);
@@ -551,6 +867,15 @@ invalid_frame:
     GST_WARNING_OBJECT (jpegenc, "invalid frame received");
     return gst_video_encoder_finish_frame (encoder, frame);
   }
+assemble_failed:
+  {
+    gst_video_frame_unmap (&jpegenc->current_vframe);
+    jpegenc->current_frame = NULL;
+    GST_ELEMENT_ERROR (jpegenc, STREAM, ENCODE, (NULL),
+        ("Failed to assemble the encoded slices"));
+    gst_video_encoder_finish_frame (encoder, frame);
+    return GST_FLOW_ERROR;
+  }
 }
 
 static gboolean
@@ -585,6 +910,9 @@ gst_jpegenc_set_property (GObject * object, guint prop_id,
     case PROP_SNAPSHOT:
       jpegenc->snapshot = g_value_get_boolean (value);
       break;
+    case PROP_MAX_THREADS:
+      jpegenc->max_threads = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -616,6 +944,9 @@ gst_jpegenc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_SNAPSHOT:
       g_value_set_boolean (value, jpegenc->snapshot);
       break;
+    case PROP_MAX_THREADS:
+      g_value_set_uint (value, jpegenc->max_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -655,6 +986,7 @@ gst_jpegenc_stop (GstVideoEncoder * benc)
       enc->row[i][j] = NULL;
     }
   }
+  gst_jpegenc_free_slices (enc);
 
   return TRUE;
 }
@@ -48,6 +48,31 @@ G_BEGIN_DECLS
 
 typedef struct _GstJpegEnc GstJpegEnc;
 typedef struct _GstJpegEncClass GstJpegEncClass;
+typedef struct _GstJpegEncSlice GstJpegEncSlice;
+
+/* a horizontal slice of the frame, encoded as a separate image */
+struct _GstJpegEncSlice
+{
+  GstJpegEnc *enc;
+
+  struct jpeg_compress_struct cinfo;
+  struct jpeg_error_mgr jerr;
+  struct jpeg_destination_mgr jdest;
+
+  gint first_row;
+  gint n_rows;
+
+  /* the jpeg line buffer */
+  guchar **line[3];
+  /* indirect encoding line buffers */
+  guchar *row[3][4 * DCTSIZE];
+
+  /* the encoded image */
+  guint8 *data;
+  gsize size;
+  gsize alloc_size;
+  gsize entropy_offset;
+};
 
 struct _GstJpegEnc
 {
@@ -69,7 +94,6 @@ struct _GstJpegEnc
   gint v_samp[GST_VIDEO_MAX_COMPONENTS];
   gint h_max_samp;
   gint v_max_samp;
-  gboolean planar;
   gint sof_marker;
   /* the video buffer */
   gint bufsize;
@@ -87,6 +111,14 @@ struct _GstJpegEnc
   gint smoothing;
   gint idct_method;
   gboolean snapshot;
+  guint max_threads;
+
+  /* parallel encoding */
+  GstTaskPool *pool;
+  guint n_threads;
+  GstJpegEncSlice *slices;
+  guint n_slices;
+  gint slice_rows;
 
   GstMemory *output_mem;
   GstMapInfo output_map;
@@ -66,6 +66,13 @@
  * on the JPEG-encoded video frame buffers. This allows the Matroska
  * multiplexer to timestamp the frames in the resulting file.
  *
+ * Sources that use the default connection settings share their HTTP session,
+ * and therefore their persistent connections, with the other sources of the
+ * same pipeline through a #GstContext of type "gst.soup.session". Since 1.24,
+ * sources with #GstSoupHTTPSrc:share-session set also share one session with
+ * the other such sources of the whole process when no context provides one,
+ * so that connections to the same server are reused across pipelines.
+ *
  */
 
 #ifdef HAVE_CONFIG_H
@@ -165,6 +172,12 @@ GST_DEBUG_CATEGORY_STATIC (souphttpsrc_debug);
 
 #define GST_SOUP_SESSION_CONTEXT "gst.soup.session"
 
+/* session of the sources with share-session set that did not get one from a
+ * context. Only a weak reference is kept so that it goes away with its last
+ * user */
+G_LOCK_DEFINE_STATIC (default_session);
+static GWeakRef default_session;
+
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
     GST_PAD_SRC,
     GST_PAD_ALWAYS,
@@ -196,6 +209,7 @@ enum
   PROP_RETRIES,
   PROP_METHOD,
   PROP_TLS_INTERACTION,
+  PROP_SHARE_SESSION,
 };
 
 #define DEFAULT_USER_AGENT           "GStreamer souphttpsrc " PACKAGE_VERSION " "
@@ -211,6 +225,7 @@ enum
 #define DEFAULT_TIMEOUT              15
 #define DEFAULT_RETRIES              3
 #define DEFAULT_SOUP_METHOD          NULL
+#define DEFAULT_SHARE_SESSION        FALSE
 
 #define GROW_BLOCKSIZE_LIMIT 1
 #define GROW_BLOCKSIZE_COUNT 1
@@ -497,6 +512,25 @@ gst_soup_http_src_class_init (GstSoupHTTPSrcClass * klass)
           "The HTTP method to use (GET, HEAD, OPTIONS, etc)",
           DEFAULT_SOUP_METHOD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+ /**
+   * GstSoupHTTPSrc:share-session:
+   *
+   * Share the HTTP session, and therefore the persistent connections, with
+   * the other sources of the process that have this property set, if the
+   * connection settings of this source allow sharing and no session is
+   * provided through a #GstContext. The session is freed together with its
+   * last user.
+   *
+   * Cookies set by the servers are not kept in such a session, as it is used
+   * by unrelated pipelines.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_SHARE_SESSION,
+      g_param_spec_boolean ("share-session", "Share session",
+          "Share the HTTP session with the other sources of the process",
+          DEFAULT_SHARE_SESSION, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &srctemplate);
 
   gst_element_class_set_static_metadata (gstelement_class, "HTTP client source",
@@ -582,6 +616,7 @@ gst_soup_http_src_init (GstSoupHTTPSrc * src)
   src->tls_interaction = DEFAULT_TLS_INTERACTION;
   src->max_retries = DEFAULT_RETRIES;
   src->method = DEFAULT_SOUP_METHOD;
+  src->share_session = DEFAULT_SHARE_SESSION;
   src->minimum_blocksize = gst_base_src_get_blocksize (GST_BASE_SRC_CAST (src));
   proxy = g_getenv ("http_proxy");
   if (!gst_soup_http_src_set_proxy (src, proxy)) {
@@ -754,6 +789,9 @@ gst_soup_http_src_set_property (GObject * object, guint prop_id,
       g_free (src->method);
       src->method = g_value_dup_string (value);
       break;
+    case PROP_SHARE_SESSION:
+      src->share_session = g_value_get_boolean (value);
+      break;
     case PROP_SSL_CA_FILE:
       if (gst_soup_loader_get_api_version () == 2) {
         g_free (src->ssl_ca_file);
@@ -849,6 +887,9 @@ gst_soup_http_src_get_property (GObject * object, guint prop_id,
     case PROP_METHOD:
       g_value_set_string (value, src->method);
       break;
+    case PROP_SHARE_SESSION:
+      g_value_set_boolean (value, src->share_session);
+      break;
     case PROP_SSL_CA_FILE:
       if (gst_soup_loader_get_api_version () == 2)
         g_value_set_string (value, src->ssl_ca_file);
@@ -1028,8 +1069,10 @@ thread_func (gpointer user_data)
     _soup_session_add_feature_by_type (session->session,
         _soup_content_decoder_get_type ());
   }
-  _soup_session_add_feature_by_type (session->session,
-      _soup_cookie_jar_get_type ());
+  /* unrelated pipelines must not see each other's cookies */
+  if (!src->session_is_process_wide)
+    _soup_session_add_feature_by_type (session->session,
+        _soup_cookie_jar_get_type ());
 
   /* soup2: connect the authenticate handler for the src that spawned the
    * session (i.e. the first owner); other users of this session will connect
@@ -1098,6 +1141,7 @@ gst_soup_http_src_session_open (GstSoupHTTPSrc * src)
 {
   GstQuery *query;
   gboolean can_share;
+  GstSoupSession *shared_session = NULL;
 
   if (src->session) {
     GST_DEBUG_OBJECT (src, "Session is already open");
@@ -1139,10 +1183,27 @@ gst_soup_http_src_session_open (GstSoupHTTPSrc * src)
   GST_OBJECT_LOCK (src);
 
   src->session_is_shared = can_share;
+  /* the first user sets up the logger of the process-wide session, so only
+   * sources with the default log level can use it */
+  src->session_is_process_wide = can_share && src->share_session
+      && !src->external_session && src->log_level == DEFAULT_SOUP_LOG_LEVEL;
 
-  if (src->external_session && can_share) {
+  if (can_share && src->external_session) {
     GST_DEBUG_OBJECT (src, "Using external session %p", src->external_session);
-    src->session = g_object_ref (src->external_session);
+    shared_session = g_object_ref (src->external_session);
+  } else if (src->session_is_process_wide) {
+    /* keep the lock until the new session is registered below, so that
+     * concurrent sources don't create a session each */
+    G_LOCK (default_session);
+    shared_session = g_weak_ref_get (&default_session);
+    if (shared_session) {
+      GST_DEBUG_OBJECT (src, "Using process-wide session %p", shared_session);
+      G_UNLOCK (default_session);
+    }
+  }
+
+  if (shared_session) {
+    src->session = shared_session;
     /* for soup2, connect another authenticate handler; see thread_func */
     if (gst_soup_loader_get_api_version () < 3) {
       g_signal_connect (src->session->session, "authenticate",
@@ -1169,6 +1230,8 @@ gst_soup_http_src_session_open (GstSoupHTTPSrc * src)
         thread_func, src, NULL);
 
     if (!src->session->thread) {
+      if (src->session_is_process_wide)
+        G_UNLOCK (default_session);
       goto err;
     }
 
@@ -1181,6 +1244,11 @@ gst_soup_http_src_session_open (GstSoupHTTPSrc * src)
     while (!g_main_loop_is_running (src->session->loop))
       g_cond_wait (&src->session_cond, &src->session_mutex);
     GST_DEBUG_OBJECT (src, "Soup thread started");
+
+    if (src->session_is_process_wide) {
+      g_weak_ref_set (&default_session, src->session);
+      G_UNLOCK (default_session);
+    }
   }
 
   GST_OBJECT_UNLOCK (src);
@@ -64,6 +64,8 @@ struct _GstSoupHTTPSrc {
   gchar **cookies;             /* HTTP request cookies. */
   GstSoupSession *session;     /* Libsoup session wrapper. */
   gboolean session_is_shared;
+  gboolean share_session;      /* Use the process-wide session */
+  gboolean session_is_process_wide;
   GstSoupSession *external_session; /* Shared via GstContext */
   SoupMessage *msg;            /* Request message. */
   gint retry_count;            /* Number of retries since we received data */
@@ -366,6 +366,8 @@ static GstFlowReturn gst_vpx_enc_handle_frame (GstVideoEncoder *
     video_encoder, GstVideoCodecFrame * frame);
 static gboolean gst_vpx_enc_sink_event (GstVideoEncoder *
     video_encoder, GstEvent * event);
+static gboolean gst_vpx_enc_src_event (GstVideoEncoder *
+    video_encoder, GstEvent * event);
 static gboolean gst_vpx_enc_propose_allocation (GstVideoEncoder * encoder,
     GstQuery * query);
 static gboolean gst_vpx_enc_transform_meta (GstVideoEncoder * encoder,
@@ -396,6 +398,7 @@ gst_vpx_enc_class_init (GstVPXEncClass * klass)
   video_encoder_class->flush = gst_vpx_enc_flush;
   video_encoder_class->finish = gst_vpx_enc_finish;
   video_encoder_class->sink_event = gst_vpx_enc_sink_event;
+  video_encoder_class->src_event = gst_vpx_enc_src_event;
   video_encoder_class->propose_allocation = gst_vpx_enc_propose_allocation;
   video_encoder_class->transform_meta = gst_vpx_enc_transform_meta;
 
@@ -2373,6 +2376,37 @@ gst_vpx_enc_sink_event (GstVideoEncoder * benc, GstEvent * event)
   return GST_VIDEO_ENCODER_CLASS (parent_class)->sink_event (benc, event);
 }
 
+static gboolean
+gst_vpx_enc_src_event (GstVideoEncoder * benc, GstEvent * event)
+{
+  GstVPXEnc *enc = GST_VPX_ENC (benc);
+  guint bitrate;
+
+  /* bandwidth estimate from rtpsession, follow it like a change of the
+   * target-bitrate property */
+  if (gst_video_event_parse_bandwidth_estimate (event, &bitrate) &&
+      bitrate >= 1000) {
+    vpx_codec_err_t status = VPX_CODEC_OK;
+
+    g_mutex_lock (&enc->encoder_lock);
+    if (enc->cfg.rc_target_bitrate != bitrate / 1000) {
+      GST_DEBUG_OBJECT (enc, "Following bandwidth estimate of %u bps",
+          bitrate);
+      enc->cfg.rc_target_bitrate = bitrate / 1000;
+      enc->rc_target_bitrate_auto = FALSE;
+      if (enc->inited)
+        status = vpx_codec_enc_config_set (&enc->encoder, &enc->cfg);
+    }
+    g_mutex_unlock (&enc->encoder_lock);
+
+    if (status != VPX_CODEC_OK)
+      GST_WARNING_OBJECT (enc, "Failed to set new bitrate: %s",
+          gst_vpx_error_name (status));
+  }
+
+  return GST_VIDEO_ENCODER_CLASS (parent_class)->src_event (benc, event);
+}
+
 static gboolean
 gst_vpx_enc_propose_allocation (GstVideoEncoder * encoder, GstQuery * query)
 {
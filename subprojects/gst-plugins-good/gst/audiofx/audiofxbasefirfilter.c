@@ -50,11 +50,13 @@ enum
 {
   PROP_0 = 0,
   PROP_LOW_LATENCY,
-  PROP_DRAIN_ON_CHANGES
+  PROP_DRAIN_ON_CHANGES,
+  PROP_PARTITION_SIZE
 };
 
 #define DEFAULT_LOW_LATENCY FALSE
 #define DEFAULT_DRAIN_ON_CHANGES TRUE
+#define DEFAULT_PARTITION_SIZE 0
 
 #define gst_audio_fx_base_fir_filter_parent_class parent_class
 G_DEFINE_TYPE (GstAudioFXBaseFIRFilter, gst_audio_fx_base_fir_filter,
@@ -362,6 +364,141 @@ DEFINE_FFT_PROCESS_FUNC_FIXED_CHANNELS (64, 2, double);
 #undef DEFINE_FFT_PROCESS_FUNC
 #undef DEFINE_FFT_PROCESS_FUNC_FIXED_CHANNELS
 
+/* This implements uniformly partitioned FFT convolution, again with the
+ * overlap-save algorithm.
+ *
+ * With the FFT convolution above the block length, and with it the
+ * latency, is a multiple of the kernel length. For long kernels, like room
+ * impulse responses of several seconds, this gives an unusable latency.
+ *
+ * Instead the kernel is split into K partitions h_k of P samples each and
+ * the input is processed in blocks of P samples. Every block gives
+ *
+ * y = IFFT (\sum_{k=0}^{K-1} X_{n-k} * FFT(h_k))
+ *
+ * where X_{n-k} is the spectrum of the input block from k blocks ago. These
+ * spectra are kept in a ring buffer, the frequency domain delay line, so
+ * every input block is transformed only once. Each FFT covers the last
+ * N >= 2 * P input samples, of which the last P output samples are valid.
+ *
+ * The latency is P, the runtime complexity per sample is
+ *
+ *   ( N log N + K * N )
+ * O ( --------------- )
+ *   (        P        )
+ */
+#define DEFINE_PARTITIONED_PROCESS_FUNC(width,ctype) \
+static guint \
+process_partitioned_##width (GstAudioFXBaseFIRFilter * self, \
+    const g##ctype * src, g##ctype * dst, guint input_samples) \
+{ \
+  gint channels = GST_AUDIO_FILTER_CHANNELS (self); \
+  gint i, j; \
+  guint k, pass; \
+  guint partition_length = self->partition_length; \
+  guint n_partitions = self->n_partitions; \
+  guint block_length = self->block_length; \
+  guint buffer_fill = self->buffer_fill; \
+  guint frequency_response_length = self->frequency_response_length; \
+  GstFFTF64Complex *fft_buffer = self->fft_buffer; \
+  GstFFTF64Complex *fdl; \
+  gdouble *buffer = self->buffer; \
+  gdouble *ifft_buffer; \
+  guint generated = 0; \
+  \
+  if (!fft_buffer) \
+    self->fft_buffer = fft_buffer = \
+        g_new (GstFFTF64Complex, frequency_response_length); \
+  \
+  /* Buffer contains the last block_length input samples of every \
+   * channel, the output of the inverse FFT and the delay lines of all \
+   * channels, so that everything is reset together. */ \
+  if (!buffer) { \
+    self->buffer_length = block_length; \
+    self->buffer = buffer = g_new0 (gdouble, \
+        (channels + 1) * block_length + \
+        2 * channels * n_partitions * frequency_response_length); \
+    self->buffer_fill = buffer_fill = 0; \
+    self->fdl_pos = 0; \
+  } \
+  ifft_buffer = buffer + channels * block_length; \
+  fdl = (GstFFTF64Complex *) (ifft_buffer + block_length); \
+  \
+  while (input_samples) { \
+    pass = MIN (partition_length - buffer_fill, input_samples); \
+    \
+    /* Deinterleave channels, new samples go to the end */ \
+    for (i = 0; i < pass; i++) { \
+      for (j = 0; j < channels; j++) { \
+        buffer[block_length * j + block_length - partition_length + \
+            buffer_fill + i] = src[i * channels + j]; \
+      } \
+    } \
+    buffer_fill += pass; \
+    src += channels * pass; \
+    input_samples -= pass; \
+    \
+    /* If we don't have a complete partition go out */ \
+    if (buffer_fill < partition_length) \
+      break; \
+    \
+    for (j = 0; j < channels; j++) { \
+      gdouble *input = buffer + block_length * j; \
+      GstFFTF64Complex *channel_fdl = \
+          fdl + n_partitions * frequency_response_length * j; \
+      \
+      /* Calculate FFT of the input into the delay line */ \
+      gst_fft_f64_fft (self->fft, input, \
+          channel_fdl + self->fdl_pos * frequency_response_length); \
+      \
+      /* Multiply and accumulate all delayed input spectra with the \
+       * spectra of the corresponding partitions */ \
+      memset (fft_buffer, 0, \
+          frequency_response_length * sizeof (GstFFTF64Complex)); \
+      for (k = 0; k < n_partitions; k++) { \
+        const GstFFTF64Complex *x = channel_fdl + \
+            ((self->fdl_pos + n_partitions - k) % n_partitions) * \
+            frequency_response_length; \
+        const GstFFTF64Complex *h = self->frequency_response + \
+            k * frequency_response_length; \
+        \
+        for (i = 0; i < frequency_response_length; i++) { \
+          fft_buffer[i].r += x[i].r * h[i].r - x[i].i * h[i].i; \
+          fft_buffer[i].i += x[i].r * h[i].i + x[i].i * h[i].r; \
+        } \
+      } \
+      \
+      /* Calculate inverse FFT of the result */ \
+      gst_fft_f64_inverse_fft (self->ifft, fft_buffer, ifft_buffer); \
+      \
+      /* Copy the last partition_length samples to the output */ \
+      for (i = 0; i < partition_length; i++) { \
+        dst[i * channels + j] = \
+            ifft_buffer[block_length - partition_length + i]; \
+      } \
+      \
+      /* Move the input by one partition for the next block */ \
+      memmove (input, input + partition_length, \
+          (block_length - partition_length) * sizeof (gdouble)); \
+    } \
+    \
+    self->fdl_pos = (self->fdl_pos + 1) % n_partitions; \
+    generated += partition_length; \
+    dst += channels * partition_length; \
+    buffer_fill = 0; \
+  } \
+  \
+  /* Write back cached buffer_fill value */ \
+  self->buffer_fill = buffer_fill; \
+  \
+  return generated; \
+}
+
+DEFINE_PARTITIONED_PROCESS_FUNC (32, float);
+DEFINE_PARTITIONED_PROCESS_FUNC (64, double);
+
+#undef DEFINE_PARTITIONED_PROCESS_FUNC
+
 /* Element class */
 static void
     gst_audio_fx_base_fir_filter_calculate_frequency_response
@@ -375,8 +512,50 @@ static void
   self->frequency_response_length = 0;
   g_free (self->fft_buffer);
   self->fft_buffer = NULL;
+  self->n_partitions = 0;
 
   if (self->kernel && self->kernel_length >= FFT_THRESHOLD
+      && !self->low_latency && self->partition_length > 0
+      && self->partition_length < self->kernel_length) {
+    guint block_length, i, k;
+    guint partition_length = self->partition_length;
+    gdouble *kernel_tmp;
+
+    /* One partition of input plus one of history at least */
+    block_length = gst_fft_next_fast_length (2 * partition_length);
+    self->block_length = block_length;
+    self->n_partitions =
+        (self->kernel_length + partition_length - 1) / partition_length;
+
+    self->fft = gst_fft_f64_new (block_length, FALSE);
+    self->ifft = gst_fft_f64_new (block_length, TRUE);
+    self->frequency_response_length = block_length / 2 + 1;
+    self->frequency_response = g_new (GstFFTF64Complex,
+        self->n_partitions * self->frequency_response_length);
+
+    kernel_tmp = g_new (gdouble, block_length);
+    for (k = 0; k < self->n_partitions; k++) {
+      GstFFTF64Complex *response = self->frequency_response +
+          k * self->frequency_response_length;
+      guint length = MIN (partition_length,
+          self->kernel_length - k * partition_length);
+
+      memset (kernel_tmp, 0, block_length * sizeof (gdouble));
+      memcpy (kernel_tmp, self->kernel + k * partition_length,
+          length * sizeof (gdouble));
+      gst_fft_f64_fft (self->fft, kernel_tmp, response);
+
+      /* Normalize to make sure IFFT(FFT(x)) == x */
+      for (i = 0; i < self->frequency_response_length; i++) {
+        response[i].r /= block_length;
+        response[i].i /= block_length;
+      }
+    }
+    g_free (kernel_tmp);
+
+    GST_DEBUG_OBJECT (self, "using %u partitions of %u samples, FFT length %u",
+        self->n_partitions, partition_length, block_length);
+  } else if (self->kernel && self->kernel_length >= FFT_THRESHOLD
       && !self->low_latency) {
     guint block_length, i;
     gdouble *kernel_tmp, *kernel = self->kernel;
@@ -412,7 +591,10 @@ gst_audio_fx_base_fir_filter_select_process_function (GstAudioFXBaseFIRFilter *
 {
   switch (format) {
     case GST_AUDIO_FORMAT_F32:
-      if (self->fft && !self->low_latency) {
+      if (self->fft && !self->low_latency && self->n_partitions > 0) {
+        self->process =
+            (GstAudioFXBaseFIRFilterProcessFunc) process_partitioned_32;
+      } else if (self->fft && !self->low_latency) {
         if (channels == 1)
           self->process = (GstAudioFXBaseFIRFilterProcessFunc) process_fft_1_32;
         else if (channels == 2)
@@ -429,7 +611,10 @@ gst_audio_fx_base_fir_filter_select_process_function (GstAudioFXBaseFIRFilter *
       }
       break;
     case GST_AUDIO_FORMAT_F64:
-      if (self->fft && !self->low_latency) {
+      if (self->fft && !self->low_latency && self->n_partitions > 0) {
+        self->process =
+            (GstAudioFXBaseFIRFilterProcessFunc) process_partitioned_64;
+      } else if (self->fft && !self->low_latency) {
         if (channels == 1)
           self->process = (GstAudioFXBaseFIRFilterProcessFunc) process_fft_1_64;
         else if (channels == 2)
@@ -502,6 +687,31 @@ gst_audio_fx_base_fir_filter_set_property (GObject * object, guint prop_id,
       g_mutex_unlock (&self->lock);
       break;
     }
+    case PROP_PARTITION_SIZE:{
+      guint partition_length;
+
+      if (GST_STATE (self) >= GST_STATE_PAUSED) {
+        g_warning ("Changing the \"partition-size\" property "
+            "is only allowed in states < PAUSED");
+        return;
+      }
+
+      g_mutex_lock (&self->lock);
+      partition_length = g_value_get_uint (value);
+
+      if (self->partition_length != partition_length) {
+        self->partition_length = partition_length;
+        g_free (self->buffer);
+        self->buffer = NULL;
+        self->buffer_fill = 0;
+        self->buffer_length = 0;
+        gst_audio_fx_base_fir_filter_calculate_frequency_response (self);
+        gst_audio_fx_base_fir_filter_select_process_function (self,
+            GST_AUDIO_FILTER_FORMAT (self), GST_AUDIO_FILTER_CHANNELS (self));
+      }
+      g_mutex_unlock (&self->lock);
+      break;
+    }
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -521,6 +731,9 @@ gst_audio_fx_base_fir_filter_get_property (GObject * object, guint prop_id,
     case PROP_DRAIN_ON_CHANGES:
       g_value_set_boolean (value, self->drain_on_changes);
       break;
+    case PROP_PARTITION_SIZE:
+      g_value_set_uint (value, self->partition_length);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -569,6 +782,23 @@ gst_audio_fx_base_fir_filter_class_init (GstAudioFXBaseFIRFilterClass * klass)
           DEFAULT_DRAIN_ON_CHANGES,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstAudioFXBaseFIRFilter:partition-size:
+   *
+   * Split long filter kernels into partitions of this many samples in FFT
+   * mode. The latency is then the partition size instead of a multiple of
+   * the filter length, at the cost of some more computations. 0 disables
+   * partitioning. Has no effect in low-latency mode.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PARTITION_SIZE,
+      g_param_spec_uint ("partition-size", "Partition size",
+          "Length of the kernel partitions in FFT mode, this is also the "
+          "latency (0 = no partitioning). "
+          "Can only be changed in states < PAUSED!", 0, G_MAXUINT / 4,
+          DEFAULT_PARTITION_SIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   caps = gst_caps_from_string (ALLOWED_CAPS);
   gst_audio_filter_class_add_pad_templates (GST_AUDIO_FILTER_CLASS (klass),
       caps);
@@ -602,6 +832,7 @@ gst_audio_fx_base_fir_filter_init (GstAudioFXBaseFIRFilter * self)
 
   self->low_latency = DEFAULT_LOW_LATENCY;
   self->drain_on_changes = DEFAULT_DRAIN_ON_CHANGES;
+  self->partition_length = DEFAULT_PARTITION_SIZE;
 
   g_mutex_init (&self->lock);
 }
@@ -669,7 +900,8 @@ gst_audio_fx_base_fir_filter_push_residue (GstAudioFXBaseFIRFilter * self)
     gst_buffer_map (outbuf, &map, GST_MAP_READWRITE);
 
     while (gensamples < outsamples) {
-      guint step_insamples = self->block_length - self->buffer_fill;
+      guint step_insamples = (self->n_partitions > 0 ?
+          self->partition_length : self->block_length) - self->buffer_fill;
       guint8 *zeroes = g_new0 (guint8, step_insamples * channels * bps);
       guint8 *out = g_new (guint8, self->block_length * channels * bps);
       guint step_gensamples;
@@ -777,7 +1009,10 @@ gst_audio_fx_base_fir_filter_transform_size (GstBaseTransform * base,
   bpf = GST_AUDIO_INFO_BPF (&info);
 
   size /= bpf;
-  blocklen = self->block_length - self->kernel_length + 1;
+  if (self->n_partitions > 0)
+    blocklen = self->partition_length;
+  else
+    blocklen = self->block_length - self->kernel_length + 1;
   *othersize = ((size + blocklen - 1) / blocklen) * blocklen;
   *othersize *= bpf;
 
@@ -972,7 +1207,9 @@ gst_audio_fx_base_fir_filter_query (GstBaseTransform * trans,
             GST_TIME_FORMAT " max %" GST_TIME_FORMAT,
             GST_TIME_ARGS (min), GST_TIME_ARGS (max));
 
-        if (self->fft && !self->low_latency)
+        if (self->fft && !self->low_latency && self->n_partitions > 0)
+          latency = self->partition_length;
+        else if (self->fft && !self->low_latency)
           latency = self->block_length - self->kernel_length + 1;
         else
           latency = self->latency;
@@ -1030,7 +1267,7 @@ gst_audio_fx_base_fir_filter_set_kernel (GstAudioFXBaseFIRFilter * self,
     gdouble * kernel, guint kernel_length, guint64 latency,
     const GstAudioInfo * info)
 {
-  gboolean latency_changed;
+  gboolean latency_changed, partitions_changed;
   GstAudioFormat format;
   gint channels;
 
@@ -1045,6 +1282,12 @@ gst_audio_fx_base_fir_filter_set_kernel (GstAudioFXBaseFIRFilter * self,
       || (!self->low_latency && self->kernel_length >= FFT_THRESHOLD
           && kernel_length < FFT_THRESHOLD));
 
+  /* The partitions and with them the buffer size change with the kernel
+   * length, and partitioning might be switched on or off by it */
+  partitions_changed = (self->partition_length > 0
+      && self->kernel_length != kernel_length);
+  latency_changed |= partitions_changed;
+
   /* FIXME: If the latency changes, the buffer size changes too and we
    * have to drain in any case until this is fixed in the future */
   if (self->buffer && (!self->drain_on_changes || latency_changed)) {
@@ -80,6 +80,11 @@ struct _GstAudioFXBaseFIRFilter {
   GstFFTF64Complex *fft_buffer;          /* FFT buffer, has the length of the frequency response */
   guint block_length;                    /* Length of the processing blocks -- time domain */
 
+  /* Partitioned FFT convolution specific data */
+  guint partition_length;                /* Length of the kernel partitions, 0 to not partition */
+  guint n_partitions;                    /* Number of kernel partitions, 0 if not partitioned */
+  guint fdl_pos;                         /* Position of the latest input spectrum in the delay line */
+
   GstClockTime start_ts;        /* start timestamp after a discont */
   guint64 start_off;            /* start offset after a discont */
   guint64 nsamples_out;         /* number of output samples since last discont */
@@ -60,6 +60,7 @@ GST_DEBUG_CATEGORY_STATIC (deinterlace_debug);
 #define DEFAULT_LOCKING         GST_DEINTERLACE_LOCKING_NONE
 #define DEFAULT_IGNORE_OBSCURE  TRUE
 #define DEFAULT_DROP_ORPHANS    TRUE
+#define DEFAULT_MAX_THREADS     1
 
 enum
 {
@@ -70,7 +71,8 @@ enum
   PROP_FIELD_LAYOUT,
   PROP_LOCKING,
   PROP_IGNORE_OBSCURE,
-  PROP_DROP_ORPHANS
+  PROP_DROP_ORPHANS,
+  PROP_MAX_THREADS
 };
 
 /* P is progressive, meaning the top and bottom fields belong to
@@ -284,7 +286,8 @@ gst_deinterlace_locking_get_type (void)
 
 #define DEINTERLACE_VIDEO_FORMATS \
     "{ AYUV, ARGB, ABGR, RGBA, BGRA, Y444, xRGB, xBGR, RGBx, BGRx, RGB, " \
-    "BGR, YUY2, YVYU, UYVY, Y42B, I420, YV12, Y41B, NV12, NV21 }"
+    "BGR, YUY2, YVYU, UYVY, Y42B, I420, YV12, Y41B, NV12, NV21, " \
+    "P010_10LE }"
 
 #define DEINTERLACE_CAPS GST_VIDEO_CAPS_MAKE(DEINTERLACE_VIDEO_FORMATS)
 
@@ -461,6 +464,24 @@ gst_deinterlace_set_method (GstDeinterlace * self, GstDeinterlaceMethods method)
     gst_deinterlace_method_setup (self->method, &self->vinfo);
 }
 
+/* called from the streaming thread so the threads of the method are not
+ * changed while it is running */
+static void
+gst_deinterlace_update_max_threads (GstDeinterlace * self)
+{
+  guint max_threads;
+
+  if (!GST_IS_DEINTERLACE_SIMPLE_METHOD (self->method))
+    return;
+
+  GST_OBJECT_LOCK (self);
+  max_threads = self->max_threads;
+  GST_OBJECT_UNLOCK (self);
+
+  gst_deinterlace_simple_method_set_max_threads (GST_DEINTERLACE_SIMPLE_METHOD
+      (self->method), max_threads);
+}
+
 static gboolean
 gst_deinterlace_clip_buffer (GstDeinterlace * self, GstBuffer * buffer)
 {
@@ -635,6 +656,21 @@ gst_deinterlace_class_init (GstDeinterlaceClass * klass)
           "active locking mode.", DEFAULT_DROP_ORPHANS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstDeinterlace:max-threads:
+   *
+   * The maximum number of threads the lines of a frame are split over, 0 for
+   * the number of processors. Only used by the methods that process each
+   * line separately, like yadif and linear.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_uint ("max-threads", "Max Threads",
+          "Maximum number of threads to use (0 = number of processors)", 0,
+          G_MAXINT, DEFAULT_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   element_class->change_state =
       GST_DEBUG_FUNCPTR (gst_deinterlace_change_state);
 
@@ -696,6 +732,7 @@ gst_deinterlace_init (GstDeinterlace * self)
   gst_element_add_pad (GST_ELEMENT (self), self->srcpad);
 
   self->mode = DEFAULT_MODE;
+  self->max_threads = DEFAULT_MAX_THREADS;
   self->user_set_method_id = DEFAULT_METHOD;
   gst_video_info_init (&self->vinfo);
   gst_video_info_init (&self->vinfo_out);
@@ -947,6 +984,11 @@ gst_deinterlace_set_property (GObject * object, guint prop_id,
     case PROP_DROP_ORPHANS:
       self->drop_orphans = g_value_get_boolean (value);
       break;
+    case PROP_MAX_THREADS:
+      GST_OBJECT_LOCK (self);
+      self->max_threads = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (self);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
   }
@@ -983,6 +1025,9 @@ gst_deinterlace_get_property (GObject * object, guint prop_id,
     case PROP_DROP_ORPHANS:
       g_value_set_boolean (value, self->drop_orphans);
       break;
+    case PROP_MAX_THREADS:
+      g_value_set_uint (value, self->max_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
   }
@@ -1917,6 +1962,7 @@ restart:
           gst_video_frame_new_and_map (&self->vinfo_out, outbuf, GST_MAP_WRITE);
 
       /* do magic calculus */
+      gst_deinterlace_update_max_threads (self);
       gst_deinterlace_method_deinterlace_frame (self->method,
           self->field_history, self->history_count, outframe,
           self->cur_field_idx);
@@ -2078,6 +2124,7 @@ restart:
           gst_video_frame_new_and_map (&self->vinfo_out, outbuf, GST_MAP_WRITE);
 
       /* do magic calculus */
+      gst_deinterlace_update_max_threads (self);
       gst_deinterlace_method_deinterlace_frame (self->method,
           self->field_history, self->history_count, outframe,
           self->cur_field_idx);
@@ -89,6 +89,8 @@ gst_deinterlace_method_supported_impl (GstDeinterlaceMethodClass * klass,
       return (klass->deinterlace_frame_rgb != NULL);
     case GST_VIDEO_FORMAT_BGR:
       return (klass->deinterlace_frame_bgr != NULL);
+    case GST_VIDEO_FORMAT_P010_10LE:
+      return (klass->deinterlace_frame_p010_10le != NULL);
     default:
       return FALSE;
   }
@@ -171,6 +173,9 @@ gst_deinterlace_method_setup_impl (GstDeinterlaceMethod * self,
     case GST_VIDEO_FORMAT_BGR:
       self->deinterlace_frame = klass->deinterlace_frame_bgr;
       break;
+    case GST_VIDEO_FORMAT_P010_10LE:
+      self->deinterlace_frame = klass->deinterlace_frame_p010_10le;
+      break;
     default:
       self->deinterlace_frame = NULL;
       break;
@@ -276,6 +281,11 @@ gst_deinterlace_simple_method_supported (GstDeinterlaceMethodClass * mklass,
           && klass->copy_scanline_nv21 != NULL
           && klass->interpolate_scanline_planar_y != NULL
           && klass->copy_scanline_planar_y != NULL);
+    case GST_VIDEO_FORMAT_P010_10LE:
+      return (klass->interpolate_scanline_p010_10le != NULL
+          && klass->copy_scanline_p010_10le != NULL
+          && klass->interpolate_scanline_planar_y_16 != NULL
+          && klass->copy_scanline_planar_y_16 != NULL);
     case GST_VIDEO_FORMAT_I420:
     case GST_VIDEO_FORMAT_YV12:
     case GST_VIDEO_FORMAT_Y444:
@@ -517,31 +527,39 @@ gst_deinterlace_simple_method_copy_scanline_planar_v (GstDeinterlaceSimpleMethod
   memcpy (out, scanlines->m0, size);
 }
 
+typedef struct
+{
+  GstDeinterlaceSimpleMethod *self;
+  GstVideoFrame *dest;
+  LinesGetter *lg;
+  guint cur_field_flags;
+  gint plane;
+  GstDeinterlaceSimpleMethodFunction copy_scanline;
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline;
+  gint start, end;
+} PlaneLinesTask;
+
 static void
-    gst_deinterlace_simple_method_deinterlace_frame_planar_plane
-    (GstDeinterlaceSimpleMethod * self, GstVideoFrame * dest,
-    LinesGetter * lg,
-    guint cur_field_flags, gint plane,
-    GstDeinterlaceSimpleMethodFunction copy_scanline,
-    GstDeinterlaceSimpleMethodFunction interpolate_scanline)
+gst_deinterlace_simple_method_deinterlace_plane_lines (PlaneLinesTask * task)
 {
+  GstDeinterlaceSimpleMethod *self = task->self;
+  GstVideoFrame *dest = task->dest;
+  LinesGetter *lg = task->lg;
+  gint plane = task->plane;
   GstDeinterlaceScanlineData scanlines;
   gint i;
-  gint frame_height, frame_width;
+  gint frame_width;
 
-  frame_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, plane);
   frame_width = GST_VIDEO_FRAME_COMP_WIDTH (dest, plane) *
       GST_VIDEO_FRAME_COMP_PSTRIDE (dest, plane);
 
-  g_assert (interpolate_scanline != NULL);
-  g_assert (copy_scanline != NULL);
-
 #define LINE(x,i) (((guint8*)GST_VIDEO_FRAME_PLANE_DATA((x),plane)) + i * \
     GST_VIDEO_FRAME_PLANE_STRIDE((x),plane))
 
-  for (i = 0; i < frame_height; i++) {
+  for (i = task->start; i < task->end; i++) {
     memset (&scanlines, 0, sizeof (scanlines));
-    scanlines.bottom_field = (cur_field_flags == PICTURE_INTERLACED_BOTTOM);
+    scanlines.bottom_field =
+        (task->cur_field_flags == PICTURE_INTERLACED_BOTTOM);
 
     if (!((i & 1) ^ scanlines.bottom_field)) {
       /* copying */
@@ -559,7 +577,7 @@ static void
       scanlines.m2 = get_line (lg, 2, plane, i, 0);
       scanlines.bb2 = get_line (lg, 2, plane, i, 2);
 
-      copy_scanline (self, LINE (dest, i), &scanlines, frame_width);
+      task->copy_scanline (self, LINE (dest, i), &scanlines, frame_width);
     } else {
       /* interpolating */
       scanlines.tp2 = get_line (lg, -2, plane, i, -1);
@@ -579,12 +597,69 @@ static void
       scanlines.t2 = get_line (lg, 2, plane, i, -1);
       scanlines.b2 = get_line (lg, 2, plane, i, 1);
 
-      interpolate_scanline (self, LINE (dest, i), &scanlines, frame_width);
+      task->interpolate_scanline (self, LINE (dest, i), &scanlines,
+          frame_width);
     }
 #undef LINE
   }
 }
 
+static void
+    gst_deinterlace_simple_method_deinterlace_frame_planar_plane
+    (GstDeinterlaceSimpleMethod * self, GstVideoFrame * dest,
+    LinesGetter * lg,
+    guint cur_field_flags, gint plane,
+    GstDeinterlaceSimpleMethodFunction copy_scanline,
+    GstDeinterlaceSimpleMethodFunction interpolate_scanline)
+{
+  PlaneLinesTask *tasks;
+  gpointer *ids;
+  gint i, n_tasks, frame_height, lines_per_task;
+
+  frame_height = GST_VIDEO_FRAME_COMP_HEIGHT (dest, plane);
+
+  g_assert (interpolate_scanline != NULL);
+  g_assert (copy_scanline != NULL);
+
+  /* Every line only depends on the history, so the lines can be split over
+   * the threads. Give each of them whole pairs of lines. */
+  n_tasks = 1;
+  if (self->pool)
+    n_tasks = CLAMP (frame_height / 16, 1, self->n_threads);
+  lines_per_task = GST_ROUND_UP_2 ((frame_height + n_tasks - 1) / n_tasks);
+
+  tasks = g_newa (PlaneLinesTask, n_tasks);
+  ids = g_newa (gpointer, n_tasks);
+
+  for (i = 0; i < n_tasks; i++) {
+    tasks[i].self = self;
+    tasks[i].dest = dest;
+    tasks[i].lg = lg;
+    tasks[i].cur_field_flags = cur_field_flags;
+    tasks[i].plane = plane;
+    tasks[i].copy_scanline = copy_scanline;
+    tasks[i].interpolate_scanline = interpolate_scanline;
+    tasks[i].start = MIN (i * lines_per_task, frame_height);
+    tasks[i].end = MIN ((i + 1) * lines_per_task, frame_height);
+  }
+
+  /* the first lines are done in the current thread */
+  for (i = 1; i < n_tasks; i++) {
+    ids[i] = gst_task_pool_push (self->pool,
+        (GstTaskPoolFunction) gst_deinterlace_simple_method_deinterlace_plane_lines,
+        &tasks[i], NULL);
+    if (ids[i] == NULL)
+      gst_deinterlace_simple_method_deinterlace_plane_lines (&tasks[i]);
+  }
+
+  gst_deinterlace_simple_method_deinterlace_plane_lines (&tasks[0]);
+
+  for (i = 1; i < n_tasks; i++) {
+    if (ids[i])
+      gst_task_pool_join (self->pool, ids[i]);
+  }
+}
+
 static void
 gst_deinterlace_simple_method_deinterlace_frame_planar (GstDeinterlaceMethod *
     method, const GstDeinterlaceField * history, guint history_count,
@@ -629,7 +704,7 @@ gst_deinterlace_simple_method_deinterlace_frame_nv12 (GstDeinterlaceMethod *
   guint cur_field_flags = history[cur_field_idx].flags;
   LinesGetter lg = { history, history_count, cur_field_idx, };
 
-  /* Y plane is at position 0 */
+  /* Y plane is at position 0, also used for P010 */
   g_assert (self->interpolate_scanline_packed != NULL);
   g_assert (self->copy_scanline_packed != NULL);
   g_assert (self->interpolate_scanline_planar[0] != NULL);
@@ -728,6 +803,13 @@ gst_deinterlace_simple_method_setup (GstDeinterlaceMethod * method,
           klass->interpolate_scanline_planar_y;
       self->copy_scanline_planar[0] = klass->copy_scanline_planar_y;
       break;
+    case GST_VIDEO_FORMAT_P010_10LE:
+      self->interpolate_scanline_packed = klass->interpolate_scanline_p010_10le;
+      self->copy_scanline_packed = klass->copy_scanline_p010_10le;
+      self->interpolate_scanline_planar[0] =
+          klass->interpolate_scanline_planar_y_16;
+      self->copy_scanline_planar[0] = klass->copy_scanline_planar_y_16;
+      break;
     case GST_VIDEO_FORMAT_I420:
     case GST_VIDEO_FORMAT_YV12:
     case GST_VIDEO_FORMAT_Y444:
@@ -748,12 +830,65 @@ gst_deinterlace_simple_method_setup (GstDeinterlaceMethod * method,
   }
 }
 
+/**
+ * gst_deinterlace_simple_method_set_max_threads:
+ * @self: a #GstDeinterlaceSimpleMethod
+ * @max_threads: the maximum number of threads, 0 for the number of
+ *     processors
+ *
+ * Split the lines of every plane over up to @max_threads threads.
+ */
+void
+gst_deinterlace_simple_method_set_max_threads (GstDeinterlaceSimpleMethod *
+    self, guint max_threads)
+{
+  if (max_threads == 0)
+    max_threads = g_get_num_processors ();
+
+  if (self->n_threads == max_threads)
+    return;
+
+  if (self->pool) {
+    gst_task_pool_cleanup (self->pool);
+    gst_object_unref (self->pool);
+    self->pool = NULL;
+  }
+
+  self->n_threads = max_threads;
+
+  /* the current thread works too */
+  if (max_threads > 1) {
+    self->pool = gst_shared_task_pool_new ();
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (self->pool),
+        max_threads - 1);
+    gst_task_pool_prepare (self->pool, NULL);
+  }
+}
+
+static void
+gst_deinterlace_simple_method_finalize (GObject * object)
+{
+  GstDeinterlaceSimpleMethod *self = GST_DEINTERLACE_SIMPLE_METHOD (object);
+
+  if (self->pool) {
+    gst_task_pool_cleanup (self->pool);
+    gst_object_unref (self->pool);
+    self->pool = NULL;
+  }
+
+  G_OBJECT_CLASS (gst_deinterlace_simple_method_parent_class)->finalize
+      (object);
+}
+
 static void
 gst_deinterlace_simple_method_class_init (GstDeinterlaceSimpleMethodClass
     * klass)
 {
+  GObjectClass *gobject_class = (GObjectClass *) klass;
   GstDeinterlaceMethodClass *dm_class = (GstDeinterlaceMethodClass *) klass;
 
+  gobject_class->finalize = gst_deinterlace_simple_method_finalize;
+
   dm_class->deinterlace_frame_ayuv =
       gst_deinterlace_simple_method_deinterlace_frame_packed;
   dm_class->deinterlace_frame_yuy2 =
@@ -788,6 +923,8 @@ gst_deinterlace_simple_method_class_init (GstDeinterlaceSimpleMethodClass
       gst_deinterlace_simple_method_deinterlace_frame_nv12;
   dm_class->deinterlace_frame_nv21 =
       gst_deinterlace_simple_method_deinterlace_frame_nv12;
+  dm_class->deinterlace_frame_p010_10le =
+      gst_deinterlace_simple_method_deinterlace_frame_nv12;
   dm_class->fields_required = 2;
   dm_class->setup = gst_deinterlace_simple_method_setup;
   dm_class->supported = gst_deinterlace_simple_method_supported;
@@ -854,4 +991,5 @@ gst_deinterlace_simple_method_class_init (GstDeinterlaceSimpleMethodClass
 static void
 gst_deinterlace_simple_method_init (GstDeinterlaceSimpleMethod * self)
 {
+  self->n_threads = 1;
 }
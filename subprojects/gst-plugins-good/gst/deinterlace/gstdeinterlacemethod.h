@@ -100,6 +100,7 @@ struct _GstDeinterlaceMethodClass {
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_bgra;
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_rgb;
   GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_bgr;
+  GstDeinterlaceMethodDeinterlaceFunction deinterlace_frame_p010_10le;
 
   const gchar *name;
   const gchar *nick;
@@ -168,6 +169,10 @@ typedef void (*GstDeinterlaceSimpleMethodFunction) (GstDeinterlaceSimpleMethod *
 struct _GstDeinterlaceSimpleMethod {
   GstDeinterlaceMethod parent;
 
+  /* lines of a plane are split over this many threads */
+  guint n_threads;
+  GstTaskPool *pool;
+
   GstDeinterlaceSimpleMethodFunction interpolate_scanline_packed;
   GstDeinterlaceSimpleMethodFunction copy_scanline_packed;
 
@@ -206,6 +211,10 @@ struct _GstDeinterlaceSimpleMethodClass {
   GstDeinterlaceSimpleMethodFunction interpolate_scanline_nv21;
   GstDeinterlaceSimpleMethodFunction copy_scanline_nv21;
 
+  /* 16 bit semi-planar formats, the interleaved chroma plane */
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline_p010_10le;
+  GstDeinterlaceSimpleMethodFunction copy_scanline_p010_10le;
+
   /* Planar formats */
   GstDeinterlaceSimpleMethodFunction copy_scanline_planar_y;
   GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_y;
@@ -213,10 +222,16 @@ struct _GstDeinterlaceSimpleMethodClass {
   GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_u;
   GstDeinterlaceSimpleMethodFunction copy_scanline_planar_v;
   GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_v;
+
+  /* 16 bit luma plane, only used by the 16 bit formats */
+  GstDeinterlaceSimpleMethodFunction copy_scanline_planar_y_16;
+  GstDeinterlaceSimpleMethodFunction interpolate_scanline_planar_y_16;
 };
 
 GType gst_deinterlace_simple_method_get_type (void);
 
+void gst_deinterlace_simple_method_set_max_threads (GstDeinterlaceSimpleMethod * self, guint max_threads);
+
 G_END_DECLS
 
 #endif /* __GST_DEINTERLACE_METHOD_H__ */
@@ -96,6 +96,14 @@ static void
 filter_scanline_yadif_packed_3 (GstDeinterlaceSimpleMethod * self,
     guint8 * out, const GstDeinterlaceScanlineData * scanlines, guint size);
 
+static void
+filter_scanline_yadif_planar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * scanlines, guint size);
+
+static void
+filter_scanline_yadif_semiplanar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * scanlines, guint size);
+
 static void
 filter_line_c_planar_mode0 (void *ORC_RESTRICT dst,
     const void *ORC_RESTRICT tzero, const void *ORC_RESTRICT bzero,
@@ -166,6 +174,8 @@ static void
   dism_class->copy_scanline_bgr = copy_scanline;
   dism_class->copy_scanline_nv12 = copy_scanline;
   dism_class->copy_scanline_nv21 = copy_scanline;
+  dism_class->copy_scanline_planar_y_16 = copy_scanline;
+  dism_class->copy_scanline_p010_10le = copy_scanline;
 
   dism_class->interpolate_scanline_planar_y = filter_scanline_yadif_planar;
   dism_class->interpolate_scanline_planar_u = filter_scanline_yadif_planar;
@@ -182,6 +192,10 @@ static void
   dism_class->interpolate_scanline_bgr = filter_scanline_yadif_packed_3;
   dism_class->interpolate_scanline_nv12 = filter_scanline_yadif_semiplanar;
   dism_class->interpolate_scanline_nv21 = filter_scanline_yadif_semiplanar;
+  dism_class->interpolate_scanline_planar_y_16 =
+      filter_scanline_yadif_planar_16;
+  dism_class->interpolate_scanline_p010_10le =
+      filter_scanline_yadif_semiplanar_16;
 }
 
 #define FFABS(a) ABS(a)
@@ -343,6 +357,97 @@ filter_edges (guint8 * sdst, const guint8 * stzero, const guint8 * sbzero,
       FILTER (w - border, w, 0)
 }
 
+/* Same as filter_line_c() and filter_edges() but for 16 bit samples, the
+ * FILTER macro doesn't care about the sample size */
+ALWAYS_INLINE static void
+filter_line_c_16 (guint16 * sdst, const guint16 * stzero,
+    const guint16 * sbzero, const guint16 * smone, const guint16 * smp,
+    const guint16 * sttwo, const guint16 * sbtwo, const guint16 * stptwo,
+    const guint16 * sbptwo, const guint16 * sttone, const guint16 * sttp,
+    const guint16 * sbbone, const guint16 * sbbp, int w, int colors,
+    int start, int end, int mode)
+{
+  int x;
+  const int y_alternates_every = 0;
+
+  FILTER (start, end, 1)
+}
+
+ALWAYS_INLINE static void
+filter_edges_16 (guint16 * sdst, const guint16 * stzero,
+    const guint16 * sbzero, const guint16 * smone, const guint16 * smp,
+    const guint16 * sttwo, const guint16 * sbtwo, const guint16 * stptwo,
+    const guint16 * sbptwo, const guint16 * sttone, const guint16 * sttp,
+    const guint16 * sbbone, const guint16 * sbbp, int w, int colors, int mode)
+{
+  int x;
+  const int y_alternates_every = 0;
+  const int edge = colors * (MAX_ALIGN / 2);
+  const int border = 3 * colors;
+
+  FILTER (0, border, 0)
+      FILTER (w - edge, w - border, 1)
+      FILTER (w - border, w, 0)
+}
+
+ALWAYS_INLINE static void
+filter_scanline_yadif_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * s_orig, guint size,
+    int colors)
+{
+  guint16 *dst = (guint16 *) out;
+  const int bpp = 2;
+  int w = size / bpp;
+  int edge = colors * MAX_ALIGN / bpp;
+  GstDeinterlaceScanlineData s = *s_orig;
+
+  int mode = (s.tt1 == NULL || s.bb1 == NULL || s.ttp == NULL
+      || s.bbp == NULL) ? 2 : 0;
+
+  /* When starting up, some data might not yet be available, so use the current frame */
+  if (s.m1 == NULL)
+    s.m1 = s.mp;
+  if (s.tt1 == NULL)
+    s.tt1 = s.ttp;
+  if (s.bb1 == NULL)
+    s.bb1 = s.bbp;
+  if (s.t2 == NULL)
+    s.t2 = s.tp2;
+  if (s.b2 == NULL)
+    s.b2 = s.bp2;
+
+#define L16(l) ((const guint16 *) (l))
+  filter_edges_16 (dst, L16 (s.t0), L16 (s.b0), L16 (s.m1), L16 (s.mp),
+      L16 (s.t2), L16 (s.b2), L16 (s.tp2), L16 (s.bp2), L16 (s.tt1),
+      L16 (s.ttp), L16 (s.bb1), L16 (s.bbp), w, colors, mode);
+  /* separate calls so mode is a constant in each of them */
+  if (mode == 0)
+    filter_line_c_16 (dst, L16 (s.t0), L16 (s.b0), L16 (s.m1), L16 (s.mp),
+        L16 (s.t2), L16 (s.b2), L16 (s.tp2), L16 (s.bp2), L16 (s.tt1),
+        L16 (s.ttp), L16 (s.bb1), L16 (s.bbp), w, colors, colors * 3,
+        w - edge, 0);
+  else
+    filter_line_c_16 (dst, L16 (s.t0), L16 (s.b0), L16 (s.m1), L16 (s.mp),
+        L16 (s.t2), L16 (s.b2), L16 (s.tp2), L16 (s.bp2), L16 (s.tt1),
+        L16 (s.ttp), L16 (s.bb1), L16 (s.bbp), w, colors, colors * 3,
+        w - edge, 2);
+#undef L16
+}
+
+static void
+filter_scanline_yadif_planar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * s_orig, guint size)
+{
+  filter_scanline_yadif_16 (self, out, s_orig, size, 1);
+}
+
+static void
+filter_scanline_yadif_semiplanar_16 (GstDeinterlaceSimpleMethod * self,
+    guint8 * out, const GstDeinterlaceScanlineData * s_orig, guint size)
+{
+  filter_scanline_yadif_16 (self, out, s_orig, size, 2);
+}
+
 static void
 filter_scanline_yadif_semiplanar (GstDeinterlaceSimpleMethod * self,
     guint8 * out, const GstDeinterlaceScanlineData * s_orig, guint size)
@@ -45,6 +45,10 @@
  * In most cases a queue and an audioconvert element should be added after each source pad
  * before further processing of the audio data.
  *
+ * Since 1.24 non-interleaved input is accepted too. The planes of such input already
+ * are mono streams, so the buffers pushed on the source pads share the memory of the
+ * input buffer instead of copying the samples.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 filesrc location=/path/to/file.mp3 ! decodebin ! audioconvert ! "audio/x-raw,channels=2 ! deinterleave name=d  d.src_0 ! queue ! audioconvert ! vorbisenc ! oggmux ! filesink location=channel1.ogg  d.src_1 ! queue ! audioconvert ! vorbisenc ! oggmux ! filesink location=channel2.ogg
@@ -84,7 +88,8 @@ static GstStaticPadTemplate sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_STATIC_CAPS ("audio/x-raw, "
         "format = (string) " GST_AUDIO_FORMATS_ALL ", "
         "rate = (int) [ 1, MAX ], "
-        "channels = (int) [ 1, MAX ], layout = (string) interleaved"));
+        "channels = (int) [ 1, MAX ], "
+        "layout = (string) {interleaved, non-interleaved}"));
 
 #define MAKE_FUNC(type) \
 static void deinterleave_##type (guint##type *out, guint##type *in, \
@@ -455,7 +460,8 @@ gst_deinterleave_sink_setcaps (GstDeinterleave * self, GstCaps * caps)
   /* Get srcpad caps */
   srccaps = gst_caps_copy (caps);
   s = gst_caps_get_structure (srccaps, 0);
-  gst_structure_set (s, "channels", G_TYPE_INT, 1, NULL);
+  gst_structure_set (s, "channels", G_TYPE_INT, 1, "layout", G_TYPE_STRING,
+      "interleaved", NULL);
   gst_structure_remove_field (s, "channel-mask");
 
   /* If we already have pads, update the caps otherwise
@@ -501,6 +507,8 @@ info_from_caps_failed:
   }
 }
 
+/* the layout is removed too, mono streams are the same in both layouts and
+ * the input layout does not need to match the one of the output */
 static void
 __remove_channels (GstCaps * caps)
 {
@@ -512,6 +520,7 @@ __remove_channels (GstCaps * caps)
     s = gst_caps_get_structure (caps, i);
     gst_structure_remove_field (s, "channel-mask");
     gst_structure_remove_field (s, "channels");
+    gst_structure_remove_field (s, "layout");
   }
 }
 
@@ -828,6 +837,69 @@ gst_deinterleave_get_property (GObject * object, guint prop_id,
   }
 }
 
+/* non-interleaved input: the planes are pushed as sub-buffers sharing the
+ * memory of the input buffer */
+static GstFlowReturn
+gst_deinterleave_process_planar (GstDeinterleave * self, GstBuffer * buf)
+{
+  GstFlowReturn ret = GST_FLOW_OK;
+  guint channels = GST_AUDIO_INFO_CHANNELS (&self->audio_info);
+  guint bpf = GST_AUDIO_INFO_WIDTH (&self->audio_info) / 8;
+  GstAudioMeta *meta;
+  guint pads_pushed = 0;
+  gsize nframes, bufsize;
+  GList *srcs;
+  guint i;
+
+  meta = gst_buffer_get_audio_meta (buf);
+  if (meta)
+    nframes = meta->samples;
+  else
+    nframes = gst_buffer_get_size (buf) / channels / bpf;
+  bufsize = nframes * bpf;
+
+  for (srcs = self->srcpads, i = 0; srcs; srcs = srcs->next, i++) {
+    GstPad *pad = (GstPad *) srcs->data;
+    GstBuffer *outbuf;
+    gsize offset;
+
+    offset = meta ? meta->offsets[i] : i * bufsize;
+    if (offset + bufsize > gst_buffer_get_size (buf))
+      goto wrong_size;
+
+    outbuf = gst_buffer_copy_region (buf,
+        GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS |
+        GST_BUFFER_COPY_MEMORY, offset, bufsize);
+
+    ret = gst_pad_push (pad, outbuf);
+    if (ret == GST_FLOW_OK)
+      pads_pushed++;
+    else if (ret == GST_FLOW_NOT_LINKED)
+      ret = GST_FLOW_OK;
+    else
+      goto done;
+  }
+
+  /* Return NOT_LINKED if no pad was linked */
+  if (!pads_pushed)
+    ret = GST_FLOW_NOT_LINKED;
+
+  GST_DEBUG_OBJECT (self, "Pushed on %d pads", pads_pushed);
+
+done:
+  gst_buffer_unref (buf);
+  return ret;
+
+wrong_size:
+  {
+    GST_ELEMENT_ERROR (self, STREAM, FORMAT, (NULL),
+        ("plane %u does not fit into buffer of size %" G_GSIZE_FORMAT, i,
+            gst_buffer_get_size (buf)));
+    gst_buffer_unref (buf);
+    return GST_FLOW_ERROR;
+  }
+}
+
 static GstFlowReturn
 gst_deinterleave_process (GstDeinterleave * self, GstBuffer * buf)
 {
@@ -843,26 +915,6 @@ gst_deinterleave_process (GstDeinterleave * self, GstBuffer * buf)
   GstBuffer **buffers_out = g_new0 (GstBuffer *, channels);
   guint8 *in, *out;
   GstMapInfo read_info;
-  GList *pending_events, *l;
-
-  /* Send any pending events to all src pads */
-  GST_OBJECT_LOCK (self);
-  pending_events = self->pending_events;
-  self->pending_events = NULL;
-  GST_OBJECT_UNLOCK (self);
-
-  if (pending_events) {
-    GstEvent *event;
-
-    GST_DEBUG_OBJECT (self, "Sending pending events to all src pads");
-    for (l = pending_events; l; l = l->next) {
-      event = l->data;
-      for (srcs = self->srcpads; srcs != NULL; srcs = srcs->next)
-        gst_pad_push_event (GST_PAD (srcs->data), gst_event_ref (event));
-      gst_event_unref (event);
-    }
-    g_list_free (pending_events);
-  }
 
   gst_buffer_map (buf, &read_info, GST_MAP_READ);
 
@@ -959,6 +1011,31 @@ clean_buffers:
   }
 }
 
+static void
+gst_deinterleave_push_pending_events (GstDeinterleave * self)
+{
+  GList *pending_events, *l, *srcs;
+
+  /* Send any pending events to all src pads */
+  GST_OBJECT_LOCK (self);
+  pending_events = self->pending_events;
+  self->pending_events = NULL;
+  GST_OBJECT_UNLOCK (self);
+
+  if (pending_events) {
+    GstEvent *event;
+
+    GST_DEBUG_OBJECT (self, "Sending pending events to all src pads");
+    for (l = pending_events; l; l = l->next) {
+      event = l->data;
+      for (srcs = self->srcpads; srcs != NULL; srcs = srcs->next)
+        gst_pad_push_event (GST_PAD (srcs->data), gst_event_ref (event));
+      gst_event_unref (event);
+    }
+    g_list_free (pending_events);
+  }
+}
+
 static GstFlowReturn
 gst_deinterleave_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 {
@@ -971,7 +1048,13 @@ gst_deinterleave_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   g_return_val_if_fail (GST_AUDIO_INFO_CHANNELS (&self->audio_info) > 0,
       GST_FLOW_NOT_NEGOTIATED);
 
-  ret = gst_deinterleave_process (self, buffer);
+  gst_deinterleave_push_pending_events (self);
+
+  if (GST_AUDIO_INFO_LAYOUT (&self->audio_info) ==
+      GST_AUDIO_LAYOUT_NON_INTERLEAVED)
+    ret = gst_deinterleave_process_planar (self, buffer);
+  else
+    ret = gst_deinterleave_process (self, buffer);
 
   if (ret != GST_FLOW_OK)
     GST_DEBUG_OBJECT (self, "flow return: %s", gst_flow_get_name (ret));
@@ -45,6 +45,10 @@
  *
  * The channel number of every sinkpad in the out can be retrieved from the "channel" property of the pad.
  *
+ * Since 1.24 the output is non-interleaved if downstream prefers that layout. The output
+ * buffers then carry a #GstAudioMeta and reference the memory of the input buffers instead
+ * of copying the samples.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 filesrc location=file.mp3 ! decodebin ! audioconvert ! "audio/x-raw,channels=2" ! deinterleave name=d  interleave name=i ! audioconvert ! wavenc ! filesink location=test.wav    d.src_0 ! queue ! audioconvert ! i.sink_1    d.src_1 ! queue ! audioconvert ! i.sink_0
@@ -96,7 +100,7 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
         "rate = (int) [ 1, MAX ], "
         "channels = (int) [ 1, MAX ], "
         "format = (string) " GST_AUDIO_FORMATS_ALL ", "
-        "layout = (string) interleaved")
+        "layout = (string) {interleaved, non-interleaved}")
     );
 
 #define MAKE_FUNC(type) \
@@ -226,6 +230,8 @@ static gboolean gst_interleave_sink_event (GstCollectPads * pads,
 static gboolean gst_interleave_sink_query (GstCollectPads * pads,
     GstCollectData * data, GstQuery * query, gpointer user_data);
 
+static gboolean gst_interleave_set_src_caps (GstInterleave * self,
+    GstCaps * srccaps);
 static gboolean gst_interleave_sink_setcaps (GstInterleave * self,
     GstPad * pad, const GstCaps * caps, const GstAudioInfo * info);
 
@@ -559,8 +565,7 @@ gst_interleave_request_new_pad (GstElement * element, GstPadTemplate * templ,
     gst_structure_set (s, "channels", G_TYPE_INT, self->channels, NULL);
     gst_interleave_set_channel_positions (self, s);
 
-    gst_interleave_send_stream_start (self);
-    gst_pad_set_caps (self->src, srccaps);
+    gst_interleave_set_src_caps (self, srccaps);
     gst_caps_unref (srccaps);
 
     GST_OBJECT_UNLOCK (self->collect);
@@ -625,8 +630,7 @@ gst_interleave_release_pad (GstElement * element, GstPad * pad)
       gst_structure_set (s, "channels", G_TYPE_INT, self->channels, NULL);
       gst_interleave_set_channel_positions (self, s);
 
-      gst_interleave_send_stream_start (self);
-      gst_pad_set_caps (self->src, srccaps);
+      gst_interleave_set_src_caps (self, srccaps);
       gst_caps_unref (srccaps);
     } else {
       gst_caps_replace (&self->sinkcaps, NULL);
@@ -738,8 +742,14 @@ gst_interleave_sink_getcaps (GstPad * pad, GstInterleave * self,
     sinkcaps = gst_caps_copy (gst_pad_get_pad_template_caps (pad));
     __remove_channels (sinkcaps);
     if (peercaps) {
+      guint i;
+
       peercaps = gst_caps_make_writable (peercaps);
       __remove_channels (peercaps);
+      /* the output layout does not constrain the mono input layout */
+      for (i = 0; i < gst_caps_get_size (peercaps); i++)
+        gst_structure_remove_field (gst_caps_get_structure (peercaps, i),
+            "layout");
       /* if the peer has caps, intersect */
       GST_DEBUG_OBJECT (pad, "intersecting peer and template caps");
       result = gst_caps_intersect (peercaps, sinkcaps);
@@ -796,6 +806,59 @@ gst_interleave_set_process_function (GstInterleave * self)
   }
 }
 
+/* non-interleaved output is only used if it is the first choice of
+ * downstream, as interleaved audio is what most elements expect */
+static gboolean
+gst_interleave_peer_prefers_non_interleaved (GstInterleave * self,
+    GstCaps * srccaps)
+{
+  GstCaps *filter, *peercaps;
+  const gchar *layout;
+  gboolean ret = FALSE;
+
+  filter = gst_caps_copy (srccaps);
+  gst_structure_remove_field (gst_caps_get_structure (filter, 0), "layout");
+  peercaps = gst_pad_peer_query_caps (self->src, filter);
+  gst_caps_unref (filter);
+
+  if (!peercaps)
+    return FALSE;
+
+  if (!gst_caps_is_empty (peercaps)) {
+    peercaps = gst_caps_fixate (peercaps);
+    layout =
+        gst_structure_get_string (gst_caps_get_structure (peercaps, 0),
+        "layout");
+    ret = g_strcmp0 (layout, "non-interleaved") == 0;
+  }
+  gst_caps_unref (peercaps);
+
+  return ret;
+}
+
+/* sets the layout on @srccaps, which already contain the channels, and
+ * configures the src pad with them */
+static gboolean
+gst_interleave_set_src_caps (GstInterleave * self, GstCaps * srccaps)
+{
+  GstStructure *s = gst_caps_get_structure (srccaps, 0);
+  gboolean res;
+
+  self->non_interleaved =
+      gst_interleave_peer_prefers_non_interleaved (self, srccaps);
+  gst_structure_set (s, "layout", G_TYPE_STRING,
+      self->non_interleaved ? "non-interleaved" : "interleaved", NULL);
+
+  GST_DEBUG_OBJECT (self, "setting src caps %" GST_PTR_FORMAT, srccaps);
+
+  gst_interleave_send_stream_start (self);
+  res = gst_pad_set_caps (self->src, srccaps);
+  if (res && !gst_audio_info_from_caps (&self->src_info, srccaps))
+    res = FALSE;
+
+  return res;
+}
+
 static gboolean
 gst_interleave_sink_setcaps (GstInterleave * self, GstPad * pad,
     const GstCaps * caps, const GstAudioInfo * info)
@@ -820,12 +883,10 @@ gst_interleave_sink_setcaps (GstInterleave * self, GstPad * pad,
 
     gst_structure_remove_field (s, "channel-mask");
 
-    gst_structure_set (s, "channels", G_TYPE_INT, self->channels, "layout",
-        G_TYPE_STRING, "interleaved", NULL);
+    gst_structure_set (s, "channels", G_TYPE_INT, self->channels, NULL);
     gst_interleave_set_channel_positions (self, s);
 
-    gst_interleave_send_stream_start (self);
-    res = gst_pad_set_caps (self->src, srccaps);
+    res = gst_interleave_set_src_caps (self, srccaps);
     gst_caps_unref (srccaps);
 
     if (!res)
@@ -1169,19 +1230,34 @@ gst_interleave_src_event (GstPad * pad, GstObject * parent, GstEvent * event)
   return result;
 }
 
+static void
+gst_interleave_append_silence (GstBuffer * buffer, gsize size)
+{
+  GstMemory *mem;
+  GstMapInfo map;
+
+  mem = gst_allocator_alloc (NULL, size, NULL);
+  gst_memory_map (mem, &map, GST_MAP_WRITE);
+  memset (map.data, 0, size);
+  gst_memory_unmap (mem, &map);
+  gst_buffer_append_memory (buffer, mem);
+}
+
 static GstFlowReturn
 gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
 {
   guint size;
   GstBuffer *outbuf = NULL;
+  gsize *offsets = NULL;
   GstFlowReturn ret = GST_FLOW_OK;
   GSList *collected;
   guint nsamples;
   guint ncollected = 0;
   gboolean empty = TRUE;
   gint width = self->width / 8;
-  GstMapInfo write_info;
+  GstMapInfo write_info = GST_MAP_INFO_INIT;
   GstClockTime timestamp = -1;
+  gint i;
 
   size = gst_collect_pads_available (pads);
   if (size == 0)
@@ -1199,15 +1275,23 @@ gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
 
   nsamples = size / width;
 
-  outbuf = gst_buffer_new_allocate (NULL, size * self->channels, NULL);
+  if (self->non_interleaved) {
+    /* the planes of the output are the memories of the input buffers */
+    outbuf = gst_buffer_new ();
+    offsets = g_new (gsize, self->channels);
+    for (i = 0; i < self->channels; i++)
+      offsets[i] = G_MAXSIZE;
+  } else {
+    outbuf = gst_buffer_new_allocate (NULL, size * self->channels, NULL);
 
-  if (outbuf == NULL || gst_buffer_get_size (outbuf) < size * self->channels) {
-    gst_buffer_unref (outbuf);
-    return GST_FLOW_NOT_NEGOTIATED;
-  }
+    if (outbuf == NULL || gst_buffer_get_size (outbuf) < size * self->channels) {
+      gst_buffer_unref (outbuf);
+      return GST_FLOW_NOT_NEGOTIATED;
+    }
 
-  gst_buffer_map (outbuf, &write_info, GST_MAP_WRITE);
-  memset (write_info.data, 0, size * self->channels);
+    gst_buffer_map (outbuf, &write_info, GST_MAP_WRITE);
+    memset (write_info.data, 0, size * self->channels);
+  }
 
   for (collected = pads->data; collected != NULL; collected = collected->next) {
     GstCollectData *cdata;
@@ -1236,6 +1320,18 @@ gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
     if (self->channels <= 64 && self->channel_mask) {
       channel = self->default_channels_ordering_map[channel];
     }
+
+    if (offsets) {
+      gsize insize = gst_buffer_get_size (inbuf);
+
+      offsets[channel] = gst_buffer_get_size (outbuf);
+      gst_buffer_copy_into (outbuf, inbuf, GST_BUFFER_COPY_MEMORY, 0,
+          MIN (insize, size));
+      if (insize < size)
+        gst_interleave_append_silence (outbuf, size - insize);
+      goto next;
+    }
+
     outdata = write_info.data + width * channel;
 
     gst_buffer_map (inbuf, &input_info, GST_MAP_READ);
@@ -1248,7 +1344,8 @@ gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
   }
 
   if (ncollected == 0) {
-    gst_buffer_unmap (outbuf, &write_info);
+    if (!offsets)
+      gst_buffer_unmap (outbuf, &write_info);
     goto eos;
   }
 
@@ -1322,7 +1419,19 @@ gst_interleave_collected (GstCollectPads * pads, GstInterleave * self)
   if (empty)
     GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_GAP);
 
-  gst_buffer_unmap (outbuf, &write_info);
+  if (offsets) {
+    /* channels without data are silent */
+    for (i = 0; i < self->channels; i++) {
+      if (offsets[i] == G_MAXSIZE) {
+        offsets[i] = gst_buffer_get_size (outbuf);
+        gst_interleave_append_silence (outbuf, size);
+      }
+    }
+    gst_buffer_add_audio_meta (outbuf, &self->src_info, nsamples, offsets);
+    g_free (offsets);
+  } else {
+    gst_buffer_unmap (outbuf, &write_info);
+  }
 
   GST_LOG_OBJECT (self, "pushing outbuf, timestamp %" GST_TIME_FORMAT,
       GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (outbuf)));
@@ -1335,6 +1444,7 @@ eos:
     GST_DEBUG_OBJECT (self, "no data available, must be EOS");
     if (outbuf)
       gst_buffer_unref (outbuf);
+    g_free (offsets);
     gst_pad_push_event (self->src, gst_event_new_eos ());
     return GST_FLOW_EOS;
   }
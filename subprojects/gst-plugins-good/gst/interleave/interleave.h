@@ -28,6 +28,7 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstcollectpads.h>
+#include <gst/audio/audio.h>
 
 G_BEGIN_DECLS
 
@@ -73,6 +74,11 @@ struct _GstInterleave
 
   GstInterleaveFunc func;
 
+  /* output layout and format, the output buffers carry a GstAudioMeta
+   * when non-interleaved */
+  gboolean non_interleaved;
+  GstAudioInfo src_info;
+
   GstPad *src;
 
   gboolean send_stream_start;
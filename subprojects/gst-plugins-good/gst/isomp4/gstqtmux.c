@@ -508,7 +508,10 @@ gst_qt_mux_class_init (GstQTMuxClass * klass)
 #endif
   g_object_class_install_property (gobject_class, PROP_FAST_START,
       g_param_spec_boolean ("faststart", "Format file to faststart",
-          "If the file should be formatted for faststart (headers first)",
+          "If the file should be formatted for faststart (headers first). "
+          "With a seekable downstream and reserved-max-duration set, space "
+          "for the headers is reserved at the start instead of using a "
+          "temporary file",
           DEFAULT_FAST_START, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   g_object_class_install_property (gobject_class, PROP_FAST_START_TEMP_FILE,
       g_param_spec_string ("faststart-file", "File to use for storing buffers",
@@ -3035,6 +3038,7 @@ gst_qt_mux_start_file (GstQTMux * qtmux)
 
   /* Default is 'normal' mode */
   qtmux->mux_mode = GST_QT_MUX_MODE_MOOV_AT_END;
+  qtmux->fast_start_reserved = FALSE;
 
   /* Require a sensible fragment duration when muxing
    * using the ISML muxer */
@@ -3083,7 +3087,19 @@ gst_qt_mux_start_file (GstQTMux * qtmux)
       }
       break;
     case GST_QT_MUX_MODE_FAST_START:
-      break;                    /* Don't need seekability, ignore */
+      /* If we can seek back and know how much space the moov will need,
+       * reserve that before the mdat and write the media data directly
+       * instead of storing it in the temporary file and copying it over
+       * after the moov at the end */
+      if (qtmux->downstream_seekable
+          && reserved_max_duration != GST_CLOCK_TIME_NONE
+          && reserved_max_duration != 0) {
+        GST_INFO_OBJECT (qtmux, "reserving space for the moov instead of "
+            "using a temporary file for faststart");
+        qtmux->mux_mode = GST_QT_MUX_MODE_MOOV_AT_END;
+        qtmux->fast_start_reserved = TRUE;
+      }
+      break;                    /* Don't need seekability otherwise */
     case GST_QT_MUX_MODE_FRAGMENTED:
       if (qtmux->fragment_mode == GST_QT_MUX_FRAGMENT_STREAMABLE)
         break;
@@ -3205,6 +3221,34 @@ gst_qt_mux_start_file (GstQTMux * qtmux)
       if (ret != GST_FLOW_OK)
         break;
 
+      if (qtmux->fast_start_reserved) {
+        guint64 size = 0, offset = 0;
+
+        /* Reserve the size of the moov without any samples plus the
+         * estimate for the index tables of reserved-max-duration, filled
+         * with a free atom until the moov is written there at the end */
+        qtmux->moov_pos = qtmux->header_size;
+        gst_qt_mux_configure_moov (qtmux);
+        if (!atom_moov_copy_data (qtmux->moov, NULL, &size, &offset)) {
+          GST_ELEMENT_ERROR (qtmux, STREAM, MUX, (NULL),
+              ("Failed to serialize moov"));
+          return GST_FLOW_ERROR;
+        }
+        qtmux->base_moov_size = offset;
+        qtmux->reserved_moov_size = qtmux->base_moov_size +
+            gst_util_uint64_scale (reserved_max_duration,
+            reserved_bytes_per_sec_per_trak *
+            atom_moov_get_trak_count (qtmux->moov), GST_SECOND);
+
+        GST_DEBUG_OBJECT (qtmux, "reserving %u bytes for the moov",
+            qtmux->reserved_moov_size);
+
+        ret = gst_qt_mux_send_free_atom (qtmux, &qtmux->header_size,
+            qtmux->reserved_moov_size, FALSE);
+        if (ret != GST_FLOW_OK)
+          break;
+      }
+
       /* Store this as the mdat offset for later updating
        * when we write the moov */
       qtmux->mdat_pos = qtmux->header_size;
@@ -4137,6 +4181,50 @@ gst_qt_mux_stop_file (GstQTMux * qtmux)
    * the chunk offsets stored into the moov */
   atom_moov_chunks_set_offset (qtmux->moov, offset);
 
+  if (qtmux->fast_start_reserved) {
+    guint64 moov_size = 0;
+
+    size = 0;
+    if (!atom_moov_copy_data (qtmux->moov, NULL, &size, &moov_size))
+      goto serialize_error;
+    ret = gst_qt_mux_send_extra_atoms (qtmux, FALSE, &moov_size, FALSE);
+    if (ret != GST_FLOW_OK)
+      return ret;
+
+    /* the remaining reserved space must be either empty or large enough for
+     * a free atom header */
+    if (moov_size == qtmux->reserved_moov_size
+        || moov_size + 8 <= qtmux->reserved_moov_size) {
+      GST_DEBUG_OBJECT (qtmux, "writing moov of size %" G_GUINT64_FORMAT
+          " into the %u reserved bytes", moov_size, qtmux->reserved_moov_size);
+
+      gst_qt_mux_seek_to (qtmux, qtmux->moov_pos);
+      ret = gst_qt_mux_send_moov (qtmux, NULL, 0, FALSE, FALSE);
+      if (ret != GST_FLOW_OK)
+        return ret;
+      ret = gst_qt_mux_send_extra_atoms (qtmux, TRUE, NULL, FALSE);
+      if (ret != GST_FLOW_OK)
+        return ret;
+      if (moov_size < qtmux->reserved_moov_size) {
+        ret = gst_qt_mux_send_free_atom (qtmux, NULL,
+            qtmux->reserved_moov_size - moov_size, FALSE);
+        if (ret != GST_FLOW_OK)
+          return ret;
+      }
+
+      return gst_qt_mux_update_mdat_size (qtmux, qtmux->mdat_pos,
+          qtmux->mdat_size, NULL, FALSE);
+    }
+
+    /* The file is still valid with the moov at the end, the reserved space
+     * just stays a free atom */
+    GST_ELEMENT_WARNING (qtmux, STREAM, MUX, (NULL),
+        ("moov of size %" G_GUINT64_FORMAT " does not fit into the %u "
+            "reserved bytes, writing it at the end of the file. Increase "
+            "reserved-max-duration or reserved-bytes-per-sec for faststart "
+            "output", moov_size, qtmux->reserved_moov_size));
+  }
+
   /* write out moov and extra atoms */
   /* note: as of this point, we no longer care about tracking written data size,
    * since there is no more use for it anyway */
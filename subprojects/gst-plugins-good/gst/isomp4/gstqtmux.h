@@ -338,6 +338,10 @@ struct _GstQTMux
   /* True if the first moov in the ping-pong buffers
    * is the active one. See gst_qt_mux_robust_recording_rewrite_moov() */
   gboolean reserved_moov_first_active;
+  /* True if faststart output is produced by writing the moov into
+   * reserved_moov_size bytes reserved before the mdat, instead of going
+   * through the temporary file */
+  gboolean fast_start_reserved;
 
   /* Tracking of periodic MOOV updates */
   GstClockTime last_moov_update;
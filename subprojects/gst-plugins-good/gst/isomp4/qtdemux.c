@@ -88,6 +88,14 @@
 /* if the sample index is larger than this, something is likely wrong */
 #define QTDEMUX_MAX_SAMPLE_INDEX_SIZE (200*1024*1024)
 
+/* amount of data read at once from upstream in pull mode for reads smaller
+ * than this, following reads within that range are served from it */
+#define QTDEMUX_PULL_CACHE_SIZE (512 * 1024)
+
+/* number of samples parsed at once from the stbl tables when moving past the
+ * already parsed samples */
+#define QTDEMUX_SAMPLE_PARSE_WINDOW 4096
+
 /* For converting qt creation times to unix epoch times */
 #define QTDEMUX_SECONDS_PER_DAY (60 * 60 * 24)
 #define QTDEMUX_LEAP_YEARS_FROM_1904_TO_1970 17
@@ -364,6 +372,8 @@ static GstCaps *qtdemux_generic_caps (GstQTDemux * qtdemux,
     QtDemuxStream * stream, QtDemuxStreamStsdEntry * entry, guint32 fourcc,
     const guint8 * stsd_entry_data, gchar ** codec_name);
 
+static gboolean qtdemux_ensure_samples (GstQTDemux * qtdemux,
+    QtDemuxStream * stream, guint32 n);
 static gboolean qtdemux_parse_samples (GstQTDemux * qtdemux,
     QtDemuxStream * stream, guint32 n);
 static GstFlowReturn qtdemux_expose_streams (GstQTDemux * qtdemux);
@@ -452,6 +462,7 @@ gst_qtdemux_init (GstQTDemux * qtdemux)
   g_queue_init (&qtdemux->protection_event_queue);
   qtdemux->flowcombiner = gst_flow_combiner_new ();
   g_mutex_init (&qtdemux->expose_lock);
+  g_mutex_init (&qtdemux->pull_cache_lock);
 
   qtdemux->active_streams = g_ptr_array_new_with_free_func
       ((GDestroyNotify) gst_qtdemux_stream_unref);
@@ -471,6 +482,7 @@ gst_qtdemux_finalize (GObject * object)
   g_free (qtdemux->redirect_location);
   g_free (qtdemux->cenc_aux_info_sizes);
   g_mutex_clear (&qtdemux->expose_lock);
+  g_mutex_clear (&qtdemux->pull_cache_lock);
 
   g_ptr_array_free (qtdemux->active_streams, TRUE);
   g_ptr_array_free (qtdemux->old_streams, TRUE);
@@ -486,6 +498,7 @@ gst_qtdemux_dispose (GObject * object)
   g_clear_object (&qtdemux->adapter);
   gst_clear_tag_list (&qtdemux->tag_list);
   g_clear_pointer (&qtdemux->flowcombiner, gst_flow_combiner_unref);
+  gst_clear_buffer (&qtdemux->pull_cache);
 
   g_queue_clear_full (&qtdemux->protection_event_queue,
       (GDestroyNotify) gst_event_unref);
@@ -515,6 +528,56 @@ _gst_buffer_new_wrapped (gpointer mem, gsize size, GFreeFunc free_func)
       mem, size, 0, size, mem, free_func);
 }
 
+/* pull @size bytes at @offset from upstream.
+ *
+ * Small reads are served from a buffer of QTDEMUX_PULL_CACHE_SIZE read ahead
+ * from upstream, so that reading the atoms of a chain of fragments or the
+ * interleaved samples of the streams one by one results in a few larger
+ * reads instead of a round-trip per atom or sample, e.g. over HTTP. */
+static GstFlowReturn
+gst_qtdemux_pull_range (GstQTDemux * qtdemux, guint64 offset, guint size,
+    GstBuffer ** buf)
+{
+  GstFlowReturn flow = GST_FLOW_OK;
+  guint64 cache_size;
+
+  /* let upstream read into preallocated buffers directly */
+  if (*buf || size >= QTDEMUX_PULL_CACHE_SIZE)
+    return gst_pad_pull_range (qtdemux->sinkpad, offset, size, buf);
+
+  g_mutex_lock (&qtdemux->pull_cache_lock);
+  if (qtdemux->pull_cache) {
+    cache_size = gst_buffer_get_size (qtdemux->pull_cache);
+    if (offset >= qtdemux->pull_cache_offset
+        && offset + size <= qtdemux->pull_cache_offset + cache_size)
+      goto from_cache;
+
+    gst_clear_buffer (&qtdemux->pull_cache);
+  }
+
+  flow = gst_pad_pull_range (qtdemux->sinkpad, offset,
+      QTDEMUX_PULL_CACHE_SIZE, &qtdemux->pull_cache);
+  if (G_UNLIKELY (flow != GST_FLOW_OK)) {
+    g_mutex_unlock (&qtdemux->pull_cache_lock);
+    return flow;
+  }
+
+  GST_LOG_OBJECT (qtdemux, "read ahead %" G_GSIZE_FORMAT " bytes at offset %"
+      G_GUINT64_FORMAT, gst_buffer_get_size (qtdemux->pull_cache), offset);
+
+  qtdemux->pull_cache_offset = offset;
+  cache_size = gst_buffer_get_size (qtdemux->pull_cache);
+
+from_cache:
+  /* a short read at the end of the file is caught by the caller */
+  *buf = gst_buffer_copy_region (qtdemux->pull_cache, GST_BUFFER_COPY_ALL,
+      offset - qtdemux->pull_cache_offset,
+      MIN (size, qtdemux->pull_cache_offset + cache_size - offset));
+  g_mutex_unlock (&qtdemux->pull_cache_lock);
+
+  return flow;
+}
+
 static GstFlowReturn
 gst_qtdemux_pull_atom (GstQTDemux * qtdemux, guint64 offset, guint64 size,
     GstBuffer ** buf)
@@ -555,7 +618,7 @@ gst_qtdemux_pull_atom (GstQTDemux * qtdemux, guint64 offset, guint64 size,
     }
   }
 
-  flow = gst_pad_pull_range (qtdemux->sinkpad, offset, size, buf);
+  flow = gst_qtdemux_pull_range (qtdemux, offset, size, buf);
 
   if (G_UNLIKELY (flow != GST_FLOW_OK))
     return flow;
@@ -913,7 +976,7 @@ gst_qtdemux_find_index_for_given_media_offset_linear (GstQTDemux * qtdemux,
 
   result++;
   while (index < str->n_samples - 1) {
-    if (!qtdemux_parse_samples (qtdemux, str, index + 1))
+    if (!qtdemux_ensure_samples (qtdemux, str, index + 1))
       goto parse_failed;
 
     if (media_offset < result->offset)
@@ -961,7 +1024,7 @@ gst_qtdemux_find_index_linear (GstQTDemux * qtdemux, QtDemuxStream * str,
     sample = str->samples + index;
   } else {
     while (index < str->n_samples - 1) {
-      if (!qtdemux_parse_samples (qtdemux, str, index + 1))
+      if (!qtdemux_ensure_samples (qtdemux, str, index + 1))
         goto parse_failed;
 
       sample = str->samples + index + 1;
@@ -1015,7 +1078,7 @@ gst_qtdemux_find_keyframe (GstQTDemux * qtdemux, QtDemuxStream * str,
 
   /* else search until we have a keyframe */
   while (new_index < str->n_samples) {
-    if (next && !qtdemux_parse_samples (qtdemux, str, new_index))
+    if (next && !qtdemux_ensure_samples (qtdemux, str, new_index))
       goto parse_failed;
 
     if (str->samples[new_index].keyframe)
@@ -1176,7 +1239,8 @@ gst_qtdemux_adjust_seek (GstQTDemux * qtdemux, gint64 desired_time,
 
     /* shift to next frame if we are looking for next keyframe */
     if (next && QTSAMPLE_PTS_NO_CSLG (str, &str->samples[index]) < media_start
-        && index < str->stbl_index)
+        && index + 1 < str->n_samples
+        && qtdemux_ensure_samples (qtdemux, str, index + 1))
       index++;
 
     if (!empty_segment) {
@@ -1659,10 +1723,12 @@ gst_qtdemux_handle_src_event (GstPad * pad, GstObject * parent,
       gst_event_parse_seek_trickmode_interval (event,
           &qtdemux->trickmode_interval);
 
-      /* Build complete index for seeking;
-       * if not a fragmented file at least and we're really doing a seek,
-       * not just an instant-rate-change */
-      if (!qtdemux->fragmented && !instant_rate_change) {
+      /* Build complete index for seeking in push mode, where the sample
+       * for the byte position of the new upstream segment is looked up in
+       * the whole sample table; if not a fragmented file at least and we're
+       * really doing a seek, not just an instant-rate-change.
+       * In pull mode the samples are only parsed up to the seek position */
+      if (!qtdemux->pullbased && !qtdemux->fragmented && !instant_rate_change) {
         if (!qtdemux_ensure_index (qtdemux))
           goto index_failed;
       }
@@ -1985,6 +2051,10 @@ gst_qtdemux_reset (GstQTDemux * qtdemux, gboolean hard)
 
   GST_DEBUG_OBJECT (qtdemux, "Resetting demux");
 
+  g_mutex_lock (&qtdemux->pull_cache_lock);
+  gst_clear_buffer (&qtdemux->pull_cache);
+  g_mutex_unlock (&qtdemux->pull_cache_lock);
+
   if (hard || qtdemux->upstream_format_is_time) {
     qtdemux->state = QTDEMUX_STATE_INITIAL;
     qtdemux->neededbytes = 16;
@@ -5427,7 +5497,7 @@ gst_qtdemux_prepare_current_sample (GstQTDemux * qtdemux,
     while (stream->sample_index >= stream->n_samples);
   }
 
-  if (!qtdemux_parse_samples (qtdemux, stream, stream->sample_index)) {
+  if (!qtdemux_ensure_samples (qtdemux, stream, stream->sample_index)) {
     GST_LOG_OBJECT (qtdemux, "Parsing of index %u failed!",
         stream->sample_index);
     return FALSE;
@@ -5490,7 +5560,7 @@ gst_qtdemux_advance_sample (GstQTDemux * qtdemux, QtDemuxStream * stream)
   if (G_UNLIKELY (stream->sample_index >= stream->n_samples))
     goto next_segment;
 
-  if (!qtdemux_parse_samples (qtdemux, stream, stream->sample_index)) {
+  if (!qtdemux_ensure_samples (qtdemux, stream, stream->sample_index)) {
     GST_LOG_OBJECT (qtdemux, "Parsing of index %u failed!",
         stream->sample_index);
     return;
@@ -6736,7 +6806,7 @@ gst_qtdemux_loop_state_movie (GstQTDemux * qtdemux)
 
       /* Failed to parse sample so let's go back to the previous one that was
        * still successful */
-      if (!qtdemux_parse_samples (qtdemux, stream, stream->sample_index)) {
+      if (!qtdemux_ensure_samples (qtdemux, stream, stream->sample_index)) {
         stream->sample_index--;
         break;
       }
@@ -7060,7 +7130,7 @@ next_entry_size (GstQTDemux * demux)
       continue;
     }
 
-    if (!qtdemux_parse_samples (demux, stream, stream->sample_index)) {
+    if (!qtdemux_ensure_samples (demux, stream, stream->sample_index)) {
       GST_LOG_OBJECT (demux, "Parsing of index %u from stbl atom failed!",
           stream->sample_index);
       return -1;
@@ -9873,6 +9943,26 @@ no_samples:
   }
 }
 
+/* make sure sample @n of @stream is parsed.
+ *
+ * When @n is past the already parsed samples, a whole window of samples
+ * following it is parsed at once so that walking the sample table during
+ * playback or when searching for a seek position does not go through the
+ * stbl parser for every single sample. Samples are only ever materialized up
+ * to the current playback or seek position plus this window. */
+static gboolean
+qtdemux_ensure_samples (GstQTDemux * qtdemux, QtDemuxStream * stream,
+    guint32 n)
+{
+  if (n < stream->n_samples && n > stream->stbl_index && stream->stsz.data) {
+    guint64 last = (guint64) n + QTDEMUX_SAMPLE_PARSE_WINDOW - 1;
+
+    n = MIN (last, stream->n_samples - 1);
+  }
+
+  return qtdemux_parse_samples (qtdemux, stream, n);
+}
+
 /* collect samples from the next sample to be parsed up to sample @n for @stream
  * by reading the info from @stbl
  *
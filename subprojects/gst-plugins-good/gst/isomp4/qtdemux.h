@@ -90,6 +90,13 @@ struct _GstQTDemux {
   /* TRUE if pull-based */
   gboolean pullbased;
 
+  /* PULL-BASED only: data read ahead from upstream so that consecutive small
+   * reads of atoms and samples don't each cause a pull_range() upstream,
+   * protected by pull_cache_lock */
+  GMutex pull_cache_lock;
+  GstBuffer *pull_cache;
+  guint64 pull_cache_offset;
+
   gchar *redirect_location;
 
   /* Protect pad exposing from flush event */
@@ -63,6 +63,7 @@
 #include <gst/audio/audio.h>
 
 #include "gstlevel.h"
+#include "gstloudness.h"
 
 GST_DEBUG_CATEGORY_STATIC (level_debug);
 #define GST_CAT_DEFAULT level_debug
@@ -822,7 +823,12 @@ gst_level_sink_event (GstBaseTransform * trans, GstEvent * event)
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
-  return GST_ELEMENT_REGISTER (level, plugin);
+  gboolean ret = FALSE;
+
+  ret |= GST_ELEMENT_REGISTER (level, plugin);
+  ret |= GST_ELEMENT_REGISTER (loudness, plugin);
+
+  return ret;
 }
 
 GST_PLUGIN_DEFINE (GST_VERSION_MAJOR,
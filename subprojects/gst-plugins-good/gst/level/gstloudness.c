@@ -0,0 +1,669 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-loudness
+ * @title: loudness
+ * @see_also: level
+ *
+ * Loudness measures the loudness of the incoming audio as specified by
+ * ITU-R BS.1770 and EBU R 128. The channels are K-weighted and summed, LFE
+ * channels are ignored and surround channels weighted with +1.5 dB.
+ *
+ * If the #GstLoudness:post-messages property is %TRUE, it generates an
+ * element message named `loudness` after each interval of time given by the
+ * #GstLoudness:interval property. Unlike the messages of level it contains
+ * no per-channel values, only these fields:
+ *
+ * * #GstClockTime `timestamp`: the start of the interval.
+ * * #GstClockTime `stream-time`: the stream time of the interval.
+ * * #GstClockTime `running-time`: the running time of the interval.
+ * * #GstClockTime `duration`: the duration of the interval.
+ * * #gdouble `momentary`: the loudness over the last 400ms in LUFS.
+ * * #gdouble `short-term`: the loudness over the last 3s in LUFS.
+ * * #gdouble `integrated`: the gated loudness since the start of the stream
+ *   in LUFS.
+ *
+ * The same values can also be read at any time from the properties of the
+ * element, so applications watching many streams can poll them and disable
+ * the messages. All values are updated every 100ms and are -inf when there
+ * was no signal.
+ *
+ * ## Example launch line
+ * |[
+ * gst-launch-1.0 -m uridecodebin uri=file:///path/to/file ! audioconvert ! loudness ! fakesink
+ * ]|
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <math.h>
+#include <string.h>
+#include <gst/gst.h>
+#include <gst/audio/audio.h>
+
+#include "gstloudness.h"
+
+GST_DEBUG_CATEGORY_STATIC (loudness_debug);
+#define GST_CAT_DEFAULT loudness_debug
+
+/* blocks below this are ignored for the integrated loudness */
+#define ABSOLUTE_GATE -70.0
+/* and blocks this far below the ungated loudness */
+#define RELATIVE_GATE -10.0
+
+#define CAPS \
+    "audio/x-raw, " \
+    "format = (string) { " GST_AUDIO_NE (S16) ", " GST_AUDIO_NE (S32) ", " \
+    GST_AUDIO_NE (F32) ", " GST_AUDIO_NE (F64) " }, " \
+    "layout = (string) interleaved, " \
+    "rate = (int) [ 1, MAX ], " "channels = (int) [ 1, MAX ]"
+
+static GstStaticPadTemplate sink_template_factory =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (CAPS)
+    );
+
+static GstStaticPadTemplate src_template_factory =
+GST_STATIC_PAD_TEMPLATE ("src",
+    GST_PAD_SRC,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (CAPS)
+    );
+
+enum
+{
+  PROP_0,
+  PROP_POST_MESSAGES,
+  PROP_INTERVAL,
+  PROP_MOMENTARY,
+  PROP_SHORT_TERM,
+  PROP_INTEGRATED,
+};
+
+/* mean square of each histogram bin */
+static gdouble bin_power[GST_LOUDNESS_HISTOGRAM_BINS];
+
+#define gst_loudness_parent_class parent_class
+G_DEFINE_TYPE (GstLoudness, gst_loudness, GST_TYPE_BASE_TRANSFORM);
+GST_ELEMENT_REGISTER_DEFINE (loudness, "loudness", GST_RANK_NONE,
+    GST_TYPE_LOUDNESS);
+
+static void gst_loudness_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_loudness_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+static void gst_loudness_finalize (GObject * obj);
+
+static gboolean gst_loudness_set_caps (GstBaseTransform * trans, GstCaps * in,
+    GstCaps * out);
+static gboolean gst_loudness_start (GstBaseTransform * trans);
+static GstFlowReturn gst_loudness_transform_ip (GstBaseTransform * trans,
+    GstBuffer * in);
+static gboolean gst_loudness_sink_event (GstBaseTransform * trans,
+    GstEvent * event);
+static void gst_loudness_post_message (GstLoudness * self);
+static void gst_loudness_recalc_interval_frames (GstLoudness * self);
+
+static void
+gst_loudness_class_init (GstLoudnessClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+  GstBaseTransformClass *trans_class = GST_BASE_TRANSFORM_CLASS (klass);
+  guint i;
+
+  gobject_class->set_property = gst_loudness_set_property;
+  gobject_class->get_property = gst_loudness_get_property;
+  gobject_class->finalize = gst_loudness_finalize;
+
+  g_object_class_install_property (gobject_class, PROP_POST_MESSAGES,
+      g_param_spec_boolean ("post-messages", "Post Messages",
+          "Whether to post a 'loudness' element message on the bus for each "
+          "passed interval", TRUE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_INTERVAL,
+      g_param_spec_uint64 ("interval", "Interval",
+          "Interval of time between message posts (in nanoseconds)",
+          1, G_MAXUINT64, GST_SECOND,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_MOMENTARY,
+      g_param_spec_double ("momentary", "Momentary",
+          "Loudness over the last 400ms (in LUFS)",
+          -INFINITY, G_MAXDOUBLE, -INFINITY,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_SHORT_TERM,
+      g_param_spec_double ("short-term", "Short-term",
+          "Loudness over the last 3s (in LUFS)",
+          -INFINITY, G_MAXDOUBLE, -INFINITY,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+  g_object_class_install_property (gobject_class, PROP_INTEGRATED,
+      g_param_spec_double ("integrated", "Integrated",
+          "Gated loudness since the start of the stream (in LUFS)",
+          -INFINITY, G_MAXDOUBLE, -INFINITY,
+          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  GST_DEBUG_CATEGORY_INIT (loudness_debug, "loudness", 0,
+      "Loudness calculation");
+
+  gst_element_class_add_static_pad_template (element_class,
+      &sink_template_factory);
+  gst_element_class_add_static_pad_template (element_class,
+      &src_template_factory);
+  gst_element_class_set_static_metadata (element_class, "Loudness",
+      "Filter/Analyzer/Audio",
+      "EBU R 128 loudness messager for audio/raw",
+      "GStreamer maintainers <gstreamer-devel@lists.freedesktop.org>");
+
+  trans_class->set_caps = GST_DEBUG_FUNCPTR (gst_loudness_set_caps);
+  trans_class->start = GST_DEBUG_FUNCPTR (gst_loudness_start);
+  trans_class->transform_ip = GST_DEBUG_FUNCPTR (gst_loudness_transform_ip);
+  trans_class->sink_event = GST_DEBUG_FUNCPTR (gst_loudness_sink_event);
+
+  for (i = 0; i < GST_LOUDNESS_HISTOGRAM_BINS; i++)
+    bin_power[i] = pow (10.0, (ABSOLUTE_GATE + (i + 0.5) / 10.0 + 0.691) / 10.);
+}
+
+static void
+gst_loudness_init (GstLoudness * self)
+{
+  gst_audio_info_init (&self->info);
+
+  self->interval = GST_SECOND;
+  self->post_messages = TRUE;
+  self->message_ts = GST_CLOCK_TIME_NONE;
+
+  gst_base_transform_set_passthrough (GST_BASE_TRANSFORM (self), TRUE);
+}
+
+static void
+gst_loudness_finalize (GObject * obj)
+{
+  GstLoudness *self = GST_LOUDNESS (obj);
+
+  g_free (self->channels);
+  self->channels = NULL;
+
+  G_OBJECT_CLASS (parent_class)->finalize (obj);
+}
+
+static gdouble
+power_to_lufs (gdouble power)
+{
+  if (power <= 0.0)
+    return -INFINITY;
+
+  return -0.691 + 10.0 * log10 (power);
+}
+
+/* called with object lock */
+static gdouble
+gst_loudness_get_power (GstLoudness * self, guint steps)
+{
+  gdouble sum = 0.0;
+  guint i, pos = self->step_pos;
+
+  for (i = 0; i < steps; i++) {
+    pos = pos == 0 ? GST_LOUDNESS_STEPS - 1 : pos - 1;
+    sum += self->steps[pos];
+  }
+
+  return sum / steps;
+}
+
+/* called with object lock */
+static gdouble
+gst_loudness_get_integrated (GstLoudness * self)
+{
+  gdouble sum = 0.0, threshold;
+  guint64 count = 0;
+  guint i;
+
+  for (i = 0; i < GST_LOUDNESS_HISTOGRAM_BINS; i++) {
+    sum += self->histogram[i] * bin_power[i];
+    count += self->histogram[i];
+  }
+
+  if (count == 0)
+    return -INFINITY;
+
+  threshold = power_to_lufs (sum / count) + RELATIVE_GATE;
+
+  sum = 0.0;
+  count = 0;
+  for (i = 0; i < GST_LOUDNESS_HISTOGRAM_BINS; i++) {
+    if (ABSOLUTE_GATE + (i + 0.5) / 10.0 <= threshold)
+      continue;
+    sum += self->histogram[i] * bin_power[i];
+    count += self->histogram[i];
+  }
+
+  if (count == 0)
+    return -INFINITY;
+
+  return power_to_lufs (sum / count);
+}
+
+static void
+gst_loudness_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstLoudness *self = GST_LOUDNESS (object);
+
+  GST_OBJECT_LOCK (self);
+
+  switch (prop_id) {
+    case PROP_POST_MESSAGES:
+      self->post_messages = g_value_get_boolean (value);
+      break;
+    case PROP_INTERVAL:
+      self->interval = g_value_get_uint64 (value);
+      if (GST_AUDIO_INFO_RATE (&self->info)) {
+        gst_loudness_recalc_interval_frames (self);
+      }
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+
+  GST_OBJECT_UNLOCK (self);
+}
+
+static void
+gst_loudness_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstLoudness *self = GST_LOUDNESS (object);
+
+  GST_OBJECT_LOCK (self);
+
+  switch (prop_id) {
+    case PROP_POST_MESSAGES:
+      g_value_set_boolean (value, self->post_messages);
+      break;
+    case PROP_INTERVAL:
+      g_value_set_uint64 (value, self->interval);
+      break;
+    case PROP_MOMENTARY:
+      g_value_set_double (value,
+          power_to_lufs (gst_loudness_get_power (self, 4)));
+      break;
+    case PROP_SHORT_TERM:
+      g_value_set_double (value,
+          power_to_lufs (gst_loudness_get_power (self, GST_LOUDNESS_STEPS)));
+      break;
+    case PROP_INTEGRATED:
+      g_value_set_double (value, gst_loudness_get_integrated (self));
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+
+  GST_OBJECT_UNLOCK (self);
+}
+
+/* K-weight @frames interleaved frames of all channels and add their squares
+ * to the sums of the channels. The filter is the cascade of a high shelf and
+ * a high pass biquad, both in transposed direct form II and run over one
+ * channel at a time so that the coefficients and state stay in registers. */
+#define DEFINE_PROCESS_FUNC(TYPE, SCALE)                                \
+static void                                                             \
+gst_loudness_process_##TYPE (GstLoudness * self, gpointer data,        \
+    guint frames)                                                       \
+{                                                                       \
+  const TYPE *in = data;                                                \
+  guint channels = GST_AUDIO_INFO_CHANNELS (&self->info);               \
+  gdouble b0 = self->b[0], b1 = self->b[1], b2 = self->b[2];            \
+  gdouble a1 = self->a[0], a2 = self->a[1];                             \
+  gdouble c1 = self->a2[0], c2 = self->a2[1];                           \
+  guint i, c;                                                           \
+                                                                        \
+  for (c = 0; c < channels; c++) {                                      \
+    GstLoudnessChannel *ch = &self->channels[c];                        \
+    gdouble z0 = ch->z[0], z1 = ch->z[1], z2 = ch->z[2], z3 = ch->z[3]; \
+    gdouble sum = 0.0;                                                  \
+                                                                        \
+    if (ch->weight == 0.0)                                              \
+      continue;                                                         \
+                                                                        \
+    for (i = 0; i < frames; i++) {                                      \
+      gdouble x = in[i * channels + c] * (SCALE);                       \
+      gdouble y, w;                                                     \
+                                                                        \
+      y = b0 * x + z0;                                                  \
+      z0 = b1 * x - a1 * y + z1;                                        \
+      z1 = b2 * x - a2 * y;                                             \
+                                                                        \
+      w = y + z2;                                                       \
+      z2 = -2.0 * y - c1 * w + z3;                                      \
+      z3 = y - c2 * w;                                                  \
+                                                                        \
+      sum += w * w;                                                     \
+    }                                                                   \
+                                                                        \
+    /* don't let the state decay into denormals on silence */           \
+    ch->z[0] = fabs (z0) < 1e-30 ? 0.0 : z0;                            \
+    ch->z[1] = fabs (z1) < 1e-30 ? 0.0 : z1;                            \
+    ch->z[2] = fabs (z2) < 1e-30 ? 0.0 : z2;                            \
+    ch->z[3] = fabs (z3) < 1e-30 ? 0.0 : z3;                            \
+    ch->sum += sum;                                                     \
+  }                                                                     \
+}
+
+DEFINE_PROCESS_FUNC (gint16, 1.0 / 32768.0);
+DEFINE_PROCESS_FUNC (gint32, 1.0 / 2147483648.0);
+DEFINE_PROCESS_FUNC (gfloat, 1.0);
+DEFINE_PROCESS_FUNC (gdouble, 1.0);
+
+/* called with object lock */
+static void
+gst_loudness_reset (GstLoudness * self)
+{
+  guint i, channels = GST_AUDIO_INFO_CHANNELS (&self->info);
+
+  for (i = 0; i < channels; i++) {
+    memset (self->channels[i].z, 0, sizeof (self->channels[i].z));
+    self->channels[i].sum = 0.0;
+  }
+
+  memset (self->steps, 0, sizeof (self->steps));
+  memset (self->histogram, 0, sizeof (self->histogram));
+  self->step_fill = 0;
+  self->step_pos = 0;
+  self->num_steps = 0;
+}
+
+/* called with object lock when a 100ms step is complete */
+static void
+gst_loudness_end_step (GstLoudness * self)
+{
+  guint i, channels = GST_AUDIO_INFO_CHANNELS (&self->info);
+  gdouble power = 0.0, block;
+
+  for (i = 0; i < channels; i++) {
+    power += self->channels[i].weight * self->channels[i].sum;
+    self->channels[i].sum = 0.0;
+  }
+
+  self->steps[self->step_pos] = power / self->step_frames;
+  self->step_pos = (self->step_pos + 1) % GST_LOUDNESS_STEPS;
+  self->step_fill = 0;
+  self->num_steps++;
+
+  /* gating blocks are 400ms long and overlap by 75% */
+  if (self->num_steps < 4)
+    return;
+
+  block = power_to_lufs (gst_loudness_get_power (self, 4));
+  if (block > ABSOLUTE_GATE) {
+    gint bin = (block - ABSOLUTE_GATE) * 10.0;
+
+    self->histogram[MIN (bin, GST_LOUDNESS_HISTOGRAM_BINS - 1)]++;
+  }
+}
+
+/* called with object lock */
+static void
+gst_loudness_recalc_interval_frames (GstLoudness * self)
+{
+  GstClockTime interval = self->interval;
+  guint sample_rate = GST_AUDIO_INFO_RATE (&self->info);
+  guint interval_frames;
+
+  interval_frames = GST_CLOCK_TIME_TO_FRAMES (interval, sample_rate);
+
+  if (interval_frames == 0) {
+    GST_WARNING_OBJECT (self, "interval %" GST_TIME_FORMAT " is too small, "
+        "should be at least %" GST_TIME_FORMAT " for sample rate %u",
+        GST_TIME_ARGS (interval),
+        GST_TIME_ARGS (GST_FRAMES_TO_CLOCK_TIME (1, sample_rate)), sample_rate);
+    interval_frames = 1;
+  }
+
+  self->interval_frames = interval_frames;
+}
+
+static gdouble
+channel_weight (GstAudioChannelPosition position)
+{
+  switch (position) {
+    case GST_AUDIO_CHANNEL_POSITION_LFE1:
+    case GST_AUDIO_CHANNEL_POSITION_LFE2:
+      return 0.0;
+    case GST_AUDIO_CHANNEL_POSITION_REAR_LEFT:
+    case GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT:
+    case GST_AUDIO_CHANNEL_POSITION_SIDE_LEFT:
+    case GST_AUDIO_CHANNEL_POSITION_SIDE_RIGHT:
+      return 1.41;
+    default:
+      return 1.0;
+  }
+}
+
+static gboolean
+gst_loudness_set_caps (GstBaseTransform * trans, GstCaps * in, GstCaps * out)
+{
+  GstLoudness *self = GST_LOUDNESS (trans);
+  GstAudioInfo info;
+  gdouble f0, G, Q, K, Vh, Vb, a0;
+  gint i, channels, rate;
+
+  if (!gst_audio_info_from_caps (&info, in))
+    return FALSE;
+
+  GST_OBJECT_LOCK (self);
+
+  switch (GST_AUDIO_INFO_FORMAT (&info)) {
+    case GST_AUDIO_FORMAT_S16:
+      self->process = gst_loudness_process_gint16;
+      break;
+    case GST_AUDIO_FORMAT_S32:
+      self->process = gst_loudness_process_gint32;
+      break;
+    case GST_AUDIO_FORMAT_F32:
+      self->process = gst_loudness_process_gfloat;
+      break;
+    case GST_AUDIO_FORMAT_F64:
+      self->process = gst_loudness_process_gdouble;
+      break;
+    default:
+      self->process = NULL;
+      break;
+  }
+
+  self->info = info;
+  channels = GST_AUDIO_INFO_CHANNELS (&info);
+  rate = GST_AUDIO_INFO_RATE (&info);
+
+  g_free (self->channels);
+  self->channels = g_new0 (GstLoudnessChannel, channels);
+  for (i = 0; i < channels; i++)
+    self->channels[i].weight = channel_weight (info.position[i]);
+
+  /* the filters of BS.1770 are only specified for 48kHz, derive them for
+   * other rates from the analog prototypes they were designed from */
+  f0 = 1681.974450955533;
+  G = 3.999843853973347;
+  Q = 0.7071752369554196;
+  K = tan (G_PI * f0 / rate);
+  Vh = pow (10.0, G / 20.0);
+  Vb = pow (Vh, 0.4996667741545416);
+  a0 = 1.0 + K / Q + K * K;
+  self->b[0] = (Vh + Vb * K / Q + K * K) / a0;
+  self->b[1] = 2.0 * (K * K - Vh) / a0;
+  self->b[2] = (Vh - Vb * K / Q + K * K) / a0;
+  self->a[0] = 2.0 * (K * K - 1.0) / a0;
+  self->a[1] = (1.0 - K / Q + K * K) / a0;
+
+  f0 = 38.13547087602444;
+  Q = 0.5003270373238773;
+  K = tan (G_PI * f0 / rate);
+  a0 = 1.0 + K / Q + K * K;
+  self->a2[0] = 2.0 * (K * K - 1.0) / a0;
+  self->a2[1] = (1.0 - K / Q + K * K) / a0;
+
+  self->step_frames = MAX (rate / 10, 1);
+  gst_loudness_reset (self);
+  gst_loudness_recalc_interval_frames (self);
+
+  GST_OBJECT_UNLOCK (self);
+  return TRUE;
+}
+
+static gboolean
+gst_loudness_start (GstBaseTransform * trans)
+{
+  GstLoudness *self = GST_LOUDNESS (trans);
+
+  GST_OBJECT_LOCK (self);
+  self->num_frames = 0;
+  self->message_ts = GST_CLOCK_TIME_NONE;
+  if (self->channels)
+    gst_loudness_reset (self);
+  GST_OBJECT_UNLOCK (self);
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_loudness_transform_ip (GstBaseTransform * trans, GstBuffer * in)
+{
+  GstLoudness *self = GST_LOUDNESS (trans);
+  GstMapInfo map;
+  guint8 *in_data;
+  guint num_frames, block_size, bpf;
+
+  bpf = GST_AUDIO_INFO_BPF (&self->info);
+
+  gst_buffer_map (in, &map, GST_MAP_READ);
+  in_data = map.data;
+  num_frames = map.size / bpf;
+
+  GST_LOG_OBJECT (self, "analyzing %u sample frames at ts %" GST_TIME_FORMAT,
+      num_frames, GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (in)));
+
+  GST_OBJECT_LOCK (self);
+
+  if (GST_BUFFER_FLAG_IS_SET (in, GST_BUFFER_FLAG_DISCONT)) {
+    self->message_ts = GST_BUFFER_TIMESTAMP (in);
+    self->num_frames = 0;
+  }
+  if (G_UNLIKELY (!GST_CLOCK_TIME_IS_VALID (self->message_ts))) {
+    self->message_ts = GST_BUFFER_TIMESTAMP (in);
+  }
+
+  while (num_frames > 0) {
+    /* subdivide to not skip steps or message intervals */
+    block_size = self->step_frames - self->step_fill;
+    block_size = MIN (block_size, self->interval_frames - self->num_frames);
+    block_size = MIN (block_size, num_frames);
+
+    self->process (self, in_data, block_size);
+
+    in_data += block_size * bpf;
+    num_frames -= block_size;
+    self->step_fill += block_size;
+    self->num_frames += block_size;
+
+    if (self->step_fill >= self->step_frames)
+      gst_loudness_end_step (self);
+
+    if (self->num_frames >= self->interval_frames)
+      gst_loudness_post_message (self);
+  }
+
+  GST_OBJECT_UNLOCK (self);
+
+  gst_buffer_unmap (in, &map);
+
+  return GST_FLOW_OK;
+}
+
+/* called with object lock */
+static void
+gst_loudness_post_message (GstLoudness * self)
+{
+  GstBaseTransform *trans = GST_BASE_TRANSFORM_CAST (self);
+  gint frames = self->num_frames;
+  GstClockTime duration;
+
+  duration = GST_FRAMES_TO_CLOCK_TIME (frames, GST_AUDIO_INFO_RATE (&self->info));
+
+  if (self->post_messages && frames > 0) {
+    GstStructure *s;
+    GstClockTime running_time, stream_time;
+
+    running_time = gst_segment_to_running_time (&trans->segment,
+        GST_FORMAT_TIME, self->message_ts);
+    stream_time = gst_segment_to_stream_time (&trans->segment,
+        GST_FORMAT_TIME, self->message_ts);
+
+    s = gst_structure_new ("loudness",
+        "timestamp", G_TYPE_UINT64, self->message_ts,
+        "stream-time", G_TYPE_UINT64, stream_time,
+        "running-time", G_TYPE_UINT64, running_time,
+        "duration", G_TYPE_UINT64, duration,
+        "momentary", G_TYPE_DOUBLE,
+        power_to_lufs (gst_loudness_get_power (self, 4)),
+        "short-term", G_TYPE_DOUBLE,
+        power_to_lufs (gst_loudness_get_power (self, GST_LOUDNESS_STEPS)),
+        "integrated", G_TYPE_DOUBLE, gst_loudness_get_integrated (self), NULL);
+
+    GST_OBJECT_UNLOCK (self);
+    gst_element_post_message (GST_ELEMENT (self),
+        gst_message_new_element (GST_OBJECT (self), s));
+    GST_OBJECT_LOCK (self);
+  }
+
+  self->num_frames -= frames;
+  self->message_ts += duration;
+}
+
+static gboolean
+gst_loudness_sink_event (GstBaseTransform * trans, GstEvent * event)
+{
+  GstLoudness *self = GST_LOUDNESS (trans);
+
+  switch (GST_EVENT_TYPE (event)) {
+    case GST_EVENT_EOS:
+      GST_OBJECT_LOCK (self);
+      if (GST_AUDIO_INFO_RATE (&self->info))
+        gst_loudness_post_message (self);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    case GST_EVENT_FLUSH_STOP:
+      GST_OBJECT_LOCK (self);
+      self->num_frames = 0;
+      self->message_ts = GST_CLOCK_TIME_NONE;
+      if (self->channels)
+        gst_loudness_reset (self);
+      GST_OBJECT_UNLOCK (self);
+      break;
+    default:
+      break;
+  }
+
+  return GST_BASE_TRANSFORM_CLASS (parent_class)->sink_event (trans, event);
+}
@@ -0,0 +1,102 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __GST_LOUDNESS_H__
+#define __GST_LOUDNESS_H__
+
+
+#include <gst/gst.h>
+#include <gst/base/gstbasetransform.h>
+#include <gst/audio/audio.h>
+
+G_BEGIN_DECLS
+
+
+#define GST_TYPE_LOUDNESS \
+  (gst_loudness_get_type())
+#define GST_LOUDNESS(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_LOUDNESS,GstLoudness))
+#define GST_LOUDNESS_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_LOUDNESS,GstLoudnessClass))
+#define GST_IS_LOUDNESS(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_LOUDNESS))
+#define GST_IS_LOUDNESS_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_LOUDNESS))
+
+
+typedef struct _GstLoudness GstLoudness;
+typedef struct _GstLoudnessClass GstLoudnessClass;
+typedef struct _GstLoudnessChannel GstLoudnessChannel;
+
+/* 100ms steps, the momentary window is 4 and the short-term window 30 steps */
+#define GST_LOUDNESS_STEPS 30
+/* 0.1 LU bins from -70 to +30 LUFS for the integrated loudness */
+#define GST_LOUDNESS_HISTOGRAM_BINS 1000
+
+struct _GstLoudnessChannel {
+  gdouble weight;               /* 0.0 for LFE channels */
+  gdouble z[4];                 /* state of the two K-weighting biquads */
+  gdouble sum;                  /* sum of squares of the current step */
+};
+
+/**
+ * GstLoudness:
+ *
+ * Opaque data structure.
+ */
+struct _GstLoudness {
+  GstBaseTransform element;
+
+  /* properties, protected by object lock */
+  gboolean post_messages;
+  guint64 interval;
+
+  GstAudioInfo info;
+  GstLoudnessChannel *channels;
+
+  /* K-weighting coefficients, b0 of the second stage is 1, b1 -2, b2 1 */
+  gdouble b[3], a[2], a2[2];
+
+  guint step_frames;            /* frames per 100ms step */
+  guint step_fill;              /* frames in the current step */
+  gdouble steps[GST_LOUDNESS_STEPS];   /* mean square of the last steps */
+  guint step_pos;
+  guint64 num_steps;
+
+  guint32 histogram[GST_LOUDNESS_HISTOGRAM_BINS];
+
+  gint num_frames;              /* frames since last emit */
+  gint interval_frames;         /* after how many frames to send a message */
+  GstClockTime message_ts;      /* starttime for next message */
+
+  void (*process) (GstLoudness *, gpointer, guint);
+};
+
+struct _GstLoudnessClass {
+  GstBaseTransformClass parent_class;
+};
+
+GType gst_loudness_get_type (void);
+
+GST_ELEMENT_REGISTER_DECLARE (loudness);
+
+G_END_DECLS
+
+
+#endif /* __GST_LOUDNESS_H__ */
@@ -332,6 +332,11 @@ gst_matroska_demux_reset (GstElement * element)
     demux->clusters = NULL;
   }
 
+  if (demux->scanned_clusters) {
+    g_array_unref (demux->scanned_clusters);
+    demux->scanned_clusters = NULL;
+  }
+
   g_list_foreach (demux->seek_parsed,
       (GFunc) gst_matroska_read_common_free_parsed_el, NULL);
   g_list_free (demux->seek_parsed);
@@ -2103,6 +2108,45 @@ gst_matroska_cluster_compare (gint64 * i1, gint64 * i2)
     return 0;
 }
 
+/* remembers cluster @offset starting at @time, so later searches can start
+ * bisecting from the closest known clusters instead of the whole file */
+static void
+gst_matroska_demux_remember_cluster (GstMatroskaDemux * demux, guint64 offset,
+    GstClockTime time)
+{
+  GstMatroskaIndex entry = { 0, };
+  GstMatroskaIndex *next;
+  guint idx;
+
+  if (demux->streaming || !GST_CLOCK_TIME_IS_VALID (time))
+    return;
+
+  if (G_UNLIKELY (!demux->scanned_clusters))
+    demux->scanned_clusters =
+        g_array_sized_new (FALSE, FALSE, sizeof (GstMatroskaIndex), 100);
+
+  next = gst_util_array_binary_search (demux->scanned_clusters->data,
+      demux->scanned_clusters->len, sizeof (GstMatroskaIndex),
+      (GCompareDataFunc) gst_matroska_index_seek_find, GST_SEARCH_MODE_AFTER,
+      &time, NULL);
+
+  if (next) {
+    if (next->time == time)
+      return;
+    idx = next - (GstMatroskaIndex *) demux->scanned_clusters->data;
+  } else {
+    idx = demux->scanned_clusters->len;
+  }
+
+  entry.pos = offset;
+  entry.time = time;
+  g_array_insert_val (demux->scanned_clusters, idx, entry);
+
+  GST_LOG_OBJECT (demux, "remembered cluster at offset %" G_GUINT64_FORMAT
+      " with time %" GST_TIME_FORMAT " (%u known)", offset,
+      GST_TIME_ARGS (time), demux->scanned_clusters->len);
+}
+
 /* searches for a cluster start from @pos,
  * return GST_FLOW_OK and cluster position in @pos if found */
 static GstFlowReturn
@@ -2578,6 +2622,34 @@ gst_matroska_demux_search_pos (GstMatroskaDemux * demux, GstClockTime time)
   otime = MAX (otime, atime);
   opos = MAX (opos, apos);
 
+  /* narrow down using the clusters seen so far around the target */
+  if (demux->scanned_clusters && GST_CLOCK_TIME_IS_VALID (time)) {
+    GstMatroskaIndex *before, *after;
+
+    before = gst_util_array_binary_search (demux->scanned_clusters->data,
+        demux->scanned_clusters->len, sizeof (GstMatroskaIndex),
+        (GCompareDataFunc) gst_matroska_index_seek_find,
+        GST_SEARCH_MODE_BEFORE, &time, NULL);
+    after = gst_util_array_binary_search (demux->scanned_clusters->data,
+        demux->scanned_clusters->len, sizeof (GstMatroskaIndex),
+        (GCompareDataFunc) gst_matroska_index_seek_find,
+        GST_SEARCH_MODE_AFTER, &time, NULL);
+
+    if (before && before->time > atime && before->pos > apos) {
+      apos = before->pos;
+      atime = before->time;
+      otime = MAX (otime, atime);
+      opos = MAX (opos, apos);
+    }
+    if (after && after->time > time && after->pos >= apos &&
+        (otime <= time || after->time < otime)) {
+      opos = after->pos;
+      otime = after->time;
+    }
+    GST_DEBUG_OBJECT (demux, "known clusters narrowed search to %"
+        G_GINT64_FORMAT " - %" G_GINT64_FORMAT, apos, opos);
+  }
+
   maxpos = gst_matroska_read_common_get_length (&demux->common);
 
   /* invariants;
@@ -5770,6 +5842,9 @@ gst_matroska_demux_parse_id (GstMatroskaDemux * demux, guint32 id,
             demux->stream_last_time =
                 demux->cluster_time * demux->common.time_scale;
           }
+          if (!demux->common.index || demux->common.index->len == 0)
+            gst_matroska_demux_remember_cluster (demux, demux->cluster_offset,
+                demux->cluster_time * demux->common.time_scale);
 #if 0
           if (demux->common.element_index) {
             if (demux->common.element_index_writer_id == -1)
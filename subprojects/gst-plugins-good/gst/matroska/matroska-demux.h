@@ -75,6 +75,9 @@ typedef struct _GstMatroskaDemux {
 
   /* cluster positions (optional) */
   GArray                  *clusters;
+  /* GstMatroskaIndex of clusters seen while playing or scanning, sorted by
+   * time, used to narrow down later bisections in files without cues */
+  GArray                  *scanned_clusters;
 
   /* keeping track of playback position */
   GstClockTime             last_stop_end;
@@ -1293,6 +1293,10 @@ gst_splitmux_part_reader_get_end_offset (GstSplitMuxPartReader * reader)
       ret = part_pad->max_ts;
   }
 
+  /* Not prepared (yet), use the duration we were told about */
+  if (reader->pads == NULL && GST_CLOCK_TIME_IS_VALID (reader->duration))
+    ret = reader->start_offset + reader->duration;
+
   SPLITMUX_PART_UNLOCK (reader);
 
   return ret;
@@ -1334,6 +1338,27 @@ gst_splitmux_part_reader_get_duration (GstSplitMuxPartReader * reader)
   return dur;
 }
 
+void
+gst_splitmux_part_reader_set_duration (GstSplitMuxPartReader * reader,
+    GstClockTime duration)
+{
+  SPLITMUX_PART_LOCK (reader);
+  reader->duration = duration;
+  SPLITMUX_PART_UNLOCK (reader);
+}
+
+gboolean
+gst_splitmux_part_reader_is_prepared (GstSplitMuxPartReader * reader)
+{
+  gboolean ret;
+
+  SPLITMUX_PART_LOCK (reader);
+  ret = reader->prep_state == PART_STATE_READY;
+  SPLITMUX_PART_UNLOCK (reader);
+
+  return ret;
+}
+
 GstPad *
 gst_splitmux_part_reader_lookup_pad (GstSplitMuxPartReader * reader,
     GstPad * target)
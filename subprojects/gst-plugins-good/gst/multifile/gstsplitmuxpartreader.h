@@ -100,6 +100,7 @@ void gst_splitmux_part_reader_set_callbacks (GstSplitMuxPartReader *reader,
     gpointer cb_data, GstSplitMuxPartReaderPadCb get_pad_cb);
 gboolean gst_splitmux_part_reader_prepare (GstSplitMuxPartReader *part);
 void gst_splitmux_part_reader_unprepare (GstSplitMuxPartReader *part);
+gboolean gst_splitmux_part_reader_is_prepared (GstSplitMuxPartReader *reader);
 void gst_splitmux_part_reader_set_location (GstSplitMuxPartReader *reader,
     const gchar *path);
 gboolean gst_splitmux_part_is_eos (GstSplitMuxPartReader *reader);
@@ -113,6 +114,7 @@ void gst_splitmux_part_reader_set_start_offset (GstSplitMuxPartReader *part, Gst
 GstClockTime gst_splitmux_part_reader_get_start_offset (GstSplitMuxPartReader *part);
 GstClockTime gst_splitmux_part_reader_get_end_offset (GstSplitMuxPartReader *part);
 GstClockTime gst_splitmux_part_reader_get_duration (GstSplitMuxPartReader * reader);
+void gst_splitmux_part_reader_set_duration (GstSplitMuxPartReader * reader, GstClockTime duration);
 
 GstPad *gst_splitmux_part_reader_lookup_pad (GstSplitMuxPartReader *reader, GstPad *target);
 GstFlowReturn gst_splitmux_part_reader_pop (GstSplitMuxPartReader *reader, GstPad *part_pad, GstDataQueueItem ** item);
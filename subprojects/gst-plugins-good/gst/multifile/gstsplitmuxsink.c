@@ -119,7 +119,9 @@ enum
   PROP_SINK_FACTORY,
   PROP_SINK_PRESET,
   PROP_SINK_PROPERTIES,
-  PROP_MUXERPAD_MAP
+  PROP_MUXERPAD_MAP,
+  PROP_MAX_PENDING_FINALIZATIONS,
+  PROP_INDEX_LOCATION
 };
 
 #define DEFAULT_MAX_SIZE_TIME       0
@@ -133,6 +135,7 @@ enum
 #define DEFAULT_USE_ROBUST_MUXING FALSE
 #define DEFAULT_RESET_MUXER TRUE
 #define DEFAULT_ASYNC_FINALIZE FALSE
+#define DEFAULT_MAX_PENDING_FINALIZATIONS 0
 #define DEFAULT_START_INDEX 0
 
 typedef struct _AsyncEosHelper
@@ -401,6 +404,40 @@ gst_splitmux_sink_class_init (GstSplitMuxSinkClass * klass)
           "Finalize fragments asynchronously",
           "Finalize each fragment asynchronously and start a new one",
           DEFAULT_ASYNC_FINALIZE, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstSplitMuxSink:max-pending-finalizations
+   *
+   * The maximum number of previous fragments that are still being finalized
+   * in the background in `async-finalize=TRUE` mode. When the limit is
+   * reached, starting the next fragment waits until one of them is done, so
+   * that slow storage can't accumulate an unbounded number of open muxers and
+   * sinks. 0 means no limit.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_MAX_PENDING_FINALIZATIONS,
+      g_param_spec_uint ("max-pending-finalizations",
+          "Maximum pending finalizations",
+          "Maximum number of fragments being finalized at the same time "
+          "(0 = unlimited). Valid only for async-finalize = TRUE",
+          0, G_MAXUINT, DEFAULT_MAX_PENDING_FINALIZATIONS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+  /**
+   * GstSplitMuxSink:index-location
+   *
+   * Location of an index file to write. Each closed fragment appends one
+   * line with the serialized splitmuxsink-fragment-closed structure, giving
+   * its location and running time. splitmuxsrc can use this with its
+   * #GstSplitMuxSrc:index-location property to avoid opening every
+   * fragment on startup.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_INDEX_LOCATION,
+      g_param_spec_string ("index-location", "Index Location",
+          "Location of a file to write the fragment index to", NULL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
   g_object_class_install_property (gobject_class, PROP_MUXER_FACTORY,
       g_param_spec_string ("muxer-factory", "Muxer factory",
           "The muxer element factory to use (default = mp4mux). "
@@ -612,6 +649,7 @@ gst_splitmux_sink_init (GstSplitMuxSink * splitmux)
   splitmux->threshold_timecode_str = NULL;
 
   splitmux->async_finalize = DEFAULT_ASYNC_FINALIZE;
+  splitmux->max_pending_finalizations = DEFAULT_MAX_PENDING_FINALIZATIONS;
   splitmux->muxer_factory = g_strdup (DEFAULT_MUXER);
   splitmux->muxer_properties = NULL;
   splitmux->sink_factory = g_strdup (DEFAULT_SINK);
@@ -700,6 +738,9 @@ gst_splitmux_sink_finalize (GObject * object)
     gst_queue_array_free (splitmux->times_to_split);
 
   g_free (splitmux->location);
+  g_free (splitmux->index_location);
+  if (splitmux->index_file)
+    fclose (splitmux->index_file);
 
   /* Make sure to free any un-released contexts. There should not be any,
    * because the dispose will have freed all request pads though */
@@ -855,6 +896,19 @@ gst_splitmux_sink_set_property (GObject * object, guint prop_id,
       splitmux->async_finalize = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (splitmux);
       break;
+    case PROP_MAX_PENDING_FINALIZATIONS:
+      GST_SPLITMUX_LOCK (splitmux);
+      splitmux->max_pending_finalizations = g_value_get_uint (value);
+      /* wake up a fragment switch waiting for the old limit */
+      GST_SPLITMUX_BROADCAST_OUTPUT (splitmux);
+      GST_SPLITMUX_UNLOCK (splitmux);
+      break;
+    case PROP_INDEX_LOCATION:
+      GST_OBJECT_LOCK (splitmux);
+      g_free (splitmux->index_location);
+      splitmux->index_location = g_value_dup_string (value);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
     case PROP_MUXER_FACTORY:
       GST_OBJECT_LOCK (splitmux);
       if (splitmux->muxer_factory)
@@ -1002,6 +1056,16 @@ gst_splitmux_sink_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, splitmux->async_finalize);
       GST_OBJECT_UNLOCK (splitmux);
       break;
+    case PROP_MAX_PENDING_FINALIZATIONS:
+      GST_SPLITMUX_LOCK (splitmux);
+      g_value_set_uint (value, splitmux->max_pending_finalizations);
+      GST_SPLITMUX_UNLOCK (splitmux);
+      break;
+    case PROP_INDEX_LOCATION:
+      GST_OBJECT_LOCK (splitmux);
+      g_value_set_string (value, splitmux->index_location);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
     case PROP_MUXER_FACTORY:
       GST_OBJECT_LOCK (splitmux);
       g_value_set_string (value, splitmux->muxer_factory);
@@ -1141,6 +1205,22 @@ send_fragment_opened_closed_msg (GstSplitMuxSink * splitmux, gboolean opened,
     gst_element_post_message (GST_ELEMENT_CAST (splitmux), msg);
   }
 
+  if (!opened && splitmux->index_file != NULL && location != NULL) {
+    GstStructure *s = gst_structure_new (msg_name,
+        "location", G_TYPE_STRING, location,
+        "running-time", GST_TYPE_CLOCK_TIME, running_time, NULL);
+    gchar *line = gst_structure_to_string (s);
+
+    /* flush right away so that a reader always sees complete fragments */
+    if (fprintf (splitmux->index_file, "%s\n", line) < 0
+        || fflush (splitmux->index_file) != 0) {
+      GST_WARNING_OBJECT (splitmux, "Failed to write index entry for %s",
+          location);
+    }
+    g_free (line);
+    gst_structure_free (s);
+  }
+
   g_free (location);
 }
 
@@ -1977,10 +2057,24 @@ _set_property_from_structure (GQuark field_id, const GValue * value,
 static void
 _lock_and_set_to_null (GstElement * element, GstSplitMuxSink * splitmux)
 {
+  gboolean is_sink = g_object_get_qdata ((GObject *) element,
+      EOS_FROM_US) != NULL;
+
   gst_element_set_locked_state (element, TRUE);
   gst_element_set_state (element, GST_STATE_NULL);
   GST_LOG_OBJECT (splitmux, "Removing old element %" GST_PTR_FORMAT, element);
   gst_bin_remove (GST_BIN (splitmux), element);
+
+  /* The fragment is complete once its sink is closed */
+  if (is_sink) {
+    GST_SPLITMUX_LOCK (splitmux);
+    if (splitmux->pending_finalizations > 0)
+      splitmux->pending_finalizations--;
+    GST_DEBUG_OBJECT (splitmux, "Fragment finalized, %u still pending",
+        splitmux->pending_finalizations);
+    GST_SPLITMUX_BROADCAST_OUTPUT (splitmux);
+    GST_SPLITMUX_UNLOCK (splitmux);
+  }
 }
 
 
@@ -2004,6 +2098,19 @@ start_next_fragment (GstSplitMuxSink * splitmux, MqStreamCtx * ctx)
 
   g_assert (ctx->is_reference);
 
+  /* Don't let the fragments that are still being finalized in the
+   * background pile up */
+  while (splitmux->async_finalize && splitmux->max_pending_finalizations > 0
+      && splitmux->pending_finalizations >=
+      splitmux->max_pending_finalizations
+      && splitmux->output_state != SPLITMUX_OUTPUT_STATE_STOPPED) {
+    GST_DEBUG_OBJECT (splitmux, "Waiting for one of %u pending fragments "
+        "to be finalized", splitmux->pending_finalizations);
+    GST_SPLITMUX_WAIT_OUTPUT (splitmux);
+  }
+  if (splitmux->output_state == SPLITMUX_OUTPUT_STATE_STOPPED)
+    return GST_FLOW_FLUSHING;
+
   /* 1 change to new file */
   splitmux->switching_fragment = TRUE;
 
@@ -2036,6 +2143,7 @@ start_next_fragment (GstSplitMuxSink * splitmux, MqStreamCtx * ctx)
       g_list_foreach (splitmux->contexts, (GFunc) block_context, splitmux);
       newname = g_strdup_printf ("sink_%u", splitmux->fragment_id);
       GST_SPLITMUX_LOCK (splitmux);
+      splitmux->pending_finalizations++;
       if ((splitmux->sink =
               create_element (splitmux, splitmux->sink_factory, newname,
                   TRUE)) == NULL)
@@ -3997,7 +4105,26 @@ gst_splitmux_sink_change_state (GstElement * element, GstStateChange transition)
       break;
     }
     case GST_STATE_CHANGE_READY_TO_PAUSED:{
+      gchar *index_location;
+
+      GST_OBJECT_LOCK (splitmux);
+      index_location = g_strdup (splitmux->index_location);
+      GST_OBJECT_UNLOCK (splitmux);
+
       GST_SPLITMUX_LOCK (splitmux);
+      if (index_location != NULL && index_location[0] != '\0') {
+        splitmux->index_file = g_fopen (index_location, "w");
+        if (splitmux->index_file == NULL) {
+          GST_ELEMENT_ERROR (splitmux, RESOURCE, OPEN_WRITE, (NULL),
+              ("Could not open index file %s for writing", index_location));
+          GST_SPLITMUX_UNLOCK (splitmux);
+          g_free (index_location);
+          ret = GST_STATE_CHANGE_FAILURE;
+          goto beach;
+        }
+      }
+      g_free (index_location);
+
       /* Make sure contexts and tracking times are cleared, in case we're being reused */
       gst_splitmux_sink_reset (splitmux);
       /* Start by collecting one input on each pad */
@@ -4044,6 +4171,14 @@ gst_splitmux_sink_change_state (GstElement * element, GstStateChange transition)
     case GST_STATE_CHANGE_PLAYING_TO_PAUSED:
       splitmux->need_async_start = TRUE;
       break;
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      GST_SPLITMUX_LOCK (splitmux);
+      if (splitmux->index_file) {
+        fclose (splitmux->index_file);
+        splitmux->index_file = NULL;
+      }
+      GST_SPLITMUX_UNLOCK (splitmux);
+      break;
     case GST_STATE_CHANGE_READY_TO_PAUSED:{
       /* Change state async, because our child sink might not
        * be ready to do that for us yet if it's state is still locked */
@@ -20,6 +20,7 @@
 #ifndef __GST_SPLITMUXSINK_H__
 #define __GST_SPLITMUXSINK_H__
 
+#include <stdio.h>
 #include <gst/gst.h>
 #include <gst/pbutils/pbutils.h>
 #include <gst/base/base.h>
@@ -214,6 +215,12 @@ struct _GstSplitMuxSink
 
   /* Async finalize options */
   gboolean async_finalize;
+  /* protected by the splitmux lock */
+  guint max_pending_finalizations;
+  guint pending_finalizations;
+  gchar *index_location;        /* OBJECT_LOCK */
+  /* index of closed fragments, protected by the splitmux lock */
+  FILE *index_file;
   gchar *muxer_factory;
   gchar *muxer_preset;
   GstStructure *muxer_properties;
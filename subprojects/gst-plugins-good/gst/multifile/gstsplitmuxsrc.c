@@ -60,9 +60,13 @@ GST_DEBUG_CATEGORY (splitmux_debug);
 enum
 {
   PROP_0,
-  PROP_LOCATION
+  PROP_LOCATION,
+  PROP_INDEX_LOCATION,
+  PROP_NUM_OPEN_FRAGMENTS
 };
 
+#define DEFAULT_NUM_OPEN_FRAGMENTS 0
+
 enum
 {
   SIGNAL_FORMAT_LOCATION,
@@ -235,6 +239,39 @@ gst_splitmux_src_class_init (GstSplitMuxSrcClass * klass)
           "Glob pattern for the location of the files to read", NULL,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstSplitMuxSrc:index-location:
+   *
+   * Location of an index file as written by splitmuxsink's
+   * #GstSplitMuxSink:index-location. The index provides the fragment
+   * locations and running times, so only the first fragment has to be
+   * opened on startup and others are opened when playback or a seek
+   * reaches them. #GstSplitMuxSrc:location and the format-location signal
+   * are only used if the index can't be read.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_INDEX_LOCATION,
+      g_param_spec_string ("index-location", "Index Location",
+          "Location of the fragment index file written by splitmuxsink", NULL,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstSplitMuxSrc:num-open-fragments:
+   *
+   * Maximum number of fragments that are kept open once they were used.
+   * The least recently used fragments are closed again when the limit
+   * is exceeded. Fragments that are currently playing are never closed.
+   * 0 means no limit.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_NUM_OPEN_FRAGMENTS,
+      g_param_spec_uint ("num-open-fragments", "Number of open fragments",
+          "Maximum number of fragments kept open (0 = unlimited)", 0,
+          G_MAXUINT, DEFAULT_NUM_OPEN_FRAGMENTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstSplitMuxSrc::format-location:
    * @splitmux: the #GstSplitMuxSrc
@@ -256,6 +293,7 @@ gst_splitmux_src_init (GstSplitMuxSrc * splitmux)
   g_mutex_init (&splitmux->lock);
   g_rw_lock_init (&splitmux->pads_rwlock);
   splitmux->total_duration = GST_CLOCK_TIME_NONE;
+  splitmux->num_open_fragments = DEFAULT_NUM_OPEN_FRAGMENTS;
   gst_segment_init (&splitmux->play_segment, GST_FORMAT_TIME);
 }
 
@@ -287,6 +325,7 @@ gst_splitmux_src_finalize (GObject * object)
   g_mutex_clear (&splitmux->lock);
   g_rw_lock_clear (&splitmux->pads_rwlock);
   g_free (splitmux->location);
+  g_free (splitmux->index_location);
 
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
@@ -305,6 +344,17 @@ gst_splitmux_src_set_property (GObject * object, guint prop_id,
       GST_OBJECT_UNLOCK (splitmux);
       break;
     }
+    case PROP_INDEX_LOCATION:
+      GST_OBJECT_LOCK (splitmux);
+      g_free (splitmux->index_location);
+      splitmux->index_location = g_value_dup_string (value);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
+    case PROP_NUM_OPEN_FRAGMENTS:
+      GST_OBJECT_LOCK (splitmux);
+      splitmux->num_open_fragments = g_value_get_uint (value);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -323,6 +373,16 @@ gst_splitmux_src_get_property (GObject * object, guint prop_id,
       g_value_set_string (value, splitmux->location);
       GST_OBJECT_UNLOCK (splitmux);
       break;
+    case PROP_INDEX_LOCATION:
+      GST_OBJECT_LOCK (splitmux);
+      g_value_set_string (value, splitmux->index_location);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
+    case PROP_NUM_OPEN_FRAGMENTS:
+      GST_OBJECT_LOCK (splitmux);
+      g_value_set_uint (value, splitmux->num_open_fragments);
+      GST_OBJECT_UNLOCK (splitmux);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -408,17 +468,139 @@ gst_splitmux_src_change_state (GstElement * element, GstStateChange transition)
   return ret;
 }
 
+/* Must be called without the splitmux lock, as preparing a part
+ * needs it to link up the output pads */
+static gboolean
+gst_splitmux_src_ensure_part_prepared (GstSplitMuxSrc * splitmux, guint idx)
+{
+  GstSplitMuxPartReader *reader = splitmux->parts[idx];
+
+  /* Still preparing the parts one after another at startup */
+  if (!splitmux->parts_on_demand)
+    return TRUE;
+
+  if (gst_splitmux_part_reader_is_prepared (reader))
+    return TRUE;
+
+  GST_DEBUG_OBJECT (splitmux, "Preparing file part %s (%u) on demand",
+      reader->path, idx);
+
+  if (!gst_splitmux_part_reader_prepare (reader) ||
+      gst_element_get_state (GST_ELEMENT_CAST (reader), NULL, NULL,
+          GST_CLOCK_TIME_NONE) != GST_STATE_CHANGE_SUCCESS) {
+    GST_WARNING_OBJECT (splitmux, "Failed to prepare file part %s",
+        reader->path);
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/* Called with the splitmux lock. Returns a reference to the least recently
+ * used part if more than num-open-fragments parts are prepared now */
+static GstSplitMuxPartReader *
+gst_splitmux_src_mark_part_used (GstSplitMuxSrc * splitmux, guint idx)
+{
+  guint i, limit, n_open = 0;
+  gint lru = -1;
+  GList *cur;
+
+  splitmux->part_last_used[idx] = ++splitmux->use_counter;
+
+  GST_OBJECT_LOCK (splitmux);
+  limit = splitmux->num_open_fragments;
+  GST_OBJECT_UNLOCK (splitmux);
+
+  if (limit == 0)
+    return NULL;
+
+  SPLITMUX_SRC_PADS_RLOCK (splitmux);
+  for (i = 0; i < splitmux->num_parts; i++) {
+    GstSplitMuxPartReader *reader = splitmux->parts[i];
+    gboolean in_use;
+
+    if (reader == NULL || !gst_splitmux_part_reader_is_prepared (reader))
+      continue;
+    n_open++;
+
+    in_use = i == splitmux->cur_part
+        || gst_splitmux_part_reader_is_active (reader);
+    for (cur = splitmux->pads; cur != NULL && !in_use; cur = cur->next)
+      in_use = ((SplitMuxSrcPad *) cur->data)->cur_part == i;
+    if (in_use)
+      continue;
+
+    if (lru == -1 || splitmux->part_last_used[i] <
+        splitmux->part_last_used[lru])
+      lru = i;
+  }
+  SPLITMUX_SRC_PADS_RUNLOCK (splitmux);
+
+  if (n_open <= limit || lru == -1)
+    return NULL;
+
+  return gst_object_ref (splitmux->parts[lru]);
+}
+
+/* Must be called without the splitmux lock */
+static void
+gst_splitmux_src_close_part (GstSplitMuxSrc * splitmux,
+    GstSplitMuxPartReader * reader)
+{
+  if (reader == NULL)
+    return;
+
+  GST_DEBUG_OBJECT (splitmux, "Closing least recently used part %s",
+      reader->path);
+  gst_splitmux_part_reader_unprepare (reader);
+  gst_object_unref (reader);
+}
+
 static void
 gst_splitmux_src_activate_first_part (GstSplitMuxSrc * splitmux)
 {
+  GstSplitMuxPartReader *lru = NULL;
+
   SPLITMUX_SRC_LOCK (splitmux);
   if (splitmux->running) {
     if (!gst_splitmux_src_activate_part (splitmux, 0, GST_SEEK_FLAG_NONE)) {
       GST_ELEMENT_ERROR (splitmux, RESOURCE, OPEN_READ, (NULL),
           ("Failed to activate first part for playback"));
+    } else {
+      lru = gst_splitmux_src_mark_part_used (splitmux, 0);
     }
   }
   SPLITMUX_SRC_UNLOCK (splitmux);
+
+  gst_splitmux_src_close_part (splitmux, lru);
+}
+
+/* Called once the first part is prepared, to place the other parts
+ * according to the running times from the index */
+static void
+gst_splitmux_src_apply_index (GstSplitMuxSrc * splitmux)
+{
+  GstClockTime offset = splitmux->end_offset;
+  guint i;
+
+  for (i = 1; i < splitmux->num_parts; i++) {
+    GstClockTime duration = 0;
+
+    if (splitmux->index_times[i] > splitmux->index_times[i - 1])
+      duration = splitmux->index_times[i] - splitmux->index_times[i - 1];
+
+    gst_splitmux_part_reader_set_start_offset (splitmux->parts[i], offset,
+        FIXED_TS_OFFSET);
+    gst_splitmux_part_reader_set_duration (splitmux->parts[i], duration);
+    offset += duration;
+  }
+
+  GST_OBJECT_LOCK (splitmux);
+  splitmux->total_duration = offset;
+  splitmux->play_segment.duration = splitmux->total_duration;
+  GST_OBJECT_UNLOCK (splitmux);
+
+  splitmux->end_offset = offset;
 }
 
 static GstBusSyncReply
@@ -432,6 +614,12 @@ gst_splitmux_part_bus_handler (GstBus * bus, GstMessage * msg,
       guint idx = splitmux->num_prepared_parts;
       gboolean need_no_more_pads;
 
+      if (splitmux->parts_on_demand) {
+        /* A part prepared on demand, whoever prepared it is waiting
+         * for it to reach PAUSED */
+        break;
+      }
+
       if (idx >= splitmux->num_parts) {
         /* Shouldn't really happen! */
         do_async_done (splitmux);
@@ -472,11 +660,26 @@ gst_splitmux_part_bus_handler (GstBus * bus, GstMessage * msg,
 
       splitmux->num_prepared_parts++;
 
-      /* If we're done or preparing the next part fails, finish here */
-      if (splitmux->num_prepared_parts >= splitmux->num_parts
+      if (splitmux->index_times != NULL) {
+        /* The index told us about the other parts, they are prepared
+         * once playback gets to them */
+        gst_splitmux_src_apply_index (splitmux);
+        splitmux->num_prepared_parts = splitmux->num_parts;
+        splitmux->parts_on_demand = TRUE;
+        do_async_done (splitmux);
+
+        GST_INFO_OBJECT (splitmux,
+            "First part prepared. Total duration from index %" GST_TIME_FORMAT
+            " Activating first part", GST_TIME_ARGS (splitmux->total_duration));
+        gst_element_call_async (GST_ELEMENT_CAST (splitmux),
+            (GstElementCallAsyncFunc) gst_splitmux_src_activate_first_part,
+            NULL, NULL);
+      } else if (splitmux->num_prepared_parts >= splitmux->num_parts
           || !gst_splitmux_src_prepare_next_part (splitmux)) {
+        /* If we're done or preparing the next part fails, finish here */
         /* Store how many parts we actually prepared in the end */
         splitmux->num_parts = splitmux->num_prepared_parts;
+        splitmux->parts_on_demand = TRUE;
         do_async_done (splitmux);
 
         /* All done preparing, activate the first part */
@@ -515,6 +718,7 @@ gst_splitmux_part_bus_handler (GstBus * bus, GstMessage * msg,
 
         /* Store how many parts we actually prepared in the end */
         splitmux->num_parts = splitmux->num_prepared_parts;
+        splitmux->parts_on_demand = TRUE;
         do_async_done (splitmux);
 
         if (idx > 0) {
@@ -897,6 +1101,111 @@ gst_splitmux_src_prepare_next_part (GstSplitMuxSrc * splitmux)
   return TRUE;
 }
 
+typedef struct
+{
+  gchar *location;
+  GstClockTime running_time;
+} SplitMuxIndexEntry;
+
+static gint
+compare_index_entries (gconstpointer a, gconstpointer b)
+{
+  const SplitMuxIndexEntry *ea = a, *eb = b;
+
+  if (ea->running_time < eb->running_time)
+    return -1;
+  if (ea->running_time > eb->running_time)
+    return 1;
+  return 0;
+}
+
+/* Returns the part locations from the index file and stores the running
+ * times the parts end at, or NULL if there is no usable index */
+static gchar **
+gst_splitmux_src_read_index (GstSplitMuxSrc * splitmux)
+{
+  gchar *index_location, *dirname, *contents = NULL;
+  gchar **lines, **files = NULL;
+  GArray *entries;
+  GError *err = NULL;
+  guint i;
+
+  GST_OBJECT_LOCK (splitmux);
+  index_location = g_strdup (splitmux->index_location);
+  GST_OBJECT_UNLOCK (splitmux);
+
+  if (index_location == NULL || index_location[0] == '\0') {
+    g_free (index_location);
+    return NULL;
+  }
+
+  if (!g_file_get_contents (index_location, &contents, NULL, &err)) {
+    GST_ELEMENT_WARNING (splitmux, RESOURCE, READ, (NULL),
+        ("Failed to read index file %s: %s", index_location, err->message));
+    g_clear_error (&err);
+    g_free (index_location);
+    return NULL;
+  }
+
+  dirname = g_path_get_dirname (index_location);
+  entries = g_array_new (FALSE, FALSE, sizeof (SplitMuxIndexEntry));
+
+  lines = g_strsplit (contents, "\n", -1);
+  for (i = 0; lines[i] != NULL; i++) {
+    GstStructure *s;
+    SplitMuxIndexEntry entry;
+    const gchar *location;
+
+    if (lines[i][0] == '\0')
+      continue;
+
+    s = gst_structure_from_string (lines[i], NULL);
+    if (s == NULL || !(location = gst_structure_get_string (s, "location"))
+        || !gst_structure_get_clock_time (s, "running-time",
+            &entry.running_time)) {
+      GST_WARNING_OBJECT (splitmux, "Ignoring invalid index entry '%s'",
+          lines[i]);
+      if (s)
+        gst_structure_free (s);
+      continue;
+    }
+
+    if (g_path_is_absolute (location))
+      entry.location = g_strdup (location);
+    else
+      entry.location = g_build_filename (dirname, location, NULL);
+    g_array_append_val (entries, entry);
+    gst_structure_free (s);
+  }
+  g_strfreev (lines);
+
+  if (entries->len > 0) {
+    g_array_sort (entries, compare_index_entries);
+
+    files = g_new0 (gchar *, entries->len + 1);
+    splitmux->index_times = g_new (GstClockTime, entries->len);
+    for (i = 0; i < entries->len; i++) {
+      SplitMuxIndexEntry *entry =
+          &g_array_index (entries, SplitMuxIndexEntry, i);
+      files[i] = entry->location;
+      splitmux->index_times[i] = entry->running_time;
+    }
+
+    GST_INFO_OBJECT (splitmux, "Read %u parts from index file %s",
+        entries->len, index_location);
+  } else {
+    GST_ELEMENT_WARNING (splitmux, RESOURCE, READ, (NULL),
+        ("Index file %s contains no fragments", index_location));
+  }
+
+  g_array_free (entries, TRUE);
+  g_free (contents);
+  g_free (dirname);
+  g_free (index_location);
+
+  return files;
+}
+
 static gboolean
 gst_splitmux_src_start (GstSplitMuxSrc * splitmux)
 {
@@ -917,7 +1226,9 @@ gst_splitmux_src_start (GstSplitMuxSrc * splitmux)
 
   GST_DEBUG_OBJECT (splitmux, "Starting");
 
-  g_signal_emit (splitmux, signals[SIGNAL_FORMAT_LOCATION], 0, &files);
+  files = gst_splitmux_src_read_index (splitmux);
+  if (files == NULL)
+    g_signal_emit (splitmux, signals[SIGNAL_FORMAT_LOCATION], 0, &files);
 
   if (files == NULL || *files == NULL) {
     GST_OBJECT_LOCK (splitmux);
@@ -942,6 +1253,9 @@ gst_splitmux_src_start (GstSplitMuxSrc * splitmux)
   splitmux->num_parts = g_strv_length (files);
 
   splitmux->parts = g_new0 (GstSplitMuxPartReader *, splitmux->num_parts);
+  splitmux->part_last_used = g_new0 (guint64, splitmux->num_parts);
+  splitmux->parts_on_demand = FALSE;
+  splitmux->use_counter = 0;
 
   /* Create all part pipelines */
   for (i = 0; i < splitmux->num_parts; i++) {
@@ -1043,6 +1357,10 @@ gst_splitmux_src_stop (GstSplitMuxSrc * splitmux)
 
   g_free (splitmux->parts);
   splitmux->parts = NULL;
+  g_free (splitmux->part_last_used);
+  splitmux->part_last_used = NULL;
+  g_clear_pointer (&splitmux->index_times, g_free);
+  splitmux->parts_on_demand = FALSE;
   splitmux->num_parts = 0;
   splitmux->num_prepared_parts = 0;
   splitmux->num_created_parts = 0;
@@ -1192,6 +1510,7 @@ gst_splitmux_end_of_part (GstSplitMuxSrc * splitmux, SplitMuxSrcPad * splitpad)
   gint next_part = -1;
   gint cur_part = splitpad->cur_part;
   gboolean res = FALSE;
+  GstSplitMuxPartReader *lru = NULL;
 
   if (splitmux->play_segment.rate >= 0.0) {
     if (cur_part + 1 < splitmux->num_parts)
@@ -1209,6 +1528,14 @@ gst_splitmux_end_of_part (GstSplitMuxSrc * splitmux, SplitMuxSrcPad * splitpad)
     }
   }
 
+  /* The next part might not have been opened yet, or was closed again */
+  if (next_part != -1
+      && !gst_splitmux_src_ensure_part_prepared (splitmux, next_part)) {
+    GST_ELEMENT_ERROR (splitmux, RESOURCE, OPEN_READ, (NULL),
+        ("Failed to prepare part %d", next_part));
+    return FALSE;
+  }
+
   SPLITMUX_SRC_LOCK (splitmux);
 
   /* If all pads are done with this part, deactivate it */
@@ -1269,11 +1596,14 @@ gst_splitmux_end_of_part (GstSplitMuxSrc * splitmux, SplitMuxSrcPad * splitpad)
           goto error;
       }
       splitmux->cur_part = next_part;
+      lru = gst_splitmux_src_mark_part_used (splitmux, next_part);
     }
     res = TRUE;
   }
 
   SPLITMUX_SRC_UNLOCK (splitmux);
+
+  gst_splitmux_src_close_part (splitmux, lru);
   return res;
 error:
   SPLITMUX_SRC_UNLOCK (splitmux);
@@ -1348,6 +1678,7 @@ splitmux_src_pad_event (GstPad * pad, GstObject * parent, GstEvent * event)
       GstClockTime part_start, position;
       GList *cur;
       GstSegment tmp;
+      GstSplitMuxPartReader *lru = NULL;
 
       gst_event_parse_seek (event, &rate, &format, &flags,
           &start_type, &start, &stop_type, &stop);
@@ -1443,8 +1774,19 @@ splitmux_src_pad_event (GstPad * pad, GstObject * parent, GstEvent * event)
           GST_TIME_FORMAT, GST_TIME_ARGS (position),
           i, GST_TIME_ARGS (position - part_start));
 
-      ret = gst_splitmux_src_activate_part (splitmux, i, flags);
+      /* Preparing on demand needs the splitmux lock to link up pads */
+      SPLITMUX_SRC_UNLOCK (splitmux);
+      ret = gst_splitmux_src_ensure_part_prepared (splitmux, i);
+      SPLITMUX_SRC_LOCK (splitmux);
+
+      if (ret && splitmux->running) {
+        ret = gst_splitmux_src_activate_part (splitmux, i, flags);
+        if (ret)
+          lru = gst_splitmux_src_mark_part_used (splitmux, i);
+      }
       SPLITMUX_SRC_UNLOCK (splitmux);
+
+      gst_splitmux_src_close_part (splitmux, lru);
     }
     case GST_EVENT_RECONFIGURE:{
       GST_DEBUG_OBJECT (splitmux, "reconfigure event on pad %" GST_PTR_FORMAT,
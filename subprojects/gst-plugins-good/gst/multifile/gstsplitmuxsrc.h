@@ -48,6 +48,8 @@ struct _GstSplitMuxSrc
   gboolean     running;
 
   gchar       *location;  /* OBJECT_LOCK */
+  gchar       *index_location;  /* OBJECT_LOCK */
+  guint        num_open_fragments;  /* OBJECT_LOCK */
 
   GstSplitMuxPartReader **parts;
   guint        num_parts;
@@ -55,6 +57,15 @@ struct _GstSplitMuxSrc
   guint        num_created_parts;
   guint        cur_part;
 
+  /* Running times at which the parts end according to the index file,
+   * or NULL if the parts were all measured */
+  GstClockTime *index_times;
+  /* Set once the initial preparation is done, parts are (re)opened
+   * on demand from then on */
+  gboolean     parts_on_demand;
+  guint64     *part_last_used;
+  guint64      use_counter;
+
   gboolean async_pending;
   gboolean pads_complete;
 
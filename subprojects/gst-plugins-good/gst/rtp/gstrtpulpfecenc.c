@@ -128,6 +128,9 @@ enum
   PROP_PERCENTAGE_IMPORTANT,
 };
 
+#define PACKETS_BUF_NTH(ctx, n) ((ctx)->packets_buf[((ctx)->packets_buf_first + \
+    (n)) % PACKETS_BUF_MAX_LENGTH])
+
 #define RTP_FEC_MAP_INFO_NTH(ctx, data) (&g_array_index (\
     ((GstRtpUlpFecEncStreamCtx *)ctx)->info_arr, \
     RtpUlpFecMapInfo, \
@@ -144,23 +147,20 @@ dump_stream_ctx_settings (GstRtpUlpFecEncStreamCtx * ctx)
 
 static void
 gst_rtp_ulpfec_enc_stream_ctx_start (GstRtpUlpFecEncStreamCtx * ctx,
-    GQueue * packets, guint fec_packets)
+    guint fec_packets)
 {
-  GList *it = packets->tail;
   guint i;
 
-  g_array_set_size (ctx->info_arr, packets->length);
+  g_array_set_size (ctx->info_arr, ctx->packets_buf_len);
 
-  for (i = 0; i < packets->length; ++i) {
-    GstBuffer *buffer = it->data;
+  for (i = 0; i < ctx->packets_buf_len; ++i) {
+    GstBuffer *buffer = PACKETS_BUF_NTH (ctx, i);
     RtpUlpFecMapInfo *info = RTP_FEC_MAP_INFO_NTH (ctx, i);
 
     if (!rtp_ulpfec_map_info_map (gst_buffer_ref (buffer), info))
       g_assert_not_reached ();
 
     GST_LOG_RTP_PACKET (ctx->parent, "rtp header (incoming)", &info->rtp);
-
-    it = g_list_previous (it);
   }
 
   ctx->fec_packets = fec_packets;
@@ -317,31 +317,52 @@ gst_rtp_ulpfec_enc_stream_ctx_get_fec_packets_num (GstRtpUlpFecEncStreamCtx *
 static void
 gst_rtp_ulpfec_enc_stream_ctx_free_packets_buf (GstRtpUlpFecEncStreamCtx * ctx)
 {
-  while (ctx->packets_buf.length)
-    gst_buffer_unref (g_queue_pop_tail (&ctx->packets_buf));
+  guint i;
+
+  for (i = 0; i < ctx->packets_buf_len; ++i)
+    gst_clear_buffer (&PACKETS_BUF_NTH (ctx, i));
+
+  ctx->packets_buf_first = 0;
+  ctx->packets_buf_len = 0;
 }
 
 static void
 gst_rtp_ulpfec_enc_stream_ctx_prepend_to_fec_buffer (GstRtpUlpFecEncStreamCtx *
     ctx, GstRTPBuffer * rtp, guint buf_max_size)
 {
-  GList *new_head;
-  if (ctx->packets_buf.length == buf_max_size) {
-    new_head = g_queue_pop_tail_link (&ctx->packets_buf);
-  } else {
-    new_head = g_list_alloc ();
+  g_assert_cmpint (buf_max_size, <=, PACKETS_BUF_MAX_LENGTH);
+
+  /* drop the oldest packet if the window is full */
+  if (ctx->packets_buf_len == buf_max_size) {
+    gst_clear_buffer (&PACKETS_BUF_NTH (ctx, 0));
+    ctx->packets_buf_first =
+        (ctx->packets_buf_first + 1) % PACKETS_BUF_MAX_LENGTH;
+    ctx->packets_buf_len--;
   }
 
-  gst_buffer_replace ((GstBuffer **) & new_head->data, rtp->buffer);
-  g_queue_push_head_link (&ctx->packets_buf, new_head);
+  PACKETS_BUF_NTH (ctx, ctx->packets_buf_len) = gst_buffer_ref (rtp->buffer);
+  ctx->packets_buf_len++;
+}
+
+/* Pushes @buffer on the src pad, or adds it to @list when processing a
+ * buffer list */
+static GstFlowReturn
+gst_rtp_ulpfec_enc_stream_ctx_push (GstRtpUlpFecEncStreamCtx * ctx,
+    GstBuffer * buffer, GstBufferList * list)
+{
+  if (list) {
+    gst_buffer_list_add (list, buffer);
+    return GST_FLOW_OK;
+  }
 
-  g_assert_cmpint (ctx->packets_buf.length, <=, buf_max_size);
+  return gst_pad_push (ctx->srcpad, buffer);
 }
 
 static GstFlowReturn
 gst_rtp_ulpfec_enc_stream_ctx_push_fec_packets (GstRtpUlpFecEncStreamCtx * ctx,
     guint8 pt, guint16 seq, guint32 timestamp, guint32 ssrc, guint8 twcc_ext_id,
-    GstRTPHeaderExtensionFlags twcc_ext_flags, guint8 twcc_appbits)
+    GstRTPHeaderExtensionFlags twcc_ext_flags, guint8 twcc_appbits,
+    GstBufferList * list)
 {
   GstFlowReturn ret = GST_FLOW_OK;
   guint fec_packets_num =
@@ -351,11 +372,11 @@ gst_rtp_ulpfec_enc_stream_ctx_push_fec_packets (GstRtpUlpFecEncStreamCtx * ctx,
       fec_packets_num);
   if (fec_packets_num) {
     guint fec_packets_pushed = 0;
-    GstBuffer *latest_packet = ctx->packets_buf.head->data;
+    GstBuffer *latest_packet =
+        PACKETS_BUF_NTH (ctx, ctx->packets_buf_len - 1);
     GstBuffer *fec = NULL;
 
-    gst_rtp_ulpfec_enc_stream_ctx_start (ctx, &ctx->packets_buf,
-        fec_packets_num);
+    gst_rtp_ulpfec_enc_stream_ctx_start (ctx, fec_packets_num);
 
     while (NULL != (fec =
             gst_rtp_ulpfec_enc_stream_ctx_protect (ctx, pt,
@@ -390,7 +411,7 @@ gst_rtp_ulpfec_enc_stream_ctx_push_fec_packets (GstRtpUlpFecEncStreamCtx * ctx,
 
       GST_LOG_OBJECT (ctx->parent, "ctx %p pushing generated fec buffer %"
           GST_PTR_FORMAT, ctx, fec);
-      ret = gst_pad_push (ctx->srcpad, fec);
+      ret = gst_rtp_ulpfec_enc_stream_ctx_push (ctx, fec, list);
       if (GST_FLOW_OK == ret)
         ++fec_packets_pushed;
       else
@@ -401,7 +422,7 @@ gst_rtp_ulpfec_enc_stream_ctx_push_fec_packets (GstRtpUlpFecEncStreamCtx * ctx,
 
     g_assert_cmpint (fec_packets_pushed, <=, fec_packets_num);
 
-    ctx->num_packets_protected += ctx->packets_buf.length;
+    ctx->num_packets_protected += ctx->packets_buf_len;
     ctx->num_packets_fec += fec_packets_pushed;
     ctx->seqnum_offset += fec_packets_pushed;
     ctx->seqnum += fec_packets_pushed;
@@ -513,7 +534,7 @@ gst_rtp_ulpfec_enc_stream_ctx_free (GstRtpUlpFecEncStreamCtx * ctx)
 
 static GstFlowReturn
 gst_rtp_ulpfec_enc_stream_ctx_process (GstRtpUlpFecEncStreamCtx * ctx,
-    GstBuffer * buffer, guint8 twcc_ext_id)
+    GstBuffer * buffer, guint8 twcc_ext_id, GstBufferList * list)
 {
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
   GstFlowReturn ret;
@@ -562,14 +583,15 @@ gst_rtp_ulpfec_enc_stream_ctx_process (GstRtpUlpFecEncStreamCtx * ctx,
 
     gst_rtp_buffer_unmap (&rtp);
 
-    ret = gst_pad_push (ctx->srcpad, buffer);
+    ret = gst_rtp_ulpfec_enc_stream_ctx_push (ctx, buffer, list);
     if (GST_FLOW_OK == ret)
       ret =
           gst_rtp_ulpfec_enc_stream_ctx_push_fec_packets (ctx, ctx->pt, fec_seq,
-          fec_timestamp, fec_ssrc, twcc_ext_id, twcc_ext_flags, twcc_appbits);
+          fec_timestamp, fec_ssrc, twcc_ext_id, twcc_ext_flags, twcc_appbits,
+          list);
   } else {
     gst_rtp_buffer_unmap (&rtp);
-    ret = gst_pad_push (ctx->srcpad, buffer);
+    ret = gst_rtp_ulpfec_enc_stream_ctx_push (ctx, buffer, list);
   }
 
   if (empty_packet_buffer)
@@ -598,17 +620,14 @@ gst_rtp_ulpfec_enc_aquire_ctx (GstRtpUlpFecEnc * fec, guint ssrc)
 }
 
 static GstFlowReturn
-gst_rtp_ulpfec_enc_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+gst_rtp_ulpfec_enc_process_buffer (GstRtpUlpFecEnc * fec, GstBuffer * buffer,
+    GstBufferList * list)
 {
-  GstRtpUlpFecEnc *fec = GST_RTP_ULPFEC_ENC (parent);
   GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
   GstFlowReturn ret;
   guint ssrc = 0;
   GstRtpUlpFecEncStreamCtx *ctx;
 
-  if (fec->pt == UNDEF_PT)
-    return gst_pad_push (fec->srcpad, buffer);
-
   /* FIXME: avoid this additional mapping of the buffer to get the
      ssrc! */
   if (!gst_rtp_buffer_map (buffer,
@@ -620,7 +639,8 @@ gst_rtp_ulpfec_enc_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 
   ctx = gst_rtp_ulpfec_enc_aquire_ctx (fec, ssrc);
 
-  ret = gst_rtp_ulpfec_enc_stream_ctx_process (ctx, buffer, fec->twcc_ext_id);
+  ret = gst_rtp_ulpfec_enc_stream_ctx_process (ctx, buffer, fec->twcc_ext_id,
+      list);
 
   /* FIXME: does not work for multiple ssrcs */
   fec->num_packets_protected = ctx->num_packets_protected;
@@ -628,6 +648,58 @@ gst_rtp_ulpfec_enc_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   return ret;
 }
 
+static GstFlowReturn
+gst_rtp_ulpfec_enc_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  GstRtpUlpFecEnc *fec = GST_RTP_ULPFEC_ENC (parent);
+
+  if (fec->pt == UNDEF_PT)
+    return gst_pad_push (fec->srcpad, buffer);
+
+  return gst_rtp_ulpfec_enc_process_buffer (fec, buffer, NULL);
+}
+
+typedef struct
+{
+  GstRtpUlpFecEnc *fec;
+  GstBufferList *out;
+} ProcessListData;
+
+static gboolean
+process_list_item (GstBuffer ** buffer, guint idx, gpointer user_data)
+{
+  ProcessListData *data = user_data;
+
+  /* steal the buffer from the list, so it can be modified without a copy.
+   * Nothing is pushed from here, so this can't fail */
+  gst_rtp_ulpfec_enc_process_buffer (data->fec, *buffer, data->out);
+  *buffer = NULL;
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_rtp_ulpfec_enc_chain_list (GstPad * pad, GstObject * parent,
+    GstBufferList * list)
+{
+  GstRtpUlpFecEnc *fec = GST_RTP_ULPFEC_ENC (parent);
+  ProcessListData data;
+
+  if (fec->pt == UNDEF_PT)
+    return gst_pad_push_list (fec->srcpad, list);
+
+  /* the media packets and the FEC packets generated for them are pushed
+   * downstream as one list */
+  data.fec = fec;
+  data.out = gst_buffer_list_new_sized (gst_buffer_list_length (list));
+
+  list = gst_buffer_list_make_writable (list);
+  gst_buffer_list_foreach (list, process_list_item, &data);
+  gst_buffer_list_unref (list);
+
+  return gst_pad_push_list (fec->srcpad, data.out);
+}
+
 static void
 gst_rtp_ulpfec_enc_configure_ctx (gpointer key, gpointer value,
     gpointer user_data)
@@ -771,6 +843,8 @@ gst_rtp_ulpfec_enc_init (GstRtpUlpFecEnc * fec)
   GST_PAD_SET_PROXY_ALLOCATION (fec->sinkpad);
   gst_pad_set_chain_function (fec->sinkpad,
       GST_DEBUG_FUNCPTR (gst_rtp_ulpfec_enc_chain));
+  gst_pad_set_chain_list_function (fec->sinkpad,
+      GST_DEBUG_FUNCPTR (gst_rtp_ulpfec_enc_chain_list));
   gst_pad_set_event_function (fec->sinkpad,
       GST_DEBUG_FUNCPTR (gst_rtp_ulpfec_enc_event_sink));
   gst_element_add_pad (GST_ELEMENT (fec), fec->sinkpad);
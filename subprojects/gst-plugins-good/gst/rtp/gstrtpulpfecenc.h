@@ -23,6 +23,8 @@
 
 #include <gst/gst.h>
 
+#include "rtpulpfeccommon.h"
+
 G_BEGIN_DECLS
 
 #define GST_TYPE_RTP_ULPFEC_ENC \
@@ -79,7 +81,11 @@ typedef struct {
   guint num_packets_received;
   guint num_packets_fec;
   guint fec_nth;
-  GQueue packets_buf;
+  /* ring buffer of the packets to protect, preallocated for the largest
+   * protection window */
+  GstBuffer *packets_buf[RTP_ULPFEC_PROTECTED_PACKETS_MAX (TRUE)];
+  guint packets_buf_first;
+  guint packets_buf_len;
 
   gdouble budget;
   gdouble budget_inc;
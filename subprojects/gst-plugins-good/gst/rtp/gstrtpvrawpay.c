@@ -32,10 +32,12 @@
 
 enum
 {
-  PROP_CHUNKS_PER_FRAME = 1
+  PROP_CHUNKS_PER_FRAME = 1,
+  PROP_ZERO_COPY
 };
 
 #define DEFAULT_CHUNKS_PER_FRAME 10
+#define DEFAULT_ZERO_COPY FALSE
 
 GST_DEBUG_CATEGORY_STATIC (rtpvrawpay_debug);
 #define GST_CAT_DEFAULT (rtpvrawpay_debug)
@@ -111,6 +113,25 @@ gst_rtp_vraw_pay_class_init (GstRtpVRawPayClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
       );
 
+  /**
+   * GstRtpVRawPay:zero-copy:
+   *
+   * Reference the line segments of the packed formats (RGB, RGBA, BGR, BGRA,
+   * UYVY and UYVP) from the input buffer instead of copying them into the
+   * packets. This saves a copy of every frame, but the input buffer is only
+   * released once all the packets referencing it have been sent, so
+   * upstream needs enough buffers in its pool.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class,
+      PROP_ZERO_COPY,
+      g_param_spec_boolean ("zero-copy", "Zero copy",
+          "Reference the input data from the packets instead of copying it, "
+          "for the packed formats", DEFAULT_ZERO_COPY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+      );
+
   gstrtpbasepayload_class->set_caps = gst_rtp_vraw_pay_setcaps;
   gstrtpbasepayload_class->handle_buffer = gst_rtp_vraw_pay_handle_buffer;
 
@@ -132,6 +153,7 @@ static void
 gst_rtp_vraw_pay_init (GstRtpVRawPay * rtpvrawpay)
 {
   rtpvrawpay->chunks_per_frame = DEFAULT_CHUNKS_PER_FRAME;
+  rtpvrawpay->zero_copy = DEFAULT_ZERO_COPY;
 }
 
 static gboolean
@@ -273,6 +295,7 @@ gst_rtp_vraw_pay_handle_buffer (GstRTPBasePayload * payload, GstBuffer * buffer)
   guint last_line;              /* last pack line number we pushed out a buffer list     */
   guint line, offset;
   guint8 *p0, *yp, *up, *vp;
+  gsize p0_offset;
   guint ystride, uvstride;
   guint xinc, yinc;
   guint pgroup;
@@ -283,6 +306,7 @@ gst_rtp_vraw_pay_handle_buffer (GstRTPBasePayload * payload, GstBuffer * buffer)
   GstVideoFrame frame;
   gint interlaced;
   gboolean use_buffer_lists;
+  gboolean zero_copy;
   GstBufferList *list = NULL;
   GstRTPBuffer rtp = { NULL, };
   gboolean discont;
@@ -301,6 +325,7 @@ gst_rtp_vraw_pay_handle_buffer (GstRTPBasePayload * payload, GstBuffer * buffer)
 
   /* get pointer and strides of the planes */
   p0 = GST_VIDEO_FRAME_PLANE_DATA (&frame, 0);
+  p0_offset = GST_VIDEO_FRAME_PLANE_OFFSET (&frame, 0);
   yp = GST_VIDEO_FRAME_COMP_DATA (&frame, 0);
   up = GST_VIDEO_FRAME_COMP_DATA (&frame, 1);
   vp = GST_VIDEO_FRAME_COMP_DATA (&frame, 2);
@@ -319,6 +344,25 @@ gst_rtp_vraw_pay_handle_buffer (GstRTPBasePayload * payload, GstBuffer * buffer)
 
   format = GST_VIDEO_INFO_FORMAT (&rtpvrawpay->vinfo);
 
+  /* packed formats are stored in memory exactly like they go on the wire, the
+   * line segments can then be referenced from the input buffer instead of
+   * being copied after the payload headers */
+  switch (format) {
+    case GST_VIDEO_FORMAT_RGB:
+    case GST_VIDEO_FORMAT_RGBA:
+    case GST_VIDEO_FORMAT_BGR:
+    case GST_VIDEO_FORMAT_BGRA:
+    case GST_VIDEO_FORMAT_UYVY:
+    case GST_VIDEO_FORMAT_UYVP:
+      GST_OBJECT_LOCK (rtpvrawpay);
+      zero_copy = rtpvrawpay->zero_copy;
+      GST_OBJECT_UNLOCK (rtpvrawpay);
+      break;
+    default:
+      zero_copy = FALSE;
+      break;
+  }
+
   yinc = rtpvrawpay->yinc;
   xinc = rtpvrawpay->xinc;
 
@@ -349,7 +393,7 @@ gst_rtp_vraw_pay_handle_buffer (GstRTPBasePayload * payload, GstBuffer * buffer)
     /* write all lines */
     while (line < height) {
       guint left, pack_line;
-      GstBuffer *out;
+      GstBuffer *out, *data = NULL;
       guint8 *outdata, *headers;
       gboolean next_line, complete = FALSE;
       guint length, cont, pixels;
@@ -468,6 +512,9 @@ gst_rtp_vraw_pay_handle_buffer (GstRTPBasePayload * payload, GstBuffer * buffer)
       GST_LOG_OBJECT (rtpvrawpay, "consumed %u bytes",
           (guint) (outdata - headers));
 
+      if (zero_copy)
+        data = gst_buffer_new ();
+
       /* second pass, read headers and write the data */
       while (TRUE) {
         guint offs, lin;
@@ -492,8 +539,15 @@ gst_rtp_vraw_pay_handle_buffer (GstRTPBasePayload * payload, GstBuffer * buffer)
           case GST_VIDEO_FORMAT_UYVY:
           case GST_VIDEO_FORMAT_UYVP:
             offs /= xinc;
-            memcpy (outdata, p0 + (lin * ystride) + (offs * pgroup), length);
-            outdata += length;
+            if (zero_copy) {
+              gst_buffer_copy_into (data, buffer, GST_BUFFER_COPY_MEMORY,
+                  p0_offset + (lin * ystride) + (offs * pgroup), length);
+              /* account for the bytes not written to the output buffer */
+              left += length;
+            } else {
+              memcpy (outdata, p0 + (lin * ystride) + (offs * pgroup), length);
+              outdata += length;
+            }
             break;
           case GST_VIDEO_FORMAT_AYUV:
           {
@@ -556,6 +610,8 @@ gst_rtp_vraw_pay_handle_buffer (GstRTPBasePayload * payload, GstBuffer * buffer)
           default:
             gst_rtp_buffer_unmap (&rtp);
             gst_buffer_unref (out);
+            if (data)
+              gst_buffer_unref (data);
             goto unknown_sampling;
         }
 
@@ -574,6 +630,8 @@ gst_rtp_vraw_pay_handle_buffer (GstRTPBasePayload * payload, GstBuffer * buffer)
         GST_LOG_OBJECT (rtpvrawpay, "we have %u bytes left", left);
         gst_buffer_resize (out, 0, gst_buffer_get_size (out) - left);
       }
+      if (data)
+        out = gst_buffer_append (out, data);
 
       gst_rtp_copy_video_meta (rtpvrawpay, out, buffer);
 
@@ -637,6 +695,11 @@ gst_rtp_vraw_pay_set_property (GObject * object, guint prop_id,
     case PROP_CHUNKS_PER_FRAME:
       rtpvrawpay->chunks_per_frame = g_value_get_int (value);
       break;
+    case PROP_ZERO_COPY:
+      GST_OBJECT_LOCK (rtpvrawpay);
+      rtpvrawpay->zero_copy = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (rtpvrawpay);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -655,6 +718,11 @@ gst_rtp_vraw_pay_get_property (GObject * object, guint prop_id,
     case PROP_CHUNKS_PER_FRAME:
       g_value_set_int (value, rtpvrawpay->chunks_per_frame);
       break;
+    case PROP_ZERO_COPY:
+      GST_OBJECT_LOCK (rtpvrawpay);
+      g_value_set_boolean (value, rtpvrawpay->zero_copy);
+      GST_OBJECT_UNLOCK (rtpvrawpay);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -51,6 +51,7 @@ struct _GstRtpVRawPay
 
   /* properties */
   guint chunks_per_frame;
+  gboolean zero_copy;
 };
 
 struct _GstRtpVRawPayClass
@@ -158,6 +158,7 @@ enum
 #define DEFAULT_ADD_REFERENCE_TIMESTAMP_META FALSE
 #define DEFAULT_FASTSTART_MIN_PACKETS 0
 #define DEFAULT_SYNC_INTERVAL 0
+#define DEFAULT_SHARED_TIMERS FALSE
 
 #define DEFAULT_AUTO_RTX_DELAY (20 * GST_MSECOND)
 #define DEFAULT_AUTO_RTX_TIMEOUT (40 * GST_MSECOND)
@@ -193,6 +194,7 @@ enum
   PROP_ADD_REFERENCE_TIMESTAMP_META,
   PROP_FASTSTART_MIN_PACKETS,
   PROP_SYNC_INTERVAL,
+  PROP_SHARED_TIMERS,
 };
 
 #define JBUF_LOCK(priv)   G_STMT_START {			\
@@ -242,7 +244,7 @@ enum
 #define JBUF_SIGNAL_TIMER(priv) G_STMT_START {            \
   if (G_UNLIKELY ((priv)->waiting_timer)) {               \
     GST_DEBUG ("signal timer, %d waiters", (priv)->waiting_timer); \
-    g_cond_signal (&(priv)->jbuf_timer);                  \
+    g_cond_broadcast (&(priv)->jbuf_timer);               \
   }                                                       \
 } G_STMT_END
 
@@ -310,6 +312,11 @@ struct _GstRtpJitterBufferPrivate
 
   gboolean timer_running;
   GThread *timer_thread;
+  /* the timers run from the shared pool, a dispatch is queued or running,
+   * and another dispatch is needed */
+  gboolean timer_shared;
+  gboolean timer_scheduled;
+  gboolean timer_pending;
 
   /* properties */
   guint latency_ms;
@@ -337,6 +344,7 @@ struct _GstRtpJitterBufferPrivate
   guint faststart_min_packets;
   gboolean add_reference_timestamp_meta;
   guint sync_interval;
+  gboolean shared_timers;
 
   /* Reference for GstReferenceTimestampMeta */
   GstCaps *reference_timestamp_caps;
@@ -580,6 +588,7 @@ static void do_handle_sync_inband (GstRtpJitterBuffer * jitterbuffer,
 static void unschedule_current_timer (GstRtpJitterBuffer * jitterbuffer);
 
 static void wait_next_timeout (GstRtpJitterBuffer * jitterbuffer);
+static void schedule_shared_timer (GstRtpJitterBuffer * jitterbuffer);
 
 static GstStructure *gst_rtp_jitter_buffer_create_stats (GstRtpJitterBuffer *
     jitterbuffer);
@@ -997,6 +1006,21 @@ gst_rtp_jitter_buffer_class_init (GstRtpJitterBufferClass * klass)
           0, G_MAXUINT, DEFAULT_SYNC_INTERVAL,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRtpJitterBuffer:shared-timers:
+   *
+   * Run the timers from a pool of threads shared by all jitterbuffers of the
+   * process, with one thread per CPU core, instead of from a timer thread of
+   * this jitterbuffer. This bounds the number of threads when receiving many
+   * streams. The property is applied when going from READY to PAUSED.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_SHARED_TIMERS,
+      g_param_spec_boolean ("shared-timers", "Shared Timers",
+          "Run the timers from a thread pool shared by all jitterbuffers",
+          DEFAULT_SHARED_TIMERS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /**
    * GstRtpJitterBuffer::request-pt-map:
    * @buffer: the object which received the signal
@@ -1128,6 +1152,7 @@ gst_rtp_jitter_buffer_init (GstRtpJitterBuffer * jitterbuffer)
   priv->faststart_min_packets = DEFAULT_FASTSTART_MIN_PACKETS;
   priv->add_reference_timestamp_meta = DEFAULT_ADD_REFERENCE_TIMESTAMP_META;
   priv->sync_interval = DEFAULT_SYNC_INTERVAL;
+  priv->shared_timers = DEFAULT_SHARED_TIMERS;
 
   priv->ts_offset_remainder = 0;
   priv->last_dts = -1;
@@ -1834,8 +1859,10 @@ gst_rtp_jitter_buffer_change_state (GstElement * element,
       priv->blocked = TRUE;
       priv->timer_running = TRUE;
       priv->srcresult = GST_FLOW_OK;
-      priv->timer_thread =
-          g_thread_new ("timer", (GThreadFunc) wait_next_timeout, jitterbuffer);
+      priv->timer_shared = priv->shared_timers;
+      if (!priv->timer_shared)
+        priv->timer_thread = g_thread_new ("timer",
+            (GThreadFunc) wait_next_timeout, jitterbuffer);
       JBUF_UNLOCK (priv);
       break;
     case GST_STATE_CHANGE_PAUSED_TO_PLAYING:
@@ -1844,6 +1871,7 @@ gst_rtp_jitter_buffer_change_state (GstElement * element,
       priv->blocked = FALSE;
       JBUF_SIGNAL_EVENT (priv);
       JBUF_SIGNAL_TIMER (priv);
+      schedule_shared_timer (jitterbuffer);
       JBUF_UNLOCK (priv);
       break;
     default:
@@ -1877,9 +1905,14 @@ gst_rtp_jitter_buffer_change_state (GstElement * element,
       JBUF_SIGNAL_TIMER (priv);
       JBUF_SIGNAL_QUERY (priv, FALSE);
       JBUF_SIGNAL_QUEUE (priv);
+      /* wait for the shared timer dispatch to finish */
+      while (priv->timer_scheduled)
+        JBUF_WAIT_TIMER (priv);
       JBUF_UNLOCK (priv);
-      g_thread_join (priv->timer_thread);
-      priv->timer_thread = NULL;
+      if (priv->timer_thread) {
+        g_thread_join (priv->timer_thread);
+        priv->timer_thread = NULL;
+      }
       gst_clear_caps (&priv->reference_timestamp_caps);
       g_list_free_full (priv->cname_ssrc_mappings,
           (GDestroyNotify) cname_ssrc_mapping_free);
@@ -2336,6 +2369,11 @@ unschedule_current_timer (GstRtpJitterBuffer * jitterbuffer)
   if (priv->clock_id) {
     GST_DEBUG_OBJECT (jitterbuffer, "unschedule current timer");
     gst_clock_id_unschedule (priv->clock_id);
+    if (priv->timer_shared) {
+      /* unscheduled async waits don't call back, dispatch again instead */
+      gst_clock_id_unref (priv->clock_id);
+      schedule_shared_timer (jitterbuffer);
+    }
     priv->clock_id = NULL;
   }
 }
@@ -2362,6 +2400,8 @@ update_current_timer (GstRtpJitterBuffer * jitterbuffer)
 
   /* wakeup the timer thread in case the timer queue was empty */
   JBUF_SIGNAL_TIMER (priv);
+  if (priv->clock_id == NULL)
+    schedule_shared_timer (jitterbuffer);
 
   /* no need to wait if the current wait is earlier or later */
   if (timer->timeout != -1 && timer->timeout >= priv->timer_timeout)
@@ -4487,6 +4527,136 @@ stopping:
   return;
 }
 
+/* The shared timers do the same as wait_next_timeout() but instead of waiting
+ * on the clock, the earliest timer is scheduled as an async clock wait and
+ * the expired timers are handled from a thread pool shared by all
+ * jitterbuffers. */
+static GThreadPool *shared_timer_pool;
+
+static gboolean
+shared_timer_expired (GstClock * clock, GstClockTime time, GstClockID id,
+    GstRtpJitterBuffer * jitterbuffer)
+{
+  GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
+
+  JBUF_LOCK (priv);
+  if (priv->clock_id == id) {
+    GST_DEBUG_OBJECT (jitterbuffer, "sync done, #%d", priv->timer_seqnum);
+    gst_clock_id_unref (priv->clock_id);
+    priv->clock_id = NULL;
+    schedule_shared_timer (jitterbuffer);
+  }
+  JBUF_UNLOCK (priv);
+
+  return TRUE;
+}
+
+static void
+shared_timer_dispatch (GstRtpJitterBuffer * jitterbuffer)
+{
+  GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
+  GstClockTime now = 0;
+
+  JBUF_LOCK (priv);
+  while (priv->timer_pending && priv->timer_running && !priv->blocked) {
+    RtpTimer *timer;
+    GQueue events = G_QUEUE_INIT;
+
+    priv->timer_pending = FALSE;
+
+    GST_OBJECT_LOCK (jitterbuffer);
+    if (priv->eos) {
+      now = GST_CLOCK_TIME_NONE;
+    } else if (GST_ELEMENT_CLOCK (jitterbuffer)) {
+      now =
+          gst_clock_get_time (GST_ELEMENT_CLOCK (jitterbuffer)) -
+          GST_ELEMENT_CAST (jitterbuffer)->base_time;
+    }
+    GST_OBJECT_UNLOCK (jitterbuffer);
+
+    GST_DEBUG_OBJECT (jitterbuffer, "now %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (now));
+
+    if (priv->do_retransmission)
+      rtp_timer_queue_remove_until (priv->rtx_stats_timers, now);
+
+    while ((timer = rtp_timer_queue_pop_until (priv->timers, now)))
+      do_timeout (jitterbuffer, timer, now, &events);
+
+    timer = rtp_timer_queue_peek_earliest (priv->timers);
+    if (timer) {
+      GstClock *clock;
+
+      GST_OBJECT_LOCK (jitterbuffer);
+      clock = GST_ELEMENT_CLOCK (jitterbuffer);
+      if (!clock) {
+        GST_DEBUG_OBJECT (jitterbuffer, "No clock, timeout right away");
+        now = timer->timeout;
+        priv->timer_pending = TRUE;
+      } else if (priv->clock_id == NULL
+          || priv->timer_timeout != timer->timeout) {
+        GstClockTime sync_time;
+
+        if (priv->clock_id) {
+          gst_clock_id_unschedule (priv->clock_id);
+          gst_clock_id_unref (priv->clock_id);
+        }
+
+        sync_time = timer->timeout + GST_ELEMENT_CAST (jitterbuffer)->base_time;
+        sync_time += priv->peer_latency;
+
+        GST_DEBUG_OBJECT (jitterbuffer, "timer #%i sync to timestamp %"
+            GST_TIME_FORMAT " with sync time %" GST_TIME_FORMAT, timer->seqnum,
+            GST_TIME_ARGS (get_pts_timeout (timer)),
+            GST_TIME_ARGS (sync_time));
+
+        priv->clock_id = gst_clock_new_single_shot_id (clock, sync_time);
+        priv->timer_timeout = timer->timeout;
+        priv->timer_seqnum = timer->seqnum;
+        gst_clock_id_wait_async (priv->clock_id,
+            (GstClockCallback) shared_timer_expired,
+            gst_object_ref (jitterbuffer), gst_object_unref);
+      }
+      GST_OBJECT_UNLOCK (jitterbuffer);
+    } else if (priv->eos) {
+      /* the pusher thread waits for the timers to drain */
+      JBUF_SIGNAL_TIMER (priv);
+    }
+
+    push_rtx_events (jitterbuffer, &events);
+  }
+  priv->timer_scheduled = FALSE;
+  JBUF_SIGNAL_TIMER (priv);
+  JBUF_UNLOCK (priv);
+
+  gst_object_unref (jitterbuffer);
+}
+
+/* called with JBUF_LOCK */
+static void
+schedule_shared_timer (GstRtpJitterBuffer * jitterbuffer)
+{
+  GstRtpJitterBufferPrivate *priv = jitterbuffer->priv;
+  static gsize pool_init = 0;
+
+  if (!priv->timer_shared || !priv->timer_running)
+    return;
+
+  priv->timer_pending = TRUE;
+  if (priv->timer_scheduled)
+    return;
+
+  if (g_once_init_enter (&pool_init)) {
+    shared_timer_pool =
+        g_thread_pool_new ((GFunc) shared_timer_dispatch, NULL,
+        g_get_num_processors (), FALSE, NULL);
+    g_once_init_leave (&pool_init, 1);
+  }
+
+  priv->timer_scheduled = TRUE;
+  g_thread_pool_push (shared_timer_pool, gst_object_ref (jitterbuffer), NULL);
+}
+
 /*
  * This function implements the main pushing loop on the source pad.
  *
@@ -5205,6 +5375,11 @@ gst_rtp_jitter_buffer_set_property (GObject * object,
       priv->sync_interval = g_value_get_uint (value);
       JBUF_UNLOCK (priv);
       break;
+    case PROP_SHARED_TIMERS:
+      JBUF_LOCK (priv);
+      priv->shared_timers = g_value_get_boolean (value);
+      JBUF_UNLOCK (priv);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -5371,6 +5546,11 @@ gst_rtp_jitter_buffer_get_property (GObject * object,
       g_value_set_uint (value, priv->sync_interval);
       JBUF_UNLOCK (priv);
       break;
+    case PROP_SHARED_TIMERS:
+      JBUF_LOCK (priv);
+      g_value_set_boolean (value, priv->shared_timers);
+      JBUF_UNLOCK (priv);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
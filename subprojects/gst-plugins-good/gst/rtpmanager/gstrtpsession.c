@@ -786,6 +786,11 @@ gst_rtp_session_class_init (GstRtpSessionClass * klass)
    *      average of the difference in inter-packet spacing between
    *      sender and receiver. A sudden increase in this number can indicate
    *      network congestion.
+   *  "estimated-bitrate" G_TYPE_UINT  The available bandwidth estimated from
+   *      the above with a delay and loss based controller, or 0 if there
+   *      is no estimate yet. Every new estimate is also sent upstream from
+   *      the send_rtp_sink pad as a custom "GstRTPBandwidthEstimate" event
+   *      with a "bitrate" G_TYPE_UINT field, in bits per second. Since: 1.24
    *
    * Since: 1.18
    */
@@ -2941,6 +2946,9 @@ gst_rtp_session_notify_twcc (RTPSession * sess,
   GstRtpSession *rtpsession = GST_RTP_SESSION (user_data);
   GstEvent *event;
   GstPad *send_rtp_sink;
+  guint estimated_bitrate = 0;
+
+  gst_structure_get_uint (twcc_stats, "estimated-bitrate", &estimated_bitrate);
 
   GST_RTP_SESSION_LOCK (rtpsession);
   if ((send_rtp_sink = rtpsession->send_rtp_sink))
@@ -2953,6 +2961,14 @@ gst_rtp_session_notify_twcc (RTPSession * sess,
   if (send_rtp_sink) {
     event = gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM, twcc_packets);
     gst_pad_push_event (send_rtp_sink, event);
+
+    /* let the encoders follow the estimate directly */
+    if (estimated_bitrate) {
+      event = gst_event_new_custom (GST_EVENT_CUSTOM_UPSTREAM,
+          gst_structure_new ("GstRTPBandwidthEstimate",
+              "bitrate", G_TYPE_UINT, estimated_bitrate, NULL));
+      gst_pad_push_event (send_rtp_sink, event);
+    }
     gst_object_unref (send_rtp_sink);
   }
 
@@ -98,7 +98,10 @@ typedef struct
 
 typedef struct
 {
+  /* Kept allocated from one FEC packet to the next, allocated_len is
+   * its size */
   guint8 *xored_payload;
+  guint allocated_len;
   guint32 xored_timestamp;
   guint8 xored_pt;
   guint16 xored_payload_len;
@@ -169,7 +172,7 @@ struct _GstRTPST_2022_1_FecEnc
   gboolean enable_column;
 
   /* Array of FecPackets, with size enc->l */
-  GPtrArray *columns;
+  FecPacket *columns;
   /* Index of the current column in the array above */
   guint current_column;
   /* Tracks the column seqnum */
@@ -220,23 +223,46 @@ free_fec_packet (FecPacket * packet)
   g_free (packet);
 }
 
+/* Start a new FEC packet, keeping the payload allocation around */
+static void
+fec_packet_reset (FecPacket * packet)
+{
+  guint8 *xored_payload = packet->xored_payload;
+  guint allocated_len = packet->allocated_len;
+
+  memset (packet, 0x00, sizeof (FecPacket));
+  packet->xored_payload = xored_payload;
+  packet->allocated_len = allocated_len;
+}
+
+static void
+fec_packet_ensure_size (FecPacket * packet, guint len)
+{
+  if (packet->allocated_len < len) {
+    packet->xored_payload = g_realloc (packet->xored_payload, len);
+    packet->allocated_len = len;
+  }
+}
+
+/* XOR doesn't care about byte order, so work on native words, 32 bytes at a
+ * time. The fixed size inner loop gets turned into vector instructions by
+ * the compiler, the memcpy()s take care of unaligned payloads. */
 static void
 _xor_mem (guint8 * restrict dst, const guint8 * restrict src, gsize length)
 {
-  guint i;
-
-  for (i = 0; i < (length / sizeof (guint64)); ++i) {
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-    GST_WRITE_UINT64_LE (dst,
-        GST_READ_UINT64_LE (dst) ^ GST_READ_UINT64_LE (src));
-#else
-    GST_WRITE_UINT64_BE (dst,
-        GST_READ_UINT64_BE (dst) ^ GST_READ_UINT64_BE (src));
-#endif
-    dst += sizeof (guint64);
-    src += sizeof (guint64);
+  guint64 d[4], s[4];
+  gsize i;
+
+  for (; length >= sizeof (d); length -= sizeof (d)) {
+    memcpy (d, dst, sizeof (d));
+    memcpy (s, src, sizeof (s));
+    for (i = 0; i < G_N_ELEMENTS (d); ++i)
+      d[i] ^= s[i];
+    memcpy (dst, d, sizeof (d));
+    dst += sizeof (d);
+    src += sizeof (s);
   }
-  for (i = 0; i < (length % sizeof (guint64)); ++i)
+  for (i = 0; i < length; ++i)
     dst[i] ^= src[i];
 }
 
@@ -252,15 +278,14 @@ fec_packet_update (FecPacket * fec, GstRTPBuffer * rtp)
     fec->xored_marker = gst_rtp_buffer_get_marker (rtp);
     fec->xored_padding = gst_rtp_buffer_get_padding (rtp);
     fec->xored_extension = gst_rtp_buffer_get_extension (rtp);
-    fec->xored_payload = g_malloc (sizeof (guint8) * fec->payload_len);
+    fec_packet_ensure_size (fec, fec->payload_len);
     memcpy (fec->xored_payload, gst_rtp_buffer_get_payload (rtp),
         fec->payload_len);
   } else {
     guint plen = gst_rtp_buffer_get_payload_len (rtp);
 
     if (fec->payload_len < plen) {
-      fec->xored_payload =
-          g_realloc (fec->xored_payload, sizeof (guint8) * plen);
+      fec_packet_ensure_size (fec, plen);
       memset (fec->xored_payload + fec->payload_len, 0,
           plen - fec->payload_len);
       fec->payload_len = plen;
@@ -445,19 +470,17 @@ gst_rtpst_2022_1_fecenc_sink_chain (GstPad * pad, GstObject * parent,
     fec_packet_update (enc->row, &rtp);
     if (enc->row->n_packets == enc->l) {
       queue_fec_packet (enc, enc->row, TRUE);
-      g_free (enc->row->xored_payload);
-      memset (enc->row, 0x00, sizeof (FecPacket));
+      fec_packet_reset (enc->row);
     }
   }
 
   if (enc->enable_column && enc->l && enc->d) {
-    FecPacket *column = g_ptr_array_index (enc->columns, enc->current_column);
+    FecPacket *column = &enc->columns[enc->current_column];
 
     fec_packet_update (column, &rtp);
     if (column->n_packets == enc->d) {
       queue_fec_packet (enc, column, FALSE);
-      g_free (column->xored_payload);
-      memset (column, 0x00, sizeof (FecPacket));
+      fec_packet_reset (column);
     }
 
     enc->current_column++;
@@ -519,7 +542,11 @@ gst_rtpst_2022_1_fecenc_reset (GstRTPST_2022_1_FecEnc * enc, gboolean allocate)
   }
 
   if (enc->columns) {
-    g_ptr_array_unref (enc->columns);
+    guint i;
+
+    for (i = 0; i < enc->l; i++)
+      g_free (enc->columns[i].xored_payload);
+    g_free (enc->columns);
     enc->columns = NULL;
   }
 
@@ -536,15 +563,8 @@ gst_rtpst_2022_1_fecenc_reset (GstRTPST_2022_1_FecEnc * enc, gboolean allocate)
   g_queue_clear_full (&enc->queued_column_packets, (GDestroyNotify) free_item);
 
   if (allocate) {
-    guint i;
-
     enc->row = g_malloc0 (sizeof (FecPacket));
-    enc->columns =
-        g_ptr_array_new_full (enc->l, (GDestroyNotify) free_fec_packet);
-
-    for (i = 0; i < enc->l; i++) {
-      g_ptr_array_add (enc->columns, g_malloc0 (sizeof (FecPacket)));
-    }
+    enc->columns = g_new0 (FecPacket, enc->l);
 
     g_queue_init (&enc->queued_column_packets);
 
@@ -631,11 +651,8 @@ gst_rtpst_2022_1_fecenc_set_property (GObject * object, guint prop_id,
         guint i;
 
         if (enc->columns) {
-          for (i = 0; i < enc->l; i++) {
-            FecPacket *column = g_ptr_array_index (enc->columns, i);
-            g_free (column->xored_payload);
-            memset (column, 0x00, sizeof (FecPacket));
-          }
+          for (i = 0; i < enc->l; i++)
+            fec_packet_reset (&enc->columns[i]);
         }
         enc->current_column = 0;
         enc->column_seq = 0;
@@ -113,6 +113,7 @@ rtp_jitter_buffer_finalize (GObject * object)
     gst_object_unref (jbuf->pipeline_clock);
 
   rtp_jitter_buffer_flush (jbuf, NULL, NULL);
+  g_free (jbuf->index);
 
   g_mutex_clear (&jbuf->clock_lock);
 
@@ -675,6 +676,83 @@ no_skew:
   return out_time;
 }
 
+#define INDEX_MIN_SIZE 64
+#define INDEX_MAX_SIZE 65536
+
+static inline RTPJitterBufferItem *
+index_lookup (RTPJitterBuffer * jbuf, guint16 seqnum)
+{
+  RTPJitterBufferItem *item;
+
+  if (G_UNLIKELY (jbuf->index == NULL))
+    return NULL;
+
+  item = (RTPJitterBufferItem *) jbuf->index[seqnum & jbuf->index_mask];
+  if (item && item->seqnum == seqnum)
+    return item;
+
+  return NULL;
+}
+
+/* grow the index until it has a free slot for @seqnum and for all the
+ * packets in the queue */
+static void
+index_grow (RTPJitterBuffer * jbuf, guint16 seqnum)
+{
+  guint size = jbuf->index ? jbuf->index_mask + 1 : INDEX_MIN_SIZE / 2;
+  gboolean collision;
+  GList *l;
+
+  do {
+    size *= 2;
+    g_free (jbuf->index);
+    jbuf->index = g_new0 (GList *, size);
+    jbuf->index_mask = size - 1;
+
+    collision = FALSE;
+    for (l = jbuf->packets.head; l && !collision; l = l->next) {
+      RTPJitterBufferItem *qitem = (RTPJitterBufferItem *) l;
+      GList **slot;
+
+      if (qitem->seqnum == -1)
+        continue;
+
+      slot = &jbuf->index[qitem->seqnum & jbuf->index_mask];
+      if (*slot)
+        collision = TRUE;
+      else
+        *slot = l;
+    }
+    if (jbuf->index[seqnum & jbuf->index_mask])
+      collision = TRUE;
+  } while (collision && size < INDEX_MAX_SIZE);
+
+  GST_DEBUG ("seqnum index has %u slots now", size);
+}
+
+static void
+index_add (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item)
+{
+  if (G_UNLIKELY (jbuf->index == NULL ||
+          jbuf->index[item->seqnum & jbuf->index_mask] != NULL))
+    index_grow (jbuf, item->seqnum);
+
+  jbuf->index[item->seqnum & jbuf->index_mask] = (GList *) item;
+}
+
+static void
+index_remove (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item)
+{
+  GList **slot;
+
+  if (item->seqnum == -1 || jbuf->index == NULL)
+    return;
+
+  slot = &jbuf->index[item->seqnum & jbuf->index_mask];
+  if (*slot == (GList *) item)
+    *slot = NULL;
+}
+
 static void
 queue_do_insert (RTPJitterBuffer * jbuf, GList * list, GList * item)
 {
@@ -1073,7 +1151,9 @@ rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
     gboolean * head, gint * percent)
 {
   GList *list, *event = NULL;
+  RTPJitterBufferItem *last;
   guint16 seqnum;
+  gint dist;
 
   g_return_val_if_fail (jbuf != NULL, FALSE);
   g_return_val_if_fail (item != NULL, FALSE);
@@ -1086,6 +1166,38 @@ rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
 
   seqnum = item->seqnum;
 
+  /* find the packet with the highest seqnum, only events can follow it */
+  for (last = (RTPJitterBufferItem *) list; last;
+      last = (RTPJitterBufferItem *) last->prev) {
+    if (last->seqnum != -1)
+      break;
+  }
+
+  /* the common case: the packet goes after all others */
+  if (last == NULL || gst_rtp_buffer_compare_seqnum (last->seqnum, seqnum) > 0)
+    goto append;
+
+  if (G_UNLIKELY (index_lookup (jbuf, seqnum)))
+    goto duplicate;
+
+  /* The packet goes right before the packet with the next higher seqnum,
+   * after any events in front of that. Look it up in the index unless the
+   * seqnum distance to the last packet is larger than the queue, then walking
+   * the queue is cheaper. */
+  dist = gst_rtp_buffer_compare_seqnum (seqnum, last->seqnum);
+  if (dist > 0 && dist <= jbuf->packets.length) {
+    RTPJitterBufferItem *next = NULL;
+    gint i;
+
+    for (i = 1; i <= dist && next == NULL; i++)
+      next = index_lookup (jbuf, seqnum + i);
+
+    if (G_LIKELY (next != NULL)) {
+      list = next->prev;
+      goto append;
+    }
+  }
+
   /* loop the list to skip strictly larger seqnum buffers */
   for (; list; list = g_list_previous (list)) {
     guint16 qseq;
@@ -1125,6 +1237,8 @@ rtp_jitter_buffer_insert (RTPJitterBuffer * jbuf, RTPJitterBufferItem * item,
     list = event;
 
 append:
+  if (item->seqnum != -1)
+    index_add (jbuf, item);
   queue_do_insert (jbuf, list, (GList *) item);
 
   /* buffering mode, update buffer stats */
@@ -1319,6 +1433,7 @@ rtp_jitter_buffer_pop (RTPJitterBuffer * jbuf, gint * percent)
 
   item = queue->head;
   if (item) {
+    index_remove (jbuf, (RTPJitterBufferItem *) item);
     queue->head = item->next;
     if (queue->head)
       queue->head->prev = NULL;
@@ -1379,8 +1494,10 @@ rtp_jitter_buffer_flush (RTPJitterBuffer * jbuf, GFunc free_func,
   if (free_func == NULL)
     free_func = (GFunc) rtp_jitter_buffer_free_item;
 
-  while ((item = g_queue_pop_head_link (&jbuf->packets)))
+  while ((item = g_queue_pop_head_link (&jbuf->packets))) {
+    index_remove (jbuf, (RTPJitterBufferItem *) item);
     free_func ((RTPJitterBufferItem *) item, user_data);
+  }
 }
 
 /**
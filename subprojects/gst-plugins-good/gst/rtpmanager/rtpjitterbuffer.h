@@ -74,6 +74,9 @@ struct _RTPJitterBuffer {
   GObject        object;
 
   GQueue         packets;
+  /* the items of packets with a seqnum, at seqnum & index_mask */
+  GList        **index;
+  guint          index_mask;
 
   RTPJitterBufferMode mode;
 
@@ -3837,8 +3837,9 @@ session_start_rtcp (RTPSession * sess, ReportData * data)
   }
 }
 
-/* construct a Sender or Receiver Report */
-static void
+/* construct a Sender or Receiver Report, returns %TRUE when the packet is
+ * full and no more sources need to be looked at */
+static gboolean
 session_report_blocks (const gchar * key, RTPSource * source, ReportData * data)
 {
   RTPSession *sess = data->sess;
@@ -3852,18 +3853,18 @@ session_report_blocks (const gchar * key, RTPSource * source, ReportData * data)
   if (((gint16) (source->generation - sess->generation)) > 0) {
     GST_DEBUG ("source %08x generation %u > %u", source->ssrc,
         source->generation, sess->generation);
-    return;
+    return FALSE;
   }
 
   if (g_hash_table_contains (source->reported_in_sr_of,
           GUINT_TO_POINTER (data->source->ssrc))) {
     GST_DEBUG ("source %08x already reported in this generation", source->ssrc);
-    return;
+    return FALSE;
   }
 
   if (gst_rtcp_packet_get_rb_count (packet) == GST_RTCP_MAX_RB_COUNT) {
     GST_DEBUG ("max RB count reached");
-    return;
+    return TRUE;
   }
 
   /* only report about remote sources */
@@ -3903,6 +3904,8 @@ session_report_blocks (const gchar * key, RTPSource * source, ReportData * data)
 reported:
   g_hash_table_add (source->reported_in_sr_of,
       GUINT_TO_POINTER (data->source->ssrc));
+
+  return FALSE;
 }
 
 /* construct FIR */
@@ -4436,10 +4439,14 @@ is_rtcp_time (RTPSession * sess, GstClockTime current_time, ReportData * data)
   return TRUE;
 }
 
+/* number of sources to clean up before giving packet processing a chance to
+ * take the session lock */
+#define CLEANUP_BATCH_SIZE 64
+
 static void
-clone_ssrcs_hashtable (gchar * key, RTPSource * source, GHashTable * hash_table)
+clone_ssrcs_array (gchar * key, RTPSource * source, GPtrArray * array)
 {
-  g_hash_table_insert (hash_table, key, g_object_ref (source));
+  g_ptr_array_add (array, g_object_ref (source));
 }
 
 static gboolean
@@ -4524,10 +4531,11 @@ generate_rtcp (const gchar * key, RTPSource * source, ReportData * data)
     make_source_bye (sess, source, data);
     is_bye = TRUE;
   } else if (!data->is_early) {
-    /* loop over all known sources and add report blocks. If we are early, we
-     * just make a minimal RTCP packet and skip this step */
-    g_hash_table_foreach (sess->ssrcs[sess->mask_idx],
-        (GHFunc) session_report_blocks, data);
+    /* loop over the known sources and add report blocks until the packet is
+     * full. If we are early, we just make a minimal RTCP packet and skip this
+     * step */
+    g_hash_table_find (sess->ssrcs[sess->mask_idx],
+        (GHRFunc) session_report_blocks, data);
   }
   if (!data->has_sdes && (!data->is_early || !sess->reduced_size_rtcp
           || sr_req_pending))
@@ -4641,9 +4649,10 @@ rtp_session_on_timeout (RTPSession * sess, GstClockTime current_time,
 {
   GstFlowReturn result = GST_FLOW_OK;
   ReportData data = { GST_RTCP_BUFFER_INIT };
-  GHashTable *table_copy;
+  GPtrArray *sources;
   ReportOutput *output;
   gboolean all_empty = FALSE;
+  guint i;
 
   g_return_val_if_fail (RTP_IS_SESSION (sess), GST_FLOW_ERROR);
 
@@ -4684,17 +4693,24 @@ rtp_session_on_timeout (RTPSession * sess, GstClockTime current_time,
   sess->conflicting_addresses =
       timeout_conflicting_addresses (sess->conflicting_addresses, current_time);
 
-  /* Make a local copy of the hashtable. We need to do this because the
+  /* Make a local copy of the sources. We need to do this because the
    * cleanup stage below releases the session lock. */
-  table_copy = g_hash_table_new_full (NULL, NULL, NULL,
-      (GDestroyNotify) g_object_unref);
+  sources = g_ptr_array_new_full (g_hash_table_size (sess->ssrcs
+          [sess->mask_idx]), (GDestroyNotify) g_object_unref);
   g_hash_table_foreach (sess->ssrcs[sess->mask_idx],
-      (GHFunc) clone_ssrcs_hashtable, table_copy);
+      (GHFunc) clone_ssrcs_array, sources);
 
   /* Clean up the session, mark the source for removing, this might release the
-   * session lock. */
-  g_hash_table_foreach (table_copy, (GHFunc) session_cleanup, &data);
-  g_hash_table_destroy (table_copy);
+   * session lock. With many sources, also release the lock regularly to not
+   * block the processing of packets for too long. */
+  for (i = 0; i < sources->len; i++) {
+    if (i > 0 && i % CLEANUP_BATCH_SIZE == 0) {
+      RTP_SESSION_UNLOCK (sess);
+      RTP_SESSION_LOCK (sess);
+    }
+    session_cleanup (NULL, g_ptr_array_index (sources, i), &data);
+  }
+  g_ptr_array_unref (sources);
 
   /* Now remove the marked sources */
   g_hash_table_foreach_remove (sess->ssrcs[sess->mask_idx],
@@ -24,6 +24,19 @@
 #include "rtpstats.h"
 #include "rtptwcc.h"
 
+/* Bandwidth estimation, loosely following the combined delay and loss based
+ * controllers of Google Congestion Control
+ * (draft-ietf-rmcat-gcc-02) */
+#define BWE_MIN_BITRATE                 (30 * 1000)
+#define BWE_MAX_BITRATE                 (50 * 1000 * 1000)
+/* queues are building up when the packets arrive further apart on average
+ * than they were sent */
+#define BWE_OVERUSE_DELTA_OF_DELTA      (500 * GST_USECOND)
+#define BWE_DECREASE_FACTOR             0.85
+#define BWE_INCREASE_FACTOR             1.08
+#define BWE_LOSS_HIGH_PCT               10.0
+#define BWE_LOSS_LOW_PCT                2.0
+
 void
 gst_rtp_packet_rate_ctx_reset (RTPPacketRateCtx * ctx, gint32 clock_rate)
 {
@@ -565,6 +578,40 @@ _get_window_start_index (RTPTWCCStats * stats, GstClockTime duration,
   return -1;
 }
 
+static void
+rtp_twcc_stats_update_estimate (RTPTWCCStats * stats)
+{
+  gdouble estimate = stats->estimated_bitrate;
+  gboolean overuse;
+
+  /* start from what we are actually sending */
+  if (estimate == 0)
+    estimate = stats->bitrate_sent;
+  if (estimate == 0 || stats->bitrate_recv == 0)
+    return;
+
+  overuse = GST_CLOCK_STIME_IS_VALID (stats->avg_delta_of_delta) &&
+      stats->avg_delta_of_delta > BWE_OVERUSE_DELTA_OF_DELTA;
+
+  if (overuse) {
+    /* delay based: back off below what made it through */
+    estimate = MIN (estimate, BWE_DECREASE_FACTOR * stats->bitrate_recv);
+  } else if (stats->packet_loss_pct > BWE_LOSS_HIGH_PCT) {
+    /* loss based: decrease proportionally to the loss */
+    estimate *= 1.0 - 0.5 * stats->packet_loss_pct / 100.0;
+  } else if (stats->packet_loss_pct < BWE_LOSS_LOW_PCT) {
+    /* probe for more, but don't run away from the receive rate */
+    estimate = MIN (estimate * BWE_INCREASE_FACTOR,
+        1.5 * stats->bitrate_recv);
+  }
+
+  stats->estimated_bitrate = CLAMP (estimate, BWE_MIN_BITRATE,
+      BWE_MAX_BITRATE);
+
+  GST_DEBUG ("Bandwidth estimate: %u (overuse: %d)", stats->estimated_bitrate,
+      overuse);
+}
+
 static void
 rtp_twcc_stats_calculate_windowed_stats (RTPTWCCStats * stats)
 {
@@ -637,6 +684,8 @@ rtp_twcc_stats_calculate_windowed_stats (RTPTWCCStats * stats)
       packets_recv, stats->packet_loss_pct, stats->bitrate_sent,
       stats->bitrate_recv, GST_STIME_ARGS (stats->avg_delta_of_delta),
       stats->avg_delta_of_delta_change);
+
+  rtp_twcc_stats_update_estimate (stats);
 }
 
 RTPTWCCStats *
@@ -667,7 +716,8 @@ rtp_twcc_stats_get_stats_structure (RTPTWCCStats * stats)
       "packets-sent", G_TYPE_UINT, stats->packets_sent,
       "packets-recv", G_TYPE_UINT, stats->packets_recv,
       "packet-loss-pct", G_TYPE_DOUBLE, stats->packet_loss_pct,
-      "avg-delta-of-delta", G_TYPE_INT64, stats->avg_delta_of_delta, NULL);
+      "avg-delta-of-delta", G_TYPE_INT64, stats->avg_delta_of_delta,
+      "estimated-bitrate", G_TYPE_UINT, stats->estimated_bitrate, NULL);
 }
 
 GstStructure *
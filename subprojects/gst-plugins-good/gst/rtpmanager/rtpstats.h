@@ -278,6 +278,9 @@ typedef struct {
   gfloat packet_loss_pct;
   GstClockTimeDiff avg_delta_of_delta;
   gfloat avg_delta_of_delta_change;
+
+  /* bandwidth estimate derived from the above, 0 until the first estimate */
+  guint estimated_bitrate;
 } RTPTWCCStats;
 
 
@@ -24,12 +24,24 @@
 
 #include "rtptimerqueue.h"
 
+/* The timers with a timeout are hashed into a timer wheel of WHEEL_SIZE slots
+ * of 2^WHEEL_SHIFT ns each. A slot points to the last queued timer of its
+ * tick, which is used as a starting point to find the position of new
+ * timers. */
+#define WHEEL_SHIFT 22
+#define WHEEL_SIZE 1024
+#define WHEEL_LOOKBACK 16
+
+#define TIMER_TICK(t) ((t) >> WHEEL_SHIFT)
+
 struct _RtpTimerQueue
 {
   GObject parent;
 
   GQueue timers;
   GHashTable *hashtable;
+
+  GList *wheel[WHEEL_SIZE];
 };
 
 G_DEFINE_TYPE (RtpTimerQueue, rtp_timer_queue, G_TYPE_OBJECT);
@@ -234,6 +246,80 @@ rtp_timer_queue_insert_after (RtpTimerQueue * queue, RtpTimer * sibling,
   queue->timers.length++;
 }
 
+static void
+rtp_timer_queue_unlink (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  if (timer->slot) {
+    *timer->slot = NULL;
+    timer->slot = NULL;
+  }
+
+  g_queue_unlink (&queue->timers, (GList *) timer);
+}
+
+/* make @timer the entry of its slot if it is the last timer of its tick */
+static void
+rtp_timer_queue_update_slot (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  RtpTimer *next = rtp_timer_get_next (timer);
+  GList **slot;
+
+  if (next && TIMER_TICK (next->timeout) == TIMER_TICK (timer->timeout))
+    return;
+
+  slot = &queue->wheel[TIMER_TICK (timer->timeout) % WHEEL_SIZE];
+  if (*slot)
+    ((RtpTimer *) * slot)->slot = NULL;
+
+  *slot = (GList *) timer;
+  timer->slot = slot;
+}
+
+/* find a queued timer with a timeout shortly before @timeout */
+static RtpTimer *
+rtp_timer_queue_lookup_slot (RtpTimerQueue * queue, GstClockTime timeout)
+{
+  guint64 tick = TIMER_TICK (timeout);
+  guint i;
+
+  for (i = 0; i < WHEEL_LOOKBACK && i <= tick; i++) {
+    RtpTimer *it = (RtpTimer *) queue->wheel[(tick - i) % WHEEL_SIZE];
+
+    if (it && TIMER_TICK (it->timeout) == tick - i)
+      return it;
+  }
+
+  return NULL;
+}
+
+static void rtp_timer_queue_insert_tail (RtpTimerQueue * queue,
+    RtpTimer * timer);
+
+/* insert a timer with a valid timeout, starting the search from the timer
+ * wheel if possible */
+static void
+rtp_timer_queue_insert_timeout (RtpTimerQueue * queue, RtpTimer * timer)
+{
+  RtpTimer *it = rtp_timer_queue_lookup_slot (queue, timer->timeout);
+
+  if (it == NULL) {
+    rtp_timer_queue_insert_tail (queue, timer);
+  } else {
+    while (it && rtp_timer_is_sooner (timer, it))
+      it = rtp_timer_get_prev (it);
+
+    if (it == NULL) {
+      g_queue_push_head_link (&queue->timers, (GList *) timer);
+    } else {
+      while (rtp_timer_is_later (timer, rtp_timer_get_next (it)))
+        it = rtp_timer_get_next (it);
+      rtp_timer_queue_insert_after (queue, it, timer);
+    }
+  }
+
+  rtp_timer_queue_update_slot (queue, timer);
+}
+
 static void
 rtp_timer_queue_insert_tail (RtpTimerQueue * queue, RtpTimer * timer)
 {
@@ -347,6 +433,7 @@ rtp_timer_dup (const RtpTimer * timer)
   memcpy (copy, timer, sizeof (RtpTimer));
   memset (&copy->list, 0, sizeof (GList));
   copy->queued = FALSE;
+  copy->slot = NULL;
   return copy;
 }
 
@@ -397,8 +484,8 @@ rtp_timer_queue_new (void)
  *
  * Insert a timer into the queue. Earliest timer are at the head and then
  * timer are sorted by seqnum (smaller seqnum first). This function is o(n)
- * but it is expected that most timers added are schedule later, in which case
- * the insertion will be faster.
+ * in the worst case, but timers with a timeout close to queued timers are
+ * found through the timer wheel and inserted in constant time.
  *
  * Returns: %FALSE if a timer with the same seqnum already existed
  */
@@ -416,7 +503,7 @@ rtp_timer_queue_insert (RtpTimerQueue * queue, RtpTimer * timer)
   if (timer->timeout == -1)
     rtp_timer_queue_insert_head (queue, timer);
   else
-    rtp_timer_queue_insert_tail (queue, timer);
+    rtp_timer_queue_insert_timeout (queue, timer);
 
   g_hash_table_insert (queue->hashtable,
       GINT_TO_POINTER (timer->seqnum), timer);
@@ -431,8 +518,8 @@ rtp_timer_queue_insert (RtpTimerQueue * queue, RtpTimer * timer)
  * @timer: the #RtpTimer to reschedule
  *
  * This function moves @timer inside the queue to put it back to it's new
- * location. This function is o(n) but it is assumed that nearby modification
- * of the timeout will occure.
+ * location. This function is o(1) for timers with a timeout close to other
+ * queued timers, o(n) otherwise.
  *
  * Returns: %TRUE if the timer was moved
  */
@@ -443,8 +530,21 @@ rtp_timer_queue_reschedule (RtpTimerQueue * queue, RtpTimer * timer)
 
   g_return_val_if_fail (timer->queued == TRUE, FALSE);
 
+  if (GST_CLOCK_TIME_IS_VALID (timer->timeout)) {
+    RtpTimer *next = rtp_timer_get_next (timer);
+
+    if (!rtp_timer_is_sooner (timer, rtp_timer_get_prev (timer)) &&
+        !rtp_timer_is_later (timer, next) &&
+        (next == NULL || GST_CLOCK_TIME_IS_VALID (next->timeout)))
+      return FALSE;
+
+    rtp_timer_queue_unlink (queue, timer);
+    rtp_timer_queue_insert_timeout (queue, timer);
+    return TRUE;
+  }
+
   if (rtp_timer_is_closer_to_head (timer, rtp_timer_queue_get_head (queue))) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
+    rtp_timer_queue_unlink (queue, timer);
     rtp_timer_queue_insert_head (queue, timer);
     return TRUE;
   }
@@ -453,13 +553,13 @@ rtp_timer_queue_reschedule (RtpTimerQueue * queue, RtpTimer * timer)
     it = rtp_timer_get_prev (it);
 
   if (it != timer) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
+    rtp_timer_queue_unlink (queue, timer);
     rtp_timer_queue_insert_before (queue, it, timer);
     return TRUE;
   }
 
   if (rtp_timer_is_closer_to_tail (timer, rtp_timer_queue_get_tail (queue))) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
+    rtp_timer_queue_unlink (queue, timer);
     rtp_timer_queue_insert_tail (queue, timer);
     return TRUE;
   }
@@ -468,7 +568,7 @@ rtp_timer_queue_reschedule (RtpTimerQueue * queue, RtpTimer * timer)
     it = rtp_timer_get_next (it);
 
   if (it != timer) {
-    g_queue_unlink (&queue->timers, (GList *) timer);
+    rtp_timer_queue_unlink (queue, timer);
     rtp_timer_queue_insert_after (queue, it, timer);
     return TRUE;
   }
@@ -489,7 +589,7 @@ rtp_timer_queue_unschedule (RtpTimerQueue * queue, RtpTimer * timer)
 {
   g_return_if_fail (timer->queued == TRUE);
 
-  g_queue_unlink (&queue->timers, (GList *) timer);
+  rtp_timer_queue_unlink (queue, timer);
   g_hash_table_remove (queue->hashtable, GINT_TO_POINTER (timer->seqnum));
   timer->queued = FALSE;
 }
@@ -58,6 +58,7 @@ typedef struct
 {
   GList list;
   gboolean queued;
+  GList **slot;
 
   guint16 seqnum;
   RtpTimerType type;
@@ -92,6 +92,11 @@ enum
 #define DEFAULT_BUFFER_SIZE        0
 #define DEFAULT_BIND_ADDRESS       NULL
 #define DEFAULT_BIND_PORT          0
+#define DEFAULT_MAX_BITRATE        0
+
+/* how much sending may get ahead of the configured bitrate after having
+ * been idle */
+#define PACING_BURST               (10 * GST_MSECOND)
 
 enum
 {
@@ -114,7 +119,8 @@ enum
   PROP_SEND_DUPLICATES,
   PROP_BUFFER_SIZE,
   PROP_BIND_ADDRESS,
-  PROP_BIND_PORT
+  PROP_BIND_PORT,
+  PROP_MAX_BITRATE
 };
 
 static void gst_multiudpsink_finalize (GObject * object);
@@ -351,6 +357,24 @@ gst_multiudpsink_class_init (GstMultiUDPSinkClass * klass)
           "Port to bind the socket to", 0, G_MAXUINT16,
           DEFAULT_BIND_PORT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstMultiUDPSink:max-bitrate:
+   *
+   * Pace the outgoing packets to at most this many bits per second for the
+   * whole sink, summed over all sockets and clients. Packets are still sent
+   * in batches, but never more than what was accumulated since the last
+   * batch plus a small burst allowance. The property can be changed at
+   * runtime, for example from a congestion controller's estimate. 0 disables
+   * pacing.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_BITRATE,
+      g_param_spec_uint64 ("max-bitrate", "Max Bitrate",
+          "Maximum rate in bits per second to pace the packets to "
+          "(0 = unlimited)", 0, G_MAXUINT64, DEFAULT_MAX_BITRATE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_add_static_pad_template (gstelement_class, &sink_template);
 
   gst_element_class_set_static_metadata (gstelement_class, "UDP packet sender",
@@ -418,6 +442,9 @@ gst_multiudpsink_init (GstMultiUDPSink * sink)
   sink->force_ipv4 = DEFAULT_FORCE_IPV4;
   sink->qos_dscp = DEFAULT_QOS_DSCP;
   sink->send_duplicates = DEFAULT_SEND_DUPLICATES;
+  sink->max_bitrate = DEFAULT_MAX_BITRATE;
+  sink->pacing_clock = gst_system_clock_obtain ();
+  sink->pacing_time = GST_CLOCK_TIME_NONE;
   sink->multi_iface = g_strdup (DEFAULT_MULTICAST_IFACE);
 
   gst_multiudpsink_create_cancellable (sink);
@@ -548,6 +575,8 @@ gst_multiudpsink_finalize (GObject * object)
 
   gst_multiudpsink_free_cancellable (sink);
 
+  gst_object_unref (sink->pacing_clock);
+
   g_free (sink->multi_iface);
   sink->multi_iface = NULL;
 
@@ -634,6 +663,62 @@ gst_udp_address_get_string (GSocketAddress * addr, gchar * s, gsize size)
   return s;
 }
 
+/* Pacing for the max-bitrate property. pacing_time is the time at which the
+ * next packet may be sent, it advances by the duration of every packet sent
+ * and is never allowed to lag behind the clock by more than PACING_BURST.
+ * Waits until sending is allowed and returns how many of @messages can be
+ * sent right away, or 0 if the wait got interrupted by unlock(). */
+static guint
+gst_multiudpsink_pace (GstMultiUDPSink * sink, guint64 max_bitrate,
+    GstOutputMessage * messages, guint num_messages)
+{
+  GstClockTime now, next;
+  guint i;
+
+  now = gst_clock_get_time (sink->pacing_clock);
+
+  if (!GST_CLOCK_TIME_IS_VALID (sink->pacing_time)
+      || sink->pacing_time + PACING_BURST < now)
+    sink->pacing_time = now > PACING_BURST ? now - PACING_BURST : 0;
+
+  while (sink->pacing_time > now) {
+    GstClockReturn ret;
+    GstClockID id;
+
+    GST_LOG_OBJECT (sink, "waiting %" GST_TIME_FORMAT " for pacing",
+        GST_TIME_ARGS (sink->pacing_time - now));
+
+    GST_OBJECT_LOCK (sink);
+    if (g_cancellable_is_cancelled (sink->cancellable)) {
+      GST_OBJECT_UNLOCK (sink);
+      return 0;
+    }
+    id = sink->pacing_id = gst_clock_new_single_shot_id (sink->pacing_clock,
+        sink->pacing_time);
+    GST_OBJECT_UNLOCK (sink);
+
+    ret = gst_clock_id_wait (id, NULL);
+
+    GST_OBJECT_LOCK (sink);
+    sink->pacing_id = NULL;
+    GST_OBJECT_UNLOCK (sink);
+    gst_clock_id_unref (id);
+
+    if (ret == GST_CLOCK_UNSCHEDULED)
+      return 0;
+
+    now = gst_clock_get_time (sink->pacing_clock);
+  }
+
+  /* the bucket may go into debt by the last packet of the batch */
+  for (i = 0, next = sink->pacing_time; i < num_messages && next <= now; ++i) {
+    next += gst_util_uint64_scale (gst_udp_calc_message_size (&messages[i]),
+        8 * GST_SECOND, max_bitrate);
+  }
+
+  return i;
+}
+
 /* Wrapper around g_socket_send_messages() plus error handling (ignoring).
  * Returns FALSE if we got cancelled, otherwise TRUE. */
 static GstFlowReturn
@@ -641,14 +726,36 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
     GstOutputMessage * messages, guint num_messages)
 {
   gboolean sent_max_size_warning = FALSE;
+  guint64 max_bitrate;
+
+  GST_OBJECT_LOCK (sink);
+  max_bitrate = sink->max_bitrate;
+  GST_OBJECT_UNLOCK (sink);
 
   while (num_messages > 0) {
     gchar astr[64] G_GNUC_UNUSED;
     GError *err = NULL;
-    guint msg_size, skip, i;
+    guint msg_size, skip, i, num_send;
     gint ret, err_idx;
 
-    ret = g_socket_send_messages (socket, messages, num_messages, 0,
+    num_send = num_messages;
+    if (max_bitrate > 0) {
+      num_send = gst_multiudpsink_pace (sink, max_bitrate, messages,
+          num_messages);
+
+      if (num_send == 0) {
+        GstFlowReturn flow_ret;
+
+        flow_ret = gst_base_sink_wait_preroll (GST_BASE_SINK (sink));
+
+        if (flow_ret == GST_FLOW_OK)
+          continue;
+
+        return flow_ret;
+      }
+    }
+
+    ret = g_socket_send_messages (socket, messages, num_send, 0,
         sink->cancellable, &err);
 
     if (G_UNLIKELY (ret < 0)) {
@@ -667,7 +774,7 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
         return flow_ret;
       }
 
-      err_idx = gst_udp_messsages_find_first_not_sent (messages, num_messages);
+      err_idx = gst_udp_messsages_find_first_not_sent (messages, num_send);
       if (err_idx < 0)
         break;
 
@@ -707,6 +814,13 @@ gst_multiudpsink_send_messages (GstMultiUDPSink * sink, GSocket * socket,
 
     g_assert (ret <= num_messages);
 
+    if (max_bitrate > 0) {
+      for (i = 0; i < ret; ++i) {
+        sink->pacing_time += gst_util_uint64_scale (messages[i].bytes_sent,
+            8 * GST_SECOND, max_bitrate);
+      }
+    }
+
     messages += ret;
     num_messages -= ret;
   }
@@ -1094,6 +1208,11 @@ gst_multiudpsink_set_property (GObject * object, guint prop_id,
     case PROP_BIND_PORT:
       udpsink->bind_port = g_value_get_int (value);
       break;
+    case PROP_MAX_BITRATE:
+      GST_OBJECT_LOCK (udpsink);
+      udpsink->max_bitrate = g_value_get_uint64 (value);
+      GST_OBJECT_UNLOCK (udpsink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1167,6 +1286,11 @@ gst_multiudpsink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_BIND_PORT:
       g_value_set_int (value, udpsink->bind_port);
       break;
+    case PROP_MAX_BITRATE:
+      GST_OBJECT_LOCK (udpsink);
+      g_value_set_uint64 (value, udpsink->max_bitrate);
+      GST_OBJECT_UNLOCK (udpsink);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1243,6 +1367,7 @@ gst_multiudpsink_start (GstBaseSink * bsink)
   sink = GST_MULTIUDPSINK (bsink);
 
   sink->external_socket = FALSE;
+  sink->pacing_time = GST_CLOCK_TIME_NONE;
 
   if (sink->socket) {
     GST_DEBUG_OBJECT (sink, "using configured socket");
@@ -1801,7 +1926,11 @@ gst_multiudpsink_unlock (GstBaseSink * bsink)
 
   sink = GST_MULTIUDPSINK (bsink);
 
+  GST_OBJECT_LOCK (sink);
   g_cancellable_cancel (sink->cancellable);
+  if (sink->pacing_id)
+    gst_clock_id_unschedule (sink->pacing_id);
+  GST_OBJECT_UNLOCK (sink);
 
   return TRUE;
 }
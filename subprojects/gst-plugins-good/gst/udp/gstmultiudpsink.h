@@ -102,6 +102,12 @@ struct _GstMultiUDPSink {
   gint           buffer_size;
   gchar         *bind_address;
   gint           bind_port;
+  guint64        max_bitrate;
+
+  /* pacing state, pacing_id is protected by the object lock */
+  GstClock      *pacing_clock;
+  GstClockTime   pacing_time;
+  GstClockID     pacing_id;
 };
 
 struct _GstMultiUDPSinkClass {
@@ -571,6 +571,7 @@ static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src",
 #define UDP_DEFAULT_LOOP               TRUE
 #define UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS TRUE
 #define UDP_DEFAULT_MTU                (1492)
+#define UDP_DEFAULT_BATCH_SIZE         1
 
 enum
 {
@@ -594,6 +595,7 @@ enum
   PROP_RETRIEVE_SENDER_ADDRESS,
   PROP_MTU,
   PROP_SOCKET_TIMESTAMP,
+  PROP_BATCH_SIZE,
 };
 
 static void gst_udpsrc_uri_handler_init (gpointer g_iface, gpointer iface_data);
@@ -603,6 +605,8 @@ static gboolean gst_udpsrc_close (GstUDPSrc * src);
 static gboolean gst_udpsrc_unlock (GstBaseSrc * bsrc);
 static gboolean gst_udpsrc_unlock_stop (GstBaseSrc * bsrc);
 static GstFlowReturn gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf);
+static GstFlowReturn gst_udpsrc_create (GstPushSrc * psrc, GstBuffer ** buf);
+static void gst_udpsrc_clear_batch (GstUDPSrc * src);
 
 static void gst_udpsrc_finalize (GObject * object);
 
@@ -780,6 +784,27 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
           GST_SOCKET_TIMESTAMP_MODE, GST_SOCKET_TIMESTAMP_MODE_REALTIME,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstUDPSrc:batch-size:
+   *
+   * Maximum number of packets to read with one system call. With a value
+   * bigger than 1 the packets that are available are pushed downstream
+   * together in a #GstBufferList, saving a system call and a push per packet
+   * at high packet rates. The socket is put into non-blocking mode then.
+   *
+   * All packets of a batch are timestamped with the time they were read.
+   * Packets bigger than #GstUDPSrc:mtu are dropped in this mode, so it
+   * needs to be set to the biggest expected packet size.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_BATCH_SIZE,
+      g_param_spec_uint ("batch-size", "Batch size",
+          "Maximum number of packets to read at once and push in a buffer list",
+          1, 1024, UDP_DEFAULT_BATCH_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gst_element_class_add_static_pad_template (gstelement_class, &src_template);
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -795,6 +820,7 @@ gst_udpsrc_class_init (GstUDPSrcClass * klass)
   gstbasesrc_class->get_caps = gst_udpsrc_getcaps;
   gstbasesrc_class->decide_allocation = gst_udpsrc_decide_allocation;
 
+  gstpushsrc_class->create = gst_udpsrc_create;
   gstpushsrc_class->fill = gst_udpsrc_fill;
 
   gst_type_mark_as_plugin_api (GST_TYPE_SOCKET_TIMESTAMP_MODE, 0);
@@ -822,6 +848,7 @@ gst_udpsrc_init (GstUDPSrc * udpsrc)
   udpsrc->loop = UDP_DEFAULT_LOOP;
   udpsrc->retrieve_sender_address = UDP_DEFAULT_RETRIEVE_SENDER_ADDRESS;
   udpsrc->mtu = UDP_DEFAULT_MTU;
+  udpsrc->batch_size = UDP_DEFAULT_BATCH_SIZE;
 
   /* configure basesrc to be a live source */
   gst_base_src_set_live (GST_BASE_SRC (udpsrc), TRUE);
@@ -864,6 +891,8 @@ gst_udpsrc_finalize (GObject * object)
     gst_memory_unref (udpsrc->extra_mem);
   udpsrc->extra_mem = NULL;
 
+  gst_udpsrc_clear_batch (udpsrc);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -913,6 +942,199 @@ gst_udpsrc_free_cancellable (GstUDPSrc * src)
   src->cancellable = NULL;
 }
 
+/* optimization: use messages only in multicast mode and
+ * if we can't let the kernel do the filtering for us */
+static gboolean
+gst_udpsrc_needs_control_messages (GstUDPSrc * udpsrc)
+{
+  gboolean needed;
+
+  needed =
+      g_inet_address_get_is_multicast (g_inet_socket_address_get_address
+      (udpsrc->addr));
+#ifdef IP_MULTICAST_ALL
+  if (g_inet_address_get_family (g_inet_socket_address_get_address
+          (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
+    needed = FALSE;
+#endif
+#ifdef SO_TIMESTAMPNS
+  if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
+    needed = TRUE;
+#endif
+
+  return needed;
+}
+
+/* Waits until a packet can be read, posting a message on every timeout */
+static GstFlowReturn
+gst_udpsrc_wait_readable (GstUDPSrc * udpsrc)
+{
+  gboolean try_again;
+  GError *err = NULL;
+
+  do {
+    gint64 timeout;
+
+    try_again = FALSE;
+
+    if (udpsrc->timeout)
+      timeout = udpsrc->timeout / 1000;
+    else
+      timeout = -1;
+
+    GST_LOG_OBJECT (udpsrc, "doing select, timeout %" G_GINT64_FORMAT, timeout);
+
+    if (!g_socket_condition_timed_wait (udpsrc->used_socket, G_IO_IN | G_IO_PRI,
+            timeout, udpsrc->cancellable, &err)) {
+      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY)
+          || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+        goto stopped;
+      } else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)) {
+        g_clear_error (&err);
+        /* timeout, post element message */
+        gst_element_post_message (GST_ELEMENT_CAST (udpsrc),
+            gst_message_new_element (GST_OBJECT_CAST (udpsrc),
+                gst_structure_new ("GstUDPSrcTimeout",
+                    "timeout", G_TYPE_UINT64, udpsrc->timeout, NULL)));
+      } else {
+        goto select_error;
+      }
+
+      try_again = TRUE;
+    }
+  } while (G_UNLIKELY (try_again));
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+select_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("select error: %s", err->message));
+    g_clear_error (&err);
+    return GST_FLOW_ERROR;
+  }
+stopped:
+  {
+    GST_DEBUG ("stop called");
+    g_clear_error (&err);
+    return GST_FLOW_FLUSHING;
+  }
+}
+
+/* Checks the control messages received with a packet, sets the DTS of
+ * @outbuf from a socket timestamp and frees the messages. Returns TRUE if the
+ * packet was sent to a different multicast address and must be dropped */
+static gboolean
+gst_udpsrc_process_control_messages (GstUDPSrc * udpsrc,
+    GSocketControlMessage ** msgs, gint n_msgs, GstBuffer * outbuf)
+{
+  GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
+  gboolean skip_packet = FALSE;
+  gsize iaddr_size = g_inet_address_get_native_size (iaddr);
+  const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
+  gint i;
+
+  for (i = 0; i < n_msgs && !skip_packet; i++) {
+#ifdef IP_PKTINFO
+    if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IPV6_PKTINFO
+    if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
+      GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef IP_RECVDSTADDR
+    if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
+      GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
+
+      if (sizeof (msg->addr) == iaddr_size
+          && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
+        skip_packet = TRUE;
+    }
+#endif
+#ifdef SO_TIMESTAMPNS
+    if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
+      GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
+      GstClock *clock;
+      GstClockTime socket_ts;
+
+      socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
+      GST_TRACE_OBJECT (udpsrc,
+          "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
+          GST_TIME_ARGS (socket_ts));
+
+      clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+      if (clock != NULL) {
+        gint64 adjust_dts, cur_sys_time, delta;
+        GstClockTime base_time, cur_gst_clk_time, running_time;
+
+        /*
+         * We use g_get_real_time as the time reference for SCM timestamps
+         * is always CLOCK_REALTIME.
+         */
+        cur_sys_time = g_get_real_time () * GST_USECOND;
+        cur_gst_clk_time = gst_clock_get_time (clock);
+
+        delta = (gint64) cur_sys_time - (gint64) socket_ts;
+        if (delta < 0) {
+          /*
+           * The current system time will always be greater than the SCM
+           * timestamp as the packet would have been timestamped at least
+           * some clock cycles before. If it is not, then the system time
+           * was adjusted. Since we cannot rely on the delta calculation in
+           * such a case, set the DTS to current pipeline clock when this
+           * happens.
+           */
+          GST_LOG_OBJECT (udpsrc,
+              "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
+          GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+        } else {
+          base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+          running_time = cur_gst_clk_time - base_time;
+          adjust_dts = (gint64) running_time - delta;
+          /*
+           * If the system time was adjusted much further ahead, we might
+           * end up with delta > cur_gst_clk_time. Set the DTS to current
+           * pipeline clock for this scenario as well.
+           */
+          if (adjust_dts < 0) {
+            GST_LOG_OBJECT (udpsrc,
+                "Current system time much ahead in time, setting DTS to pipeline clock");
+            GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
+          } else {
+            GST_BUFFER_DTS (outbuf) = adjust_dts;
+            GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
+                GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
+          }
+        }
+        g_object_unref (clock);
+      } else {
+        GST_ERROR_OBJECT (udpsrc,
+            "Failed to get element clock, not setting DTS");
+      }
+    }
+#endif
+  }
+
+  for (i = 0; i < n_msgs; i++) {
+    g_object_unref (msgs[i]);
+  }
+  g_free (msgs);
+
+  return skip_packet;
+}
+
 static GstFlowReturn
 gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
 {
@@ -920,33 +1142,20 @@ gst_udpsrc_fill (GstPushSrc * psrc, GstBuffer * outbuf)
   GSocketAddress *saddr = NULL;
   GSocketAddress **p_saddr;
   gint flags = G_SOCKET_MSG_NONE;
-  gboolean try_again;
   GError *err = NULL;
   gssize res;
   gsize offset;
   GSocketControlMessage **msgs = NULL;
   GSocketControlMessage ***p_msgs;
-  gint n_msgs = 0, i;
+  gint n_msgs = 0;
+  GstFlowReturn flow;
   GstMapInfo info;
   GstMapInfo extra_info;
   GInputVector ivec[2];
 
   udpsrc = GST_UDPSRC_CAST (psrc);
 
-  /* optimization: use messages only in multicast mode and
-   * if we can't let the kernel do the filtering for us */
-  p_msgs =
-      (g_inet_address_get_is_multicast (g_inet_socket_address_get_address
-          (udpsrc->addr))) ? &msgs : NULL;
-#ifdef IP_MULTICAST_ALL
-  if (g_inet_address_get_family (g_inet_socket_address_get_address
-          (udpsrc->addr)) == G_SOCKET_FAMILY_IPV4)
-    p_msgs = NULL;
-#endif
-#ifdef SO_TIMESTAMPNS
-  if (udpsrc->socket_timestamp_mode == GST_SOCKET_TIMESTAMP_MODE_REALTIME)
-    p_msgs = &msgs;
-#endif
+  p_msgs = gst_udpsrc_needs_control_messages (udpsrc) ? &msgs : NULL;
 
   /* Retrieve sender address unless we've been configured not to do so */
   p_saddr = (udpsrc->retrieve_sender_address) ? &saddr : NULL;
@@ -989,37 +1198,9 @@ retry:
     saddr = NULL;
   }
 
-  do {
-    gint64 timeout;
-
-    try_again = FALSE;
-
-    if (udpsrc->timeout)
-      timeout = udpsrc->timeout / 1000;
-    else
-      timeout = -1;
-
-    GST_LOG_OBJECT (udpsrc, "doing select, timeout %" G_GINT64_FORMAT, timeout);
-
-    if (!g_socket_condition_timed_wait (udpsrc->used_socket, G_IO_IN | G_IO_PRI,
-            timeout, udpsrc->cancellable, &err)) {
-      if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY)
-          || g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
-        goto stopped;
-      } else if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_TIMED_OUT)) {
-        g_clear_error (&err);
-        /* timeout, post element message */
-        gst_element_post_message (GST_ELEMENT_CAST (udpsrc),
-            gst_message_new_element (GST_OBJECT_CAST (udpsrc),
-                gst_structure_new ("GstUDPSrcTimeout",
-                    "timeout", G_TYPE_UINT64, udpsrc->timeout, NULL)));
-      } else {
-        goto select_error;
-      }
-
-      try_again = TRUE;
-    }
-  } while (G_UNLIKELY (try_again));
+  flow = gst_udpsrc_wait_readable (udpsrc);
+  if (flow != GST_FLOW_OK)
+    goto wait_failed;
 
   res =
       g_socket_receive_message (udpsrc->used_socket, p_saddr, ivec, 2,
@@ -1041,109 +1222,7 @@ retry:
   /* Retry if multicast and the destination address is not ours. We don't want
    * to receive arbitrary packets */
   if (p_msgs) {
-    GInetAddress *iaddr = g_inet_socket_address_get_address (udpsrc->addr);
-    gboolean skip_packet = FALSE;
-    gsize iaddr_size = g_inet_address_get_native_size (iaddr);
-    const guint8 *iaddr_bytes = g_inet_address_to_bytes (iaddr);
-
-    for (i = 0; i < n_msgs && !skip_packet; i++) {
-#ifdef IP_PKTINFO
-      if (GST_IS_IP_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPPktinfoMessage *msg = GST_IP_PKTINFO_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IPV6_PKTINFO
-      if (GST_IS_IPV6_PKTINFO_MESSAGE (msgs[i])) {
-        GstIPV6PktinfoMessage *msg = GST_IPV6_PKTINFO_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef IP_RECVDSTADDR
-      if (GST_IS_IP_RECVDSTADDR_MESSAGE (msgs[i])) {
-        GstIPRecvdstaddrMessage *msg = GST_IP_RECVDSTADDR_MESSAGE (msgs[i]);
-
-        if (sizeof (msg->addr) == iaddr_size
-            && memcmp (iaddr_bytes, &msg->addr, sizeof (msg->addr)))
-          skip_packet = TRUE;
-      }
-#endif
-#ifdef SO_TIMESTAMPNS
-      if (GST_IS_SOCKET_TIMESTAMP_MESSAGE (msgs[i])) {
-        GstSocketTimestampMessage *msg = GST_SOCKET_TIMESTAMP_MESSAGE (msgs[i]);
-        GstClock *clock;
-        GstClockTime socket_ts;
-
-        socket_ts = GST_TIMESPEC_TO_TIME (msg->socket_ts);
-        GST_TRACE_OBJECT (udpsrc,
-            "Got SCM_TIMESTAMPNS %" GST_TIME_FORMAT " in msg",
-            GST_TIME_ARGS (socket_ts));
-
-        clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
-        if (clock != NULL) {
-          gint64 adjust_dts, cur_sys_time, delta;
-          GstClockTime base_time, cur_gst_clk_time, running_time;
-
-          /*
-           * We use g_get_real_time as the time reference for SCM timestamps
-           * is always CLOCK_REALTIME.
-           */
-          cur_sys_time = g_get_real_time () * GST_USECOND;
-          cur_gst_clk_time = gst_clock_get_time (clock);
-
-          delta = (gint64) cur_sys_time - (gint64) socket_ts;
-          if (delta < 0) {
-            /*
-             * The current system time will always be greater than the SCM
-             * timestamp as the packet would have been timestamped at least
-             * some clock cycles before. If it is not, then the system time
-             * was adjusted. Since we cannot rely on the delta calculation in
-             * such a case, set the DTS to current pipeline clock when this
-             * happens.
-             */
-            GST_LOG_OBJECT (udpsrc,
-                "Current system time is behind SCM timestamp, setting DTS to pipeline clock");
-            GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-          } else {
-            base_time = gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
-            running_time = cur_gst_clk_time - base_time;
-            adjust_dts = (gint64) running_time - delta;
-            /*
-             * If the system time was adjusted much further ahead, we might
-             * end up with delta > cur_gst_clk_time. Set the DTS to current
-             * pipeline clock for this scenario as well.
-             */
-            if (adjust_dts < 0) {
-              GST_LOG_OBJECT (udpsrc,
-                  "Current system time much ahead in time, setting DTS to pipeline clock");
-              GST_BUFFER_DTS (outbuf) = cur_gst_clk_time;
-            } else {
-              GST_BUFFER_DTS (outbuf) = adjust_dts;
-              GST_LOG_OBJECT (udpsrc, "Setting DTS to %" GST_TIME_FORMAT,
-                  GST_TIME_ARGS (GST_BUFFER_DTS (outbuf)));
-            }
-          }
-          g_object_unref (clock);
-        } else {
-          GST_ERROR_OBJECT (udpsrc,
-              "Failed to get element clock, not setting DTS");
-        }
-      }
-#endif
-    }
-
-    for (i = 0; i < n_msgs; i++) {
-      g_object_unref (msgs[i]);
-    }
-    g_free (msgs);
-
-    if (skip_packet) {
+    if (gst_udpsrc_process_control_messages (udpsrc, msgs, n_msgs, outbuf)) {
       GST_DEBUG_OBJECT (udpsrc,
           "Dropping packet for a different multicast address");
       goto retry;
@@ -1193,22 +1272,11 @@ memory_map_error:
         ("Failed to map memory"));
     return GST_FLOW_ERROR;
   }
-select_error:
+wait_failed:
   {
     gst_buffer_unmap (outbuf, &info);
     gst_memory_unmap (udpsrc->extra_mem, &extra_info);
-    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
-        ("select error: %s", err->message));
-    g_clear_error (&err);
-    return GST_FLOW_ERROR;
-  }
-stopped:
-  {
-    gst_buffer_unmap (outbuf, &info);
-    gst_memory_unmap (udpsrc->extra_mem, &extra_info);
-    GST_DEBUG ("stop called");
-    g_clear_error (&err);
-    return GST_FLOW_FLUSHING;
+    return flow;
   }
 receive_error:
   {
@@ -1235,6 +1303,302 @@ skip_error:
   }
 }
 
+/* One message of a batched read. The buffers of unused slots stay mapped
+ * between reads so that only the slots that were pushed out are refilled */
+typedef struct
+{
+  GstBuffer *buffer;
+  GstMapInfo map;
+  GInputVector vec;
+  GSocketAddress *saddr;
+  GSocketControlMessage **msgs;
+  guint n_msgs;
+} GstUDPSrcBatchSlot;
+
+static void
+gst_udpsrc_batch_slot_clear (GstUDPSrcBatchSlot * slot)
+{
+  guint i;
+
+  if (slot->buffer) {
+    gst_buffer_unmap (slot->buffer, &slot->map);
+    gst_buffer_unref (slot->buffer);
+    slot->buffer = NULL;
+  }
+  g_clear_object (&slot->saddr);
+
+  for (i = 0; i < slot->n_msgs; i++)
+    g_object_unref (slot->msgs[i]);
+  g_free (slot->msgs);
+  slot->msgs = NULL;
+  slot->n_msgs = 0;
+}
+
+static void
+gst_udpsrc_clear_batch (GstUDPSrc * src)
+{
+  GstUDPSrcBatchSlot *slots = src->batch_slots;
+  guint i;
+
+  for (i = 0; i < src->n_batch_slots; i++)
+    gst_udpsrc_batch_slot_clear (&slots[i]);
+
+  g_free (src->batch_slots);
+  src->batch_slots = NULL;
+  g_free (src->batch_msgs);
+  src->batch_msgs = NULL;
+  src->n_batch_slots = 0;
+}
+
+static GstFlowReturn
+gst_udpsrc_prepare_batch (GstUDPSrc * udpsrc, gboolean need_msgs)
+{
+  GstUDPSrcBatchSlot *slots;
+  GstBufferPool *pool;
+  GstFlowReturn flow = GST_FLOW_OK;
+  guint i;
+
+  if (udpsrc->n_batch_slots != udpsrc->batch_size) {
+    gst_udpsrc_clear_batch (udpsrc);
+    udpsrc->batch_slots = g_new0 (GstUDPSrcBatchSlot, udpsrc->batch_size);
+    udpsrc->batch_msgs = g_new0 (GInputMessage, udpsrc->batch_size);
+    udpsrc->n_batch_slots = udpsrc->batch_size;
+  }
+
+  slots = udpsrc->batch_slots;
+
+  pool = gst_base_src_get_buffer_pool (GST_BASE_SRC_CAST (udpsrc));
+  if (pool == NULL)
+    goto no_pool;
+
+  for (i = 0; i < udpsrc->n_batch_slots; i++) {
+    GstUDPSrcBatchSlot *slot = &slots[i];
+    GInputMessage *msg = &udpsrc->batch_msgs[i];
+
+    if (slot->buffer == NULL) {
+      flow = gst_buffer_pool_acquire_buffer (pool, &slot->buffer, NULL);
+      if (flow != GST_FLOW_OK)
+        break;
+
+      if (!gst_buffer_map (slot->buffer, &slot->map, GST_MAP_READWRITE)) {
+        gst_buffer_unref (slot->buffer);
+        slot->buffer = NULL;
+        gst_object_unref (pool);
+        goto buffer_map_error;
+      }
+
+      slot->vec.buffer = slot->map.data;
+      slot->vec.size = slot->map.size;
+    }
+
+    msg->address = udpsrc->retrieve_sender_address ? &slot->saddr : NULL;
+    msg->vectors = &slot->vec;
+    msg->num_vectors = 1;
+    msg->bytes_received = 0;
+    msg->flags = G_SOCKET_MSG_NONE;
+    msg->control_messages = need_msgs ? &slot->msgs : NULL;
+    msg->num_control_messages = need_msgs ? &slot->n_msgs : NULL;
+  }
+
+  gst_object_unref (pool);
+
+  return flow;
+
+  /* ERRORS */
+no_pool:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("No buffer pool to receive into"));
+    return GST_FLOW_ERROR;
+  }
+buffer_map_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+        ("Failed to map memory"));
+    return GST_FLOW_ERROR;
+  }
+}
+
+/* Reads up to batch-size packets with one g_socket_receive_messages() call
+ * into a buffer list */
+static GstFlowReturn
+gst_udpsrc_receive_batch (GstUDPSrc * udpsrc, GstBufferList ** p_list)
+{
+  GstUDPSrcBatchSlot *slots;
+  GstBufferList *list;
+  GstClockTime now;
+  GstFlowReturn flow;
+  gboolean need_msgs;
+  GError *err = NULL;
+  gint res, i;
+
+  need_msgs = gst_udpsrc_needs_control_messages (udpsrc);
+
+retry:
+  flow = gst_udpsrc_prepare_batch (udpsrc, need_msgs);
+  if (flow != GST_FLOW_OK)
+    return flow;
+
+  slots = udpsrc->batch_slots;
+
+  flow = gst_udpsrc_wait_readable (udpsrc);
+  if (flow != GST_FLOW_OK)
+    return flow;
+
+  res =
+      g_socket_receive_messages (udpsrc->used_socket, udpsrc->batch_msgs,
+      udpsrc->n_batch_slots, G_SOCKET_MSG_NONE, udpsrc->cancellable, &err);
+
+  if (G_UNLIKELY (res < 0)) {
+    /* see gst_udpsrc_fill(), we can also be woken up without a packet being
+     * left to read */
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_HOST_UNREACHABLE) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+      g_clear_error (&err);
+      goto retry;
+    }
+    goto receive_error;
+  }
+
+  now = GST_CLOCK_TIME_NONE;
+  if (gst_base_src_get_do_timestamp (GST_BASE_SRC_CAST (udpsrc))) {
+    GstClock *clock = gst_element_get_clock (GST_ELEMENT_CAST (udpsrc));
+
+    if (clock) {
+      GstClockTime base_time =
+          gst_element_get_base_time (GST_ELEMENT_CAST (udpsrc));
+
+      now = gst_clock_get_time (clock);
+      now = now > base_time ? now - base_time : 0;
+      gst_object_unref (clock);
+    }
+  }
+
+  list = gst_buffer_list_new_sized (res);
+
+  for (i = 0; i < res; i++) {
+    GstUDPSrcBatchSlot *slot = &slots[i];
+    GInputMessage *msg = &udpsrc->batch_msgs[i];
+    GstBuffer *outbuf = slot->buffer;
+    gsize offset = udpsrc->skip_first_bytes;
+    gboolean drop = FALSE;
+
+    gst_buffer_unmap (outbuf, &slot->map);
+    slot->buffer = NULL;
+
+    if (need_msgs) {
+      drop = gst_udpsrc_process_control_messages (udpsrc, slot->msgs,
+          slot->n_msgs, outbuf);
+      slot->msgs = NULL;
+      slot->n_msgs = 0;
+
+      if (drop)
+        GST_DEBUG_OBJECT (udpsrc,
+            "Dropping packet for a different multicast address");
+    }
+#ifdef MSG_TRUNC
+    if (!drop && (msg->flags & MSG_TRUNC)) {
+      GST_WARNING_OBJECT (udpsrc, "Dropping packet bigger than the mtu of %u "
+          "bytes", udpsrc->mtu);
+      drop = TRUE;
+    }
+#endif
+
+    if (!drop && G_UNLIKELY (offset > 0 && msg->bytes_received < offset)) {
+      gst_buffer_unref (outbuf);
+      for (; i < res; i++)
+        gst_udpsrc_batch_slot_clear (&slots[i]);
+      gst_buffer_list_unref (list);
+      goto skip_error;
+    }
+
+    if (drop) {
+      gst_buffer_unref (outbuf);
+      g_clear_object (&slot->saddr);
+      continue;
+    }
+
+    gst_buffer_resize (outbuf, offset, msg->bytes_received - offset);
+
+    if (slot->saddr) {
+      gst_buffer_add_net_address_meta (outbuf, slot->saddr);
+      g_clear_object (&slot->saddr);
+    }
+
+    /* basesrc only timestamps the first buffer of a list */
+    if (!GST_BUFFER_DTS_IS_VALID (outbuf))
+      GST_BUFFER_DTS (outbuf) = now;
+
+    gst_buffer_list_add (list, outbuf);
+  }
+
+  GST_LOG_OBJECT (udpsrc, "read %d packets, pushing %u", res,
+      gst_buffer_list_length (list));
+
+  if (gst_buffer_list_length (list) == 0) {
+    gst_buffer_list_unref (list);
+    goto retry;
+  }
+
+  *p_list = list;
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+receive_error:
+  {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_BUSY) ||
+        g_error_matches (err, G_IO_ERROR, G_IO_ERROR_CANCELLED)) {
+      g_clear_error (&err);
+      return GST_FLOW_FLUSHING;
+    } else {
+      GST_ELEMENT_ERROR (udpsrc, RESOURCE, READ, (NULL),
+          ("receive error %d: %s", res, err->message));
+      g_clear_error (&err);
+      return GST_FLOW_ERROR;
+    }
+  }
+skip_error:
+  {
+    GST_ELEMENT_ERROR (udpsrc, STREAM, DECODE, (NULL),
+        ("UDP buffer to small to skip header"));
+    return GST_FLOW_ERROR;
+  }
+}
+
+static GstFlowReturn
+gst_udpsrc_create (GstPushSrc * psrc, GstBuffer ** buf)
+{
+  GstUDPSrc *udpsrc = GST_UDPSRC_CAST (psrc);
+  GstBaseSrc *bsrc = GST_BASE_SRC_CAST (psrc);
+  GstBufferList *list = NULL;
+  GstFlowReturn flow;
+
+  if (udpsrc->batch_size <= 1) {
+    /* one packet per buffer, allocate and fill like GstPushSrc does */
+    flow = GST_BASE_SRC_GET_CLASS (bsrc)->alloc (bsrc, -1,
+        gst_base_src_get_blocksize (bsrc), buf);
+    if (flow != GST_FLOW_OK)
+      return flow;
+
+    flow = gst_udpsrc_fill (psrc, *buf);
+    if (flow != GST_FLOW_OK)
+      gst_buffer_replace (buf, NULL);
+
+    return flow;
+  }
+
+  flow = gst_udpsrc_receive_batch (udpsrc, &list);
+  if (flow != GST_FLOW_OK)
+    return flow;
+
+  gst_base_src_submit_buffer_list (bsrc, list);
+  *buf = NULL;
+
+  return GST_FLOW_OK;
+}
+
 static gboolean
 gst_udpsrc_set_uri (GstUDPSrc * src, const gchar * uri, GError ** error)
 {
@@ -1375,6 +1739,9 @@ gst_udpsrc_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_SOCKET_TIMESTAMP:
       udpsrc->socket_timestamp_mode = g_value_get_enum (value);
       break;
+    case PROP_BATCH_SIZE:
+      udpsrc->batch_size = g_value_get_uint (value);
+      break;
     default:
       break;
   }
@@ -1441,6 +1808,9 @@ gst_udpsrc_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_SOCKET_TIMESTAMP:
       g_value_set_enum (value, udpsrc->socket_timestamp_mode);
       break;
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, udpsrc->batch_size);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1754,6 +2124,15 @@ gst_udpsrc_open (GstUDPSrc * src)
   }
 #endif
 
+  /* we always wait for the socket to become readable, a batched read must
+   * only return the packets that are already there */
+  if (src->batch_size > 1) {
+    /* the application might still use its socket after we're done */
+    if (src->external_socket)
+      src->restore_blocking = g_socket_get_blocking (src->used_socket);
+    g_socket_set_blocking (src->used_socket, FALSE);
+  }
+
   /* NOTE: sockaddr_in.sin_port works for ipv4 and ipv6 because sin_port
    * follows ss_family on both */
   {
@@ -1894,7 +2273,10 @@ gst_udpsrc_close (GstUDPSrc * src)
         GST_ERROR_OBJECT (src, "Failed to close socket: %s", err->message);
         g_clear_error (&err);
       }
+    } else if (src->restore_blocking) {
+      g_socket_set_blocking (src->used_socket, TRUE);
     }
+    src->restore_blocking = FALSE;
 
     g_object_unref (src->used_socket);
     src->used_socket = NULL;
@@ -1930,6 +2312,9 @@ gst_udpsrc_change_state (GstElement * element, GstStateChange transition)
     goto failure;
 
   switch (transition) {
+    case GST_STATE_CHANGE_PAUSED_TO_READY:
+      gst_udpsrc_clear_batch (src);
+      break;
     case GST_STATE_CHANGE_READY_TO_NULL:
       gst_udpsrc_close (src);
       break;
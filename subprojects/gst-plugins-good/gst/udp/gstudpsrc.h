@@ -96,6 +96,14 @@ struct _GstUDPSrc {
   /* Extra memory for buffers with a size superior to max_packet_size */
   GstMemory *extra_mem;
 
+  /* Batched receiving, with one slot per message */
+  guint batch_size;
+  guint n_batch_slots;
+  gpointer batch_slots;
+  GInputMessage *batch_msgs;
+  /* blocking mode of an external socket to restore when closing */
+  gboolean restore_blocking;
+
   gchar     *uri;
 };
 
@@ -1104,10 +1104,16 @@ gst_v4l2_allocator_import_dmabuf (GstV4l2Allocator * allocator,
   for (i = 0; i < group->n_mem; i++) {
     gint dmafd;
     gsize size, offset, maxsize;
+    guint64 modifier;
 
     if (!gst_is_dmabuf_memory (dma_mem[i]))
       goto not_dmabuf;
 
+    /* V4L2 has no way to describe tiled or compressed layouts to the driver */
+    gst_dmabuf_memory_get_drm_modifier (dma_mem[i], &modifier);
+    if (modifier != GST_DMABUF_DRM_MODIFIER_LINEAR)
+      goto not_linear;
+
     size = gst_memory_get_sizes (dma_mem[i], &offset, &maxsize);
 
     dmafd = gst_dmabuf_memory_get_fd (dma_mem[i]);
@@ -1155,6 +1161,12 @@ not_dmabuf:
     GST_ERROR_OBJECT (allocator, "Memory %i is not of DMABUF", i);
     return FALSE;
   }
+not_linear:
+  {
+    GST_ERROR_OBJECT (allocator, "Memory %i has non-linear DRM modifier %#"
+        G_GINT64_MODIFIER "x", i, modifier);
+    return FALSE;
+  }
 }
 
 gboolean
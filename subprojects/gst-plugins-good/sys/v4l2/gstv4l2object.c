@@ -5415,10 +5415,19 @@ gst_v4l2_object_try_import (GstV4l2Object * obj, GstBuffer * buffer)
     for (i = 0; i < n_mem; i++) {
       GstMemory *mem = gst_buffer_peek_memory (buffer, i);
 
+      guint64 modifier;
+
       if (!gst_is_dmabuf_memory (mem)) {
         GST_DEBUG_OBJECT (obj->dbg_obj, "Cannot import non-DMABuf memory.");
         return FALSE;
       }
+
+      gst_dmabuf_memory_get_drm_modifier (mem, &modifier);
+      if (modifier != GST_DMABUF_DRM_MODIFIER_LINEAR) {
+        GST_DEBUG_OBJECT (obj->dbg_obj, "Cannot import DMABuf with modifier "
+            "0x%" G_GINT64_MODIFIER "x", modifier);
+        return FALSE;
+      }
     }
   }
 
@@ -5426,6 +5435,56 @@ gst_v4l2_object_try_import (GstV4l2Object * obj, GstBuffer * buffer)
   return TRUE;
 }
 
+/**
+ * gst_v4l2_object_select_import_mode:
+ * @obj: a #GstV4l2Object for an output queue
+ * @buffer: the first buffer that will be queued
+ *
+ * When the io-mode was left to auto, switch the output queue over to DMABuf
+ * importation if @buffer can be imported as is, so that upstream memory that
+ * was not allocated from our pool does not get copied into driver buffers.
+ * Otherwise the queue stays in MMAP mode and buffers are copied.
+ *
+ * Must be called before the buffer pool is configured.
+ *
+ * Returns: %TRUE if the mode was switched to %GST_V4L2_IO_DMABUF_IMPORT
+ */
+gboolean
+gst_v4l2_object_select_import_mode (GstV4l2Object * obj, GstBuffer * buffer)
+{
+  GstV4l2BufferPool *pool;
+  gboolean can_import;
+
+  if (obj->req_mode != GST_V4L2_IO_AUTO || obj->mode != GST_V4L2_IO_MMAP)
+    return FALSE;
+
+  if (!V4L2_TYPE_IS_OUTPUT (obj->type) || !buffer)
+    return FALSE;
+
+  pool = GST_V4L2_BUFFER_POOL (gst_v4l2_object_get_buffer_pool (obj));
+  if (!pool)
+    return FALSE;
+
+  /* buffers from our own pool are already zero-copy */
+  can_import = buffer->pool != GST_BUFFER_POOL (pool) &&
+      GST_V4L2_ALLOCATOR_CAN_REQUEST (pool->vallocator, DMABUF);
+  gst_object_unref (pool);
+
+  if (!can_import)
+    return FALSE;
+
+  obj->mode = GST_V4L2_IO_DMABUF_IMPORT;
+  if (!gst_v4l2_object_try_import (obj, buffer)) {
+    GST_DEBUG_OBJECT (obj->dbg_obj, "cannot import upstream buffers, copying");
+    obj->mode = GST_V4L2_IO_MMAP;
+    return FALSE;
+  }
+
+  GST_INFO_OBJECT (obj->dbg_obj, "importing upstream DMABuf");
+
+  return TRUE;
+}
+
 /**
  * gst_v4l2_object_get_buffer_pool:
  * @src: a #GstV4l2Object
@@ -903,6 +903,8 @@ gst_v4l2_transform_prepare_output_buffer (GstBaseTransform * trans,
     gint min = MAX (GST_V4L2_MIN_BUFFERS (self->v4l2output),
         self->v4l2output->min_buffers);
 
+    gst_v4l2_object_select_import_mode (self->v4l2output, inbuf);
+
     if (self->v4l2output->mode == GST_V4L2_IO_USERPTR ||
         self->v4l2output->mode == GST_V4L2_IO_DMABUF_IMPORT) {
       if (!gst_v4l2_object_try_import (self->v4l2output, inbuf)) {
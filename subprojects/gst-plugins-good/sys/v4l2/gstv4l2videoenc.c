@@ -775,6 +775,13 @@ gst_v4l2_video_enc_handle_frame (GstVideoEncoder * encoder,
       guint min = MAX (self->v4l2output->min_buffers,
           GST_V4L2_MIN_BUFFERS (self->v4l2output));
 
+      /* Import upstream DMABuf directly when possible instead of copying
+       * into our own buffers */
+      if (gst_v4l2_object_select_import_mode (self->v4l2output,
+              frame->input_buffer) && self->v4l2output->need_video_meta)
+        gst_buffer_pool_config_add_option (config,
+            GST_BUFFER_POOL_OPTION_VIDEO_META);
+
       gst_buffer_pool_config_set_params (config, self->input_state->caps,
           self->v4l2output->info.size, min, min);
 
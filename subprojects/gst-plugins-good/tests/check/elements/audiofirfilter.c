@@ -22,8 +22,12 @@
  * with newer GLib versions (>= 2.31.0) */
 #define GLIB_DISABLE_DEPRECATION_WARNINGS
 
+#include <math.h>
+
 #include <gst/gst.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+#include <gst/audio/audio.h>
 
 static gboolean have_eos = FALSE;
 
@@ -178,6 +182,73 @@ GST_START_TEST (test_pipeline)
 
 GST_END_TEST;
 
+#define PARTITIONED_KERNEL_LENGTH 300
+#define PARTITIONED_SAMPLES 1000
+
+GST_START_TEST (test_partitioned)
+{
+  GstHarness *h;
+  GValueArray *va;
+  GValue v = { 0, };
+  gdouble kernel[PARTITIONED_KERNEL_LENGTH];
+  gdouble input[PARTITIONED_SAMPLES];
+  GstBuffer *buffer;
+  GstMapInfo map;
+  guint i, j, n = 0;
+
+  h = gst_harness_new ("audiofirfilter");
+  g_object_set (h->element, "partition-size", 64, NULL);
+
+  va = g_value_array_new (PARTITIONED_KERNEL_LENGTH);
+  g_value_init (&v, G_TYPE_DOUBLE);
+  for (i = 0; i < PARTITIONED_KERNEL_LENGTH; i++) {
+    kernel[i] = sin (i * 0.37) * exp (-(gdouble) i / 100.0);
+    g_value_set_double (&v, kernel[i]);
+    g_value_array_append (va, &v);
+  }
+  g_value_unset (&v);
+  g_object_set (h->element, "kernel", va, NULL);
+  g_value_array_free (va);
+
+  gst_harness_set_src_caps_str (h, "audio/x-raw, format=(string)"
+      GST_AUDIO_NE (F64) ", rate=(int)44100, channels=(int)1, "
+      "layout=(string)interleaved");
+
+  for (i = 0; i < PARTITIONED_SAMPLES; i++)
+    input[i] = sin (i * 0.1) + 0.3 * cos (i * 1.7);
+
+  /* two buffers that are no multiple of the partition size */
+  for (i = 0; i < 2; i++) {
+    buffer = gst_buffer_new_memdup (input + i * PARTITIONED_SAMPLES / 2,
+        PARTITIONED_SAMPLES / 2 * sizeof (gdouble));
+    GST_BUFFER_PTS (buffer) = gst_util_uint64_scale_int (i *
+        PARTITIONED_SAMPLES / 2, GST_SECOND, 44100);
+    fail_unless_equals_int (gst_harness_push (h, buffer), GST_FLOW_OK);
+  }
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  /* the output must be the linear convolution */
+  while ((buffer = gst_harness_try_pull (h))) {
+    gst_buffer_map (buffer, &map, GST_MAP_READ);
+    for (i = 0; i < map.size / sizeof (gdouble); i++, n++) {
+      gdouble expected = 0.0;
+
+      for (j = 0; j < PARTITIONED_KERNEL_LENGTH && j <= n; j++)
+        expected += input[n - j] * kernel[j];
+      fail_unless (n < PARTITIONED_SAMPLES);
+      fail_unless (fabs (((gdouble *) map.data)[i] - expected) < 1e-9,
+          "sample %u: %g != %g", n, ((gdouble *) map.data)[i], expected);
+    }
+    gst_buffer_unmap (buffer, &map);
+    gst_buffer_unref (buffer);
+  }
+  fail_unless_equals_int (n, PARTITIONED_SAMPLES);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 audiofirfilter_suite (void)
 {
@@ -186,6 +257,7 @@ audiofirfilter_suite (void)
 
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_pipeline);
+  tcase_add_test (tc_chain, test_partitioned);
 
   return s;
 }
@@ -23,6 +23,7 @@
 
 #include <stdio.h>
 #include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
 #include <gst/video/video.h>
 
 static gboolean
@@ -1018,6 +1019,88 @@ GST_END_TEST;
 
 
 
+/* Deinterlace frames of random data with yadif and return all output frames
+ * in one buffer */
+static GstBuffer *
+run_yadif (const gchar * format, guint max_threads)
+{
+  GstHarness *h;
+  GstVideoInfo info;
+  GstBuffer *buf, *result;
+  GstCaps *caps;
+  GstMapInfo map;
+  GRand *rand;
+  guint i, j;
+
+  h = gst_harness_new_parse ("deinterlace method=yadif fields=all");
+  gst_harness_set (h, "deinterlace", "max-threads", max_threads, NULL);
+
+  caps = gst_caps_new_simple ("video/x-raw", "format", G_TYPE_STRING, format,
+      "width", G_TYPE_INT, 64, "height", G_TYPE_INT, 96,
+      "framerate", GST_TYPE_FRACTION, 25, 1,
+      "interlace-mode", G_TYPE_STRING, "interleaved", NULL);
+  fail_unless (gst_video_info_from_caps (&info, caps));
+  gst_harness_set_src_caps (h, caps);
+
+  rand = g_rand_new_with_seed (42);
+  for (i = 0; i < 6; i++) {
+    buf = gst_buffer_new_allocate (NULL, info.size, NULL);
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
+    for (j = 0; j < map.size; j++)
+      map.data[j] = g_rand_int (rand);
+    gst_buffer_unmap (buf, &map);
+
+    GST_BUFFER_PTS (buf) = i * 40 * GST_MSECOND;
+    GST_BUFFER_DURATION (buf) = 40 * GST_MSECOND;
+    GST_BUFFER_FLAG_SET (buf, GST_VIDEO_BUFFER_FLAG_INTERLACED);
+    GST_BUFFER_FLAG_SET (buf, GST_VIDEO_BUFFER_FLAG_TFF);
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+  }
+  g_rand_free (rand);
+
+  fail_unless (gst_harness_push_event (h, gst_event_new_eos ()));
+
+  result = gst_buffer_new ();
+  while ((buf = gst_harness_try_pull (h)))
+    result = gst_buffer_append (result, buf);
+
+  gst_harness_teardown (h);
+
+  return result;
+}
+
+static void
+check_yadif_threads (const gchar * format)
+{
+  GstBuffer *expected, *buf;
+  GstMapInfo map;
+  guint max_threads;
+
+  expected = run_yadif (format, 1);
+  fail_unless (gst_buffer_get_size (expected) > 0);
+  gst_buffer_map (expected, &map, GST_MAP_READ);
+
+  for (max_threads = 2; max_threads <= 5; max_threads += 3) {
+    buf = run_yadif (format, max_threads);
+    fail_unless_equals_int (gst_buffer_get_size (buf), map.size);
+    fail_unless (gst_buffer_memcmp (buf, 0, map.data, map.size) == 0,
+        "%s output with %u threads differs", format, max_threads);
+    gst_buffer_unref (buf);
+  }
+
+  gst_buffer_unmap (expected, &map);
+  gst_buffer_unref (expected);
+}
+
+GST_START_TEST (test_yadif_max_threads)
+{
+  check_yadif_threads ("I420");
+  check_yadif_threads ("NV12");
+  check_yadif_threads ("P010_10LE");
+}
+
+GST_END_TEST;
+
 static Suite *
 deinterlace_suite (void)
 {
@@ -1045,6 +1128,7 @@ deinterlace_suite (void)
   tcase_add_test (tc_chain, test_mode_auto_expected_caps);
   tcase_add_test (tc_chain, test_mode_auto_strict_expected_caps);
   tcase_add_test (tc_chain, test_fields_auto_expected_caps);
+  tcase_add_test (tc_chain, test_yadif_max_threads);
 
   return s;
 }
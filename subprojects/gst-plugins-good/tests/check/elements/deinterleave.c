@@ -199,6 +199,104 @@ GST_START_TEST (test_2_channels)
 
 GST_END_TEST;
 
+static guint8 *planar_data;
+
+static GstFlowReturn
+deinterleave_planar_chain_func (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstMapInfo map;
+  gint channel;
+
+  channel = strcmp (GST_PAD_NAME (pad), "sink0") == 0 ? 0 : 1;
+
+  /* the planes are pushed without copying */
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  fail_unless (map.data == planar_data + channel * 48000 * sizeof (gfloat));
+  gst_buffer_unmap (buffer, &map);
+
+  return deinterleave_chain_func (pad, parent, buffer);
+}
+
+static void
+deinterleave_planar_pad_added (GstElement * src, GstPad * pad, gpointer data)
+{
+  deinterleave_pad_added (src, pad, data);
+  gst_pad_set_chain_function (mysinkpads[nsinkpads - 1],
+      deinterleave_planar_chain_func);
+}
+
+GST_START_TEST (test_2_channels_non_interleaved)
+{
+  GstPad *sinkpad;
+  gint i;
+  GstBuffer *inbuf;
+  GstCaps *caps;
+  gfloat *indata;
+  GstMapInfo map;
+  GstAudioInfo info;
+
+  mysinkpads = g_new0 (GstPad *, 2);
+  nsinkpads = 0;
+
+  deinterleave = gst_element_factory_make ("deinterleave", NULL);
+  fail_unless (deinterleave != NULL);
+
+  mysrcpad = gst_pad_new ("src", GST_PAD_SRC);
+  fail_unless (mysrcpad != NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+
+  gst_audio_info_set_format (&info, GST_AUDIO_FORMAT_F32, 48000, 2, NULL);
+  GST_AUDIO_INFO_LAYOUT (&info) = GST_AUDIO_LAYOUT_NON_INTERLEAVED;
+  caps = gst_audio_info_to_caps (&info);
+
+  gst_check_setup_events (mysrcpad, deinterleave, caps, GST_FORMAT_TIME);
+
+  sinkpad = gst_element_get_static_pad (deinterleave, "sink");
+  fail_unless (sinkpad != NULL);
+  fail_unless (gst_pad_link (mysrcpad, sinkpad) == GST_PAD_LINK_OK);
+  g_object_unref (sinkpad);
+
+  g_signal_connect (deinterleave, "pad-added",
+      G_CALLBACK (deinterleave_planar_pad_added), GINT_TO_POINTER (2));
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (deinterleave, bus);
+
+  fail_unless (gst_element_set_state (deinterleave,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+
+  inbuf = gst_buffer_new_and_alloc (2 * 48000 * sizeof (gfloat));
+  gst_buffer_add_audio_meta (inbuf, &info, 48000, NULL);
+  gst_buffer_map (inbuf, &map, GST_MAP_WRITE);
+  indata = (gfloat *) map.data;
+  for (i = 0; i < 48000; i++) {
+    indata[i] = -1.0;
+    indata[48000 + i] = 1.0;
+  }
+  planar_data = map.data;
+  gst_buffer_unmap (inbuf, &map);
+
+  fail_unless (gst_pad_push (mysrcpad, inbuf) == GST_FLOW_OK);
+  fail_unless_equals_int (nsinkpads, 2);
+
+  fail_unless (gst_element_set_state (deinterleave,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+
+  for (i = 0; i < nsinkpads; i++)
+    g_object_unref (mysinkpads[i]);
+  g_free (mysinkpads);
+  mysinkpads = NULL;
+
+  g_object_unref (deinterleave);
+  gst_bus_set_flushing (bus, TRUE);
+  g_object_unref (bus);
+  gst_caps_unref (caps);
+  gst_object_unref (mysrcpad);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_2_channels_1_linked)
 {
   GstPad *sinkpad;
@@ -648,6 +746,7 @@ deinterleave_suite (void)
   tcase_add_test (tc_chain, test_create_and_unref);
   tcase_add_test (tc_chain, test_2_channels);
   tcase_add_test (tc_chain, test_2_channels_1_linked);
+  tcase_add_test (tc_chain, test_2_channels_non_interleaved);
   tcase_add_test (tc_chain, test_2_channels_caps_change);
   tcase_add_test (tc_chain, test_8_channels_float32);
 
@@ -274,6 +274,150 @@ GST_START_TEST (test_interleave_2ch)
 
 GST_END_TEST;
 
+static GstStaticPadTemplate planar_sinktemplate =
+GST_STATIC_PAD_TEMPLATE ("sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS ("audio/x-raw, "
+        "format = (string) " GST_AUDIO_NE (F32) ", "
+        "channels = (int) 2, layout = (string) non-interleaved, rate = (int) 48000"));
+
+static GstFlowReturn
+interleave_planar_chain_func (GstPad * pad, GstObject * parent,
+    GstBuffer * buffer)
+{
+  GstAudioMeta *meta;
+  GstMapInfo map;
+  gfloat *outdata;
+  gint i, c;
+
+  meta = gst_buffer_get_audio_meta (buffer);
+  fail_unless (meta != NULL);
+  fail_unless_equals_int (meta->samples, 48000);
+  fail_unless_equals_int (GST_AUDIO_INFO_CHANNELS (&meta->info), 2);
+
+  /* one memory per input channel */
+  fail_unless_equals_int (gst_buffer_n_memory (buffer), 2);
+
+  gst_buffer_map (buffer, &map, GST_MAP_READ);
+  for (c = 0; c < 2; c++) {
+    outdata = (gfloat *) (map.data + meta->offsets[c]);
+    for (i = 0; i < 48000; i++)
+      fail_unless_equals_float (outdata[i], input[c]);
+  }
+  gst_buffer_unmap (buffer, &map);
+  gst_buffer_unref (buffer);
+
+  have_data++;
+
+  return GST_FLOW_OK;
+}
+
+GST_START_TEST (test_interleave_2ch_non_interleaved_output)
+{
+  GstElement *queue;
+  GstPad *sink0, *sink1, *src, *tmp;
+  GstCaps *caps;
+  gint i, c;
+  GstBuffer *inbuf;
+  gfloat *indata;
+  GstMapInfo map;
+
+  mysrcpads = g_new0 (GstPad *, 2);
+
+  have_data = 0;
+
+  interleave = gst_element_factory_make ("interleave", NULL);
+  fail_unless (interleave != NULL);
+
+  queue = gst_element_factory_make ("queue", "queue");
+  fail_unless (queue != NULL);
+
+  sink0 = gst_element_request_pad_simple (interleave, "sink_%u");
+  fail_unless (sink0 != NULL);
+  sink1 = gst_element_request_pad_simple (interleave, "sink_%u");
+  fail_unless (sink1 != NULL);
+
+  caps = gst_caps_from_string (CAPS_48khz);
+  for (c = 0; c < 2; c++) {
+    gchar *name = g_strdup_printf ("src%d", c);
+    gchar *stream_id = g_strdup_printf ("%d", c);
+
+    mysrcpads[c] = gst_pad_new_from_static_template (&srctemplate, name);
+    fail_unless (mysrcpads[c] != NULL);
+    gst_pad_set_active (mysrcpads[c], TRUE);
+    gst_check_setup_events_interleave (mysrcpads[c], interleave, caps,
+        GST_FORMAT_TIME, stream_id);
+    gst_pad_use_fixed_caps (mysrcpads[c]);
+    g_free (stream_id);
+    g_free (name);
+  }
+
+  tmp = gst_element_get_static_pad (queue, "sink");
+  fail_unless (gst_pad_link (mysrcpads[0], tmp) == GST_PAD_LINK_OK);
+  gst_object_unref (tmp);
+  tmp = gst_element_get_static_pad (queue, "src");
+  fail_unless (gst_pad_link (tmp, sink0) == GST_PAD_LINK_OK);
+  gst_object_unref (tmp);
+
+  fail_unless (gst_pad_link (mysrcpads[1], sink1) == GST_PAD_LINK_OK);
+
+  /* downstream only accepts non-interleaved audio */
+  mysinkpad = gst_pad_new_from_static_template (&planar_sinktemplate, "sink");
+  fail_unless (mysinkpad != NULL);
+  gst_pad_set_chain_function (mysinkpad, interleave_planar_chain_func);
+  gst_pad_set_active (mysinkpad, TRUE);
+
+  src = gst_element_get_static_pad (interleave, "src");
+  fail_unless (src != NULL);
+  fail_unless (gst_pad_link (src, mysinkpad) == GST_PAD_LINK_OK);
+  gst_object_unref (src);
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (interleave, bus);
+
+  fail_unless (gst_element_set_state (interleave,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+
+  input[0] = -1.0;
+  input[1] = 1.0;
+  for (c = 0; c < 2; c++) {
+    inbuf = gst_buffer_new_and_alloc (48000 * sizeof (gfloat));
+    gst_buffer_map (inbuf, &map, GST_MAP_WRITE);
+    indata = (gfloat *) map.data;
+    for (i = 0; i < 48000; i++)
+      indata[i] = input[c];
+    gst_buffer_unmap (inbuf, &map);
+    fail_unless (gst_pad_push (mysrcpads[c], inbuf) == GST_FLOW_OK);
+  }
+
+  fail_unless (have_data == 1);
+
+  gst_bus_set_flushing (bus, TRUE);
+  gst_element_set_state (interleave, GST_STATE_NULL);
+  gst_element_set_state (queue, GST_STATE_NULL);
+
+  gst_object_unref (mysrcpads[0]);
+  gst_object_unref (mysrcpads[1]);
+  gst_object_unref (mysinkpad);
+
+  gst_element_release_request_pad (interleave, sink0);
+  gst_object_unref (sink0);
+  gst_element_release_request_pad (interleave, sink1);
+  gst_object_unref (sink1);
+
+  gst_object_unref (interleave);
+  gst_object_unref (queue);
+  gst_object_unref (bus);
+  gst_caps_unref (caps);
+
+  g_free (mysrcpads);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_interleave_2ch_1eos)
 {
   GstElement *queue;
@@ -815,6 +959,7 @@ interleave_suite (void)
   tcase_add_test (tc_chain, test_request_pads);
   tcase_add_test (tc_chain, test_interleave_2ch);
   tcase_add_test (tc_chain, test_interleave_2ch_1eos);
+  tcase_add_test (tc_chain, test_interleave_2ch_non_interleaved_output);
   tcase_add_test (tc_chain, test_interleave_2ch_pipeline_interleaved);
   tcase_add_test (tc_chain, test_interleave_2ch_pipeline_non_interleaved);
   tcase_add_test (tc_chain, test_interleave_2ch_pipeline_input_chanpos);
@@ -125,6 +125,82 @@ GST_START_TEST (test_jpegdec_discover)
 
 GST_END_TEST;
 
+static GstSample *
+pull_decoded_sample (const gchar * description)
+{
+  GstElement *pipeline, *sink;
+  GstSample *sample;
+  GError *error = NULL;
+
+  pipeline = gst_parse_launch (description, &error);
+  fail_unless (pipeline != NULL, "%s", (error ? error->message : ""));
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  sample = gst_app_sink_pull_sample (GST_APP_SINK (sink));
+  fail_unless (GST_IS_SAMPLE (sample));
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (sink);
+  gst_object_unref (pipeline);
+
+  return sample;
+}
+
+/* Decoding the slices of a frame encoded with several threads in parallel
+ * has to give the same image as decoding it in one go. */
+GST_START_TEST (test_jpegdec_max_threads)
+{
+  GstSample *serial, *parallel;
+  GstMapInfo serial_map, parallel_map;
+  GstBuffer *serial_buf, *parallel_buf;
+
+  serial = pull_decoded_sample ("videotestsrc num-buffers=1 pattern=smpte ! "
+      "video/x-raw, format=I420, width=640, height=480 ! "
+      "jpegenc max-threads=4 ! jpegdec max-threads=1 ! appsink name=sink");
+  parallel = pull_decoded_sample ("videotestsrc num-buffers=1 pattern=smpte ! "
+      "video/x-raw, format=I420, width=640, height=480 ! "
+      "jpegenc max-threads=4 ! jpegdec max-threads=4 ! appsink name=sink");
+
+  serial_buf = gst_sample_get_buffer (serial);
+  parallel_buf = gst_sample_get_buffer (parallel);
+  fail_unless (gst_buffer_map (serial_buf, &serial_map, GST_MAP_READ));
+  fail_unless (gst_buffer_map (parallel_buf, &parallel_map, GST_MAP_READ));
+  fail_unless_equals_uint64 (serial_map.size, parallel_map.size);
+  fail_unless (memcmp (serial_map.data, parallel_map.data,
+          serial_map.size) == 0);
+  gst_buffer_unmap (serial_buf, &serial_map);
+  gst_buffer_unmap (parallel_buf, &parallel_map);
+
+  gst_sample_unref (serial);
+  gst_sample_unref (parallel);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_jpegdec_downscale)
+{
+  GstSample *sample;
+  GstCaps *expected;
+  gchar *filename, *description;
+
+  filename = g_build_filename (GST_TEST_FILES_PATH, "image.jpg", NULL);
+  description = g_strdup_printf ("filesrc location=\"%s\" ! "
+      "jpegdec downscale=2 ! appsink name=sink", filename);
+  sample = pull_decoded_sample (description);
+
+  expected = gst_caps_from_string ("video/x-raw, width=60, height=80");
+  fail_unless (gst_caps_is_always_compatible (gst_sample_get_caps (sample),
+          expected));
+
+  gst_caps_unref (expected);
+  gst_sample_unref (sample);
+  g_free (description);
+  g_free (filename);
+}
+
+GST_END_TEST;
+
 static Suite *
 jpegdec_suite (void)
 {
@@ -134,6 +210,8 @@ jpegdec_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_jpegdec_explicit);
   tcase_add_test (tc_chain, test_jpegdec_discover);
+  tcase_add_test (tc_chain, test_jpegdec_max_threads);
+  tcase_add_test (tc_chain, test_jpegdec_downscale);
 
   return s;
 }
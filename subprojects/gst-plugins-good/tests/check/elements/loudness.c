@@ -0,0 +1,156 @@
+/* GStreamer
+ *
+ * unit test for loudness
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <math.h>
+#include <gst/audio/audio.h>
+#include <gst/check/gstcheck.h>
+#include <gst/check/gstharness.h>
+
+#define RATE 48000
+
+#define LOUDNESS_CAPS_STRING \
+  "audio/x-raw, " \
+    "format = (string) "GST_AUDIO_NE(F32)", " \
+    "layout = (string) interleaved, " \
+    "rate = (int) 48000, " \
+    "channels = (int) %d, "  \
+    "channel-mask = (bitmask) %s"
+
+/* push @seconds of a 1kHz sine with @amplitude on the first @loud channels
+ * and silence on the others, in buffers of 1/10s */
+static void
+push_sine (GstHarness * h, gint channels, gint loud, gdouble amplitude,
+    gint seconds)
+{
+  gint i, j, c, n = 0;
+
+  for (i = 0; i < seconds * 10; i++) {
+    GstBuffer *buf;
+    GstMapInfo map;
+    gfloat *data;
+
+    buf = gst_buffer_new_allocate (NULL,
+        RATE / 10 * channels * sizeof (gfloat), NULL);
+    GST_BUFFER_TIMESTAMP (buf) = i * GST_SECOND / 10;
+    GST_BUFFER_DURATION (buf) = GST_SECOND / 10;
+
+    gst_buffer_map (buf, &map, GST_MAP_WRITE);
+    data = (gfloat *) map.data;
+    for (j = 0; j < RATE / 10; j++, n++) {
+      for (c = 0; c < channels; c++)
+        data[j * channels + c] = c < loud ?
+            amplitude * sin (2 * G_PI * 1000 * n / RATE) : 0.0;
+    }
+    gst_buffer_unmap (buf, &map);
+
+    fail_unless_equals_int (gst_harness_push (h, buf), GST_FLOW_OK);
+    gst_buffer_unref (gst_harness_pull (h));
+  }
+}
+
+GST_START_TEST (test_sine)
+{
+  GstHarness *h;
+  GstBus *bus;
+  GstMessage *message;
+  const GstStructure *s;
+  gdouble momentary, short_term, integrated;
+  gchar *caps;
+  gint n = 0;
+
+  h = gst_harness_new ("loudness");
+  bus = gst_bus_new ();
+  gst_element_set_bus (h->element, bus);
+
+  caps = g_strdup_printf (LOUDNESS_CAPS_STRING, 2, "0x3");
+  gst_harness_set_src_caps_str (h, caps);
+  g_free (caps);
+
+  /* -23dBFS on both channels is -23 LUFS, see EBU Tech 3341 */
+  push_sine (h, 2, 2, pow (10, -23 / 20.), 5);
+
+  while ((message = gst_bus_pop (bus))) {
+    s = gst_message_get_structure (message);
+    if (s && gst_structure_has_name (s, "loudness")) {
+      fail_unless (gst_structure_get_double (s, "momentary", &momentary));
+      fail_unless (gst_structure_get_double (s, "short-term", &short_term));
+      fail_unless (gst_structure_get_double (s, "integrated", &integrated));
+      fail_unless (fabs (momentary + 23.0) < 0.1, "momentary %f", momentary);
+      fail_unless (fabs (integrated + 23.0) < 0.1, "integrated %f",
+          integrated);
+      /* the short-term window is only filled after 3s */
+      if (n >= 2)
+        fail_unless (fabs (short_term + 23.0) < 0.1, "short-term %f",
+            short_term);
+      n++;
+    }
+    gst_message_unref (message);
+  }
+  fail_unless_equals_int (n, 5);
+
+  g_object_get (h->element, "integrated", &integrated, NULL);
+  fail_unless (fabs (integrated + 23.0) < 0.1, "integrated %f", integrated);
+
+  gst_element_set_bus (h->element, NULL);
+  gst_object_unref (bus);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_lfe_ignored)
+{
+  GstHarness *h;
+  gdouble integrated;
+  gchar *caps;
+
+  h = gst_harness_new ("loudness");
+  g_object_set (h->element, "post-messages", FALSE, NULL);
+
+  /* a single LFE channel does not contribute to the loudness */
+  caps = g_strdup_printf (LOUDNESS_CAPS_STRING, 1, "0x8");
+  gst_harness_set_src_caps_str (h, caps);
+  g_free (caps);
+
+  push_sine (h, 1, 1, 0.5, 1);
+
+  g_object_get (h->element, "integrated", &integrated, NULL);
+  fail_unless (isinf (integrated) && integrated < 0, "integrated %f",
+      integrated);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+static Suite *
+loudness_suite (void)
+{
+  Suite *s = suite_create ("loudness");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_sine);
+  tcase_add_test (tc_chain, test_lfe_ignored);
+
+  return s;
+}
+
+GST_CHECK_MAIN (loudness);
@@ -1148,6 +1148,109 @@ GST_START_TEST (test_average_bitrate)
 
 GST_END_TEST;
 
+GST_START_TEST (test_faststart_reserved)
+{
+  gchar *location;
+  GstElement *qtmux;
+  GstElement *filesink;
+  GstBuffer *inbuffer;
+  GstCaps *caps;
+  GstSegment segment;
+  GstBus *bus;
+  gchar *data;
+  gsize size, pos;
+  GString *atoms;
+  int i;
+
+  location = g_strdup_printf ("%s/%s-%d", g_get_tmp_dir (), "qtmuxtest",
+      g_random_int ());
+  qtmux = gst_check_setup_element ("qtmux");
+  /* with a seekable downstream, the moov is written into space reserved
+   * before the mdat instead of going through a temporary file */
+  g_object_set (qtmux, "faststart", TRUE, "reserved-max-duration",
+      60 * GST_SECOND, NULL);
+  filesink = gst_element_factory_make ("filesink", NULL);
+  g_object_set (filesink, "location", location, NULL);
+  gst_element_link (qtmux, filesink);
+  mysrcpad = setup_src_pad (qtmux, &srcvideoh264template, "video_%u");
+  fail_unless (mysrcpad != NULL);
+  gst_pad_set_active (mysrcpad, TRUE);
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (filesink, bus);
+  gst_object_unref (bus);
+
+  fail_unless (gst_element_set_state (filesink,
+          GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE,
+      "could not set filesink to playing");
+  fail_unless (gst_element_set_state (qtmux,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+
+  caps = gst_caps_from_string (VIDEO_CAPS_H264_STRING);
+  gst_pad_set_caps (mysrcpad, caps);
+  gst_caps_unref (caps);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  for (i = 0; i < 10; i++) {
+    inbuffer = gst_buffer_new_and_alloc (100);
+    gst_buffer_memset (inbuffer, 0, 0, 100);
+    GST_BUFFER_PTS (inbuffer) = GST_BUFFER_DTS (inbuffer) = i * GST_SECOND;
+    GST_BUFFER_DURATION (inbuffer) = GST_SECOND;
+    fail_unless (gst_pad_push (mysrcpad, inbuffer) == GST_FLOW_OK);
+  }
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()) == TRUE);
+
+  gst_message_unref (gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+          GST_MESSAGE_EOS));
+
+  gst_element_set_state (qtmux, GST_STATE_NULL);
+  gst_element_set_state (filesink, GST_STATE_NULL);
+
+  gst_element_set_bus (filesink, NULL);
+
+  gst_check_drop_buffers ();
+  gst_pad_set_active (mysrcpad, FALSE);
+  teardown_src_pad (mysrcpad);
+  gst_object_unref (filesink);
+  gst_check_teardown_element (qtmux);
+
+  /* walk the top-level atoms */
+  fail_unless (g_file_get_contents (location, &data, &size, NULL));
+  atoms = g_string_new (NULL);
+  pos = 0;
+  while (pos + 8 <= size) {
+    guint64 atom_size = GST_READ_UINT32_BE (data + pos);
+
+    if (atom_size == 1) {
+      fail_unless (pos + 16 <= size);
+      atom_size = GST_READ_UINT64_BE (data + pos + 8);
+    }
+    fail_unless (atom_size >= 8);
+
+    g_string_append_len (atoms, data + pos + 4, 4);
+    g_string_append_c (atoms, ' ');
+    pos += atom_size;
+  }
+  fail_unless_equals_int (pos, size);
+  /* the rest of the reserved space and the placeholder for a 64 bit mdat
+   * header are free atoms */
+  fail_unless (g_str_has_prefix (atoms->str, "ftyp moov "), "%s", atoms->str);
+  fail_unless (g_str_has_suffix (atoms->str, " mdat "), "%s", atoms->str);
+
+  g_string_free (atoms, TRUE);
+  g_free (data);
+  g_unlink (location);
+  g_free (location);
+}
+
+GST_END_TEST;
+
 struct TestInputData
 {
   GstPad *srcpad;
@@ -1888,6 +1991,7 @@ qtmux_suite (void)
   tcase_add_test (tc_chain, test_video_pad_frag_asc_finalise);
 
   tcase_add_test (tc_chain, test_average_bitrate);
+  tcase_add_test (tc_chain, test_faststart_reserved);
 
   tcase_add_test (tc_chain, test_reuse);
   tcase_add_test (tc_chain, test_encodebin_qtmux);
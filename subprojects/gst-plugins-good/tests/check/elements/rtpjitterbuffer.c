@@ -757,6 +757,38 @@ GST_START_TEST (test_lost_event)
 
 GST_END_TEST;
 
+GST_START_TEST (test_lost_event_shared_timers)
+{
+  GstHarness *h = gst_harness_new ("rtpjitterbuffer");
+  GstBuffer *buf;
+  gint latency_ms = 100;
+  guint next_seqnum;
+  guint missing_seqnum;
+
+  /* same as test_lost_event, with the timers run from the shared pool */
+  g_object_set (h->element, "do-lost", TRUE, "shared-timers", TRUE, NULL);
+  next_seqnum = construct_deterministic_initial_state (h, latency_ms);
+
+  missing_seqnum = next_seqnum;
+  next_seqnum += 1;
+  push_test_buffer (h, next_seqnum);
+
+  fail_unless_equals_int (0, gst_harness_buffers_in_queue (h));
+  fail_unless_equals_int (0, gst_harness_events_in_queue (h));
+
+  gst_harness_crank_single_clock_wait (h);
+  verify_lost_event (h, missing_seqnum,
+      missing_seqnum * TEST_BUF_DURATION, TEST_BUF_DURATION);
+
+  buf = gst_harness_pull (h);
+  fail_unless_equals_int (next_seqnum, get_rtp_seq_num (buf));
+  gst_buffer_unref (buf);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_only_one_lost_event_on_large_gaps)
 {
   GstHarness *h = gst_harness_new ("rtpjitterbuffer");
@@ -2969,6 +3001,51 @@ GST_START_TEST (test_fill_queue)
 
 GST_END_TEST;
 
+GST_START_TEST (test_reorder_queue)
+{
+  GstHarness *h = gst_harness_new ("rtpjitterbuffer");
+  GstStructure *stats;
+  guint64 duplicates;
+  GstBuffer *buf;
+  gint i;
+
+  /* the queue spans 6s of packets, don't drop them as misordered */
+  g_object_set (h->element, "max-misorder-time", 10000, NULL);
+  gst_harness_use_testclock (h);
+
+  gst_harness_set_src_caps (h, generate_caps ());
+
+  gst_harness_play (h);
+
+  gst_harness_push (h, generate_test_buffer (0));
+  buf = gst_harness_pull (h);
+  fail_unless_equals_int (0, get_rtp_seq_num (buf));
+  gst_buffer_unref (buf);
+
+  /* fill the queue back to front, with a duplicate in the middle */
+  for (i = 300; i > 150; i--)
+    gst_harness_push (h, generate_test_buffer (i));
+  gst_harness_push (h, generate_test_buffer (200));
+  for (i = 150; i > 0; i--)
+    gst_harness_push (h, generate_test_buffer (i));
+
+  for (i = 1; i <= 300; i++) {
+    buf = gst_harness_pull (h);
+    fail_unless_equals_int (i, get_rtp_seq_num (buf));
+    gst_buffer_unref (buf);
+  }
+
+  g_object_get (h->element, "stats", &stats, NULL);
+  gst_structure_get (stats, "num-duplicates", G_TYPE_UINT64, &duplicates,
+      NULL);
+  fail_unless_equals_int (duplicates, 1);
+  gst_structure_free (stats);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 typedef struct
 {
   gint64 dts_skew;
@@ -3514,6 +3591,7 @@ rtpjitterbuffer_suite (void)
   tcase_add_test (tc_chain, test_clear_pt_map);
 
   tcase_add_test (tc_chain, test_lost_event);
+  tcase_add_test (tc_chain, test_lost_event_shared_timers);
   tcase_add_test (tc_chain, test_only_one_lost_event_on_large_gaps);
   tcase_add_test (tc_chain, test_two_lost_one_arrives_in_time);
   tcase_add_test (tc_chain, test_out_of_order_loss_not_reported);
@@ -3561,6 +3639,7 @@ rtpjitterbuffer_suite (void)
   tcase_add_test (tc_chain, test_big_gap_seqnum);
   tcase_add_test (tc_chain, test_big_gap_arrival_time);
   tcase_add_test (tc_chain, test_fill_queue);
+  tcase_add_test (tc_chain, test_reorder_queue);
 
   tcase_add_loop_test (tc_chain,
       test_considered_lost_packet_in_large_gap_arrives, 0,
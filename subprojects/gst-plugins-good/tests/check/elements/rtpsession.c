@@ -507,6 +507,63 @@ GST_START_TEST (test_multiple_senders_roundrobin_rbs)
 
 GST_END_TEST;
 
+GST_START_TEST (test_many_senders_roundrobin_rbs)
+{
+  SessionHarness *h = session_harness_new ();
+  GstBuffer *buf;
+  GstRTCPBuffer rtcp = GST_RTCP_BUFFER_INIT;
+  GstRTCPPacket rtcp_packet;
+  GHashTable *reported;
+  const gint num_ssrcs = 100;
+  gint i, j;
+  guint32 ssrc;
+
+  g_object_set (h->internal_session, "internal-ssrc", 0xDEADBEEF, NULL);
+  g_object_set (h->session, "rtcp-min-interval", 20 * GST_SECOND, NULL);
+
+  /* more sources than cleaned up at once, and than fit in 3 RRs */
+  for (i = 0; i < 5; i++) {
+    for (j = 0; j < num_ssrcs; j++) {
+      buf = generate_test_buffer (i, 10000 + j);
+      fail_unless_equals_int (GST_FLOW_OK, session_harness_recv_rtp (h, buf));
+    }
+  }
+
+  reported = g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  for (i = 0; i < 4; i++) {
+    guint expected_rb_count = (i < 3) ? GST_RTCP_MAX_RB_COUNT :
+        (num_ssrcs - 3 * GST_RTCP_MAX_RB_COUNT);
+
+    session_harness_produce_rtcp (h, 1);
+    buf = session_harness_pull_rtcp (h);
+    fail_unless (gst_rtcp_buffer_validate (buf));
+
+    gst_rtcp_buffer_map (buf, GST_MAP_READ, &rtcp);
+    fail_unless (gst_rtcp_buffer_get_first_packet (&rtcp, &rtcp_packet));
+    fail_unless_equals_int (GST_RTCP_TYPE_RR,
+        gst_rtcp_packet_get_type (&rtcp_packet));
+    fail_unless_equals_int (expected_rb_count,
+        gst_rtcp_packet_get_rb_count (&rtcp_packet));
+
+    for (j = 0; j < expected_rb_count; j++) {
+      gst_rtcp_packet_get_rb (&rtcp_packet, j, &ssrc, NULL, NULL,
+          NULL, NULL, NULL, NULL);
+      fail_unless (g_hash_table_add (reported, GUINT_TO_POINTER (ssrc)));
+    }
+
+    gst_rtcp_buffer_unmap (&rtcp);
+    gst_buffer_unref (buf);
+  }
+
+  fail_unless_equals_int (num_ssrcs, g_hash_table_size (reported));
+
+  g_hash_table_unref (reported);
+  session_harness_free (h);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_no_rbs_for_internal_senders)
 {
   SessionHarness *h = session_harness_new ();
@@ -4041,6 +4098,67 @@ GST_START_TEST (test_twcc_send_and_recv)
 
 GST_END_TEST;
 
+GST_START_TEST (test_twcc_bandwidth_estimate)
+{
+  SessionHarness *h_send = session_harness_new ();
+  SessionHarness *h_recv = session_harness_new ();
+  GstStructure *twcc_stats;
+  guint estimated_bitrate, bitrate = 0;
+  GstEvent *event;
+  guint frame;
+  const guint num_frames = 3;
+  const guint num_slices = 15;
+
+  /* enable twcc */
+  session_harness_set_twcc_recv_ext_id (h_recv, TEST_TWCC_EXT_ID);
+  session_harness_set_twcc_send_ext_id (h_send, TEST_TWCC_EXT_ID);
+
+  for (frame = 0; frame < num_frames; frame++) {
+    GstBuffer *buf;
+    guint slice;
+
+    for (slice = 0; slice < num_slices; slice++) {
+      guint seq = frame * num_slices + slice;
+
+      buf = generate_twcc_send_buffer (seq, slice == num_slices - 1);
+      fail_unless_equals_int (GST_FLOW_OK,
+          session_harness_send_rtp (h_send, buf));
+      session_harness_advance_and_crank (h_send, TEST_BUF_DURATION);
+
+      buf = session_harness_pull_send_rtp (h_send);
+      fail_unless_equals_int (GST_FLOW_OK,
+          session_harness_recv_rtp (h_recv, buf));
+    }
+
+    session_harness_recv_rtcp (h_send, session_harness_produce_twcc (h_recv));
+  }
+
+  /* the last estimate is sent upstream */
+  while ((event = gst_harness_try_pull_upstream_event (h_send->send_rtp_h))) {
+    if (GST_EVENT_TYPE (event) == GST_EVENT_CUSTOM_UPSTREAM &&
+        gst_event_has_name (event, "GstRTPBandwidthEstimate"))
+      fail_unless (gst_structure_get_uint (gst_event_get_structure (event),
+              "bitrate", &bitrate));
+    gst_event_unref (event);
+  }
+
+  twcc_stats = session_harness_get_last_twcc_stats (h_send);
+  fail_unless (gst_structure_get_uint (twcc_stats, "estimated-bitrate",
+          &estimated_bitrate));
+  gst_structure_free (twcc_stats);
+
+  /* no loss and no queuing delay, the estimate probes above the current
+   * bitrate but stays close to what the receiver gets */
+  fail_unless_equals_int (bitrate, estimated_bitrate);
+  fail_unless (bitrate > TEST_BUF_BPS);
+  fail_unless (bitrate <= TEST_BUF_BPS * 3 / 2);
+
+  session_harness_free (h_send);
+  session_harness_free (h_recv);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_twcc_multiple_payloads_below_window)
 {
   SessionHarness *h_send = session_harness_new ();
@@ -4313,6 +4431,7 @@ rtpsession_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, test_multiple_ssrc_rr);
   tcase_add_test (tc_chain, test_multiple_senders_roundrobin_rbs);
+  tcase_add_test (tc_chain, test_many_senders_roundrobin_rbs);
   tcase_add_test (tc_chain, test_no_rbs_for_internal_senders);
   tcase_add_test (tc_chain, test_internal_sources_timeout);
   tcase_add_test (tc_chain, test_receive_rtcp_app_packet);
@@ -4377,6 +4496,7 @@ rtpsession_suite (void)
   tcase_add_test (tc_chain, test_twcc_recv_rtcp_reordered);
   tcase_add_test (tc_chain, test_twcc_no_exthdr_in_buffer);
   tcase_add_test (tc_chain, test_twcc_send_and_recv);
+  tcase_add_test (tc_chain, test_twcc_bandwidth_estimate);
   tcase_add_test (tc_chain, test_twcc_multiple_payloads_below_window);
   tcase_add_loop_test (tc_chain, test_twcc_feedback_interval, 0,
       G_N_ELEMENTS (test_twcc_feedback_interval_ctx));
@@ -305,6 +305,41 @@ GST_START_TEST (test_timer_queue_timer_offset)
 
 GST_END_TEST;
 
+GST_START_TEST (test_timer_queue_many_timers)
+{
+  RtpTimerQueue *queue = rtp_timer_queue_new ();
+  GstClockTime last = 0;
+  RtpTimer *timer;
+  guint i, n = 0;
+
+  /* spread over many ticks of the timer wheel and in random order */
+  for (i = 0; i < 1000; i++)
+    rtp_timer_queue_set_deadline (queue, i, (i * 7919) % 1000 * GST_MSECOND,
+        0);
+
+  /* move some timers around and remove others */
+  for (i = 0; i < 1000; i += 3)
+    rtp_timer_queue_set_deadline (queue, i, (i * 13) % 1000 * GST_MSECOND, 0);
+  for (i = 1; i < 1000; i += 7) {
+    timer = rtp_timer_queue_find (queue, i);
+    rtp_timer_queue_unschedule (queue, timer);
+    rtp_timer_free (timer);
+  }
+
+  while ((timer = rtp_timer_queue_pop_until (queue, GST_CLOCK_TIME_NONE))) {
+    fail_unless (timer->timeout >= last);
+    last = timer->timeout;
+    rtp_timer_free (timer);
+    n++;
+  }
+  fail_unless_equals_int (n, 1000 - 143);
+  fail_unless_equals_int (rtp_timer_queue_length (queue), 0);
+
+  g_object_unref (queue);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtptimerqueue_suite (void)
 {
@@ -319,6 +354,7 @@ rtptimerqueue_suite (void)
   tcase_add_test (tc_chain, test_timer_queue_update_timer_seqnum);
   tcase_add_test (tc_chain, test_timer_queue_dup_timer);
   tcase_add_test (tc_chain, test_timer_queue_timer_offset);
+  tcase_add_test (tc_chain, test_timer_queue_many_timers);
 
   return s;
 }
@@ -644,6 +644,89 @@ GST_START_TEST (rtpulpfecdec_fecstorage_gives_no_buffers)
 
 GST_END_TEST;
 
+static GstBuffer *
+create_media_packet (guint16 seq, gboolean marker)
+{
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  GstBuffer *buf = gst_rtp_buffer_new_allocate (100, 0, 0);
+
+  gst_buffer_memset (buf, 0, seq & 0xff, gst_buffer_get_size (buf));
+  gst_rtp_buffer_map (buf, GST_MAP_WRITE, &rtp);
+  gst_rtp_buffer_set_version (&rtp, 2);
+  gst_rtp_buffer_set_padding (&rtp, FALSE);
+  gst_rtp_buffer_set_extension (&rtp, FALSE);
+  gst_rtp_buffer_set_payload_type (&rtp, 96);
+  gst_rtp_buffer_set_ssrc (&rtp, 0x12345678);
+  gst_rtp_buffer_set_timestamp (&rtp, 1000);
+  gst_rtp_buffer_set_seq (&rtp, seq);
+  gst_rtp_buffer_set_marker (&rtp, marker);
+  gst_rtp_buffer_unmap (&rtp);
+
+  GST_BUFFER_PTS (buf) = seq * RTP_PACKET_DUR;
+
+  return buf;
+}
+
+static GstHarness *
+create_fecenc_harness (void)
+{
+  GstHarness *h = gst_harness_new ("rtpulpfecenc");
+
+  g_object_set (h->element, "pt", 100, "percentage", 50, NULL);
+  gst_harness_set_src_caps_str (h, "application/x-rtp");
+
+  return h;
+}
+
+GST_START_TEST (rtpulpfecenc_buffer_list)
+{
+  GstHarness *h_list = create_fecenc_harness ();
+  GstHarness *h_single = create_fecenc_harness ();
+  GstBufferList *list = gst_buffer_list_new ();
+  guint i, n_single, n_list;
+  guint n_fec = 0;
+
+  for (i = 0; i < 6; i++) {
+    gst_buffer_list_add (list, create_media_packet (i, i == 5));
+    fail_unless_equals_int (gst_harness_push (h_single,
+            create_media_packet (i, i == 5)), GST_FLOW_OK);
+  }
+  fail_unless_equals_int (gst_pad_push_list (h_list->srcpad, list),
+      GST_FLOW_OK);
+
+  /* a buffer list generates the same packets as single buffers */
+  n_single = gst_harness_buffers_received (h_single);
+  n_list = gst_harness_buffers_received (h_list);
+  fail_unless_equals_int (n_list, n_single);
+  fail_unless (n_list > 6);
+
+  for (i = 0; i < n_list; i++) {
+    GstBuffer *a = gst_harness_pull (h_list);
+    GstBuffer *b = gst_harness_pull (h_single);
+    GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+    GstMapInfo map;
+
+    fail_unless_equals_int (gst_buffer_get_size (a), gst_buffer_get_size (b));
+    gst_buffer_map (b, GST_MAP_READ, &map);
+    fail_unless (gst_buffer_memcmp (a, 0, map.data, map.size) == 0);
+    gst_buffer_unmap (b, &map);
+
+    gst_rtp_buffer_map (a, GST_MAP_READ, &rtp);
+    if (gst_rtp_buffer_get_payload_type (&rtp) == 100)
+      n_fec++;
+    gst_rtp_buffer_unmap (&rtp);
+
+    gst_buffer_unref (a);
+    gst_buffer_unref (b);
+  }
+  fail_unless_equals_int (n_fec, n_list - 6);
+
+  gst_harness_teardown (h_list);
+  gst_harness_teardown (h_single);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtpfec_suite (void)
 {
@@ -665,6 +748,8 @@ rtpfec_suite (void)
   tcase_add_test (tc_chain, rtpulpfecdec_invalid_recovered);
   tcase_add_test (tc_chain, rtpulpfecdec_invalid_recovered_pt_mismatch);
   tcase_add_test (tc_chain, rtpulpfecdec_fecstorage_gives_no_buffers);
+
+  tcase_add_test (tc_chain, rtpulpfecenc_buffer_list);
   return s;
 }
 
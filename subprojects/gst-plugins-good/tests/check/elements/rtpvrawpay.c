@@ -0,0 +1,161 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/check.h>
+#include <gst/check/gstharness.h>
+#include <gst/video/video.h>
+
+#define WIDTH 320
+#define HEIGHT 16
+
+static const gchar *formats[] = { "UYVY", "RGB", "BGRA" };
+
+static GstBuffer *
+create_frame (const gchar * format)
+{
+  GstVideoInfo info;
+  GstBuffer *buf;
+  GstMapInfo map;
+  gsize i;
+
+  gst_video_info_set_format (&info, gst_video_format_from_string (format),
+      WIDTH, HEIGHT);
+  buf = gst_buffer_new_allocate (NULL, GST_VIDEO_INFO_SIZE (&info), NULL);
+  gst_buffer_map (buf, &map, GST_MAP_WRITE);
+  for (i = 0; i < map.size; i++)
+    map.data[i] = i % 251;
+  gst_buffer_unmap (buf, &map);
+
+  GST_BUFFER_PTS (buf) = 0;
+  GST_BUFFER_DURATION (buf) = GST_SECOND / 30;
+
+  return buf;
+}
+
+static GstHarness *
+create_payloader (const gchar * format, gboolean zero_copy)
+{
+  GstHarness *h;
+  gchar *caps;
+
+  h = gst_harness_new_parse ("rtpvrawpay mtu=1400 seqnum-offset=0 ssrc=1 "
+      "timestamp-offset=0");
+  gst_harness_set (h, "rtpvrawpay", "zero-copy", zero_copy, NULL);
+
+  caps = g_strdup_printf ("video/x-raw,format=%s,width=%d,height=%d,"
+      "framerate=30/1", format, WIDTH, HEIGHT);
+  gst_harness_set_src_caps_str (h, caps);
+  g_free (caps);
+
+  return h;
+}
+
+/* referencing the input data produces the same packets as copying it */
+GST_START_TEST (test_pay_zero_copy)
+{
+  const gchar *format = formats[__i__];
+  GstHarness *h_copy, *h_zero;
+  GstBuffer *in;
+  guint i, n;
+
+  h_copy = create_payloader (format, FALSE);
+  h_zero = create_payloader (format, TRUE);
+
+  in = create_frame (format);
+  fail_unless_equals_int (gst_harness_push (h_copy, gst_buffer_ref (in)),
+      GST_FLOW_OK);
+  fail_unless_equals_int (gst_harness_push (h_zero, gst_buffer_ref (in)),
+      GST_FLOW_OK);
+
+  n = gst_harness_buffers_in_queue (h_copy);
+  fail_unless (n > 1);
+  fail_unless_equals_int (gst_harness_buffers_in_queue (h_zero), n);
+
+  for (i = 0; i < n; i++) {
+    GstBuffer *copy = gst_harness_pull (h_copy);
+    GstBuffer *zero = gst_harness_pull (h_zero);
+    GstMapInfo map;
+
+    /* the copied packets have everything in one memory, the others have the
+     * headers followed by memories of the input frame */
+    fail_unless_equals_int (gst_buffer_n_memory (copy), 1);
+    fail_unless (gst_buffer_n_memory (zero) > 1);
+
+    fail_unless_equals_int (gst_buffer_get_size (zero),
+        gst_buffer_get_size (copy));
+    gst_buffer_map (copy, &map, GST_MAP_READ);
+    fail_unless (gst_buffer_memcmp (zero, 0, map.data, map.size) == 0);
+    gst_buffer_unmap (copy, &map);
+
+    gst_buffer_unref (copy);
+    gst_buffer_unref (zero);
+  }
+
+  gst_buffer_unref (in);
+  gst_harness_teardown (h_copy);
+  gst_harness_teardown (h_zero);
+}
+
+GST_END_TEST;
+
+/* by default the input buffer is not referenced by the packets */
+GST_START_TEST (test_pay_copy_default)
+{
+  GstHarness *h;
+  GstBuffer *in, *out;
+  gboolean zero_copy;
+
+  h = gst_harness_new_parse ("rtpvrawpay");
+  gst_harness_get (h, "rtpvrawpay", "zero-copy", &zero_copy, NULL);
+  fail_if (zero_copy);
+  gst_harness_teardown (h);
+
+  h = create_payloader ("UYVY", FALSE);
+  in = create_frame ("UYVY");
+  fail_unless_equals_int (gst_harness_push (h, gst_buffer_ref (in)),
+      GST_FLOW_OK);
+
+  /* the memory of the input is only used by the input buffer */
+  ASSERT_MINI_OBJECT_REFCOUNT (gst_buffer_peek_memory (in, 0), "memory", 1);
+
+  while ((out = gst_harness_try_pull (h)))
+    gst_buffer_unref (out);
+
+  gst_buffer_unref (in);
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
+static Suite *
+rtpvrawpay_suite (void)
+{
+  Suite *s = suite_create ("rtpvrawpay");
+  TCase *tc_chain;
+
+  suite_add_tcase (s, (tc_chain = tcase_create ("general")));
+  tcase_add_loop_test (tc_chain, test_pay_zero_copy, 0, G_N_ELEMENTS (formats));
+  tcase_add_test (tc_chain, test_pay_copy_default);
+
+  return s;
+}
+
+GST_CHECK_MAIN (rtpvrawpay);
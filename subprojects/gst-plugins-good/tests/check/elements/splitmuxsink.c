@@ -589,6 +589,49 @@ GST_START_TEST (test_splitmuxsink_async)
 
 GST_END_TEST;
 
+GST_START_TEST (test_splitmuxsink_async_max_pending)
+{
+  GstMessage *msg;
+  GstElement *pipeline;
+  GstElement *sink;
+  gchar *dest_pattern;
+  guint count;
+  gchar *in_pattern;
+
+  pipeline =
+      gst_parse_launch
+      ("videotestsrc num-buffers=15 ! video/x-raw,width=80,height=64,framerate=5/1 ! videoconvert !"
+      " queue ! theoraenc keyframe-force=5 ! splitmuxsink name=splitsink "
+      " max-size-time=1000000000 async-finalize=true max-pending-finalizations=1"
+      " muxer-factory=matroskamux audiotestsrc num-buffers=15 samplesperbuffer=9600 ! "
+      " audio/x-raw,rate=48000 ! splitsink.audio_%u", NULL);
+  fail_if (pipeline == NULL);
+  sink = gst_bin_get_by_name (GST_BIN (pipeline), "splitsink");
+  fail_if (sink == NULL);
+  dest_pattern = g_build_filename (tmpdir, "matroska%05d.mkv", NULL);
+  g_object_set (G_OBJECT (sink), "location", dest_pattern, NULL);
+  g_free (dest_pattern);
+  g_object_unref (sink);
+
+  msg = run_pipeline (pipeline);
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+    dump_error (msg);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+
+  gst_object_unref (pipeline);
+
+  count = count_files (tmpdir);
+  fail_unless (count == 3, "Expected 3 output files, got %d", count);
+
+  in_pattern = g_build_filename (tmpdir, "matroska*.mkv", NULL);
+  test_playback (in_pattern, 0, 3 * GST_SECOND, TRUE);
+  g_free (in_pattern);
+}
+
+GST_END_TEST;
+
 /* For verifying bug https://bugzilla.gnome.org/show_bug.cgi?id=762893 */
 GST_START_TEST (test_splitmuxsink_reuse_simple)
 {
@@ -900,6 +943,7 @@ splitmuxsink_suite (void)
           tempdir_cleanup);
 
       tcase_add_test (tc_chain, test_splitmuxsink_async);
+      tcase_add_test (tc_chain, test_splitmuxsink_async_max_pending);
     } else {
       GST_INFO ("Skipping tests, missing plugins: matroska and/or vorbis");
     }
@@ -674,6 +674,100 @@ GST_START_TEST (test_splitmuxsrc_robust_mux)
 
 GST_END_TEST;
 
+GST_START_TEST (test_splitmuxsrc_index)
+{
+  GstMessage *msg;
+  GstElement *pipeline;
+  GstElement *element;
+  GstAppSinkCallbacks callbacks = { NULL };
+  gchar *dest_pattern, *index_location, *contents;
+  gchar **lines;
+  guint i, n_entries = 0;
+  gint64 duration;
+
+  pipeline =
+      gst_parse_launch
+      ("videotestsrc num-buffers=10 !"
+      "  video/x-raw,width=80,height=64,framerate=10/1 !"
+      "  jpegenc ! splitmuxsink name=splitsink muxer=qtmux"
+      "  max-size-time=300000000", NULL);
+  fail_if (pipeline == NULL);
+  element = gst_bin_get_by_name (GST_BIN (pipeline), "splitsink");
+  fail_if (element == NULL);
+  dest_pattern = g_build_filename (tmpdir, "out%05d.mp4", NULL);
+  index_location = g_build_filename (tmpdir, "index.txt", NULL);
+  g_object_set (G_OBJECT (element), "location", dest_pattern,
+      "index-location", index_location, NULL);
+  g_free (dest_pattern);
+  g_object_unref (element);
+
+  msg = run_pipeline (pipeline);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (pipeline);
+
+  /* One index entry for each fragment */
+  fail_unless (g_file_get_contents (index_location, &contents, NULL, NULL));
+  lines = g_strsplit (contents, "\n", -1);
+  for (i = 0; lines[i] != NULL; i++) {
+    GstStructure *s;
+
+    if (lines[i][0] == '\0')
+      continue;
+    s = gst_structure_from_string (lines[i], NULL);
+    fail_unless (s != NULL);
+    fail_unless (gst_structure_has_field (s, "location"));
+    fail_unless (gst_structure_has_field (s, "running-time"));
+    gst_structure_free (s);
+    n_entries++;
+  }
+  g_strfreev (lines);
+  g_free (contents);
+  fail_unless (n_entries > 1);
+  fail_unless_equals_int (n_entries, count_files (tmpdir) - 1);
+
+  /* Play back from the index, keeping only one fragment open */
+  pipeline = gst_parse_launch ("splitmuxsrc name=splitsrc num-open-fragments=1"
+      " ! appsink name=sink sync=false", NULL);
+  fail_if (pipeline == NULL);
+  element = gst_bin_get_by_name (GST_BIN (pipeline), "splitsrc");
+  g_object_set (G_OBJECT (element), "index-location", index_location, NULL);
+  g_object_unref (element);
+  g_free (index_location);
+
+  element = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+  callbacks.new_sample = receive_sample;
+  gst_app_sink_set_callbacks (GST_APP_SINK (element), &callbacks, NULL, NULL);
+  g_object_unref (element);
+
+  seek_pipeline (pipeline, 1.0, 0, -1);
+  fail_unless (gst_element_query_duration (pipeline, GST_FORMAT_TIME,
+          &duration));
+  fail_unless (duration > 800 * GST_MSECOND,
+      "Unexpected duration %" GST_TIME_FORMAT, GST_TIME_ARGS (duration));
+
+  msg = run_pipeline (pipeline);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  fail_unless (first_ts == 0);
+  fail_unless (last_ts == GST_SECOND,
+      "Expected end of playback range 0:00:01, got %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (last_ts));
+
+  /* Seek back into a fragment that was closed again */
+  seek_pipeline (pipeline, 1.0, 400 * GST_MSECOND, -1);
+  msg = run_pipeline (pipeline);
+  fail_unless (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  fail_unless (last_ts == GST_SECOND,
+      "Expected end of playback range 0:00:01, got %" GST_TIME_FORMAT,
+      GST_TIME_ARGS (last_ts));
+
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 static Suite *
 splitmuxsrc_suite (void)
 {
@@ -726,6 +820,7 @@ splitmuxsrc_suite (void)
         tempdir_cleanup);
     tcase_add_test (tc_chain_mp4_jpeg, test_splitmuxsrc_caps_change);
     tcase_add_test (tc_chain_mp4_jpeg, test_splitmuxsrc_robust_mux);
+    tcase_add_test (tc_chain_mp4_jpeg, test_splitmuxsrc_index);
   } else {
     GST_INFO ("Skipping tests, missing plugins: jpegenc or mp4mux");
   }
@@ -244,6 +244,52 @@ GST_START_TEST (test_udpsink_dscp)
 
 GST_END_TEST;
 
+GST_START_TEST (test_udpsink_max_bitrate)
+{
+  GstSegment segment;
+  GstElement *udpsink;
+  GstBufferList *list;
+  GstPad *srcpad;
+  gint64 start, elapsed;
+  gint i;
+
+  udpsink = gst_check_setup_element ("udpsink");
+  g_object_set (udpsink, "host", "127.0.0.1", "port", 5554,
+      "max-bitrate", G_GUINT64_CONSTANT (800000), NULL);
+
+  srcpad = gst_check_setup_src_pad_by_name (udpsink, &srctemplate, "sink");
+
+  gst_element_set_state (udpsink, GST_STATE_PLAYING);
+  gst_pad_set_active (srcpad, TRUE);
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("hey there!"));
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  /* 20 packets of 1000 bytes at 100000 bytes per second take 200ms, minus
+   * the 10ms burst allowance */
+  list = gst_buffer_list_new ();
+  for (i = 0; i < 20; i++) {
+    GstBuffer *buf = gst_buffer_new_allocate (NULL, 1000, NULL);
+
+    gst_buffer_memset (buf, 0, 0, 1000);
+    gst_buffer_list_add (list, buf);
+  }
+
+  start = g_get_monotonic_time ();
+  fail_unless_equals_int (gst_pad_push_list (srcpad, list), GST_FLOW_OK);
+  elapsed = g_get_monotonic_time () - start;
+
+  fail_unless (elapsed >= 150 * G_TIME_SPAN_MILLISECOND,
+      "sending took only %" G_GINT64_FORMAT "us", elapsed);
+
+  gst_check_teardown_pad_by_name (udpsink, "sink");
+  gst_check_teardown_element (udpsink);
+}
+
+GST_END_TEST;
+
 static Suite *
 udpsink_suite (void)
 {
@@ -256,6 +302,7 @@ udpsink_suite (void)
   tcase_add_test (tc_chain, test_udpsink_bufferlist);
   tcase_add_test (tc_chain, test_udpsink_client_add_remove);
   tcase_add_test (tc_chain, test_udpsink_dscp);
+  tcase_add_test (tc_chain, test_udpsink_max_bitrate);
 
   return s;
 }
@@ -91,6 +91,14 @@
  * specific settings are needed in this case to avoid pipeline stalling.
  * Depending on goals and context, other approaches are possible, e.g.
  * tune=zerolatency might be configured, or queue sizes increased.
+ * |[
+ * gst-launch-1.0 videotestsrc num-buffers=1000 ! tee name=t \
+ *   t. ! queue ! x264enc thread-budget=8 bitrate=4000 ! fakesink \
+ *   t. ! queue ! videoscale ! video/x-raw,width=640,height=360 ! \
+ *     x264enc thread-budget=8 bitrate=1000 ! fakesink
+ * ]| This example pipeline encodes two renditions of the same input. Both
+ * encoders share a budget of 8 threads instead of each creating threads for
+ * all the CPU cores.
  *
  */
 
@@ -401,6 +409,7 @@ enum
   ARG_TUNE,
   ARG_FRAME_PACKING,
   ARG_INSERT_VUI,
+  ARG_THREAD_BUDGET,
 };
 
 #define ARG_THREADS_DEFAULT            0        /* 0 means 'auto' which is 1.5x number of CPU cores */
@@ -438,11 +447,16 @@ enum
 #define ARG_INTRA_REFRESH_DEFAULT      FALSE
 #define ARG_OPTION_STRING_DEFAULT      ""
 static GString *x264enc_defaults;
+
+/* number of started encoders that share the thread-budget */
+static GMutex thread_budget_lock;
+static guint thread_budget_users;
 #define ARG_SPEED_PRESET_DEFAULT       6        /* 'medium' preset - matches x264 CLI default */
 #define ARG_PSY_TUNE_DEFAULT           0        /* no psy tuning */
 #define ARG_TUNE_DEFAULT               0        /* no tuning */
 #define ARG_FRAME_PACKING_DEFAULT      -1       /* automatic (none, or from input caps) */
 #define ARG_INSERT_VUI_DEFAULT         TRUE
+#define ARG_THREAD_BUDGET_DEFAULT      0
 
 enum
 {
@@ -929,6 +943,21 @@ gst_x264_enc_sink_query (GstVideoEncoder * enc, GstQuery * query)
   return ret;
 }
 
+static gboolean
+gst_x264_enc_src_event (GstVideoEncoder * enc, GstEvent * event)
+{
+  guint bitrate;
+
+  /* bandwidth estimate from rtpsession, follow it like a change of the
+   * bitrate property */
+  if (gst_video_event_parse_bandwidth_estimate (event, &bitrate)) {
+    GST_DEBUG_OBJECT (enc, "Following bandwidth estimate of %u bps", bitrate);
+    g_object_set (enc, "bitrate", MAX (bitrate / 1000, 1), NULL);
+  }
+
+  return GST_VIDEO_ENCODER_CLASS (parent_class)->src_event (enc, event);
+}
+
 static void
 gst_x264_enc_class_init (GstX264EncClass * klass)
 {
@@ -960,6 +989,7 @@ gst_x264_enc_class_init (GstX264EncClass * klass)
   gstencoder_class->propose_allocation =
       GST_DEBUG_FUNCPTR (gst_x264_enc_propose_allocation);
   gstencoder_class->sink_query = GST_DEBUG_FUNCPTR (gst_x264_enc_sink_query);
+  gstencoder_class->src_event = GST_DEBUG_FUNCPTR (gst_x264_enc_src_event);
 
   /* options for which we don't use string equivalents */
   g_object_class_install_property (gobject_class, ARG_PASS,
@@ -1016,6 +1046,25 @@ gst_x264_enc_class_init (GstX264EncClass * klass)
           "Insert VUI NAL in stream",
           ARG_INSERT_VUI_DEFAULT, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * x264enc:thread-budget:
+   *
+   * Total number of threads shared by all the x264enc instances that have
+   * this property set and #x264enc:threads set to 0 (automatic). Each such
+   * encoder gets an equal part of the budget, based on the number of
+   * encoders that are started when it opens its encoder. This avoids
+   * oversubscribing the CPU cores when encoding many renditions at once.
+   * Changes take effect the next time the element is started.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, ARG_THREAD_BUDGET,
+      g_param_spec_uint ("thread-budget", "Thread Budget",
+          "Number of threads shared with the other encoders that have a "
+          "thread budget, when threads is 0 (0 = no shared budget)",
+          0, G_MAXINT, ARG_THREAD_BUDGET_DEFAULT,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   /* options for which we _do_ use string equivalents */
   g_object_class_install_property (gobject_class, ARG_THREADS,
       g_param_spec_uint ("threads", "Threads",
@@ -1287,6 +1336,7 @@ gst_x264_enc_init (GstX264Enc * encoder)
 {
   /* properties */
   encoder->threads = ARG_THREADS_DEFAULT;
+  encoder->thread_budget = ARG_THREAD_BUDGET_DEFAULT;
   encoder->sliced_threads = ARG_SLICED_THREADS_DEFAULT;
   encoder->sync_lookahead = ARG_SYNC_LOOKAHEAD_DEFAULT;
   encoder->pass = ARG_PASS_DEFAULT;
@@ -1402,6 +1452,16 @@ gst_x264_enc_start (GstVideoEncoder * encoder)
      this is probably overkill for most streams */
   gst_video_encoder_set_min_pts (encoder, GST_SECOND * 60 * 60 * 1000);
 
+  GST_OBJECT_LOCK (x264enc);
+  x264enc->active_thread_budget = x264enc->thread_budget;
+  GST_OBJECT_UNLOCK (x264enc);
+
+  if (x264enc->active_thread_budget > 0) {
+    g_mutex_lock (&thread_budget_lock);
+    thread_budget_users++;
+    g_mutex_unlock (&thread_budget_lock);
+  }
+
   return TRUE;
 }
 
@@ -1418,6 +1478,13 @@ gst_x264_enc_stop (GstVideoEncoder * encoder)
     gst_video_codec_state_unref (x264enc->input_state);
   x264enc->input_state = NULL;
 
+  if (x264enc->active_thread_budget > 0) {
+    g_mutex_lock (&thread_budget_lock);
+    thread_budget_users--;
+    g_mutex_unlock (&thread_budget_lock);
+    x264enc->active_thread_budget = 0;
+  }
+
   return TRUE;
 }
 
@@ -1646,6 +1713,24 @@ gst_x264_enc_init_encoder (GstX264Enc * encoder)
     }
   }
 
+  /* x264 cannot change its thread count once opened, so the share is
+   * computed from the encoders started so far; in a ladder they are all
+   * started before the first caps arrive */
+  if (encoder->active_thread_budget > 0 &&
+      encoder->x264param.i_threads == X264_THREADS_AUTO) {
+    guint users;
+
+    g_mutex_lock (&thread_budget_lock);
+    users = MAX (thread_budget_users, 1);
+    g_mutex_unlock (&thread_budget_lock);
+
+    encoder->x264param.i_threads =
+        MAX (encoder->active_thread_budget / users, 1);
+    GST_DEBUG_OBJECT (encoder, "using %d threads out of a budget of %u "
+        "shared by %u encoders", encoder->x264param.i_threads,
+        encoder->active_thread_budget, users);
+  }
+
   /* set up encoder parameters */
 #if X264_BUILD >= 153
   encoder->x264param.i_bitdepth = GST_VIDEO_INFO_COMP_DEPTH (info, 0);
@@ -2963,6 +3048,9 @@ gst_x264_enc_set_property (GObject * object, guint prop_id,
     case ARG_INSERT_VUI:
       encoder->insert_vui = g_value_get_boolean (value);
       break;
+    case ARG_THREAD_BUDGET:
+      encoder->thread_budget = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -3107,6 +3195,9 @@ gst_x264_enc_get_property (GObject * object, guint prop_id,
     case ARG_INSERT_VUI:
       g_value_set_boolean (value, encoder->insert_vui);
       break;
+    case ARG_THREAD_BUDGET:
+      g_value_set_uint (value, encoder->thread_budget);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
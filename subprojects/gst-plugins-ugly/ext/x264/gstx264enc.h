@@ -73,6 +73,9 @@ struct _GstX264Enc
 
   /* properties */
   guint threads;
+  guint thread_budget;
+  /* budget this instance is accounted in, from start() to stop() */
+  guint active_thread_budget;
   gboolean sliced_threads;
   gint sync_lookahead;
   gint pass;
@@ -14,3 +14,71 @@ def __video_info_from_caps(*args):
 
 
 GstVideo.VideoInfo.from_caps = __video_info_from_caps
+
+
+class VideoFrameMap:
+    """Zero-copy access to the planes of a raw video buffer.
+
+    The buffer is mapped once and every plane is exposed as a memoryview
+    into the mapped memory, together with its stride, so that it can for
+    example be wrapped with `numpy.frombuffer()` without copying:
+
+        with GstVideo.VideoFrameMap(buf, info, Gst.MapFlags.READ) as frame:
+            y = numpy.frombuffer(frame.planes[0], numpy.uint8)
+            y = y.reshape(-1, frame.strides[0])
+
+    Plane offsets and strides are taken from the buffer's GstVideoMeta if it
+    has one, otherwise from @info. The plane views are released again when
+    the frame is unmapped, which fails if they are still exported.
+    """
+
+    def __init__(self, buffer, info, flags):
+        self.buffer = buffer
+        self.info = info
+        self.mapinfo = buffer.map(flags)
+        if not self.mapinfo.__parent__:
+            raise Gst.MapError('MappingError', 'Mapping was not successful')
+
+        meta = GstVideo.buffer_get_video_meta(buffer)
+        if meta:
+            n_planes = meta.n_planes
+            offsets = list(meta.offset[:n_planes])
+            self.strides = list(meta.stride[:n_planes])
+        else:
+            n_planes = info.finfo.n_planes
+            offsets = list(info.offset[:n_planes])
+            self.strides = list(info.stride[:n_planes])
+
+        data = self.mapinfo.data
+        self.planes = []
+        for plane in range(n_planes):
+            start = offsets[plane]
+            end = len(data)
+            height = self.__plane_height(plane)
+            if height is not None:
+                end = min(end, start + self.strides[plane] * height)
+            self.planes.append(data[start:end])
+
+    def __plane_height(self, plane):
+        finfo = self.info.finfo
+        for comp in range(finfo.n_components):
+            if finfo.plane[comp] == plane:
+                # same rounding as GST_VIDEO_SUB_SCALE()
+                return -((-self.info.height) >> finfo.h_sub[comp])
+        return None
+
+    def unmap(self):
+        for plane in self.planes:
+            plane.release()
+        self.planes = []
+        return self.buffer.unmap(self.mapinfo)
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, type, value, tb):
+        if not self.unmap():
+            raise Gst.MapError('MappingError', 'Unmapping was not successful')
+
+
+__all__.append('VideoFrameMap')
@@ -18,6 +18,7 @@
 # Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
 
 import sys
+import gi
 import overrides_hack
 overrides_hack
 from common import TestCase, unittest
@@ -112,5 +113,31 @@ class TestBufferMap(TestCase):
         with self.assertRaises(ValueError):
             info.data[0]
 
+
+class TestVideoFrameMap(TestCase):
+
+    def test_planes(self):
+        Gst.init(None)
+        try:
+            gi.require_version('GstVideo', '1.0')
+            from gi.repository import GstVideo
+        except (ImportError, ValueError):
+            self.skipTest('GstVideo not available')
+
+        info = GstVideo.VideoInfo.new()
+        info.set_format(GstVideo.VideoFormat.I420, 16, 8)
+        buf = Gst.Buffer.new_wrapped(bytes(range(info.size)))
+
+        with GstVideo.VideoFrameMap(buf, info, Gst.MapFlags.READ) as frame:
+            self.assertEqual(len(frame.planes), 3)
+            self.assertEqual(frame.strides, [16, 8, 8])
+            self.assertEqual(len(frame.planes[0]), 16 * 8)
+            self.assertEqual(len(frame.planes[1]), 8 * 4)
+            self.assertEqual(frame.planes[1][0], info.offset[1] % 256)
+            plane = frame.planes[2]
+
+        with self.assertRaises(ValueError):
+            plane[0]
+
 if __name__ == "__main__":
     unittest.main()
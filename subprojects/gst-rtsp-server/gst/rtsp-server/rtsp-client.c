@@ -2074,6 +2074,102 @@ seek_failed:
   }
 }
 
+static GstRTSPStatusCode
+check_limits (GstRTSPClient * client, const gchar * path,
+    guint max_transports, guint64 max_bitrate, guint extra_transports,
+    guint64 extra_bitrate)
+{
+  GstRTSPClientPrivate *priv = client->priv;
+  guint n_transports;
+  guint64 bitrate;
+
+  if (max_transports == 0 && max_bitrate == 0)
+    return GST_RTSP_STS_OK;
+
+  gst_rtsp_session_pool_get_load (priv->session_pool, path, &n_transports,
+      &bitrate, NULL);
+
+  if (max_transports > 0 && n_transports + extra_transports > max_transports) {
+    GST_WARNING ("client %p: %u transports for %s, refusing %u more", client,
+        n_transports, GST_STR_NULL (path), extra_transports);
+    return GST_RTSP_STS_SERVICE_UNAVAILABLE;
+  }
+  if (max_bitrate > 0 && bitrate + extra_bitrate > max_bitrate) {
+    GST_WARNING ("client %p: bitrate %" G_GUINT64_FORMAT " for %s, refusing %"
+        G_GUINT64_FORMAT " more", client, bitrate, GST_STR_NULL (path),
+        extra_bitrate);
+    return GST_RTSP_STS_NOT_ENOUGH_BANDWIDTH;
+  }
+
+  return GST_RTSP_STS_OK;
+}
+
+/* check whether starting @extra_transports more transports carrying
+ * @extra_bitrate on the media at @path stays within the limits of the session
+ * pool and of the mount point */
+static GstRTSPStatusCode
+check_admission (GstRTSPClient * client, const gchar * path,
+    guint extra_transports, guint64 extra_bitrate)
+{
+  GstRTSPClientPrivate *priv = client->priv;
+  GstRTSPMediaFactory *factory;
+  GstRTSPStatusCode code;
+  gint matched;
+
+  code = check_limits (client, NULL,
+      gst_rtsp_session_pool_get_max_transports (priv->session_pool),
+      gst_rtsp_session_pool_get_max_bitrate (priv->session_pool),
+      extra_transports, extra_bitrate);
+  if (code != GST_RTSP_STS_OK || priv->mount_points == NULL)
+    return code;
+
+  factory = gst_rtsp_mount_points_match (priv->mount_points, path, &matched);
+  if (factory) {
+    gchar *mount = g_strndup (path, matched);
+
+    code = check_limits (client, mount,
+        gst_rtsp_media_factory_get_max_transports (factory),
+        gst_rtsp_media_factory_get_max_bitrate (factory),
+        extra_transports, extra_bitrate);
+    g_free (mount);
+    g_object_unref (factory);
+  }
+
+  return code;
+}
+
+/* admission for the transports of @sessmedia that are not streamed to yet */
+static GstRTSPStatusCode
+check_play_admission (GstRTSPClient * client, GstRTSPSessionMedia * sessmedia,
+    const gchar * path)
+{
+  GPtrArray *transports;
+  guint i, extra_transports = 0;
+  guint64 extra_bitrate = 0;
+
+  transports = gst_rtsp_session_media_get_transports (sessmedia);
+  for (i = 0; i < transports->len; i++) {
+    GstRTSPStreamTransport *trans = g_ptr_array_index (transports, i);
+    GstRTSPStream *stream;
+
+    if (trans == NULL)
+      continue;
+
+    stream = gst_rtsp_stream_transport_get_stream (trans);
+    if (gst_rtsp_stream_has_transport (stream, trans))
+      continue;
+
+    extra_transports++;
+    extra_bitrate += gst_rtsp_stream_get_bitrate (stream);
+  }
+  g_ptr_array_unref (transports);
+
+  if (extra_transports == 0)
+    return GST_RTSP_STS_OK;
+
+  return check_admission (client, path, extra_transports, extra_bitrate);
+}
+
 static gboolean
 handle_play_request (GstRTSPClient * client, GstRTSPContext * ctx)
 {
@@ -2112,7 +2208,11 @@ handle_play_request (GstRTSPClient * client, GstRTSPContext * ctx)
   if (path[matched] != '\0')
     goto no_aggregate;
 
+  /* refuse new transports when the server or mount point is overloaded */
+  code = check_play_admission (client, sessmedia, path);
   g_free (path);
+  if (code != GST_RTSP_STS_OK)
+    goto admission_refused;
 
   ctx->sessmedia = sessmedia;
   ctx->media = media = gst_rtsp_session_media_get_media (sessmedia);
@@ -2237,6 +2337,13 @@ no_aggregate:
     g_free (path);
     return FALSE;
   }
+admission_refused:
+  {
+    GST_ERROR ("client %p: load limit reached", client);
+    send_generic_error_response (client, code, ctx);
+    g_object_unref (sessmedia);
+    return FALSE;
+  }
 sig_failed:
   {
     GST_ERROR ("client %p: pre signal returned error: %s", client,
@@ -2902,6 +3009,12 @@ handle_setup_request (GstRTSPClient * client, GstRTSPContext * ctx)
     goto sig_failed;
   }
 
+  /* refuse new transports when the server or mount point is overloaded, a
+   * stream that is already streaming costs its current bitrate */
+  code = check_admission (client, path, 1, gst_rtsp_stream_get_bitrate (stream));
+  if (code != GST_RTSP_STS_OK)
+    goto admission_refused;
+
   if (session == NULL) {
     /* create a session if this fails we probably reached our session limit or
      * something. */
@@ -3158,6 +3271,14 @@ sig_failed:
     g_object_unref (media);
     goto cleanup_path;
   }
+admission_refused:
+  {
+    GST_ERROR ("client %p: load limit reached", client);
+    send_generic_error_response (client, code, ctx);
+    gst_rtsp_media_unlock (media);
+    g_object_unref (media);
+    goto cleanup_path;
+  }
 service_unavailable:
   {
     GST_ERROR ("client %p: can't create session", client);
@@ -75,6 +75,17 @@ struct _GstRTSPMediaFactoryPrivate
   GMutex medias_lock;
   GHashTable *medias;           /* protected by medias_lock */
 
+  guint media_pool_size;
+  guint media_pool_expiry;
+  /* uri -> GQueue of PooledMedia, protected by medias_lock */
+  GHashTable *media_pool;
+  GThreadPool *media_pool_fill; /* protected by medias_lock */
+  GstRTSPThreadPool *media_pool_threads;
+
+  /* admission limits for the mount point */
+  guint max_transports;
+  guint64 max_bitrate;
+
   GType media_gtype;
 
   GstClock *clock;
@@ -98,6 +109,10 @@ struct _GstRTSPMediaFactoryPrivate
 #define DEFAULT_DO_RETRANSMISSION FALSE
 #define DEFAULT_DSCP_QOS        (-1)
 #define DEFAULT_ENABLE_RTCP     TRUE
+#define DEFAULT_MEDIA_POOL_SIZE 0
+#define DEFAULT_MEDIA_POOL_EXPIRY 0
+#define DEFAULT_MAX_TRANSPORTS  0
+#define DEFAULT_MAX_BITRATE     0
 
 enum
 {
@@ -117,6 +132,10 @@ enum
   PROP_BIND_MCAST_ADDRESS,
   PROP_DSCP_QOS,
   PROP_ENABLE_RTCP,
+  PROP_MEDIA_POOL_SIZE,
+  PROP_MEDIA_POOL_EXPIRY,
+  PROP_MAX_TRANSPORTS,
+  PROP_MAX_BITRATE,
   PROP_LAST
 };
 
@@ -138,6 +157,8 @@ static void gst_rtsp_media_factory_set_property (GObject * object, guint propid,
     const GValue * value, GParamSpec * pspec);
 static void gst_rtsp_media_factory_finalize (GObject * obj);
 
+static void media_pool_trim (GstRTSPMediaFactory * factory, guint size);
+
 static gchar *default_gen_key (GstRTSPMediaFactory * factory,
     const GstRTSPUrl * url);
 static GstElement *default_create_element (GstRTSPMediaFactory * factory,
@@ -268,6 +289,67 @@ gst_rtsp_media_factory_class_init (GstRTSPMediaFactoryClass * klass)
           "The IP DSCP field to use", -1, 63,
           DEFAULT_DSCP_QOS, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTSPMediaFactory:media-pool-size:
+   *
+   * The number of prepared medias to keep ready for each url that was
+   * requested before, so that new clients don't have to wait for the
+   * pipeline to preroll. Medias in the pool are constructed, configured
+   * and prepared from a background thread. Medias that end up shared are
+   * not replaced in the pool.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MEDIA_POOL_SIZE,
+      g_param_spec_uint ("media-pool-size", "Media pool size",
+          "The number of prepared medias to keep ready for each url", 0,
+          G_MAXUINT, DEFAULT_MEDIA_POOL_SIZE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPMediaFactory:media-pool-expiry:
+   *
+   * The time in seconds after which an unused media in the pool is
+   * unprepared, or 0 to keep them around forever. Expired medias of all
+   * urls are unprepared whenever a media is taken from or added to the pool
+   * and when this property is set.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MEDIA_POOL_EXPIRY,
+      g_param_spec_uint ("media-pool-expiry", "Media pool expiry",
+          "Seconds after which unused pooled medias are unprepared "
+          "(0 = never)", 0, G_MAXUINT, DEFAULT_MEDIA_POOL_EXPIRY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPMediaFactory:max-transports:
+   *
+   * The maximum amount of active transports to the medias of the mount
+   * point of this factory, 0 for no limit.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_TRANSPORTS,
+      g_param_spec_uint ("max-transports", "Max Transports",
+          "The maximum amount of active transports of the mount point "
+          "(0 = unlimited)", 0, G_MAXUINT, DEFAULT_MAX_TRANSPORTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPMediaFactory:max-bitrate:
+   *
+   * The maximum total bitrate in bits per second sent from the medias of the
+   * mount point of this factory, 0 for no limit.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_BITRATE,
+      g_param_spec_uint64 ("max-bitrate", "Max Bitrate",
+          "The maximum total bitrate in bits per second of the mount point "
+          "(0 = unlimited)", 0, G_MAXUINT64, DEFAULT_MAX_BITRATE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONSTRUCTED] =
       g_signal_new ("media-constructed", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_LAST, G_STRUCT_OFFSET (GstRTSPMediaFactoryClass,
@@ -313,11 +395,17 @@ gst_rtsp_media_factory_init (GstRTSPMediaFactory * factory)
   priv->bind_mcast_address = DEFAULT_BIND_MCAST_ADDRESS;
   priv->enable_rtcp = DEFAULT_ENABLE_RTCP;
   priv->dscp_qos = DEFAULT_DSCP_QOS;
+  priv->media_pool_size = DEFAULT_MEDIA_POOL_SIZE;
+  priv->media_pool_expiry = DEFAULT_MEDIA_POOL_EXPIRY;
+  priv->max_transports = DEFAULT_MAX_TRANSPORTS;
+  priv->max_bitrate = DEFAULT_MAX_BITRATE;
 
   g_mutex_init (&priv->lock);
   g_mutex_init (&priv->medias_lock);
   priv->medias = g_hash_table_new_full (g_str_hash, g_str_equal,
       g_free, g_object_unref);
+  priv->media_pool = g_hash_table_new_full (g_str_hash, g_str_equal,
+      g_free, NULL);
   priv->media_gtype = GST_TYPE_RTSP_MEDIA;
 }
 
@@ -332,6 +420,14 @@ gst_rtsp_media_factory_finalize (GObject * obj)
   if (priv->permissions)
     gst_rtsp_permissions_unref (priv->permissions);
   g_hash_table_unref (priv->medias);
+  /* the fill jobs keep a ref on the factory, none can be pending here but we
+   * might be called from the last one */
+  if (priv->media_pool_fill)
+    g_thread_pool_free (priv->media_pool_fill, TRUE, FALSE);
+  media_pool_trim (factory, 0);
+  g_hash_table_unref (priv->media_pool);
+  if (priv->media_pool_threads)
+    g_object_unref (priv->media_pool_threads);
   g_mutex_clear (&priv->medias_lock);
   g_free (priv->launch);
   g_mutex_clear (&priv->lock);
@@ -402,6 +498,22 @@ gst_rtsp_media_factory_get_property (GObject * object, guint propid,
       g_value_set_boolean (value,
           gst_rtsp_media_factory_is_enable_rtcp (factory));
       break;
+    case PROP_MEDIA_POOL_SIZE:
+      g_value_set_uint (value,
+          gst_rtsp_media_factory_get_media_pool_size (factory));
+      break;
+    case PROP_MEDIA_POOL_EXPIRY:
+      g_value_set_uint (value,
+          gst_rtsp_media_factory_get_media_pool_expiry (factory));
+      break;
+    case PROP_MAX_TRANSPORTS:
+      g_value_set_uint (value,
+          gst_rtsp_media_factory_get_max_transports (factory));
+      break;
+    case PROP_MAX_BITRATE:
+      g_value_set_uint64 (value,
+          gst_rtsp_media_factory_get_max_bitrate (factory));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -467,6 +579,22 @@ gst_rtsp_media_factory_set_property (GObject * object, guint propid,
       gst_rtsp_media_factory_set_enable_rtcp (factory,
           g_value_get_boolean (value));
       break;
+    case PROP_MEDIA_POOL_SIZE:
+      gst_rtsp_media_factory_set_media_pool_size (factory,
+          g_value_get_uint (value));
+      break;
+    case PROP_MEDIA_POOL_EXPIRY:
+      gst_rtsp_media_factory_set_media_pool_expiry (factory,
+          g_value_get_uint (value));
+      break;
+    case PROP_MAX_TRANSPORTS:
+      gst_rtsp_media_factory_set_max_transports (factory,
+          g_value_get_uint (value));
+      break;
+    case PROP_MAX_BITRATE:
+      gst_rtsp_media_factory_set_max_bitrate (factory,
+          g_value_get_uint64 (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
   }
@@ -1360,6 +1488,227 @@ weak_ref_free (GWeakRef * ref)
   g_free (ref);
 }
 
+typedef struct
+{
+  GstRTSPMedia *media;
+  gint64 added;                 /* monotonic time */
+} PooledMedia;
+
+static void
+pooled_media_free (PooledMedia * pooled)
+{
+  gst_rtsp_media_unprepare (pooled->media);
+  g_object_unref (pooled->media);
+  g_free (pooled);
+}
+
+/* drop pooled medias so that at most @size are left for every url */
+static void
+media_pool_trim (GstRTSPMediaFactory * factory, guint size)
+{
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+  GHashTableIter iter;
+  GQueue *queue;
+  GList *dropped = NULL;
+
+  g_mutex_lock (&priv->medias_lock);
+  g_hash_table_iter_init (&iter, priv->media_pool);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & queue)) {
+    while (g_queue_get_length (queue) > size)
+      dropped = g_list_prepend (dropped, g_queue_pop_tail (queue));
+    if (g_queue_is_empty (queue)) {
+      g_queue_free (queue);
+      g_hash_table_iter_remove (&iter);
+    }
+  }
+  g_mutex_unlock (&priv->medias_lock);
+
+  /* unpreparing can take a while, don't keep the lock */
+  g_list_free_full (dropped, (GDestroyNotify) pooled_media_free);
+}
+
+/* with medias_lock. Moves the expired and failed medias of all urls to
+ * @dropped, so that medias of urls that are not requested anymore don't
+ * stay prepared forever */
+static void
+media_pool_sweep (GstRTSPMediaFactory * factory, guint expiry,
+    GList ** dropped)
+{
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+  GHashTableIter iter;
+  GQueue *queue;
+  gint64 now = g_get_monotonic_time ();
+
+  g_hash_table_iter_init (&iter, priv->media_pool);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *) & queue)) {
+    GList *walk = queue->head;
+
+    while (walk) {
+      PooledMedia *pooled = walk->data;
+      GList *next = walk->next;
+
+      if ((expiry && now - pooled->added > expiry * G_TIME_SPAN_SECOND) ||
+          gst_rtsp_media_get_status (pooled->media) !=
+          GST_RTSP_MEDIA_STATUS_PREPARED) {
+        g_queue_delete_link (queue, walk);
+        *dropped = g_list_prepend (*dropped, pooled);
+      }
+      walk = next;
+    }
+
+    if (g_queue_is_empty (queue)) {
+      g_queue_free (queue);
+      g_hash_table_iter_remove (&iter);
+    }
+  }
+}
+
+/* with medias_lock. Expired and failed medias are added to @dropped */
+static GstRTSPMedia *
+media_pool_take (GstRTSPMediaFactory * factory, const gchar * uri,
+    guint expiry, GList ** dropped)
+{
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+  GstRTSPMedia *media = NULL;
+  PooledMedia *pooled;
+  GQueue *queue;
+
+  media_pool_sweep (factory, expiry, dropped);
+
+  if (!(queue = g_hash_table_lookup (priv->media_pool, uri)))
+    return NULL;
+
+  if ((pooled = g_queue_pop_head (queue))) {
+    media = pooled->media;
+    g_free (pooled);
+  }
+
+  if (media) {
+    /* the user prepares the media again, give up the pool's prepare count
+     * so that its unprepare really unprepares it */
+    gst_rtsp_media_drop_prepare_count (media);
+    GST_INFO_OBJECT (factory, "took prepared media %p for %s from the pool",
+        media, uri);
+  }
+
+  return media;
+}
+
+/* construct, configure and prepare a media for the pool */
+static GstRTSPMedia *
+media_pool_create (GstRTSPMediaFactory * factory, const GstRTSPUrl * url)
+{
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+  GstRTSPMediaFactoryClass *klass = GST_RTSP_MEDIA_FACTORY_GET_CLASS (factory);
+  GstRTSPMedia *media;
+  GstRTSPThread *thread;
+
+  if (!klass->construct || !(media = klass->construct (factory, url)))
+    return NULL;
+
+  g_signal_emit (factory,
+      gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONSTRUCTED], 0, media, NULL);
+
+  if (klass->configure)
+    klass->configure (factory, media);
+
+  g_signal_emit (factory,
+      gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONFIGURE], 0, media, NULL);
+
+  /* medias for recording are not prepared before the client is ready */
+  if (gst_rtsp_media_get_transport_mode (media) &
+      GST_RTSP_TRANSPORT_MODE_RECORD)
+    goto no_prepare;
+
+  thread = gst_rtsp_thread_pool_get_thread (priv->media_pool_threads,
+      GST_RTSP_THREAD_TYPE_MEDIA, NULL);
+  if (thread == NULL || !gst_rtsp_media_prepare (media, thread))
+    goto no_prepare;
+
+  return media;
+
+no_prepare:
+  {
+    GST_WARNING_OBJECT (factory, "can't prepare media %p for the pool", media);
+    g_object_unref (media);
+    return NULL;
+  }
+}
+
+static void
+media_pool_fill_func (GstRTSPUrl * url, gpointer user_data)
+{
+  GstRTSPMediaFactory *factory = user_data;
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+  gchar *uri = gst_rtsp_url_get_request_uri (url);
+
+  while (TRUE) {
+    GstRTSPMedia *media;
+    PooledMedia *pooled;
+    GQueue *queue;
+    GList *dropped = NULL;
+    guint size, expiry;
+
+    GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+    size = priv->media_pool_size;
+    expiry = priv->media_pool_expiry;
+    GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
+    g_mutex_lock (&priv->medias_lock);
+    queue = g_hash_table_lookup (priv->media_pool, uri);
+    if (queue && g_queue_get_length (queue) >= size) {
+      g_mutex_unlock (&priv->medias_lock);
+      break;
+    }
+    g_mutex_unlock (&priv->medias_lock);
+
+    if (!(media = media_pool_create (factory, url)))
+      break;
+
+    pooled = g_new (PooledMedia, 1);
+    pooled->media = media;
+    pooled->added = g_get_monotonic_time ();
+
+    g_mutex_lock (&priv->medias_lock);
+    media_pool_sweep (factory, expiry, &dropped);
+    if (!(queue = g_hash_table_lookup (priv->media_pool, uri))) {
+      queue = g_queue_new ();
+      g_hash_table_insert (priv->media_pool, g_strdup (uri), queue);
+    }
+    g_queue_push_tail (queue, pooled);
+    g_mutex_unlock (&priv->medias_lock);
+
+    g_list_free_full (dropped, (GDestroyNotify) pooled_media_free);
+
+    GST_INFO_OBJECT (factory, "added prepared media %p for %s to the pool",
+        media, uri);
+  }
+
+  g_free (uri);
+  gst_rtsp_url_free (url);
+  /* taken when the job was pushed */
+  g_object_unref (factory);
+}
+
+/* with medias_lock */
+static void
+media_pool_schedule_fill (GstRTSPMediaFactory * factory,
+    const GstRTSPUrl * url)
+{
+  GstRTSPMediaFactoryPrivate *priv = factory->priv;
+
+  if (!priv->media_pool_fill) {
+    /* one thread, so that the jobs for the same url never race */
+    priv->media_pool_fill =
+        g_thread_pool_new ((GFunc) media_pool_fill_func, factory, 1, FALSE,
+        NULL);
+    priv->media_pool_threads = gst_rtsp_thread_pool_new ();
+  }
+
+  g_object_ref (factory);
+  g_thread_pool_push (priv->media_pool_fill, gst_rtsp_url_copy (url), NULL);
+}
+
 /**
  * gst_rtsp_media_factory_construct:
  * @factory: a #GstRTSPMediaFactory
@@ -1385,6 +1734,8 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
   gchar *key;
   GstRTSPMedia *media;
   GstRTSPMediaFactoryClass *klass;
+  guint pool_size, pool_expiry;
+  GList *dropped = NULL;
 
   g_return_val_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory), NULL);
   g_return_val_if_fail (url != NULL, NULL);
@@ -1392,6 +1743,11 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
   priv = factory->priv;
   klass = GST_RTSP_MEDIA_FACTORY_GET_CLASS (factory);
 
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  pool_size = priv->media_pool_size;
+  pool_expiry = priv->media_pool_expiry;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
   /* convert the url to a key for the hashtable. NULL return or a NULL function
    * will not cache anything for this factory. */
   if (klass->gen_key)
@@ -1409,8 +1765,19 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
     media = NULL;
 
   if (media == NULL) {
-    /* nothing cached found, try to create one */
-    if (klass->construct) {
+    GstRTSPMedia *pooled = NULL;
+
+    if (pool_size > 0) {
+      gchar *uri = gst_rtsp_url_get_request_uri (url);
+      pooled = media_pool_take (factory, uri, pool_expiry, &dropped);
+      g_free (uri);
+    }
+
+    if (pooled) {
+      /* already constructed and configured for the pool */
+      media = pooled;
+    } else if (klass->construct) {
+      /* nothing cached found, try to create one */
       media = klass->construct (factory, url);
       if (media)
         g_signal_emit (factory,
@@ -1421,12 +1788,14 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
 
     if (media) {
       /* configure the media */
-      if (klass->configure)
-        klass->configure (factory, media);
+      if (!pooled) {
+        if (klass->configure)
+          klass->configure (factory, media);
 
-      g_signal_emit (factory,
-          gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONFIGURE], 0, media,
-          NULL);
+        g_signal_emit (factory,
+            gst_rtsp_media_factory_signals[SIGNAL_MEDIA_CONFIGURE], 0, media,
+            NULL);
+      }
 
       /* check if we can cache this media */
       if (gst_rtsp_media_is_shared (media) && key) {
@@ -1434,6 +1803,9 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
         g_object_ref (media);
         g_hash_table_insert (priv->medias, key, media);
         key = NULL;
+      } else if (pool_size > 0) {
+        /* have the next one for this url ready */
+        media_pool_schedule_fill (factory, url);
       }
       if (!gst_rtsp_media_is_reusable (media)) {
         /* when not reusable, connect to the unprepare signal to remove the item
@@ -1446,6 +1818,8 @@ gst_rtsp_media_factory_construct (GstRTSPMediaFactory * factory,
   }
   g_mutex_unlock (&priv->medias_lock);
 
+  g_list_free_full (dropped, (GDestroyNotify) pooled_media_free);
+
   if (key)
     g_free (key);
 
@@ -1762,6 +2136,231 @@ gst_rtsp_media_factory_is_enable_rtcp (GstRTSPMediaFactory * factory)
   return result;
 }
 
+/**
+ * gst_rtsp_media_factory_set_media_pool_size:
+ * @factory: a #GstRTSPMediaFactory
+ * @size: the number of medias
+ *
+ * Keep @size prepared medias ready for every url that was constructed
+ * before. gst_rtsp_media_factory_construct() hands those out instead of
+ * constructing a new media and replaces them from a background thread.
+ *
+ * Since: 1.24
+ */
+void
+gst_rtsp_media_factory_set_media_pool_size (GstRTSPMediaFactory * factory,
+    guint size)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory));
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  priv->media_pool_size = size;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
+  media_pool_trim (factory, size);
+}
+
+/**
+ * gst_rtsp_media_factory_get_media_pool_size:
+ * @factory: a #GstRTSPMediaFactory
+ *
+ * Get the number of prepared medias kept ready for every url.
+ *
+ * Returns: the media pool size
+ *
+ * Since: 1.24
+ */
+guint
+gst_rtsp_media_factory_get_media_pool_size (GstRTSPMediaFactory * factory)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+  guint result;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory), 0);
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  result = priv->media_pool_size;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
+  return result;
+}
+
+/**
+ * gst_rtsp_media_factory_set_media_pool_expiry:
+ * @factory: a #GstRTSPMediaFactory
+ * @expiry: the expiry in seconds
+ *
+ * Unprepare medias that stayed unused in the media pool for longer than
+ * @expiry seconds. 0 keeps them forever. Expired medias of all urls are
+ * unprepared whenever a media is taken from or added to the pool and when
+ * this is called.
+ *
+ * Since: 1.24
+ */
+void
+gst_rtsp_media_factory_set_media_pool_expiry (GstRTSPMediaFactory * factory,
+    guint expiry)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+  GList *dropped = NULL;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory));
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  priv->media_pool_expiry = expiry;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
+  g_mutex_lock (&priv->medias_lock);
+  media_pool_sweep (factory, expiry, &dropped);
+  g_mutex_unlock (&priv->medias_lock);
+
+  /* unpreparing can take a while, don't keep the lock */
+  g_list_free_full (dropped, (GDestroyNotify) pooled_media_free);
+}
+
+/**
+ * gst_rtsp_media_factory_get_media_pool_expiry:
+ * @factory: a #GstRTSPMediaFactory
+ *
+ * Get the time after which unused pooled medias are unprepared.
+ *
+ * Returns: the expiry in seconds
+ *
+ * Since: 1.24
+ */
+guint
+gst_rtsp_media_factory_get_media_pool_expiry (GstRTSPMediaFactory * factory)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+  guint result;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory), 0);
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  result = priv->media_pool_expiry;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
+  return result;
+}
+
+/**
+ * gst_rtsp_media_factory_set_max_transports:
+ * @factory: a #GstRTSPMediaFactory
+ * @max: the maximum number of active transports
+ *
+ * Configure the maximum number of active transports to the medias of the
+ * mount point of @factory. Clients are refused in SETUP and PLAY when they
+ * would exceed it. 0 means no limit.
+ *
+ * Since: 1.24
+ */
+void
+gst_rtsp_media_factory_set_max_transports (GstRTSPMediaFactory * factory,
+    guint max)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory));
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  priv->max_transports = max;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+}
+
+/**
+ * gst_rtsp_media_factory_get_max_transports:
+ * @factory: a #GstRTSPMediaFactory
+ *
+ * Get the maximum number of active transports of the mount point of
+ * @factory.
+ *
+ * Returns: the maximum number of active transports, 0 for no limit
+ *
+ * Since: 1.24
+ */
+guint
+gst_rtsp_media_factory_get_max_transports (GstRTSPMediaFactory * factory)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+  guint result;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory), 0);
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  result = priv->max_transports;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
+  return result;
+}
+
+/**
+ * gst_rtsp_media_factory_set_max_bitrate:
+ * @factory: a #GstRTSPMediaFactory
+ * @max: the maximum total bitrate in bits per second
+ *
+ * Configure the maximum total bitrate sent from the medias of the mount point
+ * of @factory. Clients are refused in PLAY when their streams would exceed
+ * it. 0 means no limit.
+ *
+ * Since: 1.24
+ */
+void
+gst_rtsp_media_factory_set_max_bitrate (GstRTSPMediaFactory * factory,
+    guint64 max)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory));
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  priv->max_bitrate = max;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+}
+
+/**
+ * gst_rtsp_media_factory_get_max_bitrate:
+ * @factory: a #GstRTSPMediaFactory
+ *
+ * Get the maximum total bitrate sent from the medias of the mount point of
+ * @factory.
+ *
+ * Returns: the maximum bitrate in bits per second, 0 for no limit
+ *
+ * Since: 1.24
+ */
+guint64
+gst_rtsp_media_factory_get_max_bitrate (GstRTSPMediaFactory * factory)
+{
+  GstRTSPMediaFactoryPrivate *priv;
+  guint64 result;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA_FACTORY (factory), 0);
+
+  priv = factory->priv;
+
+  GST_RTSP_MEDIA_FACTORY_LOCK (factory);
+  result = priv->max_bitrate;
+  GST_RTSP_MEDIA_FACTORY_UNLOCK (factory);
+
+  return result;
+}
+
 static gchar *
 default_gen_key (GstRTSPMediaFactory * factory, const GstRTSPUrl * url)
 {
@@ -265,6 +265,34 @@ void                  gst_rtsp_media_factory_set_enable_rtcp (GstRTSPMediaFactor
 GST_RTSP_SERVER_API
 gboolean              gst_rtsp_media_factory_is_enable_rtcp (GstRTSPMediaFactory * factory);
 
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_factory_set_media_pool_size (GstRTSPMediaFactory * factory,
+                                                                  guint size);
+
+GST_RTSP_SERVER_API
+guint                 gst_rtsp_media_factory_get_media_pool_size (GstRTSPMediaFactory * factory);
+
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_factory_set_media_pool_expiry (GstRTSPMediaFactory * factory,
+                                                                    guint expiry);
+
+GST_RTSP_SERVER_API
+guint                 gst_rtsp_media_factory_get_media_pool_expiry (GstRTSPMediaFactory * factory);
+
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_factory_set_max_transports (GstRTSPMediaFactory * factory,
+                                                                 guint max);
+
+GST_RTSP_SERVER_API
+guint                 gst_rtsp_media_factory_get_max_transports (GstRTSPMediaFactory * factory);
+
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_factory_set_max_bitrate (GstRTSPMediaFactory * factory,
+                                                              guint64 max);
+
+GST_RTSP_SERVER_API
+guint64               gst_rtsp_media_factory_get_max_bitrate (GstRTSPMediaFactory * factory);
+
 /* creating the media from the factory and a url */
 
 GST_RTSP_SERVER_API
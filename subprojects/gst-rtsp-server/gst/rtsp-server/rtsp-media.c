@@ -156,6 +156,8 @@ struct _GstRTSPMediaPrivate
   guint latency;                /* protected by lock */
   GstClock *clock;              /* protected by lock */
   gboolean do_rate_control;     /* protected by lock */
+  gboolean gop_cache;           /* protected by lock */
+  guint drop_delta_threshold;   /* protected by lock */
   GstRTSPPublishClockMode publish_clock_mode;
 
   /* Dynamic element handling */
@@ -2466,6 +2468,8 @@ gst_rtsp_media_create_stream (GstRTSPMedia * media, GstElement * payloader,
   gst_rtsp_stream_set_buffer_size (stream, priv->buffer_size);
   gst_rtsp_stream_set_publish_clock_mode (stream, priv->publish_clock_mode);
   gst_rtsp_stream_set_rate_control (stream, priv->do_rate_control);
+  gst_rtsp_stream_set_gop_cache (stream, priv->gop_cache);
+  gst_rtsp_stream_set_drop_delta_threshold (stream, priv->drop_delta_threshold);
 
   g_ptr_array_add (priv->streams, stream);
 
@@ -4114,6 +4118,24 @@ default_unprepare (GstRTSPMedia * media)
   return TRUE;
 }
 
+/* Gives up one prepare count without unpreparing @media. Used by the
+ * factory when handing a media it prepared for its pool to a user, who
+ * will prepare and unprepare it again. */
+void
+gst_rtsp_media_drop_prepare_count (GstRTSPMedia * media)
+{
+  GstRTSPMediaPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA (media));
+
+  priv = media->priv;
+
+  g_rec_mutex_lock (&priv->state_lock);
+  if (priv->prepare_count > 0)
+    priv->prepare_count--;
+  g_rec_mutex_unlock (&priv->state_lock);
+}
+
 /**
  * gst_rtsp_media_unprepare:
  * @media: a #GstRTSPMedia
@@ -5241,3 +5263,117 @@ gst_rtsp_media_get_rate_control (GstRTSPMedia * media)
 
   return res;
 }
+
+/**
+ * gst_rtsp_media_set_gop_cache:
+ * @media: a #GstRTSPMedia
+ * @enabled: whether to cache the last GOP
+ *
+ * Define whether the streams of @media replay the RTP packets since the last
+ * keyframe to new clients. See gst_rtsp_stream_set_gop_cache(). This is
+ * mostly useful for shared live media.
+ *
+ * Since: 1.24
+ */
+void
+gst_rtsp_media_set_gop_cache (GstRTSPMedia * media, gboolean enabled)
+{
+  GstRTSPMediaPrivate *priv;
+  guint i;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA (media));
+
+  GST_LOG_OBJECT (media, "%s GOP cache", enabled ? "Enabling" : "Disabling");
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->gop_cache = enabled;
+  for (i = 0; i < priv->streams->len; i++) {
+    GstRTSPStream *stream = g_ptr_array_index (priv->streams, i);
+
+    gst_rtsp_stream_set_gop_cache (stream, enabled);
+  }
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_media_get_gop_cache:
+ * @media: a #GstRTSPMedia
+ *
+ * Returns: whether the streams of @media replay the last GOP to new clients.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_rtsp_media_get_gop_cache (GstRTSPMedia * media)
+{
+  GstRTSPMediaPrivate *priv;
+  gboolean res;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA (media), FALSE);
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  res = priv->gop_cache;
+  g_mutex_unlock (&priv->lock);
+
+  return res;
+}
+
+/**
+ * gst_rtsp_media_set_drop_delta_threshold:
+ * @media: a #GstRTSPMedia
+ * @threshold: the backlog length in messages, 0 to disable
+ *
+ * Configure the TCP backlog length after which the streams of @media drop
+ * delta units for a client. See gst_rtsp_stream_set_drop_delta_threshold().
+ *
+ * Since: 1.24
+ */
+void
+gst_rtsp_media_set_drop_delta_threshold (GstRTSPMedia * media, guint threshold)
+{
+  GstRTSPMediaPrivate *priv;
+  guint i;
+
+  g_return_if_fail (GST_IS_RTSP_MEDIA (media));
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->drop_delta_threshold = threshold;
+  for (i = 0; i < priv->streams->len; i++) {
+    GstRTSPStream *stream = g_ptr_array_index (priv->streams, i);
+
+    gst_rtsp_stream_set_drop_delta_threshold (stream, threshold);
+  }
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_media_get_drop_delta_threshold:
+ * @media: a #GstRTSPMedia
+ *
+ * Returns: the TCP backlog length after which the streams of @media drop
+ * delta units, 0 if they never do.
+ *
+ * Since: 1.24
+ */
+guint
+gst_rtsp_media_get_drop_delta_threshold (GstRTSPMedia * media)
+{
+  GstRTSPMediaPrivate *priv;
+  guint res;
+
+  g_return_val_if_fail (GST_IS_RTSP_MEDIA (media), 0);
+
+  priv = media->priv;
+
+  g_mutex_lock (&priv->lock);
+  res = priv->drop_delta_threshold;
+  g_mutex_unlock (&priv->lock);
+
+  return res;
+}
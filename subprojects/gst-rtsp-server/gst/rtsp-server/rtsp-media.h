@@ -440,6 +440,18 @@ void                  gst_rtsp_media_set_rate_control (GstRTSPMedia * media, gbo
 GST_RTSP_SERVER_API
 gboolean              gst_rtsp_media_get_rate_control (GstRTSPMedia * media);
 
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_set_gop_cache (GstRTSPMedia * media, gboolean enabled);
+
+GST_RTSP_SERVER_API
+gboolean              gst_rtsp_media_get_gop_cache (GstRTSPMedia * media);
+
+GST_RTSP_SERVER_API
+void                  gst_rtsp_media_set_drop_delta_threshold (GstRTSPMedia * media, guint threshold);
+
+GST_RTSP_SERVER_API
+guint                 gst_rtsp_media_get_drop_delta_threshold (GstRTSPMedia * media);
+
 #ifdef G_DEFINE_AUTOPTR_CLEANUP_FUNC
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstRTSPMedia, gst_object_unref)
 #endif
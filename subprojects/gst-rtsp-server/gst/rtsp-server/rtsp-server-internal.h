@@ -44,6 +44,13 @@ gboolean                 gst_rtsp_stream_transport_backlog_peek_is_rtp (GstRTSPS
 
 gboolean                 gst_rtsp_stream_transport_backlog_is_empty (GstRTSPStreamTransport *trans);
 
+guint                    gst_rtsp_stream_transport_backlog_length (GstRTSPStreamTransport *trans);
+
+void                     gst_rtsp_stream_transport_drop_delta_units (GstRTSPStreamTransport *trans,
+                                                                  guint threshold,
+                                                                  GstBuffer **buffer,
+                                                                  GstBufferList **buffer_list);
+
 void                     gst_rtsp_stream_transport_clear_backlog (GstRTSPStreamTransport * trans);
 
 void                     gst_rtsp_stream_transport_lock_backlog  (GstRTSPStreamTransport * trans);
@@ -60,7 +67,11 @@ gboolean                 gst_rtsp_stream_transport_check_back_pressure (GstRTSPS
 
 gboolean                 gst_rtsp_stream_is_tcp_receiver (GstRTSPStream * stream);
 
+gboolean                 gst_rtsp_stream_has_transport (GstRTSPStream * stream,
+                                                        GstRTSPStreamTransport * trans);
+
 void                     gst_rtsp_media_set_enable_rtcp (GstRTSPMedia *media, gboolean enable);
+void                     gst_rtsp_media_drop_prepare_count (GstRTSPMedia *media);
 void                     gst_rtsp_stream_set_enable_rtcp (GstRTSPStream *stream, gboolean enable);
 
 G_END_DECLS
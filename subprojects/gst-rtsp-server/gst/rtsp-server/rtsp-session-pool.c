@@ -33,6 +33,12 @@
  *
  * All sessions can be iterated with gst_rtsp_session_pool_filter().
  *
+ * The load caused by the sessions, on the whole server or on one mount point,
+ * can be retrieved with gst_rtsp_session_pool_get_load(). New transports are
+ * refused when they would exceed the limits configured with
+ * gst_rtsp_session_pool_set_max_transports() and
+ * gst_rtsp_session_pool_set_max_bitrate().
+ *
  * Run gst_rtsp_session_pool_cleanup() periodically to remove timed out sessions
  * or use gst_rtsp_session_pool_create_watch() to be notified when session
  * cleanup should be performed.
@@ -44,21 +50,28 @@
 #endif
 
 #include "rtsp-session-pool.h"
+#include "rtsp-server-internal.h"
 
 struct _GstRTSPSessionPoolPrivate
 {
   GMutex lock;                  /* protects everything in this struct */
   guint max_sessions;
+  guint max_transports;
+  guint64 max_bitrate;
   GHashTable *sessions;
   guint sessions_cookie;
 };
 
 #define DEFAULT_MAX_SESSIONS 0
+#define DEFAULT_MAX_TRANSPORTS 0
+#define DEFAULT_MAX_BITRATE 0
 
 enum
 {
   PROP_0,
   PROP_MAX_SESSIONS,
+  PROP_MAX_TRANSPORTS,
+  PROP_MAX_BITRATE,
   PROP_LAST
 };
 
@@ -111,6 +124,33 @@ gst_rtsp_session_pool_class_init (GstRTSPSessionPoolClass * klass)
           0, G_MAXUINT, DEFAULT_MAX_SESSIONS,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstRTSPSessionPool:max-transports:
+   *
+   * The maximum amount of active transports of all sessions (0 = unlimited).
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_TRANSPORTS,
+      g_param_spec_uint ("max-transports", "Max Transports",
+          "the maximum amount of active transports (0 = unlimited)",
+          0, G_MAXUINT, DEFAULT_MAX_TRANSPORTS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstRTSPSessionPool:max-bitrate:
+   *
+   * The maximum total bitrate in bits per second sent to all sessions
+   * (0 = unlimited).
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_BITRATE,
+      g_param_spec_uint64 ("max-bitrate", "Max Bitrate",
+          "the maximum total bitrate in bits per second (0 = unlimited)",
+          0, G_MAXUINT64, DEFAULT_MAX_BITRATE,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_rtsp_session_pool_signals[SIGNAL_SESSION_REMOVED] =
       g_signal_new ("session-removed", G_TYPE_FROM_CLASS (klass),
       G_SIGNAL_RUN_LAST, G_STRUCT_OFFSET (GstRTSPSessionPoolClass,
@@ -135,6 +175,8 @@ gst_rtsp_session_pool_init (GstRTSPSessionPool * pool)
   priv->sessions = g_hash_table_new_full (g_str_hash, g_str_equal,
       NULL, g_object_unref);
   priv->max_sessions = DEFAULT_MAX_SESSIONS;
+  priv->max_transports = DEFAULT_MAX_TRANSPORTS;
+  priv->max_bitrate = DEFAULT_MAX_BITRATE;
 }
 
 static GstRTSPFilterResult
@@ -167,6 +209,12 @@ gst_rtsp_session_pool_get_property (GObject * object, guint propid,
     case PROP_MAX_SESSIONS:
       g_value_set_uint (value, gst_rtsp_session_pool_get_max_sessions (pool));
       break;
+    case PROP_MAX_TRANSPORTS:
+      g_value_set_uint (value, gst_rtsp_session_pool_get_max_transports (pool));
+      break;
+    case PROP_MAX_BITRATE:
+      g_value_set_uint64 (value, gst_rtsp_session_pool_get_max_bitrate (pool));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
       break;
@@ -183,6 +231,13 @@ gst_rtsp_session_pool_set_property (GObject * object, guint propid,
     case PROP_MAX_SESSIONS:
       gst_rtsp_session_pool_set_max_sessions (pool, g_value_get_uint (value));
       break;
+    case PROP_MAX_TRANSPORTS:
+      gst_rtsp_session_pool_set_max_transports (pool,
+          g_value_get_uint (value));
+      break;
+    case PROP_MAX_BITRATE:
+      gst_rtsp_session_pool_set_max_bitrate (pool, g_value_get_uint64 (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, propid, pspec);
       break;
@@ -255,6 +310,194 @@ gst_rtsp_session_pool_get_max_sessions (GstRTSPSessionPool * pool)
   return result;
 }
 
+/**
+ * gst_rtsp_session_pool_set_max_transports:
+ * @pool: a #GstRTSPSessionPool
+ * @max: the maximum number of active transports
+ *
+ * Configure the maximum number of active transports of all sessions in @pool.
+ * Clients are refused in SETUP and PLAY when they would exceed it. A value
+ * of 0 means an unlimited amount of transports.
+ *
+ * Since: 1.24
+ */
+void
+gst_rtsp_session_pool_set_max_transports (GstRTSPSessionPool * pool,
+    guint max)
+{
+  GstRTSPSessionPoolPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_SESSION_POOL (pool));
+
+  priv = pool->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->max_transports = max;
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_session_pool_get_max_transports:
+ * @pool: a #GstRTSPSessionPool
+ *
+ * Get the maximum number of active transports in @pool. 0 means an
+ * unlimited amount of transports.
+ *
+ * Returns: the maximum number of active transports.
+ *
+ * Since: 1.24
+ */
+guint
+gst_rtsp_session_pool_get_max_transports (GstRTSPSessionPool * pool)
+{
+  GstRTSPSessionPoolPrivate *priv;
+  guint result;
+
+  g_return_val_if_fail (GST_IS_RTSP_SESSION_POOL (pool), 0);
+
+  priv = pool->priv;
+
+  g_mutex_lock (&priv->lock);
+  result = priv->max_transports;
+  g_mutex_unlock (&priv->lock);
+
+  return result;
+}
+
+/**
+ * gst_rtsp_session_pool_set_max_bitrate:
+ * @pool: a #GstRTSPSessionPool
+ * @max: the maximum total bitrate in bits per second
+ *
+ * Configure the maximum total bitrate sent to all sessions in @pool. Clients
+ * are refused in PLAY when their streams would exceed it. A value of 0 means
+ * an unlimited bitrate.
+ *
+ * Since: 1.24
+ */
+void
+gst_rtsp_session_pool_set_max_bitrate (GstRTSPSessionPool * pool,
+    guint64 max)
+{
+  GstRTSPSessionPoolPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_SESSION_POOL (pool));
+
+  priv = pool->priv;
+
+  g_mutex_lock (&priv->lock);
+  priv->max_bitrate = max;
+  g_mutex_unlock (&priv->lock);
+}
+
+/**
+ * gst_rtsp_session_pool_get_max_bitrate:
+ * @pool: a #GstRTSPSessionPool
+ *
+ * Get the maximum total bitrate sent to all sessions in @pool. 0 means an
+ * unlimited bitrate.
+ *
+ * Returns: the maximum total bitrate in bits per second.
+ *
+ * Since: 1.24
+ */
+guint64
+gst_rtsp_session_pool_get_max_bitrate (GstRTSPSessionPool * pool)
+{
+  GstRTSPSessionPoolPrivate *priv;
+  guint64 result;
+
+  g_return_val_if_fail (GST_IS_RTSP_SESSION_POOL (pool), 0);
+
+  priv = pool->priv;
+
+  g_mutex_lock (&priv->lock);
+  result = priv->max_bitrate;
+  g_mutex_unlock (&priv->lock);
+
+  return result;
+}
+
+static void
+add_session_media_load (GstRTSPSessionMedia * sessmedia, guint * n_transports,
+    guint64 * bitrate, guint * backlog)
+{
+  GPtrArray *transports;
+  guint i;
+
+  transports = gst_rtsp_session_media_get_transports (sessmedia);
+  for (i = 0; i < transports->len; i++) {
+    GstRTSPStreamTransport *trans = g_ptr_array_index (transports, i);
+    GstRTSPStream *stream;
+
+    if (trans == NULL)
+      continue;
+
+    stream = gst_rtsp_stream_transport_get_stream (trans);
+    if (!gst_rtsp_stream_has_transport (stream, trans))
+      continue;
+
+    *n_transports += 1;
+    *bitrate += gst_rtsp_stream_get_bitrate (stream);
+
+    gst_rtsp_stream_transport_lock_backlog (trans);
+    *backlog += gst_rtsp_stream_transport_backlog_length (trans);
+    gst_rtsp_stream_transport_unlock_backlog (trans);
+  }
+  g_ptr_array_unref (transports);
+}
+
+/**
+ * gst_rtsp_session_pool_get_load:
+ * @pool: a #GstRTSPSessionPool
+ * @path: (allow-none): a mount point path or %NULL
+ * @n_transports: (out) (allow-none): the number of active transports
+ * @bitrate: (out) (allow-none): the total bitrate in bits per second
+ * @backlog: (out) (allow-none): the number of messages queued on TCP
+ *    transports
+ *
+ * Get the load caused by the sessions in @pool, or only by the session media
+ * for @path when it is not %NULL. Only transports that are streamed to are
+ * counted; the bitrate is the sum of the measured bitrates of their streams.
+ *
+ * Since: 1.24
+ */
+void
+gst_rtsp_session_pool_get_load (GstRTSPSessionPool * pool, const gchar * path,
+    guint * n_transports, guint64 * bitrate, guint * backlog)
+{
+  GList *sessions, *walk;
+  guint n = 0, b = 0;
+  guint64 rate = 0;
+
+  g_return_if_fail (GST_IS_RTSP_SESSION_POOL (pool));
+
+  sessions = gst_rtsp_session_pool_filter (pool, NULL, NULL);
+  for (walk = sessions; walk; walk = walk->next) {
+    GstRTSPSession *session = walk->data;
+    GList *medias, *m;
+
+    medias = gst_rtsp_session_filter (session, NULL, NULL);
+    for (m = medias; m; m = m->next) {
+      GstRTSPSessionMedia *sessmedia = m->data;
+      gint matched;
+
+      if (path == NULL ||
+          gst_rtsp_session_media_matches (sessmedia, path, &matched))
+        add_session_media_load (sessmedia, &n, &rate, &b);
+    }
+    g_list_free_full (medias, g_object_unref);
+  }
+  g_list_free_full (sessions, g_object_unref);
+
+  if (n_transports)
+    *n_transports = n;
+  if (bitrate)
+    *bitrate = rate;
+  if (backlog)
+    *backlog = b;
+}
+
 /**
  * gst_rtsp_session_pool_get_n_sessions:
  * @pool: a #GstRTSPSessionPool
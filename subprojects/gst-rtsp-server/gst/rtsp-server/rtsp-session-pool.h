@@ -134,6 +134,27 @@ guint                 gst_rtsp_session_pool_get_max_sessions  (GstRTSPSessionPoo
 GST_RTSP_SERVER_API
 guint                 gst_rtsp_session_pool_get_n_sessions    (GstRTSPSessionPool *pool);
 
+/* load accounting */
+
+GST_RTSP_SERVER_API
+void                  gst_rtsp_session_pool_set_max_transports (GstRTSPSessionPool *pool, guint max);
+
+GST_RTSP_SERVER_API
+guint                 gst_rtsp_session_pool_get_max_transports (GstRTSPSessionPool *pool);
+
+GST_RTSP_SERVER_API
+void                  gst_rtsp_session_pool_set_max_bitrate   (GstRTSPSessionPool *pool, guint64 max);
+
+GST_RTSP_SERVER_API
+guint64               gst_rtsp_session_pool_get_max_bitrate   (GstRTSPSessionPool *pool);
+
+GST_RTSP_SERVER_API
+void                  gst_rtsp_session_pool_get_load          (GstRTSPSessionPool *pool,
+                                                               const gchar *path,
+                                                               guint *n_transports,
+                                                               guint64 *bitrate,
+                                                               guint *backlog);
+
 /* managing sessions */
 
 GST_RTSP_SERVER_API
@@ -90,6 +90,8 @@ struct _GstRTSPStreamTransportPrivate
   GstClockTime first_rtp_timestamp;
   GstQueueArray *items;
   GRecMutex backlog_lock;
+  /* dropping delta units until the next keyframe */
+  gboolean drop_delta;
 };
 
 #define MAX_BACKLOG_DURATION (10 * GST_SECOND)
@@ -977,6 +979,81 @@ gst_rtsp_stream_transport_backlog_is_empty (GstRTSPStreamTransport * trans)
   return gst_queue_array_is_empty (trans->priv->items);
 }
 
+/* Not MT-safe, caller should ensure consistent locking.
+ * See gst_rtsp_stream_transport_lock_backlog() */
+guint
+gst_rtsp_stream_transport_backlog_length (GstRTSPStreamTransport * trans)
+{
+  return gst_queue_array_get_length (trans->priv->items);
+}
+
+static gboolean
+drop_delta_unit (GstRTSPStreamTransport * trans, GstBuffer * buffer,
+    guint threshold)
+{
+  GstRTSPStreamTransportPrivate *priv = trans->priv;
+  gboolean behind, drop;
+
+  behind = gst_queue_array_get_length (priv->items) > threshold;
+
+  /* once a delta unit is dropped, all following ones must be dropped too.
+   * Decide again on the next keyframe */
+  if (!GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT))
+    drop = behind;
+  else
+    drop = priv->drop_delta || behind;
+
+  if (drop != priv->drop_delta)
+    GST_DEBUG_OBJECT (trans, "%s dropping until the next keyframe",
+        drop ? "start" : "stop");
+  priv->drop_delta = drop;
+
+  return drop;
+}
+
+/* Not MT-safe, caller should ensure consistent locking (see
+ * gst_rtsp_stream_transport_lock_backlog()). Removes the packets from
+ * @buffer or @buffer_list that should not be queued because more than
+ * @threshold messages are already in the backlog; the rest of the GOP is then
+ * dropped until a keyframe arrives with the backlog below @threshold.
+ * Ownership of @buffer and @buffer_list is transfered in and out, they are
+ * set to %NULL when all packets were dropped */
+void
+gst_rtsp_stream_transport_drop_delta_units (GstRTSPStreamTransport * trans,
+    guint threshold, GstBuffer ** buffer, GstBufferList ** buffer_list)
+{
+  if (*buffer && drop_delta_unit (trans, *buffer, threshold))
+    gst_clear_buffer (buffer);
+
+  if (*buffer_list) {
+    GstBufferList *kept = NULL;
+    guint i, j, len;
+
+    len = gst_buffer_list_length (*buffer_list);
+    for (i = 0; i < len; i++) {
+      GstBuffer *b = gst_buffer_list_get (*buffer_list, i);
+
+      if (drop_delta_unit (trans, b, threshold)) {
+        if (kept == NULL) {
+          kept = gst_buffer_list_new_sized (len);
+          for (j = 0; j < i; j++)
+            gst_buffer_list_add (kept,
+                gst_buffer_ref (gst_buffer_list_get (*buffer_list, j)));
+        }
+      } else if (kept) {
+        gst_buffer_list_add (kept, gst_buffer_ref (b));
+      }
+    }
+
+    if (kept) {
+      gst_buffer_list_unref (*buffer_list);
+      if (gst_buffer_list_length (kept) == 0)
+        gst_clear_buffer_list (&kept);
+      *buffer_list = kept;
+    }
+  }
+}
+
 /* Not MT-safe, caller should ensure consistent locking.
  * See gst_rtsp_stream_transport_lock_backlog() */
 void
@@ -153,6 +153,26 @@ struct _GstRTSPStreamPrivate
   /* rate control */
   gboolean do_rate_control;
 
+  /* TCP backlog length after which delta units are dropped, 0 = never */
+  guint drop_delta_threshold;
+
+  /* updated from the streaming thread on the RTP tee, protected by tee_lock */
+  GMutex tee_lock;
+
+  /* bitrate of the RTP packets, measured over BITRATE_WINDOW */
+  gint64 bitrate_start;
+  guint64 bitrate_bytes;
+  guint64 bitrate;
+
+  /* GOP cache, the RTP packets since the last keyframe that are replayed to
+   * new transports */
+  gboolean gop_cache;
+  GQueue gop_buffers;
+  gboolean have_gop_ssrc;
+  guint32 gop_ssrc;
+  GstSegment gop_segment;
+  GstClockTime gop_running_time;
+
   /* Forward Error Correction with RFC 5109 */
   GstElement *ulpfec_decoder;
   GstElement *ulpfec_encoder;
@@ -240,6 +260,19 @@ struct _GstRTSPStreamPrivate
 #define DEFAULT_BIND_MCAST_ADDRESS FALSE
 #define DEFAULT_DO_RATE_CONTROL TRUE
 #define DEFAULT_ENABLE_RTCP TRUE
+#define DEFAULT_GOP_CACHE FALSE
+
+/* the GOP cache is dropped until the next keyframe when the GOP has more
+ * packets than this */
+#define GOP_CACHE_MAX_PACKETS 8192
+/* how long a GOP cache replay waits for a full socket, in microseconds */
+#define GOP_CACHE_SEND_TIMEOUT (100 * 1000)
+
+#define BITRATE_WINDOW G_USEC_PER_SEC
+
+/* number of packets the TCP sender coalesces into one buffer list for all
+ * TCP transports when it falls behind the stream */
+#define TCP_MAX_BATCH 64
 
 enum
 {
@@ -272,7 +305,7 @@ static void gst_rtsp_stream_finalize (GObject * obj);
 
 static gboolean
 update_transport (GstRTSPStream * stream, GstRTSPStreamTransport * trans,
-    gboolean add);
+    gboolean add, GstBufferList ** udp_replay);
 
 static guint gst_rtsp_stream_signals[SIGNAL_LAST] = { 0 };
 
@@ -340,8 +373,13 @@ gst_rtsp_stream_init (GstRTSPStream * stream)
   priv->bind_mcast_address = DEFAULT_BIND_MCAST_ADDRESS;
   priv->do_rate_control = DEFAULT_DO_RATE_CONTROL;
   priv->enable_rtcp = DEFAULT_ENABLE_RTCP;
+  priv->gop_cache = DEFAULT_GOP_CACHE;
+  g_queue_init (&priv->gop_buffers);
+  gst_segment_init (&priv->gop_segment, GST_FORMAT_TIME);
+  priv->gop_running_time = GST_CLOCK_TIME_NONE;
 
   g_mutex_init (&priv->lock);
+  g_mutex_init (&priv->tee_lock);
 
   priv->continue_sending = TRUE;
   priv->send_cookie = 0;
@@ -435,6 +473,9 @@ gst_rtsp_stream_finalize (GObject * obj)
   g_free (priv->control);
   g_mutex_clear (&priv->lock);
 
+  g_queue_clear_full (&priv->gop_buffers, (GDestroyNotify) gst_buffer_unref);
+  g_mutex_clear (&priv->tee_lock);
+
   g_hash_table_unref (priv->keys);
   g_hash_table_destroy (priv->ptmap);
 
@@ -2629,6 +2670,246 @@ ensure_cached_transports (GstRTSPStream * stream)
   }
 }
 
+/* must be called with tee_lock */
+static void
+gop_cache_clear (GstRTSPStreamPrivate * priv)
+{
+  GstBuffer *buffer;
+
+  while ((buffer = g_queue_pop_head (&priv->gop_buffers)))
+    gst_buffer_unref (buffer);
+  priv->gop_running_time = GST_CLOCK_TIME_NONE;
+}
+
+/* must be called with tee_lock */
+static gboolean
+gop_cache_add (GstRTSPStream * stream, GstBuffer * buffer)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  guint32 ssrc;
+
+  if (!gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp))
+    return TRUE;
+  ssrc = gst_rtp_buffer_get_ssrc (&rtp);
+  gst_rtp_buffer_unmap (&rtp);
+
+  /* skip packets of auxiliary streams like retransmission */
+  if (priv->have_gop_ssrc && ssrc != priv->gop_ssrc)
+    return TRUE;
+
+  if (!GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    /* first packet of a keyframe, start a new GOP */
+    gop_cache_clear (priv);
+    priv->gop_running_time = gst_segment_to_running_time (&priv->gop_segment,
+        GST_FORMAT_TIME, GST_BUFFER_PTS (buffer));
+  } else if (g_queue_is_empty (&priv->gop_buffers)) {
+    /* waiting for a keyframe */
+    return TRUE;
+  }
+
+  if (priv->gop_buffers.length >= GOP_CACHE_MAX_PACKETS) {
+    GST_DEBUG_OBJECT (stream, "GOP too large, dropping cache");
+    gop_cache_clear (priv);
+    return TRUE;
+  }
+
+  g_queue_push_tail (&priv->gop_buffers, gst_buffer_ref (buffer));
+
+  return TRUE;
+}
+
+static gboolean
+gop_cache_add_list_func (GstBuffer ** buffer, guint idx, gpointer user_data)
+{
+  return gop_cache_add (GST_RTSP_STREAM (user_data), *buffer);
+}
+
+/* must be called with tee_lock */
+static void
+update_bitrate (GstRTSPStreamPrivate * priv, gsize size)
+{
+  gint64 now = g_get_monotonic_time ();
+
+  if (priv->bitrate_start == 0) {
+    priv->bitrate_start = now;
+  } else if (now - priv->bitrate_start >= BITRATE_WINDOW) {
+    priv->bitrate = gst_util_uint64_scale (priv->bitrate_bytes * 8,
+        G_USEC_PER_SEC, now - priv->bitrate_start);
+    priv->bitrate_start = now;
+    priv->bitrate_bytes = 0;
+  }
+  priv->bitrate_bytes += size;
+}
+
+static GstPadProbeReturn
+tee_probe (GstPad * pad, GstPadProbeInfo * info, gpointer user_data)
+{
+  GstRTSPStream *stream = GST_RTSP_STREAM (user_data);
+  GstRTSPStreamPrivate *priv = stream->priv;
+
+  g_mutex_lock (&priv->tee_lock);
+  if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER)
+    update_bitrate (priv, gst_buffer_get_size (GST_PAD_PROBE_INFO_BUFFER
+            (info)));
+  else if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER_LIST)
+    update_bitrate (priv,
+        gst_buffer_list_calculate_size (GST_PAD_PROBE_INFO_BUFFER_LIST
+            (info)));
+
+  if (!priv->gop_cache)
+    goto done;
+
+  if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    gop_cache_add (stream, GST_PAD_PROBE_INFO_BUFFER (info));
+  } else if (GST_PAD_PROBE_INFO_TYPE (info) & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    gst_buffer_list_foreach (GST_PAD_PROBE_INFO_BUFFER_LIST (info),
+        gop_cache_add_list_func, stream);
+  } else if (GST_PAD_PROBE_INFO_TYPE (info) &
+      (GST_PAD_PROBE_TYPE_EVENT_BOTH | GST_PAD_PROBE_TYPE_EVENT_FLUSH)) {
+    GstEvent *event = GST_PAD_PROBE_INFO_EVENT (info);
+
+    switch (GST_EVENT_TYPE (event)) {
+      case GST_EVENT_CAPS:
+      {
+        GstCaps *caps;
+        GstStructure *s;
+
+        gst_event_parse_caps (event, &caps);
+        s = gst_caps_get_structure (caps, 0);
+        priv->have_gop_ssrc = gst_structure_get_uint (s, "ssrc",
+            &priv->gop_ssrc);
+        break;
+      }
+      case GST_EVENT_SEGMENT:
+        gst_event_copy_segment (event, &priv->gop_segment);
+        break;
+      case GST_EVENT_FLUSH_STOP:
+        gop_cache_clear (priv);
+        break;
+      default:
+        break;
+    }
+  }
+
+done:
+  g_mutex_unlock (&priv->tee_lock);
+
+  return GST_PAD_PROBE_OK;
+}
+
+static GstBufferList *
+gop_cache_get_list (GstRTSPStream * stream)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  GstBufferList *list = NULL;
+  GList *walk;
+
+  g_mutex_lock (&priv->tee_lock);
+  if (priv->gop_cache && !g_queue_is_empty (&priv->gop_buffers)) {
+    list = gst_buffer_list_new_sized (priv->gop_buffers.length);
+    for (walk = priv->gop_buffers.head; walk; walk = walk->next)
+      gst_buffer_list_add (list, gst_buffer_ref (walk->data));
+  }
+  g_mutex_unlock (&priv->tee_lock);
+
+  return list;
+}
+
+typedef struct
+{
+  GstRTSPStream *stream;
+  GSocket *socket;
+  GSocketAddress *addr;
+} GopCacheReplay;
+
+/* Send one cached packet. The socket is shared with the udpsink, so wait
+ * for it to become writable again when it is full. Other errors only lose
+ * this packet, the rest of the GOP is still sent */
+static gboolean
+gop_cache_send_func (GstBuffer ** buffer, guint idx, gpointer user_data)
+{
+  GopCacheReplay *replay = user_data;
+  GstMapInfo map;
+  GError *err = NULL;
+  gboolean res = TRUE;
+
+  if (!gst_buffer_map (*buffer, &map, GST_MAP_READ))
+    return TRUE;
+
+  while (g_socket_send_to (replay->socket, replay->addr,
+          (const gchar *) map.data, map.size, NULL, &err) < 0) {
+    if (g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK) &&
+        g_socket_condition_timed_wait (replay->socket, G_IO_OUT,
+            GOP_CACHE_SEND_TIMEOUT, NULL)) {
+      g_clear_error (&err);
+      continue;
+    }
+
+    GST_DEBUG_OBJECT (replay->stream, "failed to send cached packet %u: %s",
+        idx, err->message);
+    /* give up when the socket stays full, the client gets live data */
+    res = !g_error_matches (err, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK);
+    g_clear_error (&err);
+    break;
+  }
+  gst_buffer_unmap (*buffer, &map);
+
+  return res;
+}
+
+/* Queue the GOP cache in the backlog of a newly added TCP transport before
+ * any live packet so that it can start decoding without waiting for the
+ * next keyframe. Must be called with lock */
+static void
+gop_cache_replay_tcp (GstRTSPStream * stream, GstRTSPStreamTransport * trans)
+{
+  GstBufferList *list;
+
+  if (!(list = gop_cache_get_list (stream)))
+    return;
+
+  GST_DEBUG_OBJECT (stream, "replaying %u cached packets to TCP transport",
+      gst_buffer_list_length (list));
+
+  gst_rtsp_stream_transport_lock_backlog (trans);
+  if (!gst_rtsp_stream_transport_backlog_push (trans, NULL, list, TRUE))
+    GST_WARNING_OBJECT (stream, "backlog full after replaying GOP cache");
+  gst_rtsp_stream_transport_unlock_backlog (trans);
+}
+
+/* Send @list from the GOP cache directly on the RTP socket of the stream to
+ * a new UDP client, before it gets added to the udpsink for live packets.
+ * Must be called *without* priv->lock as this might wait for the socket */
+static void
+gop_cache_replay_udp (GstRTSPStream * stream, GstBufferList * list,
+    const gchar * dest, gint port)
+{
+  GstRTSPStreamPrivate *priv = stream->priv;
+  GopCacheReplay replay = { stream, NULL, NULL };
+
+  replay.addr = g_inet_socket_address_new_from_string (dest, port);
+  if (!replay.addr)
+    return;
+
+  g_mutex_lock (&priv->lock);
+  if (g_socket_address_get_family (replay.addr) == G_SOCKET_FAMILY_IPV6)
+    replay.socket = priv->socket_v6[0];
+  else
+    replay.socket = priv->socket_v4[0];
+  if (replay.socket)
+    g_object_ref (replay.socket);
+  g_mutex_unlock (&priv->lock);
+
+  if (replay.socket) {
+    GST_DEBUG_OBJECT (stream, "replaying %u cached packets to %s:%d",
+        gst_buffer_list_length (list), dest, port);
+    gst_buffer_list_foreach (list, gop_cache_send_func, &replay);
+    g_object_unref (replay.socket);
+  }
+  g_object_unref (replay.addr);
+}
+
 /* Must be called *without* priv->lock */
 static void
 check_transport_backlog (GstRTSPStream * stream, GstRTSPStreamTransport * trans)
@@ -2665,21 +2946,44 @@ check_transport_backlog (GstRTSPStream * stream, GstRTSPStreamTransport * trans)
   if (!send_ret) {
     /* remove transport on send error */
     g_mutex_lock (&priv->lock);
-    update_transport (stream, trans, FALSE);
+    update_transport (stream, trans, FALSE, NULL);
     g_mutex_unlock (&priv->lock);
   }
 }
 
+static guint
+add_sample_to_batch (GstBufferList * batch, GstSample * sample)
+{
+  GstBuffer *buffer = gst_sample_get_buffer (sample);
+  GstBufferList *buffer_list = gst_sample_get_buffer_list (sample);
+  guint i, n = 0;
+
+  if (buffer) {
+    gst_buffer_list_add (batch, gst_buffer_ref (buffer));
+    n++;
+  }
+  if (buffer_list) {
+    for (i = 0; i < gst_buffer_list_length (buffer_list); i++) {
+      gst_buffer_list_add (batch,
+          gst_buffer_ref (gst_buffer_list_get (buffer_list, i)));
+      n++;
+    }
+  }
+
+  return n;
+}
+
 /* Must be called with priv->lock */
 static void
 send_tcp_message (GstRTSPStream * stream, gint idx)
 {
   GstRTSPStreamPrivate *priv = stream->priv;
   GstAppSink *sink;
-  GstSample *sample;
+  GstSample *sample, *next;
   GstBuffer *buffer;
-  GstBufferList *buffer_list;
-  gboolean is_rtp;
+  GstBufferList *buffer_list, *batch = NULL;
+  guint n_packets;
+  gboolean is_rtp, more = FALSE;
   GPtrArray *transports;
 
   if (!priv->have_buffer[idx])
@@ -2700,13 +3004,43 @@ send_tcp_message (GstRTSPStream * stream, gint idx)
   }
 
   sink = GST_APP_SINK (priv->appsink[idx]);
-  sample = gst_app_sink_pull_sample (sink);
+  /* don't block, earlier samples might have been pulled as part of a batch
+   * before their new-sample callback ran */
+  sample = gst_app_sink_try_pull_sample (sink, 0);
   if (!sample) {
     return;
   }
 
   buffer = gst_sample_get_buffer (sample);
   buffer_list = gst_sample_get_buffer_list (sample);
+  n_packets = buffer ? 1 : (buffer_list ? gst_buffer_list_length (buffer_list) :
+      0);
+
+  /* more samples are queued when we are behind, send all of them as one
+   * list so that every client only gets one write for them */
+  while (n_packets < TCP_MAX_BATCH &&
+      (next = gst_app_sink_try_pull_sample (sink, 0))) {
+    if (!batch) {
+      batch = gst_buffer_list_new_sized (TCP_MAX_BATCH);
+      add_sample_to_batch (batch, sample);
+    }
+    n_packets += add_sample_to_batch (batch, next);
+    gst_sample_unref (next);
+  }
+
+  /* the batch is full but appsink might still have samples, their
+   * new-sample callbacks already ran so send them without waiting for the
+   * next one, which might never come at EOS or when the input pauses */
+  if (n_packets >= TCP_MAX_BATCH) {
+    priv->have_buffer[idx] = TRUE;
+    more = TRUE;
+  }
+
+  if (batch) {
+    GST_LOG_OBJECT (stream, "sending batch of %u packets", n_packets);
+    buffer = NULL;
+    buffer_list = batch;
+  }
 
   /* We will get one message-sent notification per buffer or
    * complete buffer-list. We handle each buffer-list as a unit */
@@ -2730,20 +3064,34 @@ send_tcp_message (GstRTSPStream * stream, gint idx)
       if (buffer_list)
         buflist_ref = gst_buffer_list_ref (buffer_list);
 
-      if (!gst_rtsp_stream_transport_backlog_push (tr,
+      /* shed load on slow clients before they have to be dropped */
+      if (is_rtp && priv->drop_delta_threshold > 0)
+        gst_rtsp_stream_transport_drop_delta_units (tr,
+            priv->drop_delta_threshold, &buf_ref, &buflist_ref);
+
+      if ((buf_ref || buflist_ref) &&
+          !gst_rtsp_stream_transport_backlog_push (tr,
               buf_ref, buflist_ref, is_rtp)) {
         GST_ERROR_OBJECT (stream,
             "Dropping slow transport %" GST_PTR_FORMAT, tr);
-        update_transport (stream, tr, FALSE);
+        update_transport (stream, tr, FALSE, NULL);
       }
 
       gst_rtsp_stream_transport_unlock_backlog (tr);
     }
   }
+  gst_clear_buffer_list (&batch);
   gst_sample_unref (sample);
 
   g_mutex_unlock (&priv->lock);
 
+  if (more) {
+    g_mutex_lock (&priv->send_lock);
+    priv->send_cookie++;
+    g_cond_signal (&priv->send_cond);
+    g_mutex_unlock (&priv->send_lock);
+  }
+
   if (transports) {
     gint index;
 
@@ -3616,6 +3964,14 @@ create_sender_part (GstRTSPStream * stream, const GstRTSPTransport * transport)
       priv->tee[i] = gst_element_factory_make ("tee", NULL);
       gst_bin_add (bin, priv->tee[i]);
       link_tee = TRUE;
+
+      if (i == 0) {
+        GstPad *teepad = gst_element_get_static_pad (priv->tee[i], "sink");
+
+        gst_pad_add_probe (teepad, GST_PAD_PROBE_TYPE_DATA_DOWNSTREAM |
+            GST_PAD_PROBE_TYPE_EVENT_FLUSH, tee_probe, stream, NULL);
+        gst_object_unref (teepad);
+      }
     }
 
     if (is_udp && !priv->udpsink[i]) {
@@ -3633,7 +3989,7 @@ create_sender_part (GstRTSPStream * stream, const GstRTSPTransport * transport)
       /* make appsink */
       priv->appsink[i] = gst_element_factory_make ("appsink", NULL);
       g_object_set (priv->appsink[i], "emit-signals", FALSE, "buffer-list",
-          TRUE, "max-buffers", 1, NULL);
+          TRUE, "max-buffers", TCP_MAX_BATCH, NULL);
 
       if (i == 0)
         g_object_set (priv->appsink[i], "sync", priv->do_rate_control, NULL);
@@ -4134,6 +4490,13 @@ gst_rtsp_stream_leave_bin (GstRTSPStream * stream, GstBin * bin,
 
   priv->joined_bin = NULL;
 
+  g_mutex_lock (&priv->tee_lock);
+  gop_cache_clear (priv);
+  priv->bitrate_start = 0;
+  priv->bitrate_bytes = 0;
+  priv->bitrate = 0;
+  g_mutex_unlock (&priv->tee_lock);
+
   /* all transports must be removed by now */
   if (priv->transports != NULL)
     goto transports_not_removed;
@@ -4439,6 +4802,24 @@ stats:
   }
 
 done:
+  /* new transports start with the replayed GOP cache */
+  g_mutex_lock (&priv->tee_lock);
+  if (priv->gop_cache && !g_queue_is_empty (&priv->gop_buffers)) {
+    GstRTPBuffer rtp_buffer = GST_RTP_BUFFER_INIT;
+
+    if (gst_rtp_buffer_map (g_queue_peek_head (&priv->gop_buffers),
+            GST_MAP_READ, &rtp_buffer)) {
+      if (seq)
+        *seq = gst_rtp_buffer_get_seq (&rtp_buffer);
+      if (rtptime)
+        *rtptime = gst_rtp_buffer_get_timestamp (&rtp_buffer);
+      if (running_time && GST_CLOCK_TIME_IS_VALID (*running_time))
+        *running_time = priv->gop_running_time;
+      gst_rtp_buffer_unmap (&rtp_buffer);
+    }
+  }
+  g_mutex_unlock (&priv->tee_lock);
+
   g_mutex_unlock (&priv->lock);
 
   return TRUE;
@@ -4699,10 +5080,12 @@ remove_client (GstElement * rtp_sink, GstElement * rtcp_sink,
     g_signal_emit_by_name (rtcp_sink, "remove", host, rtcp_port, NULL);
 }
 
-/* must be called with lock */
+/* must be called with lock. When adding a UDP transport with @udp_replay,
+ * the cached GOP is returned in it instead of adding the client to the
+ * udpsink, the caller has to replay it and add the client afterwards */
 static gboolean
 update_transport (GstRTSPStream * stream, GstRTSPStreamTransport * trans,
-    gboolean add)
+    gboolean add, GstBufferList ** udp_replay)
 {
   GstRTSPStreamPrivate *priv = stream->priv;
   const GstRTSPTransport *tr;
@@ -4768,7 +5151,8 @@ update_transport (GstRTSPStream * stream, GstRTSPStreamTransport * trans,
 
       if (add) {
         GST_INFO ("adding %s:%d-%d", dest, min, max);
-        add_client (priv->udpsink[0], priv->udpsink[1], dest, min, max);
+        if (!udp_replay || !(*udp_replay = gop_cache_get_list (stream)))
+          add_client (priv->udpsink[0], priv->udpsink[1], dest, min, max);
         priv->transports = g_list_prepend (priv->transports, trans);
       } else {
         GST_INFO ("removing %s:%d-%d", dest, min, max);
@@ -4783,6 +5167,7 @@ update_transport (GstRTSPStream * stream, GstRTSPStreamTransport * trans,
         GST_INFO ("adding TCP %s", tr->destination);
         priv->transports = g_list_prepend (priv->transports, trans);
         priv->n_tcp_transports++;
+        gop_cache_replay_tcp (stream, trans);
       } else {
         GST_INFO ("removing TCP %s", tr->destination);
         priv->transports = g_list_delete_link (priv->transports, tr_element);
@@ -4848,6 +5233,8 @@ gst_rtsp_stream_add_transport (GstRTSPStream * stream,
     GstRTSPStreamTransport * trans)
 {
   GstRTSPStreamPrivate *priv;
+  const GstRTSPTransport *tr;
+  GstBufferList *replay = NULL;
   gboolean res;
 
   g_return_val_if_fail (GST_IS_RTSP_STREAM (stream), FALSE);
@@ -4856,12 +5243,42 @@ gst_rtsp_stream_add_transport (GstRTSPStream * stream,
   g_return_val_if_fail (priv->joined_bin != NULL, FALSE);
 
   g_mutex_lock (&priv->lock);
-  res = update_transport (stream, trans, TRUE);
+  res = update_transport (stream, trans, TRUE, &replay);
   if (res)
     gst_rtsp_stream_transport_set_message_sent_full (trans, on_message_sent,
         stream, NULL);
   g_mutex_unlock (&priv->lock);
 
+  if (!res)
+    return FALSE;
+
+  tr = gst_rtsp_stream_transport_get_transport (trans);
+  if (tr->lower_transport == GST_RTSP_LOWER_TRANS_TCP) {
+    /* start sending a replayed GOP cache without waiting for live data */
+    check_transport_backlog (stream, trans);
+  } else if (replay) {
+    gint min, max;
+
+    if (priv->client_side) {
+      min = tr->server_port.min;
+      max = tr->server_port.max;
+    } else {
+      min = tr->client_port.min;
+      max = tr->client_port.max;
+    }
+
+    /* live packets only go to the client once the older replayed ones were
+     * sent, unless it was removed in the meantime */
+    gop_cache_replay_udp (stream, replay, tr->destination, min);
+    gst_buffer_list_unref (replay);
+
+    g_mutex_lock (&priv->lock);
+    if (g_list_find (priv->transports, trans))
+      add_client (priv->udpsink[0], priv->udpsink[1], tr->destination, min,
+          max);
+    g_mutex_unlock (&priv->lock);
+  }
+
   return res;
 }
 
@@ -4892,7 +5309,7 @@ gst_rtsp_stream_remove_transport (GstRTSPStream * stream,
   g_return_val_if_fail (priv->joined_bin != NULL, FALSE);
 
   g_mutex_lock (&priv->lock);
-  res = update_transport (stream, trans, FALSE);
+  res = update_transport (stream, trans, FALSE, NULL);
   g_mutex_unlock (&priv->lock);
 
   return res;
@@ -5281,7 +5698,7 @@ restart:
 
     switch (res) {
       case GST_RTSP_FILTER_REMOVE:
-        update_transport (stream, trans, FALSE);
+        update_transport (stream, trans, FALSE, NULL);
         break;
       case GST_RTSP_FILTER_REF:
         result = g_list_prepend (result, g_object_ref (trans));
@@ -6382,6 +6799,162 @@ gst_rtsp_stream_get_rate_control (GstRTSPStream * stream)
   return ret;
 }
 
+/**
+ * gst_rtsp_stream_set_gop_cache:
+ * @stream: a #GstRTSPStream
+ * @enabled: whether to cache the last GOP
+ *
+ * Define whether @stream keeps the RTP packets since the last keyframe and
+ * sends them to new unicast transports when they are added, so that new
+ * clients of a shared live media can start decoding without waiting for the
+ * next keyframe. The first packet of a keyframe is detected as a packet
+ * without the %GST_BUFFER_FLAG_DELTA_UNIT flag.
+ *
+ * The cached packets are sent with their original sequence numbers and
+ * timestamps, the RTP-Info of @stream then refers to the first cached packet.
+ * UDP clients only get live packets once the cached ones were sent.
+ *
+ * Since: 1.24
+ */
+void
+gst_rtsp_stream_set_gop_cache (GstRTSPStream * stream, gboolean enabled)
+{
+  GstRTSPStreamPrivate *priv;
+
+  g_return_if_fail (GST_IS_RTSP_STREAM (stream));
+
+  priv = stream->priv;
+
+  GST_DEBUG_OBJECT (stream, "%s GOP cache", enabled ? "Enabling" : "Disabling");
+
+  g_mutex_lock (&priv->tee_lock);
+  priv->gop_cache = enabled;
+  if (!enabled)
+    gop_cache_clear (priv);
+  g_mutex_unlock (&priv->tee_lock);
+}
+
+/**
+ * gst_rtsp_stream_get_gop_cache:
+ * @stream: a #GstRTSPStream
+ *
+ * Returns: whether @stream replays the last GOP to new transports.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_rtsp_stream_get_gop_cache (GstRTSPStream * stream)
+{
+  GstRTSPStreamPrivate *priv;
+  gboolean ret;
+
+  g_return_val_if_fail (GST_IS_RTSP_STREAM (stream), FALSE);
+
+  priv = stream->priv;
+
+  g_mutex_lock (&priv->tee_lock);
+  ret = priv->gop_cache;
+  g_mutex_unlock (&priv->tee_lock);
+
+  return ret;
+}
+
+/**
+ * gst_rtsp_stream_get_bitrate:
+ * @stream: a #GstRTSPStream
+ *
+ * Get the bitrate of the RTP packets that @stream sends to each of its
+ * transports, measured over the last second.
+ *
+ * Returns: the bitrate in bits per second, 0 when the stream is not
+ * streaming.
+ *
+ * Since: 1.24
+ */
+guint64
+gst_rtsp_stream_get_bitrate (GstRTSPStream * stream)
+{
+  GstRTSPStreamPrivate *priv;
+  guint64 ret;
+
+  g_return_val_if_fail (GST_IS_RTSP_STREAM (stream), 0);
+
+  priv = stream->priv;
+
+  g_mutex_lock (&priv->tee_lock);
+  if (priv->bitrate_start != 0 &&
+      g_get_monotonic_time () - priv->bitrate_start < 2 * BITRATE_WINDOW)
+    ret = priv->bitrate;
+  else
+    ret = 0;
+  g_mutex_unlock (&priv->tee_lock);
+
+  return ret;
+}
+
+/**
+ * gst_rtsp_stream_set_drop_delta_threshold:
+ * @stream: a #GstRTSPStream
+ * @threshold: the backlog length in messages, 0 to disable
+ *
+ * Define the length of the send backlog of a TCP transport after which
+ * @stream stops queueing delta units for it and drops the rest of the GOP,
+ * resuming with the next keyframe that arrives when the backlog is below
+ * @threshold again. This sheds load on the slowest clients before they have
+ * to be disconnected.
+ *
+ * Since: 1.24
+ */
+void
+gst_rtsp_stream_set_drop_delta_threshold (GstRTSPStream * stream,
+    guint threshold)
+{
+  g_return_if_fail (GST_IS_RTSP_STREAM (stream));
+
+  GST_DEBUG_OBJECT (stream, "drop delta threshold %u", threshold);
+
+  g_mutex_lock (&stream->priv->lock);
+  stream->priv->drop_delta_threshold = threshold;
+  g_mutex_unlock (&stream->priv->lock);
+}
+
+/**
+ * gst_rtsp_stream_get_drop_delta_threshold:
+ * @stream: a #GstRTSPStream
+ *
+ * Returns: the TCP backlog length after which delta units are dropped, 0 if
+ * they are never dropped.
+ *
+ * Since: 1.24
+ */
+guint
+gst_rtsp_stream_get_drop_delta_threshold (GstRTSPStream * stream)
+{
+  guint ret;
+
+  g_return_val_if_fail (GST_IS_RTSP_STREAM (stream), 0);
+
+  g_mutex_lock (&stream->priv->lock);
+  ret = stream->priv->drop_delta_threshold;
+  g_mutex_unlock (&stream->priv->lock);
+
+  return ret;
+}
+
+/* whether @trans is currently streamed to */
+gboolean
+gst_rtsp_stream_has_transport (GstRTSPStream * stream,
+    GstRTSPStreamTransport * trans)
+{
+  gboolean ret;
+
+  g_mutex_lock (&stream->priv->lock);
+  ret = g_list_find (stream->priv->transports, trans) != NULL;
+  g_mutex_unlock (&stream->priv->lock);
+
+  return ret;
+}
+
 /**
  * gst_rtsp_stream_unblock_rtcp:
  *
@@ -365,6 +365,21 @@ void               gst_rtsp_stream_set_rate_control (GstRTSPStream * stream, gbo
 GST_RTSP_SERVER_API
 gboolean           gst_rtsp_stream_get_rate_control (GstRTSPStream * stream);
 
+GST_RTSP_SERVER_API
+void               gst_rtsp_stream_set_gop_cache (GstRTSPStream * stream, gboolean enabled);
+
+GST_RTSP_SERVER_API
+gboolean           gst_rtsp_stream_get_gop_cache (GstRTSPStream * stream);
+
+GST_RTSP_SERVER_API
+guint64            gst_rtsp_stream_get_bitrate (GstRTSPStream * stream);
+
+GST_RTSP_SERVER_API
+void               gst_rtsp_stream_set_drop_delta_threshold (GstRTSPStream * stream, guint threshold);
+
+GST_RTSP_SERVER_API
+guint              gst_rtsp_stream_get_drop_delta_threshold (GstRTSPStream * stream);
+
 GST_RTSP_SERVER_API
 void               gst_rtsp_stream_unblock_rtcp (GstRTSPStream * stream);
 
@@ -420,6 +420,161 @@ GST_START_TEST (test_allow_bind_mcast)
 
 GST_END_TEST;
 
+GST_START_TEST (test_media_pool)
+{
+  GstRTSPMediaFactory *factory;
+  GstRTSPMedia *media;
+  GstRTSPUrl *url;
+  GstRTSPThreadPool *pool;
+  GstRTSPThread *thread;
+  gint i;
+
+  factory = gst_rtsp_media_factory_new ();
+  gst_rtsp_media_factory_set_launch (factory,
+      "( videotestsrc ! rtpvrawpay pt=96 name=pay0 )");
+  fail_unless_equals_int (gst_rtsp_media_factory_get_media_pool_size (factory),
+      0);
+  fail_unless_equals_int (gst_rtsp_media_factory_get_media_pool_expiry
+      (factory), 0);
+  gst_rtsp_media_factory_set_media_pool_size (factory, 1);
+  fail_unless_equals_int (gst_rtsp_media_factory_get_media_pool_size (factory),
+      1);
+  fail_unless (gst_rtsp_url_parse ("rtsp://localhost:8554/test",
+          &url) == GST_RTSP_OK);
+
+  /* the pool is only filled once the url was requested */
+  media = gst_rtsp_media_factory_construct (factory, url);
+  fail_unless (GST_IS_RTSP_MEDIA (media));
+  fail_unless (gst_rtsp_media_get_status (media) ==
+      GST_RTSP_MEDIA_STATUS_UNPREPARED);
+  g_object_unref (media);
+
+  /* wait for the background thread to prepare one */
+  for (i = 0; i < 100; i++) {
+    media = gst_rtsp_media_factory_construct (factory, url);
+    fail_unless (GST_IS_RTSP_MEDIA (media));
+    if (gst_rtsp_media_get_status (media) == GST_RTSP_MEDIA_STATUS_PREPARED)
+      break;
+    g_object_unref (media);
+    media = NULL;
+    g_usleep (G_USEC_PER_SEC / 20);
+  }
+  fail_unless (media != NULL);
+
+  /* users prepare and unprepare it like any other media */
+  pool = gst_rtsp_thread_pool_new ();
+  thread = gst_rtsp_thread_pool_get_thread (pool,
+      GST_RTSP_THREAD_TYPE_MEDIA, NULL);
+  fail_unless (gst_rtsp_media_prepare (media, thread));
+  fail_unless (gst_rtsp_media_unprepare (media));
+  fail_unless (gst_rtsp_media_get_status (media) ==
+      GST_RTSP_MEDIA_STATUS_UNPREPARED);
+  g_object_unref (media);
+
+  gst_rtsp_media_factory_set_media_pool_size (factory, 0);
+  gst_rtsp_url_free (url);
+
+  /* a refill might still be running and keep the factory alive */
+  g_object_add_weak_pointer (G_OBJECT (factory), (gpointer *) & factory);
+  g_object_unref (factory);
+  for (i = 0; factory != NULL && i < 100; i++)
+    g_usleep (G_USEC_PER_SEC / 20);
+  fail_unless (factory == NULL);
+
+  g_object_unref (pool);
+  gst_rtsp_thread_pool_cleanup ();
+}
+
+GST_END_TEST;
+
+static GMutex constructed_lock;
+
+static void
+media_constructed_cb (GstRTSPMediaFactory * factory, GstRTSPMedia * media,
+    GPtrArray * medias)
+{
+  g_mutex_lock (&constructed_lock);
+  g_ptr_array_add (medias, g_object_ref (media));
+  g_mutex_unlock (&constructed_lock);
+}
+
+static GstRTSPMedia *
+get_constructed_media (GPtrArray * medias, guint idx)
+{
+  GstRTSPMedia *media = NULL;
+
+  g_mutex_lock (&constructed_lock);
+  if (idx < medias->len)
+    media = g_object_ref (g_ptr_array_index (medias, idx));
+  g_mutex_unlock (&constructed_lock);
+
+  return media;
+}
+
+GST_START_TEST (test_media_pool_expiry)
+{
+  GstRTSPMediaFactory *factory;
+  GstRTSPMedia *media, *pooled = NULL;
+  GstRTSPUrl *url1, *url2;
+  GPtrArray *medias;
+  gint i;
+
+  medias = g_ptr_array_new_with_free_func (g_object_unref);
+  factory = gst_rtsp_media_factory_new ();
+  gst_rtsp_media_factory_set_launch (factory,
+      "( videotestsrc ! rtpvrawpay pt=96 name=pay0 )");
+  gst_rtsp_media_factory_set_media_pool_size (factory, 1);
+  gst_rtsp_media_factory_set_media_pool_expiry (factory, 1);
+  g_signal_connect (factory, "media-constructed",
+      G_CALLBACK (media_constructed_cb), medias);
+  fail_unless (gst_rtsp_url_parse ("rtsp://localhost:8554/test1",
+          &url1) == GST_RTSP_OK);
+  fail_unless (gst_rtsp_url_parse ("rtsp://localhost:8554/test2",
+          &url2) == GST_RTSP_OK);
+
+  /* the first media is not pooled, the second one is prepared for the pool
+   * of the first url */
+  media = gst_rtsp_media_factory_construct (factory, url1);
+  fail_unless (GST_IS_RTSP_MEDIA (media));
+  g_object_unref (media);
+
+  for (i = 0; i < 100; i++) {
+    pooled = get_constructed_media (medias, 1);
+    if (pooled &&
+        gst_rtsp_media_get_status (pooled) == GST_RTSP_MEDIA_STATUS_PREPARED)
+      break;
+    g_clear_object (&pooled);
+    g_usleep (G_USEC_PER_SEC / 20);
+  }
+  fail_unless (pooled != NULL);
+
+  /* the first url is never requested again, its pooled media still gets
+   * unprepared once expired */
+  g_usleep (G_USEC_PER_SEC + G_USEC_PER_SEC / 2);
+  media = gst_rtsp_media_factory_construct (factory, url2);
+  fail_unless (GST_IS_RTSP_MEDIA (media));
+  g_object_unref (media);
+  fail_unless (gst_rtsp_media_get_status (pooled) ==
+      GST_RTSP_MEDIA_STATUS_UNPREPARED);
+  g_object_unref (pooled);
+
+  gst_rtsp_media_factory_set_media_pool_size (factory, 0);
+  gst_rtsp_url_free (url1);
+  gst_rtsp_url_free (url2);
+
+  /* a refill might still be running and keep the factory alive */
+  g_object_add_weak_pointer (G_OBJECT (factory), (gpointer *) & factory);
+  g_object_unref (factory);
+  for (i = 0; factory != NULL && i < 100; i++)
+    g_usleep (G_USEC_PER_SEC / 20);
+  fail_unless (factory == NULL);
+
+  g_ptr_array_unref (medias);
+  gst_rtsp_thread_pool_cleanup ();
+}
+
+GST_END_TEST;
+
 static Suite *
 rtspmediafactory_suite (void)
 {
@@ -437,6 +592,8 @@ rtspmediafactory_suite (void)
   tcase_add_test (tc, test_reset);
   tcase_add_test (tc, test_mcast_ttl);
   tcase_add_test (tc, test_allow_bind_mcast);
+  tcase_add_test (tc, test_media_pool);
+  tcase_add_test (tc, test_media_pool_expiry);
 
   return s;
 }
@@ -187,6 +187,44 @@ GST_START_TEST (test_pool)
 
 GST_END_TEST;
 
+GST_START_TEST (test_load)
+{
+  GstRTSPSessionPool *pool;
+  GstRTSPSession *session;
+  guint n_transports = 1, backlog = 1;
+  guint64 bitrate = 1, max_bitrate;
+
+  pool = gst_rtsp_session_pool_new ();
+  fail_unless_equals_int (gst_rtsp_session_pool_get_max_transports (pool), 0);
+  fail_unless (gst_rtsp_session_pool_get_max_bitrate (pool) == 0);
+
+  gst_rtsp_session_pool_set_max_transports (pool, 10);
+  fail_unless_equals_int (gst_rtsp_session_pool_get_max_transports (pool), 10);
+  g_object_set (pool, "max-bitrate", G_GUINT64_CONSTANT (2000000), NULL);
+  g_object_get (pool, "max-bitrate", &max_bitrate, NULL);
+  fail_unless (max_bitrate == 2000000);
+
+  /* sessions without media don't add any load */
+  session = gst_rtsp_session_pool_create (pool);
+  fail_unless (GST_IS_RTSP_SESSION (session));
+
+  gst_rtsp_session_pool_get_load (pool, NULL, &n_transports, &bitrate,
+      &backlog);
+  fail_unless_equals_int (n_transports, 0);
+  fail_unless (bitrate == 0);
+  fail_unless_equals_int (backlog, 0);
+
+  n_transports = 1;
+  gst_rtsp_session_pool_get_load (pool, "/test", &n_transports, NULL, NULL);
+  fail_unless_equals_int (n_transports, 0);
+
+  fail_unless (gst_rtsp_session_pool_remove (pool, session));
+  g_object_unref (session);
+  g_object_unref (pool);
+}
+
+GST_END_TEST;
+
 static Suite *
 rtspsessionpool_suite (void)
 {
@@ -196,6 +234,7 @@ rtspsessionpool_suite (void)
   suite_add_tcase (s, tc);
   tcase_set_timeout (tc, 15);
   tcase_add_test (tc, test_pool);
+  tcase_add_test (tc, test_load);
 
   return s;
 }
@@ -18,6 +18,7 @@
  */
 
 #include <gst/check/gstcheck.h>
+#include <gst/rtp/gstrtpbuffer.h>
 
 #include <rtsp-stream.h>
 #include <rtsp-address-pool.h>
@@ -653,6 +654,199 @@ GST_START_TEST (test_remove_transport_twice)
 
 GST_END_TEST;
 
+GST_START_TEST (test_gop_cache)
+{
+  GstPad *srcpad;
+  GstElement *pay;
+  GstRTSPStream *stream;
+  GstBin *bin;
+  GstElement *rtpbin;
+  GstRTSPTransport *transport;
+  GstRTSPStreamTransport *tr;
+
+  srcpad = gst_pad_new ("testsrcpad", GST_PAD_SRC);
+  fail_unless (srcpad != NULL);
+  gst_pad_set_active (srcpad, TRUE);
+  pay = gst_element_factory_make ("rtpgstpay", "testpayloader");
+  fail_unless (pay != NULL);
+  stream = gst_rtsp_stream_new (0, pay, srcpad);
+  fail_unless (stream != NULL);
+  gst_object_unref (pay);
+  gst_object_unref (srcpad);
+  rtpbin = gst_element_factory_make ("rtpbin", "testrtpbin");
+  fail_unless (rtpbin != NULL);
+  bin = GST_BIN (gst_bin_new ("testbin"));
+  fail_unless (bin != NULL);
+  fail_unless (gst_bin_add (bin, rtpbin));
+
+  fail_if (gst_rtsp_stream_get_gop_cache (stream));
+  gst_rtsp_stream_set_gop_cache (stream, TRUE);
+  fail_unless (gst_rtsp_stream_get_gop_cache (stream));
+
+  /* adding a transport with an empty cache works as before */
+  gst_rtsp_stream_set_protocols (stream, GST_RTSP_LOWER_TRANS_TCP);
+  fail_unless (gst_rtsp_stream_join_bin (stream, bin, rtpbin, GST_STATE_NULL));
+
+  fail_unless (gst_rtsp_transport_new (&transport) == GST_RTSP_OK);
+  transport->lower_transport = GST_RTSP_LOWER_TRANS_TCP;
+  transport->destination = g_strdup ("127.0.0.1");
+  tr = gst_rtsp_stream_transport_new (stream, transport);
+  fail_unless (tr);
+
+  fail_unless (gst_rtsp_stream_add_transport (stream, tr));
+  fail_unless (gst_rtsp_stream_remove_transport (stream, tr));
+
+  gst_rtsp_stream_set_gop_cache (stream, FALSE);
+  fail_if (gst_rtsp_stream_get_gop_cache (stream));
+
+  fail_unless (gst_rtsp_stream_leave_bin (stream, bin, rtpbin));
+  g_object_unref (tr);
+  gst_object_unref (bin);
+  gst_object_unref (stream);
+}
+
+GST_END_TEST;
+
+static GstPad *
+get_rtp_tee_sinkpad (GstBin * bin)
+{
+  GstIterator *it;
+  GValue item = G_VALUE_INIT;
+  GstPad *result = NULL;
+
+  it = gst_bin_iterate_all_by_element_factory_name (bin, "tee");
+  while (!result && gst_iterator_next (it, &item) == GST_ITERATOR_OK) {
+    GstPad *sinkpad =
+        gst_element_get_static_pad (g_value_get_object (&item), "sink");
+    GstPad *peer = gst_pad_get_peer (sinkpad);
+
+    if (peer && g_str_has_prefix (GST_PAD_NAME (peer), "send_rtp_src"))
+      result = gst_object_ref (sinkpad);
+    gst_clear_object (&peer);
+    gst_object_unref (sinkpad);
+    g_value_reset (&item);
+  }
+  g_value_unset (&item);
+  gst_iterator_free (it);
+
+  return result;
+}
+
+static void
+chain_rtp_packet (GstPad * pad, guint16 seqnum, gboolean delta)
+{
+  GstBuffer *buffer = gst_rtp_buffer_new_allocate (4, 0, 0);
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+
+  fail_unless (gst_rtp_buffer_map (buffer, GST_MAP_WRITE, &rtp));
+  gst_rtp_buffer_set_seq (&rtp, seqnum);
+  gst_rtp_buffer_unmap (&rtp);
+  GST_BUFFER_PTS (buffer) = seqnum * GST_MSECOND;
+  if (delta)
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+
+  /* the outputs of the tee are not active, only its probe matters */
+  gst_pad_chain (pad, buffer);
+}
+
+static gboolean
+gop_cache_send_rtp (GstBuffer * buffer, guint8 channel, gpointer user_data)
+{
+  GArray *seqnums = user_data;
+  GstRTPBuffer rtp = GST_RTP_BUFFER_INIT;
+  guint16 seqnum;
+
+  fail_unless (gst_rtp_buffer_map (buffer, GST_MAP_READ, &rtp));
+  seqnum = gst_rtp_buffer_get_seq (&rtp);
+  gst_rtp_buffer_unmap (&rtp);
+  g_array_append_val (seqnums, seqnum);
+
+  return TRUE;
+}
+
+static gboolean
+gop_cache_send_rtcp (GstBuffer * buffer, guint8 channel, gpointer user_data)
+{
+  return TRUE;
+}
+
+GST_START_TEST (test_gop_cache_replay)
+{
+  GstPad *srcpad, *teepad;
+  GstElement *pay;
+  GstRTSPStream *stream;
+  GstBin *bin;
+  GstElement *rtpbin;
+  GstRTSPTransport *transport;
+  GstRTSPStreamTransport *tr;
+  GstSegment segment;
+  GArray *seqnums;
+
+  srcpad = gst_pad_new ("testsrcpad", GST_PAD_SRC);
+  fail_unless (srcpad != NULL);
+  gst_pad_set_active (srcpad, TRUE);
+  pay = gst_element_factory_make ("rtpgstpay", "testpayloader");
+  fail_unless (pay != NULL);
+  stream = gst_rtsp_stream_new (0, pay, srcpad);
+  fail_unless (stream != NULL);
+  gst_object_unref (pay);
+  gst_object_unref (srcpad);
+  rtpbin = gst_element_factory_make ("rtpbin", "testrtpbin");
+  fail_unless (rtpbin != NULL);
+  bin = GST_BIN (gst_bin_new ("testbin"));
+  fail_unless (bin != NULL);
+  fail_unless (gst_bin_add (bin, rtpbin));
+
+  gst_rtsp_stream_set_gop_cache (stream, TRUE);
+  gst_rtsp_stream_set_protocols (stream, GST_RTSP_LOWER_TRANS_TCP);
+  fail_unless (gst_rtsp_stream_join_bin (stream, bin, rtpbin, GST_STATE_NULL));
+
+  teepad = get_rtp_tee_sinkpad (bin);
+  fail_unless (teepad != NULL);
+  gst_pad_set_active (teepad, TRUE);
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_send_event (teepad, gst_event_new_stream_start ("test"));
+  gst_pad_send_event (teepad, gst_event_new_segment (&segment));
+
+  /* deltas before the first keyframe are not cached, a new keyframe starts
+   * a new GOP */
+  chain_rtp_packet (teepad, 1, TRUE);
+  chain_rtp_packet (teepad, 2, FALSE);
+  chain_rtp_packet (teepad, 3, TRUE);
+  chain_rtp_packet (teepad, 4, FALSE);
+  chain_rtp_packet (teepad, 5, TRUE);
+  chain_rtp_packet (teepad, 6, TRUE);
+
+  fail_unless (gst_rtsp_transport_new (&transport) == GST_RTSP_OK);
+  transport->lower_transport = GST_RTSP_LOWER_TRANS_TCP;
+  transport->destination = g_strdup ("127.0.0.1");
+  tr = gst_rtsp_stream_transport_new (stream, transport);
+  fail_unless (tr);
+
+  seqnums = g_array_new (FALSE, FALSE, sizeof (guint16));
+  gst_rtsp_stream_transport_set_callbacks (tr, gop_cache_send_rtp,
+      gop_cache_send_rtcp, seqnums, NULL);
+
+  /* the client gets the last GOP in order right away */
+  fail_unless (gst_rtsp_stream_add_transport (stream, tr));
+  fail_unless_equals_int (seqnums->len, 3);
+  fail_unless_equals_int (g_array_index (seqnums, guint16, 0), 4);
+  fail_unless_equals_int (g_array_index (seqnums, guint16, 1), 5);
+  fail_unless_equals_int (g_array_index (seqnums, guint16, 2), 6);
+
+  fail_unless (gst_rtsp_stream_remove_transport (stream, tr));
+
+  gst_pad_set_active (teepad, FALSE);
+  gst_object_unref (teepad);
+  fail_unless (gst_rtsp_stream_leave_bin (stream, bin, rtpbin));
+  g_object_unref (tr);
+  g_array_unref (seqnums);
+  gst_object_unref (bin);
+  gst_object_unref (stream);
+}
+
+GST_END_TEST;
+
 static gboolean
 is_ipv6_supported (void)
 {
@@ -699,6 +893,8 @@ rtspstream_suite (void)
   tcase_add_test (tc, test_multicast_client_address_invalid);
   tcase_add_test (tc, test_add_transport_twice);
   tcase_add_test (tc, test_remove_transport_twice);
+  tcase_add_test (tc, test_gop_cache);
+  tcase_add_test (tc, test_gop_cache_replay);
 
   return s;
 }
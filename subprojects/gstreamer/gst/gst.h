@@ -56,6 +56,7 @@
 #include <gst/gstiterator.h>
 #include <gst/gstmessage.h>
 #include <gst/gstmemory.h>
+#include <gst/gstmemorybudget.h>
 #include <gst/gstmeta.h>
 #include <gst/gstminiobject.h>
 #include <gst/gstobject.h>
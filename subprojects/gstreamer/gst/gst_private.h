@@ -100,6 +100,18 @@ struct _GstMetaItem {
   GstMeta meta;
 };
 
+/* The first meta APIs that are registered get a slot in the meta index of
+ * every buffer, which makes looking them up O(1). The tags of those APIs that
+ * matter for copying buffers are cached along with them. */
+#define PRIV_GST_META_API_SLOTS 8
+
+#define PRIV_GST_META_API_TAG_MEMORY            (1 << 0)
+#define PRIV_GST_META_API_TAG_MEMORY_REFERENCE  (1 << 1)
+
+G_GNUC_INTERNAL extern GType _priv_gst_meta_api_slots[PRIV_GST_META_API_SLOTS];
+G_GNUC_INTERNAL extern guint _priv_gst_meta_api_slot_tags[PRIV_GST_META_API_SLOTS];
+G_GNUC_INTERNAL extern gint _priv_gst_n_meta_api_slots;
+
 /* FIXME: could rename all priv_gst_* functions to __gst_* now */
 G_GNUC_INTERNAL  gboolean priv_gst_plugin_loading_have_whitelist (void);
 
@@ -194,6 +206,25 @@ gboolean priv_gst_structure_parse_name (gchar * str, gchar **start, gchar ** end
 G_GNUC_INTERNAL
 gboolean priv_gst_structure_parse_fields (gchar *str, gchar ** end, GstStructure *structure);
 
+/* used in gstcaps.c for caching caps operations */
+G_GNUC_INTERNAL
+guint priv_gst_structure_hash (const GstStructure * structure);
+G_GNUC_INTERNAL
+gboolean priv_gst_structure_is_identical (const GstStructure * structure1,
+                                          const GstStructure * structure2);
+
+/* used in gstevent.c and gstquery.c to allocate the structure inline */
+G_GNUC_INTERNAL
+GstStructure *priv_gst_structure_new_id_valist_with_header (gsize header_size,
+                                                            gpointer * header,
+                                                            GQuark name_quark,
+                                                            GQuark field_quark,
+                                                            va_list varargs);
+
+/* used in gstbus.c to fold a newer message into a still queued one */
+G_GNUC_INTERNAL
+gboolean priv_gst_message_coalesce (GstMessage * pending, GstMessage * message);
+
 /* used in gstvalue.c and gststructure.c */
 
 #define GST_WRAPPED_PTR_FORMAT     "p\aa"
@@ -419,6 +450,10 @@ struct _GstTypeFindFactory {
   gpointer                      user_data;
   GDestroyNotify                user_data_notify;
 
+  /* caps in the registry cache, parsed when needed */
+  GBytes *                      cache;
+  const gchar *                 caps_string;
+
   gpointer _gst_reserved[GST_PADDING];
 };
 
@@ -466,6 +501,11 @@ struct _GstElementFactory {
 
   GList *               interfaces;             /* interface type names this element implements */
 
+  /* The registry cache the pad templates point into and the serialized
+   * metadata in it, which is only parsed when needed */
+  GBytes *              cache;
+  const gchar *         metadata_string;
+
   /*< private >*/
   gpointer _gst_reserved[GST_PADDING];
 };
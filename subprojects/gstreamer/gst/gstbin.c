@@ -141,6 +141,7 @@
 
 #include "gstutils.h"
 #include "gstchildproxy.h"
+#include "gsttaskpool.h"
 
 GST_DEBUG_CATEGORY_STATIC (bin_debug);
 #define GST_CAT_DEFAULT bin_debug
@@ -172,8 +173,26 @@ struct _GstBinPrivate
   gboolean posted_eos;
   gboolean posted_playing;
   GstElementFlags suppressed_flags;
+
+  /* change the state of independent children concurrently */
+  gboolean parallel_state_changes;
+  /* only used with the STATE_LOCK held */
+  GstTaskPool *state_pool;
+
+  /* GstElement -> BinLatency of the sink children, protected by the
+   * object lock */
+  gboolean cache_latency;
+  GHashTable *latency_cache;
 };
 
+/* cached result of a successful latency query on a sink child */
+typedef struct
+{
+  gboolean live;
+  GstClockTime min;
+  GstClockTime max;
+} BinLatency;
+
 typedef struct
 {
   guint32 cookie;
@@ -181,6 +200,7 @@ typedef struct
 } BinContinueData;
 
 static void gst_bin_dispose (GObject * object);
+static void gst_bin_finalize (GObject * object);
 
 static void gst_bin_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
@@ -246,12 +266,16 @@ enum
 
 #define DEFAULT_ASYNC_HANDLING	FALSE
 #define DEFAULT_MESSAGE_FORWARD	FALSE
+#define DEFAULT_PARALLEL_STATE_CHANGES	FALSE
+#define DEFAULT_CACHE_LATENCY	FALSE
 
 enum
 {
   PROP_0,
   PROP_ASYNC_HANDLING,
   PROP_MESSAGE_FORWARD,
+  PROP_PARALLEL_STATE_CHANGES,
+  PROP_CACHE_LATENCY,
   PROP_LAST
 };
 
@@ -445,7 +469,49 @@ gst_bin_class_init (GstBinClass * klass)
           "Forwards all children messages",
           DEFAULT_MESSAGE_FORWARD, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstBin:parallel-state-changes:
+   *
+   * If set to %TRUE, children that are not linked to each other, directly or
+   * through other children, change state concurrently on a thread pool. The
+   * children of each group of linked elements still change state one after
+   * the other, in the same order as without this property. This speeds up
+   * state changes of bins with many independent branches, for example many
+   * sources that each open a device.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_PARALLEL_STATE_CHANGES,
+      g_param_spec_boolean ("parallel-state-changes", "Parallel State Changes",
+          "Change the state of unlinked children concurrently",
+          DEFAULT_PARALLEL_STATE_CHANGES,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstBin:cache-latency:
+   *
+   * If set to %TRUE, the bin keeps the result of the latency query of each
+   * of its sinks. A #GST_MESSAGE_LATENCY from a child only invalidates the
+   * results of the sinks downstream of that child, so recalculating the
+   * latency after a change in one branch does not query all the other
+   * branches again. Removing a child invalidates the sinks downstream of it.
+   * Failed queries are never cached, and the results are dropped when a sink
+   * prerolls and when the bin goes to PAUSED or PLAYING, as the sinks only
+   * report their final latency once prerolled.
+   *
+   * This relies on elements posting a #GST_MESSAGE_LATENCY whenever their
+   * latency changes, including when new branches are linked.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_LATENCY,
+      g_param_spec_boolean ("cache-latency", "Cache Latency",
+          "Cache the latency of the sinks and only query again the branches "
+          "that posted a latency message", DEFAULT_CACHE_LATENCY,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gobject_class->dispose = gst_bin_dispose;
+  gobject_class->finalize = gst_bin_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class, "Generic bin",
       "Generic/Bin",
@@ -504,6 +570,9 @@ gst_bin_init (GstBin * bin)
   bin->priv->asynchandling = DEFAULT_ASYNC_HANDLING;
   bin->priv->structure_cookie = 0;
   bin->priv->message_forward = DEFAULT_MESSAGE_FORWARD;
+  bin->priv->parallel_state_changes = DEFAULT_PARALLEL_STATE_CHANGES;
+  bin->priv->cache_latency = DEFAULT_CACHE_LATENCY;
+  bin->priv->latency_cache = g_hash_table_new_full (NULL, NULL, NULL, g_free);
 }
 
 static void
@@ -521,8 +590,14 @@ gst_bin_dispose (GObject * object)
   gst_object_replace ((GstObject **) provided_clock_p, NULL);
   gst_object_replace ((GstObject **) clock_provider_p, NULL);
   bin_remove_messages (bin, NULL, GST_MESSAGE_ANY);
+  g_hash_table_remove_all (bin->priv->latency_cache);
   GST_OBJECT_UNLOCK (object);
 
+  if (bin->priv->state_pool) {
+    gst_task_pool_cleanup (bin->priv->state_pool);
+    gst_clear_object (&bin->priv->state_pool);
+  }
+
   while (bin->children) {
     gst_bin_remove (bin, GST_ELEMENT_CAST (bin->children->data));
   }
@@ -534,6 +609,16 @@ gst_bin_dispose (GObject * object)
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
 
+static void
+gst_bin_finalize (GObject * object)
+{
+  GstBin *bin = GST_BIN_CAST (object);
+
+  g_hash_table_unref (bin->priv->latency_cache);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
 /**
  * gst_bin_new:
  * @name: (allow-none): the name of the new bin
@@ -567,6 +652,17 @@ gst_bin_set_property (GObject * object, guint prop_id,
       gstbin->priv->message_forward = g_value_get_boolean (value);
       GST_OBJECT_UNLOCK (gstbin);
       break;
+    case PROP_PARALLEL_STATE_CHANGES:
+      GST_OBJECT_LOCK (gstbin);
+      gstbin->priv->parallel_state_changes = g_value_get_boolean (value);
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
+    case PROP_CACHE_LATENCY:
+      GST_OBJECT_LOCK (gstbin);
+      gstbin->priv->cache_latency = g_value_get_boolean (value);
+      g_hash_table_remove_all (gstbin->priv->latency_cache);
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -592,6 +688,16 @@ gst_bin_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, gstbin->priv->message_forward);
       GST_OBJECT_UNLOCK (gstbin);
       break;
+    case PROP_PARALLEL_STATE_CHANGES:
+      GST_OBJECT_LOCK (gstbin);
+      g_value_set_boolean (value, gstbin->priv->parallel_state_changes);
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
+    case PROP_CACHE_LATENCY:
+      GST_OBJECT_LOCK (gstbin);
+      g_value_set_boolean (value, gstbin->priv->cache_latency);
+      GST_OBJECT_UNLOCK (gstbin);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1542,6 +1648,96 @@ no_function:
   }
 }
 
+/* drops the cached latency of @child and of all the children downstream of
+ * it. @child can be any element inside the bin, or %NULL to drop everything */
+static void
+bin_invalidate_latency (GstBin * bin, GstObject * child)
+{
+  GHashTable *visited;
+  GQueue queue = G_QUEUE_INIT;
+  GstObject *obj;
+
+  GST_OBJECT_LOCK (bin);
+  if (g_hash_table_size (bin->priv->latency_cache) == 0) {
+    GST_OBJECT_UNLOCK (bin);
+    return;
+  }
+  GST_OBJECT_UNLOCK (bin);
+
+  /* find the direct child of the bin containing @child */
+  obj = child ? gst_object_ref (child) : NULL;
+  while (obj) {
+    GstObject *parent = gst_object_get_parent (obj);
+
+    if (parent == GST_OBJECT_CAST (bin)) {
+      gst_object_unref (parent);
+      break;
+    }
+    gst_object_unref (obj);
+    obj = parent;
+  }
+
+  if (!obj || !GST_IS_ELEMENT (obj)) {
+    GST_DEBUG_OBJECT (bin, "dropping all cached latencies");
+    GST_OBJECT_LOCK (bin);
+    g_hash_table_remove_all (bin->priv->latency_cache);
+    GST_OBJECT_UNLOCK (bin);
+    if (obj)
+      gst_object_unref (obj);
+    return;
+  }
+
+  visited = g_hash_table_new_full (NULL, NULL, gst_object_unref, NULL);
+  g_hash_table_add (visited, obj);
+  g_queue_push_tail (&queue, obj);
+
+  while ((obj = g_queue_pop_head (&queue))) {
+    GstElement *element = GST_ELEMENT_CAST (obj);
+    GList *pads, *l;
+
+    GST_OBJECT_LOCK (element);
+    pads = g_list_copy_deep (element->srcpads, (GCopyFunc) gst_object_ref,
+        NULL);
+    GST_OBJECT_UNLOCK (element);
+
+    for (l = pads; l; l = l->next) {
+      GstPad *peer = gst_pad_get_peer (GST_PAD_CAST (l->data));
+      GstElement *peer_parent;
+
+      if (!peer)
+        continue;
+
+      peer_parent = gst_pad_get_parent_element (peer);
+      if (peer_parent && GST_OBJECT_PARENT (peer_parent) ==
+          GST_OBJECT_CAST (bin) && !g_hash_table_contains (visited,
+              peer_parent)) {
+        g_hash_table_add (visited, gst_object_ref (peer_parent));
+        g_queue_push_tail (&queue, peer_parent);
+      }
+      if (peer_parent)
+        gst_object_unref (peer_parent);
+      gst_object_unref (peer);
+    }
+    g_list_free_full (pads, gst_object_unref);
+  }
+
+  GST_OBJECT_LOCK (bin);
+  {
+    GHashTableIter iter;
+    gpointer key;
+
+    g_hash_table_iter_init (&iter, visited);
+    while (g_hash_table_iter_next (&iter, &key, NULL)) {
+      if (g_hash_table_remove (bin->priv->latency_cache, key))
+        GST_DEBUG_OBJECT (bin, "dropped cached latency of %" GST_PTR_FORMAT,
+            key);
+    }
+  }
+  GST_OBJECT_UNLOCK (bin);
+
+  g_hash_table_unref (visited);
+}
+
 /* remove an element from the bin
  *
  * MT safe
@@ -1795,6 +1991,12 @@ no_state_recalc:
   if (clock_message)
     gst_element_post_message (GST_ELEMENT_CAST (bin), clock_message);
 
+  /* the sinks downstream of the element will lose it as upstream */
+  bin_invalidate_latency (bin, GST_OBJECT_CAST (element));
+  GST_OBJECT_LOCK (bin);
+  g_hash_table_remove (bin->priv->latency_cache, element);
+  GST_OBJECT_UNLOCK (bin);
+
   /* unlink all linked pads */
   it = gst_element_iterate_pads (element);
   while (gst_iterator_foreach (it, (GstIteratorForeachFunction) unlink_pads,
@@ -2817,6 +3019,258 @@ reset_state (const GValue * data, gpointer user_data)
         gst_element_state_get_name (state));
 }
 
+/* a group of children linked to each other, in state change order */
+typedef struct
+{
+  GstBin *bin;
+  GPtrArray *children;
+  GstClockTime base_time;
+  GstClockTime start_time;
+  GstState current;
+  GstState next;
+
+  gboolean have_async;
+  gboolean have_no_preroll;
+  gboolean failed;
+} BinStateChain;
+
+static void
+gst_bin_change_chain_state (BinStateChain * chain)
+{
+  guint i;
+
+  for (i = 0; i < chain->children->len; i++) {
+    GstElement *child = g_ptr_array_index (chain->children, i);
+    GstStateChangeReturn ret;
+    GstObject *parent;
+
+    ret = gst_bin_element_set_state (chain->bin, child, chain->base_time,
+        chain->start_time, chain->current, chain->next);
+
+    switch (ret) {
+      case GST_STATE_CHANGE_SUCCESS:
+        break;
+      case GST_STATE_CHANGE_ASYNC:
+        chain->have_async = TRUE;
+        break;
+      case GST_STATE_CHANGE_NO_PREROLL:
+        chain->have_no_preroll = TRUE;
+        break;
+      case GST_STATE_CHANGE_FAILURE:
+        GST_CAT_INFO_OBJECT (GST_CAT_STATES, chain->bin,
+            "child '%s' failed to go to state %s", GST_ELEMENT_NAME (child),
+            gst_element_state_get_name (chain->next));
+
+        /* only fail if the child is still inside this bin, see
+         * gst_bin_change_state_func() */
+        parent = gst_object_get_parent (GST_OBJECT_CAST (child));
+        if (parent == GST_OBJECT_CAST (chain->bin)) {
+          gst_object_unref (parent);
+          chain->failed = TRUE;
+          return;
+        }
+        if (parent)
+          gst_object_unref (parent);
+        break;
+      default:
+        g_assert_not_reached ();
+        break;
+    }
+  }
+}
+
+static guint
+chain_find_root (guint * roots, guint i)
+{
+  while (roots[i] != i) {
+    roots[i] = roots[roots[i]];
+    i = roots[i];
+  }
+  return i;
+}
+
+/* splits the children, in state change order, into groups of elements that
+ * are linked to each other */
+static GPtrArray *
+gst_bin_collect_chains (GstBin * bin, GPtrArray * children)
+{
+  GHashTable *index;
+  GPtrArray *chains;
+  guint *roots, *chain_of_root;
+  guint i;
+
+  roots = g_new (guint, children->len);
+  index = g_hash_table_new (NULL, NULL);
+  for (i = 0; i < children->len; i++) {
+    roots[i] = i;
+    g_hash_table_insert (index, g_ptr_array_index (children, i),
+        GUINT_TO_POINTER (i));
+  }
+
+  for (i = 0; i < children->len; i++) {
+    GstElement *child = g_ptr_array_index (children, i);
+    GList *pads, *l;
+
+    GST_OBJECT_LOCK (child);
+    pads = g_list_copy_deep (child->pads, (GCopyFunc) gst_object_ref, NULL);
+    GST_OBJECT_UNLOCK (child);
+
+    for (l = pads; l; l = l->next) {
+      GstPad *peer = gst_pad_get_peer (GST_PAD_CAST (l->data));
+      GstElement *peer_parent;
+      gpointer j;
+
+      if (!peer)
+        continue;
+
+      peer_parent = gst_pad_get_parent_element (peer);
+      if (peer_parent && g_hash_table_lookup_extended (index, peer_parent,
+              NULL, &j)) {
+        guint a = chain_find_root (roots, i);
+        guint b = chain_find_root (roots, GPOINTER_TO_UINT (j));
+
+        roots[MAX (a, b)] = MIN (a, b);
+      }
+      if (peer_parent)
+        gst_object_unref (peer_parent);
+      gst_object_unref (peer);
+    }
+    g_list_free_full (pads, gst_object_unref);
+  }
+
+  chains = g_ptr_array_new ();
+  chain_of_root = g_new (guint, children->len);
+  for (i = 0; i < children->len; i++) {
+    guint root = chain_find_root (roots, i);
+    BinStateChain *chain;
+
+    if (root == i) {
+      chain = g_new0 (BinStateChain, 1);
+      chain->bin = bin;
+      chain->children = g_ptr_array_new ();
+      chain_of_root[i] = chains->len;
+      g_ptr_array_add (chains, chain);
+    } else {
+      chain = g_ptr_array_index (chains, chain_of_root[root]);
+    }
+    g_ptr_array_add (chain->children, g_ptr_array_index (children, i));
+  }
+
+  g_free (chain_of_root);
+  g_free (roots);
+  g_hash_table_unref (index);
+
+  return chains;
+}
+
+/* the parallel version of the iteration in gst_bin_change_state_func(),
+ * returns FALSE if a child failed to change state */
+static gboolean
+gst_bin_change_children_state_parallel (GstBin * bin, GstState current,
+    GstState next, gboolean * have_async, gboolean * have_no_preroll)
+{
+  GstElement *element = GST_ELEMENT_CAST (bin);
+  GPtrArray *children, *chains;
+  gpointer *handles;
+  GstIterator *it;
+  GValue data = G_VALUE_INIT;
+  gboolean done = FALSE, res = TRUE;
+  guint32 cookie;
+  guint i;
+
+  children = g_ptr_array_new_with_free_func (gst_object_unref);
+
+restart:
+  g_ptr_array_set_size (children, 0);
+  GST_OBJECT_LOCK (bin);
+  cookie = bin->children_cookie;
+  GST_OBJECT_UNLOCK (bin);
+
+  it = gst_bin_iterate_sorted (bin);
+  done = FALSE;
+  while (!done) {
+    switch (gst_iterator_next (it, &data)) {
+      case GST_ITERATOR_OK:
+        g_ptr_array_add (children, g_value_dup_object (&data));
+        g_value_reset (&data);
+        break;
+      case GST_ITERATOR_RESYNC:
+        g_ptr_array_set_size (children, 0);
+        gst_iterator_resync (it);
+        break;
+      default:
+        done = TRUE;
+        break;
+    }
+  }
+  g_value_unset (&data);
+  gst_iterator_free (it);
+
+  chains = gst_bin_collect_chains (bin, children);
+
+  GST_CAT_DEBUG_OBJECT (GST_CAT_STATES, bin,
+      "changing state of %u children in %u independent chains",
+      children->len, chains->len);
+
+  if (chains->len > 1 && !bin->priv->state_pool) {
+    GstTaskPool *pool = gst_shared_task_pool_new ();
+
+    gst_shared_task_pool_set_max_threads (GST_SHARED_TASK_POOL (pool),
+        g_get_num_processors ());
+    gst_task_pool_prepare (pool, NULL);
+    bin->priv->state_pool = pool;
+  }
+
+  handles = g_new0 (gpointer, chains->len);
+  for (i = 0; i < chains->len; i++) {
+    BinStateChain *chain = g_ptr_array_index (chains, i);
+
+    chain->base_time = gst_element_get_base_time (element);
+    chain->start_time = gst_element_get_start_time (element);
+    chain->current = current;
+    chain->next = next;
+
+    /* the first chain is done in this thread */
+    if (i > 0)
+      handles[i] = gst_task_pool_push (bin->priv->state_pool,
+          (GstTaskPoolFunction) gst_bin_change_chain_state, chain, NULL);
+    if (!handles[i])
+      gst_bin_change_chain_state (chain);
+  }
+
+  for (i = 0; i < chains->len; i++) {
+    BinStateChain *chain = g_ptr_array_index (chains, i);
+
+    if (handles[i])
+      gst_task_pool_join (bin->priv->state_pool, handles[i]);
+
+    *have_async |= chain->have_async;
+    *have_no_preroll |= chain->have_no_preroll;
+    if (chain->failed)
+      res = FALSE;
+
+    g_ptr_array_unref (chain->children);
+    g_free (chain);
+  }
+  g_free (handles);
+  g_ptr_array_unref (chains);
+
+  /* children were added or removed while changing state, make sure the new
+   * ones get the state too */
+  GST_OBJECT_LOCK (bin);
+  if (res && cookie != bin->children_cookie) {
+    GST_OBJECT_UNLOCK (bin);
+    GST_CAT_DEBUG_OBJECT (GST_CAT_STATES, bin, "children changed, resync");
+    *have_no_preroll = FALSE;
+    goto restart;
+  }
+  GST_OBJECT_UNLOCK (bin);
+
+  g_ptr_array_unref (children);
+
+  return res;
+}
+
 static GstStateChangeReturn
 gst_bin_change_state_func (GstElement * element, GstStateChange transition)
 {
@@ -2828,6 +3282,7 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
   GstClockTime base_time, start_time;
   GstIterator *it;
   gboolean done;
+  gboolean parallel;
   GValue data = { 0, };
 
   /* we don't need to take the STATE_LOCK, it is already taken */
@@ -2850,6 +3305,11 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
       asynchandling = bin->priv->asynchandling;
       GST_OBJECT_UNLOCK (bin);
 
+      /* the sinks answer differently once they prerolled, query them again */
+      GST_OBJECT_LOCK (bin);
+      g_hash_table_remove_all (bin->priv->latency_cache);
+      GST_OBJECT_UNLOCK (bin);
+
       if (toplevel)
         gst_bin_recalculate_latency (bin);
       if (asynchandling)
@@ -2863,8 +3323,10 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
       GST_DEBUG_OBJECT (element, "clearing EOS elements");
       bin_remove_messages (bin, NULL, GST_MESSAGE_EOS);
       bin->priv->posted_eos = FALSE;
-      if (current == GST_STATE_READY)
+      if (current == GST_STATE_READY) {
         bin_remove_messages (bin, NULL, GST_MESSAGE_STREAM_START);
+        g_hash_table_remove_all (bin->priv->latency_cache);
+      }
       GST_OBJECT_UNLOCK (bin);
       if (current == GST_STATE_READY)
         if (!(gst_bin_src_pads_activate (bin, TRUE)))
@@ -2875,6 +3337,7 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
       GST_OBJECT_LOCK (bin);
       GST_DEBUG_OBJECT (element, "clearing all cached messages");
       bin_remove_messages (bin, NULL, GST_MESSAGE_ANY);
+      g_hash_table_remove_all (bin->priv->latency_cache);
       GST_OBJECT_UNLOCK (bin);
       /* Pads can be activated in PULL mode before in NULL state */
       if (current != GST_STATE_NULL) {
@@ -2914,6 +3377,20 @@ gst_bin_change_state_func (GstElement * element, GstStateChange transition)
    * even after a resync when the async element is gone */
   have_async = FALSE;
 
+  GST_OBJECT_LOCK (bin);
+  parallel = bin->priv->parallel_state_changes;
+  GST_OBJECT_UNLOCK (bin);
+
+  if (parallel) {
+    have_no_preroll = FALSE;
+    if (!gst_bin_change_children_state_parallel (bin, current, next,
+            &have_async, &have_no_preroll)) {
+      ret = GST_STATE_CHANGE_FAILURE;
+      goto undo;
+    }
+    goto children_done;
+  }
+
 restart:
   /* take base_time */
   base_time = gst_element_get_base_time (element);
@@ -3004,6 +3481,7 @@ restart:
     }
   }
 
+children_done:
   ret = GST_ELEMENT_CLASS (parent_class)->change_state (element, transition);
   if (G_UNLIKELY (ret == GST_STATE_CHANGE_FAILURE))
     goto done;
@@ -3699,6 +4177,9 @@ gst_bin_handle_message_func (GstBin * bin, GstMessage * message)
       GST_MESSAGE_TYPE_NAME (message));
 
   switch (type) {
+    case GST_MESSAGE_LATENCY:
+      bin_invalidate_latency (bin, src);
+      goto forward;
     case GST_MESSAGE_ERROR:
     {
       GST_OBJECT_LOCK (bin);
@@ -3912,6 +4393,11 @@ gst_bin_handle_message_func (GstBin * bin, GstMessage * message)
 
       bin_do_message_forward (bin, message);
 
+      /* a sink that prerolled answers the latency query differently than
+       * before, drop what was cached for it */
+      if (src)
+        bin_invalidate_latency (bin, src);
+
       GST_OBJECT_LOCK (bin);
       /* ignore messages if we are shutting down */
       if ((target = GST_STATE_TARGET (bin)) <= GST_STATE_READY)
@@ -4039,6 +4525,7 @@ forward:
 /* generic struct passed to all query fold methods */
 typedef struct
 {
+  GstBin *bin;
   GstQuery *query;
   gint64 min;
   gint64 max;
@@ -4145,16 +4632,58 @@ bin_query_latency_fold (const GValue * vitem, GValue * ret, QueryFold * fold)
 {
   gboolean res = FALSE;
   GstObject *item = g_value_get_object (vitem);
-  if (GST_IS_PAD (item))
-    res = gst_pad_query (GST_PAD (item), fold->query);
-  else
-    res = gst_element_query (GST_ELEMENT (item), fold->query);
-  if (res) {
-    GstClockTime min, max;
-    gboolean live;
+  GstBin *bin = fold->bin;
+  GstClockTime min = 0, max = -1;
+  gboolean live = FALSE;
+  gboolean cache = FALSE, cached = FALSE;
 
-    gst_query_parse_latency (fold->query, &live, &min, &max);
+  if (GST_IS_ELEMENT (item)) {
+    BinLatency *latency;
 
+    GST_OBJECT_LOCK (bin);
+    cache = bin->priv->cache_latency;
+    if (cache && (latency =
+            g_hash_table_lookup (bin->priv->latency_cache, item))) {
+      res = TRUE;
+      live = latency->live;
+      min = latency->min;
+      max = latency->max;
+      cached = TRUE;
+    }
+    GST_OBJECT_UNLOCK (bin);
+  }
+
+  if (cached) {
+    GST_LOG_OBJECT (item, "using cached latency");
+  } else {
+    if (GST_IS_PAD (item))
+      res = gst_pad_query (GST_PAD (item), fold->query);
+    else
+      res = gst_element_query (GST_ELEMENT (item), fold->query);
+
+    if (res)
+      gst_query_parse_latency (fold->query, &live, &min, &max);
+
+    /* failed queries are not cached, sinks fail the query until they
+     * prerolled and will answer later */
+    if (cache && res) {
+      BinLatency *latency = g_new (BinLatency, 1);
+
+      latency->live = live;
+      latency->min = min;
+      latency->max = max;
+
+      GST_OBJECT_LOCK (bin);
+      /* only cache children, it could have been removed meanwhile */
+      if (GST_OBJECT_PARENT (item) == GST_OBJECT_CAST (bin))
+        g_hash_table_insert (bin->priv->latency_cache, item, latency);
+      else
+        g_free (latency);
+      GST_OBJECT_UNLOCK (bin);
+    }
+  }
+
+  if (res) {
     GST_DEBUG_OBJECT (item,
         "got latency min %" GST_TIME_FORMAT ", max %" GST_TIME_FORMAT
         ", live %d", GST_TIME_ARGS (min), GST_TIME_ARGS (max), live);
@@ -4293,6 +4822,7 @@ gst_bin_query (GstElement * element, GstQuery * query)
       break;
   }
 
+  fold_data.bin = bin;
   fold_data.query = query;
 
   iter = gst_bin_iterate_sinks (bin);
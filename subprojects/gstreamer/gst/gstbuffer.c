@@ -151,6 +151,7 @@ GType _gst_buffer_type = 0;
 #define GST_BUFFER_BUFMEM(b)       (((GstBufferImpl *)(b))->bufmem)
 #define GST_BUFFER_META(b)         (((GstBufferImpl *)(b))->item)
 #define GST_BUFFER_TAIL_META(b)    (((GstBufferImpl *)(b))->tail_item)
+#define GST_BUFFER_META_INDEX(b,i) (((GstBufferImpl *)(b))->meta_index[i])
 
 typedef struct
 {
@@ -167,10 +168,67 @@ typedef struct
    * GstBufferImpl */
   GstMetaItem *item;
   GstMetaItem *tail_item;
+
+  /* first meta of every API with a meta index slot, NULL when the buffer
+   * has none of that API */
+  GstMetaItem *meta_index[PRIV_GST_META_API_SLOTS];
 } GstBufferImpl;
 
 static gint64 meta_seq;         /* 0 *//* ATOMIC */
 
+/* get the meta index slot of @api or -1 when it has none */
+static inline gint
+_meta_api_slot (GType api)
+{
+  gint i, n;
+
+  n = g_atomic_int_get (&_priv_gst_n_meta_api_slots);
+  for (i = 0; i < n; i++) {
+    if (_priv_gst_meta_api_slots[i] == api)
+      return i;
+  }
+  return -1;
+}
+
+/* the tags relevant to copying a meta of @api */
+static inline guint
+_meta_api_copy_tags (GType api)
+{
+  gint slot;
+  guint tags = 0;
+
+  slot = _meta_api_slot (api);
+  if (slot >= 0)
+    return _priv_gst_meta_api_slot_tags[slot];
+
+  if (gst_meta_api_type_has_tag (api, _gst_meta_tag_memory))
+    tags |= PRIV_GST_META_API_TAG_MEMORY;
+  if (gst_meta_api_type_has_tag (api, _gst_meta_tag_memory_reference))
+    tags |= PRIV_GST_META_API_TAG_MEMORY_REFERENCE;
+
+  return tags;
+}
+
+/* update the meta index of @buffer for @item that is about to be unlinked */
+static void
+_meta_index_remove (GstBuffer * buffer, GstMetaItem * item)
+{
+  GType api = item->meta.info->api;
+  GstMetaItem *walk;
+  gint slot;
+
+  slot = _meta_api_slot (api);
+  if (slot < 0 || GST_BUFFER_META_INDEX (buffer, slot) != item)
+    return;
+
+  /* the next meta of the same API becomes the first one */
+  for (walk = item->next; walk; walk = walk->next) {
+    if (walk->meta.info->api == api)
+      break;
+  }
+  GST_BUFFER_META_INDEX (buffer, slot) = walk;
+}
+
 /* TODO: use GLib's once https://gitlab.gnome.org/GNOME/glib/issues/1076 lands */
 #if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)
 static inline gint64
@@ -292,6 +350,7 @@ _actual_merged_memory (GstBuffer * buffer, guint idx, guint length)
       gst_memory_unmap (mem[i], &sinfo);
     }
     gst_memory_unmap (result, &dinfo);
+    GST_TRACER_BUFFER_MERGE (buffer, result);
   }
 
   return result;
@@ -519,6 +578,54 @@ gst_buffer_get_max_memory (void)
   return GST_BUFFER_MEM_MAX;
 }
 
+static void
+_copy_metas (GstBuffer * dest, GstBuffer * src, GstBufferCopyFlags flags,
+    gboolean region, gsize offset, gsize size)
+{
+  GstMetaItem *walk;
+  gboolean deep;
+
+  deep = (flags & GST_BUFFER_COPY_DEEP) != 0;
+
+  /* NOTE: GstGLSyncMeta copying relies on the meta
+   *       being copied now, after the buffer data,
+   *       so this has to happen last */
+  for (walk = GST_BUFFER_META (src); walk; walk = walk->next) {
+    GstMeta *meta = &walk->meta;
+    const GstMetaInfo *info = meta->info;
+    guint tags = _meta_api_copy_tags (info->api);
+
+    /* Don't copy memory metas if we only copied part of the buffer, didn't
+     * copy memories or merged memories. In all these cases the memory
+     * structure has changed and the memory meta becomes meaningless.
+     */
+    if ((region || !(flags & GST_BUFFER_COPY_MEMORY)
+            || (flags & GST_BUFFER_COPY_MERGE))
+        && (tags & PRIV_GST_META_API_TAG_MEMORY)) {
+      GST_CAT_DEBUG (GST_CAT_BUFFER,
+          "don't copy memory meta %p of API type %s", meta,
+          g_type_name (info->api));
+    } else if (deep && (tags & PRIV_GST_META_API_TAG_MEMORY_REFERENCE)) {
+      GST_CAT_DEBUG (GST_CAT_BUFFER,
+          "don't copy memory reference meta %p of API type %s", meta,
+          g_type_name (info->api));
+    } else if (info->transform_func) {
+      GstMetaTransformCopy copy_data;
+
+      copy_data.region = region;
+      copy_data.offset = offset;
+      copy_data.size = size;
+
+      if (!info->transform_func (dest, meta, src,
+              _gst_meta_transform_copy, &copy_data)) {
+        GST_CAT_ERROR (GST_CAT_BUFFER,
+            "failed to copy meta %p of API type %s", meta,
+            g_type_name (info->api));
+      }
+    }
+  }
+}
+
 /**
  * gst_buffer_copy_into:
  * @dest: a destination #GstBuffer
@@ -540,7 +647,6 @@ gboolean
 gst_buffer_copy_into (GstBuffer * dest, GstBuffer * src,
     GstBufferCopyFlags flags, gsize offset, gsize size)
 {
-  GstMetaItem *walk;
   gsize bufsize;
   gboolean region = FALSE;
 
@@ -663,49 +769,8 @@ gst_buffer_copy_into (GstBuffer * dest, GstBuffer * src,
     }
   }
 
-  if (flags & GST_BUFFER_COPY_META) {
-    gboolean deep;
-
-    deep = (flags & GST_BUFFER_COPY_DEEP) != 0;
-
-    /* NOTE: GstGLSyncMeta copying relies on the meta
-     *       being copied now, after the buffer data,
-     *       so this has to happen last */
-    for (walk = GST_BUFFER_META (src); walk; walk = walk->next) {
-      GstMeta *meta = &walk->meta;
-      const GstMetaInfo *info = meta->info;
-
-      /* Don't copy memory metas if we only copied part of the buffer, didn't
-       * copy memories or merged memories. In all these cases the memory
-       * structure has changed and the memory meta becomes meaningless.
-       */
-      if ((region || !(flags & GST_BUFFER_COPY_MEMORY)
-              || (flags & GST_BUFFER_COPY_MERGE))
-          && gst_meta_api_type_has_tag (info->api, _gst_meta_tag_memory)) {
-        GST_CAT_DEBUG (GST_CAT_BUFFER,
-            "don't copy memory meta %p of API type %s", meta,
-            g_type_name (info->api));
-      } else if (deep && gst_meta_api_type_has_tag (info->api,
-              _gst_meta_tag_memory_reference)) {
-        GST_CAT_DEBUG (GST_CAT_BUFFER,
-            "don't copy memory reference meta %p of API type %s", meta,
-            g_type_name (info->api));
-      } else if (info->transform_func) {
-        GstMetaTransformCopy copy_data;
-
-        copy_data.region = region;
-        copy_data.offset = offset;
-        copy_data.size = size;
-
-        if (!info->transform_func (dest, meta, src,
-                _gst_meta_transform_copy, &copy_data)) {
-          GST_CAT_ERROR (GST_CAT_BUFFER,
-              "failed to copy meta %p of API type %s", meta,
-              g_type_name (info->api));
-        }
-      }
-    }
-  }
+  if (flags & GST_BUFFER_COPY_META)
+    _copy_metas (dest, src, flags, region, offset, size);
 
   return TRUE;
 }
@@ -755,6 +820,75 @@ gst_buffer_copy_deep (const GstBuffer * buffer)
       GST_BUFFER_COPY_ALL | GST_BUFFER_COPY_DEEP);
 }
 
+/**
+ * gst_buffer_make_metadata_writable:
+ * @buf: (transfer full): a #GstBuffer
+ *
+ * Returns a buffer of which the metadata, like the timestamps, flags and
+ * metas, can be changed. If @buf is writable it is returned, otherwise a new
+ * buffer referencing the memory of @buf is returned and @buf is unreffed.
+ *
+ * The memory stays shared with the other users of @buf, so it is only copied
+ * when it is mapped for writing, and the metas are copied as they are. Memory
+ * that has the #GST_MEMORY_FLAG_NO_SHARE flag set can't be shared, so when
+ * @buf contains such memory this falls back to gst_buffer_copy(), which
+ * copies that memory. Use this in elements that only change the metadata.
+ *
+ * Returns: (transfer full): a buffer with writable metadata
+ *
+ * Since: 1.24
+ */
+GstBuffer *
+gst_buffer_make_metadata_writable (GstBuffer * buf)
+{
+  GstBuffer *copy;
+  guint i, len;
+
+  g_return_val_if_fail (GST_IS_BUFFER (buf), NULL);
+
+  if (gst_buffer_is_writable (buf))
+    return buf;
+
+  len = GST_BUFFER_MEM_LEN (buf);
+  for (i = 0; i < len; i++) {
+    if (GST_MEMORY_FLAG_IS_SET (GST_BUFFER_MEM_PTR (buf, i),
+            GST_MEMORY_FLAG_NO_SHARE)) {
+      GST_CAT_LOG (GST_CAT_BUFFER, "buffer %p has memory that can't be "
+          "shared, doing a regular copy", buf);
+      copy = gst_buffer_copy (buf);
+      goto done;
+    }
+  }
+
+  copy = gst_buffer_new ();
+  gst_buffer_copy_into (copy, buf,
+      GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS, 0, -1);
+
+  for (i = 0; i < len; i++) {
+    GstMemory *mem = _memory_get_exclusive_reference (GST_BUFFER_MEM_PTR (buf,
+            i));
+
+    if (G_UNLIKELY (!mem)) {
+      /* fall back to the regular copy */
+      gst_buffer_unref (copy);
+      copy = gst_buffer_copy (buf);
+      goto done;
+    }
+    _memory_add (copy, -1, mem);
+  }
+
+  /* the memory layout is the same, so memory metas are still valid */
+  _copy_metas (copy, buf, GST_BUFFER_COPY_MEMORY | GST_BUFFER_COPY_META,
+      FALSE, 0, gst_buffer_get_size (buf));
+
+  GST_BUFFER_FLAG_UNSET (copy, GST_BUFFER_FLAG_TAG_MEMORY);
+
+done:
+  gst_buffer_unref (buf);
+
+  return copy;
+}
+
 /* the default dispose function revives the buffer and returns it to the
  * pool when there is a pool */
 static gboolean
@@ -831,6 +965,7 @@ gst_buffer_init (GstBufferImpl * buffer)
 
   GST_BUFFER_MEM_LEN (buffer) = 0;
   GST_BUFFER_META (buffer) = NULL;
+  memset (buffer->meta_index, 0, sizeof (buffer->meta_index));
 }
 
 /**
@@ -2231,10 +2366,17 @@ gst_buffer_get_meta (GstBuffer * buffer, GType api)
 {
   GstMetaItem *item;
   GstMeta *result = NULL;
+  gint slot;
 
   g_return_val_if_fail (buffer != NULL, NULL);
   g_return_val_if_fail (api != 0, NULL);
 
+  slot = _meta_api_slot (api);
+  if (slot >= 0) {
+    item = GST_BUFFER_META_INDEX (buffer, slot);
+    return item ? &item->meta : NULL;
+  }
+
   /* find GstMeta of the requested API */
   for (item = GST_BUFFER_META (buffer); item; item = item->next) {
     GstMeta *meta = &item->meta;
@@ -2285,6 +2427,7 @@ gst_buffer_add_meta (GstBuffer * buffer, const GstMetaInfo * info,
   GstMetaItem *item;
   GstMeta *result = NULL;
   gsize size;
+  gint slot;
 
   g_return_val_if_fail (buffer != NULL, NULL);
   g_return_val_if_fail (info != NULL, NULL);
@@ -2323,6 +2466,10 @@ gst_buffer_add_meta (GstBuffer * buffer, const GstMetaInfo * info,
     GST_BUFFER_TAIL_META (buffer) = item;
   }
 
+  slot = _meta_api_slot (info->api);
+  if (slot >= 0 && GST_BUFFER_META_INDEX (buffer, slot) == NULL)
+    GST_BUFFER_META_INDEX (buffer, slot) = item;
+
   return result;
 
 init_failed:
@@ -2360,6 +2507,8 @@ gst_buffer_remove_meta (GstBuffer * buffer, GstMeta * meta)
     if (m == meta) {
       const GstMetaInfo *info = meta->info;
 
+      _meta_index_remove (buffer, walk);
+
       /* remove from list */
       if (GST_BUFFER_TAIL_META (buffer) == walk) {
         if (prev != walk)
@@ -2448,12 +2597,19 @@ gst_buffer_iterate_meta_filtered (GstBuffer * buffer, gpointer * state,
   g_return_val_if_fail (state != NULL, NULL);
 
   meta = (GstMetaItem **) state;
-  if (*meta == NULL)
-    /* state NULL, move to first item */
+  if (*meta == NULL) {
+    gint slot = _meta_api_slot (meta_api_type);
+
+    /* state NULL, move to first item, the index has it directly */
+    if (slot >= 0) {
+      *meta = GST_BUFFER_META_INDEX (buffer, slot);
+      return *meta ? &(*meta)->meta : NULL;
+    }
     *meta = GST_BUFFER_META (buffer);
-  else
+  } else {
     /* state !NULL, move to next item in list */
     *meta = (*meta)->next;
+  }
 
   while (*meta != NULL && (*meta)->meta.info->api != meta_api_type)
     *meta = (*meta)->next;
@@ -2508,6 +2664,8 @@ gst_buffer_foreach_meta (GstBuffer * buffer, GstBufferForeachMetaFunc func,
       g_return_val_if_fail (!GST_META_FLAG_IS_SET (m, GST_META_FLAG_LOCKED),
           FALSE);
 
+      _meta_index_remove (buffer, walk);
+
       if (GST_BUFFER_TAIL_META (buffer) == walk) {
         if (prev != walk)
           GST_BUFFER_TAIL_META (buffer) = prev;
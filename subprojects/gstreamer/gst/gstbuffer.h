@@ -475,6 +475,9 @@ GstBuffer * gst_buffer_copy      (const GstBuffer * buf);
 GST_API
 GstBuffer * gst_buffer_copy_deep (const GstBuffer * buf);
 
+GST_API
+GstBuffer * gst_buffer_make_metadata_writable (GstBuffer * buf);
+
 /**
  * GstBufferCopyFlags:
  * @GST_BUFFER_COPY_NONE: copy nothing
@@ -561,7 +564,9 @@ gboolean        gst_buffer_copy_into            (GstBuffer *dest, GstBuffer *src
  * gst_buffer_copy(). The passed-in @buf will be unreffed in that case, and the
  * caller will now own a reference to the new returned buffer object. Note
  * that this just copies the buffer structure itself, the underlying memory is
- * not copied if it can be shared amongst multiple buffers.
+ * not copied if it can be shared amongst multiple buffers. Elements that only
+ * change the metadata can use gst_buffer_make_metadata_writable() instead,
+ * which never copies the memory.
  *
  * In short, this function unrefs the buf in the argument and refs the buffer
  * that it returns. Don't access the argument after calling this function unless
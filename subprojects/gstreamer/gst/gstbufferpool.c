@@ -59,6 +59,11 @@
  * The bufferpool can be deactivated again with gst_buffer_pool_set_active().
  * All further gst_buffer_pool_acquire_buffer() calls will return an error. When
  * all buffers are returned to the pool they will be freed.
+ *
+ * Since 1.24, a per-thread buffer cache can be enabled in the configuration
+ * with gst_buffer_pool_config_set_thread_cache_size(). Buffers released by a
+ * thread are then kept in a small thread-local cache and handed out again to
+ * the next acquire on the same thread without touching the shared free queue.
  */
 
 #include "gst_private.h"
@@ -110,8 +115,34 @@ struct _GstBufferPoolPrivate
   guint cur_buffers;
   GstAllocator *allocator;
   GstAllocationParams params;
+
+  /* per-thread buffer cache */
+  guint thread_cache_size;
+  GMutex magazines_lock;
+  GPtrArray *magazines;
+  gint waiters;                 /* number of threads about to wait for a buffer */
 };
 
+/* A magazine is a small per-thread stack of free buffers for one pool. It is
+ * only touched by its owner thread except when the pool is stopped or when
+ * an acquire would otherwise have to wait, in which case other threads steal
+ * from it. Overflow goes to the shared queue of the pool (the depot). */
+typedef struct
+{
+  gint refcount;
+  GMutex lock;
+  /* the pool this magazine belongs to, NULL once detached */
+  GstBufferPool *pool;
+  guint n_buffers;
+  guint size;
+  GstBuffer **buffers;
+} GstBufferPoolMagazine;
+
+static void thread_magazines_free (gpointer data);
+
+/* GPtrArray of magazines of the current thread */
+static GPrivate thread_magazines = G_PRIVATE_INIT (thread_magazines_free);
+
 static void gst_buffer_pool_dispose (GObject * object);
 static void gst_buffer_pool_finalize (GObject * object);
 
@@ -161,6 +192,8 @@ gst_buffer_pool_init (GstBufferPool * pool)
 
   priv->poll = gst_poll_new_timer ();
   priv->queue = gst_atomic_queue_new (16);
+  g_mutex_init (&priv->magazines_lock);
+  priv->magazines = g_ptr_array_new ();
   pool->flushing = 1;
   priv->active = FALSE;
   priv->configured = FALSE;
@@ -196,6 +229,263 @@ gst_buffer_pool_dispose (GObject * object)
   G_OBJECT_CLASS (gst_buffer_pool_parent_class)->dispose (object);
 }
 
+static GstBufferPoolMagazine *
+magazine_new (GstBufferPool * pool, guint size)
+{
+  GstBufferPoolMagazine *mag;
+
+  mag = g_new0 (GstBufferPoolMagazine, 1);
+  mag->refcount = 1;
+  g_mutex_init (&mag->lock);
+  mag->pool = pool;
+  mag->size = size;
+  mag->buffers = g_new0 (GstBuffer *, size);
+
+  return mag;
+}
+
+static GstBufferPoolMagazine *
+magazine_ref (GstBufferPoolMagazine * mag)
+{
+  g_atomic_int_inc (&mag->refcount);
+  return mag;
+}
+
+static void
+magazine_unref (GstBufferPoolMagazine * mag)
+{
+  if (g_atomic_int_dec_and_test (&mag->refcount)) {
+    g_assert (mag->n_buffers == 0);
+    g_free (mag->buffers);
+    g_mutex_clear (&mag->lock);
+    g_free (mag);
+  }
+}
+
+/* must be called with the magazine lock. Moves all but @keep buffers into the
+ * shared queue of @pool and wakes up waiters */
+static void
+magazine_flush_unlocked (GstBufferPool * pool, GstBufferPoolMagazine * mag,
+    guint keep)
+{
+  GstBufferPoolPrivate *priv = pool->priv;
+
+  while (mag->n_buffers > keep) {
+    GstBuffer *buffer = mag->buffers[--mag->n_buffers];
+
+    mag->buffers[mag->n_buffers] = NULL;
+    gst_atomic_queue_push (priv->queue, buffer);
+    gst_poll_write_control (priv->poll);
+  }
+}
+
+/* called when a thread exits, gives the cached buffers back to their pools */
+static void
+thread_magazines_free (gpointer data)
+{
+  GPtrArray *mags = data;
+  guint i;
+
+  for (i = 0; i < mags->len; i++) {
+    GstBufferPoolMagazine *mag = g_ptr_array_index (mags, i);
+    GstBufferPool *pool;
+
+    g_mutex_lock (&mag->lock);
+    /* the pool can't be finalized while we hold the lock, it would first have
+     * to detach us */
+    if ((pool = mag->pool)) {
+      magazine_flush_unlocked (pool, mag, 0);
+      g_atomic_pointer_set (&mag->pool, NULL);
+    }
+    g_mutex_unlock (&mag->lock);
+    magazine_unref (mag);
+  }
+  g_ptr_array_free (mags, TRUE);
+}
+
+/* must be called with the magazines lock. Drops the magazines of threads
+ * that exited */
+static void
+prune_magazines_unlocked (GstBufferPool * pool)
+{
+  GstBufferPoolPrivate *priv = pool->priv;
+  guint i;
+
+  for (i = 0; i < priv->magazines->len;) {
+    GstBufferPoolMagazine *mag = g_ptr_array_index (priv->magazines, i);
+
+    if (g_atomic_pointer_get (&mag->pool) == NULL) {
+      g_ptr_array_remove_index_fast (priv->magazines, i);
+      magazine_unref (mag);
+    } else {
+      i++;
+    }
+  }
+}
+
+/* get the magazine of the current thread for @pool, optionally creating it */
+static GstBufferPoolMagazine *
+get_thread_magazine (GstBufferPool * pool, gboolean create)
+{
+  GstBufferPoolPrivate *priv = pool->priv;
+  GstBufferPoolMagazine *mag;
+  GPtrArray *mags;
+  guint i;
+
+  mags = g_private_get (&thread_magazines);
+  if (mags) {
+    for (i = 0; i < mags->len;) {
+      GstBufferPool *owner;
+
+      mag = g_ptr_array_index (mags, i);
+      owner = g_atomic_pointer_get (&mag->pool);
+      if (owner == pool)
+        return mag;
+
+      if (owner == NULL) {
+        /* pool was reconfigured or finalized */
+        g_ptr_array_remove_index_fast (mags, i);
+        magazine_unref (mag);
+      } else {
+        i++;
+      }
+    }
+  }
+
+  if (!create)
+    return NULL;
+
+  if (!mags) {
+    mags = g_ptr_array_new ();
+    g_private_set (&thread_magazines, mags);
+  }
+
+  mag = magazine_new (pool, priv->thread_cache_size);
+
+  g_mutex_lock (&priv->magazines_lock);
+  prune_magazines_unlocked (pool);
+  g_ptr_array_add (priv->magazines, magazine_ref (mag));
+  g_mutex_unlock (&priv->magazines_lock);
+
+  g_ptr_array_add (mags, mag);
+
+  GST_DEBUG_OBJECT (pool, "created thread cache %p for thread %p", mag,
+      g_thread_self ());
+
+  return mag;
+}
+
+static GstBuffer *
+magazine_pop (GstBufferPool * pool)
+{
+  GstBufferPoolMagazine *mag;
+  GstBuffer *buffer = NULL;
+
+  if ((mag = get_thread_magazine (pool, FALSE))) {
+    g_mutex_lock (&mag->lock);
+    if (mag->n_buffers > 0) {
+      buffer = mag->buffers[--mag->n_buffers];
+      mag->buffers[mag->n_buffers] = NULL;
+    }
+    g_mutex_unlock (&mag->lock);
+  }
+  return buffer;
+}
+
+static void
+magazine_push (GstBufferPool * pool, GstBuffer * buffer)
+{
+  GstBufferPoolMagazine *mag;
+
+  mag = get_thread_magazine (pool, TRUE);
+
+  g_mutex_lock (&mag->lock);
+  /* when full, give half of the buffers back to the shared queue so that
+   * other threads can pick them up */
+  if (mag->n_buffers == mag->size)
+    magazine_flush_unlocked (pool, mag, mag->size / 2);
+  mag->buffers[mag->n_buffers++] = buffer;
+  /* someone is waiting for a buffer, make all of ours available */
+  if (G_UNLIKELY (g_atomic_int_get (&pool->priv->waiters) > 0))
+    magazine_flush_unlocked (pool, mag, 0);
+  g_mutex_unlock (&mag->lock);
+}
+
+/* take a buffer from the cache of any thread, used before waiting */
+static GstBuffer *
+steal_from_magazines (GstBufferPool * pool)
+{
+  GstBufferPoolPrivate *priv = pool->priv;
+  GstBuffer *buffer = NULL;
+  guint i;
+
+  g_mutex_lock (&priv->magazines_lock);
+  for (i = 0; i < priv->magazines->len && buffer == NULL; i++) {
+    GstBufferPoolMagazine *mag = g_ptr_array_index (priv->magazines, i);
+
+    g_mutex_lock (&mag->lock);
+    if (mag->n_buffers > 0) {
+      buffer = mag->buffers[--mag->n_buffers];
+      mag->buffers[mag->n_buffers] = NULL;
+    }
+    g_mutex_unlock (&mag->lock);
+  }
+  g_mutex_unlock (&priv->magazines_lock);
+
+  if (buffer)
+    GST_LOG_OBJECT (pool, "stole buffer %p from thread cache", buffer);
+
+  return buffer;
+}
+
+/* move the buffers of all thread caches into the shared queue */
+static void
+drain_magazines (GstBufferPool * pool)
+{
+  GstBufferPoolPrivate *priv = pool->priv;
+  guint i;
+
+  g_mutex_lock (&priv->magazines_lock);
+  for (i = 0; i < priv->magazines->len; i++) {
+    GstBufferPoolMagazine *mag = g_ptr_array_index (priv->magazines, i);
+
+    g_mutex_lock (&mag->lock);
+    if (mag->pool)
+      magazine_flush_unlocked (pool, mag, 0);
+    g_mutex_unlock (&mag->lock);
+  }
+  g_mutex_unlock (&priv->magazines_lock);
+}
+
+static void do_free_buffer (GstBufferPool * pool, GstBuffer * buffer);
+
+/* detach all thread caches from the pool, the threads will drop them the
+ * next time they look them up */
+static void
+detach_magazines (GstBufferPool * pool)
+{
+  GstBufferPoolPrivate *priv = pool->priv;
+  guint i;
+
+  g_mutex_lock (&priv->magazines_lock);
+  for (i = 0; i < priv->magazines->len; i++) {
+    GstBufferPoolMagazine *mag = g_ptr_array_index (priv->magazines, i);
+
+    g_mutex_lock (&mag->lock);
+    while (mag->n_buffers > 0) {
+      GstBuffer *buffer = mag->buffers[--mag->n_buffers];
+
+      mag->buffers[mag->n_buffers] = NULL;
+      do_free_buffer (pool, buffer);
+    }
+    g_atomic_pointer_set (&mag->pool, NULL);
+    g_mutex_unlock (&mag->lock);
+    magazine_unref (mag);
+  }
+  g_ptr_array_set_size (priv->magazines, 0);
+  g_mutex_unlock (&priv->magazines_lock);
+}
+
 static void
 gst_buffer_pool_finalize (GObject * object)
 {
@@ -207,6 +497,9 @@ gst_buffer_pool_finalize (GObject * object)
 
   GST_DEBUG_OBJECT (pool, "%p finalize", pool);
 
+  detach_magazines (pool);
+  g_ptr_array_free (priv->magazines, TRUE);
+  g_mutex_clear (&priv->magazines_lock);
   gst_atomic_queue_unref (priv->queue);
   gst_poll_free (priv->poll);
   gst_structure_free (priv->config);
@@ -436,6 +729,9 @@ do_stop (GstBufferPool * pool)
     pclass = GST_BUFFER_POOL_GET_CLASS (pool);
 
     GST_LOG_OBJECT (pool, "stopping");
+    /* give the buffers in the thread caches back to the queue so that the
+     * stop function can free them */
+    drain_magazines (pool);
     if (G_LIKELY (pclass->stop)) {
       if (!pclass->stop (pool))
         return FALSE;
@@ -607,7 +903,7 @@ default_set_config (GstBufferPool * pool, GstStructure * config)
 {
   GstBufferPoolPrivate *priv = pool->priv;
   GstCaps *caps;
-  guint size, min_buffers, max_buffers;
+  guint size, min_buffers, max_buffers, thread_cache_size;
   GstAllocator *allocator;
   GstAllocationParams params;
 
@@ -619,8 +915,16 @@ default_set_config (GstBufferPool * pool, GstStructure * config)
   if (!gst_buffer_pool_config_get_allocator (config, &allocator, &params))
     goto wrong_config;
 
+  if (!gst_buffer_pool_config_get_thread_cache_size (config,
+          &thread_cache_size))
+    thread_cache_size = 0;
+
   GST_DEBUG_OBJECT (pool, "config %" GST_PTR_FORMAT, config);
 
+  /* the existing thread caches might have the wrong size */
+  detach_magazines (pool);
+  priv->thread_cache_size = thread_cache_size;
+
   priv->size = size;
   priv->min_buffers = min_buffers;
   priv->max_buffers = max_buffers;
@@ -1105,17 +1409,83 @@ gst_buffer_pool_config_validate_params (GstStructure * config, GstCaps * caps,
   return ret;
 }
 
+/**
+ * gst_buffer_pool_config_set_thread_cache_size:
+ * @config: a #GstBufferPool configuration
+ * @size: the maximum number of buffers to cache per thread or 0 to disable
+ *
+ * Configures a per-thread buffer cache of @size buffers in @config.
+ *
+ * When enabled, buffers released to the pool are kept in a cache that is
+ * local to the releasing thread and are handed out again to acquires on the
+ * same thread without touching the shared free queue of the pool. When the
+ * cache of a thread is full, half of it is moved to the shared queue. When
+ * the pool would have to wait for a free buffer, the caches of all threads
+ * are made available again.
+ *
+ * This is only supported by pools that use the default acquire and release
+ * implementation.
+ *
+ * Since: 1.24
+ */
+void
+gst_buffer_pool_config_set_thread_cache_size (GstStructure * config,
+    guint size)
+{
+  g_return_if_fail (config != NULL);
+
+  gst_structure_id_set (config,
+      GST_QUARK (THREAD_CACHE_SIZE), G_TYPE_UINT, size, NULL);
+}
+
+/**
+ * gst_buffer_pool_config_get_thread_cache_size:
+ * @config: (transfer none): a #GstBufferPool configuration
+ * @size: (out) (optional): the maximum number of buffers cached per thread
+ *
+ * Gets the per-thread buffer cache size from @config.
+ *
+ * Returns: %TRUE if the thread cache size was set in @config.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_buffer_pool_config_get_thread_cache_size (GstStructure * config,
+    guint * size)
+{
+  guint cache_size;
+
+  g_return_val_if_fail (config != NULL, FALSE);
+
+  if (!gst_structure_id_get (config,
+          GST_QUARK (THREAD_CACHE_SIZE), G_TYPE_UINT, &cache_size, NULL))
+    return FALSE;
+
+  if (size)
+    *size = cache_size;
+
+  return TRUE;
+}
+
 static GstFlowReturn
 default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
     GstBufferPoolAcquireParams * params)
 {
   GstFlowReturn result;
   GstBufferPoolPrivate *priv = pool->priv;
+  gboolean thread_cache = priv->thread_cache_size > 0;
 
   while (TRUE) {
     if (G_UNLIKELY (GST_BUFFER_POOL_IS_FLUSHING (pool)))
       goto flushing;
 
+    /* try the cache of the current thread first */
+    if (thread_cache && (*buffer = magazine_pop (pool))) {
+      result = GST_FLOW_OK;
+      GST_LOG_OBJECT (pool, "acquired buffer %p from thread cache", *buffer);
+      break;
+    }
+
     /* try to get a buffer from the queue */
     *buffer = gst_atomic_queue_pop (priv->queue);
     if (G_LIKELY (*buffer)) {
@@ -1146,9 +1516,23 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
       /* something went wrong, return error */
       break;
 
+    if (thread_cache) {
+      /* announce that we are going to wait so that releasing threads put
+       * their buffers in the shared queue, then check if other threads have
+       * buffers cached */
+      g_atomic_int_inc (&priv->waiters);
+      if ((*buffer = steal_from_magazines (pool))) {
+        g_atomic_int_add (&priv->waiters, -1);
+        result = GST_FLOW_OK;
+        break;
+      }
+    }
+
     /* check if we need to wait */
     if (params && (params->flags & GST_BUFFER_POOL_ACQUIRE_FLAG_DONTWAIT)) {
       GST_LOG_OBJECT (pool, "no more buffers");
+      if (thread_cache)
+        g_atomic_int_add (&priv->waiters, -1);
       break;
     }
 
@@ -1165,6 +1549,8 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
         gst_poll_wait (priv->poll, GST_CLOCK_TIME_NONE);
       } else {
         /* This is a critical error, GstPoll already gave a warning */
+        if (thread_cache)
+          g_atomic_int_add (&priv->waiters, -1);
         result = GST_FLOW_ERROR;
         break;
       }
@@ -1181,6 +1567,9 @@ default_acquire_buffer (GstBufferPool * pool, GstBuffer ** buffer,
       }
       gst_poll_write_control (pool->priv->poll);
     }
+
+    if (thread_cache)
+      g_atomic_int_add (&priv->waiters, -1);
   }
 
   return result;
@@ -1324,6 +1713,14 @@ default_release_buffer (GstBufferPool * pool, GstBuffer * buffer)
   if (G_UNLIKELY (!gst_buffer_is_all_memory_writable (buffer)))
     goto not_writable;
 
+  /* keep it around in the cache of this thread, buffers released while
+   * flushing go to the queue directly so they can be freed when stopping */
+  if (pool->priv->thread_cache_size > 0
+      && !GST_BUFFER_POOL_IS_FLUSHING (pool)) {
+    magazine_push (pool, buffer);
+    return;
+  }
+
   /* keep it around in our queue */
   gst_atomic_queue_push (pool->priv->queue, buffer);
   gst_poll_write_control (pool->priv->poll);
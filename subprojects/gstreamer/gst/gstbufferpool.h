@@ -336,6 +336,12 @@ GST_API
 gboolean         gst_buffer_pool_config_validate_params (GstStructure *config, GstCaps *caps,
                                                          guint size, guint min_buffers, guint max_buffers);
 
+GST_API
+void             gst_buffer_pool_config_set_thread_cache_size (GstStructure *config, guint size);
+
+GST_API
+gboolean         gst_buffer_pool_config_get_thread_cache_size (GstStructure *config, guint *size);
+
 /* buffer management */
 
 GST_API
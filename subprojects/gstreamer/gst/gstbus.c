@@ -44,6 +44,14 @@
  * gst_bus_peek() and gst_bus_pop() methods one can look at or retrieve a
  * previously posted message.
  *
+ * #GST_MESSAGE_QOS, #GST_MESSAGE_BUFFERING and #GST_MESSAGE_DURATION_CHANGED
+ * messages only describe the latest state of their source. When one of them
+ * is posted while the last queued message is one of the same type from the
+ * same source, that queued message takes over the contents of the new one
+ * instead of a second message being queued. Messages are never coalesced
+ * across other messages, so the order of the messages on the bus is kept.
+ * The sync handler still sees every message.
+ *
  * The bus can be polled with the gst_bus_poll() method. This methods blocks
  * up to the specified timeout value until one of the specified messages types
  * is posted on the bus. The application can then gst_bus_pop() the messages
@@ -137,10 +145,54 @@ sync_handler_unref (SyncHandler * handler)
   g_free (handler);
 }
 
+/* These messages only report the latest state of their source. A newer one
+ * replaces the contents of one from the same source that is still queued,
+ * so a slow consumer doesn't make the queue grow. */
+static inline gboolean
+gst_bus_message_coalesces (GstMessage * message)
+{
+  if (GST_MESSAGE_SRC (message) == NULL)
+    return FALSE;
+
+  switch (GST_MESSAGE_TYPE (message)) {
+    case GST_MESSAGE_QOS:
+    case GST_MESSAGE_BUFFERING:
+    case GST_MESSAGE_DURATION_CHANGED:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
+static guint
+coalesce_message_hash (gconstpointer key)
+{
+  GstMessage *message = (GstMessage *) key;
+
+  return g_direct_hash (GST_MESSAGE_SRC (message)) ^
+      GST_MESSAGE_TYPE (message);
+}
+
+static gboolean
+coalesce_message_equal (gconstpointer a, gconstpointer b)
+{
+  GstMessage *message1 = (GstMessage *) a;
+  GstMessage *message2 = (GstMessage *) b;
+
+  return GST_MESSAGE_SRC (message1) == GST_MESSAGE_SRC (message2) &&
+      GST_MESSAGE_TYPE (message1) == GST_MESSAGE_TYPE (message2);
+}
+
 struct _GstBusPrivate
 {
   GstAtomicQueue *queue;
   GMutex queue_lock;
+  /* queued messages that newer ones can be coalesced into, protected by
+   * queue_lock */
+  GHashTable *coalesce;
+  /* the message pushed last on the queue, only compared against and never
+   * dereferenced as it might have been popped and freed already */
+  gpointer tail;
 
   SyncHandler *sync_handler;
 
@@ -252,6 +304,8 @@ gst_bus_init (GstBus * bus)
   bus->priv->enable_async = DEFAULT_ENABLE_ASYNC;
   g_mutex_init (&bus->priv->queue_lock);
   bus->priv->queue = gst_atomic_queue_new (32);
+  bus->priv->coalesce =
+      g_hash_table_new (coalesce_message_hash, coalesce_message_equal);
 
   GST_DEBUG_OBJECT (bus, "created");
 }
@@ -272,6 +326,8 @@ gst_bus_dispose (GObject * object)
     } while (message != NULL);
     gst_atomic_queue_unref (bus->priv->queue);
     bus->priv->queue = NULL;
+    g_hash_table_unref (bus->priv->coalesce);
+    bus->priv->coalesce = NULL;
     g_mutex_unlock (&bus->priv->queue_lock);
     g_mutex_clear (&bus->priv->queue_lock);
 
@@ -315,6 +371,37 @@ gst_bus_new (void)
   return result;
 }
 
+/* Queues @message, or folds it into the queued message of the same type from
+ * the same source when that is the last queued message, so that the new
+ * contents don't overtake messages posted in between. The lookup and the
+ * push happen under the queue lock so that a consumer can't pop the pending
+ * message while it is being updated. */
+static void
+gst_bus_push_coalesced (GstBus * bus, GstMessage * message)
+{
+  GstMessage *pending;
+
+  g_mutex_lock (&bus->priv->queue_lock);
+  pending = g_hash_table_lookup (bus->priv->coalesce, message);
+  if (pending && pending == g_atomic_pointer_get (&bus->priv->tail)
+      && priv_gst_message_coalesce (pending, message)) {
+    g_mutex_unlock (&bus->priv->queue_lock);
+
+    GST_DEBUG_OBJECT (bus, "[msg %p] coalesced into pending message %p",
+        message, pending);
+    gst_message_unref (message);
+    return;
+  }
+
+  GST_DEBUG_OBJECT (bus, "[msg %p] pushing on async queue", message);
+  g_hash_table_add (bus->priv->coalesce, message);
+  gst_atomic_queue_push (bus->priv->queue, message);
+  g_atomic_pointer_set (&bus->priv->tail, message);
+  gst_poll_write_control (bus->priv->poll);
+  g_mutex_unlock (&bus->priv->queue_lock);
+  GST_DEBUG_OBJECT (bus, "[msg %p] pushed on async queue", message);
+}
+
 /**
  * gst_bus_post:
  * @bus: a #GstBus to post on
@@ -378,8 +465,13 @@ gst_bus_post (GstBus * bus, GstMessage * message)
       break;
     case GST_BUS_PASS:
       /* pass the message to the async queue, refcount passed in the queue */
+      if (gst_bus_message_coalesces (message)) {
+        gst_bus_push_coalesced (bus, message);
+        break;
+      }
       GST_DEBUG_OBJECT (bus, "[msg %p] pushing on async queue", message);
       gst_atomic_queue_push (bus->priv->queue, message);
+      g_atomic_pointer_set (&bus->priv->tail, message);
       gst_poll_write_control (bus->priv->poll);
       GST_DEBUG_OBJECT (bus, "[msg %p] pushed on async queue", message);
 
@@ -404,6 +496,7 @@ gst_bus_post (GstBus * bus, GstMessage * message)
       g_mutex_lock (lock);
 
       gst_atomic_queue_push (bus->priv->queue, message);
+      g_atomic_pointer_set (&bus->priv->tail, message);
       gst_poll_write_control (bus->priv->poll);
 
       /* now block till the message is freed */
@@ -538,6 +631,10 @@ gst_bus_timed_pop_filtered (GstBus * bus, GstClockTime timeout,
         gst_atomic_queue_length (bus->priv->queue));
 
     while ((message = gst_atomic_queue_pop (bus->priv->queue))) {
+      if (gst_bus_message_coalesces (message) &&
+          g_hash_table_lookup (bus->priv->coalesce, message) == message)
+        g_hash_table_remove (bus->priv->coalesce, message);
+
       if (bus->priv->poll) {
         while (!gst_poll_read_control (bus->priv->poll)) {
           if (errno == EWOULDBLOCK) {
@@ -129,6 +129,9 @@ static void gst_caps_transform_to_string (const GValue * src_value,
     GValue * dest_value);
 static gboolean gst_caps_from_string_inplace (GstCaps * caps,
     const gchar * string);
+static void caps_cache_clear (void);
+static gboolean gst_caps_can_intersect_zig_zag (const GstCaps * caps1,
+    const GstCaps * caps2);
 
 GType _gst_caps_type = 0;
 GstCaps *_gst_caps_any;
@@ -151,6 +154,7 @@ _priv_gst_caps_initialize (void)
 void
 _priv_gst_caps_cleanup (void)
 {
+  caps_cache_clear ();
   gst_caps_unref (_gst_caps_any);
   _gst_caps_any = NULL;
   gst_caps_unref (_gst_caps_none);
@@ -189,6 +193,321 @@ _gst_caps_copy (const GstCaps * caps)
   return newcaps;
 }
 
+/* Cache of intersection and subset results
+ *
+ * Negotiation tends to do the same operations on identical caps over and
+ * over again. The operands are interned by content into private copies
+ * that can't change, and the results are kept in a small LRU keyed on the
+ * interned operands. Only operations comparing enough structure pairs are
+ * cached, for single structures the lookup costs about as much as the
+ * operation itself.
+ *
+ * Intersection results are copied out of the cache, gst_caps_intersect()
+ * was always documented to return new caps and callers do modify them.
+ */
+#define CAPS_CACHE_SIZE 256
+#define CAPS_CACHE_MIN_PAIRS 4
+
+typedef enum
+{
+  CAPS_CACHE_INTERSECT_ZIG_ZAG = GST_CAPS_INTERSECT_ZIG_ZAG,
+  CAPS_CACHE_INTERSECT_FIRST = GST_CAPS_INTERSECT_FIRST,
+  CAPS_CACHE_IS_SUBSET,
+  CAPS_CACHE_CAN_INTERSECT,
+} GstCapsCacheOp;
+
+typedef struct
+{
+  guint hash;
+  GstCaps *caps;
+  /* number of cache entries using this */
+  guint n_entries;
+} GstCapsInterned;
+
+typedef struct
+{
+  GstCapsInterned *caps1;
+  GstCapsInterned *caps2;
+  GstCapsCacheOp op;
+
+  GstCaps *result;
+  gboolean value;
+
+  GList link;
+} GstCapsCacheEntry;
+
+/* Recursive: comparing caps values nested in structures ends up in
+ * gst_caps_is_subset() again, these nested calls bypass the cache */
+static GRecMutex caps_cache_lock;
+static gboolean caps_cache_busy = FALSE;
+static GHashTable *caps_intern_table = NULL;
+static GHashTable *caps_cache_table = NULL;
+static GQueue caps_cache_lru = G_QUEUE_INIT;
+
+static guint
+caps_cache_hash_caps (const GstCaps * caps)
+{
+  guint hash = GST_CAPS_LEN (caps);
+  guint i, j, len = GST_CAPS_LEN (caps);
+
+  for (i = 0; i < len; i++) {
+    GstStructure *s = gst_caps_get_structure_unchecked (caps, i);
+    GstCapsFeatures *f = gst_caps_get_features_unchecked (caps, i);
+
+    hash = hash * 31 + priv_gst_structure_hash (s);
+
+    /* gst_caps_features_is_equal() ignores the order */
+    if (f && gst_caps_features_is_any (f)) {
+      hash = hash * 31 + 1;
+    } else if (f
+        && !gst_caps_features_is_equal (f,
+            GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY)) {
+      guint fhash = 0;
+
+      for (j = 0; j < gst_caps_features_get_size (f); j++)
+        fhash += gst_caps_features_get_nth_id (f, j);
+      hash = hash * 31 + fhash;
+    }
+  }
+
+  return hash;
+}
+
+static gboolean
+caps_cache_caps_is_identical (const GstCaps * caps1, const GstCaps * caps2)
+{
+  guint i, len;
+
+  if (caps1 == caps2)
+    return TRUE;
+
+  if (GST_CAPS_FLAGS (caps1) != GST_CAPS_FLAGS (caps2))
+    return FALSE;
+
+  len = GST_CAPS_LEN (caps1);
+  if (len != GST_CAPS_LEN (caps2))
+    return FALSE;
+
+  for (i = 0; i < len; i++) {
+    GstCapsFeatures *f1 = gst_caps_get_features_unchecked (caps1, i);
+    GstCapsFeatures *f2 = gst_caps_get_features_unchecked (caps2, i);
+
+    if (!f1)
+      f1 = GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY;
+    if (!f2)
+      f2 = GST_CAPS_FEATURES_MEMORY_SYSTEM_MEMORY;
+
+    if (gst_caps_features_is_any (f1) != gst_caps_features_is_any (f2) ||
+        !gst_caps_features_is_equal (f1, f2) ||
+        !priv_gst_structure_is_identical (gst_caps_get_structure_unchecked
+            (caps1, i), gst_caps_get_structure_unchecked (caps2, i)))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
+static guint
+caps_interned_hash (gconstpointer key)
+{
+  return ((const GstCapsInterned *) key)->hash;
+}
+
+static gboolean
+caps_interned_equal (gconstpointer a, gconstpointer b)
+{
+  const GstCapsInterned *ia = a, *ib = b;
+
+  return ia->hash == ib->hash
+      && caps_cache_caps_is_identical (ia->caps, ib->caps);
+}
+
+static void
+caps_interned_free (GstCapsInterned * interned)
+{
+  gst_caps_unref (interned->caps);
+  g_free (interned);
+}
+
+static guint
+caps_cache_entry_hash (gconstpointer key)
+{
+  const GstCapsCacheEntry *entry = key;
+
+  return (g_direct_hash (entry->caps1) * 31 +
+      g_direct_hash (entry->caps2)) * 31 + entry->op;
+}
+
+static gboolean
+caps_cache_entry_equal (gconstpointer a, gconstpointer b)
+{
+  const GstCapsCacheEntry *ea = a, *eb = b;
+
+  return ea->caps1 == eb->caps1 && ea->caps2 == eb->caps2 && ea->op == eb->op;
+}
+
+static GstCapsInterned *
+caps_cache_intern (const GstCaps * caps, guint hash)
+{
+  GstCapsInterned key = { hash, (GstCaps *) caps, 0 };
+  GstCapsInterned *interned;
+
+  interned = g_hash_table_lookup (caps_intern_table, &key);
+  if (!interned) {
+    interned = g_new0 (GstCapsInterned, 1);
+    interned->hash = hash;
+    /* a private copy, that nobody else can modify */
+    interned->caps = _gst_caps_copy (caps);
+    GST_MINI_OBJECT_FLAG_SET (interned->caps,
+        GST_MINI_OBJECT_FLAG_MAY_BE_LEAKED);
+    g_hash_table_add (caps_intern_table, interned);
+  }
+
+  return interned;
+}
+
+static void
+caps_cache_release (GstCapsInterned * interned)
+{
+  if (interned->n_entries == 0)
+    g_hash_table_remove (caps_intern_table, interned);
+}
+
+static void
+caps_cache_entry_free (GstCapsCacheEntry * entry)
+{
+  entry->caps1->n_entries--;
+  entry->caps2->n_entries--;
+  caps_cache_release (entry->caps1);
+  if (entry->caps2 != entry->caps1)
+    caps_cache_release (entry->caps2);
+  if (entry->result)
+    gst_caps_unref (entry->result);
+  g_free (entry);
+}
+
+static inline gboolean
+caps_cache_applies (const GstCaps * caps1, const GstCaps * caps2)
+{
+  return (guint64) GST_CAPS_LEN (caps1) * GST_CAPS_LEN (caps2) >=
+      CAPS_CACHE_MIN_PAIRS;
+}
+
+/* Returns %TRUE if the result of @op is cached and sets either @result or
+ * @value */
+static gboolean
+caps_cache_lookup (const GstCaps * caps1, guint hash1, const GstCaps * caps2,
+    guint hash2, GstCapsCacheOp op, GstCaps ** result, gboolean * value)
+{
+  GstCapsInterned key1 = { hash1, (GstCaps *) caps1, 0 };
+  GstCapsInterned key2 = { hash2, (GstCaps *) caps2, 0 };
+  GstCapsCacheEntry key, *entry = NULL;
+
+  g_rec_mutex_lock (&caps_cache_lock);
+  if (caps_cache_busy || !caps_cache_table) {
+    g_rec_mutex_unlock (&caps_cache_lock);
+    return FALSE;
+  }
+  caps_cache_busy = TRUE;
+
+  key.caps1 = g_hash_table_lookup (caps_intern_table, &key1);
+  key.caps2 = key.caps1 ? g_hash_table_lookup (caps_intern_table, &key2) : NULL;
+  key.op = op;
+  if (key.caps2)
+    entry = g_hash_table_lookup (caps_cache_table, &key);
+
+  if (entry) {
+    g_queue_unlink (&caps_cache_lru, &entry->link);
+    g_queue_push_head_link (&caps_cache_lru, &entry->link);
+    /* Callers expect new caps they can modify, copying is still much cheaper
+     * than the operation */
+    if (result)
+      *result = _gst_caps_copy (entry->result);
+    if (value)
+      *value = entry->value;
+  }
+
+  caps_cache_busy = FALSE;
+  g_rec_mutex_unlock (&caps_cache_lock);
+
+  return entry != NULL;
+}
+
+static void
+caps_cache_store (const GstCaps * caps1, guint hash1, const GstCaps * caps2,
+    guint hash2, GstCapsCacheOp op, GstCaps * result, gboolean value)
+{
+  GstCapsInterned *interned1, *interned2;
+  GstCapsCacheEntry key, *entry;
+
+  g_rec_mutex_lock (&caps_cache_lock);
+  if (caps_cache_busy) {
+    g_rec_mutex_unlock (&caps_cache_lock);
+    return;
+  }
+  caps_cache_busy = TRUE;
+
+  if (!caps_cache_table) {
+    caps_intern_table = g_hash_table_new_full (caps_interned_hash,
+        caps_interned_equal, (GDestroyNotify) caps_interned_free, NULL);
+    caps_cache_table = g_hash_table_new (caps_cache_entry_hash,
+        caps_cache_entry_equal);
+  }
+
+  interned1 = caps_cache_intern (caps1, hash1);
+  interned2 = caps_cache_intern (caps2, hash2);
+
+  key.caps1 = interned1;
+  key.caps2 = interned2;
+  key.op = op;
+  if (g_hash_table_contains (caps_cache_table, &key)) {
+    /* raced with another thread */
+    caps_cache_release (interned1);
+    if (interned2 != interned1)
+      caps_cache_release (interned2);
+  } else {
+    entry = g_new0 (GstCapsCacheEntry, 1);
+    entry->caps1 = interned1;
+    entry->caps2 = interned2;
+    interned1->n_entries++;
+    interned2->n_entries++;
+    entry->op = op;
+    if (result) {
+      entry->result = _gst_caps_copy (result);
+      GST_MINI_OBJECT_FLAG_SET (entry->result,
+          GST_MINI_OBJECT_FLAG_MAY_BE_LEAKED);
+    }
+    entry->value = value;
+    entry->link.data = entry;
+
+    g_hash_table_add (caps_cache_table, entry);
+    g_queue_push_head_link (&caps_cache_lru, &entry->link);
+
+    while (caps_cache_lru.length > CAPS_CACHE_SIZE) {
+      GList *link = g_queue_pop_tail_link (&caps_cache_lru);
+
+      g_hash_table_remove (caps_cache_table, link->data);
+      caps_cache_entry_free (link->data);
+    }
+  }
+
+  caps_cache_busy = FALSE;
+  g_rec_mutex_unlock (&caps_cache_lock);
+}
+
+static void
+caps_cache_clear (void)
+{
+  GList *link;
+
+  g_rec_mutex_lock (&caps_cache_lock);
+  while ((link = g_queue_pop_tail_link (&caps_cache_lru)))
+    caps_cache_entry_free (link->data);
+  g_clear_pointer (&caps_cache_table, g_hash_table_unref);
+  g_clear_pointer (&caps_intern_table, g_hash_table_unref);
+  g_rec_mutex_unlock (&caps_cache_lock);
+}
+
 /* creation/deletion */
 static void
 _gst_caps_free (GstCaps * caps)
@@ -1324,6 +1643,8 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
   GstStructure *s1, *s2;
   GstCapsFeatures *f1, *f2;
   gboolean ret = TRUE;
+  gboolean cache;
+  guint hash1 = 0, hash2 = 0;
   gint i, j;
 
   g_return_val_if_fail (subset != NULL, FALSE);
@@ -1334,6 +1655,15 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
   if (CAPS_IS_ANY (subset) || CAPS_IS_EMPTY (superset))
     return FALSE;
 
+  cache = caps_cache_applies (subset, superset);
+  if (cache) {
+    hash1 = caps_cache_hash_caps (subset);
+    hash2 = caps_cache_hash_caps (superset);
+    if (caps_cache_lookup (subset, hash1, superset, hash2,
+            CAPS_CACHE_IS_SUBSET, NULL, &ret))
+      return ret;
+  }
+
   for (i = GST_CAPS_LEN (subset) - 1; i >= 0; i--) {
     s1 = gst_caps_get_structure_unchecked (subset, i);
     f1 = gst_caps_get_features_unchecked (subset, i);
@@ -1362,6 +1692,10 @@ gst_caps_is_subset (const GstCaps * subset, const GstCaps * superset)
     }
   }
 
+  if (cache)
+    caps_cache_store (subset, hash1, superset, hash2, CAPS_CACHE_IS_SUBSET,
+        NULL, ret);
+
   return ret;
 }
 
@@ -1538,12 +1872,8 @@ gst_caps_is_strictly_equal (const GstCaps * caps1, const GstCaps * caps2)
 gboolean
 gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
 {
-  guint64 i;                    /* index can be up to 2 * G_MAX_UINT */
-  guint j, k, len1, len2;
-  GstStructure *struct1;
-  GstStructure *struct2;
-  GstCapsFeatures *features1;
-  GstCapsFeatures *features2;
+  guint hash1, hash2;
+  gboolean ret;
 
   g_return_val_if_fail (GST_IS_CAPS (caps1), FALSE);
   g_return_val_if_fail (GST_IS_CAPS (caps2), FALSE);
@@ -1560,6 +1890,32 @@ gst_caps_can_intersect (const GstCaps * caps1, const GstCaps * caps2)
   if (G_UNLIKELY (CAPS_IS_ANY (caps1) || CAPS_IS_ANY (caps2)))
     return TRUE;
 
+  if (!caps_cache_applies (caps1, caps2))
+    return gst_caps_can_intersect_zig_zag (caps1, caps2);
+
+  hash1 = caps_cache_hash_caps (caps1);
+  hash2 = caps_cache_hash_caps (caps2);
+  if (caps_cache_lookup (caps1, hash1, caps2, hash2, CAPS_CACHE_CAN_INTERSECT,
+          NULL, &ret))
+    return ret;
+
+  ret = gst_caps_can_intersect_zig_zag (caps1, caps2);
+  caps_cache_store (caps1, hash1, caps2, hash2, CAPS_CACHE_CAN_INTERSECT,
+      NULL, ret);
+
+  return ret;
+}
+
+static gboolean
+gst_caps_can_intersect_zig_zag (const GstCaps * caps1, const GstCaps * caps2)
+{
+  guint64 i;                    /* index can be up to 2 * G_MAX_UINT */
+  guint j, k, len1, len2;
+  GstStructure *struct1;
+  GstStructure *struct2;
+  GstCapsFeatures *features1;
+  GstCapsFeatures *features2;
+
   /* run zigzag on top line then right line, this preserves the caps order
    * much better than a simple loop.
    *
@@ -1755,6 +2111,10 @@ GstCaps *
 gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
     GstCapsIntersectMode mode)
 {
+  GstCaps *result;
+  gboolean cache;
+  guint hash1 = 0, hash2 = 0;
+
   g_return_val_if_fail (GST_IS_CAPS (caps1), NULL);
   g_return_val_if_fail (GST_IS_CAPS (caps2), NULL);
 
@@ -1774,15 +2134,30 @@ gst_caps_intersect_full (GstCaps * caps1, GstCaps * caps2,
   if (G_UNLIKELY (CAPS_IS_ANY (caps2)))
     return gst_caps_ref (caps1);
 
-  switch (mode) {
-    case GST_CAPS_INTERSECT_FIRST:
-      return gst_caps_intersect_first (caps1, caps2);
-    default:
-      g_warning ("Unknown caps intersect mode: %d", mode);
-      /* fallthrough */
-    case GST_CAPS_INTERSECT_ZIG_ZAG:
-      return gst_caps_intersect_zig_zag (caps1, caps2);
+  if (mode != GST_CAPS_INTERSECT_FIRST && mode != GST_CAPS_INTERSECT_ZIG_ZAG) {
+    g_warning ("Unknown caps intersect mode: %d", mode);
+    mode = GST_CAPS_INTERSECT_ZIG_ZAG;
   }
+
+  cache = caps_cache_applies (caps1, caps2);
+  if (cache) {
+    hash1 = caps_cache_hash_caps (caps1);
+    hash2 = caps_cache_hash_caps (caps2);
+    if (caps_cache_lookup (caps1, hash1, caps2, hash2,
+            (GstCapsCacheOp) mode, &result, NULL))
+      return result;
+  }
+
+  if (mode == GST_CAPS_INTERSECT_FIRST)
+    result = gst_caps_intersect_first (caps1, caps2);
+  else
+    result = gst_caps_intersect_zig_zag (caps1, caps2);
+
+  if (cache)
+    caps_cache_store (caps1, hash1, caps2, hash2, (GstCapsCacheOp) mode,
+        result, FALSE);
+
+  return result;
 }
 
 /**
@@ -176,6 +176,34 @@ gst_element_factory_cleanup (GstElementFactory * factory)
 
   g_list_free (factory->interfaces);
   factory->interfaces = NULL;
+
+  factory->metadata_string = NULL;
+  g_clear_pointer (&factory->cache, g_bytes_unref);
+}
+
+/* Factories loaded from the registry cache only parse their metadata when it
+ * is first asked for */
+static GstStructure *
+gst_element_factory_get_metadata_structure (GstElementFactory * factory)
+{
+  GstStructure *metadata = g_atomic_pointer_get (&factory->metadata);
+
+  if (G_UNLIKELY (metadata == NULL && factory->metadata_string != NULL)) {
+    metadata = gst_structure_from_string (factory->metadata_string, NULL);
+    if (metadata == NULL) {
+      GST_ERROR_OBJECT (factory, "Error when trying to deserialize structure "
+          "for metadata '%s'", factory->metadata_string);
+      return NULL;
+    }
+
+    if (!g_atomic_pointer_compare_and_exchange (&factory->metadata, NULL,
+            metadata)) {
+      gst_structure_free (metadata);
+      metadata = g_atomic_pointer_get (&factory->metadata);
+    }
+  }
+
+  return metadata;
 }
 
 #define CHECK_METADATA_FIELD(klass, name, key)                                 \
@@ -873,7 +901,8 @@ gst_element_factory_get_metadata (GstElementFactory * factory,
 {
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  return gst_structure_get_string ((GstStructure *) factory->metadata, key);
+  return gst_structure_get_string (gst_element_factory_get_metadata_structure
+      (factory), key);
 }
 
 /**
@@ -895,7 +924,7 @@ gst_element_factory_get_metadata_keys (GstElementFactory * factory)
 
   g_return_val_if_fail (GST_IS_ELEMENT_FACTORY (factory), NULL);
 
-  metadata = (GstStructure *) factory->metadata;
+  metadata = gst_element_factory_get_metadata_structure (factory);
   if (metadata == NULL)
     return NULL;
 
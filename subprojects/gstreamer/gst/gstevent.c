@@ -359,6 +359,34 @@ had_parent:
   }
 }
 
+/* Creates an event with a new structure holding the given fields. The
+ * structure is allocated in the same block as the event, so this takes a
+ * single allocation instead of the two of gst_event_new_custom(). */
+static GstEvent *
+gst_event_new_with_fields (GstEventType type, GQuark name_quark,
+    GQuark field_quark, ...)
+{
+  GstEventImpl *event = NULL;
+  GstStructure *structure;
+  va_list varargs;
+
+  va_start (varargs, field_quark);
+  structure = priv_gst_structure_new_id_valist_with_header (sizeof
+      (GstEventImpl), (gpointer *) & event, name_quark, field_quark, varargs);
+  va_end (varargs);
+
+  GST_CAT_DEBUG (GST_CAT_EVENT, "creating new event %p %s %d", event,
+      gst_event_type_get_name (type), type);
+
+  gst_event_init (event, type);
+
+  gst_structure_set_parent_refcount (structure,
+      &event->event.mini_object.refcount);
+  GST_EVENT_STRUCTURE (event) = structure;
+
+  return GST_EVENT_CAST (event);
+}
+
 /**
  * gst_event_get_structure:
  * @event: The #GstEvent.
@@ -608,9 +636,9 @@ gst_event_new_flush_stop (gboolean reset_time)
 
   GST_CAT_INFO (GST_CAT_EVENT, "creating flush stop %d", reset_time);
 
-  event = gst_event_new_custom (GST_EVENT_FLUSH_STOP,
-      gst_structure_new_id (GST_QUARK (EVENT_FLUSH_STOP),
-          GST_QUARK (RESET_TIME), G_TYPE_BOOLEAN, reset_time, NULL));
+  event = gst_event_new_with_fields (GST_EVENT_FLUSH_STOP,
+      GST_QUARK (EVENT_FLUSH_STOP),
+      GST_QUARK (RESET_TIME), G_TYPE_BOOLEAN, reset_time, NULL);
 
   return event;
 }
@@ -737,14 +765,11 @@ gst_event_parse_select_streams (GstEvent * event, GList ** streams)
 GstEvent *
 gst_event_new_stream_group_done (guint group_id)
 {
-  GstStructure *s;
-
   g_return_val_if_fail (group_id != GST_GROUP_ID_INVALID, NULL);
 
-  s = gst_structure_new_id (GST_QUARK (EVENT_STREAM_GROUP_DONE),
+  return gst_event_new_with_fields (GST_EVENT_STREAM_GROUP_DONE,
+      GST_QUARK (EVENT_STREAM_GROUP_DONE),
       GST_QUARK (GROUP_ID), G_TYPE_UINT, group_id, NULL);
-
-  return gst_event_new_custom (GST_EVENT_STREAM_GROUP_DONE, s);
 }
 
 /**
@@ -819,10 +844,9 @@ gst_event_new_gap (GstClockTime timestamp, GstClockTime duration)
       GST_TIME_ARGS (timestamp), GST_TIME_ARGS (timestamp + duration),
       GST_TIME_ARGS (duration));
 
-  event = gst_event_new_custom (GST_EVENT_GAP,
-      gst_structure_new_id (GST_QUARK (EVENT_GAP),
-          GST_QUARK (TIMESTAMP), GST_TYPE_CLOCK_TIME, timestamp,
-          GST_QUARK (DURATION), GST_TYPE_CLOCK_TIME, duration, NULL));
+  event = gst_event_new_with_fields (GST_EVENT_GAP, GST_QUARK (EVENT_GAP),
+      GST_QUARK (TIMESTAMP), GST_TYPE_CLOCK_TIME, timestamp,
+      GST_QUARK (DURATION), GST_TYPE_CLOCK_TIME, duration, NULL);
 
   return event;
 }
@@ -917,9 +941,8 @@ gst_event_new_caps (GstCaps * caps)
 
   GST_CAT_INFO (GST_CAT_EVENT, "creating caps event %" GST_PTR_FORMAT, caps);
 
-  event = gst_event_new_custom (GST_EVENT_CAPS,
-      gst_structure_new_id (GST_QUARK (EVENT_CAPS),
-          GST_QUARK (CAPS), GST_TYPE_CAPS, caps, NULL));
+  event = gst_event_new_with_fields (GST_EVENT_CAPS, GST_QUARK (EVENT_CAPS),
+      GST_QUARK (CAPS), GST_TYPE_CAPS, caps, NULL);
 
   return event;
 }
@@ -998,9 +1021,9 @@ gst_event_new_segment (const GstSegment * segment)
   GST_CAT_INFO (GST_CAT_EVENT, "creating segment event %" GST_SEGMENT_FORMAT,
       segment);
 
-  event = gst_event_new_custom (GST_EVENT_SEGMENT,
-      gst_structure_new_id (GST_QUARK (EVENT_SEGMENT),
-          GST_QUARK (SEGMENT), GST_TYPE_SEGMENT, segment, NULL));
+  event = gst_event_new_with_fields (GST_EVENT_SEGMENT,
+      GST_QUARK (EVENT_SEGMENT),
+      GST_QUARK (SEGMENT), GST_TYPE_SEGMENT, segment, NULL);
 
   return event;
 }
@@ -1127,19 +1150,18 @@ gst_event_new_buffer_size (GstFormat format, gint64 minsize,
     gint64 maxsize, gboolean async)
 {
   GstEvent *event;
-  GstStructure *structure;
 
   GST_CAT_INFO (GST_CAT_EVENT,
       "creating buffersize format %s, minsize %" G_GINT64_FORMAT
       ", maxsize %" G_GINT64_FORMAT ", async %d", gst_format_get_name (format),
       minsize, maxsize, async);
 
-  structure = gst_structure_new_id (GST_QUARK (EVENT_BUFFER_SIZE),
+  event = gst_event_new_with_fields (GST_EVENT_BUFFERSIZE,
+      GST_QUARK (EVENT_BUFFER_SIZE),
       GST_QUARK (FORMAT), GST_TYPE_FORMAT, format,
       GST_QUARK (MINSIZE), G_TYPE_INT64, minsize,
       GST_QUARK (MAXSIZE), G_TYPE_INT64, maxsize,
       GST_QUARK (ASYNC), G_TYPE_BOOLEAN, async, NULL);
-  event = gst_event_new_custom (GST_EVENT_BUFFERSIZE, structure);
 
   return event;
 }
@@ -1239,7 +1261,6 @@ gst_event_new_qos (GstQOSType type, gdouble proportion,
     GstClockTimeDiff diff, GstClockTime timestamp)
 {
   GstEvent *event;
-  GstStructure *structure;
 
   /* diff must be positive or timestamp + diff must be positive */
   g_return_val_if_fail (diff >= 0 || -diff <= timestamp, NULL);
@@ -1249,12 +1270,11 @@ gst_event_new_qos (GstQOSType type, gdouble proportion,
       ", timestamp %" GST_TIME_FORMAT, type, proportion,
       diff, GST_TIME_ARGS (timestamp));
 
-  structure = gst_structure_new_id (GST_QUARK (EVENT_QOS),
+  event = gst_event_new_with_fields (GST_EVENT_QOS, GST_QUARK (EVENT_QOS),
       GST_QUARK (TYPE), GST_TYPE_QOS_TYPE, type,
       GST_QUARK (PROPORTION), G_TYPE_DOUBLE, proportion,
       GST_QUARK (DIFF), G_TYPE_INT64, diff,
       GST_QUARK (TIMESTAMP), G_TYPE_UINT64, timestamp, NULL);
-  event = gst_event_new_custom (GST_EVENT_QOS, structure);
 
   return event;
 }
@@ -1365,7 +1385,6 @@ gst_event_new_seek (gdouble rate, GstFormat format, GstSeekFlags flags,
     GstSeekType start_type, gint64 start, GstSeekType stop_type, gint64 stop)
 {
   GstEvent *event;
-  GstStructure *structure;
 
   g_return_val_if_fail (rate != 0.0, NULL);
   g_return_val_if_fail ((flags & GST_SEEK_FLAG_INSTANT_RATE_CHANGE) == 0
@@ -1401,7 +1420,7 @@ gst_event_new_seek (gdouble rate, GstFormat format, GstSeekFlags flags,
         stop);
   }
 
-  structure = gst_structure_new_id (GST_QUARK (EVENT_SEEK),
+  event = gst_event_new_with_fields (GST_EVENT_SEEK, GST_QUARK (EVENT_SEEK),
       GST_QUARK (RATE), G_TYPE_DOUBLE, rate,
       GST_QUARK (FORMAT), GST_TYPE_FORMAT, format,
       GST_QUARK (FLAGS), GST_TYPE_SEEK_FLAGS, flags,
@@ -1411,7 +1430,6 @@ gst_event_new_seek (gdouble rate, GstFormat format, GstSeekFlags flags,
       GST_QUARK (STOP), G_TYPE_INT64, stop,
       GST_QUARK (TRICKMODE_INTERVAL), GST_TYPE_CLOCK_TIME, (GstClockTime) 0,
       NULL);
-  event = gst_event_new_custom (GST_EVENT_SEEK, structure);
 
   return event;
 }
@@ -1550,16 +1568,15 @@ GstEvent *
 gst_event_new_latency (GstClockTime latency)
 {
   GstEvent *event;
-  GstStructure *structure;
 
   g_return_val_if_fail (GST_CLOCK_TIME_IS_VALID (latency), NULL);
 
   GST_CAT_INFO (GST_CAT_EVENT,
       "creating latency event %" GST_TIME_FORMAT, GST_TIME_ARGS (latency));
 
-  structure = gst_structure_new_id (GST_QUARK (EVENT_LATENCY),
+  event = gst_event_new_with_fields (GST_EVENT_LATENCY,
+      GST_QUARK (EVENT_LATENCY),
       GST_QUARK (LATENCY), G_TYPE_UINT64, latency, NULL);
-  event = gst_event_new_custom (GST_EVENT_LATENCY, structure);
 
   return event;
 }
@@ -1612,19 +1629,17 @@ gst_event_new_step (GstFormat format, guint64 amount, gdouble rate,
     gboolean flush, gboolean intermediate)
 {
   GstEvent *event;
-  GstStructure *structure;
 
   g_return_val_if_fail (rate > 0.0, NULL);
 
   GST_CAT_INFO (GST_CAT_EVENT, "creating step event");
 
-  structure = gst_structure_new_id (GST_QUARK (EVENT_STEP),
+  event = gst_event_new_with_fields (GST_EVENT_STEP, GST_QUARK (EVENT_STEP),
       GST_QUARK (FORMAT), GST_TYPE_FORMAT, format,
       GST_QUARK (AMOUNT), G_TYPE_UINT64, amount,
       GST_QUARK (RATE), G_TYPE_DOUBLE, rate,
       GST_QUARK (FLUSH), G_TYPE_BOOLEAN, flush,
       GST_QUARK (INTERMEDIATE), G_TYPE_BOOLEAN, intermediate, NULL);
-  event = gst_event_new_custom (GST_EVENT_STEP, structure);
 
   return event;
 }
@@ -1775,15 +1790,12 @@ gst_event_parse_sink_message (GstEvent * event, GstMessage ** msg)
 GstEvent *
 gst_event_new_stream_start (const gchar * stream_id)
 {
-  GstStructure *s;
-
   g_return_val_if_fail (stream_id != NULL, NULL);
 
-  s = gst_structure_new_id (GST_QUARK (EVENT_STREAM_START),
+  return gst_event_new_with_fields (GST_EVENT_STREAM_START,
+      GST_QUARK (EVENT_STREAM_START),
       GST_QUARK (STREAM_ID), G_TYPE_STRING, stream_id,
       GST_QUARK (FLAGS), GST_TYPE_STREAM_FLAGS, GST_STREAM_FLAG_NONE, NULL);
-
-  return gst_event_new_custom (GST_EVENT_STREAM_START, s);
 }
 
 /**
@@ -1965,15 +1977,12 @@ gst_event_parse_group_id (GstEvent * event, guint * group_id)
 GstEvent *
 gst_event_new_stream_collection (GstStreamCollection * collection)
 {
-  GstStructure *s;
-
   g_return_val_if_fail (collection != NULL, NULL);
   g_return_val_if_fail (GST_IS_STREAM_COLLECTION (collection), NULL);
 
-  s = gst_structure_new_id (GST_QUARK (EVENT_STREAM_COLLECTION),
+  return gst_event_new_with_fields (GST_EVENT_STREAM_COLLECTION,
+      GST_QUARK (EVENT_STREAM_COLLECTION),
       GST_QUARK (COLLECTION), GST_TYPE_STREAM_COLLECTION, collection, NULL);
-
-  return gst_event_new_custom (GST_EVENT_STREAM_COLLECTION, s);
 }
 
 /**
@@ -2073,16 +2082,13 @@ gst_event_parse_toc (GstEvent * event, GstToc ** toc, gboolean * updated)
 GstEvent *
 gst_event_new_toc_select (const gchar * uid)
 {
-  GstStructure *structure;
-
   g_return_val_if_fail (uid != NULL, NULL);
 
   GST_CAT_INFO (GST_CAT_EVENT, "creating toc select event for UID: %s", uid);
 
-  structure = gst_structure_new_id (GST_QUARK (EVENT_TOC_SELECT),
+  return gst_event_new_with_fields (GST_EVENT_TOC_SELECT,
+      GST_QUARK (EVENT_TOC_SELECT),
       GST_QUARK (UID), G_TYPE_STRING, uid, NULL);
-
-  return gst_event_new_custom (GST_EVENT_TOC_SELECT, structure);
 }
 
 /**
@@ -2235,16 +2241,14 @@ GstEvent *
 gst_event_new_segment_done (GstFormat format, gint64 position)
 {
   GstEvent *event;
-  GstStructure *structure;
 
   GST_CAT_INFO (GST_CAT_EVENT, "creating segment-done event");
 
-  structure = gst_structure_new_id (GST_QUARK (EVENT_SEGMENT_DONE),
+  event = gst_event_new_with_fields (GST_EVENT_SEGMENT_DONE,
+      GST_QUARK (EVENT_SEGMENT_DONE),
       GST_QUARK (FORMAT), GST_TYPE_FORMAT, format,
       GST_QUARK (POSITION), G_TYPE_INT64, position, NULL);
 
-  event = gst_event_new_custom (GST_EVENT_SEGMENT_DONE, structure);
-
   return event;
 }
 
@@ -2310,10 +2314,10 @@ gst_event_new_instant_rate_change (gdouble rate_multiplier,
   GST_CAT_TRACE (GST_CAT_EVENT, "creating instant-rate-change event %lf %08x",
       rate_multiplier, new_flags);
 
-  event = gst_event_new_custom (GST_EVENT_INSTANT_RATE_CHANGE,
-      gst_structure_new_id (GST_QUARK (EVENT_INSTANT_RATE_CHANGE),
-          GST_QUARK (RATE), G_TYPE_DOUBLE, rate_multiplier,
-          GST_QUARK (FLAGS), GST_TYPE_SEGMENT_FLAGS, new_flags, NULL));
+  event = gst_event_new_with_fields (GST_EVENT_INSTANT_RATE_CHANGE,
+      GST_QUARK (EVENT_INSTANT_RATE_CHANGE),
+      GST_QUARK (RATE), G_TYPE_DOUBLE, rate_multiplier,
+      GST_QUARK (FLAGS), GST_TYPE_SEGMENT_FLAGS, new_flags, NULL);
 
   return event;
 }
@@ -2384,12 +2388,12 @@ gst_event_new_instant_rate_sync_time (gdouble rate_multiplier,
       " %" GST_TIME_FORMAT, rate_multiplier,
       GST_TIME_ARGS (running_time), GST_TIME_ARGS (upstream_running_time));
 
-  event = gst_event_new_custom (GST_EVENT_INSTANT_RATE_SYNC_TIME,
-      gst_structure_new_id (GST_QUARK (EVENT_INSTANT_RATE_SYNC_TIME),
-          GST_QUARK (RATE), G_TYPE_DOUBLE, rate_multiplier,
-          GST_QUARK (RUNNING_TIME), GST_TYPE_CLOCK_TIME, running_time,
-          GST_QUARK (UPSTREAM_RUNNING_TIME), GST_TYPE_CLOCK_TIME,
-          upstream_running_time, NULL));
+  event = gst_event_new_with_fields (GST_EVENT_INSTANT_RATE_SYNC_TIME,
+      GST_QUARK (EVENT_INSTANT_RATE_SYNC_TIME),
+      GST_QUARK (RATE), G_TYPE_DOUBLE, rate_multiplier,
+      GST_QUARK (RUNNING_TIME), GST_TYPE_CLOCK_TIME, running_time,
+      GST_QUARK (UPSTREAM_RUNNING_TIME), GST_TYPE_CLOCK_TIME,
+      upstream_running_time, NULL);
 
   return event;
 }
@@ -98,6 +98,8 @@
 #include <glib/gstdio.h>
 #include <errno.h>
 #include <string.h>             /* G_VA_COPY */
+#include <stddef.h>             /* ptrdiff_t */
+#include <stdint.h>             /* intmax_t */
 
 #include "gst_private.h"
 #include "gstutils.h"
@@ -3766,6 +3768,884 @@ gst_debug_remove_ring_buffer_logger (void)
   gst_debug_remove_log_function (gst_ring_buffer_logger_log);
 }
 
+/* Binary ring buffer logger
+ *
+ * Every thread writes fixed-layout records into its own ring of memory
+ * without taking any lock. For the common printf conversions only the raw
+ * argument values are stored and the message is formatted when the logs are
+ * fetched. Anything else (the GStreamer %p extensions, messages that were
+ * already formatted by another log function, ...) is formatted right away
+ * and stored as text.
+ *
+ * A record is a GstBinaryLogRecord followed by the file name, the function
+ * name and the object id, and then either the format string and its
+ * arguments or the formatted text. Strings are stored as a 8 byte length
+ * followed by the characters, all other arguments take 8 bytes. Everything
+ * is padded to 8 bytes.
+ */
+#define BINARY_LOG_MIN_SIZE 16384
+#define BINARY_LOG_MAX_NAME 256
+#define BINARY_LOG_MAX_STRING 1024
+#define BINARY_LOG_MAX_EXITED_THREADS 16
+
+#define BINARY_LOG_RECORD_LEVEL_MASK 0xff
+#define BINARY_LOG_RECORD_PADDING (1 << 8)
+#define BINARY_LOG_RECORD_TEXT (1 << 9)
+
+#define BINARY_LOG_NULL_STRING G_MAXUINT32
+
+typedef struct
+{
+  guint32 size;
+  guint32 flags;
+  GstClockTime timestamp;
+  GstDebugCategory *category;
+  gint32 line;
+  guint32 reserved;
+} GstBinaryLogRecord;
+
+typedef enum
+{
+  BINARY_LOG_ARG_NONE,
+  BINARY_LOG_ARG_INT,
+  BINARY_LOG_ARG_LONG,
+  BINARY_LOG_ARG_LONG_LONG,
+  BINARY_LOG_ARG_SIZE,
+  BINARY_LOG_ARG_INTMAX,
+  BINARY_LOG_ARG_PTRDIFF,
+  BINARY_LOG_ARG_DOUBLE,
+  BINARY_LOG_ARG_POINTER,
+  BINARY_LOG_ARG_STRING,
+  BINARY_LOG_ARG_UNSUPPORTED,
+} GstBinaryLogArg;
+
+typedef struct
+{
+  guint generation;
+  guint size;
+  guint n_exited;
+  GQueue rings;
+} GstBinaryLogger;
+
+typedef struct
+{
+  guint generation;
+  gpointer thread;
+  gboolean exited;
+  gboolean detached;
+
+  guint8 *data;
+  guint size;
+
+  /* Logical positions of the oldest valid byte and of the end of the last
+   * record. Only the owning thread writes them, readers take a copy of the
+   * data in between */
+  guint start;
+  guint end;
+
+  /* Used to build a record before copying it into the ring */
+  GByteArray *scratch;
+} GstBinaryLog;
+
+static void gst_binary_log_thread_exit (GstBinaryLog * log);
+
+G_LOCK_DEFINE_STATIC (binary_logger);
+static GstBinaryLogger *binary_logger = NULL;
+static guint binary_logger_generation = 0;
+static GPrivate binary_log_private =
+G_PRIVATE_INIT ((GDestroyNotify) gst_binary_log_thread_exit);
+
+static void
+gst_binary_log_free (GstBinaryLog * log)
+{
+  g_free (log->data);
+  g_byte_array_unref (log->scratch);
+  g_free (log);
+}
+
+/* With the binary_logger lock */
+static void
+gst_binary_logger_remove_exited (GstBinaryLogger * logger, guint max_exited)
+{
+  GList *l, *next;
+
+  for (l = logger->rings.head; l && logger->n_exited > max_exited; l = next) {
+    GstBinaryLog *log = l->data;
+
+    next = l->next;
+    if (!log->exited)
+      continue;
+
+    g_queue_delete_link (&logger->rings, l);
+    gst_binary_log_free (log);
+    logger->n_exited--;
+  }
+}
+
+static void
+gst_binary_log_thread_exit (GstBinaryLog * log)
+{
+  G_LOCK (binary_logger);
+  if (log->detached) {
+    gst_binary_log_free (log);
+  } else {
+    /* Keep the logs of the thread around until there are too many. The ring
+     * can only be attached to the current logger */
+    log->exited = TRUE;
+    binary_logger->n_exited++;
+    gst_binary_logger_remove_exited (binary_logger,
+        BINARY_LOG_MAX_EXITED_THREADS);
+  }
+  G_UNLOCK (binary_logger);
+}
+
+static GstBinaryLog *
+gst_binary_log_get (GstBinaryLogger * logger)
+{
+  GstBinaryLog *log = g_private_get (&binary_log_private);
+
+  if (G_LIKELY (log != NULL && log->generation == logger->generation))
+    return log;
+
+  G_LOCK (binary_logger);
+  /* A ring of a logger that was removed in the meantime */
+  if (log)
+    gst_binary_log_free (log);
+  log = NULL;
+
+  if (binary_logger == logger) {
+    log = g_new0 (GstBinaryLog, 1);
+    log->generation = logger->generation;
+    log->thread = g_thread_self ();
+    log->size = logger->size;
+    log->data = g_malloc (log->size);
+    log->scratch = g_byte_array_sized_new (256);
+    g_queue_push_tail (&logger->rings, log);
+  }
+  G_UNLOCK (binary_logger);
+
+  g_private_set (&binary_log_private, log);
+
+  return log;
+}
+
+static void
+binary_log_append (GByteArray * a, gconstpointer data, gsize len)
+{
+  static const guint8 zeros[8] = { 0, };
+
+  g_byte_array_append (a, data, len);
+  if (len % 8)
+    g_byte_array_append (a, zeros, 8 - len % 8);
+}
+
+static void
+binary_log_append_value (GByteArray * a, guint64 value)
+{
+  g_byte_array_append (a, (const guint8 *) &value, 8);
+}
+
+static void
+binary_log_append_string (GByteArray * a, const gchar * s, gsize max_len)
+{
+  gsize len = 0;
+
+  if (s == NULL) {
+    binary_log_append_value (a, BINARY_LOG_NULL_STRING);
+    return;
+  }
+
+  /* Not strlen(), the string might not be NUL-terminated if a precision
+   * was given */
+  while (len < max_len && s[len] != '\0')
+    len++;
+
+  binary_log_append_value (a, len);
+  binary_log_append (a, s, len);
+}
+
+/* Parses the conversion starting at the '%' at @p and returns the position
+ * after it. @n_stars is set to the number of int arguments that are consumed
+ * for the width and precision, @precision to the literal precision or -1 */
+static const gchar *
+binary_log_parse_conversion (const gchar * p, GstBinaryLogArg * arg,
+    guint * n_stars, gint * precision)
+{
+  gint longs = 0;
+  gboolean size = FALSE, intmax = FALSE, ptrdiff = FALSE;
+  gboolean long_double = FALSE;
+
+  *n_stars = 0;
+  *precision = -1;
+
+  /* '%' */
+  p++;
+
+  /* flags */
+  while (*p && strchr ("-+ #0'", *p))
+    p++;
+
+  /* width */
+  if (*p == '*') {
+    (*n_stars)++;
+    p++;
+  } else {
+    while (g_ascii_isdigit (*p))
+      p++;
+  }
+
+  /* precision */
+  if (*p == '.') {
+    p++;
+    if (*p == '*') {
+      (*n_stars)++;
+      p++;
+    } else {
+      *precision = 0;
+      while (g_ascii_isdigit (*p)) {
+        *precision = MIN (*precision * 10 + (*p - '0'), BINARY_LOG_MAX_STRING);
+        p++;
+      }
+    }
+  }
+
+  /* length modifiers */
+  for (;;) {
+    switch (*p) {
+      case 'h':
+        /* promoted to int */
+        p++;
+        continue;
+      case 'l':
+        longs++;
+        p++;
+        continue;
+      case 'q':
+        longs = 2;
+        p++;
+        continue;
+      case 'L':
+        long_double = TRUE;
+        p++;
+        continue;
+      case 'z':
+      case 'Z':
+        size = TRUE;
+        p++;
+        continue;
+      case 'j':
+        intmax = TRUE;
+        p++;
+        continue;
+      case 't':
+        ptrdiff = TRUE;
+        p++;
+        continue;
+      case 'I':
+        if (p[1] == '6' && p[2] == '4') {
+          longs = 2;
+          p += 3;
+        } else if (p[1] == '3' && p[2] == '2') {
+          p += 3;
+        } else {
+          size = TRUE;
+          p++;
+        }
+        continue;
+      default:
+        break;
+    }
+    break;
+  }
+
+  switch (*p) {
+    case '%':
+      *arg = BINARY_LOG_ARG_NONE;
+      break;
+    case 'd':
+    case 'i':
+    case 'o':
+    case 'u':
+    case 'x':
+    case 'X':
+      if (size)
+        *arg = BINARY_LOG_ARG_SIZE;
+      else if (intmax)
+        *arg = BINARY_LOG_ARG_INTMAX;
+      else if (ptrdiff)
+        *arg = BINARY_LOG_ARG_PTRDIFF;
+      else if (longs >= 2)
+        *arg = BINARY_LOG_ARG_LONG_LONG;
+      else if (longs == 1)
+        *arg = BINARY_LOG_ARG_LONG;
+      else
+        *arg = BINARY_LOG_ARG_INT;
+      break;
+    case 'c':
+      *arg = longs ? BINARY_LOG_ARG_UNSUPPORTED : BINARY_LOG_ARG_INT;
+      break;
+    case 'e':
+    case 'E':
+    case 'f':
+    case 'F':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      *arg = long_double ? BINARY_LOG_ARG_UNSUPPORTED : BINARY_LOG_ARG_DOUBLE;
+      break;
+    case 's':
+      *arg = longs ? BINARY_LOG_ARG_UNSUPPORTED : BINARY_LOG_ARG_STRING;
+      break;
+    case 'p':
+      /* %p\a... are our own printf extensions */
+      *arg = p[1] == '\a' ? BINARY_LOG_ARG_UNSUPPORTED : BINARY_LOG_ARG_POINTER;
+      break;
+    default:
+      /* %n, wide characters, ... */
+      *arg = BINARY_LOG_ARG_UNSUPPORTED;
+      break;
+  }
+
+  if (*p)
+    p++;
+
+  return p;
+}
+
+/* Returns FALSE if the message has to be formatted right away */
+static gboolean
+binary_log_append_arguments (GByteArray * a, const gchar * format,
+    va_list args)
+{
+  const gchar *p = format;
+
+  while ((p = strchr (p, '%'))) {
+    GstBinaryLogArg arg;
+    guint n_stars, i;
+    gint precision, star = 0;
+
+    p = binary_log_parse_conversion (p, &arg, &n_stars, &precision);
+
+    for (i = 0; i < n_stars; i++) {
+      star = va_arg (args, int);
+      binary_log_append_value (a, (gint64) star);
+    }
+
+    switch (arg) {
+      case BINARY_LOG_ARG_NONE:
+        break;
+      case BINARY_LOG_ARG_INT:
+        binary_log_append_value (a, (gint64) va_arg (args, int));
+        break;
+      case BINARY_LOG_ARG_LONG:
+        binary_log_append_value (a, (gint64) va_arg (args, long));
+        break;
+      case BINARY_LOG_ARG_LONG_LONG:
+        binary_log_append_value (a, (gint64) va_arg (args, long long));
+        break;
+      case BINARY_LOG_ARG_SIZE:
+        binary_log_append_value (a, (guint64) va_arg (args, gsize));
+        break;
+      case BINARY_LOG_ARG_INTMAX:
+        binary_log_append_value (a, (gint64) va_arg (args, intmax_t));
+        break;
+      case BINARY_LOG_ARG_PTRDIFF:
+        binary_log_append_value (a, (gint64) va_arg (args, ptrdiff_t));
+        break;
+      case BINARY_LOG_ARG_DOUBLE:{
+        gdouble d = va_arg (args, double);
+
+        g_byte_array_append (a, (const guint8 *) &d, 8);
+        break;
+      }
+      case BINARY_LOG_ARG_POINTER:
+        binary_log_append_value (a, (guintptr) va_arg (args, gpointer));
+        break;
+      case BINARY_LOG_ARG_STRING:{
+        gsize max_len = BINARY_LOG_MAX_STRING;
+
+        if (precision >= 0)
+          max_len = precision;
+        else if (n_stars == 2 && star >= 0)
+          max_len = MIN (star, BINARY_LOG_MAX_STRING);
+
+        binary_log_append_string (a, va_arg (args, const gchar *), max_len);
+        break;
+      }
+      case BINARY_LOG_ARG_UNSUPPORTED:
+        return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+static void
+gst_binary_log_write (GstBinaryLog * log, const guint8 * data, guint size)
+{
+  guint mask = log->size - 1;
+  guint offset = log->end & mask;
+  guint space_to_end = log->size - offset;
+  guint needed = size;
+  guint start = log->start;
+
+  /* Records are never split, fill the end of the ring with padding */
+  if (space_to_end < size)
+    needed += space_to_end;
+
+  /* Drop the oldest records that are going to be overwritten, before
+   * overwriting them */
+  while (log->end + needed - start > log->size) {
+    guint32 record_size;
+
+    memcpy (&record_size, log->data + (start & mask), 4);
+    start += record_size;
+  }
+  g_atomic_int_set (&log->start, start);
+
+  if (space_to_end < size) {
+    guint32 padding[2] = { space_to_end, BINARY_LOG_RECORD_PADDING };
+
+    memcpy (log->data + offset, padding, sizeof (padding));
+    offset = 0;
+  }
+  memcpy (log->data + offset, data, size);
+
+  g_atomic_int_set (&log->end, log->end + needed);
+}
+
+static void
+gst_binary_logger_log (GstDebugCategory * category,
+    GstDebugLevel level, const gchar * file, const gchar * function,
+    gint line, GObject * object, GstDebugMessage * message, gpointer user_data)
+{
+  GstBinaryLogger *logger = user_data;
+  GstBinaryLogRecord record = { 0, };
+  GstBinaryLog *log;
+  GByteArray *a;
+  const gchar *object_id = NULL;
+  guint max_record_size;
+  guint args_offset;
+  gboolean text = TRUE;
+  gchar c;
+
+  log = gst_binary_log_get (logger);
+  if (G_UNLIKELY (log == NULL))
+    return;
+
+  /* See gst_ring_buffer_logger_log() */
+  c = file[0];
+  if (c == '.' || c == '/' || c == '\\' || (c != '\0' && file[1] == ':')) {
+    file = gst_path_basename (file);
+  }
+
+  if (object || message->object_id)
+    object_id = gst_debug_message_get_id (message);
+
+  a = log->scratch;
+  g_byte_array_set_size (a, sizeof (record));
+  binary_log_append_string (a, file, BINARY_LOG_MAX_NAME);
+  binary_log_append_string (a, function, BINARY_LOG_MAX_NAME);
+  binary_log_append_string (a, object_id, BINARY_LOG_MAX_NAME);
+  args_offset = a->len;
+
+  /* Record sizes are bounded so that a single message can't evict everything
+   * else */
+  max_record_size = log->size / 4;
+
+  if (message->message == NULL && message->format != NULL) {
+    va_list args;
+
+    binary_log_append_string (a, message->format, BINARY_LOG_MAX_STRING);
+    G_VA_COPY (args, message->arguments);
+    text = !binary_log_append_arguments (a, message->format, args);
+    va_end (args);
+
+    if (a->len > max_record_size)
+      text = TRUE;
+  }
+
+  if (text) {
+    gsize max_len = max_record_size - args_offset - 16;
+
+    g_byte_array_set_size (a, args_offset);
+    binary_log_append_string (a, gst_debug_message_get (message), max_len);
+    record.flags |= BINARY_LOG_RECORD_TEXT;
+  }
+
+  record.size = a->len;
+  record.flags |= level & BINARY_LOG_RECORD_LEVEL_MASK;
+  record.timestamp =
+      GST_CLOCK_DIFF (_priv_gst_start_time, gst_util_get_timestamp ());
+  record.category = category;
+  record.line = line;
+  memcpy (a->data, &record, sizeof (record));
+
+  gst_binary_log_write (log, a->data, a->len);
+}
+
+typedef struct
+{
+  const guint8 *p;
+  const guint8 *end;
+} GstBinaryLogReader;
+
+static guint64
+binary_log_read_value (GstBinaryLogReader * r)
+{
+  guint64 value = 0;
+
+  if (r->end - r->p >= 8) {
+    memcpy (&value, r->p, 8);
+    r->p += 8;
+  } else {
+    r->p = r->end;
+  }
+
+  return value;
+}
+
+static gchar *
+binary_log_read_string (GstBinaryLogReader * r)
+{
+  guint64 len = binary_log_read_value (r);
+  gchar *s;
+
+  if (len == BINARY_LOG_NULL_STRING)
+    return NULL;
+
+  len = MIN (len, (guint64) (r->end - r->p));
+  s = g_strndup ((const gchar *) r->p, len);
+  r->p += GST_ROUND_UP_8 (len);
+  if (r->p > r->end)
+    r->p = r->end;
+
+  return s;
+}
+
+static void
+binary_log_append_printf (GString * str, const gchar * format, ...)
+{
+  va_list args;
+
+  va_start (args, format);
+  g_string_append_vprintf (str, format, args);
+  va_end (args);
+}
+
+#define BINARY_LOG_APPEND_PRINTF(str, spec, n_stars, stars, value) \
+G_STMT_START { \
+  if ((n_stars) == 0) \
+    binary_log_append_printf (str, spec, value); \
+  else if ((n_stars) == 1) \
+    binary_log_append_printf (str, spec, stars[0], value); \
+  else \
+    binary_log_append_printf (str, spec, stars[0], stars[1], value); \
+} G_STMT_END
+
+static void
+binary_log_format_message (GString * str, GstBinaryLogReader * r)
+{
+  gchar *format = binary_log_read_string (r);
+  const gchar *p, *q;
+
+  if (format == NULL)
+    return;
+
+  p = format;
+  while ((q = strchr (p, '%'))) {
+    GstBinaryLogArg arg;
+    guint n_stars, i;
+    gint precision, stars[2] = { 0, };
+    gchar spec[32];
+
+    g_string_append_len (str, p, q - p);
+    p = binary_log_parse_conversion (q, &arg, &n_stars, &precision);
+
+    for (i = 0; i < n_stars; i++)
+      stars[i] = (gint) binary_log_read_value (r);
+
+    if ((gsize) (p - q) >= sizeof (spec)) {
+      g_string_append_len (str, q, p - q);
+      continue;
+    }
+    memcpy (spec, q, p - q);
+    spec[p - q] = '\0';
+
+    switch (arg) {
+      case BINARY_LOG_ARG_NONE:
+        g_string_append_c (str, '%');
+        break;
+      case BINARY_LOG_ARG_INT:{
+        gint v = (gint) binary_log_read_value (r);
+
+        BINARY_LOG_APPEND_PRINTF (str, spec, n_stars, stars, v);
+        break;
+      }
+      case BINARY_LOG_ARG_LONG:{
+        long v = (long) binary_log_read_value (r);
+
+        BINARY_LOG_APPEND_PRINTF (str, spec, n_stars, stars, v);
+        break;
+      }
+      case BINARY_LOG_ARG_LONG_LONG:{
+        long long v = (long long) binary_log_read_value (r);
+
+        BINARY_LOG_APPEND_PRINTF (str, spec, n_stars, stars, v);
+        break;
+      }
+      case BINARY_LOG_ARG_SIZE:{
+        gsize v = (gsize) binary_log_read_value (r);
+
+        BINARY_LOG_APPEND_PRINTF (str, spec, n_stars, stars, v);
+        break;
+      }
+      case BINARY_LOG_ARG_INTMAX:{
+        intmax_t v = (intmax_t) binary_log_read_value (r);
+
+        BINARY_LOG_APPEND_PRINTF (str, spec, n_stars, stars, v);
+        break;
+      }
+      case BINARY_LOG_ARG_PTRDIFF:{
+        ptrdiff_t v = (ptrdiff_t) binary_log_read_value (r);
+
+        BINARY_LOG_APPEND_PRINTF (str, spec, n_stars, stars, v);
+        break;
+      }
+      case BINARY_LOG_ARG_DOUBLE:{
+        guint64 bits = binary_log_read_value (r);
+        gdouble v;
+
+        memcpy (&v, &bits, 8);
+        BINARY_LOG_APPEND_PRINTF (str, spec, n_stars, stars, v);
+        break;
+      }
+      case BINARY_LOG_ARG_POINTER:{
+        gpointer v = (gpointer) (guintptr) binary_log_read_value (r);
+
+        BINARY_LOG_APPEND_PRINTF (str, spec, n_stars, stars, v);
+        break;
+      }
+      case BINARY_LOG_ARG_STRING:{
+        gchar *v = binary_log_read_string (r);
+
+        BINARY_LOG_APPEND_PRINTF (str, spec, n_stars, stars,
+            v ? v : "(NULL)");
+        g_free (v);
+        break;
+      }
+      case BINARY_LOG_ARG_UNSUPPORTED:
+        /* never stored */
+        g_string_append (str, q);
+        g_free (format);
+        return;
+    }
+  }
+  g_string_append (str, p);
+
+  g_free (format);
+}
+
+static void
+gst_binary_log_dump (GstBinaryLog * log, GString * str)
+{
+  guint mask = log->size - 1;
+  guint8 *data;
+  guint start, end, pos;
+  GString *message;
+
+  /* The writer publishes the end after writing a record and moves the start
+   * before overwriting anything, so everything between the start after the
+   * copy and the end before the copy is valid */
+  end = g_atomic_int_get (&log->end);
+  data = g_malloc (log->size);
+  memcpy (data, log->data, log->size);
+  start = g_atomic_int_get (&log->start);
+
+  if (end - start > log->size) {
+    /* Overtaken while copying */
+    g_free (data);
+    return;
+  }
+
+  message = g_string_new (NULL);
+  for (pos = start; pos != end;) {
+    const guint8 *p = data + (pos & mask);
+    GstBinaryLogRecord record;
+    GstBinaryLogReader r;
+    gchar *file, *function, *object_id;
+
+    memcpy (&record, p, 8);
+    if (record.size < 8 || record.size > end - pos
+        || record.size > log->size - (pos & mask))
+      break;
+
+    if (record.flags & BINARY_LOG_RECORD_PADDING) {
+      pos += record.size;
+      continue;
+    }
+
+    if (record.size < sizeof (record))
+      break;
+    memcpy (&record, p, sizeof (record));
+
+    r.p = p + sizeof (record);
+    r.end = p + record.size;
+    file = binary_log_read_string (&r);
+    function = binary_log_read_string (&r);
+    object_id = binary_log_read_string (&r);
+
+    g_string_truncate (message, 0);
+    if (record.flags & BINARY_LOG_RECORD_TEXT) {
+      gchar *text = binary_log_read_string (&r);
+
+      if (text)
+        g_string_append (message, text);
+      g_free (text);
+    } else {
+      binary_log_format_message (message, &r);
+    }
+
+    /* no color, all platforms */
+    g_string_append_printf (str, "%" GST_TIME_FORMAT NOCOLOR_PRINT_FMT_ID,
+        GST_TIME_ARGS (record.timestamp), _gst_getpid (), log->thread,
+        gst_debug_level_get_name (record.flags & BINARY_LOG_RECORD_LEVEL_MASK),
+        gst_debug_category_get_name (record.category), GST_STR_NULL (file),
+        record.line, GST_STR_NULL (function), object_id ? object_id : "",
+        message->str);
+
+    g_free (file);
+    g_free (function);
+    g_free (object_id);
+
+    pos += record.size;
+  }
+
+  g_string_free (message, TRUE);
+  g_free (data);
+}
+
+/**
+ * gst_debug_binary_ring_buffer_logger_get_logs:
+ *
+ * Fetches the current logs per thread from the binary ring buffer logger.
+ * This is where the messages are formatted. See
+ * gst_debug_add_binary_ring_buffer_logger() for details.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): NULL-terminated array of
+ * strings with the debug output per thread
+ *
+ * Since: 1.24
+ */
+gchar **
+gst_debug_binary_ring_buffer_logger_get_logs (void)
+{
+  gchar **logs, **tmp;
+  GList *l;
+
+  g_return_val_if_fail (binary_logger != NULL, NULL);
+
+  G_LOCK (binary_logger);
+
+  tmp = logs = g_new0 (gchar *, binary_logger->rings.length + 1);
+  for (l = binary_logger->rings.head; l; l = l->next) {
+    GString *str = g_string_new (NULL);
+
+    gst_binary_log_dump (l->data, str);
+    *tmp++ = g_string_free (str, FALSE);
+  }
+
+  G_UNLOCK (binary_logger);
+
+  return logs;
+}
+
+static void
+gst_binary_logger_free (GstBinaryLogger * logger)
+{
+  G_LOCK (binary_logger);
+  if (binary_logger == logger) {
+    GstBinaryLog *log;
+
+    /* Rings of running threads are still used by them until their next
+     * message or until they exit */
+    while ((log = g_queue_pop_head (&logger->rings))) {
+      if (log->exited)
+        gst_binary_log_free (log);
+      else
+        log->detached = TRUE;
+    }
+
+    g_free (logger);
+    binary_logger = NULL;
+  }
+  G_UNLOCK (binary_logger);
+}
+
+/**
+ * gst_debug_add_binary_ring_buffer_logger:
+ * @max_size_per_thread: Maximum size of log per thread in bytes
+ *
+ * Adds a memory ringbuffer based debug logger similar to
+ * gst_debug_add_ring_buffer_logger() that is cheap enough to be left enabled
+ * at high debug levels.
+ *
+ * Each thread writes into its own ring buffer of @max_size_per_thread bytes,
+ * rounded up to a power of two, without any locking. For the standard printf
+ * conversions only the arguments are stored and messages are formatted when
+ * the logs are fetched with gst_debug_binary_ring_buffer_logger_get_logs().
+ * Messages using the GStreamer specific printf extensions, like
+ * %GST_PTR_FORMAT, are formatted immediately. Note that the default log
+ * function still formats every message unless it is removed with
+ * gst_debug_remove_log_function().
+ *
+ * The logs of the most recently exited threads are kept. The logger can be
+ * removed again with gst_debug_remove_binary_ring_buffer_logger(). Only one
+ * logger at a time is possible.
+ *
+ * Since: 1.24
+ */
+void
+gst_debug_add_binary_ring_buffer_logger (guint max_size_per_thread)
+{
+  GstBinaryLogger *logger;
+
+  G_LOCK (binary_logger);
+
+  if (binary_logger) {
+    g_warn_if_reached ();
+    G_UNLOCK (binary_logger);
+    return;
+  }
+
+  logger = binary_logger = g_new0 (GstBinaryLogger, 1);
+
+  max_size_per_thread = CLAMP (max_size_per_thread, BINARY_LOG_MIN_SIZE,
+      G_MAXINT / 2 + 1);
+  logger->size = 1U << g_bit_storage (max_size_per_thread - 1);
+  logger->generation = ++binary_logger_generation;
+  g_queue_init (&logger->rings);
+
+  gst_debug_add_log_function (gst_binary_logger_log, logger,
+      (GDestroyNotify) gst_binary_logger_free);
+  G_UNLOCK (binary_logger);
+}
+
+/**
+ * gst_debug_remove_binary_ring_buffer_logger:
+ *
+ * Removes any previously added binary ring buffer logger with
+ * gst_debug_add_binary_ring_buffer_logger().
+ *
+ * Since: 1.24
+ */
+void
+gst_debug_remove_binary_ring_buffer_logger (void)
+{
+  gst_debug_remove_log_function (gst_binary_logger_log);
+}
+
 #else /* GST_DISABLE_GST_DEBUG */
 #ifndef GST_REMOVE_DISABLED
 
@@ -3786,5 +4666,21 @@ gst_debug_remove_ring_buffer_logger (void)
 {
 }
 
+gchar **
+gst_debug_binary_ring_buffer_logger_get_logs (void)
+{
+  return NULL;
+}
+
+void
+gst_debug_add_binary_ring_buffer_logger (guint max_size_per_thread)
+{
+}
+
+void
+gst_debug_remove_binary_ring_buffer_logger (void)
+{
+}
+
 #endif /* GST_REMOVE_DISABLED */
 #endif /* GST_DISABLE_GST_DEBUG */
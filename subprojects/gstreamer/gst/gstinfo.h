@@ -2154,6 +2154,13 @@ void                  gst_debug_remove_ring_buffer_logger   (void);
 GST_API
 gchar **              gst_debug_ring_buffer_logger_get_logs (void);
 
+GST_API
+void                  gst_debug_add_binary_ring_buffer_logger      (guint max_size_per_thread);
+GST_API
+void                  gst_debug_remove_binary_ring_buffer_logger   (void);
+GST_API
+gchar **              gst_debug_binary_ring_buffer_logger_get_logs (void);
+
 G_END_DECLS
 
 #endif /* __GSTINFO_H__ */
@@ -373,6 +373,8 @@ gst_memory_copy (GstMemory * mem, gssize offset, gssize size)
   g_return_val_if_fail (mem != NULL, NULL);
 
   copy = mem->allocator->mem_copy (mem, offset, size);
+  if (copy)
+    GST_TRACER_MEMORY_COPY (mem, copy);
 
   return copy;
 }
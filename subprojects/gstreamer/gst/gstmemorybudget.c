@@ -0,0 +1,426 @@
+/* GStreamer
+ *
+ * gstmemorybudget.c: shared accounting of queued memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:gstmemorybudget
+ * @title: GstMemoryBudget
+ * @short_description: Shared accounting of queued memory
+ * @see_also: #GstContext
+ *
+ * Elements like queue, queue2 and multiqueue each limit the amount of data
+ * they hold, but nothing limits the total over a pipeline with many of them.
+ * A #GstMemoryBudget is a byte counter shared by a group of elements: they
+ * charge it for the data they hold and release it again when the data leaves
+ * them. When the budget's maximum is exceeded, they apply its
+ * #GstMemoryBudgetPolicy to new data.
+ *
+ * The budget is distributed with a #GstContext of type
+ * #GST_MEMORY_BUDGET_CONTEXT_TYPE. Setting the context created by
+ * gst_memory_budget_context_new() on a pipeline makes the whole pipeline
+ * share it, setting different budgets on different bins gives every branch
+ * its own budget.
+ *
+ * |[<!-- language="C" -->
+ *   GstMemoryBudget *budget;
+ *   GstContext *context;
+ *
+ *   budget = gst_memory_budget_new ("ingest", 512 * 1024 * 1024,
+ *       GST_MEMORY_BUDGET_POLICY_DROP_DELTA);
+ *   context = gst_memory_budget_context_new (budget);
+ *   gst_element_set_context (pipeline, context);
+ *   gst_context_unref (context);
+ *   gst_memory_budget_unref (budget);
+ * ]|
+ *
+ * Since: 1.24
+ */
+
+#include "gst_private.h"
+
+#include "gstmemorybudget.h"
+
+#define GST_CAT_DEFAULT GST_CAT_MEMORY
+
+struct _GstMemoryBudget
+{
+  gint refcount;
+
+  gchar *name;
+  guint64 max_bytes;
+  GstMemoryBudgetPolicy policy;
+
+  /* pointer sized so they can be updated atomically, the memory of a
+   * process can't be larger anyway */
+  gsize current;
+  gsize peak;
+};
+
+G_DEFINE_BOXED_TYPE (GstMemoryBudget, gst_memory_budget,
+    (GBoxedCopyFunc) gst_memory_budget_ref,
+    (GBoxedFreeFunc) gst_memory_budget_unref);
+
+/**
+ * gst_memory_budget_new:
+ * @name: (nullable): a name for the budget, used in warnings
+ * @max_bytes: the maximum number of bytes the elements may hold together
+ * @policy: what to do with new data when the budget is exceeded
+ *
+ * Create a new #GstMemoryBudget.
+ *
+ * Returns: (transfer full): a new #GstMemoryBudget
+ *
+ * Since: 1.24
+ */
+GstMemoryBudget *
+gst_memory_budget_new (const gchar * name, guint64 max_bytes,
+    GstMemoryBudgetPolicy policy)
+{
+  GstMemoryBudget *budget;
+
+  g_return_val_if_fail (max_bytes > 0, NULL);
+
+  budget = g_new0 (GstMemoryBudget, 1);
+  budget->refcount = 1;
+  budget->name = g_strdup (name ? name : "memory-budget");
+  budget->max_bytes = max_bytes;
+  budget->policy = policy;
+
+  GST_DEBUG ("created budget %s of %" G_GUINT64_FORMAT " bytes", budget->name,
+      max_bytes);
+
+  return budget;
+}
+
+/**
+ * gst_memory_budget_ref:
+ * @budget: a #GstMemoryBudget
+ *
+ * Increase the refcount of @budget.
+ *
+ * Returns: (transfer full): @budget
+ *
+ * Since: 1.24
+ */
+GstMemoryBudget *
+gst_memory_budget_ref (GstMemoryBudget * budget)
+{
+  g_return_val_if_fail (budget != NULL, NULL);
+
+  g_atomic_int_inc (&budget->refcount);
+
+  return budget;
+}
+
+/**
+ * gst_memory_budget_unref:
+ * @budget: (transfer full): a #GstMemoryBudget
+ *
+ * Decrease the refcount of @budget and free it when it reaches 0.
+ *
+ * Since: 1.24
+ */
+void
+gst_memory_budget_unref (GstMemoryBudget * budget)
+{
+  g_return_if_fail (budget != NULL);
+
+  if (g_atomic_int_dec_and_test (&budget->refcount)) {
+    g_free (budget->name);
+    g_free (budget);
+  }
+}
+
+/**
+ * gst_memory_budget_get_name:
+ * @budget: a #GstMemoryBudget
+ *
+ * Returns: the name of @budget
+ *
+ * Since: 1.24
+ */
+const gchar *
+gst_memory_budget_get_name (GstMemoryBudget * budget)
+{
+  g_return_val_if_fail (budget != NULL, NULL);
+
+  return budget->name;
+}
+
+/**
+ * gst_memory_budget_get_max_bytes:
+ * @budget: a #GstMemoryBudget
+ *
+ * Returns: the maximum number of bytes of @budget
+ *
+ * Since: 1.24
+ */
+guint64
+gst_memory_budget_get_max_bytes (GstMemoryBudget * budget)
+{
+  g_return_val_if_fail (budget != NULL, 0);
+
+  return budget->max_bytes;
+}
+
+/**
+ * gst_memory_budget_get_policy:
+ * @budget: a #GstMemoryBudget
+ *
+ * Returns: the policy of @budget
+ *
+ * Since: 1.24
+ */
+GstMemoryBudgetPolicy
+gst_memory_budget_get_policy (GstMemoryBudget * budget)
+{
+  g_return_val_if_fail (budget != NULL, GST_MEMORY_BUDGET_POLICY_WARN);
+
+  return budget->policy;
+}
+
+/**
+ * gst_memory_budget_get_current_bytes:
+ * @budget: a #GstMemoryBudget
+ *
+ * Returns: the number of bytes currently charged to @budget
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+guint64
+gst_memory_budget_get_current_bytes (GstMemoryBudget * budget)
+{
+  g_return_val_if_fail (budget != NULL, 0);
+
+  return g_atomic_pointer_get (&budget->current);
+}
+
+/**
+ * gst_memory_budget_get_peak_bytes:
+ * @budget: a #GstMemoryBudget
+ *
+ * Returns: about the highest number of bytes that was charged to @budget at
+ *     once
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+guint64
+gst_memory_budget_get_peak_bytes (GstMemoryBudget * budget)
+{
+  g_return_val_if_fail (budget != NULL, 0);
+
+  return g_atomic_pointer_get (&budget->peak);
+}
+
+/**
+ * gst_memory_budget_charge:
+ * @budget: a #GstMemoryBudget
+ * @size: the number of bytes to charge
+ *
+ * Charge @size bytes to @budget. They need to be released again with
+ * gst_memory_budget_release() when the data is no longer held.
+ *
+ * Returns: %TRUE if @budget is still within its maximum after the charge
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_memory_budget_charge (GstMemoryBudget * budget, gsize size)
+{
+  gsize current, peak;
+
+  g_return_val_if_fail (budget != NULL, FALSE);
+
+  current = (gsize) g_atomic_pointer_add (&budget->current, size) + size;
+
+  /* racy, a concurrent charge may be missed but this is only a statistic */
+  peak = g_atomic_pointer_get (&budget->peak);
+  if (current > peak)
+    g_atomic_pointer_set (&budget->peak, current);
+
+  return current <= budget->max_bytes;
+}
+
+/**
+ * gst_memory_budget_release:
+ * @budget: a #GstMemoryBudget
+ * @size: the number of bytes to release
+ *
+ * Release @size bytes previously charged with gst_memory_budget_charge().
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+void
+gst_memory_budget_release (GstMemoryBudget * budget, gsize size)
+{
+  g_return_if_fail (budget != NULL);
+
+  g_atomic_pointer_add (&budget->current, -(gssize) size);
+}
+
+/**
+ * gst_memory_budget_admit_buffer:
+ * @budget: a #GstMemoryBudget
+ * @buffer: (nullable): the buffer to admit, or %NULL for other data
+ * @size: the number of bytes to charge for the data
+ * @dropping_deltas: (inout) (optional): per-stream state of the caller,
+ *     %TRUE while delta units are dropped until the next keyframe
+ * @exceeded: (out) (optional): whether @budget is exceeded
+ *
+ * Charge @size bytes for data an element is about to hold and apply the
+ * policy of @budget when that exceeds it. With
+ * %GST_MEMORY_BUDGET_POLICY_LEAK exceeding data is refused, with
+ * %GST_MEMORY_BUDGET_POLICY_DROP_DELTA it is refused only if @buffer has
+ * the %GST_BUFFER_FLAG_DELTA_UNIT flag set. Refused data is not charged.
+ *
+ * Delta units following a dropped one can't be decoded until the next
+ * keyframe, so when @dropping_deltas is given, it is set to %TRUE once a
+ * delta unit was dropped and all following delta units are refused until
+ * a buffer without the %GST_BUFFER_FLAG_DELTA_UNIT flag is admitted, even
+ * if the budget has room again. Callers keep one such state per stream,
+ * initialize it to %FALSE and reset it on flushes.
+ *
+ * Elements are expected to post a warning message when @exceeded changes
+ * to %TRUE.
+ *
+ * Returns: %TRUE if the data was charged and should be kept, %FALSE if it
+ *     should be dropped
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_memory_budget_admit_buffer (GstMemoryBudget * budget, GstBuffer * buffer,
+    gsize size, gboolean * dropping_deltas, gboolean * exceeded)
+{
+  gboolean keep = TRUE;
+
+  g_return_val_if_fail (budget != NULL, TRUE);
+
+  if (dropping_deltas && budget->policy == GST_MEMORY_BUDGET_POLICY_DROP_DELTA
+      && buffer != NULL) {
+    if (!GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+      *dropping_deltas = FALSE;
+    } else if (*dropping_deltas) {
+      GST_LOG ("budget %s, dropping delta unit of %" G_GSIZE_FORMAT
+          " bytes until the next keyframe", budget->name, size);
+      if (exceeded)
+        *exceeded = gst_memory_budget_get_current_bytes (budget) + size >
+            budget->max_bytes;
+      return FALSE;
+    }
+  }
+
+  if (gst_memory_budget_charge (budget, size)) {
+    if (exceeded)
+      *exceeded = FALSE;
+    return TRUE;
+  }
+
+  switch (budget->policy) {
+    case GST_MEMORY_BUDGET_POLICY_LEAK:
+      keep = FALSE;
+      break;
+    case GST_MEMORY_BUDGET_POLICY_DROP_DELTA:
+      keep = buffer == NULL
+          || !GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+      break;
+    default:
+      break;
+  }
+
+  if (!keep) {
+    GST_LOG ("budget %s exceeded, dropping %" G_GSIZE_FORMAT " bytes",
+        budget->name, size);
+    gst_memory_budget_release (budget, size);
+    if (dropping_deltas && budget->policy == GST_MEMORY_BUDGET_POLICY_DROP_DELTA)
+      *dropping_deltas = TRUE;
+  }
+
+  if (exceeded)
+    *exceeded = TRUE;
+
+  return keep;
+}
+
+/**
+ * gst_memory_budget_context_new:
+ * @budget: a #GstMemoryBudget
+ *
+ * Create a persistent #GstContext of type #GST_MEMORY_BUDGET_CONTEXT_TYPE
+ * carrying @budget. Setting it on a bin with gst_element_set_context()
+ * distributes it to all children, elements that hold data then charge
+ * @budget for it.
+ *
+ * Returns: (transfer full): a new #GstContext
+ *
+ * Since: 1.24
+ */
+GstContext *
+gst_memory_budget_context_new (GstMemoryBudget * budget)
+{
+  GstContext *context;
+  GstStructure *s;
+
+  g_return_val_if_fail (budget != NULL, NULL);
+
+  context = gst_context_new (GST_MEMORY_BUDGET_CONTEXT_TYPE, TRUE);
+  s = gst_context_writable_structure (context);
+  gst_structure_set (s, "budget", GST_TYPE_MEMORY_BUDGET, budget, NULL);
+
+  return context;
+}
+
+/**
+ * gst_memory_budget_from_context:
+ * @context: a #GstContext
+ *
+ * Get the #GstMemoryBudget carried by @context.
+ *
+ * Returns: (transfer full) (nullable): the #GstMemoryBudget of @context, or
+ *     %NULL if @context is not of type #GST_MEMORY_BUDGET_CONTEXT_TYPE
+ *
+ * Since: 1.24
+ */
+GstMemoryBudget *
+gst_memory_budget_from_context (const GstContext * context)
+{
+  const GstStructure *s;
+  GstMemoryBudget *budget = NULL;
+
+  g_return_val_if_fail (GST_IS_CONTEXT (context), NULL);
+
+  if (!gst_context_has_context_type (context, GST_MEMORY_BUDGET_CONTEXT_TYPE))
+    return NULL;
+
+  s = gst_context_get_structure (context);
+  if (!gst_structure_get (s, "budget", GST_TYPE_MEMORY_BUDGET, &budget, NULL))
+    return NULL;
+
+  return budget;
+}
@@ -0,0 +1,120 @@
+/* GStreamer
+ *
+ * gstmemorybudget.h: shared accounting of queued memory
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_MEMORY_BUDGET_H__
+#define __GST_MEMORY_BUDGET_H__
+
+#include <gst/gstconfig.h>
+#include <gst/gstbuffer.h>
+#include <gst/gstcontext.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_MEMORY_BUDGET (gst_memory_budget_get_type())
+
+/**
+ * GstMemoryBudget:
+ *
+ * Opaque structure accounting the memory held by a group of elements.
+ *
+ * Since: 1.24
+ */
+typedef struct _GstMemoryBudget GstMemoryBudget;
+
+/**
+ * GstMemoryBudgetPolicy:
+ * @GST_MEMORY_BUDGET_POLICY_WARN: keep the data and post a warning message
+ *     on the bus when the budget is exceeded
+ * @GST_MEMORY_BUDGET_POLICY_LEAK: drop incoming data while the budget is
+ *     exceeded
+ * @GST_MEMORY_BUDGET_POLICY_DROP_DELTA: drop incoming delta units once the
+ *     budget is exceeded until the next keyframe, keyframes are still kept
+ *
+ * What elements charging a #GstMemoryBudget do when it is exceeded.
+ *
+ * Since: 1.24
+ */
+typedef enum {
+  GST_MEMORY_BUDGET_POLICY_WARN = 0,
+  GST_MEMORY_BUDGET_POLICY_LEAK,
+  GST_MEMORY_BUDGET_POLICY_DROP_DELTA
+} GstMemoryBudgetPolicy;
+
+/**
+ * GST_MEMORY_BUDGET_CONTEXT_TYPE:
+ *
+ * The #GstContext type carrying a #GstMemoryBudget, see
+ * gst_memory_budget_context_new().
+ *
+ * Since: 1.24
+ */
+#define GST_MEMORY_BUDGET_CONTEXT_TYPE "gst.memory.budget"
+
+GST_API
+GType                   gst_memory_budget_get_type        (void);
+
+GST_API
+GstMemoryBudget *       gst_memory_budget_new             (const gchar * name,
+                                                           guint64 max_bytes,
+                                                           GstMemoryBudgetPolicy policy) G_GNUC_MALLOC;
+GST_API
+GstMemoryBudget *       gst_memory_budget_ref             (GstMemoryBudget * budget);
+
+GST_API
+void                    gst_memory_budget_unref           (GstMemoryBudget * budget);
+
+GST_API
+const gchar *           gst_memory_budget_get_name        (GstMemoryBudget * budget);
+
+GST_API
+guint64                 gst_memory_budget_get_max_bytes    (GstMemoryBudget * budget);
+
+GST_API
+GstMemoryBudgetPolicy   gst_memory_budget_get_policy       (GstMemoryBudget * budget);
+
+GST_API
+guint64                 gst_memory_budget_get_current_bytes (GstMemoryBudget * budget);
+
+GST_API
+guint64                 gst_memory_budget_get_peak_bytes   (GstMemoryBudget * budget);
+
+GST_API
+gboolean                gst_memory_budget_charge          (GstMemoryBudget * budget,
+                                                           gsize size);
+GST_API
+void                    gst_memory_budget_release         (GstMemoryBudget * budget,
+                                                           gsize size);
+GST_API
+gboolean                gst_memory_budget_admit_buffer    (GstMemoryBudget * budget,
+                                                           GstBuffer * buffer,
+                                                           gsize size,
+                                                           gboolean * dropping_deltas,
+                                                           gboolean * exceeded);
+GST_API
+GstContext *            gst_memory_budget_context_new     (GstMemoryBudget * budget);
+
+GST_API
+GstMemoryBudget *       gst_memory_budget_from_context    (const GstContext * context);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstMemoryBudget, gst_memory_budget_unref)
+
+G_END_DECLS
+
+#endif /* __GST_MEMORY_BUDGET_H__ */
@@ -326,6 +326,45 @@ had_parent:
   }
 }
 
+/* Moves the contents of @message into @pending, a message of the same type
+ * and source that is still waiting in a bus queue. This only works when the
+ * queue holds the only reference to @pending, nobody else can then observe
+ * the change. @message can be unreffed afterwards. */
+gboolean
+priv_gst_message_coalesce (GstMessage * pending, GstMessage * message)
+{
+  GstStructure *structure;
+
+  g_return_val_if_fail (GST_MESSAGE_TYPE (pending) ==
+      GST_MESSAGE_TYPE (message), FALSE);
+  g_return_val_if_fail (GST_MESSAGE_SRC (pending) ==
+      GST_MESSAGE_SRC (message), FALSE);
+
+  if (GST_MINI_OBJECT_REFCOUNT_VALUE (pending) != 1 ||
+      GST_MINI_OBJECT_REFCOUNT_VALUE (message) != 1)
+    return FALSE;
+
+  structure = GST_MESSAGE_STRUCTURE (pending);
+  if (structure) {
+    gst_structure_set_parent_refcount (structure, NULL);
+    gst_structure_free (structure);
+  }
+
+  structure = GST_MESSAGE_STRUCTURE (message);
+  GST_MESSAGE_STRUCTURE (message) = NULL;
+  if (structure) {
+    gst_structure_set_parent_refcount (structure, NULL);
+    gst_structure_set_parent_refcount (structure,
+        &pending->mini_object.refcount);
+  }
+  GST_MESSAGE_STRUCTURE (pending) = structure;
+
+  GST_MESSAGE_TIMESTAMP (pending) = GST_MESSAGE_TIMESTAMP (message);
+  GST_MESSAGE_SEQNUM (pending) = GST_MESSAGE_SEQNUM (message);
+
+  return TRUE;
+}
+
 /**
  * gst_message_get_seqnum:
  * @message: A #GstMessage.
@@ -59,6 +59,13 @@ GQuark _gst_meta_transform_copy;
 GQuark _gst_meta_tag_memory;
 GQuark _gst_meta_tag_memory_reference;
 
+/* slots are only ever added, under slot_lock, and published by incrementing
+ * the counter so that lookups don't need to take the lock */
+GType _priv_gst_meta_api_slots[PRIV_GST_META_API_SLOTS];
+guint _priv_gst_meta_api_slot_tags[PRIV_GST_META_API_SLOTS];
+gint _priv_gst_n_meta_api_slots = 0;
+static GMutex slot_lock;
+
 typedef struct
 {
   GstCustomMeta meta;
@@ -148,6 +155,28 @@ gst_meta_api_type_register (const gchar * api, const gchar ** tags)
 
   g_type_set_qdata (type, GST_QUARK (TAGS), g_strdupv ((gchar **) tags));
 
+  if (type != G_TYPE_INVALID) {
+    gint n;
+
+    g_mutex_lock (&slot_lock);
+    n = _priv_gst_n_meta_api_slots;
+    /* the tag quarks are only there after gst_init() */
+    if (n < PRIV_GST_META_API_SLOTS && _gst_meta_tag_memory != 0) {
+      guint slot_tags = 0;
+
+      if (gst_meta_api_type_has_tag (type, _gst_meta_tag_memory))
+        slot_tags |= PRIV_GST_META_API_TAG_MEMORY;
+      if (gst_meta_api_type_has_tag (type, _gst_meta_tag_memory_reference))
+        slot_tags |= PRIV_GST_META_API_TAG_MEMORY_REFERENCE;
+
+      GST_CAT_DEBUG (GST_CAT_META, "  using meta index slot %d", n);
+      _priv_gst_meta_api_slots[n] = type;
+      _priv_gst_meta_api_slot_tags[n] = slot_tags;
+      g_atomic_int_set (&_priv_gst_n_meta_api_slots, n + 1);
+    }
+    g_mutex_unlock (&slot_lock);
+  }
+
   return type;
 }
 
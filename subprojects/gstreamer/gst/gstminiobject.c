@@ -439,6 +439,8 @@ gst_mini_object_make_writable (GstMiniObject * mini_object)
     ret = gst_mini_object_copy (mini_object);
     GST_CAT_DEBUG (GST_CAT_PERFORMANCE, "copy %s miniobject %p -> %p",
         g_type_name (GST_MINI_OBJECT_TYPE (mini_object)), mini_object, ret);
+    if (ret)
+      GST_TRACER_MINI_OBJECT_WRITABLE_COPY (mini_object, ret);
     gst_mini_object_unref (mini_object);
   }
 
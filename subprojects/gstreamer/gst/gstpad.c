@@ -136,6 +136,8 @@ struct _GstPadPrivate
 {
   guint events_cookie;
   GArray *events;
+  /* one bit per event type present in events, see _event_type_bit() */
+  guint64 events_mask;
   guint last_cookie;
 
   gint using;
@@ -150,6 +152,11 @@ struct _GstPadPrivate
    * by a single thread at a time. Protected by the object lock */
   GCond activation_cond;
   gboolean in_activation;
+
+  /* batch mode, protected by the object lock */
+  guint batch_size;
+  GstBufferList *batch;
+  GstFlowReturn batch_ret;
 };
 
 typedef struct
@@ -448,6 +455,7 @@ remove_events (GstPad * pad)
 
   GST_OBJECT_FLAG_UNSET (pad, GST_PAD_FLAG_PENDING_EVENTS);
   g_array_set_size (events, 0);
+  pad->priv->events_mask = 0;
   pad->priv->events_cookie++;
 
   if (notify) {
@@ -462,6 +470,30 @@ remove_events (GstPad * pad)
 
 #define _to_sticky_order(t) gst_event_type_to_sticky_ordering(t)
 
+/* Types can share a bit, so a set bit only means that an event of the type
+ * may be stored, while a cleared bit means that none is. This makes lookups
+ * of absent types, the common case when checking for STREAM_START, SEGMENT
+ * or EOS, independent of the number of stored events. */
+#define _event_type_bit(t) \
+  (G_GUINT64_CONSTANT (1) << (((t) >> GST_EVENT_NUM_SHIFT) & 63))
+
+/* should be called with object lock */
+static void
+update_events_mask (GstPad * pad)
+{
+  GArray *events = pad->priv->events;
+  guint64 mask = 0;
+  guint i;
+
+  for (i = 0; i < events->len; i++) {
+    PadEvent *ev = &g_array_index (events, PadEvent, i);
+
+    if (ev->event)
+      mask |= _event_type_bit (GST_EVENT_TYPE (ev->event));
+  }
+  pad->priv->events_mask = mask;
+}
+
 /* should be called with object lock */
 static PadEvent *
 find_event_by_type (GstPad * pad, GstEventType type, guint idx)
@@ -471,6 +503,9 @@ find_event_by_type (GstPad * pad, GstEventType type, guint idx)
   PadEvent *ev;
   guint last_sticky_order = _to_sticky_order (type);
 
+  if (!(pad->priv->events_mask & _event_type_bit (type)))
+    return NULL;
+
   events = pad->priv->events;
   len = events->len;
 
@@ -500,6 +535,9 @@ find_event (GstPad * pad, GstEvent * event)
   GArray *events;
   PadEvent *ev;
 
+  if (!(pad->priv->events_mask & _event_type_bit (GST_EVENT_TYPE (event))))
+    return NULL;
+
   events = pad->priv->events;
   len = events->len;
 
@@ -523,6 +561,10 @@ remove_event_by_type (GstPad * pad, GstEventType type)
   guint i, len;
   GArray *events;
   PadEvent *ev;
+  gboolean removed = FALSE;
+
+  if (!(pad->priv->events_mask & _event_type_bit (type)))
+    return;
 
   events = pad->priv->events;
   len = events->len;
@@ -544,11 +586,15 @@ remove_event_by_type (GstPad * pad, GstEventType type)
     g_array_remove_index (events, i);
     len--;
     pad->priv->events_cookie++;
+    removed = TRUE;
     continue;
 
   next:
     i++;
   }
+
+  if (removed)
+    update_events_mask (pad);
 }
 
 /* check all events on srcpad against those on sinkpad. All events that are not
@@ -629,12 +675,14 @@ restart:
         /* function unreffed and set the event to NULL, remove it */
         gst_event_unref (ev->event);
         g_array_remove_index (events, i);
+        update_events_mask (pad);
         len--;
         cookie = ++pad->priv->events_cookie;
         continue;
       } else {
         /* function gave a new event for us */
         gst_event_take (&ev->event, ev_ret.event);
+        update_events_mask (pad);
       }
     } else {
       /* just unref, nothing changed */
@@ -729,6 +777,10 @@ gst_pad_dispose (GObject * object)
   GST_OBJECT_LOCK (pad);
   remove_events (pad);
   g_hook_list_clear (&pad->probes);
+  if (pad->priv->batch) {
+    gst_buffer_list_unref (pad->priv->batch);
+    pad->priv->batch = NULL;
+  }
   GST_OBJECT_UNLOCK (pad);
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
@@ -973,6 +1025,8 @@ gst_pad_mode_get_name (GstPadMode mode)
 static gboolean
 pre_activate (GstPad * pad, GstPadMode new_mode)
 {
+  GstBufferList *batch;
+
   switch (new_mode) {
     case GST_PAD_MODE_NONE:
       GST_OBJECT_LOCK (pad);
@@ -991,7 +1045,13 @@ pre_activate (GstPad * pad, GstPadMode new_mode)
       GST_PAD_MODE (pad) = new_mode;
       /* unlock blocked pads so element can resume and stop */
       GST_PAD_BLOCK_BROADCAST (pad);
+      batch = pad->priv->batch;
+      pad->priv->batch = NULL;
+      pad->priv->batch_ret = GST_FLOW_OK;
       GST_OBJECT_UNLOCK (pad);
+      /* drop buffers collected in batch mode */
+      if (batch)
+        gst_buffer_list_unref (batch);
       break;
     case GST_PAD_MODE_PUSH:
     case GST_PAD_MODE_PULL:
@@ -4823,6 +4883,129 @@ not_linked:
   }
 }
 
+/* must be called with the OBJECT_LOCK */
+static inline gboolean
+gst_pad_can_batch_unlocked (GstPad * pad)
+{
+  GstPad *peer;
+
+  if (G_UNLIKELY (pad->priv->batch_size == 0))
+    return FALSE;
+
+  if (G_UNLIKELY (GST_PAD_IS_FLUSHING (pad) || GST_PAD_IS_EOS (pad)))
+    return FALSE;
+
+  if (G_UNLIKELY (GST_PAD_MODE (pad) != GST_PAD_MODE_PUSH))
+    return FALSE;
+
+  /* probes and sticky events need to be handled for each buffer */
+  if (G_UNLIKELY (pad->num_probes || GST_PAD_HAS_PENDING_EVENTS (pad)))
+    return FALSE;
+
+  /* peers without chain list function would get the buffers one by one
+   * anyway, don't delay them */
+  peer = GST_PAD_PEER (pad);
+  if (G_UNLIKELY (peer == NULL
+          || GST_PAD_CHAINLISTFUNC (peer) == gst_pad_chain_list_default))
+    return FALSE;
+
+#ifndef GST_DISABLE_GST_TRACER_HOOKS
+  /* tracers expect to see each pushed buffer */
+  if (G_UNLIKELY (GST_TRACER_IS_ENABLED))
+    return FALSE;
+#endif
+
+  return TRUE;
+}
+
+static GstFlowReturn
+gst_pad_push_batch_list (GstPad * pad, GstBufferList * list)
+{
+  GstFlowReturn res;
+
+  GST_CAT_LOG_OBJECT (GST_CAT_SCHEDULING, pad, "pushing batch of %u buffers",
+      gst_buffer_list_length (list));
+
+  GST_TRACER_PAD_PUSH_LIST_PRE (pad, list);
+  res = gst_pad_push_data (pad,
+      GST_PAD_PROBE_TYPE_BUFFER_LIST | GST_PAD_PROBE_TYPE_PUSH, list);
+  GST_TRACER_PAD_PUSH_LIST_POST (pad, res);
+
+  return res;
+}
+
+/* push the buffers collected in batch mode, if any */
+static GstFlowReturn
+gst_pad_push_pending_batch (GstPad * pad)
+{
+  GstBufferList *list;
+  GstFlowReturn ret;
+
+  GST_OBJECT_LOCK (pad);
+  list = pad->priv->batch;
+  pad->priv->batch = NULL;
+  ret = pad->priv->batch_ret;
+  pad->priv->batch_ret = GST_FLOW_OK;
+  GST_OBJECT_UNLOCK (pad);
+
+  if (list)
+    ret = gst_pad_push_batch_list (pad, list);
+
+  return ret;
+}
+
+/* collect @buffer in the batch of @pad. Returns FALSE when the buffer needs
+ * to be pushed normally */
+static gboolean
+gst_pad_batch_buffer (GstPad * pad, GstBuffer * buffer, GstFlowReturn * ret)
+{
+  GstPadPrivate *priv = pad->priv;
+  GstBufferList *list;
+
+  GST_OBJECT_LOCK (pad);
+  if (G_UNLIKELY (!gst_pad_can_batch_unlocked (pad))) {
+    list = priv->batch;
+    priv->batch = NULL;
+    GST_OBJECT_UNLOCK (pad);
+
+    /* push the collected buffers first to keep the order */
+    if (list) {
+      if ((*ret = gst_pad_push_batch_list (pad, list)) != GST_FLOW_OK) {
+        gst_buffer_unref (buffer);
+        return TRUE;
+      }
+    }
+    return FALSE;
+  }
+
+  /* report the error of a batch that was pushed from an event */
+  if (G_UNLIKELY (priv->batch_ret != GST_FLOW_OK)) {
+    *ret = priv->batch_ret;
+    priv->batch_ret = GST_FLOW_OK;
+    GST_OBJECT_UNLOCK (pad);
+    gst_buffer_unref (buffer);
+    return TRUE;
+  }
+
+  if (priv->batch == NULL)
+    priv->batch = gst_buffer_list_new_sized (priv->batch_size);
+  gst_buffer_list_add (priv->batch, buffer);
+
+  list = NULL;
+  if (gst_buffer_list_length (priv->batch) >= priv->batch_size) {
+    list = priv->batch;
+    priv->batch = NULL;
+  }
+  GST_OBJECT_UNLOCK (pad);
+
+  if (list)
+    *ret = gst_pad_push_batch_list (pad, list);
+  else
+    *ret = GST_FLOW_OK;
+
+  return TRUE;
+}
+
 /**
  * gst_pad_push:
  * @pad: a source #GstPad, returns #GST_FLOW_ERROR if not.
@@ -4854,6 +5037,12 @@ gst_pad_push (GstPad * pad, GstBuffer * buffer)
   g_return_val_if_fail (GST_PAD_IS_SRC (pad), GST_FLOW_ERROR);
   g_return_val_if_fail (GST_IS_BUFFER (buffer), GST_FLOW_ERROR);
 
+  /* unlocked check, the batch is only filled from the streaming thread */
+  if (G_UNLIKELY (pad->priv->batch_size != 0 || pad->priv->batch != NULL)) {
+    if (gst_pad_batch_buffer (pad, buffer, &res))
+      return res;
+  }
+
   GST_TRACER_PAD_PUSH_PRE (pad, buffer);
   res = gst_pad_push_data (pad,
       GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_PUSH, buffer);
@@ -4894,6 +5083,14 @@ gst_pad_push_list (GstPad * pad, GstBufferList * list)
   g_return_val_if_fail (GST_PAD_IS_SRC (pad), GST_FLOW_ERROR);
   g_return_val_if_fail (GST_IS_BUFFER_LIST (list), GST_FLOW_ERROR);
 
+  /* keep the order with buffers collected in batch mode */
+  if (G_UNLIKELY (pad->priv->batch != NULL)) {
+    if ((res = gst_pad_push_pending_batch (pad)) != GST_FLOW_OK) {
+      gst_buffer_list_unref (list);
+      return res;
+    }
+  }
+
   GST_TRACER_PAD_PUSH_LIST_PRE (pad, list);
   res = gst_pad_push_data (pad,
       GST_PAD_PROBE_TYPE_BUFFER_LIST | GST_PAD_PROBE_TYPE_PUSH, list);
@@ -4901,6 +5098,96 @@ gst_pad_push_list (GstPad * pad, GstBufferList * list)
   return res;
 }
 
+/**
+ * gst_pad_set_batch_size:
+ * @pad: a source #GstPad
+ * @size: the maximum number of buffers to collect, or 0 to disable batching
+ *
+ * Enables or disables batch mode on @pad.
+ *
+ * In batch mode, buffers pushed with gst_pad_push() are collected into a
+ * #GstBufferList instead of being pushed one by one, as long as no probes are
+ * installed on @pad, no sticky events are pending and the peer pad has its
+ * own chain list function. Peer pads without a chain list function keep
+ * receiving the buffers one by one.
+ *
+ * The collected buffers are pushed downstream with a single
+ * gst_pad_push_list() when @size buffers have been collected, before any
+ * other buffer list or serialized event is pushed on @pad, and when
+ * gst_pad_push_batch() is called. Elements using batch mode should call
+ * gst_pad_push_batch() when they have no more data ready so that buffers are
+ * not held back.
+ *
+ * The #GstFlowReturn returned by gst_pad_push() for a buffer that was only
+ * collected is the result of pushing the previous batch.
+ *
+ * Disabling batch mode pushes the collected buffers downstream, this should
+ * only be done from the streaming thread.
+ *
+ * Since: 1.24
+ */
+void
+gst_pad_set_batch_size (GstPad * pad, guint size)
+{
+  g_return_if_fail (GST_IS_PAD (pad));
+  g_return_if_fail (GST_PAD_IS_SRC (pad));
+
+  GST_OBJECT_LOCK (pad);
+  GST_DEBUG_OBJECT (pad, "setting batch size to %u", size);
+  pad->priv->batch_size = size;
+  GST_OBJECT_UNLOCK (pad);
+
+  if (size == 0)
+    gst_pad_push_pending_batch (pad);
+}
+
+/**
+ * gst_pad_get_batch_size:
+ * @pad: a source #GstPad
+ *
+ * Gets the maximum number of buffers collected in batch mode on @pad.
+ *
+ * Returns: the batch size of @pad, 0 if batch mode is disabled.
+ *
+ * Since: 1.24
+ */
+guint
+gst_pad_get_batch_size (GstPad * pad)
+{
+  guint size;
+
+  g_return_val_if_fail (GST_IS_PAD (pad), 0);
+
+  GST_OBJECT_LOCK (pad);
+  size = pad->priv->batch_size;
+  GST_OBJECT_UNLOCK (pad);
+
+  return size;
+}
+
+/**
+ * gst_pad_push_batch:
+ * @pad: a source #GstPad
+ *
+ * Pushes the buffers that were collected in batch mode on @pad to the peer
+ * pad. See gst_pad_set_batch_size().
+ *
+ * Returns: a #GstFlowReturn from the peer pad, %GST_FLOW_OK when no buffers
+ * were collected.
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+GstFlowReturn
+gst_pad_push_batch (GstPad * pad)
+{
+  g_return_val_if_fail (GST_IS_PAD (pad), GST_FLOW_ERROR);
+  g_return_val_if_fail (GST_PAD_IS_SRC (pad), GST_FLOW_ERROR);
+
+  return gst_pad_push_pending_batch (pad);
+}
+
 static GstFlowReturn
 gst_pad_get_range_unchecked (GstPad * pad, guint64 offset, guint size,
     GstBuffer ** buffer)
@@ -5377,6 +5664,7 @@ store_sticky_event (GstPad * pad, GstEvent * event)
     ev.event = gst_event_ref (event);
     ev.received = FALSE;
     g_array_insert_val (events, i, ev);
+    pad->priv->events_mask |= _event_type_bit (type);
     res = TRUE;
   }
 
@@ -5640,6 +5928,43 @@ idle_probe_stopped:
   }
 }
 
+/* buffers collected in batch mode must go out before serialized events and
+ * are dropped when flushing */
+static void
+gst_pad_batch_handle_event (GstPad * pad, GstEvent * event)
+{
+  GstBufferList *list = NULL;
+  gboolean flush_start;
+
+  flush_start = GST_EVENT_TYPE (event) == GST_EVENT_FLUSH_START;
+
+  /* out of band events don't change the order of the collected buffers */
+  GST_OBJECT_LOCK (pad);
+  if (flush_start || GST_EVENT_IS_SERIALIZED (event)) {
+    list = pad->priv->batch;
+    pad->priv->batch = NULL;
+  }
+  GST_OBJECT_UNLOCK (pad);
+
+  if (list == NULL)
+    return;
+
+  if (flush_start) {
+    GST_CAT_LOG_OBJECT (GST_CAT_SCHEDULING, pad, "dropping batch of %u buffers",
+        gst_buffer_list_length (list));
+    gst_buffer_list_unref (list);
+  } else {
+    GstFlowReturn ret;
+
+    ret = gst_pad_push_batch_list (pad, list);
+
+    /* reported by the next push */
+    GST_OBJECT_LOCK (pad);
+    pad->priv->batch_ret = ret;
+    GST_OBJECT_UNLOCK (pad);
+  }
+}
+
 /**
  * gst_pad_push_event:
  * @pad: a #GstPad to push the event to.
@@ -5672,6 +5997,9 @@ gst_pad_push_event (GstPad * pad, GstEvent * event)
     if (G_UNLIKELY (!GST_EVENT_IS_DOWNSTREAM (event)))
       goto wrong_direction;
     type = GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM;
+
+    if (G_UNLIKELY (pad->priv->batch != NULL))
+      gst_pad_batch_handle_event (pad, event);
   } else if (GST_PAD_IS_SINK (pad)) {
     if (G_UNLIKELY (!GST_EVENT_IS_UPSTREAM (event)))
       goto wrong_direction;
@@ -1486,6 +1486,15 @@ GstFlowReturn		gst_pad_push				(GstPad *pad, GstBuffer *buffer);
 GST_API
 GstFlowReturn		gst_pad_push_list			(GstPad *pad, GstBufferList *list);
 
+GST_API
+void			gst_pad_set_batch_size			(GstPad *pad, guint size);
+
+GST_API
+guint			gst_pad_get_batch_size			(GstPad *pad);
+
+GST_API
+GstFlowReturn		gst_pad_push_batch			(GstPad *pad);
+
 GST_API
 GstFlowReturn		gst_pad_pull_range			(GstPad *pad, guint64 offset, guint size,
 								 GstBuffer **buffer);
@@ -33,6 +33,25 @@
  * Please note that these functions take several measures to create
  * somewhat dynamic pipelines. Due to that such pipelines are not always
  * reusable (set the state to NULL and back to PLAYING).
+ *
+ * Applications that create many similar pipelines can compile the description
+ * once with gst_parse_template_new() and create the pipelines with
+ * gst_parse_template_instantiate(). Property values can be left open as
+ * `${name}` parameters that get a value per pipeline, and the factories and
+ * property values are only resolved and deserialized once for all pipelines.
+ *
+ * |[<!-- language="C" -->
+ *   GstParseTemplate *tmpl;
+ *   GstStructure *params;
+ *   GstElement *pipeline;
+ *
+ *   tmpl = gst_parse_template_new ("udpsrc port=${port} ! rtpjitterbuffer ! "
+ *       "fakesink", GST_PARSE_FLAG_NONE, &error);
+ *
+ *   params = gst_structure_new ("params", "port", G_TYPE_INT, 5004, NULL);
+ *   pipeline = gst_parse_template_instantiate (tmpl, params, NULL, &error);
+ *   gst_structure_free (params);
+ * ]|
  */
 
 #include "gst_private.h"
@@ -45,10 +64,34 @@
 #include "parse/types.h"
 #endif
 
+struct _GstParseTemplate
+{
+  gint refcount;
+
+  GstParseFlags flags;
+
+  /* the description split at the parameters, segments[i] is followed by the
+   * value of the parameter params[i] and the last segment by nothing */
+  gchar **segments;
+  gchar **params;
+  guint n_params;
+
+  /* the unique parameter names */
+  gchar **names;
+
+#ifndef GST_DISABLE_PARSE
+  GstParseCache *cache;
+#endif
+};
+
 G_DEFINE_BOXED_TYPE (GstParseContext, gst_parse_context,
     (GBoxedCopyFunc) gst_parse_context_copy,
     (GBoxedFreeFunc) gst_parse_context_free);
 
+G_DEFINE_BOXED_TYPE (GstParseTemplate, gst_parse_template,
+    (GBoxedCopyFunc) gst_parse_template_ref,
+    (GBoxedFreeFunc) gst_parse_template_unref);
+
 /**
  * gst_parse_error_quark:
  *
@@ -308,6 +351,54 @@ gst_parse_launch (const gchar * pipeline_description, GError ** error)
       error);
 }
 
+#ifndef GST_DISABLE_PARSE
+static GstElement *
+gst_parse_launch_with_cache (const gchar * pipeline_description,
+    GstParseContext * context, GstParseFlags flags, GstParseCache * cache,
+    GError ** error)
+{
+  GstElement *element;
+  GError *myerror = NULL;
+
+  GST_CAT_INFO (GST_CAT_PIPELINE, "parsing pipeline description '%s'",
+      pipeline_description);
+
+  element = priv_gst_parse_launch (pipeline_description, &myerror, context,
+      flags, cache);
+
+  /* don't return partially constructed pipeline if FATAL_ERRORS was given */
+  if (G_UNLIKELY (myerror != NULL && element != NULL)) {
+    if ((flags & GST_PARSE_FLAG_FATAL_ERRORS)) {
+      gst_object_unref (element);
+      element = NULL;
+    }
+  }
+
+  if (myerror)
+    g_propagate_error (error, myerror);
+
+  return element;
+}
+
+static gboolean
+gst_parse_is_param_char (gchar c)
+{
+  return g_ascii_isalnum (c) || c == '_' || c == '-';
+}
+#else /* GST_DISABLE_PARSE */
+static void
+gst_parse_set_disabled_error (GError ** error)
+{
+  gchar *msg;
+
+  GST_WARNING ("Disabled API called");
+
+  msg = gst_error_get_message (GST_CORE_ERROR, GST_CORE_ERROR_DISABLED);
+  g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_DISABLED, "%s", msg);
+  g_free (msg);
+}
+#endif /* GST_DISABLE_PARSE */
+
 /**
  * gst_parse_launch_full:
  * @pipeline_description: the command line describing the pipeline
@@ -335,38 +426,284 @@ gst_parse_launch_full (const gchar * pipeline_description,
     GstParseContext * context, GstParseFlags flags, GError ** error)
 {
 #ifndef GST_DISABLE_PARSE
-  GstElement *element;
-  GError *myerror = NULL;
-
   g_return_val_if_fail (pipeline_description != NULL, NULL);
   g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-  GST_CAT_INFO (GST_CAT_PIPELINE, "parsing pipeline description '%s'",
-      pipeline_description);
+  return gst_parse_launch_with_cache (pipeline_description, context, flags,
+      NULL, error);
+#else
+  gst_parse_set_disabled_error (error);
 
-  element = priv_gst_parse_launch (pipeline_description, &myerror, context,
-      flags);
+  return NULL;
+#endif
+}
 
-  /* don't return partially constructed pipeline if FATAL_ERRORS was given */
-  if (G_UNLIKELY (myerror != NULL && element != NULL)) {
-    if ((flags & GST_PARSE_FLAG_FATAL_ERRORS)) {
-      gst_object_unref (element);
-      element = NULL;
+/**
+ * gst_parse_template_new:
+ * @description: the command line describing the pipeline, with `${name}`
+ *     parameters
+ * @flags: parsing options used for every instantiation
+ * @error: the error message in case of an erroneous description
+ *
+ * Compile a pipeline description into a #GstParseTemplate, which can be
+ * instantiated many times with gst_parse_template_instantiate().
+ *
+ * The description uses the same syntax as gst_parse_launch(). Property values
+ * can be replaced by parameters in the form `${name}`, made of letters,
+ * digits, `-` and `_`. Parameters can only be used as the complete value of a
+ * property, as in `location=${path}`.
+ *
+ * The element factories and the deserialized property values are kept in the
+ * template and are reused by all its instantiations.
+ *
+ * Returns: (transfer full) (nullable): a new #GstParseTemplate, or %NULL if
+ *     @description uses parameters the wrong way
+ *
+ * Since: 1.24
+ */
+GstParseTemplate *
+gst_parse_template_new (const gchar * description, GstParseFlags flags,
+    GError ** error)
+{
+#ifndef GST_DISABLE_PARSE
+  GstParseTemplate *tmpl;
+  GPtrArray *segments, *params, *names;
+  const gchar *walk, *start;
+
+  g_return_val_if_fail (description != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  segments = g_ptr_array_new ();
+  params = g_ptr_array_new ();
+  names = g_ptr_array_new ();
+
+  start = walk = description;
+  while ((walk = strstr (walk, "${")) != NULL) {
+    const gchar *name, *before;
+    gchar *param;
+    guint i;
+
+    /* must be the value of an assignment */
+    before = walk;
+    while (before > description && g_ascii_isspace (before[-1]))
+      before--;
+    if (before == description || before[-1] != '=')
+      goto not_a_value;
+
+    name = walk + 2;
+    for (walk = name; gst_parse_is_param_char (*walk); walk++);
+    if (walk == name || *walk != '}')
+      goto bad_param;
+    walk++;
+    if (*walk != '\0' && !g_ascii_isspace (*walk))
+      goto not_a_value;
+
+    param = g_strndup (name, walk - name - 1);
+    g_ptr_array_add (segments, g_strndup (start, name - 2 - start));
+    g_ptr_array_add (params, param);
+    start = walk;
+
+    for (i = 0; i < names->len; i++) {
+      if (strcmp (g_ptr_array_index (names, i), param) == 0)
+        break;
     }
+    if (i == names->len)
+      g_ptr_array_add (names, g_strdup (param));
+  }
+  g_ptr_array_add (segments, g_strdup (start));
+
+  tmpl = g_new0 (GstParseTemplate, 1);
+  tmpl->refcount = 1;
+  tmpl->flags = flags;
+  tmpl->n_params = params->len;
+  g_ptr_array_add (segments, NULL);
+  tmpl->segments = (gchar **) g_ptr_array_free (segments, FALSE);
+  g_ptr_array_add (params, NULL);
+  tmpl->params = (gchar **) g_ptr_array_free (params, FALSE);
+  g_ptr_array_add (names, NULL);
+  tmpl->names = (gchar **) g_ptr_array_free (names, FALSE);
+  tmpl->cache = priv_gst_parse_cache_new ();
+
+  GST_CAT_DEBUG (GST_CAT_PIPELINE, "compiled description '%s' with %u "
+      "parameters", description, tmpl->n_params);
+
+  return tmpl;
+
+  /* ERRORS */
+not_a_value:
+  {
+    g_set_error (error, GST_PARSE_ERROR, GST_PARSE_ERROR_SYNTAX,
+        "parameters can only be used as property values");
+    goto error;
+  }
+bad_param:
+  {
+    g_set_error (error, GST_PARSE_ERROR, GST_PARSE_ERROR_SYNTAX,
+        "malformed parameter");
+    goto error;
+  }
+error:
+  {
+    g_ptr_array_foreach (segments, (GFunc) g_free, NULL);
+    g_ptr_array_free (segments, TRUE);
+    g_ptr_array_foreach (params, (GFunc) g_free, NULL);
+    g_ptr_array_free (params, TRUE);
+    g_ptr_array_foreach (names, (GFunc) g_free, NULL);
+    g_ptr_array_free (names, TRUE);
+    return NULL;
   }
+#else
+  gst_parse_set_disabled_error (error);
 
-  if (myerror)
-    g_propagate_error (error, myerror);
+  return NULL;
+#endif
+}
 
-  return element;
-#else
-  gchar *msg;
+/**
+ * gst_parse_template_ref:
+ * @tmpl: a #GstParseTemplate
+ *
+ * Increase the refcount of @tmpl.
+ *
+ * Returns: (transfer full): @tmpl
+ *
+ * Since: 1.24
+ */
+GstParseTemplate *
+gst_parse_template_ref (GstParseTemplate * tmpl)
+{
+  g_return_val_if_fail (tmpl != NULL, NULL);
 
-  GST_WARNING ("Disabled API called");
+  g_atomic_int_inc (&tmpl->refcount);
 
-  msg = gst_error_get_message (GST_CORE_ERROR, GST_CORE_ERROR_DISABLED);
-  g_set_error (error, GST_CORE_ERROR, GST_CORE_ERROR_DISABLED, "%s", msg);
-  g_free (msg);
+  return tmpl;
+}
+
+/**
+ * gst_parse_template_unref:
+ * @tmpl: (transfer full): a #GstParseTemplate
+ *
+ * Decrease the refcount of @tmpl and free it when it reaches 0.
+ *
+ * Since: 1.24
+ */
+void
+gst_parse_template_unref (GstParseTemplate * tmpl)
+{
+  g_return_if_fail (tmpl != NULL);
+
+  if (g_atomic_int_dec_and_test (&tmpl->refcount)) {
+    g_strfreev (tmpl->segments);
+    g_strfreev (tmpl->params);
+    g_strfreev (tmpl->names);
+#ifndef GST_DISABLE_PARSE
+    priv_gst_parse_cache_free (tmpl->cache);
+#endif
+    g_free (tmpl);
+  }
+}
+
+/**
+ * gst_parse_template_get_parameters:
+ * @tmpl: a #GstParseTemplate
+ *
+ * Get the names of the parameters used in @tmpl.
+ *
+ * Returns: (transfer none) (array zero-terminated=1): the %NULL terminated
+ *     parameter names
+ *
+ * Since: 1.24
+ */
+const gchar *const *
+gst_parse_template_get_parameters (GstParseTemplate * tmpl)
+{
+  g_return_val_if_fail (tmpl != NULL, NULL);
+
+  return (const gchar * const *) tmpl->names;
+}
+
+/**
+ * gst_parse_template_instantiate:
+ * @tmpl: a #GstParseTemplate
+ * @parameters: (nullable): a #GstStructure with a field for every parameter
+ *     of @tmpl
+ * @context: (nullable): a parse context allocated with
+ *      gst_parse_context_new(), or %NULL
+ * @error: the error message in case of an erroneous pipeline.
+ *
+ * Create a new pipeline from @tmpl like gst_parse_launch_full(). The
+ * parameters of @tmpl are replaced by the fields of the same name in
+ * @parameters, non-string fields are serialized with gst_value_serialize().
+ *
+ * This function can be called from multiple threads at the same time.
+ *
+ * Returns: (transfer floating) (nullable): a new element on success, %NULL on
+ *     failure or if a parameter is missing.
+ *
+ * Since: 1.24
+ */
+GstElement *
+gst_parse_template_instantiate (GstParseTemplate * tmpl,
+    const GstStructure * parameters, GstParseContext * context,
+    GError ** error)
+{
+#ifndef GST_DISABLE_PARSE
+  GstElement *element;
+  GString *str;
+  guint i;
+
+  g_return_val_if_fail (tmpl != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  str = g_string_sized_new (256);
+
+  for (i = 0; i < tmpl->n_params; i++) {
+    const GValue *value;
+    const gchar *p;
+    gchar *serialized = NULL;
+
+    g_string_append (str, tmpl->segments[i]);
+
+    value = parameters ? gst_structure_get_value (parameters,
+        tmpl->params[i]) : NULL;
+    if (value == NULL)
+      goto missing_param;
+
+    if (G_VALUE_HOLDS_STRING (value))
+      p = g_value_get_string (value);
+    else
+      p = serialized = gst_value_serialize (value);
+    if (p == NULL)
+      p = "";
+
+    /* quote the value, the parser strips the quotes and the escapes again */
+    g_string_append_c (str, '"');
+    for (; *p; p++) {
+      if (*p == '"' || *p == '\\')
+        g_string_append_c (str, '\\');
+      g_string_append_c (str, *p);
+    }
+    g_string_append_c (str, '"');
+    g_free (serialized);
+  }
+  g_string_append (str, tmpl->segments[i]);
+
+  element = gst_parse_launch_with_cache (str->str, context, tmpl->flags,
+      tmpl->cache, error);
+  g_string_free (str, TRUE);
+
+  return element;
+
+  /* ERRORS */
+missing_param:
+  {
+    g_set_error (error, GST_PARSE_ERROR, GST_PARSE_ERROR_SYNTAX,
+        "no value for parameter \"%s\"", tmpl->params[i]);
+    g_string_free (str, TRUE);
+    return NULL;
+  }
+#else
+  gst_parse_set_disabled_error (error);
 
   return NULL;
 #endif
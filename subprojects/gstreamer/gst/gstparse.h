@@ -131,7 +131,44 @@ GstElement      * gst_parse_launchv_full (const gchar     ** argv,
                                           GstParseFlags      flags,
                                           GError          ** error) G_GNUC_MALLOC;
 
+/* compiled pipeline descriptions */
+
+#define GST_TYPE_PARSE_TEMPLATE (gst_parse_template_get_type())
+
+/**
+ * GstParseTemplate:
+ *
+ * Opaque structure holding a compiled pipeline description, see
+ * gst_parse_template_new().
+ *
+ * Since: 1.24
+ */
+typedef struct _GstParseTemplate GstParseTemplate;
+
+GST_API
+GType              gst_parse_template_get_type    (void);
+
+GST_API
+GstParseTemplate * gst_parse_template_new         (const gchar      * description,
+                                                   GstParseFlags      flags,
+                                                   GError          ** error) G_GNUC_MALLOC;
+GST_API
+GstParseTemplate * gst_parse_template_ref         (GstParseTemplate * tmpl);
+
+GST_API
+void               gst_parse_template_unref       (GstParseTemplate * tmpl);
+
+GST_API
+const gchar * const * gst_parse_template_get_parameters (GstParseTemplate * tmpl);
+
+GST_API
+GstElement       * gst_parse_template_instantiate (GstParseTemplate * tmpl,
+                                                   const GstStructure * parameters,
+                                                   GstParseContext  * context,
+                                                   GError          ** error) G_GNUC_MALLOC;
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstParseContext, gst_parse_context_free)
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstParseTemplate, gst_parse_template_unref)
 
 G_END_DECLS
 
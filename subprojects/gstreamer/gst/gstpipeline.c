@@ -1027,6 +1027,62 @@ gst_pipeline_get_auto_flush_bus (GstPipeline * pipeline)
   return res;
 }
 
+/**
+ * gst_pipeline_reset:
+ * @pipeline: a #GstPipeline
+ *
+ * Brings @pipeline back to the %GST_STATE_READY state so that it can be
+ * reused for another stream, for example after pointing the source and sink
+ * elements to new locations, instead of creating a new pipeline.
+ *
+ * Unlike going through the %GST_STATE_NULL state, the elements keep the
+ * resources they acquire when going to READY, like opened devices and
+ * hardware contexts, which makes the next run start faster. The pending
+ * messages of the previous run, like EOS and errors, are removed from the
+ * bus unless automatic flushing was disabled with
+ * gst_pipeline_set_auto_flush_bus(), and the running time of the next run
+ * starts at 0 again.
+ *
+ * Returns: %TRUE if @pipeline is in the READY state
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_pipeline_reset (GstPipeline * pipeline)
+{
+  GstBus *bus;
+  gboolean auto_flush;
+
+  g_return_val_if_fail (GST_IS_PIPELINE (pipeline), FALSE);
+
+  GST_DEBUG_OBJECT (pipeline, "resetting for reuse");
+
+  /* going down to READY is never async */
+  if (gst_element_set_state (GST_ELEMENT_CAST (pipeline),
+          GST_STATE_READY) == GST_STATE_CHANGE_FAILURE) {
+    GST_WARNING_OBJECT (pipeline, "failed to go to READY");
+    return FALSE;
+  }
+
+  GST_OBJECT_LOCK (pipeline);
+  if ((bus = GST_ELEMENT_BUS (pipeline)))
+    gst_object_ref (bus);
+  auto_flush = pipeline->priv->auto_flush_bus;
+  GST_OBJECT_UNLOCK (pipeline);
+
+  if (bus) {
+    if (auto_flush) {
+      gst_bus_set_flushing (bus, TRUE);
+      gst_bus_set_flushing (bus, FALSE);
+    }
+    gst_object_unref (bus);
+  }
+
+  return TRUE;
+}
+
 /**
  * gst_pipeline_set_latency:
  * @pipeline: a #GstPipeline
@@ -800,7 +800,8 @@ win32_plugin_loader_process_packet (Win32PluginLoader * self)
         if (header->payload_size > 0) {
           GstPlugin *new_plugin = NULL;
           if (!_priv_gst_registry_chunks_load_plugin (server->registry,
-                  &payload, payload + header->payload_size, &new_plugin)) {
+                  &payload, payload + header->payload_size, NULL,
+                  &new_plugin)) {
             /* Got garbage from the child, so fail and trigger replay of plugins */
             GST_ERROR ("Problems loading plugin details with seqnum %u",
                 header->seq_num);
@@ -83,6 +83,12 @@
 #endif
 #include <sys/time.h>
 #include <sys/socket.h>
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 #endif
 
 #ifdef G_OS_WIN32
@@ -124,9 +130,14 @@ typedef enum
   GST_POLL_MODE_PSELECT,
   GST_POLL_MODE_POLL,
   GST_POLL_MODE_PPOLL,
+  GST_POLL_MODE_EPOLL,
   GST_POLL_MODE_WINDOWS
 } GstPollMode;
 
+/* sets with at least this many fds switch from poll() to epoll, below that
+ * poll() over the small array is cheaper than the extra epoll_ctl() calls */
+#define EPOLL_MIN_FDS 64
+
 struct _GstPoll
 {
   GstPollMode mode;
@@ -150,6 +161,21 @@ struct _GstPoll
   HANDLE wakeup_event;
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+  /* once in epoll mode all fds are registered with epoll_fd and the results
+   * are stored directly in fds, active_fds is not used anymore. The event
+   * data is the index in fds and the fd, so the moved fd is updated when an
+   * fd is removed. */
+  gint epoll_fd;
+  /* only used from the waiting thread */
+  GArray *epoll_events;
+  /* index and fd of the entries with revents set by the last wait, cleared
+   * with the lock before the next wait */
+  GArray *epoll_ready;
+  /* an fd could not be added, fall back to poll() on the next wait */
+  gboolean epoll_failed;
+#endif
+
   gboolean controllable;
   gint waiting;
   gint control_pending;
@@ -172,12 +198,33 @@ static gboolean gst_poll_add_fd_unlocked (GstPoll * set, GstPollFD * fd);
 #define TEST_REBUILD(s)     (g_atomic_int_compare_and_exchange(&(s)->rebuild, 1, 0))
 #define MARK_REBUILD(s)     (g_atomic_int_set(&(s)->rebuild, 1))
 
+#ifdef HAVE_SYS_EPOLL_H
+#define USE_EPOLL(s)        ((s)->epoll_fd >= 0)
+#define ACTIVE_FDS(s)       (USE_EPOLL (s) ? (s)->fds : (s)->active_fds)
+#else
+#define ACTIVE_FDS(s)       ((s)->active_fds)
+#endif
+
 #ifndef G_OS_WIN32
 
 static gboolean
 wake_event (GstPoll * set)
 {
   ssize_t num_written;
+#ifdef HAVE_SYS_EVENTFD_H
+  if (set->control_write_fd.fd == set->control_read_fd.fd) {
+    guint64 val = 1;
+
+    while ((num_written = write (set->control_write_fd.fd, &val,
+                sizeof (val))) != sizeof (val)) {
+      if (num_written == -1 && errno != EAGAIN && errno != EINTR) {
+        g_critical ("%p: failed to wake event: %s", set, strerror (errno));
+        return FALSE;
+      }
+    }
+    return TRUE;
+  }
+#endif
   while ((num_written = write (set->control_write_fd.fd, "W", 1)) != 1) {
     if (num_written == -1 && errno != EAGAIN && errno != EINTR) {
       g_critical ("%p: failed to wake event: %s", set, strerror (errno));
@@ -192,6 +239,21 @@ release_event (GstPoll * set)
 {
   gchar buf[1] = { '\0' };
   ssize_t num_read;
+#ifdef HAVE_SYS_EVENTFD_H
+  if (set->control_write_fd.fd == set->control_read_fd.fd) {
+    guint64 val;
+
+    /* only called with a pending wakeup, so this does not block */
+    while ((num_read = read (set->control_read_fd.fd, &val,
+                sizeof (val))) != sizeof (val)) {
+      if (num_read == -1 && errno != EAGAIN && errno != EINTR) {
+        g_critical ("%p: failed to release event: %s", set, strerror (errno));
+        return FALSE;
+      }
+    }
+    return TRUE;
+  }
+#endif
   while ((num_read = read (set->control_read_fd.fd, buf, 1)) != 1) {
     if (num_read == -1 && errno != EAGAIN && errno != EINTR) {
       g_critical ("%p: failed to release event: %s", set, strerror (errno));
@@ -392,6 +454,135 @@ find_index (GArray * array, GstPollFD * fd)
   return fd->idx;
 }
 
+#ifdef HAVE_SYS_EPOLL_H
+#define EPOLL_DATA(idx,fd)    (((guint64) (idx) << 32) | (guint32) (fd))
+#define EPOLL_DATA_IDX(data)  ((guint) ((data) >> 32))
+#define EPOLL_DATA_FD(data)   ((gint) ((data) & G_MAXUINT32))
+
+/* call with the lock */
+static void
+epoll_update_fd (GstPoll * set, gint op, guint idx)
+{
+  struct pollfd *pfd = &g_array_index (set->fds, struct pollfd, idx);
+  struct epoll_event ev = { 0, };
+
+  if (!USE_EPOLL (set))
+    return;
+
+  /* errors and hangups are always reported */
+  ev.events = pfd->events & (EPOLLIN | EPOLLPRI | EPOLLOUT);
+  ev.data.u64 = EPOLL_DATA (idx, pfd->fd);
+
+  if (epoll_ctl (set->epoll_fd, op, pfd->fd, &ev) < 0) {
+    /* removing an fd that was already closed fails, which is fine */
+    if (op == EPOLL_CTL_DEL)
+      return;
+
+    /* regular files can't be used with epoll for example */
+    GST_WARNING ("%p: epoll_ctl on fd %d failed: %s", set, pfd->fd,
+        g_strerror (errno));
+    set->epoll_failed = TRUE;
+    MARK_REBUILD (set);
+  }
+}
+
+/* call with the lock, from the waiting thread. Returns %TRUE if the set
+ * is in epoll mode */
+static gboolean
+epoll_rebuild (GstPoll * set)
+{
+  guint i;
+
+  /* timers can have multiple waiters and only have the control fd */
+  if (set->timer)
+    return FALSE;
+
+  if (USE_EPOLL (set) && set->epoll_failed) {
+    GST_INFO ("%p: falling back to poll", set);
+    close (set->epoll_fd);
+    set->epoll_fd = -1;
+    g_array_set_size (set->epoll_ready, 0);
+  }
+
+  if (!USE_EPOLL (set) && !set->epoll_failed &&
+      set->fds->len >= EPOLL_MIN_FDS) {
+    set->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+    if (set->epoll_fd < 0) {
+      GST_WARNING ("%p: can't create epoll: %s", set, g_strerror (errno));
+      set->epoll_failed = TRUE;
+      return FALSE;
+    }
+
+    GST_DEBUG ("%p: switching to epoll for %u fds", set, set->fds->len);
+    for (i = 0; i < set->fds->len && !set->epoll_failed; i++)
+      epoll_update_fd (set, EPOLL_CTL_ADD, i);
+
+    if (set->epoll_failed) {
+      close (set->epoll_fd);
+      set->epoll_fd = -1;
+    }
+  }
+
+  if (!USE_EPOLL (set))
+    return FALSE;
+
+  g_array_set_size (set->epoll_events, set->fds->len);
+
+  return TRUE;
+}
+
+/* call with the lock */
+static void
+epoll_clear_ready (GstPoll * set)
+{
+  guint i;
+
+  for (i = 0; i < set->epoll_ready->len; i++) {
+    guint64 data = g_array_index (set->epoll_ready, guint64, i);
+    GstPollFD fd = GST_POLL_FD_INIT;
+    gint idx;
+
+    /* look up again if the fd was moved by a removal */
+    fd.fd = EPOLL_DATA_FD (data);
+    fd.idx = EPOLL_DATA_IDX (data);
+    idx = find_index (set->fds, &fd);
+    if (idx >= 0)
+      g_array_index (set->fds, struct pollfd, idx).revents = 0;
+  }
+
+  g_array_set_size (set->epoll_ready, 0);
+}
+
+static gint
+epoll_collect (GstPoll * set, gint n_events)
+{
+  gint i, res = 0;
+
+  g_mutex_lock (&set->lock);
+  for (i = 0; i < n_events; i++) {
+    struct epoll_event *ev =
+        &g_array_index (set->epoll_events, struct epoll_event, i);
+    guint idx = EPOLL_DATA_IDX (ev->data.u64);
+    struct pollfd *pfd;
+
+    /* removed while we were waiting */
+    if (idx >= set->fds->len)
+      continue;
+    pfd = &g_array_index (set->fds, struct pollfd, idx);
+    if (pfd->fd != EPOLL_DATA_FD (ev->data.u64))
+      continue;
+
+    pfd->revents =
+        ev->events & (POLLIN | POLLPRI | POLLOUT | POLLERR | POLLHUP);
+    g_array_append_val (set->epoll_ready, ev->data.u64);
+    res++;
+  }
+  g_mutex_unlock (&set->lock);
+
+  return res;
+}
+#endif
+
 #if !defined(HAVE_PPOLL) && defined(HAVE_POLL)
 /* check if all file descriptors will fit in an fd_set */
 static gboolean
@@ -440,6 +631,10 @@ choose_mode (GstPoll * set, GstClockTime timeout)
   GstPollMode mode;
 
   if (set->mode == GST_POLL_MODE_AUTO) {
+#ifdef HAVE_SYS_EPOLL_H
+    if (USE_EPOLL (set))
+      return GST_POLL_MODE_EPOLL;
+#endif
 #ifdef HAVE_PPOLL
     mode = GST_POLL_MODE_PPOLL;
 #elif defined(HAVE_POLL)
@@ -686,9 +881,20 @@ gst_poll_new (gboolean controllable)
   nset->active_fds = g_array_new (FALSE, FALSE, sizeof (struct pollfd));
   nset->control_read_fd.fd = -1;
   nset->control_write_fd.fd = -1;
+#ifdef HAVE_SYS_EPOLL_H
+  nset->epoll_fd = -1;
+  nset->epoll_events = g_array_new (FALSE, FALSE, sizeof (struct epoll_event));
+  nset->epoll_ready = g_array_new (FALSE, FALSE, sizeof (guint64));
+#endif
   {
     gint control_sock[2];
 
+#ifdef HAVE_SYS_EVENTFD_H
+    /* a single eventfd is used for both ends of the control socket */
+    if ((control_sock[0] = eventfd (0, EFD_CLOEXEC)) >= 0) {
+      control_sock[1] = control_sock[0];
+    } else
+#endif
     if (socketpair (PF_UNIX, SOCK_STREAM, 0, control_sock) < 0)
       goto no_socket_pair;
 
@@ -774,8 +980,15 @@ gst_poll_free (GstPoll * set)
 #ifndef G_OS_WIN32
   if (set->control_write_fd.fd >= 0)
     close (set->control_write_fd.fd);
-  if (set->control_read_fd.fd >= 0)
+  if (set->control_read_fd.fd >= 0 &&
+      set->control_read_fd.fd != set->control_write_fd.fd)
     close (set->control_read_fd.fd);
+#ifdef HAVE_SYS_EPOLL_H
+  if (set->epoll_fd >= 0)
+    close (set->epoll_fd);
+  g_array_free (set->epoll_events, TRUE);
+  g_array_free (set->epoll_ready, TRUE);
+#endif
 #else
   CloseHandle (set->wakeup_event);
 
@@ -859,6 +1072,9 @@ gst_poll_add_fd_unlocked (GstPoll * set, GstPollFD * fd)
     g_array_append_val (set->fds, nfd);
 
     fd->idx = set->fds->len - 1;
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_update_fd (set, EPOLL_CTL_ADD, fd->idx);
+#endif
 #else
     WinsockFd wfd;
     HANDLE event;
@@ -940,10 +1156,20 @@ gst_poll_remove_fd (GstPoll * set, GstPollFD * fd)
     g_array_remove_index_fast (set->events, idx);
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_update_fd (set, EPOLL_CTL_DEL, idx);
+#endif
+
     /* remove the fd at index, we use _remove_index_fast, which copies the last
      * element of the array to the freed index */
     g_array_remove_index_fast (set->fds, idx);
 
+#ifdef HAVE_SYS_EPOLL_H
+    /* update the index of the moved fd */
+    if (idx < set->fds->len)
+      epoll_update_fd (set, EPOLL_CTL_MOD, idx);
+#endif
+
     /* mark fd as removed by setting the index to -1 */
     fd->idx = -1;
     MARK_REBUILD (set);
@@ -992,6 +1218,9 @@ gst_poll_fd_ctl_write (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events &= ~POLLOUT;
 
     GST_LOG ("%p: pfd->events now %d (POLLOUT:%d)", set, pfd->events, POLLOUT);
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_update_fd (set, EPOLL_CTL_MOD, idx);
+#endif
 #else
     gst_poll_update_winsock_event_mask (set, idx, FD_WRITE | FD_CONNECT,
         active);
@@ -1024,6 +1253,9 @@ gst_poll_fd_ctl_read_unlocked (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events |= POLLIN;
     else
       pfd->events &= ~POLLIN;
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_update_fd (set, EPOLL_CTL_MOD, idx);
+#endif
 #else
     gst_poll_update_winsock_event_mask (set, idx, FD_READ | FD_ACCEPT, active);
 #endif
@@ -1106,6 +1338,9 @@ gst_poll_fd_ctl_pri (GstPoll * set, GstPollFD * fd, gboolean active)
       pfd->events &= ~POLLPRI;
 
     GST_LOG ("%p: pfd->events now %d (POLLPRI:%d)", set, pfd->events, POLLOUT);
+#ifdef HAVE_SYS_EPOLL_H
+    epoll_update_fd (set, EPOLL_CTL_MOD, idx);
+#endif
     MARK_REBUILD (set);
   } else {
     GST_WARNING ("%p: couldn't find fd !", set);
@@ -1176,14 +1411,14 @@ gst_poll_fd_has_closed (const GstPoll * set, GstPollFD * fd)
 
   g_mutex_lock (&((GstPoll *) set)->lock);
 
-  idx = find_index (set->active_fds, fd);
+  idx = find_index (ACTIVE_FDS (set), fd);
   if (idx >= 0) {
 #ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
+    struct pollfd *pfd = &g_array_index (ACTIVE_FDS (set), struct pollfd, idx);
 
     res = (pfd->revents & POLLHUP) != 0;
 #else
-    WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
+    WinsockFd *wfd = &g_array_index (ACTIVE_FDS (set), WinsockFd, idx);
 
     res = (wfd->events.lNetworkEvents & FD_CLOSE) != 0;
 #endif
@@ -1218,14 +1453,14 @@ gst_poll_fd_has_error (const GstPoll * set, GstPollFD * fd)
 
   g_mutex_lock (&((GstPoll *) set)->lock);
 
-  idx = find_index (set->active_fds, fd);
+  idx = find_index (ACTIVE_FDS (set), fd);
   if (idx >= 0) {
 #ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
+    struct pollfd *pfd = &g_array_index (ACTIVE_FDS (set), struct pollfd, idx);
 
     res = (pfd->revents & (POLLERR | POLLNVAL)) != 0;
 #else
-    WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
+    WinsockFd *wfd = &g_array_index (ACTIVE_FDS (set), WinsockFd, idx);
 
     res = (wfd->events.iErrorCode[FD_CLOSE_BIT] != 0) ||
         (wfd->events.iErrorCode[FD_READ_BIT] != 0) ||
@@ -1249,14 +1484,14 @@ gst_poll_fd_can_read_unlocked (const GstPoll * set, GstPollFD * fd)
   gboolean res = FALSE;
   gint idx;
 
-  idx = find_index (set->active_fds, fd);
+  idx = find_index (ACTIVE_FDS (set), fd);
   if (idx >= 0) {
 #ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
+    struct pollfd *pfd = &g_array_index (ACTIVE_FDS (set), struct pollfd, idx);
 
     res = (pfd->revents & POLLIN) != 0;
 #else
-    WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
+    WinsockFd *wfd = &g_array_index (ACTIVE_FDS (set), WinsockFd, idx);
 
     res = (wfd->events.lNetworkEvents & (FD_READ | FD_ACCEPT)) != 0;
 #endif
@@ -1316,14 +1551,14 @@ gst_poll_fd_can_write (const GstPoll * set, GstPollFD * fd)
 
   g_mutex_lock (&((GstPoll *) set)->lock);
 
-  idx = find_index (set->active_fds, fd);
+  idx = find_index (ACTIVE_FDS (set), fd);
   if (idx >= 0) {
 #ifndef G_OS_WIN32
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
+    struct pollfd *pfd = &g_array_index (ACTIVE_FDS (set), struct pollfd, idx);
 
     res = (pfd->revents & POLLOUT) != 0;
 #else
-    WinsockFd *wfd = &g_array_index (set->active_fds, WinsockFd, idx);
+    WinsockFd *wfd = &g_array_index (ACTIVE_FDS (set), WinsockFd, idx);
 
     res = (wfd->events.lNetworkEvents & FD_WRITE) != 0;
 #endif
@@ -1365,9 +1600,9 @@ gst_poll_fd_has_pri (const GstPoll * set, GstPollFD * fd)
 
   g_mutex_lock (&((GstPoll *) set)->lock);
 
-  idx = find_index (set->active_fds, fd);
+  idx = find_index (ACTIVE_FDS (set), fd);
   if (idx >= 0) {
-    struct pollfd *pfd = &g_array_index (set->active_fds, struct pollfd, idx);
+    struct pollfd *pfd = &g_array_index (ACTIVE_FDS (set), struct pollfd, idx);
 
     res = (pfd->revents & POLLPRI) != 0;
   } else {
@@ -1432,14 +1667,17 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
     res = -1;
     restarting = FALSE;
 
-    mode = choose_mode (set, timeout);
-
     if (TEST_REBUILD (set)) {
       g_mutex_lock (&set->lock);
 #ifndef G_OS_WIN32
-      g_array_set_size (set->active_fds, set->fds->len);
-      memcpy (set->active_fds->data, set->fds->data,
-          set->fds->len * sizeof (struct pollfd));
+#ifdef HAVE_SYS_EPOLL_H
+      if (!epoll_rebuild (set))
+#endif
+      {
+        g_array_set_size (set->active_fds, set->fds->len);
+        memcpy (set->active_fds->data, set->fds->data,
+            set->fds->len * sizeof (struct pollfd));
+      }
 #else
       if (!gst_poll_prepare_winsock_active_sets (set))
         goto winsock_error;
@@ -1447,6 +1685,8 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
       g_mutex_unlock (&set->lock);
     }
 
+    mode = choose_mode (set, timeout);
+
     switch (mode) {
       case GST_POLL_MODE_AUTO:
         g_assert_not_reached ();
@@ -1470,6 +1710,37 @@ gst_poll_wait (GstPoll * set, GstClockTime timeout)
 #else
         g_assert_not_reached ();
         errno = ENOSYS;
+#endif
+        break;
+      }
+      case GST_POLL_MODE_EPOLL:
+      {
+#ifdef HAVE_SYS_EPOLL_H
+        gint t;
+
+        if (timeout != GST_CLOCK_TIME_NONE) {
+          /* round up, waking up early would spin until the timeout */
+          t = MIN (GST_TIME_AS_MSECONDS (timeout + GST_MSECOND - 1), G_MAXINT);
+        } else {
+          t = -1;
+        }
+
+        g_mutex_lock (&set->lock);
+        epoll_clear_ready (set);
+        g_mutex_unlock (&set->lock);
+
+        res = epoll_wait (set->epoll_fd,
+            (struct epoll_event *) set->epoll_events->data,
+            set->epoll_events->len, t);
+        if (res > 0) {
+          res = epoll_collect (set, res);
+          /* only events for fds that were removed in the meantime */
+          if (res == 0)
+            restarting = TRUE;
+        }
+#else
+        g_assert_not_reached ();
+        errno = ENOSYS;
 #endif
         break;
       }
@@ -184,6 +184,9 @@ gst_query_type_get_flags (GstQueryType type)
   return ret;
 }
 
+static GstQuery *gst_query_new_with_fields (GstQueryType type,
+    GQuark name_quark, GQuark field_quark, ...);
+
 static void
 _gst_query_free (GstQuery * query)
 {
@@ -234,14 +237,12 @@ GstQuery *
 gst_query_new_position (GstFormat format)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_POSITION),
+  query = gst_query_new_with_fields (GST_QUERY_POSITION,
+      GST_QUARK (QUERY_POSITION),
       GST_QUARK (FORMAT), GST_TYPE_FORMAT, format,
       GST_QUARK (CURRENT), G_TYPE_INT64, G_GINT64_CONSTANT (-1), NULL);
 
-  query = gst_query_new_custom (GST_QUERY_POSITION, structure);
-
   return query;
 }
 
@@ -313,14 +314,12 @@ GstQuery *
 gst_query_new_duration (GstFormat format)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_DURATION),
+  query = gst_query_new_with_fields (GST_QUERY_DURATION,
+      GST_QUARK (QUERY_DURATION),
       GST_QUARK (FORMAT), GST_TYPE_FORMAT, format,
       GST_QUARK (DURATION), G_TYPE_INT64, G_GINT64_CONSTANT (-1), NULL);
 
-  query = gst_query_new_custom (GST_QUERY_DURATION, structure);
-
   return query;
 }
 
@@ -390,15 +389,13 @@ GstQuery *
 gst_query_new_latency (void)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_LATENCY),
+  query = gst_query_new_with_fields (GST_QUERY_LATENCY,
+      GST_QUARK (QUERY_LATENCY),
       GST_QUARK (LIVE), G_TYPE_BOOLEAN, FALSE,
       GST_QUARK (MIN_LATENCY), G_TYPE_UINT64, G_GUINT64_CONSTANT (0),
       GST_QUARK (MAX_LATENCY), G_TYPE_UINT64, GST_CLOCK_TIME_NONE, NULL);
 
-  query = gst_query_new_custom (GST_QUERY_LATENCY, structure);
-
   return query;
 }
 
@@ -476,16 +473,14 @@ gst_query_new_convert (GstFormat src_format, gint64 value,
     GstFormat dest_format)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_CONVERT),
+  query = gst_query_new_with_fields (GST_QUERY_CONVERT,
+      GST_QUARK (QUERY_CONVERT),
       GST_QUARK (SRC_FORMAT), GST_TYPE_FORMAT, src_format,
       GST_QUARK (SRC_VALUE), G_TYPE_INT64, value,
       GST_QUARK (DEST_FORMAT), GST_TYPE_FORMAT, dest_format,
       GST_QUARK (DEST_VALUE), G_TYPE_INT64, G_GINT64_CONSTANT (-1), NULL);
 
-  query = gst_query_new_custom (GST_QUERY_CONVERT, structure);
-
   return query;
 }
 
@@ -570,16 +565,14 @@ GstQuery *
 gst_query_new_segment (GstFormat format)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_SEGMENT),
+  query = gst_query_new_with_fields (GST_QUERY_SEGMENT,
+      GST_QUARK (QUERY_SEGMENT),
       GST_QUARK (RATE), G_TYPE_DOUBLE, (gdouble) 0.0,
       GST_QUARK (FORMAT), GST_TYPE_FORMAT, format,
       GST_QUARK (START_VALUE), G_TYPE_INT64, G_GINT64_CONSTANT (-1),
       GST_QUARK (STOP_VALUE), G_TYPE_INT64, G_GINT64_CONSTANT (-1), NULL);
 
-  query = gst_query_new_custom (GST_QUERY_SEGMENT, structure);
-
   return query;
 }
 
@@ -703,6 +696,36 @@ had_parent:
   }
 }
 
+/* Creates a query with a new structure holding the given fields, allocated
+ * in the same block as the query itself */
+static GstQuery *
+gst_query_new_with_fields (GstQueryType type, GQuark name_quark,
+    GQuark field_quark, ...)
+{
+  GstQueryImpl *query = NULL;
+  GstStructure *structure;
+  va_list varargs;
+
+  va_start (varargs, field_quark);
+  structure = priv_gst_structure_new_id_valist_with_header (sizeof
+      (GstQueryImpl), (gpointer *) & query, name_quark, field_quark, varargs);
+  va_end (varargs);
+
+  GST_DEBUG ("creating new query %p %s", query, gst_query_type_get_name (type));
+
+  gst_structure_set_parent_refcount (structure,
+      &query->query.mini_object.refcount);
+
+  gst_mini_object_init (GST_MINI_OBJECT_CAST (query), 0, _gst_query_type,
+      (GstMiniObjectCopyFunction) _gst_query_copy, NULL,
+      (GstMiniObjectFreeFunction) _gst_query_free);
+
+  GST_QUERY_TYPE (query) = type;
+  GST_QUERY_STRUCTURE (query) = structure;
+
+  return GST_QUERY_CAST (query);
+}
+
 /**
  * gst_query_get_structure:
  * @query: a #GstQuery
@@ -767,16 +790,14 @@ GstQuery *
 gst_query_new_seeking (GstFormat format)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_SEEKING),
+  query = gst_query_new_with_fields (GST_QUERY_SEEKING,
+      GST_QUARK (QUERY_SEEKING),
       GST_QUARK (FORMAT), GST_TYPE_FORMAT, format,
       GST_QUARK (SEEKABLE), G_TYPE_BOOLEAN, FALSE,
       GST_QUARK (SEGMENT_START), G_TYPE_INT64, G_GINT64_CONSTANT (-1),
       GST_QUARK (SEGMENT_END), G_TYPE_INT64, G_GINT64_CONSTANT (-1), NULL);
 
-  query = gst_query_new_custom (GST_QUERY_SEEKING, structure);
-
   return query;
 }
 
@@ -883,10 +904,9 @@ GstQuery *
 gst_query_new_formats (void)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id_empty (GST_QUARK (QUERY_FORMATS));
-  query = gst_query_new_custom (GST_QUERY_FORMATS, structure);
+  query = gst_query_new_with_fields (GST_QUERY_FORMATS,
+      GST_QUARK (QUERY_FORMATS), 0);
 
   return query;
 }
@@ -1043,11 +1063,11 @@ GstQuery *
 gst_query_new_buffering (GstFormat format)
 {
   GstQuery *query;
-  GstStructure *structure;
 
   /* by default, we configure the answer as no buffering with a 100% buffering
    * progress */
-  structure = gst_structure_new_id (GST_QUARK (QUERY_BUFFERING),
+  query = gst_query_new_with_fields (GST_QUERY_BUFFERING,
+      GST_QUARK (QUERY_BUFFERING),
       GST_QUARK (BUSY), G_TYPE_BOOLEAN, FALSE,
       GST_QUARK (BUFFER_PERCENT), G_TYPE_INT, 100,
       GST_QUARK (BUFFERING_MODE), GST_TYPE_BUFFERING_MODE, GST_BUFFERING_STREAM,
@@ -1059,8 +1079,6 @@ gst_query_new_buffering (GstFormat format)
       GST_QUARK (START_VALUE), G_TYPE_INT64, G_GINT64_CONSTANT (-1),
       GST_QUARK (STOP_VALUE), G_TYPE_INT64, G_GINT64_CONSTANT (-1), NULL);
 
-  query = gst_query_new_custom (GST_QUERY_BUFFERING, structure);
-
   return query;
 }
 
@@ -1375,13 +1393,10 @@ GstQuery *
 gst_query_new_uri (void)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_URI),
+  query = gst_query_new_with_fields (GST_QUERY_URI, GST_QUARK (QUERY_URI),
       GST_QUARK (URI), G_TYPE_STRING, NULL, NULL);
 
-  query = gst_query_new_custom (GST_QUERY_URI, structure);
-
   return query;
 }
 
@@ -1543,14 +1558,12 @@ GstQuery *
 gst_query_new_allocation (GstCaps * caps, gboolean need_pool)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_ALLOCATION),
+  query = gst_query_new_with_fields (GST_QUERY_ALLOCATION,
+      GST_QUARK (QUERY_ALLOCATION),
       GST_QUARK (CAPS), GST_TYPE_CAPS, caps,
       GST_QUARK (NEED_POOL), G_TYPE_BOOLEAN, need_pool, NULL);
 
-  query = gst_query_new_custom (GST_QUERY_ALLOCATION, structure);
-
   return query;
 }
 
@@ -2120,14 +2133,13 @@ GstQuery *
 gst_query_new_scheduling (void)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_SCHEDULING),
+  query = gst_query_new_with_fields (GST_QUERY_SCHEDULING,
+      GST_QUARK (QUERY_SCHEDULING),
       GST_QUARK (FLAGS), GST_TYPE_SCHEDULING_FLAGS, 0,
       GST_QUARK (MINSIZE), G_TYPE_INT, 1,
       GST_QUARK (MAXSIZE), G_TYPE_INT, -1,
       GST_QUARK (ALIGN), G_TYPE_INT, 0, NULL);
-  query = gst_query_new_custom (GST_QUERY_SCHEDULING, structure);
 
   return query;
 }
@@ -2335,14 +2347,13 @@ GstQuery *
 gst_query_new_accept_caps (GstCaps * caps)
 {
   GstQuery *query;
-  GstStructure *structure;
 
   g_return_val_if_fail (gst_caps_is_fixed (caps), NULL);
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_ACCEPT_CAPS),
+  query = gst_query_new_with_fields (GST_QUERY_ACCEPT_CAPS,
+      GST_QUARK (QUERY_ACCEPT_CAPS),
       GST_QUARK (CAPS), GST_TYPE_CAPS, caps,
       GST_QUARK (RESULT), G_TYPE_BOOLEAN, FALSE, NULL);
-  query = gst_query_new_custom (GST_QUERY_ACCEPT_CAPS, structure);
 
   return query;
 }
@@ -2438,12 +2449,10 @@ GstQuery *
 gst_query_new_caps (GstCaps * filter)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_CAPS),
+  query = gst_query_new_with_fields (GST_QUERY_CAPS, GST_QUARK (QUERY_CAPS),
       GST_QUARK (FILTER), GST_TYPE_CAPS, filter,
       GST_QUARK (CAPS), GST_TYPE_CAPS, NULL, NULL);
-  query = gst_query_new_custom (GST_QUERY_CAPS, structure);
 
   return query;
 }
@@ -2536,10 +2545,9 @@ GstQuery *
 gst_query_new_drain (void)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id_empty (GST_QUARK (QUERY_DRAIN));
-  query = gst_query_new_custom (GST_QUERY_DRAIN, structure);
+  query = gst_query_new_with_fields (GST_QUERY_DRAIN,
+      GST_QUARK (QUERY_DRAIN), 0);
 
   return query;
 }
@@ -2560,13 +2568,12 @@ GstQuery *
 gst_query_new_context (const gchar * context_type)
 {
   GstQuery *query;
-  GstStructure *structure;
 
   g_return_val_if_fail (context_type != NULL, NULL);
 
-  structure = gst_structure_new_id (GST_QUARK (QUERY_CONTEXT),
+  query = gst_query_new_with_fields (GST_QUERY_CONTEXT,
+      GST_QUARK (QUERY_CONTEXT),
       GST_QUARK (CONTEXT_TYPE), G_TYPE_STRING, context_type, NULL);
-  query = gst_query_new_custom (GST_QUERY_CONTEXT, structure);
 
   return query;
 }
@@ -2669,10 +2676,9 @@ GstQuery *
 gst_query_new_bitrate (void)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id_empty (GST_QUARK (QUERY_BITRATE));
-  query = gst_query_new_custom (GST_QUERY_BITRATE, structure);
+  query = gst_query_new_with_fields (GST_QUERY_BITRATE,
+      GST_QUARK (QUERY_BITRATE), 0);
 
   return query;
 }
@@ -2741,10 +2747,9 @@ GstQuery *
 gst_query_new_selectable (void)
 {
   GstQuery *query;
-  GstStructure *structure;
 
-  structure = gst_structure_new_id_empty (GST_QUARK (QUERY_SELECTABLE));
-  query = gst_query_new_custom (GST_QUERY_SELECTABLE, structure);
+  query = gst_query_new_with_fields (GST_QUERY_SELECTABLE,
+      GST_QUARK (QUERY_SELECTABLE), 0);
 
   return query;
 }
@@ -567,6 +567,9 @@ fail:
  *
  * Read the contents of the binary cache file at @location into @registry.
  *
+ * The file stays mapped for as long as features loaded from it exist, so that
+ * their metadata and caps can be parsed from it only when they are needed.
+ *
  * Returns: %TRUE on success.
  */
 gboolean
@@ -574,6 +577,7 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
     const char *location)
 {
   GMappedFile *mapped = NULL;
+  GBytes *cache = NULL;
   gchar *contents = NULL;
   gchar *in = NULL;
   gsize size;
@@ -596,12 +600,15 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
   timer = g_timer_new ();
 #endif
 
+#ifndef G_OS_WIN32
+  /* On win32 a mapped file can't be replaced when writing a new registry */
   mapped = g_mapped_file_new (location, FALSE, &err);
   if (G_UNLIKELY (err != NULL)) {
     GST_INFO ("Unable to mmap file %s : %s", location, err->message);
     g_error_free (err);
     err = NULL;
   }
+#endif
 
   if (mapped == NULL) {
     /* Error mmap-ing the cache, try a plain memory read */
@@ -615,10 +622,13 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
       g_error_free (err);
       return FALSE;
     }
+    cache = g_bytes_new_take (contents, size);
   } else {
     /* This can't fail if g_mapped_file_new() succeeded */
     contents = g_mapped_file_get_contents (mapped);
     size = g_mapped_file_get_length (mapped);
+    cache = g_mapped_file_get_bytes (mapped);
+    g_mapped_file_unref (mapped);
   }
 
   /* in is a cursor pointer, we initialize it with the begin of registry and is updated on each read */
@@ -666,7 +676,8 @@ priv_gst_registry_binary_read_cache (GstRegistry * registry,
       GST_DEBUG ("reading binary registry %" G_GSIZE_FORMAT "(%x)/%"
           G_GSIZE_FORMAT, (gsize) in - (gsize) contents,
           (guint) ((gsize) in - (gsize) contents), size);
-      if (!_priv_gst_registry_chunks_load_plugin (registry, &in, end, NULL)) {
+      if (!_priv_gst_registry_chunks_load_plugin (registry, &in, end, cache,
+              NULL)) {
         GST_ERROR ("Problem while reading binary registry %s", location);
         goto Error;
       }
@@ -683,16 +694,12 @@ done:
   GST_INFO ("loaded %s in %lf seconds", location, seconds);
 
   res = TRUE;
-  /* TODO: once we re-use the pointers to registry contents, return here */
 
 Error:
 #ifndef GST_DISABLE_GST_DEBUG
   g_timer_destroy (timer);
 #endif
-  if (mapped) {
-    g_mapped_file_unref (mapped);
-  } else {
-    g_free (contents);
-  }
+  /* the features that point into the cache keep their own reference */
+  g_bytes_unref (cache);
   return res;
 }
@@ -297,9 +297,12 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
       }
     }
 
-    /* pack element metadata strings */
-    gst_registry_chunks_save_string (list,
-        gst_structure_to_string (factory->metadata));
+    /* pack element metadata strings, as they were read if never parsed */
+    if (factory->metadata == NULL && factory->metadata_string)
+      gst_registry_chunks_save_const_string (list, factory->metadata_string);
+    else
+      gst_registry_chunks_save_string (list,
+          gst_structure_to_string (factory->metadata));
   } else if (GST_IS_TYPE_FIND_FACTORY (feature)) {
     GstRegistryChunkTypeFindFactory *tff;
     GstTypeFindFactory *factory = GST_TYPE_FIND_FACTORY (feature);
@@ -323,7 +326,9 @@ gst_registry_chunks_save_feature (GList ** list, GstPluginFeature * feature)
     }
     GST_DEBUG_OBJECT (feature, "saved %d extensions", tff->nextensions);
     /* save caps */
-    if (factory->caps) {
+    if (factory->caps == NULL && factory->caps_string) {
+      gst_registry_chunks_save_const_string (list, factory->caps_string);
+    } else if (factory->caps) {
       GstCaps *fcaps = gst_caps_ref (factory->caps);
       /* we simplify the caps before saving. This is a lot faster
        * when loading them later on */
@@ -508,13 +513,13 @@ fail:
  * gst_registry_chunks_load_pad_template:
  *
  * Make a new GstStaticPadTemplate from current GstRegistryChunkPadTemplate
- * structure.
+ * structure. When loading from the registry cache the strings point into it.
  *
  * Returns: new GstStaticPadTemplate
  */
 static gboolean
 gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
-    gchar * end)
+    gchar * end, GBytes * cache)
 {
   GstRegistryChunkPadTemplate *pt;
   GstStaticPadTemplate *template = NULL;
@@ -530,8 +535,13 @@ gst_registry_chunks_load_pad_template (GstElementFactory * factory, gchar ** in,
   template->static_caps.caps = NULL;
 
   /* unpack pad template strings */
-  unpack_const_string (*in, template->name_template, end, fail);
-  unpack_const_string (*in, template->static_caps.string, end, fail);
+  if (cache) {
+    unpack_string_nocopy (*in, template->name_template, end, fail);
+    unpack_string_nocopy (*in, template->static_caps.string, end, fail);
+  } else {
+    unpack_const_string (*in, template->name_template, end, fail);
+    unpack_const_string (*in, template->static_caps.string, end, fail);
+  }
 
   __gst_element_factory_add_static_pad_template (factory, template);
   GST_DEBUG ("Added pad_template %s", template->name_template);
@@ -547,13 +557,15 @@ fail:
 /*
  * gst_registry_chunks_load_feature:
  *
- * Make a new GstPluginFeature from current binary plugin feature structure
+ * Make a new GstPluginFeature from current binary plugin feature structure.
+ * When loading from the registry cache, the element factory metadata and
+ * the typefinder caps are only parsed when they are first used.
  *
  * Returns: new GstPluginFeature
  */
 static gboolean
 gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin * plugin)
+    gchar * end, GstPlugin * plugin, GBytes * cache)
 {
   GstRegistryChunkPluginFeature *pf = NULL;
   GstPluginFeature *feature = NULL;
@@ -611,7 +623,11 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
 
     /* unpack element factory strings */
     unpack_string_nocopy (*in, meta_data_str, end, fail);
-    if (meta_data_str && *meta_data_str) {
+    if (cache) {
+      factory->cache = g_bytes_ref (cache);
+      if (meta_data_str && *meta_data_str)
+        factory->metadata_string = meta_data_str;
+    } else if (meta_data_str && *meta_data_str) {
       factory->metadata = gst_structure_from_string (meta_data_str, NULL);
       if (!factory->metadata) {
         GST_ERROR
@@ -626,7 +642,7 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
     /* load pad templates */
     for (i = 0; i < n; i++) {
       if (G_UNLIKELY (!gst_registry_chunks_load_pad_template (factory, in,
-                  end))) {
+                  end, factory->cache))) {
         GST_ERROR ("Error while loading binary pad template");
         goto fail;
       }
@@ -668,10 +684,14 @@ gst_registry_chunks_load_feature (GstRegistry * registry, gchar ** in,
 
     /* load typefinder caps */
     unpack_string_nocopy (*in, const_str, end, fail);
-    if (const_str != NULL && *const_str != '\0')
-      factory->caps = gst_caps_from_string (const_str);
-    else
+    if (const_str == NULL || *const_str == '\0') {
       factory->caps = NULL;
+    } else if (cache) {
+      factory->cache = g_bytes_ref (cache);
+      factory->caps_string = const_str;
+    } else {
+      factory->caps = gst_caps_from_string (const_str);
+    }
 
     /* load extensions */
     if (tff->nextensions) {
@@ -817,10 +837,13 @@ fail:
  * Make a new GstPlugin from current GstRegistryChunkPluginElement structure
  * and add it to the GstRegistry. Return an offset to the next
  * GstRegistryChunkPluginElement structure.
+ *
+ * If @cache is not %NULL, it holds the data being read and the features keep
+ * pointing into it instead of copying and parsing everything upfront.
  */
 gboolean
 _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
-    gchar * end, GstPlugin ** out_plugin)
+    gchar * end, GBytes * cache, GstPlugin ** out_plugin)
 {
 #ifndef GST_DISABLE_GST_DEBUG
   gchar *start = *in;
@@ -887,7 +910,7 @@ _priv_gst_registry_chunks_load_plugin (GstRegistry * registry, gchar ** in,
   /* Load plugin features */
   for (i = 0; i < n; i++) {
     if (G_UNLIKELY (!gst_registry_chunks_load_feature (registry, in, end,
-                plugin))) {
+                plugin, cache))) {
       GST_ERROR ("Error while loading binary feature for plugin '%s'",
           GST_STR_NULL (plugin->desc.name));
       gst_registry_remove_plugin (registry, plugin);
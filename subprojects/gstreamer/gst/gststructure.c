@@ -167,6 +167,9 @@ typedef struct
   guint fields_len;             /* Number of valid items in fields */
   guint fields_alloc;           /* Allocated items in fields */
 
+  /* TRUE if the structure lives in the memory block of its parent */
+  gboolean embedded;
+
   /* Fields are allocated if GST_STRUCTURE_IS_USING_DYNAMIC_ARRAY(),
    *  else it's a pointer to the arr field. */
   GstStructureField *fields;
@@ -190,6 +193,79 @@ typedef struct
 #define IS_TAGLIST(structure) \
     (structure->name == GST_QUARK (TAGLIST))
 
+/* Values of these types hold no resources, so they don't need to be unset */
+static inline gboolean
+structure_value_is_plain (GType type)
+{
+  GType fundamental = G_TYPE_FUNDAMENTAL (type);
+
+  return (fundamental >= G_TYPE_CHAR && fundamental <= G_TYPE_DOUBLE) ||
+      type == GST_TYPE_FRACTION;
+}
+
+static gchar *
+structure_collect_fraction (GValue * value, gint numerator, gint denominator)
+{
+  if (G_UNLIKELY (denominator == 0 || numerator < -G_MAXINT
+          || denominator < -G_MAXINT))
+    return g_strdup_printf ("passed invalid fraction %d/%d for `%s'",
+        numerator, denominator, g_type_name (GST_TYPE_FRACTION));
+
+  value->g_type = GST_TYPE_FRACTION;
+  gst_value_set_fraction (value, numerator, denominator);
+
+  return NULL;
+}
+
+/* Like G_VALUE_COLLECT_INIT() on a zeroed @value, but the int, uint64,
+ * string, fraction and similar types that make up most of the fields of
+ * events and queries are stored directly, the same way their collect
+ * functions would, without going through the value table. */
+#define STRUCTURE_VALUE_COLLECT_INIT(value, type, varargs, err)            \
+G_STMT_START {                                                            \
+  switch (G_TYPE_FUNDAMENTAL (type)) {                                    \
+    case G_TYPE_INT:                                                      \
+    case G_TYPE_BOOLEAN:                                                  \
+      (value)->g_type = (type);                                           \
+      (value)->data[0].v_int = va_arg ((varargs), gint);                  \
+      break;                                                              \
+    case G_TYPE_UINT:                                                     \
+      (value)->g_type = (type);                                           \
+      (value)->data[0].v_uint = va_arg ((varargs), guint);                \
+      break;                                                              \
+    case G_TYPE_ENUM:                                                     \
+      (value)->g_type = (type);                                           \
+      (value)->data[0].v_long = va_arg ((varargs), gint);                 \
+      break;                                                              \
+    case G_TYPE_INT64:                                                    \
+      (value)->g_type = (type);                                           \
+      (value)->data[0].v_int64 = va_arg ((varargs), gint64);              \
+      break;                                                              \
+    case G_TYPE_UINT64:                                                   \
+      (value)->g_type = (type);                                           \
+      (value)->data[0].v_uint64 = va_arg ((varargs), guint64);            \
+      break;                                                              \
+    case G_TYPE_DOUBLE:                                                   \
+      (value)->g_type = (type);                                           \
+      (value)->data[0].v_double = va_arg ((varargs), gdouble);            \
+      break;                                                              \
+    case G_TYPE_STRING:                                                   \
+      (value)->g_type = (type);                                           \
+      (value)->data[0].v_pointer = g_strdup (va_arg ((varargs), gchar *)); \
+      break;                                                              \
+    default:                                                              \
+      if ((type) == GST_TYPE_FRACTION) {                                  \
+        gint _num = va_arg ((varargs), gint);                             \
+        gint _den = va_arg ((varargs), gint);                             \
+                                                                          \
+        (err) = structure_collect_fraction ((value), _num, _den);         \
+      } else {                                                            \
+        G_VALUE_COLLECT_INIT ((value), (type), (varargs), 0, &(err));     \
+      }                                                                   \
+      break;                                                              \
+  }                                                                       \
+} G_STMT_END
+
 /* Replacement for g_array_append_val */
 static void
 _structure_append_val (GstStructure * s, GstStructureField * val)
@@ -267,19 +343,31 @@ _priv_gst_structure_initialize (void)
       "GstStructure debug");
 }
 
+/* Allocates a structure with room for @prealloc fields. When @header_size is
+ * not 0, @header_size zeroed bytes are allocated in front of the structure in
+ * the same block and returned in @header; the structure is then embedded and
+ * the block is freed by whoever owns the header. */
 static GstStructure *
-gst_structure_new_id_empty_with_size (GQuark quark, guint prealloc)
+gst_structure_new_id_empty_with_header (GQuark quark, guint prealloc,
+    gsize header_size, gpointer * header)
 {
   guint n_alloc;
   GstStructureImpl *structure;
+  guint8 *mem;
 
   if (prealloc == 0)
     prealloc = 1;
 
+  header_size = GST_ROUND_UP_8 (header_size);
   n_alloc = GST_ROUND_UP_8 (prealloc);
-  structure =
-      g_malloc0 (sizeof (GstStructureImpl) + (n_alloc -
+  mem = g_malloc0 (header_size + sizeof (GstStructureImpl) + (n_alloc -
           1) * sizeof (GstStructureField));
+  structure = (GstStructureImpl *) (mem + header_size);
+
+  if (header_size) {
+    *header = mem;
+    structure->embedded = TRUE;
+  }
 
   ((GstStructure *) structure)->type = _gst_structure_type;
   ((GstStructure *) structure)->name = quark;
@@ -294,6 +382,12 @@ gst_structure_new_id_empty_with_size (GQuark quark, guint prealloc)
   return GST_STRUCTURE_CAST (structure);
 }
 
+static GstStructure *
+gst_structure_new_id_empty_with_size (GQuark quark, guint prealloc)
+{
+  return gst_structure_new_id_empty_with_header (quark, prealloc, 0, NULL);
+}
+
 /**
  * gst_structure_new_id_empty:
  * @quark: name of new structure
@@ -534,17 +628,23 @@ gst_structure_free (GstStructure * structure)
   for (i = 0; i < len; i++) {
     field = GST_STRUCTURE_FIELD (structure, i);
 
-    if (G_IS_VALUE (&field->value)) {
+    if (G_IS_VALUE (&field->value) &&
+        !structure_value_is_plain (G_VALUE_TYPE (&field->value))) {
       g_value_unset (&field->value);
     }
   }
   if (GST_STRUCTURE_IS_USING_DYNAMIC_ARRAY (structure))
     g_free (((GstStructureImpl *) structure)->fields);
 
+  GST_TRACE ("free structure %p", structure);
+
+  /* embedded structures are freed together with their parent */
+  if (((GstStructureImpl *) structure)->embedded)
+    return;
+
 #ifdef USE_POISONING
   memset (structure, 0xff, sizeof (GstStructure));
 #endif
-  GST_TRACE ("free structure %p", structure);
 
   g_free (structure);
 }
@@ -824,7 +924,7 @@ gst_structure_set_valist_internal (GstStructure * structure,
 
     type = va_arg (varargs, GType);
 
-    G_VALUE_COLLECT_INIT (&field.value, type, varargs, 0, &err);
+    STRUCTURE_VALUE_COLLECT_INIT (&field.value, type, varargs, err);
     if (G_UNLIKELY (err)) {
       g_critical ("%s", err);
       g_free (err);
@@ -891,7 +991,7 @@ gst_structure_id_set_valist_internal (GstStructure * structure,
     field.name = fieldname;
     type = va_arg (varargs, GType);
 
-    G_VALUE_COLLECT_INIT (&field.value, type, varargs, 0, &err);
+    STRUCTURE_VALUE_COLLECT_INIT (&field.value, type, varargs, err);
     if (G_UNLIKELY (err)) {
       g_critical ("%s", err);
       g_free (err);
@@ -995,6 +1095,39 @@ gst_structure_new_id (GQuark name_quark, GQuark field_quark, ...)
   return s;
 }
 
+/* va_list form of gst_structure_new_id() with @header_size bytes allocated
+ * in front of the structure. Events and queries use this to get their
+ * structure in the same allocation as themselves. */
+GstStructure *
+priv_gst_structure_new_id_valist_with_header (gsize header_size,
+    gpointer * header, GQuark name_quark, GQuark field_quark, va_list varargs)
+{
+  GstStructure *s;
+  va_list copy;
+  guint len = 0;
+  GQuark quark_copy = field_quark;
+  GType type_copy;
+
+  g_return_val_if_fail (header_size > 0 && header != NULL, NULL);
+  g_return_val_if_fail (name_quark != 0, NULL);
+
+  va_copy (copy, varargs);
+  while (quark_copy) {
+    type_copy = va_arg (copy, GType);
+    G_VALUE_COLLECT_SKIP (type_copy, copy);
+    quark_copy = va_arg (copy, GQuark);
+    len++;
+  }
+  va_end (copy);
+
+  s = gst_structure_new_id_empty_with_header (name_quark, len, header_size,
+      header);
+
+  gst_structure_id_set_valist_internal (s, field_quark, varargs);
+
+  return s;
+}
+
 #if GST_VERSION_NANO == 1
 #define GIT_G_WARNING g_warning
 #else
@@ -3125,6 +3258,141 @@ gst_structure_is_equal (const GstStructure * structure1,
       (gpointer) structure2);
 }
 
+static guint
+value_hash (const GValue * value)
+{
+  GType type = G_VALUE_TYPE (value);
+  guint hash = (guint) type;
+  guint i, n;
+
+  switch (G_TYPE_FUNDAMENTAL (type)) {
+    case G_TYPE_INT:
+      return hash * 31 + g_value_get_int (value);
+    case G_TYPE_UINT:
+      return hash * 31 + g_value_get_uint (value);
+    case G_TYPE_INT64:
+      return hash * 31 + (guint) g_value_get_int64 (value);
+    case G_TYPE_UINT64:
+      return hash * 31 + (guint) g_value_get_uint64 (value);
+    case G_TYPE_BOOLEAN:
+      return hash * 31 + g_value_get_boolean (value);
+    case G_TYPE_ENUM:
+      return hash * 31 + g_value_get_enum (value);
+    case G_TYPE_FLAGS:
+      return hash * 31 + g_value_get_flags (value);
+    case G_TYPE_STRING:{
+      const gchar *str = g_value_get_string (value);
+
+      return hash * 31 + (str ? g_str_hash (str) : 0);
+    }
+    default:
+      break;
+  }
+
+  if (type == GST_TYPE_FRACTION) {
+    hash = hash * 31 + gst_value_get_fraction_numerator (value);
+    hash = hash * 31 + gst_value_get_fraction_denominator (value);
+  } else if (type == GST_TYPE_INT_RANGE) {
+    hash = hash * 31 + gst_value_get_int_range_min (value);
+    hash = hash * 31 + gst_value_get_int_range_max (value);
+  } else if (type == GST_TYPE_LIST) {
+    n = gst_value_list_get_size (value);
+    for (i = 0; i < n; i++)
+      hash = hash * 31 + value_hash (gst_value_list_get_value (value, i));
+  } else if (type == GST_TYPE_ARRAY) {
+    n = gst_value_array_get_size (value);
+    for (i = 0; i < n; i++)
+      hash = hash * 31 + value_hash (gst_value_array_get_value (value, i));
+  }
+
+  /* Anything else only hashes the type, the values are still compared */
+  return hash;
+}
+
+/* Hash over the name and the fields in their order, consistent with
+ * priv_gst_structure_is_identical() */
+guint
+priv_gst_structure_hash (const GstStructure * structure)
+{
+  guint hash = structure->name;
+  guint i, len = GST_STRUCTURE_LEN (structure);
+
+  for (i = 0; i < len; i++) {
+    GstStructureField *field = GST_STRUCTURE_FIELD (structure, i);
+
+    hash = hash * 31 + field->name;
+    hash = hash * 31 + value_hash (&field->value);
+  }
+
+  return hash;
+}
+
+static gboolean
+value_is_identical (const GValue * value1, const GValue * value2)
+{
+  guint i, n;
+
+  if (G_VALUE_TYPE (value1) != G_VALUE_TYPE (value2))
+    return FALSE;
+
+  /* Unlike gst_value_compare() the order of list items matters here, it
+   * decides about the order of the items in intersections */
+  if (GST_VALUE_HOLDS_LIST (value1)) {
+    n = gst_value_list_get_size (value1);
+    if (n != gst_value_list_get_size (value2))
+      return FALSE;
+    for (i = 0; i < n; i++) {
+      if (!value_is_identical (gst_value_list_get_value (value1, i),
+              gst_value_list_get_value (value2, i)))
+        return FALSE;
+    }
+    return TRUE;
+  } else if (GST_VALUE_HOLDS_ARRAY (value1)) {
+    n = gst_value_array_get_size (value1);
+    if (n != gst_value_array_get_size (value2))
+      return FALSE;
+    for (i = 0; i < n; i++) {
+      if (!value_is_identical (gst_value_array_get_value (value1, i),
+              gst_value_array_get_value (value2, i)))
+        return FALSE;
+    }
+    return TRUE;
+  }
+
+  return gst_value_compare (value1, value2) == GST_VALUE_EQUAL;
+}
+
+/* Like gst_structure_is_equal() but also requires the fields and list items
+ * to be in the same order, so that any operation on the two structures gives
+ * the same result */
+gboolean
+priv_gst_structure_is_identical (const GstStructure * structure1,
+    const GstStructure * structure2)
+{
+  guint i, len;
+
+  if (structure1 == structure2)
+    return TRUE;
+
+  if (structure1->name != structure2->name)
+    return FALSE;
+
+  len = GST_STRUCTURE_LEN (structure1);
+  if (len != GST_STRUCTURE_LEN (structure2))
+    return FALSE;
+
+  for (i = 0; i < len; i++) {
+    GstStructureField *field1 = GST_STRUCTURE_FIELD (structure1, i);
+    GstStructureField *field2 = GST_STRUCTURE_FIELD (structure2, i);
+
+    if (field1->name != field2->name
+        || !value_is_identical (&field1->value, &field2->value))
+      return FALSE;
+  }
+
+  return TRUE;
+}
+
 /**
  * gst_structure_intersect:
  * @struct1: a #GstStructure
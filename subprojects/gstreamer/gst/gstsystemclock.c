@@ -35,6 +35,10 @@
  * Subclasses can however override all of the important methods for sync and
  * async notifications to implement their own callback methods or blocking
  * wait operations.
+ *
+ * Applications needing very precise wakeups, e.g. for network pacing, can set
+ * #GstSystemClock:spin-time so that the last part of each wait is spent busy
+ * waiting instead of relying on the scheduler to wake the thread up in time.
  */
 
 #include "gst_private.h"
@@ -47,6 +51,10 @@
 
 #include <errno.h>
 
+#ifdef HAVE_SYS_PRCTL_H
+#include <sys/prctl.h>
+#endif
+
 #ifdef G_OS_WIN32
 #  define WIN32_LEAN_AND_MEAN   /* prevents from including too many things */
 #  include <windows.h>          /* QueryPerformance* stuff */
@@ -446,6 +454,7 @@ struct _GstSystemClockPrivate
   GCond entries_changed;
 
   GstClockType clock_type;
+  GstClockTime spin_time;
 
 #ifdef G_OS_WIN32
   LARGE_INTEGER frequency;
@@ -465,10 +474,13 @@ struct _GstSystemClockPrivate
 #define DEFAULT_CLOCK_TYPE GST_CLOCK_TYPE_MONOTONIC
 #endif
 
+#define DEFAULT_SPIN_TIME 0
+
 enum
 {
   PROP_0,
   PROP_CLOCK_TYPE,
+  PROP_SPIN_TIME,
   /* FILL ME */
 };
 
@@ -526,6 +538,22 @@ gst_system_clock_class_init (GstSystemClockClass * klass)
           GST_TYPE_CLOCK_TYPE, DEFAULT_CLOCK_TYPE,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstSystemClock:spin-time:
+   *
+   * Amount of time before the deadline of a wait that is spent busy waiting
+   * instead of sleeping. This trades CPU time for lower wakeup jitter. On
+   * Linux the timer slack of waiting threads is also reduced to the minimum
+   * when this is enabled.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_SPIN_TIME,
+      g_param_spec_uint64 ("spin-time", "Spin time",
+          "Busy wait for this amount of time before the deadline "
+          "(0 = disabled)", 0, G_MAXUINT64, DEFAULT_SPIN_TIME,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gstclock_class->get_internal_time = gst_system_clock_get_internal_time;
   gstclock_class->get_resolution = gst_system_clock_get_resolution;
   gstclock_class->wait = gst_system_clock_id_wait_jitter;
@@ -547,6 +575,7 @@ gst_system_clock_init (GstSystemClock * clock)
   clock->priv = priv = gst_system_clock_get_instance_private (clock);
 
   priv->clock_type = DEFAULT_CLOCK_TYPE;
+  priv->spin_time = DEFAULT_SPIN_TIME;
 
   priv->entries = NULL;
   g_cond_init (&priv->entries_changed);
@@ -639,6 +668,11 @@ gst_system_clock_set_property (GObject * object, guint prop_id,
       GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, sysclock, "clock-type set to %d",
           sysclock->priv->clock_type);
       break;
+    case PROP_SPIN_TIME:
+      sysclock->priv->spin_time = g_value_get_uint64 (value);
+      GST_CAT_DEBUG_OBJECT (GST_CAT_CLOCK, sysclock, "spin-time set to %"
+          GST_TIME_FORMAT, GST_TIME_ARGS (sysclock->priv->spin_time));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -655,6 +689,9 @@ gst_system_clock_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_CLOCK_TYPE:
       g_value_set_enum (value, sysclock->priv->clock_type);
       break;
+    case PROP_SPIN_TIME:
+      g_value_set_uint64 (value, sysclock->priv->spin_time);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1039,6 +1076,39 @@ gst_system_clock_get_resolution (GstClock * clock)
  *
  * MT safe.
  */
+#if defined (HAVE_SYS_PRCTL_H) && defined (PR_SET_TIMERSLACK)
+static GPrivate timer_slack_reduced;
+
+/* The default timer slack of 50us delays every wakeup of the thread */
+static void
+gst_system_clock_reduce_timer_slack (GstClock * clock)
+{
+  if (g_private_get (&timer_slack_reduced))
+    return;
+
+  if (prctl (PR_SET_TIMERSLACK, 1, 0, 0, 0) != 0) {
+    GST_CAT_WARNING_OBJECT (GST_CAT_CLOCK, clock,
+        "Couldn't reduce timer slack: %s", g_strerror (errno));
+  }
+
+  g_private_set (&timer_slack_reduced, GINT_TO_POINTER (TRUE));
+}
+#else
+#define gst_system_clock_reduce_timer_slack(clock)
+#endif
+
+/* Busy waits until @deadline (monotonic time in nanoseconds) or until the
+ * entry gets unscheduled. Called without the entry lock */
+static void
+gst_system_clock_spin_until (GstClockEntry * entry, gint64 deadline)
+{
+  while (g_get_monotonic_time () * 1000 < deadline) {
+    if (g_atomic_int_get ((gint *) & GST_CLOCK_ENTRY_STATUS (entry)) ==
+        GST_CLOCK_UNSCHEDULED)
+      break;
+  }
+}
+
 static GstClockReturn
 gst_system_clock_id_wait_jitter_unlocked (GstClock * clock,
     GstClockEntry * entry, GstClockTimeDiff * jitter, gboolean restart)
@@ -1046,6 +1116,7 @@ gst_system_clock_id_wait_jitter_unlocked (GstClock * clock,
   GstClockTime entryt, now;
   GstClockTimeDiff diff;
   GstClockReturn status;
+  GstClockTime spin_time;
   gint64 mono_ts;
 
   status = GST_CLOCK_ENTRY_STATUS (entry);
@@ -1078,37 +1149,55 @@ gst_system_clock_id_wait_jitter_unlocked (GstClock * clock,
     GstClockTime final;
 #endif
 
+    spin_time = GST_SYSTEM_CLOCK_CAST (clock)->priv->spin_time;
+    if (spin_time > 0)
+      gst_system_clock_reduce_timer_slack (clock);
+
     while (TRUE) {
       gboolean waitret;
 
-#ifdef HAVE_CLOCK_NANOSLEEP
-      if (diff <= 500 * GST_USECOND) {
-        /* In order to provide more accurate wait, we will use BLOCKING
-           clock_nanosleep for any deadlines at or below 500us */
-        struct timespec end;
-        GST_TIME_TO_TIMESPEC (mono_ts * 1000 + diff, end);
+      if (diff <= (GstClockTimeDiff) spin_time) {
+        /* Close enough to the deadline, don't give the CPU away anymore.
+         * Same as a timeout of the regular wait below */
         GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
-        waitret =
-            clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &end, NULL) == 0;
+        gst_system_clock_spin_until (entry, mono_ts * 1000 + diff);
         GST_SYSTEM_CLOCK_ENTRY_LOCK ((GstClockEntryImpl *) entry);
+        waitret = FALSE;
       } else {
+        /* sleep until the spin time window starts */
+        diff -= spin_time;
 
-        if (diff < 2 * GST_MSECOND) {
-          /* For any deadline within 2ms, we first use the regular non-blocking
-             wait by reducing the diff accordingly */
-          diff -= 500 * GST_USECOND;
-        }
+#ifdef HAVE_CLOCK_NANOSLEEP
+        if (diff <= 500 * GST_USECOND) {
+          /* In order to provide more accurate wait, we will use BLOCKING
+             clock_nanosleep for any deadlines at or below 500us */
+          struct timespec end;
+          GST_TIME_TO_TIMESPEC (mono_ts * 1000 + diff, end);
+          GST_SYSTEM_CLOCK_ENTRY_UNLOCK ((GstClockEntryImpl *) entry);
+          waitret =
+              clock_nanosleep (CLOCK_MONOTONIC, TIMER_ABSTIME, &end,
+              NULL) == 0;
+          GST_SYSTEM_CLOCK_ENTRY_LOCK ((GstClockEntryImpl *) entry);
+        } else {
+
+          if (diff < 2 * GST_MSECOND) {
+            /* For any deadline within 2ms, we first use the regular
+               non-blocking wait by reducing the diff accordingly */
+            diff -= 500 * GST_USECOND;
+          }
 #endif
 
-        /* now wait on the entry, it either times out or the cond is signalled.
-         * The status of the entry is BUSY only around the wait. */
-        waitret =
-            GST_SYSTEM_CLOCK_ENTRY_WAIT_UNTIL ((GstClockEntryImpl *) entry,
-            mono_ts * 1000 + diff);
+          /* now wait on the entry, it either times out or the cond is
+           * signalled. The status of the entry is BUSY only around the
+           * wait. */
+          waitret =
+              GST_SYSTEM_CLOCK_ENTRY_WAIT_UNTIL ((GstClockEntryImpl *) entry,
+              mono_ts * 1000 + diff);
 
 #ifdef HAVE_CLOCK_NANOSLEEP
-      }
+        }
 #endif
+      }
 
       /* get the new status, mark as DONE. We do this so that the unschedule
        * function knows when we left the poll and doesn't need to wakeup the
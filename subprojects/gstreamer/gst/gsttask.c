@@ -71,6 +71,7 @@
 
 #include "gstinfo.h"
 #include "gsttask.h"
+#include "gstvalue.h"
 #include "glib-compat-private.h"
 
 #include <stdio.h>
@@ -83,6 +84,11 @@
 #include <pthread.h>
 #endif
 
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (task_debug);
 #define GST_CAT_DEFAULT (task_debug)
 
@@ -106,6 +112,26 @@ struct _GstTaskPrivate
   /* remember the pool and id that is currently running. */
   gpointer id;
   GstTaskPool *pool_id;
+
+  /* cooperative scheduling on a GstWorkStealingTaskPool, the task gives
+   * back the thread after each iteration */
+  gboolean cooperative;
+  /* paused cooperative task that was not requeued, protected by the object
+   * lock */
+  gboolean parked;
+  gboolean entered;
+
+  /* requested affinity, protected by the object lock */
+  gint numa_node;
+  GArray *cpus;
+  gboolean affinity_changed;
+
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+  /* affinity of the thread before we changed it, only used from the
+   * streaming thread */
+  gboolean affinity_set;
+  cpu_set_t saved_affinity;
+#endif
 };
 
 #ifdef _MSC_VER
@@ -198,6 +224,7 @@ gst_task_win32_set_thread_name (const gchar * name)
 static void gst_task_finalize (GObject * object);
 
 static void gst_task_func (GstTask * task);
+static gboolean gst_task_requeue_unlocked (GstTask * task);
 
 static GMutex pool_lock;
 
@@ -248,6 +275,7 @@ gst_task_init (GstTask * task)
   task->lock = NULL;
   g_cond_init (&task->cond);
   SET_TASK_STATE (task, GST_TASK_STOPPED);
+  task->priv->numa_node = -1;
 
   /* use the default klass pool for this task, users can
    * override this later */
@@ -276,6 +304,9 @@ gst_task_finalize (GObject * object)
 
   gst_object_unref (priv->pool);
 
+  if (priv->cpus)
+    g_array_unref (priv->cpus);
+
   /* task thread cannot be running here since it holds a ref
    * to the task so that the finalize could not have happened */
   g_cond_clear (&task->cond);
@@ -325,6 +356,127 @@ gst_task_configure_name (GstTask * task)
 #endif
 }
 
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+/* add the CPUs of NUMA @node to @set, the cpulist is formatted like
+ * "0-7,16-23" */
+static gboolean
+gst_task_add_node_cpus (gint node, cpu_set_t * set)
+{
+  gchar *path, *contents = NULL;
+  gchar **ranges, **r;
+  gboolean res = FALSE;
+
+  path = g_strdup_printf ("/sys/devices/system/node/node%d/cpulist", node);
+  if (!g_file_get_contents (path, &contents, NULL, NULL))
+    goto done;
+
+  ranges = g_strsplit (g_strstrip (contents), ",", -1);
+  for (r = ranges; *r; r++) {
+    guint64 first, last;
+    gchar *end;
+
+    if (**r == '\0')
+      continue;
+
+    first = last = g_ascii_strtoull (*r, &end, 10);
+    if (*end == '-')
+      last = g_ascii_strtoull (end + 1, NULL, 10);
+
+    for (; first <= last && first < CPU_SETSIZE; first++) {
+      CPU_SET (first, set);
+      res = TRUE;
+    }
+  }
+  g_strfreev (ranges);
+
+done:
+  g_free (contents);
+  g_free (path);
+
+  return res;
+}
+#endif
+
+/* called from the streaming thread without locks, moves the thread to the
+ * configured CPUs */
+static void
+gst_task_apply_affinity (GstTask * task)
+{
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+  GstTaskPrivate *priv = task->priv;
+  cpu_set_t set;
+  gboolean have_cpus = FALSE;
+  gint node;
+  guint i;
+
+  CPU_ZERO (&set);
+
+  GST_OBJECT_LOCK (task);
+  node = priv->numa_node;
+  if (priv->cpus) {
+    for (i = 0; i < priv->cpus->len; i++) {
+      guint cpu = g_array_index (priv->cpus, guint, i);
+
+      if (cpu < CPU_SETSIZE) {
+        CPU_SET (cpu, &set);
+        have_cpus = TRUE;
+      }
+    }
+  }
+  GST_OBJECT_UNLOCK (task);
+
+  /* an explicit CPU list wins over the NUMA node */
+  if (!have_cpus && node >= 0) {
+    have_cpus = gst_task_add_node_cpus (node, &set);
+    if (!have_cpus)
+      GST_WARNING_OBJECT (task, "no CPUs found for NUMA node %d", node);
+  }
+
+  if (!have_cpus) {
+    /* affinity was removed, go back to where we came from */
+    if (priv->affinity_set) {
+      pthread_setaffinity_np (pthread_self (), sizeof (cpu_set_t),
+          &priv->saved_affinity);
+      priv->affinity_set = FALSE;
+    }
+    return;
+  }
+
+  if (!priv->affinity_set) {
+    if (pthread_getaffinity_np (pthread_self (), sizeof (cpu_set_t),
+            &priv->saved_affinity) != 0) {
+      GST_WARNING_OBJECT (task, "failed to get thread affinity");
+      return;
+    }
+  }
+
+  if (pthread_setaffinity_np (pthread_self (), sizeof (cpu_set_t), &set) != 0) {
+    GST_WARNING_OBJECT (task, "failed to set thread affinity");
+    return;
+  }
+
+  GST_DEBUG_OBJECT (task, "moved thread to %d CPUs", CPU_COUNT (&set));
+  priv->affinity_set = TRUE;
+#else
+  GST_DEBUG_OBJECT (task, "thread affinity is not supported");
+#endif
+}
+
+/* called from the streaming thread when it is handed back to the pool */
+static void
+gst_task_reset_affinity (GstTask * task)
+{
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+  GstTaskPrivate *priv = task->priv;
+
+  if (priv->affinity_set) {
+    pthread_setaffinity_np (pthread_self (), sizeof (cpu_set_t),
+        &priv->saved_affinity);
+    priv->affinity_set = FALSE;
+  }
+#endif
+}
+
 static void
 gst_task_func (GstTask * task)
 {
@@ -350,20 +502,35 @@ gst_task_func (GstTask * task)
   task->thread = tself;
   GST_OBJECT_UNLOCK (task);
 
-  /* fire the enter_func callback when we need to */
-  if (priv->enter_func)
+  /* fire the enter_func callback when we need to, cooperative tasks only
+   * call it the first time they are scheduled */
+  if (priv->enter_func && !priv->entered)
     priv->enter_func (task, tself, priv->enter_user_data);
+  priv->entered = priv->cooperative;
 
   /* locking order is TASK_LOCK, LOCK */
   g_rec_mutex_lock (lock);
-  /* configure the thread name now */
-  gst_task_configure_name (task);
+  /* configure the thread name now, the threads of pools running tasks
+   * cooperatively are shared */
+  if (!priv->cooperative)
+    gst_task_configure_name (task);
 
   while (G_LIKELY (GET_TASK_STATE (task) != GST_TASK_STOPPED)) {
     GST_OBJECT_LOCK (task);
     while (G_UNLIKELY (GST_TASK_STATE (task) == GST_TASK_PAUSED)) {
       g_rec_mutex_unlock (lock);
 
+      if (priv->cooperative) {
+        /* don't block the worker while paused, we get queued again when
+         * the state changes */
+        GST_INFO_OBJECT (task, "Task parked in paused");
+        task->thread = NULL;
+        priv->parked = TRUE;
+        GST_TASK_SIGNAL (task);
+        GST_OBJECT_UNLOCK (task);
+        return;
+      }
+
       GST_TASK_SIGNAL (task);
       GST_INFO_OBJECT (task, "Task going to paused");
       GST_TASK_WAIT (task);
@@ -378,18 +545,48 @@ gst_task_func (GstTask * task)
       GST_OBJECT_UNLOCK (task);
       break;
     } else {
+      /* the threads of cooperative pools are shared, they keep their own
+       * affinity */
+      gboolean update_affinity = priv->affinity_changed && !priv->cooperative;
+
+      priv->affinity_changed = FALSE;
       GST_OBJECT_UNLOCK (task);
+
+      if (G_UNLIKELY (update_affinity))
+        gst_task_apply_affinity (task);
     }
 
     task->func (task->user_data);
+
+    if (priv->cooperative) {
+      GST_OBJECT_LOCK (task);
+      if (GET_TASK_STATE (task) == GST_TASK_STARTED) {
+        /* yield the worker to other tasks and queue the next iteration */
+        g_rec_mutex_unlock (lock);
+        task->thread = NULL;
+        if (G_LIKELY (gst_task_requeue_unlocked (task))) {
+          GST_OBJECT_UNLOCK (task);
+          return;
+        }
+        /* could not requeue, continue on this thread */
+        task->thread = tself;
+        GST_OBJECT_UNLOCK (task);
+        g_rec_mutex_lock (lock);
+      } else {
+        GST_OBJECT_UNLOCK (task);
+      }
+    }
   }
 
   g_rec_mutex_unlock (lock);
 
+  gst_task_reset_affinity (task);
+
   GST_OBJECT_LOCK (task);
   task->thread = NULL;
 
 exit:
+  priv->entered = FALSE;
   if (priv->leave_func) {
     /* fire the leave_func callback when we need to. We need to do this before
      * we signal the task and with the task lock released. */
@@ -564,6 +761,10 @@ gst_task_get_pool (GstTask * task)
  * Set @pool as the new GstTaskPool for @task. Any new streaming threads that
  * will be created by @task will now use @pool.
  *
+ * When @pool is a #GstWorkStealingTaskPool, @task runs cooperatively: the
+ * thread is given back to @pool every time the task function returns and
+ * the next iteration is queued on @pool again.
+ *
  * MT safe.
  */
 void
@@ -665,6 +866,233 @@ gst_task_set_leave_callback (GstTask * task, GstTaskThreadFunc leave_func,
   GST_OBJECT_UNLOCK (task);
 }
 
+/**
+ * gst_task_set_numa_node:
+ * @task: a #GstTask
+ * @node: a NUMA node or -1
+ *
+ * Run the streaming thread of @task on the CPUs of NUMA node @node so that
+ * the memory it touches can stay local to that node. With -1 the thread is
+ * not restricted to a node.
+ *
+ * The affinity is applied by the streaming thread before the next call of
+ * the task function and is removed again when the thread is returned to the
+ * pool. An explicit CPU list configured with gst_task_set_cpu_affinity()
+ * takes precedence over the node. Tasks that run cooperatively on a
+ * #GstWorkStealingTaskPool keep the affinity of the pool workers.
+ *
+ * This currently only has an effect on Linux.
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+void
+gst_task_set_numa_node (GstTask * task, gint node)
+{
+  g_return_if_fail (GST_IS_TASK (task));
+  g_return_if_fail (node >= -1);
+
+  GST_OBJECT_LOCK (task);
+  if (task->priv->numa_node != node) {
+    task->priv->numa_node = node;
+    task->priv->affinity_changed = TRUE;
+  }
+  GST_OBJECT_UNLOCK (task);
+}
+
+/**
+ * gst_task_get_numa_node:
+ * @task: a #GstTask
+ *
+ * Returns: the NUMA node configured with gst_task_set_numa_node() or -1
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+gint
+gst_task_get_numa_node (GstTask * task)
+{
+  gint node;
+
+  g_return_val_if_fail (GST_IS_TASK (task), -1);
+
+  GST_OBJECT_LOCK (task);
+  node = task->priv->numa_node;
+  GST_OBJECT_UNLOCK (task);
+
+  return node;
+}
+
+/**
+ * gst_task_set_cpu_affinity:
+ * @task: a #GstTask
+ * @cpus: (array length=n_cpus) (nullable): the CPUs to run on
+ * @n_cpus: the number of entries in @cpus
+ *
+ * Run the streaming thread of @task only on @cpus. With an empty list the
+ * thread is not restricted, or only restricted to the NUMA node configured
+ * with gst_task_set_numa_node().
+ *
+ * See gst_task_set_numa_node() for when the affinity is applied.
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+void
+gst_task_set_cpu_affinity (GstTask * task, const guint * cpus, guint n_cpus)
+{
+  GArray *old;
+
+  g_return_if_fail (GST_IS_TASK (task));
+  g_return_if_fail (cpus != NULL || n_cpus == 0);
+
+  GST_OBJECT_LOCK (task);
+  old = task->priv->cpus;
+  if (n_cpus > 0) {
+    task->priv->cpus = g_array_sized_new (FALSE, FALSE, sizeof (guint), n_cpus);
+    g_array_append_vals (task->priv->cpus, cpus, n_cpus);
+  } else {
+    task->priv->cpus = NULL;
+  }
+  task->priv->affinity_changed = TRUE;
+  GST_OBJECT_UNLOCK (task);
+
+  if (old)
+    g_array_unref (old);
+}
+
+/**
+ * gst_task_get_cpu_affinity:
+ * @task: a #GstTask
+ * @n_cpus: (out): the number of returned CPUs
+ *
+ * Returns: (array length=n_cpus) (transfer full) (nullable): the CPUs
+ *     configured with gst_task_set_cpu_affinity(), free with g_free().
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+guint *
+gst_task_get_cpu_affinity (GstTask * task, guint * n_cpus)
+{
+  guint *cpus = NULL;
+
+  g_return_val_if_fail (GST_IS_TASK (task), NULL);
+  g_return_val_if_fail (n_cpus != NULL, NULL);
+
+  GST_OBJECT_LOCK (task);
+  *n_cpus = 0;
+  if (task->priv->cpus) {
+    *n_cpus = task->priv->cpus->len;
+    cpus = g_memdup2 (task->priv->cpus->data, sizeof (guint) * *n_cpus);
+  }
+  GST_OBJECT_UNLOCK (task);
+
+  return cpus;
+}
+
+/**
+ * gst_task_affinity_context_new:
+ * @numa_node: a NUMA node or -1
+ * @cpus: (array length=n_cpus) (nullable): CPUs to run on
+ * @n_cpus: the number of entries in @cpus
+ *
+ * Create a persistent #GstContext of type #GST_TASK_AFFINITY_CONTEXT_TYPE
+ * that describes where streaming threads should run. Setting it on a bin
+ * with gst_element_set_context() distributes it to all children, elements
+ * like queue, multiqueue or #GstAggregator subclasses apply it to their
+ * source pad tasks with gst_task_set_affinity_from_context().
+ *
+ * Returns: (transfer full): a new #GstContext
+ *
+ * Since: 1.24
+ */
+GstContext *
+gst_task_affinity_context_new (gint numa_node, const guint * cpus,
+    guint n_cpus)
+{
+  GstContext *context;
+  GstStructure *s;
+  GValue array = G_VALUE_INIT;
+  GValue cpu = G_VALUE_INIT;
+  guint i;
+
+  g_return_val_if_fail (numa_node >= -1, NULL);
+  g_return_val_if_fail (cpus != NULL || n_cpus == 0, NULL);
+
+  context = gst_context_new (GST_TASK_AFFINITY_CONTEXT_TYPE, TRUE);
+  s = gst_context_writable_structure (context);
+
+  g_value_init (&array, GST_TYPE_ARRAY);
+  g_value_init (&cpu, G_TYPE_UINT);
+  for (i = 0; i < n_cpus; i++) {
+    g_value_set_uint (&cpu, cpus[i]);
+    gst_value_array_append_value (&array, &cpu);
+  }
+  g_value_unset (&cpu);
+
+  gst_structure_set (s, "numa-node", G_TYPE_INT, numa_node, NULL);
+  gst_structure_take_value (s, "cpus", &array);
+
+  return context;
+}
+
+/**
+ * gst_task_set_affinity_from_context:
+ * @task: a #GstTask
+ * @context: a #GstContext of type #GST_TASK_AFFINITY_CONTEXT_TYPE
+ *
+ * Configure the NUMA node and CPU affinity of @task from @context.
+ *
+ * Returns: %TRUE if @context was a task affinity context.
+ *
+ * MT safe.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_task_set_affinity_from_context (GstTask * task, const GstContext * context)
+{
+  const GstStructure *s;
+  const GValue *array;
+  GArray *cpus;
+  gint node = -1;
+  guint i, n;
+
+  g_return_val_if_fail (GST_IS_TASK (task), FALSE);
+  g_return_val_if_fail (GST_IS_CONTEXT (context), FALSE);
+
+  if (!gst_context_has_context_type (context, GST_TASK_AFFINITY_CONTEXT_TYPE))
+    return FALSE;
+
+  s = gst_context_get_structure (context);
+  gst_structure_get_int (s, "numa-node", &node);
+
+  cpus = g_array_new (FALSE, FALSE, sizeof (guint));
+  array = gst_structure_get_value (s, "cpus");
+  if (array && GST_VALUE_HOLDS_ARRAY (array)) {
+    n = gst_value_array_get_size (array);
+    for (i = 0; i < n; i++) {
+      const GValue *v = gst_value_array_get_value (array, i);
+
+      if (G_VALUE_HOLDS_UINT (v)) {
+        guint cpu = g_value_get_uint (v);
+        g_array_append_val (cpus, cpu);
+      }
+    }
+  }
+
+  gst_task_set_numa_node (task, MAX (node, -1));
+  gst_task_set_cpu_affinity (task, (const guint *) cpus->data, cpus->len);
+  g_array_unref (cpus);
+
+  return TRUE;
+}
+
 /**
  * gst_task_get_state:
  * @task: The #GstTask to query
@@ -708,6 +1136,9 @@ start_task (GstTask * task)
   /* push on the thread pool, we remember the original pool because the user
    * could change it later on and then we join to the wrong pool. */
   priv->pool_id = gst_object_ref (priv->pool);
+  priv->cooperative = GST_IS_WORK_STEALING_TASK_POOL (priv->pool_id);
+  priv->parked = FALSE;
+  priv->affinity_changed = priv->numa_node >= 0 || priv->cpus != NULL;
   priv->id =
       gst_task_pool_push (priv->pool_id, (GstTaskPoolFunction) gst_task_func,
       task, &error);
@@ -720,6 +1151,47 @@ start_task (GstTask * task)
   return res;
 }
 
+/* called with the object lock. Queue the next iteration of a cooperative
+ * task on its pool */
+static gboolean
+gst_task_requeue_unlocked (GstTask * task)
+{
+  GstTaskPrivate *priv = task->priv;
+  GError *error = NULL;
+  gpointer old_id;
+
+  old_id = priv->id;
+  priv->id =
+      gst_task_pool_push (priv->pool_id, (GstTaskPoolFunction) gst_task_func,
+      task, &error);
+
+  if (error != NULL) {
+    GST_WARNING_OBJECT (task, "failed to requeue task: %s", error->message);
+    g_error_free (error);
+    priv->id = old_id;
+    return FALSE;
+  }
+
+  if (old_id)
+    gst_task_pool_dispose_handle (priv->pool_id, old_id);
+
+  return TRUE;
+}
+
+/* called with the object lock. Wake up a parked cooperative task */
+static void
+gst_task_unpark_unlocked (GstTask * task)
+{
+  GstTaskPrivate *priv = task->priv;
+
+  if (!priv->parked)
+    return;
+
+  priv->parked = FALSE;
+  if (!gst_task_requeue_unlocked (task))
+    g_warning ("failed to wake up task %p", task);
+}
+
 static inline gboolean
 gst_task_set_state_unlocked (GstTask * task, GstTaskState state)
 {
@@ -746,6 +1218,7 @@ gst_task_set_state_unlocked (GstTask * task, GstTaskState state)
       case GST_TASK_PAUSED:
         /* when we are paused, signal to go to the new state */
         GST_TASK_SIGNAL (task);
+        gst_task_unpark_unlocked (task);
         break;
       case GST_TASK_STARTED:
         /* if we were started, we'll go to the new state after the next
@@ -916,6 +1389,7 @@ gst_task_join (GstTask * task)
   SET_TASK_STATE (task, GST_TASK_STOPPED);
   /* signal the state change for when it was blocked in PAUSED. */
   GST_TASK_SIGNAL (task);
+  gst_task_unpark_unlocked (task);
   /* we set the running flag when pushing the task on the thread pool.
    * This means that the task function might not be called when we try
    * to join it here. */
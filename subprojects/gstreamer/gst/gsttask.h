@@ -24,6 +24,7 @@
 #define __GST_TASK_H__
 
 #include <gst/gstobject.h>
+#include <gst/gstcontext.h>
 #include <gst/gsttaskpool.h>
 
 G_BEGIN_DECLS
@@ -193,6 +194,35 @@ void            gst_task_set_leave_callback  (GstTask *task,
                                               gpointer user_data,
                                               GDestroyNotify notify);
 GST_API
+void            gst_task_set_numa_node  (GstTask *task, gint node);
+
+GST_API
+gint            gst_task_get_numa_node  (GstTask *task);
+
+GST_API
+void            gst_task_set_cpu_affinity (GstTask *task, const guint *cpus,
+                                           guint n_cpus);
+GST_API
+guint *         gst_task_get_cpu_affinity (GstTask *task, guint *n_cpus);
+
+/**
+ * GST_TASK_AFFINITY_CONTEXT_TYPE:
+ *
+ * The #GstContext type describing the NUMA node and CPUs streaming threads
+ * should run on, see gst_task_affinity_context_new().
+ *
+ * Since: 1.24
+ */
+#define GST_TASK_AFFINITY_CONTEXT_TYPE "gst.task.affinity"
+
+GST_API
+GstContext *    gst_task_affinity_context_new (gint numa_node,
+                                               const guint *cpus,
+                                               guint n_cpus);
+GST_API
+gboolean        gst_task_set_affinity_from_context (GstTask *task,
+                                                    const GstContext *context);
+GST_API
 GstTaskState    gst_task_get_state      (GstTask *task);
 
 GST_API
@@ -37,6 +37,11 @@
 #include "gsttaskpool.h"
 #include "gsterror.h"
 
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 GST_DEBUG_CATEGORY_STATIC (taskpool_debug);
 #define GST_CAT_DEFAULT (taskpool_debug)
 
@@ -546,3 +551,424 @@ gst_shared_task_pool_new (void)
 
   return pool;
 }
+
+/**
+ * SECTION:gstworkstealingtaskpool
+ * @title: GstWorkStealingTaskPool
+ * @short_description: Task pool with a fixed number of work-stealing workers
+ * @see_also: #GstTaskPool, #GstTask
+ *
+ * A #GstWorkStealingTaskPool runs the pushed functions on a fixed set of
+ * worker threads, by default one per CPU core. Each worker has its own queue
+ * of pending functions. Functions pushed from a worker thread are queued on
+ * that worker, others are distributed over the workers. Idle workers steal
+ * pending functions from the queues of busy workers.
+ *
+ * A #GstTask that uses this pool runs cooperatively: every time its function
+ * returns, the task gives the worker thread back to the pool and is queued
+ * again. Paused tasks don't occupy a worker. This allows running many
+ * streams on as many threads as there are cores, but a task function that
+ * blocks keeps its worker busy. As for #GstSharedTaskPool, tasks that wait on
+ * each other can deadlock when all workers are blocked, so the number of
+ * workers needs to be larger than the number of tasks that can block at the
+ * same time.
+ *
+ * Since: 1.24
+ */
+
+typedef struct
+{
+  GstWorkStealingTaskPool *pool;
+  guint index;
+  GThread *thread;
+
+  /* queue of SharedTaskData, the owner pops from the head and thieves from
+   * the tail */
+  GMutex lock;
+  GQueue jobs;
+  gint n_jobs;
+} WorkStealingWorker;
+
+struct _GstWorkStealingTaskPoolPrivate
+{
+  guint n_workers;
+  gboolean pin_workers;
+
+  /* protected by the object lock */
+  WorkStealingWorker *workers;
+  guint next_worker;
+
+  /* idle workers sleep on the cond */
+  GMutex lock;
+  GCond cond;
+  gboolean shutdown;
+  gint n_pending;
+  gint n_idle;
+};
+
+/* the worker of the current thread, if any */
+static GPrivate current_worker;
+
+G_DEFINE_TYPE_WITH_PRIVATE (GstWorkStealingTaskPool,
+    gst_work_stealing_task_pool, GST_TYPE_TASK_POOL);
+
+static SharedTaskData *
+work_stealing_take_job (GstWorkStealingTaskPool * pool,
+    WorkStealingWorker * worker)
+{
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+  SharedTaskData *tdata = NULL;
+  guint i;
+
+  /* first our own queue */
+  if (g_atomic_int_get (&worker->n_jobs) > 0) {
+    g_mutex_lock (&worker->lock);
+    if ((tdata = g_queue_pop_head (&worker->jobs)))
+      g_atomic_int_add (&worker->n_jobs, -1);
+    g_mutex_unlock (&worker->lock);
+  }
+
+  /* then steal from the others */
+  for (i = 1; tdata == NULL && i < priv->n_workers; i++) {
+    WorkStealingWorker *victim;
+
+    victim = &priv->workers[(worker->index + i) % priv->n_workers];
+    if (g_atomic_int_get (&victim->n_jobs) == 0)
+      continue;
+
+    g_mutex_lock (&victim->lock);
+    if ((tdata = g_queue_pop_tail (&victim->jobs)))
+      g_atomic_int_add (&victim->n_jobs, -1);
+    g_mutex_unlock (&victim->lock);
+
+    if (tdata)
+      GST_LOG_OBJECT (pool, "worker %u stole job %p from worker %u",
+          worker->index, tdata, victim->index);
+  }
+
+  if (tdata)
+    g_atomic_int_add (&priv->n_pending, -1);
+
+  return tdata;
+}
+
+static void
+work_stealing_pin_worker (GstWorkStealingTaskPool * pool,
+    WorkStealingWorker * worker)
+{
+#ifdef HAVE_PTHREAD_SETAFFINITY_NP
+  cpu_set_t set;
+  guint cpu;
+
+  cpu = worker->index % g_get_num_processors ();
+
+  CPU_ZERO (&set);
+  CPU_SET (cpu, &set);
+  if (pthread_setaffinity_np (pthread_self (), sizeof (set), &set) != 0)
+    GST_WARNING_OBJECT (pool, "failed to pin worker %u to CPU %u",
+        worker->index, cpu);
+  else
+    GST_DEBUG_OBJECT (pool, "pinned worker %u to CPU %u", worker->index, cpu);
+#else
+  GST_DEBUG_OBJECT (pool, "pinning workers is not supported");
+#endif
+}
+
+static gpointer
+work_stealing_worker_func (WorkStealingWorker * worker)
+{
+  GstWorkStealingTaskPool *pool = worker->pool;
+  GstWorkStealingTaskPoolPrivate *priv = pool->priv;
+
+  g_private_set (&current_worker, worker);
+
+  if (priv->pin_workers)
+    work_stealing_pin_worker (pool, worker);
+
+  GST_DEBUG_OBJECT (pool, "worker %u started", worker->index);
+
+  while (TRUE) {
+    SharedTaskData *tdata;
+
+    if ((tdata = work_stealing_take_job (pool, worker))) {
+      shared_func (tdata, GST_TASK_POOL_CAST (pool));
+      continue;
+    }
+
+    /* nothing to do, wait for new jobs. Pushers check for idle workers
+     * after queueing, we check for pending jobs after announcing that we are
+     * idle so that no wakeup gets lost */
+    g_mutex_lock (&priv->lock);
+    g_atomic_int_inc (&priv->n_idle);
+    while (!priv->shutdown && g_atomic_int_get (&priv->n_pending) == 0)
+      g_cond_wait (&priv->cond, &priv->lock);
+    g_atomic_int_add (&priv->n_idle, -1);
+    if (priv->shutdown && g_atomic_int_get (&priv->n_pending) == 0) {
+      g_mutex_unlock (&priv->lock);
+      break;
+    }
+    g_mutex_unlock (&priv->lock);
+  }
+
+  GST_DEBUG_OBJECT (pool, "worker %u stopped", worker->index);
+
+  g_private_set (&current_worker, NULL);
+
+  return NULL;
+}
+
+static void
+work_stealing_prepare (GstTaskPool * pool, GError ** error)
+{
+  GstWorkStealingTaskPool *ws_pool = GST_WORK_STEALING_TASK_POOL (pool);
+  GstWorkStealingTaskPoolPrivate *priv = ws_pool->priv;
+  WorkStealingWorker *workers;
+  guint i;
+
+  GST_OBJECT_LOCK (pool);
+  if (priv->workers) {
+    GST_OBJECT_UNLOCK (pool);
+    return;
+  }
+
+  priv->shutdown = FALSE;
+  workers = g_new0 (WorkStealingWorker, priv->n_workers);
+  for (i = 0; i < priv->n_workers; i++) {
+    workers[i].pool = ws_pool;
+    workers[i].index = i;
+    g_mutex_init (&workers[i].lock);
+    g_queue_init (&workers[i].jobs);
+  }
+  priv->workers = workers;
+
+  for (i = 0; i < priv->n_workers; i++) {
+    gchar *name = g_strdup_printf ("gstws-%u", i);
+
+    workers[i].thread = g_thread_try_new (name,
+        (GThreadFunc) work_stealing_worker_func, &workers[i], error);
+    g_free (name);
+
+    if (workers[i].thread == NULL) {
+      GST_ERROR_OBJECT (pool, "failed to start worker %u", i);
+      break;
+    }
+  }
+  GST_OBJECT_UNLOCK (pool);
+
+  GST_DEBUG_OBJECT (pool, "started %u workers", i);
+}
+
+static void
+work_stealing_cleanup (GstTaskPool * pool)
+{
+  GstWorkStealingTaskPool *ws_pool = GST_WORK_STEALING_TASK_POOL (pool);
+  GstWorkStealingTaskPoolPrivate *priv = ws_pool->priv;
+  WorkStealingWorker *workers;
+  guint i;
+
+  GST_OBJECT_LOCK (pool);
+  workers = priv->workers;
+  GST_OBJECT_UNLOCK (pool);
+
+  if (workers == NULL)
+    return;
+
+  /* the workers process the jobs that are still queued before exiting */
+  g_mutex_lock (&priv->lock);
+  priv->shutdown = TRUE;
+  g_cond_broadcast (&priv->cond);
+  g_mutex_unlock (&priv->lock);
+
+  for (i = 0; i < priv->n_workers; i++) {
+    if (workers[i].thread)
+      g_thread_join (workers[i].thread);
+  }
+
+  GST_OBJECT_LOCK (pool);
+  priv->workers = NULL;
+  GST_OBJECT_UNLOCK (pool);
+
+  for (i = 0; i < priv->n_workers; i++) {
+    SharedTaskData *tdata;
+
+    /* can only happen when not all workers could be started */
+    while ((tdata = g_queue_pop_head (&workers[i].jobs)))
+      shared_func (tdata, pool);
+    g_mutex_clear (&workers[i].lock);
+  }
+  g_free (workers);
+}
+
+static gpointer
+work_stealing_push (GstTaskPool * pool, GstTaskPoolFunction func,
+    gpointer user_data, GError ** error)
+{
+  GstWorkStealingTaskPool *ws_pool = GST_WORK_STEALING_TASK_POOL (pool);
+  GstWorkStealingTaskPoolPrivate *priv = ws_pool->priv;
+  WorkStealingWorker *worker;
+  SharedTaskData *tdata;
+
+  worker = g_private_get (&current_worker);
+  if (worker == NULL || worker->pool != ws_pool) {
+    /* not called from one of our workers, spread the load */
+    GST_OBJECT_LOCK (pool);
+    if (priv->workers == NULL || priv->shutdown) {
+      GST_OBJECT_UNLOCK (pool);
+      g_set_error_literal (error, GST_CORE_ERROR, GST_CORE_ERROR_FAILED,
+          "No thread pool");
+      return NULL;
+    }
+    worker = &priv->workers[priv->next_worker++ % priv->n_workers];
+    GST_OBJECT_UNLOCK (pool);
+  }
+
+  tdata = g_new (SharedTaskData, 1);
+  tdata->done = FALSE;
+  tdata->func = func;
+  tdata->user_data = user_data;
+  g_atomic_int_set (&tdata->refcount, 1);
+  g_cond_init (&tdata->done_cond);
+  g_mutex_init (&tdata->done_lock);
+
+  /* functions pushed from a worker stay on that worker unless stolen */
+  g_mutex_lock (&worker->lock);
+  g_queue_push_tail (&worker->jobs, shared_task_data_ref (tdata));
+  g_atomic_int_inc (&worker->n_jobs);
+  g_mutex_unlock (&worker->lock);
+
+  g_atomic_int_inc (&priv->n_pending);
+  if (g_atomic_int_get (&priv->n_idle) > 0) {
+    g_mutex_lock (&priv->lock);
+    g_cond_signal (&priv->cond);
+    g_mutex_unlock (&priv->lock);
+  }
+
+  return tdata;
+}
+
+static void
+gst_work_stealing_task_pool_finalize (GObject * object)
+{
+  GstWorkStealingTaskPool *pool = GST_WORK_STEALING_TASK_POOL (object);
+
+  work_stealing_cleanup (GST_TASK_POOL_CAST (pool));
+
+  g_mutex_clear (&pool->priv->lock);
+  g_cond_clear (&pool->priv->cond);
+
+  G_OBJECT_CLASS (gst_work_stealing_task_pool_parent_class)->finalize (object);
+}
+
+static void
+gst_work_stealing_task_pool_class_init (GstWorkStealingTaskPoolClass * klass)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+  GstTaskPoolClass *taskpoolclass = GST_TASK_POOL_CLASS (klass);
+
+  gobject_class->finalize = gst_work_stealing_task_pool_finalize;
+
+  taskpoolclass->prepare = work_stealing_prepare;
+  taskpoolclass->cleanup = work_stealing_cleanup;
+  taskpoolclass->push = work_stealing_push;
+  taskpoolclass->join = shared_join;
+  taskpoolclass->dispose_handle = shared_dispose_handle;
+}
+
+static void
+gst_work_stealing_task_pool_init (GstWorkStealingTaskPool * pool)
+{
+  GstWorkStealingTaskPoolPrivate *priv;
+
+  priv = pool->priv = gst_work_stealing_task_pool_get_instance_private (pool);
+  priv->n_workers = g_get_num_processors ();
+  g_mutex_init (&priv->lock);
+  g_cond_init (&priv->cond);
+}
+
+/**
+ * gst_work_stealing_task_pool_new:
+ * @n_workers: the number of worker threads, or 0 for one per CPU core
+ *
+ * Create a new work-stealing task pool. The workers are started by
+ * gst_task_pool_prepare().
+ *
+ * Returns: (transfer full): a new #GstWorkStealingTaskPool.
+ * gst_object_unref() after usage.
+ *
+ * Since: 1.24
+ */
+GstTaskPool *
+gst_work_stealing_task_pool_new (guint n_workers)
+{
+  GstWorkStealingTaskPool *pool;
+
+  pool = g_object_new (GST_TYPE_WORK_STEALING_TASK_POOL, NULL);
+  if (n_workers > 0)
+    pool->priv->n_workers = n_workers;
+
+  /* clear floating flag */
+  gst_object_ref_sink (pool);
+
+  return GST_TASK_POOL_CAST (pool);
+}
+
+/**
+ * gst_work_stealing_task_pool_get_n_workers:
+ * @pool: a #GstWorkStealingTaskPool
+ *
+ * Returns: the number of worker threads of @pool
+ *
+ * Since: 1.24
+ */
+guint
+gst_work_stealing_task_pool_get_n_workers (GstWorkStealingTaskPool * pool)
+{
+  g_return_val_if_fail (GST_IS_WORK_STEALING_TASK_POOL (pool), 0);
+
+  return pool->priv->n_workers;
+}
+
+/**
+ * gst_work_stealing_task_pool_set_pin_workers:
+ * @pool: a #GstWorkStealingTaskPool
+ * @pin: whether to pin the workers to CPU cores
+ *
+ * Configure whether the worker threads of @pool are pinned to one CPU core
+ * each. Worker N runs on CPU N modulo the number of CPUs. This only has an
+ * effect on workers started after this call and only on platforms that
+ * support setting the CPU affinity of threads.
+ *
+ * Since: 1.24
+ */
+void
+gst_work_stealing_task_pool_set_pin_workers (GstWorkStealingTaskPool * pool,
+    gboolean pin)
+{
+  g_return_if_fail (GST_IS_WORK_STEALING_TASK_POOL (pool));
+
+  GST_OBJECT_LOCK (pool);
+  pool->priv->pin_workers = pin;
+  GST_OBJECT_UNLOCK (pool);
+}
+
+/**
+ * gst_work_stealing_task_pool_get_pin_workers:
+ * @pool: a #GstWorkStealingTaskPool
+ *
+ * Returns: whether the worker threads of @pool are pinned to CPU cores
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_work_stealing_task_pool_get_pin_workers (GstWorkStealingTaskPool * pool)
+{
+  gboolean ret;
+
+  g_return_val_if_fail (GST_IS_WORK_STEALING_TASK_POOL (pool), FALSE);
+
+  GST_OBJECT_LOCK (pool);
+  ret = pool->priv->pin_workers;
+  GST_OBJECT_UNLOCK (pool);
+
+  return ret;
+}
@@ -172,6 +172,62 @@ guint           gst_shared_task_pool_get_max_threads (GstSharedTaskPool *pool);
 GST_API
 GstTaskPool *   gst_shared_task_pool_new             (void);
 
+typedef struct _GstWorkStealingTaskPool GstWorkStealingTaskPool;
+typedef struct _GstWorkStealingTaskPoolClass GstWorkStealingTaskPoolClass;
+typedef struct _GstWorkStealingTaskPoolPrivate GstWorkStealingTaskPoolPrivate;
+
+#define GST_TYPE_WORK_STEALING_TASK_POOL             (gst_work_stealing_task_pool_get_type ())
+#define GST_WORK_STEALING_TASK_POOL(pool)            (G_TYPE_CHECK_INSTANCE_CAST ((pool), GST_TYPE_WORK_STEALING_TASK_POOL, GstWorkStealingTaskPool))
+#define GST_IS_WORK_STEALING_TASK_POOL(pool)         (G_TYPE_CHECK_INSTANCE_TYPE ((pool), GST_TYPE_WORK_STEALING_TASK_POOL))
+#define GST_WORK_STEALING_TASK_POOL_CLASS(pclass)    (G_TYPE_CHECK_CLASS_CAST ((pclass), GST_TYPE_WORK_STEALING_TASK_POOL, GstWorkStealingTaskPoolClass))
+#define GST_IS_WORK_STEALING_TASK_POOL_CLASS(pclass) (G_TYPE_CHECK_CLASS_TYPE ((pclass), GST_TYPE_WORK_STEALING_TASK_POOL))
+#define GST_WORK_STEALING_TASK_POOL_GET_CLASS(pool)  (G_TYPE_INSTANCE_GET_CLASS ((pool), GST_TYPE_WORK_STEALING_TASK_POOL, GstWorkStealingTaskPoolClass))
+
+/**
+ * GstWorkStealingTaskPool:
+ *
+ * The #GstWorkStealingTaskPool object.
+ *
+ * Since: 1.24
+ */
+struct _GstWorkStealingTaskPool {
+  GstTaskPool parent;
+
+  /*< private >*/
+  GstWorkStealingTaskPoolPrivate *priv;
+
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+/**
+ * GstWorkStealingTaskPoolClass:
+ *
+ * The #GstWorkStealingTaskPoolClass object.
+ *
+ * Since: 1.24
+ */
+struct _GstWorkStealingTaskPoolClass {
+  GstTaskPoolClass parent_class;
+
+  /*< private >*/
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+GST_API
+GType           gst_work_stealing_task_pool_get_type        (void);
+
+GST_API
+GstTaskPool *   gst_work_stealing_task_pool_new             (guint n_workers);
+
+GST_API
+guint           gst_work_stealing_task_pool_get_n_workers   (GstWorkStealingTaskPool *pool);
+
+GST_API
+void            gst_work_stealing_task_pool_set_pin_workers (GstWorkStealingTaskPool *pool, gboolean pin);
+
+GST_API
+gboolean        gst_work_stealing_task_pool_get_pin_workers (GstWorkStealingTaskPool *pool);
+
 G_END_DECLS
 
 #endif /* __GST_TASK_POOL_H__ */
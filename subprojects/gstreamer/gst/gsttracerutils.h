@@ -84,6 +84,9 @@ typedef enum /*< skip >*/
   GST_TRACER_QUARK_HOOK_PAD_CHAIN_POST,
   GST_TRACER_QUARK_HOOK_PAD_CHAIN_LIST_PRE,
   GST_TRACER_QUARK_HOOK_PAD_CHAIN_LIST_POST,
+  GST_TRACER_QUARK_HOOK_MEMORY_COPY,
+  GST_TRACER_QUARK_HOOK_BUFFER_MERGE,
+  GST_TRACER_QUARK_HOOK_MINI_OBJECT_WRITABLE_COPY,
   GST_TRACER_QUARK_MAX
 } GstTracerQuarkId;
 
@@ -839,6 +842,96 @@ typedef void (*GstTracerHookPadChainListPost) (GObject *self, GstClockTime ts,
     GstTracerHookPadChainListPost, (GST_TRACER_ARGS, pad, res)); \
 }G_STMT_END
 
+/**
+ * GstTracerHookMemoryCopy:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @mem: the memory that was copied
+ * @copy: the copy
+ *
+ * Hook called when gst_memory_copy() copied a #GstMemory named
+ * "memory-copy".
+ *
+ * Since: 1.24
+ */
+typedef void (*GstTracerHookMemoryCopy) (GObject *self, GstClockTime ts,
+    GstMemory *mem, GstMemory *copy);
+
+/**
+ * GST_TRACER_MEMORY_COPY:
+ * @mem: a %GstMemory
+ * @copy: a %GstMemory
+ *
+ * Dispatches the "memory-copy" hook.
+ *
+ * Since: 1.24
+ */
+#define GST_TRACER_MEMORY_COPY(mem, copy) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_MEMORY_COPY), \
+    GstTracerHookMemoryCopy, (GST_TRACER_ARGS, mem, copy)); \
+}G_STMT_END
+
+/**
+ * GstTracerHookBufferMerge:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @buffer: the buffer whose memories were merged
+ * @merged: the memory the data of @buffer was copied into
+ *
+ * Hook called when the memories of a #GstBuffer were copied into a single
+ * #GstMemory, for example to map a buffer with multiple memories, named
+ * "buffer-merge".
+ *
+ * Since: 1.24
+ */
+typedef void (*GstTracerHookBufferMerge) (GObject *self, GstClockTime ts,
+    GstBuffer *buffer, GstMemory *merged);
+
+/**
+ * GST_TRACER_BUFFER_MERGE:
+ * @buffer: a %GstBuffer
+ * @merged: a %GstMemory
+ *
+ * Dispatches the "buffer-merge" hook.
+ *
+ * Since: 1.24
+ */
+#define GST_TRACER_BUFFER_MERGE(buffer, merged) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_BUFFER_MERGE), \
+    GstTracerHookBufferMerge, (GST_TRACER_ARGS, buffer, merged)); \
+}G_STMT_END
+
+/**
+ * GstTracerHookMiniObjectWritableCopy:
+ * @self: the tracer instance
+ * @ts: the current timestamp
+ * @object: the mini object that was not writable
+ * @copy: the copy
+ *
+ * Hook called when gst_mini_object_make_writable() had to copy a
+ * #GstMiniObject because it was not writable, usually because of other
+ * references, named "mini-object-writable-copy". The reference that is
+ * replaced by @copy is not released yet.
+ *
+ * Since: 1.24
+ */
+typedef void (*GstTracerHookMiniObjectWritableCopy) (GObject *self,
+    GstClockTime ts, GstMiniObject *object, GstMiniObject *copy);
+
+/**
+ * GST_TRACER_MINI_OBJECT_WRITABLE_COPY:
+ * @object: a %GstMiniObject
+ * @copy: a %GstMiniObject
+ *
+ * Dispatches the "mini-object-writable-copy" hook.
+ *
+ * Since: 1.24
+ */
+#define GST_TRACER_MINI_OBJECT_WRITABLE_COPY(object, copy) G_STMT_START{ \
+  GST_TRACER_DISPATCH(GST_TRACER_QUARK(HOOK_MINI_OBJECT_WRITABLE_COPY), \
+    GstTracerHookMiniObjectWritableCopy, (GST_TRACER_ARGS, object, copy)); \
+}G_STMT_END
+
 #else /* !GST_DISABLE_GST_TRACER_HOOKS */
 
 static inline void
@@ -892,6 +985,9 @@ _priv_gst_tracing_deinit (void)
 #define GST_TRACER_PAD_CHAIN_POST(pad, res)
 #define GST_TRACER_PAD_CHAIN_LIST_PRE(pad, list)
 #define GST_TRACER_PAD_CHAIN_LIST_POST(pad, res)
+#define GST_TRACER_MEMORY_COPY(mem, copy)
+#define GST_TRACER_BUFFER_MERGE(buffer, merged)
+#define GST_TRACER_MINI_OBJECT_WRITABLE_COPY(object, copy)
 
 #endif /* GST_DISABLE_GST_TRACER_HOOKS */
 
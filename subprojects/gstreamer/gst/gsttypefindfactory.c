@@ -120,6 +120,8 @@ gst_type_find_factory_dispose (GObject * object)
     gst_caps_unref (factory->caps);
     factory->caps = NULL;
   }
+  factory->caps_string = NULL;
+  g_clear_pointer (&factory->cache, g_bytes_unref);
   if (factory->extensions) {
     g_strfreev (factory->extensions);
     factory->extensions = NULL;
@@ -164,9 +166,25 @@ gst_type_find_factory_get_list (void)
 GstCaps *
 gst_type_find_factory_get_caps (GstTypeFindFactory * factory)
 {
+  GstCaps *caps;
+
   g_return_val_if_fail (GST_IS_TYPE_FIND_FACTORY (factory), NULL);
 
-  return factory->caps;
+  caps = g_atomic_pointer_get (&factory->caps);
+
+  /* caps of factories loaded from the registry cache are parsed on first use */
+  if (G_UNLIKELY (caps == NULL && factory->caps_string != NULL)) {
+    caps = gst_caps_from_string (factory->caps_string);
+    if (caps == NULL)
+      return NULL;
+
+    if (!g_atomic_pointer_compare_and_exchange (&factory->caps, NULL, caps)) {
+      gst_caps_unref (caps);
+      caps = g_atomic_pointer_get (&factory->caps);
+    }
+  }
+
+  return caps;
 }
 
 /**
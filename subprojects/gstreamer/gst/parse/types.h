@@ -31,6 +31,10 @@ typedef struct {
 } element_t;
 
 
+/* resolved factories and property values shared by the instantiations of a
+ * GstParseTemplate, implemented in grammar.y */
+typedef struct _GstParseCache GstParseCache;
+
 typedef struct _graph_t graph_t;
 struct _graph_t {
   chain_t *chain; /* links are supposed to be done now */
@@ -38,6 +42,7 @@ struct _graph_t {
   GError **error;
   GstParseContext *ctx; /* may be NULL */
   GstParseFlags flags;
+  GstParseCache *cache; /* may be NULL */
 };
 
 
@@ -117,6 +122,11 @@ gst_parse_unescape (gchar *str)
 G_GNUC_INTERNAL GstElement *priv_gst_parse_launch (const gchar      * str,
                                                    GError          ** err,
                                                    GstParseContext  * ctx,
-                                                   GstParseFlags      flags);
+                                                   GstParseFlags      flags,
+                                                   GstParseCache    * cache);
+
+G_GNUC_INTERNAL GstParseCache *priv_gst_parse_cache_new (void);
+
+G_GNUC_INTERNAL void priv_gst_parse_cache_free (GstParseCache * cache);
 
 #endif /* __GST_PARSE_TYPES_H__ */
@@ -111,7 +111,9 @@
  * this, some functions like gst_adapter_available_fast() are provided to help
  * speed up such cases should you want to. To avoid repeated memory allocations,
  * gst_adapter_copy() can be used to copy data into a (statically allocated)
- * user provided buffer.
+ * user provided buffer. Code that only needs to look at the data can use
+ * gst_adapter_map_vectored() to get a #GstByteReader for every buffer
+ * touched by a range instead of having it merged.
  *
  * #GstAdapter is not MT safe. All operations on an adapter must be serialized by
  * the caller. This is not normally a problem, however, as the normal use case
@@ -170,8 +172,17 @@ struct _GstAdapter
   guint64 distance_from_discont;
 
   GstMapInfo info;
+
+  /* buffers mapped by gst_adapter_map_vectored(), starting at queue index
+   * vmap_first, and the readers handed out for them */
+  guint vmap_first;
+  GArray *vmap_infos;
+  GArray *vmap_readers;
 };
 
+#define ADAPTER_IS_MAPPED(a) ((a)->info.memory != NULL || \
+    ((a)->vmap_infos != NULL && (a)->vmap_infos->len > 0))
+
 struct _GstAdapterClass
 {
   GObjectClass parent_class;
@@ -229,6 +240,11 @@ gst_adapter_finalize (GObject * object)
 
   g_free (adapter->assembled_data);
 
+  if (adapter->vmap_infos) {
+    g_array_unref (adapter->vmap_infos);
+    g_array_unref (adapter->vmap_readers);
+  }
+
   gst_queue_array_free (adapter->bufqueue);
 
   GST_CALL_PARENT (G_OBJECT_CLASS, finalize, (object));
@@ -259,7 +275,7 @@ gst_adapter_clear (GstAdapter * adapter)
   GstMiniObject *obj;
   g_return_if_fail (GST_IS_ADAPTER (adapter));
 
-  if (adapter->info.memory)
+  if (ADAPTER_IS_MAPPED (adapter))
     gst_adapter_unmap (adapter);
 
   while ((obj = gst_queue_array_pop_head (adapter->bufqueue)))
@@ -491,7 +507,7 @@ gst_adapter_map (GstAdapter * adapter, gsize size)
   g_return_val_if_fail (GST_IS_ADAPTER (adapter), NULL);
   g_return_val_if_fail (size > 0, NULL);
 
-  if (adapter->info.memory)
+  if (ADAPTER_IS_MAPPED (adapter))
     gst_adapter_unmap (adapter);
 
   /* we don't have enough data, return NULL. This is unlikely
@@ -556,11 +572,104 @@ gst_adapter_map (GstAdapter * adapter, gsize size)
   return adapter->assembled_data;
 }
 
+/**
+ * gst_adapter_map_vectored:
+ * @adapter: a #GstAdapter
+ * @offset: the offset in the adapter to start from
+ * @size: the number of bytes to map/peek
+ * @n_chunks: (out): the number of chunks returned
+ *
+ * Maps @size bytes starting at @offset in the @adapter without assembling
+ * them into one contiguous block. Every queued buffer the range touches is
+ * mapped in place and a #GstByteReader is set up over the part of it that
+ * belongs to the range, so the data of all chunks together, in order, is the
+ * requested range.
+ *
+ * This avoids the copy gst_adapter_map() has to make when the data spans
+ * several buffers, which is useful for parsers that only need to look at
+ * the data, for example to scan for start codes. The readers may be used to
+ * parse the data but their data pointers are only valid until the memory is
+ * released again with gst_adapter_unmap(), which needs to happen before any
+ * other function that modifies the @adapter is called.
+ *
+ * Returns %NULL if @size bytes are not available after @offset.
+ *
+ * Returns: (transfer none) (array length=n_chunks) (nullable): the readers
+ *     for the mapped chunks, or %NULL
+ *
+ * Since: 1.24
+ */
+const GstByteReader *
+gst_adapter_map_vectored (GstAdapter * adapter, gsize offset, gsize size,
+    guint * n_chunks)
+{
+  GstBuffer *cur;
+  GstMapInfo info;
+  GstByteReader reader;
+  gsize skip, bsize, chunk;
+  guint idx;
+
+  g_return_val_if_fail (GST_IS_ADAPTER (adapter), NULL);
+  g_return_val_if_fail (size > 0, NULL);
+  g_return_val_if_fail (n_chunks != NULL, NULL);
+
+  *n_chunks = 0;
+
+  if (ADAPTER_IS_MAPPED (adapter))
+    gst_adapter_unmap (adapter);
+
+  if (G_UNLIKELY (offset > adapter->size || size > adapter->size - offset))
+    return NULL;
+
+  if (adapter->vmap_infos == NULL) {
+    adapter->vmap_infos = g_array_new (FALSE, FALSE, sizeof (GstMapInfo));
+    adapter->vmap_readers =
+        g_array_new (FALSE, FALSE, sizeof (GstByteReader));
+  }
+
+  /* find the buffer that contains offset */
+  skip = adapter->skip + offset;
+  idx = 0;
+  cur = gst_queue_array_peek_head (adapter->bufqueue);
+  bsize = gst_buffer_get_size (cur);
+  while (skip >= bsize) {
+    skip -= bsize;
+    cur = gst_queue_array_peek_nth (adapter->bufqueue, ++idx);
+    bsize = gst_buffer_get_size (cur);
+  }
+  adapter->vmap_first = idx;
+
+  while (size > 0) {
+    if (!gst_buffer_map (cur, &info, GST_MAP_READ)) {
+      GST_WARNING_OBJECT (adapter, "failed to map buffer %p", cur);
+      gst_adapter_unmap (adapter);
+      return NULL;
+    }
+
+    chunk = MIN (info.size - skip, size);
+    gst_byte_reader_init (&reader, info.data + skip, chunk);
+    g_array_append_val (adapter->vmap_infos, info);
+    g_array_append_val (adapter->vmap_readers, reader);
+
+    size -= chunk;
+    skip = 0;
+    if (size > 0)
+      cur = gst_queue_array_peek_nth (adapter->bufqueue, ++idx);
+  }
+
+  GST_LOG_OBJECT (adapter, "mapped %u chunks", adapter->vmap_readers->len);
+
+  *n_chunks = adapter->vmap_readers->len;
+
+  return (const GstByteReader *) adapter->vmap_readers->data;
+}
+
 /**
  * gst_adapter_unmap:
  * @adapter: a #GstAdapter
  *
- * Releases the memory obtained with the last gst_adapter_map().
+ * Releases the memory obtained with the last gst_adapter_map() or
+ * gst_adapter_map_vectored().
  */
 void
 gst_adapter_unmap (GstAdapter * adapter)
@@ -573,6 +682,21 @@ gst_adapter_unmap (GstAdapter * adapter)
     gst_buffer_unmap (cur, &adapter->info);
     adapter->info.memory = NULL;
   }
+
+  if (adapter->vmap_infos && adapter->vmap_infos->len > 0) {
+    guint i;
+
+    for (i = 0; i < adapter->vmap_infos->len; i++) {
+      GstBuffer *cur = gst_queue_array_peek_nth (adapter->bufqueue,
+          adapter->vmap_first + i);
+
+      gst_buffer_unmap (cur, &g_array_index (adapter->vmap_infos,
+              GstMapInfo, i));
+    }
+    GST_LOG_OBJECT (adapter, "unmapped %u chunks", adapter->vmap_infos->len);
+    g_array_set_size (adapter->vmap_infos, 0);
+    g_array_set_size (adapter->vmap_readers, 0);
+  }
 }
 
 /**
@@ -633,7 +757,7 @@ gst_adapter_flush_unchecked (GstAdapter * adapter, gsize flush)
 
   GST_LOG_OBJECT (adapter, "flushing %" G_GSIZE_FORMAT " bytes", flush);
 
-  if (adapter->info.memory)
+  if (ADAPTER_IS_MAPPED (adapter))
     gst_adapter_unmap (adapter);
 
   /* clear state */
@@ -23,6 +23,7 @@
 #define __GST_ADAPTER_H__
 
 #include <gst/base/base-prelude.h>
+#include <gst/base/gstbytereader.h>
 
 G_BEGIN_DECLS
 
@@ -63,6 +64,9 @@ void                    gst_adapter_push                (GstAdapter *adapter, Gs
 GST_BASE_API
 gconstpointer           gst_adapter_map                 (GstAdapter *adapter, gsize size);
 
+GST_BASE_API
+const GstByteReader *   gst_adapter_map_vectored        (GstAdapter *adapter, gsize offset,
+                                                         gsize size, guint *n_chunks);
 GST_BASE_API
 void                    gst_adapter_unmap               (GstAdapter *adapter);
 
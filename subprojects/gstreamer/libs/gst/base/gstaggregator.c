@@ -1534,6 +1534,30 @@ gst_aggregator_stop_srcpad_task (GstAggregator * self, GstEvent * flush_start)
   return res;
 }
 
+/* apply the task affinity context, if any, to the srcpad task */
+static void
+gst_aggregator_update_task_affinity (GstAggregator * self)
+{
+  GstContext *context;
+  GstTask *task = NULL;
+
+  context = gst_element_get_context (GST_ELEMENT_CAST (self),
+      GST_TASK_AFFINITY_CONTEXT_TYPE);
+  if (context == NULL)
+    return;
+
+  GST_OBJECT_LOCK (self->srcpad);
+  if (GST_PAD_TASK (self->srcpad))
+    task = gst_object_ref (GST_PAD_TASK (self->srcpad));
+  GST_OBJECT_UNLOCK (self->srcpad);
+
+  if (task) {
+    gst_task_set_affinity_from_context (task, context);
+    gst_object_unref (task);
+  }
+  gst_context_unref (context);
+}
+
 static void
 gst_aggregator_start_srcpad_task (GstAggregator * self)
 {
@@ -1542,6 +1566,16 @@ gst_aggregator_start_srcpad_task (GstAggregator * self)
   self->priv->running = TRUE;
   gst_pad_start_task (GST_PAD (self->srcpad),
       (GstTaskFunction) gst_aggregator_aggregate_func, self, NULL);
+  gst_aggregator_update_task_affinity (self);
+}
+
+static void
+gst_aggregator_set_context (GstElement * element, GstContext * context)
+{
+  GST_ELEMENT_CLASS (aggregator_parent_class)->set_context (element, context);
+
+  if (gst_context_has_context_type (context, GST_TASK_AFFINITY_CONTEXT_TYPE))
+    gst_aggregator_update_task_affinity (GST_AGGREGATOR (element));
 }
 
 static GstFlowReturn
@@ -2861,6 +2895,8 @@ gst_aggregator_class_init (GstAggregatorClass * klass)
       GST_DEBUG_FUNCPTR (gst_aggregator_release_pad);
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_aggregator_change_state);
+  gstelement_class->set_context =
+      GST_DEBUG_FUNCPTR (gst_aggregator_set_context);
 
   gobject_class->set_property = gst_aggregator_set_property;
   gobject_class->get_property = gst_aggregator_get_property;
@@ -3143,6 +3179,13 @@ gst_aggregator_pad_chain_internal (GstAggregator * self,
 
     if ((gst_aggregator_pad_has_space (self, aggpad) || !head)
         && aggpad->priv->flow_return == GST_FLOW_OK) {
+      /* Readiness of the pads only depends on the oldest queued item, so
+       * the src thread only needs to be woken up if this buffer becomes
+       * the oldest one. This avoids one wakeup and clock unschedule per
+       * buffer when upstream runs ahead */
+      gboolean need_wakeup = !head
+          || gst_aggregator_pad_queue_is_empty (aggpad);
+
       if (head) {
         GST_DEBUG_OBJECT (aggpad, "Enqueuing %" GST_PTR_FORMAT, buffer);
         g_queue_push_head (&aggpad->priv->data, buffer);
@@ -3152,7 +3195,8 @@ gst_aggregator_pad_chain_internal (GstAggregator * self,
       apply_buffer (aggpad, buffer, head);
       aggpad->priv->num_buffers++;
       buffer = NULL;
-      SRC_BROADCAST (self);
+      if (need_wakeup)
+        SRC_BROADCAST (self);
       break;
     }
 
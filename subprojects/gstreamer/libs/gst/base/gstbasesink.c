@@ -278,6 +278,11 @@ struct _GstBaseSinkPrivate
   gsize rc_accumulated;
 
   gboolean drop_out_of_segment;
+
+  /* presentation feedback from the subclass, running time of the last
+   * presented frame and the output refresh interval. Protected by LOCK */
+  GstClockTime presentation_time;
+  GstClockTime refresh_interval;
 };
 
 #define DO_RUNNING_AVG(avg,val,size) (((val) + ((size)-1) * (avg)) / (size))
@@ -717,6 +722,8 @@ gst_base_sink_init (GstBaseSink * basesink, gpointer g_class)
   priv->async_enabled = DEFAULT_ASYNC;
   priv->ts_offset = DEFAULT_TS_OFFSET;
   priv->render_delay = DEFAULT_RENDER_DELAY;
+  priv->presentation_time = GST_CLOCK_TIME_NONE;
+  priv->refresh_interval = GST_CLOCK_TIME_NONE;
   priv->processing_deadline = DEFAULT_PROCESSING_DEADLINE;
   priv->blocksize = DEFAULT_BLOCKSIZE;
   priv->cached_clock_id = NULL;
@@ -1558,6 +1565,44 @@ gst_base_sink_get_processing_deadline (GstBaseSink * sink)
   return res;
 }
 
+/**
+ * gst_base_sink_set_presentation_feedback:
+ * @sink: a #GstBaseSink
+ * @presentation_time: the running time at which the last frame was actually
+ *   presented, or %GST_CLOCK_TIME_NONE
+ * @refresh_interval: the refresh interval of the output, or
+ *   %GST_CLOCK_TIME_NONE
+ *
+ * Reports when the last frame was presented by the output device and its
+ * refresh interval, e.g. from a vblank or page flip event. Sinks that wait for
+ * the next refresh cycle after submitting a frame should call this after each
+ * presentation.
+ *
+ * When presentation feedback is available, @sink does not wait on the clock
+ * until the running time of a buffer anymore but until the refresh cycle
+ * before the one closest to it, so that the frame is displayed at the refresh
+ * cycle that is closest to its running time instead of the one after it.
+ *
+ * Passing %GST_CLOCK_TIME_NONE for either value disables this again.
+ *
+ * Since: 1.24
+ */
+void
+gst_base_sink_set_presentation_feedback (GstBaseSink * sink,
+    GstClockTime presentation_time, GstClockTime refresh_interval)
+{
+  g_return_if_fail (GST_IS_BASE_SINK (sink));
+
+  GST_OBJECT_LOCK (sink);
+  sink->priv->presentation_time = presentation_time;
+  sink->priv->refresh_interval = refresh_interval;
+  GST_OBJECT_UNLOCK (sink);
+
+  GST_LOG_OBJECT (sink, "presented at %" GST_TIME_FORMAT ", refresh interval %"
+      GST_TIME_FORMAT, GST_TIME_ARGS (presentation_time),
+      GST_TIME_ARGS (refresh_interval));
+}
+
 static void
 gst_base_sink_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec)
@@ -2302,6 +2347,48 @@ gst_base_sink_adjust_time (GstBaseSink * basesink, GstClockTime time)
   return time;
 }
 
+/* with STREAM_LOCK, PREROLL_LOCK
+ * Moves @time to the start of the refresh cycle preceding the one closest to
+ * @time, so that a sink waiting for the next refresh after rendering presents
+ * the frame as close as possible to @time. */
+static GstClockTime
+gst_base_sink_align_to_refresh (GstBaseSink * basesink, GstClockTime time)
+{
+  GstClockTime presentation_time, refresh_interval;
+  guint64 cycles;
+
+  if (G_UNLIKELY (!GST_CLOCK_TIME_IS_VALID (time)))
+    return time;
+
+  GST_OBJECT_LOCK (basesink);
+  presentation_time = basesink->priv->presentation_time;
+  refresh_interval = basesink->priv->refresh_interval;
+  GST_OBJECT_UNLOCK (basesink);
+
+  if (!GST_CLOCK_TIME_IS_VALID (presentation_time) ||
+      !GST_CLOCK_TIME_IS_VALID (refresh_interval) || refresh_interval == 0)
+    return time;
+
+  /* refresh cycles can't be predicted reliably from old feedback */
+  if (time <= presentation_time || time - presentation_time > GST_SECOND)
+    return time;
+
+  cycles = (time - presentation_time + refresh_interval / 2) /
+      refresh_interval;
+  if (cycles == 0)
+    return time;
+
+  return presentation_time + (cycles - 1) * refresh_interval;
+}
+
+static void
+gst_base_sink_reset_presentation_feedback (GstBaseSink * basesink)
+{
+  GST_OBJECT_LOCK (basesink);
+  basesink->priv->presentation_time = GST_CLOCK_TIME_NONE;
+  GST_OBJECT_UNLOCK (basesink);
+}
+
 /**
  * gst_base_sink_wait_clock:
  * @sink: the sink
@@ -2665,7 +2752,7 @@ gst_base_sink_do_sync (GstBaseSink * basesink,
   GstClockTimeDiff jitter = 0;
   gboolean syncable;
   GstClockReturn status = GST_CLOCK_OK;
-  GstClockTime rstart, rstop, rnext, sstart, sstop, stime;
+  GstClockTime rstart, rstop, rnext, sstart, sstop, stime, wtime;
   gboolean do_sync;
   GstBaseSinkPrivate *priv;
   GstFlowReturn ret;
@@ -2779,14 +2866,22 @@ again:
     stime = priv->rc_next;
   }
 
+  /* adjust for the refresh cycle reported by the subclass */
+  wtime = gst_base_sink_align_to_refresh (basesink, stime);
+
   /* preroll done, we can sync since we are in PLAYING now. */
   GST_DEBUG_OBJECT (basesink, "possibly waiting for clock to reach %"
-      GST_TIME_FORMAT ", adjusted %" GST_TIME_FORMAT,
-      GST_TIME_ARGS (rstart), GST_TIME_ARGS (stime));
+      GST_TIME_FORMAT ", adjusted %" GST_TIME_FORMAT ", wait until %"
+      GST_TIME_FORMAT, GST_TIME_ARGS (rstart), GST_TIME_ARGS (stime),
+      GST_TIME_ARGS (wtime));
 
   /* This function will return immediately if start == -1, no clock
    * or sync is disabled with GST_CLOCK_BADTIME. */
-  status = gst_base_sink_wait_clock (basesink, stime, &jitter);
+  status = gst_base_sink_wait_clock (basesink, wtime, &jitter);
+
+  /* the jitter is relative to the buffer's time, not to the refresh cycle */
+  if (wtime != stime)
+    jitter -= GST_CLOCK_DIFF (wtime, stime);
 
   GST_DEBUG_OBJECT (basesink, "clock returned %d, jitter %c%" GST_TIME_FORMAT,
       status, (jitter < 0 ? '-' : ' '), GST_TIME_ARGS (ABS (jitter)));
@@ -3232,6 +3327,7 @@ gst_base_sink_flush_start (GstBaseSink * basesink, GstPad * pad)
    * anymore */
   GST_PAD_STREAM_LOCK (pad);
   gst_base_sink_reset_qos (basesink);
+  gst_base_sink_reset_presentation_feedback (basesink);
   /* and we need to commit our state again on the next
    * prerolled buffer */
   basesink->playing_async = TRUE;
@@ -5683,6 +5779,7 @@ gst_base_sink_change_state (GstElement * element, GstStateChange transition)
       basesink->eos = FALSE;
       priv->received_eos = FALSE;
       gst_base_sink_reset_qos (basesink);
+      gst_base_sink_reset_presentation_feedback (basesink);
       priv->rc_next = -1;
       priv->committed = FALSE;
       priv->call_preroll = TRUE;
@@ -328,6 +328,12 @@ void            gst_base_sink_set_processing_deadline  (GstBaseSink *sink, GstCl
 GST_BASE_API
 GstClockTime    gst_base_sink_get_processing_deadline  (GstBaseSink *sink);
 
+/* presentation feedback */
+GST_BASE_API
+void            gst_base_sink_set_presentation_feedback (GstBaseSink *sink,
+                                                         GstClockTime presentation_time,
+                                                         GstClockTime refresh_interval);
+
 GST_BASE_API
 GstClockReturn  gst_base_sink_wait_clock        (GstBaseSink *sink, GstClockTime time,
                                                  GstClockTimeDiff * jitter);
@@ -1679,8 +1679,11 @@ default_prepare_output_buffer (GstBaseTransform * trans,
       *outbuf = inbuf;
     } else {
       GST_DEBUG_OBJECT (trans, "making writable buffer copy");
-      /* we make a copy of the input buffer */
-      *outbuf = gst_buffer_copy (inbuf);
+      /* we make a copy of the input buffer that shares the memory. Memory
+       * that the transform maps for writing is copied at that point, so
+       * elements that only change the metadata never copy the data. Buffers
+       * with NO_SHARE memory get a regular gst_buffer_copy() as before */
+      *outbuf = gst_buffer_make_metadata_writable (gst_buffer_ref (inbuf));
     }
     goto done;
   }
@@ -2290,7 +2293,7 @@ gst_base_transform_getrange (GstPad * pad, GstObject * parent, guint64 offset,
       GST_DEBUG_OBJECT (trans, "we have a pending DISCONT");
       if (!GST_BUFFER_IS_DISCONT (outbuf)) {
         GST_DEBUG_OBJECT (trans, "marking DISCONT on output buffer");
-        outbuf = gst_buffer_make_writable (outbuf);
+        outbuf = gst_buffer_make_metadata_writable (outbuf);
         GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
       }
       priv->discont = FALSE;
@@ -2381,7 +2384,7 @@ gst_base_transform_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
           GST_DEBUG_OBJECT (trans, "we have a pending DISCONT");
           if (!GST_BUFFER_IS_DISCONT (outbuf)) {
             GST_DEBUG_OBJECT (trans, "marking DISCONT on output buffer");
-            outbuf = gst_buffer_make_writable (outbuf);
+            outbuf = gst_buffer_make_metadata_writable (outbuf);
             GST_BUFFER_FLAG_SET (outbuf, GST_BUFFER_FLAG_DISCONT);
           }
           priv->discont = FALSE;
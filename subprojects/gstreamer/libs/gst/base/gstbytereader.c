@@ -29,6 +29,15 @@
 #include "gst/glib-compat-private.h"
 #include <string.h>
 
+#if defined (__SSE2__) || defined (_M_X64) || \
+    (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_START_CODE_SSE2
+#include <emmintrin.h>
+#elif defined (__ARM_NEON) && defined (__GNUC__)
+#define HAVE_START_CODE_NEON
+#include <arm_neon.h>
+#endif
+
 /**
  * SECTION:gstbytereader
  * @title: GstByteReader
@@ -862,12 +871,70 @@ gst_byte_reader_dup_data (GstByteReader * reader, guint size, guint8 ** val)
   return _gst_byte_reader_dup_data_inline (reader, size, val);
 }
 
+/* Vector part of the start code scan. Tests 16 candidate positions at once
+ * by comparing the data at offsets 0, 1 and 2 against 00 00 01, and returns
+ * how far it got or the position of the first match in @found. Every
+ * position it tests needs 4 bytes of data, like in the scalar loop. Only
+ * instruction sets that are part of the base ABI are used, so no runtime
+ * detection is needed. */
+static inline guint
+_scan_for_start_code_simd (const guint8 * data, guint size, gint * found)
+{
+  guint i = 0;
+
+#if defined (HAVE_START_CODE_SSE2)
+  const __m128i zero = _mm_setzero_si128 ();
+  const __m128i one = _mm_set1_epi8 (1);
+
+  for (; i + 19 <= size; i += 16) {
+    __m128i v0 = _mm_loadu_si128 ((const __m128i *) (data + i));
+    __m128i v1 = _mm_loadu_si128 ((const __m128i *) (data + i + 1));
+    __m128i v2 = _mm_loadu_si128 ((const __m128i *) (data + i + 2));
+    __m128i eq = _mm_and_si128 (_mm_and_si128 (_mm_cmpeq_epi8 (v0, zero),
+            _mm_cmpeq_epi8 (v1, zero)), _mm_cmpeq_epi8 (v2, one));
+    guint mask = _mm_movemask_epi8 (eq);
+
+    if (G_UNLIKELY (mask)) {
+      *found = i + g_bit_nth_lsf (mask, -1);
+      return i;
+    }
+  }
+#elif defined (HAVE_START_CODE_NEON)
+  const uint8x16_t zero = vdupq_n_u8 (0);
+  const uint8x16_t one = vdupq_n_u8 (1);
+
+  for (; i + 19 <= size; i += 16) {
+    uint8x16_t v0 = vld1q_u8 (data + i);
+    uint8x16_t v1 = vld1q_u8 (data + i + 1);
+    uint8x16_t v2 = vld1q_u8 (data + i + 2);
+    uint8x16_t eq = vandq_u8 (vandq_u8 (vceqq_u8 (v0, zero),
+            vceqq_u8 (v1, zero)), vceqq_u8 (v2, one));
+    /* narrow to 4 bits per byte to get a scalar mask */
+    guint64 mask = vget_lane_u64 (vreinterpret_u64_u8 (vshrn_n_u16
+            (vreinterpretq_u16_u8 (eq), 4)), 0);
+
+    if (G_UNLIKELY (mask)) {
+      *found = i + (__builtin_ctzll (mask) >> 2);
+      return i;
+    }
+  }
+#endif
+
+  *found = -1;
+  return i;
+}
+
 /* Special optimized scan for mask 0xffffff00 and pattern 0x00000100 */
 static inline gint
 _scan_for_start_code (const guint8 * data, guint size)
 {
-  guint8 *pdata = (guint8 *) data;
+  guint8 *pdata;
   guint8 *pend = (guint8 *) (data + size - 4);
+  gint found;
+
+  pdata = (guint8 *) data + _scan_for_start_code_simd (data, size, &found);
+  if (found != -1)
+    return found;
 
   while (pdata <= pend) {
     if (pdata[2] > 1) {
@@ -105,6 +105,53 @@ _get_nearest_control_points2 (GstTimedValueControlSource * self,
   }
 }
 
+/* Fills @n_values values that all lie between @cp1 and @cp2 */
+typedef void (*InterpolateSegmentFunc) (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values);
+
+/* Splits the requested range at the control points, so that the values
+ * of each segment are computed in one tight loop without lookups */
+static inline gboolean
+_get_value_array (GstTimedValueControlSource * self, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values,
+    InterpolateSegmentFunc interpolate_segment)
+{
+  gboolean ret = FALSE;
+  GstClockTime ts = timestamp;
+  GstClockTime next_ts;
+  GstControlPoint *cp1, *cp2;
+  guint i, n;
+
+  g_mutex_lock (&self->lock);
+
+  while (n_values > 0) {
+    _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
+
+    n = n_values;
+    if (GST_CLOCK_TIME_IS_VALID (next_ts) && interval > 0)
+      n = MIN (n, (next_ts - ts + interval - 1) / interval);
+
+    GST_LOG ("%u values from ts=%" GST_TIME_FORMAT " before next_ts=%"
+        GST_TIME_FORMAT, n, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
+
+    if (cp1) {
+      interpolate_segment (self, cp1, cp2, ts, interval, n, values);
+      ret = TRUE;
+    } else {
+      for (i = 0; i < n; i++)
+        values[i] = NAN;
+    }
+
+    ts += n * interval;
+    values += n;
+    n_values -= n;
+  }
+
+  g_mutex_unlock (&self->lock);
+  return ret;
+}
+
 
 /*  steps-like (no-)interpolation, default */
 /*  just returns the value for the most recent key-frame */
@@ -135,38 +182,24 @@ interpolate_none_get (GstTimedValueControlSource * self, GstClockTime timestamp,
   return ret;
 }
 
+static void
+_interpolate_none_segment (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values)
+{
+  guint i;
+
+  for (i = 0; i < n_values; i++)
+    values[i] = cp1->value;
+}
+
 static gboolean
 interpolate_none_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_none (self, cp1);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array (self, timestamp, interval, n_values, values,
+      _interpolate_none_segment);
 }
 
 
@@ -207,40 +240,36 @@ interpolate_linear_get (GstTimedValueControlSource * self,
   return ret;
 }
 
+static void
+_interpolate_linear_segment (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values)
+{
+  gdouble offset, step, slope;
+  guint i;
+
+  if (!cp2) {
+    for (i = 0; i < n_values; i++)
+      values[i] = cp1->value;
+    return;
+  }
+
+  slope = (cp2->value - cp1->value) /
+      gst_guint64_to_gdouble (cp2->timestamp - cp1->timestamp);
+  offset = gst_guint64_to_gdouble (timestamp - cp1->timestamp);
+  step = gst_guint64_to_gdouble (interval);
+
+  for (i = 0; i < n_values; i++)
+    values[i] = cp1->value + ((offset + i * step) * slope);
+}
+
 static gboolean
 interpolate_linear_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_linear (cp1->timestamp, cp1->value,
-          (cp2 ? cp2->timestamp : GST_CLOCK_TIME_NONE),
-          (cp2 ? cp2->value : 0.0), ts);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array (self, timestamp, interval, n_values, values,
+      _interpolate_linear_segment);
 }
 
 
@@ -392,43 +421,55 @@ interpolate_cubic_get (GstTimedValueControlSource * self,
   return ret;
 }
 
+static void
+_interpolate_cubic_segment (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values)
+{
+  gdouble offset, step, span, h, z1, z2, a, b;
+  guint i;
+
+  if (!self->valid_cache) {
+    _interpolate_cubic_update_cache (self);
+    self->valid_cache = TRUE;
+  }
+
+  if (!cp2) {
+    for (i = 0; i < n_values; i++)
+      values[i] = cp1->value;
+    return;
+  }
+
+  offset = gst_guint64_to_gdouble (timestamp - cp1->timestamp);
+  step = gst_guint64_to_gdouble (interval);
+  span = gst_guint64_to_gdouble (cp2->timestamp - cp1->timestamp);
+  h = cp1->cache.cubic.h;
+  z1 = cp1->cache.cubic.z;
+  z2 = cp2->cache.cubic.z;
+  a = cp2->value / h - h * z2;
+  b = cp1->value / h - h * z1;
+
+  /* same as _interpolate_cubic() with the per segment terms hoisted */
+  for (i = 0; i < n_values; i++) {
+    gdouble diff1 = offset + i * step;
+    gdouble diff2 = span - diff1;
+
+    values[i] = (z2 * diff1 * diff1 * diff1 + z1 * diff2 * diff2 * diff2) / h
+        + a * diff1 + b * diff2;
+  }
+}
+
 static gboolean
 interpolate_cubic_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
   if (self->nvalues <= 2)
     return interpolate_linear_get_value_array (self, timestamp, interval,
         n_values, values);
 
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_cubic (self, cp1, cp1->value, cp2,
-          (cp2 ? cp2->value : 0.0), ts);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array (self, timestamp, interval, n_values, values,
+      _interpolate_cubic_segment);
 }
 
 
@@ -561,43 +602,50 @@ interpolate_cubic_monotonic_get (GstTimedValueControlSource * self,
   return ret;
 }
 
+static void
+_interpolate_cubic_monotonic_segment (GstTimedValueControlSource * self,
+    GstControlPoint * cp1, GstControlPoint * cp2, GstClockTime timestamp,
+    GstClockTime interval, guint n_values, gdouble * values)
+{
+  gdouble offset, step, c1, c2, c3;
+  guint i;
+
+  if (!self->valid_cache) {
+    _interpolate_cubic_monotonic_update_cache (self);
+    self->valid_cache = TRUE;
+  }
+
+  if (!cp2) {
+    for (i = 0; i < n_values; i++)
+      values[i] = cp1->value;
+    return;
+  }
+
+  offset = gst_guint64_to_gdouble (timestamp - cp1->timestamp);
+  step = gst_guint64_to_gdouble (interval);
+  c1 = cp1->cache.cubic_monotonic.c1s;
+  c2 = cp1->cache.cubic_monotonic.c2s;
+  c3 = cp1->cache.cubic_monotonic.c3s;
+
+  for (i = 0; i < n_values; i++) {
+    gdouble diff = offset + i * step;
+    gdouble diff2 = diff * diff;
+
+    values[i] = cp1->value + c1 * diff + c2 * diff2 + c3 * diff * diff2;
+  }
+}
+
 static gboolean
 interpolate_cubic_monotonic_get_value_array (GstTimedValueControlSource * self,
     GstClockTime timestamp, GstClockTime interval, guint n_values,
     gdouble * values)
 {
-  gboolean ret = FALSE;
-  guint i;
-  GstClockTime ts = timestamp;
-  GstClockTime next_ts = 0;
-  GstControlPoint *cp1 = NULL, *cp2 = NULL;
-
   if (self->nvalues <= 2)
     return interpolate_linear_get_value_array (self, timestamp, interval,
         n_values, values);
 
-  g_mutex_lock (&self->lock);
-
-  for (i = 0; i < n_values; i++) {
-    GST_LOG ("values[%3d] : ts=%" GST_TIME_FORMAT ", next_ts=%" GST_TIME_FORMAT,
-        i, GST_TIME_ARGS (ts), GST_TIME_ARGS (next_ts));
-    if (ts >= next_ts) {
-      _get_nearest_control_points2 (self, ts, &cp1, &cp2, &next_ts);
-    }
-    if (cp1) {
-      *values = _interpolate_cubic_monotonic (self, cp1, cp1->value, cp2,
-          (cp2 ? cp2->value : 0.0), ts);
-      ret = TRUE;
-      GST_LOG ("values[%3d]=%lf", i, *values);
-    } else {
-      *values = NAN;
-      GST_LOG ("values[%3d]=-", i);
-    }
-    ts += interval;
-    values++;
-  }
-  g_mutex_unlock (&self->lock);
-  return ret;
+  return _get_value_array (self, timestamp, interval, n_values, values,
+      _interpolate_cubic_monotonic_segment);
 }
 
 
@@ -52,9 +52,18 @@ GST_DEBUG_CATEGORY_STATIC (GST_CAT_DEFAULT);
   GST_DEBUG_CATEGORY_INIT (GST_CAT_DEFAULT, "timed value control source", 0, \
     "timed value control source base class")
 
+struct _GstTimedValueControlSourcePrivate
+{
+  /* control point found by the last lookup, so that sequential lookups
+   * don't need to search the whole sequence. Protected by the lock and
+   * reset whenever control points are added or removed */
+  GSequenceIter *cursor;
+};
+
 #define gst_timed_value_control_source_parent_class parent_class
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (GstTimedValueControlSource,
-    gst_timed_value_control_source, GST_TYPE_CONTROL_SOURCE, _do_init);
+    gst_timed_value_control_source, GST_TYPE_CONTROL_SOURCE,
+    G_ADD_PRIVATE (GstTimedValueControlSource) _do_init);
 
 
 enum
@@ -125,6 +134,7 @@ gst_timed_value_control_source_reset (GstTimedValueControlSource * self)
     self->values = NULL;
   }
 
+  self->priv->cursor = NULL;
   self->nvalues = 0;
   self->valid_cache = FALSE;
 }
@@ -211,6 +221,7 @@ gst_timed_value_control_source_set_internal (GstTimedValueControlSource *
   cp = _make_new_cp (self, timestamp, value);
   g_sequence_insert_sorted (self->values, cp,
       (GCompareDataFunc) gst_control_point_compare, NULL);
+  self->priv->cursor = NULL;
   self->nvalues++;
   g_mutex_unlock (&self->lock);
 
@@ -230,18 +241,35 @@ done:
  * If all values in the control point list come after the given
  * timestamp or no values exist, %NULL is returned.
  *
- * For use in control source implementations.
+ * For use in control source implementations, with the
+ * GST_TIMED_VALUE_CONTROL_SOURCE_LOCK() taken.
  *
  * Returns: (transfer none) (nullable): the found #GSequenceIter or %NULL
  */
 GSequenceIter *gst_timed_value_control_source_find_control_point_iter
     (GstTimedValueControlSource * self, GstClockTime timestamp)
 {
-  GSequenceIter *iter;
+  GSequenceIter *iter, *next;
+  guint i;
 
   if (!self->values)
     return NULL;
 
+  /* Values are usually requested with increasing timestamps, so first check
+   * if the timestamp is still in the segment of the previous lookup or
+   * in the one right after it */
+  iter = self->priv->cursor;
+  if (iter && ((GstControlPoint *) g_sequence_get (iter))->timestamp <=
+      timestamp) {
+    for (i = 0; i < 2; i++) {
+      next = g_sequence_iter_next (iter);
+      if (g_sequence_iter_is_end (next)
+          || ((GstControlPoint *) g_sequence_get (next))->timestamp > timestamp)
+        return self->priv->cursor = iter;
+      iter = next;
+    }
+  }
+
   iter =
       g_sequence_search (self->values, &timestamp,
       (GCompareDataFunc) gst_control_point_find, NULL);
@@ -253,7 +281,7 @@ GSequenceIter *gst_timed_value_control_source_find_control_point_iter
   if (g_sequence_iter_is_begin (iter))
     return NULL;
 
-  return g_sequence_iter_prev (iter);
+  return self->priv->cursor = g_sequence_iter_prev (iter);
 }
 
 
@@ -345,6 +373,7 @@ gst_timed_value_control_source_unset (GstTimedValueControlSource * self,
      */
     cp = g_memdup2 (g_sequence_get (iter), sizeof (GstControlPoint));
     g_sequence_remove (iter);
+    self->priv->cursor = NULL;
     self->nvalues--;
     self->valid_cache = FALSE;
     res = TRUE;
@@ -378,6 +407,7 @@ gst_timed_value_control_source_unset_all (GstTimedValueControlSource * self)
     g_sequence_free (self->values);
     self->values = NULL;
   }
+  self->priv->cursor = NULL;
   self->nvalues = 0;
   self->valid_cache = FALSE;
 
@@ -446,6 +476,7 @@ gst_timed_value_control_invalidate_cache (GstTimedValueControlSource * self)
 static void
 gst_timed_value_control_source_init (GstTimedValueControlSource * self)
 {
+  self->priv = gst_timed_value_control_source_get_instance_private (self);
   g_mutex_init (&self->lock);
 }
 
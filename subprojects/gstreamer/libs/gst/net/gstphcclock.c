@@ -0,0 +1,392 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:gstphcclock
+ * @title: GstPhcClock
+ * @short_description: Special clock that reads the time of a PTP hardware
+ *                     clock
+ * @see_also: #GstClock, #GstPtpClock, #GstPipeline
+ *
+ * GstPhcClock provides the time of a PTP hardware clock (PHC) of a network
+ * interface, as exposed by Linux via the `/dev/ptpN` devices.
+ *
+ * Unlike #GstPtpClock, which runs the PTP protocol with software timestamps
+ * and estimates the remote time from them, GstPhcClock does not implement
+ * PTP itself. The PHC is expected to be disciplined to the PTP network by
+ * another daemon, such as ptp4l from linuxptp, using the hardware
+ * timestamps of the network interface. This allows for sub-microsecond
+ * accuracy, as required by SMPTE ST 2110 or AES67.
+ *
+ * Reading the time is a single clock_gettime() call on the device and
+ * involves no communication with other processes. The clock reports the
+ * time of the PHC, which is usually in the TAI timescale.
+ *
+ * gst_phc_clock_new() creates the clock for a PHC device and
+ * gst_phc_clock_new_for_interface() for the PHC of a network interface.
+ *
+ * Since: 1.24
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "gstphcclock.h"
+
+#if defined(__linux__) && defined(HAVE_LINUX_PTP_CLOCK_H)
+#define HAVE_PHC 1
+#endif
+
+#ifdef HAVE_PHC
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <linux/ethtool.h>
+#include <linux/ptp_clock.h>
+#include <linux/sockios.h>
+
+/* see clock_getres(2) */
+#define FD_TO_CLOCKID(fd) ((~(clockid_t) (fd) << 3) | 3)
+#endif
+
+GST_DEBUG_CATEGORY_STATIC (phc_debug);
+#define GST_CAT_DEFAULT (phc_debug)
+
+enum
+{
+  PROP_0,
+  PROP_DEVICE,
+  PROP_INTERFACE,
+};
+
+struct _GstPhcClockPrivate
+{
+  gchar *device;
+  gchar *interface;
+
+  gint fd;
+#ifdef HAVE_PHC
+  clockid_t clock_id;
+#endif
+};
+
+#define gst_phc_clock_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstPhcClock, gst_phc_clock, GST_TYPE_SYSTEM_CLOCK,
+    G_ADD_PRIVATE (GstPhcClock)
+    GST_DEBUG_CATEGORY_INIT (phc_debug, "phcclock", 0, "PHC clock"));
+
+static void gst_phc_clock_constructed (GObject * object);
+static void gst_phc_clock_finalize (GObject * object);
+static void gst_phc_clock_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_phc_clock_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+static GstClockTime gst_phc_clock_get_internal_time (GstClock * clock);
+
+static void
+gst_phc_clock_class_init (GstPhcClockClass * klass)
+{
+  GObjectClass *gobject_class;
+  GstClockClass *clock_class;
+
+  gobject_class = G_OBJECT_CLASS (klass);
+  clock_class = GST_CLOCK_CLASS (klass);
+
+  gobject_class->constructed = gst_phc_clock_constructed;
+  gobject_class->finalize = gst_phc_clock_finalize;
+  gobject_class->get_property = gst_phc_clock_get_property;
+  gobject_class->set_property = gst_phc_clock_set_property;
+
+  /**
+   * GstPhcClock:device:
+   *
+   * The PTP hardware clock device to read the time from, e.g. `/dev/ptp0`.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_DEVICE,
+      g_param_spec_string ("device", "Device",
+          "The PTP hardware clock device", NULL,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstPhcClock:interface:
+   *
+   * Network interface whose PTP hardware clock is used if no
+   * #GstPhcClock:device is set.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_INTERFACE,
+      g_param_spec_string ("interface", "Interface",
+          "Network interface whose PTP hardware clock is used", NULL,
+          G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
+
+  clock_class->get_internal_time = gst_phc_clock_get_internal_time;
+}
+
+static void
+gst_phc_clock_init (GstPhcClock * self)
+{
+  self->priv = gst_phc_clock_get_instance_private (self);
+  self->priv->fd = -1;
+}
+
+#ifdef HAVE_PHC
+static gchar *
+gst_phc_clock_find_device (GstPhcClock * self, const gchar * interface)
+{
+  struct ethtool_ts_info info = { 0, };
+  struct ifreq ifr = { 0, };
+  gint sock;
+
+  sock = socket (AF_INET, SOCK_DGRAM, 0);
+  if (sock < 0) {
+    GST_ERROR_OBJECT (self, "Failed to create socket: %s", g_strerror (errno));
+    return NULL;
+  }
+
+  info.cmd = ETHTOOL_GET_TS_INFO;
+  g_strlcpy (ifr.ifr_name, interface, sizeof (ifr.ifr_name));
+  ifr.ifr_data = (gpointer) & info;
+
+  if (ioctl (sock, SIOCETHTOOL, &ifr) < 0) {
+    GST_ERROR_OBJECT (self, "Failed to get timestamping info of %s: %s",
+        interface, g_strerror (errno));
+    close (sock);
+    return NULL;
+  }
+  close (sock);
+
+  if (info.phc_index < 0) {
+    GST_ERROR_OBJECT (self, "Interface %s has no PTP hardware clock",
+        interface);
+    return NULL;
+  }
+
+  if (!(info.so_timestamping & SOF_TIMESTAMPING_RAW_HARDWARE))
+    GST_WARNING_OBJECT (self, "Interface %s does not provide hardware "
+        "timestamps, the PTP daemon will not be able to use the PHC",
+        interface);
+
+  return g_strdup_printf ("/dev/ptp%d", info.phc_index);
+}
+#endif
+
+static void
+gst_phc_clock_constructed (GObject * object)
+{
+  GstPhcClock *self = GST_PHC_CLOCK (object);
+  GstPhcClockPrivate *priv = self->priv;
+#ifdef HAVE_PHC
+  struct timespec ts;
+#endif
+
+  G_OBJECT_CLASS (parent_class)->constructed (object);
+
+#ifdef HAVE_PHC
+  if (!priv->device && priv->interface)
+    priv->device = gst_phc_clock_find_device (self, priv->interface);
+
+  if (!priv->device) {
+    GST_ERROR_OBJECT (self, "No PTP hardware clock device");
+    return;
+  }
+
+  priv->fd = open (priv->device, O_RDONLY | O_CLOEXEC);
+  if (priv->fd < 0) {
+    GST_ERROR_OBJECT (self, "Failed to open %s: %s", priv->device,
+        g_strerror (errno));
+    return;
+  }
+  priv->clock_id = FD_TO_CLOCKID (priv->fd);
+
+  if (clock_gettime (priv->clock_id, &ts) < 0) {
+    GST_ERROR_OBJECT (self, "Failed to read the time of %s: %s", priv->device,
+        g_strerror (errno));
+    close (priv->fd);
+    priv->fd = -1;
+    return;
+  }
+
+  GST_INFO_OBJECT (self, "Using PTP hardware clock %s", priv->device);
+#else
+  GST_ERROR_OBJECT (self, "PTP hardware clocks are not supported");
+#endif
+}
+
+static void
+gst_phc_clock_finalize (GObject * object)
+{
+  GstPhcClock *self = GST_PHC_CLOCK (object);
+
+#ifdef HAVE_PHC
+  if (self->priv->fd >= 0)
+    close (self->priv->fd);
+#endif
+  g_free (self->priv->device);
+  g_free (self->priv->interface);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
+}
+
+static void
+gst_phc_clock_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstPhcClock *self = GST_PHC_CLOCK (object);
+
+  switch (prop_id) {
+    case PROP_DEVICE:
+      g_free (self->priv->device);
+      self->priv->device = g_value_dup_string (value);
+      break;
+    case PROP_INTERFACE:
+      g_free (self->priv->interface);
+      self->priv->interface = g_value_dup_string (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static void
+gst_phc_clock_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec)
+{
+  GstPhcClock *self = GST_PHC_CLOCK (object);
+
+  switch (prop_id) {
+    case PROP_DEVICE:
+      g_value_set_string (value, self->priv->device);
+      break;
+    case PROP_INTERFACE:
+      g_value_set_string (value, self->priv->interface);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+}
+
+static GstClockTime
+gst_phc_clock_get_internal_time (GstClock * clock)
+{
+#ifdef HAVE_PHC
+  GstPhcClock *self = GST_PHC_CLOCK (clock);
+  struct timespec ts;
+
+  if (G_UNLIKELY (self->priv->fd < 0))
+    return GST_CLOCK_TIME_NONE;
+
+  if (G_UNLIKELY (clock_gettime (self->priv->clock_id, &ts) < 0)) {
+    GST_ERROR_OBJECT (self, "Failed to read the time: %s", g_strerror (errno));
+    return GST_CLOCK_TIME_NONE;
+  }
+
+  return GST_TIMESPEC_TO_TIME (ts);
+#else
+  return GST_CLOCK_TIME_NONE;
+#endif
+}
+
+/**
+ * gst_phc_clock_is_supported:
+ *
+ * Check if PTP hardware clocks are supported on this platform.
+ *
+ * Returns: %TRUE if #GstPhcClock can be used.
+ *
+ * Since: 1.24
+ */
+gboolean
+gst_phc_clock_is_supported (void)
+{
+#ifdef HAVE_PHC
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+static GstClock *
+gst_phc_clock_new_internal (const gchar * name, const gchar * property,
+    const gchar * value)
+{
+  GstPhcClock *clock;
+
+  clock = g_object_new (GST_TYPE_PHC_CLOCK, "name", name, property, value,
+      NULL);
+
+  /* Clear floating flag */
+  gst_object_ref_sink (clock);
+
+  if (clock->priv->fd < 0) {
+    gst_object_unref (clock);
+    return NULL;
+  }
+
+  return GST_CLOCK_CAST (clock);
+}
+
+/**
+ * gst_phc_clock_new:
+ * @name: Name of the clock
+ * @device: PTP hardware clock device, e.g. `/dev/ptp0`
+ *
+ * Creates a new clock that reads the time of the PTP hardware clock
+ * @device.
+ *
+ * Returns: (transfer full) (nullable): A new #GstClock, or %NULL if @device
+ * could not be opened.
+ *
+ * Since: 1.24
+ */
+GstClock *
+gst_phc_clock_new (const gchar * name, const gchar * device)
+{
+  g_return_val_if_fail (device != NULL, NULL);
+
+  return gst_phc_clock_new_internal (name, "device", device);
+}
+
+/**
+ * gst_phc_clock_new_for_interface:
+ * @name: Name of the clock
+ * @interface: Network interface name, e.g. `eth0`
+ *
+ * Creates a new clock that reads the time of the PTP hardware clock of the
+ * network interface @interface.
+ *
+ * Returns: (transfer full) (nullable): A new #GstClock, or %NULL if
+ * @interface has no usable PTP hardware clock.
+ *
+ * Since: 1.24
+ */
+GstClock *
+gst_phc_clock_new_for_interface (const gchar * name, const gchar * interface)
+{
+  g_return_val_if_fail (interface != NULL, NULL);
+
+  return gst_phc_clock_new_internal (name, "interface", interface);
+}
@@ -0,0 +1,92 @@
+/* GStreamer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_PHC_CLOCK_H__
+#define __GST_PHC_CLOCK_H__
+
+#include <gst/gst.h>
+#include <gst/gstsystemclock.h>
+#include <gst/net/net-prelude.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_PHC_CLOCK \
+  (gst_phc_clock_get_type())
+#define GST_PHC_CLOCK(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_PHC_CLOCK,GstPhcClock))
+#define GST_PHC_CLOCK_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_PHC_CLOCK,GstPhcClockClass))
+#define GST_IS_PHC_CLOCK(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_PHC_CLOCK))
+#define GST_IS_PHC_CLOCK_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_PHC_CLOCK))
+
+typedef struct _GstPhcClock GstPhcClock;
+typedef struct _GstPhcClockClass GstPhcClockClass;
+typedef struct _GstPhcClockPrivate GstPhcClockPrivate;
+
+/**
+ * GstPhcClock:
+ *
+ * Opaque #GstPhcClock structure.
+ *
+ * Since: 1.24
+ */
+struct _GstPhcClock {
+  GstSystemClock clock;
+
+  /*< private >*/
+  GstPhcClockPrivate *priv;
+
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+/**
+ * GstPhcClockClass:
+ * @parent_class: parented to #GstSystemClockClass
+ *
+ * Opaque #GstPhcClockClass structure.
+ *
+ * Since: 1.24
+ */
+struct _GstPhcClockClass {
+  GstSystemClockClass parent_class;
+
+  /*< private >*/
+  gpointer _gst_reserved[GST_PADDING];
+};
+
+GST_NET_API
+GType           gst_phc_clock_get_type             (void);
+
+GST_NET_API
+gboolean        gst_phc_clock_is_supported         (void);
+
+GST_NET_API
+GstClock*       gst_phc_clock_new                  (const gchar *name,
+                                                    const gchar *device);
+
+GST_NET_API
+GstClock*       gst_phc_clock_new_for_interface    (const gchar *name,
+                                                    const gchar *interface);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(GstPhcClock, gst_object_unref)
+
+G_END_DECLS
+
+#endif /* __GST_PHC_CLOCK_H__ */
@@ -72,6 +72,10 @@
 #include <unistd.h>
 #endif
 
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
 #include "gstelements_private.h"
 #include "gstfilesink.h"
 #include "gstcoreelementselements.h"
@@ -135,6 +139,7 @@ GST_DEBUG_CATEGORY_STATIC (gst_file_sink_debug);
 #define DEFAULT_O_SYNC		FALSE
 #define DEFAULT_MAX_TRANSIENT_ERROR_TIMEOUT	0
 #define DEFAULT_FILE_MODE      GST_FILE_SINK_FILE_MODE_TRUNC
+#define DEFAULT_ASYNC_DEPTH	0
 
 enum
 {
@@ -146,6 +151,7 @@ enum
   PROP_O_SYNC,
   PROP_MAX_TRANSIENT_ERROR_TIMEOUT,
   PROP_FILE_MODE,
+  PROP_ASYNC_DEPTH,
   PROP_LAST
 };
 
@@ -219,6 +225,12 @@ static void gst_file_sink_uri_handler_init (gpointer g_iface,
     gpointer iface_data);
 
 static GstFlowReturn gst_file_sink_flush_buffer (GstFileSink * filesink);
+static GstFlowReturn gst_file_sink_finish_writes (GstFileSink * filesink);
+
+#ifdef HAVE_LIBURING
+static void gst_file_sink_uring_open (GstFileSink * sink);
+static void gst_file_sink_uring_close (GstFileSink * sink);
+#endif
 
 #define _do_init \
   G_IMPLEMENT_INTERFACE (GST_TYPE_URI_HANDLER, gst_file_sink_uri_handler_init); \
@@ -292,6 +304,26 @@ gst_file_sink_class_init (GstFileSinkClass * klass)
           G_MAXINT, DEFAULT_MAX_TRANSIENT_ERROR_TIMEOUT,
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstFileSink:async-depth
+   *
+   * Number of writes to keep in flight with io_uring. With a value bigger
+   * than 0 the streaming thread only blocks when that many writes are still
+   * pending. Every pending write keeps its buffers alive. All writes are
+   * finished before EOS is forwarded, on seeks and before syncing.
+   *
+   * Writes are synchronous if io_uring is not available and for files that
+   * are not seekable or opened for appending.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_ASYNC_DEPTH,
+      g_param_spec_uint ("async-depth", "Asynchronous depth",
+          "Number of writes to keep in flight with io_uring (0 = synchronous "
+          "writes)", 0, 4096, DEFAULT_ASYNC_DEPTH,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "File Sink",
       "Sink/File", "Write stream to a file",
@@ -328,6 +360,7 @@ gst_file_sink_init (GstFileSink * filesink)
   filesink->buffer_size = DEFAULT_BUFFER_SIZE;
   filesink->append = FALSE;
   filesink->file_mode = DEFAULT_FILE_MODE;
+  filesink->async_depth = DEFAULT_ASYNC_DEPTH;
 
   gst_base_sink_set_sync (GST_BASE_SINK (filesink), FALSE);
 }
@@ -408,6 +441,9 @@ gst_file_sink_set_property (GObject * object, guint prop_id,
     case PROP_MAX_TRANSIENT_ERROR_TIMEOUT:
       sink->max_transient_error_timeout = g_value_get_int (value);
       break;
+    case PROP_ASYNC_DEPTH:
+      sink->async_depth = g_value_get_uint (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -442,6 +478,9 @@ gst_file_sink_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_MAX_TRANSIENT_ERROR_TIMEOUT:
       g_value_set_int (value, sink->max_transient_error_timeout);
       break;
+    case PROP_ASYNC_DEPTH:
+      g_value_set_uint (value, sink->async_depth);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -490,6 +529,11 @@ gst_file_sink_open_file (GstFileSink * sink)
     sink->current_buffer_size = 0;
   }
 
+#ifdef HAVE_LIBURING
+  if (sink->async_depth > 0)
+    gst_file_sink_uring_open (sink);
+#endif
+
   GST_DEBUG_OBJECT (sink, "opened file %s, seekable %d",
       sink->filename, sink->seekable);
 
@@ -515,10 +559,14 @@ static void
 gst_file_sink_close_file (GstFileSink * sink)
 {
   if (sink->file) {
-    if (gst_file_sink_flush_buffer (sink) != GST_FLOW_OK)
+    if (gst_file_sink_finish_writes (sink) != GST_FLOW_OK)
       GST_ELEMENT_ERROR (sink, RESOURCE, CLOSE,
           (_("Error closing file \"%s\"."), sink->filename), NULL);
 
+#ifdef HAVE_LIBURING
+    gst_file_sink_uring_close (sink);
+#endif
+
     if (fclose (sink->file) != 0)
       GST_ELEMENT_ERROR (sink, RESOURCE, CLOSE,
           (_("Error closing file \"%s\"."), sink->filename), GST_ERROR_SYSTEM);
@@ -607,7 +655,7 @@ gst_file_sink_do_seek (GstFileSink * filesink, guint64 new_offset)
   GST_DEBUG_OBJECT (filesink, "Seeking to offset %" G_GUINT64_FORMAT
       " using " __GST_STDIO_SEEK_FUNCTION, new_offset);
 
-  if (gst_file_sink_flush_buffer (filesink) != GST_FLOW_OK)
+  if (gst_file_sink_finish_writes (filesink) != GST_FLOW_OK)
     goto flush_buffer_failed;
 
 #ifdef HAVE_FSEEKO
@@ -693,7 +741,7 @@ gst_file_sink_event (GstBaseSink * sink, GstEvent * event)
       filesink->current_buffer_size = 0;
       break;
     case GST_EVENT_EOS:
-      if (gst_file_sink_flush_buffer (filesink) != GST_FLOW_OK)
+      if (gst_file_sink_finish_writes (filesink) != GST_FLOW_OK)
         goto flush_buffer_failed;
       break;
     default:
@@ -752,6 +800,384 @@ gst_file_sink_get_current_offset (GstFileSink * filesink, guint64 * p_pos)
   return (ret != (off_t) - 1);
 }
 
+#ifdef HAVE_LIBURING
+/* Writes queued to the ring, each covering the memories of one or more
+ * buffers. The buffers stay referenced and mapped until the kernel
+ * completed them. Writes are done at explicit offsets, so this is only used
+ * for seekable files that are not opened in append mode. */
+
+/* Upper limit of iovecs in one write, like IOV_MAX on Linux */
+#define GST_FILE_SINK_URING_MAX_VECS 1024
+
+typedef struct
+{
+  GstBuffer **buffers;
+  guint n_buffers;
+
+  GstMapInfo *maps;
+  struct iovec *vecs;
+  guint n_vecs;
+  /* first iovec not completely written yet */
+  guint first_vec;
+
+  guint64 offset;
+  gsize size;
+  gsize written;
+} GstFileSinkUringWrite;
+
+typedef struct
+{
+  struct io_uring ring;
+  gint fd;
+  gboolean fixed_file;
+  guint depth;
+  guint in_flight;
+  /* waiting for completions failed, the queued writes are lost */
+  gboolean broken;
+} GstFileSinkUring;
+
+static void
+gst_file_sink_uring_open (GstFileSink * sink)
+{
+  GstFileSinkUring *uring;
+  gint ret;
+
+  if (!sink->seekable || sink->append
+      || sink->file_mode == GST_FILE_SINK_FILE_MODE_APPEND) {
+    GST_DEBUG_OBJECT (sink, "not using io_uring for non-seekable or "
+        "appending files");
+    return;
+  }
+
+  uring = g_new0 (GstFileSinkUring, 1);
+
+  ret = io_uring_queue_init (sink->async_depth, &uring->ring, 0);
+  if (ret < 0) {
+    GST_WARNING_OBJECT (sink, "failed to set up io_uring, writing "
+        "synchronously: %s", g_strerror (-ret));
+    g_free (uring);
+    return;
+  }
+
+  uring->fd = fileno (sink->file);
+  uring->depth = sink->async_depth;
+
+  ret = io_uring_register_files (&uring->ring, &uring->fd, 1);
+  uring->fixed_file = (ret == 0);
+  if (!uring->fixed_file)
+    GST_DEBUG_OBJECT (sink, "can't register file: %s", g_strerror (-ret));
+
+  GST_DEBUG_OBJECT (sink, "keeping up to %u writes in flight", uring->depth);
+
+  sink->uring = uring;
+}
+
+static void
+gst_file_sink_uring_write_free (GstFileSinkUringWrite * write)
+{
+  guint i;
+
+  for (i = 0; i < write->n_vecs; i++)
+    gst_memory_unmap (write->maps[i].memory, &write->maps[i]);
+  for (i = 0; i < write->n_buffers; i++)
+    gst_buffer_unref (write->buffers[i]);
+
+  g_free (write->vecs);
+  g_free (write->maps);
+  g_free (write->buffers);
+  g_free (write);
+}
+
+/* Returns %NULL if a memory can't be mapped */
+static GstFileSinkUringWrite *
+gst_file_sink_uring_write_new (GstBuffer ** buffers, guint n_buffers,
+    guint64 offset)
+{
+  GstFileSinkUringWrite *write;
+  guint i, j, n_mem = 0;
+
+  for (i = 0; i < n_buffers; i++)
+    n_mem += gst_buffer_n_memory (buffers[i]);
+
+  write = g_new0 (GstFileSinkUringWrite, 1);
+  write->buffers = g_new (GstBuffer *, n_buffers);
+  write->maps = g_new (GstMapInfo, n_mem);
+  write->vecs = g_new (struct iovec, n_mem);
+  write->offset = offset;
+
+  for (i = 0; i < n_buffers; i++) {
+    guint n = gst_buffer_n_memory (buffers[i]);
+
+    write->buffers[write->n_buffers++] = gst_buffer_ref (buffers[i]);
+
+    for (j = 0; j < n; j++) {
+      GstMemory *mem = gst_buffer_peek_memory (buffers[i], j);
+      GstMapInfo *map = &write->maps[write->n_vecs];
+
+      /* skipping the memory would write everything after it at the wrong
+       * offset */
+      if (!gst_memory_map (mem, map, GST_MAP_READ)) {
+        GST_WARNING ("failed to map memory %p for reading", mem);
+        gst_file_sink_uring_write_free (write);
+        return NULL;
+      }
+      if (map->size == 0) {
+        gst_memory_unmap (mem, map);
+        continue;
+      }
+
+      write->vecs[write->n_vecs].iov_base = map->data;
+      write->vecs[write->n_vecs].iov_len = map->size;
+      write->size += map->size;
+      write->n_vecs++;
+    }
+  }
+
+  return write;
+}
+
+/* Queue the part of @write that is not written yet. The caller made sure
+ * there's room in the ring. */
+static gboolean
+gst_file_sink_uring_submit (GstFileSinkUring * uring,
+    GstFileSinkUringWrite * write)
+{
+  struct io_uring_sqe *sqe;
+  gint ret;
+
+  sqe = io_uring_get_sqe (&uring->ring);
+  g_assert (sqe != NULL);
+
+  io_uring_prep_writev (sqe, uring->fixed_file ? 0 : uring->fd,
+      &write->vecs[write->first_vec], write->n_vecs - write->first_vec,
+      write->offset + write->written);
+  if (uring->fixed_file)
+    sqe->flags |= IOSQE_FIXED_FILE;
+  io_uring_sqe_set_data (sqe, write);
+
+  do {
+    ret = io_uring_submit (&uring->ring);
+  } while (ret == -EINTR);
+
+  if (ret < 0) {
+    errno = -ret;
+    return FALSE;
+  }
+
+  uring->in_flight++;
+  return TRUE;
+}
+
+/* Mark @bytes of @write as written, returns TRUE if nothing is left */
+static gboolean
+gst_file_sink_uring_write_advance (GstFileSinkUringWrite * write, gsize bytes)
+{
+  write->written += bytes;
+
+  while (bytes > 0 && write->first_vec < write->n_vecs) {
+    struct iovec *vec = &write->vecs[write->first_vec];
+
+    if (bytes < vec->iov_len) {
+      vec->iov_base = (guint8 *) vec->iov_base + bytes;
+      vec->iov_len -= bytes;
+      break;
+    }
+
+    bytes -= vec->iov_len;
+    write->first_vec++;
+  }
+
+  return write->written >= write->size;
+}
+
+/* Wait for one write to complete, resubmitting the remainder of short and
+ * interrupted writes. */
+static GstFlowReturn
+gst_file_sink_uring_complete_one (GstFileSink * sink)
+{
+  GstFileSinkUring *uring = sink->uring;
+  GstFileSinkUringWrite *write;
+  struct io_uring_cqe *cqe;
+  gint ret, res, err;
+
+  if (uring->broken)
+    return GST_FLOW_ERROR;
+
+  do {
+    ret = io_uring_wait_cqe (&uring->ring, &cqe);
+  } while (ret == -EINTR);
+
+  if (ret < 0) {
+    err = -ret;
+    goto wait_failed;
+  }
+
+  write = io_uring_cqe_get_data (cqe);
+  res = cqe->res;
+  io_uring_cqe_seen (&uring->ring, cqe);
+  uring->in_flight--;
+
+  if (res == -EINTR || res == -EAGAIN) {
+    GST_DEBUG_OBJECT (sink, "write at offset %" G_GUINT64_FORMAT
+        " interrupted, retrying", write->offset + write->written);
+  } else if (res <= 0) {
+    /* a regular file only writes nothing if the disk is full */
+    err = res < 0 ? -res : ENOSPC;
+    gst_file_sink_uring_write_free (write);
+    goto write_failed;
+  } else if (gst_file_sink_uring_write_advance (write, res)) {
+    GST_LOG_OBJECT (sink, "completed write of %" G_GSIZE_FORMAT " bytes at "
+        "offset %" G_GUINT64_FORMAT, write->size, write->offset);
+    gst_file_sink_uring_write_free (write);
+    return GST_FLOW_OK;
+  }
+
+  if (!gst_file_sink_uring_submit (uring, write)) {
+    err = errno;
+    gst_file_sink_uring_write_free (write);
+    goto write_failed;
+  }
+
+  return GST_FLOW_OK;
+
+  /* ERRORS */
+wait_failed:
+  {
+    uring->broken = TRUE;
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+        (_("Error while writing to file \"%s\"."), sink->filename),
+        ("%s", g_strerror (err)));
+    return GST_FLOW_ERROR;
+  }
+write_failed:
+  {
+    switch (err) {
+      case ENOSPC:
+        GST_ELEMENT_ERROR (sink, RESOURCE, NO_SPACE_LEFT, (NULL), (NULL));
+        break;
+      default:
+        GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+            (_("Error while writing to file \"%s\"."), sink->filename),
+            ("%s", g_strerror (err)));
+        break;
+    }
+    return GST_FLOW_ERROR;
+  }
+}
+
+/* Queue a write of @buffers at the current position, waiting for earlier
+ * writes only when the ring is full */
+static GstFlowReturn
+gst_file_sink_uring_write_buffers (GstFileSink * sink, GstBuffer ** buffers,
+    guint n_buffers)
+{
+  GstFileSinkUring *uring = sink->uring;
+  GstFlowReturn flow = GST_FLOW_OK;
+  GstFileSinkUringWrite *write;
+  guint i, start = 0, n_vecs = 0;
+  gint err;
+
+  if (n_buffers == 0)
+    return GST_FLOW_OK;
+
+  for (i = 0; i <= n_buffers; i++) {
+    guint n = i < n_buffers ? gst_buffer_n_memory (buffers[i]) : 0;
+
+    if (i < n_buffers && (i == start
+            || n_vecs + n <= GST_FILE_SINK_URING_MAX_VECS)) {
+      n_vecs += n;
+      continue;
+    }
+
+    while (uring->in_flight >= uring->depth) {
+      flow = gst_file_sink_uring_complete_one (sink);
+      if (flow != GST_FLOW_OK)
+        return flow;
+    }
+
+    write = gst_file_sink_uring_write_new (&buffers[start], i - start,
+        sink->current_pos);
+    if (write == NULL)
+      goto map_failed;
+
+    if (write->size == 0) {
+      gst_file_sink_uring_write_free (write);
+    } else {
+      GST_LOG_OBJECT (sink, "queueing write of %" G_GSIZE_FORMAT " bytes at "
+          "offset %" G_GUINT64_FORMAT, write->size, write->offset);
+
+      sink->current_pos += write->size;
+
+      if (!gst_file_sink_uring_submit (uring, write)) {
+        err = errno;
+        gst_file_sink_uring_write_free (write);
+        goto submit_failed;
+      }
+    }
+
+    start = i;
+    n_vecs = n;
+  }
+
+  return flow;
+
+  /* ERRORS */
+map_failed:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+        (_("Error while writing to file \"%s\"."), sink->filename),
+        ("Failed to map buffer memory for reading"));
+    return GST_FLOW_ERROR;
+  }
+submit_failed:
+  {
+    GST_ELEMENT_ERROR (sink, RESOURCE, WRITE,
+        (_("Error while writing to file \"%s\"."), sink->filename),
+        ("%s", g_strerror (err)));
+    return GST_FLOW_ERROR;
+  }
+}
+
+/* Wait until all queued writes are done */
+static GstFlowReturn
+gst_file_sink_uring_drain (GstFileSink * sink)
+{
+  GstFileSinkUring *uring = sink->uring;
+  GstFlowReturn flow = GST_FLOW_OK;
+
+  if (uring == NULL)
+    return GST_FLOW_OK;
+
+  if (uring->in_flight > 0)
+    GST_DEBUG_OBJECT (sink, "waiting for %u writes", uring->in_flight);
+
+  /* keep reaping after a failed write so no buffer stays queued */
+  while (uring->in_flight > 0 && !uring->broken) {
+    GstFlowReturn ret = gst_file_sink_uring_complete_one (sink);
+
+    if (ret != GST_FLOW_OK)
+      flow = ret;
+  }
+
+  return flow;
+}
+
+static void
+gst_file_sink_uring_close (GstFileSink * sink)
+{
+  GstFileSinkUring *uring = sink->uring;
+
+  if (uring == NULL)
+    return;
+
+  if (uring->fixed_file)
+    io_uring_unregister_files (&uring->ring);
+  io_uring_queue_exit (&uring->ring);
+  g_free (uring);
+  sink->uring = NULL;
+}
+#endif
+
 static GstFlowReturn
 gst_file_sink_render_list_internal (GstFileSink * sink,
     GstBufferList * buffer_list)
@@ -768,6 +1194,21 @@ gst_file_sink_render_list_internal (GstFileSink * sink,
       "writing %u buffers at position %" G_GUINT64_FORMAT, num_buffers,
       sink->current_pos);
 
+#ifdef HAVE_LIBURING
+  if (sink->uring) {
+    GstBuffer **buffers = g_new (GstBuffer *, num_buffers);
+    guint i;
+
+    for (i = 0; i < num_buffers; i++)
+      buffers[i] = gst_buffer_list_get (buffer_list, i);
+
+    flow = gst_file_sink_uring_write_buffers (sink, buffers, num_buffers);
+    g_free (buffers);
+
+    return flow;
+  }
+#endif
+
   for (;;) {
     guint64 bytes_written = 0;
 
@@ -808,6 +1249,24 @@ gst_file_sink_flush_buffer (GstFileSink * filesink)
   if (filesink->buffer && filesink->current_buffer_size) {
     guint64 skip = 0;
 
+#ifdef HAVE_LIBURING
+    if (filesink->uring) {
+      GstBuffer *buffer;
+
+      /* hand the filled buffer over to the write and fill a new one */
+      buffer = gst_buffer_new_wrapped_full (0, filesink->buffer,
+          filesink->allocated_buffer_size, 0, filesink->current_buffer_size,
+          filesink->buffer, g_free);
+      filesink->buffer = g_malloc (filesink->allocated_buffer_size);
+      filesink->current_buffer_size = 0;
+
+      flow_ret = gst_file_sink_uring_write_buffers (filesink, &buffer, 1);
+      gst_buffer_unref (buffer);
+
+      return flow_ret;
+    }
+#endif
+
     for (;;) {
       guint64 bytes_written = 0;
 
@@ -846,6 +1305,26 @@ gst_file_sink_flush_buffer (GstFileSink * filesink)
   return flow_ret;
 }
 
+/* Write out the internal buffer and wait for all writes in flight */
+static GstFlowReturn
+gst_file_sink_finish_writes (GstFileSink * filesink)
+{
+  GstFlowReturn flow_ret;
+
+  flow_ret = gst_file_sink_flush_buffer (filesink);
+
+#ifdef HAVE_LIBURING
+  {
+    GstFlowReturn drain_ret = gst_file_sink_uring_drain (filesink);
+
+    if (flow_ret == GST_FLOW_OK)
+      flow_ret = drain_ret;
+  }
+#endif
+
+  return flow_ret;
+}
+
 static gboolean
 has_sync_after_buffer (GstBuffer ** buffer, guint idx, gpointer user_data)
 {
@@ -876,6 +1355,11 @@ render_buffer (GstFileSink * filesink, GstBuffer * buffer)
   guint64 bytes_written = 0;
   guint64 skip = 0;
 
+#ifdef HAVE_LIBURING
+  if (filesink->uring)
+    return gst_file_sink_uring_write_buffers (filesink, &buffer, 1);
+#endif
+
   for (;;) {
     flow =
         gst_writev_buffer (GST_OBJECT_CAST (filesink),
@@ -968,6 +1452,9 @@ gst_file_sink_render_list (GstBaseSink * bsink, GstBufferList * buffer_list)
     }
   }
 
+  if (flow == GST_FLOW_OK && sync_after)
+    flow = gst_file_sink_finish_writes (sink);
+
   if (flow == GST_FLOW_OK && sync_after) {
     do {
       fsync_ret = fsync (fileno (sink->file));
@@ -1052,6 +1539,9 @@ gst_file_sink_render (GstBaseSink * sink, GstBuffer * buffer)
     flow = GST_FLOW_OK;
   }
 
+  if (flow == GST_FLOW_OK && sync_after)
+    flow = gst_file_sink_finish_writes (filesink);
+
   if (flow == GST_FLOW_OK && sync_after) {
     do {
       fsync_ret = fsync (fileno (filesink->file));
@@ -113,6 +113,10 @@ struct _GstFileSink {
   gint max_transient_error_timeout;
 
   gboolean flushing;
+
+  /* io_uring writes, NULL when writing synchronously */
+  guint async_depth;
+  gpointer uring;
 };
 
 struct _GstFileSinkClass {
@@ -31,6 +31,8 @@
  * gst-launch-1.0 filesrc location=song.ogg ! decodebin ! audioconvert ! audioresample ! autoaudiosink
  * ]| Play song.ogg audio file which must be in the current working directory.
  *
+ * With #GstFileSrc:use-mmap the file is mapped into memory and the buffers
+ * wrap read-only regions of that mapping instead of copying the data.
  */
 
 #ifdef HAVE_CONFIG_H
@@ -79,6 +81,11 @@
 #include <errno.h>
 #include <string.h>
 
+#if defined (HAVE_SYS_MMAN_H) && defined (HAVE_MMAP)
+#include <sys/mman.h>
+#define HAVE_FILE_SRC_MMAP 1
+#endif
+
 #include <glib/gi18n-lib.h>
 
 static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
@@ -110,11 +117,22 @@ enum
 };
 
 #define DEFAULT_BLOCKSIZE       4*1024
+#define DEFAULT_USE_MMAP        FALSE
+
+/* number of blocks to ask the kernel to read ahead in mmap mode, and the
+ * minimum size of that window */
+#define MMAP_READAHEAD_BLOCKS   64
+#define MMAP_READAHEAD_MIN      (1024 * 1024)
+
+/* number of reads without seeking after which the access pattern is
+ * considered sequential and read-ahead is requested when reading */
+#define READ_SEQUENTIAL_THRESHOLD 2
 
 enum
 {
   PROP_0,
-  PROP_LOCATION
+  PROP_LOCATION,
+  PROP_USE_MMAP
 };
 
 static void gst_file_src_finalize (GObject * object);
@@ -131,6 +149,8 @@ static gboolean gst_file_src_is_seekable (GstBaseSrc * src);
 static gboolean gst_file_src_get_size (GstBaseSrc * src, guint64 * size);
 static GstFlowReturn gst_file_src_fill (GstBaseSrc * src, guint64 offset,
     guint length, GstBuffer * buf);
+static GstFlowReturn gst_file_src_create (GstBaseSrc * src, guint64 offset,
+    guint length, GstBuffer ** buf);
 
 static void gst_file_src_uri_handler_init (gpointer g_iface,
     gpointer iface_data);
@@ -143,6 +163,135 @@ G_DEFINE_TYPE_WITH_CODE (GstFileSrc, gst_file_src, GST_TYPE_BASE_SRC, _do_init);
 GST_ELEMENT_REGISTER_DEFINE (filesrc, "filesrc", GST_RANK_PRIMARY,
     GST_TYPE_FILE_SRC);
 
+#ifdef HAVE_FILE_SRC_MMAP
+/* Allocator for the mapped file. Only the memory covering the whole file owns
+ * the mapping, buffers get shared sub-memories of it. The mapping stays valid
+ * until the last of them is freed, so it can outlive filesrc itself. */
+#define GST_ALLOCATOR_FILE_SRC_MMAP "FileSrcMmap"
+
+typedef struct
+{
+  GstMemory mem;
+
+  guint8 *data;
+} GstFileSrcMemory;
+
+typedef struct
+{
+  GstAllocator parent;
+} GstFileSrcMmapAllocator;
+
+typedef struct
+{
+  GstAllocatorClass parent_class;
+} GstFileSrcMmapAllocatorClass;
+
+static GType gst_file_src_mmap_allocator_get_type (void);
+G_DEFINE_TYPE (GstFileSrcMmapAllocator, gst_file_src_mmap_allocator,
+    GST_TYPE_ALLOCATOR);
+
+static GstMemory *
+gst_file_src_mmap_alloc (GstAllocator * allocator, gsize size,
+    GstAllocationParams * params)
+{
+  /* only wraps mappings */
+  return NULL;
+}
+
+static void
+gst_file_src_mmap_free (GstAllocator * allocator, GstMemory * gmem)
+{
+  GstFileSrcMemory *mem = (GstFileSrcMemory *) gmem;
+
+  if (gmem->parent == NULL) {
+    GST_DEBUG ("unmapping %p, %" G_GSIZE_FORMAT " bytes", mem->data,
+        gmem->maxsize);
+    munmap (mem->data, gmem->maxsize);
+  }
+
+  g_free (mem);
+}
+
+static gpointer
+gst_file_src_mmap_mem_map (GstFileSrcMemory * mem, gsize maxsize,
+    GstMapFlags flags)
+{
+  /* the mapping is read-only */
+  if (flags & GST_MAP_WRITE)
+    return NULL;
+
+  return mem->data;
+}
+
+static gboolean
+gst_file_src_mmap_mem_unmap (GstFileSrcMemory * mem)
+{
+  return TRUE;
+}
+
+static GstFileSrcMemory *
+gst_file_src_mmap_mem_share (GstFileSrcMemory * mem, gssize offset,
+    gsize size)
+{
+  GstFileSrcMemory *sub;
+  GstMemory *parent;
+
+  /* find the real parent */
+  if ((parent = mem->mem.parent) == NULL)
+    parent = (GstMemory *) mem;
+
+  if (size == -1)
+    size = mem->mem.size - offset;
+
+  sub = g_new (GstFileSrcMemory, 1);
+  gst_memory_init (GST_MEMORY_CAST (sub), GST_MINI_OBJECT_FLAGS (parent) |
+      GST_MINI_OBJECT_FLAG_LOCK_READONLY, mem->mem.allocator, parent,
+      mem->mem.maxsize, mem->mem.align, mem->mem.offset + offset, size);
+  sub->data = mem->data;
+
+  return sub;
+}
+
+static gboolean
+gst_file_src_mmap_mem_is_span (GstFileSrcMemory * mem1,
+    GstFileSrcMemory * mem2, gsize * offset)
+{
+  if (offset) {
+    GstMemory *parent = mem1->mem.parent;
+
+    *offset = mem1->mem.offset - parent->offset;
+  }
+
+  /* and memory is contiguous */
+  return mem1->data + mem1->mem.offset + mem1->mem.size ==
+      mem2->data + mem2->mem.offset;
+}
+
+static void
+gst_file_src_mmap_allocator_class_init (GstFileSrcMmapAllocatorClass * klass)
+{
+  GstAllocatorClass *allocator_class = (GstAllocatorClass *) klass;
+
+  allocator_class->alloc = gst_file_src_mmap_alloc;
+  allocator_class->free = gst_file_src_mmap_free;
+}
+
+static void
+gst_file_src_mmap_allocator_init (GstFileSrcMmapAllocator * allocator)
+{
+  GstAllocator *alloc = GST_ALLOCATOR_CAST (allocator);
+
+  alloc->mem_type = GST_ALLOCATOR_FILE_SRC_MMAP;
+  alloc->mem_map = (GstMemoryMapFunction) gst_file_src_mmap_mem_map;
+  alloc->mem_unmap = (GstMemoryUnmapFunction) gst_file_src_mmap_mem_unmap;
+  alloc->mem_share = (GstMemoryShareFunction) gst_file_src_mmap_mem_share;
+  alloc->mem_is_span = (GstMemoryIsSpanFunction) gst_file_src_mmap_mem_is_span;
+
+  /* copies go to system memory */
+  GST_OBJECT_FLAG_SET (allocator, GST_ALLOCATOR_FLAG_CUSTOM_ALLOC);
+}
+#endif
+
 static void
 gst_file_src_class_init (GstFileSrcClass * klass)
 {
@@ -163,6 +312,27 @@ gst_file_src_class_init (GstFileSrcClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  /**
+   * GstFileSrc:use-mmap:
+   *
+   * Map regular files into memory and push read-only buffers that wrap
+   * regions of the mapping instead of reading into newly allocated memory.
+   * Downstream can sub-buffer them without copying. The kernel is told to
+   * read ahead a window of #GstBaseSrc:blocksize sized blocks, starting again
+   * after every seek.
+   *
+   * The file must not be truncated while it is mapped, accessing pages
+   * beyond the end of the file kills the process. Data appended to the file
+   * after it was mapped is read normally.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_USE_MMAP,
+      g_param_spec_boolean ("use-mmap", "Use mmap",
+          "Push read-only buffers wrapping a memory mapping of the file",
+          DEFAULT_USE_MMAP, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gobject_class->finalize = gst_file_src_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -177,6 +347,7 @@ gst_file_src_class_init (GstFileSrcClass * klass)
   gstbasesrc_class->is_seekable = GST_DEBUG_FUNCPTR (gst_file_src_is_seekable);
   gstbasesrc_class->get_size = GST_DEBUG_FUNCPTR (gst_file_src_get_size);
   gstbasesrc_class->fill = GST_DEBUG_FUNCPTR (gst_file_src_fill);
+  gstbasesrc_class->create = GST_DEBUG_FUNCPTR (gst_file_src_create);
 
   if (sizeof (off_t) < 8) {
     GST_LOG ("No large file support, sizeof (off_t) = %" G_GSIZE_FORMAT "!",
@@ -192,6 +363,7 @@ gst_file_src_init (GstFileSrc * src)
   src->uri = NULL;
 
   src->is_regular = FALSE;
+  src->use_mmap = DEFAULT_USE_MMAP;
 
   gst_base_src_set_blocksize (GST_BASE_SRC (src), DEFAULT_BLOCKSIZE);
 }
@@ -206,6 +378,9 @@ gst_file_src_finalize (GObject * object)
   g_free (src->filename);
   g_free (src->uri);
 
+  if (src->mmap_allocator)
+    gst_object_unref (src->mmap_allocator);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -270,6 +445,9 @@ gst_file_src_set_property (GObject * object, guint prop_id,
     case PROP_LOCATION:
       gst_file_src_set_location (src, g_value_get_string (value), NULL);
       break;
+    case PROP_USE_MMAP:
+      src->use_mmap = g_value_get_boolean (value);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -290,6 +468,9 @@ gst_file_src_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_LOCATION:
       g_value_set_string (value, src->filename);
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, src->use_mmap);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -306,6 +487,62 @@ gst_file_src_get_property (GObject * object, guint prop_id, GValue * value,
  * the sort of attitude we want to be advertising.  No sir.
  *
  */
+
+/* Ask the kernel to prefetch ahead of sequential reads asynchronously. With
+ * random access, e.g. a demuxer seeking around, the kernel's own read-ahead
+ * is disabled instead as it would only waste I/O */
+static void
+gst_file_src_read_advise (GstFileSrc * src, guint64 offset, guint length)
+{
+#ifdef HAVE_POSIX_FADVISE
+  guint64 window, start;
+
+  if (!src->is_regular)
+    return;
+
+  if (offset != src->read_position) {
+    /* two seeks in a row, looks like random access */
+    if (src->sequential_reads == 0 && !src->random_access) {
+      GST_LOG_OBJECT (src, "random access at offset %" G_GUINT64_FORMAT,
+          offset);
+      if (posix_fadvise (src->fd, 0, 0, POSIX_FADV_RANDOM) != 0)
+        GST_DEBUG_OBJECT (src, "posix_fadvise failed");
+      src->random_access = TRUE;
+    }
+
+    src->sequential_reads = 0;
+    src->read_advised_end = offset;
+    return;
+  }
+
+  if (++src->sequential_reads < READ_SEQUENTIAL_THRESHOLD)
+    return;
+
+  if (src->random_access) {
+    GST_LOG_OBJECT (src, "sequential access at offset %" G_GUINT64_FORMAT,
+        offset);
+    if (posix_fadvise (src->fd, 0, 0, POSIX_FADV_NORMAL) != 0)
+      GST_DEBUG_OBJECT (src, "posix_fadvise failed");
+    src->random_access = FALSE;
+  }
+
+  /* only advise again when we get close to the end of the window */
+  if (offset + length + length <= src->read_advised_end)
+    return;
+
+  window = MAX ((guint64) gst_base_src_get_blocksize (GST_BASE_SRC (src)) *
+      MMAP_READAHEAD_BLOCKS, MMAP_READAHEAD_MIN);
+  start = MAX (offset, src->read_advised_end);
+
+  GST_LOG_OBJECT (src, "read-ahead of %" G_GUINT64_FORMAT " bytes at offset %"
+      G_GUINT64_FORMAT, window, start);
+  if (posix_fadvise (src->fd, start, window, POSIX_FADV_WILLNEED) != 0)
+    GST_DEBUG_OBJECT (src, "posix_fadvise failed");
+
+  src->read_advised_end = start + window;
+#endif
+}
+
 static GstFlowReturn
 gst_file_src_fill (GstBaseSrc * basesrc, guint64 offset, guint length,
     GstBuffer * buf)
@@ -318,6 +555,9 @@ gst_file_src_fill (GstBaseSrc * basesrc, guint64 offset, guint length,
 
   src = GST_FILE_SRC_CAST (basesrc);
 
+  gst_file_src_read_advise (src, offset != -1 ? offset : src->read_position,
+      length);
+
   if (G_UNLIKELY (offset != -1 && src->read_position != offset)) {
     off_t res;
 
@@ -395,6 +635,132 @@ buffer_write_fail:
   }
 }
 
+#ifdef HAVE_FILE_SRC_MMAP
+/* tell the kernel which part of the mapping we are about to read */
+static void
+gst_file_src_mmap_advise (GstFileSrc * src, guint64 offset, guint length)
+{
+#ifdef HAVE_MADVISE
+  GstFileSrcMemory *mapping = (GstFileSrcMemory *) src->mapping;
+  guint64 size = src->mapping->size, window, start, end;
+  gsize page_mask = sysconf (_SC_PAGESIZE) - 1;
+
+  /* seeked, restart the read-ahead at the new position */
+  if (offset != src->mmap_position)
+    src->mmap_advised_end = offset;
+
+  src->mmap_position = offset + length;
+
+  /* only advise again when we get close to the end of the window */
+  if (offset + length + length <= src->mmap_advised_end)
+    return;
+
+  window = MAX ((guint64) gst_base_src_get_blocksize (GST_BASE_SRC (src)) *
+      MMAP_READAHEAD_BLOCKS, MMAP_READAHEAD_MIN);
+
+  start = MAX (offset, src->mmap_advised_end) & ~((guint64) page_mask);
+  end = MIN (start + window, size);
+  if (start >= end)
+    return;
+
+  GST_LOG_OBJECT (src, "read-ahead of %" G_GUINT64_FORMAT " bytes at offset %"
+      G_GUINT64_FORMAT, end - start, start);
+  if (madvise (mapping->data + start, end - start, MADV_WILLNEED) < 0)
+    GST_DEBUG_OBJECT (src, "madvise failed: %s", g_strerror (errno));
+
+  src->mmap_advised_end = end;
+#endif
+}
+
+static void
+gst_file_src_mmap_start (GstFileSrc * src)
+{
+  GstFileSrcMemory *mem;
+  guint64 size;
+  gpointer data;
+
+  if (!src->seekable ||
+      !gst_file_src_get_size (GST_BASE_SRC_CAST (src), &size) || size == 0) {
+    GST_INFO_OBJECT (src, "not mapping file, reading it instead");
+    return;
+  }
+
+  if (size > G_MAXSIZE)
+    goto too_big;
+
+  data = mmap (NULL, size, PROT_READ, MAP_SHARED, src->fd, 0);
+  if (data == MAP_FAILED)
+    goto map_failed;
+
+#ifdef HAVE_MADVISE
+  if (madvise (data, size, MADV_SEQUENTIAL) < 0)
+    GST_DEBUG_OBJECT (src, "madvise failed: %s", g_strerror (errno));
+#endif
+
+  if (src->mmap_allocator == NULL)
+    src->mmap_allocator =
+        g_object_new (gst_file_src_mmap_allocator_get_type (), NULL);
+
+  mem = g_new (GstFileSrcMemory, 1);
+  gst_memory_init (GST_MEMORY_CAST (mem), GST_MEMORY_FLAG_READONLY,
+      src->mmap_allocator, NULL, size, 0, 0, size);
+  mem->data = data;
+
+  src->mapping = GST_MEMORY_CAST (mem);
+  src->mmap_position = 0;
+  src->mmap_advised_end = 0;
+
+  GST_INFO_OBJECT (src, "mapped %" G_GUINT64_FORMAT " bytes", size);
+  return;
+
+too_big:
+  {
+    GST_WARNING_OBJECT (src, "file too big to map, reading it instead");
+    return;
+  }
+map_failed:
+  {
+    GST_WARNING_OBJECT (src, "failed to map file, reading it instead: %s",
+        g_strerror (errno));
+    return;
+  }
+}
+#endif
+
+static GstFlowReturn
+gst_file_src_create (GstBaseSrc * basesrc, guint64 offset, guint length,
+    GstBuffer ** buffer)
+{
+#ifdef HAVE_FILE_SRC_MMAP
+  GstFileSrc *src = GST_FILE_SRC_CAST (basesrc);
+  GstBuffer *buf;
+
+  /* downstream provided a buffer to fill or the range is beyond what we
+   * mapped, the file might have grown since */
+  if (src->mapping && *buffer == NULL && offset < src->mapping->size) {
+    length = MIN (length, src->mapping->size - offset);
+
+    gst_file_src_mmap_advise (src, offset, length);
+
+    GST_LOG_OBJECT (src, "mapping %u bytes at offset 0x%" G_GINT64_MODIFIER
+        "x", length, offset);
+
+    buf = gst_buffer_new ();
+    gst_buffer_append_memory (buf, gst_memory_share (src->mapping, offset,
+            length));
+    GST_BUFFER_OFFSET (buf) = offset;
+    GST_BUFFER_OFFSET_END (buf) = offset + length;
+
+    *buffer = buf;
+
+    return GST_FLOW_OK;
+  }
+#endif
+
+  return GST_BASE_SRC_CLASS (parent_class)->create (basesrc, offset, length,
+      buffer);
+}
+
 static gboolean
 gst_file_src_is_seekable (GstBaseSrc * basesrc)
 {
@@ -509,6 +875,9 @@ gst_file_src_start (GstBaseSrc * basesrc)
 #endif
 
   src->read_position = 0;
+  src->read_advised_end = 0;
+  src->sequential_reads = 0;
+  src->random_access = FALSE;
 
   /* We need to check if the underlying file is seekable. */
   {
@@ -537,6 +906,14 @@ gst_file_src_start (GstBaseSrc * basesrc)
 
   gst_base_src_set_dynamic_size (basesrc, src->seekable);
 
+#ifdef HAVE_FILE_SRC_MMAP
+  if (src->use_mmap)
+    gst_file_src_mmap_start (src);
+#else
+  if (src->use_mmap)
+    GST_WARNING_OBJECT (src, "mmap is not supported on this platform");
+#endif
+
   return TRUE;
 
   /* ERROR */
@@ -600,6 +977,12 @@ gst_file_src_stop (GstBaseSrc * basesrc)
 {
   GstFileSrc *src = GST_FILE_SRC (basesrc);
 
+  /* buffers still using the mapping keep it alive */
+  if (src->mapping) {
+    gst_memory_unref (src->mapping);
+    src->mapping = NULL;
+  }
+
   /* close the file */
   g_close (src->fd, NULL);
 
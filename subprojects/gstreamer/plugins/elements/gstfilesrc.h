@@ -63,6 +63,18 @@ struct _GstFileSrc {
   gboolean seekable;                    /* whether the file is seekable */
   gboolean is_regular;                  /* whether it's a (symlink to a)
                                            regular file */
+
+  gboolean use_mmap;                    /* hand out mapped file regions */
+  GstAllocator *mmap_allocator;
+  GstMemory *mapping;                   /* the mapped file, NULL when reading */
+  guint64 mmap_position;                /* expected offset of the next
+                                           mapped buffer */
+  guint64 mmap_advised_end;             /* end of the read-ahead window */
+
+  guint64 read_advised_end;             /* end of the read-ahead window when
+                                           reading */
+  guint sequential_reads;               /* number of reads without seek */
+  gboolean random_access;               /* kernel read-ahead disabled */
 };
 
 struct _GstFileSrcClass {
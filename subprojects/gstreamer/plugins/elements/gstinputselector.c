@@ -102,7 +102,8 @@ enum
   PROP_SYNC_STREAMS,
   PROP_SYNC_MODE,
   PROP_CACHE_BUFFERS,
-  PROP_DROP_BACKWARDS
+  PROP_DROP_BACKWARDS,
+  PROP_CACHE_GOP
 };
 
 #define DEFAULT_SYNC_STREAMS TRUE
@@ -110,6 +111,11 @@ enum
 #define DEFAULT_CACHE_BUFFERS FALSE
 #define DEFAULT_PAD_ALWAYS_OK TRUE
 #define DEFAULT_DROP_BACKWARDS FALSE
+#define DEFAULT_CACHE_GOP FALSE
+
+/* upper bound for the per-pad GOP cache, streams with longer GOPs are
+ * switched without replay */
+#define MAX_GOP_CACHE_BUFFERS 600
 
 enum
 {
@@ -168,6 +174,8 @@ struct _GstSelectorPad
   gboolean sending_cached_buffers;
   GQueue *cached_buffers;
 
+  GQueue *gop_cache;            /* buffers since the last keyframe */
+
   GstClockID clock_id;
 };
 
@@ -202,6 +210,7 @@ static GstFlowReturn gst_selector_pad_chain (GstPad * pad, GstObject * parent,
 static void gst_selector_pad_cache_buffer (GstSelectorPad * selpad,
     GstBuffer * buffer);
 static void gst_selector_pad_free_cached_buffers (GstSelectorPad * selpad);
+static void gst_selector_pad_free_gop_cache (GstSelectorPad * selpad);
 
 G_DEFINE_TYPE (GstSelectorPad, gst_selector_pad, GST_TYPE_PAD);
 
@@ -253,6 +262,7 @@ gst_selector_pad_finalize (GObject * object)
   if (pad->tags)
     gst_tag_list_unref (pad->tags);
   gst_selector_pad_free_cached_buffers (pad);
+  gst_selector_pad_free_gop_cache (pad);
 
   G_OBJECT_CLASS (gst_selector_pad_parent_class)->finalize (object);
 }
@@ -349,6 +359,7 @@ gst_selector_pad_reset (GstSelectorPad * pad)
   gst_segment_init (&pad->segment, GST_FORMAT_UNDEFINED);
   pad->sending_cached_buffers = FALSE;
   gst_selector_pad_free_cached_buffers (pad);
+  gst_selector_pad_free_gop_cache (pad);
   if (pad->clock_id) {
     gst_clock_id_unschedule (pad->clock_id);
     gst_clock_id_unref (pad->clock_id);
@@ -406,6 +417,40 @@ gst_selector_pad_free_cached_buffers (GstSelectorPad * selpad)
   selpad->cached_buffers = NULL;
 }
 
+/* must be called with the SELECTOR_LOCK */
+static void
+gst_selector_pad_cache_gop (GstSelectorPad * selpad, GstBuffer * buffer)
+{
+  if (!GST_BUFFER_FLAG_IS_SET (buffer, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    /* keyframe, everything before it is not needed anymore */
+    gst_selector_pad_free_gop_cache (selpad);
+    selpad->gop_cache = g_queue_new ();
+  } else if (!selpad->gop_cache) {
+    /* no keyframe seen yet, nothing to decode this buffer against */
+    return;
+  } else if (selpad->gop_cache->length >= MAX_GOP_CACHE_BUFFERS) {
+    GST_DEBUG_OBJECT (selpad, "GOP longer than %d buffers, not caching",
+        MAX_GOP_CACHE_BUFFERS);
+    gst_selector_pad_free_gop_cache (selpad);
+    return;
+  }
+
+  GST_LOG_OBJECT (selpad, "Adding buffer %p to GOP cache", buffer);
+  g_queue_push_tail (selpad->gop_cache, gst_buffer_ref (buffer));
+}
+
+/* must be called with the SELECTOR_LOCK */
+static void
+gst_selector_pad_free_gop_cache (GstSelectorPad * selpad)
+{
+  if (!selpad->gop_cache)
+    return;
+
+  GST_DEBUG_OBJECT (selpad, "Freeing GOP cache");
+  g_queue_free_full (selpad->gop_cache, (GDestroyNotify) gst_buffer_unref);
+  selpad->gop_cache = NULL;
+}
+
 /* strictly get the linked pad from the sinkpad. If the pad is active we return
  * the srcpad else we return NULL */
 static GstIterator *
@@ -588,6 +633,8 @@ gst_selector_pad_event (GstPad * pad, GstObject * parent, GstEvent * event)
     {
       gst_event_copy_segment (event, &selpad->segment);
       selpad->segment_seqnum = gst_event_get_seqnum (event);
+      /* cached buffers belong to the previous segment */
+      gst_selector_pad_free_gop_cache (selpad);
 
       GST_DEBUG_OBJECT (pad, "configured SEGMENT %" GST_SEGMENT_FORMAT,
           &selpad->segment);
@@ -1054,6 +1101,7 @@ gst_selector_pad_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   GstSelectorPad *selpad;
   GstSegment seg;
   GstClockTime running_time = GST_CLOCK_TIME_NONE;
+  GQueue *replay = NULL;
 
   sel = GST_INPUT_SELECTOR (parent);
   selpad = GST_SELECTOR_PAD_CAST (pad);
@@ -1152,6 +1200,14 @@ gst_selector_pad_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   if (pad != active_sinkpad)
     goto ignore;
 
+  /* We just switched to this pad in the middle of a GOP, replay everything
+   * since the last keyframe so that downstream can decode this buffer */
+  if (sel->cache_gop && selpad->discont && selpad->gop_cache &&
+      GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT)) {
+    replay = g_queue_copy (selpad->gop_cache);
+    g_queue_foreach (replay, (GFunc) gst_buffer_ref, NULL);
+  }
+
   /* Tell all non-active pads that we advanced the running time */
   if (sel->sync_streams)
     GST_INPUT_SELECTOR_BROADCAST (sel);
@@ -1178,6 +1234,38 @@ gst_selector_pad_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
     prev_active_sinkpad = NULL;
   }
 
+  if (replay) {
+    GstBuffer *cached;
+
+    GST_DEBUG_OBJECT (pad, "Replaying %u buffers since last keyframe",
+        replay->length);
+
+    res = GST_FLOW_OK;
+    while ((cached = g_queue_pop_head (replay))) {
+      if (res != GST_FLOW_OK) {
+        gst_buffer_unref (cached);
+        continue;
+      }
+      if (selpad->discont) {
+        cached = gst_buffer_make_writable (cached);
+        GST_BUFFER_FLAG_SET (cached, GST_BUFFER_FLAG_DISCONT);
+        selpad->discont = FALSE;
+      }
+      res = gst_pad_push (sel->srcpad, cached);
+    }
+    g_queue_free (replay);
+
+    if (res != GST_FLOW_OK) {
+      GST_DEBUG_OBJECT (pad, "Replaying GOP cache failed: %s",
+          gst_flow_get_name (res));
+      GST_INPUT_SELECTOR_LOCK (sel);
+      gst_selector_pad_cache_gop (selpad, buf);
+      GST_INPUT_SELECTOR_UNLOCK (sel);
+      gst_buffer_unref (buf);
+      goto done;
+    }
+  }
+
   seg = selpad->segment;
   if (seg.format == GST_FORMAT_TIME)
     running_time =
@@ -1212,6 +1300,11 @@ gst_selector_pad_chain (GstPad * pad, GstObject * parent, GstBuffer * buf)
   /* Only make the buffer read-only when necessary */
   if (sel->sync_streams && sel->cache_buffers)
     buf = gst_buffer_ref (buf);
+  if (sel->cache_gop && !selpad->sending_cached_buffers) {
+    GST_INPUT_SELECTOR_LOCK (sel);
+    gst_selector_pad_cache_gop (selpad, buf);
+    GST_INPUT_SELECTOR_UNLOCK (sel);
+  }
   res = gst_pad_push (sel->srcpad, buf);
   GST_LOG_OBJECT (pad, "Buffer %p forwarded result=%d", buf, res);
 
@@ -1248,6 +1341,8 @@ ignore:
     GST_DEBUG_OBJECT (pad, "Pad not active, discard buffer %p", buf);
     /* when we drop a buffer, we're creating a discont on this pad */
     selpad->discont = TRUE;
+    if (sel->cache_gop)
+      gst_selector_pad_cache_gop (selpad, buf);
     GST_INPUT_SELECTOR_UNLOCK (sel);
     gst_buffer_unref (buf);
 
@@ -1392,6 +1487,28 @@ gst_input_selector_class_init (GstInputSelectorClass * klass)
           G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
           GST_PARAM_MUTABLE_READY));
 
+  /**
+   * GstInputSelector:cache-gop
+   *
+   * If set to %TRUE, every sink pad keeps the buffers received since its
+   * last keyframe (a buffer without the %GST_BUFFER_FLAG_DELTA_UNIT flag).
+   * When switching to a pad in the middle of a GOP, those buffers are pushed
+   * before the first buffer of the new pad so that downstream decoders can
+   * continue without corruption. This allows switching between compressed
+   * streams without decoding the inactive ones.
+   *
+   * The replayed buffers keep their original timestamps and are not subject
+   * to GstInputSelector:drop-backwards.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_CACHE_GOP,
+      g_param_spec_boolean ("cache-gop", "Cache GOP",
+          "Replay the buffers since the last keyframe when switching pads",
+          DEFAULT_CACHE_GOP,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS |
+          GST_PARAM_MUTABLE_READY));
+
   gst_element_class_set_static_metadata (gstelement_class, "Input selector",
       "Generic", "N-to-1 input stream selector",
       "Julien Moutte <julien@moutte.net>, "
@@ -1568,6 +1685,11 @@ gst_input_selector_set_property (GObject * object, guint prop_id,
       sel->drop_backwards = g_value_get_boolean (value);
       GST_INPUT_SELECTOR_UNLOCK (object);
       break;
+    case PROP_CACHE_GOP:
+      GST_INPUT_SELECTOR_LOCK (object);
+      sel->cache_gop = g_value_get_boolean (value);
+      GST_INPUT_SELECTOR_UNLOCK (object);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1621,6 +1743,11 @@ gst_input_selector_get_property (GObject * object, guint prop_id,
       g_value_set_boolean (value, sel->drop_backwards);
       GST_INPUT_SELECTOR_UNLOCK (object);
       break;
+    case PROP_CACHE_GOP:
+      GST_INPUT_SELECTOR_LOCK (object);
+      g_value_set_boolean (value, sel->cache_gop);
+      GST_INPUT_SELECTOR_UNLOCK (object);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
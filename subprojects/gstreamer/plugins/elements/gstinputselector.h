@@ -73,6 +73,7 @@ struct _GstInputSelector {
   GstInputSelectorSyncMode sync_mode;
   gboolean cache_buffers;
   gboolean drop_backwards;
+  gboolean cache_gop;
 
   gboolean have_group_id;
 
@@ -187,6 +187,10 @@ struct _GstSingleQueue
   /* For interleave calculation */
   GThread *thread;              /* Streaming thread of SingleQueue */
   GstClockTime interleave;      /* Calculated interleve within the thread */
+
+  /* Memory budget state, only used from the streaming thread of the sinkpad */
+  gboolean budget_dropping_deltas;      /* Dropping deltas until a keyframe */
+  gboolean budget_needs_discont;        /* Mark the next buffer DISCONT */
 };
 
 /* Extension of GstDataQueueItem structure for our usage */
@@ -203,6 +207,9 @@ struct _GstMultiQueueItem
   guint32 posid;
 
   gboolean is_query;
+
+  /* budget charged with size, if any */
+  GstMemoryBudget *budget;
 };
 
 static GstSingleQueue *gst_single_queue_new (GstMultiQueue * mqueue, guint id);
@@ -213,6 +220,8 @@ static void wake_up_next_non_linked (GstMultiQueue * mq);
 static void compute_high_id (GstMultiQueue * mq);
 static void compute_high_time (GstMultiQueue * mq, guint groupid);
 static void single_queue_overrun_cb (GstDataQueue * dq, GstSingleQueue * sq);
+static void single_queue_shrink_visible (GstMultiQueue * mq,
+    GstSingleQueue * sq);
 static void single_queue_underrun_cb (GstDataQueue * dq, GstSingleQueue * sq);
 
 static void update_buffering (GstMultiQueue * mq, GstSingleQueue * sq);
@@ -637,6 +646,8 @@ static GstPad *gst_multi_queue_request_new_pad (GstElement * element,
 static void gst_multi_queue_release_pad (GstElement * element, GstPad * pad);
 static GstStateChangeReturn gst_multi_queue_change_state (GstElement *
     element, GstStateChange transition);
+static void gst_multi_queue_set_context (GstElement * element,
+    GstContext * context);
 
 static void gst_multi_queue_loop (GstPad * pad);
 
@@ -834,6 +845,16 @@ gst_multi_queue_class_init (GstMultiQueueClass * klass)
    *   - "buffers" G_TYPE_UINT    The queue's current level of buffers
    *   - "bytes" G_TYPE_UINT    The queue's current level of bytes
    *   - "time" G_TYPE_UINT64    The queue's current level of time
+   *   - "max-buffers" G_TYPE_UINT    The queue's current limit of buffers,
+   *     which can be above #GstMultiQueue:max-size-buffers while other queues
+   *     starve (Since: 1.24)
+   *   - "max-bytes" G_TYPE_UINT    The queue's current limit of bytes
+   *     (Since: 1.24)
+   *   - "max-time" G_TYPE_UINT64    The queue's current limit of time, which
+   *     follows the measured interleave with #GstMultiQueue:use-interleave
+   *     (Since: 1.24)
+   * - "interleave" G_TYPE_UINT64    The measured interleave of the streams
+   *   when #GstMultiQueue:use-interleave is enabled, 0 otherwise (Since: 1.24)
    *
    * Since: 1.18
    */
@@ -858,6 +879,8 @@ gst_multi_queue_class_init (GstMultiQueueClass * klass)
       GST_DEBUG_FUNCPTR (gst_multi_queue_release_pad);
   gstelement_class->change_state =
       GST_DEBUG_FUNCPTR (gst_multi_queue_change_state);
+  gstelement_class->set_context =
+      GST_DEBUG_FUNCPTR (gst_multi_queue_set_context);
 
   gst_type_mark_as_plugin_api (GST_TYPE_MULTIQUEUE_PAD, 0);
 }
@@ -908,6 +931,9 @@ gst_multi_queue_finalize (GObject * object)
   g_mutex_clear (&mqueue->reconf_lock);
   g_mutex_clear (&mqueue->buffering_post_lock);
 
+  if (mqueue->memory_budget)
+    gst_memory_budget_unref (mqueue->memory_budget);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -1066,7 +1092,10 @@ gst_multi_queue_get_stats (GstMultiQueue * mq)
       s = gst_structure_new (id,
           "buffers", G_TYPE_UINT, level.visible,
           "bytes", G_TYPE_UINT, level.bytes,
-          "time", G_TYPE_UINT64, sq->cur_time, NULL);
+          "time", G_TYPE_UINT64, sq->cur_time,
+          "max-buffers", G_TYPE_UINT, sq->max_size.visible,
+          "max-bytes", G_TYPE_UINT, sq->max_size.bytes,
+          "max-time", G_TYPE_UINT64, sq->max_size.time, NULL);
       g_value_take_boxed (&v, s);
       gst_value_array_append_and_take_value (&queues, &v);
       g_free (id);
@@ -1074,6 +1103,9 @@ gst_multi_queue_get_stats (GstMultiQueue * mq)
     gst_structure_take_value (ret, "queues", &queues);
   }
 
+  gst_structure_set (ret, "interleave", G_TYPE_UINT64,
+      mq->use_interleave ? mq->interleave : 0, NULL);
+
   return ret;
 }
 
@@ -1341,6 +1373,63 @@ gst_multi_queue_change_state (GstElement * element, GstStateChange transition)
   return result;
 }
 
+/* apply the task affinity @context to the streaming thread of @srcpad */
+static void
+gst_single_queue_update_task_affinity (GstPad * srcpad, GstContext * context)
+{
+  GstTask *task = NULL;
+
+  GST_OBJECT_LOCK (srcpad);
+  if (GST_PAD_TASK (srcpad))
+    task = gst_object_ref (GST_PAD_TASK (srcpad));
+  GST_OBJECT_UNLOCK (srcpad);
+
+  if (task) {
+    gst_task_set_affinity_from_context (task, context);
+    gst_object_unref (task);
+  }
+}
+
+static void
+gst_multi_queue_set_context (GstElement * element, GstContext * context)
+{
+  GstMultiQueue *mq = GST_MULTI_QUEUE (element);
+  GList *tmp, *srcpads = NULL;
+
+  GST_ELEMENT_CLASS (parent_class)->set_context (element, context);
+
+  if (gst_context_has_context_type (context, GST_MEMORY_BUDGET_CONTEXT_TYPE)) {
+    GstMemoryBudget *budget = gst_memory_budget_from_context (context);
+
+    /* buffers already queued keep their charge on the previous budget */
+    if (budget) {
+      GST_OBJECT_LOCK (mq);
+      if (mq->memory_budget)
+        gst_memory_budget_unref (mq->memory_budget);
+      mq->memory_budget = budget;
+      GST_OBJECT_UNLOCK (mq);
+    }
+    return;
+  }
+
+  if (!gst_context_has_context_type (context, GST_TASK_AFFINITY_CONTEXT_TYPE))
+    return;
+
+  GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  for (tmp = mq->queues; tmp; tmp = g_list_next (tmp)) {
+    GstSingleQueue *sq = (GstSingleQueue *) tmp->data;
+    GstPad *srcpad = g_weak_ref_get (&sq->srcpad);
+
+    if (srcpad)
+      srcpads = g_list_prepend (srcpads, srcpad);
+  }
+  GST_MULTI_QUEUE_MUTEX_UNLOCK (mq);
+
+  for (tmp = srcpads; tmp; tmp = g_list_next (tmp))
+    gst_single_queue_update_task_affinity (tmp->data, context);
+  g_list_free_full (srcpads, gst_object_unref);
+}
+
 static gboolean
 gst_single_queue_start (GstMultiQueue * mq, GstSingleQueue * sq)
 {
@@ -1350,8 +1439,17 @@ gst_single_queue_start (GstMultiQueue * mq, GstSingleQueue * sq)
   GST_LOG_ID (sq->debug_id, "starting task");
 
   if (srcpad) {
+    GstContext *context;
+
     res = gst_pad_start_task (srcpad,
         (GstTaskFunction) gst_multi_queue_loop, srcpad, NULL);
+
+    context = gst_element_get_context (GST_ELEMENT_CAST (mq),
+        GST_TASK_AFFINITY_CONTEXT_TYPE);
+    if (context) {
+      gst_single_queue_update_task_affinity (srcpad, context);
+      gst_context_unref (context);
+    }
     gst_object_unref (srcpad);
   }
 
@@ -1431,6 +1529,8 @@ gst_single_queue_flush (GstMultiQueue * mq, GstSingleQueue * sq, gboolean flush,
     sq->last_time = GST_CLOCK_STIME_NONE;
     sq->cached_sinktime = GST_CLOCK_STIME_NONE;
     sq->group_high_time = GST_CLOCK_STIME_NONE;
+    sq->budget_dropping_deltas = FALSE;
+    sq->budget_needs_discont = FALSE;
     gst_data_queue_set_flushing (sq->queue, FALSE);
 
     /* We will become active again on the next buffer/gap */
@@ -2124,6 +2224,10 @@ gst_multi_queue_item_destroy (GstMultiQueueItem * item)
 {
   if (!item->is_query && item->object)
     gst_mini_object_unref (item->object);
+  if (item->budget) {
+    gst_memory_budget_release (item->budget, item->size);
+    gst_memory_budget_unref (item->budget);
+  }
   g_free (item);
 }
 
@@ -2144,6 +2248,7 @@ gst_multi_queue_buffer_item_new (GstMiniObject * object, guint32 curid)
   if (item->duration == GST_CLOCK_TIME_NONE)
     item->duration = 0;
   item->visible = TRUE;
+  item->budget = NULL;
   return item;
 }
 
@@ -2161,6 +2266,7 @@ gst_multi_queue_mo_item_new (GstMiniObject * object, guint32 curid)
   item->size = 0;
   item->duration = 0;
   item->visible = FALSE;
+  item->budget = NULL;
   return item;
 }
 
@@ -2225,6 +2331,8 @@ next:
    * we might need to wake some sleeping pad up, so there's extra work
    * there too */
   GST_MULTI_QUEUE_MUTEX_LOCK (mq);
+  single_queue_shrink_visible (mq, sq);
+
   if (sq->srcresult == GST_FLOW_NOT_LINKED
       || (sq->last_oldid == G_MAXUINT32) || (newid != (sq->last_oldid + 1))
       || sq->last_oldid > mq->highid) {
@@ -2485,6 +2593,47 @@ out_flushing:
   }
 }
 
+/* Charge the memory budget for the buffer of @item. Returns FALSE if the
+ * budget policy wants it dropped. A warning is posted whenever the budget
+ * goes over its maximum after having been below. */
+static gboolean
+gst_multi_queue_admit_budget (GstMultiQueue * mq, GstSingleQueue * sq,
+    GstMultiQueueItem * item)
+{
+  GstMemoryBudget *budget;
+  gboolean keep, exceeded;
+
+  GST_OBJECT_LOCK (mq);
+  budget = mq->memory_budget ? gst_memory_budget_ref (mq->memory_budget) : NULL;
+  GST_OBJECT_UNLOCK (mq);
+
+  if (budget == NULL)
+    return TRUE;
+
+  keep = gst_memory_budget_admit_buffer (budget, GST_BUFFER_CAST (item->object),
+      item->size, &sq->budget_dropping_deltas, &exceeded);
+
+  if (!exceeded) {
+    g_atomic_int_set (&mq->budget_exceeded, FALSE);
+  } else if (g_atomic_int_compare_and_exchange (&mq->budget_exceeded, FALSE,
+          TRUE)) {
+    GST_ELEMENT_WARNING (mq, RESOURCE, NO_SPACE_LEFT,
+        ("Memory budget exceeded."),
+        ("Memory budget '%s' of %" G_GUINT64_FORMAT " bytes exceeded, now %"
+            G_GUINT64_FORMAT " bytes are queued",
+            gst_memory_budget_get_name (budget),
+            gst_memory_budget_get_max_bytes (budget),
+            gst_memory_budget_get_current_bytes (budget)));
+  }
+
+  if (keep)
+    item->budget = budget;
+  else
+    gst_memory_budget_unref (budget);
+
+  return keep;
+}
+
 /**
  * gst_multi_queue_chain:
  *
@@ -2527,6 +2676,17 @@ gst_multi_queue_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
 
   item = gst_multi_queue_buffer_item_new (GST_MINI_OBJECT_CAST (buffer), curid);
 
+  if (mq->memory_budget && !gst_multi_queue_admit_budget (mq, sq, item))
+    goto budget_drop;
+
+  if (sq->budget_needs_discont) {
+    GST_DEBUG_ID (sq->debug_id, "marking buffer DISCONT after budget drops");
+    buffer = gst_buffer_make_writable (GST_BUFFER_CAST (item->object));
+    GST_BUFFER_FLAG_SET (buffer, GST_BUFFER_FLAG_DISCONT);
+    item->object = GST_MINI_OBJECT_CAST (buffer);
+    sq->budget_needs_discont = FALSE;
+  }
+
   /* Update interleave before pushing data into queue */
   if (mq->use_interleave) {
     GstClockTime val = timestamp;
@@ -2570,6 +2730,14 @@ flushing:
       gst_multi_queue_item_destroy (item);
     goto done;
   }
+budget_drop:
+  {
+    GST_DEBUG_ID (sq->debug_id, "memory budget exceeded, dropping buffer");
+    sq->budget_needs_discont = TRUE;
+    gst_multi_queue_item_destroy (item);
+    gst_object_unref (mq);
+    return GST_FLOW_OK;
+  }
 was_eos:
   {
     GST_DEBUG_OBJECT (mq, "we are EOS, dropping buffer, return EOS");
@@ -3311,6 +3479,30 @@ done:
   }
 }
 
+/* Called with the multiqueue lock. The visible limit grows one buffer at a
+ * time while other queues starve, give the extra room back once the queue
+ * drained below half of it so the limit follows the current interleave
+ * instead of the worst one seen */
+static void
+single_queue_shrink_visible (GstMultiQueue * mq, GstSingleQueue * sq)
+{
+  GstDataQueueSize size;
+  guint new_visible;
+
+  if (mq->max_size.visible == 0 ||
+      sq->max_size.visible <= mq->max_size.visible)
+    return;
+
+  gst_data_queue_get_level (sq->queue, &size);
+  if (size.visible >= sq->max_size.visible / 2)
+    return;
+
+  new_visible = MAX (mq->max_size.visible, sq->max_size.visible / 2);
+  GST_DEBUG_ID (sq->debug_id, "Shrinking max visible from %u to %u",
+      sq->max_size.visible, new_visible);
+  sq->max_size.visible = new_visible;
+}
+
 static void
 single_queue_underrun_cb (GstDataQueue * dq, GstSingleQueue * sq)
 {
@@ -90,6 +90,11 @@ struct _GstMultiQueue {
   gboolean interleave_incomplete; /* TRUE if not all streams were active */
 
   GstClockTime unlinked_cache_time;
+
+  /* shared budget from the memory budget context, protected by the object
+   * lock. Every queued buffer holds a charge on it */
+  GstMemoryBudget *memory_budget;
+  gint budget_exceeded;
 };
 
 struct _GstMultiQueueClass {
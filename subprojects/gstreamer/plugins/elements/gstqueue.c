@@ -122,13 +122,28 @@ enum
   PROP_MIN_THRESHOLD_TIME,
   PROP_LEAKY,
   PROP_SILENT,
-  PROP_FLUSH_ON_EOS
+  PROP_FLUSH_ON_EOS,
+  PROP_SPIN_COUNT,
+  PROP_WAKEUP_WATERMARK
 };
 
 /* default property values */
 #define DEFAULT_MAX_SIZE_BUFFERS  200   /* 200 buffers */
 #define DEFAULT_MAX_SIZE_BYTES    (10 * 1024 * 1024)    /* 10 MB       */
 #define DEFAULT_MAX_SIZE_TIME     GST_SECOND    /* 1 second    */
+#define DEFAULT_SPIN_COUNT        0
+#define DEFAULT_WAKEUP_WATERMARK  100
+
+/* lower bound for the adaptive spin budget */
+#define MIN_SPIN_COUNT            16
+
+#if defined (__GNUC__) && (defined (__i386__) || defined (__x86_64__))
+#define GST_QUEUE_CPU_RELAX() __asm__ __volatile__ ("pause")
+#elif defined (__GNUC__) && defined (__aarch64__)
+#define GST_QUEUE_CPU_RELAX() __asm__ __volatile__ ("yield")
+#else
+#define GST_QUEUE_CPU_RELAX() G_STMT_START { } G_STMT_END
+#endif
 
 #define GST_QUEUE_MUTEX_LOCK(q) G_STMT_START {                          \
   g_mutex_lock (&q->qlock);                                              \
@@ -146,9 +161,11 @@ enum
 
 #define GST_QUEUE_WAIT_DEL_CHECK(q, label) G_STMT_START {               \
   STATUS (q, q->sinkpad, "wait for DEL");                               \
-  q->waiting_del = TRUE;                                                \
-  g_cond_wait (&q->item_del, &q->qlock);                                  \
-  q->waiting_del = FALSE;                                               \
+  if (!gst_queue_spin_wait (q, &q->del_seq, &q->spin_del)) {            \
+    q->waiting_del = TRUE;                                              \
+    g_cond_wait (&q->item_del, &q->qlock);                                \
+    q->waiting_del = FALSE;                                             \
+  }                                                                     \
   if (q->srcresult != GST_FLOW_OK) {                                    \
     STATUS (q, q->srcpad, "received DEL wakeup");                       \
     goto label;                                                         \
@@ -158,9 +175,11 @@ enum
 
 #define GST_QUEUE_WAIT_ADD_CHECK(q, label) G_STMT_START {               \
   STATUS (q, q->srcpad, "wait for ADD");                                \
-  q->waiting_add = TRUE;                                                \
-  g_cond_wait (&q->item_add, &q->qlock);                                  \
-  q->waiting_add = FALSE;                                               \
+  if (!gst_queue_spin_wait (q, &q->add_seq, &q->spin_add)) {            \
+    q->waiting_add = TRUE;                                              \
+    g_cond_wait (&q->item_add, &q->qlock);                                \
+    q->waiting_add = FALSE;                                             \
+  }                                                                     \
   if (q->srcresult != GST_FLOW_OK) {                                    \
     STATUS (q, q->srcpad, "received ADD wakeup");                       \
     goto label;                                                         \
@@ -168,7 +187,9 @@ enum
   STATUS (q, q->srcpad, "received ADD");                                \
 } G_STMT_END
 
+/* the sequence numbers tell a spinning waiter that something changed */
 #define GST_QUEUE_SIGNAL_DEL(q) G_STMT_START {                          \
+  g_atomic_int_inc (&q->del_seq);                                       \
   if (q->waiting_del) {                                                 \
     STATUS (q, q->srcpad, "signal DEL");                                \
     g_cond_signal (&q->item_del);                                        \
@@ -176,6 +197,7 @@ enum
 } G_STMT_END
 
 #define GST_QUEUE_SIGNAL_ADD(q) G_STMT_START {                          \
+  g_atomic_int_inc (&q->add_seq);                                       \
   if (q->waiting_add) {                                                 \
     STATUS (q, q->sinkpad, "signal ADD");                               \
     g_cond_signal (&q->item_add);                                        \
@@ -222,6 +244,12 @@ static gboolean gst_queue_sink_activate_mode (GstPad * pad, GstObject * parent,
 
 static gboolean gst_queue_is_empty (GstQueue * queue);
 static gboolean gst_queue_is_filled (GstQueue * queue);
+static gboolean gst_queue_spin_wait (GstQueue * queue, gint * seq,
+    guint * budget);
+static gboolean gst_queue_is_below_watermark (GstQueue * queue);
+
+static void gst_queue_set_context (GstElement * element, GstContext * context);
+static void gst_queue_update_task_affinity (GstQueue * queue);
 
 
 typedef struct
@@ -405,6 +433,41 @@ gst_queue_class_init (GstQueueClass * klass)
           G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
           G_PARAM_STATIC_STRINGS));
 
+  /**
+   * queue:spin-count:
+   *
+   * Number of iterations to busy-wait for the other streaming thread before
+   * blocking when the queue is empty or full. When upstream and downstream
+   * run on different CPUs and hand over data at a high rate this avoids
+   * most of the sleeps and wakeups. The actual number of iterations adapts
+   * to how often spinning succeeds, up to this value. 0 disables spinning.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_SPIN_COUNT,
+      g_param_spec_uint ("spin-count", "Spin count",
+          "Iterations to busy-wait before blocking (0 = never spin)",
+          0, G_MAXINT, DEFAULT_SPIN_COUNT,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
+  /**
+   * queue:wakeup-watermark:
+   *
+   * Fill level, in percent of the max sizes, the queue has to drain to
+   * before upstream blocked on a full queue is woken up. Lower values let
+   * upstream push bigger batches for every wakeup. With 100 upstream is
+   * woken up as soon as there is space for one more item.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_WAKEUP_WATERMARK,
+      g_param_spec_uint ("wakeup-watermark", "Wakeup watermark",
+          "Percentage of the max sizes below which upstream is woken up "
+          "again when the queue was full", 0, 100, DEFAULT_WAKEUP_WATERMARK,
+          G_PARAM_READWRITE | GST_PARAM_MUTABLE_PLAYING |
+          G_PARAM_STATIC_STRINGS));
+
   gobject_class->finalize = gst_queue_finalize;
 
   gst_element_class_set_static_metadata (gstelement_class,
@@ -413,6 +476,8 @@ gst_queue_class_init (GstQueueClass * klass)
   gst_element_class_add_static_pad_template (gstelement_class, &srctemplate);
   gst_element_class_add_static_pad_template (gstelement_class, &sinktemplate);
 
+  gstelement_class->set_context = gst_queue_set_context;
+
   /* Registering debug symbols for function pointers */
   GST_DEBUG_REGISTER_FUNCPTR (gst_queue_src_activate_mode);
   GST_DEBUG_REGISTER_FUNCPTR (gst_queue_handle_sink_event);
@@ -457,10 +522,14 @@ gst_queue_init (GstQueue * queue)
   gst_segment_init (&queue->sink_segment, GST_FORMAT_TIME);
   gst_segment_init (&queue->src_segment, GST_FORMAT_TIME);
   queue->head_needs_discont = queue->tail_needs_discont = FALSE;
+  queue->budget_dropping_deltas = FALSE;
 
   queue->leaky = GST_QUEUE_NO_LEAK;
   queue->srcresult = GST_FLOW_FLUSHING;
 
+  queue->spin_count = queue->spin_add = queue->spin_del = DEFAULT_SPIN_COUNT;
+  queue->wakeup_watermark = DEFAULT_WAKEUP_WATERMARK;
+
   g_mutex_init (&queue->qlock);
   g_cond_init (&queue->item_add);
   g_cond_init (&queue->item_del);
@@ -498,6 +567,11 @@ gst_queue_finalize (GObject * object)
   }
   gst_queue_array_free (queue->queue);
 
+  if (queue->memory_budget) {
+    gst_memory_budget_release (queue->memory_budget, queue->budget_bytes);
+    gst_memory_budget_unref (queue->memory_budget);
+  }
+
   g_mutex_clear (&queue->qlock);
   g_cond_clear (&queue->item_add);
   g_cond_clear (&queue->item_del);
@@ -698,6 +772,77 @@ apply_buffer_list (GstQueue * queue, GstBufferList * buffer_list,
   update_time_level (queue);
 }
 
+/* release bytes of dequeued or flushed buffers, with QUEUE_LOCK */
+static inline void
+gst_queue_locked_release_budget (GstQueue * queue, gsize size)
+{
+  if (queue->memory_budget == NULL)
+    return;
+
+  /* buffers queued before the budget was set were charged as a whole */
+  size = MIN (size, queue->budget_bytes);
+  gst_memory_budget_release (queue->memory_budget, size);
+  queue->budget_bytes -= size;
+  if (queue->budget_bytes == 0)
+    queue->budget_exceeded = FALSE;
+}
+
+/* charge the memory budget for a new buffer or list, with QUEUE_LOCK.
+ * Returns FALSE when the budget policy wants it dropped, @post_warning is set
+ * when this made the budget go over its maximum */
+static gboolean
+gst_queue_locked_admit_budget (GstQueue * queue, GstMiniObject * obj,
+    gboolean is_list, gboolean * post_warning)
+{
+  GstBuffer *buffer;
+  gboolean exceeded;
+  gsize size;
+
+  if (is_list) {
+    size = gst_buffer_list_calculate_size (GST_BUFFER_LIST_CAST (obj));
+    buffer = NULL;
+  } else {
+    buffer = GST_BUFFER_CAST (obj);
+    size = gst_buffer_get_size (buffer);
+  }
+
+  if (!gst_memory_budget_admit_buffer (queue->memory_budget, buffer, size,
+          &queue->budget_dropping_deltas, &exceeded)) {
+    *post_warning = !queue->budget_exceeded;
+    queue->budget_exceeded = TRUE;
+    return FALSE;
+  }
+
+  *post_warning = exceeded && !queue->budget_exceeded;
+  queue->budget_exceeded = exceeded;
+  queue->budget_bytes += size;
+
+  return TRUE;
+}
+
+static void
+gst_queue_post_budget_warning (GstQueue * queue)
+{
+  GstMemoryBudget *budget;
+
+  GST_QUEUE_MUTEX_LOCK (queue);
+  budget = queue->memory_budget ?
+      gst_memory_budget_ref (queue->memory_budget) : NULL;
+  GST_QUEUE_MUTEX_UNLOCK (queue);
+
+  if (budget == NULL)
+    return;
+
+  GST_ELEMENT_WARNING (queue, RESOURCE, NO_SPACE_LEFT,
+      ("Memory budget exceeded."),
+      ("Memory budget '%s' of %" G_GUINT64_FORMAT " bytes exceeded, now %"
+          G_GUINT64_FORMAT " bytes are queued",
+          gst_memory_budget_get_name (budget),
+          gst_memory_budget_get_max_bytes (budget),
+          gst_memory_budget_get_current_bytes (budget)));
+  gst_memory_budget_unref (budget);
+}
+
 static void
 gst_queue_locked_flush (GstQueue * queue, gboolean full)
 {
@@ -719,12 +864,14 @@ gst_queue_locked_flush (GstQueue * queue, gboolean full)
   queue->last_query = FALSE;
   g_cond_signal (&queue->query_handled);
   GST_QUEUE_CLEAR_LEVEL (queue->cur_level);
+  gst_queue_locked_release_budget (queue, queue->budget_bytes);
   queue->min_threshold.buffers = queue->orig_min_threshold.buffers;
   queue->min_threshold.bytes = queue->orig_min_threshold.bytes;
   queue->min_threshold.time = queue->orig_min_threshold.time;
   gst_segment_init (&queue->sink_segment, GST_FORMAT_TIME);
   gst_segment_init (&queue->src_segment, GST_FORMAT_TIME);
   queue->head_needs_discont = queue->tail_needs_discont = FALSE;
+  queue->budget_dropping_deltas = FALSE;
 
   queue->sinktime = queue->srctime = GST_CLOCK_STIME_NONE;
   queue->sink_tainted = queue->src_tainted = TRUE;
@@ -841,6 +988,7 @@ gst_queue_locked_dequeue (GstQueue * queue)
 
     queue->cur_level.buffers--;
     queue->cur_level.bytes -= bufsize;
+    gst_queue_locked_release_budget (queue, bufsize);
     apply_buffer (queue, buffer, &queue->src_segment, FALSE);
 
     /* if the queue is empty now, update the other side */
@@ -854,6 +1002,7 @@ gst_queue_locked_dequeue (GstQueue * queue)
 
     queue->cur_level.buffers -= gst_buffer_list_length (buffer_list);
     queue->cur_level.bytes -= bufsize;
+    gst_queue_locked_release_budget (queue, bufsize);
     apply_buffer_list (queue, buffer_list, &queue->src_segment, FALSE);
 
     /* if the queue is empty now, update the other side */
@@ -895,7 +1044,9 @@ gst_queue_locked_dequeue (GstQueue * queue)
         item, GST_OBJECT_NAME (queue));
     item = NULL;
   }
-  GST_QUEUE_SIGNAL_DEL (queue);
+  /* batch the wakeups of upstream blocked on a full queue */
+  if (gst_queue_is_below_watermark (queue))
+    GST_QUEUE_SIGNAL_DEL (queue);
 
   return item;
 
@@ -1134,6 +1285,57 @@ gst_queue_is_filled (GstQueue * queue)
               queue->cur_level.time >= queue->max_size.time)));
 }
 
+/* called with the queue lock */
+static gboolean
+gst_queue_is_below_watermark (GstQueue * queue)
+{
+  guint wm = queue->wakeup_watermark;
+
+  if (wm >= 100)
+    return TRUE;
+
+  return !((queue->max_size.buffers > 0 &&
+          queue->cur_level.buffers >
+          (guint64) queue->max_size.buffers * wm / 100) ||
+      (queue->max_size.bytes > 0 &&
+          queue->cur_level.bytes > (guint64) queue->max_size.bytes * wm / 100)
+      || (queue->max_size.time > 0
+          && queue->cur_level.time >
+          gst_util_uint64_scale_int (queue->max_size.time, wm, 100)));
+}
+
+/* called with the queue lock. Busy-wait for the other streaming thread to
+ * change @seq before we block on the condition variable. All changes to @seq
+ * are done with the queue lock, so when it is unchanged after relocking
+ * nothing happened and it is safe to block. Returns %TRUE when @seq changed
+ * and the caller has to check its condition again. */
+static gboolean
+gst_queue_spin_wait (GstQueue * queue, gint * seq, guint * budget)
+{
+  gint old_seq;
+  guint i, n;
+
+  if (*budget == 0)
+    return FALSE;
+
+  old_seq = g_atomic_int_get (seq);
+  n = *budget;
+
+  GST_QUEUE_MUTEX_UNLOCK (queue);
+  for (i = 0; i < n && g_atomic_int_get (seq) == old_seq; i++)
+    GST_QUEUE_CPU_RELAX ();
+  GST_QUEUE_MUTEX_LOCK (queue);
+
+  /* spin longer when it helps, shorter when we did it for nothing */
+  if (g_atomic_int_get (seq) != old_seq) {
+    *budget = MIN (*budget * 2, queue->spin_count);
+    return TRUE;
+  }
+
+  *budget = MIN (MAX (*budget / 2, MIN_SPIN_COUNT), queue->spin_count);
+  return FALSE;
+}
+
 static void
 gst_queue_leak_downstream (GstQueue * queue)
 {
@@ -1183,6 +1385,7 @@ gst_queue_chain_buffer_or_list (GstPad * pad, GstObject * parent,
     GstMiniObject * obj, gboolean is_list)
 {
   GstQueue *queue;
+  gboolean post_warning = FALSE;
 
   queue = GST_QUEUE_CAST (parent);
 
@@ -1263,6 +1466,15 @@ gst_queue_chain_buffer_or_list (GstPad * pad, GstObject * parent,
     }
   }
 
+  if (queue->memory_budget &&
+      !gst_queue_locked_admit_budget (queue, obj, is_list, &post_warning)) {
+    GST_CAT_DEBUG_OBJECT (queue_dataflow, queue,
+        "memory budget exceeded, dropping %s %p",
+        is_list ? "buffer list" : "buffer", obj);
+    queue->tail_needs_discont = TRUE;
+    goto out_budget_drop;
+  }
+
   if (queue->tail_needs_discont) {
     if (!is_list) {
       GstBuffer *buffer = GST_BUFFER_CAST (obj);
@@ -1293,6 +1505,9 @@ gst_queue_chain_buffer_or_list (GstPad * pad, GstObject * parent,
     gst_queue_locked_enqueue_buffer (queue, obj);
   GST_QUEUE_MUTEX_UNLOCK (queue);
 
+  if (G_UNLIKELY (post_warning))
+    gst_queue_post_budget_warning (queue);
+
   return GST_FLOW_OK;
 
   /* special conditions */
@@ -1302,6 +1517,16 @@ out_unref:
 
     gst_mini_object_unref (obj);
 
+    return GST_FLOW_OK;
+  }
+out_budget_drop:
+  {
+    GST_QUEUE_MUTEX_UNLOCK (queue);
+
+    gst_mini_object_unref (obj);
+    if (post_warning)
+      gst_queue_post_budget_warning (queue);
+
     return GST_FLOW_OK;
   }
 out_flushing:
@@ -1734,6 +1959,70 @@ gst_queue_sink_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
   return result;
 }
 
+/* apply the task affinity context, if any, to the streaming thread */
+static void
+gst_queue_update_task_affinity (GstQueue * queue)
+{
+  GstContext *context;
+  GstTask *task = NULL;
+
+  context = gst_element_get_context (GST_ELEMENT_CAST (queue),
+      GST_TASK_AFFINITY_CONTEXT_TYPE);
+  if (context == NULL)
+    return;
+
+  GST_OBJECT_LOCK (queue->srcpad);
+  if (GST_PAD_TASK (queue->srcpad))
+    task = gst_object_ref (GST_PAD_TASK (queue->srcpad));
+  GST_OBJECT_UNLOCK (queue->srcpad);
+
+  if (task) {
+    gst_task_set_affinity_from_context (task, context);
+    gst_object_unref (task);
+  }
+  gst_context_unref (context);
+}
+
+/* switch to the budget of the context, moving the charge for the currently
+ * queued buffers over to it */
+static void
+gst_queue_update_memory_budget (GstQueue * queue, GstContext * context)
+{
+  GstMemoryBudget *budget, *old;
+
+  budget = gst_memory_budget_from_context (context);
+  if (budget == NULL)
+    return;
+
+  GST_QUEUE_MUTEX_LOCK (queue);
+  old = queue->memory_budget;
+  if (old)
+    gst_memory_budget_release (old, queue->budget_bytes);
+  queue->memory_budget = budget;
+  queue->budget_bytes = queue->cur_level.bytes;
+  queue->budget_exceeded =
+      !gst_memory_budget_charge (budget, queue->budget_bytes);
+  GST_QUEUE_MUTEX_UNLOCK (queue);
+
+  GST_DEBUG_OBJECT (queue, "using memory budget %s",
+      gst_memory_budget_get_name (budget));
+
+  if (old)
+    gst_memory_budget_unref (old);
+}
+
+static void
+gst_queue_set_context (GstElement * element, GstContext * context)
+{
+  GST_ELEMENT_CLASS (parent_class)->set_context (element, context);
+
+  if (gst_context_has_context_type (context, GST_TASK_AFFINITY_CONTEXT_TYPE))
+    gst_queue_update_task_affinity (GST_QUEUE (element));
+  else if (gst_context_has_context_type (context,
+          GST_MEMORY_BUDGET_CONTEXT_TYPE))
+    gst_queue_update_memory_budget (GST_QUEUE (element), context);
+}
+
 static gboolean
 gst_queue_src_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
     gboolean active)
@@ -1754,12 +2043,14 @@ gst_queue_src_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
             gst_pad_start_task (pad, (GstTaskFunction) gst_queue_loop, pad,
             NULL);
         GST_QUEUE_MUTEX_UNLOCK (queue);
+
+        gst_queue_update_task_affinity (queue);
       } else {
         /* step 1, unblock loop function */
         GST_QUEUE_MUTEX_LOCK (queue);
         queue->srcresult = GST_FLOW_FLUSHING;
         /* the item add signal will unblock */
-        g_cond_signal (&queue->item_add);
+        GST_QUEUE_SIGNAL_ADD (queue);
         GST_QUEUE_MUTEX_UNLOCK (queue);
 
         /* step 2, make sure streaming finishes */
@@ -1844,6 +2135,15 @@ gst_queue_set_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       queue->flush_on_eos = g_value_get_boolean (value);
       break;
+    case PROP_SPIN_COUNT:
+      queue->spin_count = queue->spin_add = queue->spin_del =
+          g_value_get_uint (value);
+      break;
+    case PROP_WAKEUP_WATERMARK:
+      queue->wakeup_watermark = g_value_get_uint (value);
+      /* upstream might be waiting for a lower level than the new one */
+      GST_QUEUE_SIGNAL_DEL (queue);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -1897,6 +2197,12 @@ gst_queue_get_property (GObject * object,
     case PROP_FLUSH_ON_EOS:
       g_value_set_boolean (value, queue->flush_on_eos);
       break;
+    case PROP_SPIN_COUNT:
+      g_value_set_uint (value, queue->spin_count);
+      break;
+    case PROP_WAKEUP_WATERMARK:
+      g_value_set_uint (value, queue->wakeup_watermark);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -138,6 +138,22 @@ struct _GstQueue {
   GstQuery *last_handled_query;
 
   gboolean flush_on_eos; /* flush on EOS */
+
+  /* busy-waiting before blocking, the budgets adapt up to spin_count */
+  guint spin_count;
+  guint spin_add, spin_del;
+  /* bumped on every ADD/DEL signal, for spinning waiters */
+  gint add_seq, del_seq;
+
+  /* percentage of max_size to drain to before waking up upstream */
+  guint wakeup_watermark;
+
+  /* shared budget from the memory budget context, charged with the bytes of
+   * the queued buffers */
+  GstMemoryBudget *memory_budget;
+  guint64 budget_bytes;
+  gboolean budget_exceeded;
+  gboolean budget_dropping_deltas;
 };
 
 struct _GstQueueClass {
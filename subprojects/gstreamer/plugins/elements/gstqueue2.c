@@ -85,6 +85,11 @@
 #include <fcntl.h>
 #endif
 
+#if defined (HAVE_SYS_MMAN_H) && defined (HAVE_MMAP)
+#include <sys/mman.h>
+#define HAVE_QUEUE2_MMAP 1
+#endif
+
 static GstStaticPadTemplate sinktemplate = GST_STATIC_PAD_TEMPLATE ("sink",
     GST_PAD_SINK,
     GST_PAD_ALWAYS,
@@ -109,6 +114,8 @@ enum
 #define QUEUE_IS_USING_TEMP_FILE(queue) ((queue)->temp_template != NULL)
 #define QUEUE_IS_USING_RING_BUFFER(queue) ((queue)->ring_buffer_max_size != 0)  /* for consistency with the above macro */
 #define QUEUE_IS_USING_QUEUE(queue) (!QUEUE_IS_USING_TEMP_FILE(queue) && !QUEUE_IS_USING_RING_BUFFER (queue))
+/* the temp file is accessed with stdio unless it's mapped, see use-mmap */
+#define QUEUE_IS_USING_FILE_IO(queue) (QUEUE_IS_USING_TEMP_FILE(queue) && (queue)->mapping == NULL)
 
 #define QUEUE_MAX_BYTES(queue) MIN((queue)->max_level.bytes, (queue)->ring_buffer_max_size)
 
@@ -126,6 +133,7 @@ enum
 #define DEFAULT_TEMP_REMOVE        TRUE
 #define DEFAULT_RING_BUFFER_MAX_SIZE 0
 #define DEFAULT_USE_BITRATE_QUERY  TRUE
+#define DEFAULT_USE_MMAP           FALSE
 
 enum
 {
@@ -150,6 +158,7 @@ enum
   PROP_AVG_IN_RATE,
   PROP_USE_BITRATE_QUERY,
   PROP_BITRATE,
+  PROP_USE_MMAP,
   PROP_LAST
 };
 static GParamSpec *obj_props[PROP_LAST] = { NULL, };
@@ -473,6 +482,22 @@ gst_queue2_class_init (GstQueue2Class * klass)
       "Conversion value between data size and time",
       0, G_MAXUINT64, 0, G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GstQueue2:use-mmap
+   *
+   * When both #GstQueue2:temp-template and #GstQueue2:ring-buffer-max-size
+   * are set, map the temporary file into memory instead of reading and
+   * writing it. Output buffers then wrap the mapped data without copying,
+   * and the ring buffer is not overwritten while downstream still uses them,
+   * so the ring buffer has to be larger than what downstream keeps around.
+   *
+   * Since: 1.24
+   */
+  obj_props[PROP_USE_MMAP] = g_param_spec_boolean ("use-mmap", "Use mmap",
+      "Map the temp file ring buffer into memory and output buffers "
+      "wrapping it", DEFAULT_USE_MMAP,
+      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS);
+
   g_object_class_install_properties (gobject_class, PROP_LAST, obj_props);
 
   /* set several parent class virtual functions */
@@ -568,6 +593,7 @@ gst_queue2_init (GstQueue2 * queue)
 
   queue->ring_buffer = NULL;
   queue->ring_buffer_max_size = DEFAULT_RING_BUFFER_MAX_SIZE;
+  queue->use_mmap = DEFAULT_USE_MMAP;
 
   queue->use_bitrate_query = DEFAULT_USE_BITRATE_QUERY;
 
@@ -1487,6 +1513,219 @@ gst_queue2_have_data (GstQueue2 * queue, guint64 offset, guint length)
 #define FSEEK_FILE(file,offset)  (fseek (file, offset, SEEK_SET) != 0)
 #endif
 
+#ifdef HAVE_QUEUE2_MMAP
+/* The ring buffer in the mapped temp file. Output buffers wrap it directly
+ * and keep a reference, it is unmapped when the last one is released */
+struct _GstQueue2Mapping
+{
+  gint refcount;
+  guint8 *data;
+  gsize size;
+
+  GMutex lock;
+  /* the queue to wake up when regions are released, NULL once the queue
+   * closed the temp file */
+  GstQueue2 *queue;
+  /* regions used by output buffers, protected by lock */
+  GQueue exports;
+};
+
+typedef struct
+{
+  GstQueue2Mapping *mapping;
+  gsize offset;
+  gsize size;
+  GList link;
+} GstQueue2Export;
+
+static GstQueue2Mapping *
+gst_queue2_mapping_new (GstQueue2 * queue, gint fd, guint64 size)
+{
+  GstQueue2Mapping *mapping;
+  gpointer data;
+
+  if (size > G_MAXSIZE)
+    goto too_big;
+
+  /* make the whole ring buffer part of the file, we don't want SIGBUS */
+  if (ftruncate (fd, size) < 0)
+    goto resize_failed;
+
+  data = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED)
+    goto map_failed;
+
+  mapping = g_new0 (GstQueue2Mapping, 1);
+  mapping->refcount = 1;
+  mapping->data = data;
+  mapping->size = size;
+  g_mutex_init (&mapping->lock);
+  mapping->queue = queue;
+  g_queue_init (&mapping->exports);
+
+  return mapping;
+
+  /* ERRORS */
+too_big:
+  {
+    GST_WARNING_OBJECT (queue, "ring buffer too big to map");
+    return NULL;
+  }
+resize_failed:
+  {
+    GST_WARNING_OBJECT (queue, "failed to resize temp file: %s",
+        g_strerror (errno));
+    return NULL;
+  }
+map_failed:
+  {
+    GST_WARNING_OBJECT (queue, "failed to map temp file: %s",
+        g_strerror (errno));
+    return NULL;
+  }
+}
+
+static void
+gst_queue2_mapping_unref (GstQueue2Mapping * mapping)
+{
+  if (!g_atomic_int_dec_and_test (&mapping->refcount))
+    return;
+
+  munmap (mapping->data, mapping->size);
+  g_mutex_clear (&mapping->lock);
+  g_free (mapping);
+}
+
+/* called by the queue when closing the temp file, output buffers might still
+ * be alive */
+static void
+gst_queue2_mapping_close (GstQueue2Mapping * mapping)
+{
+  g_mutex_lock (&mapping->lock);
+  mapping->queue = NULL;
+  g_mutex_unlock (&mapping->lock);
+
+  gst_queue2_mapping_unref (mapping);
+}
+
+static void
+gst_queue2_mapping_release (GstQueue2Export * export)
+{
+  GstQueue2Mapping *mapping = export->mapping;
+
+#ifdef MADV_DONTNEED
+  {
+    static gsize page_size = 0;
+    gsize start, end;
+
+    if (page_size == 0)
+      page_size = sysconf (_SC_PAGESIZE);
+
+    /* the data stays in the file, but there's no need to keep the pages of
+     * consumed regions mapped */
+    start = GST_ROUND_UP_N (export->offset, page_size);
+    end = GST_ROUND_DOWN_N (export->offset + export->size, page_size);
+    if (end > start)
+      madvise (mapping->data + start, end - start, MADV_DONTNEED);
+  }
+#endif
+
+  g_mutex_lock (&mapping->lock);
+  g_queue_unlink (&mapping->exports, &export->link);
+  /* this can be called with the queue lock held, so just signal a writer
+   * waiting for free space without taking it */
+  if (mapping->queue)
+    g_cond_signal (&mapping->queue->item_del);
+  g_mutex_unlock (&mapping->lock);
+
+  g_free (export);
+  gst_queue2_mapping_unref (mapping);
+}
+
+static GstBuffer *
+gst_queue2_mapping_wrap (GstQueue2Mapping * mapping, gsize offset, gsize size)
+{
+  GstQueue2Export *export;
+
+  export = g_new0 (GstQueue2Export, 1);
+  g_atomic_int_inc (&mapping->refcount);
+  export->mapping = mapping;
+  export->offset = offset;
+  export->size = size;
+  export->link.data = export;
+
+  g_mutex_lock (&mapping->lock);
+  g_queue_push_tail_link (&mapping->exports, &export->link);
+  g_mutex_unlock (&mapping->lock);
+
+  return gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY,
+      mapping->data + offset, size, 0, size, export,
+      (GDestroyNotify) gst_queue2_mapping_release);
+}
+
+/* returns how many bytes can be written at @offset without overwriting data
+ * that is still used by output buffers */
+static guint64
+gst_queue2_mapping_get_writable (GstQueue2Mapping * mapping, guint64 offset)
+{
+  guint64 writable = mapping->size;
+  GList *l;
+
+  g_mutex_lock (&mapping->lock);
+  for (l = mapping->exports.head; l; l = l->next) {
+    GstQueue2Export *export = l->data;
+
+    if (offset >= export->offset && offset < export->offset + export->size) {
+      writable = 0;
+      break;
+    }
+
+    if (export->offset > offset)
+      writable = MIN (writable, export->offset - offset);
+    else
+      writable = MIN (writable, mapping->size - offset + export->offset);
+  }
+  g_mutex_unlock (&mapping->lock);
+
+  return writable;
+}
+
+/* wraps the mapped ring buffer if the requested data is available in one
+ * piece, returns NULL if it has to be read normally */
+static GstBuffer *
+gst_queue2_create_read_mapped (GstQueue2 * queue, guint64 offset,
+    guint length)
+{
+  GstQueue2Range *range = queue->current;
+  guint64 rb_size = queue->ring_buffer_max_size;
+  guint64 file_offset;
+  GstBuffer *buf;
+
+  if (range == NULL || offset < range->offset ||
+      offset + length > range->writing_pos)
+    return NULL;
+
+  file_offset = (range->rb_offset + (offset - range->offset)) % rb_size;
+  if (file_offset + length > rb_size)
+    return NULL;
+
+  GST_DEBUG_OBJECT (queue, "Wrapping %u bytes from %" G_GUINT64_FORMAT
+      " at ring buffer offset %" G_GUINT64_FORMAT, length, offset,
+      file_offset);
+
+  buf = gst_queue2_mapping_wrap (queue->mapping, file_offset, length);
+
+  range->reading_pos = offset + length;
+  update_cur_pos (queue, range, range->reading_pos);
+  GST_QUEUE2_SIGNAL_DEL (queue);
+
+  GST_BUFFER_OFFSET (buf) = offset;
+  GST_BUFFER_OFFSET_END (buf) = offset + length;
+
+  return buf;
+}
+#endif
+
 static GstFlowReturn
 gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
     guint8 * dst, gint64 * read_return)
@@ -1496,13 +1735,13 @@ gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
 
   ring_buffer = queue->ring_buffer;
 
-  if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, offset))
+  if (QUEUE_IS_USING_FILE_IO (queue) && FSEEK_FILE (queue->temp_file, offset))
     goto seek_failed;
 
   /* this should not block */
   GST_LOG_OBJECT (queue, "Reading %d bytes from offset %" G_GUINT64_FORMAT,
       length, offset);
-  if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+  if (QUEUE_IS_USING_FILE_IO (queue)) {
     res = fread (dst, 1, length, queue->temp_file);
   } else {
     memcpy (dst, ring_buffer + offset, length);
@@ -1512,7 +1751,7 @@ gst_queue2_read_data_at_offset (GstQueue2 * queue, guint64 offset, guint length,
   GST_LOG_OBJECT (queue, "read %" G_GSIZE_FORMAT " bytes", res);
 
   if (G_UNLIKELY (res < length)) {
-    if (!QUEUE_IS_USING_TEMP_FILE (queue))
+    if (!QUEUE_IS_USING_FILE_IO (queue))
       goto could_not_read;
     /* check for errors or EOF */
     if (ferror (queue->temp_file))
@@ -1556,6 +1795,14 @@ gst_queue2_create_read (GstQueue2 * queue, guint64 offset, guint length,
   guint64 rpos;
   GstFlowReturn ret = GST_FLOW_OK;
 
+#ifdef HAVE_QUEUE2_MMAP
+  if (*buffer == NULL && queue->mapping &&
+      (buf = gst_queue2_create_read_mapped (queue, offset, length))) {
+    *buffer = buf;
+    return GST_FLOW_OK;
+  }
+#endif
+
   /* allocate the output buffer of the requested size */
   if (*buffer == NULL)
     buf = gst_buffer_new_allocate (NULL, length, NULL);
@@ -1799,6 +2046,20 @@ gst_queue2_open_temp_location_file (GstQueue2 * queue)
   if (queue->temp_file == NULL)
     goto open_failed;
 
+#ifdef HAVE_QUEUE2_MMAP
+  if (queue->use_mmap && QUEUE_IS_USING_RING_BUFFER (queue)) {
+    queue->mapping =
+        gst_queue2_mapping_new (queue, fd, queue->ring_buffer_max_size);
+    if (queue->mapping) {
+      GST_DEBUG_OBJECT (queue, "mapped ring buffer of %" G_GUINT64_FORMAT
+          " bytes", queue->ring_buffer_max_size);
+      queue->ring_buffer = queue->mapping->data;
+    } else {
+      GST_WARNING_OBJECT (queue, "falling back to file I/O");
+    }
+  }
+#endif
+
   g_free (queue->temp_location);
   queue->temp_location = name;
 
@@ -1853,6 +2114,14 @@ gst_queue2_close_temp_location_file (GstQueue2 * queue)
 
   GST_DEBUG_OBJECT (queue, "closing temp file");
 
+#ifdef HAVE_QUEUE2_MMAP
+  if (queue->mapping) {
+    gst_queue2_mapping_close (queue->mapping);
+    queue->mapping = NULL;
+    queue->ring_buffer = NULL;
+  }
+#endif
+
   fflush (queue->temp_file);
   fclose (queue->temp_file);
 
@@ -1873,6 +2142,10 @@ gst_queue2_flush_temp_file (GstQueue2 * queue)
   if (queue->temp_file == NULL)
     return;
 
+  /* truncating would invalidate the mapping, the ranges are reset anyway */
+  if (queue->mapping)
+    return;
+
   GST_DEBUG_OBJECT (queue, "flushing temp file");
 
   queue->temp_file = g_freopen (queue->temp_location, "wb+", queue->temp_file);
@@ -2004,6 +2277,29 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       /* get the amount of space we have */
       space = QUEUE_MAX_BYTES (queue) - queue->cur_level.bytes;
 
+#ifdef HAVE_QUEUE2_MMAP
+      if (queue->mapping) {
+        guint64 writable;
+
+        /* don't overwrite data that output buffers still point to */
+        while ((writable = gst_queue2_mapping_get_writable (queue->mapping,
+                    writing_pos)) == 0) {
+          gint64 end_time;
+
+          if (queue->sinkresult != GST_FLOW_OK)
+            goto out_flushing;
+
+          GST_DEBUG_OBJECT (queue, "waiting for output buffers to be freed");
+          /* releasing doesn't take our lock, so don't rely on the signal */
+          end_time = g_get_monotonic_time () + 10 * G_TIME_SPAN_MILLISECOND;
+          queue->waiting_del = TRUE;
+          g_cond_wait_until (&queue->item_del, &queue->qlock, end_time);
+          queue->waiting_del = FALSE;
+        }
+        space = MIN (space, writable);
+      }
+#endif
+
       /* calculate if we need to split or if we can write the entire
        * buffer now */
       to_write = MIN (size, space);
@@ -2112,7 +2408,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       new_writing_pos = writing_pos + to_write;
     }
 
-    if (QUEUE_IS_USING_TEMP_FILE (queue)
+    if (QUEUE_IS_USING_FILE_IO (queue)
         && FSEEK_FILE (queue->temp_file, writing_pos))
       goto seek_failed;
 
@@ -2122,7 +2418,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
           "] (rb wpos %" G_GUINT64_FORMAT ")", to_write, queue->current->offset,
           queue->current->writing_pos, queue->current->rb_writing_pos);
       /* either not using ring buffer or no wrapping, just write */
-      if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+      if (QUEUE_IS_USING_FILE_IO (queue)) {
         if (fwrite (data, to_write, 1, queue->temp_file) != 1)
           goto handle_error;
       } else {
@@ -2167,7 +2463,7 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
       if (block_one > 0) {
         GST_INFO_OBJECT (queue, "writing %u bytes", block_one);
         /* write data to end of ring buffer */
-        if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+        if (QUEUE_IS_USING_FILE_IO (queue)) {
           if (fwrite (data, block_one, 1, queue->temp_file) != 1)
             goto handle_error;
         } else {
@@ -2175,12 +2471,12 @@ gst_queue2_create_write (GstQueue2 * queue, GstBuffer * buffer)
         }
       }
 
-      if (QUEUE_IS_USING_TEMP_FILE (queue) && FSEEK_FILE (queue->temp_file, 0))
+      if (QUEUE_IS_USING_FILE_IO (queue) && FSEEK_FILE (queue->temp_file, 0))
         goto seek_failed;
 
       if (block_two > 0) {
         GST_INFO_OBJECT (queue, "writing %u bytes", block_two);
-        if (QUEUE_IS_USING_TEMP_FILE (queue)) {
+        if (QUEUE_IS_USING_FILE_IO (queue)) {
           if (fwrite (data + block_one, block_two, 1, queue->temp_file) != 1)
             goto handle_error;
         } else {
@@ -3994,6 +4290,9 @@ gst_queue2_set_property (GObject * object,
     case PROP_RING_BUFFER_MAX_SIZE:
       queue->ring_buffer_max_size = g_value_get_uint64 (value);
       break;
+    case PROP_USE_MMAP:
+      queue->use_mmap = g_value_get_boolean (value);
+      break;
     case PROP_USE_BITRATE_QUERY:
       queue->use_bitrate_query = g_value_get_boolean (value);
       break;
@@ -4068,6 +4367,9 @@ gst_queue2_get_property (GObject * object,
     case PROP_RING_BUFFER_MAX_SIZE:
       g_value_set_uint64 (value, queue->ring_buffer_max_size);
       break;
+    case PROP_USE_MMAP:
+      g_value_set_boolean (value, queue->use_mmap);
+      break;
     case PROP_AVG_IN_RATE:
     {
       gdouble in_rate = queue->byte_in_rate;
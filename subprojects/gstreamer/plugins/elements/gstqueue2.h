@@ -47,6 +47,7 @@ typedef struct _GstQueue2 GstQueue2;
 typedef struct _GstQueue2Size GstQueue2Size;
 typedef struct _GstQueue2Class GstQueue2Class;
 typedef struct _GstQueue2Range GstQueue2Range;
+typedef struct _GstQueue2Mapping GstQueue2Mapping;
 
 /* used to keep track of sizes (current and max) */
 struct _GstQueue2Size
@@ -163,6 +164,8 @@ struct _GstQueue2
 
   guint64 ring_buffer_max_size;
   guint8 * ring_buffer;
+  gboolean use_mmap;
+  GstQueue2Mapping *mapping;
 
   gint downstream_may_block;
 
@@ -35,6 +35,15 @@
  * provide separate threads for each branch. Otherwise a blocked dataflow in one
  * branch would stall the other branches.
  *
+ * Alternatively, the branches can be queued inside tee by setting the
+ * #GstTeePad:max-size-buffers property on the src pads. The queued branches
+ * are pushed from a pool of worker threads shared by all of them, and
+ * #GstTeePad:leaky allows a slow branch to drop buffers instead of stalling
+ * the other branches (Since: 1.24). A worker stays with its branch while
+ * downstream blocks, e.g. in preroll or when waiting for the clock, so every
+ * queued branch with data pending always gets its own worker, even when that
+ * means using more than #GstTee:max-threads threads.
+ *
  * ## Example launch line
  * |[
  * gst-launch-1.0 filesrc location=song.ogg ! decodebin ! tee name=t ! queue ! audioconvert ! audioresample ! autoaudiosink t. ! queue ! audioconvert ! goom ! videoconvert ! autovideosink
@@ -53,6 +62,8 @@
 #include "gstcoreelementselements.h"
 #include "gst/glib-compat-private.h"
 
+#include <gst/base/gstqueuearray.h>
+
 #include <string.h>
 #include <stdio.h>
 
@@ -82,12 +93,35 @@ gst_tee_pull_mode_get_type (void)
   return type;
 }
 
+#define GST_TYPE_TEE_LEAKY (gst_tee_leaky_get_type())
+static GType
+gst_tee_leaky_get_type (void)
+{
+  static GType type = 0;
+  static const GEnumValue data[] = {
+    {GST_TEE_NO_LEAK, "Not Leaky", "no"},
+    {GST_TEE_LEAK_UPSTREAM, "Leaky on upstream (new buffers)", "upstream"},
+    {GST_TEE_LEAK_DOWNSTREAM, "Leaky on downstream (old buffers)",
+        "downstream"},
+    {0, NULL, NULL},
+  };
+
+  if (!type) {
+    type = g_enum_register_static ("GstTeeLeaky", data);
+  }
+  return type;
+}
+
 #define DEFAULT_PROP_NUM_SRC_PADS	0
 #define DEFAULT_PROP_HAS_CHAIN		TRUE
 #define DEFAULT_PROP_SILENT		TRUE
 #define DEFAULT_PROP_LAST_MESSAGE	NULL
 #define DEFAULT_PULL_MODE		GST_TEE_PULL_MODE_NEVER
 #define DEFAULT_PROP_ALLOW_NOT_LINKED	FALSE
+#define DEFAULT_PROP_MAX_THREADS	0
+
+#define DEFAULT_PAD_PROP_MAX_SIZE_BUFFERS	0
+#define DEFAULT_PAD_PROP_LEAKY		GST_TEE_NO_LEAK
 
 enum
 {
@@ -99,6 +133,14 @@ enum
   PROP_PULL_MODE,
   PROP_ALLOC_PAD,
   PROP_ALLOW_NOT_LINKED,
+  PROP_MAX_THREADS,
+};
+
+enum
+{
+  PAD_PROP_0,
+  PAD_PROP_MAX_SIZE_BUFFERS,
+  PAD_PROP_LEAKY,
 };
 
 static GstStaticPadTemplate src_template = GST_STATIC_PAD_TEMPLATE ("src_%u",
@@ -141,6 +183,19 @@ struct _GstTeePad
   gboolean pushed;
   GstFlowReturn result;
   gboolean removed;
+
+  /* branch queue, protected by lock */
+  GMutex lock;
+  GCond cond;
+  guint max_size_buffers;
+  GstTeeLeaky leaky;
+  GstQueueArray *queue;
+  guint cur_buffers;
+  gboolean flushing;
+  /* a worker is pushing the queue or will be doing so */
+  gboolean scheduled;
+  GThread *worker;
+  GstFlowReturn srcresult;
 };
 
 struct _GstTeePadClass
@@ -150,9 +205,49 @@ struct _GstTeePadClass
 
 G_DEFINE_TYPE (GstTeePad, gst_tee_pad, GST_TYPE_PAD);
 
+static void gst_tee_pad_finalize (GObject * object);
+static void gst_tee_pad_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec);
+static void gst_tee_pad_get_property (GObject * object, guint prop_id,
+    GValue * value, GParamSpec * pspec);
+
 static void
 gst_tee_pad_class_init (GstTeePadClass * klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  gobject_class->finalize = gst_tee_pad_finalize;
+  gobject_class->set_property = gst_tee_pad_set_property;
+  gobject_class->get_property = gst_tee_pad_get_property;
+
+  /**
+   * GstTeePad:max-size-buffers:
+   *
+   * Maximum number of buffers queued for this branch. When non-zero, data is
+   * pushed on this pad from the worker threads of tee instead of the
+   * upstream streaming thread, so that a slow branch does not delay the
+   * other ones. 0 pushes directly from the streaming thread.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PAD_PROP_MAX_SIZE_BUFFERS,
+      g_param_spec_uint ("max-size-buffers", "Max. size (buffers)",
+          "Max. number of buffers queued for this branch (0=not queued)",
+          0, G_MAXUINT, DEFAULT_PAD_PROP_MAX_SIZE_BUFFERS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * GstTeePad:leaky:
+   *
+   * What to do when the queue of this branch is full. By default the
+   * upstream streaming thread blocks until there is space again.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PAD_PROP_LEAKY,
+      g_param_spec_enum ("leaky", "Leaky",
+          "Where the branch queue leaks, if at all", GST_TYPE_TEE_LEAKY,
+          DEFAULT_PAD_PROP_LEAKY, G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static void
@@ -167,6 +262,288 @@ static void
 gst_tee_pad_init (GstTeePad * pad)
 {
   gst_tee_pad_reset (pad);
+
+  g_mutex_init (&pad->lock);
+  g_cond_init (&pad->cond);
+  pad->max_size_buffers = DEFAULT_PAD_PROP_MAX_SIZE_BUFFERS;
+  pad->leaky = DEFAULT_PAD_PROP_LEAKY;
+  pad->queue = gst_queue_array_new (16);
+  pad->srcresult = GST_FLOW_OK;
+}
+
+/* call with the object lock of @tee */
+static void
+gst_tee_update_max_threads (GstTee * tee)
+{
+  guint max_threads;
+
+  max_threads = tee->max_threads ? tee->max_threads : g_get_num_processors ();
+  /* never make a branch wait for another one to unblock */
+  max_threads = MAX (max_threads, tee->n_scheduled);
+
+  if (max_threads != (guint) g_thread_pool_get_max_threads (tee->pool)) {
+    GST_DEBUG_OBJECT (tee, "using up to %u worker threads", max_threads);
+    g_thread_pool_set_max_threads (tee->pool, max_threads, NULL);
+  }
+}
+
+/* call with the pad lock */
+static void
+gst_tee_pad_clear_queue (GstTeePad * pad)
+{
+  GstMiniObject *item;
+
+  while ((item = gst_queue_array_pop_head (pad->queue)))
+    gst_mini_object_unref (item);
+  pad->cur_buffers = 0;
+}
+
+static void
+gst_tee_pad_finalize (GObject * object)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+
+  gst_tee_pad_clear_queue (pad);
+  gst_queue_array_free (pad->queue);
+  g_mutex_clear (&pad->lock);
+  g_cond_clear (&pad->cond);
+
+  G_OBJECT_CLASS (gst_tee_pad_parent_class)->finalize (object);
+}
+
+static void
+gst_tee_pad_set_property (GObject * object, guint prop_id,
+    const GValue * value, GParamSpec * pspec)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+
+  g_mutex_lock (&pad->lock);
+  switch (prop_id) {
+    case PAD_PROP_MAX_SIZE_BUFFERS:
+      pad->max_size_buffers = g_value_get_uint (value);
+      break;
+    case PAD_PROP_LEAKY:
+      pad->leaky = (GstTeeLeaky) g_value_get_enum (value);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  /* wake up a streaming thread waiting for space */
+  g_cond_broadcast (&pad->cond);
+  g_mutex_unlock (&pad->lock);
+}
+
+static void
+gst_tee_pad_get_property (GObject * object, guint prop_id, GValue * value,
+    GParamSpec * pspec)
+{
+  GstTeePad *pad = GST_TEE_PAD_CAST (object);
+
+  g_mutex_lock (&pad->lock);
+  switch (prop_id) {
+    case PAD_PROP_MAX_SIZE_BUFFERS:
+      g_value_set_uint (value, pad->max_size_buffers);
+      break;
+    case PAD_PROP_LEAKY:
+      g_value_set_enum (value, pad->leaky);
+      break;
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+  }
+  g_mutex_unlock (&pad->lock);
+}
+
+/* runs in one of the worker threads of the pool and pushes the queued items
+ * until the queue runs empty. Only one worker pushes a pad at a time so the
+ * items stay in order */
+static void
+gst_tee_pad_worker (GstTeePad * tpad, GstTee * tee)
+{
+  GstPad *pad = GST_PAD_CAST (tpad);
+  GstMiniObject *item;
+  GstFlowReturn ret;
+
+  g_mutex_lock (&tpad->lock);
+  tpad->worker = g_thread_self ();
+  while (!tpad->flushing && (item = gst_queue_array_pop_head (tpad->queue))) {
+    gboolean is_event = GST_IS_EVENT (item);
+
+    if (!is_event)
+      tpad->cur_buffers--;
+    g_cond_broadcast (&tpad->cond);
+    g_mutex_unlock (&tpad->lock);
+
+    if (is_event) {
+      gst_pad_push_event (pad, GST_EVENT_CAST (item));
+      ret = GST_FLOW_OK;
+    } else if (GST_IS_BUFFER_LIST (item)) {
+      ret = gst_pad_push_list (pad, GST_BUFFER_LIST_CAST (item));
+    } else {
+      ret = gst_pad_push (pad, GST_BUFFER_CAST (item));
+    }
+
+    g_mutex_lock (&tpad->lock);
+    /* keep the first fatal flow return until flushing */
+    if (!is_event && !tpad->flushing && (tpad->srcresult == GST_FLOW_OK ||
+            tpad->srcresult == GST_FLOW_NOT_LINKED)) {
+      if (ret != tpad->srcresult)
+        GST_DEBUG_OBJECT (pad, "branch returned %s", gst_flow_get_name (ret));
+      tpad->srcresult = ret;
+    }
+  }
+  tpad->scheduled = FALSE;
+  tpad->worker = NULL;
+
+  GST_OBJECT_LOCK (tee);
+  tee->n_scheduled--;
+  gst_tee_update_max_threads (tee);
+  GST_OBJECT_UNLOCK (tee);
+
+  g_cond_broadcast (&tpad->cond);
+  g_mutex_unlock (&tpad->lock);
+
+  gst_object_unref (pad);
+}
+
+/* Queues @item for pushing from the worker pool if the branch is queued, in
+ * which case ownership of @item is taken and %TRUE is returned with the flow
+ * return of the branch in @ret. Returns %FALSE if @item should be pushed
+ * directly. */
+static gboolean
+gst_tee_pad_queue_item (GstTee * tee, GstTeePad * pad, GstMiniObject * item,
+    GstFlowReturn * ret)
+{
+  gboolean is_event = GST_IS_EVENT (item);
+
+  g_mutex_lock (&pad->lock);
+  if (pad->max_size_buffers == 0 && !pad->scheduled) {
+    g_mutex_unlock (&pad->lock);
+    return FALSE;
+  }
+
+  if (pad->flushing)
+    goto flushing;
+
+  if (!is_event && pad->srcresult != GST_FLOW_OK &&
+      pad->srcresult != GST_FLOW_NOT_LINKED) {
+    *ret = pad->srcresult;
+    goto drop;
+  }
+
+  while (!is_event && pad->max_size_buffers > 0 &&
+      pad->cur_buffers >= pad->max_size_buffers) {
+    if (pad->leaky == GST_TEE_LEAK_UPSTREAM) {
+      GST_DEBUG_OBJECT (pad, "queue is full, leaking new buffer");
+      *ret = GST_FLOW_OK;
+      goto drop;
+    } else if (pad->leaky == GST_TEE_LEAK_DOWNSTREAM) {
+      guint i, len = gst_queue_array_get_length (pad->queue);
+
+      /* drop the oldest buffer, the events are kept */
+      for (i = 0; i < len; i++) {
+        GstMiniObject *old = gst_queue_array_peek_nth (pad->queue, i);
+
+        if (!GST_IS_EVENT (old)) {
+          GST_DEBUG_OBJECT (pad, "queue is full, leaking old buffer");
+          gst_queue_array_drop_element (pad->queue, i);
+          gst_mini_object_unref (old);
+          pad->cur_buffers--;
+          break;
+        }
+      }
+    } else {
+      GST_LOG_OBJECT (pad, "queue is full, waiting for free space");
+      g_cond_wait (&pad->cond, &pad->lock);
+      if (pad->flushing)
+        goto flushing;
+    }
+  }
+
+  gst_queue_array_push_tail (pad->queue, item);
+  if (!is_event)
+    pad->cur_buffers++;
+  *ret = pad->srcresult;
+
+  if (!pad->scheduled) {
+    pad->scheduled = TRUE;
+
+    /* make sure there is a thread for this branch before handing it over */
+    GST_OBJECT_LOCK (tee);
+    tee->n_scheduled++;
+    gst_tee_update_max_threads (tee);
+    GST_OBJECT_UNLOCK (tee);
+
+    g_thread_pool_push (tee->pool, gst_object_ref (pad), NULL);
+  }
+  g_mutex_unlock (&pad->lock);
+
+  return TRUE;
+
+flushing:
+  {
+    GST_LOG_OBJECT (pad, "flushing, dropping %" GST_PTR_FORMAT, item);
+    *ret = GST_FLOW_FLUSHING;
+    goto drop;
+  }
+drop:
+  {
+    g_mutex_unlock (&pad->lock);
+    gst_mini_object_unref (item);
+    return TRUE;
+  }
+}
+
+static void
+gst_tee_pad_start_flushing (GstTeePad * pad)
+{
+  g_mutex_lock (&pad->lock);
+  pad->flushing = TRUE;
+  gst_tee_pad_clear_queue (pad);
+  g_cond_broadcast (&pad->cond);
+  g_mutex_unlock (&pad->lock);
+}
+
+/* waits until the worker is done pushing the queue of @pad */
+static void
+gst_tee_pad_wait_idle (GstTeePad * pad)
+{
+  g_mutex_lock (&pad->lock);
+  /* don't deadlock when called from the worker of the pad, e.g. from a pad
+   * probe */
+  while (pad->scheduled && pad->worker != g_thread_self ())
+    g_cond_wait (&pad->cond, &pad->lock);
+  g_mutex_unlock (&pad->lock);
+}
+
+static void
+gst_tee_pad_stop_flushing (GstTeePad * pad)
+{
+  gst_tee_pad_wait_idle (pad);
+
+  g_mutex_lock (&pad->lock);
+  pad->flushing = FALSE;
+  pad->srcresult = GST_FLOW_OK;
+  g_mutex_unlock (&pad->lock);
+}
+
+/* (de)activating in push mode starts the branch from scratch, the flow return
+ * of the previous run, e.g. EOS or FLUSHING from downstream going to READY,
+ * must not be reported for the new one */
+static void
+gst_tee_pad_set_push_active (GstTeePad * pad, gboolean active)
+{
+  gst_tee_pad_start_flushing (pad);
+  gst_tee_pad_wait_idle (pad);
+
+  if (active) {
+    g_mutex_lock (&pad->lock);
+    gst_tee_pad_clear_queue (pad);
+    pad->flushing = FALSE;
+    pad->srcresult = GST_FLOW_OK;
+    g_mutex_unlock (&pad->lock);
+  }
 }
 
 static GstPad *gst_tee_request_new_pad (GstElement * element,
@@ -225,6 +602,8 @@ gst_tee_finalize (GObject * object)
 
   g_free (tee->last_message);
 
+  g_thread_pool_free (tee->pool, FALSE, TRUE);
+
   G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
@@ -288,6 +667,25 @@ gst_tee_class_init (GstTeeClass * klass)
           "all unlinked", DEFAULT_PROP_ALLOW_NOT_LINKED,
           G_PARAM_CONSTRUCT | G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
+  /**
+   * GstTee:max-threads
+   *
+   * Maximum number of worker threads pushing the queued branches, see
+   * #GstTeePad:max-size-buffers. The threads are shared by all queued
+   * branches. 0 uses as many threads as there are processors.
+   *
+   * As a worker blocks with its branch when downstream blocks, more threads
+   * are started when more queued branches than this have data pending at
+   * the same time, and stopped again when they are done.
+   *
+   * Since: 1.24
+   */
+  g_object_class_install_property (gobject_class, PROP_MAX_THREADS,
+      g_param_spec_uint ("max-threads", "Max threads",
+          "Maximum number of threads pushing the queued branches "
+          "(0 = number of processors)", 0, G_MAXINT, DEFAULT_PROP_MAX_THREADS,
+          G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
   gst_element_class_set_static_metadata (gstelement_class,
       "Tee pipe fitting",
       "Generic",
@@ -301,6 +699,8 @@ gst_tee_class_init (GstTeeClass * klass)
   gstelement_class->release_pad = GST_DEBUG_FUNCPTR (gst_tee_release_pad);
 
   gst_type_mark_as_plugin_api (GST_TYPE_TEE_PULL_MODE, 0);
+  gst_type_mark_as_plugin_api (GST_TYPE_TEE_LEAKY, 0);
+  gst_type_mark_as_plugin_api (GST_TYPE_TEE_PAD, 0);
 }
 
 static void
@@ -324,6 +724,11 @@ gst_tee_init (GstTee * tee)
   tee->pad_indexes = g_hash_table_new (NULL, NULL);
 
   tee->last_message = NULL;
+
+  tee->max_threads = DEFAULT_PROP_MAX_THREADS;
+  tee->n_scheduled = 0;
+  tee->pool = g_thread_pool_new ((GFunc) gst_tee_pad_worker, tee,
+      g_get_num_processors (), FALSE, NULL);
 }
 
 static void
@@ -396,6 +801,11 @@ gst_tee_request_new_pad (GstElement * element, GstPadTemplate * templ,
 
   GST_OBJECT_UNLOCK (tee);
 
+  /* set before activating so that the branch queue is reset like on any
+   * later activation */
+  gst_pad_set_activatemode_function (srcpad,
+      GST_DEBUG_FUNCPTR (gst_tee_src_activate_mode));
+
   switch (mode) {
     case GST_PAD_MODE_PULL:
       /* we already have a src pad in pull mode, and our pull mode can only be
@@ -411,8 +821,6 @@ gst_tee_request_new_pad (GstElement * element, GstPadTemplate * templ,
   if (!res)
     goto activate_failed;
 
-  gst_pad_set_activatemode_function (srcpad,
-      GST_DEBUG_FUNCPTR (gst_tee_src_activate_mode));
   gst_pad_set_query_function (srcpad, GST_DEBUG_FUNCPTR (gst_tee_src_query));
   gst_pad_set_getrange_function (srcpad,
       GST_DEBUG_FUNCPTR (gst_tee_src_get_range));
@@ -464,6 +872,11 @@ gst_tee_release_pad (GstElement * element, GstPad * pad)
   }
   GST_OBJECT_UNLOCK (tee);
 
+  /* drop the queued data and let the worker finish before the pad goes away,
+   * also when the pad is not active */
+  gst_tee_pad_start_flushing (GST_TEE_PAD_CAST (pad));
+  gst_tee_pad_wait_idle (GST_TEE_PAD_CAST (pad));
+
   gst_pad_set_active (pad, FALSE);
   gst_element_remove_pad (GST_ELEMENT_CAST (tee), pad);
 
@@ -508,6 +921,10 @@ gst_tee_set_property (GObject * object, guint prop_id, const GValue * value,
     case PROP_ALLOW_NOT_LINKED:
       tee->allow_not_linked = g_value_get_boolean (value);
       break;
+    case PROP_MAX_THREADS:
+      tee->max_threads = g_value_get_uint (value);
+      gst_tee_update_max_threads (tee);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -544,6 +961,9 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
     case PROP_ALLOW_NOT_LINKED:
       g_value_set_boolean (value, tee->allow_not_linked);
       break;
+    case PROP_MAX_THREADS:
+      g_value_set_uint (value, tee->max_threads);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -551,15 +971,77 @@ gst_tee_get_property (GObject * object, guint prop_id, GValue * value,
   GST_OBJECT_UNLOCK (tee);
 }
 
+static void
+gst_tee_foreach_src_pad (GstTee * tee, GFunc func)
+{
+  GList *pads;
+
+  GST_OBJECT_LOCK (tee);
+  pads = g_list_copy_deep (GST_ELEMENT_CAST (tee)->srcpads,
+      (GCopyFunc) gst_object_ref, NULL);
+  GST_OBJECT_UNLOCK (tee);
+
+  g_list_foreach (pads, func, NULL);
+  g_list_free_full (pads, gst_object_unref);
+}
+
+typedef struct
+{
+  GstTee *tee;
+  GstEvent *event;
+  gboolean result;
+  gboolean dispatched;
+} ForwardEventData;
+
+static gboolean
+gst_tee_forward_event (GstPad * pad, ForwardEventData * data)
+{
+  GstEvent *event = gst_event_ref (data->event);
+  GstFlowReturn ret;
+
+  /* serialized events go through the queue of the branch to stay in order
+   * with the data */
+  if (gst_tee_pad_queue_item (data->tee, GST_TEE_PAD_CAST (pad),
+          GST_MINI_OBJECT_CAST (event), &ret))
+    data->result |= (ret != GST_FLOW_FLUSHING);
+  else
+    data->result |= gst_pad_push_event (pad, event);
+
+  data->dispatched = TRUE;
+
+  /* don't stop */
+  return FALSE;
+}
+
 static gboolean
 gst_tee_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
 {
+  GstTee *tee = GST_TEE_CAST (parent);
   gboolean res;
 
   switch (GST_EVENT_TYPE (event)) {
-    default:
+    case GST_EVENT_FLUSH_START:
+      gst_tee_foreach_src_pad (tee, (GFunc) gst_tee_pad_start_flushing);
       res = gst_pad_event_default (pad, parent, event);
       break;
+    case GST_EVENT_FLUSH_STOP:
+      gst_tee_foreach_src_pad (tee, (GFunc) gst_tee_pad_stop_flushing);
+      res = gst_pad_event_default (pad, parent, event);
+      break;
+    default:
+      if (GST_EVENT_IS_SERIALIZED (event)) {
+        ForwardEventData data = { tee, event, FALSE, FALSE };
+
+        gst_pad_forward (pad, (GstPadForwardFunction) gst_tee_forward_event,
+            &data);
+        gst_event_unref (event);
+
+        /* like the default handler, return TRUE if there are no pads */
+        res = data.dispatched ? data.result : TRUE;
+      } else {
+        res = gst_pad_event_default (pad, parent, event);
+      }
+      break;
   }
 
   return res;
@@ -739,6 +1221,10 @@ gst_tee_sink_query (GstPad * pad, GstObject * parent, GstQuery * query)
   GstTee *tee = GST_TEE (parent);
   gboolean res;
 
+  /* let the queued branches catch up with the preceding data first */
+  if (GST_QUERY_IS_SERIALIZED (query))
+    gst_tee_foreach_src_pad (tee, (GFunc) gst_tee_pad_wait_idle);
+
   switch (GST_QUERY_TYPE (query)) {
     case GST_QUERY_ALLOCATION:
     {
@@ -848,12 +1334,16 @@ gst_tee_do_push (GstTee * tee, GstPad * pad, gpointer data, gboolean is_list)
   if (pad == tee->pull_pad) {
     /* don't push on the pad we're pulling from */
     res = GST_FLOW_OK;
-  } else if (is_list) {
-    res =
-        gst_pad_push_list (pad,
-        gst_buffer_list_ref (GST_BUFFER_LIST_CAST (data)));
   } else {
-    res = gst_pad_push (pad, gst_buffer_ref (GST_BUFFER_CAST (data)));
+    GstMiniObject *item = gst_mini_object_ref (GST_MINI_OBJECT_CAST (data));
+
+    if (gst_tee_pad_queue_item (tee, GST_TEE_PAD_CAST (pad), item, &res)) {
+      /* queued for the worker threads */
+    } else if (is_list) {
+      res = gst_pad_push_list (pad, GST_BUFFER_LIST_CAST (item));
+    } else {
+      res = gst_pad_push (pad, GST_BUFFER_CAST (item));
+    }
   }
   return res;
 }
@@ -893,6 +1383,9 @@ gst_tee_handle_data (GstTee * tee, gpointer data, gboolean is_list)
 
     if (pad == tee->pull_pad) {
       ret = GST_FLOW_OK;
+    } else if (gst_tee_pad_queue_item (tee, GST_TEE_PAD_CAST (pad),
+            GST_MINI_OBJECT_CAST (data), &ret)) {
+      /* queued for the worker threads */
     } else if (is_list) {
       ret = gst_pad_push_list (pad, GST_BUFFER_LIST_CAST (data));
     } else {
@@ -1127,6 +1620,13 @@ gst_tee_src_activate_mode (GstPad * pad, GstObject * parent, GstPadMode mode,
       GST_OBJECT_UNLOCK (tee);
       break;
     }
+    case GST_PAD_MODE_PUSH:
+    {
+      /* drop the branch queue and wait for the worker to notice */
+      gst_tee_pad_set_push_active (GST_TEE_PAD_CAST (pad), active);
+      res = TRUE;
+      break;
+    }
     default:
       res = TRUE;
       break;
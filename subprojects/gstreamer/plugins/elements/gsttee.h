@@ -57,6 +57,23 @@ typedef enum {
   GST_TEE_PULL_MODE_SINGLE,
 } GstTeePullMode;
 
+/**
+ * GstTeeLeaky:
+ * @GST_TEE_NO_LEAK: Not leaky, block when the branch queue is full
+ * @GST_TEE_LEAK_UPSTREAM: Leaky on upstream (new buffers)
+ * @GST_TEE_LEAK_DOWNSTREAM: Leaky on downstream (old buffers)
+ *
+ * Buffer dropping scheme of a queued branch to avoid blocking the other
+ * branches when it is full.
+ *
+ * Since: 1.24
+ */
+typedef enum {
+  GST_TEE_NO_LEAK,
+  GST_TEE_LEAK_UPSTREAM,
+  GST_TEE_LEAK_DOWNSTREAM,
+} GstTeeLeaky;
+
 /**
  * GstTee:
  *
@@ -81,6 +98,12 @@ struct _GstTee {
   GstPad         *pull_pad;
 
   gboolean        allow_not_linked;
+
+  /* workers pushing the queued branches */
+  GThreadPool    *pool;
+  guint           max_threads;
+  /* queued branches with data pending, each of them needs a worker */
+  guint           n_scheduled;
 };
 
 struct _GstTeeClass {
@@ -102,6 +102,10 @@ GST_STATIC_PAD_TEMPLATE ("src",
 #define TYPE_FIND_MIN_SIZE   (2*1024)
 #define TYPE_FIND_MAX_SIZE (128*1024)
 
+/* in push mode, don't run all typefinders again before the available data
+ * grew by this factor since the last unsuccessful attempt */
+#define TYPE_FIND_RETRY_FACTOR 2
+
 /* TypeFind signals and args */
 enum
 {
@@ -343,6 +347,7 @@ gst_type_find_element_dispose (GObject * object)
 
   gst_clear_object (&typefind->adapter);
   gst_clear_caps (&typefind->force_caps);
+  g_clear_pointer (&typefind->extension, g_free);
 
   G_OBJECT_CLASS (parent_class)->dispose (object);
 }
@@ -582,6 +587,9 @@ start_typefinding (GstTypeFindElement * typefind)
   if (typefind->caps)
     gst_caps_replace (&typefind->caps, NULL);
   typefind->initial_offset = GST_BUFFER_OFFSET_NONE;
+  g_clear_pointer (&typefind->extension, g_free);
+  typefind->have_extension = FALSE;
+  typefind->last_failed_size = 0;
   GST_OBJECT_UNLOCK (typefind);
 
   typefind->mode = MODE_TYPEFIND;
@@ -719,6 +727,7 @@ gst_type_find_element_sink_event (GstPad * pad, GstObject * parent,
           g_list_free (typefind->cached_events);
           typefind->cached_events = NULL;
           gst_adapter_clear (typefind->adapter);
+          typefind->last_failed_size = 0;
           GST_OBJECT_UNLOCK (typefind);
           /* fall through */
         }
@@ -950,7 +959,6 @@ gst_type_find_element_chain_do_typefinding (GstTypeFindElement * typefind,
   gsize avail;
   const guint8 *data;
   gboolean have_min, have_max;
-  gchar *ext;
 
   GST_OBJECT_LOCK (typefind);
   if (typefind->force_caps) {
@@ -972,13 +980,24 @@ gst_type_find_element_chain_do_typefinding (GstTypeFindElement * typefind,
     if (!have_min)
       goto not_enough_data;
 
-    ext = gst_type_find_get_extension (typefind, typefind->sink);
+    /* running all typefinders again on a few more bytes rarely gives a
+     * different result, so wait until there is substantially more data */
+    if (!have_max && typefind->last_failed_size > 0 &&
+        avail < typefind->last_failed_size * TYPE_FIND_RETRY_FACTOR)
+      goto skip_attempt;
+
+    /* the uri doesn't change while typefinding, only query it once */
+    if (!typefind->have_extension) {
+      typefind->extension =
+          gst_type_find_get_extension (typefind, typefind->sink);
+      typefind->have_extension = TRUE;
+    }
+
     /* map all available data */
     data = gst_adapter_map (typefind->adapter, avail);
     caps = gst_type_find_helper_for_data_with_extension (GST_OBJECT (typefind),
-        data, avail, ext, &probability);
+        data, avail, typefind->extension, &probability);
     gst_adapter_unmap (typefind->adapter);
-    g_free (ext);
 
     if (caps == NULL && have_max)
       goto no_type_found;
@@ -1026,8 +1045,17 @@ no_type_found:
     stop_typefinding (typefind);
     return GST_FLOW_ERROR;
   }
+skip_attempt:
+  {
+    GST_OBJECT_UNLOCK (typefind);
+    GST_LOG_OBJECT (typefind, "last attempt with %" G_GSIZE_FORMAT " bytes "
+        "failed, waiting for more data (%" G_GSIZE_FORMAT " bytes)",
+        typefind->last_failed_size, avail);
+    return GST_FLOW_OK;
+  }
 wait_for_data:
   {
+    typefind->last_failed_size = avail;
     GST_OBJECT_UNLOCK (typefind);
 
     if (at_eos) {
@@ -1053,6 +1081,7 @@ low_probability:
     if (have_max)
       goto no_type_found;
 
+    typefind->last_failed_size = avail;
     GST_OBJECT_UNLOCK (typefind);
     GST_DEBUG_OBJECT (typefind, "waiting for more data to try again");
     return GST_FLOW_OK;
@@ -1362,6 +1391,9 @@ gst_type_find_element_change_state (GstElement * element,
           (GFunc) gst_mini_object_unref, NULL);
       g_list_free (typefind->cached_events);
       typefind->cached_events = NULL;
+      g_clear_pointer (&typefind->extension, g_free);
+      typefind->have_extension = FALSE;
+      typefind->last_failed_size = 0;
       typefind->mode = MODE_TYPEFIND;
       GST_OBJECT_UNLOCK (typefind);
       break;
@@ -59,7 +59,13 @@ struct _GstTypeFindElement {
   GstCaps *             force_caps;
 
   guint64		initial_offset;
-  
+
+  /* push mode: uri extension of the stream, looked up once */
+  gchar *               extension;
+  gboolean              have_extension;
+  /* push mode: amount of data the last unsuccessful attempt ran on */
+  gsize                 last_failed_size;
+
   /* Only used when driving the pipeline */
   gboolean need_segment;
   gboolean need_stream_start;
@@ -0,0 +1,670 @@
+/* GStreamer
+ *
+ * gstchrometrace.c: tracing module that writes chrome trace event files
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-chrometrace
+ * @short_description: write a chrome trace event file
+ *
+ * A tracing module that writes the data flow of the pipelines in the
+ * [Trace Event Format](https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU)
+ * understood by Perfetto (https://ui.perfetto.dev) and `chrome://tracing`,
+ * instead of going through the debug log like the other tracers.
+ *
+ * Every push into and pull from an element is a slice on the timeline of
+ * the thread doing it, so nested slices show which element called which.
+ * Buffers are connected by flow arrows from one push to the next push of
+ * the same buffer, also across threads, and the levels of queue elements
+ * are shown as counters.
+ *
+ * The hooks only append a fixed size record to a ring buffer of the
+ * thread, the JSON is formatted and written by a separate thread. When a
+ * thread produces events faster than they are written the new events are
+ * dropped, and the number of dropped events is logged at the end.
+ *
+ * Parameters:
+ * 1. file: (string) the file to write to, `gst-trace.json` in the current
+ *    directory by default
+ * 2. buffer-size: (uint) the number of events each thread can buffer,
+ *    16384 by default
+ * 3. flush-interval: (uint) interval in milliseconds at which the events
+ *    are written, 100 by default
+ * 4. queues: (string) comma separated list of element factory names whose
+ *    level is recorded, "queue,queue2" by default
+ * 5. name: (string) set a name for the tracer object itself
+ *
+ * ```
+ * GST_TRACERS="chrometrace(file=/tmp/trace.json)" ./...
+ * ```
+ *
+ * The file is complete when the tracer is destroyed in gst_deinit(), but
+ * the trace viewers also load a file that is still being written.
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <errno.h>
+#include <string.h>
+#include <glib/gstdio.h>
+
+#ifdef HAVE_UNISTD_H
+#  include <unistd.h>           /* getpid on UNIX */
+#endif
+
+#ifdef G_OS_WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>          /* GetCurrentProcessId */
+#endif
+
+#include "gstchrometrace.h"
+#include "gsttracers_private.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_chrome_trace_debug);
+#define GST_CAT_DEFAULT gst_chrome_trace_debug
+
+enum
+{
+  /* actions */
+  SIGNAL_FLUSH,
+
+  LAST_SIGNAL
+};
+
+#define DEFAULT_FILE "gst-trace.json"
+#define DEFAULT_BUFFER_SIZE 16384
+#define DEFAULT_FLUSH_INTERVAL 100
+#define DEFAULT_QUEUES "queue,queue2"
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_chrome_trace_debug, "chrometrace", 0, "chrome trace tracer");
+#define gst_chrome_trace_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstChromeTraceTracer, gst_chrome_trace_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+static void gst_chrome_trace_tracer_flush (GstChromeTraceTracer * self);
+
+static guint gst_chrome_trace_tracer_signals[LAST_SIGNAL] = { 0 };
+
+/* Protects setting the element data */
+G_LOCK_DEFINE_STATIC (chrome_trace_elements);
+
+static guint process_id;
+
+typedef enum
+{
+  EVENT_BEGIN,
+  EVENT_END,
+  EVENT_FLOW,
+  EVENT_COUNTER,
+} GstChromeTraceEventType;
+
+typedef struct
+{
+  GstClockTime ts;
+  GstChromeTraceEventType type;
+  /* interned and escaped for JSON */
+  const gchar *name;
+  /* the flow id, or the buffers and bytes of a counter */
+  guint64 id;
+  guint64 value;
+} GstChromeTraceEvent;
+
+typedef struct
+{
+  guint tid;
+  const gchar *name;
+
+  /* single producer, single consumer ring: head is only written by the
+   * thread itself and tail by the writer */
+  GstChromeTraceEvent *events;
+  guint mask;
+  gint head;
+  gint tail;
+  gint dropped;
+
+  /* only accessed by the writer */
+  gboolean named;
+} GstChromeTraceThread;
+
+typedef struct
+{
+  const gchar *name;
+  gboolean is_queue;
+} GstChromeTraceElement;
+
+/* helpers */
+
+static guint
+get_process_id (void)
+{
+#ifdef G_OS_WIN32
+  return GetCurrentProcessId ();
+#elif defined (HAVE_UNISTD_H)
+  return getpid ();
+#else
+  return 0;
+#endif
+}
+
+static const gchar *
+intern_json_string (const gchar * str)
+{
+  GString *s = g_string_sized_new (strlen (str));
+  const gchar *res;
+
+  for (; *str; str++) {
+    if (*str == '"' || *str == '\\')
+      g_string_append_printf (s, "\\%c", *str);
+    else if ((guchar) * str < 0x20)
+      g_string_append_printf (s, "\\u%04x", (guchar) * str);
+    else
+      g_string_append_c (s, *str);
+  }
+
+  res = g_intern_string (s->str);
+  g_string_free (s, TRUE);
+
+  return res;
+}
+
+static gboolean
+is_queue_element (GstChromeTraceTracer * self, GstElement * element)
+{
+  GstElementFactory *factory = gst_element_get_factory (element);
+  GObjectClass *klass = G_OBJECT_GET_CLASS (element);
+
+  if (!factory || !self->queues
+      || !g_strv_contains ((const gchar * const *) self->queues,
+          GST_OBJECT_NAME (factory)))
+    return FALSE;
+
+  return g_object_class_find_property (klass, "current-level-buffers")
+      && g_object_class_find_property (klass, "current-level-bytes");
+}
+
+static const GstChromeTraceElement *
+get_element_data (GstChromeTraceTracer * self, GstElement * element)
+{
+  GstChromeTraceElement *data;
+  gchar *path;
+
+  data = g_object_get_qdata ((GObject *) element, self->data_quark);
+  if (G_LIKELY (data))
+    return data;
+
+  G_LOCK (chrome_trace_elements);
+  if (!(data = g_object_get_qdata ((GObject *) element, self->data_quark))) {
+    data = g_new0 (GstChromeTraceElement, 1);
+    path = gst_object_get_path_string (GST_OBJECT_CAST (element));
+    data->name = intern_json_string (path);
+    g_free (path);
+    data->is_queue = is_queue_element (self, element);
+    g_object_set_qdata_full ((GObject *) element, self->data_quark, data,
+        g_free);
+  }
+  G_UNLOCK (chrome_trace_elements);
+
+  return data;
+}
+
+/* threads */
+
+static GstChromeTraceThread *
+get_thread (GstChromeTraceTracer * self, GstPad * pad)
+{
+  GstChromeTraceThread *thread;
+  GstElement *element;
+
+  thread = gst_tracers_get_thread_data (GST_TRACER_CAST (self));
+  if (G_LIKELY (thread))
+    return thread;
+
+  thread = g_new0 (GstChromeTraceThread, 1);
+  /* Named after the element that first pushes from it, usually the one
+   * running the streaming thread */
+  if ((element = gst_tracers_get_pad_element (pad)))
+    thread->name = get_element_data (self, element)->name;
+  thread->mask = self->buffer_size - 1;
+  thread->events = g_new (GstChromeTraceEvent, self->buffer_size);
+  gst_tracers_set_thread_data (GST_TRACER_CAST (self), thread);
+
+  g_mutex_lock (&self->lock);
+  thread->tid = ++self->next_tid;
+  g_ptr_array_add (self->threads, thread);
+  g_mutex_unlock (&self->lock);
+
+  return thread;
+}
+
+static void
+free_thread (GstChromeTraceThread * thread)
+{
+  g_free (thread->events);
+  g_free (thread);
+}
+
+static inline void
+record_event (GstChromeTraceThread * thread, GstChromeTraceEventType type,
+    GstClockTime ts, const gchar * name, guint64 id, guint64 value)
+{
+  guint head = (guint) thread->head;
+  guint tail = (guint) g_atomic_int_get (&thread->tail);
+  GstChromeTraceEvent *ev;
+
+  if (G_UNLIKELY (head - tail > thread->mask)) {
+    g_atomic_int_inc (&thread->dropped);
+    return;
+  }
+
+  ev = &thread->events[head & thread->mask];
+  ev->ts = ts;
+  ev->type = type;
+  ev->name = name;
+  ev->id = id;
+  ev->value = value;
+
+  /* publish the event to the writer */
+  g_atomic_int_set (&thread->head, (gint) (head + 1));
+}
+
+static void
+record_queue_level (GstChromeTraceThread * thread, GstClockTime ts,
+    GstElement * element, const GstChromeTraceElement * data)
+{
+  guint buffers = 0, bytes = 0;
+
+  g_object_get (element, "current-level-buffers", &buffers,
+      "current-level-bytes", &bytes, NULL);
+  record_event (thread, EVENT_COUNTER, ts, data->name, buffers, bytes);
+}
+
+static void
+enter_element (GstChromeTraceTracer * self, guint64 ts, GstPad * pad,
+    gpointer obj)
+{
+  GstChromeTraceThread *thread = get_thread (self, pad);
+  const GstChromeTraceElement *data;
+  GstElement *element;
+
+  /* a queue pushing out the buffer it just dequeued */
+  if ((element = gst_tracers_get_pad_element (pad))) {
+    data = get_element_data (self, element);
+    if (data->is_queue)
+      record_queue_level (thread, ts, element, data);
+  }
+
+  if (!(element = gst_tracers_get_pad_element (GST_PAD_PEER (pad))))
+    return;
+
+  data = get_element_data (self, element);
+  record_event (thread, EVENT_BEGIN, ts, data->name, 0, 0);
+  if (obj)
+    record_event (thread, EVENT_FLOW, ts, NULL, GPOINTER_TO_SIZE (obj), 0);
+}
+
+static void
+leave_element (GstChromeTraceTracer * self, guint64 ts, GstPad * pad)
+{
+  GstChromeTraceThread *thread = get_thread (self, pad);
+  const GstChromeTraceElement *data;
+  GstElement *element;
+
+  if (!(element = gst_tracers_get_pad_element (GST_PAD_PEER (pad))))
+    return;
+
+  record_event (thread, EVENT_END, ts, NULL, 0, 0);
+
+  /* a queue that just took the buffer */
+  data = get_element_data (self, element);
+  if (data->is_queue)
+    record_queue_level (thread, ts, element, data);
+}
+
+/* hooks */
+
+static void
+do_push_buffer_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBuffer * buffer)
+{
+  enter_element (GST_CHROME_TRACE_TRACER_CAST (tracer), ts, pad, buffer);
+}
+
+static void
+do_push_buffer_list_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBufferList * list)
+{
+  enter_element (GST_CHROME_TRACE_TRACER_CAST (tracer), ts, pad, list);
+}
+
+static void
+do_pull_range_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    guint64 offset, guint size)
+{
+  enter_element (GST_CHROME_TRACE_TRACER_CAST (tracer), ts, pad, NULL);
+}
+
+static void
+do_push_post (GstTracer * tracer, guint64 ts, GstPad * pad, GstFlowReturn res)
+{
+  leave_element (GST_CHROME_TRACE_TRACER_CAST (tracer), ts, pad);
+}
+
+static void
+do_pull_range_post (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBuffer * buffer, GstFlowReturn res)
+{
+  leave_element (GST_CHROME_TRACE_TRACER_CAST (tracer), ts, pad);
+}
+
+/* writer */
+
+static void
+write_separator (GstChromeTraceTracer * self)
+{
+  if (self->n_events++ > 0)
+    fputs (",\n", self->out);
+}
+
+static void
+write_event (GstChromeTraceTracer * self, GstChromeTraceThread * thread,
+    const GstChromeTraceEvent * ev)
+{
+  gdouble ts = (gdouble) ev->ts / GST_USECOND;
+
+  write_separator (self);
+
+  switch (ev->type) {
+    case EVENT_BEGIN:
+      fprintf (self->out, "{\"ph\":\"B\",\"name\":\"%s\",\"pid\":%u,"
+          "\"tid\":%u,\"ts\":%.3f}", ev->name, process_id, thread->tid, ts);
+      break;
+    case EVENT_END:
+      fprintf (self->out, "{\"ph\":\"E\",\"pid\":%u,\"tid\":%u,\"ts\":%.3f}",
+          process_id, thread->tid, ts);
+      break;
+    case EVENT_FLOW:
+      /* ends the arrow from the previous push of the same buffer and starts
+       * the one to the next */
+      fprintf (self->out, "{\"ph\":\"f\",\"bp\":\"e\",\"cat\":\"buffer\","
+          "\"name\":\"buffer\",\"id\":\"0x%" G_GINT64_MODIFIER "x\","
+          "\"pid\":%u,\"tid\":%u,\"ts\":%.3f},\n", ev->id, process_id,
+          thread->tid, ts);
+      fprintf (self->out, "{\"ph\":\"s\",\"cat\":\"buffer\","
+          "\"name\":\"buffer\",\"id\":\"0x%" G_GINT64_MODIFIER "x\","
+          "\"pid\":%u,\"tid\":%u,\"ts\":%.3f}", ev->id, process_id,
+          thread->tid, ts);
+      break;
+    case EVENT_COUNTER:
+      fprintf (self->out, "{\"ph\":\"C\",\"name\":\"%s\",\"pid\":%u,"
+          "\"tid\":%u,\"ts\":%.3f,\"args\":{\"buffers\":%" G_GUINT64_FORMAT
+          ",\"bytes\":%" G_GUINT64_FORMAT "}}", ev->name, process_id,
+          thread->tid, ts, ev->id, ev->value);
+      break;
+  }
+}
+
+static void
+gst_chrome_trace_tracer_flush (GstChromeTraceTracer * self)
+{
+  GPtrArray *threads;
+  guint i;
+
+  if (!self->out)
+    return;
+
+  g_mutex_lock (&self->lock);
+  threads = g_ptr_array_copy (self->threads, NULL, NULL);
+  g_mutex_unlock (&self->lock);
+
+  g_mutex_lock (&self->write_lock);
+  for (i = 0; i < threads->len; i++) {
+    GstChromeTraceThread *thread = g_ptr_array_index (threads, i);
+    guint head = (guint) g_atomic_int_get (&thread->head);
+    guint tail = (guint) thread->tail;
+
+    if (!thread->named) {
+      write_separator (self);
+      if (thread->name)
+        fprintf (self->out, "{\"ph\":\"M\",\"name\":\"thread_name\","
+            "\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", process_id,
+            thread->tid, thread->name);
+      else
+        fprintf (self->out, "{\"ph\":\"M\",\"name\":\"thread_name\","
+            "\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}",
+            process_id, thread->tid, thread->tid);
+      thread->named = TRUE;
+    }
+
+    for (; tail != head; tail++)
+      write_event (self, thread, &thread->events[tail & thread->mask]);
+
+    /* hand the slots back to the thread */
+    g_atomic_int_set (&thread->tail, (gint) tail);
+  }
+  fflush (self->out);
+  g_mutex_unlock (&self->write_lock);
+
+  g_ptr_array_unref (threads);
+}
+
+static gpointer
+gst_chrome_trace_tracer_write_thread (GstChromeTraceTracer * self)
+{
+  gint64 end_time = g_get_monotonic_time ();
+
+  g_mutex_lock (&self->write_lock);
+  while (!self->write_stop) {
+    end_time += self->flush_interval * G_TIME_SPAN_MILLISECOND;
+    while (!self->write_stop
+        && g_cond_wait_until (&self->write_cond, &self->write_lock, end_time));
+    if (self->write_stop)
+      break;
+    g_mutex_unlock (&self->write_lock);
+
+    gst_chrome_trace_tracer_flush (self);
+
+    g_mutex_lock (&self->write_lock);
+  }
+  g_mutex_unlock (&self->write_lock);
+
+  return NULL;
+}
+
+/* tracer class */
+
+static void
+set_params (GstChromeTraceTracer * self)
+{
+  gchar *params, *tmp;
+  GstStructure *params_struct = NULL;
+  const gchar *queues = DEFAULT_QUEUES;
+  guint buffer_size = DEFAULT_BUFFER_SIZE;
+
+  g_object_get (self, "params", &params, NULL);
+  if (params) {
+    tmp = g_strdup_printf ("chrometrace,%s", params);
+    params_struct = gst_structure_from_string (tmp, NULL);
+    g_free (tmp);
+
+    if (params_struct) {
+      const gchar *name = gst_structure_get_string (params_struct, "name");
+      const gchar *file = gst_structure_get_string (params_struct, "file");
+      gint val;
+
+      if (name)
+        gst_object_set_name (GST_OBJECT (self), name);
+      if (file)
+        self->file = g_strdup (file);
+      if (gst_structure_get_int (params_struct, "buffer-size", &val))
+        buffer_size = MAX (val, 1);
+      else
+        gst_structure_get_uint (params_struct, "buffer-size", &buffer_size);
+      if (gst_structure_get_int (params_struct, "flush-interval", &val))
+        self->flush_interval = MAX (val, 1);
+      else
+        gst_structure_get_uint (params_struct, "flush-interval",
+            &self->flush_interval);
+      if (gst_structure_has_field (params_struct, "queues"))
+        queues = gst_structure_get_string (params_struct, "queues");
+    } else {
+      GST_WARNING_OBJECT (self, "failed to parse params '%s'", params);
+    }
+    g_free (params);
+  }
+
+  if (!self->file)
+    self->file = g_strdup (DEFAULT_FILE);
+  if (queues)
+    self->queues = g_strsplit (queues, ",", -1);
+  self->flush_interval = MAX (self->flush_interval, 1);
+
+  /* the ring needs a power of two */
+  buffer_size = CLAMP (buffer_size, 2, 1 << 24);
+  self->buffer_size = 1 << g_bit_storage (buffer_size - 1);
+
+  if (params_struct)
+    gst_structure_free (params_struct);
+}
+
+static void
+gst_chrome_trace_tracer_constructed (GObject * object)
+{
+  GstChromeTraceTracer *self = GST_CHROME_TRACE_TRACER (object);
+  GstTracer *tracer = GST_TRACER (object);
+
+  set_params (self);
+
+  self->out = g_fopen (self->file, "w");
+  if (!self->out) {
+    GST_ERROR_OBJECT (self, "failed to open %s: %s", self->file,
+        g_strerror (errno));
+    goto done;
+  }
+  fputs ("[\n", self->out);
+  fflush (self->out);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (do_push_buffer_pre));
+  gst_tracing_register_hook (tracer, "pad-push-post",
+      G_CALLBACK (do_push_post));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_buffer_list_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (do_push_post));
+  gst_tracing_register_hook (tracer, "pad-pull-range-pre",
+      G_CALLBACK (do_pull_range_pre));
+  gst_tracing_register_hook (tracer, "pad-pull-range-post",
+      G_CALLBACK (do_pull_range_post));
+
+  self->write_thread = g_thread_new ("chrometrace-tracer",
+      (GThreadFunc) gst_chrome_trace_tracer_write_thread, self);
+
+done:
+  ((GObjectClass *) parent_class)->constructed (object);
+}
+
+static void
+gst_chrome_trace_tracer_finalize (GObject * object)
+{
+  GstChromeTraceTracer *self = GST_CHROME_TRACE_TRACER (object);
+  guint i;
+
+  if (self->write_thread) {
+    g_mutex_lock (&self->write_lock);
+    self->write_stop = TRUE;
+    g_cond_signal (&self->write_cond);
+    g_mutex_unlock (&self->write_lock);
+    g_thread_join (self->write_thread);
+  }
+
+  if (self->out) {
+    gst_chrome_trace_tracer_flush (self);
+    fputs ("\n]\n", self->out);
+    fclose (self->out);
+  }
+
+  for (i = 0; i < self->threads->len; i++) {
+    GstChromeTraceThread *thread = g_ptr_array_index (self->threads, i);
+
+    self->dropped += (guint) g_atomic_int_get (&thread->dropped);
+  }
+  if (self->dropped)
+    GST_WARNING_OBJECT (self, "dropped %" G_GUINT64_FORMAT " events, "
+        "increase buffer-size or decrease flush-interval", self->dropped);
+
+  g_ptr_array_unref (self->threads);
+  g_mutex_clear (&self->lock);
+  g_mutex_clear (&self->write_lock);
+  g_cond_clear (&self->write_cond);
+  g_strfreev (self->queues);
+  g_free (self->file);
+
+  ((GObjectClass *) parent_class)->finalize (object);
+}
+
+static void
+gst_chrome_trace_tracer_class_init (GstChromeTraceTracerClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->constructed = gst_chrome_trace_tracer_constructed;
+  gobject_class->finalize = gst_chrome_trace_tracer_finalize;
+
+  /**
+   * GstChromeTraceTracer::flush:
+   * @chrometracetracer: the chrometrace tracer object to emit this signal on
+   *
+   * Writes all events recorded so far to the file, without waiting for
+   * the next flush interval.
+   *
+   * Since: 1.24
+   */
+  gst_chrome_trace_tracer_signals[SIGNAL_FLUSH] =
+      g_signal_new ("flush", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstChromeTraceTracerClass, flush), NULL, NULL, NULL,
+      G_TYPE_NONE, 0, G_TYPE_NONE);
+
+  klass->flush = gst_chrome_trace_tracer_flush;
+
+  process_id = get_process_id ();
+}
+
+static void
+gst_chrome_trace_tracer_init (GstChromeTraceTracer * self)
+{
+  static gint instance_count = 0;
+  gchar *quark_name;
+
+  self->flush_interval = DEFAULT_FLUSH_INTERVAL;
+  g_mutex_init (&self->lock);
+  g_mutex_init (&self->write_lock);
+  g_cond_init (&self->write_cond);
+  self->threads = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      free_thread);
+
+  /* Separate per instance, they can have different queues */
+  quark_name = g_strdup_printf ("gstchrometrace:data:%d",
+      g_atomic_int_add (&instance_count, 1));
+  self->data_quark = g_quark_from_string (quark_name);
+  g_free (quark_name);
+}
@@ -0,0 +1,87 @@
+/* GStreamer
+ *
+ * gstchrometrace.h: tracing module that writes chrome trace event files
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_CHROME_TRACE_TRACER_H__
+#define __GST_CHROME_TRACE_TRACER_H__
+
+#include <stdio.h>
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_CHROME_TRACE_TRACER \
+  (gst_chrome_trace_tracer_get_type())
+#define GST_CHROME_TRACE_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_CHROME_TRACE_TRACER,GstChromeTraceTracer))
+#define GST_CHROME_TRACE_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_CHROME_TRACE_TRACER,GstChromeTraceTracerClass))
+#define GST_IS_CHROME_TRACE_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_CHROME_TRACE_TRACER))
+#define GST_IS_CHROME_TRACE_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_CHROME_TRACE_TRACER))
+#define GST_CHROME_TRACE_TRACER_CAST(obj) ((GstChromeTraceTracer *)(obj))
+
+typedef struct _GstChromeTraceTracer GstChromeTraceTracer;
+typedef struct _GstChromeTraceTracerClass GstChromeTraceTracerClass;
+
+/**
+ * GstChromeTraceTracer:
+ *
+ * Opaque #GstChromeTraceTracer data structure
+ */
+struct _GstChromeTraceTracer {
+  GstTracer parent;
+
+  /*< private >*/
+  gchar *file;
+  guint buffer_size;
+  guint flush_interval;
+  gchar **queues;
+
+  /* GstChromeTraceThread *, one for each thread that ran a hook */
+  GMutex lock;
+  GPtrArray *threads;
+  guint next_tid;
+  GQuark data_quark;
+
+  /* writer thread, the output is only accessed with write_lock */
+  GMutex write_lock;
+  GCond write_cond;
+  gboolean write_stop;
+  GThread *write_thread;
+  FILE *out;
+  guint64 n_events;
+  guint64 dropped;
+};
+
+struct _GstChromeTraceTracerClass {
+  GstTracerClass parent_class;
+
+  /* actions */
+  void (*flush) (GstChromeTraceTracer *tracer);
+};
+
+G_GNUC_INTERNAL GType gst_chrome_trace_tracer_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_CHROME_TRACE_TRACER_H__ */
@@ -0,0 +1,576 @@
+/* GStreamer
+ *
+ * gstcopies.c: tracing module that finds the copies of buffer data
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-copies
+ * @short_description: find the elements copying buffer data
+ *
+ * A tracing module that counts the copies of buffer data done by the core
+ * and attributes them to the element the copying thread is running in, like
+ * the flamegraph tracer does for cpu time. It tells where the hidden
+ * memcpys of a pipeline happen, which usually are:
+ *
+ * * `memory-copy`: a #GstMemory was copied with gst_memory_copy(), for
+ *   example because a shared memory was mapped for writing or because the
+ *   allocator of a memory can't share it.
+ * * `buffer-merge`: the memories of a #GstBuffer were copied into a single
+ *   memory, for example when mapping a buffer with several memories.
+ * * `writable-copy`: gst_buffer_make_writable() had to copy a buffer because
+ *   something else still had a reference to it. The copy itself only shares
+ *   the memories, but it's usually followed by a `memory-copy` when the
+ *   memories are mapped for writing. `extra-refs` is the sum of the other
+ *   references that were held on the buffers, a tee or a queue holding on to
+ *   buffers is a common cause.
+ *
+ * The copies done by elements themselves, for example by converting data
+ * into a new buffer, are not counted.
+ *
+ * The totals are logged as `copy-stats` records in the `GST_TRACER` debug
+ * category at level 7 when the tracer is destroyed in gst_deinit(), one for
+ * each element, kind of copy and call site, and can be fetched at any time
+ * with the `get-stats` action signal.
+ *
+ * Parameters:
+ * 1. stack-traces: (boolean) also group the copies by the stack trace of
+ *    the call site. This is expensive and requires GStreamer to be built
+ *    with stack trace support. Defaults to %FALSE.
+ * 2. name: (string) set a name for the tracer object itself
+ *
+ * ```
+ * GST_TRACERS="copies(stack-traces=true)" GST_DEBUG=GST_TRACER:7 ./...
+ * ```
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <string.h>
+
+#include "gstcopies.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_copies_debug);
+#define GST_CAT_DEFAULT gst_copies_debug
+
+enum
+{
+  /* actions */
+  SIGNAL_GET_STATS,
+
+  LAST_SIGNAL
+};
+
+#define NO_ELEMENT "(none)"
+
+#define KIND_MEMORY_COPY "memory-copy"
+#define KIND_BUFFER_MERGE "buffer-merge"
+#define KIND_WRITABLE_COPY "writable-copy"
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_copies_debug, "copies", 0, "copies tracer");
+#define gst_copies_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstCopiesTracer, gst_copies_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+static GstStructure *gst_copies_tracer_get_stats (GstCopiesTracer * self);
+
+static GstTracerRecord *tr_copies;
+static guint gst_copies_tracer_signals[LAST_SIGNAL] = { 0 };
+
+/* Protects setting the names of the elements */
+G_LOCK_DEFINE_STATIC (copies_names);
+static GQuark name_quark;
+
+typedef struct
+{
+  /* interned */
+  const gchar *element;
+  const gchar *kind;
+  gchar *trace;
+
+  guint64 count;
+  guint64 bytes;
+  guint64 extra_refs;
+} GstCopiesStats;
+
+/* The elements a thread is running in, for one tracer instance */
+typedef struct
+{
+  /* element pushing or pulling when the stack is empty */
+  const gchar *base;
+  /* const gchar *, the interned names of the elements called into */
+  GPtrArray *stack;
+} GstCopiesThread;
+
+static void
+free_thread (GstCopiesThread * thread)
+{
+  g_ptr_array_unref (thread->stack);
+  g_free (thread);
+}
+
+static GPrivate thread_data =
+G_PRIVATE_INIT ((GDestroyNotify) g_hash_table_unref);
+
+static void
+free_stats (GstCopiesStats * stats)
+{
+  g_free (stats->trace);
+  g_free (stats);
+}
+
+/* element names */
+
+static const gchar *
+get_element_name (GstElement * element)
+{
+  const gchar *name;
+
+  name = g_object_get_qdata ((GObject *) element, name_quark);
+  if (G_LIKELY (name))
+    return name;
+
+  G_LOCK (copies_names);
+  if (!(name = g_object_get_qdata ((GObject *) element, name_quark))) {
+    name = g_intern_string (GST_STR_NULL (GST_OBJECT_NAME (element)));
+    g_object_set_qdata ((GObject *) element, name_quark, (gpointer) name);
+  }
+  G_UNLOCK (copies_names);
+
+  return name;
+}
+
+/* The element owning @pad, bins and pads of ghost pads are skipped as they
+ * only forward */
+static GstElement *
+get_pad_element (GstPad * pad)
+{
+  GstObject *parent;
+
+  if (!pad || GST_IS_PROXY_PAD (pad))
+    return NULL;
+
+  parent = GST_OBJECT_PARENT (pad);
+  if (!parent || !GST_IS_ELEMENT (parent) || GST_IS_BIN (parent))
+    return NULL;
+
+  return GST_ELEMENT_CAST (parent);
+}
+
+/* threads */
+
+static GstCopiesThread *
+get_thread (GstCopiesTracer * self)
+{
+  GHashTable *threads = g_private_get (&thread_data);
+  GstCopiesThread *thread;
+
+  if (G_UNLIKELY (!threads)) {
+    threads = g_hash_table_new_full (NULL, NULL, NULL,
+        (GDestroyNotify) free_thread);
+    g_private_set (&thread_data, threads);
+  }
+
+  thread = g_hash_table_lookup (threads, self);
+  if (G_UNLIKELY (!thread)) {
+    thread = g_new0 (GstCopiesThread, 1);
+    thread->stack = g_ptr_array_sized_new (16);
+    g_hash_table_insert (threads, self, thread);
+  }
+
+  return thread;
+}
+
+static void
+enter_element (GstCopiesTracer * self, GstPad * pad)
+{
+  GstCopiesThread *thread = get_thread (self);
+  GstElement *element;
+  const gchar *name;
+
+  if (thread->stack->len == 0) {
+    element = get_pad_element (pad);
+    thread->base = element ? get_element_name (element) : NULL;
+    name = thread->base;
+  } else {
+    name = g_ptr_array_index (thread->stack, thread->stack->len - 1);
+  }
+
+  if ((element = get_pad_element (GST_PAD_PEER (pad))))
+    name = get_element_name (element);
+
+  g_ptr_array_add (thread->stack, (gpointer) name);
+}
+
+static void
+leave_element (GstCopiesTracer * self)
+{
+  GstCopiesThread *thread = get_thread (self);
+
+  /* The tracer might have been created in the middle of a push */
+  if (thread->stack->len > 0)
+    g_ptr_array_set_size (thread->stack, thread->stack->len - 1);
+}
+
+static const gchar *
+get_current_element (GstCopiesTracer * self)
+{
+  GstCopiesThread *thread = get_thread (self);
+  const gchar *name;
+
+  if (thread->stack->len > 0)
+    name = g_ptr_array_index (thread->stack, thread->stack->len - 1);
+  else
+    name = thread->base;
+
+  return name ? name : NO_ELEMENT;
+}
+
+/* stats */
+
+static void
+add_copy (GstCopiesTracer * self, const gchar * kind, gsize bytes,
+    guint extra_refs)
+{
+  const gchar *element = get_current_element (self);
+  GstCopiesStats *stats;
+  gchar *trace = NULL;
+  gchar *key;
+
+  if (self->stack_traces)
+    trace = gst_debug_get_stack_trace (GST_STACK_TRACE_SHOW_NONE);
+
+  key = g_strconcat (element, "\n", kind, "\n", trace, NULL);
+
+  g_mutex_lock (&self->lock);
+  stats = g_hash_table_lookup (self->stats, key);
+  if (!stats) {
+    stats = g_new0 (GstCopiesStats, 1);
+    stats->element = element;
+    stats->kind = kind;
+    stats->trace = trace;
+    trace = NULL;
+    g_hash_table_insert (self->stats, key, stats);
+    key = NULL;
+  }
+  stats->count++;
+  stats->bytes += bytes;
+  stats->extra_refs += extra_refs;
+  g_mutex_unlock (&self->lock);
+
+  g_free (key);
+  g_free (trace);
+}
+
+/* hooks */
+
+static void
+do_push_buffer_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBuffer * buffer)
+{
+  enter_element (GST_COPIES_TRACER_CAST (tracer), pad);
+}
+
+static void
+do_push_buffer_list_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBufferList * list)
+{
+  enter_element (GST_COPIES_TRACER_CAST (tracer), pad);
+}
+
+static void
+do_pull_range_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    guint64 offset, guint size)
+{
+  enter_element (GST_COPIES_TRACER_CAST (tracer), pad);
+}
+
+static void
+do_push_post (GstTracer * tracer, guint64 ts, GstPad * pad, GstFlowReturn res)
+{
+  leave_element (GST_COPIES_TRACER_CAST (tracer));
+}
+
+static void
+do_pull_range_post (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBuffer * buffer, GstFlowReturn res)
+{
+  leave_element (GST_COPIES_TRACER_CAST (tracer));
+}
+
+static void
+do_memory_copy (GstTracer * tracer, guint64 ts, GstMemory * mem,
+    GstMemory * copy)
+{
+  add_copy (GST_COPIES_TRACER_CAST (tracer), KIND_MEMORY_COPY, copy->size, 0);
+}
+
+static void
+do_buffer_merge (GstTracer * tracer, guint64 ts, GstBuffer * buffer,
+    GstMemory * merged)
+{
+  add_copy (GST_COPIES_TRACER_CAST (tracer), KIND_BUFFER_MERGE, merged->size,
+      0);
+}
+
+static void
+do_mini_object_writable_copy (GstTracer * tracer, guint64 ts,
+    GstMiniObject * object, GstMiniObject * copy)
+{
+  gint refcount;
+
+  /* copying other mini objects doesn't copy any data */
+  if (!GST_IS_BUFFER (object))
+    return;
+
+  /* the reference replaced by the copy is still held */
+  refcount = GST_MINI_OBJECT_REFCOUNT_VALUE (object);
+  add_copy (GST_COPIES_TRACER_CAST (tracer), KIND_WRITABLE_COPY,
+      gst_buffer_get_size (GST_BUFFER_CAST (object)), MAX (refcount - 1, 0));
+}
+
+/* results */
+
+static gint
+compare_stats (gconstpointer a, gconstpointer b)
+{
+  const GstCopiesStats *sa = *(const GstCopiesStats **) a;
+  const GstCopiesStats *sb = *(const GstCopiesStats **) b;
+
+  if (sa->bytes != sb->bytes)
+    return sa->bytes > sb->bytes ? -1 : 1;
+  if (sa->count != sb->count)
+    return sa->count > sb->count ? -1 : 1;
+  return 0;
+}
+
+/* The stats, the biggest copies first; the stats belong to the tracer and @self
+ * must be locked for as long as they are used */
+static GPtrArray *
+get_sorted_stats (GstCopiesTracer * self)
+{
+  GPtrArray *res = g_ptr_array_new ();
+  GHashTableIter iter;
+  gpointer stats;
+
+  g_hash_table_iter_init (&iter, self->stats);
+  while (g_hash_table_iter_next (&iter, NULL, &stats))
+    g_ptr_array_add (res, stats);
+  g_ptr_array_sort (res, compare_stats);
+
+  return res;
+}
+
+static GstStructure *
+gst_copies_tracer_get_stats (GstCopiesTracer * self)
+{
+  GValue list = G_VALUE_INIT;
+  GstStructure *info;
+  GPtrArray *sorted;
+  guint i;
+
+  g_value_init (&list, GST_TYPE_LIST);
+
+  g_mutex_lock (&self->lock);
+  sorted = get_sorted_stats (self);
+  for (i = 0; i < sorted->len; i++) {
+    GstCopiesStats *stats = g_ptr_array_index (sorted, i);
+    GValue s_value = G_VALUE_INIT;
+    GstStructure *s;
+
+    s = gst_structure_new ("copy-stats", "element", G_TYPE_STRING,
+        stats->element, "kind", G_TYPE_STRING, stats->kind, "count",
+        G_TYPE_UINT64, stats->count, "bytes", G_TYPE_UINT64, stats->bytes,
+        "extra-refs", G_TYPE_UINT64, stats->extra_refs, NULL);
+    if (stats->trace)
+      gst_structure_set (s, "trace", G_TYPE_STRING, stats->trace, NULL);
+
+    /* avoid copy of the structure */
+    g_value_init (&s_value, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&s_value, s);
+    gst_value_list_append_and_take_value (&list, &s_value);
+  }
+  g_mutex_unlock (&self->lock);
+  g_ptr_array_unref (sorted);
+
+  info = gst_structure_new_empty ("copies-info");
+  gst_structure_take_value (info, "copies-list", &list);
+
+  return info;
+}
+
+static void
+log_stats (GstCopiesTracer * self)
+{
+  GPtrArray *sorted;
+  guint i;
+
+  g_mutex_lock (&self->lock);
+  sorted = get_sorted_stats (self);
+  for (i = 0; i < sorted->len; i++) {
+    GstCopiesStats *stats = g_ptr_array_index (sorted, i);
+
+    gst_tracer_record_log (tr_copies, stats->element, stats->kind,
+        stats->count, stats->bytes, stats->extra_refs,
+        stats->trace ? stats->trace : "");
+  }
+  g_mutex_unlock (&self->lock);
+  g_ptr_array_unref (sorted);
+}
+
+/* tracer class */
+
+static void
+set_params (GstCopiesTracer * self)
+{
+  gchar *params, *tmp;
+  GstStructure *params_struct = NULL;
+
+  g_object_get (self, "params", &params, NULL);
+  if (!params)
+    return;
+
+  tmp = g_strdup_printf ("copies,%s", params);
+  params_struct = gst_structure_from_string (tmp, NULL);
+  g_free (tmp);
+
+  if (params_struct) {
+    const gchar *name = gst_structure_get_string (params_struct, "name");
+
+    if (name)
+      gst_object_set_name (GST_OBJECT (self), name);
+    gst_structure_get_boolean (params_struct, "stack-traces",
+        &self->stack_traces);
+
+    gst_structure_free (params_struct);
+  } else {
+    GST_WARNING_OBJECT (self, "failed to parse params '%s'", params);
+  }
+  g_free (params);
+}
+
+static void
+gst_copies_tracer_constructed (GObject * object)
+{
+  GstCopiesTracer *self = GST_COPIES_TRACER (object);
+  GstTracer *tracer = GST_TRACER (object);
+
+  set_params (self);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (do_push_buffer_pre));
+  gst_tracing_register_hook (tracer, "pad-push-post",
+      G_CALLBACK (do_push_post));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_buffer_list_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (do_push_post));
+  gst_tracing_register_hook (tracer, "pad-pull-range-pre",
+      G_CALLBACK (do_pull_range_pre));
+  gst_tracing_register_hook (tracer, "pad-pull-range-post",
+      G_CALLBACK (do_pull_range_post));
+  gst_tracing_register_hook (tracer, "memory-copy",
+      G_CALLBACK (do_memory_copy));
+  gst_tracing_register_hook (tracer, "buffer-merge",
+      G_CALLBACK (do_buffer_merge));
+  gst_tracing_register_hook (tracer, "mini-object-writable-copy",
+      G_CALLBACK (do_mini_object_writable_copy));
+
+  ((GObjectClass *) parent_class)->constructed (object);
+}
+
+static void
+gst_copies_tracer_finalize (GObject * object)
+{
+  GstCopiesTracer *self = GST_COPIES_TRACER (object);
+
+  log_stats (self);
+
+  g_hash_table_unref (self->stats);
+  g_mutex_clear (&self->lock);
+
+  ((GObjectClass *) parent_class)->finalize (object);
+}
+
+#define RECORD_FIELD_STRING(name) \
+    name, GST_TYPE_STRUCTURE, gst_structure_new ("value", \
+        "type", G_TYPE_GTYPE, G_TYPE_STRING, \
+        NULL)
+#define RECORD_FIELD_UINT64(name) \
+    name, GST_TYPE_STRUCTURE, gst_structure_new ("value", \
+        "type", G_TYPE_GTYPE, G_TYPE_UINT64, \
+        NULL)
+
+static void
+gst_copies_tracer_class_init (GstCopiesTracerClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->constructed = gst_copies_tracer_constructed;
+  gobject_class->finalize = gst_copies_tracer_finalize;
+
+  tr_copies = gst_tracer_record_new ("copy-stats.class",
+      RECORD_FIELD_STRING ("element"), RECORD_FIELD_STRING ("kind"),
+      RECORD_FIELD_UINT64 ("count"), RECORD_FIELD_UINT64 ("bytes"),
+      RECORD_FIELD_UINT64 ("extra-refs"), RECORD_FIELD_STRING ("trace"),
+      NULL);
+  GST_OBJECT_FLAG_SET (tr_copies, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+
+  /**
+   * GstCopiesTracer::get-stats:
+   * @copiestracer: the copies tracer object to emit this signal on
+   *
+   * Returns a #GstStructure containing a #GValue of type #GST_TYPE_LIST
+   * named `copies-list`, a list of #GstStructure objects with the copies done
+   * so far, the biggest first. Each #GstStructure object has the following
+   * fields:
+   *
+   * `element`: the name of the element the copies were done in
+   * `kind`: the kind of copy, as described in the tracer documentation
+   * `count`: the number of copies
+   * `bytes`: the number of bytes copied
+   * `extra-refs`: for `writable-copy`, the number of other references held
+   *               on the copied buffers
+   * `trace`: the stack trace of the call site, only available if the
+   *          `stack-traces` param is set to `true`
+   *
+   * Returns: (transfer full): a newly-allocated #GstStructure
+   *
+   * Since: 1.24
+   */
+  gst_copies_tracer_signals[SIGNAL_GET_STATS] =
+      g_signal_new ("get-stats", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstCopiesTracerClass, get_stats), NULL, NULL, NULL,
+      GST_TYPE_STRUCTURE, 0, G_TYPE_NONE);
+
+  klass->get_stats = gst_copies_tracer_get_stats;
+
+  name_quark = g_quark_from_static_string ("gstcopies:name");
+}
+
+static void
+gst_copies_tracer_init (GstCopiesTracer * self)
+{
+  g_mutex_init (&self->lock);
+  self->stats = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+      (GDestroyNotify) free_stats);
+}
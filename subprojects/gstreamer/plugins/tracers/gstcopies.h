@@ -0,0 +1,71 @@
+/* GStreamer
+ *
+ * gstcopies.h: tracing module that finds the copies of buffer data
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_COPIES_TRACER_H__
+#define __GST_COPIES_TRACER_H__
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_COPIES_TRACER \
+  (gst_copies_tracer_get_type())
+#define GST_COPIES_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_COPIES_TRACER,GstCopiesTracer))
+#define GST_COPIES_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_COPIES_TRACER,GstCopiesTracerClass))
+#define GST_IS_COPIES_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_COPIES_TRACER))
+#define GST_IS_COPIES_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_COPIES_TRACER))
+#define GST_COPIES_TRACER_CAST(obj) ((GstCopiesTracer *)(obj))
+
+typedef struct _GstCopiesTracer GstCopiesTracer;
+typedef struct _GstCopiesTracerClass GstCopiesTracerClass;
+
+/**
+ * GstCopiesTracer:
+ *
+ * Opaque #GstCopiesTracer data structure
+ */
+struct _GstCopiesTracer {
+  GstTracer parent;
+
+  /*< private >*/
+  gboolean stack_traces;
+
+  /* key -> GstCopiesStats *, protected by lock */
+  GMutex lock;
+  GHashTable *stats;
+};
+
+struct _GstCopiesTracerClass {
+  GstTracerClass parent_class;
+
+  /* actions */
+  GstStructure * (*get_stats) (GstCopiesTracer *tracer);
+};
+
+G_GNUC_INTERNAL GType gst_copies_tracer_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_COPIES_TRACER_H__ */
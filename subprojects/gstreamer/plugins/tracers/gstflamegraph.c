@@ -0,0 +1,556 @@
+/* GStreamer
+ *
+ * gstflamegraph.c: tracing module that attributes cpu time to elements
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-flamegraph
+ * @short_description: attribute cpu time to elements for flame graphs
+ *
+ * A tracing module that keeps track of the element each streaming thread is
+ * currently running in, and attributes the cpu time of the thread to it. As
+ * elements usually share threads, this tells which element of a chain is
+ * actually using the cpu, which the rusage tracer can't.
+ *
+ * An element is entered when data is pushed into it or pulled from it and
+ * left when the push or pull returns, the time spent in the elements further
+ * downstream (or upstream for pulls) is not counted for it. The time a
+ * thread spends outside of any push is counted for the element running the
+ * thread, usually a source or a queue. Each thread only updates its own call
+ * tree, so the overhead is two reads of the thread's cpu clock per push.
+ *
+ * The result is written in the "folded stacks" format used by flame graph
+ * tools like `flamegraph.pl`, inferno or speedscope: one line per call
+ * stack, made of the top-level pipeline followed by the elements in call
+ * order (named by their path below the pipeline) and the time in
+ * microseconds:
+ *
+ * ```
+ * pipeline0;filesrc0;qtdemux0;queue0 1402
+ * pipeline0;queue0;decodebin0/avdec_h264-0 923077
+ * ```
+ *
+ * The stacks are written to a file when the tracer is destroyed in
+ * gst_deinit() and can be fetched at any time with the `get-folded-stacks`
+ * action signal, use gst_tracing_get_active_tracers() to find the tracer.
+ *
+ * Parameters:
+ * 1. file: (string) the file to write the stacks to, `gst-flamegraph.folded`
+ *    in the current directory by default
+ * 2. clock: (string) `cpu` (the default) for the thread's cpu time or `wall`
+ *    for wall clock time, which includes the time spent waiting. Platforms
+ *    without a per-thread cpu clock always use the wall clock.
+ * 3. name: (string) set a name for the tracer object itself
+ *
+ * ```
+ * GST_TRACERS="flamegraph(file=/tmp/pipeline.folded)" ./...
+ * flamegraph.pl /tmp/pipeline.folded > pipeline.svg
+ * ```
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include <string.h>
+#include <time.h>
+
+#include "gstflamegraph.h"
+#include "gsttracers_private.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_flame_graph_debug);
+#define GST_CAT_DEFAULT gst_flame_graph_debug
+
+enum
+{
+  /* actions */
+  SIGNAL_GET_FOLDED_STACKS,
+
+  LAST_SIGNAL
+};
+
+#define DEFAULT_FILE "gst-flamegraph.folded"
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_flame_graph_debug, "flamegraph", 0, "flamegraph tracer");
+#define gst_flame_graph_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstFlameGraphTracer, gst_flame_graph_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+static gchar *gst_flame_graph_tracer_get_folded_stacks (GstFlameGraphTracer *
+    self);
+
+static guint gst_flame_graph_tracer_signals[LAST_SIGNAL] = { 0 };
+
+/* Protects setting the names of the elements */
+G_LOCK_DEFINE_STATIC (flame_graph_names);
+static GQuark names_quark;
+
+/* The frame names of an element, interned */
+typedef struct
+{
+  const gchar *pipeline;
+  const gchar *name;
+} GstFlameGraphNames;
+
+typedef struct _GstFlameGraphNode GstFlameGraphNode;
+
+struct _GstFlameGraphNode
+{
+  const gchar *name;
+  GHashTable *children;         /* interned name -> GstFlameGraphNode */
+  GstClockTime time;
+};
+
+typedef struct
+{
+  /* only taken by the thread itself and when collecting the stacks */
+  GMutex lock;
+  GstFlameGraphNode root;
+  GstFlameGraphNode *current;
+  GPtrArray *stack;             /* GstFlameGraphNode *, callers of current */
+  GstClockTime last;
+} GstFlameGraphThread;
+
+/* call tree */
+
+static void
+free_node (GstFlameGraphNode * node)
+{
+  if (node->children)
+    g_hash_table_unref (node->children);
+  g_free (node);
+}
+
+static GstFlameGraphNode *
+get_child_node (GstFlameGraphNode * node, const gchar * name)
+{
+  GstFlameGraphNode *child;
+
+  if (G_UNLIKELY (!node->children))
+    node->children = g_hash_table_new_full (NULL, NULL, NULL,
+        (GDestroyNotify) free_node);
+
+  child = g_hash_table_lookup (node->children, name);
+  if (G_UNLIKELY (!child)) {
+    child = g_new0 (GstFlameGraphNode, 1);
+    child->name = name;
+    g_hash_table_insert (node->children, (gpointer) name, child);
+  }
+
+  return child;
+}
+
+static const gchar *
+intern_frame_name (const gchar * name)
+{
+  gchar *tmp;
+  const gchar *res;
+
+  if (!strchr (name, ';'))
+    return g_intern_string (name);
+
+  /* ';' separates the frames */
+  tmp = g_strdelimit (g_strdup (name), ";", '_');
+  res = g_intern_string (tmp);
+  g_free (tmp);
+
+  return res;
+}
+
+static const GstFlameGraphNames *
+get_element_names (GstElement * element)
+{
+  GstFlameGraphNames *names;
+  GstObject *obj, *top;
+  GString *path;
+
+  names = g_object_get_qdata ((GObject *) element, names_quark);
+  if (G_LIKELY (names))
+    return names;
+
+  G_LOCK (flame_graph_names);
+  if (!(names = g_object_get_qdata ((GObject *) element, names_quark))) {
+    names = g_new0 (GstFlameGraphNames, 1);
+
+    top = GST_OBJECT_CAST (element);
+    while (GST_OBJECT_PARENT (top))
+      top = GST_OBJECT_PARENT (top);
+
+    path = g_string_new (GST_STR_NULL (GST_OBJECT_NAME (element)));
+    for (obj = GST_OBJECT_PARENT (element); obj && obj != top;
+        obj = GST_OBJECT_PARENT (obj)) {
+      g_string_prepend_c (path, '/');
+      g_string_prepend (path, GST_STR_NULL (GST_OBJECT_NAME (obj)));
+    }
+
+    if (top != GST_OBJECT_CAST (element))
+      names->pipeline = intern_frame_name (GST_STR_NULL (GST_OBJECT_NAME (top)));
+    names->name = intern_frame_name (path->str);
+    g_string_free (path, TRUE);
+
+    g_object_set_qdata_full ((GObject *) element, names_quark, names, g_free);
+  }
+  G_UNLOCK (flame_graph_names);
+
+  return names;
+}
+
+static GstFlameGraphNode *
+get_element_node (GstFlameGraphThread * thread, GstFlameGraphNode * node,
+    GstElement * element)
+{
+  const GstFlameGraphNames *names = get_element_names (element);
+
+  if (node == &thread->root && names->pipeline)
+    node = get_child_node (node, names->pipeline);
+
+  return get_child_node (node, names->name);
+}
+
+/* threads */
+
+static GstFlameGraphThread *
+get_thread (GstFlameGraphTracer * self)
+{
+  GstFlameGraphThread *thread;
+
+  /* Other tracer instances have their own call trees */
+  thread = gst_tracers_get_thread_data (GST_TRACER_CAST (self));
+  if (G_LIKELY (thread))
+    return thread;
+
+  thread = g_new0 (GstFlameGraphThread, 1);
+  g_mutex_init (&thread->lock);
+  thread->current = &thread->root;
+  thread->stack = g_ptr_array_sized_new (16);
+  thread->last = GST_CLOCK_TIME_NONE;
+  gst_tracers_set_thread_data (GST_TRACER_CAST (self), thread);
+
+  g_mutex_lock (&self->lock);
+  g_ptr_array_add (self->threads, thread);
+  g_mutex_unlock (&self->lock);
+
+  return thread;
+}
+
+static void
+free_thread (GstFlameGraphThread * thread)
+{
+  if (thread->root.children)
+    g_hash_table_unref (thread->root.children);
+  g_ptr_array_unref (thread->stack);
+  g_mutex_clear (&thread->lock);
+  g_free (thread);
+}
+
+static inline GstClockTime
+get_time (GstFlameGraphTracer * self, guint64 ts)
+{
+#if defined (HAVE_CLOCK_GETTIME) && defined (CLOCK_THREAD_CPUTIME_ID)
+  struct timespec now;
+
+  if (!self->wall_clock && !clock_gettime (CLOCK_THREAD_CPUTIME_ID, &now))
+    return GST_TIMESPEC_TO_TIME (now);
+#endif
+
+  return ts;
+}
+
+static inline void
+account_time (GstFlameGraphThread * thread, GstClockTime now)
+{
+  if (GST_CLOCK_TIME_IS_VALID (thread->last) && now > thread->last)
+    thread->current->time += now - thread->last;
+  thread->last = now;
+}
+
+static void
+enter_element (GstFlameGraphTracer * self, guint64 ts, GstPad * pad)
+{
+  GstFlameGraphThread *thread = get_thread (self);
+  GstClockTime now = get_time (self, ts);
+  GstElement *element;
+
+  g_mutex_lock (&thread->lock);
+  if (thread->stack->len == 0) {
+    /* The time since the last push done from this thread belongs to the
+     * element running it */
+    element = gst_tracers_get_pad_element (pad);
+    thread->current = element ?
+        get_element_node (thread, &thread->root, element) : &thread->root;
+  }
+  account_time (thread, now);
+
+  g_ptr_array_add (thread->stack, thread->current);
+  if ((element = gst_tracers_get_pad_element (GST_PAD_PEER (pad))))
+    thread->current = get_element_node (thread, thread->current, element);
+  g_mutex_unlock (&thread->lock);
+}
+
+static void
+leave_element (GstFlameGraphTracer * self, guint64 ts)
+{
+  GstFlameGraphThread *thread = get_thread (self);
+  GstClockTime now = get_time (self, ts);
+
+  g_mutex_lock (&thread->lock);
+  /* The tracer might have been created in the middle of a push */
+  if (thread->stack->len > 0) {
+    account_time (thread, now);
+    thread->current = g_ptr_array_steal_index (thread->stack,
+        thread->stack->len - 1);
+  }
+  g_mutex_unlock (&thread->lock);
+}
+
+/* hooks */
+
+static void
+do_push_buffer_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBuffer * buffer)
+{
+  enter_element (GST_FLAME_GRAPH_TRACER_CAST (tracer), ts, pad);
+}
+
+static void
+do_push_buffer_list_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBufferList * list)
+{
+  enter_element (GST_FLAME_GRAPH_TRACER_CAST (tracer), ts, pad);
+}
+
+static void
+do_pull_range_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    guint64 offset, guint size)
+{
+  enter_element (GST_FLAME_GRAPH_TRACER_CAST (tracer), ts, pad);
+}
+
+static void
+do_push_post (GstTracer * tracer, guint64 ts, GstPad * pad, GstFlowReturn res)
+{
+  leave_element (GST_FLAME_GRAPH_TRACER_CAST (tracer), ts);
+}
+
+static void
+do_pull_range_post (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBuffer * buffer, GstFlowReturn res)
+{
+  leave_element (GST_FLAME_GRAPH_TRACER_CAST (tracer), ts);
+}
+
+/* folded stacks */
+
+static void
+collect_stacks (GstFlameGraphNode * node, GString * path, GHashTable * totals)
+{
+  gsize len = path->len;
+
+  if (node->name) {
+    if (len > 0)
+      g_string_append_c (path, ';');
+    g_string_append (path, node->name);
+
+    if (node->time > 0) {
+      guint64 *total = g_hash_table_lookup (totals, path->str);
+
+      if (!total) {
+        total = g_new0 (guint64, 1);
+        g_hash_table_insert (totals, g_strdup (path->str), total);
+      }
+      *total += node->time;
+    }
+  }
+
+  if (node->children) {
+    GHashTableIter iter;
+    gpointer child;
+
+    g_hash_table_iter_init (&iter, node->children);
+    while (g_hash_table_iter_next (&iter, NULL, &child))
+      collect_stacks (child, path, totals);
+  }
+
+  g_string_truncate (path, len);
+}
+
+static gchar *
+gst_flame_graph_tracer_get_folded_stacks (GstFlameGraphTracer * self)
+{
+  GHashTable *totals;
+  GString *path, *res;
+  GList *stacks, *l;
+  guint i;
+
+  /* Threads running in the same elements end up in the same stacks */
+  totals = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+  path = g_string_new (NULL);
+
+  g_mutex_lock (&self->lock);
+  for (i = 0; i < self->threads->len; i++) {
+    GstFlameGraphThread *thread = g_ptr_array_index (self->threads, i);
+
+    g_mutex_lock (&thread->lock);
+    collect_stacks (&thread->root, path, totals);
+    g_mutex_unlock (&thread->lock);
+  }
+  g_mutex_unlock (&self->lock);
+
+  res = g_string_new (NULL);
+  stacks = g_list_sort (g_hash_table_get_keys (totals), (GCompareFunc) strcmp);
+  for (l = stacks; l; l = l->next) {
+    guint64 *total = g_hash_table_lookup (totals, l->data);
+
+    if (*total >= GST_USECOND)
+      g_string_append_printf (res, "%s %" G_GUINT64_FORMAT "\n",
+          (const gchar *) l->data, *total / GST_USECOND);
+  }
+  g_list_free (stacks);
+
+  g_string_free (path, TRUE);
+  g_hash_table_unref (totals);
+
+  return g_string_free (res, FALSE);
+}
+
+/* tracer class */
+
+static void
+set_params (GstFlameGraphTracer * self)
+{
+  gchar *params, *tmp;
+  GstStructure *params_struct = NULL;
+
+  g_object_get (self, "params", &params, NULL);
+  if (params) {
+    tmp = g_strdup_printf ("flamegraph,%s", params);
+    params_struct = gst_structure_from_string (tmp, NULL);
+    g_free (tmp);
+
+    if (params_struct) {
+      const gchar *name = gst_structure_get_string (params_struct, "name");
+      const gchar *clock = gst_structure_get_string (params_struct, "clock");
+      const gchar *file = gst_structure_get_string (params_struct, "file");
+
+      if (name)
+        gst_object_set_name (GST_OBJECT (self), name);
+      if (file)
+        self->file = g_strdup (file);
+      if (!g_strcmp0 (clock, "wall"))
+        self->wall_clock = TRUE;
+      else if (clock && g_strcmp0 (clock, "cpu"))
+        GST_WARNING_OBJECT (self, "unknown clock '%s'", clock);
+
+      gst_structure_free (params_struct);
+    } else {
+      GST_WARNING_OBJECT (self, "failed to parse params '%s'", params);
+    }
+    g_free (params);
+  }
+
+  if (!self->file)
+    self->file = g_strdup (DEFAULT_FILE);
+}
+
+static void
+gst_flame_graph_tracer_constructed (GObject * object)
+{
+  GstFlameGraphTracer *self = GST_FLAME_GRAPH_TRACER (object);
+  GstTracer *tracer = GST_TRACER (object);
+
+  set_params (self);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (do_push_buffer_pre));
+  gst_tracing_register_hook (tracer, "pad-push-post",
+      G_CALLBACK (do_push_post));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_buffer_list_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (do_push_post));
+  gst_tracing_register_hook (tracer, "pad-pull-range-pre",
+      G_CALLBACK (do_pull_range_pre));
+  gst_tracing_register_hook (tracer, "pad-pull-range-post",
+      G_CALLBACK (do_pull_range_post));
+
+  ((GObjectClass *) parent_class)->constructed (object);
+}
+
+static void
+gst_flame_graph_tracer_finalize (GObject * object)
+{
+  GstFlameGraphTracer *self = GST_FLAME_GRAPH_TRACER (object);
+  GError *err = NULL;
+  gchar *stacks;
+
+  stacks = gst_flame_graph_tracer_get_folded_stacks (self);
+  if (*stacks) {
+    if (!g_file_set_contents (self->file, stacks, -1, &err)) {
+      GST_ERROR_OBJECT (self, "failed to write %s: %s", self->file,
+          err->message);
+      g_clear_error (&err);
+    }
+  }
+  g_free (stacks);
+
+  g_ptr_array_unref (self->threads);
+  g_mutex_clear (&self->lock);
+  g_free (self->file);
+
+  ((GObjectClass *) parent_class)->finalize (object);
+}
+
+static void
+gst_flame_graph_tracer_class_init (GstFlameGraphTracerClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->constructed = gst_flame_graph_tracer_constructed;
+  gobject_class->finalize = gst_flame_graph_tracer_finalize;
+
+  /**
+   * GstFlameGraphTracer::get-folded-stacks:
+   * @flamegraphtracer: the flamegraph tracer object to emit this signal on
+   *
+   * Returns the time spent in each element so far, in the folded stacks
+   * format described in the tracer documentation.
+   *
+   * Returns: (transfer full): a newly-allocated string
+   *
+   * Since: 1.24
+   */
+  gst_flame_graph_tracer_signals[SIGNAL_GET_FOLDED_STACKS] =
+      g_signal_new ("get-folded-stacks", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstFlameGraphTracerClass, get_folded_stacks), NULL,
+      NULL, NULL, G_TYPE_STRING, 0, G_TYPE_NONE);
+
+  klass->get_folded_stacks = gst_flame_graph_tracer_get_folded_stacks;
+
+  names_quark = g_quark_from_static_string ("gstflamegraph:names");
+}
+
+static void
+gst_flame_graph_tracer_init (GstFlameGraphTracer * self)
+{
+  g_mutex_init (&self->lock);
+  self->threads = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      free_thread);
+}
@@ -0,0 +1,72 @@
+/* GStreamer
+ *
+ * gstflamegraph.h: tracing module that attributes cpu time to elements
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_FLAME_GRAPH_TRACER_H__
+#define __GST_FLAME_GRAPH_TRACER_H__
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_FLAME_GRAPH_TRACER \
+  (gst_flame_graph_tracer_get_type())
+#define GST_FLAME_GRAPH_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_FLAME_GRAPH_TRACER,GstFlameGraphTracer))
+#define GST_FLAME_GRAPH_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_FLAME_GRAPH_TRACER,GstFlameGraphTracerClass))
+#define GST_IS_FLAME_GRAPH_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_FLAME_GRAPH_TRACER))
+#define GST_IS_FLAME_GRAPH_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_FLAME_GRAPH_TRACER))
+#define GST_FLAME_GRAPH_TRACER_CAST(obj) ((GstFlameGraphTracer *)(obj))
+
+typedef struct _GstFlameGraphTracer GstFlameGraphTracer;
+typedef struct _GstFlameGraphTracerClass GstFlameGraphTracerClass;
+
+/**
+ * GstFlameGraphTracer:
+ *
+ * Opaque #GstFlameGraphTracer data structure
+ */
+struct _GstFlameGraphTracer {
+  GstTracer parent;
+
+  /*< private >*/
+  gchar *file;
+  gboolean wall_clock;
+
+  /* GstFlameGraphThread *, one for each thread that ran a hook */
+  GMutex lock;
+  GPtrArray *threads;
+};
+
+struct _GstFlameGraphTracerClass {
+  GstTracerClass parent_class;
+
+  /* actions */
+  gchar * (*get_folded_stacks) (GstFlameGraphTracer *tracer);
+};
+
+G_GNUC_INTERNAL GType gst_flame_graph_tracer_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_FLAME_GRAPH_TRACER_H__ */
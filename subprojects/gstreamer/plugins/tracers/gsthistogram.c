@@ -0,0 +1,853 @@
+/* GStreamer
+ *
+ * gsthistogram.c: tracing module that keeps latency histograms
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+/**
+ * SECTION:tracer-histogram
+ * @short_description: keep latency and throughput histograms
+ *
+ * A tracing module that keeps fixed-bucket, log-linear histograms instead of
+ * logging every event, so it is cheap enough to be left enabled. Recording a
+ * value only increments a counter in one of a few per-thread shards of the
+ * histogram.
+ *
+ * For every pad it tracks the time spent in gst_pad_push() (or
+ * gst_pad_pull_range()), including everything downstream, and the gap
+ * between two consecutive buffers. For every element it tracks the
+ * processing time of its chain (or getrange) function, excluding the time
+ * spent in pushes done from it, and for queue elements the time buffers
+ * spend inside the queue.
+ *
+ * The histograms are fetched with the `get-snapshot` action signal, use
+ * gst_tracing_get_active_tracers() to find the tracer. With the `interval`
+ * parameter the same snapshot is also posted periodically as an element
+ * message on the bus of all running top-level pipelines.
+ *
+ * Parameters:
+ * 1. interval: (uint) interval in milliseconds at which to post snapshots on
+ *    the bus, 0 (the default) to disable
+ * 2. queues: (string) comma separated list of element factory names for which
+ *    the residency time is tracked, "queue,queue2,multiqueue" by default
+ * 3. name: (string) set a name for the tracer object itself
+ *
+ * ```
+ * GST_TRACERS="histogram(interval=10000)" ./...
+ * ```
+ *
+ * The snapshot is a `histogram-snapshot` structure with a `pads` and an
+ * `elements` field, each a list of structures with the `name` of the object
+ * and, for each of the histograms (`push` and `gap` for pads, `processing`
+ * and `residency` for elements), `-count`, `-p50`, `-p90`, `-p99`, `-p999`
+ * and `-max` fields in nanoseconds. The histograms are cumulative since the
+ * object was first seen; values are accurate to 1/8.
+ *
+ * Since: 1.24
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gsthistogram.h"
+#include "gsttracers_private.h"
+
+GST_DEBUG_CATEGORY_STATIC (gst_histogram_debug);
+#define GST_CAT_DEFAULT gst_histogram_debug
+
+enum
+{
+  /* actions */
+  SIGNAL_GET_SNAPSHOT,
+
+  LAST_SIGNAL
+};
+
+#define DEFAULT_INTERVAL 0
+#define DEFAULT_QUEUES "queue,queue2,multiqueue"
+
+/* 8 sub-buckets per power of two, up to 2^36ns (about 68 seconds) */
+#define HISTOGRAM_SUB_BUCKET_BITS 3
+#define HISTOGRAM_SUB_BUCKETS (1 << HISTOGRAM_SUB_BUCKET_BITS)
+#define HISTOGRAM_MAX_BITS 36
+#define HISTOGRAM_MAX_VALUE (G_GUINT64_CONSTANT (1) << HISTOGRAM_MAX_BITS)
+#define HISTOGRAM_N_BUCKETS \
+    ((HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BUCKET_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+#define HISTOGRAM_N_SHARDS 4
+
+/* buffers that are remembered per queue element at most */
+#define MAX_PENDING_BUFFERS 16384
+
+#define _do_init \
+    GST_DEBUG_CATEGORY_INIT (gst_histogram_debug, "histogram", 0, "histogram tracer");
+#define gst_histogram_tracer_parent_class parent_class
+G_DEFINE_TYPE_WITH_CODE (GstHistogramTracer, gst_histogram_tracer,
+    GST_TYPE_TRACER, _do_init);
+
+static GstStructure *gst_histogram_tracer_get_snapshot (GstHistogramTracer *
+    self);
+
+static guint gst_histogram_tracer_signals[LAST_SIGNAL] = { 0 };
+
+/* Protects the pads and elements lists of all tracers, and the tracer
+ * pointer of the stats */
+G_LOCK_DEFINE_STATIC (histogram_stats);
+
+typedef struct
+{
+  guint counts[HISTOGRAM_N_BUCKETS];
+} GstHistogramShard;
+
+typedef struct
+{
+  GstHistogramShard shards[HISTOGRAM_N_SHARDS];
+} GstHistogram;
+
+typedef struct
+{
+  GstHistogramTracer *tracer;
+  GList *link;
+  gchar *name;
+
+  GstHistogram push;
+  GstHistogram gap;
+  /* only written from the streaming thread */
+  GstClockTime last_ts;
+} GstHistogramPadStats;
+
+typedef struct
+{
+  GstMiniObject *obj;
+  GstClockTime ts;
+} GstHistogramPending;
+
+typedef struct
+{
+  GstHistogramTracer *tracer;
+  GList *link;
+  gchar *name;
+
+  GstHistogram processing;
+
+  /* queue elements only */
+  gboolean is_queue;
+  GstHistogram *residency;
+  GMutex lock;
+  GQueue pending;               /* GstHistogramPending */
+} GstHistogramElementStats;
+
+/* A push or pull that is currently in progress in a thread */
+typedef struct
+{
+  GstHistogramTracer *tracer;
+  GstHistogramPadStats *pad_stats;
+  GstHistogramElementStats *peer_stats;
+  GstClockTime start;
+  GstClockTime child_time;
+} GstHistogramFrame;
+
+static void
+frame_stack_destroy (gpointer data)
+{
+  g_array_unref (data);
+}
+
+static GPrivate frame_stack = G_PRIVATE_INIT (frame_stack_destroy);
+static GPrivate shard_index;
+static gint next_shard_index = 0;
+
+/* histogram helpers */
+
+static inline guint
+histogram_bucket (guint64 value)
+{
+  guint shift;
+
+  if (value < HISTOGRAM_SUB_BUCKETS)
+    return value;
+  if (value >= HISTOGRAM_MAX_VALUE)
+    value = HISTOGRAM_MAX_VALUE - 1;
+
+  shift = g_bit_nth_msf (value, -1) - HISTOGRAM_SUB_BUCKET_BITS;
+
+  return (shift + 1) * HISTOGRAM_SUB_BUCKETS +
+      ((value >> shift) - HISTOGRAM_SUB_BUCKETS);
+}
+
+/* The largest value that is counted in bucket @idx */
+static guint64
+histogram_bucket_max (guint idx)
+{
+  guint block = idx >> HISTOGRAM_SUB_BUCKET_BITS;
+  guint sub = idx & (HISTOGRAM_SUB_BUCKETS - 1);
+
+  if (block == 0)
+    return sub;
+
+  return ((guint64) (HISTOGRAM_SUB_BUCKETS + sub + 1) << (block - 1)) - 1;
+}
+
+static inline guint
+get_shard_index (void)
+{
+  guint idx = GPOINTER_TO_UINT (g_private_get (&shard_index));
+
+  if (G_UNLIKELY (idx == 0)) {
+    idx = (g_atomic_int_add (&next_shard_index, 1) % HISTOGRAM_N_SHARDS) + 1;
+    g_private_set (&shard_index, GUINT_TO_POINTER (idx));
+  }
+
+  return idx - 1;
+}
+
+static inline void
+histogram_record (GstHistogram * hist, guint64 value)
+{
+  GstHistogramShard *shard = &hist->shards[get_shard_index ()];
+
+  g_atomic_int_inc (&shard->counts[histogram_bucket (value)]);
+}
+
+static void
+histogram_add_fields (GstHistogram * hist, GstStructure * s,
+    const gchar * prefix)
+{
+  static const struct
+  {
+    const gchar *name;
+    guint permille;
+  } quantiles[] = {
+    {"p50", 500}, {"p90", 900}, {"p99", 990}, {"p999", 999}
+  };
+  guint64 counts[HISTOGRAM_N_BUCKETS] = { 0, };
+  guint64 total = 0, cumulative = 0, max = 0;
+  guint i, j, q = 0;
+  gchar *field;
+
+  for (i = 0; i < HISTOGRAM_N_BUCKETS; i++) {
+    for (j = 0; j < HISTOGRAM_N_SHARDS; j++)
+      counts[i] += (guint) g_atomic_int_get (&hist->shards[j].counts[i]);
+    total += counts[i];
+    if (counts[i])
+      max = histogram_bucket_max (i);
+  }
+
+  field = g_strdup_printf ("%s-count", prefix);
+  gst_structure_set (s, field, G_TYPE_UINT64, total, NULL);
+  g_free (field);
+
+  for (i = 0; i < HISTOGRAM_N_BUCKETS && q < G_N_ELEMENTS (quantiles); i++) {
+    cumulative += counts[i];
+    /* the first bucket at or above the quantile, for all quantiles hit */
+    while (q < G_N_ELEMENTS (quantiles) && total > 0
+        && cumulative * 1000 >= total * quantiles[q].permille) {
+      field = g_strdup_printf ("%s-%s", prefix, quantiles[q].name);
+      gst_structure_set (s, field, G_TYPE_UINT64, histogram_bucket_max (i),
+          NULL);
+      g_free (field);
+      q++;
+    }
+  }
+  for (; q < G_N_ELEMENTS (quantiles); q++) {
+    field = g_strdup_printf ("%s-%s", prefix, quantiles[q].name);
+    gst_structure_set (s, field, G_TYPE_UINT64, G_GUINT64_CONSTANT (0), NULL);
+    g_free (field);
+  }
+
+  field = g_strdup_printf ("%s-max", prefix);
+  gst_structure_set (s, field, G_TYPE_UINT64, max, NULL);
+  g_free (field);
+}
+
+/* stats helpers */
+
+static void
+free_pad_stats (GstHistogramPadStats * stats)
+{
+  G_LOCK (histogram_stats);
+  if (stats->tracer)
+    g_queue_delete_link (&stats->tracer->pads, stats->link);
+  G_UNLOCK (histogram_stats);
+
+  g_free (stats->name);
+  g_free (stats);
+}
+
+static void
+free_element_stats (GstHistogramElementStats * stats)
+{
+  GstHistogramPending *pending;
+
+  G_LOCK (histogram_stats);
+  if (stats->tracer)
+    g_queue_delete_link (&stats->tracer->elements, stats->link);
+  G_UNLOCK (histogram_stats);
+
+  while ((pending = g_queue_pop_head (&stats->pending)))
+    g_free (pending);
+  g_mutex_clear (&stats->lock);
+  g_free (stats->residency);
+  g_free (stats->name);
+  g_free (stats);
+}
+
+static gboolean
+is_queue_element (GstHistogramTracer * self, GstElement * element)
+{
+  GstElementFactory *factory = gst_element_get_factory (element);
+  const gchar *name;
+
+  if (!factory || !self->queues)
+    return FALSE;
+
+  name = GST_OBJECT_NAME (factory);
+
+  return g_strv_contains ((const gchar * const *) self->queues, name);
+}
+
+static GstHistogramPadStats *
+get_pad_stats (GstHistogramTracer * self, GstPad * pad)
+{
+  GstHistogramPadStats *stats;
+
+  /* ghost and proxy pads just forward, the time is accounted on the real
+   * pads inside the bin */
+  if (G_UNLIKELY (!pad || GST_IS_PROXY_PAD (pad)))
+    return NULL;
+
+  stats = g_object_get_qdata ((GObject *) pad, self->data_quark);
+  if (G_LIKELY (stats))
+    return stats;
+
+  G_LOCK (histogram_stats);
+  if (!(stats = g_object_get_qdata ((GObject *) pad, self->data_quark))) {
+    stats = g_new0 (GstHistogramPadStats, 1);
+    stats->tracer = self;
+    stats->name = g_strdup_printf ("%s:%s", GST_DEBUG_PAD_NAME (pad));
+    stats->last_ts = GST_CLOCK_TIME_NONE;
+    g_queue_push_tail (&self->pads, stats);
+    stats->link = self->pads.tail;
+    g_object_set_qdata_full ((GObject *) pad, self->data_quark, stats,
+        (GDestroyNotify) free_pad_stats);
+  }
+  G_UNLOCK (histogram_stats);
+
+  return stats;
+}
+
+static GstHistogramElementStats *
+get_element_stats (GstHistogramTracer * self, GstElement * element)
+{
+  GstHistogramElementStats *stats;
+
+  stats = g_object_get_qdata ((GObject *) element, self->data_quark);
+  if (G_LIKELY (stats))
+    return stats;
+
+  G_LOCK (histogram_stats);
+  if (!(stats = g_object_get_qdata ((GObject *) element, self->data_quark))) {
+    stats = g_new0 (GstHistogramElementStats, 1);
+    stats->tracer = self;
+    stats->name = g_strdup (GST_STR_NULL (GST_OBJECT_NAME (element)));
+    if (is_queue_element (self, element)) {
+      stats->is_queue = TRUE;
+      stats->residency = g_new0 (GstHistogram, 1);
+    }
+    g_mutex_init (&stats->lock);
+    g_queue_init (&stats->pending);
+    g_queue_push_tail (&self->elements, stats);
+    stats->link = self->elements.tail;
+    g_object_set_qdata_full ((GObject *) element, self->data_quark, stats,
+        (GDestroyNotify) free_element_stats);
+  }
+  G_UNLOCK (histogram_stats);
+
+  return stats;
+}
+
+/* The element doing the work when data is pushed into or pulled from @pad,
+ * bins and pads of ghost pads are skipped */
+static GstHistogramElementStats *
+get_peer_element_stats (GstHistogramTracer * self, GstPad * pad)
+{
+  GstElement *element = gst_tracers_get_pad_element (GST_PAD_PEER (pad));
+
+  return element ? get_element_stats (self, element) : NULL;
+}
+
+static GstHistogramElementStats *
+get_parent_element_stats (GstHistogramTracer * self, GstPad * pad)
+{
+  GstElement *element = gst_tracers_get_pad_element (pad);
+
+  return element ? get_element_stats (self, element) : NULL;
+}
+
+/* queue residency */
+
+static void
+queue_enter (GstHistogramElementStats * stats, GstMiniObject * obj,
+    GstClockTime ts)
+{
+  GstHistogramPending *pending;
+
+  g_mutex_lock (&stats->lock);
+  if (stats->pending.length >= MAX_PENDING_BUFFERS)
+    pending = g_queue_pop_head (&stats->pending);
+  else
+    pending = g_new (GstHistogramPending, 1);
+  pending->obj = obj;
+  pending->ts = ts;
+  g_queue_push_tail (&stats->pending, pending);
+  g_mutex_unlock (&stats->lock);
+}
+
+static void
+queue_leave (GstHistogramElementStats * stats, GstMiniObject * obj,
+    GstClockTime ts)
+{
+  GstHistogramPending *pending = NULL;
+  GList *l;
+
+  g_mutex_lock (&stats->lock);
+  /* Usually the head, unless there are multiple streams as in multiqueue */
+  for (l = stats->pending.head; l; l = l->next) {
+    if (((GstHistogramPending *) l->data)->obj == obj) {
+      pending = l->data;
+      g_queue_delete_link (&stats->pending, l);
+      break;
+    }
+  }
+  g_mutex_unlock (&stats->lock);
+
+  if (pending) {
+    histogram_record (stats->residency, GST_CLOCK_DIFF (pending->ts, ts));
+    g_free (pending);
+  }
+}
+
+/* frames */
+
+static GArray *
+get_frame_stack (void)
+{
+  GArray *stack = g_private_get (&frame_stack);
+
+  if (G_UNLIKELY (!stack)) {
+    stack = g_array_sized_new (FALSE, FALSE, sizeof (GstHistogramFrame), 16);
+    g_private_set (&frame_stack, stack);
+  }
+
+  return stack;
+}
+
+static void
+frame_begin (GstHistogramTracer * self, GstClockTime ts, GstPad * pad,
+    GstMiniObject * obj)
+{
+  GArray *stack = get_frame_stack ();
+  GstHistogramFrame frame;
+
+  frame.tracer = self;
+  frame.pad_stats = get_pad_stats (self, pad);
+  frame.peer_stats = get_peer_element_stats (self, pad);
+  frame.start = ts;
+  frame.child_time = 0;
+
+  if (frame.pad_stats) {
+    if (GST_CLOCK_TIME_IS_VALID (frame.pad_stats->last_ts))
+      histogram_record (&frame.pad_stats->gap,
+          GST_CLOCK_DIFF (frame.pad_stats->last_ts, ts));
+    frame.pad_stats->last_ts = ts;
+  }
+
+  if (obj) {
+    GstHistogramElementStats *stats;
+
+    if (frame.peer_stats && frame.peer_stats->is_queue)
+      queue_enter (frame.peer_stats, obj, ts);
+    if ((stats = get_parent_element_stats (self, pad)) && stats->is_queue)
+      queue_leave (stats, obj, ts);
+  }
+
+  g_array_append_val (stack, frame);
+}
+
+static void
+frame_end (GstHistogramTracer * self, GstClockTime ts)
+{
+  GArray *stack = get_frame_stack ();
+  GstHistogramFrame *frame = NULL;
+  GstClockTime total, own;
+  gint i;
+
+  /* Other tracer instances might have frames on the same stack */
+  for (i = stack->len - 1; i >= 0; i--) {
+    frame = &g_array_index (stack, GstHistogramFrame, i);
+    if (frame->tracer == self)
+      break;
+  }
+  if (i < 0)
+    return;
+
+  total = GST_CLOCK_DIFF (frame->start, ts);
+  own = total > frame->child_time ? total - frame->child_time : 0;
+
+  if (frame->pad_stats)
+    histogram_record (&frame->pad_stats->push, total);
+  if (frame->peer_stats)
+    histogram_record (&frame->peer_stats->processing, own);
+
+  g_array_remove_index (stack, i);
+
+  /* Not part of the processing time of the element pushing */
+  for (i--; i >= 0; i--) {
+    frame = &g_array_index (stack, GstHistogramFrame, i);
+    if (frame->tracer == self) {
+      frame->child_time += total;
+      break;
+    }
+  }
+}
+
+/* hooks */
+
+static void
+do_push_buffer_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBuffer * buffer)
+{
+  frame_begin (GST_HISTOGRAM_TRACER_CAST (tracer), ts, pad,
+      GST_MINI_OBJECT_CAST (buffer));
+}
+
+static void
+do_push_buffer_list_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBufferList * list)
+{
+  frame_begin (GST_HISTOGRAM_TRACER_CAST (tracer), ts, pad,
+      GST_MINI_OBJECT_CAST (list));
+}
+
+static void
+do_pull_range_pre (GstTracer * tracer, guint64 ts, GstPad * pad,
+    guint64 offset, guint size)
+{
+  frame_begin (GST_HISTOGRAM_TRACER_CAST (tracer), ts, pad, NULL);
+}
+
+static void
+do_push_post (GstTracer * tracer, guint64 ts, GstPad * pad, GstFlowReturn res)
+{
+  frame_end (GST_HISTOGRAM_TRACER_CAST (tracer), ts);
+}
+
+static void
+do_pull_range_post (GstTracer * tracer, guint64 ts, GstPad * pad,
+    GstBuffer * buffer, GstFlowReturn res)
+{
+  frame_end (GST_HISTOGRAM_TRACER_CAST (tracer), ts);
+}
+
+static void
+do_element_change_state_post (GstTracer * tracer, guint64 ts,
+    GstElement * element, GstStateChange transition,
+    GstStateChangeReturn result)
+{
+  GstHistogramTracer *self = GST_HISTOGRAM_TRACER_CAST (tracer);
+  guint i;
+
+  if (!GST_IS_PIPELINE (element) || GST_OBJECT_PARENT (element) != NULL)
+    return;
+
+  g_mutex_lock (&self->post_lock);
+  if (transition == GST_STATE_CHANGE_READY_TO_PAUSED
+      && result != GST_STATE_CHANGE_FAILURE) {
+    GWeakRef *ref = g_new0 (GWeakRef, 1);
+
+    g_weak_ref_init (ref, element);
+    g_ptr_array_add (self->pipelines, ref);
+  } else if (transition == GST_STATE_CHANGE_PAUSED_TO_READY) {
+    for (i = 0; i < self->pipelines->len; i++) {
+      GWeakRef *ref = g_ptr_array_index (self->pipelines, i);
+      GstElement *pipeline = g_weak_ref_get (ref);
+
+      if (pipeline == element || pipeline == NULL) {
+        g_ptr_array_remove_index_fast (self->pipelines, i);
+        i--;
+      }
+      if (pipeline)
+        gst_object_unref (pipeline);
+    }
+  }
+  g_mutex_unlock (&self->post_lock);
+}
+
+/* snapshots */
+
+static GstStructure *
+gst_histogram_tracer_get_snapshot (GstHistogramTracer * self)
+{
+  GValue pads = G_VALUE_INIT, elements = G_VALUE_INIT;
+  GstStructure *snapshot;
+  GList *l;
+
+  g_value_init (&pads, GST_TYPE_LIST);
+  g_value_init (&elements, GST_TYPE_LIST);
+
+  G_LOCK (histogram_stats);
+  for (l = self->pads.head; l; l = l->next) {
+    GstHistogramPadStats *stats = l->data;
+    GValue v = G_VALUE_INIT;
+    GstStructure *s;
+
+    s = gst_structure_new ("pad", "name", G_TYPE_STRING, stats->name, NULL);
+    histogram_add_fields (&stats->push, s, "push");
+    histogram_add_fields (&stats->gap, s, "gap");
+
+    g_value_init (&v, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&v, s);
+    gst_value_list_append_and_take_value (&pads, &v);
+  }
+  for (l = self->elements.head; l; l = l->next) {
+    GstHistogramElementStats *stats = l->data;
+    GValue v = G_VALUE_INIT;
+    GstStructure *s;
+
+    s = gst_structure_new ("element", "name", G_TYPE_STRING, stats->name,
+        NULL);
+    histogram_add_fields (&stats->processing, s, "processing");
+    if (stats->residency)
+      histogram_add_fields (stats->residency, s, "residency");
+
+    g_value_init (&v, GST_TYPE_STRUCTURE);
+    g_value_take_boxed (&v, s);
+    gst_value_list_append_and_take_value (&elements, &v);
+  }
+  G_UNLOCK (histogram_stats);
+
+  snapshot = gst_structure_new_empty ("histogram-snapshot");
+  gst_structure_take_value (snapshot, "pads", &pads);
+  gst_structure_take_value (snapshot, "elements", &elements);
+
+  return snapshot;
+}
+
+static gpointer
+gst_histogram_tracer_post_thread (GstHistogramTracer * self)
+{
+  gint64 end_time = g_get_monotonic_time ();
+
+  g_mutex_lock (&self->post_lock);
+  while (!self->post_stop) {
+    GPtrArray *pipelines;
+    GstStructure *snapshot;
+    guint i;
+
+    end_time += self->interval * G_TIME_SPAN_MILLISECOND;
+    while (!self->post_stop
+        && g_cond_wait_until (&self->post_cond, &self->post_lock, end_time));
+    if (self->post_stop)
+      break;
+
+    pipelines = g_ptr_array_new_with_free_func (gst_object_unref);
+    for (i = 0; i < self->pipelines->len; i++) {
+      GstElement *pipeline = g_weak_ref_get (g_ptr_array_index (self->pipelines,
+              i));
+
+      if (pipeline)
+        g_ptr_array_add (pipelines, pipeline);
+    }
+    g_mutex_unlock (&self->post_lock);
+
+    if (pipelines->len > 0) {
+      snapshot = gst_histogram_tracer_get_snapshot (self);
+      for (i = 0; i < pipelines->len; i++) {
+        GstElement *pipeline = g_ptr_array_index (pipelines, i);
+
+        gst_element_post_message (pipeline,
+            gst_message_new_element (GST_OBJECT_CAST (pipeline),
+                gst_structure_copy (snapshot)));
+      }
+      gst_structure_free (snapshot);
+    }
+    g_ptr_array_unref (pipelines);
+
+    g_mutex_lock (&self->post_lock);
+  }
+  g_mutex_unlock (&self->post_lock);
+
+  return NULL;
+}
+
+static void
+free_weak_ref (GWeakRef * ref)
+{
+  g_weak_ref_clear (ref);
+  g_free (ref);
+}
+
+/* tracer class */
+
+static void
+set_params (GstHistogramTracer * self)
+{
+  gchar *params, *tmp;
+  GstStructure *params_struct = NULL;
+  const gchar *queues = DEFAULT_QUEUES;
+
+  g_object_get (self, "params", &params, NULL);
+  if (params) {
+    tmp = g_strdup_printf ("histogram,%s", params);
+    params_struct = gst_structure_from_string (tmp, NULL);
+    g_free (tmp);
+
+    if (params_struct) {
+      const gchar *name = gst_structure_get_string (params_struct, "name");
+      gint interval;
+
+      if (name)
+        gst_object_set_name (GST_OBJECT (self), name);
+      if (gst_structure_get_int (params_struct, "interval", &interval))
+        self->interval = MAX (interval, 0);
+      else
+        gst_structure_get_uint (params_struct, "interval", &self->interval);
+      if (gst_structure_has_field (params_struct, "queues"))
+        queues = gst_structure_get_string (params_struct, "queues");
+    } else {
+      GST_WARNING_OBJECT (self, "failed to parse params '%s'", params);
+    }
+    g_free (params);
+  }
+
+  if (queues)
+    self->queues = g_strsplit (queues, ",", -1);
+
+  if (params_struct)
+    gst_structure_free (params_struct);
+}
+
+static void
+gst_histogram_tracer_constructed (GObject * object)
+{
+  GstHistogramTracer *self = GST_HISTOGRAM_TRACER (object);
+  GstTracer *tracer = GST_TRACER (object);
+
+  set_params (self);
+
+  gst_tracing_register_hook (tracer, "pad-push-pre",
+      G_CALLBACK (do_push_buffer_pre));
+  gst_tracing_register_hook (tracer, "pad-push-post",
+      G_CALLBACK (do_push_post));
+  gst_tracing_register_hook (tracer, "pad-push-list-pre",
+      G_CALLBACK (do_push_buffer_list_pre));
+  gst_tracing_register_hook (tracer, "pad-push-list-post",
+      G_CALLBACK (do_push_post));
+  gst_tracing_register_hook (tracer, "pad-pull-range-pre",
+      G_CALLBACK (do_pull_range_pre));
+  gst_tracing_register_hook (tracer, "pad-pull-range-post",
+      G_CALLBACK (do_pull_range_post));
+
+  if (self->interval > 0) {
+    gst_tracing_register_hook (tracer, "element-change-state-post",
+        G_CALLBACK (do_element_change_state_post));
+    self->post_thread = g_thread_new ("histogram-tracer",
+        (GThreadFunc) gst_histogram_tracer_post_thread, self);
+  }
+
+  ((GObjectClass *) parent_class)->constructed (object);
+}
+
+static void
+gst_histogram_tracer_finalize (GObject * object)
+{
+  GstHistogramTracer *self = GST_HISTOGRAM_TRACER (object);
+  GList *l;
+
+  if (self->post_thread) {
+    g_mutex_lock (&self->post_lock);
+    self->post_stop = TRUE;
+    g_cond_signal (&self->post_cond);
+    g_mutex_unlock (&self->post_lock);
+    g_thread_join (self->post_thread);
+  }
+
+  /* The stats stay attached to their objects until these are finalized */
+  G_LOCK (histogram_stats);
+  for (l = self->pads.head; l; l = l->next)
+    ((GstHistogramPadStats *) l->data)->tracer = NULL;
+  for (l = self->elements.head; l; l = l->next)
+    ((GstHistogramElementStats *) l->data)->tracer = NULL;
+  g_queue_clear (&self->pads);
+  g_queue_clear (&self->elements);
+  G_UNLOCK (histogram_stats);
+
+  g_ptr_array_unref (self->pipelines);
+  g_mutex_clear (&self->post_lock);
+  g_cond_clear (&self->post_cond);
+  g_strfreev (self->queues);
+
+  ((GObjectClass *) parent_class)->finalize (object);
+}
+
+static void
+gst_histogram_tracer_class_init (GstHistogramTracerClass * klass)
+{
+  GObjectClass *gobject_class = (GObjectClass *) klass;
+
+  gobject_class->constructed = gst_histogram_tracer_constructed;
+  gobject_class->finalize = gst_histogram_tracer_finalize;
+
+  /**
+   * GstHistogramTracer::get-snapshot:
+   * @histogramtracer: the histogram tracer object to emit this signal on
+   *
+   * Returns a `histogram-snapshot` #GstStructure with the current state of
+   * all histograms, see the tracer documentation for the fields.
+   *
+   * Returns: (transfer full): a newly-allocated #GstStructure
+   *
+   * Since: 1.24
+   */
+  gst_histogram_tracer_signals[SIGNAL_GET_SNAPSHOT] =
+      g_signal_new ("get-snapshot", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION,
+      G_STRUCT_OFFSET (GstHistogramTracerClass, get_snapshot), NULL, NULL,
+      NULL, GST_TYPE_STRUCTURE, 0, G_TYPE_NONE);
+
+  klass->get_snapshot = gst_histogram_tracer_get_snapshot;
+}
+
+static void
+gst_histogram_tracer_init (GstHistogramTracer * self)
+{
+  static gint instance_count = 0;
+  gchar *quark_name;
+
+  self->interval = DEFAULT_INTERVAL;
+  g_queue_init (&self->pads);
+  g_queue_init (&self->elements);
+  g_mutex_init (&self->post_lock);
+  g_cond_init (&self->post_cond);
+  self->pipelines = g_ptr_array_new_with_free_func ((GDestroyNotify)
+      free_weak_ref);
+
+  /* Separate per instance, several histogram tracers can be active */
+  quark_name = g_strdup_printf ("gsthistogram:data:%d",
+      g_atomic_int_add (&instance_count, 1));
+  self->data_quark = g_quark_from_string (quark_name);
+  g_free (quark_name);
+}
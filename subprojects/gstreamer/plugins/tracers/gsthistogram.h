@@ -0,0 +1,83 @@
+/* GStreamer
+ *
+ * gsthistogram.h: tracing module that keeps latency histograms
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __GST_HISTOGRAM_TRACER_H__
+#define __GST_HISTOGRAM_TRACER_H__
+
+#include <gst/gst.h>
+#include <gst/gsttracer.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_HISTOGRAM_TRACER \
+  (gst_histogram_tracer_get_type())
+#define GST_HISTOGRAM_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_HISTOGRAM_TRACER,GstHistogramTracer))
+#define GST_HISTOGRAM_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_HISTOGRAM_TRACER,GstHistogramTracerClass))
+#define GST_IS_HISTOGRAM_TRACER(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_HISTOGRAM_TRACER))
+#define GST_IS_HISTOGRAM_TRACER_CLASS(klass) \
+  (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_HISTOGRAM_TRACER))
+#define GST_HISTOGRAM_TRACER_CAST(obj) ((GstHistogramTracer *)(obj))
+
+typedef struct _GstHistogramTracer GstHistogramTracer;
+typedef struct _GstHistogramTracerClass GstHistogramTracerClass;
+
+/**
+ * GstHistogramTracer:
+ *
+ * Opaque #GstHistogramTracer data structure
+ */
+struct _GstHistogramTracer {
+  GstTracer parent;
+
+  /*< private >*/
+  GQuark data_quark;
+
+  /* factory names of the elements whose residency time is tracked */
+  gchar **queues;
+
+  /* GstHistogramPadStats / GstHistogramElementStats, protected by the
+   * global stats lock */
+  GQueue pads;
+  GQueue elements;
+
+  /* periodic bus messages */
+  guint interval;
+  GMutex post_lock;
+  GCond post_cond;
+  gboolean post_stop;
+  GThread *post_thread;
+  GPtrArray *pipelines;         /* GWeakRef *, protected by post_lock */
+};
+
+struct _GstHistogramTracerClass {
+  GstTracerClass parent_class;
+
+  /* actions */
+  GstStructure * (*get_snapshot) (GstHistogramTracer *tracer);
+};
+
+G_GNUC_INTERNAL GType gst_histogram_tracer_get_type (void);
+
+G_END_DECLS
+
+#endif /* __GST_HISTOGRAM_TRACER_H__ */
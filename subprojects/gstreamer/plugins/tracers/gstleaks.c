@@ -39,7 +39,7 @@
  * active at the same time.
  *
  * Parameters can also be passed to each tracer. The leaks tracer currently
- * accepts five params:
+ * accepts eight params:
  * 1. filters: (string) to filter which objects to record
  * 2. check-refs: (boolean) whether to record every location where a leaked
  *    object was reffed and unreffed
@@ -47,6 +47,18 @@
  * 4. name: (string) set a name for the tracer object itself
  * 5. log-leaks-on-deinit: (boolean) whether to report all leaks on
  *    gst_deinit() by printing them in the debug log; "true" by default
+ * 6. sampling: (uint) only record one in this many of the created objects,
+ *    1 (all of them) by default. Since 1.24
+ * 7. live-counts: (boolean) keep a count of the live objects of each type,
+ *    see the `get-live-counts` action signal; "false" by default. Since 1.24
+ * 8. growth-interval: (uint) interval in seconds at which the types whose
+ *    number of live objects grew are logged, 0 (the default) to disable.
+ *    Enables `live-counts`. Since 1.24
+ *
+ * Recording every object, with its stack trace, is expensive. To look for
+ * slow leaks in long running pipelines the objects can be sampled, which
+ * makes the leaks reported on gst_deinit() a sample of the actual leaks, and
+ * the live counts only increment and decrement a counter per type.
  *
  * Examples:
  * ```
@@ -55,6 +67,9 @@
  * ```
  * GST_TRACERS='leaks(filters="GstBuffer",stack-traces-flags=full,check-refs=true);leaks(name=all-leaks)'
  * ```
+ * ```
+ * GST_TRACERS='leaks(sampling=1000,growth-interval=60,log-leaks-on-deinit=false)'
+ * ```
  */
 
 #ifdef HAVE_CONFIG_H
@@ -80,11 +95,18 @@ enum
   SIGNAL_ACTIVITY_GET_CHECKPOINT,
   SIGNAL_ACTIVITY_LOG_CHECKPOINT,
   SIGNAL_ACTIVITY_STOP_TRACKING,
+  SIGNAL_GET_LIVE_COUNTS,
+  SIGNAL_LOG_GROWTH,
 
   LAST_SIGNAL
 };
 
 #define DEFAULT_LOG_LEAKS TRUE  /* for backwards-compat */
+#define DEFAULT_SAMPLING 1
+#define DEFAULT_GROWTH_INTERVAL 0
+
+/* types that can be counted, further types are ignored */
+#define TYPE_COUNTERS_SIZE 1024
 
 #define _do_init \
     GST_DEBUG_CATEGORY_INIT (gst_leaks_debug, "leaks", 0, "leaks tracer");
@@ -99,6 +121,8 @@ static GstStructure *gst_leaks_tracer_activity_get_checkpoint (GstLeaksTracer *
     self);
 static void gst_leaks_tracer_activity_log_checkpoint (GstLeaksTracer * self);
 static void gst_leaks_tracer_activity_stop_tracking (GstLeaksTracer * self);
+static GstStructure *gst_leaks_tracer_get_live_counts (GstLeaksTracer * self);
+static void gst_leaks_tracer_log_growth (GstLeaksTracer * self);
 
 #ifdef G_OS_UNIX
 static void gst_leaks_tracer_setup_signals (GstLeaksTracer * leaks);
@@ -109,6 +133,7 @@ static GstTracerRecord *tr_alive;
 static GstTracerRecord *tr_refings;
 static GstTracerRecord *tr_added = NULL;
 static GstTracerRecord *tr_removed = NULL;
+static GstTracerRecord *tr_growth;
 static GQueue instances = G_QUEUE_INIT;
 static guint gst_leaks_tracer_signals[LAST_SIGNAL] = { 0 };
 
@@ -120,6 +145,15 @@ typedef enum
   MINI_OBJECT,
 } ObjectKind;
 
+typedef struct
+{
+  /* GType, set once when the slot is taken */
+  gpointer type;
+  gint live;
+  /* the live count of the previous growth report */
+  gint reported;
+} GstLeaksTypeCounter;
+
 typedef struct
 {
   gboolean reffed;
@@ -224,6 +258,8 @@ static void
 set_params_from_structure (GstLeaksTracer * self, GstStructure * params)
 {
   const gchar *filters, *name;
+  gboolean live_counts = FALSE;
+  gint val;
 
   filters = gst_structure_get_string (params, "filters");
   if (filters)
@@ -235,6 +271,20 @@ set_params_from_structure (GstLeaksTracer * self, GstStructure * params)
 
   gst_structure_get_boolean (params, "check-refs", &self->check_refs);
   gst_structure_get_boolean (params, "log-leaks-on-deinit", &self->log_leaks);
+
+  if (gst_structure_get_int (params, "sampling", &val))
+    self->sampling = MAX (val, 1);
+  else if (gst_structure_get_uint (params, "sampling", &self->sampling))
+    self->sampling = MAX (self->sampling, 1);
+
+  if (gst_structure_get_int (params, "growth-interval", &val))
+    self->growth_interval = MAX (val, 0);
+  else
+    gst_structure_get_uint (params, "growth-interval", &self->growth_interval);
+
+  gst_structure_get_boolean (params, "live-counts", &live_counts);
+  if (live_counts || self->growth_interval > 0)
+    self->type_counters = g_new0 (GstLeaksTypeCounter, TYPE_COUNTERS_SIZE);
 }
 
 static void
@@ -313,6 +363,40 @@ should_handle_object_type (GstLeaksTracer * self, GType object_type)
   return FALSE;
 }
 
+/* The counter of @type, or NULL if the table is full */
+static GstLeaksTypeCounter *
+get_type_counter (GstLeaksTracer * self, GType type)
+{
+  GstLeaksTypeCounter *counters = self->type_counters;
+  guint i, idx = (guint) ((type >> 2) * 2654435761u);
+
+  for (i = 0; i < TYPE_COUNTERS_SIZE; i++) {
+    GstLeaksTypeCounter *c = &counters[(idx + i) & (TYPE_COUNTERS_SIZE - 1)];
+    GType t = (GType) GPOINTER_TO_SIZE (g_atomic_pointer_get (&c->type));
+
+    if (t == 0) {
+      if (g_atomic_pointer_compare_and_exchange (&c->type, NULL,
+              GSIZE_TO_POINTER (type)))
+        return c;
+      /* taken by another thread in the meantime, maybe for the same type */
+      t = (GType) GPOINTER_TO_SIZE (g_atomic_pointer_get (&c->type));
+    }
+    if (t == type)
+      return c;
+  }
+
+  return NULL;
+}
+
+static inline void
+count_object (GstLeaksTracer * self, GType type, gint diff)
+{
+  GstLeaksTypeCounter *c = get_type_counter (self, type);
+
+  if (G_LIKELY (c))
+    g_atomic_int_add (&c->live, diff);
+}
+
 /* The object may be destroyed when we log it using the checkpointing system so
  * we have to save its type name */
 typedef struct
@@ -393,6 +477,13 @@ handle_object_created (GstLeaksTracer * self, gpointer object, GType type,
   if (!should_handle_object_type (self, type))
     return;
 
+  if (self->type_counters)
+    count_object (self, type, 1);
+
+  if (self->sampling > 1
+      && (guint) g_atomic_int_add (&self->sample_count, 1) % self->sampling)
+    return;
+
   infos = g_malloc0 (sizeof (ObjectRefingInfos));
   infos->kind = kind;
   switch (kind) {
@@ -442,6 +533,54 @@ object_created_cb (GstTracer * tracer, GstClockTime ts, GstObject * object)
   handle_object_created (self, object, object_type, GOBJECT);
 }
 
+static void
+mini_object_destroyed_cb (GstTracer * tracer, GstClockTime ts,
+    GstMiniObject * object)
+{
+  GstLeaksTracer *self = GST_LEAKS_TRACER_CAST (tracer);
+  GType type = GST_MINI_OBJECT_TYPE (object);
+
+  if (should_handle_object_type (self, type))
+    count_object (self, type, -1);
+}
+
+static void
+object_destroyed_cb (GstTracer * tracer, GstClockTime ts, GstObject * object)
+{
+  GstLeaksTracer *self = GST_LEAKS_TRACER_CAST (tracer);
+  GType type = G_OBJECT_TYPE (object);
+
+  if (g_type_is_a (type, GST_TYPE_TRACER))
+    return;
+
+  if (should_handle_object_type (self, type))
+    count_object (self, type, -1);
+}
+
+static gpointer
+gst_leaks_tracer_growth_thread (GstLeaksTracer * self)
+{
+  gint64 end_time = g_get_monotonic_time ();
+
+  g_mutex_lock (&self->growth_lock);
+  while (!self->growth_stop) {
+    end_time += self->growth_interval * G_TIME_SPAN_SECOND;
+    while (!self->growth_stop
+        && g_cond_wait_until (&self->growth_cond, &self->growth_lock,
+            end_time));
+    if (self->growth_stop)
+      break;
+    g_mutex_unlock (&self->growth_lock);
+
+    gst_leaks_tracer_log_growth (self);
+
+    g_mutex_lock (&self->growth_lock);
+  }
+  g_mutex_unlock (&self->growth_lock);
+
+  return NULL;
+}
+
 static void
 handle_object_reffed (GstLeaksTracer * self, gpointer object, GType type,
     gint new_refcount, gboolean reffed, GstClockTime ts)
@@ -517,6 +656,10 @@ static void
 gst_leaks_tracer_init (GstLeaksTracer * self)
 {
   self->log_leaks = DEFAULT_LOG_LEAKS;
+  self->sampling = DEFAULT_SAMPLING;
+  self->growth_interval = DEFAULT_GROWTH_INTERVAL;
+  g_mutex_init (&self->growth_lock);
+  g_cond_init (&self->growth_cond);
   self->objects = g_hash_table_new_full (NULL, NULL, NULL,
       (GDestroyNotify) object_refing_infos_free);
 
@@ -559,7 +702,17 @@ gst_leaks_tracer_constructed (GObject * object)
 
   /* We rely on weak pointers rather than (mini-)object-destroyed hooks so we
    * are notified of objects being destroyed even during the shuting down of
-   * the tracing system. */
+   * the tracing system. The counts are only approximate anyway. */
+  if (self->type_counters) {
+    gst_tracing_register_hook (tracer, "mini-object-destroyed",
+        G_CALLBACK (mini_object_destroyed_cb));
+    gst_tracing_register_hook (tracer, "object-destroyed",
+        G_CALLBACK (object_destroyed_cb));
+  }
+
+  if (self->growth_interval > 0)
+    self->growth_thread = g_thread_new ("leaks-tracer-growth",
+        (GThreadFunc) gst_leaks_tracer_growth_thread, self);
 
   ((GObjectClass *) gst_leaks_tracer_parent_class)->constructed (object);
 }
@@ -764,6 +917,14 @@ gst_leaks_tracer_finalize (GObject * object)
 
   GST_DEBUG_OBJECT (self, "destroying tracer, checking for leaks");
 
+  if (self->growth_thread) {
+    g_mutex_lock (&self->growth_lock);
+    self->growth_stop = TRUE;
+    g_cond_signal (&self->growth_cond);
+    g_mutex_unlock (&self->growth_lock);
+    g_thread_join (self->growth_thread);
+  }
+
   self->done = TRUE;
 
   /* Tracers are destroyed as part of gst_deinit() so now is a good time to
@@ -794,6 +955,9 @@ gst_leaks_tracer_finalize (GObject * object)
   g_clear_pointer (&self->added, g_hash_table_unref);
   g_clear_pointer (&self->removed, g_hash_table_unref);
   g_clear_pointer (&self->unhandled_filter, g_hash_table_unref);
+  g_clear_pointer (&self->type_counters, g_free);
+  g_mutex_clear (&self->growth_lock);
+  g_cond_clear (&self->growth_cond);
 
   G_LOCK (instances);
   g_queue_remove (&instances, self);
@@ -833,6 +997,14 @@ gst_leaks_tracer_finalize (GObject * object)
     "trace", GST_TYPE_STRUCTURE, gst_structure_new ("value", \
         "type", G_TYPE_GTYPE, G_TYPE_STRING, \
         NULL)
+#define RECORD_FIELD_LIVE \
+    "live", GST_TYPE_STRUCTURE, gst_structure_new ("value", \
+        "type", G_TYPE_GTYPE, G_TYPE_INT, \
+        NULL)
+#define RECORD_FIELD_GROWTH \
+    "growth", GST_TYPE_STRUCTURE, gst_structure_new ("value", \
+        "type", G_TYPE_GTYPE, G_TYPE_INT, \
+        NULL)
 
 #ifdef G_OS_UNIX
 static gboolean
@@ -1131,6 +1303,61 @@ gst_leaks_tracer_activity_stop_tracking (GstLeaksTracer * self)
   GST_OBJECT_UNLOCK (self);
 }
 
+static GstStructure *
+gst_leaks_tracer_get_live_counts (GstLeaksTracer * self)
+{
+  GstLeaksTypeCounter *counters = self->type_counters;
+  GstStructure *s = gst_structure_new_empty ("live-counts");
+  guint i;
+
+  if (!counters)
+    return s;
+
+  for (i = 0; i < TYPE_COUNTERS_SIZE; i++) {
+    GType type = (GType) GPOINTER_TO_SIZE (g_atomic_pointer_get
+        (&counters[i].type));
+    gint live;
+
+    if (type == 0)
+      continue;
+
+    live = g_atomic_int_get (&counters[i].live);
+    if (live > 0)
+      gst_structure_set (s, g_type_name (type), G_TYPE_INT, live, NULL);
+  }
+
+  return s;
+}
+
+static void
+gst_leaks_tracer_log_growth (GstLeaksTracer * self)
+{
+  GstLeaksTypeCounter *counters = self->type_counters;
+  guint i;
+
+  if (!counters)
+    return;
+
+  GST_OBJECT_LOCK (self);
+  GST_TRACE_OBJECT (self, "listing types with more live objects than at the "
+      "last report");
+  for (i = 0; i < TYPE_COUNTERS_SIZE; i++) {
+    GType type = (GType) GPOINTER_TO_SIZE (g_atomic_pointer_get
+        (&counters[i].type));
+    gint live;
+
+    if (type == 0)
+      continue;
+
+    live = g_atomic_int_get (&counters[i].live);
+    if (live > counters[i].reported)
+      gst_tracer_record_log (tr_growth, g_type_name (type), live,
+          live - counters[i].reported);
+    counters[i].reported = live;
+  }
+  GST_OBJECT_UNLOCK (self);
+}
+
 static void
 gst_leaks_tracer_class_init (GstLeaksTracerClass * klass)
 {
@@ -1157,6 +1384,10 @@ gst_leaks_tracer_class_init (GstLeaksTracerClass * klass)
       RECORD_FIELD_TYPE_NAME, RECORD_FIELD_ADDRESS, NULL);
   GST_OBJECT_FLAG_SET (tr_removed, GST_OBJECT_FLAG_MAY_BE_LEAKED);
 
+  tr_growth = gst_tracer_record_new ("object-growth.class",
+      RECORD_FIELD_TYPE_NAME, RECORD_FIELD_LIVE, RECORD_FIELD_GROWTH, NULL);
+  GST_OBJECT_FLAG_SET (tr_growth, GST_OBJECT_FLAG_MAY_BE_LEAKED);
+
   /**
    * GstLeaksTracer::get-live-objects:
    * @leakstracer: the leaks tracer object to emit this signal on
@@ -1309,10 +1540,50 @@ gst_leaks_tracer_class_init (GstLeaksTracerClass * klass)
           activity_stop_tracking), NULL, NULL, NULL, G_TYPE_NONE, 0,
       G_TYPE_NONE);
 
+  /**
+   * GstLeaksTracer::get-live-counts:
+   * @leakstracer: the leaks tracer object to emit this signal on
+   *
+   * Returns a `live-counts` #GstStructure with one #gint field per type,
+   * named after the type, holding the number of objects of that type that
+   * are currently alive. Objects that were created before the tracer are
+   * not accounted for.
+   *
+   * This requires the `live-counts` or `growth-interval` params, otherwise
+   * the structure is empty.
+   *
+   * Returns: (transfer full): a newly-allocated #GstStructure
+   *
+   * Since: 1.24
+   */
+  gst_leaks_tracer_signals[SIGNAL_GET_LIVE_COUNTS] =
+      g_signal_new ("get-live-counts", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET (GstLeaksTracerClass,
+          get_live_counts), NULL, NULL, NULL, GST_TYPE_STRUCTURE, 0,
+      G_TYPE_NONE);
+
+  /**
+   * GstLeaksTracer::log-growth:
+   * @leakstracer: the leaks tracer object to emit this signal on
+   *
+   * Logs the types whose number of live objects grew since the previous
+   * report to the debug log under `GST_TRACER:7`, with their current count
+   * and the growth. This is what is done periodically with the
+   * `growth-interval` param.
+   *
+   * Since: 1.24
+   */
+  gst_leaks_tracer_signals[SIGNAL_LOG_GROWTH] =
+      g_signal_new ("log-growth", G_TYPE_FROM_CLASS (klass),
+      G_SIGNAL_RUN_LAST | G_SIGNAL_ACTION, G_STRUCT_OFFSET (GstLeaksTracerClass,
+          log_growth), NULL, NULL, NULL, G_TYPE_NONE, 0, G_TYPE_NONE);
+
   klass->get_live_objects = gst_leaks_tracer_get_live_objects;
   klass->log_live_objects = gst_leaks_tracer_log_live_objects;
   klass->activity_start_tracking = gst_leaks_tracer_activity_start_tracking;
   klass->activity_get_checkpoint = gst_leaks_tracer_activity_get_checkpoint;
   klass->activity_log_checkpoint = gst_leaks_tracer_activity_log_checkpoint;
   klass->activity_stop_tracking = gst_leaks_tracer_activity_stop_tracking;
+  klass->get_live_counts = gst_leaks_tracer_get_live_counts;
+  klass->log_growth = gst_leaks_tracer_log_growth;
 }
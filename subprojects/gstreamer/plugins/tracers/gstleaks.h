@@ -72,6 +72,21 @@ struct _GstLeaksTracer {
   gboolean log_leaks;
 
   GstStackTraceFlags trace_flags;
+
+  /* only track one in @sampling created objects */
+  guint sampling;
+  gint sample_count;
+
+  /* GstLeaksTypeCounter, open addressing table filled locklessly, NULL if
+   * live counts are disabled */
+  gpointer type_counters;
+
+  /* periodic growth reports */
+  guint growth_interval;
+  GMutex growth_lock;
+  GCond growth_cond;
+  gboolean growth_stop;
+  GThread *growth_thread;
 };
 
 struct _GstLeaksTracerClass {
@@ -84,6 +99,8 @@ struct _GstLeaksTracerClass {
   GstStructure * (*activity_get_checkpoint)     (GstLeaksTracer *tracer);
   void           (*activity_log_checkpoint)     (GstLeaksTracer *tracer);
   void           (*activity_stop_tracking)      (GstLeaksTracer *tracer);
+  GstStructure * (*get_live_counts)             (GstLeaksTracer *tracer);
+  void           (*log_growth)                  (GstLeaksTracer *tracer);
 };
 
 G_GNUC_INTERNAL GType gst_leaks_tracer_get_type (void);
@@ -30,6 +30,10 @@
 #include "gststats.h"
 #include "gstleaks.h"
 #include "gstfactories.h"
+#include "gsthistogram.h"
+#include "gstflamegraph.h"
+#include "gstchrometrace.h"
+#include "gstcopies.h"
 
 static gboolean
 plugin_init (GstPlugin * plugin)
@@ -51,6 +55,17 @@ plugin_init (GstPlugin * plugin)
   if (!gst_tracer_register (plugin, "factories",
           gst_factories_tracer_get_type ()))
     return FALSE;
+  if (!gst_tracer_register (plugin, "histogram",
+          gst_histogram_tracer_get_type ()))
+    return FALSE;
+  if (!gst_tracer_register (plugin, "flamegraph",
+          gst_flame_graph_tracer_get_type ()))
+    return FALSE;
+  if (!gst_tracer_register (plugin, "chrometrace",
+          gst_chrome_trace_tracer_get_type ()))
+    return FALSE;
+  if (!gst_tracer_register (plugin, "copies", gst_copies_tracer_get_type ()))
+    return FALSE;
   return TRUE;
 }
 
@@ -0,0 +1,104 @@
+/* GStreamer
+ *
+ * gsttracers_private.c: Shared code for the core tracers
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#include "gsttracers_private.h"
+
+typedef struct
+{
+  GstTracer *tracer;
+  gpointer data;
+} GstTracersThreadData;
+
+static void
+thread_list_destroy (gpointer data)
+{
+  /* the data itself belongs to the tracers */
+  g_array_unref (data);
+}
+
+/* GstTracersThreadData of the current thread, one per tracer instance */
+static GPrivate thread_list = G_PRIVATE_INIT (thread_list_destroy);
+
+/* The element owning @pad, bins and pads of ghost pads are skipped as they
+ * only forward */
+GstElement *
+gst_tracers_get_pad_element (GstPad * pad)
+{
+  GstObject *parent;
+
+  if (!pad || GST_IS_PROXY_PAD (pad))
+    return NULL;
+
+  parent = GST_OBJECT_PARENT (pad);
+  if (!parent || !GST_IS_ELEMENT (parent) || GST_IS_BIN (parent))
+    return NULL;
+
+  return GST_ELEMENT_CAST (parent);
+}
+
+/* The data @tracer set for the current thread, or NULL */
+gpointer
+gst_tracers_get_thread_data (GstTracer * tracer)
+{
+  GArray *threads = g_private_get (&thread_list);
+  guint i;
+
+  if (G_UNLIKELY (!threads))
+    return NULL;
+
+  for (i = 0; i < threads->len; i++) {
+    GstTracersThreadData *td =
+        &g_array_index (threads, GstTracersThreadData, i);
+
+    if (td->tracer == tracer)
+      return td->data;
+  }
+
+  return NULL;
+}
+
+/* Sets the data of @tracer for the current thread. The tracer keeps
+ * ownership of @data and must keep it alive as long as the thread can
+ * trace */
+void
+gst_tracers_set_thread_data (GstTracer * tracer, gpointer data)
+{
+  GArray *threads = g_private_get (&thread_list);
+  GstTracersThreadData td = { tracer, data };
+  guint i;
+
+  if (G_UNLIKELY (!threads)) {
+    threads = g_array_new (FALSE, FALSE, sizeof (GstTracersThreadData));
+    g_private_set (&thread_list, threads);
+  }
+
+  for (i = 0; i < threads->len; i++) {
+    if (g_array_index (threads, GstTracersThreadData, i).tracer == tracer) {
+      g_array_index (threads, GstTracersThreadData, i).data = data;
+      return;
+    }
+  }
+
+  g_array_append_val (threads, td);
+}
@@ -0,0 +1,265 @@
+/* GStreamer
+ *
+ * datapath.c: per item cost of the core data paths
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/* Runs a fixed set of data path benchmarks and prints one CSV line per
+ * benchmark, so that the results can be compared between releases:
+ *
+ *   benchmark,iterations,total-ns,ns-per-iteration
+ */
+
+#include <stdlib.h>
+#include <gst/gst.h>
+
+#define DEFAULT_ITERATIONS (100000)
+#define CHAIN_LENGTH (10)
+#define POOL_THREADS (4)
+
+static void
+report (const gchar * name, guint64 iterations, GstClockTime start,
+    GstClockTime end)
+{
+  GstClockTimeDiff total = GST_CLOCK_DIFF (start, end);
+
+  g_print ("%s,%" G_GUINT64_FORMAT ",%" G_GINT64_FORMAT ",%.1f\n", name,
+      iterations, total, (gdouble) total / iterations);
+}
+
+/* time spent after going to PLAYING until EOS */
+static void
+run_pipeline (const gchar * name, const gchar * description,
+    guint64 iterations)
+{
+  GstElement *pipeline;
+  GstBus *bus;
+  GstMessage *msg;
+  GstClockTime start, end;
+  GError *error = NULL;
+
+  pipeline = gst_parse_launch (description, &error);
+  if (!pipeline) {
+    g_printerr ("%s: could not create pipeline: %s\n", name, error->message);
+    g_clear_error (&error);
+    return;
+  }
+
+  /* preroll first so that only the streaming is measured */
+  gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+
+  bus = gst_element_get_bus (pipeline);
+
+  start = gst_util_get_timestamp ();
+  gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  msg = gst_bus_poll (bus, GST_MESSAGE_EOS | GST_MESSAGE_ERROR, -1);
+  end = gst_util_get_timestamp ();
+
+  if (GST_MESSAGE_TYPE (msg) == GST_MESSAGE_ERROR)
+    g_printerr ("%s: pipeline posted an error\n", name);
+  else
+    report (name, iterations, start, end);
+
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+static void
+bench_chain (guint64 iterations)
+{
+  GString *desc = g_string_new (NULL);
+  guint i;
+
+  g_string_printf (desc, "fakesrc num-buffers=%" G_GUINT64_FORMAT,
+      iterations);
+  for (i = 0; i < CHAIN_LENGTH; i++)
+    g_string_append (desc, " ! identity");
+  g_string_append (desc, " ! fakesink");
+
+  run_pipeline ("push-chain-" G_STRINGIFY (CHAIN_LENGTH), desc->str,
+      iterations);
+  g_string_free (desc, TRUE);
+}
+
+static void
+bench_queue (guint64 iterations)
+{
+  gchar *desc;
+
+  desc = g_strdup_printf ("fakesrc num-buffers=%" G_GUINT64_FORMAT
+      " ! queue ! fakesink", iterations);
+  run_pipeline ("queue-handoff", desc, iterations);
+  g_free (desc);
+
+  desc = g_strdup_printf ("fakesrc num-buffers=%" G_GUINT64_FORMAT
+      " ! multiqueue ! fakesink", iterations);
+  run_pipeline ("multiqueue-handoff", desc, iterations);
+  g_free (desc);
+}
+
+typedef struct
+{
+  GstBufferPool *pool;
+  guint64 iterations;
+} PoolThreadData;
+
+static gpointer
+pool_thread (PoolThreadData * data)
+{
+  guint64 i;
+
+  for (i = 0; i < data->iterations; i++) {
+    GstBuffer *buf = NULL;
+
+    gst_buffer_pool_acquire_buffer (data->pool, &buf, NULL);
+    gst_buffer_unref (buf);
+  }
+
+  return NULL;
+}
+
+static void
+bench_pool (guint64 iterations)
+{
+  GstBufferPool *pool;
+  GstStructure *conf;
+  GThread *threads[POOL_THREADS];
+  PoolThreadData data;
+  GstClockTime start, end;
+  gint i;
+
+  pool = gst_buffer_pool_new ();
+  conf = gst_buffer_pool_get_config (pool);
+  gst_buffer_pool_config_set_params (conf, NULL, 1400, POOL_THREADS, 0);
+  gst_buffer_pool_set_config (pool, conf);
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  data.pool = pool;
+  data.iterations = iterations / POOL_THREADS;
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < POOL_THREADS; i++)
+    threads[i] = g_thread_new ("pool", (GThreadFunc) pool_thread, &data);
+  for (i = 0; i < POOL_THREADS; i++)
+    g_thread_join (threads[i]);
+  end = gst_util_get_timestamp ();
+
+  report ("pool-acquire-release-" G_STRINGIFY (POOL_THREADS) "-threads",
+      data.iterations * POOL_THREADS, start, end);
+
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+}
+
+static void
+bench_caps (guint64 iterations)
+{
+  GstCaps *caps1, *caps2;
+  GstClockTime start, end;
+  guint64 i;
+
+  /* what a decoder typically intersects with a video sink */
+  caps1 = gst_caps_from_string ("video/x-raw, format=(string){ I420, NV12, "
+      "YV12, YUY2, UYVY, RGBA, BGRA, RGBx, BGRx }, width=(int)[ 1, 32767 ], "
+      "height=(int)[ 1, 32767 ], framerate=(fraction)[ 0/1, 2147483647/1 ]; "
+      "video/x-raw(memory:GLMemory), format=(string)RGBA, "
+      "width=(int)[ 1, 32767 ], height=(int)[ 1, 32767 ]");
+  caps2 = gst_caps_from_string ("video/x-raw, format=(string)NV12, "
+      "width=(int)1920, height=(int)1080, framerate=(fraction)30/1, "
+      "interlace-mode=(string)progressive, colorimetry=(string)bt709");
+
+  start = gst_util_get_timestamp ();
+  for (i = 0; i < iterations; i++) {
+    GstCaps *res = gst_caps_intersect (caps1, caps2);
+    gst_caps_unref (res);
+  }
+  end = gst_util_get_timestamp ();
+
+  report ("caps-intersect", iterations, start, end);
+
+  gst_caps_unref (caps1);
+  gst_caps_unref (caps2);
+}
+
+static gpointer
+bus_thread (GstBus * bus)
+{
+  GstStructure *s = gst_structure_new_empty ("benchmark");
+  guint64 i, iterations = GPOINTER_TO_SIZE (g_object_get_data (G_OBJECT (bus),
+          "iterations"));
+
+  for (i = 0; i < iterations; i++)
+    gst_bus_post (bus, gst_message_new_element (NULL, gst_structure_copy (s)));
+
+  gst_structure_free (s);
+
+  return NULL;
+}
+
+static void
+bench_bus (guint64 iterations)
+{
+  GstBus *bus = gst_bus_new ();
+  GstClockTime start, end;
+  GThread *thread;
+  guint64 i;
+
+  g_object_set_data (G_OBJECT (bus), "iterations",
+      GSIZE_TO_POINTER (iterations));
+
+  start = gst_util_get_timestamp ();
+  thread = g_thread_new ("bus", (GThreadFunc) bus_thread, bus);
+  for (i = 0; i < iterations; i++) {
+    GstMessage *msg = gst_bus_timed_pop (bus, GST_CLOCK_TIME_NONE);
+    gst_message_unref (msg);
+  }
+  g_thread_join (thread);
+  end = gst_util_get_timestamp ();
+
+  report ("bus-post-pop", iterations, start, end);
+
+  gst_object_unref (bus);
+}
+
+gint
+main (gint argc, gchar * argv[])
+{
+  guint64 iterations = DEFAULT_ITERATIONS;
+
+  gst_init (&argc, &argv);
+
+  if (argc > 1)
+    iterations = g_ascii_strtoull (argv[1], NULL, 10);
+
+  if (iterations == 0) {
+    g_print ("usage: %s [iterations]\n", argv[0]);
+    exit (-1);
+  }
+
+  g_print ("benchmark,iterations,total-ns,ns-per-iteration\n");
+
+  bench_chain (iterations);
+  bench_queue (iterations);
+  bench_pool (iterations);
+  bench_caps (iterations);
+  bench_bus (iterations);
+
+  return 0;
+}
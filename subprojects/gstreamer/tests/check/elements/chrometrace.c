@@ -0,0 +1,137 @@
+/* GStreamer
+ *
+ * Unit test for the chrometrace tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <glib/gstdio.h>
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+#define NUM_BUFFERS 20
+
+static gchar *trace_file;
+
+static GstTracer *
+get_tracer_by_name (const gchar * name)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next) {
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), name) == 0)
+      tracer = gst_object_ref (l->data);
+  }
+
+  g_list_free_full (tracers, gst_object_unref);
+  return tracer;
+}
+
+GST_START_TEST (test_trace_events)
+{
+  GstElement *pipe;
+  GstTracer *tracer;
+  GstMessage *m;
+  gchar *contents;
+
+  pipe = gst_parse_launch ("fakesrc name=src num-buffers="
+      G_STRINGIFY (NUM_BUFFERS) " ! queue name=queue ! fakesink name=sink "
+      "sync=false", NULL);
+  fail_unless (pipe != NULL);
+  gst_object_set_name (GST_OBJECT (pipe), "pipeline");
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (m), GST_MESSAGE_EOS);
+  gst_message_unref (m);
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  tracer = get_tracer_by_name ("trace");
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "flush");
+
+  fail_unless (g_file_get_contents (trace_file, &contents, NULL, NULL));
+  fail_unless (g_str_has_prefix (contents, "[\n"));
+  /* one slice per element, thread names, queue levels and buffer flows */
+  fail_unless (strstr (contents,
+          "{\"ph\":\"B\",\"name\":\"/pipeline/queue\"") != NULL);
+  fail_unless (strstr (contents,
+          "{\"ph\":\"B\",\"name\":\"/pipeline/sink\"") != NULL);
+  fail_unless (strstr (contents, "\"ph\":\"E\"") != NULL);
+  fail_unless (strstr (contents,
+          "\"args\":{\"name\":\"/pipeline/src\"}") != NULL);
+  fail_unless (strstr (contents,
+          "{\"ph\":\"C\",\"name\":\"/pipeline/queue\"") != NULL);
+  fail_unless (strstr (contents, "\"ph\":\"s\"") != NULL);
+  fail_unless (strstr (contents, "\"ph\":\"f\"") != NULL);
+
+  g_free (contents);
+  gst_object_unref (tracer);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+chrometracetracer_suite (void)
+{
+  Suite *s = suite_create ("chrometracetracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+#ifndef GST_DISABLE_PARSE
+  tcase_add_test (tc_chain, test_trace_events);
+#endif
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (chrometracetracer); because we need to set
+ * the env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+  gchar *tracers;
+  int ret;
+
+  trace_file = g_build_filename (g_get_tmp_dir (), "gst-check-trace.json",
+      NULL);
+  tracers = g_strdup_printf ("chrometrace(name=trace,file=\"%s\")",
+      trace_file);
+  g_setenv ("GST_TRACERS", tracers, TRUE);
+  g_free (tracers);
+
+  gst_check_init (&argc, &argv);
+  s = chrometracetracer_suite ();
+  ret = gst_check_run_suite (s, "chrometracetracer", __FILE__);
+
+  gst_deinit ();
+  g_unlink (trace_file);
+  g_free (trace_file);
+
+  return ret;
+}
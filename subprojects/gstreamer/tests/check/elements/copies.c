@@ -0,0 +1,184 @@
+/* GStreamer
+ *
+ * Unit test for the copies tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+#define BUFFER_SIZE 4096
+
+static GstTracer *
+get_tracer_by_name (const gchar * name)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next) {
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), name) == 0)
+      tracer = gst_object_ref (l->data);
+  }
+
+  g_list_free_full (tracers, gst_object_unref);
+  return tracer;
+}
+
+/* The stats of @kind, or NULL */
+static const GstStructure *
+find_stats (const GstStructure * info, const gchar * kind)
+{
+  const GValue *list = gst_structure_get_value (info, "copies-list");
+  guint i;
+
+  fail_unless (list != NULL);
+  for (i = 0; i < gst_value_list_get_size (list); i++) {
+    const GstStructure *s =
+        gst_value_get_structure (gst_value_list_get_value (list, i));
+
+    if (!g_strcmp0 (gst_structure_get_string (s, "kind"), kind))
+      return s;
+  }
+
+  return NULL;
+}
+
+GST_START_TEST (test_writable_copy)
+{
+  GstBuffer *buffer, *ref;
+  GstTracer *tracer;
+  GstStructure *info;
+  const GstStructure *s;
+  GstMapInfo map;
+  guint64 count, bytes, extra_refs;
+
+  buffer = gst_buffer_new_allocate (NULL, BUFFER_SIZE, NULL);
+  ref = gst_buffer_ref (buffer);
+
+  /* the extra ref forces a copy, which shares the memory until it's mapped
+   * for writing */
+  buffer = gst_buffer_make_writable (buffer);
+  fail_unless (buffer != ref);
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_WRITE));
+  gst_buffer_unmap (buffer, &map);
+
+  tracer = get_tracer_by_name ("copies");
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "get-stats", &info);
+  fail_unless (info != NULL);
+  GST_INFO ("stats: %" GST_PTR_FORMAT, info);
+
+  s = find_stats (info, "writable-copy");
+  fail_unless (s != NULL);
+  fail_unless_equals_string (gst_structure_get_string (s, "element"),
+      "(none)");
+  fail_unless (gst_structure_get_uint64 (s, "count", &count));
+  fail_unless (gst_structure_get_uint64 (s, "bytes", &bytes));
+  fail_unless (gst_structure_get_uint64 (s, "extra-refs", &extra_refs));
+  fail_unless_equals_uint64 (count, 1);
+  fail_unless_equals_uint64 (bytes, BUFFER_SIZE);
+  fail_unless_equals_uint64 (extra_refs, 1);
+
+  s = find_stats (info, "memory-copy");
+  fail_unless (s != NULL);
+  fail_unless (gst_structure_get_uint64 (s, "count", &count));
+  fail_unless (gst_structure_get_uint64 (s, "bytes", &bytes));
+  fail_unless_equals_uint64 (count, 1);
+  fail_unless_equals_uint64 (bytes, BUFFER_SIZE);
+
+  fail_unless (find_stats (info, "buffer-merge") == NULL);
+
+  gst_structure_free (info);
+  gst_object_unref (tracer);
+  gst_buffer_unref (buffer);
+  gst_buffer_unref (ref);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_buffer_merge)
+{
+  GstBuffer *buffer;
+  GstTracer *tracer;
+  GstStructure *info;
+  const GstStructure *s;
+  GstMapInfo map;
+  guint64 bytes;
+
+  buffer = gst_buffer_new ();
+  gst_buffer_append_memory (buffer, gst_allocator_alloc (NULL, BUFFER_SIZE,
+          NULL));
+  gst_buffer_append_memory (buffer, gst_allocator_alloc (NULL, BUFFER_SIZE,
+          NULL));
+
+  /* mapping the two memories at once merges them */
+  fail_unless (gst_buffer_map (buffer, &map, GST_MAP_READ));
+  fail_unless_equals_int (map.size, 2 * BUFFER_SIZE);
+  gst_buffer_unmap (buffer, &map);
+
+  tracer = get_tracer_by_name ("copies");
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "get-stats", &info);
+  fail_unless (info != NULL);
+
+  s = find_stats (info, "buffer-merge");
+  fail_unless (s != NULL);
+  fail_unless (gst_structure_get_uint64 (s, "bytes", &bytes));
+  fail_unless (bytes >= 2 * BUFFER_SIZE);
+
+  gst_structure_free (info);
+  gst_object_unref (tracer);
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
+static Suite *
+copiestracer_suite (void)
+{
+  Suite *s = suite_create ("copiestracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_writable_copy);
+  tcase_add_test (tc_chain, test_buffer_merge);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (copiestracer); because we need to set
+ * the env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+  int ret;
+
+  g_setenv ("GST_TRACERS", "copies(name=copies)", TRUE);
+
+  gst_check_init (&argc, &argv);
+  s = copiestracer_suite ();
+  ret = gst_check_run_suite (s, "copiestracer", __FILE__);
+
+  gst_deinit ();
+
+  return ret;
+}
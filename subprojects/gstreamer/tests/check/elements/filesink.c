@@ -329,6 +329,74 @@ GST_START_TEST (test_seeking)
 
 GST_END_TEST;
 
+static void
+check_async_writes (const gchar * buffer_mode)
+{
+  GstElement *filesink;
+  gchar *tmp_fn;
+  GstSegment segment;
+
+  tmp_fn = create_temporary_file ();
+  if (tmp_fn == NULL)
+    return;
+  filesink = setup_filesink ();
+
+  GST_LOG ("using temp file '%s'", tmp_fn);
+  g_object_set (filesink, "location", tmp_fn, "async-depth", 2,
+      "buffer-size", 1024, NULL);
+  gst_util_set_object_arg (G_OBJECT (filesink), "buffer-mode", buffer_mode);
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+
+  fail_unless (gst_pad_push_event (mysrcpad,
+          gst_event_new_stream_start ("test")));
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+
+  /* more writes than fit into the ring */
+  PUSH_BYTES (1);
+  PUSH_BYTES (99);
+  PUSH_BYTES (8800);
+  PUSH_BUFFER_LIST (3, 10);
+  PUSH_BUFFER_WITH_MULTIPLE_MEM_BLOCKS (2, 20);
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 8970);
+
+  /* the segment waits for the pending writes before seeking */
+  segment.start = 100;
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment)));
+  CHECK_QUERY_POSITION (filesink, GST_FORMAT_BYTES, 100);
+  PUSH_BYTES (50);
+
+  fail_unless (gst_pad_push_event (mysrcpad, gst_event_new_eos ()));
+
+  /* everything is on disk once EOS went through */
+  CHECK_WRITTEN_BYTES (0, 1, 8970);
+  CHECK_WRITTEN_BYTES (1, 99, 8970);
+  CHECK_WRITTEN_BYTES (100, 50, 8970);
+  CHECK_WRITTEN_BYTES (8920, 10, 8970);
+  CHECK_WRITTEN_BYTES (8930, 20, 8970);
+  CHECK_WRITTEN_BYTES (8950, 20, 8970);
+
+  fail_unless_equals_int (gst_element_set_state (filesink, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  cleanup_filesink (filesink);
+
+  g_remove (tmp_fn);
+  g_free (tmp_fn);
+}
+
+GST_START_TEST (test_async_writes)
+{
+  check_async_writes ("unbuffered");
+  check_async_writes ("full");
+  check_async_writes ("default");
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_flush)
 {
   GstElement *filesink;
@@ -496,6 +564,7 @@ filesink_suite (void)
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_seeking);
   tcase_add_test (tc_chain, test_flush);
+  tcase_add_test (tc_chain, test_async_writes);
 
   return s;
 }
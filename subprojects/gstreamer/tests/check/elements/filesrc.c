@@ -161,7 +161,8 @@ GST_START_TEST (test_reverse)
 
 GST_END_TEST;
 
-GST_START_TEST (test_pull)
+static void
+check_pull (gboolean use_mmap)
 {
   GstElement *src;
   GstQuery *seeking_query;
@@ -174,7 +175,8 @@ GST_START_TEST (test_pull)
 
   src = setup_filesrc ();
 
-  g_object_set (G_OBJECT (src), "location", TESTFILE, NULL);
+  g_object_set (G_OBJECT (src), "location", TESTFILE, "use-mmap", use_mmap,
+      NULL);
   fail_unless (gst_element_set_state (src,
           GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS,
       "could not set to ready");
@@ -301,6 +303,72 @@ GST_START_TEST (test_pull)
   cleanup_filesrc (src);
 }
 
+GST_START_TEST (test_pull)
+{
+  check_pull (FALSE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_pull_mmap)
+{
+  check_pull (TRUE);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_mmap_buffers_outlive_filesrc)
+{
+  GstElement *src;
+  GstPad *pad;
+  GstBuffer *mapped = NULL, *read = NULL, *sub;
+  GstMapInfo info1, info2;
+
+  /* read the reference data without mmap */
+  src = gst_element_factory_make ("filesrc", NULL);
+  g_object_set (G_OBJECT (src), "location", TESTFILE, NULL);
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS);
+  pad = gst_element_get_static_pad (src, "src");
+  fail_unless (gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, TRUE));
+  fail_unless_equals_int (gst_pad_get_range (pad, 10, 100, &read),
+      GST_FLOW_OK);
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pad);
+
+  g_object_set (G_OBJECT (src), "use-mmap", TRUE, NULL);
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS);
+  pad = gst_element_get_static_pad (src, "src");
+  fail_unless (gst_pad_activate_mode (pad, GST_PAD_MODE_PULL, TRUE));
+  fail_unless_equals_int (gst_pad_get_range (pad, 0, 200, &mapped),
+      GST_FLOW_OK);
+
+#ifdef HAVE_MMAP
+  /* mapped buffers are read-only */
+  fail_if (gst_buffer_map (mapped, &info1, GST_MAP_WRITE));
+#endif
+
+  /* sub-buffers share the mapping, it survives filesrc */
+  sub = gst_buffer_copy_region (mapped, GST_BUFFER_COPY_MEMORY, 10, 100);
+  gst_buffer_unref (mapped);
+  fail_unless (gst_element_set_state (src,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pad);
+  gst_object_unref (src);
+
+  fail_unless (gst_buffer_map (sub, &info1, GST_MAP_READ));
+  fail_unless (gst_buffer_map (read, &info2, GST_MAP_READ));
+  fail_unless_equals_int (info1.size, 100);
+  fail_unless (memcmp (info1.data, info2.data, 100) == 0);
+  gst_buffer_unmap (read, &info2);
+  gst_buffer_unmap (sub, &info1);
+
+  gst_buffer_unref (read);
+  gst_buffer_unref (sub);
+}
+
 GST_END_TEST;
 
 GST_START_TEST (test_coverage)
@@ -554,6 +622,8 @@ filesrc_suite (void)
   tcase_add_test (tc_chain, test_seeking);
   tcase_add_test (tc_chain, test_reverse);
   tcase_add_test (tc_chain, test_pull);
+  tcase_add_test (tc_chain, test_pull_mmap);
+  tcase_add_test (tc_chain, test_mmap_buffers_outlive_filesrc);
   tcase_add_test (tc_chain, test_coverage);
   tcase_add_test (tc_chain, test_uri_interface);
   tcase_add_test (tc_chain, test_uri_query);
@@ -0,0 +1,155 @@
+/* GStreamer
+ *
+ * Unit test for the flamegraph tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <string.h>
+#include <glib/gstdio.h>
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+#define NUM_BUFFERS 100
+
+static GstTracer *
+get_tracer_by_name (const gchar * name)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next) {
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), name) == 0)
+      tracer = gst_object_ref (l->data);
+  }
+
+  g_list_free_full (tracers, gst_object_unref);
+  return tracer;
+}
+
+/* The time of @stack, or -1 if it's not there */
+static gint64
+find_stack (gchar ** lines, const gchar * stack)
+{
+  gsize len = strlen (stack);
+  gchar **line;
+
+  for (line = lines; *line; line++) {
+    if (g_str_has_prefix (*line, stack) && (*line)[len] == ' ')
+      return g_ascii_strtoll (*line + len + 1, NULL, 10);
+  }
+
+  return -1;
+}
+
+GST_START_TEST (test_folded_stacks)
+{
+  GstElement *pipe, *bin, *src, *identity, *sink;
+  GstTracer *tracer;
+  GstMessage *m;
+  gchar *stacks, **lines;
+
+  pipe = gst_pipeline_new ("pipeline");
+  bin = gst_bin_new ("bin");
+  src = gst_element_factory_make ("fakesrc", "src");
+  identity = gst_element_factory_make ("identity", "identity");
+  sink = gst_element_factory_make ("fakesink", "sink");
+  fail_unless (src && identity && sink);
+  g_object_set (src, "num-buffers", NUM_BUFFERS, NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+
+  gst_bin_add (GST_BIN (bin), identity);
+  fail_unless (gst_element_add_pad (bin, gst_ghost_pad_new ("sink",
+              identity->sinkpads->data)));
+  fail_unless (gst_element_add_pad (bin, gst_ghost_pad_new ("src",
+              identity->srcpads->data)));
+  gst_bin_add_many (GST_BIN (pipe), src, bin, sink, NULL);
+  fail_unless (gst_element_link_many (src, bin, sink, NULL));
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (m), GST_MESSAGE_EOS);
+  gst_message_unref (m);
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+
+  tracer = get_tracer_by_name ("flame");
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "get-folded-stacks", &stacks);
+  fail_unless (stacks != NULL);
+  GST_INFO ("stacks:\n%s", stacks);
+  lines = g_strsplit (stacks, "\n", -1);
+
+  /* the ghost pads of the bin don't show up as frames */
+  fail_unless (find_stack (lines, "pipeline;src") >= 0);
+  fail_unless (find_stack (lines, "pipeline;src;bin/identity") >= 0);
+  fail_unless (find_stack (lines, "pipeline;src;bin/identity;sink") >= 0);
+  fail_unless (find_stack (lines, "pipeline;src;bin") < 0);
+
+  g_strfreev (lines);
+  g_free (stacks);
+  gst_object_unref (tracer);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+flamegraphtracer_suite (void)
+{
+  Suite *s = suite_create ("flamegraphtracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_folded_stacks);
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (flamegraphtracer); because we need to set
+ * the env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+  gchar *file, *tracers;
+  int ret;
+
+  /* the wall clock so that even the cheap elements get some time */
+  file = g_build_filename (g_get_tmp_dir (), "gst-check-flamegraph.folded",
+      NULL);
+  tracers = g_strdup_printf ("flamegraph(name=flame,clock=wall,file=\"%s\")",
+      file);
+  g_setenv ("GST_TRACERS", tracers, TRUE);
+  g_free (tracers);
+
+  gst_check_init (&argc, &argv);
+  s = flamegraphtracer_suite ();
+  ret = gst_check_run_suite (s, "flamegraphtracer", __FILE__);
+
+  gst_deinit ();
+  g_unlink (file);
+  g_free (file);
+
+  return ret;
+}
@@ -0,0 +1,205 @@
+/* GStreamer
+ *
+ * Unit test for the histogram tracer
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/gst.h>
+#include <gst/check/gstcheck.h>
+
+#define NUM_BUFFERS 20
+
+static GstTracer *
+get_tracer_by_name (const gchar * name)
+{
+  GList *tracers, *l;
+  GstTracer *tracer = NULL;
+
+  tracers = gst_tracing_get_active_tracers ();
+  for (l = tracers; l; l = l->next) {
+    if (g_strcmp0 (GST_OBJECT_NAME (l->data), name) == 0)
+      tracer = gst_object_ref (l->data);
+  }
+
+  g_list_free_full (tracers, gst_object_unref);
+  return tracer;
+}
+
+static const GstStructure *
+find_entry (const GstStructure * snapshot, const gchar * list,
+    const gchar * name)
+{
+  const GValue *entries = gst_structure_get_value (snapshot, list);
+  guint i;
+
+  fail_unless (entries != NULL);
+  fail_unless (G_VALUE_HOLDS (entries, GST_TYPE_LIST));
+
+  for (i = 0; i < gst_value_list_get_size (entries); i++) {
+    const GstStructure *s =
+        gst_value_get_structure (gst_value_list_get_value (entries, i));
+
+    if (g_strcmp0 (gst_structure_get_string (s, "name"), name) == 0)
+      return s;
+  }
+
+  return NULL;
+}
+
+static guint64
+get_field (const GstStructure * s, const gchar * field)
+{
+  guint64 value = 0;
+
+  fail_unless (gst_structure_get_uint64 (s, field, &value), "no field %s",
+      field);
+  return value;
+}
+
+static void
+run_pipeline (GstElement * pipe)
+{
+  GstMessage *m;
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_PLAYING),
+      GST_STATE_CHANGE_ASYNC);
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), -1,
+      GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (m), GST_MESSAGE_EOS);
+  gst_message_unref (m);
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+}
+
+GST_START_TEST (test_get_snapshot)
+{
+  GstElement *pipe, *src, *queue, *sink;
+  GstStructure *snapshot;
+  const GstStructure *s;
+  GstTracer *tracer;
+
+  pipe = gst_pipeline_new ("pipeline");
+  src = gst_element_factory_make ("fakesrc", "src");
+  queue = gst_element_factory_make ("queue", "queue");
+  sink = gst_element_factory_make ("fakesink", "sink");
+  fail_unless (src && queue && sink);
+  g_object_set (src, "num-buffers", NUM_BUFFERS, NULL);
+  g_object_set (sink, "sync", FALSE, NULL);
+
+  gst_bin_add_many (GST_BIN (pipe), src, queue, sink, NULL);
+  fail_unless (gst_element_link_many (src, queue, sink, NULL));
+
+  run_pipeline (pipe);
+
+  tracer = get_tracer_by_name ("hist");
+  fail_unless (tracer);
+  g_signal_emit_by_name (tracer, "get-snapshot", &snapshot);
+  fail_unless (snapshot != NULL);
+  fail_unless (gst_structure_has_name (snapshot, "histogram-snapshot"));
+
+  s = find_entry (snapshot, "pads", "src:src");
+  fail_unless (s != NULL);
+  fail_unless_equals_uint64 (get_field (s, "push-count"), NUM_BUFFERS);
+  fail_unless_equals_uint64 (get_field (s, "gap-count"), NUM_BUFFERS - 1);
+  fail_unless (get_field (s, "push-p50") <= get_field (s, "push-p99"));
+  fail_unless (get_field (s, "push-p99") <= get_field (s, "push-max"));
+
+  s = find_entry (snapshot, "pads", "queue:src");
+  fail_unless (s != NULL);
+  fail_unless_equals_uint64 (get_field (s, "push-count"), NUM_BUFFERS);
+
+  s = find_entry (snapshot, "elements", "queue");
+  fail_unless (s != NULL);
+  fail_unless_equals_uint64 (get_field (s, "processing-count"), NUM_BUFFERS);
+  fail_unless_equals_uint64 (get_field (s, "residency-count"), NUM_BUFFERS);
+
+  s = find_entry (snapshot, "elements", "sink");
+  fail_unless (s != NULL);
+  fail_unless_equals_uint64 (get_field (s, "processing-count"), NUM_BUFFERS);
+  fail_if (gst_structure_has_field (s, "residency-count"));
+
+  gst_structure_free (snapshot);
+  gst_object_unref (tracer);
+
+  gst_object_unref (pipe);
+
+  /* The objects are gone from the snapshot together with the pipeline */
+  tracer = get_tracer_by_name ("hist");
+  g_signal_emit_by_name (tracer, "get-snapshot", &snapshot);
+  fail_unless (find_entry (snapshot, "elements", "queue") == NULL);
+  gst_structure_free (snapshot);
+  gst_object_unref (tracer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_periodic_snapshot)
+{
+  GstElement *pipe;
+  GstMessage *m;
+
+  pipe = gst_parse_launch ("fakesrc num-buffers=-1 ! fakesink sync=false",
+      NULL);
+  fail_unless (pipe != NULL);
+
+  fail_unless (gst_element_set_state (pipe, GST_STATE_PLAYING) !=
+      GST_STATE_CHANGE_FAILURE);
+
+  m = gst_bus_timed_pop_filtered (GST_ELEMENT_BUS (pipe), 5 * GST_SECOND,
+      GST_MESSAGE_ELEMENT);
+  fail_unless (m != NULL);
+  fail_unless (gst_message_has_name (m, "histogram-snapshot"));
+  fail_unless (GST_MESSAGE_SRC (m) == GST_OBJECT (pipe));
+  gst_message_unref (m);
+
+  fail_unless_equals_int (gst_element_set_state (pipe, GST_STATE_NULL),
+      GST_STATE_CHANGE_SUCCESS);
+  gst_object_unref (pipe);
+}
+
+GST_END_TEST;
+
+static Suite *
+histogramtracer_suite (void)
+{
+  Suite *s = suite_create ("histogramtracer");
+  TCase *tc_chain = tcase_create ("general");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_get_snapshot);
+#ifndef GST_DISABLE_PARSE
+  tcase_add_test (tc_chain, test_periodic_snapshot);
+#endif
+
+  return s;
+}
+
+/* Replacement for GST_CHECK_MAIN (histogramtracer); because we need to set
+ * the env before gst_init() is called */
+int
+main (int argc, char **argv)
+{
+  Suite *s;
+
+  g_setenv ("GST_TRACERS", "histogram(name=hist,interval=100)", TRUE);
+  gst_check_init (&argc, &argv);
+  s = histogramtracer_suite ();
+  return gst_check_run_suite (s, "histogramtracer", __FILE__);
+}
@@ -493,12 +493,55 @@ GST_START_TEST (test_activity_get_checkpoint)
 
 GST_END_TEST;
 
+static gint
+get_live_count (GstTracer * tracer, const gchar * type_name)
+{
+  GstStructure *counts;
+  gint live = 0;
+
+  g_signal_emit_by_name (tracer, "get-live-counts", &counts);
+  fail_unless (gst_structure_has_name (counts, "live-counts"));
+  gst_structure_get_int (counts, type_name, &live);
+  gst_structure_free (counts);
+
+  return live;
+}
+
+GST_START_TEST (test_live_counts)
+{
+  GstCaps *caps[10];
+  GstTracer *tracer = get_tracer_by_name ("counted");
+  gint live;
+  guint i;
+
+  fail_unless (tracer);
+
+  live = get_live_count (tracer, "GstCaps");
+  for (i = 0; i < G_N_ELEMENTS (caps); i++)
+    caps[i] = gst_caps_new_empty_simple ("video/x-raw");
+
+  /* all objects are counted, even when only some are sampled */
+  fail_unless_equals_int (get_live_count (tracer, "GstCaps"),
+      live + G_N_ELEMENTS (caps));
+  fail_unless_equals_int (get_live_count (tracer, "GstBuffer"), 0);
+  g_signal_emit_by_name (tracer, "log-growth");
+
+  for (i = 0; i < G_N_ELEMENTS (caps); i++)
+    gst_caps_unref (caps[i]);
+  fail_unless_equals_int (get_live_count (tracer, "GstCaps"), live);
+
+  gst_object_unref (tracer);
+}
+
+GST_END_TEST;
+
 static Suite *
 leakstracer_suite (void)
 {
   Suite *s = suite_create ("leakstracer");
   TCase *tc_chain_1 = tcase_create ("live-objects");
   TCase *tc_chain_2 = tcase_create ("activity-tracking");
+  TCase *tc_chain_3 = tcase_create ("live-counts");
 
   suite_add_tcase (s, tc_chain_1);
   tcase_add_test (tc_chain_1, test_log_live_objects);
@@ -510,6 +553,9 @@ leakstracer_suite (void)
   tcase_add_test (tc_chain_2, test_activity_log_checkpoint);
   tcase_add_test (tc_chain_2, test_activity_get_checkpoint);
 
+  suite_add_tcase (s, tc_chain_3);
+  tcase_add_test (tc_chain_3, test_live_counts);
+
   return s;
 }
 
@@ -520,7 +566,8 @@ main (int argc, char **argv)
 {
   Suite *s;
   g_setenv ("GST_TRACERS", "leaks(name=plain,log-leaks-on-deinit=false);"
-      "leaks(name=more,filters=GstPad,check-refs=true,stack-traces-flags=none,log-leaks-on-deinit=false);",
+      "leaks(name=more,filters=GstPad,check-refs=true,stack-traces-flags=none,log-leaks-on-deinit=false);"
+      "leaks(name=counted,filters=GstCaps,sampling=4,live-counts=true,log-leaks-on-deinit=false);",
       TRUE);
   gst_check_init (&argc, &argv);
   s = leakstracer_suite ();
@@ -1359,6 +1359,46 @@ GST_START_TEST (test_limit_changes)
 
 GST_END_TEST;
 
+GST_START_TEST (test_stats_limits)
+{
+  GstElement *mq;
+  GstPad *sinkpad;
+  GstStructure *stats;
+  const GValue *queues, *v;
+  const GstStructure *s;
+  guint max_buffers;
+  guint64 interleave;
+
+  mq = gst_element_factory_make ("multiqueue", NULL);
+  fail_unless (mq != NULL);
+  g_object_set (mq, "max-size-buffers", (guint) 7, NULL);
+
+  sinkpad = gst_element_request_pad_simple (mq, "sink_%u");
+  fail_unless (sinkpad != NULL);
+
+  g_object_get (mq, "stats", &stats, NULL);
+  fail_unless (stats != NULL);
+  fail_unless (gst_structure_get_uint64 (stats, "interleave", &interleave));
+  fail_unless_equals_uint64 (interleave, 0);
+
+  queues = gst_structure_get_value (stats, "queues");
+  fail_unless (queues != NULL);
+  fail_unless_equals_int (gst_value_array_get_size (queues), 1);
+  v = gst_value_array_get_value (queues, 0);
+  s = gst_value_get_structure (v);
+  fail_unless (gst_structure_get_uint (s, "max-buffers", &max_buffers));
+  fail_unless_equals_int (max_buffers, 7);
+  fail_unless (gst_structure_has_field (s, "max-bytes"));
+  fail_unless (gst_structure_has_field (s, "max-time"));
+  gst_structure_free (stats);
+
+  gst_element_release_request_pad (mq, sinkpad);
+  gst_object_unref (sinkpad);
+  gst_object_unref (mq);
+}
+
+GST_END_TEST;
+
 static GMutex block_mutex;
 static GCond block_cond;
 static gint unblock_count;
@@ -1492,6 +1532,111 @@ GST_START_TEST (test_buffering_with_none_pts)
 
 GST_END_TEST;
 
+static guint
+get_queue_max_buffers (GstElement * mq, guint idx)
+{
+  GstStructure *stats;
+  const GValue *queues;
+  const GstStructure *s;
+  guint max_buffers = 0;
+
+  g_object_get (mq, "stats", &stats, NULL);
+  queues = gst_structure_get_value (stats, "queues");
+  s = gst_value_get_structure (gst_value_array_get_value (queues, idx));
+  fail_unless (gst_structure_get_uint (s, "max-buffers", &max_buffers));
+  gst_structure_free (stats);
+
+  return max_buffers;
+}
+
+GST_START_TEST (test_visible_limit_shrinks)
+{
+  /*
+   * One stream is blocked downstream while the other one starves, so the
+   * visible limit of the blocked stream grows with every buffer. Once it
+   * drains again the limit must go back to the configured max-size-buffers.
+   */
+  GstElement *mq;
+  GstPad *inputpads[2];
+  GstPad *outputpads[2];
+  GstPad *mq_sinkpads[2];
+  GstPad *mq_srcpads[2];
+  GstSegment segment;
+  gchar *name;
+  gint i;
+
+  g_mutex_init (&block_mutex);
+  g_cond_init (&block_cond);
+  unblock_count = 0;
+
+  mq = gst_element_factory_make ("multiqueue", NULL);
+  fail_unless (mq != NULL);
+
+  g_object_set (mq,
+      "max-size-bytes", (guint) 0,
+      "max-size-buffers", (guint) 2,
+      "max-size-time", (guint64) 0, NULL);
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+
+  for (i = 0; i < 2; i++) {
+    inputpads[i] = gst_pad_new ("dummysrc", GST_PAD_SRC);
+    outputpads[i] = gst_pad_new ("dummysink", GST_PAD_SINK);
+    gst_pad_set_chain_function (outputpads[i], pad_chain_block);
+    gst_pad_set_event_function (outputpads[i], pad_event_always_ok);
+    mq_sinkpads[i] = gst_element_request_pad_simple (mq, "sink_%u");
+    fail_unless (mq_sinkpads[i] != NULL);
+    name = g_strdup_printf ("src_%d", i);
+    mq_srcpads[i] = gst_element_get_static_pad (mq, name);
+    g_free (name);
+    fail_unless (gst_pad_link (inputpads[i],
+            mq_sinkpads[i]) == GST_PAD_LINK_OK);
+    fail_unless (gst_pad_link (mq_srcpads[i],
+            outputpads[i]) == GST_PAD_LINK_OK);
+
+    gst_pad_set_active (inputpads[i], TRUE);
+    gst_pad_set_active (outputpads[i], TRUE);
+  }
+
+  gst_element_set_state (mq, GST_STATE_PAUSED);
+
+  for (i = 0; i < 2; i++) {
+    name = g_strdup_printf ("test%d", i);
+    gst_pad_push_event (inputpads[i], gst_event_new_stream_start (name));
+    g_free (name);
+    gst_pad_push_event (inputpads[i], gst_event_new_segment (&segment));
+  }
+
+  /* the second stream stays empty, so the first one can always grow */
+  for (i = 0; i < 10; i++)
+    fail_unless (gst_pad_push (inputpads[0], gst_buffer_new ()) == GST_FLOW_OK);
+
+  fail_unless (get_queue_max_buffers (mq, 0) > 2);
+
+  g_mutex_lock (&block_mutex);
+  unblock_count = -1;
+  g_cond_signal (&block_cond);
+  g_mutex_unlock (&block_mutex);
+
+  /* draining gives the extra room back */
+  for (i = 0; i < 500 && get_queue_max_buffers (mq, 0) != 2; i++)
+    g_usleep (G_USEC_PER_SEC / 100);
+  fail_unless_equals_int (get_queue_max_buffers (mq, 0), 2);
+
+  gst_element_set_state (mq, GST_STATE_NULL);
+  for (i = 0; i < 2; i++) {
+    gst_object_unref (inputpads[i]);
+    gst_object_unref (outputpads[i]);
+    gst_object_unref (mq_sinkpads[i]);
+    gst_object_unref (mq_srcpads[i]);
+  }
+  gst_object_unref (mq);
+  g_mutex_clear (&block_mutex);
+  g_cond_clear (&block_cond);
+}
+
+GST_END_TEST;
+
 static gboolean
 event_func_signal (GstPad * sinkpad, GstObject * parent, GstEvent * event)
 {
@@ -1687,8 +1832,10 @@ multiqueue_suite (void)
   tcase_add_test (tc_chain, test_high_threshold_change);
   tcase_add_test (tc_chain, test_low_threshold_change);
   tcase_add_test (tc_chain, test_limit_changes);
+  tcase_add_test (tc_chain, test_stats_limits);
 
   tcase_add_test (tc_chain, test_buffering_with_none_pts);
+  tcase_add_test (tc_chain, test_visible_limit_shrinks);
   tcase_add_test (tc_chain, test_initial_events_nodelay);
 
   tcase_add_test (tc_chain, test_stream_status_messages);
@@ -1181,6 +1181,141 @@ GST_START_TEST (test_initial_events_nodelay)
 
 GST_END_TEST;
 
+#define N_SPIN_BUFFERS 100
+
+GST_START_TEST (test_spin_and_wakeup_watermark)
+{
+  GstSegment segment;
+  GList *l;
+  guint i;
+
+  g_object_set (G_OBJECT (queue), "max-size-buffers", 4, "spin-count", 1000,
+      "wakeup-watermark", 50, NULL);
+  mysinkpad = setup_sink_pad (queue, &sinktemplate);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+  gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment));
+
+  /* upstream blocks on the full queue and gets woken up again, nothing may
+   * get lost or reordered */
+  for (i = 0; i < N_SPIN_BUFFERS; i++) {
+    GstBuffer *buffer = gst_buffer_new ();
+
+    GST_BUFFER_OFFSET (buffer) = i;
+    fail_unless_equals_int (gst_pad_push (mysrcpad, buffer), GST_FLOW_OK);
+  }
+
+  g_mutex_lock (&check_mutex);
+  while (g_list_length (buffers) < N_SPIN_BUFFERS)
+    g_cond_wait (&check_cond, &check_mutex);
+  g_mutex_unlock (&check_mutex);
+
+  for (i = 0, l = buffers; l; i++, l = l->next)
+    fail_unless_equals_int (GST_BUFFER_OFFSET (l->data), i);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_memory_budget)
+{
+  GstMemoryBudget *budget;
+  GstContext *context;
+  GstBuffer *key, *delta1, *delta2, *delta3, *key2;
+  GstSegment segment;
+  GstMessage *msg;
+  GstBus *bus;
+
+  budget = gst_memory_budget_new ("test", 10,
+      GST_MEMORY_BUDGET_POLICY_DROP_DELTA);
+  context = gst_memory_budget_context_new (budget);
+  gst_element_set_context (queue, context);
+  gst_context_unref (context);
+
+  bus = gst_bus_new ();
+  gst_element_set_bus (queue, bus);
+
+  block_src ();
+
+  UNDERRUN_LOCK ();
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS,
+      "could not set to playing");
+  UNDERRUN_WAIT ();
+  UNDERRUN_UNLOCK ();
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_push_event (mysrcpad, gst_event_new_stream_start ("test"));
+  gst_pad_push_event (mysrcpad, gst_event_new_segment (&segment));
+
+  key = gst_buffer_new_and_alloc (4);
+  delta1 = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_FLAG_SET (delta1, GST_BUFFER_FLAG_DELTA_UNIT);
+  delta2 = gst_buffer_new_and_alloc (4);
+  GST_BUFFER_FLAG_SET (delta2, GST_BUFFER_FLAG_DELTA_UNIT);
+  delta3 = gst_buffer_new_and_alloc (1);
+  GST_BUFFER_FLAG_SET (delta3, GST_BUFFER_FLAG_DELTA_UNIT);
+  key2 = gst_buffer_new_and_alloc (4);
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, key), GST_FLOW_OK);
+  fail_unless_equals_int (gst_pad_push (mysrcpad, delta1), GST_FLOW_OK);
+  fail_unless_equals_int (gst_memory_budget_get_current_bytes (budget), 8);
+  fail_if (gst_bus_have_pending (bus));
+
+  /* over budget, the delta unit is dropped but the keyframe is kept */
+  gst_buffer_ref (delta2);
+  fail_unless_equals_int (gst_pad_push (mysrcpad, delta2), GST_FLOW_OK);
+  fail_unless_equals_int (gst_memory_budget_get_current_bytes (budget), 8);
+  ASSERT_BUFFER_REFCOUNT (delta2, "delta2", 1);
+  gst_buffer_unref (delta2);
+
+  msg = gst_bus_pop_filtered (bus, GST_MESSAGE_WARNING);
+  fail_unless (msg != NULL);
+  gst_message_unref (msg);
+
+  /* the following delta unit would fit but can't be decoded without the
+   * dropped one, so deltas are dropped until the next keyframe */
+  gst_buffer_ref (delta3);
+  fail_unless_equals_int (gst_pad_push (mysrcpad, delta3), GST_FLOW_OK);
+  fail_unless_equals_int (gst_memory_budget_get_current_bytes (budget), 8);
+  ASSERT_BUFFER_REFCOUNT (delta3, "delta3", 1);
+  gst_buffer_unref (delta3);
+
+  fail_unless_equals_int (gst_pad_push (mysrcpad, key2), GST_FLOW_OK);
+  fail_unless_equals_int (gst_memory_budget_get_current_bytes (budget), 12);
+  fail_unless_equals_int (gst_memory_budget_get_peak_bytes (budget), 12);
+
+  /* draining the queue releases the budget */
+  UNDERRUN_LOCK ();
+  mysinkpad = setup_sink_pad (queue, &sinktemplate);
+  unblock_src ();
+  UNDERRUN_WAIT ();
+  UNDERRUN_UNLOCK ();
+
+  fail_unless_equals_int (g_list_length (buffers), 3);
+  fail_unless (g_list_nth_data (buffers, 0) == key);
+  fail_unless (g_list_nth_data (buffers, 1) == delta1);
+  fail_unless (g_list_nth_data (buffers, 2) == key2);
+  fail_unless (GST_BUFFER_FLAG_IS_SET (key2, GST_BUFFER_FLAG_DISCONT));
+  fail_unless_equals_int (gst_memory_budget_get_current_bytes (budget), 0);
+
+  fail_unless (gst_element_set_state (queue,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS, "could not set to null");
+
+  gst_element_set_bus (queue, NULL);
+  gst_object_unref (bus);
+  gst_memory_budget_unref (budget);
+}
+
+GST_END_TEST;
+
 static Suite *
 queue_suite (void)
 {
@@ -1204,6 +1339,8 @@ queue_suite (void)
   tcase_add_test (tc_chain, test_sticky_not_linked);
   tcase_add_test (tc_chain, test_time_level_buffer_list);
   tcase_add_test (tc_chain, test_initial_events_nodelay);
+  tcase_add_test (tc_chain, test_spin_and_wakeup_watermark);
+  tcase_add_test (tc_chain, test_memory_budget);
 
   return s;
 }
@@ -715,6 +715,71 @@ GST_START_TEST (test_ready_paused_buffering_message)
 
 GST_END_TEST;
 
+GST_START_TEST (test_mmap_ring_buffer)
+{
+  GstElement *queue2;
+  GstBuffer *buffer;
+  GstPad *sinkpad, *srcpad;
+  GstSegment segment;
+  GstMapInfo info;
+  gchar *template;
+  guint8 *data;
+  gint i;
+
+  queue2 = gst_element_factory_make ("queue2", NULL);
+  sinkpad = gst_element_get_static_pad (queue2, "sink");
+  srcpad = gst_element_get_static_pad (queue2, "src");
+
+  template = g_build_filename (g_get_tmp_dir (), "queue2-test-XXXXXX", NULL);
+  g_object_set (queue2, "temp-template", template,
+      "ring-buffer-max-size", (guint64) 64 * 1024, "use-mmap", TRUE,
+      "use-buffering", FALSE, NULL);
+  g_free (template);
+
+  gst_pad_activate_mode (srcpad, GST_PAD_MODE_PULL, TRUE);
+  gst_element_set_state (queue2, GST_STATE_PLAYING);
+
+  gst_segment_init (&segment, GST_FORMAT_BYTES);
+  gst_pad_send_event (sinkpad, gst_event_new_stream_start ("test"));
+  gst_pad_send_event (sinkpad, gst_event_new_segment (&segment));
+
+  data = g_malloc (8 * 1024);
+  for (i = 0; i < 8 * 1024; i++)
+    data[i] = i & 0xff;
+  buffer = gst_buffer_new_wrapped (data, 8 * 1024);
+  fail_unless (gst_pad_chain (sinkpad, buffer) == GST_FLOW_OK);
+
+  buffer = NULL;
+  fail_unless (gst_pad_get_range (srcpad, 1024, 4 * 1024,
+          &buffer) == GST_FLOW_OK);
+  fail_unless_equals_int (gst_buffer_get_size (buffer), 4 * 1024);
+  fail_unless_equals_uint64 (GST_BUFFER_OFFSET (buffer), 1024);
+
+#ifdef HAVE_MMAP
+  /* the output wraps the mapped temp file */
+  fail_unless (GST_MEMORY_IS_READONLY (gst_buffer_peek_memory (buffer, 0)));
+#endif
+
+  fail_unless (gst_buffer_map (buffer, &info, GST_MAP_READ));
+  for (i = 0; i < 4 * 1024; i++)
+    fail_unless_equals_int (info.data[i], (1024 + i) & 0xff);
+  gst_buffer_unmap (buffer, &info);
+
+  gst_element_set_state (queue2, GST_STATE_NULL);
+
+  /* the data stays valid after the queue closed the file */
+  fail_unless (gst_buffer_map (buffer, &info, GST_MAP_READ));
+  fail_unless_equals_int (info.data[0], 1024 & 0xff);
+  gst_buffer_unmap (buffer, &info);
+  gst_buffer_unref (buffer);
+
+  gst_object_unref (sinkpad);
+  gst_object_unref (srcpad);
+  gst_object_unref (queue2);
+}
+
+GST_END_TEST;
+
 static Suite *
 queue2_suite (void)
 {
@@ -733,6 +798,7 @@ queue2_suite (void)
   tcase_add_test (tc_chain, test_small_ring_buffer);
   tcase_add_test (tc_chain, test_bitrate_query);
   tcase_add_test (tc_chain, test_ready_paused_buffering_message);
+  tcase_add_test (tc_chain, test_mmap_ring_buffer);
 
   return s;
 }
@@ -629,6 +629,67 @@ GST_START_TEST (test_input_selector_switch_to_eos_stream)
 GST_END_TEST;
 
 
+static GstBuffer *
+input_selector_push_frame (gint stream, gboolean keyframe)
+{
+  GstBuffer *buf;
+  GstPad *pad = stream == 1 ? stream1_pad : stream2_pad;
+
+  buf = gst_buffer_new ();
+  if (!keyframe)
+    GST_BUFFER_FLAG_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT);
+  fail_unless (gst_pad_push (pad, gst_buffer_ref (buf)) == GST_FLOW_OK);
+  gst_buffer_unref (buf);
+
+  return buf;
+}
+
+GST_START_TEST (test_input_selector_cache_gop)
+{
+  GstBuffer *delta1, *delta2, *delta3;
+  GList *l;
+
+  setup_input_selector_with_2_streams (2);
+  g_object_set (selector, "cache-gop", TRUE, NULL);
+
+  /* deltas before the first keyframe can't be replayed */
+  input_selector_push_frame (1, FALSE);
+  input_selector_push_frame (1, TRUE);
+  delta1 = input_selector_push_frame (1, FALSE);
+  delta2 = input_selector_push_frame (1, FALSE);
+  input_selector_push_frame (2, TRUE);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  gst_check_drop_buffers ();
+
+  /* switching in the middle of the GOP replays it from the keyframe, which
+   * is copied to mark the discont */
+  g_object_set (selector, "active-pad", GST_PAD_PEER (stream1_pad), NULL);
+  delta3 = input_selector_push_frame (1, FALSE);
+  fail_unless_equals_int (g_list_length (buffers), 4);
+  l = buffers;
+  fail_unless (GST_BUFFER_FLAG_IS_SET (l->data, GST_BUFFER_FLAG_DISCONT));
+  fail_if (GST_BUFFER_FLAG_IS_SET (l->data, GST_BUFFER_FLAG_DELTA_UNIT));
+  l = l->next;
+  fail_unless (l->data == delta1);
+  l = l->next;
+  fail_unless (l->data == delta2);
+  l = l->next;
+  fail_unless (l->data == delta3);
+  fail_if (GST_BUFFER_FLAG_IS_SET (l->data, GST_BUFFER_FLAG_DISCONT));
+  gst_check_drop_buffers ();
+
+  /* switching on a keyframe doesn't replay anything */
+  g_object_set (selector, "active-pad", GST_PAD_PEER (stream2_pad), NULL);
+  input_selector_push_frame (2, TRUE);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  gst_check_drop_buffers ();
+
+  teardown_input_selector_with_2_streams ();
+}
+
+GST_END_TEST;
+
+
 GST_START_TEST (test_output_selector_no_srcpad_negotiation)
 {
   GstElement *sel;
@@ -840,6 +901,7 @@ selector_suite (void)
   tcase_add_test (tc_chain, test_input_selector_empty_stream);
   tcase_add_test (tc_chain, test_input_selector_shorter_stream);
   tcase_add_test (tc_chain, test_input_selector_switch_to_eos_stream);
+  tcase_add_test (tc_chain, test_input_selector_cache_gop);
   tcase_add_test (tc_chain, test_output_selector_no_srcpad_negotiation);
 
   tc_chain = tcase_create ("output-selector-negotiation");
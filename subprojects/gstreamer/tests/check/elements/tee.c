@@ -939,6 +939,345 @@ GST_START_TEST (test_allocation_query_empty)
 
 GST_END_TEST;
 
+typedef struct
+{
+  GMutex lock;
+  GCond cond;
+  gboolean blocked;
+  guint count;
+  GstClockTime last_pts;
+  GstFlowReturn ret;
+} BranchData;
+
+static GstFlowReturn
+branch_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
+{
+  BranchData *data = gst_pad_get_element_private (pad);
+  GstFlowReturn ret;
+
+  g_mutex_lock (&data->lock);
+  while (data->blocked)
+    g_cond_wait (&data->cond, &data->lock);
+  data->count++;
+  data->last_pts = GST_BUFFER_PTS (buffer);
+  ret = data->ret;
+  g_cond_broadcast (&data->cond);
+  g_mutex_unlock (&data->lock);
+
+  gst_buffer_unref (buffer);
+
+  return ret;
+}
+
+static GstPad *
+setup_branch (GstElement * tee, BranchData * data, const gchar * name)
+{
+  GstPad *srcpad, *sinkpad;
+
+  g_mutex_init (&data->lock);
+  g_cond_init (&data->cond);
+  data->blocked = FALSE;
+  data->count = 0;
+  data->last_pts = GST_CLOCK_TIME_NONE;
+  data->ret = GST_FLOW_OK;
+
+  srcpad = gst_element_request_pad_simple (tee, "src_%u");
+  fail_unless (srcpad != NULL);
+
+  sinkpad = gst_pad_new (name, GST_PAD_SINK);
+  gst_pad_set_element_private (sinkpad, data);
+  gst_pad_set_chain_function (sinkpad, branch_chain);
+  gst_pad_set_active (sinkpad, TRUE);
+  fail_unless_equals_int (gst_pad_link (srcpad, sinkpad), GST_PAD_LINK_OK);
+  gst_object_unref (sinkpad);
+
+  return srcpad;
+}
+
+static void
+teardown_branch (GstElement * tee, GstPad * srcpad, BranchData * data)
+{
+  GstPad *sinkpad = gst_pad_get_peer (srcpad);
+
+  gst_element_release_request_pad (tee, srcpad);
+  gst_object_unref (srcpad);
+  gst_pad_set_active (sinkpad, FALSE);
+  gst_object_unref (sinkpad);
+
+  g_mutex_clear (&data->lock);
+  g_cond_clear (&data->cond);
+}
+
+/* a blocked leaky branch must not stall the other branch, and after
+ * unblocking it only gets the most recent buffers */
+GST_START_TEST (test_queued_branch_leaky)
+{
+#define NUM_LEAKY_BUFFERS 10
+  GstElement *tee;
+  GstPad *srcpad, *src1, *src2;
+  BranchData branch1, branch2;
+  GstSegment segment;
+  GstCaps *caps;
+  gint i;
+
+  static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+      GST_PAD_SRC,
+      GST_PAD_ALWAYS,
+      GST_STATIC_CAPS_ANY);
+
+  tee = gst_check_setup_element ("tee");
+  fail_unless (tee);
+
+  src1 = setup_branch (tee, &branch1, "sink1");
+  g_object_set (src1, "max-size-buffers", 2, "leaky", 2 /* downstream */ ,
+      NULL);
+  branch1.blocked = TRUE;
+  src2 = setup_branch (tee, &branch2, "sink2");
+
+  srcpad = gst_check_setup_src_pad (tee, &srctemplate);
+  gst_pad_set_active (srcpad, TRUE);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_caps_new_empty_simple ("test/test");
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("test"));
+  gst_pad_set_caps (srcpad, caps);
+  gst_caps_unref (caps);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  for (i = 0; i < NUM_LEAKY_BUFFERS; i++) {
+    GstBuffer *buffer = gst_buffer_new ();
+
+    GST_BUFFER_PTS (buffer) = i * GST_SECOND;
+    fail_unless_equals_int (gst_pad_push (srcpad, buffer), GST_FLOW_OK);
+  }
+
+  /* the unqueued branch got everything while the other one is blocked */
+  fail_unless_equals_int (branch2.count, NUM_LEAKY_BUFFERS);
+  fail_unless_equals_int (branch1.count, 0);
+
+  g_mutex_lock (&branch1.lock);
+  branch1.blocked = FALSE;
+  g_cond_broadcast (&branch1.cond);
+  while (branch1.last_pts != (NUM_LEAKY_BUFFERS - 1) * GST_SECOND)
+    g_cond_wait (&branch1.cond, &branch1.lock);
+  /* at most the buffer that was blocked plus the queued ones */
+  fail_unless (branch1.count <= 3);
+  g_mutex_unlock (&branch1.lock);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+
+  teardown_branch (tee, src1, &branch1);
+  teardown_branch (tee, src2, &branch2);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_check_teardown_src_pad (tee);
+  gst_check_teardown_element (tee);
+#undef NUM_LEAKY_BUFFERS
+}
+
+GST_END_TEST;
+
+/* all queued branches get every buffer, in order, from the shared workers */
+GST_START_TEST (test_queued_branches)
+{
+#define NUM_BRANCHES 10
+#define NUM_QUEUED_BUFFERS 50
+  GstElement *tee;
+  GstPad *srcpad, *srcpads[NUM_BRANCHES];
+  BranchData branches[NUM_BRANCHES];
+  GstSegment segment;
+  GstCaps *caps;
+  gint i;
+
+  static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+      GST_PAD_SRC,
+      GST_PAD_ALWAYS,
+      GST_STATIC_CAPS_ANY);
+
+  tee = gst_check_setup_element ("tee");
+  fail_unless (tee);
+  g_object_set (tee, "max-threads", 2, NULL);
+
+  for (i = 0; i < NUM_BRANCHES; i++) {
+    gchar *name = g_strdup_printf ("sink%d", i);
+
+    srcpads[i] = setup_branch (tee, &branches[i], name);
+    g_object_set (srcpads[i], "max-size-buffers", 4, NULL);
+    g_free (name);
+  }
+
+  srcpad = gst_check_setup_src_pad (tee, &srctemplate);
+  gst_pad_set_active (srcpad, TRUE);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+
+  caps = gst_caps_new_empty_simple ("test/test");
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("test"));
+  gst_pad_set_caps (srcpad, caps);
+  gst_caps_unref (caps);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+
+  for (i = 0; i < NUM_QUEUED_BUFFERS; i++) {
+    GstBuffer *buffer = gst_buffer_new ();
+
+    GST_BUFFER_PTS (buffer) = i * GST_SECOND;
+    fail_unless_equals_int (gst_pad_push (srcpad, buffer), GST_FLOW_OK);
+  }
+
+  for (i = 0; i < NUM_BRANCHES; i++) {
+    g_mutex_lock (&branches[i].lock);
+    while (branches[i].count < NUM_QUEUED_BUFFERS)
+      g_cond_wait (&branches[i].cond, &branches[i].lock);
+    fail_unless_equals_uint64 (branches[i].last_pts,
+        (NUM_QUEUED_BUFFERS - 1) * GST_SECOND);
+    g_mutex_unlock (&branches[i].lock);
+  }
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+
+  for (i = 0; i < NUM_BRANCHES; i++)
+    teardown_branch (tee, srcpads[i], &branches[i]);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_check_teardown_src_pad (tee);
+  gst_check_teardown_element (tee);
+#undef NUM_QUEUED_BUFFERS
+#undef NUM_BRANCHES
+}
+
+GST_END_TEST;
+
+static void
+push_stream_start (GstPad * srcpad)
+{
+  GstSegment segment;
+  GstCaps *caps;
+
+  caps = gst_caps_new_empty_simple ("test/test");
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("test"));
+  gst_pad_set_caps (srcpad, caps);
+  gst_caps_unref (caps);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&segment));
+}
+
+/* the flow return of a queued branch is forgotten when tee is restarted
+ * without a flush */
+GST_START_TEST (test_queued_branch_restart)
+{
+  GstElement *tee;
+  GstPad *srcpad, *src1;
+  BranchData branch1;
+  GstFlowReturn ret = GST_FLOW_OK;
+  gint i;
+
+  static GstStaticPadTemplate srctemplate = GST_STATIC_PAD_TEMPLATE ("src",
+      GST_PAD_SRC,
+      GST_PAD_ALWAYS,
+      GST_STATIC_CAPS_ANY);
+
+  tee = gst_check_setup_element ("tee");
+  fail_unless (tee);
+
+  src1 = setup_branch (tee, &branch1, "sink1");
+  g_object_set (src1, "max-size-buffers", 2, NULL);
+  branch1.ret = GST_FLOW_EOS;
+
+  srcpad = gst_check_setup_src_pad (tee, &srctemplate);
+  gst_pad_set_active (srcpad, TRUE);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+  push_stream_start (srcpad);
+
+  /* the EOS of the branch is reported on one of the next buffers */
+  for (i = 0; i < 1000 && ret == GST_FLOW_OK; i++) {
+    ret = gst_pad_push (srcpad, gst_buffer_new ());
+    g_usleep (1000);
+  }
+  fail_unless_equals_int (ret, GST_FLOW_EOS);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_READY) == GST_STATE_CHANGE_SUCCESS);
+
+  g_mutex_lock (&branch1.lock);
+  branch1.ret = GST_FLOW_OK;
+  branch1.count = 0;
+  g_mutex_unlock (&branch1.lock);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_PLAYING) == GST_STATE_CHANGE_SUCCESS);
+  push_stream_start (srcpad);
+
+  fail_unless_equals_int (gst_pad_push (srcpad, gst_buffer_new ()),
+      GST_FLOW_OK);
+
+  g_mutex_lock (&branch1.lock);
+  while (branch1.count < 1)
+    g_cond_wait (&branch1.cond, &branch1.lock);
+  g_mutex_unlock (&branch1.lock);
+
+  fail_unless_equals_int (gst_pad_push (srcpad, gst_buffer_new ()),
+      GST_FLOW_OK);
+
+  fail_unless (gst_element_set_state (tee,
+          GST_STATE_NULL) == GST_STATE_CHANGE_SUCCESS);
+
+  teardown_branch (tee, src1, &branch1);
+  gst_pad_set_active (srcpad, FALSE);
+  gst_check_teardown_src_pad (tee);
+  gst_check_teardown_element (tee);
+}
+
+GST_END_TEST;
+
+/* with more queued branches than max-threads, the workers blocked in the
+ * preroll of the first sinks must not keep the other branches from
+ * prerolling */
+GST_START_TEST (test_queued_branches_preroll)
+{
+#define NUM_BRANCHES 4
+  GstElement *pipeline, *src, *tee, *sink;
+  GstStateChangeReturn ret;
+  gint i;
+
+  pipeline = gst_pipeline_new (NULL);
+  src = gst_element_factory_make ("fakesrc", NULL);
+  tee = gst_element_factory_make ("tee", NULL);
+  g_object_set (tee, "max-threads", 1, NULL);
+  gst_bin_add_many (GST_BIN (pipeline), src, tee, NULL);
+  fail_unless (gst_element_link (src, tee));
+
+  for (i = 0; i < NUM_BRANCHES; i++) {
+    GstPad *srcpad, *sinkpad;
+
+    sink = gst_element_factory_make ("fakesink", NULL);
+    gst_bin_add (GST_BIN (pipeline), sink);
+
+    srcpad = gst_element_request_pad_simple (tee, "src_%u");
+    g_object_set (srcpad, "max-size-buffers", 2, NULL);
+    sinkpad = gst_element_get_static_pad (sink, "sink");
+    fail_unless_equals_int (gst_pad_link (srcpad, sinkpad), GST_PAD_LINK_OK);
+    gst_object_unref (sinkpad);
+    gst_object_unref (srcpad);
+  }
+
+  ret = gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  fail_if (ret == GST_STATE_CHANGE_FAILURE);
+  ret = gst_element_get_state (pipeline, NULL, NULL, 5 * GST_SECOND);
+  fail_unless_equals_int (ret, GST_STATE_CHANGE_SUCCESS);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+#undef NUM_BRANCHES
+}
+
+GST_END_TEST;
 
 static Suite *
 tee_suite (void)
@@ -962,6 +1301,10 @@ tee_suite (void)
   tcase_add_test (tc_chain, test_allocation_query_allow_not_linked);
   tcase_add_test (tc_chain, test_allocation_query_failure);
   tcase_add_test (tc_chain, test_allocation_query_empty);
+  tcase_add_test (tc_chain, test_queued_branch_leaky);
+  tcase_add_test (tc_chain, test_queued_branches);
+  tcase_add_test (tc_chain, test_queued_branch_restart);
+  tcase_add_test (tc_chain, test_queued_branches_preroll);
 
   return s;
 }
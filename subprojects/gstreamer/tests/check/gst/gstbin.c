@@ -1490,6 +1490,196 @@ GST_START_TEST (test_state_failure_remove)
 
 GST_END_TEST;
 
+GST_START_TEST (test_parallel_state_changes)
+{
+  GstElement *pipeline, *src, *identity, *sink, *failing = NULL;
+  GstStateChangeReturn ret;
+  GstMessage *msg;
+  GstBus *bus;
+  GList *l;
+  gint i;
+
+#define NUM_CHAINS 8
+
+  pipeline = gst_pipeline_new (NULL);
+  g_object_set (pipeline, "parallel-state-changes", TRUE, NULL);
+
+  for (i = 0; i < NUM_CHAINS; i++) {
+    src = gst_element_factory_make ("fakesrc", NULL);
+    g_object_set (src, "num-buffers", 3, NULL);
+    identity = gst_element_factory_make ("identity", NULL);
+    sink = gst_element_factory_make ("fakesink", NULL);
+    gst_bin_add_many (GST_BIN (pipeline), src, identity, sink, NULL);
+    fail_unless (gst_element_link_many (src, identity, sink, NULL));
+  }
+
+  ret = gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  fail_unless (ret == GST_STATE_CHANGE_ASYNC);
+  ret = gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+  fail_unless (ret == GST_STATE_CHANGE_SUCCESS);
+
+  for (l = GST_BIN_CHILDREN (pipeline); l; l = l->next)
+    fail_unless_equals_int (GST_STATE (l->data), GST_STATE_PLAYING);
+
+  bus = gst_element_get_bus (pipeline);
+  msg = gst_bus_poll (bus, GST_MESSAGE_EOS | GST_MESSAGE_ERROR, -1);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+  gst_message_unref (msg);
+  gst_object_unref (bus);
+
+  ret = gst_element_set_state (pipeline, GST_STATE_NULL);
+  fail_unless (ret == GST_STATE_CHANGE_SUCCESS);
+
+  for (l = GST_BIN_CHILDREN (pipeline); l; l = l->next) {
+    fail_unless_equals_int (GST_STATE (l->data), GST_STATE_NULL);
+    if (!failing && g_str_has_prefix (GST_OBJECT_NAME (l->data), "fakesink"))
+      failing = l->data;
+  }
+
+  /* a failure in one chain fails the whole state change */
+  g_object_set (failing, "state-error", 1 /* null-to-ready */ , NULL);
+  ret = gst_element_set_state (pipeline, GST_STATE_READY);
+  fail_unless (ret == GST_STATE_CHANGE_FAILURE);
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+
+#undef NUM_CHAINS
+}
+
+GST_END_TEST;
+
+static GstPadProbeReturn
+count_latency_queries (GstPad * pad, GstPadProbeInfo * info, gpointer data)
+{
+  if (GST_QUERY_TYPE (GST_PAD_PROBE_INFO_QUERY (info)) == GST_QUERY_LATENCY)
+    g_atomic_int_inc ((gint *) data);
+
+  return GST_PAD_PROBE_OK;
+}
+
+GST_START_TEST (test_cache_latency)
+{
+  GstElement *pipeline, *src1, *src2, *sink1, *sink2;
+  GstQuery *query;
+  GstPad *pad;
+  gint count1 = 0, count2 = 0;
+
+  pipeline = gst_pipeline_new (NULL);
+  g_object_set (pipeline, "cache-latency", TRUE, NULL);
+
+  src1 = gst_element_factory_make ("fakesrc", NULL);
+  sink1 = gst_element_factory_make ("fakesink", NULL);
+  src2 = gst_element_factory_make ("fakesrc", NULL);
+  sink2 = gst_element_factory_make ("fakesink", NULL);
+  gst_bin_add_many (GST_BIN (pipeline), src1, sink1, src2, sink2, NULL);
+  fail_unless (gst_element_link (src1, sink1));
+  fail_unless (gst_element_link (src2, sink2));
+
+  pad = gst_element_get_static_pad (src1, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_QUERY_UPSTREAM,
+      count_latency_queries, &count1, NULL);
+  gst_object_unref (pad);
+  pad = gst_element_get_static_pad (src2, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_QUERY_UPSTREAM,
+      count_latency_queries, &count2, NULL);
+  gst_object_unref (pad);
+
+  /* the sinks only answer the latency query once prerolled */
+  fail_unless_equals_int (gst_element_set_state (pipeline, GST_STATE_PAUSED),
+      GST_STATE_CHANGE_ASYNC);
+  fail_unless_equals_int (gst_element_get_state (pipeline, NULL, NULL,
+          GST_CLOCK_TIME_NONE), GST_STATE_CHANGE_SUCCESS);
+
+  query = gst_query_new_latency ();
+  fail_unless (gst_element_query (pipeline, query));
+  fail_unless (count1 > 0);
+  fail_unless (count2 > 0);
+  count1 = count2 = 0;
+
+  /* second query is answered from the cache */
+  fail_unless (gst_element_query (pipeline, query));
+  fail_unless_equals_int (count1, 0);
+  fail_unless_equals_int (count2, 0);
+
+  /* only the branch that posted a latency message is queried again */
+  gst_element_post_message (src1,
+      gst_message_new_latency (GST_OBJECT_CAST (src1)));
+  fail_unless (gst_element_query (pipeline, query));
+  fail_unless_equals_int (count1, 1);
+  fail_unless_equals_int (count2, 0);
+
+  /* disabling the cache queries all branches */
+  g_object_set (pipeline, "cache-latency", FALSE, NULL);
+  fail_unless (gst_element_query (pipeline, query));
+  fail_unless_equals_int (count1, 2);
+  fail_unless_equals_int (count2, 1);
+
+  gst_query_unref (query);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_cache_latency_live)
+{
+  GstElement *pipeline, *src, *sink;
+  GstStateChangeReturn ret;
+  GstQuery *query;
+  GstPad *pad;
+  gboolean live;
+  gint count = 0;
+
+  pipeline = gst_pipeline_new (NULL);
+  g_object_set (pipeline, "cache-latency", TRUE, NULL);
+
+  src = gst_element_factory_make ("fakesrc", NULL);
+  g_object_set (src, "is-live", TRUE, NULL);
+  sink = gst_element_factory_make ("fakesink", NULL);
+  g_object_set (sink, "sync", TRUE, "processing-deadline", (guint64) 0, NULL);
+  gst_bin_add_many (GST_BIN (pipeline), src, sink, NULL);
+  fail_unless (gst_element_link (src, sink));
+
+  pad = gst_element_get_static_pad (src, "src");
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_QUERY_UPSTREAM,
+      count_latency_queries, &count, NULL);
+  gst_object_unref (pad);
+
+  /* a live sink fails the query until it prerolled, which must not be
+   * cached */
+  ret = gst_element_set_state (pipeline, GST_STATE_PAUSED);
+  fail_unless_equals_int (ret, GST_STATE_CHANGE_NO_PREROLL);
+
+  query = gst_query_new_latency ();
+  fail_if (gst_element_query (pipeline, query));
+  fail_unless_equals_int (count, 0);
+
+  ret = gst_element_set_state (pipeline, GST_STATE_PLAYING);
+  fail_if (ret == GST_STATE_CHANGE_FAILURE);
+  ret = gst_element_get_state (pipeline, NULL, NULL, GST_CLOCK_TIME_NONE);
+  fail_unless_equals_int (ret, GST_STATE_CHANGE_SUCCESS);
+
+  /* prerolled now, the sink is queried again and reports a live latency */
+  fail_unless (gst_element_query (pipeline, query));
+  gst_query_parse_latency (query, &live, NULL, NULL);
+  fail_unless (live);
+  fail_unless (count > 0);
+  count = 0;
+
+  /* and that answer is cached */
+  fail_unless (gst_element_query (pipeline, query));
+  gst_query_parse_latency (query, &live, NULL, NULL);
+  fail_unless (live);
+  fail_unless_equals_int (count, 0);
+
+  gst_query_unref (query);
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_many_bins)
 {
   GstStateChangeReturn ret;
@@ -2017,6 +2207,9 @@ gst_bin_suite (void)
   tcase_add_test (tc_chain, test_link_structure_change);
   tcase_add_test (tc_chain, test_state_failure_remove);
   tcase_add_test (tc_chain, test_state_failure_unref);
+  tcase_add_test (tc_chain, test_parallel_state_changes);
+  tcase_add_test (tc_chain, test_cache_latency);
+  tcase_add_test (tc_chain, test_cache_latency_live);
   tcase_add_test (tc_chain, test_state_change_skip);
   tcase_add_test (tc_chain, test_duration_is_max);
   tcase_add_test (tc_chain, test_duration_unknown_overrides);
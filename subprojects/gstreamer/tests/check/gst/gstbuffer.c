@@ -286,6 +286,79 @@ GST_START_TEST (test_metadata_writable)
 
 GST_END_TEST;
 
+GST_START_TEST (test_make_metadata_writable)
+{
+  GstBuffer *buffer, *copy;
+  GstMemory *mem;
+  GstMapInfo info;
+  guint8 data[4] = { 0, 1, 2, 3 };
+
+  buffer = gst_buffer_new ();
+  mem = gst_memory_new_wrapped (0, data, sizeof (data), 0, sizeof (data),
+      NULL, NULL);
+  gst_buffer_append_memory (buffer, mem);
+  GST_BUFFER_PTS (buffer) = 10;
+
+  /* writable buffers are returned as is */
+  copy = gst_buffer_make_metadata_writable (buffer);
+  fail_unless (copy == buffer);
+
+  gst_buffer_ref (buffer);
+  copy = gst_buffer_make_metadata_writable (buffer);
+  fail_if (copy == buffer);
+  fail_unless (gst_buffer_is_writable (copy));
+  fail_unless (gst_buffer_peek_memory (copy, 0) == mem);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (copy), 10);
+  ASSERT_BUFFER_REFCOUNT (buffer, "buffer", 1);
+
+  GST_BUFFER_PTS (copy) = 20;
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (buffer), 10);
+
+  /* the shared memory is copied when it is written to */
+  fail_unless (gst_buffer_map (copy, &info, GST_MAP_WRITE));
+  info.data[0] = 42;
+  gst_buffer_unmap (copy, &info);
+  fail_if (gst_buffer_peek_memory (copy, 0) == mem);
+  fail_unless_equals_int (data[0], 0);
+
+  gst_buffer_unref (copy);
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_make_metadata_writable_no_share)
+{
+  GstBuffer *buffer, *copy;
+  GstMemory *mem;
+  guint8 data[4] = { 0, 1, 2, 3 };
+
+  buffer = gst_buffer_new ();
+  mem = gst_memory_new_wrapped (GST_MEMORY_FLAG_NO_SHARE, data, sizeof (data),
+      0, sizeof (data), NULL, NULL);
+  gst_buffer_append_memory (buffer, mem);
+  gst_buffer_append_memory (buffer, gst_allocator_alloc (NULL, 4, NULL));
+  GST_BUFFER_PTS (buffer) = 10;
+
+  /* NO_SHARE memory is never shared, it's copied like with
+   * gst_buffer_make_writable() */
+  gst_buffer_ref (buffer);
+  copy = gst_buffer_make_metadata_writable (buffer);
+  fail_if (copy == buffer);
+  fail_unless (gst_buffer_is_writable (copy));
+  fail_unless_equals_int (gst_buffer_n_memory (copy), 2);
+  fail_if (gst_buffer_peek_memory (copy, 0) == mem);
+  fail_unless (gst_buffer_memcmp (copy, 0, data, sizeof (data)) == 0);
+  fail_unless_equals_uint64 (GST_BUFFER_PTS (copy), 10);
+  ASSERT_BUFFER_REFCOUNT (buffer, "buffer", 1);
+  ASSERT_MINI_OBJECT_REFCOUNT (mem, "mem", 1);
+
+  gst_buffer_unref (copy);
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_memcmp)
 {
   GstBuffer *buffer;
@@ -979,6 +1052,8 @@ gst_buffer_suite (void)
   tcase_add_test (tc_chain, test_make_writable);
   tcase_add_test (tc_chain, test_span);
   tcase_add_test (tc_chain, test_metadata_writable);
+  tcase_add_test (tc_chain, test_make_metadata_writable);
+  tcase_add_test (tc_chain, test_make_metadata_writable_no_share);
   tcase_add_test (tc_chain, test_memcmp);
   tcase_add_test (tc_chain, test_copy);
   tcase_add_test (tc_chain, test_copy_deep);
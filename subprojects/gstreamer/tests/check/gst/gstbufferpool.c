@@ -336,6 +336,95 @@ GST_START_TEST (test_no_deadlock_for_buffer_discard)
 
 GST_END_TEST;
 
+static GstBufferPool *
+create_thread_cache_pool (guint size, guint min_buf, guint max_buf,
+    guint cache_size)
+{
+  GstBufferPool *pool = gst_buffer_pool_new ();
+  GstStructure *conf = gst_buffer_pool_get_config (pool);
+  GstCaps *caps = gst_caps_new_empty_simple ("test/data");
+
+  gst_buffer_pool_config_set_params (conf, caps, size, min_buf, max_buf);
+  gst_buffer_pool_config_set_thread_cache_size (conf, cache_size);
+  fail_unless (gst_buffer_pool_set_config (pool, conf));
+  gst_caps_unref (caps);
+
+  return pool;
+}
+
+GST_START_TEST (test_thread_cache_recycles)
+{
+  GstBufferPool *pool;
+  GstStructure *conf;
+  GstBuffer *buf, *prev;
+  guint cache_size = 0;
+  gint dcount = 0;
+
+  pool = create_thread_cache_pool (10, 0, 0, 4);
+  conf = gst_buffer_pool_get_config (pool);
+  fail_unless (gst_buffer_pool_config_get_thread_cache_size (conf,
+          &cache_size));
+  fail_unless_equals_int (cache_size, 4);
+  gst_structure_free (conf);
+
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  gst_buffer_pool_acquire_buffer (pool, &buf, NULL);
+  buffer_track_destroy (buf, &dcount);
+  prev = buf;
+  gst_buffer_unref (buf);
+
+  /* buffer should be handed out again from the cache of this thread */
+  gst_buffer_pool_acquire_buffer (pool, &buf, NULL);
+  fail_unless (buf == prev, "got a fresh buffer instead of previous");
+  fail_unless_equals_int (dcount, 0);
+  gst_buffer_unref (buf);
+
+  /* cached buffers are freed when the pool is deactivated */
+  gst_buffer_pool_set_active (pool, FALSE);
+  fail_unless_equals_int (dcount, 1);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+static gpointer
+unref_buf_in_thread (gpointer p)
+{
+  gst_buffer_unref (GST_BUFFER_CAST (p));
+  return NULL;
+}
+
+GST_START_TEST (test_thread_cache_cross_thread_release)
+{
+  GstBufferPool *pool;
+  GstBuffer *buf1, *buf2, *buf3;
+  GThread *thread;
+
+  pool = create_thread_cache_pool (10, 0, 2, 4);
+  gst_buffer_pool_set_active (pool, TRUE);
+
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf1,
+          NULL) == GST_FLOW_OK);
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf2,
+          NULL) == GST_FLOW_OK);
+
+  /* released into the cache of another thread, the blocking acquire here
+   * must still get it */
+  thread = g_thread_new (NULL, unref_buf_in_thread, buf1);
+  fail_unless (gst_buffer_pool_acquire_buffer (pool, &buf3,
+          NULL) == GST_FLOW_OK);
+  fail_unless (buf3 == buf1);
+  g_thread_join (thread);
+
+  gst_buffer_unref (buf2);
+  gst_buffer_unref (buf3);
+  gst_buffer_pool_set_active (pool, FALSE);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_buffer_pool_suite (void)
 {
@@ -355,6 +444,8 @@ gst_buffer_pool_suite (void)
   tcase_add_test (tc_chain, test_pool_config_validate);
   tcase_add_test (tc_chain, test_flushing_pool_returns_flushing);
   tcase_add_test (tc_chain, test_no_deadlock_for_buffer_discard);
+  tcase_add_test (tc_chain, test_thread_cache_recycles);
+  tcase_add_test (tc_chain, test_thread_cache_cross_thread_release);
 
   return s;
 }
@@ -926,6 +926,96 @@ GST_START_TEST (test_single_gsource)
 
 GST_END_TEST;
 
+GST_START_TEST (test_coalesce_messages)
+{
+  GstBus *bus = gst_bus_new ();
+  GstObject *src1 = GST_OBJECT (gst_bin_new ("src1"));
+  GstObject *src2 = GST_OBJECT (gst_bin_new ("src2"));
+  GstMessage *message, *peeked;
+  guint32 seqnum;
+  gint percent;
+
+  /* a newer buffering message from the same source replaces the last queued
+   * one */
+  gst_bus_post (bus, gst_message_new_buffering (src1, 10));
+  message = gst_message_new_buffering (src1, 30);
+  seqnum = gst_message_get_seqnum (message);
+  gst_bus_post (bus, message);
+  gst_bus_post (bus, gst_message_new_buffering (src2, 20));
+  gst_bus_post (bus, gst_message_new_duration_changed (src1));
+  gst_bus_post (bus, gst_message_new_duration_changed (src1));
+
+  message = gst_bus_pop (bus);
+  fail_unless (GST_MESSAGE_SRC (message) == src1);
+  gst_message_parse_buffering (message, &percent);
+  fail_unless_equals_int (percent, 30);
+  fail_unless_equals_int (gst_message_get_seqnum (message), seqnum);
+  gst_message_unref (message);
+
+  message = gst_bus_pop (bus);
+  fail_unless (GST_MESSAGE_SRC (message) == src2);
+  gst_message_parse_buffering (message, &percent);
+  fail_unless_equals_int (percent, 20);
+  gst_message_unref (message);
+
+  message = gst_bus_pop (bus);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (message),
+      GST_MESSAGE_DURATION_CHANGED);
+  gst_message_unref (message);
+  fail_if (gst_bus_have_pending (bus));
+
+  /* messages are never coalesced across other messages, so the order is
+   * kept */
+  gst_bus_post (bus, gst_message_new_buffering (src1, 10));
+  gst_bus_post (bus, gst_message_new_eos (src2));
+  gst_bus_post (bus, gst_message_new_buffering (src1, 100));
+
+  message = gst_bus_pop (bus);
+  gst_message_parse_buffering (message, &percent);
+  fail_unless_equals_int (percent, 10);
+  gst_message_unref (message);
+  message = gst_bus_pop (bus);
+  fail_unless_equals_int (GST_MESSAGE_TYPE (message), GST_MESSAGE_EOS);
+  gst_message_unref (message);
+  message = gst_bus_pop (bus);
+  gst_message_parse_buffering (message, &percent);
+  fail_unless_equals_int (percent, 100);
+  gst_message_unref (message);
+  fail_if (gst_bus_have_pending (bus));
+
+  /* once popped, a new message is queued normally */
+  gst_bus_post (bus, gst_message_new_buffering (src1, 40));
+  message = gst_bus_pop (bus);
+  gst_message_parse_buffering (message, &percent);
+  fail_unless_equals_int (percent, 40);
+  gst_message_unref (message);
+
+  /* a queued message that is referenced elsewhere is left alone */
+  gst_bus_post (bus, gst_message_new_buffering (src1, 50));
+  peeked = gst_bus_peek (bus);
+  gst_bus_post (bus, gst_message_new_buffering (src1, 60));
+  gst_bus_post (bus, gst_message_new_buffering (src1, 70));
+  gst_message_parse_buffering (peeked, &percent);
+  fail_unless_equals_int (percent, 50);
+  gst_message_unref (peeked);
+
+  message = gst_bus_pop (bus);
+  gst_message_parse_buffering (message, &percent);
+  fail_unless_equals_int (percent, 50);
+  gst_message_unref (message);
+  message = gst_bus_pop (bus);
+  gst_message_parse_buffering (message, &percent);
+  fail_unless_equals_int (percent, 70);
+  gst_message_unref (message);
+  fail_if (gst_bus_have_pending (bus));
+
+  gst_object_unref (src1);
+  gst_object_unref (src2);
+  gst_object_unref (bus);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_bus_suite (void)
 {
@@ -949,6 +1039,7 @@ gst_bus_suite (void)
   tcase_add_test (tc_chain, test_custom_main_context);
   tcase_add_test (tc_chain, test_async_message);
   tcase_add_test (tc_chain, test_single_gsource);
+  tcase_add_test (tc_chain, test_coalesce_messages);
   return s;
 }
 
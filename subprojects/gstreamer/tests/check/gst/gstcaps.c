@@ -1842,6 +1842,62 @@ GST_START_TEST (test_fixed)
 
 GST_END_TEST;
 
+GST_START_TEST (test_intersect_cached)
+{
+  GstCaps *c1, *c2, *c3, *ci1, *ci2;
+  gint i;
+
+  c1 = gst_caps_from_string ("video/x-raw, format=I420; video/x-raw, "
+      "format=NV12; video/x-raw, format=RGB");
+  c2 = gst_caps_from_string ("video/x-raw, format={ RGB, I420 }, width=320; "
+      "video/x-raw, format=NV12, width=640");
+
+  /* Repeated intersections give equal and independent results */
+  for (i = 0; i < 2; i++) {
+    ci1 = gst_caps_intersect_full (c1, c2, GST_CAPS_INTERSECT_FIRST);
+    ci2 = gst_caps_intersect_full (c1, c2, GST_CAPS_INTERSECT_FIRST);
+    fail_unless (ci1 != ci2);
+    fail_unless (gst_caps_is_writable (ci1));
+    fail_unless (gst_caps_is_writable (ci2));
+    fail_unless (gst_caps_is_strictly_equal (ci1, ci2));
+    fail_unless_equals_int (gst_caps_get_size (ci1), 3);
+    fail_unless_equals_string (gst_structure_get_string
+        (gst_caps_get_structure (ci1, 0), "format"), "I420");
+
+    /* Changing a result does not affect the next one */
+    gst_caps_set_simple (ci1, "height", G_TYPE_INT, 240, NULL);
+    gst_caps_unref (ci1);
+    gst_caps_unref (ci2);
+
+    fail_unless (gst_caps_can_intersect (c1, c2));
+    fail_if (gst_caps_is_subset (c1, c2));
+  }
+
+  /* Caps that only differ in list order give differently ordered results */
+  c3 = gst_caps_from_string ("video/x-raw, format={ I420, RGB }, width=320; "
+      "video/x-raw, format=NV12, width=640");
+  fail_unless (gst_caps_is_equal (c2, c3));
+  gst_caps_unref (c1);
+  c1 = gst_caps_from_string ("video/x-raw, format={ NV12, I420, RGB }; "
+      "video/x-raw, format=NV12");
+  ci1 = gst_caps_intersect_full (c2, c1, GST_CAPS_INTERSECT_FIRST);
+  ci2 = gst_caps_intersect_full (c3, c1, GST_CAPS_INTERSECT_FIRST);
+  fail_unless_equals_string (g_value_get_string (gst_value_list_get_value
+          (gst_structure_get_value (gst_caps_get_structure (ci1, 0),
+                  "format"), 0)), "RGB");
+  fail_unless_equals_string (g_value_get_string (gst_value_list_get_value
+          (gst_structure_get_value (gst_caps_get_structure (ci2, 0),
+                  "format"), 0)), "I420");
+  gst_caps_unref (ci1);
+  gst_caps_unref (ci2);
+
+  gst_caps_unref (c1);
+  gst_caps_unref (c2);
+  gst_caps_unref (c3);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_caps_suite (void)
 {
@@ -1880,6 +1936,7 @@ gst_caps_suite (void)
   tcase_add_test (tc_chain, test_equality);
   tcase_add_test (tc_chain, test_remains_any);
   tcase_add_test (tc_chain, test_fixed);
+  tcase_add_test (tc_chain, test_intersect_cached);
 
   return s;
 }
@@ -194,6 +194,44 @@ GST_START_TEST (test_class)
 
 GST_END_TEST;
 
+/* metadata and pad templates are available whether the factories were
+ * loaded from the registry cache or from the plugins */
+GST_START_TEST (test_metadata)
+{
+  GList *factories, *l;
+
+  factories = gst_element_factory_list_get_elements
+      (GST_ELEMENT_FACTORY_TYPE_ANY, GST_RANK_NONE);
+  fail_unless (factories != NULL);
+
+  for (l = factories; l; l = l->next) {
+    GstElementFactory *factory = l->data;
+    const GList *templates;
+    gchar **keys;
+
+    fail_unless (gst_element_factory_get_metadata (factory,
+            GST_ELEMENT_METADATA_LONGNAME) != NULL);
+    fail_unless (gst_element_factory_get_metadata (factory,
+            GST_ELEMENT_METADATA_KLASS) != NULL);
+
+    keys = gst_element_factory_get_metadata_keys (factory);
+    fail_unless (keys != NULL);
+    g_strfreev (keys);
+
+    templates = gst_element_factory_get_static_pad_templates (factory);
+    for (; templates; templates = templates->next) {
+      GstStaticPadTemplate *templ = templates->data;
+
+      fail_unless (templ->name_template != NULL);
+      fail_unless (templ->static_caps.string != NULL);
+    }
+  }
+
+  gst_plugin_feature_list_free (factories);
+}
+
+GST_END_TEST;
+
 
 static Suite *
 gst_element_factory_suite (void)
@@ -207,6 +245,7 @@ gst_element_factory_suite (void)
   tcase_add_test (tc_chain, test_element_factory);
   tcase_add_test (tc_chain, test_can_sink_any_caps);
   tcase_add_test (tc_chain, test_can_sink_all_caps);
+  tcase_add_test (tc_chain, test_metadata);
 
   return s;
 }
@@ -748,6 +748,36 @@ GST_START_TEST (send_custom_events)
 
 GST_END_TEST;
 
+GST_START_TEST (event_structure_fields)
+{
+  GstEvent *event, *copy;
+  GstStructure *structure;
+  gchar *name;
+  gint i;
+
+  event = gst_event_new_latency (10 * GST_MSECOND);
+  structure = gst_event_writable_structure (event);
+
+  /* Grow past the fields preallocated with the event */
+  for (i = 0; i < 32; i++) {
+    name = g_strdup_printf ("field-%d", i);
+    gst_structure_set (structure, name, G_TYPE_STRING, name, NULL);
+    g_free (name);
+  }
+  fail_unless_equals_int (gst_structure_n_fields (structure), 33);
+
+  copy = gst_event_copy (event);
+  gst_event_unref (event);
+
+  fail_unless_equals_int (gst_structure_n_fields (gst_event_get_structure
+          (copy)), 33);
+  fail_unless_equals_string (gst_structure_get_string (gst_event_get_structure
+          (copy), "field-31"), "field-31");
+  gst_event_unref (copy);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_event_suite (void)
 {
@@ -759,6 +789,7 @@ gst_event_suite (void)
   suite_add_tcase (s, tc_chain);
   tcase_add_test (tc_chain, create_events);
   tcase_add_test (tc_chain, send_custom_events);
+  tcase_add_test (tc_chain, event_structure_fields);
   return s;
 }
 
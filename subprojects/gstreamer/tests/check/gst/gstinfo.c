@@ -558,6 +558,80 @@ GST_START_TEST (info_set_and_reset_string)
 
 GST_END_TEST;
 
+static gpointer
+binary_ring_buffer_thread_func (gpointer data)
+{
+  GST_INFO ("from thread %d", GPOINTER_TO_INT (data));
+
+  return NULL;
+}
+
+GST_START_TEST (info_binary_ring_buffer_logger)
+{
+  GstBuffer *buf;
+  GThread *thread;
+  gchar **logs;
+  gchar *all, *expected;
+  gint i;
+
+  gst_debug_remove_log_function (gst_debug_log_default);
+  gst_debug_add_binary_ring_buffer_logger (16384);
+  gst_debug_set_threshold_from_string ("LOG", TRUE);
+
+  GST_DEBUG ("int %d, long %ld, size %" G_GSIZE_FORMAT ", int64 %"
+      G_GINT64_FORMAT, -42, 123456789L, (gsize) 7, G_GINT64_CONSTANT (-1));
+  GST_DEBUG ("string '%s', precision '%.3s', star '%*d', NULL '%s'",
+      "hello", "abcdef", 5, 12, (gchar *) NULL);
+  GST_DEBUG ("double %.2f, pointer %p, 100%%", 2.5, &i);
+
+  buf = gst_buffer_new_allocate (NULL, 42, NULL);
+  GST_BUFFER_PTS (buf) = 5 * GST_SECOND;
+  GST_LOG ("buffer %" GST_PTR_FORMAT, buf);
+  gst_buffer_unref (buf);
+
+  thread = g_thread_new ("binlog", binary_ring_buffer_thread_func,
+      GINT_TO_POINTER (17));
+  g_thread_join (thread);
+
+  logs = gst_debug_binary_ring_buffer_logger_get_logs ();
+  fail_unless (logs != NULL);
+  fail_unless_equals_int (g_strv_length (logs), 2);
+  all = g_strjoinv ("", logs);
+
+  fail_unless (strstr (all,
+          "int -42, long 123456789, size 7, int64 -1\n") != NULL);
+  fail_unless (strstr (all,
+          "string 'hello', precision 'abc', star '   12', NULL '(NULL)'\n")
+      != NULL);
+  expected = g_strdup_printf ("double 2.50, pointer %p, 100%%\n", &i);
+  fail_unless (strstr (all, expected) != NULL);
+  g_free (expected);
+  fail_unless (strstr (all, "buffer buffer: ") != NULL);
+  fail_unless (strstr (all, "from thread 17\n") != NULL);
+  fail_unless (strstr (all, " DEBUG ") != NULL);
+  fail_unless (strstr (all, "gstinfo.c:") != NULL);
+  g_free (all);
+  g_strfreev (logs);
+
+  /* Older messages are dropped when the ring is full */
+  for (i = 0; i < 1000; i++)
+    GST_DEBUG ("message %d", i);
+
+  logs = gst_debug_binary_ring_buffer_logger_get_logs ();
+  all = g_strjoinv ("", logs);
+  fail_unless (strstr (all, "message 999\n") != NULL);
+  fail_unless (strstr (all, "message 0\n") == NULL);
+  fail_unless (strstr (all, "int -42") == NULL);
+  g_free (all);
+  g_strfreev (logs);
+
+  gst_debug_remove_binary_ring_buffer_logger ();
+  gst_debug_set_default_threshold (GST_LEVEL_NONE);
+  gst_debug_add_log_function (gst_debug_log_default, NULL, NULL);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_info_suite (void)
 {
@@ -581,6 +655,7 @@ gst_info_suite (void)
   tcase_add_test (tc_chain, info_set_and_unset_multiple);
   tcase_add_test (tc_chain, info_post_gst_init_category_registration);
   tcase_add_test (tc_chain, info_set_and_reset_string);
+  tcase_add_test (tc_chain, info_binary_ring_buffer_logger);
 #endif
 
   return s;
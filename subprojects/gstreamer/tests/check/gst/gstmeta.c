@@ -808,6 +808,43 @@ GST_START_TEST (test_meta_custom_transform)
 
 GST_END_TEST;
 
+GST_START_TEST (test_meta_get_after_remove)
+{
+  GstBuffer *buffer, *copy;
+  GstMeta *m1, *m2, *m3;
+
+  buffer = gst_buffer_new_and_alloc (4);
+  fail_unless (gst_buffer_get_meta (buffer, GST_META_TEST_API_TYPE) == NULL);
+
+  m1 = (GstMeta *) GST_META_TEST_ADD (buffer);
+  m2 = (GstMeta *) GST_META_FOO_ADD (buffer);
+  m3 = (GstMeta *) GST_META_TEST_ADD (buffer);
+
+  /* the first meta of an API is returned, also after removing others */
+  fail_unless (gst_buffer_get_meta (buffer, GST_META_TEST_API_TYPE) == m1);
+  fail_unless (gst_buffer_get_meta (buffer, GST_META_FOO_API_TYPE) == m2);
+  fail_unless (gst_buffer_remove_meta (buffer, m2));
+  fail_unless (gst_buffer_get_meta (buffer, GST_META_FOO_API_TYPE) == NULL);
+  fail_unless (gst_buffer_get_meta (buffer, GST_META_TEST_API_TYPE) == m1);
+  fail_unless (gst_buffer_remove_meta (buffer, m1));
+  fail_unless (gst_buffer_get_meta (buffer, GST_META_TEST_API_TYPE) == m3);
+  fail_unless_equals_int (gst_buffer_get_n_meta (buffer,
+          GST_META_TEST_API_TYPE), 1);
+
+  /* metas added to copies are found too */
+  copy = gst_buffer_copy (buffer);
+  fail_unless (gst_buffer_get_meta (copy, GST_META_TEST_API_TYPE) != NULL);
+  fail_unless (gst_buffer_get_meta (copy, GST_META_TEST_API_TYPE) != m3);
+  gst_buffer_unref (copy);
+
+  fail_unless (gst_buffer_remove_meta (buffer, m3));
+  fail_unless (gst_buffer_get_meta (buffer, GST_META_TEST_API_TYPE) == NULL);
+
+  gst_buffer_unref (buffer);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_buffermeta_suite (void)
 {
@@ -827,6 +864,7 @@ gst_buffermeta_suite (void)
   tcase_add_test (tc_chain, test_meta_seqnum);
   tcase_add_test (tc_chain, test_meta_custom);
   tcase_add_test (tc_chain, test_meta_custom_transform);
+  tcase_add_test (tc_chain, test_meta_get_after_remove);
 
   return s;
 }
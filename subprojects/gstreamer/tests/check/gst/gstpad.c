@@ -1126,6 +1126,139 @@ GST_START_TEST (test_push_buffer_list_compat)
 
 GST_END_TEST;
 
+static guint batch_n_lists, batch_n_buffers;
+
+static GstFlowReturn
+batch_chain_list (GstPad * pad, GstObject * parent, GstBufferList * list)
+{
+  batch_n_lists++;
+  batch_n_buffers += gst_buffer_list_length (list);
+  gst_buffer_list_unref (list);
+
+  return GST_FLOW_OK;
+}
+
+static gboolean
+batch_sink_event (GstPad * pad, GstObject * parent, GstEvent * event)
+{
+  /* no buffers may be pending when EOS arrives */
+  if (GST_EVENT_TYPE (event) == GST_EVENT_EOS)
+    fail_unless_equals_int (batch_n_buffers, 6);
+
+  gst_event_unref (event);
+  return TRUE;
+}
+
+GST_START_TEST (test_push_batch)
+{
+  GstPad *src, *sink;
+  GstPadLinkReturn plr;
+  GstCaps *caps;
+  gulong id;
+  guint i;
+
+  batch_n_lists = batch_n_buffers = 0;
+
+  sink = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sink, gst_check_chain_func);
+  gst_pad_set_chain_list_function (sink, batch_chain_list);
+  gst_pad_set_event_function (sink, batch_sink_event);
+  src = gst_pad_new ("src", GST_PAD_SRC);
+
+  caps = gst_caps_from_string ("foo/bar");
+  gst_pad_set_active (src, TRUE);
+  gst_pad_set_active (sink, TRUE);
+  plr = gst_pad_link (src, sink);
+  fail_unless (GST_PAD_LINK_SUCCESSFUL (plr));
+
+  fail_unless (gst_pad_push_event (src, gst_event_new_stream_start ("test")));
+  gst_pad_set_caps (src, caps);
+  fail_unless (gst_pad_push_event (src,
+          gst_event_new_segment (&dummy_segment)));
+
+  gst_pad_set_batch_size (src, 3);
+  fail_unless_equals_int (gst_pad_get_batch_size (src), 3);
+
+  /* buffers are collected until the batch is full */
+  for (i = 0; i < 2; i++)
+    fail_unless (gst_pad_push (src, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless_equals_int (batch_n_lists, 0);
+  fail_unless (gst_pad_push (src, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless_equals_int (batch_n_lists, 1);
+  fail_unless_equals_int (batch_n_buffers, 3);
+
+  /* explicit push of a partial batch */
+  fail_unless (gst_pad_push (src, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless_equals_int (batch_n_lists, 1);
+  fail_unless (gst_pad_push_batch (src) == GST_FLOW_OK);
+  fail_unless_equals_int (batch_n_lists, 2);
+  fail_unless_equals_int (batch_n_buffers, 4);
+  fail_unless (gst_pad_push_batch (src) == GST_FLOW_OK);
+  fail_unless_equals_int (batch_n_lists, 2);
+
+  /* with a probe installed, buffers are pushed one by one */
+  id = gst_pad_add_probe (src, GST_PAD_PROBE_TYPE_BUFFER,
+      _probe_handler, GINT_TO_POINTER (GST_PAD_PROBE_OK), NULL);
+  fail_unless (gst_pad_push (src, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  gst_check_drop_buffers ();
+  gst_pad_remove_probe (src, id);
+
+  /* serialized events push the pending buffers first */
+  fail_unless (gst_pad_push (src, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless (gst_pad_push (src, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless_equals_int (batch_n_buffers, 4);
+  fail_unless (gst_pad_push_event (src, gst_event_new_eos ()));
+  fail_unless_equals_int (batch_n_lists, 3);
+  fail_unless_equals_int (batch_n_buffers, 6);
+
+  gst_pad_unlink (src, sink);
+  gst_object_unref (src);
+  gst_object_unref (sink);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_push_batch_no_chain_list)
+{
+  GstPad *src, *sink;
+  GstPadLinkReturn plr;
+  GstCaps *caps;
+
+  sink = gst_pad_new ("sink", GST_PAD_SINK);
+  gst_pad_set_chain_function (sink, gst_check_chain_func);
+  /* leave chainlistfunc unset */
+  src = gst_pad_new ("src", GST_PAD_SRC);
+
+  caps = gst_caps_from_string ("foo/bar");
+  gst_pad_set_active (src, TRUE);
+  gst_pad_set_active (sink, TRUE);
+  plr = gst_pad_link (src, sink);
+  fail_unless (GST_PAD_LINK_SUCCESSFUL (plr));
+
+  fail_unless (gst_pad_push_event (src, gst_event_new_stream_start ("test")));
+  gst_pad_set_caps (src, caps);
+  fail_unless (gst_pad_push_event (src,
+          gst_event_new_segment (&dummy_segment)));
+
+  gst_pad_set_batch_size (src, 8);
+
+  /* buffers are not held back when the peer can't handle lists */
+  fail_unless (gst_pad_push (src, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 1);
+  fail_unless (gst_pad_push (src, gst_buffer_new ()) == GST_FLOW_OK);
+  fail_unless_equals_int (g_list_length (buffers), 2);
+
+  gst_check_drop_buffers ();
+  gst_pad_unlink (src, sink);
+  gst_object_unref (src);
+  gst_object_unref (sink);
+  gst_caps_unref (caps);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_flowreturn)
 {
   GstFlowReturn ret;
@@ -2615,6 +2748,63 @@ test_sticky_chain (GstPad * pad, GstObject * parent, GstBuffer * buffer)
   return GST_FLOW_OK;
 }
 
+static gboolean
+has_sticky_event (GstPad * pad, GstEventType type)
+{
+  GstEvent *event = gst_pad_get_sticky_event (pad, type, 0);
+
+  if (event)
+    gst_event_unref (event);
+
+  return event != NULL;
+}
+
+GST_START_TEST (test_sticky_events_lookup)
+{
+  GstPad *srcpad;
+  GstCaps *caps;
+  GstSegment seg;
+
+  srcpad = gst_pad_new ("src", GST_PAD_SRC);
+  gst_pad_set_active (srcpad, TRUE);
+
+  fail_if (has_sticky_event (srcpad, GST_EVENT_STREAM_START));
+
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("test"));
+  caps = gst_caps_new_empty_simple ("foo/bar");
+  gst_pad_push_event (srcpad, gst_event_new_caps (caps));
+  gst_caps_unref (caps);
+  gst_segment_init (&seg, GST_FORMAT_TIME);
+  gst_pad_push_event (srcpad, gst_event_new_segment (&seg));
+  gst_pad_push_event (srcpad, gst_event_new_tag (gst_tag_list_new_empty ()));
+
+  fail_unless (has_sticky_event (srcpad, GST_EVENT_STREAM_START));
+  fail_unless (has_sticky_event (srcpad, GST_EVENT_CAPS));
+  fail_unless (has_sticky_event (srcpad, GST_EVENT_SEGMENT));
+  fail_unless (has_sticky_event (srcpad, GST_EVENT_TAG));
+  fail_if (has_sticky_event (srcpad, GST_EVENT_EOS));
+  fail_if (has_sticky_event (srcpad, GST_EVENT_TOC));
+
+  gst_pad_push_event (srcpad, gst_event_new_eos ());
+  fail_unless (has_sticky_event (srcpad, GST_EVENT_EOS));
+
+  /* a new stream removes EOS and tags, the other events are kept */
+  gst_pad_push_event (srcpad, gst_event_new_stream_start ("test2"));
+  fail_if (has_sticky_event (srcpad, GST_EVENT_EOS));
+  fail_if (has_sticky_event (srcpad, GST_EVENT_TAG));
+  fail_unless (has_sticky_event (srcpad, GST_EVENT_CAPS));
+  fail_unless (has_sticky_event (srcpad, GST_EVENT_SEGMENT));
+
+  /* deactivating removes everything */
+  gst_pad_set_active (srcpad, FALSE);
+  fail_if (has_sticky_event (srcpad, GST_EVENT_STREAM_START));
+  fail_if (has_sticky_event (srcpad, GST_EVENT_CAPS));
+
+  gst_object_unref (srcpad);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_sticky_events)
 {
   GstPad *srcpad, *sinkpad;
@@ -3415,6 +3605,8 @@ gst_pad_suite (void)
   tcase_add_test (tc_chain, test_push_linked);
   tcase_add_test (tc_chain, test_push_linked_flushing);
   tcase_add_test (tc_chain, test_push_buffer_list_compat);
+  tcase_add_test (tc_chain, test_push_batch);
+  tcase_add_test (tc_chain, test_push_batch_no_chain_list);
   tcase_add_test (tc_chain, test_flowreturn);
   tcase_add_test (tc_chain, test_push_negotiation);
   tcase_add_test (tc_chain, test_src_unref_unlink);
@@ -3444,6 +3636,7 @@ gst_pad_suite (void)
   tcase_add_test (tc_chain, test_block_async_full_destroy_dispose);
   tcase_add_test (tc_chain, test_block_async_replace_callback_no_flush);
   tcase_add_test (tc_chain, test_sticky_events);
+  tcase_add_test (tc_chain, test_sticky_events_lookup);
   tcase_add_test (tc_chain, test_last_flow_return_push);
   tcase_add_test (tc_chain, test_last_flow_return_pull);
   tcase_add_test (tc_chain, test_flush_stop_inactive);
@@ -594,6 +594,62 @@ GST_START_TEST (test_pipeline_reset_start_time)
 
 GST_END_TEST;
 
+GST_START_TEST (test_pipeline_reset)
+{
+  GstElement *pipeline, *fakesrc, *fakesink;
+  GstStateChangeReturn ret;
+  GstState state;
+  GstMessage *msg;
+  GstBus *bus;
+  gint i;
+
+  pipeline = gst_parse_launch ("fakesrc name=src num-buffers=5 ! "
+      "fakesink name=sink", NULL);
+  fail_unless (pipeline != NULL);
+  fakesrc = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+  fakesink = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+
+  bus = gst_element_get_bus (pipeline);
+
+  for (i = 0; i < 2; i++) {
+    GstElement *elem;
+
+    ret = gst_element_set_state (pipeline, GST_STATE_PLAYING);
+    fail_if (ret == GST_STATE_CHANGE_FAILURE);
+
+    msg = gst_bus_timed_pop_filtered (bus, GST_CLOCK_TIME_NONE,
+        GST_MESSAGE_EOS | GST_MESSAGE_ERROR);
+    fail_unless_equals_int (GST_MESSAGE_TYPE (msg), GST_MESSAGE_EOS);
+    gst_message_unref (msg);
+
+    fail_unless (gst_pipeline_reset (GST_PIPELINE (pipeline)));
+
+    ret = gst_element_get_state (pipeline, &state, NULL, 0);
+    fail_unless_equals_int (ret, GST_STATE_CHANGE_SUCCESS);
+    fail_unless_equals_int (state, GST_STATE_READY);
+
+    /* the messages of the previous run are gone */
+    fail_if (gst_bus_have_pending (bus));
+
+    /* and the same elements are reused */
+    elem = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+    fail_unless (elem == fakesrc);
+    gst_object_unref (elem);
+    elem = gst_bin_get_by_name (GST_BIN (pipeline), "sink");
+    fail_unless (elem == fakesink);
+    gst_object_unref (elem);
+  }
+
+  gst_element_set_state (pipeline, GST_STATE_NULL);
+
+  gst_object_unref (bus);
+  gst_object_unref (fakesrc);
+  gst_object_unref (fakesink);
+  gst_object_unref (pipeline);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_pipeline_processing_deadline)
 {
   GstElement *pipeline, *fakesrc, *queue, *fakesink;
@@ -756,6 +812,7 @@ gst_pipeline_suite (void)
   tcase_add_test (tc_chain, test_concurrent_create);
   tcase_add_test (tc_chain, test_pipeline_in_pipeline);
   tcase_add_test (tc_chain, test_pipeline_reset_start_time);
+  tcase_add_test (tc_chain, test_pipeline_reset);
   tcase_add_test (tc_chain, test_pipeline_processing_deadline);
   tcase_add_test (tc_chain, test_pipeline_processing_deadline_no_queue);
 
@@ -105,6 +105,80 @@ GST_END_TEST;
 
 #endif /* HAVE_PIPE */
 
+#ifndef G_OS_WIN32
+#define NUM_SOCKETS 100
+
+/* enough descriptors for the set to not use a plain poll() anymore */
+GST_START_TEST (test_poll_wait_many)
+{
+  GstPoll *set;
+  GstPollFD rfds[NUM_SOCKETS];
+  gint wfds[NUM_SOCKETS];
+  guchar c = 'A';
+  gint i;
+
+  set = gst_poll_new (TRUE);
+  fail_if (set == NULL, "Failed to create a GstPoll");
+
+  for (i = 0; i < NUM_SOCKETS; i++) {
+    gint socks[2];
+
+    fail_if (socketpair (PF_UNIX, SOCK_STREAM, 0, socks) < 0,
+        "Could not create a socket pair");
+    gst_poll_fd_init (&rfds[i]);
+    rfds[i].fd = socks[0];
+    wfds[i] = socks[1];
+
+    fail_unless (gst_poll_add_fd (set, &rfds[i]), "Could not add descriptor");
+    fail_unless (gst_poll_fd_ctl_read (set, &rfds[i], TRUE),
+        "Could not mark the descriptor as readable");
+  }
+
+  fail_unless (gst_poll_wait (set, 10 * GST_MSECOND) == 0,
+      "Waiting did not timeout");
+
+  fail_unless (write (wfds[7], &c, 1) == 1, "write() failed");
+  fail_unless (write (wfds[NUM_SOCKETS - 1], &c, 1) == 1, "write() failed");
+
+  fail_unless (gst_poll_wait (set, GST_CLOCK_TIME_NONE) == 2,
+      "Two descriptors should be available");
+  for (i = 0; i < NUM_SOCKETS; i++) {
+    fail_unless_equals_int (gst_poll_fd_can_read (set, &rfds[i]),
+        i == 7 || i == NUM_SOCKETS - 1);
+  }
+
+  /* data that is not read is reported again */
+  fail_unless (read (rfds[7].fd, &c, 1) == 1, "read() failed");
+  fail_unless (gst_poll_wait (set, GST_CLOCK_TIME_NONE) == 1,
+      "One descriptor should be available");
+  fail_if (gst_poll_fd_can_read (set, &rfds[7]),
+      "Descriptor should not be readable anymore");
+  fail_unless (gst_poll_fd_can_read (set, &rfds[NUM_SOCKETS - 1]),
+      "Descriptor should still be readable");
+
+  /* removing moves the last descriptor in place of the removed one */
+  fail_unless (gst_poll_remove_fd (set, &rfds[0]),
+      "Could not remove descriptor");
+  fail_unless (gst_poll_wait (set, GST_CLOCK_TIME_NONE) == 1,
+      "One descriptor should be available");
+  fail_unless (gst_poll_fd_can_read (set, &rfds[NUM_SOCKETS - 1]),
+      "Descriptor should still be readable");
+
+  fail_unless (gst_poll_fd_ctl_read (set, &rfds[NUM_SOCKETS - 1], FALSE),
+      "Could not unmark the descriptor as readable");
+  fail_unless (gst_poll_wait (set, 10 * GST_MSECOND) == 0,
+      "Waiting did not timeout");
+
+  gst_poll_free (set);
+  for (i = 0; i < NUM_SOCKETS; i++) {
+    close (rfds[i].fd);
+    close (wfds[i]);
+  }
+}
+
+GST_END_TEST;
+#endif
+
 GST_START_TEST (test_poll_basic)
 {
   GstPoll *set;
@@ -339,6 +413,7 @@ gst_poll_suite (void)
 #ifndef G_OS_WIN32
   tcase_add_test (tc_chain, test_poll_basic);
   tcase_add_test (tc_chain, test_poll_wait);
+  tcase_add_test (tc_chain, test_poll_wait_many);
   tcase_add_test (tc_chain, test_poll_wait_stop);
   tcase_add_test (tc_chain, test_poll_wait_restart);
   tcase_add_test (tc_chain, test_poll_wait_flush);
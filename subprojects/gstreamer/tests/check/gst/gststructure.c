@@ -1034,6 +1034,59 @@ GST_START_TEST (test_flags)
 
 GST_END_TEST;
 
+GST_START_TEST (test_set_simple_types)
+{
+  GstStructure *st;
+  const gchar *str;
+  gint i, num, den;
+  guint u;
+  gint64 i64;
+  guint64 u64;
+  gdouble d;
+  gboolean b;
+  GstFormat format;
+
+  st = gst_structure_new ("test", "int", G_TYPE_INT, -5,
+      "uint", G_TYPE_UINT, 7, "int64", G_TYPE_INT64, G_GINT64_CONSTANT (-9),
+      "uint64", G_TYPE_UINT64, G_MAXUINT64, "double", G_TYPE_DOUBLE, 2.5,
+      "bool", G_TYPE_BOOLEAN, TRUE, "format", GST_TYPE_FORMAT, GST_FORMAT_TIME,
+      "string", G_TYPE_STRING, "foo", "null-string", G_TYPE_STRING, NULL,
+      "fraction", GST_TYPE_FRACTION, 4, -6, NULL);
+
+  fail_unless (gst_structure_get_int (st, "int", &i));
+  fail_unless_equals_int (i, -5);
+  fail_unless (gst_structure_get_uint (st, "uint", &u));
+  fail_unless_equals_int (u, 7);
+  fail_unless (gst_structure_get_int64 (st, "int64", &i64));
+  fail_unless_equals_int64 (i64, -9);
+  fail_unless (gst_structure_get_uint64 (st, "uint64", &u64));
+  fail_unless_equals_uint64 (u64, G_MAXUINT64);
+  fail_unless (gst_structure_get_double (st, "double", &d));
+  fail_unless_equals_float (d, 2.5);
+  fail_unless (gst_structure_get_boolean (st, "bool", &b));
+  fail_unless (b);
+  fail_unless (gst_structure_get_enum (st, "format", GST_TYPE_FORMAT,
+          (gint *) & format));
+  fail_unless_equals_int (format, GST_FORMAT_TIME);
+  fail_unless_equals_string (gst_structure_get_string (st, "string"), "foo");
+  fail_unless (gst_structure_get (st, "null-string", G_TYPE_STRING, &str,
+          NULL));
+  fail_unless (str == NULL);
+  /* fractions are normalized the same way as with gst_value_set_fraction() */
+  fail_unless (gst_structure_get_fraction (st, "fraction", &num, &den));
+  fail_unless_equals_int (num, -2);
+  fail_unless_equals_int (den, 3);
+
+  ASSERT_CRITICAL (gst_structure_set (st, "fraction", GST_TYPE_FRACTION, 1, 0,
+          NULL));
+  fail_unless (gst_structure_get_fraction (st, "fraction", &num, &den));
+  fail_unless_equals_int (num, -2);
+
+  gst_structure_free (st);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_structure_suite (void)
 {
@@ -1067,6 +1120,7 @@ gst_structure_suite (void)
   tcase_add_test (tc_chain, test_filter_and_map_in_place);
   tcase_add_test (tc_chain, test_flagset);
   tcase_add_test (tc_chain, test_flags);
+  tcase_add_test (tc_chain, test_set_simple_types);
   return s;
 }
 
@@ -227,6 +227,63 @@ GST_START_TEST (test_resolution)
 
 GST_END_TEST;
 
+static gpointer
+unschedule_after_timeout_func (gpointer data)
+{
+  GstClockID id = data;
+
+  g_usleep (50 * G_USEC_PER_SEC / 1000);
+  gst_clock_id_unschedule (id);
+
+  return NULL;
+}
+
+GST_START_TEST (test_spin_time)
+{
+  GstClock *clock;
+  GstClockID id;
+  GstClockTime base, now;
+  GstClockReturn ret;
+  GThread *thread;
+
+  clock = g_object_new (GST_TYPE_SYSTEM_CLOCK, "spin-time", GST_MSECOND,
+      NULL);
+
+  /* deadline outside of the spin window, sleeps first then spins */
+  base = gst_clock_get_time (clock);
+  id = gst_clock_new_single_shot_id (clock, base + 5 * GST_MSECOND);
+  ret = gst_clock_id_wait (id, NULL);
+  now = gst_clock_get_time (clock);
+  fail_unless_equals_int (ret, GST_CLOCK_OK);
+  fail_unless (now >= base + 5 * GST_MSECOND);
+  gst_clock_id_unref (id);
+
+  /* deadline inside of the spin window */
+  base = gst_clock_get_time (clock);
+  id = gst_clock_new_single_shot_id (clock, base + 500 * GST_USECOND);
+  ret = gst_clock_id_wait (id, NULL);
+  now = gst_clock_get_time (clock);
+  fail_unless_equals_int (ret, GST_CLOCK_OK);
+  fail_unless (now >= base + 500 * GST_USECOND);
+  gst_clock_id_unref (id);
+
+  /* unscheduling must stop the busy wait */
+  g_object_set (clock, "spin-time", 10 * GST_SECOND, NULL);
+  base = gst_clock_get_time (clock);
+  id = gst_clock_new_single_shot_id (clock, base + 5 * GST_SECOND);
+  thread = g_thread_new ("unschedule", unschedule_after_timeout_func, id);
+  ret = gst_clock_id_wait (id, NULL);
+  now = gst_clock_get_time (clock);
+  fail_unless_equals_int (ret, GST_CLOCK_UNSCHEDULED);
+  fail_unless (now < base + 5 * GST_SECOND);
+  g_thread_join (thread);
+  gst_clock_id_unref (id);
+
+  gst_object_unref (clock);
+}
+
+GST_END_TEST;
+
 typedef struct
 {
   GThread *thread_wait;
@@ -398,6 +455,7 @@ gst_systemclock_suite (void)
   tcase_add_test (tc_chain, test_async_full);
   tcase_add_test (tc_chain, test_set_default);
   tcase_add_test (tc_chain, test_resolution);
+  tcase_add_test (tc_chain, test_spin_time);
   tcase_add_test (tc_chain, test_stress_cleanup_unschedule);
   tcase_add_test (tc_chain, test_stress_reschedule);
 
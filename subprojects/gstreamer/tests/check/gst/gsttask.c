@@ -464,6 +464,154 @@ GST_START_TEST (test_shared_task_pool_two_threads)
 
 GST_END_TEST;
 
+#define N_COOPERATIVE_TASKS 8
+#define N_COOPERATIVE_ITERATIONS 100
+
+typedef struct
+{
+  GstTask *task;
+  GRecMutex lock;
+  gint iterations;
+} CooperativeTaskData;
+
+static void
+cooperative_task_func (CooperativeTaskData * data)
+{
+  g_mutex_lock (&task_lock);
+  if (++data->iterations == N_COOPERATIVE_ITERATIONS)
+    gst_task_pause (data->task);
+  g_cond_broadcast (&task_cond);
+  g_mutex_unlock (&task_lock);
+}
+
+static gboolean
+cooperative_tasks_done (CooperativeTaskData * data, gint iterations)
+{
+  guint i;
+
+  for (i = 0; i < N_COOPERATIVE_TASKS; i++) {
+    if (data[i].iterations < iterations)
+      return FALSE;
+  }
+  return TRUE;
+}
+
+GST_START_TEST (test_work_stealing_task_pool)
+{
+  CooperativeTaskData data[N_COOPERATIVE_TASKS];
+  GstTaskPool *pool;
+  guint i;
+
+  g_mutex_init (&task_lock);
+  g_cond_init (&task_cond);
+
+  /* more tasks than workers, every task gets its share */
+  pool = gst_work_stealing_task_pool_new (2);
+  fail_unless_equals_int (gst_work_stealing_task_pool_get_n_workers
+      (GST_WORK_STEALING_TASK_POOL (pool)), 2);
+  gst_task_pool_prepare (pool, NULL);
+
+  for (i = 0; i < N_COOPERATIVE_TASKS; i++) {
+    data[i].iterations = 0;
+    g_rec_mutex_init (&data[i].lock);
+    data[i].task = gst_task_new ((GstTaskFunction) cooperative_task_func,
+        &data[i], NULL);
+    gst_task_set_lock (data[i].task, &data[i].lock);
+    gst_task_set_pool (data[i].task, pool);
+  }
+
+  g_mutex_lock (&task_lock);
+  for (i = 0; i < N_COOPERATIVE_TASKS; i++)
+    fail_unless (gst_task_start (data[i].task));
+
+  /* all tasks pause themselves after some iterations */
+  while (!cooperative_tasks_done (data, N_COOPERATIVE_ITERATIONS))
+    g_cond_wait (&task_cond, &task_lock);
+
+  /* paused tasks don't run */
+  g_mutex_unlock (&task_lock);
+  g_usleep (G_USEC_PER_SEC / 10);
+  g_mutex_lock (&task_lock);
+  for (i = 0; i < N_COOPERATIVE_TASKS; i++)
+    fail_unless_equals_int (data[i].iterations, N_COOPERATIVE_ITERATIONS);
+
+  /* resumed tasks continue */
+  for (i = 0; i < N_COOPERATIVE_TASKS; i++)
+    fail_unless (gst_task_resume (data[i].task));
+  while (!cooperative_tasks_done (data, N_COOPERATIVE_ITERATIONS + 1))
+    g_cond_wait (&task_cond, &task_lock);
+  g_mutex_unlock (&task_lock);
+
+  for (i = 0; i < N_COOPERATIVE_TASKS; i++) {
+    fail_unless (gst_task_join (data[i].task));
+    gst_object_unref (data[i].task);
+    g_rec_mutex_clear (&data[i].lock);
+  }
+
+  gst_task_pool_cleanup (pool);
+  gst_object_unref (pool);
+}
+
+GST_END_TEST;
+
+static void
+affinity_task_func (GstTask ** t)
+{
+  g_mutex_lock (&task_lock);
+  gst_task_stop (*t);
+  g_cond_signal (&task_cond);
+  g_mutex_unlock (&task_lock);
+}
+
+GST_START_TEST (test_task_affinity)
+{
+  GstTask *t;
+  GstContext *context;
+  const guint cpus[] = { 0 };
+  guint *res, n_cpus;
+
+  t = gst_task_new ((GstTaskFunction) affinity_task_func, &t, NULL);
+  fail_unless_equals_int (gst_task_get_numa_node (t), -1);
+  res = gst_task_get_cpu_affinity (t, &n_cpus);
+  fail_unless (res == NULL);
+  fail_unless_equals_int (n_cpus, 0);
+
+  gst_task_set_numa_node (t, 0);
+  fail_unless_equals_int (gst_task_get_numa_node (t), 0);
+
+  context = gst_task_affinity_context_new (-1, cpus, G_N_ELEMENTS (cpus));
+  fail_unless (gst_context_is_persistent (context));
+  fail_unless (gst_task_set_affinity_from_context (t, context));
+  gst_context_unref (context);
+
+  fail_unless_equals_int (gst_task_get_numa_node (t), -1);
+  res = gst_task_get_cpu_affinity (t, &n_cpus);
+  fail_unless_equals_int (n_cpus, 1);
+  fail_unless_equals_int (res[0], 0);
+  g_free (res);
+
+  /* other contexts are ignored */
+  context = gst_context_new ("foo", FALSE);
+  fail_if (gst_task_set_affinity_from_context (t, context));
+  gst_context_unref (context);
+
+  /* the affinity is applied from the streaming thread */
+  g_mutex_init (&task_lock);
+  g_cond_init (&task_cond);
+  g_rec_mutex_init (&task_mutex);
+  gst_task_set_lock (t, &task_mutex);
+
+  g_mutex_lock (&task_lock);
+  fail_unless (gst_task_start (t));
+  g_cond_wait (&task_cond, &task_lock);
+  g_mutex_unlock (&task_lock);
+
+  fail_unless (gst_task_join (t));
+  gst_object_unref (t);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_task_suite (void)
 {
@@ -480,6 +628,8 @@ gst_task_suite (void)
   tcase_add_test (tc_chain, test_resume);
   tcase_add_test (tc_chain, test_shared_task_pool_shared_thread);
   tcase_add_test (tc_chain, test_shared_task_pool_two_threads);
+  tcase_add_test (tc_chain, test_work_stealing_task_pool);
+  tcase_add_test (tc_chain, test_task_affinity);
 
   return s;
 }
@@ -1384,6 +1384,68 @@ GST_START_TEST (test_merge)
 
 GST_END_TEST;
 
+GST_START_TEST (test_map_vectored)
+{
+  GstAdapter *adapter;
+  const GstByteReader *chunks;
+  guint8 data[30];
+  guint n_chunks, i;
+  guint8 val;
+
+  adapter = gst_adapter_new ();
+  fail_if (adapter == NULL);
+
+  for (i = 0; i < 30; i++)
+    data[i] = i;
+
+  gst_adapter_push (adapter, gst_buffer_new_memdup (data, 5));
+  gst_adapter_push (adapter, gst_buffer_new_memdup (data + 5, 10));
+  gst_adapter_push (adapter, gst_buffer_new_memdup (data + 15, 15));
+  gst_adapter_flush (adapter, 2);
+
+  /* not enough data */
+  fail_unless (gst_adapter_map_vectored (adapter, 0, 29, &n_chunks) == NULL);
+  fail_unless_equals_int (n_chunks, 0);
+  fail_unless (gst_adapter_map_vectored (adapter, 20, 9, &n_chunks) == NULL);
+
+  /* range within one buffer */
+  chunks = gst_adapter_map_vectored (adapter, 4, 6, &n_chunks);
+  fail_unless (chunks != NULL);
+  fail_unless_equals_int (n_chunks, 1);
+  fail_unless_equals_int (gst_byte_reader_get_size (&chunks[0]), 6);
+  fail_unless (gst_byte_reader_peek_uint8 (&chunks[0], &val));
+  fail_unless_equals_int (val, 6);
+  gst_adapter_unmap (adapter);
+
+  /* range over all buffers */
+  chunks = gst_adapter_map_vectored (adapter, 1, 25, &n_chunks);
+  fail_unless (chunks != NULL);
+  fail_unless_equals_int (n_chunks, 3);
+  fail_unless_equals_int (gst_byte_reader_get_size (&chunks[0]), 2);
+  fail_unless_equals_int (gst_byte_reader_get_size (&chunks[1]), 10);
+  fail_unless_equals_int (gst_byte_reader_get_size (&chunks[2]), 13);
+  fail_unless (gst_byte_reader_peek_uint8 (&chunks[0], &val));
+  fail_unless_equals_int (val, 3);
+  fail_unless (gst_byte_reader_peek_uint8 (&chunks[1], &val));
+  fail_unless_equals_int (val, 5);
+  fail_unless (gst_byte_reader_peek_uint8 (&chunks[2], &val));
+  fail_unless_equals_int (val, 15);
+
+  /* flushing releases the mapping */
+  gst_adapter_flush (adapter, 3);
+  fail_unless_equals_int (gst_adapter_available (adapter), 25);
+
+  chunks = gst_adapter_map_vectored (adapter, 0, 25, &n_chunks);
+  fail_unless_equals_int (n_chunks, 2);
+  fail_unless (gst_byte_reader_peek_uint8 (&chunks[0], &val));
+  fail_unless_equals_int (val, 5);
+  gst_adapter_unmap (adapter);
+
+  g_object_unref (adapter);
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_take_buffer_fast)
 {
   GstAdapter *adapter;
@@ -1471,6 +1533,7 @@ gst_adapter_suite (void)
   tcase_add_test (tc_chain, test_get_buffer_list);
   tcase_add_test (tc_chain, test_merge);
   tcase_add_test (tc_chain, test_take_buffer_fast);
+  tcase_add_test (tc_chain, test_map_vectored);
   tcase_add_test (tc_chain, test_offset);
 
   return s;
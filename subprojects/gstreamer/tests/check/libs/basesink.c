@@ -24,6 +24,8 @@
 #include <gst/gst.h>
 #include <gst/check/gstcheck.h>
 #include <gst/base/gstbasesink.h>
+#include <gst/check/gstharness.h>
+#include <gst/check/gsttestclock.h>
 
 GST_START_TEST (basesink_last_sample_enabled)
 {
@@ -282,6 +284,77 @@ GST_START_TEST (basesink_position_query_handles_segment_offset)
 
 GST_END_TEST;
 
+typedef struct
+{
+  GstHarness *h;
+  GstBuffer *buf;
+} PushData;
+
+static gpointer
+push_buffer_func (gpointer data)
+{
+  PushData *push = data;
+
+  gst_harness_push (push->h, push->buf);
+
+  return NULL;
+}
+
+static GstClockTime
+pending_wait_time (GstHarness * h, GstClockTime pts)
+{
+  GstTestClock *clock = gst_harness_get_testclock (h);
+  GstClockID id = NULL;
+  GstClockTime ret;
+  GThread *thread;
+  PushData push;
+
+  push.h = h;
+  push.buf = gst_buffer_new ();
+  GST_BUFFER_PTS (push.buf) = pts;
+  thread = g_thread_new ("push", push_buffer_func, &push);
+
+  fail_unless (gst_harness_wait_for_clock_id_waits (h, 1, 5));
+  fail_unless (gst_test_clock_peek_next_pending_id (clock, &id));
+  ret = gst_clock_id_get_time (id);
+  gst_clock_id_unref (id);
+
+  fail_unless (gst_harness_crank_single_clock_wait (h));
+  g_thread_join (thread);
+  gst_object_unref (clock);
+
+  return ret;
+}
+
+GST_START_TEST (basesink_presentation_feedback)
+{
+  GstHarness *h = gst_harness_new ("fakesink");
+
+  g_object_set (h->element, "sync", TRUE, NULL);
+  gst_harness_set_src_caps_str (h, "foo/bar");
+
+  /* without feedback the sink waits for the running time of the buffer */
+  fail_unless_equals_uint64 (pending_wait_time (h, 100 * GST_MSECOND),
+      100 * GST_MSECOND);
+
+  /* the refresh cycle closest to 150ms starts at 155ms, so the frame has
+   * to be submitted right after the one at 135ms */
+  gst_base_sink_set_presentation_feedback (GST_BASE_SINK (h->element),
+      135 * GST_MSECOND, 20 * GST_MSECOND);
+  fail_unless_equals_uint64 (pending_wait_time (h, 150 * GST_MSECOND),
+      135 * GST_MSECOND);
+
+  /* disabled again */
+  gst_base_sink_set_presentation_feedback (GST_BASE_SINK (h->element),
+      GST_CLOCK_TIME_NONE, GST_CLOCK_TIME_NONE);
+  fail_unless_equals_uint64 (pending_wait_time (h, 200 * GST_MSECOND),
+      200 * GST_MSECOND);
+
+  gst_harness_teardown (h);
+}
+
+GST_END_TEST;
+
 static Suite *
 gst_basesrc_suite (void)
 {
@@ -294,6 +367,7 @@ gst_basesrc_suite (void)
   tcase_add_test (tc, basesink_test_gap);
   tcase_add_test (tc, basesink_test_eos_after_playing);
   tcase_add_test (tc, basesink_position_query_handles_segment_offset);
+  tcase_add_test (tc, basesink_presentation_feedback);
 
   return s;
 }
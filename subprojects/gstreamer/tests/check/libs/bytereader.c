@@ -608,6 +608,56 @@ GST_START_TEST (test_scan)
 
 GST_END_TEST;
 
+GST_START_TEST (test_scan_start_code)
+{
+  GstByteReader reader;
+  guint8 *data;
+  guint32 val;
+  guint i, size, pos;
+
+  /* move a 00 00 01 marker over buffers of different lengths so it ends up
+   * at every position relative to any block the scan works in */
+  for (size = 4; size <= 80; size++) {
+    data = g_malloc (size);
+
+    for (pos = 0; pos + 3 <= size; pos++) {
+      for (i = 0; i < size; i++)
+        data[i] = (i & 1) ? 0x00 : 0x02;
+      data[pos] = 0x00;
+      data[pos + 1] = 0x00;
+      data[pos + 2] = 0x01;
+      if (pos + 3 < size)
+        data[pos + 3] = 0xB3;
+
+      gst_byte_reader_init (&reader, data, size);
+
+      /* it needs the byte after the marker to be found */
+      if (pos + 4 > size) {
+        fail_unless_equals_int (gst_byte_reader_masked_scan_uint32 (&reader,
+                0xffffff00, 0x00000100, 0, size), -1);
+        continue;
+      }
+
+      fail_unless_equals_int (gst_byte_reader_masked_scan_uint32_peek
+          (&reader, 0xffffff00, 0x00000100, 0, size, &val), pos);
+      fail_unless_equals_int (val, 0x000001B3);
+
+      if (pos > 0) {
+        fail_unless_equals_int (gst_byte_reader_masked_scan_uint32 (&reader,
+                0xffffff00, 0x00000100, 1, size - 1), pos);
+        fail_unless_equals_int (gst_byte_reader_masked_scan_uint32 (&reader,
+                0xffffff00, 0x00000100, 0, pos + 3), -1);
+      }
+      fail_unless_equals_int (gst_byte_reader_masked_scan_uint32 (&reader,
+              0xffffff00, 0x00000100, pos + 1, size - pos - 1), -1);
+    }
+
+    g_free (data);
+  }
+}
+
+GST_END_TEST;
+
 GST_START_TEST (test_string_funcs)
 {
   GstByteReader reader, backup;
@@ -836,6 +886,7 @@ gst_byte_reader_suite (void)
   tcase_add_test (tc_chain, test_get_float_be);
   tcase_add_test (tc_chain, test_position_tracking);
   tcase_add_test (tc_chain, test_scan);
+  tcase_add_test (tc_chain, test_scan_start_code);
   tcase_add_test (tc_chain, test_string_funcs);
   tcase_add_test (tc_chain, test_dup_string);
   tcase_add_test (tc_chain, test_sub_reader);
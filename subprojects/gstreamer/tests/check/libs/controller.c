@@ -24,6 +24,7 @@
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
+#include <math.h>
 #include <gst/gst.h>
 #include <gst/check/gstcheck.h>
 #include <gst/controller/gstinterpolationcontrolsource.h>
@@ -729,6 +730,58 @@ GST_START_TEST (controller_interpolation_linear_value_array)
 
 GST_END_TEST;
 
+/* test that value arrays match the values for the individual timestamps */
+GST_START_TEST (controller_interpolation_value_array_matches_get)
+{
+  GstInterpolationMode modes[] = { GST_INTERPOLATION_MODE_NONE,
+    GST_INTERPOLATION_MODE_LINEAR, GST_INTERPOLATION_MODE_CUBIC,
+    GST_INTERPOLATION_MODE_CUBIC_MONOTONIC
+  };
+  GstControlSource *cs;
+  GstTimedValueControlSource *tvcs;
+  gdouble values[64], value;
+  guint i, m;
+
+  cs = gst_interpolation_control_source_new ();
+  tvcs = (GstTimedValueControlSource *) cs;
+
+  fail_unless (gst_timed_value_control_source_set (tvcs, 1 * GST_SECOND, 0.0));
+  fail_unless (gst_timed_value_control_source_set (tvcs, 2 * GST_SECOND, 0.5));
+  fail_unless (gst_timed_value_control_source_set (tvcs, 3 * GST_SECOND, 0.2));
+  fail_unless (gst_timed_value_control_source_set (tvcs, 5 * GST_SECOND, 0.8));
+
+  for (m = 0; m < G_N_ELEMENTS (modes); m++) {
+    g_object_set (cs, "mode", modes[m], NULL);
+
+    /* not aligned to the control points, starting before the first one and
+     * ending after the last one */
+    fail_unless (gst_control_source_get_value_array (cs, GST_SECOND / 3,
+            GST_SECOND / 10 + 1, G_N_ELEMENTS (values), values));
+
+    for (i = 0; i < G_N_ELEMENTS (values); i++) {
+      GstClockTime ts = GST_SECOND / 3 + i * (GST_SECOND / 10 + 1);
+
+      if (!gst_control_source_get_value (cs, ts, &value)) {
+        fail_unless (isnan (values[i]), "mode %d, value %u", modes[m], i);
+      } else {
+        fail_unless_equals_float (values[i], value);
+      }
+    }
+
+    /* a zero interval repeats the same value */
+    fail_unless (gst_control_source_get_value_array (cs, 2500 * GST_MSECOND,
+            0, 4, values));
+    fail_unless (gst_control_source_get_value (cs, 2500 * GST_MSECOND,
+            &value));
+    for (i = 0; i < 4; i++)
+      fail_unless_equals_float (values[i], value);
+  }
+
+  gst_object_unref (cs);
+}
+
+GST_END_TEST;
+
 /* test if values below minimum and above maximum are clipped */
 GST_START_TEST (controller_interpolation_linear_invalid_values)
 {
@@ -1684,6 +1737,7 @@ gst_controller_suite (void)
   tcase_add_test (tc, controller_interpolation_unset_all);
   tcase_add_test (tc, controller_interpolation_linear_absolute_value_array);
   tcase_add_test (tc, controller_interpolation_linear_value_array);
+  tcase_add_test (tc, controller_interpolation_value_array_matches_get);
   tcase_add_test (tc, controller_interpolation_linear_invalid_values);
   tcase_add_test (tc, controller_interpolation_linear_default_values);
   tcase_add_test (tc, controller_interpolation_linear_disabled);
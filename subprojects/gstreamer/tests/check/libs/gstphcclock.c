@@ -0,0 +1,79 @@
+/* GStreamer
+ *
+ * gstphcclock.c: Unit test for the PTP hardware clock
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin St, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <gst/check/gstcheck.h>
+#include <gst/net/net.h>
+
+GST_START_TEST (test_invalid_device)
+{
+  GstClock *clock;
+
+  clock = gst_phc_clock_new (NULL, "/dev/does-not-exist");
+  fail_unless (clock == NULL);
+
+  clock = gst_phc_clock_new_for_interface (NULL, "does-not-exist");
+  fail_unless (clock == NULL);
+}
+
+GST_END_TEST;
+
+GST_START_TEST (test_read_time)
+{
+  GstClock *clock;
+  GstClockTime t1, t2;
+
+  clock = gst_phc_clock_new (NULL, "/dev/ptp0");
+  if (clock == NULL) {
+    GST_INFO ("no usable PTP hardware clock, skipping test");
+    return;
+  }
+
+  ASSERT_OBJECT_REFCOUNT (clock, "phc clock", 1);
+
+  t1 = gst_clock_get_time (clock);
+  g_usleep (G_USEC_PER_SEC / 100);
+  t2 = gst_clock_get_time (clock);
+
+  fail_unless (GST_CLOCK_TIME_IS_VALID (t1));
+  fail_unless (GST_CLOCK_TIME_IS_VALID (t2));
+  fail_unless (t2 > t1);
+
+  gst_object_unref (clock);
+}
+
+GST_END_TEST;
+
+static Suite *
+gst_phc_clock_suite (void)
+{
+  Suite *s = suite_create ("GstPhcClock");
+  TCase *tc_chain = tcase_create ("generic tests");
+
+  suite_add_tcase (s, tc_chain);
+  tcase_add_test (tc_chain, test_invalid_device);
+  tcase_add_test (tc_chain, test_read_time);
+
+  return s;
+}
+
+GST_CHECK_MAIN (gst_phc_clock);
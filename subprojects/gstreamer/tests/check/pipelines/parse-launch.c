@@ -732,6 +732,111 @@ GST_START_TEST (test_parsing)
 
 GST_END_TEST;
 
+GST_START_TEST (test_template)
+{
+  GstParseTemplate *tmpl;
+  GstStructure *params;
+  GstElement *pipeline, *src, *sink;
+  const gchar *const *names;
+  GError *err = NULL;
+  gchar *name;
+  gint i, sizemax;
+
+  tmpl = gst_parse_template_new ("fakesrc name=src sizemax=${size} ! "
+      "fakesink name=${sink-name} silent=true", GST_PARSE_FLAG_NONE, &err);
+  fail_unless (tmpl != NULL);
+  fail_unless (err == NULL);
+
+  names = gst_parse_template_get_parameters (tmpl);
+  fail_unless_equals_string (names[0], "size");
+  fail_unless_equals_string (names[1], "sink-name");
+  fail_unless (names[2] == NULL);
+
+  for (i = 0; i < 3; i++) {
+    name = g_strdup_printf ("sink \"%d\"", i);
+    params = gst_structure_new ("params", "size", G_TYPE_INT, 100 + i,
+        "sink-name", G_TYPE_STRING, name, NULL);
+    pipeline = gst_parse_template_instantiate (tmpl, params, NULL, &err);
+    gst_structure_free (params);
+    fail_unless (pipeline != NULL);
+    fail_unless (err == NULL);
+
+    src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+    fail_unless (src != NULL);
+    g_object_get (src, "sizemax", &sizemax, NULL);
+    fail_unless_equals_int (sizemax, 100 + i);
+    gst_object_unref (src);
+
+    sink = gst_bin_get_by_name (GST_BIN (pipeline), name);
+    fail_unless (sink != NULL);
+    gst_object_unref (sink);
+
+    gst_object_unref (pipeline);
+    g_free (name);
+  }
+
+  /* missing parameter */
+  params = gst_structure_new ("params", "size", G_TYPE_INT, 100, NULL);
+  pipeline = gst_parse_template_instantiate (tmpl, params, NULL, &err);
+  gst_structure_free (params);
+  fail_unless (pipeline == NULL);
+  fail_unless (err != NULL);
+  g_clear_error (&err);
+
+  gst_parse_template_unref (tmpl);
+
+  /* parameters need to be property values */
+  tmpl = gst_parse_template_new ("${src} ! fakesink", GST_PARSE_FLAG_NONE,
+      &err);
+  fail_unless (tmpl == NULL);
+  fail_unless (err != NULL);
+  g_clear_error (&err);
+
+  tmpl = gst_parse_template_new ("fakesrc name=${} ! fakesink",
+      GST_PARSE_FLAG_NONE, &err);
+  fail_unless (tmpl == NULL);
+  fail_unless (err != NULL);
+  g_clear_error (&err);
+}
+
+GST_END_TEST;
+
+/* many different parameter values, more than the template keeps cached, still
+ * give the right properties, also when a value is used again after it was
+ * dropped from the cache */
+GST_START_TEST (test_template_many_values)
+{
+  GstParseTemplate *tmpl;
+  GError *err = NULL;
+  gint i;
+
+  tmpl = gst_parse_template_new ("fakesrc name=src sizemax=${size} ! "
+      "fakesink", GST_PARSE_FLAG_NONE, &err);
+  fail_unless (tmpl != NULL);
+
+  for (i = 0; i < 1000; i++) {
+    GstStructure *params;
+    GstElement *pipeline, *src;
+    gint size = (i < 900) ? i + 1 : i - 899, sizemax;
+
+    params = gst_structure_new ("params", "size", G_TYPE_INT, size, NULL);
+    pipeline = gst_parse_template_instantiate (tmpl, params, NULL, &err);
+    gst_structure_free (params);
+    fail_unless (pipeline != NULL);
+    fail_unless (err == NULL);
+
+    src = gst_bin_get_by_name (GST_BIN (pipeline), "src");
+    g_object_get (src, "sizemax", &sizemax, NULL);
+    fail_unless_equals_int (sizemax, size);
+    gst_object_unref (src);
+    gst_object_unref (pipeline);
+  }
+
+  gst_parse_template_unref (tmpl);
+}
+
+GST_END_TEST;
+
 static Suite *
 parse_suite (void)
 {
@@ -751,6 +856,8 @@ parse_suite (void)
   tcase_add_test (tc_chain, test_missing_elements);
   tcase_add_test (tc_chain, test_parsing);
   tcase_add_test (tc_chain, test_preset);
+  tcase_add_test (tc_chain, test_template);
+  tcase_add_test (tc_chain, test_template_many_values);
   return s;
 }
 